@@ -325,17 +325,19 @@ protected:
 
     static void writeXmlOrThrow (const XmlElement& xml, const File& file, const String& encoding, int maxCharsPerLine, bool useUnixNewLines = false)
     {
-        MemoryOutputStream mo;
-        xml.writeToStream (mo, String::empty, false, true, encoding, maxCharsPerLine);
-
         if (useUnixNewLines)
         {
-            MemoryOutputStream mo2;
-            mo2 << mo.toString().replace ("\r\n", "\n");
-            overwriteFileIfDifferentOrThrow (file, mo2);
+            StringBuilder sb;
+            xml.writeToStream (sb, String::empty, false, true, encoding, maxCharsPerLine);
+
+            MemoryOutputStream mo;
+            mo << sb.toString().replace ("\r\n", "\n");
+            overwriteFileIfDifferentOrThrow (file, mo);
         }
         else
         {
+            MemoryOutputStream mo;
+            xml.writeToStream (mo, String::empty, false, true, encoding, maxCharsPerLine);
             overwriteFileIfDifferentOrThrow (file, mo);
         }
     }
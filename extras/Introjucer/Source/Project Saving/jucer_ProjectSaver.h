@@ -187,6 +187,32 @@ public:
     }
 
     bool copyFolder (const File& source, const File& dest)
+    {
+        Array<File> sources, targets;
+
+        if (! findFilesToCopy (source, dest, sources, targets))
+            return false;
+
+        Atomic<int> numFailures;
+        threadPool.parallelFor (0, sources.size(), FileCopier (sources, targets, numFailures), 8);
+        return numFailures.get() == 0;
+    }
+
+private:
+    Project& project;
+    const File projectFile, generatedCodeFolder;
+    Project::Item generatedFilesGroup;
+    String extraAppConfigContent;
+    StringArray errors;
+    CriticalSection errorLock;
+
+    File appConfigFile;
+    SortedSet<File> filesCreated;
+    bool hasBinaryData;
+    ThreadPool threadPool;
+
+    // Creates the destination folders, and makes a list of the files that copyFolder() needs to copy.
+    bool findFilesToCopy (const File& source, const File& dest, Array<File>& sources, Array<File>& targets)
     {
         if (source.isDirectory() && dest.createDirectory())
         {
@@ -197,15 +223,15 @@ public:
             {
                 const File target (dest.getChildFile (subFiles.getReference(i).getFileName()));
                 filesCreated.add (target);
-                if (! subFiles.getReference(i).copyFileTo (target))
-                    return false;
+                sources.add (subFiles.getReference(i));
+                targets.add (target);
             }
 
             subFiles.clear();
             source.findChildFiles (subFiles, File::findDirectories, false);
 
             for (int i = 0; i < subFiles.size(); ++i)
-                if (! copyFolder (subFiles.getReference(i), dest.getChildFile (subFiles.getReference(i).getFileName())))
+                if (! findFilesToCopy (subFiles.getReference(i), dest.getChildFile (subFiles.getReference(i).getFileName()), sources, targets))
                     return false;
 
             return true;
@@ -214,17 +240,34 @@ public:
         return false;
     }
 
-private:
-    Project& project;
-    const File projectFile, generatedCodeFolder;
-    Project::Item generatedFilesGroup;
-    String extraAppConfigContent;
-    StringArray errors;
-    CriticalSection errorLock;
+    // Copies files, skipping any whose previous copy still has the same size and modification time.
+    struct FileCopier
+    {
+        FileCopier (const Array<File>& s, const Array<File>& t, Atomic<int>& failures)
+            : sources (s), targets (t), numFailures (failures)
+        {}
 
-    File appConfigFile;
-    SortedSet<File> filesCreated;
-    bool hasBinaryData;
+        void operator() (const int index) const
+        {
+            const File& source = sources.getReference (index);
+            const File& target = targets.getReference (index);
+            const Time sourceTime (source.getLastModificationTime());
+
+            if (target.getSize() == source.getSize()
+                 && target.getLastModificationTime() == sourceTime
+                 && target.existsAsFile())
+                return;
+
+            if (source.copyFileTo (target))
+                target.setLastModificationTime (sourceTime);
+            else
+                ++numFailures;
+        }
+
+        const Array<File>& sources;
+        const Array<File>& targets;
+        Atomic<int>& numFailures;
+    };
 
     // Recursively clears out any files in a folder that we didn't create, but avoids
     // any folders containing hidden files that might be used by version-control systems.
@@ -469,15 +512,21 @@ private:
         {
             resourceFile.setClassName ("BinaryData");
 
+            const String format (project.getBinaryDataFormat().toString());
+
+            if (format == "strings")          resourceFile.setDataFormat (ResourceFile::stringLiterals);
+            else if (format == "compressed")  resourceFile.setDataFormat (ResourceFile::compressed);
+
             Array<File> binaryDataFiles;
 
             int maxSize = project.getMaxBinaryFileSize().getValue();
             if (maxSize <= 0)
                 maxSize = 10 * 1024 * 1024;
 
-            if (resourceFile.write (binaryDataFiles, maxSize))
+            if (resourceFile.write (binaryDataFiles, maxSize, threadPool))
             {
                 hasBinaryData = true;
+                filesCreated.add (resourceFile.getManifestFile());
 
                 for (int i = 0; i < binaryDataFiles.size(); ++i)
                 {
@@ -499,6 +548,7 @@ private:
                 project.getBinaryDataCppFile (i).deleteFile();
 
             binaryDataH.deleteFile();
+            resourceFile.getManifestFile().deleteFile();
         }
     }
 
@@ -32,7 +32,8 @@ static const char* resourceFileIdentifierString = "JUCER_BINARY_RESOURCE";
 //==============================================================================
 ResourceFile::ResourceFile (Project& project_)
     : project (project_),
-      className ("BinaryData")
+      className ("BinaryData"),
+      dataFormat (byteArrays)
 {
     addResourcesFromProjectItem (project.getMainGroup());
 }
@@ -127,6 +128,167 @@ static String getComment()
     return comment;
 }
 
+// Packing the data into 64-bit ints needs far fewer tokens than writing out each byte, which
+// makes it much quicker for the compiler to parse. (MSVC only targets little-endian CPUs).
+static void writeDataAsLittleEndianInt64s (const MemoryBlock& mb, OutputStream& out)
+{
+    const uint8* const data = (const uint8*) mb.getData();
+    const size_t size = mb.getSize();
+
+    out << "{ ";
+
+    for (size_t i = 0; i <= size; i += 8)   // (always includes at least one zero byte as a terminator)
+    {
+        uint64 value = 0;
+
+        for (size_t j = jmin (i + 8, size); j > i;)
+            value = (value << 8) | data[--j];
+
+        out << "0x" << String::toHexString ((int64) value) << "ui64,";
+
+        if ((i & 0x1f8) == 0x1f8)
+            out << newLine;
+    }
+
+    out << " };";
+}
+
+//==============================================================================
+struct ResourceFile::Resource
+{
+    Resource (const File& f, const String& name)
+        : file (f), variableName (name), size (f.getSize()),
+          modificationTime (f.getLastModificationTime().toMilliseconds()),
+          contentHash (0), blockSize (0), hasBlock (false)
+    {}
+
+    // Reads the file and generates the section of a .cpp file that declares its data
+    void generateBlock (const DataFormat format)
+    {
+        block.setSize (0);
+
+        {
+            MemoryOutputStream out (block, false);
+            FileInputStream fileStream (file);
+
+            if (fileStream.openedOk())
+            {
+                MemoryBlock data;
+                fileStream.readIntoMemoryBlock (data);
+                contentHash = (int64) XXHash64::hash (data);
+
+                const String tempVariable ("temp_" + String::toHexString (file.hashCode()));
+                const size_t originalSize = data.getSize();
+
+                if (format == compressed)
+                {
+                    MemoryOutputStream compressedData;
+
+                    {
+                        GZIPCompressorOutputStream gzip (&compressedData, 9);
+                        gzip.write (data.getData(), data.getSize());
+                    }
+
+                    // (if it doesn't get any smaller, it's stored as it is, which getData() can
+                    // detect because the stored and original sizes are the same)
+                    if (compressedData.getDataSize() < originalSize)
+                        data = compressedData.getMemoryBlock();
+                }
+
+                out << newLine << "//================== " << file.getFileName() << " ==================" << newLine;
+
+                if (format == byteArrays)
+                {
+                    out << "static const unsigned char " << tempVariable << "[] =" << newLine;
+                    CodeHelpers::writeDataAsCppLiteral (data, out, true, true);
+                }
+                else if (data.getSize() < 65535)
+                {
+                    out << "static const unsigned char " << tempVariable << "[] =" << newLine;
+                    CodeHelpers::writeDataAsStringLiteral (data, out);
+                }
+                else
+                {
+                    out << "#ifdef _MSC_VER  // (MSVC can't cope with string literals longer than 64K)" << newLine
+                        << "static const unsigned __int64 " << tempVariable << "[] =" << newLine;
+                    writeDataAsLittleEndianInt64s (data, out);
+                    out << newLine
+                        << "#else" << newLine
+                        << "static const unsigned char " << tempVariable << "[] =" << newLine;
+                    CodeHelpers::writeDataAsStringLiteral (data, out);
+                    out << newLine
+                        << "#endif";
+                }
+
+                out << newLine << newLine;
+
+                if (format == compressed)
+                    out << "const CompressedResource " << variableName << " = { (const char*) " << tempVariable << ", "
+                        << (int) data.getSize() << ", " << (int) originalSize << ", 0 };" << newLine;
+                else
+                    out << "const char* " << variableName << " = (const char*) " << tempVariable << ";" << newLine;
+            }
+            else
+            {
+                contentHash = 0;
+            }
+        }
+
+        blockSize = (int64) block.getSize();
+        hasBlock = true;
+    }
+
+    const File file;
+    const String variableName;
+    const int64 size, modificationTime;
+    int64 contentHash, blockSize;
+    MemoryBlock block;
+    bool hasBlock;
+
+    JUCE_DECLARE_NON_COPYABLE (Resource)
+};
+
+struct ResourceFile::BlockGenerator
+{
+    BlockGenerator (const Array<Resource*>& r, DataFormat f) : resources (r), format (f) {}
+
+    void operator() (const int index) const
+    {
+        resources.getUnchecked (index)->generateBlock (format);
+    }
+
+    const Array<Resource*>& resources;
+    const DataFormat format;
+};
+
+struct ResourceFile::ChunkWriter
+{
+    ChunkWriter (const ResourceFile& o, const OwnedArray<Resource>& r, const Array<int>& chunks,
+                 const Array<int>& starts, const File& header, Atomic<int>& failures)
+        : owner (o), resources (r), chunksToWrite (chunks), chunkStarts (starts),
+          headerFile (header), numFailures (failures)
+    {}
+
+    void operator() (const int index) const
+    {
+        const int chunk = chunksToWrite.getUnchecked (index);
+
+        MemoryOutputStream mo;
+        owner.writeCpp (mo, headerFile, resources, chunkStarts.getUnchecked (chunk), chunkStarts.getUnchecked (chunk + 1));
+
+        if (! FileHelpers::overwriteFileWithNewDataIfDifferent (owner.project.getBinaryDataCppFile (chunk), mo))
+            ++numFailures;
+    }
+
+    const ResourceFile& owner;
+    const OwnedArray<Resource>& resources;
+    const Array<int>& chunksToWrite;
+    const Array<int>& chunkStarts;
+    const File headerFile;
+    Atomic<int>& numFailures;
+};
+
+//==============================================================================
 bool ResourceFile::writeHeader (MemoryOutputStream& header)
 {
     header << "/* ========================================================================================="
@@ -134,7 +296,22 @@ bool ResourceFile::writeHeader (MemoryOutputStream& header)
            << "namespace " << className << newLine
            << "{" << newLine;
 
-    bool containsAnyImages = false;
+    if (dataFormat == compressed)
+    {
+        header << "    // Each resource is stored compressed, and is decompressed the first time its data is used." << newLine
+               << "    struct CompressedResource" << newLine
+               << "    {" << newLine
+               << "        const char* getData() const;" << newLine
+               << "        operator const char*() const     { return getData(); }" << newLine
+               << newLine
+               << "        const char* storedData;" << newLine
+               << "        int storedSize, originalSize;" << newLine
+               << "        mutable const char* volatile decompressedData;" << newLine
+               << "    };" << newLine
+               << newLine;
+    }
+
+    const char* const dataType = (dataFormat == compressed) ? "const CompressedResource  " : "const char*   ";
 
     for (int i = 0; i < files.size(); ++i)
     {
@@ -147,12 +324,7 @@ bool ResourceFile::writeHeader (MemoryOutputStream& header)
 
         if (fileStream.openedOk())
         {
-            containsAnyImages = containsAnyImages
-                                 || (ImageFileFormat::findImageFormatForStream (fileStream) != nullptr);
-
-            const String tempVariable ("temp_" + String::toHexString (file.hashCode()));
-
-            header << "    extern const char*   " << variableName << ";" << newLine;
+            header << "    extern " << dataType << variableName << ";" << newLine;
             header << "    const int            " << variableName << "Size = " << (int) dataSize << ";" << newLine << newLine;
         }
     }
@@ -165,53 +337,34 @@ bool ResourceFile::writeHeader (MemoryOutputStream& header)
     return true;
 }
 
-bool ResourceFile::writeCpp (MemoryOutputStream& cpp, const File& headerFile, int& i, const int maxFileSize)
+void ResourceFile::writeCppPreamble (MemoryOutputStream& cpp) const
 {
-    const bool isFirstFile = (i == 0);
-
     cpp << "/* ==================================== " << resourceFileIdentifierString << " ===================================="
-        << getComment()
-        << "namespace " << className << newLine
-        << "{" << newLine;
-
-    bool containsAnyImages = false;
-
-    while (i < files.size())
-    {
-        const File& file = files.getReference(i);
-        const String variableName (variableNames[i]);
-
-        FileInputStream fileStream (file);
-
-        if (fileStream.openedOk())
-        {
-            containsAnyImages = containsAnyImages
-                                 || (ImageFileFormat::findImageFormatForStream (fileStream) != nullptr);
-
-            const String tempVariable ("temp_" + String::toHexString (file.hashCode()));
+        << getComment();
 
-            cpp  << newLine << "//================== " << file.getFileName() << " ==================" << newLine
-                << "static const unsigned char " << tempVariable << "[] =" << newLine;
-
-            {
-                MemoryBlock data;
-                fileStream.readIntoMemoryBlock (data);
-                CodeHelpers::writeDataAsCppLiteral (data, cpp, true, true);
-            }
+    if (dataFormat == compressed)
+        cpp << "#include \"" << project.getJuceSourceHFilename() << "\"" << newLine
+            << newLine;
 
-            cpp << newLine << newLine
-                << "const char* " << variableName << " = (const char*) " << tempVariable << ";" << newLine;
-        }
+    cpp << "namespace " << className << newLine
+        << "{" << newLine;
+}
 
-        ++i;
+void ResourceFile::writeCpp (MemoryOutputStream& cpp, const File& headerFile,
+                             const OwnedArray<Resource>& resources, const int start, const int end) const
+{
+    writeCppPreamble (cpp);
 
-        if (cpp.getPosition() > maxFileSize)
-            break;
+    for (int i = start; i < end; ++i)
+    {
+        const Resource& r = *resources.getUnchecked (i);
+        jassert (r.hasBlock);
+        cpp.write (r.block.getData(), r.block.getSize());
     }
 
-    if (isFirstFile)
+    if (start == 0)
     {
-        if (i < files.size())
+        if (end < files.size() && dataFormat != compressed)
         {
             cpp << newLine
                 << "}" << newLine
@@ -229,27 +382,79 @@ bool ResourceFile::writeCpp (MemoryOutputStream& cpp, const File& headerFile, in
             << "{" << newLine;
 
         StringArray returnCodes;
-        for (int j = 0; j < files.size(); ++j)
-        {
-            const File& file = files.getReference(j);
-            const int64 dataSize = file.getSize();
-            returnCodes.add ("numBytes = " + String (dataSize) + "; return " + variableNames[j] + ";");
-        }
+        for (int j = 0; j < resources.size(); ++j)
+            returnCodes.add ("numBytes = " + String (resources.getUnchecked(j)->size) + "; return " + variableNames[j] + ";");
 
         CodeHelpers::createStringMatcher (cpp, "resourceNameUTF8", variableNames, returnCodes, 4);
 
         cpp << "    numBytes = 0;" << newLine
             << "    return 0;" << newLine
             << "}" << newLine;
+
+        if (dataFormat == compressed)
+        {
+            cpp << newLine
+                << "static juce::CriticalSection decompressionLock;" << newLine
+                << newLine
+                << "const char* CompressedResource::getData() const" << newLine
+                << "{" << newLine
+                << "    if (storedSize == originalSize)" << newLine
+                << "        return storedData;" << newLine
+                << newLine
+                << "    if (decompressedData == 0)" << newLine
+                << "    {" << newLine
+                << "        const juce::ScopedLock sl (decompressionLock);" << newLine
+                << newLine
+                << "        if (decompressedData == 0)" << newLine
+                << "        {" << newLine
+                << "            juce::MemoryInputStream source (storedData, (size_t) storedSize, false);" << newLine
+                << "            juce::GZIPDecompressorInputStream gzip (source);" << newLine
+                << newLine
+                << "            // (this is never freed, so that it lives as long as the uncompressed resources do)" << newLine
+                << "            char* const data = new char [(size_t) originalSize + 1]();" << newLine
+                << "            gzip.read (data, originalSize);" << newLine
+                << "            decompressedData = data;" << newLine
+                << "        }" << newLine
+                << "    }" << newLine
+                << newLine
+                << "    return decompressedData;" << newLine
+                << "}" << newLine;
+        }
     }
 
     cpp << newLine
         << "}" << newLine;
+}
 
-    return true;
+// This hashes everything that affects the content of a .cpp file, so if the key is the
+// same as it was last time, the file doesn't need to be regenerated.
+String ResourceFile::getChunkKey (const OwnedArray<Resource>& resources, const File& headerFile,
+                                  const int start, const int end) const
+{
+    MemoryOutputStream mo;
+    mo << "3" << (int) dataFormat << className << headerFile.getFileName() << start << end << files.size();
+
+    for (int i = start; i < end; ++i)
+    {
+        const Resource& r = *resources.getUnchecked (i);
+        mo << r.file.getFullPathName() << r.variableName << r.contentHash << r.blockSize;
+    }
+
+    if (start == 0)
+        for (int i = 0; i < resources.size(); ++i)
+            mo << variableNames[i] << resources.getUnchecked(i)->size;
+
+    return String::toHexString ((int64) XXHash64::hash (mo.getData(), mo.getDataSize()));
 }
 
-bool ResourceFile::write (Array<File>& filesCreated, const int maxFileSize)
+File ResourceFile::getManifestFile() const
+{
+    return project.getBinaryDataHeaderFile().getSiblingFile (".BinaryDataManifest.xml");
+}
+
+static const char* manifestTag = "BINARYDATA_MANIFEST";
+
+bool ResourceFile::write (Array<File>& filesCreated, const int maxFileSize, ThreadPool& threadPool)
 {
     const File headerFile (project.getBinaryDataHeaderFile());
 
@@ -261,23 +466,138 @@ bool ResourceFile::write (Array<File>& filesCreated, const int maxFileSize)
         filesCreated.add (headerFile);
     }
 
-    int i = 0;
-    int fileIndex = 0;
+    ScopedPointer<XmlElement> oldManifest (XmlDocument::parse (getManifestFile()));
+
+    // (the block sizes it records depend on the format, so it's no use if that has changed)
+    if (oldManifest != nullptr && ! (oldManifest->hasTagName (manifestTag)
+                                      && oldManifest->getIntAttribute ("format") == (int) dataFormat))
+        oldManifest = nullptr;
+
+    HashMap<String, XmlElement*> oldEntries (jmax (101, files.size()));
 
-    for (;;)
+    if (oldManifest != nullptr)
+        forEachXmlChildElement (*oldManifest, e)
+            oldEntries.set (e->getStringAttribute ("path"), e);
+
+    // Any resources whose size and modification time haven't changed can use the hash and
+    // block size from the manifest - the rest need to be read and regenerated.
+    OwnedArray<Resource> resources;
+    Array<Resource*> resourcesToGenerate;
+
+    for (int i = 0; i < files.size(); ++i)
     {
-        File cpp (project.getBinaryDataCppFile (fileIndex));
+        Resource* const r = new Resource (files.getReference(i), variableNames[i]);
+        resources.add (r);
 
-        MemoryOutputStream mo;
-        if (! (writeCpp (mo, headerFile, i, maxFileSize) && FileHelpers::overwriteFileWithNewDataIfDifferent (cpp, mo)))
-            return false;
+        const XmlElement* const e = oldEntries [r->file.getFullPathName()];
 
+        if (e != nullptr && e->hasTagName ("RESOURCE")
+             && e->getStringAttribute ("size").getLargeIntValue() == r->size
+             && e->getStringAttribute ("modified").getLargeIntValue() == r->modificationTime)
+        {
+            r->contentHash = e->getStringAttribute ("hash").getHexValue64();
+            r->blockSize   = e->getStringAttribute ("blockSize").getLargeIntValue();
+        }
+        else
+        {
+            resourcesToGenerate.add (r);
+        }
+    }
+
+    threadPool.parallelFor (0, resourcesToGenerate.size(), BlockGenerator (resourcesToGenerate, dataFormat), 1);
+
+    // Split the resources between .cpp files in the same way as if each one was written in turn
+    Array<int> chunkStarts;
+
+    {
+        MemoryOutputStream preamble;
+        writeCppPreamble (preamble);
+
+        int i = 0;
+
+        do
+        {
+            chunkStarts.add (i);
+            int64 position = (int64) preamble.getDataSize();
+
+            while (i < resources.size())
+            {
+                position += resources.getUnchecked (i++)->blockSize;
+
+                if (position > maxFileSize)
+                    break;
+            }
+        }
+        while (i < resources.size());
+
+        chunkStarts.add (resources.size());
+    }
+
+    const int numChunks = chunkStarts.size() - 1;
+    ScopedPointer<XmlElement> newManifest (new XmlElement (manifestTag));
+    newManifest->setAttribute ("format", (int) dataFormat);
+    Array<int> chunksToWrite;
+    StringArray chunkKeys;
+
+    for (int chunk = 0; chunk < numChunks; ++chunk)
+    {
+        const File cpp (project.getBinaryDataCppFile (chunk));
+        const String key (getChunkKey (resources, headerFile, chunkStarts[chunk], chunkStarts[chunk + 1]));
+        chunkKeys.add (key);
         filesCreated.add (cpp);
-        ++fileIndex;
 
-        if (i >= files.size())
-            break;
+        const XmlElement* const e = oldEntries [cpp.getFullPathName()];
+
+        if (e == nullptr || ! e->hasTagName ("CPP")
+             || e->getStringAttribute ("key") != key
+             || e->getStringAttribute ("size").getLargeIntValue() != cpp.getSize()
+             || e->getStringAttribute ("modified").getLargeIntValue() != cpp.getLastModificationTime().toMilliseconds())
+        {
+            chunksToWrite.add (chunk);
+
+            resourcesToGenerate.clearQuick();
+
+            for (int i = chunkStarts[chunk]; i < chunkStarts[chunk + 1]; ++i)
+                if (! resources.getUnchecked(i)->hasBlock)
+                    resourcesToGenerate.add (resources.getUnchecked(i));
+
+            threadPool.parallelFor (0, resourcesToGenerate.size(), BlockGenerator (resourcesToGenerate, dataFormat), 1);
+        }
+    }
+
+    Atomic<int> numFailures;
+    threadPool.parallelFor (0, chunksToWrite.size(),
+                            ChunkWriter (*this, resources, chunksToWrite, chunkStarts, headerFile, numFailures), 1);
+
+    if (numFailures.get() != 0)
+    {
+        getManifestFile().deleteFile();
+        return false;
+    }
+
+    for (int i = 0; i < resources.size(); ++i)
+    {
+        const Resource& r = *resources.getUnchecked(i);
+
+        XmlElement* const e = newManifest->createNewChildElement ("RESOURCE");
+        e->setAttribute ("path", r.file.getFullPathName());
+        e->setAttribute ("size", String (r.size));
+        e->setAttribute ("modified", String (r.modificationTime));
+        e->setAttribute ("hash", String::toHexString (r.contentHash));
+        e->setAttribute ("blockSize", String (r.blockSize));
+    }
+
+    for (int chunk = 0; chunk < numChunks; ++chunk)
+    {
+        const File cpp (project.getBinaryDataCppFile (chunk));
+
+        XmlElement* const e = newManifest->createNewChildElement ("CPP");
+        e->setAttribute ("path", cpp.getFullPathName());
+        e->setAttribute ("key", chunkKeys[chunk]);
+        e->setAttribute ("size", String (cpp.getSize()));
+        e->setAttribute ("modified", String (cpp.getLastModificationTime().toMilliseconds()));
     }
 
+    newManifest->writeToFile (getManifestFile(), String::empty);
     return true;
 }
@@ -51,7 +51,26 @@ public:
     int getNumFiles() const                 { return files.size(); }
     int64 getTotalDataSize() const;
 
-    bool write (Array<File>& filesCreated, int maxFileSize);
+    enum DataFormat
+    {
+        byteArrays,         /**< Each resource is written as an array of decimal bytes. */
+        stringLiterals,     /**< Each resource is written as a string literal, which is much smaller and
+                                 quicker to compile. (Resources over 64K also get a version packed
+                                 into 64-bit ints for MSVC, which can't handle string literals that long). */
+        compressed          /**< Resources are gzipped and written as string literals, and are only
+                                 decompressed the first time their data is used. The generated
+                                 .cpp files include the project's JuceHeader.h to do this. */
+    };
+
+    void setDataFormat (DataFormat newFormat)       { dataFormat = newFormat; }
+    DataFormat getDataFormat() const                { return dataFormat; }
+
+    bool write (Array<File>& filesCreated, int maxFileSize, ThreadPool& threadPool);
+
+    /** Returns the file in which write() records the hashes of the resources and generated
+        files, so that it can skip regenerating any that haven't changed.
+    */
+    File getManifestFile() const;
 
     //==============================================================================
 private:
@@ -59,9 +78,16 @@ private:
     StringArray variableNames;
     Project& project;
     String className;
+    DataFormat dataFormat;
+
+    struct Resource;
+    struct BlockGenerator;
+    struct ChunkWriter;
 
     bool writeHeader (MemoryOutputStream&);
-    bool writeCpp (MemoryOutputStream&, const File& headerFile, int& index, int maxFileSize);
+    void writeCppPreamble (MemoryOutputStream&) const;
+    void writeCpp (MemoryOutputStream&, const File& headerFile, const OwnedArray<Resource>&, int start, int end) const;
+    String getChunkKey (const OwnedArray<Resource>&, const File& headerFile, int start, int end) const;
     void addResourcesFromProjectItem (const Project::Item& node);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ResourceFile)
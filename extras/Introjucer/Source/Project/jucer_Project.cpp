@@ -405,6 +405,16 @@ void Project::createPropertyEditors (PropertyListBuilder& props)
                    "(Note that individual resource files which are larger than this size cannot be split across multiple cpp files).");
     }
 
+    {
+        const char* formatNames[] = { "Byte arrays", "String literals", "Compressed string literals", nullptr };
+        const var formatCodes[]   = { var::null, "strings", "compressed" };
+
+        props.add (new ChoicePropertyComponent (getBinaryDataFormat(), "BinaryData format",
+                                                StringArray (formatNames), Array<var> (formatCodes, numElementsInArray (formatCodes))),
+                   "Byte arrays are the most portable, but string literals make the BinaryData.cpp files several times smaller and much "
+                   "quicker to compile. Compressed resources are also gzipped, and are decompressed the first time each one is used.");
+    }
+
     props.add (new TextPropertyComponent (getProjectPreprocessorDefs(), "Preprocessor definitions", 32768, true),
                "Global preprocessor definitions. Use the form \"NAME1=value NAME2=value\", using whitespace, commas, or "
                "new-lines to separate the items - to include a space or comma in a definition, precede it with a backslash.");
@@ -107,6 +107,7 @@ public:
     File getBinaryDataCppFile (int index) const;
     File getBinaryDataHeaderFile() const                { return getBinaryDataCppFile (0).withFileExtension (".h"); }
     Value getMaxBinaryFileSize()                        { return getProjectValue (Ids::maxBinaryFileSize); }
+    Value getBinaryDataFormat()                         { return getProjectValue (Ids::binaryDataFormat); }
 
     //==============================================================================
     String getAmalgamatedHeaderFileName() const         { return "juce_amalgamated.h"; }
@@ -178,9 +178,9 @@ namespace CodeHelpers
 
     String addEscapeChars (const String& s)
     {
-        MemoryOutputStream out;
+        StringBuilder out;
         writeEscapeChars (out, s.toRawUTF8(), -1, -1, false, true, true);
-        return out.toUTF8();
+        return out.toString();
     }
 
     String createIncludeStatement (const File& includeFile, const File& targetFile)
@@ -400,6 +400,55 @@ namespace CodeHelpers
         }
     }
 
+    void writeDataAsStringLiteral (const MemoryBlock& mb, OutputStream& out)
+    {
+        const int maxCharsOnLine = 250;
+
+        const unsigned char* const data = (const unsigned char*) mb.getData();
+        const size_t size = mb.getSize();
+        int charsOnLine = 0;
+
+        out << "\"";
+
+        for (size_t i = 0; i < size; ++i)
+        {
+            const unsigned int c = data[i];
+
+            if (c == '\\' || c == '"' || (c == '?' && i > 0 && data[i - 1] == '?')) // (avoid trigraphs)
+            {
+                out << '\\' << (char) c;
+                charsOnLine += 2;
+            }
+            else if (c >= 32 && c < 127)
+            {
+                out << (char) c;
+                ++charsOnLine;
+            }
+            else
+            {
+                // Octal escapes are never longer than 3 digits, so they only need padding
+                // when the next character is itself an octal digit.
+                const bool nextIsOctalDigit = i + 1 < size && data[i + 1] >= '0' && data[i + 1] <= '7';
+
+                out << '\\';
+
+                if (nextIsOctalDigit || c >= 64)  out << (char) ('0' + (c >> 6));
+                if (nextIsOctalDigit || c >= 8)   out << (char) ('0' + ((c >> 3) & 7));
+                out << (char) ('0' + (c & 7));
+
+                charsOnLine += 4;
+            }
+
+            if (charsOnLine >= maxCharsOnLine && i + 1 < size)
+            {
+                charsOnLine = 0;
+                out << "\"" << newLine << "\"";
+            }
+        }
+
+        out << "\";";
+    }
+
     //==============================================================================
     static unsigned int calculateHash (const String& s, const int hashMultiplier)
     {
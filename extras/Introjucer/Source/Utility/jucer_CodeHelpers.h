@@ -48,6 +48,7 @@ namespace CodeHelpers
 
     void writeDataAsCppLiteral (const MemoryBlock& data, OutputStream& out,
                                 bool breakAtNewLines, bool allowStringBreaks);
+    void writeDataAsStringLiteral (const MemoryBlock& data, OutputStream& out);
 
     void createStringMatcher (OutputStream& out, const String& utf8PointerVariable,
                               const StringArray& strings, const StringArray& codeToExecute, const int indentLevel);
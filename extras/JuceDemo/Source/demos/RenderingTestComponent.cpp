@@ -115,7 +115,13 @@ public:
         for (int i = 0; i < numElementsInArray (bouncingNumber); ++i)
             bounce (bouncingNumber[i], bouncingNumberDelta[i], 1.0f);
 
-        owner.speedLabel->setText (String (getWidth()) + "x" + String (getHeight())
+        // (showing the renderer in use makes it easy to compare them via the demo's rendering engine menu)
+        String renderer;
+
+        if (ComponentPeer* const peer = getPeer())
+            renderer = peer->getAvailableRenderingEngines() [peer->getCurrentRenderingEngine()] + " - ";
+
+        owner.speedLabel->setText (renderer + String (getWidth()) + "x" + String (getHeight())
                                     + " - Render time: " + String (averageTime, 2) + "ms",
                                    dontSendNotification);
 
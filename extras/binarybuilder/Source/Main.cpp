@@ -13,13 +13,116 @@
 
 
 //==============================================================================
+enum DataFormat
+{
+    byteArrays,
+    stringLiterals,
+    compressed
+};
+
+// Writes the data as a string literal, which is far smaller and quicker to compile than
+// a list of decimal bytes.
+static void writeStringLiteral (OutputStream& out, const uint8* data, const size_t size)
+{
+    out << "\"";
+    int charsOnLine = 0;
+
+    for (size_t i = 0; i < size; ++i)
+    {
+        const unsigned int c = data[i];
+
+        if (c == '\\' || c == '"' || (c == '?' && i > 0 && data[i - 1] == '?'))
+        {
+            out << '\\' << (char) c;
+            charsOnLine += 2;
+        }
+        else if (c >= 32 && c < 127)
+        {
+            out << (char) c;
+            ++charsOnLine;
+        }
+        else
+        {
+            // (an octal escape only needs all 3 digits if it's followed by another digit)
+            const bool padded = i + 1 < size && data[i + 1] >= '0' && data[i + 1] <= '7';
+
+            out << '\\';
+            if (padded || c >= 64)  out << (char) ('0' + (c >> 6));
+            if (padded || c >= 8)   out << (char) ('0' + ((c >> 3) & 7));
+            out << (char) ('0' + (c & 7));
+
+            charsOnLine += 4;
+        }
+
+        if (charsOnLine >= 200 && i + 1 < size)
+        {
+            out << "\"\r\n  \"";
+            charsOnLine = 0;
+        }
+    }
+
+    out << "\";\r\n";
+}
+
+static void writeByteArray (OutputStream& out, const uint8* data, const size_t size)
+{
+    out << "{";
+
+    for (size_t i = 0; i < size; ++i)
+    {
+        if ((i % 40) != 39)
+            out << (int) data[i] << ",";
+        else
+            out << (int) data[i] << ",\r\n  ";
+    }
+
+    out << "0,0};\r\n";
+}
+
+// (MSVC only targets little-endian CPUs, and parses this much more quickly than a list of bytes)
+static void writeLittleEndianInt64Array (OutputStream& out, const uint8* data, const size_t size)
+{
+    out << "{";
+
+    for (size_t i = 0; i <= size; i += 8)
+    {
+        uint64 value = 0;
+
+        for (size_t j = jmin (i + 8, size); j > i;)
+            value = (value << 8) | data[--j];
+
+        out << "0x" << String::toHexString ((int64) value) << "ui64,";
+
+        if ((i % 160) == 152)
+            out << "\r\n  ";
+    }
+
+    out << "};\r\n";
+}
+
 static int addFile (const File& file,
                     const String& classname,
                     OutputStream& headerStream,
-                    OutputStream& cppStream)
+                    OutputStream& cppStream,
+                    const DataFormat format)
 {
     MemoryBlock mb;
     file.loadFileAsData (mb);
+    const size_t originalSize = mb.getSize();
+
+    if (format == compressed)
+    {
+        MemoryOutputStream compressedData;
+
+        {
+            GZIPCompressorOutputStream gzip (&compressedData, 9);
+            gzip.write (mb.getData(), mb.getSize());
+        }
+
+        // (if it doesn't shrink, it's stored uncompressed, which the stored and original sizes being equal indicates)
+        if (compressedData.getDataSize() < originalSize)
+            mb = compressedData.getMemoryBlock();
+    }
 
     const String name (file.getFileName().toLowerCase()
                            .replaceCharacter (' ', '_')
@@ -27,35 +130,46 @@ static int addFile (const File& file,
                            .retainCharacters ("abcdefghijklmnopqrstuvwxyz_0123456789"));
 
     std::cout << "Adding " << name << ": "
-              << (int) mb.getSize() << " bytes" << std::endl;
+              << (int) originalSize << " bytes" << std::endl;
 
-    headerStream << "    extern const char*  " << name << ";\r\n"
+    headerStream << (format == compressed ? "    extern const CompressedResource  " : "    extern const char*  ") << name << ";\r\n"
                     "    const int           " << name << "Size = "
-                 << (int) mb.getSize() << ";\r\n\r\n";
+                 << (int) originalSize << ";\r\n\r\n";
 
     static int tempNum = 0;
+    ++tempNum;
 
-    cppStream << "static const unsigned char temp" << ++tempNum << "[] = {";
-
-    size_t i = 0;
     const uint8* const data = (const uint8*) mb.getData();
 
-    while (i < mb.getSize() - 1)
+    if (format == byteArrays)
     {
-        if ((i % 40) != 39)
-            cppStream << (int) data[i] << ",";
-        else
-            cppStream << (int) data[i] << ",\r\n  ";
-
-        ++i;
+        cppStream << "static const unsigned char temp" << tempNum << "[] = ";
+        writeByteArray (cppStream, data, mb.getSize());
+    }
+    else if (mb.getSize() < 65535)
+    {
+        cppStream << "static const unsigned char temp" << tempNum << "[] =\r\n  ";
+        writeStringLiteral (cppStream, data, mb.getSize());
+    }
+    else
+    {
+        cppStream << "#ifdef _MSC_VER  // (MSVC can't cope with string literals longer than 64K)\r\n"
+                     "static const unsigned __int64 temp" << tempNum << "[] = ";
+        writeLittleEndianInt64Array (cppStream, data, mb.getSize());
+        cppStream << "#else\r\n"
+                     "static const unsigned char temp" << tempNum << "[] =\r\n  ";
+        writeStringLiteral (cppStream, data, mb.getSize());
+        cppStream << "#endif\r\n";
     }
 
-    cppStream << (int) data[i] << ",0,0};\r\n";
-
-    cppStream << "const char* " << classname << "::" << name
-              << " = (const char*) temp" << tempNum << ";\r\n\r\n";
+    if (format == compressed)
+        cppStream << "const " << classname << "::CompressedResource " << classname << "::" << name
+                  << " = { (const char*) temp" << tempNum << ", " << (int) mb.getSize() << ", " << (int) originalSize << ", 0 };\r\n\r\n";
+    else
+        cppStream << "const char* " << classname << "::" << name
+                  << " = (const char*) temp" << tempNum << ";\r\n\r\n";
 
-    return mb.getSize();
+    return (int) originalSize;
 }
 
 static bool isHiddenFile (const File& f, const File& root)
@@ -73,21 +187,37 @@ int main (int argc, char* argv[])
 {
     std::cout << "\n BinaryBuilder! Copyright 2007 by Julian Storer - www.rawmaterialsoftware.com\n\n";
 
-    if (argc < 4 || argc > 5)
+    DataFormat format = byteArrays;
+    StringArray args;
+
+    for (int i = 1; i < argc; ++i)
     {
-        std::cout << " Usage: BinaryBuilder  sourcedirectory targetdirectory targetclassname [optional wildcard pattern]\n\n"
+        const String arg (argv[i]);
+
+        if (arg == "--strings")         format = stringLiterals;
+        else if (arg == "--compress")   format = compressed;
+        else                            args.add (arg);
+    }
+
+    if (args.size() < 3 || args.size() > 4)
+    {
+        std::cout << " Usage: BinaryBuilder  [--strings | --compress] sourcedirectory targetdirectory targetclassname [optional wildcard pattern]\n\n"
                      " BinaryBuilder will find all files in the source directory, and encode them\n"
                      " into two files called (targetclassname).cpp and (targetclassname).h, which it\n"
                      " will write into the target directory supplied.\n\n"
                      " Any files in sub-directories of the source directory will be put into the\n"
                      " resultant class, but #ifdef'ed out using the name of the sub-directory (hard to\n"
-                     " explain, but obvious when you try it...)\n";
+                     " explain, but obvious when you try it...)\n\n"
+                     " --strings writes the data as string literals rather than arrays of bytes, which makes\n"
+                     " the .cpp file much smaller and quicker to compile.\n\n"
+                     " --compress also gzips each file, and its data is decompressed the first time it's\n"
+                     " used. The .cpp file that this generates includes JuceHeader.h to do that.\n";
 
         return 0;
     }
 
     const File sourceDirectory (File::getCurrentWorkingDirectory()
-                                     .getChildFile (String (argv[1]).unquoted()));
+                                     .getChildFile (args[0].unquoted()));
 
     if (! sourceDirectory.isDirectory())
     {
@@ -99,7 +229,7 @@ int main (int argc, char* argv[])
     }
 
     const File destDirectory (File::getCurrentWorkingDirectory()
-                                   .getChildFile (String (argv[2]).unquoted()));
+                                   .getChildFile (args[1].unquoted()));
 
     if (! destDirectory.isDirectory())
     {
@@ -109,7 +239,7 @@ int main (int argc, char* argv[])
         return 0;
     }
 
-    String className (argv[3]);
+    String className (args[2]);
     className = className.trim();
 
     const File headerFile (destDirectory.getChildFile (className).withFileExtension (".h"));
@@ -122,7 +252,7 @@ int main (int argc, char* argv[])
 
     Array <File> files;
     sourceDirectory.findChildFiles (files, File::findFiles, true,
-                                    (argc > 4) ? argv[4] : "*");
+                                    (args.size() > 3) ? args[3] : "*");
 
     if (files.size() == 0)
     {
@@ -158,8 +288,48 @@ int main (int argc, char* argv[])
                "namespace " << className << "\r\n"
                "{\r\n";
 
-    *cpp << "/* (Auto-generated binary data file). */\r\n\r\n"
-            "#include \"" << className << ".h\"\r\n\r\n";
+    *cpp << "/* (Auto-generated binary data file). */\r\n\r\n";
+
+    if (format == compressed)
+    {
+        *header << "    // Each resource is stored compressed, and is decompressed the first time its data is used.\r\n"
+                   "    struct CompressedResource\r\n"
+                   "    {\r\n"
+                   "        const char* getData() const;\r\n"
+                   "        operator const char*() const     { return getData(); }\r\n\r\n"
+                   "        const char* storedData;\r\n"
+                   "        int storedSize, originalSize;\r\n"
+                   "        mutable const char* volatile decompressedData;\r\n"
+                   "    };\r\n\r\n";
+
+        *cpp << "#include \"JuceHeader.h\"\r\n";
+    }
+
+    *cpp << "#include \"" << className << ".h\"\r\n\r\n";
+
+    if (format == compressed)
+    {
+        *cpp << "static juce::CriticalSection decompressionLock;\r\n\r\n"
+                "const char* " << className << "::CompressedResource::getData() const\r\n"
+                "{\r\n"
+                "    if (storedSize == originalSize)\r\n"
+                "        return storedData;\r\n\r\n"
+                "    if (decompressedData == 0)\r\n"
+                "    {\r\n"
+                "        const juce::ScopedLock sl (decompressionLock);\r\n\r\n"
+                "        if (decompressedData == 0)\r\n"
+                "        {\r\n"
+                "            juce::MemoryInputStream source (storedData, (size_t) storedSize, false);\r\n"
+                "            juce::GZIPDecompressorInputStream gzip (source);\r\n\r\n"
+                "            // (this is never freed, so that it lives as long as the uncompressed resources do)\r\n"
+                "            char* const data = new char [(size_t) originalSize + 1]();\r\n"
+                "            gzip.read (data, originalSize);\r\n"
+                "            decompressedData = data;\r\n"
+                "        }\r\n"
+                "    }\r\n\r\n"
+                "    return decompressedData;\r\n"
+                "}\r\n\r\n";
+    }
 
     int totalBytes = 0;
 
@@ -175,14 +345,14 @@ int main (int argc, char* argv[])
                 *header << "  #ifdef " << file.getParentDirectory().getFileName().toUpperCase() << "\r\n";
                 *cpp << "#ifdef " << file.getParentDirectory().getFileName().toUpperCase() << "\r\n";
 
-                totalBytes += addFile (file, className, *header, *cpp);
+                totalBytes += addFile (file, className, *header, *cpp, format);
 
                 *header << "  #endif\r\n";
                 *cpp << "#endif\r\n";
             }
             else
             {
-                totalBytes += addFile (file, className, *header, *cpp);
+                totalBytes += addFile (file, className, *header, *cpp, format);
             }
         }
     }
@@ -22,6 +22,616 @@
   ==============================================================================
 */
 
+#if (JUCE_USE_SSE_INTRINSICS || JUCE_USE_ARM_NEON) && JUCE_LITTLE_ENDIAN
+ #define JUCE_USE_SIMD_AUDIO_CONVERSIONS 1
+#endif
+
+namespace AudioDataConversionHelpers
+{
+    typedef AudioData::BlockConversions BC;
+
+    inline uint32 readWord (const char* src) noexcept                       { uint32 v; memcpy (&v, src, sizeof (v)); return v; }
+    inline void writeBytes (char* dest, uint32 word, int numBytes) noexcept { memcpy (dest, &word, (size_t) numBytes); }
+
+   #if JUCE_USE_SIMD_AUDIO_CONVERSIONS
+    //==============================================================================
+    // The kernels below treat each sample as a 32-bit word loaded from its first byte (the
+    // bytes after the sample are just ignored), so every conversion becomes a few shifts and
+    // masks on 4 samples at once - that's why they're only used on little-endian CPUs.
+   #if JUCE_USE_SSE_INTRINSICS
+    static bool sse2Present = false;
+
+    static bool isSIMDAvailable() noexcept
+    {
+        if (sse2Present)
+            return true;
+
+        sse2Present = SystemStats::hasSSE2();
+        return sse2Present;
+    }
+
+    struct Lanes
+    {
+        typedef __m128i Ints;
+        typedef __m128  Floats;
+
+        static forcedinline Ints load (const char* src) noexcept                    { return _mm_loadu_si128 ((const __m128i*) src); }
+        static forcedinline void store (char* dest, Ints v) noexcept                { _mm_storeu_si128 ((__m128i*) dest, v); }
+        static forcedinline Ints set (int v) noexcept                               { return _mm_set1_epi32 (v); }
+        static forcedinline Ints bitAnd (Ints a, Ints b) noexcept                   { return _mm_and_si128 (a, b); }
+        static forcedinline Ints bitOr (Ints a, Ints b) noexcept                    { return _mm_or_si128 (a, b); }
+        template <int n> static forcedinline Ints shl (Ints a) noexcept             { return _mm_slli_epi32 (a, n); }
+        template <int n> static forcedinline Ints shr (Ints a) noexcept             { return _mm_srli_epi32 (a, n); }
+
+        static forcedinline Ints gather (const char* src, int stride) noexcept
+        {
+            return _mm_set_epi32 ((int) readWord (src + 3 * stride), (int) readWord (src + 2 * stride),
+                                  (int) readWord (src + stride),     (int) readWord (src));
+        }
+
+        static forcedinline void zip (Ints a, Ints b, Ints& lo, Ints& hi) noexcept  { lo = _mm_unpacklo_epi32 (a, b); hi = _mm_unpackhi_epi32 (a, b); }
+
+        static forcedinline void storeLow16 (char* dest, Ints a) noexcept
+        {
+            a = _mm_srai_epi32 (_mm_slli_epi32 (a, 16), 16); // (sign-extend, so that the saturating pack leaves it unchanged)
+            _mm_storel_epi64 ((__m128i*) dest, _mm_packs_epi32 (a, a));
+        }
+
+        // (the top byte of each word must be zero)
+        static forcedinline void storeLow24 (char* dest, Ints a) noexcept
+        {
+            const __m128i pairs = _mm_or_si128 (_mm_and_si128 (a, _mm_set_epi32 (0, -1, 0, -1)),
+                                                _mm_and_si128 (_mm_srli_epi64 (a, 8), _mm_set_epi32 (0xffff, (int) 0xff000000, 0xffff, (int) 0xff000000)));
+            const __m128i packed = _mm_or_si128 (_mm_move_epi64 (pairs), _mm_slli_si128 (_mm_srli_si128 (pairs, 8), 6));
+            _mm_storel_epi64 ((__m128i*) dest, packed);
+            writeBytes (dest + 8, (uint32) _mm_cvtsi128_si32 (_mm_srli_si128 (packed, 8)), 4);
+        }
+
+        static forcedinline Floats setFloats (float v) noexcept                     { return _mm_set1_ps (v); }
+        static forcedinline Floats toFloats (Ints a) noexcept                       { return _mm_cvtepi32_ps (a); }
+        static forcedinline Floats asFloats (Ints a) noexcept                       { return _mm_castsi128_ps (a); }
+        static forcedinline Ints asInts (Floats a) noexcept                         { return _mm_castps_si128 (a); }
+        static forcedinline Floats mul (Floats a, Floats b) noexcept                { return _mm_mul_ps (a, b); }
+    };
+
+    /*  The plain loops do their scaling and clipping in double precision, so to get exactly
+        the same results, these do too.
+    */
+    static forcedinline __m128i scaleToInts (const float* src, __m128d scale, __m128d limit) noexcept
+    {
+        const __m128 v = _mm_loadu_ps (src);
+        const __m128d negLimit = _mm_sub_pd (_mm_setzero_pd(), limit);
+        const __m128d lo = _mm_min_pd (_mm_max_pd (_mm_mul_pd (_mm_cvtps_pd (v), scale), negLimit), limit);
+        const __m128d hi = _mm_min_pd (_mm_max_pd (_mm_mul_pd (_mm_cvtps_pd (_mm_movehl_ps (v, v)), scale), negLimit), limit);
+
+        return _mm_unpacklo_epi64 (_mm_cvtpd_epi32 (lo), _mm_cvtpd_epi32 (hi));
+    }
+
+    // (SSE2 has no 32-bit multiply, so this does it with two 32x32->64 bit ones)
+    static forcedinline __m128i multiplyLanes (__m128i a, __m128i b) noexcept
+    {
+        const __m128i evenLanes = _mm_mul_epu32 (a, b);
+        const __m128i oddLanes  = _mm_mul_epu32 (_mm_srli_epi64 (a, 32), _mm_srli_epi64 (b, 32));
+
+        return _mm_unpacklo_epi32 (_mm_shuffle_epi32 (evenLanes, _MM_SHUFFLE (0, 0, 2, 0)),
+                                   _mm_shuffle_epi32 (oddLanes,  _MM_SHUFFLE (0, 0, 2, 0)));
+    }
+
+   #elif JUCE_USE_ARM_NEON
+    static bool isSIMDAvailable() noexcept   { return true; }
+
+    struct Lanes
+    {
+        typedef int32x4_t   Ints;
+        typedef float32x4_t Floats;
+
+        static forcedinline Ints load (const char* src) noexcept                    { return vreinterpretq_s32_u8 (vld1q_u8 ((const uint8*) src)); }
+        static forcedinline void store (char* dest, Ints v) noexcept                { vst1q_u8 ((uint8*) dest, vreinterpretq_u8_s32 (v)); }
+        static forcedinline Ints set (int v) noexcept                               { return vdupq_n_s32 (v); }
+        static forcedinline Ints bitAnd (Ints a, Ints b) noexcept                   { return vandq_s32 (a, b); }
+        static forcedinline Ints bitOr (Ints a, Ints b) noexcept                    { return vorrq_s32 (a, b); }
+        template <int n> static forcedinline Ints shl (Ints a) noexcept             { return vshlq_n_s32 (a, n); }
+        template <int n> static forcedinline Ints shr (Ints a) noexcept             { return vreinterpretq_s32_u32 (vshrq_n_u32 (vreinterpretq_u32_s32 (a), n)); }
+
+        static forcedinline Ints gather (const char* src, int stride) noexcept
+        {
+            const uint32 words[4] = { readWord (src), readWord (src + stride), readWord (src + 2 * stride), readWord (src + 3 * stride) };
+            return vreinterpretq_s32_u32 (vld1q_u32 (words));
+        }
+
+        static forcedinline void zip (Ints a, Ints b, Ints& lo, Ints& hi) noexcept  { const int32x4x2_t z = vzipq_s32 (a, b); lo = z.val[0]; hi = z.val[1]; }
+        static forcedinline void storeLow16 (char* dest, Ints a) noexcept           { vst1_u8 ((uint8*) dest, vreinterpret_u8_s16 (vmovn_s32 (a))); }
+
+        static forcedinline void storeLow24 (char* dest, Ints a) noexcept
+        {
+            const uint8x16_t bytes (vreinterpretq_u8_s32 (a));
+            const uint8x8_t lo (vget_low_u8 (bytes)), hi (vget_high_u8 (bytes));
+            static const uint8 order[] = { 0, 1, 2, 4, 5, 6, 8, 9 };
+            const uint8x8x2_t table = {{ lo, hi }};
+            vst1_u8 ((uint8*) dest, vtbl2_u8 (table, vld1_u8 (order)));
+            dest[8] = (char) vgetq_lane_u8 (bytes, 10);
+            dest[9] = (char) vgetq_lane_u8 (bytes, 12);
+            dest[10] = (char) vgetq_lane_u8 (bytes, 13);
+            dest[11] = (char) vgetq_lane_u8 (bytes, 14);
+        }
+
+        static forcedinline Floats setFloats (float v) noexcept                     { return vdupq_n_f32 (v); }
+        static forcedinline Floats toFloats (Ints a) noexcept                       { return vcvtq_f32_s32 (a); }
+        static forcedinline Floats asFloats (Ints a) noexcept                       { return vreinterpretq_f32_s32 (a); }
+        static forcedinline Ints asInts (Floats a) noexcept                         { return vreinterpretq_s32_f32 (a); }
+        static forcedinline Floats mul (Floats a, Floats b) noexcept                { return vmulq_f32 (a, b); }
+    };
+   #endif
+
+    typedef Lanes::Ints Ints;
+    typedef Lanes::Floats Floats;
+
+    //==============================================================================
+    // Converts between a sample's raw word and a full-range 32-bit int (or for the float
+    // formats, the float's bits).
+    template <int format> struct Codec {};
+
+    template <> struct Codec <BC::int16LE>
+    {
+        enum { bytesPerSample = 2, isFloat = 0 };
+        static forcedinline Ints decode (Ints w) noexcept   { return Lanes::shl<16> (w); }
+        static forcedinline Ints encode (Ints x) noexcept   { return Lanes::shr<16> (x); }
+    };
+
+    template <> struct Codec <BC::int16BE>
+    {
+        enum { bytesPerSample = 2, isFloat = 0 };
+        static forcedinline Ints decode (Ints w) noexcept   { return Lanes::bitOr (Lanes::shl<24> (w), Lanes::shl<8> (Lanes::bitAnd (w, Lanes::set (0xff00)))); }
+        static forcedinline Ints encode (Ints x) noexcept   { return Lanes::bitOr (Lanes::shr<24> (x), Lanes::bitAnd (Lanes::shr<8> (x), Lanes::set (0xff00))); }
+    };
+
+    template <> struct Codec <BC::int24LE>
+    {
+        enum { bytesPerSample = 3, isFloat = 0 };
+        static forcedinline Ints decode (Ints w) noexcept   { return Lanes::shl<8> (w); }
+        static forcedinline Ints encode (Ints x) noexcept   { return Lanes::shr<8> (x); }
+    };
+
+    template <> struct Codec <BC::int24BE>
+    {
+        enum { bytesPerSample = 3, isFloat = 0 };
+
+        static forcedinline Ints decode (Ints w) noexcept
+        {
+            return Lanes::bitOr (Lanes::bitOr (Lanes::shl<24> (w), Lanes::shl<8> (Lanes::bitAnd (w, Lanes::set (0xff00)))),
+                                 Lanes::shr<8> (Lanes::bitAnd (w, Lanes::set (0xff0000))));
+        }
+
+        static forcedinline Ints encode (Ints x) noexcept
+        {
+            return Lanes::bitOr (Lanes::bitOr (Lanes::shr<24> (x), Lanes::bitAnd (Lanes::shr<8> (x), Lanes::set (0xff00))),
+                                 Lanes::bitAnd (Lanes::shl<8> (x), Lanes::set (0xff0000)));
+        }
+    };
+
+    struct SwappedWordCodec
+    {
+        static forcedinline Ints decode (Ints w) noexcept
+        {
+            return Lanes::bitOr (Lanes::bitOr (Lanes::shl<24> (w), Lanes::shl<8> (Lanes::bitAnd (w, Lanes::set (0xff00)))),
+                                 Lanes::bitOr (Lanes::bitAnd (Lanes::shr<8> (w), Lanes::set (0xff00)), Lanes::shr<24> (w)));
+        }
+
+        static forcedinline Ints encode (Ints x) noexcept   { return decode (x); }
+    };
+
+    struct WordCodec
+    {
+        static forcedinline Ints decode (Ints w) noexcept   { return w; }
+        static forcedinline Ints encode (Ints x) noexcept   { return x; }
+    };
+
+    template <> struct Codec <BC::int32LE>   : public WordCodec          { enum { bytesPerSample = 4, isFloat = 0 }; };
+    template <> struct Codec <BC::int32BE>   : public SwappedWordCodec   { enum { bytesPerSample = 4, isFloat = 0 }; };
+    template <> struct Codec <BC::float32LE> : public WordCodec          { enum { bytesPerSample = 4, isFloat = 1 }; };
+    template <> struct Codec <BC::float32BE> : public SwappedWordCodec   { enum { bytesPerSample = 4, isFloat = 1 }; };
+
+    //==============================================================================
+    /*  Calls op.process (dest, words) for each group of 4 samples that can be loaded as words
+        without reading past the end of the data, and returns the number of samples done.
+    */
+    template <int format, class Op>
+    static int forEachGroupOfWords (const char* src, const int stride, const int num, Op& op) noexcept
+    {
+        typedef Codec<format> C;
+        const int numSafe = num - ((int) C::bytesPerSample < 4 ? 1 : 0); // the last sample isn't followed by a whole word
+        int i = 0;
+
+        if ((int) C::bytesPerSample == 2 && stride == 2)
+        {
+            for (; i + 8 <= num; i += 8)
+            {
+                const Ints w (Lanes::load (src + 2 * i));
+                Ints lo, hi;
+                Lanes::zip (w, Lanes::shr<16> (w), lo, hi);
+                op.process (i, lo);
+                op.process (i + 4, hi);
+            }
+        }
+        else if (stride == 4)
+        {
+            for (; i + 4 <= numSafe; i += 4)
+                op.process (i, Lanes::load (src + 4 * i));
+        }
+        else
+        {
+            for (; i + 4 <= numSafe; i += 4)
+                op.process (i, Lanes::gather (src + stride * i, stride));
+        }
+
+        return i;
+    }
+
+    template <int format>
+    struct ToInt32Op
+    {
+        ToInt32Op (int32* d) noexcept : dest (d) {}
+        forcedinline void process (int i, Ints w) noexcept    { Lanes::store ((char*) (dest + i), Codec<format>::decode (w)); }
+        int32* dest;
+    };
+
+    template <int format>
+    struct ToFloatOp
+    {
+        ToFloatOp (float* d, float s) noexcept : dest (d), scale (Lanes::setFloats (s)) {}
+
+        forcedinline void process (int i, Ints w) noexcept
+        {
+            const Ints x (Codec<format>::decode (w));
+            Lanes::store ((char*) (dest + i), Codec<format>::isFloat ? x : Lanes::asInts (Lanes::mul (Lanes::toFloats (x), scale)));
+        }
+
+        float* dest;
+        Floats scale;
+    };
+
+    template <int format>
+    static forcedinline void storeWords (char* dest, const int stride, Ints words) noexcept
+    {
+        const int bytesPerSample = (int) Codec<format>::bytesPerSample;
+
+        if (stride == bytesPerSample)
+        {
+            if (bytesPerSample == 4)        Lanes::store (dest, words);
+            else if (bytesPerSample == 3)   Lanes::storeLow24 (dest, words);
+            else                            Lanes::storeLow16 (dest, words);
+        }
+        else
+        {
+            uint32 w[4];
+            Lanes::store ((char*) w, words);
+
+            for (int i = 0; i < 4; ++i)
+                writeBytes (dest + i * stride, w[i], bytesPerSample);
+        }
+    }
+
+    //==============================================================================
+    /*  The scale passed in here gets applied to the full-range 32-bit value, so e.g. to get
+        AudioData's 16-bit scaling of 1/0x8000, pass 1/0x80000000.
+    */
+    template <int format>
+    static int intsToFloats (float* dest, const char* src, int stride, int num, float scale) noexcept
+    {
+        ToFloatOp<format> op (dest, scale);
+        return forEachGroupOfWords<format> (src, stride, num, op);
+    }
+
+    template <int format>
+    static int intsToInt32 (int32* dest, const char* src, int stride, int num) noexcept
+    {
+        ToInt32Op<format> op (dest);
+        return forEachGroupOfWords<format> (src, stride, num, op);
+    }
+
+    template <int format>
+    static int int32ToInts (char* dest, int stride, const int32* src, int num) noexcept
+    {
+        typedef Codec<format> C;
+        const Floats scale (Lanes::setFloats ((float) (1.0 / 0x80000000u)));
+        int i = 0;
+
+        if ((int) C::bytesPerSample < 4 && stride != (int) C::bytesPerSample)
+            return 0; // (when it's just shifting and scattering small ints, the plain loop's just as quick)
+
+        for (; i + 4 <= num; i += 4)
+        {
+            const Ints x (Lanes::load ((const char*) (src + i)));
+            storeWords<format> (dest + i * stride, stride,
+                                C::encode (C::isFloat ? Lanes::asInts (Lanes::mul (Lanes::toFloats (x), scale)) : x));
+        }
+
+        return i;
+    }
+
+    template <int format>
+    static int floatsToFloats (char* dest, int stride, const float* src, int num) noexcept
+    {
+        int i = 0;
+
+        for (; i + 4 <= num; i += 4)
+            storeWords<format> (dest + i * stride, stride, Codec<format>::encode (Lanes::load ((const char*) (src + i))));
+
+        return i;
+    }
+
+   #if JUCE_USE_SSE_INTRINSICS
+    /*  Does roundToInt (jlimit (-scale, scale, value * scale)) in double precision, and then
+        shifts the result up to make it a full-range 32-bit value.
+    */
+    template <int format>
+    static int floatsToIntsDouble (char* dest, int stride, const float* src, int num, double scale, int shift) noexcept
+    {
+        const __m128d s (_mm_set1_pd (scale));
+        const __m128i shiftCount (_mm_cvtsi32_si128 (shift));
+        int i = 0;
+
+        for (; i + 4 <= num; i += 4)
+            storeWords<format> (dest + i * stride, stride,
+                                Codec<format>::encode (_mm_sll_epi32 (scaleToInts (src + i, s, s), shiftCount)));
+
+        return i;
+    }
+
+    template <int format>
+    static int floatFormatToInt32 (int32* dest, const char* src, int stride, int num) noexcept
+    {
+        float temp[4];
+        const __m128d scale (_mm_set1_pd ((double) 0x7fffffff));
+        int i = 0;
+
+        if (stride == 4)
+        {
+            for (; i + 4 <= num; i += 4)
+            {
+                Lanes::store ((char*) temp, Codec<format>::decode (Lanes::load (src + 4 * i)));
+                _mm_storeu_si128 ((__m128i*) (dest + i), scaleToInts (temp, scale, scale));
+            }
+        }
+
+        return i;
+    }
+   #endif
+   #endif
+
+    //==============================================================================
+    // These do as much of one of the AudioDataConverters loops as they can, and return the
+    // number of samples that they've done.
+    template <int format>
+    static int convertFloatsToInts (const float* source, char* dest, int destBytesPerSample, int numSamples, double maxVal) noexcept
+    {
+        // (the AudioDataConverters methods pass in their own DataFormat values)
+        static_jassert ((int) AudioDataConverters::int16LE == (int) BC::int16LE && (int) AudioDataConverters::float32BE == (int) BC::float32BE);
+
+       #if JUCE_USE_SIMD_AUDIO_CONVERSIONS && JUCE_USE_SSE_INTRINSICS
+        if (isSIMDAvailable())
+            return floatsToIntsDouble<format> (dest, destBytesPerSample, source, numSamples, maxVal,
+                                               32 - 8 * (int) Codec<format>::bytesPerSample);
+       #endif
+
+        (void) source; (void) dest; (void) destBytesPerSample; (void) numSamples; (void) maxVal;
+        return 0;
+    }
+
+    template <int format>
+    static int convertIntsToFloats (const char* source, int srcBytesPerSample, float* dest, int numSamples, float scale) noexcept
+    {
+       #if JUCE_USE_SIMD_AUDIO_CONVERSIONS
+        if (isSIMDAvailable())
+            return intsToFloats<format> (dest, source, srcBytesPerSample, numSamples,
+                                         scale / (float) (1 << (32 - 8 * (int) Codec<format>::bytesPerSample)));
+       #endif
+
+        (void) source; (void) srcBytesPerSample; (void) dest; (void) numSamples; (void) scale;
+        return 0;
+    }
+
+    static bool interleaveStereo (const float* left, const float* right, float* dest, const int numSamples) noexcept
+    {
+        int i = 0;
+
+       #if JUCE_USE_SIMD_AUDIO_CONVERSIONS
+        if (! isSIMDAvailable())
+            return false;
+
+        for (; i + 4 <= numSamples; i += 4)
+        {
+           #if JUCE_USE_SSE_INTRINSICS
+            const __m128 l (_mm_loadu_ps (left + i)), r (_mm_loadu_ps (right + i));
+            _mm_storeu_ps (dest + 2 * i,     _mm_unpacklo_ps (l, r));
+            _mm_storeu_ps (dest + 2 * i + 4, _mm_unpackhi_ps (l, r));
+           #else
+            float32x4x2_t lr;
+            lr.val[0] = vld1q_f32 (left + i);
+            lr.val[1] = vld1q_f32 (right + i);
+            vst2q_f32 (dest + 2 * i, lr);
+           #endif
+        }
+       #else
+        return false;
+       #endif
+
+        for (; i < numSamples; ++i)
+        {
+            dest [2 * i]     = left [i];
+            dest [2 * i + 1] = right [i];
+        }
+
+        return true;
+    }
+
+    static bool deinterleaveStereo (const float* source, float* left, float* right, const int numSamples) noexcept
+    {
+        int i = 0;
+
+       #if JUCE_USE_SIMD_AUDIO_CONVERSIONS
+        if (! isSIMDAvailable())
+            return false;
+
+        for (; i + 4 <= numSamples; i += 4)
+        {
+           #if JUCE_USE_SSE_INTRINSICS
+            const __m128 a (_mm_loadu_ps (source + 2 * i)), b (_mm_loadu_ps (source + 2 * i + 4));
+            _mm_storeu_ps (left + i,  _mm_shuffle_ps (a, b, _MM_SHUFFLE (2, 0, 2, 0)));
+            _mm_storeu_ps (right + i, _mm_shuffle_ps (a, b, _MM_SHUFFLE (3, 1, 3, 1)));
+           #else
+            const float32x4x2_t lr (vld2q_f32 (source + 2 * i));
+            vst1q_f32 (left + i,  lr.val[0]);
+            vst1q_f32 (right + i, lr.val[1]);
+           #endif
+        }
+       #else
+        return false;
+       #endif
+
+        for (; i < numSamples; ++i)
+        {
+            left [i]  = source [2 * i];
+            right [i] = source [2 * i + 1];
+        }
+
+        return true;
+    }
+
+    //==============================================================================
+    /*  Works out the dither noise for 16-bit conversions: each sample gets the difference
+        between two uniform random values, from successive steps of a linear congruential
+        generator, which gives a triangular distribution of +/- 1 LSB.
+    */
+    struct DitherGenerator
+    {
+        enum { multiplier = 1664525, increment = 1013904223 };
+
+        static forcedinline uint32 next (uint32& state) noexcept
+        {
+            state = state * (uint32) multiplier + (uint32) increment;
+            return state >> 16;
+        }
+
+        static forcedinline double getNoise (uint32& state) noexcept
+        {
+            const int a = (int) next (state);
+            return (a - (int) next (state)) * (1.0 / 65536.0);
+        }
+    };
+
+    template <bool bigEndian>
+    static void convertFloatToInt16Dithered (const float* source, void* dest, int numSamples,
+                                             uint32& ditherState, const int destBytesPerSample) noexcept
+    {
+        const double maxVal = (double) 0x7fff;
+        char* intData = static_cast <char*> (dest);
+        int i = 0;
+
+       #if JUCE_USE_SIMD_AUDIO_CONVERSIONS && JUCE_USE_SSE_INTRINSICS
+        if (numSamples >= 8 && isSIMDAvailable())
+        {
+            // Each group of 4 samples uses the next 8 steps of the generator, so two sets of
+            // 4 lanes (the odd and even steps) can each jump ahead by 8 steps at a time.
+            uint32 a8 = 1, c8 = 0;
+
+            for (int step = 0; step < 8; ++step)
+            {
+                a8 *= (uint32) DitherGenerator::multiplier;
+                c8 = c8 * (uint32) DitherGenerator::multiplier + (uint32) DitherGenerator::increment;
+            }
+
+            uint32 states[8];
+            uint32 s = ditherState;
+
+            for (int step = 0; step < 8; ++step)
+            {
+                DitherGenerator::next (s);
+                states[step] = s;
+            }
+
+            __m128i odd  = _mm_set_epi32 ((int) states[6], (int) states[4], (int) states[2], (int) states[0]);
+            __m128i even = _mm_set_epi32 ((int) states[7], (int) states[5], (int) states[3], (int) states[1]);
+            const __m128i mult = _mm_set1_epi32 ((int) a8), inc = _mm_set1_epi32 ((int) c8);
+            const __m128d scale = _mm_set1_pd (maxVal), noiseScale = _mm_set1_pd (1.0 / 65536.0);
+            const __m128d limit = scale, negLimit = _mm_sub_pd (_mm_setzero_pd(), limit);
+            __m128i lastEven = even;
+
+            for (; i + 4 <= numSamples; i += 4)
+            {
+                const __m128i noise = _mm_sub_epi32 (_mm_srli_epi32 (odd, 16), _mm_srli_epi32 (even, 16));
+                const __m128 v = _mm_loadu_ps (source + i);
+
+                const __m128d lo = _mm_min_pd (_mm_max_pd (_mm_add_pd (_mm_mul_pd (_mm_cvtps_pd (v), scale),
+                                                                        _mm_mul_pd (_mm_cvtepi32_pd (noise), noiseScale)), negLimit), limit);
+                const __m128d hi = _mm_min_pd (_mm_max_pd (_mm_add_pd (_mm_mul_pd (_mm_cvtps_pd (_mm_movehl_ps (v, v)), scale),
+                                                                        _mm_mul_pd (_mm_cvtepi32_pd (_mm_unpackhi_epi64 (noise, noise)), noiseScale)), negLimit), limit);
+
+                const __m128i n (_mm_unpacklo_epi64 (_mm_cvtpd_epi32 (lo), _mm_cvtpd_epi32 (hi)));
+
+                if (bigEndian)
+                    storeWords<BC::int16BE> (intData + i * destBytesPerSample, destBytesPerSample, Codec<BC::int16BE>::encode (_mm_slli_epi32 (n, 16)));
+                else
+                    storeWords<BC::int16LE> (intData + i * destBytesPerSample, destBytesPerSample, Codec<BC::int16LE>::encode (_mm_slli_epi32 (n, 16)));
+
+                lastEven = even;
+                odd  = _mm_add_epi32 (multiplyLanes (odd,  mult), inc);
+                even = _mm_add_epi32 (multiplyLanes (even, mult), inc);
+            }
+
+            // carry on from the last step that was used
+            uint32 lastStates[4];
+            _mm_storeu_si128 ((__m128i*) lastStates, lastEven);
+            ditherState = lastStates[3];
+        }
+       #endif
+
+        for (; i < numSamples; ++i)
+        {
+            const double value = maxVal * source[i] + DitherGenerator::getNoise (ditherState);
+            const uint16 n = (uint16) (short) roundToInt (jlimit (-maxVal, maxVal, value));
+            *(uint16*) (intData + i * destBytesPerSample) = bigEndian ? ByteOrder::swapIfLittleEndian (n)
+                                                                      : ByteOrder::swapIfBigEndian (n);
+        }
+    }
+
+    /*  For 24 bits, the noise comes from a FastRandom, which can fill a whole block with it
+        in one go. The noise is added in double precision, because a float doesn't have
+        enough bits to hold a full-scale sample plus a fraction of a 24-bit LSB.
+    */
+    template <bool bigEndian>
+    static void convertFloatToInt24Dithered (const float* source, void* dest, int numSamples,
+                                             FastRandom& ditherGenerator, const int destBytesPerSample) noexcept
+    {
+        const double maxVal = (double) 0x7fffff;
+        char* intData = static_cast <char*> (dest);
+        float noise [256];
+
+        while (numSamples > 0)
+        {
+            const int num = jmin (numSamples, (int) numElementsInArray (noise));
+            ditherGenerator.fillTPDF (noise, num, 1.0f);
+
+            for (int i = 0; i < num; ++i)
+            {
+                const int n = roundToInt (jlimit (-maxVal, maxVal, maxVal * source[i] + noise[i]));
+
+                if (bigEndian)
+                    ByteOrder::bigEndian24BitToChars (n, intData);
+                else
+                    ByteOrder::littleEndian24BitToChars (n, intData);
+
+                intData += destBytesPerSample;
+            }
+
+            source += num;
+            numSamples -= num;
+        }
+    }
+}
+
+
+//==============================================================================
 void AudioDataConverters::convertFloatToInt16LE (const float* source, void* dest, int numSamples, const int destBytesPerSample)
 {
     const double maxVal = (double) 0x7fff;
@@ -29,7 +639,10 @@ void AudioDataConverters::convertFloatToInt16LE (const float* source, void* dest
 
     if (dest != (void*) source || destBytesPerSample <= 4)
     {
-        for (int i = 0; i < numSamples; ++i)
+        const int numDone = AudioDataConversionHelpers::convertFloatsToInts<int16LE> (source, intData, destBytesPerSample, numSamples, maxVal);
+        intData += destBytesPerSample * numDone;
+
+        for (int i = numDone; i < numSamples; ++i)
         {
             *(uint16*) intData = ByteOrder::swapIfBigEndian ((uint16) (short) roundToInt (jlimit (-maxVal, maxVal, maxVal * source[i])));
             intData += destBytesPerSample;
@@ -54,7 +667,10 @@ void AudioDataConverters::convertFloatToInt16BE (const float* source, void* dest
 
     if (dest != (void*) source || destBytesPerSample <= 4)
     {
-        for (int i = 0; i < numSamples; ++i)
+        const int numDone = AudioDataConversionHelpers::convertFloatsToInts<int16BE> (source, intData, destBytesPerSample, numSamples, maxVal);
+        intData += destBytesPerSample * numDone;
+
+        for (int i = numDone; i < numSamples; ++i)
         {
             *(uint16*) intData = ByteOrder::swapIfLittleEndian ((uint16) (short) roundToInt (jlimit (-maxVal, maxVal, maxVal * source[i])));
             intData += destBytesPerSample;
@@ -79,7 +695,10 @@ void AudioDataConverters::convertFloatToInt24LE (const float* source, void* dest
 
     if (dest != (void*) source || destBytesPerSample <= 4)
     {
-        for (int i = 0; i < numSamples; ++i)
+        const int numDone = AudioDataConversionHelpers::convertFloatsToInts<int24LE> (source, intData, destBytesPerSample, numSamples, maxVal);
+        intData += destBytesPerSample * numDone;
+
+        for (int i = numDone; i < numSamples; ++i)
         {
             ByteOrder::littleEndian24BitToChars (roundToInt (jlimit (-maxVal, maxVal, maxVal * source[i])), intData);
             intData += destBytesPerSample;
@@ -104,7 +723,10 @@ void AudioDataConverters::convertFloatToInt24BE (const float* source, void* dest
 
     if (dest != (void*) source || destBytesPerSample <= 4)
     {
-        for (int i = 0; i < numSamples; ++i)
+        const int numDone = AudioDataConversionHelpers::convertFloatsToInts<int24BE> (source, intData, destBytesPerSample, numSamples, maxVal);
+        intData += destBytesPerSample * numDone;
+
+        for (int i = numDone; i < numSamples; ++i)
         {
             ByteOrder::bigEndian24BitToChars (roundToInt (jlimit (-maxVal, maxVal, maxVal * source[i])), intData);
             intData += destBytesPerSample;
@@ -129,7 +751,10 @@ void AudioDataConverters::convertFloatToInt32LE (const float* source, void* dest
 
     if (dest != (void*) source || destBytesPerSample <= 4)
     {
-        for (int i = 0; i < numSamples; ++i)
+        const int numDone = AudioDataConversionHelpers::convertFloatsToInts<int32LE> (source, intData, destBytesPerSample, numSamples, maxVal);
+        intData += destBytesPerSample * numDone;
+
+        for (int i = numDone; i < numSamples; ++i)
         {
             *(uint32*)intData = ByteOrder::swapIfBigEndian ((uint32) roundToInt (jlimit (-maxVal, maxVal, maxVal * source[i])));
             intData += destBytesPerSample;
@@ -154,7 +779,10 @@ void AudioDataConverters::convertFloatToInt32BE (const float* source, void* dest
 
     if (dest != (void*) source || destBytesPerSample <= 4)
     {
-        for (int i = 0; i < numSamples; ++i)
+        const int numDone = AudioDataConversionHelpers::convertFloatsToInts<int32BE> (source, intData, destBytesPerSample, numSamples, maxVal);
+        intData += destBytesPerSample * numDone;
+
+        for (int i = numDone; i < numSamples; ++i)
         {
             *(uint32*)intData = ByteOrder::swapIfLittleEndian ((uint32) roundToInt (jlimit (-maxVal, maxVal, maxVal * source[i])));
             intData += destBytesPerSample;
@@ -208,6 +836,30 @@ void AudioDataConverters::convertFloatToFloat32BE (const float* source, void* de
     }
 }
 
+void AudioDataConverters::convertFloatToInt16LEDithered (const float* source, void* dest, int numSamples, uint32& ditherState, const int destBytesPerSample)
+{
+    jassert (dest != (void*) source); // This op can't be performed on in-place data!
+    AudioDataConversionHelpers::convertFloatToInt16Dithered<false> (source, dest, numSamples, ditherState, destBytesPerSample);
+}
+
+void AudioDataConverters::convertFloatToInt16BEDithered (const float* source, void* dest, int numSamples, uint32& ditherState, const int destBytesPerSample)
+{
+    jassert (dest != (void*) source); // This op can't be performed on in-place data!
+    AudioDataConversionHelpers::convertFloatToInt16Dithered<true> (source, dest, numSamples, ditherState, destBytesPerSample);
+}
+
+void AudioDataConverters::convertFloatToInt24LEDithered (const float* source, void* dest, int numSamples, FastRandom& ditherGenerator, const int destBytesPerSample)
+{
+    jassert (dest != (void*) source); // This op can't be performed on in-place data!
+    AudioDataConversionHelpers::convertFloatToInt24Dithered<false> (source, dest, numSamples, ditherGenerator, destBytesPerSample);
+}
+
+void AudioDataConverters::convertFloatToInt24BEDithered (const float* source, void* dest, int numSamples, FastRandom& ditherGenerator, const int destBytesPerSample)
+{
+    jassert (dest != (void*) source); // This op can't be performed on in-place data!
+    AudioDataConversionHelpers::convertFloatToInt24Dithered<true> (source, dest, numSamples, ditherGenerator, destBytesPerSample);
+}
+
 //==============================================================================
 void AudioDataConverters::convertInt16LEToFloat (const void* const source, float* const dest, int numSamples, const int srcBytesPerSample)
 {
@@ -216,7 +868,10 @@ void AudioDataConverters::convertInt16LEToFloat (const void* const source, float
 
     if (source != (void*) dest || srcBytesPerSample >= 4)
     {
-        for (int i = 0; i < numSamples; ++i)
+        const int numDone = AudioDataConversionHelpers::convertIntsToFloats<int16LE> (intData, srcBytesPerSample, dest, numSamples, scale);
+        intData += srcBytesPerSample * numDone;
+
+        for (int i = numDone; i < numSamples; ++i)
         {
             dest[i] = scale * (short) ByteOrder::swapIfBigEndian (*(uint16*)intData);
             intData += srcBytesPerSample;
@@ -241,7 +896,10 @@ void AudioDataConverters::convertInt16BEToFloat (const void* const source, float
 
     if (source != (void*) dest || srcBytesPerSample >= 4)
     {
-        for (int i = 0; i < numSamples; ++i)
+        const int numDone = AudioDataConversionHelpers::convertIntsToFloats<int16BE> (intData, srcBytesPerSample, dest, numSamples, scale);
+        intData += srcBytesPerSample * numDone;
+
+        for (int i = numDone; i < numSamples; ++i)
         {
             dest[i] = scale * (short) ByteOrder::swapIfLittleEndian (*(uint16*)intData);
             intData += srcBytesPerSample;
@@ -266,9 +924,12 @@ void AudioDataConverters::convertInt24LEToFloat (const void* const source, float
 
     if (source != (void*) dest || srcBytesPerSample >= 4)
     {
-        for (int i = 0; i < numSamples; ++i)
+        const int numDone = AudioDataConversionHelpers::convertIntsToFloats<int24LE> (intData, srcBytesPerSample, dest, numSamples, scale);
+        intData += srcBytesPerSample * numDone;
+
+        for (int i = numDone; i < numSamples; ++i)
         {
-            dest[i] = scale * (short) ByteOrder::littleEndian24Bit (intData);
+            dest[i] = scale * (int) ByteOrder::littleEndian24Bit (intData);
             intData += srcBytesPerSample;
         }
     }
@@ -279,7 +940,7 @@ void AudioDataConverters::convertInt24LEToFloat (const void* const source, float
         for (int i = numSamples; --i >= 0;)
         {
             intData -= srcBytesPerSample;
-            dest[i] = scale * (short) ByteOrder::littleEndian24Bit (intData);
+            dest[i] = scale * (int) ByteOrder::littleEndian24Bit (intData);
         }
     }
 }
@@ -291,9 +952,12 @@ void AudioDataConverters::convertInt24BEToFloat (const void* const source, float
 
     if (source != (void*) dest || srcBytesPerSample >= 4)
     {
-        for (int i = 0; i < numSamples; ++i)
+        const int numDone = AudioDataConversionHelpers::convertIntsToFloats<int24BE> (intData, srcBytesPerSample, dest, numSamples, scale);
+        intData += srcBytesPerSample * numDone;
+
+        for (int i = numDone; i < numSamples; ++i)
         {
-            dest[i] = scale * (short) ByteOrder::bigEndian24Bit (intData);
+            dest[i] = scale * (int) ByteOrder::bigEndian24Bit (intData);
             intData += srcBytesPerSample;
         }
     }
@@ -304,7 +968,7 @@ void AudioDataConverters::convertInt24BEToFloat (const void* const source, float
         for (int i = numSamples; --i >= 0;)
         {
             intData -= srcBytesPerSample;
-            dest[i] = scale * (short) ByteOrder::bigEndian24Bit (intData);
+            dest[i] = scale * (int) ByteOrder::bigEndian24Bit (intData);
         }
     }
 }
@@ -316,7 +980,10 @@ void AudioDataConverters::convertInt32LEToFloat (const void* const source, float
 
     if (source != (void*) dest || srcBytesPerSample >= 4)
     {
-        for (int i = 0; i < numSamples; ++i)
+        const int numDone = AudioDataConversionHelpers::convertIntsToFloats<int32LE> (intData, srcBytesPerSample, dest, numSamples, scale);
+        intData += srcBytesPerSample * numDone;
+
+        for (int i = numDone; i < numSamples; ++i)
         {
             dest[i] = scale * (int) ByteOrder::swapIfBigEndian (*(uint32*) intData);
             intData += srcBytesPerSample;
@@ -341,7 +1008,10 @@ void AudioDataConverters::convertInt32BEToFloat (const void* const source, float
 
     if (source != (void*) dest || srcBytesPerSample >= 4)
     {
-        for (int i = 0; i < numSamples; ++i)
+        const int numDone = AudioDataConversionHelpers::convertIntsToFloats<int32BE> (intData, srcBytesPerSample, dest, numSamples, scale);
+        intData += srcBytesPerSample * numDone;
+
+        for (int i = numDone; i < numSamples; ++i)
         {
             dest[i] = scale * (int) ByteOrder::swapIfLittleEndian (*(uint32*) intData);
             intData += srcBytesPerSample;
@@ -439,6 +1109,9 @@ void AudioDataConverters::interleaveSamples (const float** const source,
                                              const int numSamples,
                                              const int numChannels)
 {
+    if (numChannels == 2 && AudioDataConversionHelpers::interleaveStereo (source[0], source[1], dest, numSamples))
+        return;
+
     for (int chan = 0; chan < numChannels; ++chan)
     {
         int i = chan;
@@ -457,6 +1130,9 @@ void AudioDataConverters::deinterleaveSamples (const float* const source,
                                                const int numSamples,
                                                const int numChannels)
 {
+    if (numChannels == 2 && AudioDataConversionHelpers::deinterleaveStereo (source, dest[0], dest[1], numSamples))
+        return;
+
     for (int chan = 0; chan < numChannels; ++chan)
     {
         int i = chan;
@@ -470,6 +1146,133 @@ void AudioDataConverters::deinterleaveSamples (const float* const source,
     }
 }
 
+//==============================================================================
+int AudioData::BlockConversions::toInt32 (int32* dest, const void* source, int sourceBytesBetweenSamples,
+                                          int sourceFormat, int numSamples) noexcept
+{
+   #if JUCE_USE_SIMD_AUDIO_CONVERSIONS
+    using namespace AudioDataConversionHelpers;
+
+    if (isSIMDAvailable())
+    {
+        const char* const src = static_cast <const char*> (source);
+        const int stride = sourceBytesBetweenSamples;
+
+        switch (sourceFormat)
+        {
+            case int16LE:     return intsToInt32<int16LE> (dest, src, stride, numSamples);
+            case int16BE:     return intsToInt32<int16BE> (dest, src, stride, numSamples);
+            case int24LE:     return intsToInt32<int24LE> (dest, src, stride, numSamples);
+            case int24BE:     return intsToInt32<int24BE> (dest, src, stride, numSamples);
+            case int32LE:     return intsToInt32<int32LE> (dest, src, stride, numSamples);
+            case int32BE:     return intsToInt32<int32BE> (dest, src, stride, numSamples);
+           #if JUCE_USE_SSE_INTRINSICS
+            case float32LE:   return floatFormatToInt32<float32LE> (dest, src, stride, numSamples);
+            case float32BE:   return floatFormatToInt32<float32BE> (dest, src, stride, numSamples);
+           #endif
+            default:          break;
+        }
+    }
+   #endif
+
+    (void) dest; (void) source; (void) sourceBytesBetweenSamples; (void) sourceFormat; (void) numSamples;
+    return 0;
+}
+
+int AudioData::BlockConversions::toFloat (float* dest, const void* source, int sourceBytesBetweenSamples,
+                                          int sourceFormat, int numSamples) noexcept
+{
+   #if JUCE_USE_SIMD_AUDIO_CONVERSIONS
+    using namespace AudioDataConversionHelpers;
+
+    if (isSIMDAvailable())
+    {
+        const char* const src = static_cast <const char*> (source);
+        const int stride = sourceBytesBetweenSamples;
+        const float scale = (float) (1.0 / 0x80000000u);
+
+        switch (sourceFormat)
+        {
+            case int16LE:     return intsToFloats<int16LE>   (dest, src, stride, numSamples, scale);
+            case int16BE:     return intsToFloats<int16BE>   (dest, src, stride, numSamples, scale);
+            case int24LE:     return intsToFloats<int24LE>   (dest, src, stride, numSamples, scale);
+            case int24BE:     return intsToFloats<int24BE>   (dest, src, stride, numSamples, scale);
+            case int32LE:     return intsToFloats<int32LE>   (dest, src, stride, numSamples, scale);
+            case int32BE:     return intsToFloats<int32BE>   (dest, src, stride, numSamples, scale);
+            case float32LE:   return intsToFloats<float32LE> (dest, src, stride, numSamples, scale);
+            case float32BE:   return intsToFloats<float32BE> (dest, src, stride, numSamples, scale);
+            default:          break;
+        }
+    }
+   #endif
+
+    (void) dest; (void) source; (void) sourceBytesBetweenSamples; (void) sourceFormat; (void) numSamples;
+    return 0;
+}
+
+int AudioData::BlockConversions::fromInt32 (void* dest, int destBytesBetweenSamples, int destFormat,
+                                            const int32* source, int numSamples) noexcept
+{
+   #if JUCE_USE_SIMD_AUDIO_CONVERSIONS
+    using namespace AudioDataConversionHelpers;
+
+    if (isSIMDAvailable())
+    {
+        char* const dst = static_cast <char*> (dest);
+        const int stride = destBytesBetweenSamples;
+
+        switch (destFormat)
+        {
+            case int16LE:     return int32ToInts<int16LE>   (dst, stride, source, numSamples);
+            case int16BE:     return int32ToInts<int16BE>   (dst, stride, source, numSamples);
+            case int24LE:     return int32ToInts<int24LE>   (dst, stride, source, numSamples);
+            case int24BE:     return int32ToInts<int24BE>   (dst, stride, source, numSamples);
+            case int32LE:     return int32ToInts<int32LE>   (dst, stride, source, numSamples);
+            case int32BE:     return int32ToInts<int32BE>   (dst, stride, source, numSamples);
+            case float32LE:   return int32ToInts<float32LE> (dst, stride, source, numSamples);
+            case float32BE:   return int32ToInts<float32BE> (dst, stride, source, numSamples);
+            default:          break;
+        }
+    }
+   #endif
+
+    (void) dest; (void) destBytesBetweenSamples; (void) destFormat; (void) source; (void) numSamples;
+    return 0;
+}
+
+int AudioData::BlockConversions::fromFloat (void* dest, int destBytesBetweenSamples, int destFormat,
+                                            const float* source, int numSamples) noexcept
+{
+   #if JUCE_USE_SIMD_AUDIO_CONVERSIONS
+    using namespace AudioDataConversionHelpers;
+
+    if (isSIMDAvailable())
+    {
+        char* const dst = static_cast <char*> (dest);
+        const int stride = destBytesBetweenSamples;
+        const double maxValue = (double) 0x7fffffff;
+
+        switch (destFormat)
+        {
+           #if JUCE_USE_SSE_INTRINSICS
+            // (these all go via the full-range 32-bit value, just like the per-sample conversions do)
+            case int16LE:     return floatsToIntsDouble<int16LE> (dst, stride, source, numSamples, maxValue, 0);
+            case int16BE:     return floatsToIntsDouble<int16BE> (dst, stride, source, numSamples, maxValue, 0);
+            case int24LE:     return floatsToIntsDouble<int24LE> (dst, stride, source, numSamples, maxValue, 0);
+            case int24BE:     return floatsToIntsDouble<int24BE> (dst, stride, source, numSamples, maxValue, 0);
+            case int32LE:     return floatsToIntsDouble<int32LE> (dst, stride, source, numSamples, maxValue, 0);
+            case int32BE:     return floatsToIntsDouble<int32BE> (dst, stride, source, numSamples, maxValue, 0);
+           #endif
+            case float32LE:   return floatsToFloats<float32LE> (dst, stride, source, numSamples);
+            case float32BE:   return floatsToFloats<float32BE> (dst, stride, source, numSamples);
+            default:          break;
+        }
+    }
+   #endif
+
+    (void) dest; (void) destBytesBetweenSamples; (void) destFormat; (void) source; (void) numSamples;
+    return 0;
+}
 
 //==============================================================================
 #if JUCE_UNIT_TESTS
@@ -580,6 +1383,278 @@ public:
         }
     };
 
+    //==============================================================================
+    /*  Checks that converting a whole block (which may use the vectorised loops) gives
+        exactly the same bytes as converting one sample at a time.
+    */
+    template <class F1, class E1, class F2, class E2>
+    struct BlockTest
+    {
+        typedef AudioData::Pointer<F1, E1, AudioData::Interleaved, AudioData::Const>    SourceType;
+        typedef AudioData::Pointer<F2, E2, AudioData::Interleaved, AudioData::NonConst> DestType;
+
+        static bool matches (const int numSourceChannels, const int numDestChannels, Random& r)
+        {
+            const int numSamples = 259;
+            const size_t sourceSize = (size_t) (numSamples * numSourceChannels * (int) SourceType::getBytesPerSample());
+            const size_t destSize   = (size_t) (numSamples * numDestChannels * (int) DestType::getBytesPerSample());
+            HeapBlock<char> sourceData (sourceSize), dest1Data (destSize, true), dest2Data (destSize, true);
+
+            // (using the last channel, which is where reading or writing too much would go off the end)
+            char* const source = sourceData + (numSourceChannels - 1) * (int) SourceType::getBytesPerSample();
+            char* const dest1 = dest1Data + (numDestChannels - 1) * (int) DestType::getBytesPerSample();
+            char* const dest2 = dest2Data + (numDestChannels - 1) * (int) DestType::getBytesPerSample();
+
+            for (size_t i = 0; i < sourceSize; ++i)
+                sourceData[i] = (char) r.nextInt (256);
+
+            if (SourceType::isFloatingPoint())
+            {
+                AudioData::Pointer<F1, E1, AudioData::Interleaved, AudioData::NonConst> s (source, numSourceChannels);
+
+                for (int i = 0; i < numSamples; ++i, ++s)
+                    s.setAsFloat (r.nextFloat() * 3.0f - 1.5f);
+            }
+
+            DestType (dest1, numDestChannels).convertSamples (SourceType (source, numSourceChannels), numSamples);
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                SourceType s (source, numSourceChannels);
+                DestType d (dest2, numDestChannels);
+                s += i;
+                d += i;
+                d.convertSamples (s, 1);
+            }
+
+            return memcmp (dest1Data, dest2Data, destSize) == 0;
+        }
+
+        static void test (UnitTest& unitTest, Random& r)
+        {
+            for (int numChannels = 1; numChannels <= 3; ++numChannels)
+            {
+                unitTest.expect (matches (numChannels, 1, r));
+                unitTest.expect (BlockTest<F2, E2, F1, E1>::matches (1, numChannels, r));
+            }
+        }
+    };
+
+    template <class FormatType, class Endianness>
+    struct BlockTest2
+    {
+        static void test (UnitTest& unitTest, Random& r)
+        {
+            BlockTest<FormatType, Endianness, AudioData::Int32, AudioData::NativeEndian>::test (unitTest, r);
+            BlockTest<FormatType, Endianness, AudioData::Float32, AudioData::NativeEndian>::test (unitTest, r);
+        }
+    };
+
+    template <class FormatType>
+    struct BlockTest1
+    {
+        static void test (UnitTest& unitTest, Random& r)
+        {
+            BlockTest2<FormatType, AudioData::LittleEndian>::test (unitTest, r);
+            BlockTest2<FormatType, AudioData::BigEndian>::test (unitTest, r);
+        }
+    };
+
+    //==============================================================================
+    typedef void (*FloatToIntFunction) (const float*, void*, int, int);
+    typedef void (*IntToFloatFunction) (const void*, float*, int, int);
+
+    void testConverterFunctions (FloatToIntFunction toInt, IntToFloatFunction toFloat, const int bytesPerSample, Random& r)
+    {
+        const int numSamples = 259;
+
+        for (int stride = bytesPerSample; stride <= 4; ++stride)
+        {
+            HeapBlock<float> floats (numSamples), floats1 (numSamples), floats2 (numSamples);
+            HeapBlock<char> ints1 ((size_t) (numSamples * stride), true), ints2 ((size_t) (numSamples * stride), true);
+
+            for (int i = 0; i < numSamples; ++i)
+                floats[i] = r.nextFloat() * 2.4f - 1.2f;
+
+            toInt (floats, ints1, numSamples, stride);
+
+            for (int i = 0; i < numSamples; ++i)
+                toInt (floats + i, ints2 + i * stride, 1, stride);
+
+            expect (memcmp (ints1, ints2, (size_t) (numSamples * stride)) == 0);
+
+            toFloat (ints1, floats1, numSamples, stride);
+
+            for (int i = 0; i < numSamples; ++i)
+                toFloat (ints1 + i * stride, floats2 + i, 1, stride);
+
+            expect (memcmp (floats1, floats2, sizeof (float) * (size_t) numSamples) == 0);
+
+            const float tolerance = bytesPerSample == 2 ? 1.0e-4f : 1.0e-6f;
+
+            for (int i = 0; i < numSamples; ++i)
+                expect (std::abs (floats1[i] - jlimit (-1.0f, 1.0f, floats[i])) < tolerance);
+        }
+    }
+
+    void testDither (Random& r)
+    {
+        const int numSamples = 1000;
+        HeapBlock<float> source (numSamples);
+        HeapBlock<int16> dithered1 (numSamples), dithered2 (numSamples), plain (numSamples);
+
+        for (int i = 0; i < numSamples; ++i)
+            source[i] = r.nextFloat() * 2.2f - 1.1f;
+
+        uint32 state1 = 1234, state2 = 1234;
+        AudioDataConverters::convertFloatToInt16LEDithered (source, dithered1, 333, state1);
+        AudioDataConverters::convertFloatToInt16LEDithered (source + 333, dithered1 + 333, numSamples - 333, state1);
+
+        for (int i = 0; i < numSamples; ++i)
+            AudioDataConverters::convertFloatToInt16LEDithered (source + i, dithered2 + i, 1, state2);
+
+        expect (state1 == state2);
+        expect (memcmp (dithered1, dithered2, sizeof (int16) * (size_t) numSamples) == 0);
+
+        AudioDataConverters::convertFloatToInt16LE (source, plain, numSamples);
+        int numDifferent = 0;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const int diff = (int) ByteOrder::swapIfBigEndian ((uint16) dithered1[i]) - (int) ByteOrder::swapIfBigEndian ((uint16) plain[i]);
+            expect (std::abs ((int) (int16) diff) <= 1);
+
+            if (diff != 0)
+                ++numDifferent;
+        }
+
+        expect (numDifferent > 0);
+
+        HeapBlock<char> dithered24a (numSamples * 3), dithered24b (numSamples * 3), plain24 (numSamples * 3);
+        FastRandom generator1 (1234), generator2 (1234);
+        AudioDataConverters::convertFloatToInt24LEDithered (source, dithered24a, 333, generator1);
+        AudioDataConverters::convertFloatToInt24LEDithered (source + 333, dithered24a + 333 * 3, numSamples - 333, generator1);
+        AudioDataConverters::convertFloatToInt24LEDithered (source, dithered24b, numSamples, generator2);
+        AudioDataConverters::convertFloatToInt24LE (source, plain24, numSamples);
+
+        expect (memcmp (dithered24a, dithered24b, (size_t) numSamples * 3) == 0);
+        numDifferent = 0;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const int diff = ByteOrder::littleEndian24Bit (dithered24a + i * 3) - ByteOrder::littleEndian24Bit (plain24 + i * 3);
+            expect (std::abs (diff) <= 1);
+
+            if (diff != 0)
+                ++numDifferent;
+        }
+
+        expect (numDifferent > 0);
+    }
+
+    void testInterleaving (Random& r)
+    {
+        for (int numChannels = 1; numChannels <= 3; ++numChannels)
+        {
+            const int numSamples = 259;
+            HeapBlock<float> interleaved (numSamples * numChannels), result (numSamples * numChannels), channelData (numSamples * numChannels);
+            HeapBlock<float*> channels (numChannels);
+
+            for (int i = 0; i < numSamples * numChannels; ++i)
+                interleaved[i] = r.nextFloat();
+
+            for (int i = 0; i < numChannels; ++i)
+                channels[i] = channelData + i * numSamples;
+
+            AudioDataConverters::deinterleaveSamples (interleaved, channels, numSamples, numChannels);
+
+            for (int i = 0; i < numSamples * numChannels; ++i)
+                expect (channels [i % numChannels][i / numChannels] == interleaved[i]);
+
+            AudioDataConverters::interleaveSamples (const_cast <const float**> (channels.getData()), result, numSamples, numChannels);
+            expect (memcmp (interleaved, result, sizeof (float) * (size_t) (numSamples * numChannels)) == 0);
+        }
+    }
+
+    //==============================================================================
+    template <class SourceType, class DestType>
+    static void convertOneByOne (DestType d, SourceType s, int numSamples) noexcept
+    {
+        for (; --numSamples >= 0; ++d, ++s)
+        {
+            if (DestType::isFloatingPoint())
+                d.setAsFloat (s.getAsFloat());
+            else
+                d.setAsInt32 (s.getAsInt32());
+        }
+    }
+
+    template <class F1, class E1, class F2, class E2>
+    void timeConversion (const char* description, int numSourceChannels, int numDestChannels)
+    {
+        typedef AudioData::Pointer<F1, E1, AudioData::Interleaved, AudioData::Const>    SourceType;
+        typedef AudioData::Pointer<F2, E2, AudioData::Interleaved, AudioData::NonConst> DestType;
+
+        const int numSamples = 65536, numRepeats = 50;
+        HeapBlock<char> source ((size_t) (numSamples * numSourceChannels * (int) SourceType::getBytesPerSample()), true);
+        HeapBlock<char> dest ((size_t) (numSamples * numDestChannels * (int) DestType::getBytesPerSample()), true);
+
+        convertOneByOne (DestType (dest, numDestChannels), SourceType (source, numSourceChannels), numSamples); // (warm up)
+        const int64 start = Time::getHighResolutionTicks();
+
+        for (int i = 0; i < numRepeats; ++i)
+            DestType (dest, numDestChannels).convertSamples (SourceType (source, numSourceChannels), numSamples);
+
+        const int64 middle = Time::getHighResolutionTicks();
+
+        for (int i = 0; i < numRepeats; ++i)
+            convertOneByOne (DestType (dest, numDestChannels), SourceType (source, numSourceChannels), numSamples);
+
+        const int64 end = Time::getHighResolutionTicks();
+
+        logMessage (String (description) + ": "
+                     + String (Time::highResolutionTicksToSeconds (middle - start) * 1000.0, 1) + "ms (one sample at a time: "
+                     + String (Time::highResolutionTicksToSeconds (end - middle) * 1000.0, 1) + "ms)");
+    }
+
+    void timeConverterFunctions()
+    {
+        const int numSamples = 65536, numRepeats = 50;
+        HeapBlock<float> floats (numSamples * 2), channelData (numSamples * 2);
+        HeapBlock<char> ints (numSamples * 4);
+        float* channels[] = { channelData, channelData + numSamples };
+        uint32 ditherState = 0;
+
+        for (int i = 0; i < numSamples * 2; ++i)
+            floats[i] = channelData[i] = (float) std::sin (i * 0.01);
+
+        zeromem (ints, (size_t) numSamples * 4);
+
+        const char* const names[] = { "convertFloatToInt16LE", "convertFloatToInt16LEDithered", "convertFloatToInt24LE",
+                                      "convertInt24LEToFloat", "interleaveSamples (stereo)", "deinterleaveSamples (stereo)" };
+
+        for (int type = 0; type < numElementsInArray (names); ++type)
+        {
+            const int64 start = Time::getHighResolutionTicks();
+
+            for (int i = 0; i < numRepeats; ++i)
+            {
+                switch (type)
+                {
+                    case 0:  AudioDataConverters::convertFloatToInt16LE (floats, ints, numSamples); break;
+                    case 1:  AudioDataConverters::convertFloatToInt16LEDithered (floats, ints, numSamples, ditherState); break;
+                    case 2:  AudioDataConverters::convertFloatToInt24LE (floats, ints, numSamples); break;
+                    case 3:  AudioDataConverters::convertInt24LEToFloat (ints, floats, numSamples); break;
+                    case 4:  AudioDataConverters::interleaveSamples (const_cast <const float**> (channels), floats, numSamples, 2); break;
+                    default: AudioDataConverters::deinterleaveSamples (floats, channels, numSamples, 2); break;
+                }
+            }
+
+            logMessage (String (names[type]) + ": "
+                         + String (Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - start) * 1000.0, 1) + "ms");
+        }
+    }
+
     void runTest()
     {
         beginTest ("Round-trip conversion: Int8");
@@ -592,9 +1667,102 @@ public:
         Test1 <AudioData::Int32>::test (*this);
         beginTest ("Round-trip conversion: Float32");
         Test1 <AudioData::Float32>::test (*this);
+
+        Random r;
+
+        beginTest ("Block conversions");
+        BlockTest1 <AudioData::Int16>::test (*this, r);
+        BlockTest1 <AudioData::Int24>::test (*this, r);
+        BlockTest1 <AudioData::Int32>::test (*this, r);
+        BlockTest1 <AudioData::Float32>::test (*this, r);
+
+        beginTest ("AudioDataConverters");
+        testConverterFunctions (AudioDataConverters::convertFloatToInt16LE, AudioDataConverters::convertInt16LEToFloat, 2, r);
+        testConverterFunctions (AudioDataConverters::convertFloatToInt16BE, AudioDataConverters::convertInt16BEToFloat, 2, r);
+        testConverterFunctions (AudioDataConverters::convertFloatToInt24LE, AudioDataConverters::convertInt24LEToFloat, 3, r);
+        testConverterFunctions (AudioDataConverters::convertFloatToInt24BE, AudioDataConverters::convertInt24BEToFloat, 3, r);
+        testConverterFunctions (AudioDataConverters::convertFloatToInt32LE, AudioDataConverters::convertInt32LEToFloat, 4, r);
+        testConverterFunctions (AudioDataConverters::convertFloatToInt32BE, AudioDataConverters::convertInt32BEToFloat, 4, r);
+        testDither (r);
+        testInterleaving (r);
+
+        beginTest ("Conversion speed");
+        timeConversion <AudioData::Int16,   AudioData::LittleEndian, AudioData::Float32, AudioData::NativeEndian> ("Int16 stereo -> float", 2, 1);
+        timeConversion <AudioData::Int24,   AudioData::LittleEndian, AudioData::Float32, AudioData::NativeEndian> ("Int24 stereo -> float", 2, 1);
+        timeConversion <AudioData::Int24,   AudioData::BigEndian,    AudioData::Int32,   AudioData::NativeEndian> ("Int24 BE mono -> int32", 1, 1);
+        timeConversion <AudioData::Float32, AudioData::BigEndian,    AudioData::Float32, AudioData::NativeEndian> ("Float32 BE mono -> float", 1, 1);
+        timeConversion <AudioData::Float32, AudioData::NativeEndian, AudioData::Int16,   AudioData::LittleEndian> ("Float -> Int16 stereo", 1, 2);
+        timeConversion <AudioData::Int32,   AudioData::NativeEndian, AudioData::Int16,   AudioData::LittleEndian> ("Int32 -> Int16 mono", 1, 1);
+        timeConversion <AudioData::Int32,   AudioData::NativeEndian, AudioData::Int24,   AudioData::LittleEndian> ("Int32 -> Int24 mono", 1, 1);
+        timeConversion <AudioData::Int32,   AudioData::NativeEndian, AudioData::Int24,   AudioData::LittleEndian> ("Int32 -> Int24 stereo", 1, 2);
+        timeConversion <AudioData::Float32, AudioData::NativeEndian, AudioData::Int24,   AudioData::LittleEndian> ("Float -> Int24 stereo", 1, 2);
+        timeConversion <AudioData::Float32, AudioData::NativeEndian, AudioData::Int32,   AudioData::BigEndian>    ("Float -> Int32 BE mono", 1, 1);
+        timeConverterFunctions();
     }
 };
 
 static AudioConversionTests audioConversionUnitTests;
 
 #endif
+
+//==============================================================================
+#if JUCE_BENCHMARKS
+
+class AudioConversionBenchmarks  : public Benchmark
+{
+public:
+    AudioConversionBenchmarks() : Benchmark ("Audio data conversion") {}
+
+    enum { numSamples = 65536 };
+
+    void initialise()
+    {
+        Random r (1234);
+
+        for (int i = 0; i < numSamples; ++i)
+            floats[i] = r.nextFloat() * 2.0f - 1.0f;
+
+        AudioDataConverters::convertFloatToInt24LE (floats, bytes, numSamples);
+    }
+
+    void runBenchmark()
+    {
+        beginMeasurement ("float to int16 LE, 65536 samples");
+        while (keepRunning())
+            AudioDataConverters::convertFloatToInt16LE (floats, bytes, numSamples);
+
+        beginMeasurement ("float to int24 LE, 65536 samples");
+        while (keepRunning())
+            AudioDataConverters::convertFloatToInt24LE (floats, bytes, numSamples);
+
+        beginMeasurement ("int24 LE to float, 65536 samples");
+        while (keepRunning())
+            AudioDataConverters::convertInt24LEToFloat (bytes, floats, numSamples);
+
+        beginMeasurement ("float to int32 BE, 65536 samples");
+        while (keepRunning())
+            AudioDataConverters::convertFloatToInt32BE (floats, bytes, numSamples);
+
+        beginMeasurement ("float to int16 LE dithered, 65536 samples");
+        uint32 ditherState = 1;
+        while (keepRunning())
+            AudioDataConverters::convertFloatToInt16LEDithered (floats, bytes, numSamples, ditherState);
+
+        typedef AudioData::Pointer <AudioData::Float32, AudioData::NativeEndian, AudioData::NonInterleaved, AudioData::Const> SourceType;
+        typedef AudioData::Pointer <AudioData::Int24, AudioData::BigEndian, AudioData::Interleaved, AudioData::NonConst> DestType;
+
+        beginMeasurement ("AudioData::Pointer float to interleaved int24 BE, 65536 samples");
+        while (keepRunning())
+            DestType (bytes, 2).convertSamples (SourceType (floats), numSamples / 2);
+
+        preventOptimisation (bytes[0]);
+    }
+
+private:
+    float floats [numSamples];
+    char bytes [numSamples * 4];
+};
+
+static AudioConversionBenchmarks audioConversionBenchmarks;
+
+#endif
@@ -66,6 +66,25 @@ public:
     class Const;    /**< Used as a template parameter for AudioData::Pointer. Indicates that the samples can only be used for const data.. */
 
   #ifndef DOXYGEN
+    //==============================================================================
+    /** @internal
+        Vectorised loops for the most common conversions, which Pointer::convertSamples()
+        uses when one side of the conversion is a contiguous block of native-endian 32-bit
+        ints or floats (i.e. the way that AudioFormatReaders and AudioFormatWriters use it).
+        Each function returns the number of samples it managed to convert (which may be
+        zero if it can't handle the format, or if there's no SIMD support), and the caller
+        then converts the rest one sample at a time.
+    */
+    struct JUCE_API  BlockConversions
+    {
+        enum Format { int16LE, int16BE, int24LE, int24BE, int32LE, int32BE, float32LE, float32BE, unsupported = -1 };
+
+        static int toInt32 (int32* dest, const void* source, int sourceBytesBetweenSamples, int sourceFormat, int numSamples) noexcept;
+        static int toFloat (float* dest, const void* source, int sourceBytesBetweenSamples, int sourceFormat, int numSamples) noexcept;
+        static int fromInt32 (void* dest, int destBytesBetweenSamples, int destFormat, const int32* source, int numSamples) noexcept;
+        static int fromFloat (void* dest, int destBytesBetweenSamples, int destFormat, const float* source, int numSamples) noexcept;
+    };
+
     //==============================================================================
     class BigEndian
     {
@@ -118,7 +137,8 @@ public:
         inline void copyFromSameType (Int8& source) noexcept    { *data = *source.data; }
 
         int8* data;
-        enum { bytesPerSample = 1, maxValue = 0x7f, resolution = (1 << 24), isFloat = 0 };
+        enum { bytesPerSample = 1, maxValue = 0x7f, resolution = (1 << 24), isFloat = 0,
+               blockFormatLE = BlockConversions::unsupported, blockFormatBE = BlockConversions::unsupported };
     };
 
     class UInt8
@@ -143,7 +163,8 @@ public:
         inline void copyFromSameType (UInt8& source) noexcept   { *data = *source.data; }
 
         uint8* data;
-        enum { bytesPerSample = 1, maxValue = 0x7f, resolution = (1 << 24), isFloat = 0 };
+        enum { bytesPerSample = 1, maxValue = 0x7f, resolution = (1 << 24), isFloat = 0,
+               blockFormatLE = BlockConversions::unsupported, blockFormatBE = BlockConversions::unsupported };
     };
 
     class Int16
@@ -168,7 +189,8 @@ public:
         inline void copyFromSameType (Int16& source) noexcept   { *data = *source.data; }
 
         uint16* data;
-        enum { bytesPerSample = 2, maxValue = 0x7fff, resolution = (1 << 16), isFloat = 0 };
+        enum { bytesPerSample = 2, maxValue = 0x7fff, resolution = (1 << 16), isFloat = 0,
+               blockFormatLE = BlockConversions::int16LE, blockFormatBE = BlockConversions::int16BE };
     };
 
     class Int24
@@ -193,7 +215,8 @@ public:
         inline void copyFromSameType (Int24& source) noexcept   { data[0] = source.data[0]; data[1] = source.data[1]; data[2] = source.data[2]; }
 
         char* data;
-        enum { bytesPerSample = 3, maxValue = 0x7fffff, resolution = (1 << 8), isFloat = 0 };
+        enum { bytesPerSample = 3, maxValue = 0x7fffff, resolution = (1 << 8), isFloat = 0,
+               blockFormatLE = BlockConversions::int24LE, blockFormatBE = BlockConversions::int24BE };
     };
 
     class Int32
@@ -218,7 +241,8 @@ public:
         inline void copyFromSameType (Int32& source) noexcept   { *data = *source.data; }
 
         uint32* data;
-        enum { bytesPerSample = 4, maxValue = 0x7fffffff, resolution = 1, isFloat = 0 };
+        enum { bytesPerSample = 4, maxValue = 0x7fffffff, resolution = 1, isFloat = 0,
+               blockFormatLE = BlockConversions::int32LE, blockFormatBE = BlockConversions::int32BE };
     };
 
     class Float32
@@ -250,7 +274,8 @@ public:
         inline void copyFromSameType (Float32& source) noexcept { *data = *source.data; }
 
         float* data;
-        enum { bytesPerSample = 4, maxValue = 0x7fffffff, resolution = (1 << 8), isFloat = 1 };
+        enum { bytesPerSample = 4, maxValue = 0x7fffffff, resolution = (1 << 8), isFloat = 1,
+               blockFormatLE = BlockConversions::float32LE, blockFormatBE = BlockConversions::float32BE };
     };
 
     //==============================================================================
@@ -441,6 +466,11 @@ public:
 
             if (source.getRawData() != getRawData() || source.getNumBytesBetweenSamples() >= getNumBytesBetweenSamples())
             {
+                const int numDone = convertInBlocks (source, numSamples);
+                dest += numDone;
+                source += numDone;
+                numSamples -= numDone;
+
                 while (--numSamples >= 0)
                 {
                     Endianness::copyFrom (dest.data, source);
@@ -539,12 +569,47 @@ public:
         /** Returns a pointer to the underlying data. */
         const void* getRawData() const noexcept                 { return data.data; }
 
+        /** @internal */
+        enum { blockFormat       = Endianness::isBigEndian   ? (int) SampleFormat::blockFormatBE : (int) SampleFormat::blockFormatLE,
+               nativeBlockFormat = NativeEndian::isBigEndian ? (int) SampleFormat::blockFormatBE : (int) SampleFormat::blockFormatLE,
+               isNativeWordFormat = (SampleFormat::bytesPerSample == 4 && blockFormat == nativeBlockFormat) };
+
     private:
         //==============================================================================
         SampleFormat data;
 
         inline void advance() noexcept                          { this->advanceData (data); }
 
+        template <class OtherPointerType>
+        int convertInBlocks (const OtherPointerType& source, int numSamples) const noexcept
+        {
+            const char* const src = static_cast <const char*> (source.getRawData());
+            char* const dst = static_cast <char*> (const_cast <void*> (getRawData()));
+            const int srcStride = source.getNumBytesBetweenSamples();
+            const int dstStride = getNumBytesBetweenSamples();
+
+            if (dst < src + srcStride * numSamples && src < dst + dstStride * numSamples)
+                return 0; // (overlapping data has to be done in the right order, so leave that to the normal loop)
+
+            if (isNativeWordFormat && dstStride == 4)
+            {
+                if (isFloatingPoint())
+                    return BlockConversions::toFloat ((float*) dst, src, srcStride, (int) OtherPointerType::blockFormat, numSamples);
+
+                return BlockConversions::toInt32 ((int32*) dst, src, srcStride, (int) OtherPointerType::blockFormat, numSamples);
+            }
+
+            if (OtherPointerType::isNativeWordFormat && srcStride == 4)
+            {
+                if (OtherPointerType::isFloatingPoint())
+                    return BlockConversions::fromFloat (dst, dstStride, (int) blockFormat, (const float*) src, numSamples);
+
+                return BlockConversions::fromInt32 (dst, dstStride, (int) blockFormat, (const int32*) src, numSamples);
+            }
+
+            return 0;
+        }
+
         Pointer operator++ (int); // private to force you to use the more efficient pre-increment!
         Pointer operator-- (int);
     };
@@ -643,6 +708,21 @@ public:
     static void convertFloatToFloat32LE (const float* source, void* dest, int numSamples, int destBytesPerSample = 4);
     static void convertFloatToFloat32BE (const float* source, void* dest, int numSamples, int destBytesPerSample = 4);
 
+    /** Converts to 16-bit ints, adding triangular (TPDF) dither of +/- 1 LSB.
+        The ditherState is the state of the random number generator - keep the same variable
+        between calls when converting successive blocks of a stream, so that the noise is
+        continuous. The results don't depend on how the stream is split into blocks.
+    */
+    static void convertFloatToInt16LEDithered (const float* source, void* dest, int numSamples, uint32& ditherState, int destBytesPerSample = 2);
+    static void convertFloatToInt16BEDithered (const float* source, void* dest, int numSamples, uint32& ditherState, int destBytesPerSample = 2);
+
+    /** Converts to 24-bit ints, adding triangular (TPDF) dither of +/- 1 LSB.
+        The noise is taken from the FastRandom object, so as with the 16-bit versions, keep
+        using the same one for successive blocks of a stream.
+    */
+    static void convertFloatToInt24LEDithered (const float* source, void* dest, int numSamples, FastRandom& ditherGenerator, int destBytesPerSample = 3);
+    static void convertFloatToInt24BEDithered (const float* source, void* dest, int numSamples, FastRandom& ditherGenerator, int destBytesPerSample = 3);
+
     //==============================================================================
     static void convertInt16LEToFloat (const void* source, float* dest, int numSamples, int srcBytesPerSample = 2);
     static void convertInt16BEToFloat (const void* source, float* dest, int numSamples, int srcBytesPerSample = 2);
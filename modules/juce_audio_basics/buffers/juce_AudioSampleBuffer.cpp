@@ -25,39 +25,140 @@
 AudioSampleBuffer::AudioSampleBuffer (const int numChannels_,
                                       const int numSamples) noexcept
   : numChannels (numChannels_),
-    size (numSamples)
+    size (numSamples),
+    allocatedBytes (0),
+    reservedChannels (0), reservedSamplesPerChannel (0)
 {
     jassert (numSamples >= 0);
     jassert (numChannels_ > 0);
 
-    allocateData();
+    allocateSpace (numChannels_, numSamples, false, false);
 }
 
 AudioSampleBuffer::AudioSampleBuffer (const AudioSampleBuffer& other) noexcept
   : numChannels (other.numChannels),
-    size (other.size)
+    size (other.size),
+    allocatedBytes (0),
+    reservedChannels (0), reservedSamplesPerChannel (0)
 {
-    allocateData();
+    allocateSpace (numChannels, size, false, false);
 
     for (int i = 0; i < numChannels; ++i)
         FloatVectorOperations::copy (channels[i], other.channels[i], size);
 }
 
-void AudioSampleBuffer::allocateData()
+//==============================================================================
+namespace AudioBufferHelpers
 {
-    const size_t channelListSize = sizeof (float*) * (size_t) (numChannels + 1);
-    allocatedBytes = (size_t) numChannels * (size_t) size * sizeof (float) + channelListSize + 32;
-    allocatedData.malloc (allocatedBytes);
-    channels = reinterpret_cast <float**> (allocatedData.getData());
+    // When a buffer allocates its own memory, each channel's data starts on a boundary of
+    // this many bytes, so that SIMD code can use aligned loads and stores on it.
+    enum { channelAlignment = 64 };
 
-    float* chan = (float*) (allocatedData + channelListSize);
-    for (int i = 0; i < numChannels; ++i)
+    template <typename SampleType>
+    static int getAlignedNumSamples (const int numSamples) noexcept
     {
-        channels[i] = chan;
-        chan += size;
+        const int samplesPerBoundary = channelAlignment / (int) sizeof (SampleType);
+        return (numSamples + samplesPerBoundary - 1) & ~(samplesPerBoundary - 1);
     }
 
-    channels [numChannels] = nullptr;
+    template <typename SampleType>
+    static size_t getChannelListSize (const int numChannels) noexcept
+    {
+        return (sizeof (SampleType*) * (size_t) (numChannels + 1) + channelAlignment - 1) & ~(size_t) (channelAlignment - 1);
+    }
+
+    // The channel list lives at the first aligned address in the block, with the sample data after it.
+    template <typename SampleType>
+    static SampleType** getChannelList (char* const allocatedData) noexcept
+    {
+        return reinterpret_cast <SampleType**> (((pointer_sized_int) allocatedData + channelAlignment - 1)
+                                                  & ~(pointer_sized_int) (channelAlignment - 1));
+    }
+
+    template <typename SampleType>
+    static SampleType* getSampleStorage (char* const allocatedData, const int numChannelsReserved) noexcept
+    {
+        return reinterpret_cast <SampleType*> (reinterpret_cast <char*> (getChannelList<SampleType> (allocatedData))
+                                                 + getChannelListSize<SampleType> (numChannelsReserved));
+    }
+
+    template <typename SampleType>
+    static void layOutChannels (SampleType** const channels, SampleType* data,
+                                const int numChannels, const int samplesPerChannel) noexcept
+    {
+        for (int i = 0; i < numChannels; ++i)
+        {
+            channels[i] = data;
+            data += samplesPerChannel;
+        }
+
+        channels [numChannels] = nullptr;
+    }
+
+    template <typename SampleType>
+    static size_t getBytesNeeded (const int numChannels, const int samplesPerChannel) noexcept
+    {
+        return getChannelListSize<SampleType> (numChannels)
+                + sizeof (SampleType) * (size_t) numChannels * (size_t) samplesPerChannel
+                + channelAlignment;
+    }
+
+    // Returns true if a block of the given size, with a channel list for numChannelsReserved
+    // channels, has room for this many channels of the given length.
+    template <typename SampleType>
+    static bool hasSpaceFor (const size_t allocatedBytes, const int numChannelsReserved,
+                             const int numChannels, const int samplesPerChannel) noexcept
+    {
+        return allocatedBytes > 0
+                && numChannels <= numChannelsReserved
+                && getBytesNeeded<SampleType> (numChannelsReserved, 0)
+                     + sizeof (SampleType) * (size_t) numChannels * (size_t) samplesPerChannel <= allocatedBytes;
+    }
+}
+
+void AudioSampleBuffer::allocateSpace (const int newNumChannels, const int newNumSamples,
+                                       const bool keepExistingContent, const bool clearExtraSpace)
+{
+    using namespace AudioBufferHelpers;
+
+    const int newSamplesPerChannel = getAlignedNumSamples<float> (newNumSamples);
+    const size_t newTotalBytes = getBytesNeeded<float> (newNumChannels, newSamplesPerChannel);
+
+    HeapBlock <char, true> newData;
+    newData.allocate (newTotalBytes, clearExtraSpace);
+
+    float** const newChannels = getChannelList<float> (newData);
+    layOutChannels (newChannels, getSampleStorage<float> (newData, newNumChannels), newNumChannels, newSamplesPerChannel);
+
+    if (keepExistingContent)
+    {
+        const int numSamplesToCopy = jmin (newNumSamples, size);
+        const int numChansToCopy = jmin (numChannels, newNumChannels);
+
+        for (int i = 0; i < numChansToCopy; ++i)
+            FloatVectorOperations::copy (newChannels[i], channels[i], numSamplesToCopy);
+    }
+
+    allocatedData.swapWith (newData);
+    allocatedBytes = newTotalBytes;
+    reservedChannels = newNumChannels;
+    reservedSamplesPerChannel = newSamplesPerChannel;
+    channels = newChannels;
+}
+
+void AudioSampleBuffer::reserveSpace (const int numChannelsToReserve, const int numSamplesToReserve)
+{
+    jassert (numChannelsToReserve > 0 && numSamplesToReserve >= 0);
+
+    if (numSamplesToReserve > reservedSamplesPerChannel
+         || ! AudioBufferHelpers::hasSpaceFor<float> (allocatedBytes, reservedChannels,
+                                                      numChannelsToReserve, reservedSamplesPerChannel))
+    {
+        allocateSpace (jmax (numChannels, numChannelsToReserve),
+                       jmax (size, numSamplesToReserve, reservedSamplesPerChannel), true, false);
+
+        channels [numChannels] = nullptr;
+    }
 }
 
 AudioSampleBuffer::AudioSampleBuffer (float* const* dataToReferTo,
@@ -65,7 +166,8 @@ AudioSampleBuffer::AudioSampleBuffer (float* const* dataToReferTo,
                                       const int numSamples) noexcept
     : numChannels (numChannels_),
       size (numSamples),
-      allocatedBytes (0)
+      allocatedBytes (0),
+      reservedChannels (0), reservedSamplesPerChannel (0)
 {
     jassert (numChannels_ > 0);
     allocateChannels (dataToReferTo, 0);
@@ -77,7 +179,8 @@ AudioSampleBuffer::AudioSampleBuffer (float* const* dataToReferTo,
                                       const int numSamples) noexcept
     : numChannels (numChannels_),
       size (numSamples),
-      allocatedBytes (0)
+      allocatedBytes (0),
+      reservedChannels (0), reservedSamplesPerChannel (0)
 {
     jassert (numChannels_ > 0);
     allocateChannels (dataToReferTo, startSample);
@@ -90,6 +193,7 @@ void AudioSampleBuffer::setDataToReferTo (float** dataToReferTo,
     jassert (newNumChannels > 0);
 
     allocatedBytes = 0;
+    reservedChannels = reservedSamplesPerChannel = 0;
     allocatedData.free();
 
     numChannels = newNumChannels;
@@ -143,65 +247,43 @@ void AudioSampleBuffer::setSize (const int newNumChannels,
                                  const int newNumSamples,
                                  const bool keepExistingContent,
                                  const bool clearExtraSpace,
-                                 const bool avoidReallocating) noexcept
+                                 const bool /*avoidReallocating*/) noexcept
 {
     jassert (newNumChannels > 0);
     jassert (newNumSamples >= 0);
 
     if (newNumSamples != size || newNumChannels != numChannels)
     {
-        const size_t allocatedSamplesPerChannel = (newNumSamples + 3) & ~3;
-        const size_t channelListSize = ((sizeof (float*) * (size_t) (newNumChannels + 1)) + 15) & ~15;
-        const size_t newTotalBytes = ((size_t) newNumChannels * (size_t) allocatedSamplesPerChannel * sizeof (float))
-                                        + channelListSize + 32;
-
-        if (keepExistingContent)
-        {
-            HeapBlock <char, true> newData;
-            newData.allocate (newTotalBytes, clearExtraSpace);
+        using namespace AudioBufferHelpers;
 
-            const size_t numSamplesToCopy = jmin (newNumSamples, size);
+        // If the space that's already been allocated is big enough, just re-arrange the
+        // channels within it. When the content has to be kept, the channels must stay where
+        // they are, but otherwise they can be packed closer together to make room for longer ones.
+        const int newSamplesPerChannel = keepExistingContent ? reservedSamplesPerChannel
+                                                             : getAlignedNumSamples<float> (newNumSamples);
 
-            float** const newChannels = reinterpret_cast <float**> (newData.getData());
-            float* newChan = reinterpret_cast <float*> (newData + channelListSize);
+        if (newNumSamples <= newSamplesPerChannel
+             && hasSpaceFor<float> (allocatedBytes, reservedChannels, newNumChannels, newSamplesPerChannel))
+        {
+            layOutChannels (channels, getSampleStorage<float> (allocatedData, reservedChannels),
+                            newNumChannels, newSamplesPerChannel);
 
-            for (int j = 0; j < newNumChannels; ++j)
+            if (clearExtraSpace)
             {
-                newChannels[j] = newChan;
-                newChan += allocatedSamplesPerChannel;
+                for (int i = 0; i < newNumChannels; ++i)
+                {
+                    const int numKept = (keepExistingContent && i < numChannels) ? jmin (size, newNumSamples) : 0;
+                    FloatVectorOperations::clear (channels[i] + numKept, newNumSamples - numKept);
+                }
             }
 
-            const int numChansToCopy = jmin (numChannels, newNumChannels);
-            for (int i = 0; i < numChansToCopy; ++i)
-                FloatVectorOperations::copy (newChannels[i], channels[i], (int) numSamplesToCopy);
-
-            allocatedData.swapWith (newData);
-            allocatedBytes = newTotalBytes;
-            channels = newChannels;
+            reservedSamplesPerChannel = newSamplesPerChannel;
         }
         else
         {
-            if (avoidReallocating && allocatedBytes >= newTotalBytes)
-            {
-                if (clearExtraSpace)
-                    allocatedData.clear (newTotalBytes);
-            }
-            else
-            {
-                allocatedBytes = newTotalBytes;
-                allocatedData.allocate (newTotalBytes, clearExtraSpace);
-                channels = reinterpret_cast <float**> (allocatedData.getData());
-            }
-
-            float* chan = reinterpret_cast <float*> (allocatedData + channelListSize);
-            for (int i = 0; i < newNumChannels; ++i)
-            {
-                channels[i] = chan;
-                chan += allocatedSamplesPerChannel;
-            }
+            allocateSpace (newNumChannels, newNumSamples, keepExistingContent, clearExtraSpace);
         }
 
-        channels [newNumChannels] = 0;
         size = newNumSamples;
         numChannels = newNumChannels;
     }
@@ -266,14 +348,26 @@ void AudioSampleBuffer::applyGainRamp (const int channel,
         jassert (isPositiveAndBelow (channel, numChannels));
         jassert (startSample >= 0 && startSample + numSamples <= size);
 
-        const float increment = (endGain - startGain) / numSamples;
-        float* d = channels [channel] + startSample;
+        FloatVectorOperations::multiplyWithRamp (channels [channel] + startSample, startGain, endGain, numSamples);
+    }
+}
 
-        while (--numSamples >= 0)
-        {
-            *d++ *= startGain;
-            startGain += increment;
-        }
+void AudioSampleBuffer::applyExponentialGainRamp (const int channel,
+                                                  const int startSample,
+                                                  const int numSamples,
+                                                  const float startGain,
+                                                  const float endGain) noexcept
+{
+    if (startGain == endGain)
+    {
+        applyGain (channel, startSample, numSamples, startGain);
+    }
+    else
+    {
+        jassert (isPositiveAndBelow (channel, numChannels));
+        jassert (startSample >= 0 && startSample + numSamples <= size);
+
+        FloatVectorOperations::multiplyWithExponentialRamp (channels [channel] + startSample, startGain, endGain, numSamples);
     }
 }
 
@@ -299,6 +393,15 @@ void AudioSampleBuffer::applyGainRamp (const int startSample,
         applyGainRamp (i, startSample, numSamples, startGain, endGain);
 }
 
+void AudioSampleBuffer::applyExponentialGainRamp (const int startSample,
+                                                  const int numSamples,
+                                                  const float startGain,
+                                                  const float endGain) noexcept
+{
+    for (int i = 0; i < numChannels; ++i)
+        applyExponentialGainRamp (i, startSample, numSamples, startGain, endGain);
+}
+
 void AudioSampleBuffer::addFrom (const int destChannel,
                                  const int destStartSample,
                                  const AudioSampleBuffer& source,
@@ -364,16 +467,8 @@ void AudioSampleBuffer::addFromWithRamp (const int destChannel,
     else
     {
         if (numSamples > 0 && (startGain != 0.0f || endGain != 0.0f))
-        {
-            const float increment = (endGain - startGain) / numSamples;
-            float* d = channels [destChannel] + destStartSample;
-
-            while (--numSamples >= 0)
-            {
-                *d++ += startGain * *source++;
-                startGain += increment;
-            }
-        }
+            FloatVectorOperations::addWithRamp (channels [destChannel] + destStartSample,
+                                                source, startGain, endGain, numSamples);
     }
 }
 
@@ -461,16 +556,8 @@ void AudioSampleBuffer::copyFromWithRamp (const int destChannel,
     else
     {
         if (numSamples > 0 && (startGain != 0.0f || endGain != 0.0f))
-        {
-            const float increment = (endGain - startGain) / numSamples;
-            float* d = channels [destChannel] + destStartSample;
-
-            while (--numSamples >= 0)
-            {
-                *d++ = startGain * *source++;
-                startGain += increment;
-            }
-        }
+            FloatVectorOperations::copyWithRamp (channels [destChannel] + destStartSample,
+                                                 source, startGain, endGain, numSamples);
     }
 }
 
@@ -521,14 +608,7 @@ float AudioSampleBuffer::getRMSLevel (const int channel,
     if (numSamples <= 0 || channel < 0 || channel >= numChannels)
         return 0.0f;
 
-    const float* const data = channels [channel] + startSample;
-    double sum = 0.0;
-
-    for (int i = 0; i < numSamples; ++i)
-    {
-        const float sample = data [i];
-        sum += sample * sample;
-    }
+    const double sum = FloatVectorOperations::sumOfSquares (channels [channel] + startSample, numSamples);
 
     return (float) std::sqrt (sum / numSamples);
 }
@@ -30,6 +30,13 @@
 /**
     A multi-channel buffer of 32-bit floating point audio samples.
 
+    When the buffer allocates its own memory, the data for each channel starts on a
+    64-byte boundary, so SIMD code can use aligned loads and stores on it.
+
+    Once a buffer has allocated some memory, resizing it to anything that fits into that
+    memory won't allocate again, so a buffer that's been given enough space with
+    reserveSpace() or setSize() before playback starts can then be resized freely on the
+    audio thread.
 */
 class JUCE_API  AudioSampleBuffer
 {
@@ -163,11 +170,13 @@ public:
         allocated will be also be cleared. If false, then this space is left
         uninitialised.
 
-        If avoidReallocating is true, then changing the buffer's size won't reduce the
-        amount of memory that is currently allocated (but it will still increase it if
-        the new size is bigger than the amount it currently has). If this is false, then
-        a new allocation will be done so that the buffer uses takes up the minimum amount
-        of memory that it needs.
+        This never allocates memory if the new size fits into the space that the buffer
+        has already allocated, i.e. if it's shrinking, or growing back to a size that it's
+        had before, or to a size that's been set aside with reserveSpace(). (When the existing
+        content is being kept, the new length must also fit into the space that was set
+        aside for each of the existing channels). The avoidReallocating parameter is no
+        longer needed, and is only kept for compatibility, since the buffer now always
+        behaves as if it were true.
 
         If the required memory can't be allocated, this will throw a std::bad_alloc exception.
     */
@@ -177,6 +186,14 @@ public:
                   bool clearExtraSpace = false,
                   bool avoidReallocating = false) noexcept;
 
+    /** Makes sure that the buffer has enough memory for the given number of channels and
+        samples, so that it can later be resized to anything up to this size without
+        having to allocate.
+
+        This doesn't change the buffer's size or its contents. If the buffer was referring
+        to some external data, it'll make its own copy of that data.
+    */
+    void reserveSpace (int numChannels, int numSamples);
 
     /** Makes this buffer point to a pre-allocated set of channel data arrays.
 
@@ -272,6 +289,29 @@ public:
                         float startGain,
                         float endGain) noexcept;
 
+    /** Applies a range of gains to a region of a channel, moving exponentially between them.
+
+        This is like applyGainRamp(), but the gain changes by a fixed ratio on each
+        sample rather than a fixed amount, so that a change in level sounds even all the
+        way through. Both gains must be non-zero, and have the same sign.
+
+        For speed, this doesn't check whether the sample numbers
+        are in-range, so be careful!
+    */
+    void applyExponentialGainRamp (int channel,
+                                   int startSample,
+                                   int numSamples,
+                                   float startGain,
+                                   float endGain) noexcept;
+
+    /** Applies a range of gains to a region of all channels, moving exponentially between them.
+        @see applyGainRamp
+    */
+    void applyExponentialGainRamp (int startSample,
+                                   int numSamples,
+                                   float startGain,
+                                   float endGain) noexcept;
+
     /** Adds samples from another buffer to this one.
 
         @param destChannel          the channel within this buffer to add the samples to
@@ -432,11 +472,12 @@ private:
     //==============================================================================
     int numChannels, size;
     size_t allocatedBytes;
+    int reservedChannels, reservedSamplesPerChannel;
     float** channels;
     HeapBlock <char, true> allocatedData;
     float* preallocatedChannelSpace [32];
 
-    void allocateData();
+    void allocateSpace (int numChannels, int numSamples, bool keepExistingContent, bool clearExtraSpace);
     void allocateChannels (float* const* dataToReferTo, int offset);
 
     JUCE_LEAK_DETECTOR (AudioSampleBuffer)
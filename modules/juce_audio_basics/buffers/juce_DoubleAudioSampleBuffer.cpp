@@ -0,0 +1,364 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+
+DoubleAudioSampleBuffer::DoubleAudioSampleBuffer (const int numChannels_,
+                                                  const int numSamples) noexcept
+  : numChannels (0), size (0), allocatedBytes (0),
+    reservedChannels (0), reservedSamplesPerChannel (0), channels (nullptr)
+{
+    jassert (numSamples >= 0);
+    jassert (numChannels_ > 0);
+
+    setSize (numChannels_, numSamples);
+}
+
+DoubleAudioSampleBuffer::DoubleAudioSampleBuffer (double* const* dataToReferTo,
+                                                  const int numChannels_,
+                                                  const int numSamples) noexcept
+    : numChannels (numChannels_),
+      size (numSamples),
+      allocatedBytes (0),
+      reservedChannels (0), reservedSamplesPerChannel (0)
+{
+    jassert (numChannels_ > 0);
+    allocateChannels (dataToReferTo);
+}
+
+DoubleAudioSampleBuffer::DoubleAudioSampleBuffer (const DoubleAudioSampleBuffer& other) noexcept
+  : numChannels (0), size (0), allocatedBytes (0),
+    reservedChannels (0), reservedSamplesPerChannel (0), channels (nullptr)
+{
+    setSize (other.numChannels, other.size);
+
+    for (int i = 0; i < numChannels; ++i)
+        memcpy (channels[i], other.channels[i], sizeof (double) * (size_t) size);
+}
+
+DoubleAudioSampleBuffer& DoubleAudioSampleBuffer::operator= (const DoubleAudioSampleBuffer& other) noexcept
+{
+    if (this != &other)
+    {
+        setSize (other.getNumChannels(), other.getNumSamples(), false, false, false);
+
+        for (int i = 0; i < numChannels; ++i)
+            memcpy (channels[i], other.channels[i], sizeof (double) * (size_t) size);
+    }
+
+    return *this;
+}
+
+DoubleAudioSampleBuffer::~DoubleAudioSampleBuffer() noexcept
+{
+}
+
+void DoubleAudioSampleBuffer::setDataToReferTo (double** dataToReferTo,
+                                                const int newNumChannels,
+                                                const int newNumSamples) noexcept
+{
+    jassert (newNumChannels > 0);
+
+    allocatedBytes = 0;
+    reservedChannels = reservedSamplesPerChannel = 0;
+    allocatedData.free();
+
+    numChannels = newNumChannels;
+    size = newNumSamples;
+
+    allocateChannels (dataToReferTo);
+}
+
+void DoubleAudioSampleBuffer::allocateChannels (double* const* const dataToReferTo)
+{
+    // (try to avoid doing a malloc here, as that'll blow up things like Pro-Tools)
+    if (numChannels < (int) numElementsInArray (preallocatedChannelSpace))
+    {
+        channels = static_cast <double**> (preallocatedChannelSpace);
+    }
+    else
+    {
+        allocatedData.malloc ((size_t) numChannels + 1, sizeof (double*));
+        channels = reinterpret_cast <double**> (allocatedData.getData());
+    }
+
+    for (int i = 0; i < numChannels; ++i)
+    {
+        // you have to pass in the same number of valid pointers as numChannels
+        jassert (dataToReferTo[i] != nullptr);
+
+        channels[i] = dataToReferTo[i];
+    }
+
+    channels [numChannels] = nullptr;
+}
+
+void DoubleAudioSampleBuffer::allocateSpace (const int newNumChannels, const int newNumSamples,
+                                             const bool keepExistingContent, const bool clearExtraSpace)
+{
+    using namespace AudioBufferHelpers;
+
+    const int newSamplesPerChannel = getAlignedNumSamples<double> (newNumSamples);
+    const size_t newTotalBytes = getBytesNeeded<double> (newNumChannels, newSamplesPerChannel);
+
+    HeapBlock <char, true> newData;
+    newData.allocate (newTotalBytes, clearExtraSpace);
+
+    double** const newChannels = getChannelList<double> (newData);
+    layOutChannels (newChannels, getSampleStorage<double> (newData, newNumChannels), newNumChannels, newSamplesPerChannel);
+
+    if (keepExistingContent && channels != nullptr)
+    {
+        const size_t numSamplesToCopy = (size_t) jmin (newNumSamples, size);
+        const int numChansToCopy = jmin (numChannels, newNumChannels);
+
+        for (int i = 0; i < numChansToCopy; ++i)
+            memcpy (newChannels[i], channels[i], sizeof (double) * numSamplesToCopy);
+    }
+
+    allocatedData.swapWith (newData);
+    allocatedBytes = newTotalBytes;
+    reservedChannels = newNumChannels;
+    reservedSamplesPerChannel = newSamplesPerChannel;
+    channels = newChannels;
+}
+
+void DoubleAudioSampleBuffer::reserveSpace (const int numChannelsToReserve, const int numSamplesToReserve)
+{
+    jassert (numChannelsToReserve > 0 && numSamplesToReserve >= 0);
+
+    if (numSamplesToReserve > reservedSamplesPerChannel
+         || ! AudioBufferHelpers::hasSpaceFor<double> (allocatedBytes, reservedChannels,
+                                                       numChannelsToReserve, reservedSamplesPerChannel))
+    {
+        allocateSpace (jmax (numChannels, numChannelsToReserve),
+                       jmax (size, numSamplesToReserve, reservedSamplesPerChannel), true, false);
+
+        channels [numChannels] = nullptr;
+    }
+}
+
+void DoubleAudioSampleBuffer::setSize (const int newNumChannels,
+                                       const int newNumSamples,
+                                       const bool keepExistingContent,
+                                       const bool clearExtraSpace,
+                                       const bool /*avoidReallocating*/) noexcept
+{
+    jassert (newNumChannels > 0);
+    jassert (newNumSamples >= 0);
+
+    if (newNumSamples != size || newNumChannels != numChannels || channels == nullptr)
+    {
+        using namespace AudioBufferHelpers;
+
+        // (see AudioSampleBuffer::setSize() for how the existing space gets re-used)
+        const int newSamplesPerChannel = keepExistingContent ? reservedSamplesPerChannel
+                                                             : getAlignedNumSamples<double> (newNumSamples);
+
+        if (newNumSamples <= newSamplesPerChannel
+             && hasSpaceFor<double> (allocatedBytes, reservedChannels, newNumChannels, newSamplesPerChannel))
+        {
+            layOutChannels (channels, getSampleStorage<double> (allocatedData, reservedChannels),
+                            newNumChannels, newSamplesPerChannel);
+
+            if (clearExtraSpace)
+            {
+                for (int i = 0; i < newNumChannels; ++i)
+                {
+                    const int numKept = (keepExistingContent && i < numChannels) ? jmin (size, newNumSamples) : 0;
+                    zeromem (channels[i] + numKept, sizeof (double) * (size_t) (newNumSamples - numKept));
+                }
+            }
+
+            reservedSamplesPerChannel = newSamplesPerChannel;
+        }
+        else
+        {
+            allocateSpace (newNumChannels, newNumSamples, keepExistingContent, clearExtraSpace);
+        }
+
+        size = newNumSamples;
+        numChannels = newNumChannels;
+    }
+}
+
+//==============================================================================
+void DoubleAudioSampleBuffer::clear() noexcept
+{
+    for (int i = 0; i < numChannels; ++i)
+        zeromem (channels[i], sizeof (double) * (size_t) size);
+}
+
+void DoubleAudioSampleBuffer::clear (const int startSample,
+                                     const int numSamples) noexcept
+{
+    jassert (startSample >= 0 && startSample + numSamples <= size);
+
+    for (int i = 0; i < numChannels; ++i)
+        zeromem (channels[i] + startSample, sizeof (double) * (size_t) numSamples);
+}
+
+void DoubleAudioSampleBuffer::clear (const int channel,
+                                     const int startSample,
+                                     const int numSamples) noexcept
+{
+    jassert (isPositiveAndBelow (channel, numChannels));
+    jassert (startSample >= 0 && startSample + numSamples <= size);
+
+    zeromem (channels [channel] + startSample, sizeof (double) * (size_t) numSamples);
+}
+
+void DoubleAudioSampleBuffer::applyGain (const int channel,
+                                         const int startSample,
+                                         int numSamples,
+                                         const double gain) noexcept
+{
+    jassert (isPositiveAndBelow (channel, numChannels));
+    jassert (startSample >= 0 && startSample + numSamples <= size);
+
+    if (gain != 1.0)
+    {
+        double* d = channels [channel] + startSample;
+
+        if (gain == 0.0)
+        {
+            zeromem (d, sizeof (double) * (size_t) numSamples);
+        }
+        else
+        {
+            while (--numSamples >= 0)
+                *d++ *= gain;
+        }
+    }
+}
+
+void DoubleAudioSampleBuffer::applyGain (const double gain) noexcept
+{
+    for (int i = 0; i < numChannels; ++i)
+        applyGain (i, 0, size, gain);
+}
+
+void DoubleAudioSampleBuffer::addFrom (const int destChannel,
+                                       const int destStartSample,
+                                       const DoubleAudioSampleBuffer& source,
+                                       const int sourceChannel,
+                                       const int sourceStartSample,
+                                       int numSamples,
+                                       const double gain) noexcept
+{
+    jassert (&source != this || sourceChannel != destChannel);
+    jassert (isPositiveAndBelow (destChannel, numChannels));
+    jassert (destStartSample >= 0 && destStartSample + numSamples <= size);
+    jassert (isPositiveAndBelow (sourceChannel, source.numChannels));
+    jassert (sourceStartSample >= 0 && sourceStartSample + numSamples <= source.size);
+
+    if (gain != 0.0)
+    {
+        double* d = channels [destChannel] + destStartSample;
+        const double* s = source.channels [sourceChannel] + sourceStartSample;
+
+        if (gain != 1.0)
+        {
+            while (--numSamples >= 0)
+                *d++ += gain * *s++;
+        }
+        else
+        {
+            while (--numSamples >= 0)
+                *d++ += *s++;
+        }
+    }
+}
+
+void DoubleAudioSampleBuffer::copyFrom (const int destChannel,
+                                        const int destStartSample,
+                                        const DoubleAudioSampleBuffer& source,
+                                        const int sourceChannel,
+                                        const int sourceStartSample,
+                                        int numSamples) noexcept
+{
+    jassert (&source != this || sourceChannel != destChannel);
+    jassert (isPositiveAndBelow (destChannel, numChannels));
+    jassert (destStartSample >= 0 && destStartSample + numSamples <= size);
+    jassert (isPositiveAndBelow (sourceChannel, source.numChannels));
+    jassert (sourceStartSample >= 0 && sourceStartSample + numSamples <= source.size);
+
+    if (numSamples > 0)
+        memcpy (channels [destChannel] + destStartSample,
+                source.channels [sourceChannel] + sourceStartSample,
+                sizeof (double) * (size_t) numSamples);
+}
+
+void DoubleAudioSampleBuffer::copyFrom (const int destChannel,
+                                        const int destStartSample,
+                                        const AudioSampleBuffer& source,
+                                        const int sourceChannel,
+                                        const int sourceStartSample,
+                                        int numSamples) noexcept
+{
+    jassert (isPositiveAndBelow (destChannel, numChannels));
+    jassert (destStartSample >= 0 && destStartSample + numSamples <= size);
+    jassert (isPositiveAndBelow (sourceChannel, source.getNumChannels()));
+    jassert (sourceStartSample >= 0 && sourceStartSample + numSamples <= source.getNumSamples());
+
+    double* d = channels [destChannel] + destStartSample;
+    const float* s = source.getArrayOfChannels() [sourceChannel] + sourceStartSample;
+
+    while (--numSamples >= 0)
+        *d++ = *s++;
+}
+
+void DoubleAudioSampleBuffer::copyTo (AudioSampleBuffer& destination,
+                                      const int destChannel,
+                                      const int destStartSample,
+                                      const int sourceChannel,
+                                      const int sourceStartSample,
+                                      int numSamples) const noexcept
+{
+    jassert (isPositiveAndBelow (destChannel, destination.getNumChannels()));
+    jassert (destStartSample >= 0 && destStartSample + numSamples <= destination.getNumSamples());
+    jassert (isPositiveAndBelow (sourceChannel, numChannels));
+    jassert (sourceStartSample >= 0 && sourceStartSample + numSamples <= size);
+
+    float* d = destination.getArrayOfChannels() [destChannel] + destStartSample;
+    const double* s = channels [sourceChannel] + sourceStartSample;
+
+    while (--numSamples >= 0)
+        *d++ = (float) *s++;
+}
+
+double DoubleAudioSampleBuffer::getMagnitude (const int channel,
+                                              const int startSample,
+                                              int numSamples) const noexcept
+{
+    jassert (isPositiveAndBelow (channel, numChannels));
+    jassert (startSample >= 0 && startSample + numSamples <= size);
+
+    const double* s = channels [channel] + startSample;
+    double mag = 0;
+
+    while (--numSamples >= 0)
+        mag = jmax (mag, std::abs (*s++));
+
+    return mag;
+}
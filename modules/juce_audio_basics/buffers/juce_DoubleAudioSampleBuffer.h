@@ -0,0 +1,242 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+
+#ifndef __JUCE_DOUBLEAUDIOSAMPLEBUFFER_JUCEHEADER__
+#define __JUCE_DOUBLEAUDIOSAMPLEBUFFER_JUCEHEADER__
+
+#include "juce_AudioSampleBuffer.h"
+
+
+//==============================================================================
+/**
+    A multi-channel buffer of 64-bit floating point audio samples.
+
+    This works in the same way as an AudioSampleBuffer, and is what gets passed to
+    AudioProcessor::processBlock() when a processor is running in double precision.
+    It has methods for converting its contents to and from an AudioSampleBuffer.
+
+    @see AudioSampleBuffer
+*/
+class JUCE_API  DoubleAudioSampleBuffer
+{
+public:
+    //==============================================================================
+    /** Creates a buffer with a specified number of channels and samples.
+
+        The contents of the buffer will initially be undefined, so use clear() to
+        set all the samples to zero.
+    */
+    DoubleAudioSampleBuffer (int numChannels,
+                             int numSamples) noexcept;
+
+    /** Creates a buffer using a pre-allocated block of memory.
+
+        Note that if the buffer is resized or its number of channels is changed, it
+        will re-allocate memory internally and copy the existing data to this new area,
+        so it will then stop directly addressing this memory.
+
+        @param dataToReferTo    a pre-allocated array containing pointers to the data
+                                for each channel that should be used by this buffer. The
+                                buffer will only refer to this memory, it won't try to delete
+                                it when the buffer is deleted or resized.
+        @param numChannels      the number of channels to use - this must correspond to the
+                                number of elements in the array passed in
+        @param numSamples       the number of samples to use - this must correspond to the
+                                size of the arrays passed in
+    */
+    DoubleAudioSampleBuffer (double* const* dataToReferTo,
+                             int numChannels,
+                             int numSamples) noexcept;
+
+    /** Copies another buffer.
+
+        This buffer will make its own copy of the other's data.
+    */
+    DoubleAudioSampleBuffer (const DoubleAudioSampleBuffer& other) noexcept;
+
+    /** Copies another buffer onto this one.
+
+        This buffer's size will be changed to that of the other buffer.
+    */
+    DoubleAudioSampleBuffer& operator= (const DoubleAudioSampleBuffer& other) noexcept;
+
+    /** Destructor.
+
+        This will free any memory allocated by the buffer.
+    */
+    virtual ~DoubleAudioSampleBuffer() noexcept;
+
+    //==============================================================================
+    /** Returns the number of channels of audio data that this buffer contains. */
+    int getNumChannels() const noexcept     { return numChannels; }
+
+    /** Returns the number of samples allocated in each of the buffer's channels. */
+    int getNumSamples() const noexcept      { return size; }
+
+    /** Returns a pointer one of the buffer's channels.
+
+        For speed, this doesn't check whether the channel number is out of range,
+        so be careful when using it!
+    */
+    double* getSampleData (const int channelNumber) const noexcept
+    {
+        jassert (isPositiveAndBelow (channelNumber, numChannels));
+        return channels [channelNumber];
+    }
+
+    /** Returns a pointer to a sample in one of the buffer's channels.
+
+        For speed, this doesn't check whether the channel and sample number
+        are out-of-range, so be careful when using it!
+    */
+    double* getSampleData (const int channelNumber,
+                           const int sampleOffset) const noexcept
+    {
+        jassert (isPositiveAndBelow (channelNumber, numChannels));
+        jassert (isPositiveAndBelow (sampleOffset, size));
+        return channels [channelNumber] + sampleOffset;
+    }
+
+    /** Returns an array of pointers to the channels in the buffer.
+
+        Don't modify any of the pointers that are returned, and bear in mind that
+        these will become invalid if the buffer is resized.
+    */
+    double** getArrayOfChannels() const noexcept        { return channels; }
+
+    //==============================================================================
+    /** Changes the buffer's size or number of channels.
+
+        This behaves in the same way as AudioSampleBuffer::setSize().
+        @see AudioSampleBuffer::setSize
+    */
+    void setSize (int newNumChannels,
+                  int newNumSamples,
+                  bool keepExistingContent = false,
+                  bool clearExtraSpace = false,
+                  bool avoidReallocating = false) noexcept;
+
+    /** Makes sure that the buffer has enough memory to be resized up to the given size
+        without allocating.
+        This behaves in the same way as AudioSampleBuffer::reserveSpace().
+        @see AudioSampleBuffer::reserveSpace
+    */
+    void reserveSpace (int numChannels, int numSamples);
+
+    /** Makes this buffer point to a pre-allocated set of channel data arrays.
+
+        Note that if the buffer is resized or its number of channels is changed, it
+        will re-allocate memory internally and copy the existing data to this new area,
+        so it will then stop directly addressing this memory.
+    */
+    void setDataToReferTo (double** dataToReferTo,
+                           int numChannels,
+                           int numSamples) noexcept;
+
+    //==============================================================================
+    /** Clears all the samples in all channels. */
+    void clear() noexcept;
+
+    /** Clears a specified region of all the channels. */
+    void clear (int startSample,
+                int numSamples) noexcept;
+
+    /** Clears a specified region of just one channel. */
+    void clear (int channel,
+                int startSample,
+                int numSamples) noexcept;
+
+    /** Applies a gain multiple to a region of one channel. */
+    void applyGain (int channel,
+                    int startSample,
+                    int numSamples,
+                    double gain) noexcept;
+
+    /** Applies a gain multiple to all the audio data. */
+    void applyGain (double gain) noexcept;
+
+    /** Adds samples from another buffer to this one.
+        @see AudioSampleBuffer::addFrom
+    */
+    void addFrom (int destChannel,
+                  int destStartSample,
+                  const DoubleAudioSampleBuffer& source,
+                  int sourceChannel,
+                  int sourceStartSample,
+                  int numSamples,
+                  double gainToApplyToSource = 1.0) noexcept;
+
+    /** Copies samples from another buffer to this one.
+        @see AudioSampleBuffer::copyFrom
+    */
+    void copyFrom (int destChannel,
+                   int destStartSample,
+                   const DoubleAudioSampleBuffer& source,
+                   int sourceChannel,
+                   int sourceStartSample,
+                   int numSamples) noexcept;
+
+    /** Copies samples from a single-precision buffer into one of this buffer's channels,
+        converting them to doubles.
+    */
+    void copyFrom (int destChannel,
+                   int destStartSample,
+                   const AudioSampleBuffer& source,
+                   int sourceChannel,
+                   int sourceStartSample,
+                   int numSamples) noexcept;
+
+    /** Copies samples from one of this buffer's channels into a single-precision buffer,
+        converting them to floats.
+    */
+    void copyTo (AudioSampleBuffer& destination,
+                 int destChannel,
+                 int destStartSample,
+                 int sourceChannel,
+                 int sourceStartSample,
+                 int numSamples) const noexcept;
+
+    /** Finds the highest absolute sample value within a region of a channel. */
+    double getMagnitude (int channel,
+                         int startSample,
+                         int numSamples) const noexcept;
+
+private:
+    //==============================================================================
+    int numChannels, size;
+    size_t allocatedBytes;
+    int reservedChannels, reservedSamplesPerChannel;
+    double** channels;
+    HeapBlock <char, true> allocatedData;
+    double* preallocatedChannelSpace [32];
+
+    void allocateSpace (int numChannels, int numSamples, bool keepExistingContent, bool clearExtraSpace);
+    void allocateChannels (double* const* dataToReferTo);
+
+    JUCE_LEAK_DETECTOR (DoubleAudioSampleBuffer)
+};
+
+
+#endif   // __JUCE_DOUBLEAUDIOSAMPLEBUFFER_JUCEHEADER__
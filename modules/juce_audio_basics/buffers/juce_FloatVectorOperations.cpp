@@ -21,14 +21,18 @@
 
   ==============================================================================
 */
+#if JUCE_USE_SSE_INTRINSICS || JUCE_USE_ARM_NEON
+ #define JUCE_USE_SIMD_FLOAT_OPS 1
+#endif
 
-#if JUCE_USE_SSE_INTRINSICS
+#if JUCE_USE_SIMD_FLOAT_OPS
 
 namespace FloatVectorHelpers
 {
+   #if JUCE_USE_SSE_INTRINSICS
     static bool sse2Present = false;
 
-    static bool isSSE2Available() noexcept
+    static bool isSIMDAvailable() noexcept
     {
         if (sse2Present)
             return true;
@@ -49,48 +53,223 @@ namespace FloatVectorHelpers
        #endif
     }
 
+    //==============================================================================
+    struct ParallelOps
+    {
+        typedef __m128 ParallelType;
+        enum { numParallel = 4 };
+
+        static forcedinline ParallelType load1 (float v) noexcept                           { return _mm_load1_ps (&v); }
+        static forcedinline ParallelType loadA (const float* v) noexcept                    { return _mm_load_ps (v); }
+        static forcedinline ParallelType loadU (const float* v) noexcept                    { return _mm_loadu_ps (v); }
+        static forcedinline void storeA (float* dest, ParallelType a) noexcept              { _mm_store_ps (dest, a); }
+        static forcedinline void storeU (float* dest, ParallelType a) noexcept              { _mm_storeu_ps (dest, a); }
+        static forcedinline ParallelType loadInts (const int* src) noexcept                 { return _mm_cvtepi32_ps (_mm_loadu_si128 ((const __m128i*) src)); }
+
+        static forcedinline ParallelType add (ParallelType a, ParallelType b) noexcept      { return _mm_add_ps (a, b); }
+        static forcedinline ParallelType mul (ParallelType a, ParallelType b) noexcept      { return _mm_mul_ps (a, b); }
+        static forcedinline ParallelType max (ParallelType a, ParallelType b) noexcept      { return _mm_max_ps (a, b); }
+        static forcedinline ParallelType min (ParallelType a, ParallelType b) noexcept      { return _mm_min_ps (a, b); }
+        static forcedinline ParallelType neg (ParallelType a) noexcept                      { return _mm_xor_ps (a, load1 (-0.0f)); }
+        static forcedinline ParallelType abs (ParallelType a) noexcept                      { return _mm_andnot_ps (load1 (-0.0f), a); }
+
+        static forcedinline void interleave (float* dest, ParallelType a, ParallelType b) noexcept
+        {
+            _mm_storeu_ps (dest,     _mm_unpacklo_ps (a, b));
+            _mm_storeu_ps (dest + 4, _mm_unpackhi_ps (a, b));
+        }
+
+        static forcedinline void deinterleave (const float* src, ParallelType& a, ParallelType& b) noexcept
+        {
+            const ParallelType lo = _mm_loadu_ps (src);
+            const ParallelType hi = _mm_loadu_ps (src + 4);
+            a = _mm_shuffle_ps (lo, hi, _MM_SHUFFLE (2, 0, 2, 0));
+            b = _mm_shuffle_ps (lo, hi, _MM_SHUFFLE (3, 1, 3, 1));
+        }
+
+        // (these work on 8 values, and the floats must already be within the range of an int16)
+        static forcedinline void storeInt16 (int16* dest, ParallelType a, ParallelType b) noexcept
+        {
+            _mm_storeu_si128 ((__m128i*) dest, _mm_packs_epi32 (_mm_cvtps_epi32 (a), _mm_cvtps_epi32 (b)));
+        }
+
+        static forcedinline void loadInt16 (const int16* src, ParallelType& a, ParallelType& b) noexcept
+        {
+            const __m128i v = _mm_loadu_si128 ((const __m128i*) src);
+            a = _mm_cvtepi32_ps (_mm_srai_epi32 (_mm_unpacklo_epi16 (v, v), 16));
+            b = _mm_cvtepi32_ps (_mm_srai_epi32 (_mm_unpackhi_epi16 (v, v), 16));
+        }
+
+        static forcedinline float max (ParallelType a) noexcept     { float v[4]; storeU (v, a); return jmax (v[0], v[1], v[2], v[3]); }
+        static forcedinline float min (ParallelType a) noexcept     { float v[4]; storeU (v, a); return jmin (v[0], v[1], v[2], v[3]); }
+    };
+
+    // The products are summed as doubles, to keep the same precision as the plain loop.
+    static double sumOfProducts (const float* src1, const float* src2, int num) noexcept
+    {
+        double total = 0;
+
+        if (isSIMDAvailable())
+        {
+            const int numLongOps = num / 4;
+            __m128d sumLo = _mm_setzero_pd(), sumHi = _mm_setzero_pd();
+
+            for (int i = 0; i < numLongOps; ++i)
+            {
+                const __m128 p = _mm_mul_ps (_mm_loadu_ps (src1), _mm_loadu_ps (src2));
+                sumLo = _mm_add_pd (sumLo, _mm_cvtps_pd (p));
+                sumHi = _mm_add_pd (sumHi, _mm_cvtps_pd (_mm_movehl_ps (p, p)));
+                src1 += 4;
+                src2 += 4;
+            }
+
+            double sums[2];
+            _mm_storeu_pd (sums, _mm_add_pd (sumLo, sumHi));
+            mmEmpty();
+
+            total = sums[0] + sums[1];
+            num &= 3;
+        }
+
+        while (--num >= 0)
+            total += *src1++ * *src2++;
+
+        return total;
+    }
+
+   #elif JUCE_USE_ARM_NEON
+    // NEON is always present on the ARM targets that this gets compiled for
+    inline static bool isSIMDAvailable() noexcept                   { return true; }
+    inline static bool isAligned (const void*) noexcept             { return true; }
+    inline static void mmEmpty() noexcept                           {}
+
+    //==============================================================================
+    struct ParallelOps
+    {
+        typedef float32x4_t ParallelType;
+        enum { numParallel = 4 };
+
+        static forcedinline ParallelType load1 (float v) noexcept                           { return vld1q_dup_f32 (&v); }
+        static forcedinline ParallelType loadA (const float* v) noexcept                    { return vld1q_f32 (v); }
+        static forcedinline ParallelType loadU (const float* v) noexcept                    { return vld1q_f32 (v); }
+        static forcedinline void storeA (float* dest, ParallelType a) noexcept              { vst1q_f32 (dest, a); }
+        static forcedinline void storeU (float* dest, ParallelType a) noexcept              { vst1q_f32 (dest, a); }
+        static forcedinline ParallelType loadInts (const int* src) noexcept                 { return vcvtq_f32_s32 (vld1q_s32 (src)); }
+
+        static forcedinline ParallelType add (ParallelType a, ParallelType b) noexcept      { return vaddq_f32 (a, b); }
+        static forcedinline ParallelType mul (ParallelType a, ParallelType b) noexcept      { return vmulq_f32 (a, b); }
+        static forcedinline ParallelType max (ParallelType a, ParallelType b) noexcept      { return vmaxq_f32 (a, b); }
+        static forcedinline ParallelType min (ParallelType a, ParallelType b) noexcept      { return vminq_f32 (a, b); }
+        static forcedinline ParallelType neg (ParallelType a) noexcept                      { return vnegq_f32 (a); }
+        static forcedinline ParallelType abs (ParallelType a) noexcept                      { return vabsq_f32 (a); }
+
+        static forcedinline void interleave (float* dest, ParallelType a, ParallelType b) noexcept
+        {
+            float32x4x2_t v;
+            v.val[0] = a;
+            v.val[1] = b;
+            vst2q_f32 (dest, v);
+        }
+
+        static forcedinline void deinterleave (const float* src, ParallelType& a, ParallelType& b) noexcept
+        {
+            const float32x4x2_t v = vld2q_f32 (src);
+            a = v.val[0];
+            b = v.val[1];
+        }
+
+        // (these work on 8 values, and the floats must already be within the range of an int16)
+        static forcedinline void storeInt16 (int16* dest, ParallelType a, ParallelType b) noexcept
+        {
+            vst1q_s16 (dest, vcombine_s16 (vqmovn_s32 (roundToInt (a)), vqmovn_s32 (roundToInt (b))));
+        }
+
+        static forcedinline void loadInt16 (const int16* src, ParallelType& a, ParallelType& b) noexcept
+        {
+            const int16x8_t v = vld1q_s16 (src);
+            a = vcvtq_f32_s32 (vmovl_s16 (vget_low_s16 (v)));
+            b = vcvtq_f32_s32 (vmovl_s16 (vget_high_s16 (v)));
+        }
+
+        // (NEON's conversion truncates, so this adds 0.5 with the same sign as the value first)
+        static forcedinline int32x4_t roundToInt (ParallelType a) noexcept
+        {
+            const uint32x4_t sign = vandq_u32 (vreinterpretq_u32_f32 (a), vdupq_n_u32 (0x80000000u));
+            return vcvtq_s32_f32 (vaddq_f32 (a, vreinterpretq_f32_u32 (vorrq_u32 (sign, vreinterpretq_u32_f32 (vdupq_n_f32 (0.5f))))));
+        }
+
+        static forcedinline float max (ParallelType a) noexcept     { float v[4]; storeU (v, a); return jmax (v[0], v[1], v[2], v[3]); }
+        static forcedinline float min (ParallelType a) noexcept     { float v[4]; storeU (v, a); return jmin (v[0], v[1], v[2], v[3]); }
+    };
+
+    // There's no double-precision NEON on 32-bit ARM, so the products are summed as floats
+    // in short runs, and each run is then added to a double total.
+    static double sumOfProducts (const float* src1, const float* src2, int num) noexcept
+    {
+        double total = 0;
+
+        while (num >= 4)
+        {
+            const int numInRun = jmin (64, num / 4);
+            float32x4_t sum = vmulq_f32 (vld1q_f32 (src1), vld1q_f32 (src2));
+
+            for (int i = 1; i < numInRun; ++i)
+                sum = vmlaq_f32 (sum, vld1q_f32 (src1 + 4 * i), vld1q_f32 (src2 + 4 * i));
+
+            float sums[4];
+            vst1q_f32 (sums, sum);
+            total += (double) sums[0] + sums[1] + sums[2] + sums[3];
+
+            src1 += 4 * numInRun;
+            src2 += 4 * numInRun;
+            num  -= 4 * numInRun;
+        }
+
+        while (--num >= 0)
+            total += *src1++ * *src2++;
+
+        return total;
+    }
+   #endif
+
+    //==============================================================================
     static inline float findMinimumOrMaximum (const float* src, int num, const bool isMinimum) noexcept
     {
-       #if JUCE_USE_SSE_INTRINSICS
-        const int numLongOps = num / 4;
+        typedef ParallelOps Mode;
+        const int numLongOps = num / Mode::numParallel;
 
-        if (numLongOps > 1 && FloatVectorHelpers::isSSE2Available())
+        if (numLongOps > 1 && isSIMDAvailable())
         {
-            __m128 val;
+            Mode::ParallelType val;
 
-            #define JUCE_MINIMUMMAXIMUM_SSE_LOOP(loadOp, minMaxOp) \
+            #define JUCE_MINIMUMMAXIMUM_SIMD_LOOP(loadOp, minMaxOp) \
                 val = loadOp (src); \
-                src += 4; \
+                src += Mode::numParallel; \
                 for (int i = 1; i < numLongOps; ++i) \
                 { \
-                    const __m128 s = loadOp (src); \
+                    const Mode::ParallelType s = loadOp (src); \
                     val = minMaxOp (val, s); \
-                    src += 4; \
+                    src += Mode::numParallel; \
                 }
 
             if (isMinimum)
             {
-                if (FloatVectorHelpers::isAligned (src)) { JUCE_MINIMUMMAXIMUM_SSE_LOOP (_mm_load_ps,  _mm_min_ps) }
-                else                                     { JUCE_MINIMUMMAXIMUM_SSE_LOOP (_mm_loadu_ps, _mm_min_ps) }
+                if (isAligned (src)) { JUCE_MINIMUMMAXIMUM_SIMD_LOOP (Mode::loadA, Mode::min) }
+                else                 { JUCE_MINIMUMMAXIMUM_SIMD_LOOP (Mode::loadU, Mode::min) }
             }
             else
             {
-                if (FloatVectorHelpers::isAligned (src)) { JUCE_MINIMUMMAXIMUM_SSE_LOOP (_mm_load_ps, _mm_max_ps) }
-                else                                     { JUCE_MINIMUMMAXIMUM_SSE_LOOP (_mm_loadu_ps,_mm_max_ps) }
+                if (isAligned (src)) { JUCE_MINIMUMMAXIMUM_SIMD_LOOP (Mode::loadA, Mode::max) }
+                else                 { JUCE_MINIMUMMAXIMUM_SIMD_LOOP (Mode::loadU, Mode::max) }
             }
 
-            float localVal;
+            #undef JUCE_MINIMUMMAXIMUM_SIMD_LOOP
 
-            {
-                float vals[4];
-                _mm_storeu_ps (vals, val);
-                FloatVectorHelpers::mmEmpty();
+            float localVal = isMinimum ? Mode::min (val)
+                                       : Mode::max (val);
+            mmEmpty();
 
-                localVal = isMinimum ? jmin (vals[0], vals[1], vals[2], vals[3])
-                                     : jmax (vals[0], vals[1], vals[2], vals[3]);
-            }
-
-            num &= 3;
+            num &= (Mode::numParallel - 1);
 
             for (int i = 0; i < num; ++i)
                 localVal = isMinimum ? jmin (localVal, src[i])
@@ -98,67 +277,230 @@ namespace FloatVectorHelpers
 
             return localVal;
         }
-       #endif
 
         return isMinimum ? juce::findMinimum (src, num)
                          : juce::findMaximum (src, num);
     }
 }
 
-#define JUCE_BEGIN_SSE_OP \
-    if (FloatVectorHelpers::isSSE2Available()) \
+#define JUCE_BEGIN_SIMD_OP \
+    typedef FloatVectorHelpers::ParallelOps Mode; \
+    if (FloatVectorHelpers::isSIMDAvailable()) \
     { \
-        const int numLongOps = num / 4;
+        const int numLongOps = num / Mode::numParallel;
 
-#define JUCE_FINISH_SSE_OP(normalOp) \
+#define JUCE_FINISH_SIMD_OP(normalOp) \
         FloatVectorHelpers::mmEmpty(); \
-        num &= 3; \
+        num &= (Mode::numParallel - 1); \
         if (num == 0) return; \
     } \
     for (int i = 0; i < num; ++i) normalOp;
 
-#define JUCE_SSE_LOOP(sseOp, srcLoad, dstLoad, dstStore, locals, increment) \
+#define JUCE_SIMD_LOOP(simdOp, srcLoad, dstLoad, dstStore, locals, increment) \
     for (int i = 0; i < numLongOps; ++i) \
     { \
         locals (srcLoad, dstLoad); \
-        dstStore (dest, sseOp); \
+        dstStore (dest, simdOp); \
         increment; \
     }
 
-#define JUCE_INCREMENT_SRC_DEST    dest += 4; src += 4;
-#define JUCE_INCREMENT_DEST        dest += 4;
+#define JUCE_INCREMENT_SRC_DEST         dest += Mode::numParallel; src += Mode::numParallel;
+#define JUCE_INCREMENT_SRC1_SRC2_DEST   dest += Mode::numParallel; src1 += Mode::numParallel; src2 += Mode::numParallel;
+#define JUCE_INCREMENT_DEST             dest += Mode::numParallel;
 
 #define JUCE_LOAD_NONE(srcLoad, dstLoad)
-#define JUCE_LOAD_DEST(srcLoad, dstLoad)     const __m128 d = dstLoad (dest);
-#define JUCE_LOAD_SRC(srcLoad, dstLoad)      const __m128 s = srcLoad (src);
-#define JUCE_LOAD_SRC_DEST(srcLoad, dstLoad) const __m128 d = dstLoad (dest); const __m128 s = srcLoad (src);
-
-#define JUCE_PERFORM_SSE_OP_DEST(normalOp, sseOp, locals) \
-    JUCE_BEGIN_SSE_OP \
-    if (FloatVectorHelpers::isAligned (dest))   JUCE_SSE_LOOP (sseOp, dummy, _mm_load_ps,  _mm_store_ps,  locals, JUCE_INCREMENT_DEST) \
-    else                                        JUCE_SSE_LOOP (sseOp, dummy, _mm_loadu_ps, _mm_storeu_ps, locals, JUCE_INCREMENT_DEST) \
-    JUCE_FINISH_SSE_OP (normalOp)
-
-#define JUCE_PERFORM_SSE_OP_SRC_DEST(normalOp, sseOp, locals, increment) \
-    JUCE_BEGIN_SSE_OP \
+#define JUCE_LOAD_DEST(srcLoad, dstLoad)            const Mode::ParallelType d = dstLoad (dest);
+#define JUCE_LOAD_SRC(srcLoad, dstLoad)             const Mode::ParallelType s = srcLoad (src);
+#define JUCE_LOAD_SRC_DEST(srcLoad, dstLoad)        const Mode::ParallelType d = dstLoad (dest); const Mode::ParallelType s = srcLoad (src);
+#define JUCE_LOAD_SRC1_SRC2(srcLoad, dstLoad)       const Mode::ParallelType s1 = srcLoad (src1); const Mode::ParallelType s2 = srcLoad (src2);
+#define JUCE_LOAD_SRC1_SRC2_DEST(srcLoad, dstLoad)  const Mode::ParallelType d = dstLoad (dest); JUCE_LOAD_SRC1_SRC2 (srcLoad, dstLoad)
+
+#define JUCE_PERFORM_SIMD_OP_DEST(normalOp, simdOp, locals) \
+    JUCE_BEGIN_SIMD_OP \
+    if (FloatVectorHelpers::isAligned (dest))   JUCE_SIMD_LOOP (simdOp, dummy, Mode::loadA, Mode::storeA, locals, JUCE_INCREMENT_DEST) \
+    else                                        JUCE_SIMD_LOOP (simdOp, dummy, Mode::loadU, Mode::storeU, locals, JUCE_INCREMENT_DEST) \
+    JUCE_FINISH_SIMD_OP (normalOp)
+
+#define JUCE_PERFORM_SIMD_OP_SRC_DEST(normalOp, simdOp, locals, increment) \
+    JUCE_BEGIN_SIMD_OP \
     if (FloatVectorHelpers::isAligned (dest)) \
     { \
-        if (FloatVectorHelpers::isAligned (src)) JUCE_SSE_LOOP (sseOp, _mm_load_ps,  _mm_load_ps, _mm_store_ps, locals, increment) \
-        else                                     JUCE_SSE_LOOP (sseOp, _mm_loadu_ps, _mm_load_ps, _mm_store_ps, locals, increment) \
+        if (FloatVectorHelpers::isAligned (src)) JUCE_SIMD_LOOP (simdOp, Mode::loadA, Mode::loadA, Mode::storeA, locals, increment) \
+        else                                     JUCE_SIMD_LOOP (simdOp, Mode::loadU, Mode::loadA, Mode::storeA, locals, increment) \
     }\
     else \
     { \
-        if (FloatVectorHelpers::isAligned (src)) JUCE_SSE_LOOP (sseOp, _mm_load_ps,  _mm_loadu_ps, _mm_storeu_ps, locals, increment) \
-        else                                     JUCE_SSE_LOOP (sseOp, _mm_loadu_ps, _mm_loadu_ps, _mm_storeu_ps, locals, increment) \
+        if (FloatVectorHelpers::isAligned (src)) JUCE_SIMD_LOOP (simdOp, Mode::loadA, Mode::loadU, Mode::storeU, locals, increment) \
+        else                                     JUCE_SIMD_LOOP (simdOp, Mode::loadU, Mode::loadU, Mode::storeU, locals, increment) \
     } \
-    JUCE_FINISH_SSE_OP (normalOp)
+    JUCE_FINISH_SIMD_OP (normalOp)
 
+#define JUCE_PERFORM_SIMD_OP_SRC1_SRC2_DEST(normalOp, simdOp, locals) \
+    JUCE_BEGIN_SIMD_OP \
+    if (FloatVectorHelpers::isAligned (dest)) \
+    { \
+        if (FloatVectorHelpers::isAligned (src1) && FloatVectorHelpers::isAligned (src2)) \
+             JUCE_SIMD_LOOP (simdOp, Mode::loadA, Mode::loadA, Mode::storeA, locals, JUCE_INCREMENT_SRC1_SRC2_DEST) \
+        else JUCE_SIMD_LOOP (simdOp, Mode::loadU, Mode::loadA, Mode::storeA, locals, JUCE_INCREMENT_SRC1_SRC2_DEST) \
+    }\
+    else \
+    { \
+        if (FloatVectorHelpers::isAligned (src1) && FloatVectorHelpers::isAligned (src2)) \
+             JUCE_SIMD_LOOP (simdOp, Mode::loadA, Mode::loadU, Mode::storeU, locals, JUCE_INCREMENT_SRC1_SRC2_DEST) \
+        else JUCE_SIMD_LOOP (simdOp, Mode::loadU, Mode::loadU, Mode::storeU, locals, JUCE_INCREMENT_SRC1_SRC2_DEST) \
+    } \
+    JUCE_FINISH_SIMD_OP (normalOp)
 
 #else
- #define JUCE_PERFORM_SSE_OP_DEST(normalOp, unused1, unused2)              for (int i = 0; i < num; ++i) normalOp;
- #define JUCE_PERFORM_SSE_OP_SRC_DEST(normalOp, sseOp, locals, increment)  for (int i = 0; i < num; ++i) normalOp;
+ #define JUCE_PERFORM_SIMD_OP_DEST(normalOp, unused1, unused2)               for (int i = 0; i < num; ++i) normalOp;
+ #define JUCE_PERFORM_SIMD_OP_SRC_DEST(normalOp, simdOp, locals, increment)  for (int i = 0; i < num; ++i) normalOp;
+ #define JUCE_PERFORM_SIMD_OP_SRC1_SRC2_DEST(normalOp, simdOp, locals)       for (int i = 0; i < num; ++i) normalOp;
 #endif
 
+//==============================================================================
+namespace FloatVectorRampHelpers
+{
+   #if JUCE_USE_SIMD_FLOAT_OPS
+    typedef FloatVectorHelpers::ParallelOps Mode;
+   #endif
+
+    // These are what a ramp does with each value and its gain..
+    struct MultiplyOp
+    {
+        MultiplyOp (float* d) noexcept : dest (d) {}
+
+        forcedinline void apply (const float gain) noexcept                 { *dest++ *= gain; }
+
+       #if JUCE_USE_SIMD_FLOAT_OPS
+        forcedinline void apply (const Mode::ParallelType gains) noexcept
+        {
+            Mode::storeU (dest, Mode::mul (Mode::loadU (dest), gains));
+            dest += Mode::numParallel;
+        }
+       #endif
+
+        float* dest;
+    };
+
+    struct CopyOp
+    {
+        CopyOp (float* d, const float* s) noexcept : dest (d), src (s) {}
+
+        forcedinline void apply (const float gain) noexcept                 { *dest++ = *src++ * gain; }
+
+       #if JUCE_USE_SIMD_FLOAT_OPS
+        forcedinline void apply (const Mode::ParallelType gains) noexcept
+        {
+            Mode::storeU (dest, Mode::mul (Mode::loadU (src), gains));
+            dest += Mode::numParallel;
+            src += Mode::numParallel;
+        }
+       #endif
+
+        float* dest;
+        const float* src;
+    };
+
+    struct AddOp
+    {
+        AddOp (float* d, const float* s) noexcept : dest (d), src (s) {}
+
+        forcedinline void apply (const float gain) noexcept                 { *dest++ += *src++ * gain; }
+
+       #if JUCE_USE_SIMD_FLOAT_OPS
+        forcedinline void apply (const Mode::ParallelType gains) noexcept
+        {
+            Mode::storeU (dest, Mode::add (Mode::loadU (dest), Mode::mul (Mode::loadU (src), gains)));
+            dest += Mode::numParallel;
+            src += Mode::numParallel;
+        }
+       #endif
+
+        float* dest;
+        const float* src;
+    };
+
+    // ..and these are the ways in which the gain can move: by a fixed amount for each value,
+    // or by a fixed ratio.
+    struct LinearRamp
+    {
+        static forcedinline float next (const float gain, const float step) noexcept           { return gain + step; }
+        static forcedinline float advance (const float gain, const float step, const int num)   { return gain + step * (float) num; }
+        static forcedinline float stepFor (const float step, const int num)                     { return step * (float) num; }
+
+       #if JUCE_USE_SIMD_FLOAT_OPS
+        static forcedinline Mode::ParallelType next (const Mode::ParallelType gains, const Mode::ParallelType step) noexcept
+        {
+            return Mode::add (gains, step);
+        }
+       #endif
+    };
+
+    struct ExponentialRamp
+    {
+        static forcedinline float next (const float gain, const float step) noexcept           { return gain * step; }
+        static forcedinline float advance (const float gain, const float step, const int num)   { return gain * std::pow (step, (float) num); }
+        static forcedinline float stepFor (const float step, const int num)                     { return std::pow (step, (float) num); }
+
+       #if JUCE_USE_SIMD_FLOAT_OPS
+        static forcedinline Mode::ParallelType next (const Mode::ParallelType gains, const Mode::ParallelType step) noexcept
+        {
+            return Mode::mul (gains, step);
+        }
+       #endif
+    };
+
+    template <class RampType, class Op>
+    static void applyRamp (Op op, float gain, const float step, int num) noexcept
+    {
+       #if JUCE_USE_SIMD_FLOAT_OPS
+        const int numLongOps = num / Mode::numParallel;
+
+        if (numLongOps > 0 && FloatVectorHelpers::isSIMDAvailable())
+        {
+            float initialGains [Mode::numParallel];
+
+            for (int i = 0; i < Mode::numParallel; ++i)
+                initialGains[i] = RampType::advance (gain, step, i);
+
+            Mode::ParallelType gains = Mode::loadU (initialGains);
+            const Mode::ParallelType gainStep = Mode::load1 (RampType::stepFor (step, Mode::numParallel));
+
+            for (int i = 0; i < numLongOps; ++i)
+            {
+                op.apply (gains);
+                gains = RampType::next (gains, gainStep);
+            }
+
+            FloatVectorHelpers::mmEmpty();
+
+            gain = RampType::advance (gain, step, numLongOps * Mode::numParallel);
+            num &= (Mode::numParallel - 1);
+        }
+       #endif
+
+        while (--num >= 0)
+        {
+            op.apply (gain);
+            gain = RampType::next (gain, step);
+        }
+    }
+
+    template <class Op>
+    static void applyExponentialRamp (Op op, const float startGain, const float endGain, const int num) noexcept
+    {
+        // An exponential ramp can only move between two gains of the same sign, neither of
+        // which is zero - if you need to fade to or from silence, use a linear ramp.
+        jassert (startGain * endGain > 0);
+
+        if (startGain * endGain > 0)
+            applyRamp<ExponentialRamp> (op, startGain, (float) std::pow ((double) endGain / startGain, 1.0 / num), num);
+        else
+            applyRamp<LinearRamp> (op, startGain, (endGain - startGain) / num, num);
+    }
+}
+
+//==============================================================================
 void JUCE_CALLTYPE FloatVectorOperations::clear (float* dest, int num) noexcept
 {
    #if JUCE_USE_VDSP_FRAMEWORK
@@ -173,11 +515,11 @@ void JUCE_CALLTYPE FloatVectorOperations::fill (float* dest, float valueToFill,
    #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vfill (&valueToFill, dest, 1, num);
    #else
-    #if JUCE_USE_SSE_INTRINSICS
-     const __m128 val = _mm_load1_ps (&valueToFill);
+    #if JUCE_USE_SIMD_FLOAT_OPS
+     const FloatVectorHelpers::ParallelOps::ParallelType val = FloatVectorHelpers::ParallelOps::load1 (valueToFill);
     #endif
 
-    JUCE_PERFORM_SSE_OP_DEST (dest[i] = valueToFill, val, JUCE_LOAD_NONE)
+    JUCE_PERFORM_SIMD_OP_DEST (dest[i] = valueToFill, val, JUCE_LOAD_NONE)
    #endif
 }
 
@@ -191,13 +533,13 @@ void JUCE_CALLTYPE FloatVectorOperations::copyWithMultiply (float* dest, const f
    #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vsmul (src, 1, &multiplier, dest, 1, num);
    #else
-    #if JUCE_USE_SSE_INTRINSICS
-     const __m128 mult = _mm_load1_ps (&multiplier);
+    #if JUCE_USE_SIMD_FLOAT_OPS
+     const FloatVectorHelpers::ParallelOps::ParallelType mult = FloatVectorHelpers::ParallelOps::load1 (multiplier);
     #endif
 
-    JUCE_PERFORM_SSE_OP_SRC_DEST (dest[i] = src[i] * multiplier,
-                                  _mm_mul_ps (mult, s),
-                                  JUCE_LOAD_SRC, JUCE_INCREMENT_SRC_DEST)
+    JUCE_PERFORM_SIMD_OP_SRC_DEST (dest[i] = src[i] * multiplier,
+                                   Mode::mul (mult, s),
+                                   JUCE_LOAD_SRC, JUCE_INCREMENT_SRC_DEST)
    #endif
 }
 
@@ -206,32 +548,81 @@ void JUCE_CALLTYPE FloatVectorOperations::add (float* dest, const float* src, in
    #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vadd (src, 1, dest, 1, dest, 1, num);
    #else
-    JUCE_PERFORM_SSE_OP_SRC_DEST (dest[i] += src[i],
-                                  _mm_add_ps (d, s),
-                                  JUCE_LOAD_SRC_DEST, JUCE_INCREMENT_SRC_DEST)
+    JUCE_PERFORM_SIMD_OP_SRC_DEST (dest[i] += src[i],
+                                   Mode::add (d, s),
+                                   JUCE_LOAD_SRC_DEST, JUCE_INCREMENT_SRC_DEST)
    #endif
 }
 
 void JUCE_CALLTYPE FloatVectorOperations::add (float* dest, float amount, int num) noexcept
 {
-   #if JUCE_USE_SSE_INTRINSICS
-    const __m128 amountToAdd = _mm_load1_ps (&amount);
+   #if JUCE_USE_SIMD_FLOAT_OPS
+    const FloatVectorHelpers::ParallelOps::ParallelType amountToAdd = FloatVectorHelpers::ParallelOps::load1 (amount);
    #endif
 
-    JUCE_PERFORM_SSE_OP_DEST (dest[i] += amount,
-                              _mm_add_ps (d, amountToAdd),
-                              JUCE_LOAD_DEST)
+    JUCE_PERFORM_SIMD_OP_DEST (dest[i] += amount,
+                               Mode::add (d, amountToAdd),
+                               JUCE_LOAD_DEST)
 }
 
 void JUCE_CALLTYPE FloatVectorOperations::addWithMultiply (float* dest, const float* src, float multiplier, int num) noexcept
 {
-   #if JUCE_USE_SSE_INTRINSICS
-    const __m128 mult = _mm_load1_ps (&multiplier);
+   #if JUCE_USE_SIMD_FLOAT_OPS
+    const FloatVectorHelpers::ParallelOps::ParallelType mult = FloatVectorHelpers::ParallelOps::load1 (multiplier);
+   #endif
+
+    JUCE_PERFORM_SIMD_OP_SRC_DEST (dest[i] += src[i] * multiplier,
+                                   Mode::add (d, Mode::mul (mult, s)),
+                                   JUCE_LOAD_SRC_DEST, JUCE_INCREMENT_SRC_DEST)
+}
+
+void JUCE_CALLTYPE FloatVectorOperations::addWithMultiply (float* dest, const float* src1, const float* src2, int num) noexcept
+{
+   #if JUCE_USE_VDSP_FRAMEWORK
+    vDSP_vma (src1, 1, src2, 1, dest, 1, dest, 1, num);
+   #else
+    JUCE_PERFORM_SIMD_OP_SRC1_SRC2_DEST (dest[i] += src1[i] * src2[i],
+                                         Mode::add (d, Mode::mul (s1, s2)),
+                                         JUCE_LOAD_SRC1_SRC2_DEST)
    #endif
+}
+
+void JUCE_CALLTYPE FloatVectorOperations::addWithRamp (float* dest, const float* src, const float startGain,
+                                                      const float endGain, const int num) noexcept
+{
+    if (num > 0)
+        FloatVectorRampHelpers::applyRamp<FloatVectorRampHelpers::LinearRamp> (FloatVectorRampHelpers::AddOp (dest, src),
+                                                                               startGain, (endGain - startGain) / num, num);
+}
+
+void JUCE_CALLTYPE FloatVectorOperations::addWithExponentialRamp (float* dest, const float* src, const float startGain,
+                                                                 const float endGain, const int num) noexcept
+{
+    if (num > 0)
+        FloatVectorRampHelpers::applyExponentialRamp (FloatVectorRampHelpers::AddOp (dest, src), startGain, endGain, num);
+}
+
+void JUCE_CALLTYPE FloatVectorOperations::copyWithRamp (float* dest, const float* src, const float startGain,
+                                                       const float endGain, const int num) noexcept
+{
+    if (num > 0)
+        FloatVectorRampHelpers::applyRamp<FloatVectorRampHelpers::LinearRamp> (FloatVectorRampHelpers::CopyOp (dest, src),
+                                                                               startGain, (endGain - startGain) / num, num);
+}
 
-    JUCE_PERFORM_SSE_OP_SRC_DEST (dest[i] += src[i] * multiplier,
-                                  _mm_add_ps (d, _mm_mul_ps (mult, s)),
-                                  JUCE_LOAD_SRC_DEST, JUCE_INCREMENT_SRC_DEST)
+void JUCE_CALLTYPE FloatVectorOperations::multiplyWithRamp (float* dest, const float startGain,
+                                                           const float endGain, const int num) noexcept
+{
+    if (num > 0)
+        FloatVectorRampHelpers::applyRamp<FloatVectorRampHelpers::LinearRamp> (FloatVectorRampHelpers::MultiplyOp (dest),
+                                                                               startGain, (endGain - startGain) / num, num);
+}
+
+void JUCE_CALLTYPE FloatVectorOperations::multiplyWithExponentialRamp (float* dest, const float startGain,
+                                                                      const float endGain, const int num) noexcept
+{
+    if (num > 0)
+        FloatVectorRampHelpers::applyExponentialRamp (FloatVectorRampHelpers::MultiplyOp (dest), startGain, endGain, num);
 }
 
 void JUCE_CALLTYPE FloatVectorOperations::multiply (float* dest, const float* src, int num) noexcept
@@ -239,9 +630,9 @@ void JUCE_CALLTYPE FloatVectorOperations::multiply (float* dest, const float* sr
    #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vmul (src, 1, dest, 1, dest, 1, num);
    #else
-    JUCE_PERFORM_SSE_OP_SRC_DEST (dest[i] *= src[i],
-                                  _mm_mul_ps (d, s),
-                                  JUCE_LOAD_SRC_DEST, JUCE_INCREMENT_SRC_DEST)
+    JUCE_PERFORM_SIMD_OP_SRC_DEST (dest[i] *= src[i],
+                                   Mode::mul (d, s),
+                                   JUCE_LOAD_SRC_DEST, JUCE_INCREMENT_SRC_DEST)
    #endif
 }
 
@@ -250,64 +641,292 @@ void JUCE_CALLTYPE FloatVectorOperations::multiply (float* dest, float multiplie
    #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vsmul (dest, 1, &multiplier, dest, 1, num);
    #else
-    #if JUCE_USE_SSE_INTRINSICS
-     const __m128 mult = _mm_load1_ps (&multiplier);
+    #if JUCE_USE_SIMD_FLOAT_OPS
+     const FloatVectorHelpers::ParallelOps::ParallelType mult = FloatVectorHelpers::ParallelOps::load1 (multiplier);
     #endif
 
-    JUCE_PERFORM_SSE_OP_DEST (dest[i] *= multiplier,
-                              _mm_mul_ps (d, mult),
-                              JUCE_LOAD_DEST)
+    JUCE_PERFORM_SIMD_OP_DEST (dest[i] *= multiplier,
+                               Mode::mul (d, mult),
+                               JUCE_LOAD_DEST)
+   #endif
+}
+
+void JUCE_CALLTYPE FloatVectorOperations::negate (float* dest, const float* src, int num) noexcept
+{
+   #if JUCE_USE_VDSP_FRAMEWORK
+    vDSP_vneg (src, 1, dest, 1, num);
+   #else
+    JUCE_PERFORM_SIMD_OP_SRC_DEST (dest[i] = -src[i],
+                                   Mode::neg (s),
+                                   JUCE_LOAD_SRC, JUCE_INCREMENT_SRC_DEST)
+   #endif
+}
+
+void JUCE_CALLTYPE FloatVectorOperations::abs (float* dest, const float* src, int num) noexcept
+{
+   #if JUCE_USE_VDSP_FRAMEWORK
+    vDSP_vabs (src, 1, dest, 1, num);
+   #else
+    JUCE_PERFORM_SIMD_OP_SRC_DEST (dest[i] = std::abs (src[i]),
+                                   Mode::abs (s),
+                                   JUCE_LOAD_SRC, JUCE_INCREMENT_SRC_DEST)
+   #endif
+}
+
+void JUCE_CALLTYPE FloatVectorOperations::clip (float* dest, const float* src, float low, float high, int num) noexcept
+{
+    jassert (high >= low);
+
+   #if JUCE_USE_VDSP_FRAMEWORK
+    vDSP_vclip (src, 1, &low, &high, dest, 1, num);
+   #else
+    #if JUCE_USE_SIMD_FLOAT_OPS
+     const FloatVectorHelpers::ParallelOps::ParallelType lo = FloatVectorHelpers::ParallelOps::load1 (low);
+     const FloatVectorHelpers::ParallelOps::ParallelType hi = FloatVectorHelpers::ParallelOps::load1 (high);
+    #endif
+
+    JUCE_PERFORM_SIMD_OP_SRC_DEST (dest[i] = jlimit (low, high, src[i]),
+                                   Mode::max (Mode::min (s, hi), lo),
+                                   JUCE_LOAD_SRC, JUCE_INCREMENT_SRC_DEST)
+   #endif
+}
+
+void JUCE_CALLTYPE FloatVectorOperations::min (float* dest, const float* src1, const float* src2, int num) noexcept
+{
+   #if JUCE_USE_VDSP_FRAMEWORK
+    vDSP_vmin (src1, 1, src2, 1, dest, 1, num);
+   #else
+    JUCE_PERFORM_SIMD_OP_SRC1_SRC2_DEST (dest[i] = jmin (src1[i], src2[i]),
+                                         Mode::min (s1, s2),
+                                         JUCE_LOAD_SRC1_SRC2)
+   #endif
+}
+
+void JUCE_CALLTYPE FloatVectorOperations::max (float* dest, const float* src1, const float* src2, int num) noexcept
+{
+   #if JUCE_USE_VDSP_FRAMEWORK
+    vDSP_vmax (src1, 1, src2, 1, dest, 1, num);
+   #else
+    JUCE_PERFORM_SIMD_OP_SRC1_SRC2_DEST (dest[i] = jmax (src1[i], src2[i]),
+                                         Mode::max (s1, s2),
+                                         JUCE_LOAD_SRC1_SRC2)
    #endif
 }
 
 void JUCE_CALLTYPE FloatVectorOperations::convertFixedToFloat (float* dest, const int* src, float multiplier, int num) noexcept
 {
-   #if JUCE_USE_SSE_INTRINSICS
-    const __m128 mult = _mm_load1_ps (&multiplier);
+   #if JUCE_USE_SIMD_FLOAT_OPS
+    const FloatVectorHelpers::ParallelOps::ParallelType mult = FloatVectorHelpers::ParallelOps::load1 (multiplier);
+   #endif
+
+    JUCE_PERFORM_SIMD_OP_SRC_DEST (dest[i] = src[i] * multiplier,
+                                   Mode::mul (mult, Mode::loadInts (src)),
+                                   JUCE_LOAD_NONE, JUCE_INCREMENT_SRC_DEST)
+}
+
+void JUCE_CALLTYPE FloatVectorOperations::convertFloatToInt16 (int16* dest, const float* src, float multiplier, int num) noexcept
+{
+   #if JUCE_USE_SIMD_FLOAT_OPS
+    if (FloatVectorHelpers::isSIMDAvailable())
+    {
+        typedef FloatVectorHelpers::ParallelOps Mode;
+        const Mode::ParallelType mult = Mode::load1 (multiplier);
+        const Mode::ParallelType lowest = Mode::load1 (-32768.0f);
+        const Mode::ParallelType highest = Mode::load1 (32767.0f);
+        const int numLongOps = num / (2 * Mode::numParallel);
+
+        for (int i = 0; i < numLongOps; ++i)
+        {
+            Mode::storeInt16 (dest, Mode::max (lowest, Mode::min (highest, Mode::mul (mult, Mode::loadU (src)))),
+                                    Mode::max (lowest, Mode::min (highest, Mode::mul (mult, Mode::loadU (src + Mode::numParallel)))));
+            src  += 2 * Mode::numParallel;
+            dest += 2 * Mode::numParallel;
+        }
+
+        FloatVectorHelpers::mmEmpty();
+        num &= (2 * Mode::numParallel - 1);
+    }
+   #endif
+
+    for (int i = 0; i < num; ++i)
+        dest[i] = (int16) jlimit (-32768, 32767, roundToInt (src[i] * multiplier));
+}
+
+void JUCE_CALLTYPE FloatVectorOperations::convertInt16ToFloat (float* dest, const int16* src, float multiplier, int num) noexcept
+{
+   #if JUCE_USE_SIMD_FLOAT_OPS
+    if (FloatVectorHelpers::isSIMDAvailable())
+    {
+        typedef FloatVectorHelpers::ParallelOps Mode;
+        const Mode::ParallelType mult = Mode::load1 (multiplier);
+        const int numLongOps = num / (2 * Mode::numParallel);
+
+        for (int i = 0; i < numLongOps; ++i)
+        {
+            Mode::ParallelType a, b;
+            Mode::loadInt16 (src, a, b);
+            Mode::storeU (dest, Mode::mul (mult, a));
+            Mode::storeU (dest + Mode::numParallel, Mode::mul (mult, b));
+            src  += 2 * Mode::numParallel;
+            dest += 2 * Mode::numParallel;
+        }
+
+        FloatVectorHelpers::mmEmpty();
+        num &= (2 * Mode::numParallel - 1);
+    }
+   #endif
+
+    for (int i = 0; i < num; ++i)
+        dest[i] = src[i] * multiplier;
+}
+
+//==============================================================================
+double JUCE_CALLTYPE FloatVectorOperations::dotProduct (const float* src1, const float* src2, int num) noexcept
+{
+   #if JUCE_USE_SIMD_FLOAT_OPS
+    return FloatVectorHelpers::sumOfProducts (src1, src2, num);
+   #else
+    double total = 0;
+
+    for (int i = 0; i < num; ++i)
+        total += src1[i] * src2[i];
+
+    return total;
+   #endif
+}
+
+double JUCE_CALLTYPE FloatVectorOperations::sumOfSquares (const float* src, int num) noexcept
+{
+    return dotProduct (src, src, num);
+}
+
+//==============================================================================
+void JUCE_CALLTYPE FloatVectorOperations::interleave (float* dest, const float* const* src, int numChannels, int num) noexcept
+{
+    jassert (numChannels > 0);
+
+   #if JUCE_USE_SIMD_FLOAT_OPS
+    if (numChannels == 2 && FloatVectorHelpers::isSIMDAvailable())
+    {
+        typedef FloatVectorHelpers::ParallelOps Mode;
+        const float* left = src[0];
+        const float* right = src[1];
+        const int numLongOps = num / Mode::numParallel;
+
+        for (int i = 0; i < numLongOps; ++i)
+        {
+            Mode::interleave (dest, Mode::loadU (left), Mode::loadU (right));
+            left  += Mode::numParallel;
+            right += Mode::numParallel;
+            dest  += 2 * Mode::numParallel;
+        }
+
+        FloatVectorHelpers::mmEmpty();
+
+        for (int i = num & (Mode::numParallel - 1); --i >= 0;)
+        {
+            *dest++ = *left++;
+            *dest++ = *right++;
+        }
+
+        return;
+    }
+   #endif
+
+    for (int chan = 0; chan < numChannels; ++chan)
+    {
+        const float* s = src[chan];
+        float* d = dest + chan;
+
+        for (int i = num; --i >= 0;)
+        {
+            *d = *s++;
+            d += numChannels;
+        }
+    }
+}
+
+void JUCE_CALLTYPE FloatVectorOperations::deinterleave (float* const* dest, const float* src, int numChannels, int num) noexcept
+{
+    jassert (numChannels > 0);
+
+   #if JUCE_USE_SIMD_FLOAT_OPS
+    if (numChannels == 2 && FloatVectorHelpers::isSIMDAvailable())
+    {
+        typedef FloatVectorHelpers::ParallelOps Mode;
+        float* left = dest[0];
+        float* right = dest[1];
+        const int numLongOps = num / Mode::numParallel;
+
+        for (int i = 0; i < numLongOps; ++i)
+        {
+            Mode::ParallelType l, r;
+            Mode::deinterleave (src, l, r);
+            Mode::storeU (left, l);
+            Mode::storeU (right, r);
+            left  += Mode::numParallel;
+            right += Mode::numParallel;
+            src   += 2 * Mode::numParallel;
+        }
+
+        FloatVectorHelpers::mmEmpty();
+
+        for (int i = num & (Mode::numParallel - 1); --i >= 0;)
+        {
+            *left++  = *src++;
+            *right++ = *src++;
+        }
+
+        return;
+    }
    #endif
 
-    JUCE_PERFORM_SSE_OP_SRC_DEST (dest[i] = src[i] * multiplier,
-                                  _mm_mul_ps (mult, _mm_cvtepi32_ps (_mm_loadu_si128 ((const __m128i*) src))),
-                                  JUCE_LOAD_NONE, JUCE_INCREMENT_SRC_DEST)
+    for (int chan = 0; chan < numChannels; ++chan)
+    {
+        const float* s = src + chan;
+        float* d = dest[chan];
+
+        for (int i = num; --i >= 0;)
+        {
+            *d++ = *s;
+            s += numChannels;
+        }
+    }
 }
 
+//==============================================================================
 void JUCE_CALLTYPE FloatVectorOperations::findMinAndMax (const float* src, int num, float& minResult, float& maxResult) noexcept
 {
-   #if JUCE_USE_SSE_INTRINSICS
-    const int numLongOps = num / 4;
+   #if JUCE_USE_SIMD_FLOAT_OPS
+    typedef FloatVectorHelpers::ParallelOps Mode;
+    const int numLongOps = num / Mode::numParallel;
 
-    if (numLongOps > 1 && FloatVectorHelpers::isSSE2Available())
+    if (numLongOps > 1 && FloatVectorHelpers::isSIMDAvailable())
     {
-        __m128 mn, mx;
+        Mode::ParallelType mn, mx;
 
-        #define JUCE_MINMAX_SSE_LOOP(loadOp) \
+        #define JUCE_MINMAX_SIMD_LOOP(loadOp) \
             mn = loadOp (src); \
             mx = mn; \
-            src += 4; \
+            src += Mode::numParallel; \
             for (int i = 1; i < numLongOps; ++i) \
             { \
-                const __m128 s = loadOp (src); \
-                mn = _mm_min_ps (mn, s); \
-                mx = _mm_max_ps (mx, s); \
-                src += 4; \
+                const Mode::ParallelType s = loadOp (src); \
+                mn = Mode::min (mn, s); \
+                mx = Mode::max (mx, s); \
+                src += Mode::numParallel; \
             }
 
-        if (FloatVectorHelpers::isAligned (src)) { JUCE_MINMAX_SSE_LOOP (_mm_load_ps) }
-        else                                     { JUCE_MINMAX_SSE_LOOP (_mm_loadu_ps) }
+        if (FloatVectorHelpers::isAligned (src)) { JUCE_MINMAX_SIMD_LOOP (Mode::loadA) }
+        else                                     { JUCE_MINMAX_SIMD_LOOP (Mode::loadU) }
 
-        float localMin, localMax;
+        #undef JUCE_MINMAX_SIMD_LOOP
 
-        {
-            float mns[4], mxs[4];
-            _mm_storeu_ps (mns, mn);
-            _mm_storeu_ps (mxs, mx);
-            FloatVectorHelpers::mmEmpty();
+        float localMin = Mode::min (mn);
+        float localMax = Mode::max (mx);
+        FloatVectorHelpers::mmEmpty();
 
-            localMin = jmin (mns[0], mns[1], mns[2], mns[3]);
-            localMax = jmax (mxs[0], mxs[1], mxs[2], mxs[3]);
-        }
-
-        num &= 3;
+        num &= (Mode::numParallel - 1);
 
         for (int i = 0; i < num; ++i)
         {
@@ -327,7 +946,7 @@ void JUCE_CALLTYPE FloatVectorOperations::findMinAndMax (const float* src, int n
 
 float JUCE_CALLTYPE FloatVectorOperations::findMinimum (const float* src, int num) noexcept
 {
-   #if JUCE_USE_SSE_INTRINSICS
+   #if JUCE_USE_SIMD_FLOAT_OPS
     return FloatVectorHelpers::findMinimumOrMaximum (src, num, true);
    #else
     return juce::findMinimum (src, num);
@@ -336,9 +955,407 @@ float JUCE_CALLTYPE FloatVectorOperations::findMinimum (const float* src, int nu
 
 float JUCE_CALLTYPE FloatVectorOperations::findMaximum (const float* src, int num) noexcept
 {
-   #if JUCE_USE_SSE_INTRINSICS
+   #if JUCE_USE_SIMD_FLOAT_OPS
     return FloatVectorHelpers::findMinimumOrMaximum (src, num, false);
    #else
     return juce::findMaximum (src, num);
    #endif
 }
+
+bool JUCE_CALLTYPE FloatVectorOperations::isSilent (const float* src, int num) noexcept
+{
+    // (testing a few values at a time keeps the number of branches down)
+    for (; num >= 4; num -= 4, src += 4)
+        if ((src[0] != 0) | (src[1] != 0) | (src[2] != 0) | (src[3] != 0))
+            return false;
+
+    while (--num >= 0)
+        if (*src++ != 0)
+            return false;
+
+    return true;
+}
+
+//==============================================================================
+#if ! JUCE_USE_SSE_INTRINSICS && defined (__GNUC__) \
+     && (defined (__aarch64__) || (defined (__arm__) && defined (__VFP_FP__) && ! defined (__SOFTFP__)))
+ #define JUCE_USE_ARM_FPCR 1
+#endif
+
+namespace DenormalHelpers
+{
+   #if JUCE_USE_SSE_INTRINSICS
+    enum
+    {
+        flushToZeroBit      = 0x8000,
+        denormalsAreZeroBit = 0x0040
+    };
+
+    static bool isSSEAvailable() noexcept
+    {
+       #if JUCE_64BIT
+        return true;
+       #else
+        return SystemStats::hasSSE();
+       #endif
+    }
+
+    static pointer_sized_int getDenormalBits() noexcept
+    {
+        if (! isSSEAvailable())
+            return 0;
+
+        // Some of the very first SSE2 chips don't support denormals-are-zero, and setting an
+        // unsupported bit would crash, so that one is only used on chips that have SSE3
+        return flushToZeroBit | (SystemStats::hasSSE3() ? denormalsAreZeroBit : 0);
+    }
+   #elif JUCE_USE_ARM_FPCR
+    static pointer_sized_int getDenormalBits() noexcept     { return 1 << 24; } // the FZ bit of the FPCR/FPSCR
+   #else
+    static pointer_sized_int getDenormalBits() noexcept     { return 0; }
+   #endif
+}
+
+pointer_sized_int JUCE_CALLTYPE FloatVectorOperations::getFpStatusRegister() noexcept
+{
+   #if JUCE_USE_SSE_INTRINSICS
+    if (DenormalHelpers::isSSEAvailable())
+        return (pointer_sized_int) _mm_getcsr();
+   #elif JUCE_USE_ARM_FPCR
+    pointer_sized_int value;
+
+    #if defined (__aarch64__)
+     asm volatile ("mrs %0, fpcr" : "=r" (value));
+    #else
+     asm volatile ("vmrs %0, fpscr" : "=r" (value));
+    #endif
+
+    return value;
+   #endif
+
+    return 0;
+}
+
+void JUCE_CALLTYPE FloatVectorOperations::setFpStatusRegister (const pointer_sized_int newValue) noexcept
+{
+   #if JUCE_USE_SSE_INTRINSICS
+    if (DenormalHelpers::isSSEAvailable())
+        _mm_setcsr ((unsigned int) newValue);
+   #elif JUCE_USE_ARM_FPCR
+    #if defined (__aarch64__)
+     asm volatile ("msr fpcr, %0" : : "r" (newValue));
+    #else
+     asm volatile ("vmsr fpscr, %0" : : "r" (newValue));
+    #endif
+   #else
+    (void) newValue;
+   #endif
+}
+
+void JUCE_CALLTYPE FloatVectorOperations::disableDenormalisedNumberSupport (const bool shouldDisable) noexcept
+{
+    const pointer_sized_int bits = DenormalHelpers::getDenormalBits();
+
+    if (bits != 0)
+    {
+        const pointer_sized_int state = getFpStatusRegister();
+        setFpStatusRegister (shouldDisable ? (state | bits) : (state & ~bits));
+    }
+}
+
+bool JUCE_CALLTYPE FloatVectorOperations::areDenormalsDisabled() noexcept
+{
+    const pointer_sized_int bits = DenormalHelpers::getDenormalBits();
+    return bits != 0 && (getFpStatusRegister() & bits) == bits;
+}
+
+//==============================================================================
+ScopedNoDenormals::ScopedNoDenormals (const bool shouldDisable) noexcept
+    : isActive (shouldDisable),
+      previousState (shouldDisable ? FloatVectorOperations::getFpStatusRegister() : 0)
+{
+    if (isActive)
+        FloatVectorOperations::disableDenormalisedNumberSupport (true);
+}
+
+ScopedNoDenormals::~ScopedNoDenormals() noexcept
+{
+    if (isActive)
+        FloatVectorOperations::setFpStatusRegister (previousState);
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class FloatVectorOperationsTests  : public UnitTest
+{
+public:
+    FloatVectorOperationsTests() : UnitTest ("FloatVectorOperations") {}
+
+    void runTest()
+    {
+        beginTest ("FloatVectorOperations");
+
+        for (int i = 100; --i >= 0;)
+        {
+            const int num = random.nextInt (500) + 1;
+
+            // use odd offsets into the buffers so that the unaligned code-paths get tested too..
+            HeapBlock<float> buffer1 (num + 16), buffer2 (num + 16), buffer3 (num + 16), interleaved (2 * num + 16);
+            float* const data1 = buffer1 + random.nextInt (4);
+            float* const data2 = buffer2 + random.nextInt (4);
+            float* const data3 = buffer3 + random.nextInt (4);
+
+            fillRandomly (data1, num);
+            fillRandomly (data2, num);
+
+            FloatVectorOperations::negate (data3, data1, num);
+            expect (checkEach (data3, data1, num, Negate()));
+
+            FloatVectorOperations::abs (data3, data1, num);
+            expect (checkEach (data3, data1, num, Abs()));
+
+            FloatVectorOperations::clip (data3, data1, -0.5f, 0.25f, num);
+            expect (checkEach (data3, data1, num, Clip()));
+
+            FloatVectorOperations::min (data3, data1, data2, num);
+            expect (checkEachPair (data3, data1, data2, num, Min()));
+
+            FloatVectorOperations::max (data3, data1, data2, num);
+            expect (checkEachPair (data3, data1, data2, num, Max()));
+
+            FloatVectorOperations::clear (data3, num);
+            FloatVectorOperations::addWithMultiply (data3, data1, data2, num);
+            expect (checkEachPair (data3, data1, data2, num, Multiply()));
+
+            FloatVectorOperations::copy (data3, data2, num);
+            FloatVectorOperations::addWithRamp (data3, data1, 0.25f, -0.5f, num);
+
+            bool rampOk = true;
+
+            for (int j = 0; j < num; ++j)
+                rampOk = rampOk && std::abs (data3[j] - (data2[j] + data1[j] * (0.25f - 0.75f * j / num))) < 1.0e-5f;
+
+            expect (rampOk);
+
+            FloatVectorOperations::copy (data3, data2, num);
+            FloatVectorOperations::multiplyWithRamp (data3, 2.0f, -1.0f, num);
+            expect (checkRamp (data3, data2, num, 2.0f, -1.0f, false));
+
+            FloatVectorOperations::copyWithRamp (data3, data1, -0.5f, 0.5f, num);
+            expect (checkRamp (data3, data1, num, -0.5f, 0.5f, false));
+
+            FloatVectorOperations::copy (data3, data2, num);
+            FloatVectorOperations::multiplyWithExponentialRamp (data3, 0.001f, 1.0f, num);
+            expect (checkRamp (data3, data2, num, 0.001f, 1.0f, true));
+
+            FloatVectorOperations::clear (data3, num);
+            expect (FloatVectorOperations::isSilent (data3, num));
+            data3 [random.nextInt (num)] = -1.0e-20f;
+            expect (! FloatVectorOperations::isSilent (data3, num));
+
+            FloatVectorOperations::clear (data3, num);
+            FloatVectorOperations::addWithExponentialRamp (data3, data1, 2.0f, 0.5f, num);
+            expect (checkRamp (data3, data1, num, 2.0f, 0.5f, true));
+
+            double dot = 0, squares = 0;
+
+            for (int j = 0; j < num; ++j)
+            {
+                dot += data1[j] * data2[j];
+                squares += data1[j] * data1[j];
+            }
+
+            expect (std::abs (FloatVectorOperations::dotProduct (data1, data2, num) - dot) < 1.0e-6 * num);
+            expect (std::abs (FloatVectorOperations::sumOfSquares (data1, num) - squares) < 1.0e-6 * num);
+
+            const float* sources[] = { data1, data2 };
+            FloatVectorOperations::interleave (interleaved, sources, 2, num);
+
+            bool interleavedOk = true;
+
+            for (int j = 0; j < num; ++j)
+                interleavedOk = interleavedOk && interleaved[2 * j] == data1[j] && interleaved[2 * j + 1] == data2[j];
+
+            expect (interleavedOk);
+
+            HeapBlock<float> left (num), right (num);
+            float* dests[] = { left, right };
+            FloatVectorOperations::deinterleave (dests, interleaved, 2, num);
+
+            expect (memcmp (left,  data1, sizeof (float) * (size_t) num) == 0);
+            expect (memcmp (right, data2, sizeof (float) * (size_t) num) == 0);
+
+            HeapBlock<int16> ints (num + 16);
+            int16* const intData = ints + random.nextInt (4);
+            FloatVectorOperations::convertFloatToInt16 (intData, data1, 40000.0f, num);
+
+            bool intsOk = true;
+
+            for (int j = 0; j < num; ++j)
+                intsOk = intsOk && std::abs (intData[j] - jlimit (-32768.0f, 32767.0f, data1[j] * 40000.0f)) <= 0.5f;
+
+            expect (intsOk);
+
+            FloatVectorOperations::convertInt16ToFloat (data3, intData, 1.0f / 32768.0f, num);
+
+            bool floatsOk = true;
+
+            for (int j = 0; j < num; ++j)
+                floatsOk = floatsOk && data3[j] == intData[j] / 32768.0f;
+
+            expect (floatsOk);
+        }
+
+        beginTest ("Denormals");
+
+        const bool wereDisabled = FloatVectorOperations::areDenormalsDisabled();
+
+        {
+            const ScopedNoDenormals noDenormals;
+
+           #if JUCE_USE_SSE_INTRINSICS || JUCE_USE_ARM_FPCR
+            expect (FloatVectorOperations::areDenormalsDisabled());
+           #endif
+
+           #if JUCE_64BIT && (JUCE_USE_SSE_INTRINSICS || JUCE_USE_ARM_FPCR)
+            // (volatile, to stop the compiler working this out itself)
+            volatile float small = 1.0e-30f;
+            small = small * 1.0e-10f;
+            expect (small == 0);
+           #endif
+        }
+
+        expect (FloatVectorOperations::areDenormalsDisabled() == wereDisabled);
+    }
+
+private:
+    Random random;
+
+    struct Negate   { float operator() (float a) const noexcept            { return -a; } };
+    struct Abs      { float operator() (float a) const noexcept            { return std::abs (a); } };
+    struct Clip     { float operator() (float a) const noexcept            { return jlimit (-0.5f, 0.25f, a); } };
+    struct Min      { float operator() (float a, float b) const noexcept   { return jmin (a, b); } };
+    struct Max      { float operator() (float a, float b) const noexcept   { return jmax (a, b); } };
+    struct Multiply { float operator() (float a, float b) const noexcept   { return a * b; } };
+
+    void fillRandomly (float* d, int num)
+    {
+        while (--num >= 0)
+            *d++ = random.nextFloat() * 2.0f - 1.0f;
+    }
+
+    template <class Op>
+    static bool checkEach (const float* result, const float* src, int num, Op op)
+    {
+        for (int i = 0; i < num; ++i)
+            if (result[i] != op (src[i]))
+                return false;
+
+        return true;
+    }
+
+    template <class Op>
+    static bool checkEachPair (const float* result, const float* src1, const float* src2, int num, Op op)
+    {
+        for (int i = 0; i < num; ++i)
+            if (result[i] != op (src1[i], src2[i]))
+                return false;
+
+        return true;
+    }
+
+    static bool checkRamp (const float* result, const float* src, int num, float startGain, float endGain, bool isExponential)
+    {
+        for (int i = 0; i < num; ++i)
+        {
+            const double gain = isExponential ? startGain * std::pow ((double) endGain / startGain, i / (double) num)
+                                              : startGain + (endGain - startGain) * i / (double) num;
+
+            if (std::abs (result[i] - src[i] * gain) > 1.0e-5 + 1.0e-4 * std::abs (gain))
+                return false;
+        }
+
+        return true;
+    }
+};
+
+static FloatVectorOperationsTests vectorOpTests;
+
+#endif
+
+//==============================================================================
+#if JUCE_BENCHMARKS
+
+class FloatVectorOperationsBenchmarks  : public Benchmark
+{
+public:
+    FloatVectorOperationsBenchmarks() : Benchmark ("FloatVectorOperations") {}
+
+    enum { numValues = 4096, numRepeats = 64 };
+
+    void initialise()
+    {
+        Random r (1234);
+
+        for (int i = 0; i < numValues; ++i)
+        {
+            src1[i] = r.nextFloat() * 2.0f - 1.0f;
+            src2[i] = r.nextFloat() * 2.0f - 1.0f;
+        }
+    }
+
+    void runBenchmark()
+    {
+        beginMeasurement ("copy, 64 x 4096 floats");
+        while (keepRunning())
+            for (int i = numRepeats; --i >= 0;)
+                FloatVectorOperations::copy (dest, src1, numValues);
+
+        beginMeasurement ("addWithMultiply, 64 x 4096 floats");
+        while (keepRunning())
+            for (int i = numRepeats; --i >= 0;)
+                FloatVectorOperations::addWithMultiply (dest, src1, 0.5f, numValues);
+
+        beginMeasurement ("copyWithMultiply, 64 x 4096 floats");
+        while (keepRunning())
+            for (int i = numRepeats; --i >= 0;)
+                FloatVectorOperations::copyWithMultiply (dest, src1, 0.5f, numValues);
+
+        beginMeasurement ("copyWithRamp, 64 x 4096 floats");
+        while (keepRunning())
+            for (int i = numRepeats; --i >= 0;)
+                FloatVectorOperations::copyWithRamp (dest, src1, 0.0f, 1.0f, numValues);
+
+        beginMeasurement ("findMinAndMax, 64 x 4096 floats");
+        while (keepRunning())
+        {
+            float mn = 0, mx = 0;
+
+            for (int i = numRepeats; --i >= 0;)
+                FloatVectorOperations::findMinAndMax (src1, numValues, mn, mx);
+
+            preventOptimisation (mx);
+        }
+
+        beginMeasurement ("dotProduct, 64 x 4096 floats");
+        while (keepRunning())
+        {
+            double total = 0;
+
+            for (int i = numRepeats; --i >= 0;)
+                total += FloatVectorOperations::dotProduct (src1, src2, numValues);
+
+            preventOptimisation (total);
+        }
+
+        preventOptimisation (dest[0]);
+    }
+
+private:
+    float src1 [numValues], src2 [numValues], dest [numValues];
+};
+
+static FloatVectorOperationsBenchmarks vectorOpBenchmarks;
+
+#endif
@@ -56,15 +56,90 @@ public:
     /** Multiplies each source value by the given multiplier, then adds it to the destination value. */
     static void JUCE_CALLTYPE addWithMultiply (float* dest, const float* src, float multiplier, int numValues) noexcept;
 
+    /** Multiplies each value in src1 by the corresponding value in src2, and adds the result to the destination value. */
+    static void JUCE_CALLTYPE addWithMultiply (float* dest, const float* src1, const float* src2, int numValues) noexcept;
+
+    /** Multiplies each source value by a gain which moves linearly between two values, and adds it to the destination value.
+        The first value is multiplied by startGain, and the gain then changes by (endGain - startGain) / numValues for each
+        value after that, in the same way as AudioSampleBuffer::addFromWithRamp().
+    */
+    static void JUCE_CALLTYPE addWithRamp (float* dest, const float* src, float startGain, float endGain, int numValues) noexcept;
+
+    /** Multiplies each source value by a gain which moves exponentially between two values, and adds it to the destination value.
+        The first value is multiplied by startGain, and the gain is then multiplied by (endGain / startGain) ^ (1 / numValues)
+        for each value after that. Both gains must be non-zero and have the same sign.
+    */
+    static void JUCE_CALLTYPE addWithExponentialRamp (float* dest, const float* src, float startGain, float endGain, int numValues) noexcept;
+
+    /** Copies each source value to the destination, multiplied by a gain which moves linearly between two values.
+        The gain changes in the same way as for addWithRamp().
+    */
+    static void JUCE_CALLTYPE copyWithRamp (float* dest, const float* src, float startGain, float endGain, int numValues) noexcept;
+
     /** Multiplies the destination values by the source values. */
     static void JUCE_CALLTYPE multiply (float* dest, const float* src, int numValues) noexcept;
 
     /** Multiplies each of the destination values by a fixed multiplier. */
     static void JUCE_CALLTYPE multiply (float* dest, float multiplier, int numValues) noexcept;
 
+    /** Multiplies each of the destination values by a gain which moves linearly between two values.
+        The gain changes in the same way as for addWithRamp().
+    */
+    static void JUCE_CALLTYPE multiplyWithRamp (float* dest, float startGain, float endGain, int numValues) noexcept;
+
+    /** Multiplies each of the destination values by a gain which moves exponentially between two values.
+        The gain changes in the same way as for addWithExponentialRamp().
+    */
+    static void JUCE_CALLTYPE multiplyWithExponentialRamp (float* dest, float startGain, float endGain, int numValues) noexcept;
+
+    /** Copies a source vector to a destination, negating each value. */
+    static void JUCE_CALLTYPE negate (float* dest, const float* src, int numValues) noexcept;
+
+    /** Copies a source vector to a destination, taking the absolute value of each element. */
+    static void JUCE_CALLTYPE abs (float* dest, const float* src, int numValues) noexcept;
+
+    /** Copies a source vector to a destination, limiting each value to the range low to high. */
+    static void JUCE_CALLTYPE clip (float* dest, const float* src, float low, float high, int numValues) noexcept;
+
+    /** Writes the smaller of each pair of corresponding values in src1 and src2 to the destination. */
+    static void JUCE_CALLTYPE min (float* dest, const float* src1, const float* src2, int numValues) noexcept;
+
+    /** Writes the larger of each pair of corresponding values in src1 and src2 to the destination. */
+    static void JUCE_CALLTYPE max (float* dest, const float* src1, const float* src2, int numValues) noexcept;
+
     /** Converts a stream of integers to floats, multiplying each one by the given multiplier. */
     static void JUCE_CALLTYPE convertFixedToFloat (float* dest, const int* src, float multiplier, int numValues) noexcept;
 
+    /** Converts a stream of floats to 16-bit integers, multiplying each one by the given multiplier.
+        The results are rounded to the nearest integer, and clipped to the range of an int16.
+    */
+    static void JUCE_CALLTYPE convertFloatToInt16 (int16* dest, const float* src, float multiplier, int numValues) noexcept;
+
+    /** Converts a stream of 16-bit integers to floats, multiplying each one by the given multiplier. */
+    static void JUCE_CALLTYPE convertInt16ToFloat (float* dest, const int16* src, float multiplier, int numValues) noexcept;
+
+    /** Returns the sum of the products of each pair of corresponding values in two vectors.
+        The products are accumulated with double precision.
+    */
+    static double JUCE_CALLTYPE dotProduct (const float* src1, const float* src2, int numValues) noexcept;
+
+    /** Returns the sum of the squares of the values in a vector.
+        This is handy for calculating RMS levels. The squares are accumulated with double precision.
+    */
+    static double JUCE_CALLTYPE sumOfSquares (const float* src, int numValues) noexcept;
+
+    /** Interleaves a set of separate channels into a single block of samples.
+        The destination must have space for (numChannels * numSamplesPerChannel) values.
+    */
+    static void JUCE_CALLTYPE interleave (float* dest, const float* const* sourceChannels,
+                                          int numChannels, int numSamplesPerChannel) noexcept;
+
+    /** Splits a block of interleaved samples into a set of separate channels.
+        The source must contain (numChannels * numSamplesPerChannel) values.
+    */
+    static void JUCE_CALLTYPE deinterleave (float* const* destChannels, const float* source,
+                                            int numChannels, int numSamplesPerChannel) noexcept;
+
     /** Finds the miniumum and maximum values in the given array. */
     static void JUCE_CALLTYPE findMinAndMax (const float* src, int numValues, float& minResult, float& maxResult) noexcept;
 
@@ -73,6 +148,73 @@ public:
 
     /** Finds the maximum value in the given array. */
     static float JUCE_CALLTYPE findMaximum (const float* src, int numValues) noexcept;
+
+    /** Returns true if all the values in the array are zero.
+        This stops as soon as it finds a non-zero value, so is quick to reject most audio.
+    */
+    static bool JUCE_CALLTYPE isSilent (const float* src, int numValues) noexcept;
+
+    //==============================================================================
+    /** Makes the calling thread's floating point unit treat denormalised numbers as zero.
+
+        When a signal decays towards silence, recursive filters and feedback loops can
+        end up doing arithmetic on denormalised numbers, which many CPUs handle extremely
+        slowly. This turns on the flush-to-zero and denormals-are-zero modes of the SSE
+        unit on Intel chips, or the flush-to-zero bit of the FPCR on ARM, so that such
+        values are replaced by zero instead. On other platforms it does nothing.
+
+        The setting only affects the thread that calls it. Note that on 32-bit Intel
+        builds, any arithmetic that the compiler does with the old x87 instructions
+        won't be affected.
+
+        @see ScopedNoDenormals
+    */
+    static void JUCE_CALLTYPE disableDenormalisedNumberSupport (bool shouldDisable = true) noexcept;
+
+    /** Returns true if disableDenormalisedNumberSupport() is currently in effect for the calling thread. */
+    static bool JUCE_CALLTYPE areDenormalsDisabled() noexcept;
+
+    /** Returns the calling thread's floating point control register, so that it can be
+        restored with setFpStatusRegister(). On platforms where it isn't supported, this
+        returns 0.
+    */
+    static pointer_sized_int JUCE_CALLTYPE getFpStatusRegister() noexcept;
+
+    /** Restores a value that was returned by getFpStatusRegister(). */
+    static void JUCE_CALLTYPE setFpStatusRegister (pointer_sized_int newValue) noexcept;
+};
+
+//==============================================================================
+/**
+    Turns off denormalised number support for the calling thread while it's in scope,
+    and then puts back the previous floating point settings.
+
+    Create one of these at the top of an audio callback, e.g.
+    @code
+    void processBlock (AudioSampleBuffer& buffer, MidiBuffer& midi)
+    {
+        const ScopedNoDenormals noDenormals;
+        ...
+    @endcode
+
+    @see FloatVectorOperations::disableDenormalisedNumberSupport
+*/
+class JUCE_API  ScopedNoDenormals
+{
+public:
+    /** Disables denormals, unless shouldDisable is false, in which case this does nothing.
+        (The flag is handy for classes that make denormal protection optional).
+    */
+    explicit ScopedNoDenormals (bool shouldDisable = true) noexcept;
+
+    /** Restores the previous floating point settings. */
+    ~ScopedNoDenormals() noexcept;
+
+private:
+    const bool isActive;
+    const pointer_sized_int previousState;
+
+    JUCE_DECLARE_NON_COPYABLE (ScopedNoDenormals)
 };
 
 
@@ -0,0 +1,146 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+
+namespace SharedMemoryAudioHelpers
+{
+    // Each block is sent as one message: this header, followed by the channels, each of
+    // which is padded to a multiple of 16 bytes so that they're all aligned for SIMD.
+    struct BlockHeader
+    {
+        uint32 magic;
+        int32 numChannels, numSamples, reserved;
+    };
+
+    enum { blockMagic = 0x6a617564 };
+
+    static int getPaddedNumSamples (const int numSamples) noexcept
+    {
+        return (numSamples + 3) & ~3;
+    }
+
+    static size_t getBlockSize (const int numChannels, const int numSamples) noexcept
+    {
+        return sizeof (BlockHeader) + (size_t) numChannels * (size_t) getPaddedNumSamples (numSamples) * sizeof (float);
+    }
+}
+
+//==============================================================================
+SharedMemoryAudioChannel::SharedMemoryAudioChannel (SharedMemoryChannel& c)
+    : channel (c), receivedAudio (1, 0), isHoldingAudio (false)
+{
+    static_jassert (sizeof (SharedMemoryAudioHelpers::BlockHeader) == 16);
+    channelPointers.ensureStorageAllocated (32);
+}
+
+SharedMemoryAudioChannel::~SharedMemoryAudioChannel()
+{
+    releaseAudio();
+}
+
+int SharedMemoryAudioChannel::getMaximumBlockSize (const int numChannels) const noexcept
+{
+    jassert (numChannels > 0);
+
+    const int maxBytes = channel.getMaximumMessageSize() - (int) sizeof (SharedMemoryAudioHelpers::BlockHeader);
+    return jmax (0, (maxBytes / (int) sizeof (float) / numChannels) & ~3);
+}
+
+bool SharedMemoryAudioChannel::sendAudio (const AudioSampleBuffer& source, const int startSample,
+                                          const int numSamples, const int timeOutMilliseconds)
+{
+    using namespace SharedMemoryAudioHelpers;
+
+    const int numChannels = source.getNumChannels();
+    jassert (numChannels > 0 && startSample >= 0 && numSamples >= 0 && startSample + numSamples <= source.getNumSamples());
+
+    BlockHeader* const header = static_cast <BlockHeader*> (channel.startWritingMessage (getBlockSize (numChannels, numSamples),
+                                                                                          timeOutMilliseconds));
+    if (header == nullptr)
+        return false;
+
+    header->magic = (uint32) blockMagic;
+    header->numChannels = numChannels;
+    header->numSamples = numSamples;
+    header->reserved = 0;
+
+    float* dest = reinterpret_cast <float*> (header + 1);
+    const int stride = getPaddedNumSamples (numSamples);
+
+    for (int i = 0; i < numChannels; ++i)
+    {
+        FloatVectorOperations::copy (dest, source.getSampleData (i, startSample), numSamples);
+        dest += stride;
+    }
+
+    channel.finishWritingMessage();
+    return true;
+}
+
+const AudioSampleBuffer* SharedMemoryAudioChannel::receiveAudio (const int timeOutMilliseconds)
+{
+    using namespace SharedMemoryAudioHelpers;
+
+    releaseAudio();
+
+    size_t size;
+    BlockHeader* const header = static_cast <BlockHeader*> (channel.startReadingMessage (size, timeOutMilliseconds));
+
+    if (header == nullptr)
+        return nullptr;
+
+    isHoldingAudio = true;
+
+    if (size < sizeof (BlockHeader)
+         || header->magic != (uint32) blockMagic
+         || header->numChannels <= 0 || header->numSamples < 0
+         || size < getBlockSize (header->numChannels, header->numSamples))
+    {
+        jassertfalse; // the other end didn't send this with sendAudio()!
+        releaseAudio();
+        return nullptr;
+    }
+
+    channelPointers.clearQuick();
+    float* data = reinterpret_cast <float*> (header + 1);
+    const int stride = getPaddedNumSamples (header->numSamples);
+
+    for (int i = 0; i < header->numChannels; ++i)
+    {
+        channelPointers.add (data);
+        data += stride;
+    }
+
+    receivedAudio.setDataToReferTo (channelPointers.getRawDataPointer(), header->numChannels, header->numSamples);
+    return &receivedAudio;
+}
+
+void SharedMemoryAudioChannel::releaseAudio()
+{
+    if (isHoldingAudio)
+    {
+        isHoldingAudio = false;
+        channel.finishReadingMessage();
+    }
+}
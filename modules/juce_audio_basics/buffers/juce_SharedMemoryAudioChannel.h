@@ -0,0 +1,118 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+
+#ifndef __JUCE_SHAREDMEMORYAUDIOCHANNEL_JUCEHEADER__
+#define __JUCE_SHAREDMEMORYAUDIOCHANNEL_JUCEHEADER__
+
+#include "juce_AudioSampleBuffer.h"
+
+
+//==============================================================================
+/**
+    Sends and receives blocks of audio through a SharedMemoryChannel, so that an audio
+    callback can exchange audio with another process.
+
+    The samples are written straight into the channel's ring buffer by sendAudio(), and
+    receiveAudio() returns an AudioSampleBuffer that refers directly to them in the ring,
+    so the only copy that's made is the one into the shared memory. No memory is allocated
+    by either call (unless a block has more than 32 channels), so they're safe to use on
+    an audio thread, as long as a sensible timeout is used.
+
+    A typical use would be for a host to send each block to a plugin running in a child
+    process and wait for the processed block to come back:
+    @code
+    if (audioChannel.sendAudio (buffer, 0, numSamples, 100))
+    {
+        if (const AudioSampleBuffer* processed = audioChannel.receiveAudio (100))
+            for (int i = jmin (buffer.getNumChannels(), processed->getNumChannels()); --i >= 0;)
+                buffer.copyFrom (i, 0, *processed, i, 0, jmin (numSamples, processed->getNumSamples()));
+
+        audioChannel.releaseAudio();
+    }
+    @endcode
+
+    Other kinds of message can be sent through the same channel, but the receiving end
+    must know which kind to expect next.
+
+    @see SharedMemoryChannel
+*/
+class JUCE_API  SharedMemoryAudioChannel
+{
+public:
+    //==============================================================================
+    /** Creates an object to send audio through the given channel.
+        The channel must remain valid for the lifetime of this object, but needn't be open yet.
+    */
+    explicit SharedMemoryAudioChannel (SharedMemoryChannel& channel);
+
+    /** Destructor. */
+    ~SharedMemoryAudioChannel();
+
+    //==============================================================================
+    /** Sends a section of a buffer to the other end.
+
+        This waits for up to timeOutMilliseconds for there to be space in the ring (or forever
+        if it's less than zero), and returns false if it times out, if the block's too big for
+        the channel, or if the channel has been closed.
+    */
+    bool sendAudio (const AudioSampleBuffer& source, int startSample, int numSamples,
+                    int timeOutMilliseconds);
+
+    /** Returns the largest number of samples that can be sent in one block with the given
+        number of channels.
+    */
+    int getMaximumBlockSize (int numChannels) const noexcept;
+
+    //==============================================================================
+    /** Waits for the next block of audio from the other end.
+
+        The buffer that is returned refers directly to the samples in the shared ring buffer,
+        and you can process them in-place. It's valid until you call releaseAudio() or
+        receiveAudio() again - but until you do, the space can't be re-used by the sender, so
+        don't hang on to it for longer than you need to.
+
+        Returns nullptr if it times out, if the channel is closed, or if the next message
+        wasn't sent by sendAudio().
+    */
+    const AudioSampleBuffer* receiveAudio (int timeOutMilliseconds);
+
+    /** Releases the block that was returned by receiveAudio(), so that its space in the ring can be re-used. */
+    void releaseAudio();
+
+    /** Returns the channel that this object is using. */
+    SharedMemoryChannel& getChannel() const noexcept        { return channel; }
+
+private:
+    //==============================================================================
+    SharedMemoryChannel& channel;
+    AudioSampleBuffer receivedAudio;
+    Array<float*> channelPointers;
+    bool isHoldingAudio;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SharedMemoryAudioChannel)
+};
+
+
+#endif   // __JUCE_SHAREDMEMORYAUDIOCHANNEL_JUCEHEADER__
@@ -0,0 +1,336 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+struct ConvolutionReverb::ConvolverSet
+{
+    OwnedArray<ZeroLatencyConvolver> convolvers;
+    double lengthSeconds;
+};
+
+//==============================================================================
+class ConvolutionReverb::Loader  : public Thread
+{
+public:
+    Loader (ConvolutionReverb& owner_)
+        : Thread ("Convolution loader"),
+          owner (owner_),
+          numSourceChannels (0),
+          sourceSampleRate (0),
+          needsRebuild (false),
+          building (false)
+    {
+        startThread (3);
+    }
+
+    ~Loader()
+    {
+        stopThread (10000);
+    }
+
+    void setSource (PositionableAudioSource* newSource, const int numChannels, const double sampleRate)
+    {
+        {
+            const ScopedLock sl (owner.pendingLock);
+            source = newSource;
+            numSourceChannels = numChannels;
+            sourceSampleRate = sampleRate;
+            needsRebuild = true;
+        }
+
+        notify();
+    }
+
+    void triggerRebuild()
+    {
+        needsRebuild = true;
+        notify();
+    }
+
+    bool isBusy() const noexcept        { return needsRebuild || building; }
+
+    void run()
+    {
+        while (! threadShouldExit())
+        {
+            if (! needsRebuild)
+            {
+                wait (-1);
+                continue;
+            }
+
+            building = true;
+            needsRebuild = false;
+            readPendingSource();
+            owner.setActiveSet (createConvolvers());
+            building = false;
+        }
+    }
+
+private:
+    ConvolutionReverb& owner;
+    ScopedPointer<PositionableAudioSource> source;
+    int numSourceChannels;
+    double sourceSampleRate;
+    volatile bool needsRebuild, building;
+
+    void readPendingSource()
+    {
+        ScopedPointer<PositionableAudioSource> src;
+        int numChannels;
+        double rate;
+
+        {
+            const ScopedLock sl (owner.pendingLock);
+            src = source.release();
+            numChannels = numSourceChannels;
+            rate = sourceSampleRate;
+        }
+
+        if (src == nullptr || numChannels <= 0)
+            return;
+
+        const int length = (int) jmin ((int64) std::numeric_limits<int>::max(), src->getTotalLength());
+        ScopedPointer<AudioSampleBuffer> buffer (new AudioSampleBuffer (numChannels, jmax (1, length)));
+        buffer->clear();
+
+        const int blockSize = 8192;
+        src->prepareToPlay (blockSize, rate);
+        src->setNextReadPosition (0);
+
+        for (int pos = 0; pos < length && ! threadShouldExit(); pos += blockSize)
+        {
+            const AudioSourceChannelInfo info (buffer, pos, jmin (blockSize, length - pos));
+            src->getNextAudioBlock (info);
+        }
+
+        src->releaseResources();
+
+        const ScopedLock sl (owner.pendingLock);
+        owner.impulseResponse = buffer.release();
+        owner.impulseSampleRate = rate;
+    }
+
+    ConvolverSet* createConvolvers()
+    {
+        ScopedPointer<AudioSampleBuffer> ir;
+        double rate, targetRate;
+        int numChannels;
+
+        {
+            const ScopedLock sl (owner.pendingLock);
+
+            if (owner.impulseResponse == nullptr)
+                return nullptr;
+
+            ir = new AudioSampleBuffer (*owner.impulseResponse);
+            rate = owner.impulseSampleRate;
+            targetRate = owner.sampleRate;
+            numChannels = owner.numChannels;
+        }
+
+        if (targetRate > 0 && rate > 0 && targetRate != rate)
+            ir = resample (*ir, rate, targetRate);
+
+        ScopedPointer<ConvolverSet> set (new ConvolverSet());
+        set->lengthSeconds = targetRate > 0 ? ir->getNumSamples() / targetRate : 0.0;
+
+        for (int i = 0; i < numChannels && ! threadShouldExit(); ++i)
+        {
+            ZeroLatencyConvolver* const c = new ZeroLatencyConvolver (owner.headSize, owner.tailBlockSize);
+            set->convolvers.add (c);
+            c->setImpulseResponse (ir->getSampleData (i % ir->getNumChannels()), ir->getNumSamples());
+        }
+
+        return set.release();
+    }
+
+    static AudioSampleBuffer* resample (const AudioSampleBuffer& ir, const double sourceRate, const double destRate)
+    {
+        const int numChannels = ir.getNumChannels();
+        const int numOut = (int) std::ceil (ir.getNumSamples() * destRate / sourceRate);
+
+        PolyphaseResampler resampler (numChannels, PolyphaseResampler::highQuality);
+        resampler.setSampleRates (sourceRate, destRate);
+
+        // (pad the end with silence, to flush out the filter)
+        const int numIn = jmax (ir.getNumSamples(), resampler.getNumInputSamplesRequired (numOut));
+        AudioSampleBuffer input (numChannels, numIn);
+        input.clear();
+
+        for (int i = 0; i < numChannels; ++i)
+            input.copyFrom (i, 0, ir, i, 0, ir.getNumSamples());
+
+        AudioSampleBuffer* const output = new AudioSampleBuffer (numChannels, numOut);
+        resampler.process (input.getArrayOfChannels(), output->getArrayOfChannels(), numChannels, numOut);
+
+        // Keep the overall gain the same, as there are now more or fewer samples in the response.
+        output->applyGain (0, numOut, (float) (sourceRate / destRate));
+        return output;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (Loader)
+};
+
+//==============================================================================
+ConvolutionReverb::ConvolutionReverb (const int headSize_, const int tailBlockSize_)
+    : headSize (headSize_),
+      tailBlockSize (tailBlockSize_),
+      sampleRate (0),
+      numChannels (2),
+      wetLevel (0.33f),
+      dryLevel (0.4f),
+      wetGain (0.33f),
+      dryGain (0.4f),
+      wetBuffer ((size_t) headSize_),
+      impulseSampleRate (0)
+{
+    loader = new Loader (*this);
+}
+
+ConvolutionReverb::~ConvolutionReverb()
+{
+    loader = nullptr;
+}
+
+//==============================================================================
+void ConvolutionReverb::prepareToPlay (const double newSampleRate, const int newNumChannels)
+{
+    {
+        const ScopedLock sl (pendingLock);
+        sampleRate = newSampleRate;
+        numChannels = newNumChannels;
+    }
+
+    wetGain.reset (newSampleRate, 0.05);
+    dryGain.reset (newSampleRate, 0.05);
+    wetGain.setCurrentAndTargetValue (wetLevel);
+    dryGain.setCurrentAndTargetValue (dryLevel);
+
+    loader->triggerRebuild();
+}
+
+void ConvolutionReverb::setImpulseResponse (const AudioSampleBuffer& newImpulse, const double newSampleRate)
+{
+    {
+        const ScopedLock sl (pendingLock);
+        impulseResponse = new AudioSampleBuffer (newImpulse);
+        impulseSampleRate = newSampleRate;
+    }
+
+    loader->triggerRebuild();
+}
+
+void ConvolutionReverb::loadImpulseResponse (PositionableAudioSource* const source, const int numSourceChannels,
+                                             const double sourceSampleRate)
+{
+    jassert (source != nullptr);
+    loader->setSource (source, numSourceChannels, sourceSampleRate);
+}
+
+void ConvolutionReverb::clearImpulseResponse()
+{
+    {
+        const ScopedLock sl (pendingLock);
+        impulseResponse = nullptr;
+    }
+
+    loader->triggerRebuild();
+}
+
+bool ConvolutionReverb::isLoading() const noexcept
+{
+    return loader->isBusy();
+}
+
+double ConvolutionReverb::getImpulseResponseLengthSeconds() const noexcept
+{
+    const SpinLock::ScopedLockType sl (activeLock);
+    return active != nullptr ? active->lengthSeconds : 0.0;
+}
+
+void ConvolutionReverb::setActiveSet (ConvolverSet* newSet)
+{
+    ScopedPointer<ConvolverSet> oldSet;
+
+    {
+        const SpinLock::ScopedLockType sl (activeLock);
+        oldSet = active.release();
+        active = newSet;
+    }
+}
+
+void ConvolutionReverb::setLevels (const float newWetLevel, const float newDryLevel) noexcept
+{
+    wetLevel = newWetLevel;
+    dryLevel = newDryLevel;
+}
+
+//==============================================================================
+void ConvolutionReverb::reset()
+{
+    const SpinLock::ScopedLockType sl (activeLock);
+
+    if (active != nullptr)
+        for (int i = 0; i < active->convolvers.size(); ++i)
+            active->convolvers.getUnchecked(i)->reset();
+}
+
+void ConvolutionReverb::processSamples (AudioSampleBuffer& buffer, const int startSample, int numSamples) noexcept
+{
+    jassert (startSample >= 0 && startSample + numSamples <= buffer.getNumSamples());
+
+    wetGain.setValue (wetLevel);
+    dryGain.setValue (dryLevel);
+
+    // If a new set of convolvers is being swapped in, this block just gets the dry signal.
+    const bool gotLock = activeLock.tryEnter();
+    const ConvolverSet* const set = gotLock ? active.get() : nullptr;
+    const int numConvolved = set != nullptr ? jmin (set->convolvers.size(), buffer.getNumChannels()) : 0;
+
+    for (int pos = startSample; numSamples > 0;)
+    {
+        const int num = jmin (numSamples, headSize);
+        const float wetStart = wetGain.getCurrentValue(), wetEnd = wetGain.skip (num);
+        const float dryStart = dryGain.getCurrentValue(), dryEnd = dryGain.skip (num);
+
+        for (int chan = 0; chan < buffer.getNumChannels(); ++chan)
+        {
+            float* const data = buffer.getSampleData (chan, pos);
+
+            if (chan < numConvolved)
+                set->convolvers.getUnchecked (chan)->process (data, wetBuffer, num);
+
+            FloatVectorOperations::multiplyWithRamp (data, dryStart, dryEnd, num);
+
+            if (chan < numConvolved)
+                FloatVectorOperations::addWithRamp (data, wetBuffer, wetStart, wetEnd, num);
+        }
+
+        pos += num;
+        numSamples -= num;
+    }
+
+    if (gotLock)
+        activeLock.exit();
+}
@@ -0,0 +1,143 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_CONVOLUTIONREVERB_JUCEHEADER__
+#define __JUCE_CONVOLUTIONREVERB_JUCEHEADER__
+
+#include "juce_ZeroLatencyConvolver.h"
+#include "juce_LinearSmoothedValue.h"
+#include "../sources/juce_PositionableAudioSource.h"
+
+
+//==============================================================================
+/**
+    Applies a convolution reverb to a set of audio channels, using an impulse response.
+
+    Each channel is processed by a ZeroLatencyConvolver, so there's no added latency,
+    and long impulse responses can be used in real time. If the impulse response has
+    fewer channels than the audio, its channels are re-used in turn, so a mono response
+    is applied to all channels, and a stereo one to alternate channels.
+
+    Loading is done by a background thread: when you give it an impulse response, it's
+    read, resampled to the playback rate if necessary, and the new convolvers are built
+    without holding up the audio thread, which carries on using the old response until
+    the new one is ready. To load one from a file, wrap the AudioFormatReader in an
+    AudioFormatReaderSource, e.g.
+
+    @code
+    if (AudioFormatReader* reader = formatManager.createReaderFor (file))
+        convolution.loadImpulseResponse (new AudioFormatReaderSource (reader, true),
+                                         (int) reader->numChannels, reader->sampleRate);
+    @endcode
+
+    @see ZeroLatencyConvolver, ConvolutionAudioSource, Reverb
+*/
+class JUCE_API  ConvolutionReverb
+{
+public:
+    //==============================================================================
+    /** Creates a ConvolutionReverb.
+        The sizes are passed on to the ZeroLatencyConvolver objects that it creates.
+    */
+    ConvolutionReverb (int headSize = 64, int tailBlockSize = 1024);
+
+    /** Destructor. */
+    ~ConvolutionReverb();
+
+    //==============================================================================
+    /** Sets the playback sample rate and the number of channels to process.
+
+        Call this before processing, and not from the audio thread. If an impulse response
+        is loaded, it gets rebuilt for the new settings in the background.
+    */
+    void prepareToPlay (double sampleRate, int numChannels);
+
+    /** Starts loading a new impulse response from a buffer.
+        The data is copied, so the buffer doesn't need to stay in scope.
+    */
+    void setImpulseResponse (const AudioSampleBuffer& impulseResponse, double impulseSampleRate);
+
+    /** Starts loading a new impulse response from a source.
+
+        The whole source gets read by the background thread, and then deleted.
+    */
+    void loadImpulseResponse (PositionableAudioSource* source, int numChannels, double sourceSampleRate);
+
+    /** Removes the current impulse response, so that only the dry signal is output. */
+    void clearImpulseResponse();
+
+    /** Returns true if the background thread is still loading an impulse response. */
+    bool isLoading() const noexcept;
+
+    /** Returns the length of the impulse response that's currently in use, in seconds. */
+    double getImpulseResponseLengthSeconds() const noexcept;
+
+    //==============================================================================
+    /** Sets the gains that are applied to the convolved and the unprocessed signals.
+        This can be called from any thread, and the levels glide to their new values
+        over about 50ms.
+    */
+    void setLevels (float wetLevel, float dryLevel) noexcept;
+
+    /** Returns the current wet level. */
+    float getWetLevel() const noexcept                      { return wetLevel; }
+
+    /** Returns the current dry level. */
+    float getDryLevel() const noexcept                      { return dryLevel; }
+
+    //==============================================================================
+    /** Clears the reverb's history. */
+    void reset();
+
+    /** Applies the reverb to a section of a buffer. */
+    void processSamples (AudioSampleBuffer& buffer, int startSample, int numSamples) noexcept;
+
+private:
+    //==============================================================================
+    class Loader;
+    friend class Loader;
+    struct ConvolverSet;
+
+    const int headSize, tailBlockSize;
+    double sampleRate;
+    int numChannels;
+    volatile float wetLevel, dryLevel;
+    LinearSmoothedValue wetGain, dryGain;
+    HeapBlock<float> wetBuffer;
+
+    CriticalSection pendingLock;
+    ScopedPointer<AudioSampleBuffer> impulseResponse;
+    double impulseSampleRate;
+
+    SpinLock activeLock;
+    ScopedPointer<ConvolverSet> active;
+    ScopedPointer<Loader> loader;
+
+    void setActiveSet (ConvolverSet*);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ConvolutionReverb)
+};
+
+
+#endif   // __JUCE_CONVOLUTIONREVERB_JUCEHEADER__
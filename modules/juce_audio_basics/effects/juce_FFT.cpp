@@ -0,0 +1,529 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+namespace FFTHelpers
+{
+   #if JUCE_USE_SSE_INTRINSICS
+    struct SIMDOps
+    {
+        typedef __m128 Lanes;
+
+        static forcedinline Lanes load (const float* v) noexcept            { return _mm_loadu_ps (v); }
+        static forcedinline void store (float* dest, Lanes a) noexcept      { _mm_storeu_ps (dest, a); }
+        static forcedinline Lanes add (Lanes a, Lanes b) noexcept           { return _mm_add_ps (a, b); }
+        static forcedinline Lanes sub (Lanes a, Lanes b) noexcept           { return _mm_sub_ps (a, b); }
+        static forcedinline Lanes mul (Lanes a, Lanes b) noexcept           { return _mm_mul_ps (a, b); }
+    };
+   #elif JUCE_USE_ARM_NEON
+    struct SIMDOps
+    {
+        typedef float32x4_t Lanes;
+
+        static forcedinline Lanes load (const float* v) noexcept            { return vld1q_f32 (v); }
+        static forcedinline void store (float* dest, Lanes a) noexcept      { vst1q_f32 (dest, a); }
+        static forcedinline Lanes add (Lanes a, Lanes b) noexcept           { return vaddq_f32 (a, b); }
+        static forcedinline Lanes sub (Lanes a, Lanes b) noexcept           { return vsubq_f32 (a, b); }
+        static forcedinline Lanes mul (Lanes a, Lanes b) noexcept           { return vmulq_f32 (a, b); }
+    };
+   #endif
+
+    /*  Performs one radix-2 stage on blocks of (2 * half) values, where the twiddle factors
+        for the stage are in wr and wi. The half-size must be a multiple of 4.
+    */
+    static void performButterflies (float* re, float* im, const int size, const int half,
+                                    const float* wr, const float* wi) noexcept
+    {
+        for (int j = 0; j < size; j += 2 * half)
+        {
+            float* const r0 = re + j;
+            float* const i0 = im + j;
+            float* const r1 = r0 + half;
+            float* const i1 = i0 + half;
+
+           #if JUCE_USE_SSE_INTRINSICS || JUCE_USE_ARM_NEON
+            typedef SIMDOps Ops;
+
+            for (int k = 0; k < half; k += 4)
+            {
+                const Ops::Lanes br = Ops::load (r1 + k), bi = Ops::load (i1 + k);
+                const Ops::Lanes twr = Ops::load (wr + k), twi = Ops::load (wi + k);
+                const Ops::Lanes tr = Ops::sub (Ops::mul (br, twr), Ops::mul (bi, twi));
+                const Ops::Lanes ti = Ops::add (Ops::mul (br, twi), Ops::mul (bi, twr));
+                const Ops::Lanes ar = Ops::load (r0 + k), ai = Ops::load (i0 + k);
+
+                Ops::store (r1 + k, Ops::sub (ar, tr));
+                Ops::store (i1 + k, Ops::sub (ai, ti));
+                Ops::store (r0 + k, Ops::add (ar, tr));
+                Ops::store (i0 + k, Ops::add (ai, ti));
+            }
+           #else
+            for (int k = 0; k < half; ++k)
+            {
+                const float tr = r1[k] * wr[k] - i1[k] * wi[k];
+                const float ti = r1[k] * wi[k] + i1[k] * wr[k];
+
+                r1[k] = r0[k] - tr;
+                i1[k] = i0[k] - ti;
+                r0[k] += tr;
+                i0[k] += ti;
+            }
+           #endif
+        }
+    }
+}
+
+//==============================================================================
+/*  Holds the tables for one size of complex transform. These are created on demand and
+    then kept for the lifetime of the app, so that all the FFT objects can share them.
+*/
+class FFT::Plan  : public ReferenceCountedObject
+{
+public:
+    Plan (const int order_)
+        : order (order_), size (1 << order_)
+    {
+        // The twiddle factors for the stage with blocks of (2 * half) values are stored
+        // at [half, 2 * half), so the last stage's ones are also the Nth roots of unity
+        // that a real transform of twice this size needs.
+        twiddleReal.malloc ((size_t) size);
+        twiddleImag.malloc ((size_t) size);
+        twiddleReal[0] = 1.0f;
+        twiddleImag[0] = 0.0f;
+
+        for (int half = 1; half < size; half <<= 1)
+        {
+            for (int k = 0; k < half; ++k)
+            {
+                const double angle = -double_Pi * k / half;
+                twiddleReal [half + k] = (float) std::cos (angle);
+                twiddleImag [half + k] = (float) std::sin (angle);
+            }
+        }
+
+       #if JUCE_USE_VDSP_FRAMEWORK
+        setup = order > 0 ? vDSP_create_fftsetup ((vDSP_Length) order, kFFTRadix2) : nullptr;
+       #else
+        bitReversed.malloc ((size_t) size);
+
+        for (int i = 0; i < size; ++i)
+        {
+            int reversed = 0;
+
+            for (int bit = 0; bit < order; ++bit)
+                if ((i & (1 << bit)) != 0)
+                    reversed |= 1 << (order - 1 - bit);
+
+            bitReversed[i] = reversed;
+        }
+       #endif
+    }
+
+    ~Plan()
+    {
+       #if JUCE_USE_VDSP_FRAMEWORK
+        if (setup != nullptr)
+            vDSP_destroy_fftsetup (setup);
+       #endif
+    }
+
+    static Plan* get (const int order)
+    {
+        jassert (order >= 0 && order <= FFT::maxOrder);
+
+        static CriticalSection lock;
+        static ReferenceCountedObjectPtr<Plan> plans [FFT::maxOrder + 1];
+
+        const ScopedLock sl (lock);
+
+        if (plans[order].get() == nullptr)
+            plans[order] = new Plan (order);
+
+        return plans[order];
+    }
+
+    /*  Copies values from a (possibly strided) source into the working arrays, in the
+        order that perform() needs them.
+    */
+    void load (const float* srcReal, const float* srcImag, const int stride,
+               float* re, float* im) const noexcept
+    {
+        for (int i = 0; i < size; ++i)
+        {
+           #if JUCE_USE_VDSP_FRAMEWORK
+            const int index = i * stride;
+           #else
+            const int index = bitReversed[i] * stride;
+           #endif
+
+            re[i] = srcReal[index];
+            im[i] = srcImag[index];
+        }
+    }
+
+    // Performs an in-place forward transform of some values that were set up by load().
+    void perform (float* re, float* im) const noexcept
+    {
+       #if JUCE_USE_VDSP_FRAMEWORK
+        if (setup != nullptr)
+        {
+            DSPSplitComplex split = { re, im };
+            vDSP_fft_zip (setup, &split, 1, (vDSP_Length) order, FFT_FORWARD);
+        }
+       #else
+        if (size >= 2)
+        {
+            for (int i = 0; i < size; i += 2)
+            {
+                const float r0 = re[i], i0 = im[i], r1 = re[i + 1], i1 = im[i + 1];
+                re[i] = r0 + r1;   im[i] = i0 + i1;
+                re[i + 1] = r0 - r1;   im[i + 1] = i0 - i1;
+            }
+        }
+
+        if (size >= 4)
+        {
+            // (the second stage's twiddle factors are just 1 and -i)
+            for (int i = 0; i < size; i += 4)
+            {
+                const float r0 = re[i],     i0 = im[i],     r1 = re[i + 1], i1 = im[i + 1];
+                const float r2 = re[i + 2], i2 = im[i + 2], r3 = re[i + 3], i3 = im[i + 3];
+
+                re[i] = r0 + r2;       im[i] = i0 + i2;
+                re[i + 2] = r0 - r2;   im[i + 2] = i0 - i2;
+                re[i + 1] = r1 + i3;   im[i + 1] = i1 - r3;
+                re[i + 3] = r1 - i3;   im[i + 3] = i1 + r3;
+            }
+        }
+
+        for (int half = 4; half < size; half <<= 1)
+            FFTHelpers::performButterflies (re, im, size, half, twiddleReal + half, twiddleImag + half);
+       #endif
+    }
+
+    const int order, size;
+    HeapBlock<float> twiddleReal, twiddleImag;
+
+private:
+   #if JUCE_USE_VDSP_FRAMEWORK
+    FFTSetup setup;
+   #else
+    HeapBlock<int> bitReversed;
+   #endif
+
+    JUCE_DECLARE_NON_COPYABLE (Plan)
+};
+
+//==============================================================================
+FFT::FFT (const int order_)
+    : order (order_), size (1 << order_)
+{
+    jassert (order_ > 0 && order_ <= maxOrder);
+
+    plan = Plan::get (order);
+    halfPlan = Plan::get (order - 1);
+
+    workReal.malloc ((size_t) size + 2);
+    workImag.malloc ((size_t) size + 2);
+}
+
+FFT::~FFT()
+{
+}
+
+//==============================================================================
+void FFT::performComplexTransform (const Complex* input, Complex* output, const bool inverse) noexcept
+{
+    // An inverse transform is the same as a forward one with the real and imaginary
+    // parts swapped over on the way in and out.
+    if (inverse)
+        plan->load (&(input->i), &(input->r), 2, workReal, workImag);
+    else
+        plan->load (&(input->r), &(input->i), 2, workReal, workImag);
+
+    plan->perform (workReal, workImag);
+
+    if (inverse)
+    {
+        const float scale = 1.0f / size;
+
+        for (int i = 0; i < size; ++i)
+        {
+            output[i].r = workImag[i] * scale;
+            output[i].i = workReal[i] * scale;
+        }
+    }
+    else
+    {
+        for (int i = 0; i < size; ++i)
+        {
+            output[i].r = workReal[i];
+            output[i].i = workImag[i];
+        }
+    }
+}
+
+/*  The real transforms pack the even and odd input values into the real and imaginary
+    parts of a complex transform of half the size, and then separate the two halves of
+    the result again.
+*/
+void FFT::realForward (const float* input, float* outReal, float* outImag, const int outStride) noexcept
+{
+    const int half = size / 2;
+    const float* const wr = plan->twiddleReal + half;
+    const float* const wi = plan->twiddleImag + half;
+
+    halfPlan->load (input, input + 1, 2, workReal, workImag);
+    halfPlan->perform (workReal, workImag);
+
+    const float r0 = workReal[0], i0 = workImag[0];
+    outReal[0] = r0 + i0;
+    outImag[0] = 0.0f;
+    outReal [half * outStride] = r0 - i0;
+    outImag [half * outStride] = 0.0f;
+
+    for (int k = 1; k < half; ++k)
+    {
+        const float a = workReal[k], b = workImag[k];
+        const float c = workReal[half - k], d = workImag[half - k];
+
+        const float evenReal = 0.5f * (a + c), evenImag = 0.5f * (b - d);
+        const float oddReal  = 0.5f * (b + d), oddImag  = 0.5f * (c - a);
+
+        outReal [k * outStride] = evenReal + wr[k] * oddReal - wi[k] * oddImag;
+        outImag [k * outStride] = evenImag + wr[k] * oddImag + wi[k] * oddReal;
+    }
+}
+
+void FFT::realInverse (const float* inReal, const float* inImag, const int inStride, float* output) noexcept
+{
+    const int half = size / 2;
+    const float* const wr = plan->twiddleReal + half;
+    const float* const wi = plan->twiddleImag + half;
+
+    for (int k = 0; k < half; ++k)
+    {
+        const float a = inReal [k * inStride],          b = inImag [k * inStride];
+        const float c = inReal [(half - k) * inStride], d = inImag [(half - k) * inStride];
+
+        const float evenReal = 0.5f * (a + c), evenImag = 0.5f * (b - d);
+        const float diffReal = 0.5f * (a - c), diffImag = 0.5f * (b + d);
+        const float oddReal  = diffReal * wr[k] + diffImag * wi[k];
+        const float oddImag  = diffImag * wr[k] - diffReal * wi[k];
+
+        workReal[k] = evenReal - oddImag;
+        workImag[k] = evenImag + oddReal;
+    }
+
+    // (the second half of the working space is free to hold the inverse transform)
+    float* const re = workReal + half;
+    float* const im = workImag + half;
+
+    halfPlan->load (workImag, workReal, 1, re, im);
+    halfPlan->perform (re, im);
+
+    const float scale = 1.0f / half;
+
+    for (int i = 0; i < half; ++i)
+    {
+        output [2 * i]     = im[i] * scale;
+        output [2 * i + 1] = re[i] * scale;
+    }
+}
+
+void FFT::performRealForwardTransform (const float* input, Complex* output) noexcept
+{
+    realForward (input, &(output->r), &(output->i), 2);
+}
+
+void FFT::performRealForwardTransform (const float* input, float* outputReal, float* outputImag) noexcept
+{
+    realForward (input, outputReal, outputImag, 1);
+}
+
+void FFT::performRealInverseTransform (const Complex* input, float* output) noexcept
+{
+    realInverse (&(input->r), &(input->i), 2, output);
+}
+
+void FFT::performRealInverseTransform (const float* inputReal, const float* inputImag, float* output) noexcept
+{
+    realInverse (inputReal, inputImag, 1, output);
+}
+
+void FFT::performFrequencyOnlyForwardTransform (const float* input, float* magnitudes) noexcept
+{
+    // (the imaginary parts go in the spare space at the end of the working array)
+    float* const imag = workImag + size / 2;
+    realForward (input, magnitudes, imag, 1);
+
+    for (int i = getNumBins(); --i >= 0;)
+        magnitudes[i] = std::sqrt (magnitudes[i] * magnitudes[i] + imag[i] * imag[i]);
+}
+
+//==============================================================================
+void FFT::fillWindowingTable (float* dest, const int windowSize, const WindowingMethod method) noexcept
+{
+    for (int i = 0; i < windowSize; ++i)
+    {
+        const double angle = 2.0 * double_Pi * i / windowSize;
+        double value = 1.0;
+
+        switch (method)
+        {
+            case hann:      value = 0.5 - 0.5 * std::cos (angle); break;
+            case hamming:   value = 0.54 - 0.46 * std::cos (angle); break;
+            case blackman:  value = 0.42 - 0.5 * std::cos (angle) + 0.08 * std::cos (2.0 * angle); break;
+            default:        break;
+        }
+
+        dest[i] = (float) value;
+    }
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class FFTTests  : public UnitTest
+{
+public:
+    FFTTests() : UnitTest ("FFT") {}
+
+    static void performDFT (const FFT::Complex* input, FFT::Complex* output, const int size, const bool inverse)
+    {
+        for (int k = 0; k < size; ++k)
+        {
+            double sumReal = 0, sumImag = 0;
+
+            for (int n = 0; n < size; ++n)
+            {
+                const double angle = (inverse ? 2.0 : -2.0) * double_Pi * (((int64) k * n) % size) / size;
+                sumReal += input[n].r * std::cos (angle) - input[n].i * std::sin (angle);
+                sumImag += input[n].r * std::sin (angle) + input[n].i * std::cos (angle);
+            }
+
+            const double scale = inverse ? 1.0 / size : 1.0;
+            output[k].r = (float) (sumReal * scale);
+            output[k].i = (float) (sumImag * scale);
+        }
+    }
+
+    float getMaxError (const FFT::Complex* a, const FFT::Complex* b, const int num)
+    {
+        float maxError = 0;
+
+        for (int i = 0; i < num; ++i)
+            maxError = jmax (maxError, std::abs (a[i].r - b[i].r), std::abs (a[i].i - b[i].i));
+
+        return maxError;
+    }
+
+    void runTest()
+    {
+        Random r (0x1234);
+
+        beginTest ("Complex transforms");
+
+        for (int order = 1; order <= 10; ++order)
+        {
+            FFT fft (order);
+            const int size = fft.getSize();
+            HeapBlock<FFT::Complex> input (size), output (size), expected (size);
+
+            for (int i = 0; i < size; ++i)
+            {
+                input[i].r = r.nextFloat() * 2.0f - 1.0f;
+                input[i].i = r.nextFloat() * 2.0f - 1.0f;
+            }
+
+            performDFT (input, expected, size, false);
+            fft.performComplexTransform (input, output, false);
+            expect (getMaxError (output, expected, size) < 1.0e-5f * size);
+
+            // check that it can be done in-place, and that the inverse gets back to the start
+            fft.performComplexTransform (output, output, true);
+            expect (getMaxError (output, input, size) < 1.0e-5f);
+        }
+
+        beginTest ("Real transforms");
+
+        for (int order = 1; order <= 10; ++order)
+        {
+            FFT fft (order);
+            const int size = fft.getSize();
+            const int numBins = fft.getNumBins();
+            HeapBlock<FFT::Complex> complexInput (size), output (numBins), expected (size);
+            HeapBlock<float> input (size), roundTrip (size), real (numBins), imag (numBins), magnitudes (numBins);
+
+            for (int i = 0; i < size; ++i)
+            {
+                input[i] = r.nextFloat() * 2.0f - 1.0f;
+                complexInput[i].r = input[i];
+                complexInput[i].i = 0;
+            }
+
+            performDFT (complexInput, expected, size, false);
+            fft.performRealForwardTransform (input, output);
+            expect (getMaxError (output, expected, numBins) < 1.0e-5f * size);
+
+            fft.performRealForwardTransform (input, real, imag);
+            fft.performFrequencyOnlyForwardTransform (input, magnitudes);
+
+            for (int i = 0; i < numBins; ++i)
+            {
+                expect (real[i] == output[i].r && imag[i] == output[i].i);
+                expect (std::abs (magnitudes[i] - std::sqrt (output[i].r * output[i].r + output[i].i * output[i].i)) < 1.0e-5f * size);
+            }
+
+            fft.performRealInverseTransform (output, roundTrip);
+
+            for (int i = 0; i < size; ++i)
+                expect (std::abs (roundTrip[i] - input[i]) < 1.0e-5f);
+
+            fft.performRealInverseTransform (real, imag, roundTrip);
+
+            for (int i = 0; i < size; ++i)
+                expect (std::abs (roundTrip[i] - input[i]) < 1.0e-5f);
+        }
+
+        beginTest ("Windows");
+
+        {
+            const int size = 1024;
+            HeapBlock<float> window (size);
+
+            // overlapping periodic hann windows by half their length should add up to 1
+            FFT::fillWindowingTable (window, size, FFT::hann);
+
+            for (int i = 0; i < size / 2; ++i)
+                expect (std::abs (window[i] + window[i + size / 2] - 1.0f) < 1.0e-6f);
+
+            FFT::fillWindowingTable (window, size, FFT::blackman);
+            expect (std::abs (window[0]) < 1.0e-6f && std::abs (window [size / 2] - 1.0f) < 1.0e-6f);
+        }
+    }
+};
+
+static FFTTests fftTests;
+
+#endif
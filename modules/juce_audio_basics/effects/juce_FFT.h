@@ -0,0 +1,150 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_FFT_JUCEHEADER__
+#define __JUCE_FFT_JUCEHEADER__
+
+
+//==============================================================================
+/**
+    Performs fast fourier transforms of complex or real data.
+
+    An FFT object is created for one size of transform (a power of two), and can then be
+    used to perform any number of forward or inverse transforms of that size.
+
+    The tables needed for each size (the "plan") are created the first time that size
+    is used, and then cached and shared between all the FFT objects of that size, so
+    creating more of them is cheap. The transforms themselves work on the real and
+    imaginary parts in separate arrays, so each stage of butterflies runs in SSE or
+    NEON registers where they're available. On OSX and iOS, the vDSP framework is used
+    to do the complex transform instead.
+
+    The forward transforms are unscaled, and the inverse ones are scaled by 1 / size, so
+    a forward transform followed by an inverse one gives back the original data.
+
+    An FFT object has some working space of its own, so a single object mustn't be used
+    by more than one thread at a time.
+*/
+class JUCE_API  FFT
+{
+public:
+    //==============================================================================
+    /** Creates an FFT for transforms of (2 ^ order) values.
+        The order must be between 1 and maxOrder.
+    */
+    explicit FFT (int order);
+
+    /** Destructor. */
+    ~FFT();
+
+    //==============================================================================
+    /** A complex number, as used by the transform methods. */
+    struct Complex
+    {
+        float r;  /**< The real part. */
+        float i;  /**< The imaginary part. */
+    };
+
+    /** The largest order of transform that can be created. */
+    enum { maxOrder = 24 };
+
+    /** Returns the order that was passed to the constructor. */
+    int getOrder() const noexcept                       { return order; }
+
+    /** Returns the number of values in the transform, i.e. (2 ^ order). */
+    int getSize() const noexcept                        { return size; }
+
+    /** Returns the number of frequency bins produced by a transform of real data,
+        which is getSize() / 2 + 1.
+    */
+    int getNumBins() const noexcept                     { return size / 2 + 1; }
+
+    //==============================================================================
+    /** Performs a complex transform of getSize() values.
+        The input and output may point to the same array.
+    */
+    void performComplexTransform (const Complex* input, Complex* output, bool inverse) noexcept;
+
+    /** Performs a transform of getSize() real values, producing getNumBins() complex ones.
+
+        The remaining bins aren't written, because for real input they're just the complex
+        conjugates of the ones below them.
+    */
+    void performRealForwardTransform (const float* input, Complex* output) noexcept;
+
+    /** Performs a forward transform of getSize() real values, writing the real and imaginary
+        parts of the getNumBins() results to separate arrays.
+    */
+    void performRealForwardTransform (const float* input, float* outputReal, float* outputImag) noexcept;
+
+    /** Turns getNumBins() complex values back into getSize() real ones.
+        This is the inverse of performRealForwardTransform().
+    */
+    void performRealInverseTransform (const Complex* input, float* output) noexcept;
+
+    /** Turns getNumBins() complex values, with their real and imaginary parts in separate
+        arrays, back into getSize() real ones.
+    */
+    void performRealInverseTransform (const float* inputReal, const float* inputImag, float* output) noexcept;
+
+    /** Performs a forward transform of getSize() real values, and writes the magnitudes
+        of the getNumBins() results to the destination array.
+        The input and output may point to the same array, as long as it has room for
+        getNumBins() values.
+    */
+    void performFrequencyOnlyForwardTransform (const float* input, float* magnitudes) noexcept;
+
+    //==============================================================================
+    /** The shapes of windowing function that fillWindowingTable() can create. */
+    enum WindowingMethod
+    {
+        rectangular = 0,
+        hann,
+        hamming,
+        blackman
+    };
+
+    /** Fills an array with a windowing function.
+
+        The windows are periodic rather than symmetric, which is what's needed when
+        successive windows are overlapped, e.g. for a short-time fourier transform.
+    */
+    static void fillWindowingTable (float* dest, int size, WindowingMethod method) noexcept;
+
+private:
+    //==============================================================================
+    class Plan;
+
+    const int order, size;
+    ReferenceCountedObjectPtr<Plan> plan, halfPlan;
+    HeapBlock<float> workReal, workImag;
+
+    void realForward (const float* input, float* outReal, float* outImag, int outStride) noexcept;
+    void realInverse (const float* inReal, const float* inImag, int inStride, float* output) noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FFT)
+};
+
+
+#endif   // __JUCE_FFT_JUCEHEADER__
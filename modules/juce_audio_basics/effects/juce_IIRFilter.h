@@ -91,6 +91,7 @@ public:
 
 private:
     friend class IIRFilter;
+    friend class IIRFilterCascade;
     IIRCoefficients (double, double, double, double, double, double) noexcept;
 
     float c[5];
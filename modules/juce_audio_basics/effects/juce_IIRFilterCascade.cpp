@@ -0,0 +1,468 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+
+namespace IIRFilterCascadeHelpers
+{
+   #if JUCE_USE_SSE_INTRINSICS
+    struct SIMDOps
+    {
+        typedef __m128 Lanes;
+
+        static forcedinline Lanes load1 (float v) noexcept                  { return _mm_load1_ps (&v); }
+        static forcedinline Lanes load (const float* v) noexcept            { return _mm_loadu_ps (v); }
+        static forcedinline void store (float* dest, Lanes a) noexcept      { _mm_storeu_ps (dest, a); }
+        static forcedinline Lanes add (Lanes a, Lanes b) noexcept           { return _mm_add_ps (a, b); }
+        static forcedinline Lanes sub (Lanes a, Lanes b) noexcept           { return _mm_sub_ps (a, b); }
+        static forcedinline Lanes mul (Lanes a, Lanes b) noexcept           { return _mm_mul_ps (a, b); }
+
+        static forcedinline void transpose (Lanes& a, Lanes& b, Lanes& c, Lanes& d) noexcept
+        {
+            _MM_TRANSPOSE4_PS (a, b, c, d);
+        }
+
+        static forcedinline Lanes snapToZero (Lanes a) noexcept
+        {
+            const Lanes magnitude = _mm_andnot_ps (load1 (-0.0f), a);
+            return _mm_and_ps (a, _mm_cmpge_ps (magnitude, load1 (1.0e-8f)));
+        }
+    };
+
+   #elif JUCE_USE_ARM_NEON
+    struct SIMDOps
+    {
+        typedef float32x4_t Lanes;
+
+        static forcedinline Lanes load1 (float v) noexcept                  { return vld1q_dup_f32 (&v); }
+        static forcedinline Lanes load (const float* v) noexcept            { return vld1q_f32 (v); }
+        static forcedinline void store (float* dest, Lanes a) noexcept      { vst1q_f32 (dest, a); }
+        static forcedinline Lanes add (Lanes a, Lanes b) noexcept           { return vaddq_f32 (a, b); }
+        static forcedinline Lanes sub (Lanes a, Lanes b) noexcept           { return vsubq_f32 (a, b); }
+        static forcedinline Lanes mul (Lanes a, Lanes b) noexcept           { return vmulq_f32 (a, b); }
+
+        static forcedinline void transpose (Lanes& a, Lanes& b, Lanes& c, Lanes& d) noexcept
+        {
+            const float32x4x2_t ab = vtrnq_f32 (a, b);
+            const float32x4x2_t cd = vtrnq_f32 (c, d);
+
+            a = vcombine_f32 (vget_low_f32  (ab.val[0]), vget_low_f32  (cd.val[0]));
+            b = vcombine_f32 (vget_low_f32  (ab.val[1]), vget_low_f32  (cd.val[1]));
+            c = vcombine_f32 (vget_high_f32 (ab.val[0]), vget_high_f32 (cd.val[0]));
+            d = vcombine_f32 (vget_high_f32 (ab.val[1]), vget_high_f32 (cd.val[1]));
+        }
+
+        static forcedinline Lanes snapToZero (Lanes a) noexcept
+        {
+            return vreinterpretq_f32_u32 (vandq_u32 (vreinterpretq_u32_f32 (a),
+                                                     vcgeq_f32 (vabsq_f32 (a), load1 (1.0e-8f))));
+        }
+    };
+   #endif
+
+    //==============================================================================
+    // This does the same job as the SIMD versions, one lane at a time.
+    struct ScalarOps
+    {
+        struct Lanes  { float v[4]; };
+
+        static forcedinline Lanes load1 (float v) noexcept                  { Lanes r; for (int i = 0; i < 4; ++i) r.v[i] = v; return r; }
+        static forcedinline Lanes load (const float* v) noexcept            { Lanes r; memcpy (r.v, v, sizeof (r.v)); return r; }
+        static forcedinline void store (float* dest, Lanes a) noexcept      { memcpy (dest, a.v, sizeof (a.v)); }
+        static forcedinline Lanes add (Lanes a, Lanes b) noexcept           { for (int i = 0; i < 4; ++i) a.v[i] += b.v[i]; return a; }
+        static forcedinline Lanes sub (Lanes a, Lanes b) noexcept           { for (int i = 0; i < 4; ++i) a.v[i] -= b.v[i]; return a; }
+        static forcedinline Lanes mul (Lanes a, Lanes b) noexcept           { for (int i = 0; i < 4; ++i) a.v[i] *= b.v[i]; return a; }
+
+        static forcedinline void transpose (Lanes& a, Lanes& b, Lanes& c, Lanes& d) noexcept
+        {
+            Lanes* const rows[] = { &a, &b, &c, &d };
+
+            for (int i = 0; i < 4; ++i)
+                for (int j = i + 1; j < 4; ++j)
+                    std::swap (rows[i]->v[j], rows[j]->v[i]);
+        }
+
+        static forcedinline Lanes snapToZero (Lanes a) noexcept
+        {
+            for (int i = 0; i < 4; ++i)
+                if (! (a.v[i] < -1.0e-8f || a.v[i] > 1.0e-8f))
+                    a.v[i] = 0;
+
+            return a;
+        }
+    };
+
+    //==============================================================================
+    // Runs one stage for all four lanes over a few samples that have been transposed so
+    // that each Lanes value holds one sample from each channel.
+    template <class Ops, class StageType>
+    static forcedinline void processStage (StageType& stage, typename Ops::Lanes* samples, const int num) noexcept
+    {
+        typedef typename Ops::Lanes Lanes;
+
+        const Lanes c0 = Ops::load (stage.coefficients);
+        const Lanes c1 = Ops::load (stage.coefficients + 4);
+        const Lanes c2 = Ops::load (stage.coefficients + 8);
+        const Lanes c3 = Ops::load (stage.coefficients + 12);
+        const Lanes c4 = Ops::load (stage.coefficients + 16);
+        Lanes v1 = Ops::load (stage.state);
+        Lanes v2 = Ops::load (stage.state + 4);
+
+        for (int i = 0; i < num; ++i)
+        {
+            const Lanes in = samples[i];
+            const Lanes out = Ops::add (Ops::mul (c0, in), v1);
+            samples[i] = out;
+
+            v1 = Ops::add (Ops::sub (Ops::mul (c1, in), Ops::mul (c3, out)), v2);
+            v2 = Ops::sub (Ops::mul (c2, in), Ops::mul (c4, out));
+        }
+
+        Ops::store (stage.state, v1);
+        Ops::store (stage.state + 4, v2);
+
+        if (stage.rampSamplesRemaining > 0)
+        {
+            stage.rampSamplesRemaining -= num;
+
+            if (stage.rampSamplesRemaining > 0)
+            {
+                const Lanes numSteps = Ops::load1 ((float) num);
+
+                for (int i = 0; i < 20; i += 4)
+                    Ops::store (stage.coefficients + i, Ops::add (Ops::load (stage.coefficients + i),
+                                                                  Ops::mul (Ops::load (stage.deltas + i), numSteps)));
+            }
+            else
+            {
+                memcpy (stage.coefficients, stage.targets, sizeof (stage.coefficients));
+                stage.rampSamplesRemaining = 0;
+            }
+        }
+    }
+
+    // Filters up to four channels through all the stages. Any null channel pointers are
+    // treated as silent channels that don't need storing.
+    template <class Ops, class StageType>
+    static void processGroup (StageType* const stages, const int numStages,
+                              float* const* const channels, const int numSamples) noexcept
+    {
+        typedef typename Ops::Lanes Lanes;
+
+        int i = 0;
+
+        for (; i <= numSamples - 4; i += 4)
+        {
+            Lanes samples[4];
+
+            for (int lane = 0; lane < 4; ++lane)
+                samples[lane] = channels[lane] != nullptr ? Ops::load (channels[lane] + i) : Ops::load1 (0);
+
+            Ops::transpose (samples[0], samples[1], samples[2], samples[3]);
+
+            for (int stage = 0; stage < numStages; ++stage)
+                processStage<Ops> (stages[stage], samples, 4);
+
+            Ops::transpose (samples[0], samples[1], samples[2], samples[3]);
+
+            for (int lane = 0; lane < 4; ++lane)
+                if (channels[lane] != nullptr)
+                    Ops::store (channels[lane] + i, samples[lane]);
+        }
+
+        for (; i < numSamples; ++i)
+        {
+            float values[4];
+
+            for (int lane = 0; lane < 4; ++lane)
+                values[lane] = channels[lane] != nullptr ? channels[lane][i] : 0.0f;
+
+            Lanes sample (Ops::load (values));
+
+            for (int stage = 0; stage < numStages; ++stage)
+                processStage<Ops> (stages[stage], &sample, 1);
+
+            Ops::store (values, sample);
+
+            for (int lane = 0; lane < 4; ++lane)
+                if (channels[lane] != nullptr)
+                    channels[lane][i] = values[lane];
+        }
+
+        for (int stage = 0; stage < numStages; ++stage)
+        {
+            Ops::store (stages[stage].state,     Ops::snapToZero (Ops::load (stages[stage].state)));
+            Ops::store (stages[stage].state + 4, Ops::snapToZero (Ops::load (stages[stage].state + 4)));
+        }
+    }
+
+    template <class StageType>
+    static void process (StageType* const stages, const int numStages,
+                         float* const* const channels, const int numSamples) noexcept
+    {
+       #if JUCE_USE_SSE_INTRINSICS || JUCE_USE_ARM_NEON
+        if (FloatVectorHelpers::isSIMDAvailable())
+        {
+            processGroup<SIMDOps> (stages, numStages, channels, numSamples);
+            FloatVectorHelpers::mmEmpty();
+            return;
+        }
+       #endif
+
+        processGroup<ScalarOps> (stages, numStages, channels, numSamples);
+    }
+
+    static void setPassThrough (float* const coefficients) noexcept
+    {
+        zeromem (coefficients, sizeof (float) * 20);
+
+        for (int lane = 0; lane < 4; ++lane)
+            coefficients[lane] = 1.0f;
+    }
+}
+
+//==============================================================================
+// The coefficients of each stage are stored as[coefficientIndex * 4 + lane].
+struct IIRFilterCascade::Stage
+{
+    float coefficients[20], targets[20], deltas[20];
+    float state[8];
+    int rampSamplesRemaining, lastPendingSequence;
+};
+
+// The coefficients most recently asked for. The sequence number is odd while these
+// are being changed, so that the audio thread can tell when it has read a clean copy.
+struct IIRFilterCascade::PendingStage
+{
+    PendingStage() noexcept
+    {
+        IIRFilterCascadeHelpers::setPassThrough (coefficients);
+    }
+
+    float coefficients[20];
+    Atomic<int> sequence;
+
+    JUCE_DECLARE_NON_COPYABLE (PendingStage)
+};
+
+//==============================================================================
+IIRFilterCascade::IIRFilterCascade (const int numChannels_, const int numStages_)
+    : numChannels (0), numStages (0), numGroups (0), smoothingLength (0)
+{
+    setSize (numChannels_, numStages_);
+}
+
+IIRFilterCascade::~IIRFilterCascade()
+{
+}
+
+IIRFilterCascade::Stage& IIRFilterCascade::getStage (const int group, const int stageIndex) const noexcept
+{
+    return stages[group * numStages + stageIndex];
+}
+
+void IIRFilterCascade::setSize (const int newNumChannels, const int newNumStages)
+{
+    jassert (newNumChannels > 0 && newNumStages > 0);
+
+    const ScopedLock sl (changeLock);
+    applyPendingChanges();
+
+    const int newNumGroups = (newNumChannels + 3) / 4;
+    HeapBlock<Stage> newStages ((size_t) (newNumGroups * newNumStages), true);
+    OwnedArray<PendingStage> newPendingStages;
+
+    for (int group = 0; group < newNumGroups; ++group)
+    {
+        for (int stageIndex = 0; stageIndex < newNumStages; ++stageIndex)
+        {
+            Stage& stage = newStages[group * newNumStages + stageIndex];
+            IIRFilterCascadeHelpers::setPassThrough (stage.coefficients);
+
+            for (int lane = 0; lane < 4; ++lane)
+            {
+                const int channel = group * 4 + lane;
+
+                if (stageIndex < numStages)
+                {
+                    // (an unfinished change of coefficients just jumps to its target)
+                    const Stage& oldStage = getStage (channel < numChannels ? group : 0, stageIndex);
+                    const int oldLane = channel < numChannels ? lane : 0;
+
+                    for (int i = 0; i < 5; ++i)
+                        stage.coefficients[i * 4 + lane] = oldStage.targets[i * 4 + oldLane];
+
+                    if (channel < numChannels)
+                    {
+                        stage.state[lane]     = oldStage.state[lane];
+                        stage.state[4 + lane] = oldStage.state[4 + lane];
+                    }
+                }
+            }
+
+            memcpy (stage.targets, stage.coefficients, sizeof (stage.targets));
+
+            PendingStage* const pending = new PendingStage();
+            memcpy (pending->coefficients, stage.coefficients, sizeof (pending->coefficients));
+            newPendingStages.add (pending);
+        }
+    }
+
+    stages.swapWith (newStages);
+    pendingStages.swapWithArray (newPendingStages);
+    numChannels = newNumChannels;
+    numStages = newNumStages;
+    numGroups = newNumGroups;
+}
+
+//==============================================================================
+void IIRFilterCascade::setLaneCoefficients (const int stageIndex, const float* const coefficients, const int channel)
+{
+    for (int group = 0; group < numGroups; ++group)
+    {
+        if (channel >= 0 && channel / 4 != group)
+            continue;
+
+        PendingStage& pending = *pendingStages.getUnchecked (group * numStages + stageIndex);
+
+        ++(pending.sequence);
+
+        for (int lane = 0; lane < 4; ++lane)
+            if (channel < 0 || channel % 4 == lane)
+                for (int i = 0; i < 5; ++i)
+                    pending.coefficients[i * 4 + lane] = coefficients[i];
+
+        ++(pending.sequence);
+    }
+}
+
+void IIRFilterCascade::setCoefficients (const int stageIndex, const IIRCoefficients& newCoefficients, const int channel)
+{
+    const ScopedLock sl (changeLock);
+
+    jassert (isPositiveAndBelow (stageIndex, numStages) && channel < numChannels);
+
+    if (isPositiveAndBelow (stageIndex, numStages) && channel < numChannels)
+        setLaneCoefficients (stageIndex, newCoefficients.c, channel);
+}
+
+void IIRFilterCascade::makeInactive (const int stageIndex, const int channel)
+{
+    const float passThrough[] = { 1.0f, 0, 0, 0, 0 };
+
+    const ScopedLock sl (changeLock);
+
+    for (int i = 0; i < numStages; ++i)
+        if ((stageIndex < 0 || stageIndex == i) && channel < numChannels)
+            setLaneCoefficients (i, passThrough, channel);
+}
+
+void IIRFilterCascade::setSmoothingLength (const int numSamples) noexcept
+{
+    smoothingLength = jmax (0, numSamples);
+}
+
+void IIRFilterCascade::applyPendingChanges() noexcept
+{
+    const int rampLength = smoothingLength;
+
+    for (int i = 0; i < numGroups * numStages; ++i)
+    {
+        PendingStage& pending = *pendingStages.getUnchecked (i);
+        Stage& stage = stages[i];
+        const int sequence = pending.sequence.get();
+
+        if (sequence != stage.lastPendingSequence && (sequence & 1) == 0)
+        {
+            float newTargets[20];
+            memcpy (newTargets, pending.coefficients, sizeof (newTargets));
+
+            if (pending.sequence.get() == sequence)
+            {
+                stage.lastPendingSequence = sequence;
+                memcpy (stage.targets, newTargets, sizeof (stage.targets));
+
+                if (rampLength > 0)
+                {
+                    for (int j = 0; j < 20; ++j)
+                        stage.deltas[j] = (stage.targets[j] - stage.coefficients[j]) / rampLength;
+
+                    stage.rampSamplesRemaining = rampLength;
+                }
+                else
+                {
+                    memcpy (stage.coefficients, stage.targets, sizeof (stage.coefficients));
+                    stage.rampSamplesRemaining = 0;
+                }
+            }
+        }
+    }
+}
+
+//==============================================================================
+void IIRFilterCascade::reset() noexcept
+{
+    for (int i = 0; i < numGroups * numStages; ++i)
+        zeromem (stages[i].state, sizeof (stages[i].state));
+}
+
+void IIRFilterCascade::processSamples (float* const* const channelData, const int numChannelsToProcess,
+                                       const int numSamples) noexcept
+{
+    jassert (numChannelsToProcess <= numChannels);
+
+    applyPendingChanges();
+
+    const int numToProcess = jmin (numChannelsToProcess, numChannels);
+
+    for (int group = 0; group * 4 < numToProcess; ++group)
+    {
+        float* channels[4];
+
+        for (int lane = 0; lane < 4; ++lane)
+            channels[lane] = group * 4 + lane < numToProcess ? channelData[group * 4 + lane] : nullptr;
+
+        IIRFilterCascadeHelpers::process (&getStage (group, 0), numStages, channels, numSamples);
+    }
+}
+
+void IIRFilterCascade::processSamples (AudioSampleBuffer& buffer, const int startSample, const int numSamples) noexcept
+{
+    jassert (buffer.getNumChannels() <= numChannels);
+    jassert (startSample >= 0 && startSample + numSamples <= buffer.getNumSamples());
+
+    applyPendingChanges();
+
+    const int numToProcess = jmin (buffer.getNumChannels(), numChannels);
+
+    for (int group = 0; group * 4 < numToProcess; ++group)
+    {
+        float* channels[4];
+
+        for (int lane = 0; lane < 4; ++lane)
+            channels[lane] = group * 4 + lane < numToProcess ? buffer.getSampleData (group * 4 + lane, startSample)
+                                                             : nullptr;
+
+        IIRFilterCascadeHelpers::process (&getStage (group, 0), numStages, channels, numSamples);
+    }
+}
@@ -0,0 +1,138 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+
+#ifndef __JUCE_IIRFILTERCASCADE_JUCEHEADER__
+#define __JUCE_IIRFILTERCASCADE_JUCEHEADER__
+
+#include "juce_IIRFilter.h"
+#include "../buffers/juce_AudioSampleBuffer.h"
+
+
+//==============================================================================
+/**
+    A chain of IIR filters, applied to a set of audio channels.
+
+    Each of the channels is passed through the same number of filter stages, one
+    after the other. Each stage can be given its own IIRCoefficients, and these can
+    either be the same for all the channels, or set for each channel separately.
+
+    The channels are processed four at a time, with the filter state kept in a
+    structure-of-arrays layout, so that on SSE or NEON targets each group of four
+    channels runs in the lanes of the processor's vector registers. This makes it
+    a lot faster than using a separate IIRFilter for each channel and stage.
+
+    The methods that change the coefficients can be called from any thread, and
+    never make the audio thread wait: the new values are picked up at the start
+    of the next call to processSamples(). If you give it a smoothing length, the
+    coefficients will then be moved gradually towards their new values, to avoid
+    clicks when filters are changed during playback.
+
+    @see IIRFilter, IIRCoefficients, IIRFilterAudioSource
+*/
+class JUCE_API  IIRFilterCascade
+{
+public:
+    //==============================================================================
+    /** Creates a cascade for a number of channels and stages.
+        Initially all the stages are inactive, so will have no effect on samples that
+        you process with it.
+    */
+    IIRFilterCascade (int numChannels = 2, int numStages = 1);
+
+    /** Destructor. */
+    ~IIRFilterCascade();
+
+    //==============================================================================
+    /** Changes the number of channels and stages.
+
+        The coefficients of any existing channels and stages are kept, and any new
+        channels are given the same coefficients as the first channel. This allocates
+        memory, and mustn't be called while another thread is in processSamples().
+    */
+    void setSize (int numChannels, int numStages);
+
+    /** Returns the number of channels that the cascade was given. */
+    int getNumChannels() const noexcept                     { return numChannels; }
+
+    /** Returns the number of filter stages that each channel is passed through. */
+    int getNumStages() const noexcept                       { return numStages; }
+
+    //==============================================================================
+    /** Applies a set of coefficients to one of the stages.
+
+        If channel is less than 0, the coefficients are used for all the channels,
+        otherwise they're only used for the channel with that index.
+    */
+    void setCoefficients (int stageIndex, const IIRCoefficients& newCoefficients, int channel = -1);
+
+    /** Makes a stage let the incoming data pass through unchanged.
+        If stageIndex is less than 0, all the stages are made inactive. As with
+        setCoefficients(), a channel of less than 0 affects all the channels.
+    */
+    void makeInactive (int stageIndex = -1, int channel = -1);
+
+    /** Sets the number of samples over which future coefficient changes are faded in.
+        If this is 0 (the default), new coefficients are used as soon as processSamples()
+        is next called.
+    */
+    void setSmoothingLength (int numSamples) noexcept;
+
+    //==============================================================================
+    /** Resets the filters' processing pipelines, ready to start a new stream of data.
+        This clears the processing state, but doesn't change the coefficients.
+    */
+    void reset() noexcept;
+
+    /** Filters a set of channels.
+        The number of channels must be no more than getNumChannels().
+    */
+    void processSamples (float* const* channelData, int numChannels, int numSamples) noexcept;
+
+    /** Filters a section of all the channels in an AudioSampleBuffer.
+        The buffer must have no more than getNumChannels() channels.
+    */
+    void processSamples (AudioSampleBuffer& buffer, int startSample, int numSamples) noexcept;
+
+private:
+    //==============================================================================
+    struct Stage;
+    struct PendingStage;
+    friend class OwnedArray<PendingStage>;
+
+    int numChannels, numStages, numGroups;
+    HeapBlock<Stage> stages;
+    OwnedArray<PendingStage> pendingStages;
+    CriticalSection changeLock;
+    int smoothingLength;
+
+    Stage& getStage (int group, int stageIndex) const noexcept;
+    void setLaneCoefficients (int stageIndex, const float* coefficients, int channel);
+    void applyPendingChanges() noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (IIRFilterCascade)
+};
+
+
+#endif   // __JUCE_IIRFILTERCASCADE_JUCEHEADER__
@@ -0,0 +1,176 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+
+#ifndef __JUCE_LINEARSMOOTHEDVALUE_JUCEHEADER__
+#define __JUCE_LINEARSMOOTHEDVALUE_JUCEHEADER__
+
+
+//==============================================================================
+/**
+    A value that glides linearly to each new target over a fixed length of time,
+    rather than jumping straight to it.
+
+    Use one of these for a gain or any other parameter which would click or zip if it
+    changed abruptly. Call setValue() whenever the target changes, and then either
+    getNextValue() for each sample that you render, or applyGain() to scale a whole
+    block of audio at once, which uses vector operations for the part of the block
+    where the value is still moving.
+
+    This class isn't thread-safe: if the target is set by a different thread from the
+    one that renders the audio, keep the new target somewhere else and call setValue()
+    at the start of each block.
+
+    @see AudioSampleBuffer::applyGainRamp
+*/
+class LinearSmoothedValue
+{
+public:
+    /** Creates a smoothed value which starts at 0. */
+    LinearSmoothedValue() noexcept
+        : currentValue (0), targetValue (0), step (0), countdown (0), stepsToTarget (0)
+    {
+    }
+
+    /** Creates a smoothed value which starts at the value given. */
+    explicit LinearSmoothedValue (const float initialValue) noexcept
+        : currentValue (initialValue), targetValue (initialValue), step (0), countdown (0), stepsToTarget (0)
+    {
+    }
+
+    //==============================================================================
+    /** Sets the sample rate and the time that the value takes to reach each new target.
+        This also stops any glide that's in progress, jumping straight to the target value.
+    */
+    void reset (const double sampleRate, const double rampLengthInSeconds) noexcept
+    {
+        jassert (sampleRate > 0 && rampLengthInSeconds >= 0);
+
+        stepsToTarget = (int) (rampLengthInSeconds * sampleRate);
+        setCurrentAndTargetValue (targetValue);
+    }
+
+    /** Sets a new target, which the value will glide towards. */
+    void setValue (const float newValue) noexcept
+    {
+        if (newValue != targetValue)
+        {
+            targetValue = newValue;
+            countdown = stepsToTarget;
+
+            if (countdown <= 0)
+                currentValue = targetValue;
+            else
+                step = (targetValue - currentValue) / (float) countdown;
+        }
+    }
+
+    /** Jumps straight to a new value, without gliding. */
+    void setCurrentAndTargetValue (const float newValue) noexcept
+    {
+        currentValue = targetValue = newValue;
+        countdown = 0;
+    }
+
+    //==============================================================================
+    /** Moves the value on by one sample, and returns its new value. */
+    inline float getNextValue() noexcept
+    {
+        if (countdown <= 0)
+            return targetValue;
+
+        if (--countdown == 0)
+            currentValue = targetValue;
+        else
+            currentValue += step;
+
+        return currentValue;
+    }
+
+    /** Moves the value on by a number of samples, and returns its new value. */
+    float skip (const int numSamples) noexcept
+    {
+        if (numSamples >= countdown)
+        {
+            setCurrentAndTargetValue (targetValue);
+            return targetValue;
+        }
+
+        currentValue += step * (float) numSamples;
+        countdown -= numSamples;
+        return currentValue;
+    }
+
+    /** Returns true if the value is still moving towards its target. */
+    bool isSmoothing() const noexcept               { return countdown > 0; }
+
+    /** Returns the value as of the last sample that was rendered. */
+    float getCurrentValue() const noexcept          { return countdown > 0 ? currentValue : targetValue; }
+
+    /** Returns the value that it's moving towards. */
+    float getTargetValue() const noexcept           { return targetValue; }
+
+    //==============================================================================
+    /** Multiplies a block of samples by the value, moving the value on by one step for
+        each sample, in the same way as calling getNextValue() for each of them.
+    */
+    void applyGain (float* const samples, const int numSamples) noexcept
+    {
+        const int numRamped = jmin (numSamples, countdown);
+
+        if (numRamped > 0)
+        {
+            const float startGain = currentValue + step;
+            FloatVectorOperations::multiplyWithRamp (samples, startGain, skip (numRamped) + step, numRamped);
+        }
+
+        if (numSamples > numRamped && targetValue != 1.0f)
+            FloatVectorOperations::multiply (samples + numRamped, targetValue, numSamples - numRamped);
+    }
+
+    /** Multiplies a region of all the channels in a buffer by the value, moving the
+        value on by one step for each sample.
+    */
+    void applyGain (AudioSampleBuffer& buffer, const int startSample, const int numSamples) noexcept
+    {
+        const int numRamped = jmin (numSamples, countdown);
+
+        if (numRamped > 0)
+        {
+            const float startGain = currentValue + step;
+            buffer.applyGainRamp (startSample, numRamped, startGain, skip (numRamped) + step);
+        }
+
+        if (numSamples > numRamped && targetValue != 1.0f)
+            buffer.applyGain (startSample + numRamped, numSamples - numRamped, targetValue);
+    }
+
+private:
+    //==============================================================================
+    float currentValue, targetValue, step;
+    int countdown, stepsToTarget;
+};
+
+
+#endif   // __JUCE_LINEARSMOOTHEDVALUE_JUCEHEADER__
@@ -0,0 +1,247 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+namespace PartitionedConvolverHelpers
+{
+    static int getOrder (const int blockSize) noexcept
+    {
+        jassert (isPowerOfTwo (blockSize) && blockSize > 0); // the block size must be a power of two!
+
+        int order = 0;
+        while ((1 << order) < blockSize)
+            ++order;
+
+        return order;
+    }
+}
+
+PartitionedConvolver::PartitionedConvolver (const int blockSize_)
+    : blockSize (blockSize_),
+      numBins (blockSize_ + 1),
+      fft (PartitionedConvolverHelpers::getOrder (blockSize_) + 1),
+      impulseResponseLength (0),
+      numPartitions (0),
+      position (0),
+      newestSpectrum (0),
+      inputFrame ((size_t) blockSize_ * 2, true),
+      outputFrame ((size_t) blockSize_ * 2, true),
+      outputBlock ((size_t) blockSize_, true),
+      sumReal ((size_t) blockSize_ + 1),
+      sumImag ((size_t) blockSize_ + 1)
+{
+}
+
+PartitionedConvolver::~PartitionedConvolver()
+{
+}
+
+//==============================================================================
+void PartitionedConvolver::setImpulseResponse (const float* const samples, const int numSamples)
+{
+    impulseResponseLength = jmax (0, numSamples);
+    numPartitions = (impulseResponseLength + blockSize - 1) / blockSize;
+
+    partitionSpectra.malloc ((size_t) (numPartitions * numBins * 3));
+    inputSpectra.malloc ((size_t) (numPartitions * numBins * 2));
+
+    for (int i = 0; i < numPartitions; ++i)
+    {
+        // each partition is zero-padded to the FFT size
+        const int num = jmin (blockSize, impulseResponseLength - i * blockSize);
+        FloatVectorOperations::copy (outputFrame, samples + i * blockSize, num);
+        FloatVectorOperations::clear (outputFrame + num, blockSize * 2 - num);
+
+        float* const real = partitionSpectra + i * numBins * 3;
+        fft.performRealForwardTransform (outputFrame, real, real + numBins);
+        FloatVectorOperations::negate (real + numBins * 2, real + numBins, numBins);
+    }
+
+    reset();
+}
+
+void PartitionedConvolver::setImpulseResponse (const AudioSampleBuffer& buffer, const int channel)
+{
+    setImpulseResponse (buffer.getSampleData (channel), buffer.getNumSamples());
+}
+
+void PartitionedConvolver::reset() noexcept
+{
+    position = 0;
+    newestSpectrum = 0;
+
+    FloatVectorOperations::clear (inputFrame, blockSize * 2);
+    FloatVectorOperations::clear (outputBlock, blockSize);
+
+    if (numPartitions > 0)
+        FloatVectorOperations::clear (inputSpectra, numPartitions * numBins * 2);
+}
+
+//==============================================================================
+void PartitionedConvolver::process (const float* input, float* output, int numSamples) noexcept
+{
+    while (numSamples > 0)
+    {
+        const int num = jmin (numSamples, blockSize - position);
+
+        // (the input is copied before any output is written, so they can be the same data)
+        FloatVectorOperations::copy (inputFrame + blockSize + position, input, num);
+        FloatVectorOperations::copy (output, outputBlock + position, num);
+
+        position += num;
+        input += num;
+        output += num;
+        numSamples -= num;
+
+        if (position == blockSize)
+        {
+            processBlock();
+            position = 0;
+        }
+    }
+}
+
+void PartitionedConvolver::process (AudioSampleBuffer& buffer, const int channel,
+                                    const int startSample, const int numSamples) noexcept
+{
+    jassert (startSample >= 0 && startSample + numSamples <= buffer.getNumSamples());
+
+    float* const data = buffer.getSampleData (channel, startSample);
+    process (data, data, numSamples);
+}
+
+/*  Uses overlap-save: the last two blocks of input are transformed together, and after
+    multiplying by the impulse response, the second half of the result is valid output.
+*/
+void PartitionedConvolver::processBlock() noexcept
+{
+    if (numPartitions == 0)
+    {
+        FloatVectorOperations::clear (outputBlock, blockSize);
+        FloatVectorOperations::copy (inputFrame, inputFrame + blockSize, blockSize);
+        return;
+    }
+
+    newestSpectrum = (newestSpectrum + numPartitions - 1) % numPartitions;
+
+    float* const newReal = inputSpectra + newestSpectrum * numBins * 2;
+    fft.performRealForwardTransform (inputFrame, newReal, newReal + numBins);
+
+    FloatVectorOperations::clear (sumReal, numBins);
+    FloatVectorOperations::clear (sumImag, numBins);
+
+    for (int i = 0; i < numPartitions; ++i)
+    {
+        // the spectrum of the input from i blocks ago gets multiplied by the i'th partition
+        const float* const inReal = inputSpectra + ((newestSpectrum + i) % numPartitions) * numBins * 2;
+        const float* const inImag = inReal + numBins;
+        const float* const irReal = partitionSpectra + i * numBins * 3;
+        const float* const irImag = irReal + numBins;
+        const float* const irNegImag = irImag + numBins;
+
+        FloatVectorOperations::addWithMultiply (sumReal, inReal, irReal, numBins);
+        FloatVectorOperations::addWithMultiply (sumReal, inImag, irNegImag, numBins);
+        FloatVectorOperations::addWithMultiply (sumImag, inReal, irImag, numBins);
+        FloatVectorOperations::addWithMultiply (sumImag, inImag, irReal, numBins);
+    }
+
+    fft.performRealInverseTransform (sumReal, sumImag, outputFrame);
+
+    FloatVectorOperations::copy (outputBlock, outputFrame + blockSize, blockSize);
+    FloatVectorOperations::copy (inputFrame, inputFrame + blockSize, blockSize);
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class PartitionedConvolverTests  : public UnitTest
+{
+public:
+    PartitionedConvolverTests() : UnitTest ("PartitionedConvolver") {}
+
+    void runTest()
+    {
+        beginTest ("Convolution");
+
+        Random r (0x4321);
+        const int numSamples = 4000;
+
+        for (int blockSize = 16; blockSize <= 256; blockSize *= 4)
+        {
+            const int impulseLengths[] = { 1, blockSize, 1000 };
+
+            for (int j = 0; j < numElementsInArray (impulseLengths); ++j)
+            {
+                const int impulseLength = impulseLengths[j];
+                HeapBlock<float> impulse (impulseLength), input (numSamples), output (numSamples);
+
+                for (int i = 0; i < impulseLength; ++i)
+                    impulse[i] = (r.nextFloat() * 2.0f - 1.0f) / std::sqrt ((float) impulseLength);
+
+                for (int i = 0; i < numSamples; ++i)
+                    input[i] = r.nextFloat() * 2.0f - 1.0f;
+
+                PartitionedConvolver convolver (blockSize);
+                convolver.setImpulseResponse (impulse, impulseLength);
+
+                // process it in randomly-sized chunks, some of them in-place
+                FloatVectorOperations::copy (output, input, numSamples);
+
+                for (int pos = 0; pos < numSamples;)
+                {
+                    const int num = jmin (numSamples - pos, r.nextInt (300));
+
+                    if (r.nextBool())
+                        convolver.process (output + pos, output + pos, num);
+                    else
+                        convolver.process (input + pos, output + pos, num);
+
+                    pos += num;
+                }
+
+                float maxError = 0;
+
+                for (int i = 0; i < numSamples; ++i)
+                {
+                    double expected = 0;
+
+                    for (int k = 0; k < impulseLength; ++k)
+                    {
+                        const int inputIndex = i - convolver.getLatencyInSamples() - k;
+
+                        if (inputIndex >= 0)
+                            expected += impulse[k] * (double) input [inputIndex];
+                    }
+
+                    maxError = jmax (maxError, std::abs ((float) expected - output[i]));
+                }
+
+                expect (maxError < 1.0e-4f);
+            }
+        }
+    }
+};
+
+static PartitionedConvolverTests partitionedConvolverTests;
+
+#endif
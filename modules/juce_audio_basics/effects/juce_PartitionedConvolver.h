@@ -0,0 +1,106 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_PARTITIONEDCONVOLVER_JUCEHEADER__
+#define __JUCE_PARTITIONEDCONVOLVER_JUCEHEADER__
+
+#include "juce_FFT.h"
+#include "../buffers/juce_AudioSampleBuffer.h"
+
+
+//==============================================================================
+/**
+    Convolves a stream of samples with an impulse response, using uniformly-partitioned
+    FFT convolution.
+
+    The impulse response is cut into partitions of the block size, and each of these is
+    transformed once when the response is loaded. Each block of input is then transformed
+    and kept in a delay line of spectra, and the output is made by multiplying these with
+    the partitions' spectra, so the cost per sample only grows with the number of
+    partitions rather than with every sample of a long impulse response.
+
+    The output is delayed by one block (see getLatencyInSamples()), but you can pass it any
+    number of samples at a time. Smaller blocks give less latency, but take more CPU.
+
+    This isn't thread-safe, so don't load a new impulse response while another thread is
+    calling process().
+
+    @see FFT
+*/
+class JUCE_API  PartitionedConvolver
+{
+public:
+    //==============================================================================
+    /** Creates a convolver that works in blocks of a given size, which must be a power of two. */
+    explicit PartitionedConvolver (int blockSize = 512);
+
+    /** Destructor. */
+    ~PartitionedConvolver();
+
+    //==============================================================================
+    /** Loads a new impulse response, and resets the convolver's state.
+        Until an impulse response has been loaded, the output is silent.
+    */
+    void setImpulseResponse (const float* samples, int numSamples);
+
+    /** Loads a new impulse response from one channel of an AudioSampleBuffer. */
+    void setImpulseResponse (const AudioSampleBuffer& buffer, int channel);
+
+    /** Returns the length of the current impulse response. */
+    int getImpulseResponseLength() const noexcept           { return impulseResponseLength; }
+
+    /** Returns the block size that was passed to the constructor. */
+    int getBlockSize() const noexcept                       { return blockSize; }
+
+    /** Returns the number of samples by which the output lags behind the input. */
+    int getLatencyInSamples() const noexcept                { return blockSize; }
+
+    /** Clears the convolver's history, without changing its impulse response. */
+    void reset() noexcept;
+
+    //==============================================================================
+    /** Convolves some samples. The input and output may point to the same data. */
+    void process (const float* input, float* output, int numSamples) noexcept;
+
+    /** Convolves a range of samples in one channel of a buffer, in-place. */
+    void process (AudioSampleBuffer& buffer, int channel, int startSample, int numSamples) noexcept;
+
+private:
+    //==============================================================================
+    const int blockSize, numBins;
+    FFT fft;
+    int impulseResponseLength, numPartitions, position, newestSpectrum;
+
+    // Each partition of the impulse response is stored as its real, imaginary and negated
+    // imaginary parts, and each input spectrum as its real and imaginary parts.
+    HeapBlock<float> partitionSpectra, inputSpectra;
+    HeapBlock<float> inputFrame, outputFrame, outputBlock, sumReal, sumImag;
+
+    void processBlock() noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PartitionedConvolver)
+};
+
+
+#endif   // __JUCE_PARTITIONEDCONVOLVER_JUCEHEADER__
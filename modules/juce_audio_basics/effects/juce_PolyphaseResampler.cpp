@@ -0,0 +1,583 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+
+namespace PolyphaseResamplerHelpers
+{
+   #if JUCE_USE_SSE_INTRINSICS
+    struct SIMDOps
+    {
+        typedef __m128 Lanes;
+
+        static forcedinline Lanes load1 (float v) noexcept                  { return _mm_load1_ps (&v); }
+        static forcedinline Lanes load (const float* v) noexcept            { return _mm_loadu_ps (v); }
+        static forcedinline void store (float* dest, Lanes a) noexcept      { _mm_storeu_ps (dest, a); }
+        static forcedinline Lanes add (Lanes a, Lanes b) noexcept           { return _mm_add_ps (a, b); }
+        static forcedinline Lanes sub (Lanes a, Lanes b) noexcept           { return _mm_sub_ps (a, b); }
+        static forcedinline Lanes mul (Lanes a, Lanes b) noexcept           { return _mm_mul_ps (a, b); }
+    };
+
+   #elif JUCE_USE_ARM_NEON
+    struct SIMDOps
+    {
+        typedef float32x4_t Lanes;
+
+        static forcedinline Lanes load1 (float v) noexcept                  { return vld1q_dup_f32 (&v); }
+        static forcedinline Lanes load (const float* v) noexcept            { return vld1q_f32 (v); }
+        static forcedinline void store (float* dest, Lanes a) noexcept      { vst1q_f32 (dest, a); }
+        static forcedinline Lanes add (Lanes a, Lanes b) noexcept           { return vaddq_f32 (a, b); }
+        static forcedinline Lanes sub (Lanes a, Lanes b) noexcept           { return vsubq_f32 (a, b); }
+        static forcedinline Lanes mul (Lanes a, Lanes b) noexcept           { return vmulq_f32 (a, b); }
+    };
+   #endif
+
+    struct ScalarOps
+    {
+        struct Lanes  { float v[4]; };
+
+        static forcedinline Lanes load1 (float v) noexcept                  { Lanes r; for (int i = 0; i < 4; ++i) r.v[i] = v; return r; }
+        static forcedinline Lanes load (const float* v) noexcept            { Lanes r; memcpy (r.v, v, sizeof (r.v)); return r; }
+        static forcedinline void store (float* dest, Lanes a) noexcept      { memcpy (dest, a.v, sizeof (a.v)); }
+        static forcedinline Lanes add (Lanes a, Lanes b) noexcept           { for (int i = 0; i < 4; ++i) a.v[i] += b.v[i]; return a; }
+        static forcedinline Lanes sub (Lanes a, Lanes b) noexcept           { for (int i = 0; i < 4; ++i) a.v[i] -= b.v[i]; return a; }
+        static forcedinline Lanes mul (Lanes a, Lanes b) noexcept           { for (int i = 0; i < 4; ++i) a.v[i] *= b.v[i]; return a; }
+    };
+
+    //==============================================================================
+    struct QualitySettings
+    {
+        int numTaps, numPhases;
+        double passband, kaiserBeta;
+    };
+
+    static const QualitySettings& getQualitySettings (const int quality) noexcept
+    {
+        static const QualitySettings settings[] =
+        {
+            { 16,  64,  0.80, 5.0 },
+            { 32,  128, 0.86, 7.0 },
+            { 64,  256, 0.91, 9.0 },
+            { 128, 512, 0.95, 11.0 }
+        };
+
+        return settings [jlimit (0, (int) numElementsInArray (settings) - 1, quality)];
+    }
+
+    enum
+    {
+        maxExactDenominator = 512,
+        maxFilterLength = 1024,
+        samplesPerChunk = 1024
+    };
+
+    static double besselI0 (const double x) noexcept
+    {
+        double sum = 1.0, term = 1.0;
+
+        for (int k = 1; k < 50 && term > sum * 1.0e-12; ++k)
+        {
+            const double halfXOverK = x / (2.0 * k);
+            term *= halfXOverK * halfXOverK;
+            sum += term;
+        }
+
+        return sum;
+    }
+
+    //==============================================================================
+    // The input buffer holds each sample of the four channels in a group next to each
+    // other, so a whole filter tap can be applied to all of them with one multiply.
+    template <class Ops>
+    static forcedinline typename Ops::Lanes dotProduct (const float* coefficients, const float* samples,
+                                                        const int numTaps) noexcept
+    {
+        typedef typename Ops::Lanes Lanes;
+
+        Lanes a (Ops::load1 (0)), b (a);
+
+        for (int i = 0; i < numTaps; i += 2)
+        {
+            a = Ops::add (a, Ops::mul (Ops::load1 (coefficients[i]),     Ops::load (samples + i * 4)));
+            b = Ops::add (b, Ops::mul (Ops::load1 (coefficients[i + 1]), Ops::load (samples + i * 4 + 4)));
+        }
+
+        return Ops::add (a, b);
+    }
+
+    template <class Ops>
+    static forcedinline typename Ops::Lanes dotProduct (const float* coefficients1, const float* coefficients2,
+                                                        const float alpha, const float* samples,
+                                                        const int numTaps) noexcept
+    {
+        typedef typename Ops::Lanes Lanes;
+
+        Lanes a (Ops::load1 (0)), b (a);
+
+        for (int i = 0; i < numTaps; ++i)
+        {
+            const Lanes s (Ops::load (samples + i * 4));
+            a = Ops::add (a, Ops::mul (Ops::load1 (coefficients1[i]), s));
+            b = Ops::add (b, Ops::mul (Ops::load1 (coefficients2[i]), s));
+        }
+
+        return Ops::add (a, Ops::mul (Ops::load1 (alpha), Ops::sub (b, a)));
+    }
+
+    // Produces a run of output samples for a group of four channels. Null output
+    // pointers are used for lanes that aren't in use.
+    template <class Ops>
+    static void processGroup (const float* const samples, int pos, int64 phase,
+                              const int64 increment, const int64 denominator,
+                              const float* const coefficients, const int numTaps,
+                              const int numPhases, const bool interpolated,
+                              float* const* const outputs, const int numOutputSamples) noexcept
+    {
+        float values[4];
+
+        for (int i = 0; i < numOutputSamples; ++i)
+        {
+            if (interpolated)
+            {
+                // (the denominator is 2^32 when interpolating, so the top bits give the phase)
+                const int64 scaledPhase = phase * numPhases;
+                const float* const c = coefficients + (size_t) (scaledPhase >> 32) * (size_t) numTaps;
+                const float alpha = (float) (scaledPhase & 0xffffffff) * (1.0f / 4294967296.0f);
+
+                Ops::store (values, dotProduct<Ops> (c, c + numTaps, alpha, samples + pos * 4, numTaps));
+            }
+            else
+            {
+                Ops::store (values, dotProduct<Ops> (coefficients + (size_t) phase * (size_t) numTaps,
+                                                     samples + pos * 4, numTaps));
+            }
+
+            for (int lane = 0; lane < 4; ++lane)
+                if (outputs[lane] != nullptr)
+                    outputs[lane][i] = values[lane];
+
+            phase += increment;
+
+            if (phase >= denominator)
+            {
+                pos += (int) (phase / denominator);
+                phase %= denominator;
+            }
+        }
+    }
+}
+
+//==============================================================================
+class PolyphaseResampler::FilterTable  : public ReferenceCountedObject
+{
+public:
+    FilterTable (const int numTaps_, const int numPhases_, const bool isInterpolated_,
+                 const double cutoff_, const double beta_)
+        : numTaps (numTaps_), numPhases (numPhases_), isInterpolated (isInterpolated_),
+          cutoff (cutoff_), beta (beta_)
+    {
+        // an interpolating table needs an extra row at the end, for the last phase to blend into
+        const int numRows = numPhases + (isInterpolated ? 1 : 0);
+        coefficients.malloc ((size_t) (numRows * numTaps));
+
+        const double halfLength = numTaps / 2;
+        const double windowScale = 1.0 / PolyphaseResamplerHelpers::besselI0 (beta);
+
+        for (int row = 0; row < numRows; ++row)
+        {
+            float* const c = coefficients + row * numTaps;
+            const double offset = row / (double) numPhases + halfLength - 1.0;
+            double sum = 0;
+
+            for (int i = 0; i < numTaps; ++i)
+            {
+                const double distance = offset - i;
+                const double x = distance / halfLength;
+                double value = 0;
+
+                if (std::abs (x) < 1.0)
+                {
+                    const double window = PolyphaseResamplerHelpers::besselI0 (beta * std::sqrt (1.0 - x * x)) * windowScale;
+
+                    value = window * (distance == 0 ? 2.0 * cutoff
+                                                    : std::sin (2.0 * double_Pi * cutoff * distance) / (double_Pi * distance));
+                }
+
+                c[i] = (float) value;
+                sum += value;
+            }
+
+            // normalising each phase gives a flat response at DC, whatever the position
+            for (int i = 0; i < numTaps; ++i)
+                c[i] = (float) (c[i] / sum);
+        }
+    }
+
+    const float* getCoefficients() const noexcept       { return coefficients; }
+
+    typedef ReferenceCountedObjectPtr<FilterTable> Ptr;
+
+    // (this returns a Ptr rather than a raw pointer so that the table can't be purged by
+    // another thread before the caller has taken hold of it)
+    static Ptr getTable (const int numTaps, const int numPhases, const bool isInterpolated,
+                         const double cutoff, const double beta)
+    {
+        const ScopedLock sl (cache.getLock());
+
+        for (int i = cache.size(); --i >= 0;)
+        {
+            FilterTable* const t = cache.getUnchecked (i);
+
+            if (t->numTaps == numTaps && t->numPhases == numPhases && t->isInterpolated == isInterpolated
+                 && t->cutoff == cutoff && t->beta == beta)
+                return t;
+        }
+
+        // Only a handful of unused tables are kept, in case they're needed again..
+        for (int i = 0, numUnused = 0; i < cache.size(); ++i)
+            if (cache.getUnchecked (i)->getReferenceCount() == 1 && ++numUnused > 8)
+                cache.remove (i--);
+
+        FilterTable* const t = new FilterTable (numTaps, numPhases, isInterpolated, cutoff, beta);
+        cache.add (t);
+        return t;
+    }
+
+    const int numTaps, numPhases;
+    const bool isInterpolated;
+    const double cutoff, beta;
+
+private:
+    HeapBlock<float> coefficients;
+
+    static ReferenceCountedArray<FilterTable, CriticalSection> cache;
+
+    JUCE_DECLARE_NON_COPYABLE (FilterTable)
+};
+
+ReferenceCountedArray<PolyphaseResampler::FilterTable, CriticalSection> PolyphaseResampler::FilterTable::cache;
+
+//==============================================================================
+PolyphaseResampler::PolyphaseResampler (const int numChannels_, const Quality quality_)
+    : numChannels (0), numGroups (0), quality (quality_), ratio (1.0),
+      bufferSize (0), numTaps (0), numBuffered (0), readPos (0),
+      phase (0), phaseIncrement (1), phaseDenominator (1)
+{
+    updateTable (1, 1);
+    setNumChannels (numChannels_);
+}
+
+PolyphaseResampler::~PolyphaseResampler()
+{
+}
+
+void PolyphaseResampler::setNumChannels (const int newNumChannels)
+{
+    jassert (newNumChannels > 0);
+
+    numChannels = jmax (1, newNumChannels);
+    numGroups = (numChannels + 3) / 4;
+    bufferSize = PolyphaseResamplerHelpers::maxFilterLength + PolyphaseResamplerHelpers::samplesPerChunk;
+    buffer.malloc ((size_t) (numGroups * bufferSize * 4));
+    reset();
+}
+
+void PolyphaseResampler::setQuality (const Quality newQuality)
+{
+    quality = newQuality;
+
+    if (isUsingExactRatio())
+        updateTable ((int) phaseIncrement, (int) phaseDenominator);
+    else
+        updateTable (0, 0);
+
+    reset();
+}
+
+//==============================================================================
+void PolyphaseResampler::setResamplingRatio (const double samplesInPerOutputSample)
+{
+    jassert (samplesInPerOutputSample > 0);
+
+    ratio = jmax (1.0e-6, samplesInPerOutputSample);
+
+    for (int denominator = 1; denominator <= PolyphaseResamplerHelpers::maxExactDenominator; ++denominator)
+    {
+        const double numerator = ratio * denominator;
+        const int roundedNumerator = roundToInt (numerator);
+
+        if (roundedNumerator > 0 && std::abs (numerator - roundedNumerator) < numerator * 1.0e-10)
+        {
+            updateTable (roundedNumerator, denominator);
+            return;
+        }
+    }
+
+    updateTable (0, 0);
+}
+
+void PolyphaseResampler::setSampleRates (const double sourceSampleRate, const double destSampleRate)
+{
+    jassert (sourceSampleRate > 0 && destSampleRate > 0);
+
+    if (sourceSampleRate == std::floor (sourceSampleRate) && sourceSampleRate < 0x7fffffff
+         && destSampleRate == std::floor (destSampleRate) && destSampleRate < 0x7fffffff)
+    {
+        int a = (int) sourceSampleRate, b = (int) destSampleRate;
+
+        while (b != 0)
+        {
+            const int remainder = a % b;
+            a = b;
+            b = remainder;
+        }
+
+        const int numerator = (int) sourceSampleRate / a;
+        const int denominator = (int) destSampleRate / a;
+
+        if (denominator <= PolyphaseResamplerHelpers::maxExactDenominator)
+        {
+            ratio = sourceSampleRate / destSampleRate;
+            updateTable (numerator, denominator);
+            return;
+        }
+    }
+
+    setResamplingRatio (sourceSampleRate / destSampleRate);
+}
+
+bool PolyphaseResampler::isUsingExactRatio() const noexcept
+{
+    return ! table->isInterpolated;
+}
+
+int PolyphaseResampler::getFilterLength() const noexcept
+{
+    return numTaps;
+}
+
+void PolyphaseResampler::updateTable (const int exactNumerator, const int exactDenominator)
+{
+    using namespace PolyphaseResamplerHelpers;
+
+    const bool isExact = exactDenominator > 0;
+    const QualitySettings& settings = getQualitySettings (quality);
+
+    double filterRatio = isExact ? exactNumerator / (double) exactDenominator : ratio;
+
+    // When the ratio is arbitrary, the cutoff is rounded down to the nearest 1/16th of an
+    // octave, so that a ratio which is being moved around can re-use the same few tables.
+    if (! isExact && filterRatio > 1.0)
+        filterRatio = std::pow (2.0, std::ceil (16.0 * std::log (filterRatio) / std::log (2.0)) / 16.0);
+
+    const double downsampling = jmax (1.0, filterRatio);
+    const int newNumTaps = jmin ((int) maxFilterLength, (roundToInt (settings.numTaps * downsampling) + 3) & ~3);
+
+    table = FilterTable::getTable (newNumTaps, isExact ? exactDenominator : settings.numPhases, ! isExact,
+                                   0.5 * settings.passband / downsampling, settings.kaiserBeta);
+
+    const int64 newDenominator = isExact ? (int64) exactDenominator : ((int64) 1 << 32);
+
+    if (newDenominator != phaseDenominator)
+        phase = jmin (newDenominator - 1, (int64) (phase * (newDenominator / (double) phaseDenominator) + 0.5));
+
+    phaseDenominator = newDenominator;
+    phaseIncrement = isExact ? (int64) exactNumerator
+                             : jmax ((int64) 1, (int64) (ratio * (double) newDenominator + 0.5));
+
+    setNumTaps (newNumTaps);
+}
+
+// Keeps the stream's position when the length of the filter changes. The window's
+// centre has to stay in the same place, so its start moves by half the difference.
+void PolyphaseResampler::setNumTaps (const int newNumTaps) noexcept
+{
+    const int newReadPos = readPos + (numTaps - newNumTaps) / 2;
+    numTaps = newNumTaps;
+
+    if (newReadPos >= 0)
+    {
+        readPos = newReadPos;
+        return;
+    }
+
+    const int numToInsert = -newReadPos;
+
+    for (int group = 0; group < numGroups; ++group)
+    {
+        float* const data = getGroupBuffer (group);
+        memmove (data + numToInsert * 4, data, sizeof (float) * (size_t) (numBuffered * 4));
+        zeromem (data, sizeof (float) * (size_t) (numToInsert * 4));
+    }
+
+    numBuffered += numToInsert;
+    readPos = 0;
+}
+
+float* PolyphaseResampler::getGroupBuffer (const int group) const noexcept
+{
+    return buffer + (size_t) (group * bufferSize * 4);
+}
+
+//==============================================================================
+void PolyphaseResampler::reset() noexcept
+{
+    numBuffered = getNumHistorySamples();
+    readPos = 0;
+    phase = 0;
+
+    buffer.clear ((size_t) (numGroups * bufferSize * 4));
+}
+
+int PolyphaseResampler::getNumHistorySamples() const noexcept
+{
+    return numTaps / 2 - 1;
+}
+
+void PolyphaseResampler::setHistory (const float* const* const precedingSamples, const int numChannelsToSet) noexcept
+{
+    jassert (numChannelsToSet <= numChannels);
+
+    const int numSamples = getNumHistorySamples();
+    jassert (readPos + numSamples <= numBuffered);
+
+    for (int channel = jmin (numChannels, numChannelsToSet); --channel >= 0;)
+    {
+        if (const float* const src = precedingSamples[channel])
+        {
+            float* const dest = getGroupBuffer (channel / 4) + readPos * 4 + (channel & 3);
+
+            for (int i = 0; i < numSamples; ++i)
+                dest[i * 4] = src[i];
+        }
+    }
+}
+
+void PolyphaseResampler::setSubSamplePosition (const double proportionOfInputSample) noexcept
+{
+    jassert (proportionOfInputSample >= 0 && proportionOfInputSample <= 1.0);
+
+    phase = jlimit ((int64) 0, phaseDenominator - 1,
+                    (int64) (proportionOfInputSample * (double) phaseDenominator + 0.5));
+}
+
+int64 PolyphaseResampler::getInputAdvance (const int numOutputSamples) const noexcept
+{
+    return (phase + numOutputSamples * phaseIncrement) / phaseDenominator;
+}
+
+int PolyphaseResampler::getNumInputSamplesRequired (const int numOutputSamples) const noexcept
+{
+    if (numOutputSamples <= 0)
+        return 0;
+
+    return (int) jmax ((int64) 0, readPos + getInputAdvance (numOutputSamples - 1) + numTaps - numBuffered);
+}
+
+int PolyphaseResampler::process (const float* const* const inputs, float* const* const outputs,
+                                 const int numChannelsToProcess, int numOutputSamples) noexcept
+{
+    using namespace PolyphaseResamplerHelpers;
+
+    jassert (numChannelsToProcess <= numChannels);
+
+    const int numToProcess = jmin (numChannelsToProcess, numChannels);
+    const float* const coefficients = table->getCoefficients();
+    int numInputsUsed = 0, numOutputsDone = 0;
+
+    while (numOutputSamples > 0)
+    {
+        // work out how many outputs can be made before the buffer would overflow..
+        const int64 maxAdvance = bufferSize - numTaps - readPos;
+        const int numThisTime = (int) jmin ((int64) numOutputSamples,
+                                            ((maxAdvance + 1) * phaseDenominator - phase - 1) / phaseIncrement + 1);
+
+        const int numInputsNeeded = getNumInputSamplesRequired (numThisTime);
+
+        for (int group = 0; group * 4 < numToProcess; ++group)
+        {
+            float* const data = getGroupBuffer (group);
+            float* dest = data + numBuffered * 4;
+            float* groupOutputs[4];
+
+            for (int lane = 0; lane < 4; ++lane)
+            {
+                const int channel = group * 4 + lane;
+                const float* const src = channel < numToProcess ? inputs[channel] : nullptr;
+                groupOutputs[lane] = channel < numToProcess ? outputs[channel] + numOutputsDone : nullptr;
+
+                if (src != nullptr)
+                {
+                    for (int i = 0; i < numInputsNeeded; ++i)
+                        dest[i * 4 + lane] = src[numInputsUsed + i];
+                }
+                else
+                {
+                    for (int i = 0; i < numInputsNeeded; ++i)
+                        dest[i * 4 + lane] = 0;
+                }
+            }
+
+           #if JUCE_USE_SSE_INTRINSICS || JUCE_USE_ARM_NEON
+            if (FloatVectorHelpers::isSIMDAvailable())
+            {
+                processGroup<SIMDOps> (data, readPos, phase, phaseIncrement, phaseDenominator,
+                                       coefficients, numTaps, table->numPhases, table->isInterpolated,
+                                       groupOutputs, numThisTime);
+                FloatVectorHelpers::mmEmpty();
+            }
+            else
+           #endif
+            {
+                processGroup<ScalarOps> (data, readPos, phase, phaseIncrement, phaseDenominator,
+                                         coefficients, numTaps, table->numPhases, table->isInterpolated,
+                                         groupOutputs, numThisTime);
+            }
+        }
+
+        numBuffered += numInputsNeeded;
+        readPos += (int) getInputAdvance (numThisTime);
+        phase = (phase + numThisTime * phaseIncrement) % phaseDenominator;
+
+        // shuffle the samples that are still needed down to the start of the buffer..
+        const int numToDiscard = jmin (readPos, numBuffered);
+
+        if (numToDiscard > 0)
+        {
+            for (int group = 0; group < numGroups; ++group)
+            {
+                float* const data = getGroupBuffer (group);
+                memmove (data, data + numToDiscard * 4, sizeof (float) * (size_t) ((numBuffered - numToDiscard) * 4));
+            }
+
+            numBuffered -= numToDiscard;
+            readPos -= numToDiscard;
+        }
+
+        numInputsUsed += numInputsNeeded;
+        numOutputsDone += numThisTime;
+        numOutputSamples -= numThisTime;
+    }
+
+    return numInputsUsed;
+}
@@ -0,0 +1,197 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+
+#ifndef __JUCE_POLYPHASERESAMPLER_JUCEHEADER__
+#define __JUCE_POLYPHASERESAMPLER_JUCEHEADER__
+
+
+//==============================================================================
+/**
+    A windowed-sinc resampler that converts a set of channels from one sample rate
+    to another.
+
+    This does a much more accurate job than the LagrangeInterpolator, at the cost
+    of more work per sample. Each output sample is a dot-product of the input with
+    one phase of a long windowed-sinc filter. The filter tables are calculated when
+    the ratio or quality is changed, and are shared between all the resamplers that
+    use the same settings, so that a large number of them can be created cheaply.
+
+    All the channels are worked on in a single pass: they're processed in groups
+    of four, interleaved so that on SSE or NEON targets one vector instruction
+    handles a sample of each channel.
+
+    If the ratio can be expressed as a fraction with a denominator of no more than
+    512 (e.g. 44.1KHz <-> 48KHz, or exact multiples like 2x and 4x), a table with a
+    phase for every output position is used, and the position is stepped exactly with
+    integer arithmetic. Other ratios interpolate between the nearest two phases of a
+    finer table.
+
+    The output is time-aligned with the input: the first output sample falls on the
+    first input sample, which means that the resampler needs to look ahead by about
+    half the length of its filter before it can produce anything. Use
+    getNumInputSamplesRequired() to find out how much input it needs for a block, and
+    when you get to the end of a stream, keep feeding it silence to flush out the last
+    few samples.
+
+    Like any other filter, the resampler is stateful, so call reset() if there's a
+    break in the continuity of the data you're giving it.
+
+    @see LagrangeInterpolator, ResamplingAudioSource
+*/
+class JUCE_API  PolyphaseResampler
+{
+public:
+    //==============================================================================
+    /** The different filter lengths that can be used. */
+    enum Quality
+    {
+        lowQuality = 0,     /**< A 16-tap filter. Fast, but with a fairly wide transition band. */
+        mediumQuality,      /**< A 32-tap filter. */
+        highQuality,        /**< A 64-tap filter. This is good enough for most purposes. */
+        bestQuality         /**< A 128-tap filter, for mastering-grade conversions. */
+    };
+
+    //==============================================================================
+    /** Creates a resampler for a number of channels.
+        The ratio is initially 1.0.
+    */
+    PolyphaseResampler (int numChannels = 2, Quality quality = highQuality);
+
+    /** Destructor. */
+    ~PolyphaseResampler();
+
+    //==============================================================================
+    /** Changes the number of channels.
+        This allocates memory and resets the resampler.
+    */
+    void setNumChannels (int numChannels);
+
+    /** Returns the number of channels that the resampler was given. */
+    int getNumChannels() const noexcept                         { return numChannels; }
+
+    /** Changes the quality setting.
+        This resets the resampler.
+    */
+    void setQuality (Quality newQuality);
+
+    /** Returns the current quality setting. */
+    Quality getQuality() const noexcept                         { return quality; }
+
+    //==============================================================================
+    /** Sets the number of input samples consumed for each output sample.
+
+        Values greater than 1.0 reduce the sample rate; less than 1.0 increase it.
+        The stream's position is kept, so this can be called while processing, although
+        if the ratio is one that hasn't been used before, a new filter table will need
+        to be calculated, which can take a few milliseconds.
+    */
+    void setResamplingRatio (double samplesInPerOutputSample);
+
+    /** Sets the ratio to convert between two sample rates.
+        If both rates are whole numbers, this is able to find the exact ratio between
+        them, which is better than calling setResamplingRatio() with a rounded value.
+    */
+    void setSampleRates (double sourceSampleRate, double destSampleRate);
+
+    /** Returns the number of input samples consumed for each output sample. */
+    double getResamplingRatio() const noexcept                  { return ratio; }
+
+    /** Returns true if the current ratio is being stepped exactly as a fraction, rather
+        than by interpolating between filter phases.
+    */
+    bool isUsingExactRatio() const noexcept;
+
+    /** Returns the number of taps that the current filter uses for each output sample. */
+    int getFilterLength() const noexcept;
+
+    //==============================================================================
+    /** Clears the resampler's state, ready to start a new stream.
+        After this, the next output sample will line up exactly with the next input
+        sample, and the input is treated as if it had been preceded by silence.
+    */
+    void reset() noexcept;
+
+    /** Returns the number of samples preceding the start of a stream that the
+        filter takes into account.
+        @see setHistory
+    */
+    int getNumHistorySamples() const noexcept;
+
+    /** Fills in the input that came before the start of the stream.
+
+        After calling reset(), you can call this to give the resampler the
+        getNumHistorySamples() samples of each channel that came immediately before
+        the next input sample, rather than leaving it to assume they were silent. This
+        is handy when starting to process from the middle of a file.
+    */
+    void setHistory (const float* const* precedingSamples, int numChannels) noexcept;
+
+    /** Moves the start position to a fraction of the way to the next input sample.
+        Call this after reset(). The value must be between 0 and 1.
+    */
+    void setSubSamplePosition (double proportionOfInputSample) noexcept;
+
+    //==============================================================================
+    /** Returns the number of input samples that the next call to process() will need
+        to produce a given number of output samples.
+    */
+    int getNumInputSamplesRequired (int numOutputSamples) const noexcept;
+
+    /** Resamples a block of data.
+
+        @param inputs               the input channels. Each of these must contain the
+                                    number of samples returned by getNumInputSamplesRequired()
+        @param outputs              the channels to write the results into
+        @param numChannels          the number of input and output channels, which must
+                                    not be more than getNumChannels()
+        @param numOutputSamples     the number of samples to produce
+
+        @returns the number of input samples that were used
+    */
+    int process (const float* const* inputs, float* const* outputs,
+                 int numChannels, int numOutputSamples) noexcept;
+
+private:
+    //==============================================================================
+    class FilterTable;
+
+    int numChannels, numGroups;
+    Quality quality;
+    double ratio;
+    ReferenceCountedObjectPtr<FilterTable> table;
+    HeapBlock<float> buffer;
+    int bufferSize, numTaps, numBuffered, readPos;
+    int64 phase, phaseIncrement, phaseDenominator;
+
+    void updateTable (int exactNumerator, int exactDenominator);
+    void setNumTaps (int newNumTaps) noexcept;
+    float* getGroupBuffer (int group) const noexcept;
+    int64 getInputAdvance (int numOutputSamples) const noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PolyphaseResampler)
+};
+
+
+#endif   // __JUCE_POLYPHASERESAMPLER_JUCEHEADER__
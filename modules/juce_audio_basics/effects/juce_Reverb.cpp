@@ -0,0 +1,291 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+
+namespace ReverbHelpers
+{
+   #if JUCE_USE_SSE_INTRINSICS
+    struct SIMDOps
+    {
+        typedef __m128 Lanes;
+
+        static forcedinline Lanes load1 (float v) noexcept                  { return _mm_load1_ps (&v); }
+        static forcedinline Lanes load (const float* v) noexcept            { return _mm_loadu_ps (v); }
+        static forcedinline void store (float* dest, Lanes a) noexcept      { _mm_storeu_ps (dest, a); }
+        static forcedinline Lanes add (Lanes a, Lanes b) noexcept           { return _mm_add_ps (a, b); }
+        static forcedinline Lanes mul (Lanes a, Lanes b) noexcept           { return _mm_mul_ps (a, b); }
+
+        static forcedinline Lanes snapToZero (Lanes a) noexcept
+        {
+            const Lanes magnitude = _mm_andnot_ps (load1 (-0.0f), a);
+            return _mm_and_ps (a, _mm_cmpge_ps (magnitude, load1 (1.0e-8f)));
+        }
+    };
+
+   #elif JUCE_USE_ARM_NEON
+    struct SIMDOps
+    {
+        typedef float32x4_t Lanes;
+
+        static forcedinline Lanes load1 (float v) noexcept                  { return vld1q_dup_f32 (&v); }
+        static forcedinline Lanes load (const float* v) noexcept            { return vld1q_f32 (v); }
+        static forcedinline void store (float* dest, Lanes a) noexcept      { vst1q_f32 (dest, a); }
+        static forcedinline Lanes add (Lanes a, Lanes b) noexcept           { return vaddq_f32 (a, b); }
+        static forcedinline Lanes mul (Lanes a, Lanes b) noexcept           { return vmulq_f32 (a, b); }
+
+        static forcedinline Lanes snapToZero (Lanes a) noexcept
+        {
+            return vreinterpretq_f32_u32 (vandq_u32 (vreinterpretq_u32_f32 (a),
+                                                     vcgeq_f32 (vabsq_f32 (a), load1 (1.0e-8f))));
+        }
+    };
+   #endif
+
+    static const short combTunings[] = { 1116, 1188, 1277, 1356, 1422, 1491, 1557, 1617 }; // (at 44100Hz)
+    static const short allPassTunings[] = { 556, 441, 341, 225 };
+    static const int stereoSpread = 23;
+}
+
+//==============================================================================
+void Reverb::CombBank::setSizes (const int* const delayLengths)
+{
+    int longest = 1;
+
+    for (int i = 0; i < numCombs; ++i)
+    {
+        delays[i] = jmax (1, delayLengths[i]);
+        longest = jmax (longest, delays[i]);
+    }
+
+    // (a power-of-two length lets the read positions wrap with a mask)
+    const int newLength = nextPowerOfTwo (longest + 1);
+
+    if (newLength != lineLength)
+    {
+        lineLength = newLength;
+        lines.malloc ((size_t) (lineLength * numCombs));
+    }
+
+    clear();
+}
+
+void Reverb::CombBank::clear() noexcept
+{
+    writeIndex = 0;
+    zeromem (last, sizeof (last));
+    lines.clear ((size_t) (lineLength * numCombs));
+}
+
+float Reverb::CombBank::process (const float input, const float damp, const float feedbackLevel) noexcept
+{
+    const int mask = lineLength - 1;
+    float outputs [numCombs];
+
+    for (int i = 0; i < numCombs; ++i)
+        outputs[i] = lines [((writeIndex - delays[i]) & mask) * numCombs + i];
+
+    float* const frame = lines + writeIndex * numCombs;
+    writeIndex = (writeIndex + 1) & mask;
+
+   #if JUCE_USE_SSE_INTRINSICS || JUCE_USE_ARM_NEON
+    using namespace ReverbHelpers;
+    typedef SIMDOps::Lanes Lanes;
+
+    const Lanes damp1 = SIMDOps::load1 (damp);
+    const Lanes damp2 = SIMDOps::load1 (1.0f - damp);
+    const Lanes fb    = SIMDOps::load1 (feedbackLevel);
+    const Lanes in    = SIMDOps::load1 (input);
+
+    const Lanes out0 = SIMDOps::load (outputs);
+    const Lanes out1 = SIMDOps::load (outputs + 4);
+
+    const Lanes last0 = SIMDOps::snapToZero (SIMDOps::add (SIMDOps::mul (out0, damp2), SIMDOps::mul (SIMDOps::load (last), damp1)));
+    const Lanes last1 = SIMDOps::snapToZero (SIMDOps::add (SIMDOps::mul (out1, damp2), SIMDOps::mul (SIMDOps::load (last + 4), damp1)));
+    SIMDOps::store (last, last0);
+    SIMDOps::store (last + 4, last1);
+
+    SIMDOps::store (frame,     SIMDOps::snapToZero (SIMDOps::add (in, SIMDOps::mul (last0, fb))));
+    SIMDOps::store (frame + 4, SIMDOps::snapToZero (SIMDOps::add (in, SIMDOps::mul (last1, fb))));
+
+    SIMDOps::store (outputs, SIMDOps::add (out0, out1));
+    return (outputs[0] + outputs[1]) + (outputs[2] + outputs[3]);
+   #else
+    const float damp2 = 1.0f - damp;
+    float total = 0;
+
+    for (int i = 0; i < numCombs; ++i)
+    {
+        float l = outputs[i] * damp2 + last[i] * damp;
+        JUCE_UNDENORMALISE (l);
+        last[i] = l;
+
+        float temp = input + l * feedbackLevel;
+        JUCE_UNDENORMALISE (temp);
+        frame[i] = temp;
+
+        total += outputs[i];
+    }
+
+    return total;
+   #endif
+}
+
+//==============================================================================
+Reverb::Reverb()
+{
+    setParameters (Parameters());
+    setSampleRate (44100.0);
+}
+
+Reverb::~Reverb()
+{
+}
+
+void Reverb::setParameters (const Parameters& newParams)
+{
+    const float wetScaleFactor = 3.0f;
+    const float dryScaleFactor = 2.0f;
+
+    const float wet = newParams.wetLevel * wetScaleFactor;
+    wet1.setValue (wet * (newParams.width * 0.5f + 0.5f));
+    wet2.setValue (wet * (1.0f - newParams.width) * 0.5f);
+    dry.setValue (newParams.dryLevel * dryScaleFactor);
+    gain.setValue (isFrozen (newParams.freezeMode) ? 0.0f : 0.015f);
+    parameters = newParams;
+    shouldUpdateDamping = true;
+}
+
+void Reverb::setSampleRate (const double sampleRate)
+{
+    using namespace ReverbHelpers;
+    jassert (sampleRate > 0);
+
+    const int intSampleRate = (int) sampleRate;
+    int combSizes [numChannels][numCombs];
+
+    for (int i = 0; i < numCombs; ++i)
+    {
+        combSizes[0][i] = (intSampleRate * combTunings[i]) / 44100;
+        combSizes[1][i] = (intSampleRate * (combTunings[i] + stereoSpread)) / 44100;
+    }
+
+    for (int j = 0; j < numChannels; ++j)
+        combs[j].setSizes (combSizes[j]);
+
+    for (int i = 0; i < numAllPasses; ++i)
+    {
+        allPass[0][i].setSize ((intSampleRate * allPassTunings[i]) / 44100);
+        allPass[1][i].setSize ((intSampleRate * (allPassTunings[i] + stereoSpread)) / 44100);
+    }
+
+    // (this also makes all the values jump straight to their targets)
+    updateDamping();
+
+    LinearSmoothedValue* const values[] = { &gain, &wet1, &wet2, &dry, &damping, &feedback };
+
+    for (int i = 0; i < numElementsInArray (values); ++i)
+        values[i]->reset (sampleRate, 0.05);
+}
+
+void Reverb::reset()
+{
+    for (int j = 0; j < numChannels; ++j)
+    {
+        combs[j].clear();
+
+        for (int i = 0; i < numAllPasses; ++i)
+            allPass[j][i].clear();
+    }
+}
+
+void Reverb::updateDamping() noexcept
+{
+    const float roomScaleFactor = 0.28f;
+    const float roomOffset = 0.7f;
+    const float dampScaleFactor = 0.4f;
+
+    shouldUpdateDamping = false;
+
+    if (isFrozen (parameters.freezeMode))
+    {
+        damping.setValue (0.0f);
+        feedback.setValue (1.0f);
+    }
+    else
+    {
+        damping.setValue (parameters.damping * dampScaleFactor);
+        feedback.setValue (parameters.roomSize * roomScaleFactor + roomOffset);
+    }
+}
+
+//==============================================================================
+void Reverb::processStereo (float* const left, float* const right, const int numSamples) noexcept
+{
+    jassert (left != nullptr && right != nullptr);
+
+    if (shouldUpdateDamping)
+        updateDamping();
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float input = (left[i] + right[i]) * gain.getNextValue();
+        const float damp = damping.getNextValue();
+        const float fb = feedback.getNextValue();
+
+        float outL = combs[0].process (input, damp, fb);
+        float outR = combs[1].process (input, damp, fb);
+
+        for (int j = 0; j < numAllPasses; ++j)  // run the allpass filters in series
+        {
+            outL = allPass[0][j].process (outL);
+            outR = allPass[1][j].process (outR);
+        }
+
+        const float w1 = wet1.getNextValue();
+        const float w2 = wet2.getNextValue();
+        const float d  = dry.getNextValue();
+
+        left[i]  = outL * w1 + outR * w2 + left[i]  * d;
+        right[i] = outR * w1 + outL * w2 + right[i] * d;
+    }
+}
+
+void Reverb::processMono (float* const samples, const int numSamples) noexcept
+{
+    jassert (samples != nullptr);
+
+    if (shouldUpdateDamping)
+        updateDamping();
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float input = samples[i] * gain.getNextValue();
+        float output = combs[0].process (input, damping.getNextValue(), feedback.getNextValue());
+
+        for (int j = 0; j < numAllPasses; ++j)  // run the allpass filters in series
+            output = allPass[0][j].process (output);
+
+        samples[i] = output * wet1.getNextValue() + input * dry.getNextValue();
+    }
+}
@@ -34,17 +34,21 @@
     Use setSampleRate() to prepare it, and then call processStereo() or processMono() to
     apply the reverb to your audio data.
 
+    The eight comb filters of each channel share one interleaved block of delay-line
+    memory, so that on SSE or NEON targets they can all be updated with a couple of
+    vector instructions per sample. Changes to the parameters are smoothed over a short
+    ramp, so they can be moved during playback without clicks.
+
     @see ReverbAudioSource
 */
-class Reverb
+class JUCE_API  Reverb
 {
 public:
     //==============================================================================
-    Reverb()
-    {
-        setParameters (Parameters());
-        setSampleRate (44100.0);
-    }
+    Reverb();
+
+    /** Destructor. */
+    ~Reverb();
 
     //==============================================================================
     /** Holds the parameters being used by a Reverb object. */
@@ -73,202 +77,58 @@ public:
     const Parameters& getParameters() const noexcept    { return parameters; }
 
     /** Applies a new set of parameters to the reverb.
+        The levels, room size and damping will glide to their new values over about 50ms.
         Note that this doesn't attempt to lock the reverb, so if you call this in parallel with
         the process method, you may get artifacts.
     */
-    void setParameters (const Parameters& newParams)
-    {
-        const float wetScaleFactor = 3.0f;
-        const float dryScaleFactor = 2.0f;
-
-        const float wet = newParams.wetLevel * wetScaleFactor;
-        wet1 = wet * (newParams.width * 0.5f + 0.5f);
-        wet2 = wet * (1.0f - newParams.width) * 0.5f;
-        dry = newParams.dryLevel * dryScaleFactor;
-        gain = isFrozen (newParams.freezeMode) ? 0.0f : 0.015f;
-        parameters = newParams;
-        shouldUpdateDamping = true;
-    }
+    void setParameters (const Parameters& newParams);
 
     //==============================================================================
     /** Sets the sample rate that will be used for the reverb.
         You must call this before the process methods, in order to tell it the correct sample rate.
     */
-    void setSampleRate (const double sampleRate)
-    {
-        jassert (sampleRate > 0);
-
-        static const short combTunings[] = { 1116, 1188, 1277, 1356, 1422, 1491, 1557, 1617 }; // (at 44100Hz)
-        static const short allPassTunings[] = { 556, 441, 341, 225 };
-        const int stereoSpread = 23;
-        const int intSampleRate = (int) sampleRate;
-
-        for (int i = 0; i < numCombs; ++i)
-        {
-            comb[0][i].setSize ((intSampleRate * combTunings[i]) / 44100);
-            comb[1][i].setSize ((intSampleRate * (combTunings[i] + stereoSpread)) / 44100);
-        }
-
-        for (int i = 0; i < numAllPasses; ++i)
-        {
-            allPass[0][i].setSize ((intSampleRate * allPassTunings[i]) / 44100);
-            allPass[1][i].setSize ((intSampleRate * (allPassTunings[i] + stereoSpread)) / 44100);
-        }
-
-        shouldUpdateDamping = true;
-    }
+    void setSampleRate (double sampleRate);
 
     /** Clears the reverb's buffers. */
-    void reset()
-    {
-        for (int j = 0; j < numChannels; ++j)
-        {
-            for (int i = 0; i < numCombs; ++i)
-                comb[j][i].clear();
-
-            for (int i = 0; i < numAllPasses; ++i)
-                allPass[j][i].clear();
-        }
-    }
+    void reset();
 
     //==============================================================================
     /** Applies the reverb to two stereo channels of audio data. */
-    void processStereo (float* const left, float* const right, const int numSamples) noexcept
-    {
-        jassert (left != nullptr && right != nullptr);
-
-        if (shouldUpdateDamping)
-            updateDamping();
-
-        for (int i = 0; i < numSamples; ++i)
-        {
-            const float input = (left[i] + right[i]) * gain;
-            float outL = 0, outR = 0;
-
-            for (int j = 0; j < numCombs; ++j)  // accumulate the comb filters in parallel
-            {
-                outL += comb[0][j].process (input);
-                outR += comb[1][j].process (input);
-            }
-
-            for (int j = 0; j < numAllPasses; ++j)  // run the allpass filters in series
-            {
-                outL = allPass[0][j].process (outL);
-                outR = allPass[1][j].process (outR);
-            }
-
-            left[i]  = outL * wet1 + outR * wet2 + left[i]  * dry;
-            right[i] = outR * wet1 + outL * wet2 + right[i] * dry;
-        }
-    }
+    void processStereo (float* left, float* right, int numSamples) noexcept;
 
     /** Applies the reverb to a single mono channel of audio data. */
-    void processMono (float* const samples, const int numSamples) noexcept
-    {
-        jassert (samples != nullptr);
-
-        if (shouldUpdateDamping)
-            updateDamping();
-
-        for (int i = 0; i < numSamples; ++i)
-        {
-            const float input = samples[i] * gain;
-            float output = 0;
-
-            for (int j = 0; j < numCombs; ++j)  // accumulate the comb filters in parallel
-                output += comb[0][j].process (input);
-
-            for (int j = 0; j < numAllPasses; ++j)  // run the allpass filters in series
-                output = allPass[0][j].process (output);
-
-            samples[i] = output * wet1 + input * dry;
-        }
-    }
+    void processMono (float* samples, int numSamples) noexcept;
 
 private:
     //==============================================================================
-    Parameters parameters;
-
-    volatile bool shouldUpdateDamping;
-    float gain, wet1, wet2, dry;
-
-    inline static bool isFrozen (const float freezeMode) noexcept  { return freezeMode >= 0.5f; }
-
-    void updateDamping() noexcept
-    {
-        const float roomScaleFactor = 0.28f;
-        const float roomOffset = 0.7f;
-        const float dampScaleFactor = 0.4f;
-
-        shouldUpdateDamping = false;
-
-        if (isFrozen (parameters.freezeMode))
-            setDamping (0.0f, 1.0f);
-        else
-            setDamping (parameters.damping * dampScaleFactor,
-                        parameters.roomSize * roomScaleFactor + roomOffset);
-    }
-
-    void setDamping (const float dampingToUse, const float roomSizeToUse) noexcept
-    {
-        for (int j = 0; j < numChannels; ++j)
-            for (int i = numCombs; --i >= 0;)
-                comb[j][i].setFeedbackAndDamp (roomSizeToUse, dampingToUse);
-    }
+    enum { numCombs = 8, numAllPasses = 4, numChannels = 2 };
 
     //==============================================================================
-    class CombFilter
+    /** The parallel comb filters for one channel.
+
+        Each frame of the delay-line memory holds one value for each comb, and all the
+        combs write to the same frame on each sample, each one reading back the value that
+        it wrote its own delay-length ago. So the writes and the filter arithmetic
+        can be done in vector lanes, and only the reads have to be gathered one by one.
+    */
+    class CombBank
     {
     public:
-        CombFilter() noexcept
-            : bufferSize (0), bufferIndex (0),
-              feedback (0), last (0), damp1 (0), damp2 (0)
-        {}
-
-        void setSize (const int size)
-        {
-            if (size != bufferSize)
-            {
-                bufferIndex = 0;
-                buffer.malloc ((size_t) size);
-                bufferSize = size;
-            }
-
-            clear();
-        }
-
-        void clear() noexcept
-        {
-            last = 0;
-            buffer.clear ((size_t) bufferSize);
-        }
+        CombBank() noexcept  : lineLength (0), writeIndex (0) {}
 
-        void setFeedbackAndDamp (const float f, const float d) noexcept
-        {
-            damp1 = d;
-            damp2 = 1.0f - d;
-            feedback = f;
-        }
+        void setSizes (const int* delayLengths);
+        void clear() noexcept;
 
-        inline float process (const float input) noexcept
-        {
-            const float output = buffer [bufferIndex];
-            last = (output * damp2) + (last * damp1);
-            JUCE_UNDENORMALISE (last);
-
-            float temp = input + (last * feedback);
-            JUCE_UNDENORMALISE (temp);
-            buffer [bufferIndex] = temp;
-            bufferIndex = (bufferIndex + 1) % bufferSize;
-            return output;
-        }
+        /** Feeds a sample into all the combs, and returns the sum of their outputs. */
+        float process (float input, float damp, float feedback) noexcept;
 
     private:
-        HeapBlock<float> buffer;
-        int bufferSize, bufferIndex;
-        float feedback, last, damp1, damp2;
+        HeapBlock<float> lines;
+        int delays [numCombs];
+        float last [numCombs];
+        int lineLength, writeIndex;
 
-        JUCE_DECLARE_NON_COPYABLE (CombFilter)
+        JUCE_DECLARE_NON_COPYABLE (CombBank)
     };
 
     //==============================================================================
@@ -300,7 +160,10 @@ private:
             float temp = input + (bufferedValue * 0.5f);
             JUCE_UNDENORMALISE (temp);
             buffer [bufferIndex] = temp;
-            bufferIndex = (bufferIndex + 1) % bufferSize;
+
+            if (++bufferIndex >= bufferSize)
+                bufferIndex = 0;
+
             return bufferedValue - input;
         }
 
@@ -311,11 +174,18 @@ private:
         JUCE_DECLARE_NON_COPYABLE (AllPassFilter)
     };
 
-    enum { numCombs = 8, numAllPasses = 4, numChannels = 2 };
+    //==============================================================================
+    Parameters parameters;
+
+    volatile bool shouldUpdateDamping;
+    LinearSmoothedValue gain, wet1, wet2, dry, damping, feedback;
 
-    CombFilter comb [numChannels][numCombs];
+    CombBank combs [numChannels];
     AllPassFilter allPass [numChannels][numAllPasses];
 
+    inline static bool isFrozen (const float freezeMode) noexcept  { return freezeMode >= 0.5f; }
+    void updateDamping() noexcept;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Reverb)
 };
 
@@ -0,0 +1,284 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+/*  Runs the tail convolver: each time a block of input is handed over, it's convolved
+    while the audio thread carries on with the next block.
+*/
+class ZeroLatencyConvolver::TailThread  : public Thread
+{
+public:
+    TailThread (ZeroLatencyConvolver& owner_)
+        : Thread ("Convolver tail"),
+          owner (owner_),
+          blockInput ((size_t) owner_.tailBlockSize),
+          blockOutput ((size_t) owner_.tailBlockSize, true),
+          busy (false)
+    {
+        startThread (8);
+    }
+
+    ~TailThread()
+    {
+        signalThreadShouldExit();
+        blockReady.signal();
+        stopThread (5000);
+    }
+
+    // Swaps the results of the last block for a new block of input.
+    void exchange (float* input, float* output) noexcept
+    {
+        waitUntilIdle();
+
+        FloatVectorOperations::copy (output, blockOutput, owner.tailBlockSize);
+        FloatVectorOperations::copy (blockInput, input, owner.tailBlockSize);
+
+        busy = true;
+        blockReady.signal();
+    }
+
+    void waitUntilIdle() noexcept
+    {
+        while (busy)
+            blockDone.wait (100);
+    }
+
+    void clear() noexcept
+    {
+        waitUntilIdle();
+        FloatVectorOperations::clear (blockOutput, owner.tailBlockSize);
+    }
+
+    void run()
+    {
+        while (! threadShouldExit())
+        {
+            blockReady.wait (500);
+
+            if (busy)
+            {
+                owner.tail->process (blockInput, blockOutput, owner.tailBlockSize);
+                busy = false;
+                blockDone.signal();
+            }
+        }
+    }
+
+private:
+    ZeroLatencyConvolver& owner;
+    HeapBlock<float> blockInput, blockOutput;
+    WaitableEvent blockReady, blockDone;
+    volatile bool busy;
+
+    JUCE_DECLARE_NON_COPYABLE (TailThread)
+};
+
+//==============================================================================
+ZeroLatencyConvolver::ZeroLatencyConvolver (const int headSize_, const int tailBlockSize_)
+    : headSize (headSize_),
+      tailBlockSize (tailBlockSize_),
+      impulseResponseLength (0),
+      historyPosition (0),
+      tailPosition (0),
+      reversedHead ((size_t) headSize_, true),
+      history ((size_t) headSize_ * 2, true),
+      inputChunk ((size_t) headSize_),
+      middleOutput ((size_t) headSize_),
+      tailInput ((size_t) tailBlockSize_, true),
+      tailOutput ((size_t) tailBlockSize_, true),
+      middle (headSize_)
+{
+    // the sizes must both be powers of two, and the tail blocks bigger than the head!
+    jassert (isPowerOfTwo (headSize) && isPowerOfTwo (tailBlockSize) && tailBlockSize > headSize);
+}
+
+ZeroLatencyConvolver::~ZeroLatencyConvolver()
+{
+    tailThread = nullptr;
+}
+
+//==============================================================================
+void ZeroLatencyConvolver::setImpulseResponse (const float* const samples, const int numSamples)
+{
+    tailThread = nullptr;
+    tail = nullptr;
+
+    impulseResponseLength = jmax (0, numSamples);
+
+    // The head is stored backwards, so that each output sample is a dot-product with
+    // the most recent headSize input samples.
+    const int headLength = jmin (headSize, impulseResponseLength);
+    FloatVectorOperations::clear (reversedHead, headSize);
+
+    for (int i = 0; i < headLength; ++i)
+        reversedHead [headSize - 1 - i] = samples[i];
+
+    const int tailStart = tailBlockSize * 3;
+    const int middleEnd = jmin (tailStart, impulseResponseLength);
+    middle.setImpulseResponse (samples + headSize, jmax (0, middleEnd - headSize));
+
+    if (impulseResponseLength > tailStart)
+    {
+        tail = new PartitionedConvolver (tailBlockSize);
+        tail->setImpulseResponse (samples + tailStart, impulseResponseLength - tailStart);
+        tailThread = new TailThread (*this);
+    }
+
+    reset();
+}
+
+void ZeroLatencyConvolver::reset()
+{
+    if (tailThread != nullptr)
+        tailThread->clear();
+
+    if (tail != nullptr)
+        tail->reset();
+
+    middle.reset();
+
+    FloatVectorOperations::clear (history, headSize * 2);
+    FloatVectorOperations::clear (tailInput, tailBlockSize);
+    FloatVectorOperations::clear (tailOutput, tailBlockSize);
+    historyPosition = 0;
+    tailPosition = 0;
+}
+
+//==============================================================================
+void ZeroLatencyConvolver::process (const float* input, float* output, int numSamples) noexcept
+{
+    while (numSamples > 0)
+    {
+        // (the chunks never cross the end of a tail block, which is a multiple of the head size)
+        const int num = jmin (numSamples, headSize - (tailPosition & (headSize - 1)));
+
+        FloatVectorOperations::copy (inputChunk, input, num);
+
+        processHead (inputChunk, output, num);
+
+        if (middle.getImpulseResponseLength() > 0)
+        {
+            middle.process (inputChunk, middleOutput, num);
+            FloatVectorOperations::add (output, middleOutput, num);
+        }
+
+        if (tail != nullptr)
+        {
+            FloatVectorOperations::copy (tailInput + tailPosition, inputChunk, num);
+            FloatVectorOperations::add (output, tailOutput + tailPosition, num);
+        }
+
+        tailPosition += num;
+
+        if (tailPosition == tailBlockSize)
+            finishTailBlock();
+
+        input += num;
+        output += num;
+        numSamples -= num;
+    }
+}
+
+void ZeroLatencyConvolver::processHead (const float* input, float* output, const int numSamples) noexcept
+{
+    for (int i = 0; i < numSamples; ++i)
+    {
+        // each sample is written twice, so the last headSize samples are always contiguous
+        history [historyPosition] = history [historyPosition + headSize] = input[i];
+
+        if (++historyPosition >= headSize)
+            historyPosition = 0;
+
+        output[i] = (float) FloatVectorOperations::dotProduct (history + historyPosition, reversedHead, headSize);
+    }
+}
+
+/*  The tail section of the impulse response starts 3 blocks in. One block of that
+    covers the latency of the tail's PartitionedConvolver, one the time spent collecting
+    a block of input, and one the time that the background thread has to process it.
+*/
+void ZeroLatencyConvolver::finishTailBlock() noexcept
+{
+    tailPosition = 0;
+
+    if (tailThread != nullptr)
+        tailThread->exchange (tailInput, tailOutput);
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class ZeroLatencyConvolverTests  : public UnitTest
+{
+public:
+    ZeroLatencyConvolverTests() : UnitTest ("ZeroLatencyConvolver") {}
+
+    void runTest()
+    {
+        beginTest ("Convolution");
+
+        Random r (0x5678);
+        const int numSamples = 6000;
+        const int impulseLengths[] = { 1, 20, 200, 1000, 3000 };
+
+        for (int j = 0; j < numElementsInArray (impulseLengths); ++j)
+        {
+            const int impulseLength = impulseLengths[j];
+            HeapBlock<float> impulse (impulseLength), input (numSamples), output (numSamples);
+
+            for (int i = 0; i < impulseLength; ++i)
+                impulse[i] = (r.nextFloat() * 2.0f - 1.0f) / std::sqrt ((float) impulseLength);
+
+            for (int i = 0; i < numSamples; ++i)
+                input[i] = r.nextFloat() * 2.0f - 1.0f;
+
+            ZeroLatencyConvolver convolver (16, 128);
+            convolver.setImpulseResponse (impulse, impulseLength);
+
+            for (int pos = 0; pos < numSamples;)
+            {
+                const int num = jmin (numSamples - pos, r.nextInt (400));
+                convolver.process (input + pos, output + pos, num);
+                pos += num;
+            }
+
+            float maxError = 0;
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                double expected = 0;
+
+                for (int k = jmin (i, impulseLength - 1); k >= 0; --k)
+                    expected += impulse[k] * (double) input [i - k];
+
+                maxError = jmax (maxError, std::abs ((float) expected - output[i]));
+            }
+
+            expect (maxError < 1.0e-4f);
+        }
+    }
+};
+
+static ZeroLatencyConvolverTests zeroLatencyConvolverTests;
+
+#endif
@@ -0,0 +1,101 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_ZEROLATENCYCONVOLVER_JUCEHEADER__
+#define __JUCE_ZEROLATENCYCONVOLVER_JUCEHEADER__
+
+#include "juce_PartitionedConvolver.h"
+
+
+//==============================================================================
+/**
+    Convolves a stream of samples with an impulse response, without adding any latency.
+
+    The impulse response is split into three sections, each handled in a different way:
+    - The first headSize samples are applied directly, as an FIR filter.
+    - The next section, up to 3 * tailBlockSize, goes through a PartitionedConvolver with
+      a block size of headSize. Its latency is exactly covered by the head section.
+    - The rest goes through a PartitionedConvolver with a block size of tailBlockSize,
+      which runs on a background thread. It's given a whole block's worth of time to
+      process each block, so it can use large, efficient FFTs without holding up the
+      audio thread.
+
+    This makes it practical to use impulse responses that are several seconds long in
+    real time. If the background thread does fall behind (e.g. when rendering faster than
+    real-time), process() waits for it, so the results are always exact.
+
+    Like PartitionedConvolver, this isn't thread-safe: don't load a new impulse response
+    while another thread is calling process().
+
+    @see PartitionedConvolver, ConvolutionReverb
+*/
+class JUCE_API  ZeroLatencyConvolver
+{
+public:
+    //==============================================================================
+    /** Creates a convolver.
+        Both sizes must be powers of two, and the tail block size must be larger than
+        the head size.
+    */
+    ZeroLatencyConvolver (int headSize = 64, int tailBlockSize = 1024);
+
+    /** Destructor. */
+    ~ZeroLatencyConvolver();
+
+    //==============================================================================
+    /** Loads a new impulse response, and resets the convolver's state.
+        This allocates memory, and may start or stop the background thread.
+    */
+    void setImpulseResponse (const float* samples, int numSamples);
+
+    /** Returns the length of the current impulse response. */
+    int getImpulseResponseLength() const noexcept           { return impulseResponseLength; }
+
+    /** Clears the convolver's history, without changing its impulse response. */
+    void reset();
+
+    /** Convolves some samples. The input and output may point to the same data. */
+    void process (const float* input, float* output, int numSamples) noexcept;
+
+private:
+    //==============================================================================
+    class TailThread;
+    friend class TailThread;
+
+    const int headSize, tailBlockSize;
+    int impulseResponseLength, historyPosition, tailPosition;
+    HeapBlock<float> reversedHead, history, inputChunk, middleOutput;
+    HeapBlock<float> tailInput, tailOutput;
+    PartitionedConvolver middle;
+    ScopedPointer<PartitionedConvolver> tail;
+    ScopedPointer<TailThread> tailThread;
+
+    void processHead (const float* input, float* output, int numSamples) noexcept;
+    void finishTailBlock() noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ZeroLatencyConvolver)
+};
+
+
+#endif   // __JUCE_ZEROLATENCYCONVOLVER_JUCEHEADER__
@@ -48,6 +48,16 @@
  #include <emmintrin.h>
 #endif
 
+#ifndef JUCE_USE_ARM_NEON
+ #if defined (__ARM_NEON__) || defined (__ARM_NEON)
+  #define JUCE_USE_ARM_NEON 1
+ #endif
+#endif
+
+#if JUCE_USE_ARM_NEON
+ #include <arm_neon.h>
+#endif
+
 #if JUCE_MAC || JUCE_IOS
  #define JUCE_USE_VDSP_FRAMEWORK 1
  #include <Accelerate/Accelerate.h>
@@ -59,22 +69,40 @@ namespace juce
 // START_AUTOINCLUDE buffers/*.cpp, effects/*.cpp, midi/*.cpp, sources/*.cpp, synthesisers/*.cpp
 #include "buffers/juce_AudioDataConverters.cpp"
 #include "buffers/juce_AudioSampleBuffer.cpp"
+#include "buffers/juce_DoubleAudioSampleBuffer.cpp"
 #include "buffers/juce_FloatVectorOperations.cpp"
+#include "buffers/juce_SharedMemoryAudioChannel.cpp"
+#include "effects/juce_ConvolutionReverb.cpp"
+#include "effects/juce_FFT.cpp"
 #include "effects/juce_IIRFilter.cpp"
+#include "effects/juce_IIRFilterCascade.cpp"
 #include "effects/juce_LagrangeInterpolator.cpp"
+#include "effects/juce_PartitionedConvolver.cpp"
+#include "effects/juce_PolyphaseResampler.cpp"
+#include "effects/juce_Reverb.cpp"
+#include "effects/juce_ZeroLatencyConvolver.cpp"
 #include "midi/juce_MidiBuffer.cpp"
 #include "midi/juce_MidiFile.cpp"
+#include "midi/juce_MidiFileReader.cpp"
 #include "midi/juce_MidiKeyboardState.cpp"
 #include "midi/juce_MidiMessage.cpp"
 #include "midi/juce_MidiMessageSequence.cpp"
 #include "sources/juce_BufferingAudioSource.cpp"
 #include "sources/juce_ChannelRemappingAudioSource.cpp"
+#include "sources/juce_ConvolutionAudioSource.cpp"
+#include "sources/juce_DiskStreamingEngine.cpp"
 #include "sources/juce_IIRFilterAudioSource.cpp"
+#include "sources/juce_LockFreeMixerAudioSource.cpp"
 #include "sources/juce_MixerAudioSource.cpp"
+#include "sources/juce_NetworkAudioStream.cpp"
 #include "sources/juce_ResamplingAudioSource.cpp"
 #include "sources/juce_ReverbAudioSource.cpp"
+#include "sources/juce_RoutingMatrixAudioSource.cpp"
+#include "sources/juce_SpectrumAnalyserAudioSource.cpp"
+#include "sources/juce_StreamingAudioSource.cpp"
 #include "sources/juce_ToneGeneratorAudioSource.cpp"
 #include "synthesisers/juce_Synthesiser.cpp"
+#include "utilities/juce_AudioCallbackProfiler.cpp"
 // END_AUTOINCLUDE
 
 }
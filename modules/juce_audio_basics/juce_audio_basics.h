@@ -31,34 +31,64 @@
 namespace juce
 {
 
-// START_AUTOINCLUDE buffers, effects, midi, sources, synthesisers
+// START_AUTOINCLUDE buffers, effects, midi, sources, synthesisers, utilities
 #ifndef __JUCE_AUDIODATACONVERTERS_JUCEHEADER__
  #include "buffers/juce_AudioDataConverters.h"
 #endif
 #ifndef __JUCE_AUDIOSAMPLEBUFFER_JUCEHEADER__
  #include "buffers/juce_AudioSampleBuffer.h"
 #endif
+#ifndef __JUCE_DOUBLEAUDIOSAMPLEBUFFER_JUCEHEADER__
+ #include "buffers/juce_DoubleAudioSampleBuffer.h"
+#endif
 #ifndef __JUCE_FLOATVECTOROPERATIONS_JUCEHEADER__
  #include "buffers/juce_FloatVectorOperations.h"
 #endif
+#ifndef __JUCE_SHAREDMEMORYAUDIOCHANNEL_JUCEHEADER__
+ #include "buffers/juce_SharedMemoryAudioChannel.h"
+#endif
+#ifndef __JUCE_CONVOLUTIONREVERB_JUCEHEADER__
+ #include "effects/juce_ConvolutionReverb.h"
+#endif
 #ifndef __JUCE_DECIBELS_JUCEHEADER__
  #include "effects/juce_Decibels.h"
 #endif
+#ifndef __JUCE_FFT_JUCEHEADER__
+ #include "effects/juce_FFT.h"
+#endif
 #ifndef __JUCE_IIRFILTER_JUCEHEADER__
  #include "effects/juce_IIRFilter.h"
 #endif
+#ifndef __JUCE_IIRFILTERCASCADE_JUCEHEADER__
+ #include "effects/juce_IIRFilterCascade.h"
+#endif
 #ifndef __JUCE_LAGRANGEINTERPOLATOR_JUCEHEADER__
  #include "effects/juce_LagrangeInterpolator.h"
 #endif
+#ifndef __JUCE_LINEARSMOOTHEDVALUE_JUCEHEADER__
+ #include "effects/juce_LinearSmoothedValue.h"
+#endif
+#ifndef __JUCE_PARTITIONEDCONVOLVER_JUCEHEADER__
+ #include "effects/juce_PartitionedConvolver.h"
+#endif
+#ifndef __JUCE_POLYPHASERESAMPLER_JUCEHEADER__
+ #include "effects/juce_PolyphaseResampler.h"
+#endif
 #ifndef __JUCE_REVERB_JUCEHEADER__
  #include "effects/juce_Reverb.h"
 #endif
+#ifndef __JUCE_ZEROLATENCYCONVOLVER_JUCEHEADER__
+ #include "effects/juce_ZeroLatencyConvolver.h"
+#endif
 #ifndef __JUCE_MIDIBUFFER_JUCEHEADER__
  #include "midi/juce_MidiBuffer.h"
 #endif
 #ifndef __JUCE_MIDIFILE_JUCEHEADER__
  #include "midi/juce_MidiFile.h"
 #endif
+#ifndef __JUCE_MIDIFILEREADER_JUCEHEADER__
+ #include "midi/juce_MidiFileReader.h"
+#endif
 #ifndef __JUCE_MIDIKEYBOARDSTATE_JUCEHEADER__
  #include "midi/juce_MidiKeyboardState.h"
 #endif
@@ -77,12 +107,24 @@ namespace juce
 #ifndef __JUCE_CHANNELREMAPPINGAUDIOSOURCE_JUCEHEADER__
  #include "sources/juce_ChannelRemappingAudioSource.h"
 #endif
+#ifndef __JUCE_CONVOLUTIONAUDIOSOURCE_JUCEHEADER__
+ #include "sources/juce_ConvolutionAudioSource.h"
+#endif
+#ifndef __JUCE_DISKSTREAMINGENGINE_JUCEHEADER__
+ #include "sources/juce_DiskStreamingEngine.h"
+#endif
 #ifndef __JUCE_IIRFILTERAUDIOSOURCE_JUCEHEADER__
  #include "sources/juce_IIRFilterAudioSource.h"
 #endif
+#ifndef __JUCE_LOCKFREEMIXERAUDIOSOURCE_JUCEHEADER__
+ #include "sources/juce_LockFreeMixerAudioSource.h"
+#endif
 #ifndef __JUCE_MIXERAUDIOSOURCE_JUCEHEADER__
  #include "sources/juce_MixerAudioSource.h"
 #endif
+#ifndef __JUCE_NETWORKAUDIOSTREAM_JUCEHEADER__
+ #include "sources/juce_NetworkAudioStream.h"
+#endif
 #ifndef __JUCE_POSITIONABLEAUDIOSOURCE_JUCEHEADER__
  #include "sources/juce_PositionableAudioSource.h"
 #endif
@@ -92,12 +134,24 @@ namespace juce
 #ifndef __JUCE_REVERBAUDIOSOURCE_JUCEHEADER__
  #include "sources/juce_ReverbAudioSource.h"
 #endif
+#ifndef __JUCE_ROUTINGMATRIXAUDIOSOURCE_JUCEHEADER__
+ #include "sources/juce_RoutingMatrixAudioSource.h"
+#endif
+#ifndef __JUCE_SPECTRUMANALYSERAUDIOSOURCE_JUCEHEADER__
+ #include "sources/juce_SpectrumAnalyserAudioSource.h"
+#endif
+#ifndef __JUCE_STREAMINGAUDIOSOURCE_JUCEHEADER__
+ #include "sources/juce_StreamingAudioSource.h"
+#endif
 #ifndef __JUCE_TONEGENERATORAUDIOSOURCE_JUCEHEADER__
  #include "sources/juce_ToneGeneratorAudioSource.h"
 #endif
 #ifndef __JUCE_SYNTHESISER_JUCEHEADER__
  #include "synthesisers/juce_Synthesiser.h"
 #endif
+#ifndef __JUCE_AUDIOCALLBACKPROFILER_JUCEHEADER__
+ #include "utilities/juce_AudioCallbackProfiler.h"
+#endif
 // END_AUTOINCLUDE
 
 }
@@ -162,22 +162,170 @@ void MidiBuffer::addEvent (const void* const newData, const int maxBytes, const
     }
 }
 
+//==============================================================================
+struct MidiBuffer::MergeSource
+{
+    const uint8* data;
+    const uint8* end;
+    int timeOffset;
+};
+
 void MidiBuffer::addEvents (const MidiBuffer& otherBuffer,
                             const int startSample,
                             const int numSamples,
                             const int sampleDeltaToAdd)
 {
-    Iterator i (otherBuffer);
-    i.setNextSamplePosition (startSample);
+    if (&otherBuffer == this)
+    {
+        const MidiBuffer copy (otherBuffer);
+        addEvents (copy, startSample, numSamples, sampleDeltaToAdd);
+        return;
+    }
+
+    uint8* const start = otherBuffer.findEventAfter (otherBuffer.getData(), startSample - 1);
+
+    MergeSource source;
+    source.data = start;
+    source.end = numSamples < 0 ? otherBuffer.getData() + otherBuffer.bytesUsed
+                                : otherBuffer.findEventAfter (start, startSample + numSamples - 1);
+    source.timeOffset = sampleDeltaToAdd;
+
+    mergeEvents (&source, 1);
+}
 
-    const uint8* eventData;
-    int eventSize, position;
+void MidiBuffer::addEvents (const MidiBuffer* const* const buffersToAdd, const int numBuffers,
+                            const int startSample, const int numSamples)
+{
+    // the buffers are merged in batches, so that no memory needs to be allocated here
+    // for the merge state, however many buffers there are..
+    const int maxSourcesPerPass = 32;
+    MergeSource sources [maxSourcesPerPass];
+    int numSources = 0;
 
-    while (i.getNextEvent (eventData, eventSize, position)
-            && (position < startSample + numSamples || numSamples < 0))
+    for (int i = 0; i < numBuffers; ++i)
     {
-        addEvent (eventData, eventSize, position + sampleDeltaToAdd);
+        const MidiBuffer* const other = buffersToAdd[i];
+
+        if (other == this)
+        {
+            // (any pending sources must be merged before this buffer can be added to itself)
+            mergeEvents (sources, numSources);
+            numSources = 0;
+            addEvents (*this, startSample, numSamples, 0);
+            continue;
+        }
+
+        if (other == nullptr || other->isEmpty())
+            continue;
+
+        uint8* const start = other->findEventAfter (other->getData(), startSample - 1);
+
+        MergeSource& s = sources [numSources];
+        s.data = start;
+        s.end = numSamples < 0 ? other->getData() + other->bytesUsed
+                               : other->findEventAfter (start, startSample + numSamples - 1);
+        s.timeOffset = 0;
+
+        if (++numSources == maxSourcesPerPass)
+        {
+            mergeEvents (sources, numSources);
+            numSources = 0;
+        }
     }
+
+    mergeEvents (sources, numSources);
+}
+
+void MidiBuffer::mergeEvents (MergeSource* const sources, int numSources)
+{
+    using namespace MidiBufferHelpers;
+
+    size_t bytesToAdd = 0;
+    int earliestTime = std::numeric_limits<int>::max();
+    int numActive = 0;
+
+    for (int i = 0; i < numSources; ++i)
+    {
+        const MergeSource& s = sources[i];
+
+        if (s.data < s.end)
+        {
+            bytesToAdd += (size_t) (s.end - s.data);
+            earliestTime = jmin (earliestTime, getEventTime (s.data) + s.timeOffset);
+            sources [numActive++] = s;
+        }
+    }
+
+    if (bytesToAdd == 0)
+        return;
+
+    numSources = numActive;
+
+    const size_t spaceNeeded = (size_t) bytesUsed + bytesToAdd;
+    data.ensureSize ((spaceNeeded + spaceNeeded / 2 + 8) & ~(size_t) 7);
+
+    // Existing events that come before all of the new ones can stay where they are. The
+    // rest get shifted up out of the way in one go, and the merged sequence is then written
+    // forwards into the gap. The write position can never overtake the unread existing data.
+    uint8* dest = findEventAfter (getData(), earliestTime);
+    const size_t tailSize = (size_t) (getData() + bytesUsed - dest);
+    const uint8* tail = dest + bytesToAdd;
+    const uint8* const tailEnd = tail + tailSize;
+
+    if (tailSize > 0)
+        memmove (dest + bytesToAdd, dest, tailSize);
+
+    while (numSources > 0)
+    {
+        // find the source with the earliest next event (or the first of any equal ones)..
+        int best = 0;
+        int bestTime = getEventTime (sources[0].data) + sources[0].timeOffset;
+
+        for (int i = 1; i < numSources; ++i)
+        {
+            const int t = getEventTime (sources[i].data) + sources[i].timeOffset;
+
+            if (t < bestTime)
+            {
+                best = i;
+                bestTime = t;
+            }
+        }
+
+        // ..any existing events at or before that time go first..
+        const uint8* runEnd = tail;
+
+        while (runEnd < tailEnd && getEventTime (runEnd) <= bestTime)
+            runEnd += getEventTotalSize (runEnd);
+
+        if (runEnd > tail)
+        {
+            const size_t runSize = (size_t) (runEnd - tail);
+            memmove (dest, tail, runSize);
+            dest += runSize;
+            tail = runEnd;
+        }
+
+        // ..followed by the new event itself.
+        MergeSource& s = sources [best];
+        const size_t eventSize = getEventTotalSize (s.data);
+
+        *reinterpret_cast <int*> (dest) = bestTime;
+        memcpy (dest + sizeof (int), s.data + sizeof (int), eventSize - sizeof (int));
+        dest += eventSize;
+        s.data += eventSize;
+
+        if (s.data >= s.end)
+        {
+            --numSources;
+
+            for (int i = best; i < numSources; ++i)
+                sources[i] = sources[i + 1];
+        }
+    }
+
+    jassert (dest == tail); // the remaining existing events should already be in place
+    bytesUsed += (int) bytesToAdd;
 }
 
 void MidiBuffer::ensureSize (size_t minimumNumBytes)
@@ -287,3 +435,18 @@ bool MidiBuffer::Iterator::getNextEvent (MidiMessage& result, int& samplePositio
 
     return true;
 }
+
+bool MidiBuffer::Iterator::getNextEvent (EventView& result) noexcept
+{
+    return getNextEvent (result.data, result.numBytes, result.samplePosition);
+}
+
+bool MidiBuffer::Iterator::hasMoreEvents() const noexcept
+{
+    return data < buffer.getData() + buffer.bytesUsed;
+}
+
+int MidiBuffer::Iterator::getNextEventTime() const noexcept
+{
+    return hasMoreEvents() ? MidiBufferHelpers::getEventTime (data) : 0;
+}
@@ -138,6 +138,26 @@ public:
                     int numSamples,
                     int sampleDeltaToAdd);
 
+    /** Merges the events from a set of other buffers into this one.
+
+        This has the same result as calling addEvents (*buffersToAdd[i], startSample, numSamples, 0)
+        for each of the buffers in turn, but all the buffers are merged in a single pass,
+        so the cost is proportional to the total amount of data rather than growing with
+        the number of events that need to be shuffled along. This makes it a much better
+        choice when combining the output of many sources into one buffer.
+
+        Where several events share the same sample position, the ones already in this
+        buffer come first, followed by those from each of the sources in the order in
+        which they appear in the array. Null pointers in the array are ignored.
+
+        The startSample and numSamples parameters select the range of source events to
+        use, in the same way as for the other addEvents() method.
+    */
+    void addEvents (const MidiBuffer* const* buffersToAdd,
+                    int numBuffers,
+                    int startSample = 0,
+                    int numSamples = -1);
+
     /** Returns the sample number of the first event in the buffer.
 
         If the buffer's empty, this will just return 0.
@@ -164,6 +184,28 @@ public:
     */
     void ensureSize (size_t minimumNumBytes);
 
+    //==============================================================================
+    /**
+        A lightweight reference to one of the events held in a MidiBuffer.
+
+        This just points at the event's raw bytes inside the buffer's internal storage,
+        so it's only valid until the buffer is next modified.
+
+        @see MidiBuffer::Iterator
+    */
+    struct EventView
+    {
+        /** The raw midi bytes of the event. */
+        const uint8* data;
+        /** The number of bytes of midi data. */
+        int numBytes;
+        /** The event's sample position within the buffer. */
+        int samplePosition;
+
+        /** Creates a MidiMessage containing a copy of this event. */
+        MidiMessage getMessage() const      { return MidiMessage (data, numBytes, samplePosition); }
+    };
+
     //==============================================================================
     /**
         Used to iterate through the events in a MidiBuffer.
@@ -216,6 +258,25 @@ public:
                            int& numBytesOfMidiData,
                            int& samplePosition) noexcept;
 
+        /** Retrieves the next event from the buffer without copying it.
+
+            This is the fastest way to walk through a buffer: the EventView that is
+            filled in points directly into the MidiBuffer's internal data, so it is only
+            valid until the MidiBuffer is altered.
+
+            @returns        true if an event was found, or false if the iterator has reached
+                            the end of the buffer
+        */
+        bool getNextEvent (EventView& result) noexcept;
+
+        /** Returns true if there are more events left to be read. */
+        bool hasMoreEvents() const noexcept;
+
+        /** Returns the sample position of the event that getNextEvent() will return next.
+            If there are no more events, this returns 0.
+        */
+        int getNextEventTime() const noexcept;
+
     private:
         //==============================================================================
         const MidiBuffer& buffer;
@@ -233,6 +294,9 @@ private:
     uint8* getData() const noexcept;
     uint8* findEventAfter (uint8*, int samplePosition) const noexcept;
 
+    struct MergeSource;
+    void mergeEvents (MergeSource*, int numSources);
+
     JUCE_LEAK_DETECTOR (MidiBuffer)
 };
 
@@ -290,7 +290,8 @@ void MidiFile::readNextTrack (const uint8* data, int size)
     double time = 0;
     uint8 lastStatusByte = 0;
 
-    MidiMessageSequence result;
+    MidiMessageSequence* const result = new MidiMessageSequence();
+    tracks.add (result);
 
     while (size > 0)
     {
@@ -309,7 +310,7 @@ void MidiFile::readNextTrack (const uint8* data, int size)
         size -= messSize;
         data += messSize;
 
-        result.addEvent (mm);
+        result->addEvent (mm);
 
         const uint8 firstByte = *(mm.getRawData());
         if ((firstByte & 0xf0) != 0xf0)
@@ -318,10 +319,8 @@ void MidiFile::readNextTrack (const uint8* data, int size)
 
     // use a sort that puts all the note-offs before note-ons that have the same time
     MidiFileHelpers::Sorter sorter;
-    result.list.sort (sorter, true);
-
-    addTrack (result);
-    tracks.getLast()->updateMatchedPairs();
+    result->list.sort (sorter, true);
+    result->updateMatchedPairs();
 }
 
 //==============================================================================
@@ -0,0 +1,389 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+
+namespace MidiFileReaderHelpers
+{
+    static bool readVariableLengthValue (const uint8*& d, const uint8* const end, uint32& value) noexcept
+    {
+        value = 0;
+
+        for (int i = 0; i < 4; ++i)
+        {
+            if (d >= end)
+                return false;
+
+            const uint8 byte = *d++;
+            value = (value << 7) | (byte & 0x7f);
+
+            if ((byte & 0x80) == 0)
+                return true;
+        }
+
+        return false;
+    }
+
+    static int writeVariableLengthValue (uint8* d, uint32 value) noexcept
+    {
+        int numBytes = 1;
+
+        while ((value >> (7 * numBytes)) != 0 && numBytes < 4)
+            ++numBytes;
+
+        for (int i = numBytes; --i >= 0;)
+            *d++ = (uint8) (((value >> (7 * i)) & 0x7f) | (i > 0 ? 0x80 : 0));
+
+        return numBytes;
+    }
+}
+
+//==============================================================================
+MidiFileReader::MidiFileReader (const File& file)
+    : mappedFile (new MemoryMappedFile (file, MemoryMappedFile::readOnly)),
+      timeFormat (0), fileType (0), valid (false)
+{
+    if (mappedFile->getData() != nullptr)
+        parseChunks (static_cast <const uint8*> (mappedFile->getData()), mappedFile->getSize());
+}
+
+MidiFileReader::MidiFileReader (const void* const midiFileData, const size_t numBytes)
+    : timeFormat (0), fileType (0), valid (false)
+{
+    if (midiFileData != nullptr)
+        parseChunks (static_cast <const uint8*> (midiFileData), numBytes);
+}
+
+MidiFileReader::~MidiFileReader()
+{
+}
+
+void MidiFileReader::parseChunks (const uint8* d, const size_t numBytes)
+{
+    const uint8* const end = d + numBytes;
+
+    if (numBytes < 14)
+        return;
+
+    if (ByteOrder::bigEndianInt (d) == ByteOrder::bigEndianInt ("RIFF"))
+    {
+        // RMID files wrap the midi data in a RIFF chunk, so look for the header inside it
+        for (int i = 0; i < 8 && end - d >= 18; ++i)
+        {
+            d += 4;
+
+            if (ByteOrder::bigEndianInt (d) == ByteOrder::bigEndianInt ("MThd"))
+                break;
+        }
+    }
+
+    if (end - d < 14 || ByteOrder::bigEndianInt (d) != ByteOrder::bigEndianInt ("MThd"))
+        return;
+
+    const uint32 headerSize = ByteOrder::bigEndianInt (d + 4);
+
+    if (headerSize < 6 || headerSize > (uint32) (end - d - 8))
+        return;
+
+    fileType   = (int) ByteOrder::bigEndianShort (d + 8);
+    const int expectedTracks = (int) ByteOrder::bigEndianShort (d + 10);
+    timeFormat = (short) ByteOrder::bigEndianShort (d + 12);
+    d += 8 + headerSize;
+    valid = true;
+
+    tracks.ensureStorageAllocated (expectedTracks);
+
+    while (end - d >= 8 && tracks.size() < expectedTracks)
+    {
+        const uint32 chunkType = ByteOrder::bigEndianInt (d);
+        const uint32 chunkSize = jmin (ByteOrder::bigEndianInt (d + 4), (uint32) (end - d - 8));
+        d += 8;
+
+        if (chunkType == ByteOrder::bigEndianInt ("MTrk"))
+        {
+            const TrackChunk chunk = { d, (int) chunkSize };
+            tracks.add (chunk);
+        }
+
+        d += chunkSize;
+    }
+}
+
+//==============================================================================
+double MidiFileReader::Event::getTempoSecondsPerQuarterNote() const noexcept
+{
+    if (! isTempoMetaEvent())
+        return 0.5;
+
+    return (((int) data[0] << 16) | ((int) data[1] << 8) | data[2]) / 1000000.0;
+}
+
+String MidiFileReader::Event::getText() const
+{
+    return String::fromUTF8 (reinterpret_cast <const char*> (data), numBytes);
+}
+
+MidiMessage MidiFileReader::Event::getMessage() const
+{
+    if (status == 0xff)
+    {
+        HeapBlock<uint8> message ((size_t) numBytes + 6);
+        message[0] = 0xff;
+        message[1] = metaType;
+        const int headerSize = 2 + MidiFileReaderHelpers::writeVariableLengthValue (message + 2, (uint32) numBytes);
+        memcpy (message + headerSize, data, (size_t) numBytes);
+
+        return MidiMessage (message, headerSize + numBytes, (double) tick);
+    }
+
+    if (numBytes < 3)
+    {
+        uint8 message[3] = { status, 0, 0 };
+
+        for (int i = 0; i < numBytes; ++i)
+            message[i + 1] = data[i];
+
+        return MidiMessage (message, numBytes + 1, (double) tick);
+    }
+
+    HeapBlock<uint8> message ((size_t) numBytes + 1);
+    message[0] = status;
+    memcpy (message + 1, data, (size_t) numBytes);
+
+    return MidiMessage (message, numBytes + 1, (double) tick);
+}
+
+//==============================================================================
+struct MidiFileReader::Iterator::TrackState
+{
+    const uint8* pos;
+    const uint8* end;
+    int64 tick;
+    int track;
+    uint8 runningStatus;
+    bool hasEvent;
+
+    // Reads the delta-time that precedes the next event in the track
+    void readDelta() noexcept
+    {
+        uint32 delta;
+        hasEvent = MidiFileReaderHelpers::readVariableLengthValue (pos, end, delta) && pos < end;
+
+        if (hasEvent)
+            tick += delta;
+    }
+
+    bool readEvent (Event& e) noexcept
+    {
+        uint8 status = *pos;
+
+        if (status < 0x80)
+        {
+            if (runningStatus == 0)
+                return false;
+
+            status = runningStatus;
+        }
+        else
+        {
+            ++pos;
+        }
+
+        e.tick = tick;
+        e.track = track;
+        e.status = status;
+        e.metaType = 0;
+
+        if (status == 0xff || status == 0xf0 || status == 0xf7)
+        {
+            if (status == 0xff)
+            {
+                if (pos >= end)
+                    return false;
+
+                e.metaType = *pos++;
+            }
+
+            uint32 length;
+            if (! MidiFileReaderHelpers::readVariableLengthValue (pos, end, length))
+                return false;
+
+            e.numBytes = (int) jmin (length, (uint32) (end - pos));
+        }
+        else
+        {
+            e.numBytes = MidiMessage::getMessageLengthFromFirstByte (status) - 1;
+
+            if (end - pos < e.numBytes)
+                return false;
+
+            if (status < 0xf0)
+                runningStatus = status;
+        }
+
+        e.data = pos;
+        pos += e.numBytes;
+        return true;
+    }
+};
+
+MidiFileReader::Iterator::Iterator (const MidiFileReader& reader, const int trackIndex, const bool metaEventsOnly)
+    : numStates (0), lastTick (0), metaOnly (metaEventsOnly)
+{
+    const int firstTrack = trackIndex < 0 ? 0 : trackIndex;
+    const int lastTrack  = trackIndex < 0 ? reader.tracks.size() : jmin (trackIndex + 1, reader.tracks.size());
+
+    if (lastTrack > firstTrack)
+    {
+        states.malloc ((size_t) (lastTrack - firstTrack));
+
+        for (int i = firstTrack; i < lastTrack; ++i)
+        {
+            const TrackChunk& chunk = reader.tracks.getReference (i);
+            TrackState& s = states [numStates++];
+
+            s.pos = chunk.data;
+            s.end = chunk.data + chunk.size;
+            s.tick = 0;
+            s.track = i;
+            s.runningStatus = 0;
+            s.readDelta();
+        }
+    }
+}
+
+MidiFileReader::Iterator::~Iterator()
+{
+}
+
+bool MidiFileReader::Iterator::getNextEvent (Event& result) noexcept
+{
+    for (;;)
+    {
+        TrackState* next = nullptr;
+
+        for (int i = 0; i < numStates; ++i)
+        {
+            TrackState& s = states[i];
+
+            if (s.hasEvent && (next == nullptr || s.tick < next->tick))
+                next = &s;
+        }
+
+        if (next == nullptr)
+            return false;
+
+        if (! next->readEvent (result))
+        {
+            // a corrupt event ends the track
+            next->hasEvent = false;
+            continue;
+        }
+
+        next->readDelta();
+        lastTick = jmax (lastTick, result.tick);
+
+        if (metaOnly && result.status != 0xff)
+            continue;
+
+        return true;
+    }
+}
+
+//==============================================================================
+MidiFileReader::Summary::Summary()
+    : timeFormat (0), fileType (0), numTracks (0),
+      lengthInTicks (0), lengthInSeconds (0)
+{
+}
+
+double MidiFileReader::Summary::ticksToSeconds (const int64 tick) const noexcept
+{
+    if (timeFormat < 0)
+        return (double) tick / (-(timeFormat >> 8) * (timeFormat & 0xff));
+
+    if ((timeFormat & 0x7fff) == 0)
+        return 0.0;
+
+    const double tickLen = 1.0 / (timeFormat & 0x7fff);
+    double secsPerTick = 0.5 * tickLen;
+    double correctedTime = 0.0;
+    int64 lastTime = 0;
+
+    for (int i = 0; i < tempoChanges.size(); ++i)
+    {
+        const TempoChange& t = tempoChanges.getReference (i);
+
+        if (t.tick >= tick)
+            break;
+
+        correctedTime += (double) (t.tick - lastTime) * secsPerTick;
+        lastTime = t.tick;
+        secsPerTick = tickLen * t.secondsPerQuarterNote;
+    }
+
+    return correctedTime + (double) (tick - lastTime) * secsPerTick;
+}
+
+bool MidiFileReader::readSummary (Summary& result) const
+{
+    result.timeFormat = timeFormat;
+    result.fileType = fileType;
+    result.numTracks = tracks.size();
+    result.trackNames.clear();
+    result.tempoChanges.clearQuick();
+    result.timeSignatures.clearQuick();
+    result.lengthInTicks = 0;
+    result.lengthInSeconds = 0;
+
+    if (! valid)
+        return false;
+
+    for (int i = 0; i < tracks.size(); ++i)
+        result.trackNames.add (String::empty);
+
+    Iterator iter (*this, -1, true);
+    Event e;
+
+    while (iter.getNextEvent (e))
+    {
+        if (e.isTempoMetaEvent())
+        {
+            const TempoChange t = { e.tick, e.getTempoSecondsPerQuarterNote() };
+            result.tempoChanges.add (t);
+        }
+        else if (e.isTimeSignatureMetaEvent())
+        {
+            const TimeSignatureChange t = { e.tick, e.data[0], 1 << jmin (16, (int) e.data[1]) };
+            result.timeSignatures.add (t);
+        }
+        else if (e.isTrackNameEvent() && result.trackNames [e.track].isEmpty())
+        {
+            result.trackNames.set (e.track, e.getText());
+        }
+    }
+
+    result.lengthInTicks = iter.getLastTick();
+    result.lengthInSeconds = result.ticksToSeconds (result.lengthInTicks);
+    return true;
+}
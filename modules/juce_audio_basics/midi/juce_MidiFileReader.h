@@ -0,0 +1,250 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+
+#ifndef __JUCE_MIDIFILEREADER_JUCEHEADER__
+#define __JUCE_MIDIFILEREADER_JUCEHEADER__
+
+#include "juce_MidiMessage.h"
+
+
+//==============================================================================
+/**
+    Walks through the events in a standard midi file without loading it into a MidiFile.
+
+    A MidiFile object has to read a whole stream into memory and turn every event into a
+    heap-allocated MidiMessage before any of it can be used. This class instead parses the
+    file's bytes in-place - either from a memory-mapped file, or from a block of memory that
+    you provide - and hands back lightweight Event structures that point straight into the
+    file data, so reading through a file doesn't allocate anything per-event.
+
+    For quickly indexing large numbers of files, readSummary() gathers just the track names,
+    tempo map, time signatures and length of a file, skipping over all the other events.
+
+    @code
+    MidiFileReader reader (file);
+
+    MidiFileReader::Iterator i (reader);
+    MidiFileReader::Event e;
+
+    while (i.getNextEvent (e))
+        if (e.isNoteOn())
+            doSomething (e.tick, e.getNoteNumber());
+    @endcode
+
+    @see MidiFile
+*/
+class JUCE_API  MidiFileReader
+{
+public:
+    //==============================================================================
+    /** Creates a reader for a midi file, which will be memory-mapped while the reader exists.
+        If the file can't be opened or isn't a midi file, isValid() will return false.
+    */
+    explicit MidiFileReader (const File& file);
+
+    /** Creates a reader for a midi file that's held in memory.
+        The data isn't copied, so it must not be changed or deleted while this reader,
+        or any events read from it, are still in use.
+    */
+    MidiFileReader (const void* midiFileData, size_t numBytes);
+
+    /** Destructor. */
+    ~MidiFileReader();
+
+    //==============================================================================
+    /** Returns true if the data has a valid midi file header. */
+    bool isValid() const noexcept                   { return valid; }
+
+    /** Returns the raw time format code from the file's header.
+        This has the same meaning as the value returned by MidiFile::getTimeFormat().
+    */
+    short getTimeFormat() const noexcept            { return timeFormat; }
+
+    /** Returns the file type (0, 1 or 2) from the file's header. */
+    int getFileType() const noexcept                { return fileType; }
+
+    /** Returns the number of tracks that were found in the file. */
+    int getNumTracks() const noexcept               { return tracks.size(); }
+
+    //==============================================================================
+    /**
+        One of the events in a midi file.
+
+        The data pointer refers directly to the reader's file data, so an Event is only
+        valid for as long as the MidiFileReader that produced it.
+    */
+    struct JUCE_API  Event
+    {
+        /** The event's absolute time, in midi ticks from the start of the file. */
+        int64 tick;
+        /** The index of the track that the event belongs to. */
+        int track;
+        /** The event's status byte. If the event used running status, this is the status
+            byte that it inherited. Meta-events are 0xff, and sysex events are 0xf0 or 0xf7.
+        */
+        uint8 status;
+        /** For a meta-event, this is its type (e.g. 0x51 for a tempo change). */
+        uint8 metaType;
+        /** The bytes that follow the status byte: the data bytes of a channel message, or the
+            contents of a meta-event or sysex message (after its length field).
+        */
+        const uint8* data;
+        /** The number of bytes that data points to. */
+        int numBytes;
+
+        bool isMetaEvent() const noexcept           { return status == 0xff; }
+        bool isSysEx() const noexcept               { return status == 0xf0 || status == 0xf7; }
+        bool isNoteOn() const noexcept              { return (status & 0xf0) == 0x90 && numBytes > 1 && data[1] != 0; }
+        bool isNoteOff() const noexcept             { return ((status & 0xf0) == 0x80 || ((status & 0xf0) == 0x90 && numBytes > 1 && data[1] == 0)); }
+        bool isTempoMetaEvent() const noexcept      { return status == 0xff && metaType == 0x51 && numBytes >= 3; }
+        bool isTimeSignatureMetaEvent() const noexcept  { return status == 0xff && metaType == 0x58 && numBytes >= 2; }
+        bool isTrackNameEvent() const noexcept      { return status == 0xff && metaType == 0x03; }
+        bool isTextMetaEvent() const noexcept       { return status == 0xff && metaType > 0 && metaType < 16; }
+
+        /** Returns the midi channel, in the range 1 to 16, or 0 if this isn't a channel message. */
+        int getChannel() const noexcept             { return status < 0xf0 ? (status & 0x0f) + 1 : 0; }
+        /** For a note event, returns its note number. */
+        int getNoteNumber() const noexcept          { return numBytes > 0 ? data[0] : 0; }
+        /** For a tempo meta-event, returns the number of seconds per quarter-note. */
+        double getTempoSecondsPerQuarterNote() const noexcept;
+        /** For a text meta-event, returns its text. */
+        String getText() const;
+
+        /** Creates a MidiMessage containing a copy of this event, with its timestamp set to
+            its time in ticks.
+        */
+        MidiMessage getMessage() const;
+    };
+
+    //==============================================================================
+    /**
+        Reads through the events of a MidiFileReader in time order.
+
+        This can either read a single track, or merge all the tracks together, in which
+        case events that happen at the same time are returned in track order. Within a
+        track, events are returned in the order they appear in the file.
+    */
+    class JUCE_API  Iterator
+    {
+    public:
+        /** Creates an iterator.
+
+            @param reader           the reader to use. This must not be deleted while the
+                                    iterator is still in use
+            @param trackIndex       the index of the track to read, or -1 to merge all tracks
+            @param metaEventsOnly   if true, only meta-events will be returned, and all other
+                                    events will be skipped over
+        */
+        Iterator (const MidiFileReader& reader, int trackIndex = -1, bool metaEventsOnly = false);
+
+        /** Destructor. */
+        ~Iterator();
+
+        /** Moves on to the next event.
+            @returns true if an event was found, or false if there are no more events
+        */
+        bool getNextEvent (Event& result) noexcept;
+
+        /** Returns the time of the latest event that has been read so far, in ticks.
+            In metaEventsOnly mode, this includes the events that were skipped over.
+        */
+        int64 getLastTick() const noexcept          { return lastTick; }
+
+    private:
+        struct TrackState;
+        HeapBlock<TrackState> states;
+        int numStates;
+        int64 lastTick;
+        bool metaOnly;
+
+        JUCE_DECLARE_NON_COPYABLE (Iterator)
+    };
+
+    //==============================================================================
+    /** A tempo change in a midi file. */
+    struct TempoChange
+    {
+        int64 tick;
+        double secondsPerQuarterNote;
+    };
+
+    /** A time signature change in a midi file. */
+    struct TimeSignatureChange
+    {
+        int64 tick;
+        int numerator, denominator;
+    };
+
+    /** The header and meta-event information about a midi file, as found by readSummary(). */
+    struct JUCE_API  Summary
+    {
+        Summary();
+
+        short timeFormat;
+        int fileType;
+        int numTracks;
+        /** The name of each track, or an empty string for tracks that don't have one. */
+        StringArray trackNames;
+        /** All the tempo changes in the file, in time order. */
+        Array<TempoChange> tempoChanges;
+        /** All the time signature changes in the file, in time order. */
+        Array<TimeSignatureChange> timeSignatures;
+        /** The time of the last event in any of the tracks, in ticks. */
+        int64 lengthInTicks;
+        /** The time of the last event in any of the tracks, in seconds. */
+        double lengthInSeconds;
+
+        /** Converts a time in ticks to seconds, using the tempo map and time format.
+            This uses the same rules as MidiFile::convertTimestampTicksToSeconds().
+        */
+        double ticksToSeconds (int64 tick) const noexcept;
+    };
+
+    /** Reads the header and meta-events of the file, without looking at any other events.
+        @returns true if the file was valid
+    */
+    bool readSummary (Summary& result) const;
+
+private:
+    //==============================================================================
+    struct TrackChunk
+    {
+        const uint8* data;
+        int size;
+    };
+
+    ScopedPointer<MemoryMappedFile> mappedFile;
+    Array<TrackChunk> tracks;
+    short timeFormat;
+    int fileType;
+    bool valid;
+
+    void parseChunks (const uint8* data, size_t numBytes);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MidiFileReader)
+};
+
+
+#endif   // __JUCE_MIDIFILEREADER_JUCEHEADER__
@@ -22,16 +22,94 @@
   ==============================================================================
 */
 
+//==============================================================================
+// Hands out the memory for a sequence's MidiEventHolders from a few large blocks, and
+// keeps a list of the slots that have been freed so that they can be re-used.
+class MidiMessageSequence::EventPool
+{
+public:
+    EventPool() noexcept  : nextInBlock (nullptr), numLeftInBlock (0), numAllocated (0) {}
+
+    ~EventPool()
+    {
+        for (int i = blocks.size(); --i >= 0;)
+            std::free (blocks.getUnchecked (i));
+    }
+
+    void* allocate()
+    {
+        if (freeSlots.size() > 0)
+        {
+            void* const slot = freeSlots.getLast();
+            freeSlots.removeLast();
+            return slot;
+        }
+
+        if (numLeftInBlock == 0)
+            addBlock (jlimit (32, 8192, numAllocated));
+
+        --numLeftInBlock;
+        ++numAllocated;
+        void* const slot = nextInBlock;
+        nextInBlock += sizeof (MidiEventHolder);
+        return slot;
+    }
+
+    void release (void* const slot)
+    {
+        freeSlots.add (slot);
+    }
+
+    void reserve (const int numEvents)
+    {
+        const int numSpare = freeSlots.size() + numLeftInBlock;
+
+        if (numEvents > numSpare)
+            addBlock (numEvents - numSpare);
+    }
+
+private:
+    Array<char*> blocks;
+    Array<void*> freeSlots;
+    char* nextInBlock;
+    int numLeftInBlock, numAllocated;
+
+    void addBlock (const int numSlots)
+    {
+        freeSlots.ensureStorageAllocated (freeSlots.size() + numLeftInBlock);
+
+        for (; numLeftInBlock > 0; --numLeftInBlock)
+        {
+            freeSlots.add (nextInBlock);
+            nextInBlock += sizeof (MidiEventHolder);
+        }
+
+        char* const block = static_cast <char*> (std::malloc ((size_t) numSlots * sizeof (MidiEventHolder)));
+
+        if (block == nullptr)
+            throw std::bad_alloc();
+
+        blocks.add (block);
+        nextInBlock = block;
+        numLeftInBlock = numSlots;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (EventPool)
+};
+
+//==============================================================================
 MidiMessageSequence::MidiMessageSequence()
+    : pool (new EventPool())
 {
 }
 
 MidiMessageSequence::MidiMessageSequence (const MidiMessageSequence& other)
+    : pool (new EventPool())
 {
-    list.ensureStorageAllocated (other.list.size());
+    ensureStorageAllocated (other.list.size());
 
     for (int i = 0; i < other.list.size(); ++i)
-        list.add (new MidiEventHolder (other.list.getUnchecked(i)->message));
+        list.add (createEvent (other.list.getUnchecked(i)->message));
 }
 
 MidiMessageSequence& MidiMessageSequence::operator= (const MidiMessageSequence& other)
@@ -44,15 +122,42 @@ MidiMessageSequence& MidiMessageSequence::operator= (const MidiMessageSequence&
 void MidiMessageSequence::swapWith (MidiMessageSequence& other) noexcept
 {
     list.swapWithArray (other.list);
+    pool.swapWith (other.pool);
 }
 
 MidiMessageSequence::~MidiMessageSequence()
 {
+    deleteEvents (0, list.size());
+}
+
+MidiMessageSequence::MidiEventHolder* MidiMessageSequence::createEvent (const MidiMessage& message)
+{
+    return new (pool->allocate()) MidiEventHolder (message);
+}
+
+void MidiMessageSequence::deleteEvents (const int startIndex, const int numToDelete)
+{
+    for (int i = startIndex + numToDelete; --i >= startIndex;)
+    {
+        MidiEventHolder* const meh = list.getUnchecked (i);
+        meh->~MidiEventHolder();
+        pool->release (meh);
+    }
+
+    list.removeRange (startIndex, numToDelete);
 }
 
 void MidiMessageSequence::clear()
 {
+    deleteEvents (0, list.size());
     list.clear();
+    pool = new EventPool();
+}
+
+void MidiMessageSequence::ensureStorageAllocated (const int numEvents)
+{
+    list.ensureStorageAllocated (numEvents);
+    pool->reserve (numEvents - list.size());
 }
 
 int MidiMessageSequence::getNumEvents() const
@@ -77,26 +182,57 @@ double MidiMessageSequence::getTimeOfMatchingKeyUp (const int index) const
 int MidiMessageSequence::getIndexOfMatchingKeyUp (const int index) const
 {
     if (const MidiEventHolder* const meh = list [index])
-        return list.indexOf (meh->noteOffObject);
+        if (meh->noteOffObject != nullptr)
+            return getIndexOf (meh->noteOffObject);
 
     return -1;
 }
 
 int MidiMessageSequence::getIndexOf (MidiEventHolder* const event) const
 {
+    if (event == nullptr)
+        return -1;
+
+    // look for it amongst the events with the same time first..
+    const double time = event->message.getTimeStamp();
+    const int numEvents = list.size();
+
+    for (int i = getNextIndexAtTime (time); i < numEvents; ++i)
+    {
+        const MidiEventHolder* const meh = list.getUnchecked (i);
+
+        if (meh == event)
+            return i;
+
+        if (meh->message.getTimeStamp() != time)
+            break;
+    }
+
+    // ..but the sequence may not have been re-sorted since its time was changed
     return list.indexOf (event);
 }
 
 int MidiMessageSequence::getNextIndexAtTime (const double timeStamp) const
 {
-    const int numEvents = list.size();
+    int start = 0, end = list.size();
 
-    int i;
-    for (i = 0; i < numEvents; ++i)
-        if (list.getUnchecked(i)->message.getTimeStamp() >= timeStamp)
-            break;
+    while (start < end)
+    {
+        const int mid = start + (end - start) / 2;
+
+        if (list.getUnchecked (mid)->message.getTimeStamp() < timeStamp)
+            start = mid + 1;
+        else
+            end = mid;
+    }
 
-    return i;
+    return start;
+}
+
+Range<int> MidiMessageSequence::getIndexRangeForTimes (const double startTime, const double endTime) const
+{
+    const int startIndex = getNextIndexAtTime (startTime);
+    return Range<int> (startIndex, jmax (startIndex, getNextIndexAtTime (endTime)));
 }
 
 //==============================================================================
@@ -122,17 +258,33 @@ double MidiMessageSequence::getEventTime (const int index) const
 MidiMessageSequence::MidiEventHolder* MidiMessageSequence::addEvent (const MidiMessage& newMessage,
                                                                      double timeAdjustment)
 {
-    MidiEventHolder* const newOne = new MidiEventHolder (newMessage);
+    MidiEventHolder* const newOne = createEvent (newMessage);
 
     timeAdjustment += newMessage.getTimeStamp();
     newOne->message.setTimeStamp (timeAdjustment);
 
-    int i;
-    for (i = list.size(); --i >= 0;)
-        if (list.getUnchecked(i)->message.getTimeStamp() <= timeAdjustment)
-            break;
+    int numEvents = list.size();
+
+    if (numEvents == 0 || list.getUnchecked (numEvents - 1)->message.getTimeStamp() <= timeAdjustment)
+    {
+        list.add (newOne);
+        return newOne;
+    }
+
+    // find the first event that's later than the new one
+    int start = 0;
 
-    list.insert (i + 1, newOne);
+    while (start < numEvents)
+    {
+        const int mid = start + (numEvents - start) / 2;
+
+        if (list.getUnchecked (mid)->message.getTimeStamp() <= timeAdjustment)
+            start = mid + 1;
+        else
+            numEvents = mid;
+    }
+
+    list.insert (start, newOne);
     return newOne;
 }
 
@@ -142,9 +294,18 @@ void MidiMessageSequence::deleteEvent (const int index,
     if (isPositiveAndBelow (index, list.size()))
     {
         if (deleteMatchingNoteUp)
-            deleteEvent (getIndexOfMatchingKeyUp (index), false);
+        {
+            const int noteUpIndex = getIndexOfMatchingKeyUp (index);
+
+            if (noteUpIndex >= 0)
+            {
+                deleteEvents (noteUpIndex, 1);
+                deleteEvents (noteUpIndex < index ? index - 1 : index, 1);
+                return;
+            }
+        }
 
-        list.remove (index);
+        deleteEvents (index, 1);
     }
 }
 
@@ -166,18 +327,17 @@ void MidiMessageSequence::addSequence (const MidiMessageSequence& other,
     firstAllowableTime -= timeAdjustment;
     endOfAllowableDestTimes -= timeAdjustment;
 
-    for (int i = 0; i < other.list.size(); ++i)
+    const Range<int> range (other.getIndexRangeForTimes (firstAllowableTime, endOfAllowableDestTimes));
+    ensureStorageAllocated (list.size() + range.getLength());
+
+    for (int i = range.getStart(); i < range.getEnd(); ++i)
     {
         const MidiMessage& m = other.list.getUnchecked(i)->message;
-        const double t = m.getTimeStamp();
 
-        if (t >= firstAllowableTime && t < endOfAllowableDestTimes)
-        {
-            MidiEventHolder* const newOne = new MidiEventHolder (m);
-            newOne->message.setTimeStamp (timeAdjustment + t);
+        MidiEventHolder* const newOne = createEvent (m);
+        newOne->message.setTimeStamp (timeAdjustment + m.getTimeStamp());
 
-            list.add (newOne);
-        }
+        list.add (newOne);
     }
 
     sort();
@@ -192,41 +352,58 @@ void MidiMessageSequence::sort()
 
 void MidiMessageSequence::updateMatchedPairs()
 {
+    // For each note and channel, this holds the note-on that's waiting for its note-off,
+    // so the whole sequence can be matched up in a single pass.
+    HeapBlock<MidiEventHolder*> unmatchedNoteOns (16 * 128, true);
+
+    Array<MidiEventHolder*> newList;
+    int numEventsAdded = 0;
+
     for (int i = 0; i < list.size(); ++i)
     {
         MidiEventHolder* const meh = list.getUnchecked(i);
-        const MidiMessage& m1 = meh->message;
+        const MidiMessage& m = meh->message;
 
-        if (m1.isNoteOn())
+        if (m.isNoteOn())
         {
-            meh->noteOffObject = nullptr;
-            const int note = m1.getNoteNumber();
-            const int chan = m1.getChannel();
-            const int len = list.size();
+            MidiEventHolder*& unmatched = unmatchedNoteOns [(m.getChannel() - 1) * 128 + m.getNoteNumber()];
 
-            for (int j = i + 1; j < len; ++j)
+            if (unmatched != nullptr)
             {
-                const MidiMessage& m = list.getUnchecked(j)->message;
-
-                if (m.getNoteNumber() == note && m.getChannel() == chan)
+                // two note-ons in a row, so the first one needs a note-off..
+                if (numEventsAdded == 0)
                 {
-                    if (m.isNoteOff())
-                    {
-                        meh->noteOffObject = list[j];
-                        break;
-                    }
-                    else if (m.isNoteOn())
-                    {
-                        MidiEventHolder* const newEvent = new MidiEventHolder (MidiMessage::noteOff (chan, note));
-                        list.insert (j, newEvent);
-                        newEvent->message.setTimeStamp (m.getTimeStamp());
-                        meh->noteOffObject = newEvent;
-                        break;
-                    }
+                    newList.ensureStorageAllocated (list.size() + 16);
+                    newList.addArray (list, 0, i);
                 }
+
+                MidiEventHolder* const newEvent = createEvent (MidiMessage::noteOff (m.getChannel(), m.getNoteNumber()));
+                newEvent->message.setTimeStamp (m.getTimeStamp());
+                newList.add (newEvent);
+                unmatched->noteOffObject = newEvent;
+                ++numEventsAdded;
             }
+
+            meh->noteOffObject = nullptr;
+            unmatched = meh;
         }
+        else if (m.isNoteOff())
+        {
+            MidiEventHolder*& unmatched = unmatchedNoteOns [(m.getChannel() - 1) * 128 + m.getNoteNumber()];
+
+            if (unmatched != nullptr)
+            {
+                unmatched->noteOffObject = meh;
+                unmatched = nullptr;
+            }
+        }
+
+        if (numEventsAdded > 0)
+            newList.add (meh);
     }
+
+    if (numEventsAdded > 0)
+        list.swapWithArray (newList);
 }
 
 void MidiMessageSequence::addTimeToMessages (const double delta)
@@ -265,16 +442,46 @@ void MidiMessageSequence::extractSysExMessages (MidiMessageSequence& destSequenc
 
 void MidiMessageSequence::deleteMidiChannelMessages (const int channelNumberToRemove)
 {
-    for (int i = list.size(); --i >= 0;)
-        if (list.getUnchecked(i)->message.isForChannel (channelNumberToRemove))
-            list.remove(i);
+    int numKept = 0;
+
+    for (int i = 0; i < list.size(); ++i)
+    {
+        MidiEventHolder* const meh = list.getUnchecked(i);
+
+        if (meh->message.isForChannel (channelNumberToRemove))
+        {
+            meh->~MidiEventHolder();
+            pool->release (meh);
+        }
+        else
+        {
+            list.setUnchecked (numKept++, meh);
+        }
+    }
+
+    list.removeRange (numKept, list.size() - numKept);
 }
 
 void MidiMessageSequence::deleteSysExMessages()
 {
-    for (int i = list.size(); --i >= 0;)
-        if (list.getUnchecked(i)->message.isSysEx())
-            list.remove(i);
+    int numKept = 0;
+
+    for (int i = 0; i < list.size(); ++i)
+    {
+        MidiEventHolder* const meh = list.getUnchecked(i);
+
+        if (meh->message.isSysEx())
+        {
+            meh->~MidiEventHolder();
+            pool->release (meh);
+        }
+        else
+        {
+            list.setUnchecked (numKept++, meh);
+        }
+    }
+
+    list.removeRange (numKept, list.size() - numKept);
 }
 
 //==============================================================================
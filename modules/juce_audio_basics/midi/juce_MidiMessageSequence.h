@@ -35,6 +35,11 @@
     This allows the sequence to be manipulated, and also to be read from and
     written to a standard midi file.
 
+    The events are kept sorted by time, so looking up an event by its time takes a
+    binary search rather than a scan, and the events' MidiEventHolder objects are
+    packed together in blocks owned by the sequence rather than each having its own
+    heap allocation.
+
     @see MidiMessage, MidiFile
 */
 class JUCE_API  MidiMessageSequence
@@ -115,7 +120,7 @@ public:
     */
     int getIndexOfMatchingKeyUp (int index) const;
 
-    /** Returns the index of an event. */
+    /** Returns the index of an event, or -1 if it isn't in this sequence. */
     int getIndexOf (MidiEventHolder* event) const;
 
     /** Returns the index of the first event on or after the given timestamp.
@@ -125,6 +130,11 @@ public:
     */
     int getNextIndexAtTime (double timeStamp) const;
 
+    /** Returns the range of indexes of the events whose timestamps are at or after
+        startTime and before endTime.
+    */
+    Range<int> getIndexRangeForTimes (double startTime, double endTime) const;
+
     //==============================================================================
     /** Returns the timestamp of the first event in the sequence.
 
@@ -148,7 +158,9 @@ public:
     /** Inserts a midi message into the sequence.
 
         The index at which the new message gets inserted will depend on its timestamp,
-        because the sequence is kept sorted.
+        because the sequence is kept sorted. If there are already events with the same
+        time, the new one goes after them. Adding events in time order is the quickest
+        way to build a sequence.
 
         Remember to call updateMatchedPairs() after adding note-on events.
 
@@ -189,12 +201,20 @@ public:
                       double firstAllowableDestTime,
                       double endOfAllowableDestTimes);
 
+    /** Pre-allocates space for a number of events.
+        Calling this before adding a large number of events avoids having to
+        re-allocate the storage as the sequence grows.
+    */
+    void ensureStorageAllocated (int numEvents);
+
     //==============================================================================
     /** Makes sure all the note-on and note-off pairs are up-to-date.
 
         Call this after moving messages about or deleting/adding messages, and it
         will scan the list and make sure all the note-offs in the MidiEventHolder
-        structures are pointing at the correct ones.
+        structures are pointing at the correct ones. Any note-on that's followed by
+        another note-on for the same note and channel without a note-off in between
+        gets a note-off inserted before the second one.
     */
     void updateMatchedPairs();
 
@@ -271,7 +291,13 @@ public:
 private:
     //==============================================================================
     friend class MidiFile;
-    OwnedArray <MidiEventHolder> list;
+    class EventPool;
+
+    Array <MidiEventHolder*> list;
+    ScopedPointer <EventPool> pool;
+
+    MidiEventHolder* createEvent (const MidiMessage&);
+    void deleteEvents (int startIndex, int numToDelete);
 
     JUCE_LEAK_DETECTOR (MidiMessageSequence)
 };
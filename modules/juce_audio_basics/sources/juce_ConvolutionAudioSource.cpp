@@ -0,0 +1,62 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+ConvolutionAudioSource::ConvolutionAudioSource (AudioSource* const inputSource, const bool deleteInputWhenDeleted,
+                                                const int numChannels_)
+   : input (inputSource, deleteInputWhenDeleted),
+     numChannels (numChannels_),
+     bypass (false)
+{
+    jassert (inputSource != nullptr);
+}
+
+ConvolutionAudioSource::~ConvolutionAudioSource() {}
+
+void ConvolutionAudioSource::prepareToPlay (int samplesPerBlockExpected, double sampleRate)
+{
+    input->prepareToPlay (samplesPerBlockExpected, sampleRate);
+    convolution.prepareToPlay (sampleRate, numChannels);
+}
+
+void ConvolutionAudioSource::releaseResources()
+{
+    input->releaseResources();
+}
+
+void ConvolutionAudioSource::getNextAudioBlock (const AudioSourceChannelInfo& bufferToFill)
+{
+    input->getNextAudioBlock (bufferToFill);
+
+    if (! bypass)
+        convolution.processSamples (*bufferToFill.buffer, bufferToFill.startSample, bufferToFill.numSamples);
+}
+
+void ConvolutionAudioSource::setBypassed (const bool b) noexcept
+{
+    if (bypass != b)
+    {
+        bypass = b;
+        convolution.reset();
+    }
+}
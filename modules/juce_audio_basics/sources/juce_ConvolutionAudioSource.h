@@ -0,0 +1,81 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_CONVOLUTIONAUDIOSOURCE_JUCEHEADER__
+#define __JUCE_CONVOLUTIONAUDIOSOURCE_JUCEHEADER__
+
+#include "juce_AudioSource.h"
+#include "../effects/juce_ConvolutionReverb.h"
+
+
+//==============================================================================
+/**
+    An AudioSource that uses the ConvolutionReverb class to apply a convolution reverb
+    to another AudioSource.
+
+    @see ConvolutionReverb, ReverbAudioSource
+*/
+class JUCE_API  ConvolutionAudioSource   : public AudioSource
+{
+public:
+    /** Creates a ConvolutionAudioSource to process a given input source.
+
+        @param inputSource              the input source to read from - this must not be null
+        @param deleteInputWhenDeleted   if true, the input source will be deleted when
+                                        this object is deleted
+        @param numChannels              the number of channels that will be processed
+    */
+    ConvolutionAudioSource (AudioSource* inputSource,
+                            bool deleteInputWhenDeleted,
+                            int numChannels = 2);
+
+    /** Destructor. */
+    ~ConvolutionAudioSource();
+
+    //==============================================================================
+    /** Returns the ConvolutionReverb that is used to process the input.
+        Use this to load an impulse response and set the levels.
+    */
+    ConvolutionReverb& getConvolution() noexcept                { return convolution; }
+
+    void setBypassed (bool isBypassed) noexcept;
+    bool isBypassed() const noexcept                            { return bypass; }
+
+    //==============================================================================
+    void prepareToPlay (int samplesPerBlockExpected, double sampleRate);
+    void releaseResources();
+    void getNextAudioBlock (const AudioSourceChannelInfo& bufferToFill);
+
+private:
+    //==============================================================================
+    OptionalScopedPointer<AudioSource> input;
+    ConvolutionReverb convolution;
+    const int numChannels;
+    volatile bool bypass;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ConvolutionAudioSource)
+};
+
+
+#endif   // __JUCE_CONVOLUTIONAUDIOSOURCE_JUCEHEADER__
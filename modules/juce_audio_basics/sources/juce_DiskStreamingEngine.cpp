@@ -0,0 +1,204 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+
+class DiskStreamingEngine::IOThread  : public Thread
+{
+public:
+    IOThread (DiskStreamingEngine& e)
+        : Thread ("Disk Streaming"), engine (e)
+    {
+    }
+
+    void run()
+    {
+        while (! threadShouldExit())
+        {
+            if (StreamingAudioSource* const stream = engine.getNextStreamToFill())
+                engine.finishedFilling (stream, stream->fillBuffer (engine.maxSamplesPerRead));
+            else
+                wait (5);
+        }
+    }
+
+private:
+    DiskStreamingEngine& engine;
+
+    JUCE_DECLARE_NON_COPYABLE (IOThread)
+};
+
+//==============================================================================
+DiskStreamingEngine::DiskStreamingEngine (const int numberOfThreads, const int maxSamplesPerRead_)
+    : maxSamplesPerRead (jmax (1024, maxSamplesPerRead_)),
+      numReads (0), numSamplesRead (0)
+{
+    for (int i = jmax (1, numberOfThreads); --i >= 0;)
+        threads.add (new IOThread (*this));
+
+    for (int i = threads.size(); --i >= 0;)
+        threads.getUnchecked(i)->startThread();
+}
+
+DiskStreamingEngine::~DiskStreamingEngine()
+{
+    // You need to delete all the StreamingAudioSources that use this engine before deleting it!
+    jassert (streams.size() == 0);
+
+    for (int i = threads.size(); --i >= 0;)
+        threads.getUnchecked(i)->signalThreadShouldExit();
+
+    for (int i = threads.size(); --i >= 0;)
+        threads.getUnchecked(i)->stopThread (2000);
+}
+
+int DiskStreamingEngine::getNumStreams() const
+{
+    const ScopedLock sl (lock);
+    return streams.size();
+}
+
+bool DiskStreamingEngine::setThreadPriorities (const int newPriority)
+{
+    bool ok = true;
+
+    for (int i = threads.size(); --i >= 0;)
+        if (! threads.getUnchecked(i)->setPriority (newPriority))
+            ok = false;
+
+    return ok;
+}
+
+DiskStreamingEngine::Statistics DiskStreamingEngine::getStatistics() const
+{
+    Statistics stats;
+    stats.numUnderruns = numUnderruns.get();
+
+    const ScopedLock sl (lock);
+    stats.numStreams = streams.size();
+    stats.numReads = numReads;
+    stats.numSamplesRead = numSamplesRead;
+
+    if (streams.size() > 0)
+    {
+        float total = 0, lowest = 1.0f;
+
+        for (int i = streams.size(); --i >= 0;)
+        {
+            const float level = streams.getUnchecked(i)->getFillLevel();
+            total += level;
+            lowest = jmin (lowest, level);
+        }
+
+        stats.averageFillLevel = total / streams.size();
+        stats.lowestFillLevel = lowest;
+    }
+
+    return stats;
+}
+
+void DiskStreamingEngine::resetStatistics()
+{
+    numUnderruns = 0;
+
+    const ScopedLock sl (lock);
+    numReads = 0;
+    numSamplesRead = 0;
+}
+
+void DiskStreamingEngine::addStream (StreamingAudioSource* const stream)
+{
+    {
+        const ScopedLock sl (lock);
+        streams.addIfNotAlreadyThere (stream);
+    }
+
+    wakeUpThreads();
+}
+
+void DiskStreamingEngine::removeStream (StreamingAudioSource* const stream)
+{
+    for (;;)
+    {
+        {
+            const ScopedLock sl (lock);
+
+            // if a thread is in the middle of filling this stream, we have to let it finish first
+            if (! stream->isBeingFilled)
+            {
+                streams.removeFirstMatchingValue (stream);
+                return;
+            }
+        }
+
+        readFinished.wait (2);
+    }
+}
+
+void DiskStreamingEngine::wakeUpThreads()
+{
+    for (int i = threads.size(); --i >= 0;)
+        threads.getUnchecked(i)->notify();
+}
+
+StreamingAudioSource* DiskStreamingEngine::getNextStreamToFill()
+{
+    const ScopedLock sl (lock);
+
+    StreamingAudioSource* mostUrgent = nullptr;
+    double shortestTimeLeft = 0;
+
+    for (int i = streams.size(); --i >= 0;)
+    {
+        StreamingAudioSource* const s = streams.getUnchecked(i);
+        double timeLeft;
+
+        if (s->needsFilling (timeLeft)
+             && (mostUrgent == nullptr || timeLeft < shortestTimeLeft))
+        {
+            mostUrgent = s;
+            shortestTimeLeft = timeLeft;
+        }
+    }
+
+    if (mostUrgent != nullptr)
+        mostUrgent->isBeingFilled = true;
+
+    return mostUrgent;
+}
+
+void DiskStreamingEngine::finishedFilling (StreamingAudioSource* const stream, const int numSamples)
+{
+    {
+        const ScopedLock sl (lock);
+        stream->isBeingFilled = false;
+
+        if (numSamples > 0)
+        {
+            ++numReads;
+            numSamplesRead += numSamples;
+        }
+    }
+
+    readFinished.signal();
+}
@@ -0,0 +1,130 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+
+#ifndef __JUCE_DISKSTREAMINGENGINE_JUCEHEADER__
+#define __JUCE_DISKSTREAMINGENGINE_JUCEHEADER__
+
+class StreamingAudioSource;
+
+
+//==============================================================================
+/**
+    A pool of background threads that keeps a set of StreamingAudioSource objects
+    filled with data.
+
+    Rather than visiting its sources in turn like a TimeSliceThread, each of the engine's
+    threads always picks the source that is closest to running out of buffered audio,
+    and tops it up with a single large sequential read. This lets a few threads keep
+    hundreds of streams going without starving the ones that are about to underrun.
+
+    Create one engine for your app, and pass it to each StreamingAudioSource that
+    you create. The engine must not be deleted until all of its sources have gone.
+
+    @see StreamingAudioSource, BufferingAudioSource
+*/
+class JUCE_API  DiskStreamingEngine
+{
+public:
+    //==============================================================================
+    /** Creates an engine and starts its threads.
+
+        @param numberOfThreads      the number of I/O threads to run
+        @param maxSamplesPerRead    the largest number of samples that will be read from a
+                                    source in one go. Bigger reads are more efficient, but
+                                    keep a thread busy for longer
+    */
+    DiskStreamingEngine (int numberOfThreads = 2, int maxSamplesPerRead = 32768);
+
+    /** Destructor. */
+    ~DiskStreamingEngine();
+
+    //==============================================================================
+    /** Returns the number of I/O threads that the engine is running. */
+    int getNumThreads() const noexcept                  { return threads.size(); }
+
+    /** Returns the number of sources that are currently being streamed. */
+    int getNumStreams() const;
+
+    /** Changes the priority of the engine's threads.
+        @see Thread::setPriority
+    */
+    bool setThreadPriorities (int newPriority);
+
+    //==============================================================================
+    /** Some statistics about how well the engine is keeping up.
+        @see getStatistics
+    */
+    struct Statistics
+    {
+        Statistics() noexcept
+            : numStreams (0), numUnderruns (0), numReads (0), numSamplesRead (0),
+              averageFillLevel (0), lowestFillLevel (0)
+        {}
+
+        int numStreams;             /**< The number of sources currently being streamed. */
+        int numUnderruns;           /**< The number of audio blocks that couldn't be completely
+                                         filled because data wasn't ready in time. */
+        int64 numReads;             /**< The number of reads that have been made from the sources. */
+        int64 numSamplesRead;       /**< The total number of samples that have been read. */
+        float averageFillLevel;     /**< The mean proportion (0 to 1) of each source's buffer that's full. */
+        float lowestFillLevel;      /**< The emptiest source's buffer fill level (0 to 1). */
+    };
+
+    /** Returns the engine's current statistics.
+        The counters are totals since the engine was created, or since resetStatistics()
+        was last called; the fill levels are measured when this method is called.
+    */
+    Statistics getStatistics() const;
+
+    /** Resets the underrun and read counters. */
+    void resetStatistics();
+
+private:
+    //==============================================================================
+    class IOThread;
+    friend class IOThread;
+    friend class StreamingAudioSource;
+    friend class OwnedArray<IOThread>;
+    OwnedArray<IOThread> threads;
+
+    CriticalSection lock;
+    Array<StreamingAudioSource*> streams;
+    WaitableEvent readFinished;
+    const int maxSamplesPerRead;
+
+    Atomic<int> numUnderruns;
+    int64 numReads, numSamplesRead;
+
+    void addStream (StreamingAudioSource*);
+    void removeStream (StreamingAudioSource*);
+    void wakeUpThreads();
+    StreamingAudioSource* getNextStreamToFill();
+    void finishedFilling (StreamingAudioSource*, int numSamplesRead);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DiskStreamingEngine)
+};
+
+
+#endif   // __JUCE_DISKSTREAMINGENGINE_JUCEHEADER__
@@ -24,12 +24,10 @@
 
 IIRFilterAudioSource::IIRFilterAudioSource (AudioSource* const inputSource,
                                             const bool deleteInputWhenDeleted)
-    : input (inputSource, deleteInputWhenDeleted)
+    : input (inputSource, deleteInputWhenDeleted),
+      filters (2, 1)
 {
     jassert (inputSource != nullptr);
-
-    for (int i = 2; --i >= 0;)
-        iirFilters.add (new IIRFilter());
 }
 
 IIRFilterAudioSource::~IIRFilterAudioSource()  {}
@@ -37,14 +35,12 @@ IIRFilterAudioSource::~IIRFilterAudioSource()  {}
 //==============================================================================
 void IIRFilterAudioSource::setCoefficients (const IIRCoefficients& newCoefficients)
 {
-    for (int i = iirFilters.size(); --i >= 0;)
-        iirFilters.getUnchecked(i)->setCoefficients (newCoefficients);
+    filters.setCoefficients (0, newCoefficients);
 }
 
 void IIRFilterAudioSource::makeInactive()
 {
-    for (int i = iirFilters.size(); --i >= 0;)
-        iirFilters.getUnchecked(i)->makeInactive();
+    filters.makeInactive();
 }
 
 //==============================================================================
@@ -52,8 +48,7 @@ void IIRFilterAudioSource::prepareToPlay (int samplesPerBlockExpected, double sa
 {
     input->prepareToPlay (samplesPerBlockExpected, sampleRate);
 
-    for (int i = iirFilters.size(); --i >= 0;)
-        iirFilters.getUnchecked(i)->reset();
+    filters.reset();
 }
 
 void IIRFilterAudioSource::releaseResources()
@@ -67,11 +62,8 @@ void IIRFilterAudioSource::getNextAudioBlock (const AudioSourceChannelInfo& buff
 
     const int numChannels = bufferToFill.buffer->getNumChannels();
 
-    while (numChannels > iirFilters.size())
-        iirFilters.add (new IIRFilter (*iirFilters.getUnchecked (0)));
+    if (numChannels > filters.getNumChannels())
+        filters.setSize (numChannels, filters.getNumStages());
 
-    for (int i = 0; i < numChannels; ++i)
-        iirFilters.getUnchecked(i)
-            ->processSamples (bufferToFill.buffer->getSampleData (i, bufferToFill.startSample),
-                              bufferToFill.numSamples);
+    filters.processSamples (*bufferToFill.buffer, bufferToFill.startSample, bufferToFill.numSamples);
 }
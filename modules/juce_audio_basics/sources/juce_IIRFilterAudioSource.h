@@ -32,6 +32,9 @@
 //==============================================================================
 /**
     An AudioSource that performs an IIR filter on another source.
+
+    The filtering is done by an IIRFilterCascade, so you can also give it more than
+    one filter stage, and change the coefficients smoothly while it's playing.
 */
 class JUCE_API  IIRFilterAudioSource  : public AudioSource
 {
@@ -53,9 +56,18 @@ public:
     /** Changes the filter to use the same parameters as the one being passed in. */
     void setCoefficients (const IIRCoefficients& newCoefficients);
 
-    /** Calls IIRFilter::makeInactive() on all the filters being used internally. */
+    /** Makes all the filter stages inactive, so that the input passes through unchanged. */
     void makeInactive();
 
+    /** Returns the IIRFilterCascade that is used to filter the input.
+
+        You can use this to set the coefficients of each stage, or to smooth the changes
+        that are made to them. It's safe to change the coefficients while the source is
+        playing, but the number of channels and stages should only be changed before
+        prepareToPlay() is called.
+    */
+    IIRFilterCascade& getFilters() noexcept                 { return filters; }
+
     //==============================================================================
     void prepareToPlay (int samplesPerBlockExpected, double sampleRate);
     void releaseResources();
@@ -64,7 +76,7 @@ public:
 private:
     //==============================================================================
     OptionalScopedPointer<AudioSource> input;
-    OwnedArray <IIRFilter> iirFilters;
+    IIRFilterCascade filters;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (IIRFilterAudioSource)
 };
@@ -0,0 +1,340 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+
+struct LockFreeMixerAudioSource::Input
+{
+    Input (AudioSource* const source_, const bool deleteWhenRemoved, const float gain)
+        : source (source_, deleteWhenRemoved), currentGain (gain), buffer (2, 0)
+    {
+        targetGain = gain;
+    }
+
+    OptionalScopedPointer<AudioSource> source;
+    Atomic<float> targetGain;
+    float currentGain;           // (only used by the audio thread)
+    AudioSampleBuffer buffer;    // used when the inputs are being rendered in parallel
+
+    JUCE_DECLARE_NON_COPYABLE (Input)
+};
+
+// An immutable copy of the list of inputs and settings, for the audio thread to use.
+struct LockFreeMixerAudioSource::Snapshot
+{
+    Snapshot (const OwnedArray<Input>& inputs_, ThreadPool* const threadPool_, const int minimumInputsForPool_)
+        : threadPool (threadPool_), minimumInputsForPool (minimumInputsForPool_)
+    {
+        inputs.ensureStorageAllocated (inputs_.size());
+
+        for (int i = 0; i < inputs_.size(); ++i)
+            inputs.add (inputs_.getUnchecked (i));
+    }
+
+    Array<Input*> inputs;
+    ThreadPool* const threadPool;
+    const int minimumInputsForPool;
+
+    JUCE_DECLARE_NON_COPYABLE (Snapshot)
+};
+
+class LockFreeMixerAudioSource::InputRenderer
+{
+public:
+    InputRenderer (const Array<Input*>& inputs_, const int numChannels_, const int numSamples_) noexcept
+        : inputs (inputs_), numChannels (numChannels_), numSamples (numSamples_)
+    {
+    }
+
+    void operator() (const int index) const
+    {
+        Input& input = *inputs.getUnchecked (index);
+        input.buffer.setSize (numChannels, numSamples, false, false, true);
+
+        AudioSourceChannelInfo info (&input.buffer, 0, numSamples);
+        input.source->getNextAudioBlock (info);
+    }
+
+private:
+    const Array<Input*>& inputs;
+    const int numChannels, numSamples;
+};
+
+//==============================================================================
+LockFreeMixerAudioSource::LockFreeMixerAudioSource()
+    : tempBuffer (2, 0),
+      currentSampleRate (0.0),
+      bufferSizeExpected (0),
+      threadPool (nullptr),
+      minimumInputsForPool (0)
+{
+    publishedSnapshot = new Snapshot (inputs, nullptr, 0);
+    latestSnapshot = publishedSnapshot;
+}
+
+LockFreeMixerAudioSource::~LockFreeMixerAudioSource()
+{
+    removeAllInputs();
+}
+
+//==============================================================================
+void LockFreeMixerAudioSource::addInputSource (AudioSource* const input, const bool deleteWhenRemoved, const float gain)
+{
+    if (input != nullptr)
+    {
+        double localRate;
+        int localBufferSize;
+
+        {
+            const ScopedLock sl (lock);
+
+            if (findInput (input) != nullptr)
+                return;
+
+            localRate = currentSampleRate;
+            localBufferSize = bufferSizeExpected;
+        }
+
+        ScopedPointer<Input> newInput (new Input (input, deleteWhenRemoved, gain));
+
+        if (localRate > 0.0)
+        {
+            input->prepareToPlay (localBufferSize, localRate);
+            newInput->buffer.setSize (2, localBufferSize);
+        }
+
+        const ScopedLock sl (lock);
+        inputs.add (newInput.release());
+        publishSnapshot();
+    }
+}
+
+void LockFreeMixerAudioSource::removeInputSource (AudioSource* const input)
+{
+    if (input != nullptr)
+    {
+        ScopedPointer<Input> removed;
+
+        {
+            const ScopedLock sl (lock);
+            const int index = inputs.indexOf (findInput (input));
+
+            if (index < 0)
+                return;
+
+            removed = inputs.removeAndReturn (index);
+            publishSnapshot();
+        }
+
+        input->releaseResources();
+    }
+}
+
+void LockFreeMixerAudioSource::removeAllInputs()
+{
+    OwnedArray<Input> removed;
+
+    {
+        const ScopedLock sl (lock);
+        removed.swapWithArray (inputs);
+        publishSnapshot();
+    }
+
+    for (int i = removed.size(); --i >= 0;)
+        removed.getUnchecked (i)->source->releaseResources();
+}
+
+int LockFreeMixerAudioSource::getNumInputs() const
+{
+    const ScopedLock sl (lock);
+    return inputs.size();
+}
+
+void LockFreeMixerAudioSource::setInputGain (AudioSource* const input, const float newGain)
+{
+    const ScopedLock sl (lock);
+
+    if (Input* const i = findInput (input))
+        i->targetGain = newGain;
+}
+
+float LockFreeMixerAudioSource::getInputGain (AudioSource* const input) const
+{
+    const ScopedLock sl (lock);
+
+    if (Input* const i = findInput (input))
+        return i->targetGain.get();
+
+    return 0;
+}
+
+void LockFreeMixerAudioSource::setThreadPool (ThreadPool* const newThreadPool, const int minimumInputs)
+{
+    const ScopedLock sl (lock);
+    threadPool = newThreadPool;
+    minimumInputsForPool = jmax (1, minimumInputs);
+    publishSnapshot();
+}
+
+LockFreeMixerAudioSource::Input* LockFreeMixerAudioSource::findInput (AudioSource* const source) const noexcept
+{
+    for (int i = inputs.size(); --i >= 0;)
+        if (inputs.getUnchecked (i)->source == source)
+            return inputs.getUnchecked (i);
+
+    return nullptr;
+}
+
+//==============================================================================
+/*  The audio thread announces which snapshot it's using in snapshotInUse, and then
+    checks that it's still the latest one, so once a new snapshot has been published,
+    the audio thread can only be holding the old one if it already announced it. This
+    must be called with the lock held, so that there's only ever one old snapshot to
+    wait for.
+*/
+void LockFreeMixerAudioSource::publishSnapshot()
+{
+    ScopedPointer<Snapshot> oldSnapshot (publishedSnapshot.release());
+    publishedSnapshot = new Snapshot (inputs, threadPool, minimumInputsForPool);
+    latestSnapshot = publishedSnapshot;
+
+    for (int spins = 0; snapshotInUse.get() == oldSnapshot; ++spins)
+    {
+        if (spins < 100)
+            Thread::yield();
+        else
+            Thread::sleep (1);
+    }
+}
+
+LockFreeMixerAudioSource::Snapshot* LockFreeMixerAudioSource::acquireSnapshot() noexcept
+{
+    for (;;)
+    {
+        Snapshot* const snapshot = latestSnapshot.get();
+        snapshotInUse = snapshot;
+
+        if (latestSnapshot.get() == snapshot)
+            return snapshot;
+    }
+}
+
+//==============================================================================
+void LockFreeMixerAudioSource::prepareToPlay (int samplesPerBlockExpected, double sampleRate)
+{
+    tempBuffer.setSize (2, samplesPerBlockExpected);
+
+    const ScopedLock sl (lock);
+
+    currentSampleRate = sampleRate;
+    bufferSizeExpected = samplesPerBlockExpected;
+
+    for (int i = inputs.size(); --i >= 0;)
+    {
+        Input& input = *inputs.getUnchecked (i);
+        input.source->prepareToPlay (samplesPerBlockExpected, sampleRate);
+        input.buffer.setSize (2, samplesPerBlockExpected);
+    }
+}
+
+void LockFreeMixerAudioSource::releaseResources()
+{
+    const ScopedLock sl (lock);
+
+    for (int i = inputs.size(); --i >= 0;)
+    {
+        Input& input = *inputs.getUnchecked (i);
+        input.source->releaseResources();
+        input.buffer.setSize (2, 0);
+    }
+
+    tempBuffer.setSize (2, 0);
+
+    currentSampleRate = 0;
+    bufferSizeExpected = 0;
+}
+
+void LockFreeMixerAudioSource::mixInput (Input& input, const AudioSampleBuffer& source,
+                                         const AudioSourceChannelInfo& info) noexcept
+{
+    const float newGain = input.targetGain.get();
+
+    for (int chan = 0; chan < info.buffer->getNumChannels(); ++chan)
+        info.buffer->addFromWithRamp (chan, info.startSample, source.getSampleData (chan),
+                                      info.numSamples, input.currentGain, newGain);
+
+    input.currentGain = newGain;
+}
+
+void LockFreeMixerAudioSource::getNextAudioBlock (const AudioSourceChannelInfo& info)
+{
+    const Snapshot& snapshot = *acquireSnapshot();
+    const Array<Input*>& activeInputs = snapshot.inputs;
+
+    if (activeInputs.size() == 0)
+    {
+        info.clearActiveBufferRegion();
+    }
+    else if (snapshot.threadPool != nullptr && activeInputs.size() >= snapshot.minimumInputsForPool)
+    {
+        snapshot.threadPool->parallelFor (0, activeInputs.size(),
+                                          InputRenderer (activeInputs, jmax (1, info.buffer->getNumChannels()),
+                                                         info.numSamples), 1);
+
+        info.clearActiveBufferRegion();
+
+        for (int i = 0; i < activeInputs.size(); ++i)
+            mixInput (*activeInputs.getUnchecked (i), activeInputs.getUnchecked (i)->buffer, info);
+    }
+    else
+    {
+        int firstToMix = 0;
+        Input& firstInput = *activeInputs.getUnchecked (0);
+
+        // if the first input's gain is steady at 1.0, it can go straight into the output..
+        if (firstInput.currentGain == 1.0f && firstInput.targetGain.get() == 1.0f)
+        {
+            firstInput.source->getNextAudioBlock (info);
+            firstToMix = 1;
+        }
+        else
+        {
+            info.clearActiveBufferRegion();
+        }
+
+        if (firstToMix < activeInputs.size())
+        {
+            tempBuffer.setSize (jmax (1, info.buffer->getNumChannels()), info.numSamples, false, false, true);
+            AudioSourceChannelInfo info2 (&tempBuffer, 0, info.numSamples);
+
+            for (int i = firstToMix; i < activeInputs.size(); ++i)
+            {
+                Input& input = *activeInputs.getUnchecked (i);
+                input.source->getNextAudioBlock (info2);
+                mixInput (input, tempBuffer, info);
+            }
+        }
+    }
+
+    snapshotInUse = nullptr;
+}
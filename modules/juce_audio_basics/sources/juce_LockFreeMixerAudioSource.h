@@ -0,0 +1,157 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+
+#ifndef __JUCE_LOCKFREEMIXERAUDIOSOURCE_JUCEHEADER__
+#define __JUCE_LOCKFREEMIXERAUDIOSOURCE_JUCEHEADER__
+
+#include "juce_AudioSource.h"
+
+
+//==============================================================================
+/**
+    An AudioSource that mixes together a set of other AudioSources, without its
+    audio callback ever having to wait for a lock.
+
+    This does the same job as a MixerAudioSource, but when inputs are added or removed,
+    the mixer publishes a new copy of its list of inputs, which getNextAudioBlock() picks
+    up at the start of its next block. Instead of the audio thread waiting for the
+    thread that's changing the list, it's the other way round: removeInputSource() waits
+    until the audio thread can no longer be using the source before releasing it. (That
+    means that inputs mustn't be added or removed from inside getNextAudioBlock()).
+
+    Each input has a gain, and changes to it are ramped smoothly over the next block.
+
+    If you're mixing a lot of inputs, you can give the mixer a ThreadPool with
+    setThreadPool(), and it'll then pull the inputs' audio in parallel.
+
+    @see MixerAudioSource
+*/
+class JUCE_API  LockFreeMixerAudioSource  : public AudioSource
+{
+public:
+    //==============================================================================
+    /** Creates a LockFreeMixerAudioSource. */
+    LockFreeMixerAudioSource();
+
+    /** Destructor. */
+    ~LockFreeMixerAudioSource();
+
+    //==============================================================================
+    /** Adds an input source to the mixer.
+
+        As with MixerAudioSource, if the mixer is running the new source will have its
+        prepareToPlay() method called before it's added, otherwise this happens when the
+        mixer's own prepareToPlay() method is called.
+
+        @param newInput             the source to add to the mixer
+        @param deleteWhenRemoved    if true, then this source will be deleted when
+                                    no longer needed by the mixer.
+        @param gain                 the gain to apply to this input
+    */
+    void addInputSource (AudioSource* newInput, bool deleteWhenRemoved, float gain = 1.0f);
+
+    /** Removes an input source.
+
+        This waits until the audio thread has finished with the source (which can take up
+        to the length of one block) and then calls its releaseResources() method. If the
+        source was added with the deleteWhenRemoved flag set, it is then deleted.
+    */
+    void removeInputSource (AudioSource* input);
+
+    /** Removes all the input sources.
+        Any sources which were added by calling addInputSource() with the deleteWhenRemoved
+        flag set will be deleted by this method.
+    */
+    void removeAllInputs();
+
+    /** Returns the number of inputs that have been added. */
+    int getNumInputs() const;
+
+    /** Changes the gain that is applied to one of the inputs.
+        This can be called at any time, and the gain will be ramped towards the new
+        value over the course of the next block that the mixer produces.
+    */
+    void setInputGain (AudioSource* input, float newGain);
+
+    /** Returns the gain that was last set for one of the inputs.
+        If the source isn't one of the mixer's inputs, this returns 0.
+    */
+    float getInputGain (AudioSource* input) const;
+
+    //==============================================================================
+    /** Makes getNextAudioBlock() pull the inputs' audio on a thread pool.
+
+        When there are at least minimumInputsForPool inputs, each one is rendered into
+        its own buffer by one of the pool's threads, and these are then added together.
+        For this to work, the inputs mustn't share any state that their getNextAudioBlock()
+        methods change.
+
+        The pool isn't owned by the mixer, and must remain valid until you call this
+        again with a nullptr.
+    */
+    void setThreadPool (ThreadPool* threadPool, int minimumInputsForPool = 4);
+
+    //==============================================================================
+    /** Implementation of the AudioSource method.
+        This will call prepareToPlay() on all its input sources.
+    */
+    void prepareToPlay (int samplesPerBlockExpected, double sampleRate);
+
+    /** Implementation of the AudioSource method.
+        This will call releaseResources() on all its input sources.
+    */
+    void releaseResources();
+
+    /** Implementation of the AudioSource method. */
+    void getNextAudioBlock (const AudioSourceChannelInfo& bufferToFill);
+
+private:
+    //==============================================================================
+    struct Input;
+    struct Snapshot;
+    class InputRenderer;
+    friend class OwnedArray<Input>;
+    friend class ScopedPointer<Snapshot>;
+
+    OwnedArray<Input> inputs;
+    CriticalSection lock;
+    ScopedPointer<Snapshot> publishedSnapshot;
+    Atomic<Snapshot*> latestSnapshot, snapshotInUse;
+    AudioSampleBuffer tempBuffer;
+    double currentSampleRate;
+    int bufferSizeExpected;
+    ThreadPool* threadPool;
+    int minimumInputsForPool;
+
+    Input* findInput (AudioSource*) const noexcept;
+    void publishSnapshot();
+    Snapshot* acquireSnapshot() noexcept;
+    void mixInput (Input&, const AudioSampleBuffer&, const AudioSourceChannelInfo&) noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LockFreeMixerAudioSource)
+};
+
+
+#endif   // __JUCE_LOCKFREEMIXERAUDIOSOURCE_JUCEHEADER__
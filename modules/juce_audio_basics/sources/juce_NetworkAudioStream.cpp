@@ -0,0 +1,768 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+
+namespace NetworkAudioHelpers
+{
+    enum
+    {
+        magicNumber = 0x5341614a,       // "JaAS"
+        headerSize = 24,
+        maxPacketSize = 1400,           // keeps each datagram inside a typical ethernet MTU
+        maxPayloadSize = maxPacketSize - headerSize,
+        maxPacketsPerWrite = 32,
+        maxPacketsPerRead = 32
+    };
+
+    struct PacketHeader
+    {
+        uint32 sequenceNumber;
+        int64 samplePosition;
+        uint32 sampleRate;
+        int numChannels, encoding, numSamples;
+    };
+
+    static void writeHeader (char* d, const PacketHeader& h) noexcept
+    {
+        *(uint32*) d        = ByteOrder::swapIfBigEndian ((uint32) magicNumber);
+        *(uint32*) (d + 4)  = ByteOrder::swapIfBigEndian (h.sequenceNumber);
+        *(uint64*) (d + 8)  = ByteOrder::swapIfBigEndian ((uint64) h.samplePosition);
+        *(uint32*) (d + 16) = ByteOrder::swapIfBigEndian (h.sampleRate);
+        d[20] = (char) h.numChannels;
+        d[21] = (char) h.encoding;
+        *(uint16*) (d + 22) = ByteOrder::swapIfBigEndian ((uint16) h.numSamples);
+    }
+
+    static bool readHeader (const char* d, const int size, PacketHeader& h) noexcept
+    {
+        if (size < headerSize || ByteOrder::littleEndianInt (d) != (uint32) magicNumber)
+            return false;
+
+        h.sequenceNumber = ByteOrder::littleEndianInt (d + 4);
+        h.samplePosition = (int64) ByteOrder::swapIfBigEndian (*(const uint64*) (d + 8));
+        h.sampleRate     = ByteOrder::littleEndianInt (d + 16);
+        h.numChannels    = (uint8) d[20];
+        h.encoding       = (uint8) d[21];
+        h.numSamples     = ByteOrder::littleEndianShort (d + 22);
+
+        return h.numChannels > 0 && h.numSamples > 0 && h.samplePosition >= 0
+                && h.sampleRate >= 1000 && h.sampleRate <= 1000000
+                && h.encoding <= NetworkAudioSender::compressed16Bit;
+    }
+
+    static inline int floatToInt16 (const float s) noexcept
+    {
+        return jlimit (-32768, 32767, roundToInt (s * 32767.0f));
+    }
+
+    // The compressed format stores the frames interleaved, and codes the difference between
+    // each channel's 16-bit sample and its previous one, zigzagged so that small negative
+    // values are small too, as a little-endian base-128 varint. A delta needs at most 17 bits,
+    // so no sample takes more than 3 bytes, and quiet or low-frequency material takes fewer.
+    static inline char* writeDelta (char* d, const int delta) noexcept
+    {
+        uint32 v = ((uint32) delta << 1) ^ (uint32) (delta >> 31);
+
+        while (v >= 0x80)
+        {
+            *d++ = (char) (v | 0x80);
+            v >>= 7;
+        }
+
+        *d++ = (char) v;
+        return d;
+    }
+
+    static inline const char* readDelta (const char* d, const char* const end, int& delta) noexcept
+    {
+        uint32 v = 0;
+
+        for (int shift = 0;; shift += 7)
+        {
+            if (d >= end || shift > 14)
+                return nullptr;
+
+            const uint8 byte = (uint8) *d++;
+            v |= (uint32) (byte & 0x7f) << shift;
+
+            if ((byte & 0x80) == 0)
+                break;
+        }
+
+        delta = (int) (v >> 1) ^ -(int) (v & 1);
+        return d;
+    }
+
+    // Returns the smallest number of bytes that a sample can take.
+    static int getBytesPerSample (const int encoding) noexcept
+    {
+        return encoding == NetworkAudioSender::floatingPoint32Bit ? 4
+                                                                  : (encoding == NetworkAudioSender::integer16Bit ? 2 : 1);
+    }
+
+    static bool decodePacket (const char* d, const char* const end, const PacketHeader& header,
+                              float* const* const dest, const int numDestChannels) noexcept
+    {
+        const int numSamples = header.numSamples;
+
+        if (header.encoding == NetworkAudioSender::compressed16Bit)
+        {
+            int last [256] = { 0 };
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                for (int chan = 0; chan < header.numChannels; ++chan)
+                {
+                    int delta;
+                    if ((d = readDelta (d, end, delta)) == nullptr)
+                        return false;
+
+                    const int sample = (last[chan] += delta);
+
+                    if (sample < -32768 || sample > 32767)
+                        return false;
+
+                    if (chan < numDestChannels)
+                        dest[chan][i] = sample * (1.0f / 32767.0f);
+                }
+            }
+
+            return true;
+        }
+
+        if (end - d < header.numChannels * numSamples * getBytesPerSample (header.encoding))
+            return false;
+
+        for (int chan = 0; chan < jmin (numDestChannels, header.numChannels); ++chan)
+        {
+            float* const samples = dest[chan];
+
+            if (header.encoding == NetworkAudioSender::floatingPoint32Bit)
+            {
+                for (int i = 0; i < numSamples; ++i, d += 4)
+                {
+                    const uint32 bits = ByteOrder::littleEndianInt (d);
+                    memcpy (samples + i, &bits, sizeof (float));
+                }
+            }
+            else
+            {
+                for (int i = 0; i < numSamples; ++i, d += 2)
+                    samples[i] = ((int16) ByteOrder::littleEndianShort (d)) * (1.0f / 32767.0f);
+            }
+        }
+
+        return true;
+    }
+}
+
+//==============================================================================
+NetworkAudioSender::NetworkAudioSender (AudioSource* const inputSource,
+                                        const bool deleteInputWhenDeleted,
+                                        const int numChannels_,
+                                        const Encoding encoding_)
+    : input (inputSource, deleteInputWhenDeleted),
+      numChannels (jlimit (1, 32, numChannels_)),
+      encoding ((int) encoding_),
+      sampleRate (44100.0),
+      nextSequenceNumber (0),
+      nextSamplePosition (0),
+      packets ((size_t) NetworkAudioHelpers::maxPacketsPerWrite * NetworkAudioHelpers::maxPacketSize),
+      datagrams ((size_t) NetworkAudioHelpers::maxPacketsPerWrite)
+{
+    jassert (numChannels_ == numChannels); // only up to 32 channels can be sent
+}
+
+NetworkAudioSender::~NetworkAudioSender()
+{
+}
+
+bool NetworkAudioSender::connect (const String& hostName, const int portNumber)
+{
+    // (resolving the address may take a while, so this is done before taking the lock)
+    ScopedPointer<DatagramSocket> newSocket (new DatagramSocket (0));
+
+    if (! newSocket->connect (hostName, portNumber))
+        return false;
+
+    const ScopedLock sl (socketLock);
+    socket.swapWith (newSocket);
+    return true;
+}
+
+void NetworkAudioSender::disconnect()
+{
+    ScopedPointer<DatagramSocket> oldSocket;
+
+    {
+        const ScopedLock sl (socketLock);
+        socket.swapWith (oldSocket);
+    }
+}
+
+bool NetworkAudioSender::isConnected() const noexcept
+{
+    return socket != nullptr;
+}
+
+void NetworkAudioSender::setEncoding (const Encoding newEncoding) noexcept
+{
+    encoding = (int) newEncoding;
+}
+
+NetworkAudioSender::Statistics NetworkAudioSender::getStatistics() const noexcept
+{
+    Statistics s;
+    s.packetsSent = packetsSent.get();
+    s.bytesSent   = bytesSent.get();
+    s.sendErrors  = sendErrors.get();
+    s.samplesSent = samplesSent.get();
+    return s;
+}
+
+int NetworkAudioSender::getMaxSamplesPerPacket (const int enc) const noexcept
+{
+    return jmin (65535, NetworkAudioHelpers::maxPayloadSize
+                          / (numChannels * NetworkAudioHelpers::getBytesPerSample (enc)));
+}
+
+int NetworkAudioSender::writePacket (char* const dest, const AudioSampleBuffer& buffer,
+                                     const int startSample, int& numSamples, const int enc)
+{
+    using namespace NetworkAudioHelpers;
+
+    const int numSourceChannels = jmin (numChannels, buffer.getNumChannels());
+    char* d = dest + headerSize;
+
+    if (enc == compressed16Bit)
+    {
+        const char* const limit = dest + maxPacketSize - 3 * numChannels;
+        int last [32] = { 0 };
+        int i = 0;
+
+        for (; i < numSamples && d <= limit; ++i)
+        {
+            for (int chan = 0; chan < numChannels; ++chan)
+            {
+                const int sample = chan < numSourceChannels ? floatToInt16 (buffer.getSampleData (chan, startSample)[i]) : 0;
+                d = writeDelta (d, sample - last[chan]);
+                last[chan] = sample;
+            }
+        }
+
+        numSamples = i;
+    }
+    else
+    {
+        for (int chan = 0; chan < numChannels; ++chan)
+        {
+            if (chan >= numSourceChannels)
+            {
+                const size_t bytes = (size_t) getBytesPerSample (enc) * (size_t) numSamples;
+                zeromem (d, bytes);
+                d += bytes;
+                continue;
+            }
+
+            const float* const src = buffer.getSampleData (chan, startSample);
+
+            if (enc == floatingPoint32Bit)
+            {
+                for (int i = 0; i < numSamples; ++i, d += 4)
+                    *(uint32*) d = ByteOrder::swapIfBigEndian (*(const uint32*) (src + i));
+            }
+            else
+            {
+                for (int i = 0; i < numSamples; ++i, d += 2)
+                    *(uint16*) d = ByteOrder::swapIfBigEndian ((uint16) floatToInt16 (src[i]));
+            }
+        }
+    }
+
+    PacketHeader header;
+    header.sequenceNumber = nextSequenceNumber++;
+    header.samplePosition = nextSamplePosition;
+    header.sampleRate     = (uint32) roundToInt (sampleRate);
+    header.numChannels    = numChannels;
+    header.encoding       = enc;
+    header.numSamples     = numSamples;
+    writeHeader (dest, header);
+
+    nextSamplePosition += numSamples;
+    return (int) (d - dest);
+}
+
+void NetworkAudioSender::sendAudio (const AudioSampleBuffer& buffer, int startSample, int numSamples)
+{
+    const ScopedLock sl (socketLock);
+
+    if (socket == nullptr)
+    {
+        nextSamplePosition += numSamples;
+        return;
+    }
+
+    const int enc = encoding.get();
+    const int maxSamplesPerPacket = getMaxSamplesPerPacket (enc);
+
+    while (numSamples > 0)
+    {
+        int numPackets = 0;
+
+        while (numSamples > 0 && numPackets < NetworkAudioHelpers::maxPacketsPerWrite)
+        {
+            int num = jmin (numSamples, maxSamplesPerPacket);
+            char* const dest = packets + numPackets * NetworkAudioHelpers::maxPacketSize;
+
+            datagrams[numPackets++] = SocketBuffer (dest, writePacket (dest, buffer, startSample, num, enc));
+            startSample += num;
+            numSamples -= num;
+            samplesSent += num;
+        }
+
+        const int numSent = jmax (0, socket->writeMultiple (datagrams, numPackets));
+
+        for (int i = 0; i < numSent; ++i)
+            bytesSent += datagrams[i].size;
+
+        packetsSent += numSent;
+        sendErrors += numPackets - numSent;
+    }
+}
+
+void NetworkAudioSender::prepareToPlay (int samplesPerBlockExpected, double newSampleRate)
+{
+    sampleRate = newSampleRate;
+
+    if (input != nullptr)
+        input->prepareToPlay (samplesPerBlockExpected, newSampleRate);
+}
+
+void NetworkAudioSender::releaseResources()
+{
+    if (input != nullptr)
+        input->releaseResources();
+}
+
+void NetworkAudioSender::getNextAudioBlock (const AudioSourceChannelInfo& info)
+{
+    if (input != nullptr)
+        input->getNextAudioBlock (info);
+    else
+        info.clearActiveBufferRegion();
+
+    sendAudio (*info.buffer, info.startSample, info.numSamples);
+}
+
+//==============================================================================
+NetworkAudioReceiver::NetworkAudioReceiver (const int numChannels_, const double maxBufferSeconds_)
+    : Thread ("Network audio receiver"),
+      numChannels (jlimit (1, 32, numChannels_)),
+      maxBufferSeconds (jmax (0.05, maxBufferSeconds_)),
+      minLatencySeconds (0.005),
+      maxLatencySeconds (maxBufferSeconds * 0.75),
+      streamSampleRate (0),
+      outputSampleRate (44100.0),
+      jitterBuffer (numChannels, 0),
+      resampleInput (numChannels, 0),
+      readPosition (0),
+      bufferEnd (0),
+      numSamplesPlayed (0),
+      isBuffering (true),
+      hasStream (false),
+      lastPacketSize (0),
+      smoothedFillError (0),
+      resamplingRatio (1.0),
+      jitterSamples (0),
+      lastTransitTime (0),
+      baseSequenceNumber (0),
+      highestSequenceNumber (0),
+      packetsExpected (0),
+      packetsReceivedSinceReset (0),
+      packetsLostBeforeReset (0)
+{
+    zerostruct (stats);
+
+    for (int i = 0; i < numChannels; ++i)
+        interpolators.add (new LagrangeInterpolator());
+}
+
+NetworkAudioReceiver::~NetworkAudioReceiver()
+{
+    stopListening();
+}
+
+bool NetworkAudioReceiver::startListening (const int portNumber)
+{
+    stopListening();
+
+    ScopedPointer<DatagramSocket> newSocket (new DatagramSocket (0));
+
+    if (! newSocket->bindToPort (portNumber))
+        return false;
+
+    socket = newSocket;
+    startThread (8);
+    return true;
+}
+
+void NetworkAudioReceiver::stopListening()
+{
+    stopThread (5000);
+    socket = nullptr;
+
+    const ScopedLock sl (lock);
+    hasStream = false;
+    isBuffering = true;
+    streamSampleRate = 0;
+}
+
+void NetworkAudioReceiver::setLatencyRange (double minimumSeconds, double maximumSeconds)
+{
+    // the jitter buffer needs some room to spare above the maximum latency..
+    jassert (maximumSeconds < maxBufferSeconds);
+
+    const ScopedLock sl (lock);
+    minLatencySeconds = jmax (0.0, minimumSeconds);
+    maxLatencySeconds = jlimit (minLatencySeconds, maxBufferSeconds * 0.9, maximumSeconds);
+}
+
+NetworkAudioReceiver::Statistics NetworkAudioReceiver::getStatistics() const
+{
+    const ScopedLock sl (lock);
+
+    Statistics s (stats);
+    s.packetsLost = packetsLostBeforeReset + jmax ((int64) 0, packetsExpected - packetsReceivedSinceReset);
+
+    if (hasStream)
+    {
+        s.jitterSeconds         = jitterSamples / streamSampleRate;
+        s.targetLatencySeconds  = getTargetLatencySamples() / streamSampleRate;
+        s.bufferedSeconds       = (bufferEnd - readPosition) / streamSampleRate;
+        s.resamplingRatio       = resamplingRatio;
+    }
+
+    return s;
+}
+
+int NetworkAudioReceiver::getTargetLatencySamples() const noexcept
+{
+    // enough to cover a few times the mean deviation in arrival times, plus a couple of
+    // packets' worth so that a buffer can always be filled while the next one is on its way
+    const double target = jitterSamples * 4.0 + lastPacketSize * 2.0;
+
+    return roundToInt (jlimit (minLatencySeconds * streamSampleRate,
+                               maxLatencySeconds * streamSampleRate, target));
+}
+
+void NetworkAudioReceiver::resetInterpolators()
+{
+    for (int i = interpolators.size(); --i >= 0;)
+        interpolators.getUnchecked(i)->reset();
+}
+
+void NetworkAudioReceiver::clearBufferRange (int64 start, const int64 end)
+{
+    const int size = jitterBuffer.getNumSamples();
+
+    while (start < end)
+    {
+        const int index = (int) (start % size);
+        const int num = (int) jmin ((int64) (size - index), end - start);
+
+        jitterBuffer.clear (index, num);
+        start += num;
+    }
+}
+
+void NetworkAudioReceiver::resetStream (const int64 startPosition, const uint32 sequenceNumber,
+                                        const double sampleRate, const int numSamplesInBuffer)
+{
+    if (jitterBuffer.getNumSamples() != numSamplesInBuffer)
+        jitterBuffer.setSize (numChannels, numSamplesInBuffer);
+
+    if (hasStream)
+        packetsLostBeforeReset += jmax ((int64) 0, packetsExpected - packetsReceivedSinceReset);
+
+    hasStream = true;
+    isBuffering = true;
+    streamSampleRate = sampleRate;
+    readPosition = startPosition;
+    bufferEnd = startPosition;
+    baseSequenceNumber = sequenceNumber;
+    highestSequenceNumber = sequenceNumber;
+    packetsExpected = 1;
+    packetsReceivedSinceReset = 0;
+    smoothedFillError = 0;
+    jitterSamples = 0;
+    lastTransitTime = 0;
+    resetInterpolators();
+}
+
+void NetworkAudioReceiver::handlePacket (const char* const data, const int size)
+{
+    using namespace NetworkAudioHelpers;
+
+    const double arrivalTime = Time::getMillisecondCounterHiRes() * 0.001;
+    PacketHeader header;
+
+    if ((! readHeader (data, size, header))
+          || header.numSamples > roundToInt (maxBufferSeconds * header.sampleRate) / 4)
+    {
+        const ScopedLock sl (lock);
+        ++stats.packetsInvalid;
+        return;
+    }
+
+    const double rate = (double) header.sampleRate;
+    const int bufferSize = roundToInt (maxBufferSeconds * rate);
+    const int64 start = header.samplePosition;
+    const int64 end = start + header.numSamples;
+
+    const ScopedLock sl (lock);
+
+    if ((! hasStream) || rate != streamSampleRate
+         || end < readPosition - bufferSize || start > bufferEnd + bufferSize)
+    {
+        // either this is the first packet, or the sender has restarted
+        resetStream (start, header.sequenceNumber, rate, bufferSize);
+    }
+
+    ++stats.packetsReceived;
+    ++packetsReceivedSinceReset;
+    lastPacketSize = header.numSamples;
+
+    const int seqDelta = (int) (header.sequenceNumber - highestSequenceNumber);
+
+    if (seqDelta > 0)
+    {
+        packetsExpected += seqDelta;
+        highestSequenceNumber = header.sequenceNumber;
+    }
+    else if (seqDelta < 0)
+    {
+        ++stats.packetsOutOfOrder;
+    }
+
+    // This is the interarrival jitter estimate from RFC 3550: a running mean of the
+    // differences in the packets' transit times, which cancels out any constant offset
+    // between the two machines' clocks.
+    const double transitTime = arrivalTime * rate - (double) start;
+
+    if (packetsReceivedSinceReset > 1)
+        jitterSamples += (std::abs (transitTime - lastTransitTime) - jitterSamples) / 16.0;
+
+    lastTransitTime = transitTime;
+
+    if (end <= readPosition)
+    {
+        ++stats.packetsLate;
+        return;
+    }
+
+    if (end - readPosition > bufferSize)
+    {
+        // the buffer's overflowed, so skip ahead to leave just the target latency
+        ++stats.resyncs;
+        readPosition = jmax (readPosition, end - getTargetLatencySamples());
+        bufferEnd = jmax (bufferEnd, readPosition);
+        resetInterpolators();
+    }
+
+    if (start > bufferEnd)
+        clearBufferRange (bufferEnd, start);   // (leaves silence in place of any lost packets)
+
+    const int64 firstToWrite = jmax (start, readPosition);
+
+    // (the resampler's input buffer is free to use for decoding while the lock is held)
+    const bool useResampleBuffer = resampleInput.getNumSamples() >= header.numSamples;
+    HeapBlock<float> tempBuffer;
+    float* channels [32];
+
+    if (! useResampleBuffer)
+        tempBuffer.malloc ((size_t) (numChannels * header.numSamples));
+
+    for (int chan = 0; chan < numChannels; ++chan)
+        channels[chan] = useResampleBuffer ? resampleInput.getSampleData (chan)
+                                           : tempBuffer + chan * header.numSamples;
+
+    if (! decodePacket (data + headerSize, data + size, header, channels, numChannels))
+    {
+        ++stats.packetsInvalid;
+        clearBufferRange (firstToWrite, end);
+        bufferEnd = jmax (bufferEnd, end);
+        return;
+    }
+
+    for (int chan = 0; chan < numChannels; ++chan)
+    {
+        for (int64 pos = firstToWrite; pos < end;)
+        {
+            const int index = (int) (pos % bufferSize);
+            const int num = (int) jmin ((int64) (bufferSize - index), end - pos);
+
+            if (chan < header.numChannels)
+                jitterBuffer.copyFrom (chan, index, channels[chan] + (pos - start), num);
+            else
+                jitterBuffer.clear (chan, index, num);
+
+            pos += num;
+        }
+    }
+
+    bufferEnd = jmax (bufferEnd, end);
+}
+
+void NetworkAudioReceiver::run()
+{
+    using namespace NetworkAudioHelpers;
+
+    HeapBlock<char> data ((size_t) maxPacketsPerRead * maxPacketSize);
+    SocketBuffer datagrams [maxPacketsPerRead];
+
+    while (! threadShouldExit())
+    {
+        for (int i = 0; i < maxPacketsPerRead; ++i)
+            datagrams[i] = SocketBuffer (data + i * maxPacketSize, maxPacketSize);
+
+        const int numRead = socket->readMultiple (datagrams, maxPacketsPerRead, 100);
+
+        if (numRead < 0)
+        {
+            wait (20);
+            continue;
+        }
+
+        for (int i = 0; i < numRead; ++i)
+            handlePacket (static_cast <const char*> (datagrams[i].data), datagrams[i].size);
+    }
+}
+
+//==============================================================================
+void NetworkAudioReceiver::prepareToPlay (int samplesPerBlockExpected, double sampleRate)
+{
+    const ScopedLock sl (lock);
+
+    outputSampleRate = sampleRate;
+
+    // (big enough for resampling a block from up to 192KHz down to 22.05KHz)
+    resampleInput.setSize (numChannels, jmax (samplesPerBlockExpected * 9 + 8, (int) NetworkAudioHelpers::maxPacketSize));
+    resetInterpolators();
+}
+
+void NetworkAudioReceiver::releaseResources()
+{
+}
+
+void NetworkAudioReceiver::getNextAudioBlock (const AudioSourceChannelInfo& info)
+{
+    const ScopedLock sl (lock);
+
+    numSamplesPlayed += info.numSamples;
+
+    for (int chan = numChannels; chan < info.buffer->getNumChannels(); ++chan)
+        info.buffer->clear (chan, info.startSample, info.numSamples);
+
+    if (! hasStream)
+    {
+        info.clearActiveBufferRegion();
+        return;
+    }
+
+    const int target = getTargetLatencySamples();
+    const int64 numAvailable = bufferEnd - readPosition;
+
+    if (isBuffering)
+    {
+        if (numAvailable < target)
+        {
+            info.clearActiveBufferRegion();
+            return;
+        }
+
+        isBuffering = false;
+        smoothedFillError = 0;
+        resetInterpolators();
+    }
+    else if (numAvailable > roundToInt (maxLatencySeconds * streamSampleRate) + 2 * lastPacketSize)
+    {
+        ++stats.resyncs;
+        readPosition = bufferEnd - target;
+        smoothedFillError = 0;
+        resetInterpolators();
+    }
+
+    // Nudge the playback speed so that the amount of buffered audio gradually settles on
+    // the target. Keeping this correction tiny means that it's inaudible, but can still
+    // follow the typical drift between two crystal clocks, which is well under 0.1%.
+    smoothedFillError += ((double) (bufferEnd - readPosition - target) - smoothedFillError) * 0.01;
+
+    const double correction = jlimit (-0.002, 0.002, 0.1 * smoothedFillError / streamSampleRate);
+    resamplingRatio = (streamSampleRate / outputSampleRate) * (1.0 + correction);
+
+    const int bufferSize = jitterBuffer.getNumSamples();
+    const int maxInputPerChunk = resampleInput.getNumSamples() - 4;
+    int outputPos = info.startSample;
+    int numLeft = info.numSamples;
+
+    while (numLeft > 0)
+    {
+        const int numOut = jmin (numLeft, jmax (1, (int) ((maxInputPerChunk - 2) / resamplingRatio)));
+        const int numIn = jmin (maxInputPerChunk, (int) (numOut * resamplingRatio) + 2);
+
+        if (bufferEnd - readPosition < numIn)
+        {
+            ++stats.underruns;
+            isBuffering = true;
+            info.buffer->clear (outputPos, numLeft);
+            break;
+        }
+
+        for (int chan = 0; chan < numChannels; ++chan)
+        {
+            for (int i = 0; i < numIn;)
+            {
+                const int index = (int) ((readPosition + i) % bufferSize);
+                const int num = jmin (bufferSize - index, numIn - i);
+
+                resampleInput.copyFrom (chan, i, jitterBuffer, chan, index, num);
+                i += num;
+            }
+        }
+
+        int numUsed = 0;
+
+        for (int chan = 0; chan < numChannels; ++chan)
+        {
+            if (chan < info.buffer->getNumChannels())
+                numUsed = interpolators.getUnchecked (chan)
+                            ->process (resamplingRatio, resampleInput.getSampleData (chan),
+                                       info.buffer->getSampleData (chan, outputPos), numOut);
+        }
+
+        readPosition += numUsed;
+        outputPos += numOut;
+        numLeft -= numOut;
+    }
+}
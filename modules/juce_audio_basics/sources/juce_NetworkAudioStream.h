@@ -0,0 +1,275 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+
+#ifndef __JUCE_NETWORKAUDIOSTREAM_JUCEHEADER__
+#define __JUCE_NETWORKAUDIOSTREAM_JUCEHEADER__
+
+#include "juce_PositionableAudioSource.h"
+#include "../effects/juce_LagrangeInterpolator.h"
+
+
+//==============================================================================
+/**
+    Sends a live stream of audio to a NetworkAudioReceiver on another machine, as
+    UDP datagrams.
+
+    You can use this either as an AudioSource that wraps another one - in which case
+    each block that passes through it is also sent - or just call sendAudio() yourself
+    with each block of audio you want to send (e.g. from an audio callback).
+
+    The audio is split into packets small enough to avoid IP fragmentation, each with a
+    sequence number and the position of its first sample, so that the receiver can detect
+    loss, put late packets back in order and compensate for the difference between the
+    two machines' clocks. It can optionally be reduced to 16 bits, and compressed.
+
+    Sending a datagram doesn't normally block, and the packets are built in memory that's
+    allocated up-front, so it's reasonable to call sendAudio() from an audio thread.
+
+    @see NetworkAudioReceiver
+*/
+class JUCE_API  NetworkAudioSender  : public AudioSource
+{
+public:
+    //==============================================================================
+    /** The formats in which the samples can be sent. */
+    enum Encoding
+    {
+        floatingPoint32Bit  = 0,    /**< 32-bit floats - lossless, but needs the most bandwidth. */
+        integer16Bit        = 1,    /**< 16-bit integers - half the size of floatingPoint32Bit. */
+        compressed16Bit     = 2     /**< 16-bit integers, delta-coded and packed into variable-length
+                                         bytes. This is lossless compared to integer16Bit, and smaller
+                                         for quiet or low-frequency material (never more than 50% larger). */
+    };
+
+    //==============================================================================
+    /** Creates a sender.
+
+        @param input                the source to read the audio from, or nullptr if you're going
+                                    to call sendAudio() yourself
+        @param deleteInputWhenDeleted   whether to delete the input source when this is deleted
+        @param numChannels          the number of channels to send
+        @param encoding             the format in which to send the samples
+    */
+    NetworkAudioSender (AudioSource* input,
+                        bool deleteInputWhenDeleted,
+                        int numChannels,
+                        Encoding encoding = floatingPoint32Bit);
+
+    /** Destructor. */
+    ~NetworkAudioSender();
+
+    //==============================================================================
+    /** Sets the machine and port to send the audio to.
+        @returns true if the address could be resolved
+    */
+    bool connect (const String& hostName, int portNumber);
+
+    /** Stops sending audio. */
+    void disconnect();
+
+    /** Returns true if connect() has succeeded. */
+    bool isConnected() const noexcept;
+
+    //==============================================================================
+    /** Sends a block of audio.
+
+        The channels beyond the number that the sender was created with are ignored, and
+        any missing ones are sent as silence. If you're not using this as an AudioSource,
+        you must still call prepareToPlay() before sending anything, to set the sample rate.
+    */
+    void sendAudio (const AudioSampleBuffer& buffer, int startSample, int numSamples);
+
+    /** Changes the encoding. This is safe to call while audio is being sent. */
+    void setEncoding (Encoding newEncoding) noexcept;
+
+    //==============================================================================
+    /** Some counters that describe how the stream is going. */
+    struct Statistics
+    {
+        int64 packetsSent;          /**< The number of datagrams that have been sent. */
+        int64 bytesSent;            /**< The total size of the datagrams that have been sent. */
+        int64 sendErrors;           /**< The number of datagrams that the OS refused to send. */
+        int64 samplesSent;          /**< The number of sample frames that have been sent. */
+    };
+
+    /** Returns the current statistics. */
+    Statistics getStatistics() const noexcept;
+
+    //==============================================================================
+    /** Implementation of the AudioSource method. */
+    void prepareToPlay (int samplesPerBlockExpected, double sampleRate);
+    /** Implementation of the AudioSource method. */
+    void releaseResources();
+    /** Implementation of the AudioSource method. */
+    void getNextAudioBlock (const AudioSourceChannelInfo& bufferToFill);
+
+private:
+    //==============================================================================
+    OptionalScopedPointer<AudioSource> input;
+    ScopedPointer<DatagramSocket> socket;
+    CriticalSection socketLock;
+    const int numChannels;
+    Atomic<int> encoding;
+    double sampleRate;
+    uint32 nextSequenceNumber;
+    int64 nextSamplePosition;
+    HeapBlock<char> packets;
+    HeapBlock<SocketBuffer> datagrams;
+    Atomic<int64> packetsSent, bytesSent, sendErrors, samplesSent;
+
+    int getMaxSamplesPerPacket (int encoding) const noexcept;
+    int writePacket (char* dest, const AudioSampleBuffer&, int startSample, int& numSamples, int encoding);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (NetworkAudioSender)
+};
+
+
+//==============================================================================
+/**
+    Receives a stream of audio that's being sent by a NetworkAudioSender, and plays it
+    as an AudioSource.
+
+    The packets are received on a background thread and put into a jitter buffer,
+    in order of their position in the stream, so packets that arrive out of order are
+    put back where they belong, and lost ones leave a gap of silence. The amount of audio
+    that's kept in the buffer adapts to how much the packets' arrival times are varying.
+
+    Because the sender's clock will never run at exactly the same rate as the audio
+    device that's playing the stream, the audio is very slightly resampled, with the ratio
+    continuously adjusted to keep the buffer at its target level. The same resampling also
+    converts between the sender's sample rate and the one passed to prepareToPlay().
+
+    This is a PositionableAudioSource so that it can be used in an AudioTransportSource,
+    but as it's playing a live stream, it can't be repositioned.
+
+    @see NetworkAudioSender
+*/
+class JUCE_API  NetworkAudioReceiver  : public PositionableAudioSource,
+                                        private Thread
+{
+public:
+    //==============================================================================
+    /** Creates a receiver.
+
+        @param numChannels          the maximum number of channels to receive
+        @param maxBufferSeconds     the size of the jitter buffer, which limits how much
+                                    latency it can add to cope with irregular arrivals
+    */
+    NetworkAudioReceiver (int numChannels, double maxBufferSeconds = 1.0);
+
+    /** Destructor. */
+    ~NetworkAudioReceiver();
+
+    //==============================================================================
+    /** Starts listening for audio on a UDP port.
+        @returns true if the port could be opened
+    */
+    bool startListening (int portNumber);
+
+    /** Stops listening. */
+    void stopListening();
+
+    //==============================================================================
+    /** Sets the limits on the latency that the jitter buffer may add.
+
+        The buffer aims to hold enough audio to ride out the variation in the packets'
+        arrival times that it has measured recently, but never less than the minimum, or
+        more than the maximum.
+    */
+    void setLatencyRange (double minimumSeconds, double maximumSeconds);
+
+    //==============================================================================
+    /** Some counters that describe how the stream is going. */
+    struct Statistics
+    {
+        int64 packetsReceived;      /**< The number of valid packets that have arrived. */
+        int64 packetsLost;          /**< The number of packets that never arrived. */
+        int64 packetsLate;          /**< Packets that arrived too late to be played. */
+        int64 packetsOutOfOrder;    /**< Packets that arrived after a later one. */
+        int64 packetsInvalid;       /**< Datagrams that weren't recognised as audio packets. */
+        int underruns;              /**< The number of times the buffer has run dry. */
+        int resyncs;                /**< The number of times the buffer has overflowed, and jumped ahead. */
+        double jitterSeconds;       /**< The current estimate of the variation in arrival times. */
+        double targetLatencySeconds;/**< The amount of audio that the buffer is currently aiming to hold. */
+        double bufferedSeconds;     /**< The amount of audio that the buffer currently holds. */
+        double resamplingRatio;     /**< The ratio currently being used to correct for clock drift. */
+    };
+
+    /** Returns the current statistics. */
+    Statistics getStatistics() const;
+
+    /** Returns the sample rate of the incoming stream, or 0 if nothing has arrived yet. */
+    double getStreamSampleRate() const noexcept            { return streamSampleRate; }
+
+    //==============================================================================
+    /** Implementation of the AudioSource method. */
+    void prepareToPlay (int samplesPerBlockExpected, double sampleRate);
+    /** Implementation of the AudioSource method. */
+    void releaseResources();
+    /** Implementation of the AudioSource method. */
+    void getNextAudioBlock (const AudioSourceChannelInfo& bufferToFill);
+
+    /** Implements the PositionableAudioSource method. This does nothing, as the stream is live. */
+    void setNextReadPosition (int64)                        {}
+    /** Implements the PositionableAudioSource method, returning the number of samples played. */
+    int64 getNextReadPosition() const                       { return numSamplesPlayed; }
+    /** Implements the PositionableAudioSource method. */
+    int64 getTotalLength() const                            { return std::numeric_limits<int64>::max(); }
+    /** Implements the PositionableAudioSource method. */
+    bool isLooping() const                                  { return false; }
+
+private:
+    //==============================================================================
+    ScopedPointer<DatagramSocket> socket;
+    CriticalSection lock;
+    const int numChannels;
+    const double maxBufferSeconds;
+    double minLatencySeconds, maxLatencySeconds;
+    double volatile streamSampleRate;
+    double outputSampleRate;
+
+    AudioSampleBuffer jitterBuffer, resampleInput;
+    OwnedArray<LagrangeInterpolator> interpolators;
+    int64 readPosition, bufferEnd;
+    int64 volatile numSamplesPlayed;
+    bool isBuffering, hasStream;
+    int lastPacketSize;
+    double smoothedFillError, resamplingRatio, jitterSamples, lastTransitTime;
+    uint32 baseSequenceNumber, highestSequenceNumber;
+    int64 packetsExpected, packetsReceivedSinceReset, packetsLostBeforeReset;
+    Statistics stats;
+
+    void run();
+    void handlePacket (const char* data, int size);
+    void resetStream (int64 startPosition, uint32 sequenceNumber, double sampleRate, int numSamplesInBuffer);
+    void clearBufferRange (int64 start, int64 end);
+    int getTargetLatencySamples() const noexcept;
+    void resetInterpolators();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (NetworkAudioReceiver)
+};
+
+
+#endif   // __JUCE_NETWORKAUDIOSTREAM_JUCEHEADER__
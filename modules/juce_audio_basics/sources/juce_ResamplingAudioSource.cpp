@@ -49,6 +49,23 @@ void ResamplingAudioSource::setResamplingRatio (const double samplesInPerOutputS
     ratio = jmax (0.0, samplesInPerOutputSample);
 }
 
+void ResamplingAudioSource::setUsePolyphaseResampler (const bool shouldUsePolyphaseResampler,
+                                                      const PolyphaseResampler::Quality quality)
+{
+    if (! shouldUsePolyphaseResampler)
+    {
+        polyphaseResampler = nullptr;
+    }
+    else if (polyphaseResampler == nullptr)
+    {
+        polyphaseResampler = new PolyphaseResampler (numChannels, quality);
+    }
+    else if (polyphaseResampler->getQuality() != quality)
+    {
+        polyphaseResampler->setQuality (quality);
+    }
+}
+
 void ResamplingAudioSource::prepareToPlay (int samplesPerBlockExpected,
                                            double sampleRate)
 {
@@ -67,6 +84,17 @@ void ResamplingAudioSource::prepareToPlay (int samplesPerBlockExpected,
     destBuffers.calloc ((size_t) numChannels);
     createLowPass (ratio);
     resetFilters();
+
+    if (polyphaseResampler != nullptr)
+    {
+        if (ratio > 0)
+            polyphaseResampler->setResamplingRatio (ratio);
+
+        polyphaseResampler->reset();
+
+        buffer.setSize (numChannels, jmax (buffer.getNumSamples(),
+                                           polyphaseResampler->getNumInputSamplesRequired (samplesPerBlockExpected) + 32));
+    }
 }
 
 void ResamplingAudioSource::releaseResources()
@@ -84,6 +112,12 @@ void ResamplingAudioSource::getNextAudioBlock (const AudioSourceChannelInfo& inf
         localRatio = ratio;
     }
 
+    if (polyphaseResampler != nullptr)
+    {
+        getNextPolyphaseBlock (info, localRatio);
+        return;
+    }
+
     if (lastRatio != localRatio)
     {
         createLowPass (localRatio);
@@ -190,6 +224,35 @@ void ResamplingAudioSource::getNextAudioBlock (const AudioSourceChannelInfo& inf
     jassert (sampsInBuffer >= 0);
 }
 
+void ResamplingAudioSource::getNextPolyphaseBlock (const AudioSourceChannelInfo& info, const double localRatio)
+{
+    PolyphaseResampler& resampler = *polyphaseResampler;
+
+    if (resampler.getResamplingRatio() != localRatio && localRatio > 0)
+        resampler.setResamplingRatio (localRatio);
+
+    const int sampsNeeded = resampler.getNumInputSamplesRequired (info.numSamples);
+
+    if (buffer.getNumSamples() < sampsNeeded)
+        buffer.setSize (numChannels, sampsNeeded + 32);
+
+    if (sampsNeeded > 0)
+    {
+        AudioSourceChannelInfo readInfo (&buffer, 0, sampsNeeded);
+        input->getNextAudioBlock (readInfo);
+    }
+
+    const int channelsToProcess = jmin (numChannels, info.buffer->getNumChannels());
+
+    for (int channel = 0; channel < channelsToProcess; ++channel)
+    {
+        destBuffers[channel] = info.buffer->getSampleData (channel, info.startSample);
+        srcBuffers[channel] = buffer.getSampleData (channel, 0);
+    }
+
+    resampler.process (srcBuffers, destBuffers, channelsToProcess, info.numSamples);
+}
+
 void ResamplingAudioSource::createLowPass (const double frequencyRatio)
 {
     const double proportionalRate = (frequencyRatio > 1.0) ? 0.5 / frequencyRatio
@@ -26,13 +26,17 @@
 #define __JUCE_RESAMPLINGAUDIOSOURCE_JUCEHEADER__
 
 #include "juce_AudioSource.h"
+#include "../effects/juce_PolyphaseResampler.h"
 
 
 //==============================================================================
 /**
     A type of AudioSource that takes an input source and changes its sample rate.
 
-    @see AudioSource
+    By default this uses a cheap interpolator with a simple low-pass filter, but it
+    can also be made to use a PolyphaseResampler, which is far more accurate.
+
+    @see AudioSource, PolyphaseResampler
 */
 class JUCE_API  ResamplingAudioSource  : public AudioSource
 {
@@ -68,6 +72,23 @@ public:
     */
     double getResamplingRatio() const noexcept                  { return ratio; }
 
+    /** Chooses whether a PolyphaseResampler should be used to do the conversion.
+
+        This mustn't be called while the source is playing, so do it before calling
+        prepareToPlay(). Bear in mind that when the resampling ratio is changed, the
+        resampler may need to calculate a new filter table, so this works best when the
+        ratio doesn't change very often.
+
+        @see PolyphaseResampler
+    */
+    void setUsePolyphaseResampler (bool shouldUsePolyphaseResampler,
+                                   PolyphaseResampler::Quality quality = PolyphaseResampler::highQuality);
+
+    /** Returns true if a PolyphaseResampler is being used.
+        @see setUsePolyphaseResampler
+    */
+    bool isUsingPolyphaseResampler() const noexcept             { return polyphaseResampler != nullptr; }
+
     //==============================================================================
     void prepareToPlay (int samplesPerBlockExpected, double sampleRate);
     void releaseResources();
@@ -84,6 +105,7 @@ private:
     SpinLock ratioLock;
     const int numChannels;
     HeapBlock<float*> destBuffers, srcBuffers;
+    ScopedPointer<PolyphaseResampler> polyphaseResampler;
 
     void setFilterCoefficients (double c1, double c2, double c3, double c4, double c5, double c6);
     void createLowPass (double proportionalRate);
@@ -98,6 +120,8 @@ private:
 
     void applyFilter (float* samples, int num, FilterState& fs);
 
+    void getNextPolyphaseBlock (const AudioSourceChannelInfo&, double localRatio);
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ResamplingAudioSource)
 };
 
@@ -0,0 +1,367 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+
+// An immutable copy of the matrix for the audio thread to use, along with the audio thread's
+// own state: the gain that each cell has currently reached, and the list of cells to render.
+struct RoutingMatrixAudioSource::Snapshot
+{
+    Snapshot (const int numSources_, const int numOutputs_, const Array<float>& gains)
+        : numSources (numSources_), numOutputs (numOutputs_),
+          targetGains (gains),
+          currentGains ((size_t) (numSources_ * numOutputs_), true),
+          isActive ((size_t) (numSources_ * numOutputs_), true),
+          outputWritten ((size_t) numOutputs_),
+          activeCells ((size_t) (numSources_ * numOutputs_)),
+          numActiveCells (0)
+    {
+        jassert (gains.size() == numSources * numOutputs);
+
+        for (int i = 0; i < gains.size(); ++i)
+            if (gains.getUnchecked (i) != 0)
+                addActiveCell (i);
+    }
+
+    /*  Picks up the gains that the previous snapshot's cells had reached, so that cells whose
+        gain has changed carry on ramping from where they were, and any that have been
+        disconnected fade out rather than stopping dead.
+    */
+    void takeOverFrom (const Snapshot& previous) noexcept
+    {
+        for (int i = 0; i < previous.numActiveCells; ++i)
+        {
+            const int oldIndex = previous.activeCells[i];
+            const int sourceChannel = oldIndex / previous.numOutputs;
+            const int outputChannel = oldIndex % previous.numOutputs;
+            const float gain = previous.currentGains[oldIndex];
+
+            if (gain != 0 && sourceChannel < numSources && outputChannel < numOutputs)
+            {
+                const int index = sourceChannel * numOutputs + outputChannel;
+                currentGains[index] = gain;
+
+                if (! isActive[index])
+                    addActiveCell (index);
+            }
+        }
+    }
+
+    void addActiveCell (const int index) noexcept
+    {
+        isActive[index] = true;
+        activeCells[numActiveCells++] = index;
+    }
+
+    void removeActiveCell (const int listIndex) noexcept
+    {
+        isActive [activeCells [listIndex]] = false;
+        activeCells [listIndex] = activeCells [--numActiveCells];
+    }
+
+    const int numSources, numOutputs;
+    const Array<float> targetGains;
+    HeapBlock<float> currentGains;
+    HeapBlock<bool> isActive, outputWritten;
+    HeapBlock<int> activeCells;
+    int numActiveCells;
+
+    JUCE_DECLARE_NON_COPYABLE (Snapshot)
+};
+
+//==============================================================================
+RoutingMatrixAudioSource::RoutingMatrixAudioSource (AudioSource* const source_,
+                                                    const bool deleteSourceWhenDeleted)
+    : source (source_, deleteSourceWhenDeleted),
+      numSources (0), numOutputs (0),
+      sourceBuffer (2, 0)
+{
+    jassert (source_ != nullptr);
+
+    publishedSnapshot = new Snapshot (0, 0, gains);
+    latestSnapshot = publishedSnapshot;
+    snapshotInUse = publishedSnapshot;
+    currentSnapshot = publishedSnapshot;
+
+    setNumChannels (2, 2);
+}
+
+RoutingMatrixAudioSource::~RoutingMatrixAudioSource()
+{
+}
+
+//==============================================================================
+void RoutingMatrixAudioSource::setNumChannels (const int numSourceChannels, const int numOutputChannels)
+{
+    const ScopedLock sl (lock);
+    setNumChannelsInternal (numSourceChannels, numOutputChannels);
+    publishSnapshot();
+}
+
+void RoutingMatrixAudioSource::setNumChannelsInternal (const int numSourceChannels, const int numOutputChannels)
+{
+    jassert (numSourceChannels >= 0 && numOutputChannels >= 0);
+
+    Array<float> newGains;
+    newGains.insertMultiple (0, 0.0f, numSourceChannels * numOutputChannels);
+
+    for (int s = jmin (numSources, numSourceChannels); --s >= 0;)
+        for (int o = jmin (numOutputs, numOutputChannels); --o >= 0;)
+            newGains.set (s * numOutputChannels + o, gains.getUnchecked (s * numOutputs + o));
+
+    gains.swapWithArray (newGains);
+    numSources = numSourceChannels;
+    numOutputs = numOutputChannels;
+}
+
+int RoutingMatrixAudioSource::getNumSourceChannels() const
+{
+    const ScopedLock sl (lock);
+    return numSources;
+}
+
+int RoutingMatrixAudioSource::getNumOutputChannels() const
+{
+    const ScopedLock sl (lock);
+    return numOutputs;
+}
+
+void RoutingMatrixAudioSource::setGain (const int sourceChannel, const int outputChannel, const float gain)
+{
+    const ScopedLock sl (lock);
+
+    if (isPositiveAndBelow (sourceChannel, numSources)
+         && isPositiveAndBelow (outputChannel, numOutputs)
+         && gains.getUnchecked (sourceChannel * numOutputs + outputChannel) != gain)
+    {
+        gains.set (sourceChannel * numOutputs + outputChannel, gain);
+        publishSnapshot();
+    }
+}
+
+float RoutingMatrixAudioSource::getGain (const int sourceChannel, const int outputChannel) const
+{
+    const ScopedLock sl (lock);
+
+    if (isPositiveAndBelow (sourceChannel, numSources)
+         && isPositiveAndBelow (outputChannel, numOutputs))
+        return gains.getUnchecked (sourceChannel * numOutputs + outputChannel);
+
+    return 0;
+}
+
+void RoutingMatrixAudioSource::setAllGains (const float* const newGains)
+{
+    const ScopedLock sl (lock);
+
+    for (int i = 0; i < gains.size(); ++i)
+        gains.set (i, newGains[i]);
+
+    publishSnapshot();
+}
+
+void RoutingMatrixAudioSource::clearAllGains()
+{
+    const ScopedLock sl (lock);
+    FloatVectorOperations::clear (gains.getRawDataPointer(), gains.size());
+    publishSnapshot();
+}
+
+void RoutingMatrixAudioSource::setToIdentity()
+{
+    const ScopedLock sl (lock);
+    FloatVectorOperations::clear (gains.getRawDataPointer(), gains.size());
+
+    for (int i = jmin (numSources, numOutputs); --i >= 0;)
+        gains.set (i * numOutputs + i, 1.0f);
+
+    publishSnapshot();
+}
+
+//==============================================================================
+XmlElement* RoutingMatrixAudioSource::createXml() const
+{
+    XmlElement* e = new XmlElement ("ROUTINGMATRIX");
+    String gainList;
+
+    const ScopedLock sl (lock);
+
+    for (int i = 0; i < gains.size(); ++i)
+        gainList << gains.getUnchecked (i) << ' ';
+
+    e->setAttribute ("sources", numSources);
+    e->setAttribute ("outputs", numOutputs);
+    e->setAttribute ("gains", gainList.trimEnd());
+
+    return e;
+}
+
+void RoutingMatrixAudioSource::restoreFromXml (const XmlElement& e)
+{
+    if (e.hasTagName ("ROUTINGMATRIX"))
+    {
+        StringArray gainList;
+        gainList.addTokens (e.getStringAttribute ("gains"), false);
+
+        const ScopedLock sl (lock);
+
+        setNumChannelsInternal (jmax (0, e.getIntAttribute ("sources")),
+                                jmax (0, e.getIntAttribute ("outputs")));
+
+        for (int i = 0; i < gains.size(); ++i)
+            gains.set (i, gainList[i].getFloatValue());
+
+        publishSnapshot();
+    }
+}
+
+//==============================================================================
+/*  Once the audio thread has picked up a snapshot, it stays announced in snapshotInUse until
+    the next one is picked up, because the audio thread needs to read its ramp state when it
+    moves on to the new one. While it's doing that, the new one is announced in pendingSnapshot.
+    A retired snapshot can be deleted as soon as it's in neither of these, and this must check
+    pendingSnapshot first, because the audio thread sets snapshotInUse before clearing it.
+    This must be called with the lock held.
+*/
+void RoutingMatrixAudioSource::publishSnapshot()
+{
+    retiredSnapshots.add (publishedSnapshot.release());
+    publishedSnapshot = new Snapshot (numSources, numOutputs, gains);
+    latestSnapshot = publishedSnapshot;
+
+    for (int i = retiredSnapshots.size(); --i >= 0;)
+    {
+        Snapshot* const s = retiredSnapshots.getUnchecked (i);
+
+        if (pendingSnapshot.get() != s && snapshotInUse.get() != s)
+            retiredSnapshots.remove (i);
+    }
+}
+
+RoutingMatrixAudioSource::Snapshot* RoutingMatrixAudioSource::acquireSnapshot() noexcept
+{
+    Snapshot* snapshot = latestSnapshot.get();
+
+    if (snapshot != currentSnapshot)
+    {
+        for (;;)
+        {
+            pendingSnapshot = snapshot;
+
+            if (latestSnapshot.get() == snapshot)
+                break;
+
+            snapshot = latestSnapshot.get();
+        }
+
+        snapshot->takeOverFrom (*currentSnapshot);
+
+        snapshotInUse = snapshot;
+        pendingSnapshot = nullptr;
+        currentSnapshot = snapshot;
+    }
+
+    return snapshot;
+}
+
+//==============================================================================
+void RoutingMatrixAudioSource::prepareToPlay (int samplesPerBlockExpected, double sampleRate)
+{
+    sourceBuffer.setSize (jmax (1, getNumSourceChannels()), samplesPerBlockExpected);
+    source->prepareToPlay (samplesPerBlockExpected, sampleRate);
+}
+
+void RoutingMatrixAudioSource::releaseResources()
+{
+    source->releaseResources();
+    sourceBuffer.setSize (2, 0);
+}
+
+void RoutingMatrixAudioSource::getNextAudioBlock (const AudioSourceChannelInfo& info)
+{
+    Snapshot& snapshot = *acquireSnapshot();
+    AudioSampleBuffer& dest = *info.buffer;
+    const int numSamples = info.numSamples;
+    const int numChans = dest.getNumChannels();
+
+    sourceBuffer.setSize (jmax (1, snapshot.numSources), numSamples, false, false, true);
+
+    for (int i = 0; i < sourceBuffer.getNumChannels(); ++i)
+    {
+        if (i < numChans)
+            sourceBuffer.copyFrom (i, 0, dest, i, info.startSample, numSamples);
+        else
+            sourceBuffer.clear (i, 0, numSamples);
+    }
+
+    AudioSourceChannelInfo sourceInfo (&sourceBuffer, 0, numSamples);
+    source->getNextAudioBlock (sourceInfo);
+
+    zeromem (snapshot.outputWritten, sizeof (bool) * (size_t) snapshot.numOutputs);
+
+    for (int i = 0; i < snapshot.numActiveCells;)
+    {
+        const int index = snapshot.activeCells[i];
+        const float targetGain = snapshot.targetGains.getUnchecked (index);
+        const float currentGain = snapshot.currentGains[index];
+
+        if (currentGain == 0 && targetGain == 0)
+        {
+            // (this cell has finished fading out, so it can be dropped)
+            snapshot.removeActiveCell (i);
+            continue;
+        }
+
+        const int outputChannel = index % snapshot.numOutputs;
+
+        if (outputChannel < numChans)
+        {
+            const float* const src = sourceBuffer.getSampleData (index / snapshot.numOutputs);
+            float* const dst = dest.getSampleData (outputChannel, info.startSample);
+
+            if (snapshot.outputWritten [outputChannel])
+            {
+                if (currentGain == targetGain)
+                    FloatVectorOperations::addWithMultiply (dst, src, targetGain, numSamples);
+                else
+                    FloatVectorOperations::addWithRamp (dst, src, currentGain, targetGain, numSamples);
+            }
+            else
+            {
+                if (currentGain == targetGain)
+                    FloatVectorOperations::copyWithMultiply (dst, src, targetGain, numSamples);
+                else
+                    FloatVectorOperations::copyWithRamp (dst, src, currentGain, targetGain, numSamples);
+
+                snapshot.outputWritten [outputChannel] = true;
+            }
+        }
+
+        snapshot.currentGains[index] = targetGain;
+        ++i;
+    }
+
+    for (int i = 0; i < numChans; ++i)
+        if (i >= snapshot.numOutputs || ! snapshot.outputWritten[i])
+            dest.clear (i, info.startSample, numSamples);
+}
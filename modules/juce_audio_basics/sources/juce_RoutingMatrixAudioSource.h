@@ -0,0 +1,158 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+
+#ifndef __JUCE_ROUTINGMATRIXAUDIOSOURCE_JUCEHEADER__
+#define __JUCE_ROUTINGMATRIXAUDIOSOURCE_JUCEHEADER__
+
+#include "juce_AudioSource.h"
+
+
+//==============================================================================
+/**
+    An AudioSource that takes the audio from another source, and mixes its channels
+    into its output channels through a matrix of gains.
+
+    Whereas a ChannelRemappingAudioSource can only connect each channel to one other,
+    this can send any of the source's channels to any number of outputs, at any level,
+    so it can do mixdowns, upmixes and monitor mixes in a single stage.
+
+    Only the cells of the matrix that have a non-zero gain cost anything to render:
+    each one is a single vector copy or multiply-add. When a gain changes, it's ramped
+    smoothly to its new value over the next block.
+
+    As with the LockFreeMixerAudioSource, changing the matrix never makes the audio
+    thread wait for a lock: each change publishes a new copy of the matrix, which
+    getNextAudioBlock() picks up at the start of its next block.
+
+    Before calling the source, the incoming audio in each of the buffer's channels is
+    copied into the corresponding source channel, so a source that processes its input
+    will see the same data that it would without the matrix.
+
+    @see ChannelRemappingAudioSource, AudioSource
+*/
+class JUCE_API  RoutingMatrixAudioSource  : public AudioSource
+{
+public:
+    //==============================================================================
+    /** Creates a RoutingMatrixAudioSource which will take its audio from the given source.
+
+        To begin with, the matrix has 2 source channels and 2 outputs, and all its gains
+        are zero, so it'll produce silence.
+
+        @param source       the input source to use. Make sure that this doesn't
+                            get deleted before the RoutingMatrixAudioSource object
+        @param deleteSourceWhenDeleted  if true, the input source will be deleted
+                            when this object is deleted, if false, the caller is
+                            responsible for its deletion
+    */
+    RoutingMatrixAudioSource (AudioSource* source,
+                              bool deleteSourceWhenDeleted);
+
+    /** Destructor. */
+    ~RoutingMatrixAudioSource();
+
+    //==============================================================================
+    /** Changes the size of the matrix.
+
+        The source will be asked for numSourceChannels channels of audio, and these are
+        mixed into the first numOutputChannels channels of the output buffer (any others
+        are cleared). The gains of the cells that are still within the matrix are kept.
+    */
+    void setNumChannels (int numSourceChannels, int numOutputChannels);
+
+    /** Returns the number of channels that the source is asked to produce. */
+    int getNumSourceChannels() const;
+
+    /** Returns the number of output channels that the matrix mixes into. */
+    int getNumOutputChannels() const;
+
+    //==============================================================================
+    /** Sets the gain with which a source channel is mixed into an output channel.
+        A gain of zero disconnects them.
+    */
+    void setGain (int sourceChannel, int outputChannel, float gain);
+
+    /** Returns the gain with which a source channel is mixed into an output channel. */
+    float getGain (int sourceChannel, int outputChannel) const;
+
+    /** Replaces all the gains at once.
+
+        This is quicker than calling setGain() for each cell, as it only publishes the
+        matrix once. The array must contain (getNumSourceChannels() * getNumOutputChannels())
+        values, where the gain from source channel s to output channel o is at index
+        (s * getNumOutputChannels() + o).
+    */
+    void setAllGains (const float* newGains);
+
+    /** Sets all the gains to zero. */
+    void clearAllGains();
+
+    /** Connects each source channel to the output with the same index, with unity gain,
+        and disconnects everything else.
+    */
+    void setToIdentity();
+
+    //==============================================================================
+    /** Returns an XML object to encapsulate the size and gains of the matrix.
+        @see restoreFromXml
+    */
+    XmlElement* createXml() const;
+
+    /** Restores the matrix from an XML object created by createXml().
+        @see createXml
+    */
+    void restoreFromXml (const XmlElement&);
+
+    //==============================================================================
+    void prepareToPlay (int samplesPerBlockExpected, double sampleRate);
+    void releaseResources();
+    void getNextAudioBlock (const AudioSourceChannelInfo&);
+
+private:
+    //==============================================================================
+    struct Snapshot;
+    friend class ScopedPointer<Snapshot>;
+    friend class OwnedArray<Snapshot>;
+
+    OptionalScopedPointer<AudioSource> source;
+    CriticalSection lock;
+    int numSources, numOutputs;
+    Array<float> gains;
+
+    ScopedPointer<Snapshot> publishedSnapshot;
+    OwnedArray<Snapshot> retiredSnapshots;
+    Atomic<Snapshot*> latestSnapshot, pendingSnapshot, snapshotInUse;
+    Snapshot* currentSnapshot;   // (only used by the audio thread)
+    AudioSampleBuffer sourceBuffer;
+
+    void publishSnapshot();
+    Snapshot* acquireSnapshot() noexcept;
+    void setNumChannelsInternal (int numSourceChannels, int numOutputChannels);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (RoutingMatrixAudioSource)
+};
+
+
+#endif   // __JUCE_ROUTINGMATRIXAUDIOSOURCE_JUCEHEADER__
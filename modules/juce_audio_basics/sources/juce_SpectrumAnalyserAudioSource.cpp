@@ -0,0 +1,143 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+SpectrumAnalyserAudioSource::SpectrumAnalyserAudioSource (AudioSource* const inputSource,
+                                                          const bool deleteInputWhenDeleted,
+                                                          const int fftOrder,
+                                                          const int hopSize_,
+                                                          const FFT::WindowingMethod windowingMethod)
+    : input (inputSource, deleteInputWhenDeleted),
+      fft (fftOrder),
+      hopSize (hopSize_ > 0 ? hopSize_ : (1 << fftOrder) / 4),
+      magnitudeScale (1.0f),
+      window ((size_t) (1 << fftOrder)),
+      history ((size_t) (1 << fftOrder), true),
+      frame ((size_t) (1 << fftOrder) + 2),
+      latestMagnitudes ((size_t) (1 << fftOrder) / 2 + 1, true),
+      historyPosition (0),
+      samplesUntilNextFrame (hopSize),
+      numFramesAnalysed (0)
+{
+    jassert (inputSource != nullptr);
+
+    const int size = fft.getSize();
+    FFT::fillWindowingTable (window, size, windowingMethod);
+
+    // A sine wave's peak bin has a magnitude of half the window's sum times its amplitude.
+    double windowSum = 0;
+    for (int i = 0; i < size; ++i)
+        windowSum += window[i];
+
+    magnitudeScale = (float) (2.0 / windowSum);
+}
+
+SpectrumAnalyserAudioSource::~SpectrumAnalyserAudioSource()  {}
+
+//==============================================================================
+int SpectrumAnalyserAudioSource::getLatestMagnitudes (float* const dest, const int maxBins) const
+{
+    const int num = jmin (maxBins, getNumBins());
+
+    const SpinLock::ScopedLockType sl (latestMagnitudesLock);
+    FloatVectorOperations::copy (dest, latestMagnitudes, num);
+    return num;
+}
+
+void SpectrumAnalyserAudioSource::spectrumFrameReady (const float*, int)
+{
+}
+
+//==============================================================================
+void SpectrumAnalyserAudioSource::prepareToPlay (int samplesPerBlockExpected, double sampleRate)
+{
+    input->prepareToPlay (samplesPerBlockExpected, sampleRate);
+
+    FloatVectorOperations::clear (history, fft.getSize());
+    historyPosition = 0;
+    samplesUntilNextFrame = hopSize;
+    numFramesAnalysed = 0;
+}
+
+void SpectrumAnalyserAudioSource::releaseResources()
+{
+    input->releaseResources();
+}
+
+void SpectrumAnalyserAudioSource::getNextAudioBlock (const AudioSourceChannelInfo& bufferToFill)
+{
+    input->getNextAudioBlock (bufferToFill);
+
+    const AudioSampleBuffer& buffer = *bufferToFill.buffer;
+    const int numChannels = buffer.getNumChannels();
+    const int size = fft.getSize();
+
+    if (numChannels <= 0)
+        return;
+
+    const float channelGain = 1.0f / numChannels;
+
+    for (int i = 0; i < bufferToFill.numSamples; ++i)
+    {
+        float sum = 0;
+
+        for (int chan = 0; chan < numChannels; ++chan)
+            sum += *buffer.getSampleData (chan, bufferToFill.startSample + i);
+
+        history [historyPosition] = sum * channelGain;
+
+        if (++historyPosition >= size)
+            historyPosition = 0;
+
+        if (--samplesUntilNextFrame <= 0)
+        {
+            analyseFrame();
+            samplesUntilNextFrame = hopSize;
+        }
+    }
+}
+
+void SpectrumAnalyserAudioSource::analyseFrame()
+{
+    const int size = fft.getSize();
+    const int numBins = fft.getNumBins();
+
+    // unwrap the history so that the oldest sample comes first..
+    const int numAtEnd = size - historyPosition;
+    FloatVectorOperations::copy (frame, history + historyPosition, numAtEnd);
+    FloatVectorOperations::copy (frame + numAtEnd, history, historyPosition);
+
+    FloatVectorOperations::multiply (frame, window, size);
+    fft.performFrequencyOnlyForwardTransform (frame, frame);
+    FloatVectorOperations::multiply (frame, magnitudeScale, numBins);
+
+    ++numFramesAnalysed;
+    spectrumFrameReady (frame, numBins);
+
+    // (if a reader's got the lock, just skip this frame rather than blocking the audio thread)
+    if (latestMagnitudesLock.tryEnter())
+    {
+        FloatVectorOperations::copy (latestMagnitudes, frame, numBins);
+        latestMagnitudesLock.exit();
+    }
+}
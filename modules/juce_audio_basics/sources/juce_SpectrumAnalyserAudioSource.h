@@ -0,0 +1,121 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_SPECTRUMANALYSERAUDIOSOURCE_JUCEHEADER__
+#define __JUCE_SPECTRUMANALYSERAUDIOSOURCE_JUCEHEADER__
+
+#include "juce_AudioSource.h"
+#include "../effects/juce_FFT.h"
+
+
+//==============================================================================
+/**
+    An AudioSource that passes another source's audio through unchanged, while taking
+    a short-time fourier transform of it.
+
+    The channels are mixed down to mono, and every hop-size samples, the most recent
+    FFT-size samples are windowed and transformed. The magnitudes of each of these frames
+    are scaled so that a full-scale sine wave gives a peak of 1.0.
+
+    To draw a spectrum, another thread can call getLatestMagnitudes() to get a copy of the
+    most recent frame. To see every frame (e.g. for a spectrogram), you can subclass this
+    and override spectrumFrameReady().
+
+    @see FFT
+*/
+class JUCE_API  SpectrumAnalyserAudioSource  : public AudioSource
+{
+public:
+    //==============================================================================
+    /** Creates a SpectrumAnalyserAudioSource for a given input source.
+
+        @param inputSource              the input source to read from - this must not be null
+        @param deleteInputWhenDeleted   if true, the input source will be deleted when
+                                        this object is deleted
+        @param fftOrder                 the FFT size will be (2 ^ fftOrder)
+        @param hopSize                  the number of samples between successive frames - if
+                                        this is zero, a quarter of the FFT size is used
+        @param windowingMethod          the shape of window to apply to each frame
+    */
+    SpectrumAnalyserAudioSource (AudioSource* inputSource,
+                                 bool deleteInputWhenDeleted,
+                                 int fftOrder = 11,
+                                 int hopSize = 0,
+                                 FFT::WindowingMethod windowingMethod = FFT::hann);
+
+    /** Destructor. */
+    ~SpectrumAnalyserAudioSource();
+
+    //==============================================================================
+    /** Returns the number of samples in each frame. */
+    int getFFTSize() const noexcept                         { return fft.getSize(); }
+
+    /** Returns the number of frequency bins in each frame, which is getFFTSize() / 2 + 1. */
+    int getNumBins() const noexcept                         { return fft.getNumBins(); }
+
+    /** Returns the number of samples between the starts of successive frames. */
+    int getHopSize() const noexcept                         { return hopSize; }
+
+    /** Returns the number of frames that have been analysed since prepareToPlay() was called. */
+    int64 getNumFramesAnalysed() const noexcept             { return numFramesAnalysed; }
+
+    /** Copies the magnitudes of the most recent frame into an array.
+
+        This can be called from any thread. It copies up to maxBins values, and returns the
+        number that were copied.
+    */
+    int getLatestMagnitudes (float* dest, int maxBins) const;
+
+    //==============================================================================
+    void prepareToPlay (int samplesPerBlockExpected, double sampleRate);
+    void releaseResources();
+    void getNextAudioBlock (const AudioSourceChannelInfo& bufferToFill);
+
+protected:
+    //==============================================================================
+    /** Called on the audio thread each time a new frame has been analysed.
+
+        The default implementation does nothing. If you override it, remember that it's
+        called from inside getNextAudioBlock(), so it needs to be quick.
+    */
+    virtual void spectrumFrameReady (const float* magnitudes, int numBins);
+
+private:
+    //==============================================================================
+    OptionalScopedPointer<AudioSource> input;
+    FFT fft;
+    const int hopSize;
+    float magnitudeScale;
+    HeapBlock<float> window, history, frame, latestMagnitudes;
+    int historyPosition, samplesUntilNextFrame;
+    int64 numFramesAnalysed;
+    SpinLock latestMagnitudesLock;
+
+    void analyseFrame();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SpectrumAnalyserAudioSource)
+};
+
+
+#endif   // __JUCE_SPECTRUMANALYSERAUDIOSOURCE_JUCEHEADER__
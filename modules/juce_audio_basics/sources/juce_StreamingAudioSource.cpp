@@ -0,0 +1,298 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+
+StreamingAudioSource::StreamingAudioSource (PositionableAudioSource* source_,
+                                            DiskStreamingEngine& engine_,
+                                            const bool deleteSourceWhenDeleted,
+                                            const int numberOfSamplesToBuffer_,
+                                            const int numberOfChannels_)
+    : source (source_, deleteSourceWhenDeleted),
+      engine (engine_),
+      numberOfSamplesToBuffer (jmax (1024, numberOfSamplesToBuffer_)),
+      numberOfChannels (numberOfChannels_),
+      buffer (numberOfChannels_, 0),
+      bufferValidStart (0),
+      bufferValidEnd (0),
+      nextPlayPos (0),
+      sampleRate (0),
+      numSeeks (0),
+      wasSourceLooping (false),
+      isPrepared (false),
+      isBeingFilled (false)
+{
+    jassert (source_ != nullptr);
+
+    jassert (numberOfSamplesToBuffer_ > 1024); // not much point using this class if you're
+                                               //  not using a larger buffer..
+}
+
+StreamingAudioSource::~StreamingAudioSource()
+{
+    releaseResources();
+}
+
+//==============================================================================
+void StreamingAudioSource::prepareToPlay (int samplesPerBlockExpected, double sampleRate_)
+{
+    const int bufferSizeNeeded = jmax (samplesPerBlockExpected * 2, numberOfSamplesToBuffer);
+
+    if (sampleRate_ != sampleRate
+         || bufferSizeNeeded != buffer.getNumSamples()
+         || ! isPrepared)
+    {
+        engine.removeStream (this);
+
+        isPrepared = true;
+        sampleRate = sampleRate_;
+
+        source->prepareToPlay (samplesPerBlockExpected, sampleRate_);
+
+        buffer.setSize (numberOfChannels, bufferSizeNeeded);
+        buffer.clear();
+
+        bufferValidStart = 0;
+        bufferValidEnd = 0;
+
+        engine.addStream (this);
+
+        int64 samplesWanted = jmin (((int) sampleRate_) / 4, buffer.getNumSamples() / 2);
+
+        if (! isLooping())
+            samplesWanted = jmin (samplesWanted, getTotalLength() - nextPlayPos);
+
+        for (int i = 400; --i >= 0 && bufferValidEnd - bufferValidStart < samplesWanted;)
+        {
+            engine.wakeUpThreads();
+            Thread::sleep (5);
+        }
+    }
+}
+
+void StreamingAudioSource::releaseResources()
+{
+    isPrepared = false;
+    engine.removeStream (this);
+
+    buffer.setSize (numberOfChannels, 0);
+    source->releaseResources();
+}
+
+void StreamingAudioSource::getNextAudioBlock (const AudioSourceChannelInfo& info)
+{
+    const ScopedLock sl (bufferStartPosLock);
+
+    const int validStart = (int) (jlimit (bufferValidStart, bufferValidEnd, nextPlayPos) - nextPlayPos);
+    const int validEnd   = (int) (jlimit (bufferValidStart, bufferValidEnd, nextPlayPos + info.numSamples) - nextPlayPos);
+
+    // (reaching the end of a non-looping source isn't counted as an underrun)
+    const int numExpected = isLooping() ? info.numSamples
+                                        : (int) jlimit ((int64) 0, (int64) info.numSamples, getTotalLength() - nextPlayPos);
+
+    if (isPrepared && (validStart > 0 || validEnd < numExpected))
+    {
+        ++numUnderruns;
+        ++engine.numUnderruns;
+    }
+
+    if (validStart == validEnd)
+    {
+        // total cache miss
+        info.clearActiveBufferRegion();
+    }
+    else
+    {
+        if (validStart > 0)
+            info.buffer->clear (info.startSample, validStart);  // partial cache miss at start
+
+        if (validEnd < info.numSamples)
+            info.buffer->clear (info.startSample + validEnd,
+                                info.numSamples - validEnd);    // partial cache miss at end
+
+        if (validStart < validEnd)
+        {
+            for (int chan = jmin (numberOfChannels, info.buffer->getNumChannels()); --chan >= 0;)
+            {
+                jassert (buffer.getNumSamples() > 0);
+                const int startBufferIndex = (int) ((validStart + nextPlayPos) % buffer.getNumSamples());
+                const int endBufferIndex   = (int) ((validEnd + nextPlayPos)   % buffer.getNumSamples());
+
+                if (startBufferIndex < endBufferIndex)
+                {
+                    info.buffer->copyFrom (chan, info.startSample + validStart,
+                                           buffer,
+                                           chan, startBufferIndex,
+                                           validEnd - validStart);
+                }
+                else
+                {
+                    const int initialSize = buffer.getNumSamples() - startBufferIndex;
+
+                    info.buffer->copyFrom (chan, info.startSample + validStart,
+                                           buffer,
+                                           chan, startBufferIndex,
+                                           initialSize);
+
+                    info.buffer->copyFrom (chan, info.startSample + validStart + initialSize,
+                                           buffer,
+                                           chan, 0,
+                                           (validEnd - validStart) - initialSize);
+                }
+            }
+        }
+
+        nextPlayPos += info.numSamples;
+    }
+}
+
+int64 StreamingAudioSource::getNextReadPosition() const
+{
+    jassert (source->getTotalLength() > 0);
+    return (source->isLooping() && nextPlayPos > 0)
+                    ? nextPlayPos % source->getTotalLength()
+                    : nextPlayPos;
+}
+
+void StreamingAudioSource::setNextReadPosition (int64 newPosition)
+{
+    {
+        const ScopedLock sl (bufferStartPosLock);
+
+        nextPlayPos = newPosition;
+        ++numSeeks;
+    }
+
+    engine.wakeUpThreads();
+}
+
+float StreamingAudioSource::getFillLevel() const noexcept
+{
+    const int bufferSize = buffer.getNumSamples();
+
+    if (bufferSize <= 0)
+        return 0;
+
+    const int64 playPos = nextPlayPos;
+    const int64 validEnd = bufferValidEnd;
+
+    if (playPos < bufferValidStart || playPos >= validEnd)
+        return 0;
+
+    return jmin (1.0f, (float) (validEnd - playPos) / (float) bufferSize);
+}
+
+//==============================================================================
+bool StreamingAudioSource::needsFilling (double& secondsOfAudioLeft) const noexcept
+{
+    // NB: this is called by the engine without locking the buffer, so it's only a hint -
+    // fillBuffer() works out exactly what needs to be read.
+    if (isBeingFilled || ! isPrepared || buffer.getNumSamples() <= 0 || sampleRate <= 0)
+        return false;
+
+    const int64 playPos = jmax ((int64) 0, nextPlayPos);
+    int64 validEnd = bufferValidEnd;
+
+    if (playPos < bufferValidStart || playPos > validEnd)
+        validEnd = playPos;
+
+    const int64 bufferLimit = playPos + buffer.getNumSamples() - 4;
+    const int64 limit = isLooping() ? bufferLimit : jmin (bufferLimit, getTotalLength());
+    const int64 numMissing = limit - validEnd;
+
+    // unless we're close to the end of the source, wait until there's a decent-sized
+    // chunk to read, so that each read is a good big sequential one
+    if (numMissing <= 0 || (limit == bufferLimit && numMissing < buffer.getNumSamples() / 8))
+        return false;
+
+    secondsOfAudioLeft = (validEnd - playPos) / sampleRate;
+    return true;
+}
+
+int StreamingAudioSource::fillBuffer (const int maxSamplesToRead)
+{
+    int64 sectionToReadStart, sectionToReadEnd;
+    int seeksWhenStarted;
+
+    {
+        const ScopedLock sl (bufferStartPosLock);
+
+        if (! isPrepared || buffer.getNumSamples() <= 0)
+            return 0;
+
+        if (wasSourceLooping != isLooping())
+        {
+            wasSourceLooping = isLooping();
+            bufferValidStart = 0;
+            bufferValidEnd = 0;
+        }
+
+        const int64 playPos = jmax ((int64) 0, nextPlayPos);
+        int64 limit = playPos + buffer.getNumSamples() - 4;
+
+        if (! wasSourceLooping)
+            limit = jmin (limit, getTotalLength());
+
+        if (playPos < bufferValidStart || playPos >= bufferValidEnd)
+            bufferValidEnd = playPos;  // cache miss: start again from the play position
+
+        bufferValidStart = playPos;
+
+        sectionToReadStart = bufferValidEnd;
+        sectionToReadEnd = jmin (limit, sectionToReadStart + maxSamplesToRead);
+        seeksWhenStarted = numSeeks;
+    }
+
+    if (sectionToReadEnd <= sectionToReadStart)
+        return 0;
+
+    // the whole gap is read from the source in one sequential pass, even if it
+    // wraps around the end of the circular buffer
+    const int bufferIndexStart = (int) (sectionToReadStart % buffer.getNumSamples());
+    const int numSamples = (int) (sectionToReadEnd - sectionToReadStart);
+    const int initialSize = jmin (numSamples, buffer.getNumSamples() - bufferIndexStart);
+
+    readBufferSection (sectionToReadStart, initialSize, bufferIndexStart);
+
+    if (initialSize < numSamples)
+        readBufferSection (sectionToReadStart + initialSize, numSamples - initialSize, 0);
+
+    {
+        const ScopedLock sl (bufferStartPosLock);
+
+        // if the position was changed while we were reading, this data is no use
+        if (seeksWhenStarted == numSeeks && bufferValidEnd == sectionToReadStart)
+            bufferValidEnd = sectionToReadEnd;
+    }
+
+    return numSamples;
+}
+
+void StreamingAudioSource::readBufferSection (const int64 start, const int length, const int bufferOffset)
+{
+    if (source->getNextReadPosition() != start)
+        source->setNextReadPosition (start);
+
+    AudioSourceChannelInfo info (&buffer, bufferOffset, length);
+    source->getNextAudioBlock (info);
+}
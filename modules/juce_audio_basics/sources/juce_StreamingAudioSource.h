@@ -0,0 +1,130 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+
+#ifndef __JUCE_STREAMINGAUDIOSOURCE_JUCEHEADER__
+#define __JUCE_STREAMINGAUDIOSOURCE_JUCEHEADER__
+
+#include "juce_PositionableAudioSource.h"
+#include "juce_DiskStreamingEngine.h"
+
+
+//==============================================================================
+/**
+    An AudioSource which takes another source as input, and reads ahead from it
+    using a shared DiskStreamingEngine.
+
+    This does the same job as a BufferingAudioSource, and can be used in the same
+    way, but rather than each source having its own TimeSliceThread client, all
+    the sources that share an engine are filled by its pool of threads in order
+    of urgency.
+
+    @see DiskStreamingEngine, BufferingAudioSource, PositionableAudioSource
+*/
+class JUCE_API  StreamingAudioSource  : public PositionableAudioSource
+{
+public:
+    //==============================================================================
+    /** Creates a StreamingAudioSource.
+
+        @param source                   the input source to read from
+        @param engine                   the engine that will fill this source's buffer.
+                                        This object must not be deleted until after any
+                                        StreamingAudioSources that are using it have been deleted!
+        @param deleteSourceWhenDeleted  if true, then the input source object will
+                                        be deleted when this object is deleted
+        @param numberOfSamplesToBuffer  the size of buffer to use for reading ahead
+        @param numberOfChannels         the number of channels that will be played
+    */
+    StreamingAudioSource (PositionableAudioSource* source,
+                          DiskStreamingEngine& engine,
+                          bool deleteSourceWhenDeleted,
+                          int numberOfSamplesToBuffer,
+                          int numberOfChannels = 2);
+
+    /** Destructor.
+
+        The input source may be deleted depending on whether the deleteSourceWhenDeleted
+        flag was set in the constructor.
+    */
+    ~StreamingAudioSource();
+
+    //==============================================================================
+    /** Implementation of the AudioSource method. */
+    void prepareToPlay (int samplesPerBlockExpected, double sampleRate);
+
+    /** Implementation of the AudioSource method. */
+    void releaseResources();
+
+    /** Implementation of the AudioSource method. */
+    void getNextAudioBlock (const AudioSourceChannelInfo& bufferToFill);
+
+    //==============================================================================
+    /** Implements the PositionableAudioSource method. */
+    void setNextReadPosition (int64 newPosition);
+
+    /** Implements the PositionableAudioSource method. */
+    int64 getNextReadPosition() const;
+
+    /** Implements the PositionableAudioSource method. */
+    int64 getTotalLength() const                { return source->getTotalLength(); }
+
+    /** Implements the PositionableAudioSource method. */
+    bool isLooping() const                      { return source->isLooping(); }
+
+    //==============================================================================
+    /** Returns the number of audio blocks that couldn't be completely filled because
+        the data hadn't been read in time.
+    */
+    int getNumUnderruns() const noexcept        { return numUnderruns.get(); }
+
+    /** Returns the proportion of the buffer (0 to 1) that currently holds data ahead
+        of the playback position.
+    */
+    float getFillLevel() const noexcept;
+
+private:
+    //==============================================================================
+    friend class DiskStreamingEngine;
+
+    OptionalScopedPointer<PositionableAudioSource> source;
+    DiskStreamingEngine& engine;
+    int numberOfSamplesToBuffer, numberOfChannels;
+    AudioSampleBuffer buffer;
+    CriticalSection bufferStartPosLock;
+    int64 volatile bufferValidStart, bufferValidEnd, nextPlayPos;
+    double volatile sampleRate;
+    int volatile numSeeks;
+    bool wasSourceLooping, isPrepared, isBeingFilled;
+    Atomic<int> numUnderruns;
+
+    bool needsFilling (double& secondsOfAudioLeft) const noexcept;
+    int fillBuffer (int maxSamplesToRead);
+    void readBufferSection (int64 start, int length, int bufferOffset);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (StreamingAudioSource)
+};
+
+
+#endif   // __JUCE_STREAMINGAUDIOSOURCE_JUCEHEADER__
@@ -61,14 +61,89 @@ void SynthesiserVoice::clearCurrentNote()
     currentlyPlayingSound = nullptr;
 }
 
+//==============================================================================
+struct Synthesiser::ActiveLists
+{
+    ActiveLists (const uint32 listVersion) noexcept  : version (listVersion) {}
+
+    Array<SynthesiserVoice*> voices;
+    Array<SynthesiserSound*> sounds;
+    const uint32 version;
+
+    JUCE_DECLARE_NON_COPYABLE (ActiveLists)
+};
+
+/*  Picks up any newly-published lists, unless an outer call is already using the current
+    ones, so that the lists can't change under the feet of a method that called another one.
+*/
+class Synthesiser::ScopedListAccess
+{
+public:
+    ScopedListAccess (const Synthesiser& synth_)
+        : synth (synth_)
+    {
+        if (synth.listAccessDepth++ == 0)
+            synth.updateActiveLists();
+    }
+
+    ~ScopedListAccess()                                     { --synth.listAccessDepth; }
+
+    const ActiveLists* operator->() const noexcept          { return synth.currentLists; }
+    const ActiveLists& operator*() const noexcept           { return *synth.currentLists; }
+
+private:
+    const Synthesiser& synth;
+
+    JUCE_DECLARE_NON_COPYABLE (ScopedListAccess)
+};
+
+//==============================================================================
+class Synthesiser::VoiceGroupRenderer
+{
+public:
+    VoiceGroupRenderer (const Array<SynthesiserVoice*>& voices_, AudioSampleBuffer& outputBuffer_,
+                        const OwnedArray<AudioSampleBuffer>& groupBuffers_,
+                        const int startSample_, const int numSamples_, const int numGroups_) noexcept
+        : voices (voices_), outputBuffer (outputBuffer_), groupBuffers (groupBuffers_),
+          startSample (startSample_), numSamples (numSamples_), numGroups (numGroups_)
+    {
+    }
+
+    void operator() (const int group) const
+    {
+        // The first group is added straight into the output, and the others into their own buffers.
+        // Interleaving the voices stops the busy ones all ending up in the same group.
+        AudioSampleBuffer& buffer = group == 0 ? outputBuffer : *groupBuffers.getUnchecked (group - 1);
+        const int start = group == 0 ? startSample : 0;
+
+        for (int i = group; i < voices.size(); i += numGroups)
+            voices.getUnchecked (i)->renderNextBlock (buffer, start, numSamples);
+    }
+
+private:
+    const Array<SynthesiserVoice*>& voices;
+    AudioSampleBuffer& outputBuffer;
+    const OwnedArray<AudioSampleBuffer>& groupBuffers;
+    const int startSample, numSamples, numGroups;
+};
+
 //==============================================================================
 Synthesiser::Synthesiser()
     : sampleRate (0),
       lastNoteOnCounter (0),
-      shouldStealNotes (true)
+      shouldStealNotes (true),
+      currentLists (nullptr),
+      listAccessDepth (0),
+      lastListVersion (0),
+      voiceRenderingPool (nullptr)
 {
     for (int i = 0; i < numElementsInArray (lastPitchWheelValues); ++i)
         lastPitchWheelValues[i] = 0x2000;
+
+    currentLists = new ActiveLists (lastListVersion);
+    publishedLists.add (currentLists);
+    latestLists = currentLists;
+    listsInUse = currentLists;
 }
 
 Synthesiser::~Synthesiser()
@@ -78,44 +153,64 @@ Synthesiser::~Synthesiser()
 //==============================================================================
 SynthesiserVoice* Synthesiser::getVoice (const int index) const
 {
-    const ScopedLock sl (lock);
+    const ScopedLock sl (listLock);
     return voices [index];
 }
 
 void Synthesiser::clearVoices()
 {
-    const ScopedLock sl (lock);
-    voices.clear();
+    const ScopedLock sl (listLock);
+
+    for (int i = voices.size(); --i >= 0;)
+        retireVoice (i);
+
+    publishLists();
 }
 
 void Synthesiser::addVoice (SynthesiserVoice* const newVoice)
 {
-    const ScopedLock sl (lock);
+    const ScopedLock sl (listLock);
     voices.add (newVoice);
+    publishLists();
 }
 
 void Synthesiser::removeVoice (const int index)
 {
-    const ScopedLock sl (lock);
-    voices.remove (index);
+    const ScopedLock sl (listLock);
+
+    if (isPositiveAndBelow (index, voices.size()))
+    {
+        retireVoice (index);
+        publishLists();
+    }
 }
 
 void Synthesiser::clearSounds()
 {
-    const ScopedLock sl (lock);
-    sounds.clear();
+    const ScopedLock sl (listLock);
+
+    for (int i = sounds.size(); --i >= 0;)
+        retireSound (i);
+
+    publishLists();
 }
 
 void Synthesiser::addSound (const SynthesiserSound::Ptr& newSound)
 {
-    const ScopedLock sl (lock);
+    const ScopedLock sl (listLock);
     sounds.add (newSound);
+    publishLists();
 }
 
 void Synthesiser::removeSound (const int index)
 {
-    const ScopedLock sl (lock);
-    sounds.remove (index);
+    const ScopedLock sl (listLock);
+
+    if (isPositiveAndBelow (index, sounds.size()))
+    {
+        retireSound (index);
+        publishLists();
+    }
 }
 
 void Synthesiser::setNoteStealingEnabled (const bool shouldStealNotes_)
@@ -123,6 +218,97 @@ void Synthesiser::setNoteStealingEnabled (const bool shouldStealNotes_)
     shouldStealNotes = shouldStealNotes_;
 }
 
+void Synthesiser::setVoiceRenderingThreadPool (ThreadPool* const threadPool, const int numVoiceGroups)
+{
+    OwnedArray<AudioSampleBuffer> newBuffers;
+
+    if (threadPool != nullptr)
+        for (int i = 1; i < numVoiceGroups; ++i)
+            newBuffers.add (new AudioSampleBuffer (2, 512));
+
+    const ScopedLock sl (lock);
+    voiceRenderingPool = newBuffers.size() > 0 ? threadPool : nullptr;
+    voiceGroupBuffers.swapWithArray (newBuffers);
+}
+
+//==============================================================================
+/*  Each change to the voices or sounds publishes a new ActiveLists object, which the
+    rendering methods pick up (while holding the main lock) and acknowledge by setting
+    listsInUse. Because the rendering methods only ever move on to newer lists, any lists,
+    voices or sounds that were dropped before the version that's in use can be deleted.
+*/
+void Synthesiser::updateActiveLists() const
+{
+    ActiveLists* const latest = latestLists.get();
+
+    if (latest != currentLists)
+    {
+        currentLists = latest;
+        listsInUse = latest;
+    }
+}
+
+const Array<SynthesiserVoice*>& Synthesiser::getActiveVoices() const   { return currentLists->voices; }
+const Array<SynthesiserSound*>& Synthesiser::getActiveSounds() const   { return currentLists->sounds; }
+
+void Synthesiser::publishLists()
+{
+    ActiveLists* const lists = new ActiveLists (++lastListVersion);
+
+    lists->voices.ensureStorageAllocated (voices.size());
+    for (int i = 0; i < voices.size(); ++i)
+        lists->voices.add (voices.getUnchecked (i));
+
+    lists->sounds.ensureStorageAllocated (sounds.size());
+    for (int i = 0; i < sounds.size(); ++i)
+        lists->sounds.add (sounds.getUnchecked (i));
+
+    publishedLists.add (lists);
+    latestLists = lists;
+
+    deleteRetiredObjects();
+}
+
+void Synthesiser::retireVoice (const int index)
+{
+    // (the next lists to be published will be the first ones without this voice)
+    retiredVoices.add (voices.removeAndReturn (index));
+    retiredVoiceVersions.add (lastListVersion + 1);
+}
+
+void Synthesiser::retireSound (const int index)
+{
+    retiredSounds.add (sounds.getUnchecked (index));
+    retiredSoundVersions.add (lastListVersion + 1);
+    sounds.remove (index);
+}
+
+void Synthesiser::deleteRetiredObjects()
+{
+    const uint32 versionInUse = listsInUse.get()->version;
+
+    while (publishedLists.getUnchecked (0)->version < versionInUse)
+        publishedLists.remove (0);
+
+    for (int i = retiredVoices.size(); --i >= 0;)
+    {
+        if (retiredVoiceVersions.getUnchecked (i) <= versionInUse)
+        {
+            retiredVoices.remove (i);
+            retiredVoiceVersions.remove (i);
+        }
+    }
+
+    for (int i = retiredSounds.size(); --i >= 0;)
+    {
+        if (retiredSoundVersions.getUnchecked (i) <= versionInUse)
+        {
+            retiredSounds.remove (i);
+            retiredSoundVersions.remove (i);
+        }
+    }
+}
+
 //==============================================================================
 void Synthesiser::setCurrentPlaybackSampleRate (const double newRate)
 {
@@ -134,6 +320,8 @@ void Synthesiser::setCurrentPlaybackSampleRate (const double newRate)
 
         sampleRate = newRate;
 
+        const ScopedLock listSl (listLock);
+
         for (int i = voices.size(); --i >= 0;)
             voices.getUnchecked (i)->setCurrentPlaybackSampleRate (newRate);
     }
@@ -163,10 +351,7 @@ void Synthesiser::renderNextBlock (AudioSampleBuffer& outputBuffer,
                                          : numSamples;
 
         if (numThisTime > 0)
-        {
-            for (int i = voices.size(); --i >= 0;)
-                voices.getUnchecked (i)->renderNextBlock (outputBuffer, startSample, numThisTime);
-        }
+            renderVoices (*ScopedListAccess (*this), outputBuffer, startSample, numThisTime);
 
         if (useEvent)
             handleMidiEvent (m);
@@ -176,6 +361,37 @@ void Synthesiser::renderNextBlock (AudioSampleBuffer& outputBuffer,
     }
 }
 
+void Synthesiser::renderVoices (const ActiveLists& lists, AudioSampleBuffer& outputBuffer,
+                                const int startSample, const int numSamples)
+{
+    const int numGroups = voiceRenderingPool != nullptr ? jmin (voiceGroupBuffers.size() + 1, lists.voices.size())
+                                                        : 1;
+
+    if (numGroups > 1)
+    {
+        for (int i = 1; i < numGroups; ++i)
+        {
+            AudioSampleBuffer& buffer = *voiceGroupBuffers.getUnchecked (i - 1);
+            buffer.setSize (outputBuffer.getNumChannels(), numSamples, false, false, true);
+            buffer.clear();
+        }
+
+        voiceRenderingPool->parallelFor (0, numGroups, VoiceGroupRenderer (lists.voices, outputBuffer, voiceGroupBuffers,
+                                                                           startSample, numSamples, numGroups), 1);
+
+        for (int i = 1; i < numGroups; ++i)
+            for (int chan = outputBuffer.getNumChannels(); --chan >= 0;)
+                FloatVectorOperations::add (outputBuffer.getSampleData (chan, startSample),
+                                            voiceGroupBuffers.getUnchecked (i - 1)->getSampleData (chan),
+                                            numSamples);
+    }
+    else
+    {
+        for (int i = lists.voices.size(); --i >= 0;)
+            lists.voices.getUnchecked (i)->renderNextBlock (outputBuffer, startSample, numSamples);
+    }
+}
+
 void Synthesiser::handleMidiEvent (const MidiMessage& m)
 {
     if (m.isNoteOn())
@@ -216,19 +432,20 @@ void Synthesiser::noteOn (const int midiChannel,
                           const float velocity)
 {
     const ScopedLock sl (lock);
+    const ScopedListAccess lists (*this);
 
-    for (int i = sounds.size(); --i >= 0;)
+    for (int i = lists->sounds.size(); --i >= 0;)
     {
-        SynthesiserSound* const sound = sounds.getUnchecked(i);
+        SynthesiserSound* const sound = lists->sounds.getUnchecked(i);
 
         if (sound->appliesToNote (midiNoteNumber)
              && sound->appliesToChannel (midiChannel))
         {
             // If hitting a note that's still ringing, stop it first (it could be
             // still playing because of the sustain or sostenuto pedal).
-            for (int j = voices.size(); --j >= 0;)
+            for (int j = lists->voices.size(); --j >= 0;)
             {
-                SynthesiserVoice* const voice = voices.getUnchecked (j);
+                SynthesiserVoice* const voice = lists->voices.getUnchecked (j);
 
                 if (voice->getCurrentlyPlayingNote() == midiNoteNumber
                      && voice->isPlayingChannel (midiChannel))
@@ -278,10 +495,11 @@ void Synthesiser::noteOff (const int midiChannel,
                            const bool allowTailOff)
 {
     const ScopedLock sl (lock);
+    const ScopedListAccess lists (*this);
 
-    for (int i = voices.size(); --i >= 0;)
+    for (int i = lists->voices.size(); --i >= 0;)
     {
-        SynthesiserVoice* const voice = voices.getUnchecked (i);
+        SynthesiserVoice* const voice = lists->voices.getUnchecked (i);
 
         if (voice->getCurrentlyPlayingNote() == midiNoteNumber)
         {
@@ -303,10 +521,11 @@ void Synthesiser::noteOff (const int midiChannel,
 void Synthesiser::allNotesOff (const int midiChannel, const bool allowTailOff)
 {
     const ScopedLock sl (lock);
+    const ScopedListAccess lists (*this);
 
-    for (int i = voices.size(); --i >= 0;)
+    for (int i = lists->voices.size(); --i >= 0;)
     {
-        SynthesiserVoice* const voice = voices.getUnchecked (i);
+        SynthesiserVoice* const voice = lists->voices.getUnchecked (i);
 
         if (midiChannel <= 0 || voice->isPlayingChannel (midiChannel))
             voice->stopNote (allowTailOff);
@@ -318,10 +537,11 @@ void Synthesiser::allNotesOff (const int midiChannel, const bool allowTailOff)
 void Synthesiser::handlePitchWheel (const int midiChannel, const int wheelValue)
 {
     const ScopedLock sl (lock);
+    const ScopedListAccess lists (*this);
 
-    for (int i = voices.size(); --i >= 0;)
+    for (int i = lists->voices.size(); --i >= 0;)
     {
-        SynthesiserVoice* const voice = voices.getUnchecked (i);
+        SynthesiserVoice* const voice = lists->voices.getUnchecked (i);
 
         if (midiChannel <= 0 || voice->isPlayingChannel (midiChannel))
             voice->pitchWheelMoved (wheelValue);
@@ -341,10 +561,11 @@ void Synthesiser::handleController (const int midiChannel,
     }
 
     const ScopedLock sl (lock);
+    const ScopedListAccess lists (*this);
 
-    for (int i = voices.size(); --i >= 0;)
+    for (int i = lists->voices.size(); --i >= 0;)
     {
-        SynthesiserVoice* const voice = voices.getUnchecked (i);
+        SynthesiserVoice* const voice = lists->voices.getUnchecked (i);
 
         if (midiChannel <= 0 || voice->isPlayingChannel (midiChannel))
             voice->controllerMoved (controllerNumber, controllerValue);
@@ -355,6 +576,7 @@ void Synthesiser::handleSustainPedal (int midiChannel, bool isDown)
 {
     jassert (midiChannel > 0 && midiChannel <= 16);
     const ScopedLock sl (lock);
+    const ScopedListAccess lists (*this);
 
     if (isDown)
     {
@@ -362,9 +584,9 @@ void Synthesiser::handleSustainPedal (int midiChannel, bool isDown)
     }
     else
     {
-        for (int i = voices.size(); --i >= 0;)
+        for (int i = lists->voices.size(); --i >= 0;)
         {
-            SynthesiserVoice* const voice = voices.getUnchecked (i);
+            SynthesiserVoice* const voice = lists->voices.getUnchecked (i);
 
             if (voice->isPlayingChannel (midiChannel) && ! voice->keyIsDown)
                 stopVoice (voice, true);
@@ -378,10 +600,11 @@ void Synthesiser::handleSostenutoPedal (int midiChannel, bool isDown)
 {
     jassert (midiChannel > 0 && midiChannel <= 16);
     const ScopedLock sl (lock);
+    const ScopedListAccess lists (*this);
 
-    for (int i = voices.size(); --i >= 0;)
+    for (int i = lists->voices.size(); --i >= 0;)
     {
-        SynthesiserVoice* const voice = voices.getUnchecked (i);
+        SynthesiserVoice* const voice = lists->voices.getUnchecked (i);
 
         if (voice->isPlayingChannel (midiChannel))
         {
@@ -404,20 +627,21 @@ SynthesiserVoice* Synthesiser::findFreeVoice (SynthesiserSound* soundToPlay,
                                               const bool stealIfNoneAvailable) const
 {
     const ScopedLock sl (lock);
+    const ScopedListAccess lists (*this);
 
-    for (int i = voices.size(); --i >= 0;)
-        if (voices.getUnchecked (i)->getCurrentlyPlayingNote() < 0
-             && voices.getUnchecked (i)->canPlaySound (soundToPlay))
-            return voices.getUnchecked (i);
+    for (int i = lists->voices.size(); --i >= 0;)
+        if (lists->voices.getUnchecked (i)->getCurrentlyPlayingNote() < 0
+             && lists->voices.getUnchecked (i)->canPlaySound (soundToPlay))
+            return lists->voices.getUnchecked (i);
 
     if (stealIfNoneAvailable)
     {
         // currently this just steals the one that's been playing the longest, but could be made a bit smarter..
         SynthesiserVoice* oldest = nullptr;
 
-        for (int i = voices.size(); --i >= 0;)
+        for (int i = lists->voices.size(); --i >= 0;)
         {
-            SynthesiserVoice* const voice = voices.getUnchecked (i);
+            SynthesiserVoice* const voice = lists->voices.getUnchecked (i);
 
             if (voice->canPlaySound (soundToPlay)
                  && (oldest == nullptr || oldest->noteOnTime > voice->noteOnTime))
@@ -257,6 +257,15 @@ private:
     Before rendering, be sure to call the setCurrentPlaybackSampleRate() to tell it
     what the target playback rate is. This value is passed on to the voices so that
     they can pitch their output correctly.
+
+    Voices and sounds can be added and removed from any thread without blocking the
+    audio thread: each change publishes a new copy of the voice and sound lists, which
+    the rendering methods pick up the next time they're called. Removed voices and
+    sounds are only deleted once the audio thread has stopped using them (this happens
+    the next time the lists are changed, or when the synth is deleted).
+
+    If you have a lot of voices, you can also use setVoiceRenderingThreadPool() to make
+    renderNextBlock() share them out between the threads of a ThreadPool.
 */
 class JUCE_API  Synthesiser
 {
@@ -294,6 +303,24 @@ public:
     /** Deletes one of the voices. */
     void removeVoice (int index);
 
+    //==============================================================================
+    /** Makes renderNextBlock() render the voices on a thread pool.
+
+        The voices are divided into up to numVoiceGroups groups. The first group is
+        rendered straight into the output buffer, and each of the others into its own
+        scratch buffer on one of the pool's threads, and these are then added to the
+        output with FloatVectorOperations.
+
+        For this to work, your voices mustn't share any state that their renderNextBlock()
+        methods change. Note that because the voices are mixed in a different order, the
+        output may differ very slightly from what the synth would produce on its own.
+
+        The pool isn't owned by the synth, and must remain valid until you call this
+        again with a nullptr, which goes back to rendering all the voices on the
+        calling thread.
+    */
+    void setVoiceRenderingThreadPool (ThreadPool* threadPool, int numVoiceGroups);
+
     //==============================================================================
     /** Deletes all sounds. */
     void clearSounds();
@@ -441,12 +468,31 @@ public:
 
 protected:
     //==============================================================================
-    /** This is used to control access to the rendering callback and the note trigger methods. */
+    /** This is used to control access to the rendering callback and the note trigger methods.
+        Adding or removing voices and sounds doesn't use this lock.
+    */
     CriticalSection lock;
 
+    /** The voices and sounds that have been added to the synth.
+
+        These lists are changed by addVoice(), removeSound(), etc, which may be called
+        while the synth is rendering, so the rendering and note trigger methods should
+        use getActiveVoices() and getActiveSounds() instead.
+    */
     OwnedArray <SynthesiserVoice> voices;
     ReferenceCountedArray <SynthesiserSound> sounds;
 
+    /** Returns the voices that the rendering and note trigger methods are using.
+        This should only be called from inside those methods, e.g. in an overridden
+        findFreeVoice().
+    */
+    const Array<SynthesiserVoice*>& getActiveVoices() const;
+
+    /** Returns the sounds that the rendering and note trigger methods are using.
+        This should only be called from inside those methods.
+    */
+    const Array<SynthesiserSound*>& getActiveSounds() const;
+
     /** The last pitch-wheel values for each midi channel. */
     int lastPitchWheelValues [16];
 
@@ -478,6 +524,33 @@ private:
     bool shouldStealNotes;
     BigInteger sustainPedalsDown;
 
+    struct ActiveLists;
+    class ScopedListAccess;
+    class VoiceGroupRenderer;
+    friend class OwnedArray<ActiveLists>;
+    friend class ScopedListAccess;
+
+    CriticalSection listLock;
+    OwnedArray<ActiveLists> publishedLists;
+    Atomic<ActiveLists*> latestLists;
+    mutable Atomic<ActiveLists*> listsInUse;
+    mutable ActiveLists* currentLists;
+    mutable int listAccessDepth;
+    OwnedArray<SynthesiserVoice> retiredVoices;
+    ReferenceCountedArray<SynthesiserSound> retiredSounds;
+    Array<uint32> retiredVoiceVersions, retiredSoundVersions;
+    uint32 lastListVersion;
+
+    ThreadPool* voiceRenderingPool;
+    OwnedArray<AudioSampleBuffer> voiceGroupBuffers;
+
+    void updateActiveLists() const;
+    void publishLists();
+    void retireVoice (int index);
+    void retireSound (int index);
+    void deleteRetiredObjects();
+    void renderVoices (const ActiveLists&, AudioSampleBuffer&, int startSample, int numSamples);
+
     void handleMidiEvent (const MidiMessage& m);
     void stopVoice (SynthesiserVoice* voice, bool allowTailOff);
 
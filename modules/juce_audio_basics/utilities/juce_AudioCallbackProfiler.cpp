@@ -0,0 +1,140 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+
+AudioCallbackProfiler::AudioCallbackProfiler (const int eventBufferSize)
+    : slots ((size_t) nextPowerOfTwo (jmax (2, eventBufferSize))),
+      mask ((uint32) nextPowerOfTwo (jmax (2, eventBufferSize)) - 1),
+      readPosition (0)
+{
+    // (this uses the same scheme as ParameterChangeQueue: each slot's sequence number
+    // tells a writer whether it's free, and the reader whether it has been filled yet)
+    for (uint32 i = 0; i <= mask; ++i)
+        slots[i].sequence.set (i);
+}
+
+AudioCallbackProfiler::~AudioCallbackProfiler()
+{
+}
+
+void AudioCallbackProfiler::addEvent (const Event::Type type, const int id, const int numSamples,
+                                      const double startTime, const double duration) noexcept
+{
+    uint32 pos = writePosition.get();
+
+    for (;;)
+    {
+        const int distance = (int) (slots [pos & mask].sequence.get() - pos);
+
+        if (distance == 0)
+        {
+            if (writePosition.compareAndSetBool (pos + 1, pos))
+                break;
+        }
+        else if (distance < 0)
+        {
+            ++numDroppedEvents;
+            return;
+        }
+
+        pos = writePosition.get();
+    }
+
+    Slot& slot = slots [pos & mask];
+    slot.event.type = type;
+    slot.event.id = id;
+    slot.event.numSamples = numSamples;
+    slot.event.startTime = startTime;
+    slot.event.duration = duration;
+
+    Atomic<uint32>::memoryBarrier();
+    slot.sequence.set (pos + 1);
+}
+
+void AudioCallbackProfiler::addDeviceCallback (const int numSamples, const double sampleRate,
+                                               const double startTime, const double duration) noexcept
+{
+    addEvent (Event::deviceCallback, 0, numSamples, startTime, duration);
+
+    if (numSamples > 0 && sampleRate > 0)
+    {
+        const double blockDuration = 1000.0 * numSamples / sampleRate;
+        const int bin = (int) (binsPerBlockDuration * duration / blockDuration);
+
+        ++histogram [jlimit (0, (int) numHistogramBins - 1, bin)];
+    }
+}
+
+int AudioCallbackProfiler::readEvents (Array<Event>& destination)
+{
+    int numRead = 0;
+
+    for (;;)
+    {
+        Slot& slot = slots [readPosition & mask];
+
+        if ((int) (slot.sequence.get() - (readPosition + 1)) < 0)
+            break;
+
+        destination.add (slot.event);
+
+        Atomic<uint32>::memoryBarrier();
+        slot.sequence.set (readPosition + mask + 1);
+        ++readPosition;
+        ++numRead;
+    }
+
+    return numRead;
+}
+
+int AudioCallbackProfiler::getHistogramBin (const int binIndex) const noexcept
+{
+    return isPositiveAndBelow (binIndex, (int) numHistogramBins) ? histogram [binIndex].get() : 0;
+}
+
+void AudioCallbackProfiler::resetHistogram() noexcept
+{
+    for (int i = 0; i < numHistogramBins; ++i)
+        histogram[i] = 0;
+
+    numDroppedEvents = 0;
+}
+
+String AudioCallbackProfiler::createCSV (const Array<Event>& events)
+{
+    static const char* const typeNames[] = { "device", "callback", "node", "xrun" };
+
+    String s ("type,id,samples,start_ms,duration_ms");
+    s.preallocateBytes (40 * (size_t) (events.size() + 1));
+
+    for (int i = 0; i < events.size(); ++i)
+    {
+        const Event& e = events.getReference (i);
+
+        s << newLine << typeNames [e.type] << ',' << e.id << ',' << e.numSamples
+          << ',' << String (e.startTime, 3) << ',' << String (e.duration, 4);
+    }
+
+    return s;
+}
@@ -0,0 +1,147 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+
+#ifndef __JUCE_AUDIOCALLBACKPROFILER_JUCEHEADER__
+#define __JUCE_AUDIOCALLBACKPROFILER_JUCEHEADER__
+
+
+//==============================================================================
+/**
+    Records timing measurements made on the audio thread, so that they can be
+    examined and exported by another thread.
+
+    Events are added to a fixed-size ring buffer without locking or allocating,
+    so any number of audio threads can add them at once. The message thread (or
+    any other single thread) can then collect them with readEvents(). If the
+    reader falls behind and the buffer fills up, new events are dropped and counted.
+
+    It also keeps a histogram of how long the audio device's callbacks take,
+    as a proportion of the time that the block of samples lasts, so that you can see
+    how close the callbacks are getting to their deadline.
+
+    An AudioDeviceManager can use one of these to record its device callbacks and the
+    device's xruns, and an AudioProcessorGraph can use one to time each of its nodes.
+
+    @see AudioDeviceManager::setProfiler, AudioProcessorGraph::setProfiler
+*/
+class JUCE_API  AudioCallbackProfiler
+{
+public:
+    //==============================================================================
+    /** Creates a profiler which can hold up to the given number of unread events. */
+    explicit AudioCallbackProfiler (int eventBufferSize = 8192);
+
+    /** Destructor. */
+    ~AudioCallbackProfiler();
+
+    //==============================================================================
+    /** A measurement made on the audio thread. */
+    struct Event
+    {
+        enum Type
+        {
+            deviceCallback,     /**< A complete audio device callback. */
+            audioCallback,      /**< One of the AudioIODeviceCallbacks that a device callback calls.
+                                     The id is the callback's index. */
+            graphNode,          /**< The processing of an AudioProcessorGraph node. The id is its node ID. */
+            xrun                /**< The device reported some over- or under-runs. The id is the number of them. */
+        };
+
+        Type type;
+        int id;
+
+        /** The number of samples in the block. */
+        int numSamples;
+
+        /** The Time::getMillisecondCounterHiRes() time at which it started. */
+        double startTime;
+
+        /** The number of milliseconds that it took. */
+        double duration;
+    };
+
+    //==============================================================================
+    /** Adds an event.
+        This can be called by any thread, and will never block or allocate memory.
+    */
+    void addEvent (Event::Type type, int id, int numSamples, double startTime, double duration) noexcept;
+
+    /** Adds a deviceCallback event, and adds its duration to the histogram. */
+    void addDeviceCallback (int numSamples, double sampleRate, double startTime, double duration) noexcept;
+
+    //==============================================================================
+    /** Moves any events that have been added since the last call into an array.
+        Only one thread may read the events. Returns the number of events that were added
+        to the array.
+    */
+    int readEvents (Array<Event>& destination);
+
+    /** Returns the number of events that had to be thrown away because the buffer was full. */
+    int getNumDroppedEvents() const noexcept                { return numDroppedEvents.get(); }
+
+    //==============================================================================
+    enum
+    {
+        numHistogramBins = 33,      /**< The number of bins in the callback histogram. */
+        binsPerBlockDuration = 16   /**< The number of bins that cover the duration of a block. */
+    };
+
+    /** Returns the number of device callbacks that took between (binIndex / binsPerBlockDuration)
+        and ((binIndex + 1) / binsPerBlockDuration) of the time that their block lasted.
+
+        Bin number binsPerBlockDuration and above hold callbacks which missed their deadline,
+        and the last bin also holds any callbacks that were slower than that.
+    */
+    int getHistogramBin (int binIndex) const noexcept;
+
+    /** Clears the histogram and the dropped-event count. */
+    void resetHistogram() noexcept;
+
+    //==============================================================================
+    /** Returns some events as a comma-separated table, with a header line, which
+        can be written to a file to be examined in other tools.
+    */
+    static String createCSV (const Array<Event>& events);
+
+private:
+    //==============================================================================
+    struct Slot
+    {
+        Atomic<uint32> sequence;
+        Event event;
+    };
+
+    HeapBlock<Slot> slots;
+    const uint32 mask;
+    Atomic<uint32> writePosition;
+    uint32 readPosition;
+    Atomic<int> numDroppedEvents;
+    Atomic<int> histogram [numHistogramBins];
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioCallbackProfiler)
+};
+
+
+#endif   // __JUCE_AUDIOCALLBACKPROFILER_JUCEHEADER__
@@ -71,6 +71,11 @@ private:
         owner.audioDeviceErrorInt (message);
     }
 
+    void audioDeviceLatencyChanged()
+    {
+        owner.audioDeviceLatencyChangedInt();
+    }
+
     void handleIncomingMidiMessage (MidiInput* source, const MidiMessage& message)
     {
         owner.handleIncomingMidiMessageInt (source, message);
@@ -86,6 +91,43 @@ private:
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CallbackHandler)
 };
 
+//==============================================================================
+struct AudioDeviceManager::TestSound  : public ReferenceCountedObject
+{
+    TestSound (const int numSamples)  : buffer (1, numSamples), position (0) {}
+
+    AudioSampleBuffer buffer;
+    int position; // once published, this is only used by the audio thread
+
+    typedef ReferenceCountedObjectPtr<TestSound> Ptr;
+
+    JUCE_DECLARE_NON_COPYABLE (TestSound)
+};
+
+/*  An immutable copy of the callback list, which the audio thread can use without locking.
+
+    Whenever the list changes, the message thread builds a new one and swaps it in atomically.
+    The old one is kept until the audio thread can't possibly still be using it, which is when
+    it has left the callback it was in at the time of the swap.
+*/
+struct AudioDeviceManager::CallbackList
+{
+    CallbackList() noexcept  : profiler (nullptr), retiredAtSequence (0) {}
+
+    struct Entry
+    {
+        AudioIODeviceCallback* callback;
+        double cpuUsageMs;
+    };
+
+    Array<Entry> entries;
+    TestSound::Ptr testSound;
+    AudioCallbackProfiler* profiler;
+    int retiredAtSequence;
+
+    JUCE_DECLARE_NON_COPYABLE (CallbackList)
+};
+
 
 //==============================================================================
 AudioDeviceManager::AudioDeviceManager()
@@ -94,10 +136,12 @@ AudioDeviceManager::AudioDeviceManager()
       listNeedsScanning (true),
       useInputNames (false),
       inputLevel (0),
-      testSoundPosition (0),
       tempBuffer (2, 2),
       cpuUsageMs (0),
-      timeToCpuScale (0)
+      timeToCpuScale (0),
+      profiler (nullptr),
+      lastXRunCount (0),
+      audioThreadId (0)
 {
     callbackHandler = new CallbackHandler (*this);
 }
@@ -106,6 +150,7 @@ AudioDeviceManager::~AudioDeviceManager()
 {
     currentAudioDevice = nullptr;
     defaultMidiOutput = nullptr;
+    delete activeCallbacks.exchange (nullptr);
 }
 
 
@@ -155,7 +200,8 @@ static void addIfNotNull (OwnedArray <AudioIODeviceType>& list, AudioIODeviceTyp
 
 void AudioDeviceManager::createAudioDeviceTypes (OwnedArray <AudioIODeviceType>& list)
 {
-    addIfNotNull (list, AudioIODeviceType::createAudioIODeviceType_WASAPI());
+    addIfNotNull (list, AudioIODeviceType::createAudioIODeviceType_WASAPI (false));
+    addIfNotNull (list, AudioIODeviceType::createAudioIODeviceType_WASAPI (true));
     addIfNotNull (list, AudioIODeviceType::createAudioIODeviceType_DirectSound());
     addIfNotNull (list, AudioIODeviceType::createAudioIODeviceType_ASIO());
     addIfNotNull (list, AudioIODeviceType::createAudioIODeviceType_CoreAudio());
@@ -562,7 +608,10 @@ void AudioDeviceManager::stopDevice()
     if (currentAudioDevice != nullptr)
         currentAudioDevice->stop();
 
-    testSound = nullptr;
+    const ScopedLock sl (audioCallbackLock);
+    CallbackList* const newList = createCallbackList();
+    newList->testSound = nullptr;
+    publishCallbackList (newList);
 }
 
 void AudioDeviceManager::closeAudioDevice()
@@ -646,6 +695,7 @@ void AudioDeviceManager::addAudioCallback (AudioIODeviceCallback* newCallback)
 
     const ScopedLock sl (audioCallbackLock);
     callbacks.add (newCallback);
+    updateActiveCallbacks();
 }
 
 void AudioDeviceManager::removeAudioCallback (AudioIODeviceCallback* callbackToRemove)
@@ -659,20 +709,114 @@ void AudioDeviceManager::removeAudioCallback (AudioIODeviceCallback* callbackToR
 
             needsDeinitialising = needsDeinitialising && callbacks.contains (callbackToRemove);
             callbacks.removeFirstMatchingValue (callbackToRemove);
+            updateActiveCallbacks();
         }
 
+        // the caller may delete the callback as soon as this returns, so the audio thread
+        // has to have finished with it..
+        waitForAudioThreadToReleaseCallbacks();
+
         if (needsDeinitialising)
             callbackToRemove->audioDeviceStopped();
     }
 }
 
+AudioDeviceManager::CallbackList* AudioDeviceManager::createCallbackList() const
+{
+    const CallbackList* const oldList = activeCallbacks.get();
+    CallbackList* const newList = new CallbackList();
+
+    for (int i = 0; i < callbacks.size(); ++i)
+    {
+        CallbackList::Entry entry = { callbacks.getUnchecked(i), 0.0 };
+
+        if (oldList != nullptr)
+        {
+            for (int j = oldList->entries.size(); --j >= 0;)
+            {
+                if (oldList->entries.getReference(j).callback == entry.callback)
+                {
+                    entry.cpuUsageMs = oldList->entries.getReference(j).cpuUsageMs;
+                    break;
+                }
+            }
+        }
+
+        newList->entries.add (entry);
+    }
+
+    if (oldList != nullptr)
+        newList->testSound = oldList->testSound;
+
+    newList->profiler = profiler;
+    return newList;
+}
+
+void AudioDeviceManager::publishCallbackList (CallbackList* const newList)
+{
+    // (must be called with the audioCallbackLock held)
+    if (CallbackList* const oldList = activeCallbacks.exchange (newList))
+    {
+        oldList->retiredAtSequence = audioCallbackSequence.get();
+        retiredCallbacks.add (oldList);
+    }
+
+    releaseRetiredCallbackLists();
+}
+
+void AudioDeviceManager::updateActiveCallbacks()
+{
+    publishCallbackList (createCallbackList());
+}
+
+bool AudioDeviceManager::releaseRetiredCallbackLists()
+{
+    // (must be called with the audioCallbackLock held)
+    // The sequence number is odd while the audio thread is inside a callback, so a list can
+    // go once the number has moved on from the value it had when the list was swapped out.
+    const int sequence = audioCallbackSequence.get();
+
+    for (int i = retiredCallbacks.size(); --i >= 0;)
+    {
+        const int retiredAt = retiredCallbacks.getUnchecked(i)->retiredAtSequence;
+
+        if ((retiredAt & 1) == 0 || retiredAt != sequence)
+            retiredCallbacks.remove (i);
+    }
+
+    return retiredCallbacks.size() == 0;
+}
+
+void AudioDeviceManager::waitForAudioThreadToReleaseCallbacks()
+{
+    // If we're being called from inside the audio callback, there's no point waiting for it!
+    if (audioThreadId == Thread::getCurrentThreadId() && (audioCallbackSequence.get() & 1) != 0)
+        return;
+
+    for (;;)
+    {
+        {
+            const ScopedLock sl (audioCallbackLock);
+
+            if (releaseRetiredCallbackLists())
+                return;
+        }
+
+        Thread::sleep (1);
+    }
+}
+
 void AudioDeviceManager::audioDeviceIOCallbackInt (const float** inputChannelData,
                                                    int numInputChannels,
                                                    float** outputChannelData,
                                                    int numOutputChannels,
                                                    int numSamples)
 {
-    const ScopedLock sl (audioCallbackLock);
+    ++audioCallbackSequence;
+    audioThreadId = Thread::getCurrentThreadId();
+
+    const ScopedNoDenormals noDenormals (denormalProtection.get() != 0);
+    CallbackList* const list = activeCallbacks.get();
 
     if (inputLevelMeasurementEnabledCount.get() > 0 && numInputChannels > 0)
     {
@@ -700,21 +844,44 @@ void AudioDeviceManager::audioDeviceIOCallbackInt (const float** inputChannelDat
         inputLevel = 0;
     }
 
-    if (callbacks.size() > 0)
+    const int numCallbacks = list != nullptr ? list->entries.size() : 0;
+
+    if (numCallbacks > 0)
     {
+        const double filterAmount = 0.2;
         const double callbackStartTime = Time::getMillisecondCounterHiRes();
 
         tempBuffer.setSize (jmax (1, numOutputChannels), jmax (1, numSamples), false, false, true);
 
-        callbacks.getUnchecked(0)->audioDeviceIOCallback (inputChannelData, numInputChannels,
-                                                          outputChannelData, numOutputChannels, numSamples);
+        CallbackList::Entry& first = list->entries.getReference (0);
+        first.callback->audioDeviceIOCallback (inputChannelData, numInputChannels,
+                                               outputChannelData, numOutputChannels, numSamples);
+
+        double timeNow = Time::getMillisecondCounterHiRes();
+        first.cpuUsageMs += filterAmount * ((timeNow - callbackStartTime) - first.cpuUsageMs);
+
+        AudioCallbackProfiler* const profiler = list->profiler;
+
+        if (profiler != nullptr)
+            profiler->addEvent (AudioCallbackProfiler::Event::audioCallback, 0, numSamples,
+                                callbackStartTime, timeNow - callbackStartTime);
 
         float** const tempChans = tempBuffer.getArrayOfChannels();
 
-        for (int i = callbacks.size(); --i > 0;)
+        for (int i = numCallbacks; --i > 0;)
         {
-            callbacks.getUnchecked(i)->audioDeviceIOCallback (inputChannelData, numInputChannels,
-                                                              tempChans, numOutputChannels, numSamples);
+            CallbackList::Entry& entry = list->entries.getReference (i);
+            const double entryStartTime = Time::getMillisecondCounterHiRes();
+
+            entry.callback->audioDeviceIOCallback (inputChannelData, numInputChannels,
+                                                   tempChans, numOutputChannels, numSamples);
+
+            timeNow = Time::getMillisecondCounterHiRes();
+            entry.cpuUsageMs += filterAmount * ((timeNow - entryStartTime) - entry.cpuUsageMs);
+
+            if (profiler != nullptr)
+                profiler->addEvent (AudioCallbackProfiler::Event::audioCallback, i, numSamples,
+                                    entryStartTime, timeNow - entryStartTime);
 
             for (int chan = 0; chan < numOutputChannels; ++chan)
             {
@@ -726,8 +893,23 @@ void AudioDeviceManager::audioDeviceIOCallbackInt (const float** inputChannelDat
         }
 
         const double msTaken = Time::getMillisecondCounterHiRes() - callbackStartTime;
-        const double filterAmount = 0.2;
         cpuUsageMs += filterAmount * (msTaken - cpuUsageMs);
+
+        if (profiler != nullptr)
+        {
+            profiler->addDeviceCallback (numSamples, currentSetup.sampleRate, callbackStartTime, msTaken);
+
+            if (currentAudioDevice != nullptr)
+            {
+                const int xruns = currentAudioDevice->getXRunCount();
+
+                if (xruns > lastXRunCount)
+                    profiler->addEvent (AudioCallbackProfiler::Event::xrun, xruns - lastXRunCount,
+                                        numSamples, callbackStartTime, 0);
+
+                lastXRunCount = xruns;
+            }
+        }
     }
     else
     {
@@ -735,24 +917,29 @@ void AudioDeviceManager::audioDeviceIOCallbackInt (const float** inputChannelDat
             zeromem (outputChannelData[i], sizeof (float) * (size_t) numSamples);
     }
 
-    if (testSound != nullptr)
+    if (TestSound* const testSound = (list != nullptr ? list->testSound.getObject() : nullptr))
     {
-        const int numSamps = jmin (numSamples, testSound->getNumSamples() - testSoundPosition);
-        const float* const src = testSound->getSampleData (0, testSoundPosition);
+        const int numSamps = jmin (numSamples, testSound->buffer.getNumSamples() - testSound->position);
 
-        for (int i = 0; i < numOutputChannels; ++i)
-            for (int j = 0; j < numSamps; ++j)
-                outputChannelData [i][j] += src[j];
+        if (numSamps > 0)
+        {
+            const float* const src = testSound->buffer.getSampleData (0, testSound->position);
 
-        testSoundPosition += numSamps;
-        if (testSoundPosition >= testSound->getNumSamples())
-            testSound = nullptr;
+            for (int i = 0; i < numOutputChannels; ++i)
+                for (int j = 0; j < numSamps; ++j)
+                    outputChannelData [i][j] += src[j];
+
+            testSound->position += numSamps;
+        }
     }
+
+    ++audioCallbackSequence;
 }
 
 void AudioDeviceManager::audioDeviceAboutToStartInt (AudioIODevice* const device)
 {
     cpuUsageMs = 0;
+    lastXRunCount = jmax (0, device->getXRunCount());
 
     const double sampleRate = device->getCurrentSampleRate();
     const int blockSize = device->getCurrentBufferSizeSamples();
@@ -767,6 +954,10 @@ void AudioDeviceManager::audioDeviceAboutToStartInt (AudioIODevice* const device
         const ScopedLock sl (audioCallbackLock);
         for (int i = callbacks.size(); --i >= 0;)
             callbacks.getUnchecked(i)->audioDeviceAboutToStart (device);
+
+        if (CallbackList* const list = activeCallbacks.get())
+            for (int i = list->entries.size(); --i >= 0;)
+                list->entries.getReference(i).cpuUsageMs = 0;
     }
 
     sendChangeMessage();
@@ -790,11 +981,54 @@ void AudioDeviceManager::audioDeviceErrorInt (const String& message)
         callbacks.getUnchecked(i)->audioDeviceError (message);
 }
 
+void AudioDeviceManager::audioDeviceLatencyChangedInt()
+{
+    {
+        const ScopedLock sl (audioCallbackLock);
+        for (int i = callbacks.size(); --i >= 0;)
+            callbacks.getUnchecked(i)->audioDeviceLatencyChanged();
+    }
+
+    sendChangeMessage();
+}
+
+int AudioDeviceManager::getXRunCount() const noexcept
+{
+    return currentAudioDevice != nullptr ? currentAudioDevice->getXRunCount() : -1;
+}
+
 double AudioDeviceManager::getCpuUsage() const
 {
     return jlimit (0.0, 1.0, timeToCpuScale * cpuUsageMs);
 }
 
+void AudioDeviceManager::setProfiler (AudioCallbackProfiler* const newProfiler)
+{
+    if (profiler != newProfiler)
+    {
+        {
+            const ScopedLock sl (audioCallbackLock);
+            profiler = newProfiler;
+            updateActiveCallbacks();
+        }
+
+        // the caller may delete the old profiler as soon as this returns..
+        waitForAudioThreadToReleaseCallbacks();
+    }
+}
+
+double AudioDeviceManager::getCpuUsageForCallback (AudioIODeviceCallback* const callback) const
+{
+    const ScopedLock sl (audioCallbackLock);
+
+    if (const CallbackList* const list = activeCallbacks.get())
+        for (int i = list->entries.size(); --i >= 0;)
+            if (list->entries.getReference(i).callback == callback)
+                return jlimit (0.0, 1.0, timeToCpuScale * list->entries.getReference(i).cpuUsageMs);
+
+    return 0.0;
+}
+
 //==============================================================================
 void AudioDeviceManager::setMidiInputEnabled (const String& name, const bool enabled)
 {
@@ -886,10 +1120,12 @@ void AudioDeviceManager::setDefaultMidiOutput (const String& deviceName)
 
         {
             const ScopedLock sl (audioCallbackLock);
-            oldCallbacks = callbacks;
-            callbacks.clear();
+            oldCallbacks.swapWithArray (callbacks);
+            updateActiveCallbacks();
         }
 
+        waitForAudioThreadToReleaseCallbacks();
+
         if (currentAudioDevice != nullptr)
             for (int i = oldCallbacks.size(); --i >= 0;)
                 oldCallbacks.getUnchecked(i)->audioDeviceStopped();
@@ -907,6 +1143,7 @@ void AudioDeviceManager::setDefaultMidiOutput (const String& deviceName)
         {
             const ScopedLock sl (audioCallbackLock);
             callbacks = oldCallbacks;
+            updateActiveCallbacks();
         }
 
         updateXml();
@@ -917,24 +1154,15 @@ void AudioDeviceManager::setDefaultMidiOutput (const String& deviceName)
 //==============================================================================
 void AudioDeviceManager::playTestSound()
 {
-    { // cunningly nested to swap, unlock and delete in that order.
-        ScopedPointer <AudioSampleBuffer> oldSound;
-
-        {
-            const ScopedLock sl (audioCallbackLock);
-            oldSound = testSound;
-        }
-    }
-
-    testSoundPosition = 0;
+    TestSound::Ptr newSound;
 
     if (currentAudioDevice != nullptr)
     {
         const double sampleRate = currentAudioDevice->getCurrentSampleRate();
         const int soundLength = (int) sampleRate;
 
-        AudioSampleBuffer* const newSound = new AudioSampleBuffer (1, soundLength);
-        float* samples = newSound->getSampleData (0);
+        newSound = new TestSound (soundLength);
+        float* samples = newSound->buffer.getSampleData (0);
 
         const double frequency = 440.0;
         const float amplitude = 0.5f;
@@ -944,12 +1172,14 @@ void AudioDeviceManager::playTestSound()
         for (int i = 0; i < soundLength; ++i)
             samples[i] = amplitude * (float) std::sin (i * phasePerSample);
 
-        newSound->applyGainRamp (0, 0, soundLength / 10, 0.0f, 1.0f);
-        newSound->applyGainRamp (0, soundLength - soundLength / 4, soundLength / 4, 1.0f, 0.0f);
-
-        const ScopedLock sl (audioCallbackLock);
-        testSound = newSound;
+        newSound->buffer.applyGainRamp (0, 0, soundLength / 10, 0.0f, 1.0f);
+        newSound->buffer.applyGainRamp (0, soundLength - soundLength / 4, soundLength / 4, 1.0f, 0.0f);
     }
+
+    const ScopedLock sl (audioCallbackLock);
+    CallbackList* const newList = createCallbackList();
+    newList->testSound = newSound;
+    publishCallbackList (newList);
 }
 
 void AudioDeviceManager::enableInputLevelMeasurement (const bool enableMeasurement)
@@ -962,6 +1192,11 @@ void AudioDeviceManager::enableInputLevelMeasurement (const bool enableMeasureme
     inputLevel = 0;
 }
 
+void AudioDeviceManager::setDenormalProtection (const bool shouldProtectAgainstDenormals)
+{
+    denormalProtection = shouldProtectAgainstDenormals ? 1 : 0;
+}
+
 double AudioDeviceManager::getCurrentInputLevel() const
 {
     jassert (inputLevelMeasurementEnabledCount.get() > 0); // you need to call enableInputLevelMeasurement() before using this!
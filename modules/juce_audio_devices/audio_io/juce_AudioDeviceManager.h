@@ -61,7 +61,7 @@
     re-registering with different midi devices if they are changed or deleted.
 
     And yet another neat trick is that amount of CPU time being used is measured and
-    available with the getCpuUsage() method.
+    available with the getCpuUsage() method, both in total and for each of the callbacks.
 
     The AudioDeviceManager is a ChangeBroadcaster, and will send a change message to
     listeners whenever one of its settings is changed.
@@ -310,6 +310,42 @@ public:
     */
     double getCpuUsage() const;
 
+    /** Returns the average proportion of available CPU being spent inside one of the
+        registered audio callbacks.
+
+        Returns a value between 0 and 1.0, or 0 if the callback isn't registered.
+        @see getCpuUsage, addAudioCallback
+    */
+    double getCpuUsageForCallback (AudioIODeviceCallback* callback) const;
+
+    /** Gives the manager a profiler to record the timings of its callbacks in.
+
+        While a profiler is set, each device callback adds a deviceCallback event for the
+        whole callback, and an audioCallback event for each of the registered callbacks.
+        When the device reports an xrun, an xrun event is added too.
+
+        The profiler isn't deleted by the manager, and the caller must keep it alive until
+        it has been removed by calling this method with a nullptr. Once this method returns,
+        the audio thread won't use the old profiler again.
+
+        @see AudioCallbackProfiler, AudioIODevice::getXRunCount
+    */
+    void setProfiler (AudioCallbackProfiler* newProfiler);
+
+    /** Returns the profiler that was set with setProfiler(), if there is one. */
+    AudioCallbackProfiler* getProfiler() const noexcept     { return profiler; }
+
+    /** Returns the number of xruns that the current device has reported since it was opened,
+        or -1 if there's no device or it can't report them.
+
+        When the device tells the manager that its latency has changed, the manager passes
+        this on to its callbacks' AudioIODeviceCallback::audioDeviceLatencyChanged() methods,
+        and sends a change message.
+
+        @see AudioIODevice::getXRunCount
+    */
+    int getXRunCount() const noexcept;
+
     //==============================================================================
     /** Enables or disables a midi input device.
 
@@ -436,9 +472,24 @@ public:
     */
     double getCurrentInputLevel() const;
 
-    /** Returns the a lock that can be used to synchronise access to the audio callback.
-        Obviously while this is locked, you're blocking the audio thread from running, so
-        it must only be used for very brief periods when absolutely necessary.
+    /** Chooses whether the audio callbacks are run with denormalised number support turned off.
+
+        When enabled, the device's audio thread has its floating point unit set to flush
+        denormals to zero while it calls the callbacks, which stops filters and reverbs
+        from getting very expensive as they decay into silence. This is off by default.
+
+        @see ScopedNoDenormals
+    */
+    void setDenormalProtection (bool shouldProtectAgainstDenormals);
+
+    /** Returns true if setDenormalProtection() has been turned on. */
+    bool hasDenormalProtection() const noexcept             { return denormalProtection.get() != 0; }
+
+    /** Returns the lock that is used to synchronise changes to the list of audio callbacks.
+
+        Note that the audio thread never takes this lock - it reads an immutable copy of the
+        callback list which is swapped in atomically whenever the list changes - so holding
+        it won't stop your callbacks from being called.
     */
     CriticalSection& getAudioCallbackLock() noexcept        { return audioCallbackLock; }
 
@@ -462,10 +513,8 @@ private:
     ScopedPointer <XmlElement> lastExplicitSettings;
     mutable bool listNeedsScanning;
     bool useInputNames;
-    Atomic<int> inputLevelMeasurementEnabledCount;
+    Atomic<int> inputLevelMeasurementEnabledCount, denormalProtection;
     double inputLevel;
-    ScopedPointer <AudioSampleBuffer> testSound;
-    int testSoundPosition;
     AudioSampleBuffer tempBuffer;
 
     StringArray midiInsFromXml;
@@ -477,6 +526,15 @@ private:
     CriticalSection audioCallbackLock, midiCallbackLock;
 
     double cpuUsageMs, timeToCpuScale;
+    AudioCallbackProfiler* profiler;
+    int lastXRunCount;
+
+    struct TestSound;
+    struct CallbackList;
+    Atomic<CallbackList*> activeCallbacks;
+    OwnedArray<CallbackList> retiredCallbacks;
+    Atomic<int> audioCallbackSequence;
+    Thread::ThreadID audioThreadId;
 
     //==============================================================================
     class CallbackHandler;
@@ -489,9 +547,16 @@ private:
     void audioDeviceAboutToStartInt (AudioIODevice*);
     void audioDeviceStoppedInt();
     void audioDeviceErrorInt (const String&);
+    void audioDeviceLatencyChangedInt();
     void handleIncomingMidiMessageInt (MidiInput*, const MidiMessage&);
     void audioDeviceListChanged();
 
+    CallbackList* createCallbackList() const;
+    void publishCallbackList (CallbackList*);
+    void updateActiveCallbacks();
+    bool releaseRetiredCallbackLists();
+    void waitForAudioThreadToReleaseCallbacks();
+
     String restartDevice (int blockSizeToUse, double sampleRateToUse,
                           const BigInteger& ins, const BigInteger& outs);
     void stopDevice();
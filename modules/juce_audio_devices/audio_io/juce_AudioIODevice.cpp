@@ -44,5 +44,11 @@ bool AudioIODevice::showControlPanel()
     return false;
 }
 
+int AudioIODevice::getXRunCount() const noexcept
+{
+    return -1;
+}
+
 //==============================================================================
 void AudioIODeviceCallback::audioDeviceError (const String&) {}
+void AudioIODeviceCallback::audioDeviceLatencyChanged() {}
@@ -111,6 +111,14 @@ public:
         this callback.
     */
     virtual void audioDeviceError (const String& errorMessage);
+
+    /** This can be overridden to be told when the device's input or output latency has
+        changed, e.g. because the routing of a JACK graph has been altered.
+        As with audioDeviceError(), this could be called by any thread, and not all devices
+        perform this callback.
+        @see AudioIODevice::getInputLatencyInSamples, AudioIODevice::getOutputLatencyInSamples
+    */
+    virtual void audioDeviceLatencyChanged();
 };
 
 
@@ -302,6 +310,13 @@ public:
     */
     virtual int getInputLatencyInSamples() = 0;
 
+    /** Returns the number of times that the device has reported an over- or under-run
+        since it was opened, or -1 if it can't report them.
+
+        This is safe to call from the audio callback.
+    */
+    virtual int getXRunCount() const noexcept;
+
 
     //==============================================================================
     /** True if this device can show a pop-up control panel for editing its settings.
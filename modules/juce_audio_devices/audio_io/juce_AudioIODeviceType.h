@@ -153,8 +153,14 @@ public:
     static AudioIODeviceType* createAudioIODeviceType_CoreAudio();
     /** Creates an iOS device type if it's available on this platform, or returns null. */
     static AudioIODeviceType* createAudioIODeviceType_iOSAudio();
-    /** Creates a WASAPI device type if it's available on this platform, or returns null. */
-    static AudioIODeviceType* createAudioIODeviceType_WASAPI();
+    /** Creates a WASAPI device type if it's available on this platform, or returns null.
+
+        If exclusiveMode is true, the devices it creates will open the hardware in exclusive,
+        event-driven mode, using the smallest period the driver allows for the requested
+        buffer size. This gives much lower latency than shared mode, but no other app can
+        use the device while it's open.
+    */
+    static AudioIODeviceType* createAudioIODeviceType_WASAPI (bool exclusiveMode = false);
     /** Creates a DirectSound device type if it's available on this platform, or returns null. */
     static AudioIODeviceType* createAudioIODeviceType_DirectSound();
     /** Creates an ASIO device type if it's available on this platform, or returns null. */
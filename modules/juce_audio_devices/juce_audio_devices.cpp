@@ -125,6 +125,8 @@
  #if JUCE_USE_ANDROID_OPENSLES
   #include <SLES/OpenSLES.h>
   #include <SLES/OpenSLES_Android.h>
+  #include <pthread.h>
+  #include <sys/resource.h>
  #endif
 
 #endif
@@ -63,6 +63,17 @@
  #define JUCE_ALSA 1
 #endif
 
+/** Config: JUCE_ALSA_LOW_LATENCY
+    Makes ALSA devices use mmap transfers wherever the hardware allows it, so that the
+    audio is converted directly into and out of the device's ring buffer. Capture and
+    playback are linked so that they start together, only two periods are used, the
+    ALSA thread runs with SCHED_FIFO scheduling (if the process is allowed to do that),
+    and the latencies that are reported are measured from the running streams.
+*/
+#ifndef JUCE_ALSA_LOW_LATENCY
+ #define JUCE_ALSA_LOW_LATENCY 0
+#endif
+
 /** Config: JUCE_JACK
     Enables JACK audio devices (Linux only).
 */
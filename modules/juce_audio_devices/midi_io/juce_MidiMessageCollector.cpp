@@ -22,8 +22,49 @@
   ==============================================================================
 */
 
+namespace MidiCollectorHelpers
+{
+    enum { fifoSize = 32768 };
+
+    struct EventHeader
+    {
+        double timeStamp;
+        int numBytes;
+    };
+
+    // These copy to or from a logical position within the two blocks returned by the fifo.
+    static void writeToFifo (uint8* const fifoData, const int start1, const int size1, const int start2,
+                             const int offset, const void* const source, const int numBytes) noexcept
+    {
+        const int numInFirst = jlimit (0, numBytes, size1 - offset);
+
+        if (numInFirst > 0)
+            memcpy (fifoData + start1 + offset, source, (size_t) numInFirst);
+
+        if (numBytes > numInFirst)
+            memcpy (fifoData + start2 + jmax (0, offset - size1),
+                    static_cast<const uint8*> (source) + numInFirst, (size_t) (numBytes - numInFirst));
+    }
+
+    static void readFromFifo (const uint8* const fifoData, const int start1, const int size1, const int start2,
+                              const int offset, void* const dest, const int numBytes) noexcept
+    {
+        const int numInFirst = jlimit (0, numBytes, size1 - offset);
+
+        if (numInFirst > 0)
+            memcpy (dest, fifoData + start1 + offset, (size_t) numInFirst);
+
+        if (numBytes > numInFirst)
+            memcpy (static_cast<uint8*> (dest) + numInFirst,
+                    fifoData + start2 + jmax (0, offset - size1), (size_t) (numBytes - numInFirst));
+    }
+}
+
+//==============================================================================
 MidiMessageCollector::MidiMessageCollector()
     : lastCallbackTime (0),
+      fifo (MidiCollectorHelpers::fifoSize),
+      fifoData ((size_t) MidiCollectorHelpers::fifoSize),
       sampleRate (44100.0001)
 {
 }
@@ -37,14 +78,20 @@ void MidiMessageCollector::reset (const double sampleRate_)
 {
     jassert (sampleRate_ > 0);
 
-    const ScopedLock sl (midiCallbackLock);
+    const ScopedLock sl (writerLock);
     sampleRate = sampleRate_;
-    incomingMessages.clear();
+    fifo.reset();
+    pendingMessages.clear();
+    pendingMessages.ensureSize (4096);
+    laterMessages.clear();
+    laterMessages.ensureSize (4096);
     lastCallbackTime = Time::getMillisecondCounterHiRes();
 }
 
 void MidiMessageCollector::addMessageToQueue (const MidiMessage& message)
 {
+    using namespace MidiCollectorHelpers;
+
     // you need to call reset() to set the correct sample rate before using this object
     jassert (sampleRate != 44100.0001);
 
@@ -52,17 +99,61 @@ void MidiMessageCollector::addMessageToQueue (const MidiMessage& message)
     // for details of what the number should be.
     jassert (message.getTimeStamp() != 0);
 
-    const ScopedLock sl (midiCallbackLock);
+    EventHeader header;
+    header.timeStamp = message.getTimeStamp();
+    header.numBytes = message.getRawDataSize();
+
+    const int totalSize = (int) sizeof (header) + header.numBytes;
 
-    const int sampleNumber
-        = (int) ((message.getTimeStamp() - 0.001 * lastCallbackTime) * sampleRate);
+    // (this lock is only shared with other threads that are adding messages, never the reader)
+    const ScopedLock sl (writerLock);
 
-    incomingMessages.addEvent (message, sampleNumber);
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite (totalSize, start1, size1, start2, size2);
 
-    // if the messages don't get used for over a second, we'd better
-    // get rid of any old ones to avoid the queue getting too big
-    if (sampleNumber > sampleRate)
-        incomingMessages.clear (0, sampleNumber - (int) sampleRate);
+    if (size1 + size2 == totalSize)
+    {
+        writeToFifo (fifoData, start1, size1, start2, 0, &header, (int) sizeof (header));
+        writeToFifo (fifoData, start1, size1, start2, (int) sizeof (header), message.getRawData(), header.numBytes);
+        fifo.finishedWrite (totalSize);
+    }
+}
+
+void MidiMessageCollector::readIncomingMessages (const double blockStartTime)
+{
+    using namespace MidiCollectorHelpers;
+
+    int start1, size1, start2, size2;
+    fifo.prepareToRead (fifo.getNumReady(), start1, size1, start2, size2);
+
+    const int numReady = size1 + size2;
+    const int maxSamplesAhead = (int) sampleRate;
+    int offset = 0;
+
+    while (offset + (int) sizeof (EventHeader) <= numReady)
+    {
+        EventHeader header;
+        readFromFifo (fifoData, start1, size1, start2, offset, &header, (int) sizeof (header));
+        offset += (int) sizeof (header);
+
+        uint8 messageData [256];
+        HeapBlock<uint8> longMessageData;
+        uint8* data = messageData;
+
+        if (header.numBytes > (int) sizeof (messageData))
+        {
+            longMessageData.malloc ((size_t) header.numBytes);
+            data = longMessageData;
+        }
+
+        readFromFifo (fifoData, start1, size1, start2, offset, data, header.numBytes);
+        offset += header.numBytes;
+
+        const int samplePosition = roundToInt ((header.timeStamp * 1000.0 - blockStartTime) * 0.001 * sampleRate);
+        pendingMessages.addEvent (data, header.numBytes, jlimit (0, maxSamplesAhead, samplePosition));
+    }
+
+    fifo.finishedRead (offset);
 }
 
 void MidiMessageCollector::removeNextBlockOfMessages (MidiBuffer& destBuffer,
@@ -72,61 +163,41 @@ void MidiMessageCollector::removeNextBlockOfMessages (MidiBuffer& destBuffer,
     jassert (sampleRate != 44100.0001);
     jassert (numSamples > 0);
 
+    // The block that's being rendered now covers the interval between the previous callback
+    // and this one. Rather than using the raw time of each call (which can be very jittery),
+    // this follows an estimate of the callback clock, which advances by exactly one block each
+    // time and is nudged gently towards the measured time to stop it drifting.
     const double timeNow = Time::getMillisecondCounterHiRes();
-    const double msElapsed = timeNow - lastCallbackTime;
+    const double blockLengthMs = 1000.0 * numSamples / sampleRate;
+    double blockEndTime = lastCallbackTime + blockLengthMs;
+    const double clockError = timeNow - blockEndTime;
 
-    const ScopedLock sl (midiCallbackLock);
-    lastCallbackTime = timeNow;
+    if (std::abs (clockError) > jmax (20.0, 4.0 * blockLengthMs))
+        blockEndTime = timeNow; // we've lost track of the clock (e.g. after a pause), so start again
+    else
+        blockEndTime += clockError * 0.05;
 
-    if (! incomingMessages.isEmpty())
-    {
-        int numSourceSamples = jmax (1, roundToInt (msElapsed * 0.001 * sampleRate));
+    lastCallbackTime = blockEndTime;
 
-        int startSample = 0;
-        int scale = 1 << 16;
+    readIncomingMessages (blockEndTime - blockLengthMs);
 
+    if (! pendingMessages.isEmpty())
+    {
         const uint8* midiData;
         int numBytes, samplePosition;
 
-        MidiBuffer::Iterator iter (incomingMessages);
+        MidiBuffer::Iterator iter (pendingMessages);
 
-        if (numSourceSamples > numSamples)
-        {
-            // if our list of events is longer than the buffer we're being
-            // asked for, scale them down to squeeze them all in..
-            const int maxBlockLengthToUse = numSamples << 5;
-
-            if (numSourceSamples > maxBlockLengthToUse)
-            {
-                startSample = numSourceSamples - maxBlockLengthToUse;
-                numSourceSamples = maxBlockLengthToUse;
-                iter.setNextSamplePosition (startSample);
-            }
-
-            scale = (numSamples << 10) / numSourceSamples;
-
-            while (iter.getNextEvent (midiData, numBytes, samplePosition))
-            {
-                samplePosition = ((samplePosition - startSample) * scale) >> 10;
-
-                destBuffer.addEvent (midiData, numBytes,
-                                     jlimit (0, numSamples - 1, samplePosition));
-            }
-        }
-        else
+        while (iter.getNextEvent (midiData, numBytes, samplePosition))
         {
-            // if our event list is shorter than the number we need, put them
-            // towards the end of the buffer
-            startSample = numSamples - numSourceSamples;
-
-            while (iter.getNextEvent (midiData, numBytes, samplePosition))
-            {
-                destBuffer.addEvent (midiData, numBytes,
-                                     jlimit (0, numSamples - 1, samplePosition + startSample));
-            }
+            if (samplePosition < numSamples)
+                destBuffer.addEvent (midiData, numBytes, samplePosition);
+            else
+                laterMessages.addEvent (midiData, numBytes, samplePosition - numSamples);
         }
 
-        incomingMessages.clear();
+        pendingMessages.swapWith (laterMessages);
+        laterMessages.clear();
     }
 }
 
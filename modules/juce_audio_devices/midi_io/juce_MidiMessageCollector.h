@@ -36,6 +36,12 @@
     The class can also be used as either a MidiKeyboardStateListener or a MidiInputCallback
     so it can easily use a midi input or keyboard component as its source.
 
+    Incoming messages are passed to the audio thread through a lock-free FIFO, so a
+    thread that's adding messages can never block the audio callback. Their timestamps
+    are converted to sample positions using a clock that follows the timing of the calls
+    to removeNextBlockOfMessages(), so with a steady audio callback, each message is
+    delivered exactly one block after it arrived.
+
     @see MidiMessage, MidiInput
 */
 class JUCE_API  MidiMessageCollector    : public MidiKeyboardStateListener,
@@ -63,21 +69,25 @@ public:
         of the block returned by the next call to removeNextBlockOfMessages().
 
         This method is fully thread-safe when overlapping calls are made with
-        removeNextBlockOfMessages().
+        removeNextBlockOfMessages(), and may be called from more than one thread. If
+        the queue is full because nothing is removing the messages, the message is
+        discarded.
     */
     void addMessageToQueue (const MidiMessage& message);
 
     /** Removes all the pending messages from the queue as a buffer.
 
-        This will also correct the messages' timestamps to make sure they're in
-        the range 0 to numSamples - 1.
+        Each message is positioned in the block according to the time at which it
+        arrived, relative to the time of the previous call, so the positions will be in
+        the range 0 to numSamples - 1. Any messages that are timestamped later than the
+        end of this block are kept back for the next one.
 
         This call should be made regularly by something like an audio processing
         callback, because the time that it happens is used in calculating the
         midi event positions.
 
         This method is fully thread-safe when overlapping calls are made with
-        addMessageToQueue().
+        addMessageToQueue(), and it never blocks. Only one thread may call it.
 
         Precondition: numSamples must be greater than 0.
     */
@@ -95,10 +105,14 @@ public:
 private:
     //==============================================================================
     double lastCallbackTime;
-    CriticalSection midiCallbackLock;
-    MidiBuffer incomingMessages;
+    CriticalSection writerLock;
+    AbstractFifo fifo;
+    HeapBlock<uint8> fifoData;
+    MidiBuffer pendingMessages, laterMessages;
     double sampleRate;
 
+    void readIncomingMessages (double blockStartTime);
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MidiMessageCollector)
 };
 
@@ -30,8 +30,28 @@ bool isOpenSLAvailable()
     return library.open ("libOpenSLES.so");
 }
 
-const unsigned short openSLRates[]       = { 8000, 16000, 32000, 44100, 48000 };
-const unsigned short openSLBufferSizes[] = { 256, 512, 768, 1024, 1280, 1600 }; // must all be multiples of the block size
+const unsigned short openSLRates[] = { 8000, 16000, 32000, 44100, 48000 };
+
+//==============================================================================
+// Android only gives a stream the fast mixer path if it runs at the device's native rate, and
+// its buffers are a multiple of the native burst size, so these ask the AudioManager for them.
+// (Before API level 17, the properties aren't available, and these return 0)
+static String audioManagerGetProperty (const String& property)
+{
+    const LocalRef<jstring> jProperty (javaString (property));
+    const LocalRef<jstring> text ((jstring) android.activity.callObjectMethod (JuceAppActivity.audioManagerGetProperty,
+                                                                               jProperty.get()));
+    return text.get() != 0 ? juceString (text) : String::empty;
+}
+
+static int getNativeSampleRate()    { return audioManagerGetProperty ("android.media.property.OUTPUT_SAMPLE_RATE").getIntValue(); }
+static int getNativeBufferSize()    { return audioManagerGetProperty ("android.media.property.OUTPUT_FRAMES_PER_BUFFER").getIntValue(); }
+
+static bool hasLowLatencyAudioFeature()
+{
+    const LocalRef<jstring> feature (javaString ("android.hardware.audio.low_latency"));
+    return android.activity.callBooleanMethod (JuceAppActivity.hasSystemFeature, feature.get()) != 0;
+}
 
 //==============================================================================
 class OpenSLAudioIODevice  : public AudioIODevice,
@@ -41,22 +61,51 @@ public:
     OpenSLAudioIODevice (const String& deviceName)
         : AudioIODevice (deviceName, openSLTypeName),
           Thread ("OpenSL"),
-          callback (nullptr), sampleRate (0), deviceOpen (false),
+          callback (nullptr), actualBufferSize (0), sampleRate (0), numBuffers (0), deviceOpen (false),
           inputBuffer (2, 2), outputBuffer (2, 2)
     {
-        // OpenSL has piss-poor support for determining latency, so the only way I can find to
-        // get a number for this is by asking the AudioTrack/AudioRecord classes..
-        AndroidAudioIODevice javaDevice (String::empty);
-
-        // this is a total guess about how to calculate the latency, but seems to vaguely agree
-        // with the devices I've tested.. YMMV
-        inputLatency  = ((javaDevice.minBufferSizeIn  * 2) / 3);
-        outputLatency = ((javaDevice.minBufferSizeOut * 2) / 3);
-
-        const int longestLatency = jmax (inputLatency, outputLatency);
-        const int totalLatency = inputLatency + outputLatency;
-        inputLatency  = ((longestLatency * inputLatency)  / totalLatency) & ~15;
-        outputLatency = ((longestLatency * outputLatency) / totalLatency) & ~15;
+        const int nativeSampleRate = getNativeSampleRate();
+        nativeBufferSize = getNativeBufferSize();
+        isLowLatency = hasLowLatencyAudioFeature();
+
+        if (nativeSampleRate > 0)
+        {
+            // (any other rate would be resampled by the mixer, which would take it off the fast path)
+            sampleRates.add (nativeSampleRate);
+        }
+        else
+        {
+            for (int i = 0; i < numElementsInArray (openSLRates); ++i)
+                sampleRates.add (openSLRates[i]);
+        }
+
+        if (nativeBufferSize <= 0)
+            nativeBufferSize = 256;
+
+        for (int i = 1; i <= 8; ++i)
+            bufferSizes.add (nativeBufferSize * i);
+
+        if (isLowLatency)
+        {
+            // On the fast path, the mixer only adds a single burst to what we queue up
+            inputLatency = outputLatency = nativeBufferSize;
+        }
+        else
+        {
+            // OpenSL has piss-poor support for determining latency, so the only way I can find to
+            // get a number for this is by asking the AudioTrack/AudioRecord classes..
+            AndroidAudioIODevice javaDevice (String::empty);
+
+            // this is a total guess about how to calculate the latency, but seems to vaguely agree
+            // with the devices I've tested.. YMMV
+            inputLatency  = ((javaDevice.minBufferSizeIn  * 2) / 3);
+            outputLatency = ((javaDevice.minBufferSizeOut * 2) / 3);
+
+            const int longestLatency = jmax (inputLatency, outputLatency);
+            const int totalLatency = inputLatency + outputLatency;
+            inputLatency  = ((longestLatency * inputLatency)  / totalLatency) & ~15;
+            outputLatency = ((longestLatency * outputLatency) / totalLatency) & ~15;
+        }
     }
 
     ~OpenSLAudioIODevice()
@@ -81,21 +130,22 @@ public:
         return s;
     }
 
-    int getNumSampleRates()                 { return numElementsInArray (openSLRates); }
+    int getNumSampleRates()                 { return sampleRates.size(); }
 
     double getSampleRate (int index)
     {
         jassert (index >= 0 && index < getNumSampleRates());
-        return (int) openSLRates [index];
+        return sampleRates [index];
     }
 
-    int getDefaultBufferSize()              { return 1024; }
-    int getNumBufferSizesAvailable()        { return numElementsInArray (openSLBufferSizes); }
+    // (without the low-latency feature, the normal mixer wakes up too rarely for a single burst to be safe)
+    int getDefaultBufferSize()              { return nativeBufferSize * (isLowLatency ? 1 : 4); }
+    int getNumBufferSizesAvailable()        { return bufferSizes.size(); }
 
     int getBufferSizeSamples (int index)
     {
         jassert (index >= 0 && index < getNumBufferSizesAvailable());
-        return (int) openSLBufferSizes [index];
+        return bufferSizes [index];
     }
 
     String open (const BigInteger& inputChannels,
@@ -118,14 +168,19 @@ public:
         activeInputChans.setRange (1, activeInputChans.getHighestBit(), false);
         numInputChannels = activeInputChans.countNumberOfSetBits();
 
-        actualBufferSize = preferredBufferSize;
+        // (the buffers must be a multiple of the burst size to stay on the fast path)
+        actualBufferSize = jmax (1, (preferredBufferSize + nativeBufferSize / 2) / nativeBufferSize) * nativeBufferSize;
+
+        // Two buffers is the fewest that the queues can run with: one being played or recorded,
+        // and one being filled or emptied by our thread
+        numBuffers = isLowLatency ? 2 : 4;
 
         inputBuffer.setSize  (jmax (1, numInputChannels),  actualBufferSize);
         outputBuffer.setSize (jmax (1, numOutputChannels), actualBufferSize);
         outputBuffer.clear();
 
-        recorder = engine.createRecorder (numInputChannels,  sampleRate);
-        player   = engine.createPlayer   (numOutputChannels, sampleRate);
+        recorder = engine.createRecorder (numInputChannels,  sampleRate, actualBufferSize, numBuffers);
+        player   = engine.createPlayer   (numOutputChannels, sampleRate, actualBufferSize, numBuffers);
 
         startThread (8);
 
@@ -142,11 +197,17 @@ public:
         player = nullptr;
     }
 
-    int getOutputLatencyInSamples()                     { return outputLatency; }
-    int getInputLatencyInSamples()                      { return inputLatency; }
+    int getOutputLatencyInSamples()                     { return outputLatency + numBuffers * actualBufferSize; }
+    int getInputLatencyInSamples()                      { return inputLatency + actualBufferSize; }
     bool isOpen()                                       { return deviceOpen; }
     int getCurrentBufferSizeSamples()                   { return actualBufferSize; }
-    int getCurrentBitDepth()                            { return 16; }
+
+    int getCurrentBitDepth()
+    {
+        return (player != nullptr ? player->bufferList.bytesPerSample
+                                  : (recorder != nullptr ? recorder->bufferList.bytesPerSample : 2)) * 8;
+    }
+
     double getCurrentSampleRate()                       { return sampleRate; }
     BigInteger getActiveOutputChannels() const          { return activeOutputChans; }
     BigInteger getActiveInputChannels() const           { return activeInputChans; }
@@ -174,6 +235,8 @@ public:
 
     void run()
     {
+        setThreadToAudioPriority();
+
         if (recorder != nullptr)    recorder->start();
         if (player != nullptr)      player->start();
 
@@ -203,9 +266,12 @@ private:
     //==================================================================================================
     CriticalSection callbackLock;
     AudioIODeviceCallback* callback;
-    int actualBufferSize, sampleRate;
+    int actualBufferSize, sampleRate, numBuffers;
     int inputLatency, outputLatency;
-    bool deviceOpen;
+    int nativeBufferSize;
+    bool isLowLatency, deviceOpen;
+    Array<double> sampleRates;
+    Array<int> bufferSizes;
     String lastError;
     BigInteger activeOutputChans, activeInputChans;
     int numInputChannels, numOutputChannels;
@@ -221,6 +287,17 @@ private:
         return oldCallback;
     }
 
+    // Tries to make this a real-time thread, and if the app isn't allowed to do that, gives
+    // it the same priority that Android uses for its own audio threads.
+    static void setThreadToAudioPriority()
+    {
+        sched_param param;
+        param.sched_priority = sched_get_priority_min (SCHED_FIFO);
+
+        if (pthread_setschedparam (pthread_self(), SCHED_FIFO, &param) != 0)
+            setpriority (PRIO_PROCESS, (id_t) gettid(), -19 /* ANDROID_PRIORITY_URGENT_AUDIO */);
+    }
+
     //==================================================================================================
     struct Engine
     {
@@ -255,21 +332,21 @@ private:
             if (engineObject != nullptr)    (*engineObject)->Destroy (engineObject);
         }
 
-        Player* createPlayer (const int numChannels, const int sampleRate)
+        Player* createPlayer (const int numChannels, const int sampleRate, const int numSamples, const int numBuffers)
         {
             if (numChannels <= 0)
                 return nullptr;
 
-            ScopedPointer<Player> player (new Player (numChannels, sampleRate, *this));
+            ScopedPointer<Player> player (new Player (numChannels, sampleRate, numSamples, numBuffers, *this));
             return player->openedOk() ? player.release() : nullptr;
         }
 
-        Recorder* createRecorder (const int numChannels, const int sampleRate)
+        Recorder* createRecorder (const int numChannels, const int sampleRate, const int numSamples, const int numBuffers)
         {
             if (numChannels <= 0)
                 return nullptr;
 
-            ScopedPointer<Recorder> recorder (new Recorder (numChannels, sampleRate, *this));
+            ScopedPointer<Recorder> recorder (new Recorder (numChannels, sampleRate, numSamples, numBuffers, *this));
             return recorder->openedOk() ? recorder.release() : nullptr;
         }
 
@@ -288,14 +365,20 @@ private:
     };
 
     //==================================================================================================
+    // Holds the blocks that are passed to a buffer queue. Each block is laid out the way the
+    // queue wants it: interleaved, and either 16-bit integers or floats.
     struct BufferList
     {
-        BufferList (const int numChannels_)
-            : numChannels (numChannels_), bufferSpace (numChannels_ * numSamples * numBuffers), nextBlock (0)
+        BufferList (const int numChannels_, const int numSamples_, const int numBuffers_)
+            : numChannels (numChannels_), numSamples (numSamples_), numBuffers (numBuffers_),
+              bytesPerSample (sizeof (int16)),
+              bufferSpace ((size_t) (numChannels_ * numSamples_ * numBuffers_) * sizeof (float)),
+              interleaved ((size_t) (numChannels_ * numSamples_)),
+              nextBlock (0)
         {
         }
 
-        int16* waitForFreeBuffer (Thread& threadToCheck)
+        char* waitForFreeBuffer (Thread& threadToCheck)
         {
             while (numBlocksOut.get() == numBuffers)
             {
@@ -308,66 +391,141 @@ private:
             return getNextBuffer();
         }
 
-        int16* getNextBuffer()
+        char* getNextBuffer()
         {
             if (++nextBlock == numBuffers)
                 nextBlock = 0;
 
-            return bufferSpace + nextBlock * numChannels * numSamples;
+            return bufferSpace + nextBlock * getBufferSizeBytes();
         }
 
         void bufferReturned()           { --numBlocksOut; dataArrived.signal(); }
         void bufferSent()               { ++numBlocksOut; dataArrived.signal(); }
 
-        int getBufferSizeBytes() const  { return numChannels * numSamples * sizeof (int16); }
+        int getBufferSizeBytes() const  { return numChannels * numSamples * bytesPerSample; }
+        bool isFloat() const noexcept   { return bytesPerSample == sizeof (float); }
+
+        void writeBlock (char* dest, const AudioSampleBuffer& source, const int startSample)
+        {
+            float* const dst = isFloat() ? reinterpret_cast<float*> (dest) : interleaved.getData();
 
-        const int numChannels;
-        enum { numSamples = 256, numBuffers = 16 };
+            if (numChannels == 1)
+                FloatVectorOperations::copy (dst, source.getSampleData (0, startSample), numSamples);
+            else
+                FloatVectorOperations::interleave (dst, getChannelPointers (source, startSample), numChannels, numSamples);
+
+            if (! isFloat())
+                FloatVectorOperations::convertFloatToInt16 (reinterpret_cast<int16*> (dest), dst, 32767.0f, numChannels * numSamples);
+        }
+
+        void readBlock (AudioSampleBuffer& dest, const int startSample, const char* source)
+        {
+            const float* src = reinterpret_cast<const float*> (source);
+
+            if (! isFloat())
+            {
+                FloatVectorOperations::convertInt16ToFloat (interleaved, reinterpret_cast<const int16*> (source),
+                                                            1.0f / 32768.0f, numChannels * numSamples);
+                src = interleaved;
+            }
+
+            if (numChannels == 1)
+                FloatVectorOperations::copy (dest.getSampleData (0, startSample), src, numSamples);
+            else
+                FloatVectorOperations::deinterleave (getChannelPointers (dest, startSample), src, numChannels, numSamples);
+        }
+
+        const int numChannels, numSamples, numBuffers;
+        int bytesPerSample;
 
     private:
-        HeapBlock<int16> bufferSpace;
+        HeapBlock<char> bufferSpace;
+        HeapBlock<float> interleaved;
+        float* channels [2];
         int nextBlock;
         Atomic<int> numBlocksOut;
         WaitableEvent dataArrived;
+
+        float* const* getChannelPointers (const AudioSampleBuffer& buffer, const int startSample) noexcept
+        {
+            jassert (numChannels <= numElementsInArray (channels));
+
+            for (int i = 0; i < numChannels; ++i)
+                channels[i] = buffer.getSampleData (i, startSample);
+
+            return channels;
+        }
     };
 
+    //==================================================================================================
+    // Where the system supports it (from Android 5.0), the queues carry floats, which saves
+    // converting them, and lets the mixer take them at full resolution. Otherwise they fall
+    // back to 16-bit.
+   #ifdef SL_ANDROID_DATAFORMAT_PCM_EX
+    static SLAndroidDataFormat_PCM_EX createFloatFormat (int numChannels, int sampleRate, SLuint32 channelMask) noexcept
+    {
+        SLAndroidDataFormat_PCM_EX format =
+        {
+            SL_ANDROID_DATAFORMAT_PCM_EX,
+            (SLuint32) numChannels,
+            (SLuint32) sampleRate * 1000, // (sample rate units are millihertz)
+            SL_PCMSAMPLEFORMAT_FIXED_32,
+            SL_PCMSAMPLEFORMAT_FIXED_32,
+            channelMask,
+            SL_BYTEORDER_LITTLEENDIAN,
+            SL_ANDROID_PCM_REPRESENTATION_FLOAT
+        };
+
+        return format;
+    }
+   #endif
+
+    static SLDataFormat_PCM createInt16Format (int numChannels, int sampleRate, SLuint32 channelMask) noexcept
+    {
+        SLDataFormat_PCM format =
+        {
+            SL_DATAFORMAT_PCM,
+            (SLuint32) numChannels,
+            (SLuint32) sampleRate * 1000, // (sample rate units are millihertz)
+            SL_PCMSAMPLEFORMAT_FIXED_16,
+            SL_PCMSAMPLEFORMAT_FIXED_16,
+            channelMask,
+            SL_BYTEORDER_LITTLEENDIAN
+        };
+
+        return format;
+    }
+
     //==================================================================================================
     struct Player
     {
-        Player (int numChannels, int sampleRate, Engine& engine)
-            : playerObject (nullptr), playerPlay (nullptr), playerBufferQueue (nullptr),
-              bufferList (numChannels)
+        Player (int numChannels, int sampleRate, int numSamples, int numBuffers, Engine& engine)
+            : bufferList (numChannels, numSamples, numBuffers),
+              playerObject (nullptr), playerPlay (nullptr), playerBufferQueue (nullptr)
         {
             jassert (numChannels == 2);
 
-            SLDataFormat_PCM pcmFormat =
-            {
-                SL_DATAFORMAT_PCM,
-                numChannels,
-                sampleRate * 1000, // (sample rate units are millihertz)
-                SL_PCMSAMPLEFORMAT_FIXED_16,
-                SL_PCMSAMPLEFORMAT_FIXED_16,
-                SL_SPEAKER_FRONT_LEFT | SL_SPEAKER_FRONT_RIGHT,
-                SL_BYTEORDER_LITTLEENDIAN
-            };
-
-            SLDataLocator_AndroidSimpleBufferQueue bufferQueue = { SL_DATALOCATOR_ANDROIDSIMPLEBUFFERQUEUE, bufferList.numBuffers };
-            SLDataSource audioSrc = { &bufferQueue, &pcmFormat };
+            const SLuint32 channelMask = SL_SPEAKER_FRONT_LEFT | SL_SPEAKER_FRONT_RIGHT;
 
-            SLDataLocator_OutputMix outputMix = { SL_DATALOCATOR_OUTPUTMIX, engine.outputMixObject };
-            SLDataSink audioSink = { &outputMix, nullptr };
+           #ifdef SL_ANDROID_DATAFORMAT_PCM_EX
+            SLAndroidDataFormat_PCM_EX floatFormat (createFloatFormat (numChannels, sampleRate, channelMask));
 
-            // (SL_IID_BUFFERQUEUE is not guaranteed to remain future-proof, so use SL_IID_ANDROIDSIMPLEBUFFERQUEUE)
-            const SLInterfaceID interfaceIDs[] = { *engine.SL_IID_ANDROIDSIMPLEBUFFERQUEUE };
-            const SLboolean flags[] = { SL_BOOLEAN_TRUE };
+            if (create (engine, &floatFormat))
+                bufferList.bytesPerSample = sizeof (float);
+           #endif
 
-            check ((*engine.engineInterface)->CreateAudioPlayer (engine.engineInterface, &playerObject, &audioSrc, &audioSink,
-                                                                 1, interfaceIDs, flags));
+            if (playerObject == nullptr)
+            {
+                SLDataFormat_PCM pcmFormat (createInt16Format (numChannels, sampleRate, channelMask));
+                check (create (engine, &pcmFormat));
+            }
 
-            check ((*playerObject)->Realize (playerObject, SL_BOOLEAN_FALSE));
-            check ((*playerObject)->GetInterface (playerObject, *engine.SL_IID_PLAY, &playerPlay));
-            check ((*playerObject)->GetInterface (playerObject, *engine.SL_IID_ANDROIDSIMPLEBUFFERQUEUE, &playerBufferQueue));
-            check ((*playerBufferQueue)->RegisterCallback (playerBufferQueue, staticCallback, this));
+            if (playerObject != nullptr)
+            {
+                check ((*playerObject)->GetInterface (playerObject, *engine.SL_IID_PLAY, &playerPlay));
+                check ((*playerObject)->GetInterface (playerObject, *engine.SL_IID_ANDROIDSIMPLEBUFFERQUEUE, &playerBufferQueue));
+                check ((*playerBufferQueue)->RegisterCallback (playerBufferQueue, staticCallback, this));
+            }
         }
 
         ~Player()
@@ -393,42 +551,57 @@ private:
         void writeBuffer (const AudioSampleBuffer& buffer, Thread& thread)
         {
             jassert (buffer.getNumChannels() == bufferList.numChannels);
-            jassert (buffer.getNumSamples() < bufferList.numSamples * bufferList.numBuffers);
-
-            int offset = 0;
-            int numSamples = buffer.getNumSamples();
+            jassert ((buffer.getNumSamples() % bufferList.numSamples) == 0);
 
-            while (numSamples > 0)
+            for (int offset = 0; offset < buffer.getNumSamples(); offset += bufferList.numSamples)
             {
-                int16* const destBuffer = bufferList.waitForFreeBuffer (thread);
+                char* const destBuffer = bufferList.waitForFreeBuffer (thread);
 
                 if (destBuffer == nullptr)
                     break;
 
-                for (int i = 0; i < bufferList.numChannels; ++i)
-                {
-                    typedef AudioData::Pointer <AudioData::Int16,   AudioData::LittleEndian, AudioData::Interleaved, AudioData::NonConst> DstSampleType;
-                    typedef AudioData::Pointer <AudioData::Float32, AudioData::NativeEndian, AudioData::NonInterleaved, AudioData::Const> SrcSampleType;
-
-                    DstSampleType dstData (destBuffer + i, bufferList.numChannels);
-                    SrcSampleType srcData (buffer.getSampleData (i, offset));
-                    dstData.convertSamples (srcData, bufferList.numSamples);
-                }
+                bufferList.writeBlock (destBuffer, buffer, offset);
 
-                check ((*playerBufferQueue)->Enqueue (playerBufferQueue, destBuffer, bufferList.getBufferSizeBytes()));
+                check ((*playerBufferQueue)->Enqueue (playerBufferQueue, destBuffer, (SLuint32) bufferList.getBufferSizeBytes()));
                 bufferList.bufferSent();
-
-                numSamples -= bufferList.numSamples;
-                offset += bufferList.numSamples;
             }
         }
 
+        BufferList bufferList;
+
     private:
         SLObjectItf playerObject;
         SLPlayItf playerPlay;
         SLAndroidSimpleBufferQueueItf playerBufferQueue;
 
-        BufferList bufferList;
+        bool create (Engine& engine, void* format)
+        {
+            SLDataLocator_AndroidSimpleBufferQueue bufferQueue = { SL_DATALOCATOR_ANDROIDSIMPLEBUFFERQUEUE, (SLuint32) bufferList.numBuffers };
+            SLDataSource audioSrc = { &bufferQueue, format };
+
+            SLDataLocator_OutputMix outputMix = { SL_DATALOCATOR_OUTPUTMIX, engine.outputMixObject };
+            SLDataSink audioSink = { &outputMix, nullptr };
+
+            // (SL_IID_BUFFERQUEUE is not guaranteed to remain future-proof, so use SL_IID_ANDROIDSIMPLEBUFFERQUEUE)
+            const SLInterfaceID interfaceIDs[] = { *engine.SL_IID_ANDROIDSIMPLEBUFFERQUEUE };
+            const SLboolean flags[] = { SL_BOOLEAN_TRUE };
+
+            if ((*engine.engineInterface)->CreateAudioPlayer (engine.engineInterface, &playerObject, &audioSrc, &audioSink,
+                                                              1, interfaceIDs, flags) != SL_RESULT_SUCCESS)
+            {
+                playerObject = nullptr;
+                return false;
+            }
+
+            if ((*playerObject)->Realize (playerObject, SL_BOOLEAN_FALSE) != SL_RESULT_SUCCESS)
+            {
+                (*playerObject)->Destroy (playerObject);
+                playerObject = nullptr;
+                return false;
+            }
+
+            return true;
+        }
 
         static void staticCallback (SLAndroidSimpleBufferQueueItf queue, void* context)
         {
@@ -442,48 +615,39 @@ private:
     //==================================================================================================
     struct Recorder
     {
-        Recorder (int numChannels, int sampleRate, Engine& engine)
-            : recorderObject (nullptr), recorderRecord (nullptr), recorderBufferQueue (nullptr),
-              bufferList (numChannels)
+        Recorder (int numChannels, int sampleRate, int numSamples, int numBuffers, Engine& engine)
+            : bufferList (numChannels, numSamples, numBuffers),
+              recorderObject (nullptr), recorderRecord (nullptr), recorderBufferQueue (nullptr)
         {
             jassert (numChannels == 1); // STEREO doesn't always work!!
 
-            SLDataFormat_PCM pcmFormat =
-            {
-                SL_DATAFORMAT_PCM,
-                numChannels,
-                sampleRate * 1000, // (sample rate units are millihertz)
-                SL_PCMSAMPLEFORMAT_FIXED_16,
-                SL_PCMSAMPLEFORMAT_FIXED_16,
-                (numChannels == 1) ? SL_SPEAKER_FRONT_CENTER : (SL_SPEAKER_FRONT_LEFT | SL_SPEAKER_FRONT_RIGHT),
-                SL_BYTEORDER_LITTLEENDIAN
-            };
+            const SLuint32 channelMask = (numChannels == 1) ? SL_SPEAKER_FRONT_CENTER : (SL_SPEAKER_FRONT_LEFT | SL_SPEAKER_FRONT_RIGHT);
 
-            SLDataLocator_IODevice ioDevice = { SL_DATALOCATOR_IODEVICE, SL_IODEVICE_AUDIOINPUT, SL_DEFAULTDEVICEID_AUDIOINPUT, nullptr };
-            SLDataSource audioSrc = { &ioDevice, nullptr };
+           #ifdef SL_ANDROID_DATAFORMAT_PCM_EX
+            SLAndroidDataFormat_PCM_EX floatFormat (createFloatFormat (numChannels, sampleRate, channelMask));
 
-            SLDataLocator_AndroidSimpleBufferQueue bufferQueue = { SL_DATALOCATOR_ANDROIDSIMPLEBUFFERQUEUE, bufferList.numBuffers };
-            SLDataSink audioSink = { &bufferQueue, &pcmFormat };
+            if (create (engine, &floatFormat))
+                bufferList.bytesPerSample = sizeof (float);
+           #endif
 
-            const SLInterfaceID interfaceIDs[] = { *engine.SL_IID_ANDROIDSIMPLEBUFFERQUEUE };
-            const SLboolean flags[] = { SL_BOOLEAN_TRUE };
+            if (recorderObject == nullptr)
+            {
+                SLDataFormat_PCM pcmFormat (createInt16Format (numChannels, sampleRate, channelMask));
+                check (create (engine, &pcmFormat));
+            }
 
-            if (check ((*engine.engineInterface)->CreateAudioRecorder (engine.engineInterface, &recorderObject, &audioSrc,
-                                                                       &audioSink, 1, interfaceIDs, flags)))
+            if (recorderObject != nullptr)
             {
-                if (check ((*recorderObject)->Realize (recorderObject, SL_BOOLEAN_FALSE)))
+                check ((*recorderObject)->GetInterface (recorderObject, *engine.SL_IID_RECORD, &recorderRecord));
+                check ((*recorderObject)->GetInterface (recorderObject, *engine.SL_IID_ANDROIDSIMPLEBUFFERQUEUE, &recorderBufferQueue));
+                check ((*recorderBufferQueue)->RegisterCallback (recorderBufferQueue, staticCallback, this));
+                check ((*recorderRecord)->SetRecordState (recorderRecord, SL_RECORDSTATE_STOPPED));
+
+                for (int i = bufferList.numBuffers; --i >= 0;)
                 {
-                    check ((*recorderObject)->GetInterface (recorderObject, *engine.SL_IID_RECORD, &recorderRecord));
-                    check ((*recorderObject)->GetInterface (recorderObject, *engine.SL_IID_ANDROIDSIMPLEBUFFERQUEUE, &recorderBufferQueue));
-                    check ((*recorderBufferQueue)->RegisterCallback (recorderBufferQueue, staticCallback, this));
-                    check ((*recorderRecord)->SetRecordState (recorderRecord, SL_RECORDSTATE_STOPPED));
-
-                    for (int i = bufferList.numBuffers; --i >= 0;)
-                    {
-                        int16* const buffer = bufferList.getNextBuffer();
-                        jassert (buffer != nullptr);
-                        enqueueBuffer (buffer);
-                    }
+                    char* const buffer = bufferList.getNextBuffer();
+                    jassert (buffer != nullptr);
+                    enqueueBuffer (buffer);
                 }
             }
         }
@@ -511,46 +675,58 @@ private:
         void readNextBlock (AudioSampleBuffer& buffer, Thread& thread)
         {
             jassert (buffer.getNumChannels() == bufferList.numChannels);
-            jassert (buffer.getNumSamples() < bufferList.numSamples * bufferList.numBuffers);
             jassert ((buffer.getNumSamples() % bufferList.numSamples) == 0);
 
-            int offset = 0;
-            int numSamples = buffer.getNumSamples();
-
-            while (numSamples > 0)
+            for (int offset = 0; offset < buffer.getNumSamples(); offset += bufferList.numSamples)
             {
-                int16* const srcBuffer = bufferList.waitForFreeBuffer (thread);
+                char* const srcBuffer = bufferList.waitForFreeBuffer (thread);
 
                 if (srcBuffer == nullptr)
                     break;
 
-                for (int i = 0; i < bufferList.numChannels; ++i)
-                {
-                    typedef AudioData::Pointer <AudioData::Float32, AudioData::NativeEndian, AudioData::NonInterleaved, AudioData::NonConst> DstSampleType;
-                    typedef AudioData::Pointer <AudioData::Int16,   AudioData::LittleEndian, AudioData::Interleaved, AudioData::Const> SrcSampleType;
-
-                    DstSampleType dstData (buffer.getSampleData (i, offset));
-                    SrcSampleType srcData (srcBuffer + i, bufferList.numChannels);
-                    dstData.convertSamples (srcData, bufferList.numSamples);
-                }
-
+                bufferList.readBlock (buffer, offset, srcBuffer);
                 enqueueBuffer (srcBuffer);
-
-                numSamples -= bufferList.numSamples;
-                offset += bufferList.numSamples;
             }
         }
 
+        BufferList bufferList;
+
     private:
         SLObjectItf recorderObject;
         SLRecordItf recorderRecord;
         SLAndroidSimpleBufferQueueItf recorderBufferQueue;
 
-        BufferList bufferList;
+        bool create (Engine& engine, void* format)
+        {
+            SLDataLocator_IODevice ioDevice = { SL_DATALOCATOR_IODEVICE, SL_IODEVICE_AUDIOINPUT, SL_DEFAULTDEVICEID_AUDIOINPUT, nullptr };
+            SLDataSource audioSrc = { &ioDevice, nullptr };
+
+            SLDataLocator_AndroidSimpleBufferQueue bufferQueue = { SL_DATALOCATOR_ANDROIDSIMPLEBUFFERQUEUE, (SLuint32) bufferList.numBuffers };
+            SLDataSink audioSink = { &bufferQueue, format };
+
+            const SLInterfaceID interfaceIDs[] = { *engine.SL_IID_ANDROIDSIMPLEBUFFERQUEUE };
+            const SLboolean flags[] = { SL_BOOLEAN_TRUE };
+
+            if ((*engine.engineInterface)->CreateAudioRecorder (engine.engineInterface, &recorderObject, &audioSrc,
+                                                                &audioSink, 1, interfaceIDs, flags) != SL_RESULT_SUCCESS)
+            {
+                recorderObject = nullptr;
+                return false;
+            }
+
+            if ((*recorderObject)->Realize (recorderObject, SL_BOOLEAN_FALSE) != SL_RESULT_SUCCESS)
+            {
+                (*recorderObject)->Destroy (recorderObject);
+                recorderObject = nullptr;
+                return false;
+            }
+
+            return true;
+        }
 
-        void enqueueBuffer (int16* buffer)
+        void enqueueBuffer (char* buffer)
         {
-            check ((*recorderBufferQueue)->Enqueue (recorderBufferQueue, buffer, bufferList.getBufferSizeBytes()));
+            check ((*recorderBufferQueue)->Enqueue (recorderBufferQueue, buffer, (SLuint32) bufferList.getBufferSizeBytes()));
             bufferList.bufferSent();
         }
 
@@ -147,7 +147,9 @@ public:
           latency (0),
           deviceID (devID),
           isInput (forInput),
-          isInterleaved (true)
+          isInterleaved (true),
+          isMmap (false),
+          numXRuns (0)
     {
         JUCE_ALSA_LOG ("snd_pcm_open (" << deviceID.toUTF8().getAddress() << ", forInput=" << forInput << ")");
 
@@ -201,6 +203,16 @@ public:
             return false;
         }
 
+        isMmap = false;
+
+       #if JUCE_ALSA_LOW_LATENCY
+        if (snd_pcm_hw_params_set_access (handle, hwParams, SND_PCM_ACCESS_MMAP_INTERLEAVED) >= 0)
+        {
+            isInterleaved = true;
+            isMmap = true;
+        }
+        else
+       #endif
         if (snd_pcm_hw_params_set_access (handle, hwParams, SND_PCM_ACCESS_RW_INTERLEAVED) >= 0) // works better for plughw..
             isInterleaved = true;
         else if (snd_pcm_hw_params_set_access (handle, hwParams, SND_PCM_ACCESS_RW_NONINTERLEAVED) >= 0)
@@ -247,7 +259,11 @@ public:
         }
 
         int dir = 0;
+       #if JUCE_ALSA_LOW_LATENCY
+        unsigned int periods = 2;
+       #else
         unsigned int periods = 4;
+       #endif
         snd_pcm_uframes_t samplesPerPeriod = bufferSize;
 
         if (JUCE_ALSA_FAILED (snd_pcm_hw_params_set_rate_near (handle, hwParams, &sampleRate, 0))
@@ -268,18 +284,29 @@ public:
             latency = frames * (periods - 1); // (this is the method JACK uses to guess the latency..)
 
         JUCE_ALSA_LOG ("frames: " << (int) frames << ", periods: " << (int) periods
-                          << ", samplesPerPeriod: " << (int) samplesPerPeriod);
+                          << ", samplesPerPeriod: " << (int) samplesPerPeriod << ", mmap: " << (int) isMmap);
 
         snd_pcm_sw_params_t* swParams;
         snd_pcm_sw_params_alloca (&swParams);
         snd_pcm_uframes_t boundary;
 
+       #if JUCE_ALSA_LOW_LATENCY
+        // playback only starts once the whole buffer has been filled (see ALSAThread::open())
+        const snd_pcm_uframes_t startThreshold = isInput ? samplesPerPeriod
+                                                         : jmax (samplesPerPeriod, frames * periods);
+       #else
+        const snd_pcm_uframes_t startThreshold = samplesPerPeriod;
+       #endif
+
         if (JUCE_ALSA_FAILED (snd_pcm_sw_params_current (handle, swParams))
             || JUCE_ALSA_FAILED (snd_pcm_sw_params_get_boundary (swParams, &boundary))
             || JUCE_ALSA_FAILED (snd_pcm_sw_params_set_silence_threshold (handle, swParams, 0))
             || JUCE_ALSA_FAILED (snd_pcm_sw_params_set_silence_size (handle, swParams, boundary))
-            || JUCE_ALSA_FAILED (snd_pcm_sw_params_set_start_threshold (handle, swParams, samplesPerPeriod))
+            || JUCE_ALSA_FAILED (snd_pcm_sw_params_set_start_threshold (handle, swParams, startThreshold))
             || JUCE_ALSA_FAILED (snd_pcm_sw_params_set_stop_threshold (handle, swParams, boundary))
+           #if JUCE_ALSA_LOW_LATENCY
+            || JUCE_ALSA_FAILED (snd_pcm_sw_params_set_avail_min (handle, swParams, samplesPerPeriod))
+           #endif
             || JUCE_ALSA_FAILED (snd_pcm_sw_params (handle, swParams)))
         {
             return false;
@@ -305,6 +332,9 @@ public:
         float** const data = outputChannelBuffer.getArrayOfChannels();
         snd_pcm_sframes_t numDone = 0;
 
+        if (isMmap)
+            return writeToMmapBuffer (data, numSamples);
+
         if (isInterleaved)
         {
             scratch.ensureSize (sizeof (float) * numSamples * numChannelsRunning, false);
@@ -322,7 +352,7 @@ public:
             numDone = snd_pcm_writen (handle, (void**) data, numSamples);
         }
 
-        if (numDone < 0 && JUCE_ALSA_FAILED (snd_pcm_recover (handle, numDone, 1 /* silent */)))
+        if (numDone < 0 && ! recover ((int) numDone))
             return false;
 
         if (numDone < numSamples)
@@ -336,6 +366,9 @@ public:
         jassert (numChannelsRunning <= inputChannelBuffer.getNumChannels());
         float** const data = inputChannelBuffer.getArrayOfChannels();
 
+        if (isMmap)
+            return readFromMmapBuffer (data, numSamples);
+
         if (isInterleaved)
         {
             scratch.ensureSize (sizeof (float) * numSamples * numChannelsRunning, false);
@@ -343,7 +376,7 @@ public:
 
             snd_pcm_sframes_t num = snd_pcm_readi (handle, scratch.getData(), numSamples);
 
-            if (num < 0 && JUCE_ALSA_FAILED (snd_pcm_recover (handle, num, 1 /* silent */)))
+            if (num < 0 && ! recover ((int) num))
                 return false;
 
             if (num < numSamples)
@@ -356,7 +389,7 @@ public:
         {
             snd_pcm_sframes_t num = snd_pcm_readn (handle, (void**) data, numSamples);
 
-            if (num < 0 && JUCE_ALSA_FAILED (snd_pcm_recover (handle, num, 1 /* silent */)))
+            if (num < 0 && ! recover ((int) num))
                 return false;
 
             if (num < numSamples)
@@ -369,6 +402,29 @@ public:
         return true;
     }
 
+    /** Returns the number of xruns that the device has had to recover from. */
+    int getXRunCount() const noexcept       { return numXRuns; }
+
+    /** Tries to get the device going again after an error, counting it if it was an xrun.
+        Returns false if it couldn't be recovered.
+    */
+    bool recover (const int errorNum, const bool silent = true)
+    {
+        if (errorNum == -EPIPE)
+            ++numXRuns;
+
+        return ! JUCE_ALSA_FAILED (snd_pcm_recover (handle, errorNum, silent ? 1 : 0));
+    }
+
+    /** Returns the number of frames between the application's position in the stream
+        and the hardware's (including any delay the driver reports), or -1 on error.
+    */
+    int getCurrentDelay() const
+    {
+        snd_pcm_sframes_t delay = 0;
+        return (handle != 0 && snd_pcm_delay (handle, &delay) >= 0) ? (int) delay : -1;
+    }
+
     //==============================================================================
     snd_pcm_t* handle;
     String error;
@@ -378,8 +434,142 @@ private:
     //==============================================================================
     String deviceID;
     const bool isInput;
-    bool isInterleaved;
+    bool isInterleaved, isMmap;
+    int numXRuns;
     MemoryBlock scratch;
+
+    //==============================================================================
+    // Returns the address of a frame in the mmap buffer, as long as its channels are laid out the
+    // way the interleaved converter expects (otherwise the samples have to go via snd_pcm_writei).
+    char* getInterleavedFrame (const snd_pcm_channel_area_t* const areas, const snd_pcm_uframes_t offset)
+    {
+        const unsigned int frameBits = (unsigned int) (bitDepth * numChannelsRunning);
+
+        for (int i = 0; i < numChannelsRunning; ++i)
+        {
+            if (areas[i].addr != areas[0].addr
+                 || areas[i].step != frameBits
+                 || areas[i].first != areas[0].first + (unsigned int) (i * bitDepth))
+            {
+                error = "unsupported mmap channel layout";
+                JUCE_ALSA_LOG ("Error: " + error);
+                return nullptr;
+            }
+        }
+
+        return static_cast <char*> (areas[0].addr) + (areas[0].first + offset * areas[0].step) / 8;
+    }
+
+    // Waits until some frames can be transferred, and returns how many, or 0 if the
+    // device timed out, or -1 if something failed.
+    snd_pcm_sframes_t waitForFrames()
+    {
+        for (;;)
+        {
+            if (isInput && snd_pcm_state (handle) == SND_PCM_STATE_PREPARED
+                 && JUCE_ALSA_FAILED (snd_pcm_start (handle)))
+                return -1;
+
+            const snd_pcm_sframes_t avail = snd_pcm_avail_update (handle);
+
+            if (avail < 0)
+            {
+                if (! recover ((int) avail))
+                    return -1;
+            }
+            else if (avail > 0)
+            {
+                return avail;
+            }
+            else
+            {
+                const int result = snd_pcm_wait (handle, 1000);
+
+                if (result == 0)
+                    return 0;
+
+                if (result < 0 && ! recover (result))
+                    return -1;
+            }
+        }
+    }
+
+    bool writeToMmapBuffer (float** const data, const int numSamples)
+    {
+        for (int pos = 0; pos < numSamples;)
+        {
+            const snd_pcm_sframes_t avail = waitForFrames();
+
+            if (avail <= 0)
+                return avail == 0;
+
+            const snd_pcm_channel_area_t* areas;
+            snd_pcm_uframes_t offset = 0;
+            snd_pcm_uframes_t frames = (snd_pcm_uframes_t) jmin ((snd_pcm_sframes_t) (numSamples - pos), avail);
+
+            if (JUCE_ALSA_FAILED (snd_pcm_mmap_begin (handle, &areas, &offset, &frames)))
+                return false;
+
+            char* const dest = getInterleavedFrame (areas, offset);
+
+            if (dest == nullptr)
+                return false;
+
+            for (int i = 0; i < numChannelsRunning; ++i)
+                converter->convertSamples (dest, i, data[i] + pos, 0, (int) frames);
+
+            const snd_pcm_sframes_t committed = snd_pcm_mmap_commit (handle, offset, frames);
+
+            if (committed < 0 || (snd_pcm_uframes_t) committed != frames)
+                if (! recover (committed >= 0 ? -EPIPE : (int) committed))
+                    return false;
+
+            pos += (int) frames;
+        }
+
+        return true;
+    }
+
+    bool readFromMmapBuffer (float** const data, const int numSamples)
+    {
+        for (int pos = 0; pos < numSamples;)
+        {
+            const snd_pcm_sframes_t avail = waitForFrames();
+
+            if (avail <= 0)
+            {
+                for (int i = 0; i < numChannelsRunning; ++i)
+                    zeromem (data[i] + pos, sizeof (float) * (size_t) (numSamples - pos));
+
+                return avail == 0;
+            }
+
+            const snd_pcm_channel_area_t* areas;
+            snd_pcm_uframes_t offset = 0;
+            snd_pcm_uframes_t frames = (snd_pcm_uframes_t) jmin ((snd_pcm_sframes_t) (numSamples - pos), avail);
+
+            if (JUCE_ALSA_FAILED (snd_pcm_mmap_begin (handle, &areas, &offset, &frames)))
+                return false;
+
+            const char* const src = getInterleavedFrame (areas, offset);
+
+            if (src == nullptr)
+                return false;
+
+            for (int i = 0; i < numChannelsRunning; ++i)
+                converter->convertSamples (data[i] + pos, 0, src, i, (int) frames);
+
+            const snd_pcm_sframes_t committed = snd_pcm_mmap_commit (handle, offset, frames);
+
+            if (committed < 0 || (snd_pcm_uframes_t) committed != frames)
+                if (! recover (committed >= 0 ? -EPIPE : (int) committed))
+                    return false;
+
+            pos += (int) frames;
+        }
+
+        return true;
+    }
     ScopedPointer<AudioData::Converter> converter;
 
     //==============================================================================
@@ -566,7 +756,8 @@ public:
         }
 
         if (outputDevice != nullptr && inputDevice != nullptr)
-            snd_pcm_link (outputDevice->handle, inputDevice->handle);
+            if (JUCE_CHECKED_RESULT (snd_pcm_link (outputDevice->handle, inputDevice->handle)) < 0)
+                JUCE_ALSA_LOG ("couldn't link the input and output devices, so they'll start separately");
 
         if (inputDevice != nullptr && JUCE_ALSA_FAILED (snd_pcm_prepare (inputDevice->handle)))
             return;
@@ -574,6 +765,29 @@ public:
         if (outputDevice != nullptr && JUCE_ALSA_FAILED (snd_pcm_prepare (outputDevice->handle)))
             return;
 
+       #if JUCE_ALSA_LOW_LATENCY
+        // Filling the playback buffer with silence starts it (and the linked capture stream), so
+        // that the thread's first write lands a whole buffer ahead of the hardware.
+        if (outputDevice != nullptr)
+        {
+            const snd_pcm_sframes_t space = snd_pcm_avail_update (outputDevice->handle);
+
+            for (int i = (int) (space / bufferSize); --i >= 0;)
+            {
+                if (! outputDevice->writeToOutputDevice (outputChannelBuffer, bufferSize))
+                {
+                    error = outputDevice->error;
+                    return;
+                }
+            }
+        }
+       #endif
+
+        Thread::RealtimeOptions realtimeOptions;
+        realtimeOptions.priority = 9;
+        realtimeOptions.periodMs = bufferSize * 1000.0 / sampleRate;
+        setRealtime (realtimeOptions);
+
         startThread (9);
 
         int count = 1000;
@@ -630,6 +844,11 @@ public:
 
     void run()
     {
+       #if JUCE_ALSA_LOW_LATENCY
+        setRealtimeScheduling();
+        inputLatency = outputLatency = 0;
+       #endif
+
         while (! threadShouldExit())
         {
             if (inputDevice != nullptr && inputDevice->handle)
@@ -643,6 +862,11 @@ public:
                 }
 
                 audioIoInProgress = false;
+
+               #if JUCE_ALSA_LOW_LATENCY
+                // (the frames that have arrived since the end of the block that was just read)
+                inputLatency = jmax (inputLatency, inputDevice->getCurrentDelay());
+               #endif
             }
 
             if (threadShouldExit())
@@ -677,7 +901,12 @@ public:
                 snd_pcm_sframes_t avail = snd_pcm_avail_update (outputDevice->handle);
 
                 if (avail < 0)
-                    JUCE_ALSA_FAILED (snd_pcm_recover (outputDevice->handle, avail, 0));
+                    outputDevice->recover ((int) avail, false);
+
+               #if JUCE_ALSA_LOW_LATENCY
+                // (the frames that will be played before the block that's about to be written)
+                outputLatency = jmax (outputLatency, outputDevice->getCurrentDelay());
+               #endif
 
                 audioIoInProgress = true;
 
@@ -704,6 +933,12 @@ public:
         return 16;
     }
 
+    int getXRunCount() const noexcept
+    {
+        return (outputDevice != nullptr ? outputDevice->getXRunCount() : 0)
+             + (inputDevice  != nullptr ? inputDevice->getXRunCount()  : 0);
+    }
+
     //==============================================================================
     String error;
     double sampleRate;
@@ -739,6 +974,22 @@ private:
         return true;
     }
 
+   #if JUCE_ALSA_LOW_LATENCY
+    static void setRealtimeScheduling()
+    {
+        const int minp = sched_get_priority_min (SCHED_FIFO);
+        const int maxp = sched_get_priority_max (SCHED_FIFO);
+
+        struct sched_param param;
+        param.sched_priority = minp + (3 * (maxp - minp) / 4);
+
+        // This needs CAP_SYS_NICE or an rtprio limit - if it's not allowed, the thread just
+        // keeps the ordinary priority that startThread() gave it.
+        if (pthread_setschedparam (pthread_self(), SCHED_FIFO, &param) != 0)
+            JUCE_ALSA_LOG ("couldn't set SCHED_FIFO scheduling for the ALSA thread");
+    }
+   #endif
+
     void initialiseRatesAndChannels()
     {
         sampleRates.clear();
@@ -856,6 +1107,7 @@ public:
 
     int getOutputLatencyInSamples()         { return internal.outputLatency; }
     int getInputLatencyInSamples()          { return internal.inputLatency; }
+    int getXRunCount() const noexcept       { return internal.getXRunCount(); }
 
     void start (AudioIODeviceCallback* callback)
     {
@@ -62,6 +62,8 @@ JUCE_DECL_JACK_FUNCTION (jack_nframes_t, jack_port_get_total_latency, (jack_clie
 JUCE_DECL_JACK_FUNCTION (jack_port_t* , jack_port_register, (jack_client_t* client, const char* port_name, const char* port_type, unsigned long flags, unsigned long buffer_size), (client, port_name, port_type, flags, buffer_size));
 JUCE_DECL_VOID_JACK_FUNCTION (jack_set_error_function, (void (*func)(const char*)), (func));
 JUCE_DECL_JACK_FUNCTION (int, jack_set_process_callback, (jack_client_t* client, JackProcessCallback process_callback, void* arg), (client, process_callback, arg));
+JUCE_DECL_JACK_FUNCTION (int, jack_set_xrun_callback, (jack_client_t* client, JackXRunCallback xrun_callback, void* arg), (client, xrun_callback, arg));
+JUCE_DECL_JACK_FUNCTION (int, jack_set_latency_callback, (jack_client_t* client, JackLatencyCallback latency_callback, void* arg), (client, latency_callback, arg));
 JUCE_DECL_JACK_FUNCTION (const char**, jack_get_ports, (jack_client_t* client, const char* port_name_pattern, const char* type_name_pattern, unsigned long flags), (client, port_name_pattern, type_name_pattern, flags));
 JUCE_DECL_JACK_FUNCTION (int, jack_connect, (jack_client_t* client, const char* source_port, const char* destination_port), (client, source_port, destination_port));
 JUCE_DECL_JACK_FUNCTION (const char*, jack_port_name, (const jack_port_t* port), (port));
@@ -143,7 +145,13 @@ class JackAudioIODeviceType;
 static Array<JackAudioIODeviceType*> activeDeviceTypes;
 
 //==============================================================================
-class JackAudioIODevice   : public AudioIODevice
+/*  The audio callback gets the JACK port buffers directly, and never takes a lock: the
+    callback pointer is swapped atomically, and any thread that changes it waits for the
+    audio thread to finish with the old one. Port connection and latency changes arrive on
+    JACK's notification thread, and are handled asynchronously on the message thread.
+*/
+class JackAudioIODevice   : public AudioIODevice,
+                            private AsyncUpdater
 {
 public:
     JackAudioIODevice (const String& deviceName,
@@ -153,9 +161,10 @@ public:
           inputId (inId),
           outputId (outId),
           deviceIsOpen (false),
-          callback (nullptr),
           totalNumberOfInputChannels (0),
-          totalNumberOfOutputChannels (0)
+          totalNumberOfOutputChannels (0),
+          numActiveInputPorts (0),
+          numActiveOutputPorts (0)
     {
         jassert (deviceName.isNotEmpty());
 
@@ -194,11 +203,14 @@ public:
 
             inChans.calloc (totalNumberOfInputChannels + 2);
             outChans.calloc (totalNumberOfOutputChannels + 2);
+            activeInputPorts.calloc (totalNumberOfInputChannels + 2);
+            activeOutputPorts.calloc (totalNumberOfOutputChannels + 2);
         }
     }
 
     ~JackAudioIODevice()
     {
+        cancelPendingUpdate();
         close();
         if (client != nullptr)
         {
@@ -238,7 +250,11 @@ public:
         lastError = String::empty;
         close();
 
+        numXRuns = 0;
+
         juce::jack_set_process_callback (client, processCallback, this);
+        juce::jack_set_xrun_callback (client, xrunCallback, this);
+        juce::jack_set_latency_callback (client, latencyCallback, this);
         juce::jack_set_port_connect_callback (client, portConnectCallback, this);
         juce::jack_on_shutdown (client, shutdownCallback, this);
         juce::jack_activate (client);
@@ -281,6 +297,8 @@ public:
         {
             juce::jack_deactivate (client);
             juce::jack_set_process_callback (client, processCallback, nullptr);
+            juce::jack_set_xrun_callback (client, xrunCallback, nullptr);
+            juce::jack_set_latency_callback (client, latencyCallback, nullptr);
             juce::jack_set_port_connect_callback (client, portConnectCallback, nullptr);
             juce::jack_on_shutdown (client, shutdownCallback, nullptr);
         }
@@ -290,17 +308,18 @@ public:
 
     void start (AudioIODeviceCallback* newCallback)
     {
-        if (deviceIsOpen && newCallback != callback)
+        AudioIODeviceCallback* const oldCallback = callback.get();
+
+        if (deviceIsOpen && newCallback != oldCallback)
         {
             if (newCallback != nullptr)
                 newCallback->audioDeviceAboutToStart (this);
 
-            AudioIODeviceCallback* const oldCallback = callback;
+            callback = newCallback;
 
-            {
-                const ScopedLock sl (callbackLock);
-                callback = newCallback;
-            }
+            // (the audio thread may have picked up the old callback just before it was swapped)
+            while (callbackInUse.get() != 0)
+                Thread::yield();
 
             if (oldCallback != nullptr)
                 oldCallback->audioDeviceStopped();
@@ -313,11 +332,12 @@ public:
     }
 
     bool isOpen()                           { return deviceIsOpen; }
-    bool isPlaying()                        { return callback != nullptr; }
+    bool isPlaying()                        { return callback.get() != nullptr; }
     int getCurrentBufferSizeSamples()       { return getBufferSizeSamples (0); }
     double getCurrentSampleRate()           { return getSampleRate (0); }
     int getCurrentBitDepth()                { return 32; }
     String getLastError()                   { return lastError; }
+    int getXRunCount() const noexcept       { return numXRuns.get(); }
 
     BigInteger getActiveOutputChannels() const { return activeOutputChannels; }
     BigInteger getActiveInputChannels()  const { return activeInputChannels;  }
@@ -347,37 +367,35 @@ public:
 private:
     void process (const int numSamples)
     {
-        int numActiveInChans = 0, numActiveOutChans = 0;
+        callbackInUse = 1;
 
-        for (int i = 0; i < totalNumberOfInputChannels; ++i)
+        if (AudioIODeviceCallback* const currentCallback = callback.get())
         {
-            if (activeInputChannels[i])
+            // (the active port lists are only changed while there's no callback)
+            int numActiveInChans = 0, numActiveOutChans = 0;
+
+            for (int i = 0; i < numActiveInputPorts; ++i)
                 if (jack_default_audio_sample_t* in
-                        = (jack_default_audio_sample_t*) juce::jack_port_get_buffer ((jack_port_t*) inputPorts.getUnchecked(i), numSamples))
+                        = (jack_default_audio_sample_t*) juce::jack_port_get_buffer ((jack_port_t*) activeInputPorts[i], numSamples))
                     inChans [numActiveInChans++] = (float*) in;
-        }
 
-        for (int i = 0; i < totalNumberOfOutputChannels; ++i)
-        {
-            if (activeOutputChannels[i])
+            for (int i = 0; i < numActiveOutputPorts; ++i)
                 if (jack_default_audio_sample_t* out
-                        = (jack_default_audio_sample_t*) juce::jack_port_get_buffer ((jack_port_t*) outputPorts.getUnchecked(i), numSamples))
+                        = (jack_default_audio_sample_t*) juce::jack_port_get_buffer ((jack_port_t*) activeOutputPorts[i], numSamples))
                     outChans [numActiveOutChans++] = (float*) out;
-        }
-
-        const ScopedLock sl (callbackLock);
 
-        if (callback != nullptr)
-        {
             if ((numActiveInChans + numActiveOutChans) > 0)
-                callback->audioDeviceIOCallback (const_cast <const float**> (inChans.getData()), numActiveInChans,
-                                                 outChans, numActiveOutChans, numSamples);
+                currentCallback->audioDeviceIOCallback (const_cast <const float**> (inChans.getData()), numActiveInChans,
+                                                        outChans, numActiveOutChans, numSamples);
         }
         else
         {
-            for (int i = 0; i < numActiveOutChans; ++i)
-                zeromem (outChans[i], sizeof (float) * numSamples);
+            for (int i = 0; i < totalNumberOfOutputChannels; ++i)
+                if (void* const out = juce::jack_port_get_buffer ((jack_port_t*) outputPorts.getUnchecked(i), numSamples))
+                    zeromem (out, sizeof (float) * (size_t) numSamples);
         }
+
+        callbackInUse = 0;
     }
 
     static int processCallback (jack_nframes_t nframes, void* callbackArgument)
@@ -388,6 +406,33 @@ private:
         return 0;
     }
 
+    static int xrunCallback (void* callbackArgument)
+    {
+        if (callbackArgument != nullptr)
+            ++(((JackAudioIODevice*) callbackArgument)->numXRuns);
+
+        return 0;
+    }
+
+    static void latencyCallback (jack_latency_callback_mode_t, void* callbackArgument)
+    {
+        if (JackAudioIODevice* device = static_cast <JackAudioIODevice*> (callbackArgument))
+        {
+            device->latencyHasChanged = 1;
+            device->triggerAsyncUpdate();
+        }
+    }
+
+    void handleAsyncUpdate()
+    {
+        if (latencyHasChanged.compareAndSetBool (0, 1))
+            if (AudioIODeviceCallback* const currentCallback = callback.get())
+                currentCallback->audioDeviceLatencyChanged();
+
+        if (client != nullptr)
+            updateActivePorts();
+    }
+
     void updateActivePorts()
     {
         BigInteger newOutputChannels, newInputChannels;
@@ -403,13 +448,23 @@ private:
         if (newOutputChannels != activeOutputChannels
              || newInputChannels != activeInputChannels)
         {
-            AudioIODeviceCallback* const oldCallback = callback;
+            AudioIODeviceCallback* const oldCallback = callback.get();
 
             stop();
 
             activeOutputChannels = newOutputChannels;
             activeInputChannels  = newInputChannels;
 
+            numActiveInputPorts = 0;
+            for (int i = 0; i < inputPorts.size(); ++i)
+                if (activeInputChannels[i])
+                    activeInputPorts [numActiveInputPorts++] = inputPorts.getUnchecked(i);
+
+            numActiveOutputPorts = 0;
+            for (int i = 0; i < outputPorts.size(); ++i)
+                if (activeOutputChannels[i])
+                    activeOutputPorts [numActiveOutputPorts++] = outputPorts.getUnchecked(i);
+
             if (oldCallback != nullptr)
                 start (oldCallback);
 
@@ -420,7 +475,7 @@ private:
     static void portConnectCallback (jack_port_id_t, jack_port_id_t, int, void* arg)
     {
         if (JackAudioIODevice* device = static_cast <JackAudioIODevice*> (arg))
-            device->updateActivePorts();
+            device->triggerAsyncUpdate();
     }
 
     static void threadInitCallback (void* /* callbackArgument */)
@@ -449,14 +504,16 @@ private:
     bool deviceIsOpen;
     jack_client_t* client;
     String lastError;
-    AudioIODeviceCallback* callback;
-    CriticalSection callbackLock;
+    Atomic<AudioIODeviceCallback*> callback;
+    Atomic<int> callbackInUse, numXRuns, latencyHasChanged;
 
     HeapBlock <float*> inChans, outChans;
     int totalNumberOfInputChannels;
     int totalNumberOfOutputChannels;
     Array<void*> inputPorts, outputPorts;
     BigInteger activeInputChannels, activeOutputChannels;
+    HeapBlock <void*> activeInputPorts, activeOutputPorts;
+    int numActiveInputPorts, numActiveOutputPorts;
 };
 
 
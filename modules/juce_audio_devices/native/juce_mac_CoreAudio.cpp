@@ -130,6 +130,160 @@ bool  JUCE_CALLTYPE SystemAudioVolume::setGain (float gain)   { return SystemVol
 bool  JUCE_CALLTYPE SystemAudioVolume::isMuted()              { return SystemVol (kAudioDevicePropertyMute).isMuted(); }
 bool  JUCE_CALLTYPE SystemAudioVolume::setMuted (bool mute)   { return SystemVol (kAudioDevicePropertyMute).setMuted (mute); }
 
+//==============================================================================
+//==============================================================================
+/*  Carries the audio from a separate input device's IOProc over to the output device's
+    IOProc, so that two devices can be used together without an aggregate device.
+
+    The two devices run from different clocks, so the output side reads through a set of
+    resamplers whose ratio is nudged to keep the amount of buffered audio close to a target
+    level. That absorbs the drift between the clocks, and as the target is only as big as the
+    two devices' block sizes need it to be, it adds as little latency as possible.
+
+    write() and read() are each only called by one of the IOProcs, and never block.
+*/
+class CoreAudioDuplexFifo
+{
+public:
+    CoreAudioDuplexFifo (const int numChannels_, const int inputBlockSize, const int outputBlockSize_,
+                         const double inputSampleRate, const double outputSampleRate)
+        : numChannels (jmax (1, numChannels_)),
+          outputBlockSize (jmax (1, outputBlockSize_)),
+          nominalRatio (inputSampleRate > 0 && outputSampleRate > 0 ? inputSampleRate / outputSampleRate : 1.0),
+          outputRate (jmax (1.0, outputSampleRate)),
+          targetLevel (inputBlockSize + roundToInt (outputBlockSize * nominalRatio + 0.002 * inputSampleRate) + 16),
+          fifo (4 * targetLevel),
+          buffer (numChannels, 4 * targetLevel),
+          resampleInput (numChannels, roundToInt (outputBlockSize * nominalRatio * 1.01) + 8),
+          output (numChannels, outputBlockSize),
+          smoothing (jlimit (0.001, 0.5, 4.0 * outputBlockSize / jmax (1.0, outputSampleRate))),
+          isPriming (true),
+          smoothedFillError (0)
+    {
+        for (int i = 0; i < numChannels; ++i)
+            interpolators.add (new LagrangeInterpolator());
+    }
+
+    // (only called while neither device is running)
+    void reset() noexcept
+    {
+        fifo.reset();
+        isPriming = true;
+    }
+
+    void write (const float* const* data, const int numChans, const int numSamples) noexcept
+    {
+        int start1, size1, start2, size2;
+        fifo.prepareToWrite (numSamples, start1, size1, start2, size2);
+
+        if (size1 + size2 < numSamples)
+            ++numGlitches;
+
+        for (int i = 0; i < numChannels; ++i)
+        {
+            if (i < numChans && data[i] != nullptr)
+            {
+                if (size1 > 0)  buffer.copyFrom (i, start1, data[i], size1);
+                if (size2 > 0)  buffer.copyFrom (i, start2, data[i] + size1, size2);
+            }
+            else
+            {
+                if (size1 > 0)  buffer.clear (i, start1, size1);
+                if (size2 > 0)  buffer.clear (i, start2, size2);
+            }
+        }
+
+        fifo.finishedWrite (size1 + size2);
+    }
+
+    const float** read (const int numSamples) noexcept
+    {
+        jassert (numSamples <= outputBlockSize);
+        const int numOut = jmin (numSamples, outputBlockSize);
+        const int numReady = fifo.getNumReady();
+
+        if (isPriming)
+        {
+            if (numReady < targetLevel)
+                return silence();
+
+            isPriming = false;
+            smoothedFillError = 0;
+
+            for (int i = 0; i < numChannels; ++i)
+                interpolators.getUnchecked(i)->reset();
+        }
+        else if (numReady > 3 * targetLevel)
+        {
+            // (we've fallen a long way behind, e.g. because the output device stalled)
+            fifo.finishedRead (numReady - targetLevel);
+            smoothedFillError = 0;
+            ++numGlitches;
+        }
+
+        // Nudge the resampling ratio so that the buffered level settles on the target. The
+        // correction is kept small enough to be inaudible, but it can easily follow the drift
+        // between two crystal clocks, which is well under 0.1%. The target leaves room for the
+        // level to sit below it by as much as the largest correction needs, and the smoothing
+        // is scaled to the block size so that the level settles without overshooting.
+        smoothedFillError += ((double) (fifo.getNumReady() - targetLevel) - smoothedFillError) * smoothing;
+
+        const double correction = jlimit (-0.002, 0.002, smoothedFillError / outputRate);
+        const double ratio = nominalRatio * (1.0 + correction);
+        const int numIn = jmin (resampleInput.getNumSamples() - 4, (int) (numOut * ratio) + 2);
+
+        int start1, size1, start2, size2;
+        fifo.prepareToRead (numIn, start1, size1, start2, size2);
+
+        if (size1 + size2 < numIn)
+        {
+            ++numGlitches;
+            isPriming = true;
+            return silence();
+        }
+
+        int numUsed = 0;
+
+        for (int i = 0; i < numChannels; ++i)
+        {
+            resampleInput.copyFrom (i, 0, buffer, i, start1, size1);
+
+            if (size2 > 0)
+                resampleInput.copyFrom (i, size1, buffer, i, start2, size2);
+
+            numUsed = interpolators.getUnchecked(i)->process (ratio, resampleInput.getSampleData (i),
+                                                              output.getSampleData (i), numOut);
+        }
+
+        fifo.finishedRead (numUsed);
+        return const_cast<const float**> (output.getArrayOfChannels());
+    }
+
+    /** The average delay that the fifo adds, in samples at the output device's rate. */
+    int getLatencyInSamples() const noexcept    { return roundToInt (targetLevel / nominalRatio); }
+
+    Atomic<int> numGlitches;
+
+private:
+    const int numChannels, outputBlockSize;
+    const double nominalRatio, outputRate;
+    const int targetLevel;
+    AbstractFifo fifo;
+    AudioSampleBuffer buffer, resampleInput, output;
+    OwnedArray<LagrangeInterpolator> interpolators;
+    const double smoothing;
+    bool isPriming;
+    double smoothedFillError;
+
+    const float** silence() noexcept
+    {
+        output.clear();
+        return const_cast<const float**> (output.getArrayOfChannels());
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (CoreAudioDuplexFifo)
+};
+
 //==============================================================================
 class CoreAudioInternal  : private Timer
 {
@@ -143,6 +297,7 @@ public:
          audioProcID (0),
         #endif
          isSlaveDevice (false),
+         duplexFifoToFill (nullptr),
          deviceID (id),
          started (false),
          sampleRate (0),
@@ -390,6 +545,20 @@ public:
         if (AudioObjectGetPropertyData (deviceID, &pa, 0, 0, &size, &lat) == noErr)
             outputLatency = (int) lat;
 
+        // (the safety offset is the extra time that the driver reserves on top of the latency)
+        pa.mSelector = kAudioDevicePropertySafetyOffset;
+        pa.mScope = kAudioDevicePropertyScopeInput;
+        size = sizeof (lat);
+
+        if (AudioObjectGetPropertyData (deviceID, &pa, 0, 0, &size, &lat) == noErr)
+            inputLatency += (int) lat;
+
+        pa.mScope = kAudioDevicePropertyScopeOutput;
+        size = sizeof (lat);
+
+        if (AudioObjectGetPropertyData (deviceID, &pa, 0, 0, &size, &lat) == noErr)
+            outputLatency += (int) lat;
+
         JUCE_COREAUDIOLOG ("lat: " + String (inputLatency) + " " + String (outputLatency));
 
         inChanNames.clear();
@@ -571,6 +740,15 @@ public:
         {
             callback = nullptr;
 
+            if (inputDevice != nullptr)
+            {
+                // (the block sizes and rates may have changed since the last time it was started)
+                inputDevice->duplexFifoToFill = nullptr;
+                duplexFifo = new CoreAudioDuplexFifo (inputDevice->numInputChans, inputDevice->bufferSize,
+                                                      bufferSize, inputDevice->sampleRate, sampleRate);
+                inputDevice->duplexFifoToFill = duplexFifo;
+            }
+
             if (deviceID != 0)
             {
                #if MAC_OS_X_VERSION_MIN_REQUIRED < MAC_OS_X_VERSION_10_5
@@ -698,14 +876,9 @@ public:
                 }
                 else
                 {
-                    jassert (inputDevice->bufferSize == bufferSize);
-
-                    // Sometimes the two linked devices seem to get their callbacks in
-                    // parallel, so we need to lock both devices to stop the input data being
-                    // changed while inside our callback..
-                    const ScopedLock sl2 (inputDevice->callbackLock);
-
-                    callback->audioDeviceIOCallback (const_cast<const float**> (inputDevice->tempInputBuffers.getData()),
+                    // (the input device runs from its own IOProc, and passes its audio over
+                    // through the fifo, which also corrects for any drift between the clocks)
+                    callback->audioDeviceIOCallback (duplexFifo->read (bufferSize),
                                                      inputDevice->numInputChans,
                                                      tempOutputBuffers,
                                                      numOutputChans,
@@ -730,6 +903,10 @@ public:
                     }
                 }
             }
+            else if (duplexFifoToFill != nullptr)
+            {
+                duplexFifoToFill->write (tempInputBuffers, numInputChans, bufferSize);
+            }
         }
         else
         {
@@ -831,7 +1008,10 @@ public:
    #endif
 
     ScopedPointer<CoreAudioInternal> inputDevice;
+    ScopedPointer<CoreAudioDuplexFifo> duplexFifo;
     bool isSlaveDevice;
+    CoreAudioDuplexFifo* duplexFifoToFill;
+    Atomic<int> numXRuns;
 
 private:
     CriticalSection callbackLock;
@@ -882,6 +1062,10 @@ private:
                 intern->deviceDetailsChanged();
                 break;
 
+            case kAudioDeviceProcessorOverload:
+                ++(intern->numXRuns);
+                break;
+
             case kAudioDevicePropertyBufferSizeRange:
             case kAudioDevicePropertyVolumeScalar:
             case kAudioDevicePropertyMute:
@@ -1013,6 +1197,13 @@ public:
 
     int getCurrentBitDepth()             { return 32; }  // no way to find out, so just assume it's high..
 
+    int getXRunCount() const noexcept
+    {
+        return internal->numXRuns.get()
+                + (internal->inputDevice != nullptr ? internal->inputDevice->numXRuns.get() : 0)
+                + (internal->duplexFifo != nullptr ? internal->duplexFifo->numGlitches.get() : 0);
+    }
+
     int getNumBufferSizesAvailable()     { return internal->bufferSizes.size(); }
     int getBufferSizeSamples (int index) { return internal->bufferSizes [index]; }
     int getCurrentBufferSizeSamples()    { return internal->getBufferSize(); }
@@ -1076,6 +1267,12 @@ public:
 
     int getInputLatencyInSamples()
     {
+        // With a separate input device, the audio is delayed by that device's own latency and
+        // block, and then by the fifo that carries it over to the output device's callback.
+        if (internal->inputDevice != nullptr && internal->duplexFifo != nullptr)
+            return internal->inputDevice->inputLatency + internal->inputDevice->getBufferSize()
+                    + internal->duplexFifo->getLatencyInSamples();
+
         return internal->inputLatency + internal->getBufferSize() * 2;
     }
 
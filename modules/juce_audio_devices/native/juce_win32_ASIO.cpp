@@ -747,6 +747,7 @@ public:
     int getCurrentBufferSizeSamples()   { return currentBlockSizeSamples; }
     double getCurrentSampleRate()       { return currentSampleRate; }
     int getCurrentBitDepth()            { return currentBitDepth; }
+    int getXRunCount() const noexcept   { return numXRuns.get(); }
 
     BigInteger getActiveOutputChannels() const    { return currentChansOut; }
     BigInteger getActiveInputChannels() const     { return currentChansIn; }
@@ -872,6 +873,7 @@ private:
     BigInteger currentChansOut, currentChansIn;
     AudioIODeviceCallback* volatile currentCallback;
     CriticalSection callbackLock;
+    Atomic<int> numXRuns;
 
     HeapBlock<ASIOBufferInfo> bufferInfos;
     HeapBlock<float*> inBuffers, outBuffers;
@@ -1372,7 +1374,7 @@ private:
 
         case kAsioBufferSizeChange: JUCE_ASIO_LOG ("kAsioBufferSizeChange"); return sendResetRequest (deviceIndex);
         case kAsioResetRequest:     JUCE_ASIO_LOG ("kAsioResetRequest");     return sendResetRequest (deviceIndex);
-        case kAsioResyncRequest:    JUCE_ASIO_LOG ("kAsioResyncRequest");    return sendResetRequest (deviceIndex);
+        case kAsioResyncRequest:    JUCE_ASIO_LOG ("kAsioResyncRequest");    return sendResyncRequest (deviceIndex);
         case kAsioLatenciesChanged: JUCE_ASIO_LOG ("kAsioLatenciesChanged"); return 1;
         case kAsioEngineVersion:    return 2;
 
@@ -1392,6 +1394,15 @@ private:
         return 1;
     }
 
+    static long sendResyncRequest (int deviceIndex)
+    {
+        // drivers send this when they've had a dropout, so it gets counted as an xrun
+        if (currentASIODev[deviceIndex] != nullptr)
+            ++(currentASIODev[deviceIndex]->numXRuns);
+
+        return sendResetRequest (deviceIndex);
+    }
+
     static void JUCE_ASIOCALLBACK sampleRateChangedCallback (ASIOSampleRate)
     {
     }
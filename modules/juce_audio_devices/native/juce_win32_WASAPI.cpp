@@ -328,6 +328,11 @@ int refTimeToSamples (const REFERENCE_TIME& t, const double sampleRate) noexcept
     return roundToInt (sampleRate * ((double) t) * 0.0000001);
 }
 
+REFERENCE_TIME samplesToRefTime (const int numSamples, const double sampleRate) noexcept
+{
+    return (REFERENCE_TIME) ((numSamples * 10000000.0 / sampleRate) + 0.5);
+}
+
 void copyWavFormat (WAVEFORMATEXTENSIBLE& dest, const WAVEFORMATEX* const src) noexcept
 {
     memcpy (&dest, src, src->wFormatTag == WAVE_FORMAT_EXTENSIBLE ? sizeof (WAVEFORMATEXTENSIBLE)
@@ -400,7 +405,7 @@ public:
 
     bool isOk() const noexcept   { return defaultBufferSize > 0 && defaultSampleRate > 0; }
 
-    bool openClient (const double newSampleRate, const BigInteger& newChannels)
+    bool openClient (const double newSampleRate, const BigInteger& newChannels, const int bufferSizeSamples)
     {
         sampleRate = newSampleRate;
         channels = newChannels;
@@ -413,8 +418,8 @@ public:
         client = createClient();
 
         if (client != nullptr
-             && (tryInitialisingWithFormat (true, 4) || tryInitialisingWithFormat (false, 4)
-                  || tryInitialisingWithFormat (false, 3) || tryInitialisingWithFormat (false, 2)))
+             && (tryInitialisingWithFormat (true, 4, bufferSizeSamples) || tryInitialisingWithFormat (false, 4, bufferSizeSamples)
+                  || tryInitialisingWithFormat (false, 3, bufferSizeSamples) || tryInitialisingWithFormat (false, 2, bufferSizeSamples)))
         {
             sampleRateHasChanged = false;
 
@@ -467,6 +472,7 @@ public:
     UINT32 actualBufferSize;
     int bytesPerSample;
     bool sampleRateHasChanged;
+    Atomic<int> numXRuns;
 
     virtual void updateFormat (bool isFloat) = 0;
 
@@ -539,7 +545,7 @@ private:
         return client;
     }
 
-    bool tryInitialisingWithFormat (const bool useFloat, const int bytesPerSampleToTry)
+    bool tryInitialisingWithFormat (const bool useFloat, const int bytesPerSampleToTry, const int bufferSizeSamples)
     {
         WAVEFORMATEXTENSIBLE format;
         zerostruct (format);
@@ -579,15 +585,43 @@ private:
 
         CoTaskMemFree (nearestFormat);
 
-        REFERENCE_TIME defaultPeriod = 0, minPeriod = 0;
+        if (hr != S_OK)
+            return false;
+
+        // In exclusive mode, the buffer is exchanged directly with the driver, so we ask for
+        // a period that matches the requested block size (but never shorter than the device's
+        // minimum), and use it for both the buffer duration and the event periodicity.
+        REFERENCE_TIME period = 0;
+
         if (useExclusiveMode)
+        {
+            REFERENCE_TIME defaultPeriod = 0, minPeriod = 0;
             check (client->GetDevicePeriod (&defaultPeriod, &minPeriod));
 
+            period = bufferSizeSamples > 0 ? jmax (minPeriod, samplesToRefTime (bufferSizeSamples, sampleRate))
+                                           : defaultPeriod;
+        }
+
         GUID session;
-        if (hr == S_OK
-             && check (client->Initialize (useExclusiveMode ? AUDCLNT_SHAREMODE_EXCLUSIVE : AUDCLNT_SHAREMODE_SHARED,
-                                           0x40000 /*AUDCLNT_STREAMFLAGS_EVENTCALLBACK*/,
-                                           defaultPeriod, defaultPeriod, (WAVEFORMATEX*) &format, &session)))
+        hr = initialiseClient (format, period, session);
+
+        if (hr == MAKE_HRESULT (1, 0x889, 0x019) /*AUDCLNT_E_BUFFER_SIZE_NOT_ALIGNED*/ && useExclusiveMode)
+        {
+            // The driver wants a different size, so it has to be re-opened using the aligned
+            // buffer size that it reports..
+            UINT32 alignedBufferSize = 0;
+
+            if (check (client->GetBufferSize (&alignedBufferSize)))
+            {
+                period = samplesToRefTime ((int) alignedBufferSize, sampleRate);
+                client = createClient();
+
+                if (client != nullptr)
+                    hr = initialiseClient (format, period, session);
+            }
+        }
+
+        if (check (hr))
         {
             actualNumChannels = format.Format.nChannels;
             const bool isFloat = format.Format.wFormatTag == WAVE_FORMAT_EXTENSIBLE && format.SubFormat == KSDATAFORMAT_SUBTYPE_IEEE_FLOAT;
@@ -600,6 +634,13 @@ private:
         return false;
     }
 
+    HRESULT initialiseClient (WAVEFORMATEXTENSIBLE& format, const REFERENCE_TIME period, GUID& session)
+    {
+        return client->Initialize (useExclusiveMode ? AUDCLNT_SHAREMODE_EXCLUSIVE : AUDCLNT_SHAREMODE_SHARED,
+                                   0x40000 /*AUDCLNT_STREAMFLAGS_EVENTCALLBACK*/,
+                                   period, period, (WAVEFORMATEX*) &format, &session);
+    }
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (WASAPIDeviceBase)
 };
 
@@ -618,12 +659,12 @@ public:
         close();
     }
 
-    bool open (const double newSampleRate, const BigInteger& newChannels)
+    bool open (const double newSampleRate, const BigInteger& newChannels, const int bufferSizeSamples)
     {
         reservoirSize = 0;
         reservoirCapacity = 16384;
         reservoir.setSize (actualNumChannels * reservoirCapacity * sizeof (float));
-        return openClient (newSampleRate, newChannels)
+        return openClient (newSampleRate, newChannels, bufferSizeSamples)
                 && (numChannels == 0 || check (client->GetService (__uuidof (IAudioCaptureClient),
                                                                    (void**) captureClient.resetAndGetPointerAddress())));
     }
@@ -691,6 +732,9 @@ public:
 
                 if (check (captureClient->GetBuffer (&inputData, &numSamplesAvailable, &flags, 0, 0)))
                 {
+                    if ((flags & 1 /* AUDCLNT_BUFFERFLAGS_DATA_DISCONTINUITY */) != 0)
+                        ++numXRuns;
+
                     const int samplesToDo = jmin (bufferSize, (int) numSamplesAvailable);
 
                     for (int i = 0; i < numDestBuffers; ++i)
@@ -735,9 +779,9 @@ public:
         close();
     }
 
-    bool open (const double newSampleRate, const BigInteger& newChannels)
+    bool open (const double newSampleRate, const BigInteger& newChannels, const int bufferSizeSamples)
     {
-        return openClient (newSampleRate, newChannels)
+        return openClient (newSampleRate, newChannels, bufferSizeSamples)
             && (numChannels == 0 || check (client->GetService (__uuidof (IAudioRenderClient), (void**) renderClient.resetAndGetPointerAddress())));
     }
 
@@ -762,6 +806,17 @@ public:
         else                            updateFormatWithType ((AudioData::Int16*) 0);
     }
 
+    /** In exclusive mode, the device starts playing the buffer as soon as it's started, so this
+        gives it a buffer of silence to play while the first block is being rendered.
+    */
+    void prefillWithSilence()
+    {
+        uint8* outputData = nullptr;
+
+        if (renderClient != nullptr && check (renderClient->GetBuffer (actualBufferSize, &outputData)))
+            renderClient->ReleaseBuffer (actualBufferSize, 0x2 /*AUDCLNT_BUFFERFLAGS_SILENT*/);
+    }
+
     void copyBuffers (const float** const srcBuffers, const int numSrcBuffers, int bufferSize, Thread& thread)
     {
         if (numChannels <= 0)
@@ -769,14 +824,49 @@ public:
 
         int offset = 0;
 
+        if (useExclusiveMode)
+        {
+            // In exclusive event mode the driver swaps between two buffers of actualBufferSize
+            // samples, and signals the event each time one of them is free to be filled.
+            while (bufferSize > 0)
+            {
+                if (thread.threadShouldExit()
+                     || WaitForSingleObject (clientEvent, 1000) == WAIT_TIMEOUT)
+                    break;
+
+                const int samplesToDo = jmin (bufferSize, (int) actualBufferSize);
+                uint8* outputData = nullptr;
+
+                if (check (renderClient->GetBuffer ((UINT32) samplesToDo, &outputData)))
+                {
+                    for (int i = 0; i < numSrcBuffers; ++i)
+                        converter->convertSamples (outputData, channelMaps.getUnchecked(i), srcBuffers[i] + offset, 0, samplesToDo);
+
+                    renderClient->ReleaseBuffer ((UINT32) samplesToDo, 0);
+                }
+
+                offset += samplesToDo;
+                bufferSize -= samplesToDo;
+            }
+
+            return;
+        }
+
+        bool isFirstBlock = true;
+
         while (bufferSize > 0)
         {
             UINT32 padding = 0;
             if (! check (client->GetCurrentPadding (&padding)))
                 return;
 
-            int samplesToDo = useExclusiveMode ? bufferSize
-                                               : jmin ((int) (actualBufferSize - padding), bufferSize);
+            // if the device had already played everything we gave it last time, it's run dry
+            if (isFirstBlock && padding == 0)
+                ++numXRuns;
+
+            isFirstBlock = false;
+
+            int samplesToDo = jmin ((int) (actualBufferSize - padding), bufferSize);
 
             if (samplesToDo <= 0)
             {
@@ -818,7 +908,7 @@ public:
                          const String& outputDeviceId_,
                          const String& inputDeviceId_,
                          const bool exclusiveMode)
-        : AudioIODevice (deviceName, "Windows Audio"),
+        : AudioIODevice (deviceName, getTypeName (exclusiveMode)),
           Thread ("Juce WASAPI"),
           outputDeviceId (outputDeviceId_),
           inputDeviceId (inputDeviceId_),
@@ -836,6 +926,12 @@ public:
         close();
     }
 
+    static String getTypeName (const bool exclusiveMode)
+    {
+        return exclusiveMode ? "Windows Audio (Exclusive Mode)"
+                             : "Windows Audio";
+    }
+
     bool initialise()
     {
         latencyIn = latencyOut = 0;
@@ -913,6 +1009,12 @@ public:
     int getCurrentBufferSizeSamples()                   { return currentBufferSizeSamples; }
     double getCurrentSampleRate()                       { return currentSampleRate; }
     int getCurrentBitDepth()                            { return 32; }
+
+    int getXRunCount() const noexcept
+    {
+        return (inputDevice  != nullptr ? inputDevice->numXRuns.get()  : 0)
+             + (outputDevice != nullptr ? outputDevice->numXRuns.get() : 0);
+    }
     int getOutputLatencyInSamples()                     { return latencyOut; }
     int getInputLatencyInSamples()                      { return latencyIn; }
     BigInteger getActiveOutputChannels() const          { return outputDevice != nullptr ? outputDevice->channels : BigInteger(); }
@@ -937,19 +1039,28 @@ public:
         lastKnownInputChannels    = inputChannels;
         lastKnownOutputChannels   = outputChannels;
 
-        if (inputDevice != nullptr && ! inputDevice->open (currentSampleRate, inputChannels))
+        if (inputDevice != nullptr && ! inputDevice->open (currentSampleRate, inputChannels, currentBufferSizeSamples))
         {
             lastError = "Couldn't open the input device!";
             return lastError;
         }
 
-        if (outputDevice != nullptr && ! outputDevice->open (currentSampleRate, outputChannels))
+        if (outputDevice != nullptr && ! outputDevice->open (currentSampleRate, outputChannels, currentBufferSizeSamples))
         {
             close();
             lastError = "Couldn't open the output device!";
             return lastError;
         }
 
+        if (useExclusiveMode)
+        {
+            // the driver may have rounded the period, so use the block size it actually chose..
+            if (outputDevice != nullptr && outputDevice->client != nullptr)
+                currentBufferSizeSamples = (int) outputDevice->actualBufferSize;
+            else if (inputDevice != nullptr && inputDevice->client != nullptr)
+                currentBufferSizeSamples = (int) inputDevice->actualBufferSize;
+        }
+
         if (inputDevice != nullptr)   ResetEvent (inputDevice->clientEvent);
         if (outputDevice != nullptr)  ResetEvent (outputDevice->clientEvent);
 
@@ -972,6 +1083,9 @@ public:
         {
             latencyOut = (int) (outputDevice->latencySamples + currentBufferSizeSamples);
 
+            if (useExclusiveMode)
+                outputDevice->prefillWithSilence();
+
             if (! check (outputDevice->client->Start()))
             {
                 close();
@@ -1038,25 +1152,17 @@ public:
         }
     }
 
-    void setMMThreadPriority()
+    void run()
     {
-        DynamicLibrary dll ("avrt.dll");
-        JUCE_LOAD_WINAPI_FUNCTION (dll, AvSetMmThreadCharacteristicsW, avSetMmThreadCharacteristics, HANDLE, (LPCWSTR, LPDWORD))
-        JUCE_LOAD_WINAPI_FUNCTION (dll, AvSetMmThreadPriority, avSetMmThreadPriority, HANDLE, (HANDLE, AVRT_PRIORITY))
-
-        if (avSetMmThreadCharacteristics != 0 && avSetMmThreadPriority != 0)
         {
-            DWORD dummy = 0;
-            HANDLE h = avSetMmThreadCharacteristics (L"Pro Audio", &dummy);
+            Thread::RealtimeOptions realtimeOptions;
+            realtimeOptions.priority = useExclusiveMode ? 10 : 5;
 
-            if (h != 0)
-                avSetMmThreadPriority (h, AVRT_PRIORITY_NORMAL);
-        }
-    }
+            if (currentSampleRate > 0)
+                realtimeOptions.periodMs = currentBufferSizeSamples * 1000.0 / currentSampleRate;
 
-    void run()
-    {
-        setMMThreadPriority();
+            setRealtime (realtimeOptions);
+        }
 
         const int bufferSize        = currentBufferSizeSamples;
         const int numInputBuffers   = getActiveInputChannels().countNumberOfSetBits();
@@ -1213,9 +1319,10 @@ class WASAPIAudioIODeviceType  : public AudioIODeviceType,
                                  private DeviceChangeDetector
 {
 public:
-    WASAPIAudioIODeviceType()
-        : AudioIODeviceType ("Windows Audio"),
+    WASAPIAudioIODeviceType (const bool exclusive)
+        : AudioIODeviceType (WASAPIAudioIODevice::getTypeName (exclusive)),
           DeviceChangeDetector (L"Windows Audio"),
+          exclusiveMode (exclusive),
           hasScanned (false)
     {
     }
@@ -1269,7 +1376,6 @@ public:
     {
         jassert (hasScanned); // need to call scanForDevices() before doing this
 
-        const bool useExclusiveMode = false;
         ScopedPointer<WASAPIAudioIODevice> device;
 
         const int outputIndex = outputDeviceNames.indexOf (outputDeviceName);
@@ -1281,7 +1387,7 @@ public:
                                                                             : inputDeviceName,
                                               outputDeviceIds [outputIndex],
                                               inputDeviceIds [inputIndex],
-                                              useExclusiveMode);
+                                              exclusiveMode);
 
             if (! device->initialise())
                 device = nullptr;
@@ -1295,6 +1401,7 @@ public:
     StringArray inputDeviceNames, inputDeviceIds;
 
 private:
+    const bool exclusiveMode;
     bool hasScanned;
     ComSmartPtr<IMMDeviceEnumerator> enumerator;
 
@@ -1495,10 +1602,10 @@ struct MMDeviceMasterVolume
 }
 
 //==============================================================================
-AudioIODeviceType* AudioIODeviceType::createAudioIODeviceType_WASAPI()
+AudioIODeviceType* AudioIODeviceType::createAudioIODeviceType_WASAPI (bool exclusiveMode)
 {
     if (SystemStats::getOperatingSystemType() >= SystemStats::WinVista)
-        return new WasapiClasses::WASAPIAudioIODeviceType();
+        return new WasapiClasses::WASAPIAudioIODeviceType (exclusiveMode);
 
     return nullptr;
 }
@@ -22,6 +22,39 @@
   ==============================================================================
 */
 
+struct AudioTransportSource::SourceChain
+{
+    SourceChain() noexcept
+        : source (nullptr), resamplerSource (nullptr), bufferingSource (nullptr),
+          positionableSource (nullptr), masterSource (nullptr), sourceSampleRate (0.0),
+          switchPosition (-1), crossfadeSamples (0), nextRetired (nullptr)
+    {
+    }
+
+    ~SourceChain()
+    {
+        if (masterSource != nullptr)
+            masterSource->releaseResources();
+
+        delete resamplerSource;
+        delete bufferingSource;
+    }
+
+    PositionableAudioSource* source;
+    ResamplingAudioSource* resamplerSource;
+    BufferingAudioSource* bufferingSource;
+    PositionableAudioSource* positionableSource;
+    AudioSource* masterSource;
+    double sourceSampleRate;
+
+    int64 switchPosition;
+    int crossfadeSamples;
+    SourceChain* nextRetired;
+
+    JUCE_DECLARE_NON_COPYABLE (SourceChain)
+};
+
+//==============================================================================
 AudioTransportSource::AudioTransportSource()
     : source (nullptr),
       resamplerSource (nullptr),
@@ -29,7 +62,7 @@ AudioTransportSource::AudioTransportSource()
       positionableSource (nullptr),
       masterSource (nullptr),
       gain (1.0f),
-      lastGain (1.0f),
+      smoothedGain (1.0f),
       playing (false),
       stopped (true),
       sampleRate (44100.0),
@@ -37,7 +70,11 @@ AudioTransportSource::AudioTransportSource()
       blockSize (128),
       readAheadBufferSize (0),
       isPrepared (false),
-      inputStreamEOF (false)
+      inputStreamEOF (false),
+      pendingChain (nullptr),
+      outgoingChain (nullptr),
+      crossfadeBuffer (2, 128),
+      crossfadePosition (0)
 {
 }
 
@@ -63,63 +100,183 @@ void AudioTransportSource::setSource (PositionableAudioSource* const newSource,
     }
 
     readAheadBufferSize = readAheadBufferSize_;
-    sourceSampleRate = sourceSampleRateToCorrectFor;
 
-    ResamplingAudioSource* newResamplerSource = nullptr;
-    BufferingAudioSource* newBufferingSource = nullptr;
-    PositionableAudioSource* newPositionableSource = nullptr;
-    AudioSource* newMasterSource = nullptr;
+    SourceChain newChain;
+    createChain (newChain, newSource, readAheadBufferSize_, readAheadThread,
+                 sourceSampleRateToCorrectFor, maxNumChannels);
+
+    ScopedPointer<SourceChain> cancelledChains[3];
+
+    {
+        const ScopedLock sl (callbackLock);
+
+        swapWithCurrentSource (newChain);
+
+        cancelledChains[0] = queuedChain.exchange (nullptr);
+        cancelledChains[1] = pendingChain;
+        cancelledChains[2] = outgoingChain;
+        pendingChain = outgoingChain = nullptr;
+
+        playing = false;
+    }
+
+    deleteRetiredChains();
+    numQueuedSources = 0;
+
+    // (newChain now holds the old source, and will release it when it goes out of scope)
+}
+
+void AudioTransportSource::queueNextSource (PositionableAudioSource* const newSource,
+                                            const int64 switchPosition,
+                                            const int crossfadeSamples,
+                                            int readAheadBufferSize_,
+                                            TimeSliceThread* readAheadThread,
+                                            double sourceSampleRateToCorrectFor,
+                                            int maxNumChannels)
+{
+    if (newSource == nullptr || masterSource == nullptr)
+    {
+        setSource (newSource, readAheadBufferSize_, readAheadThread,
+                   sourceSampleRateToCorrectFor, maxNumChannels);
+        return;
+    }
 
-    ScopedPointer <ResamplingAudioSource> oldResamplerSource (resamplerSource);
-    ScopedPointer <BufferingAudioSource> oldBufferingSource (bufferingSource);
-    AudioSource* oldMasterSource = masterSource;
+    // The same source can't be playing and queued at the same time!
+    jassert (newSource != source);
+
+    SourceChain* const chain = new SourceChain();
+    createChain (*chain, newSource, readAheadBufferSize_, readAheadThread,
+                 sourceSampleRateToCorrectFor, maxNumChannels);
+
+    chain->switchPosition = switchPosition;
+    chain->crossfadeSamples = jmax (0, crossfadeSamples);
+
+    ++numQueuedSources;
+
+    // If the audio thread hadn't yet picked up the previous queued source, it's safe to delete it here
+    if (SourceChain* const replacedChain = queuedChain.exchange (chain))
+    {
+        delete replacedChain;
+        --numQueuedSources;
+    }
+}
+
+void AudioTransportSource::createChain (SourceChain& chain, PositionableAudioSource* const newSource,
+                                        const int readAheadSize, TimeSliceThread* const readAheadThread,
+                                        const double sourceSampleRateToCorrectFor, const int maxNumChannels)
+{
+    chain.source = newSource;
+    chain.sourceSampleRate = sourceSampleRateToCorrectFor;
 
     if (newSource != nullptr)
     {
-        newPositionableSource = newSource;
+        chain.positionableSource = newSource;
 
-        if (readAheadBufferSize_ > 0)
+        if (readAheadSize > 0)
         {
             // If you want to use a read-ahead buffer, you must also provide a TimeSliceThread
             // for it to use!
             jassert (readAheadThread != nullptr);
 
-            newPositionableSource = newBufferingSource
-                = new BufferingAudioSource (newPositionableSource, *readAheadThread,
-                                            false, readAheadBufferSize_, maxNumChannels);
+            chain.positionableSource = chain.bufferingSource
+                = new BufferingAudioSource (chain.positionableSource, *readAheadThread,
+                                            false, readAheadSize, maxNumChannels);
         }
 
-        newPositionableSource->setNextReadPosition (0);
+        chain.positionableSource->setNextReadPosition (0);
 
         if (sourceSampleRateToCorrectFor > 0)
-            newMasterSource = newResamplerSource
-                = new ResamplingAudioSource (newPositionableSource, false, maxNumChannels);
+            chain.masterSource = chain.resamplerSource
+                = new ResamplingAudioSource (chain.positionableSource, false, maxNumChannels);
         else
-            newMasterSource = newPositionableSource;
+            chain.masterSource = chain.positionableSource;
 
         if (isPrepared)
-        {
-            if (newResamplerSource != nullptr && sourceSampleRate > 0 && sampleRate > 0)
-                newResamplerSource->setResamplingRatio (sourceSampleRate / sampleRate);
+            prepareChain (chain);
+    }
+}
 
-            newMasterSource->prepareToPlay (blockSize, sampleRate);
-        }
+void AudioTransportSource::prepareChain (SourceChain& chain)
+{
+    if (chain.resamplerSource != nullptr && chain.sourceSampleRate > 0 && sampleRate > 0)
+        chain.resamplerSource->setResamplingRatio (chain.sourceSampleRate / sampleRate);
+
+    chain.masterSource->prepareToPlay (blockSize, sampleRate);
+}
+
+void AudioTransportSource::swapWithCurrentSource (SourceChain& chain) noexcept
+{
+    std::swap (source, chain.source);
+    std::swap (resamplerSource, chain.resamplerSource);
+    std::swap (bufferingSource, chain.bufferingSource);
+    std::swap (positionableSource, chain.positionableSource);
+    std::swap (masterSource, chain.masterSource);
+    std::swap (sourceSampleRate, chain.sourceSampleRate);
+}
+
+void AudioTransportSource::takeQueuedChain() noexcept
+{
+    if (queuedChain.get() != nullptr)
+    {
+        if (pendingChain != nullptr)
+            retireChain (pendingChain);
+
+        pendingChain = queuedChain.exchange (nullptr);
+    }
+}
+
+void AudioTransportSource::switchToPendingChain() noexcept
+{
+    SourceChain* const oldChain = pendingChain;
+    pendingChain = nullptr;
+
+    swapWithCurrentSource (*oldChain);
+
+    if (oldChain->crossfadeSamples > 0)
+    {
+        if (outgoingChain != nullptr)
+            retireChain (outgoingChain);
+
+        outgoingChain = oldChain;
+        crossfadePosition = 0;
+    }
+    else
+    {
+        retireChain (oldChain);
     }
+}
 
+void AudioTransportSource::retireChain (SourceChain* const chain) noexcept
+{
+    // Chains can't be deleted on the audio thread, so they're passed to the
+    // message thread, which deletes them in handleAsyncUpdate()
+    for (;;)
     {
-        const ScopedLock sl (callbackLock);
+        SourceChain* const head = retiredChains.get();
+        chain->nextRetired = head;
 
-        source = newSource;
-        resamplerSource = newResamplerSource;
-        bufferingSource = newBufferingSource;
-        masterSource = newMasterSource;
-        positionableSource = newPositionableSource;
+        if (retiredChains.compareAndSetBool (chain, head))
+            break;
+    }
 
-        playing = false;
+    triggerAsyncUpdate();
+}
+
+void AudioTransportSource::deleteRetiredChains()
+{
+    for (SourceChain* chain = retiredChains.exchange (nullptr); chain != nullptr;)
+    {
+        SourceChain* const next = chain->nextRetired;
+        delete chain;
+        --numQueuedSources;
+        chain = next;
     }
+}
 
-    if (oldMasterSource != nullptr)
-        oldMasterSource->releaseResources();
+void AudioTransportSource::handleAsyncUpdate()
+{
+    deleteRetiredChains();
+    sendChangeMessage();
 }
 
 void AudioTransportSource::start()
@@ -230,12 +387,22 @@ void AudioTransportSource::prepareToPlay (int samplesPerBlockExpected, double ne
     sampleRate = newSampleRate;
     blockSize = samplesPerBlockExpected;
 
+    smoothedGain.reset (sampleRate, 0.02);
+    smoothedGain.setCurrentAndTargetValue (gain);
+
     if (masterSource != nullptr)
         masterSource->prepareToPlay (samplesPerBlockExpected, sampleRate);
 
     if (resamplerSource != nullptr && sourceSampleRate > 0)
         resamplerSource->setResamplingRatio (sourceSampleRate / sampleRate);
 
+    takeQueuedChain();
+
+    if (pendingChain != nullptr)    prepareChain (*pendingChain);
+    if (outgoingChain != nullptr)   prepareChain (*outgoingChain);
+
+    crossfadeBuffer.setSize (2, samplesPerBlockExpected);
+
     isPrepared = true;
 }
 
@@ -246,6 +413,9 @@ void AudioTransportSource::releaseMasterResources()
     if (masterSource != nullptr)
         masterSource->releaseResources();
 
+    if (pendingChain != nullptr)    pendingChain->masterSource->releaseResources();
+    if (outgoingChain != nullptr)   outgoingChain->masterSource->releaseResources();
+
     isPrepared = false;
 }
 
@@ -260,15 +430,35 @@ void AudioTransportSource::getNextAudioBlock (const AudioSourceChannelInfo& info
 
     inputStreamEOF = false;
 
+    takeQueuedChain();
+
     if (masterSource != nullptr && ! stopped)
     {
-        masterSource->getNextAudioBlock (info);
+        const int samplesBeforeSwitch = playing ? getNumSamplesBeforeSwitch (info.numSamples)
+                                                : info.numSamples;
+
+        if (samplesBeforeSwitch < info.numSamples)
+        {
+            if (samplesBeforeSwitch > 0)
+                masterSource->getNextAudioBlock (AudioSourceChannelInfo (info.buffer, info.startSample, samplesBeforeSwitch));
+
+            switchToPendingChain();
+
+            const AudioSourceChannelInfo afterSwitch (info.buffer, info.startSample + samplesBeforeSwitch,
+                                                      info.numSamples - samplesBeforeSwitch);
+            masterSource->getNextAudioBlock (afterSwitch);
+            addOutgoingChain (afterSwitch);
+        }
+        else
+        {
+            masterSource->getNextAudioBlock (info);
+            addOutgoingChain (info);
+        }
 
         if (! playing)
         {
             // just stopped playing, so fade out the last block..
-            for (int i = info.buffer->getNumChannels(); --i >= 0;)
-                info.buffer->applyGainRamp (i, info.startSample, jmin (256, info.numSamples), 1.0f, 0.0f);
+            info.buffer->applyGainRamp (info.startSample, jmin (256, info.numSamples), 1.0f, 0.0f);
 
             if (info.numSamples > 256)
                 info.buffer->clear (info.startSample + 256, info.numSamples - 256);
@@ -284,17 +474,57 @@ void AudioTransportSource::getNextAudioBlock (const AudioSourceChannelInfo& info
 
         stopped = ! playing;
 
-        for (int i = info.buffer->getNumChannels(); --i >= 0;)
-        {
-            info.buffer->applyGainRamp (i, info.startSample, info.numSamples,
-                                        lastGain, gain);
-        }
+        smoothedGain.setValue (gain);
+        smoothedGain.applyGain (*info.buffer, info.startSample, info.numSamples);
     }
     else
     {
         info.clearActiveBufferRegion();
         stopped = true;
+
+        smoothedGain.setCurrentAndTargetValue (gain);
     }
+}
+
+int AudioTransportSource::getNumSamplesBeforeSwitch (const int numSamples) const
+{
+    if (pendingChain == nullptr)
+        return numSamples;
+
+    int64 switchPosition = pendingChain->switchPosition;
 
-    lastGain = gain;
+    if (switchPosition < 0)
+        switchPosition = jmax ((int64) 0, getTotalLength() - pendingChain->crossfadeSamples);
+
+    return (int) jlimit ((int64) 0, (int64) numSamples, switchPosition - getNextReadPosition());
+}
+
+void AudioTransportSource::addOutgoingChain (const AudioSourceChannelInfo& info)
+{
+    if (outgoingChain == nullptr)
+        return;
+
+    const int fadeLength = outgoingChain->crossfadeSamples;
+    const int numToFade = jmin (info.numSamples, fadeLength - crossfadePosition);
+    const int numChannels = info.buffer->getNumChannels();
+
+    crossfadeBuffer.setSize (numChannels, numToFade, false, false, true);
+    outgoingChain->masterSource->getNextAudioBlock (AudioSourceChannelInfo (crossfadeBuffer));
+
+    const float startGain = crossfadePosition / (float) fadeLength;
+    const float endGain = (crossfadePosition + numToFade) / (float) fadeLength;
+
+    info.buffer->applyGainRamp (info.startSample, numToFade, startGain, endGain);
+
+    for (int i = 0; i < numChannels; ++i)
+        info.buffer->addFromWithRamp (i, info.startSample, crossfadeBuffer.getSampleData (i),
+                                      numToFade, 1.0f - startGain, 1.0f - endGain);
+
+    crossfadePosition += numToFade;
+
+    if (crossfadePosition >= fadeLength)
+    {
+        retireChain (outgoingChain);
+        outgoingChain = nullptr;
+    }
 }
@@ -37,10 +37,14 @@
     You may want to use one of these along with an AudioSourcePlayer and AudioIODevice
     to control playback of an audio file.
 
+    To play a series of sources back-to-back, use queueNextSource() to have the
+    transport switch to the next one without stopping.
+
     @see AudioSource, AudioSourcePlayer
 */
 class JUCE_API  AudioTransportSource  : public PositionableAudioSource,
-                                        public ChangeBroadcaster
+                                        public ChangeBroadcaster,
+                                        private AsyncUpdater
 {
 public:
     //==============================================================================
@@ -83,6 +87,49 @@ public:
                     double sourceSampleRateToCorrectFor = 0.0,
                     int maxNumChannels = 2);
 
+    /** Queues up a source to follow on from the current one without a gap.
+
+        Unlike setSource(), this doesn't stop playback, and never makes the audio thread
+        wait. The new source (and its read-ahead buffer, if it has one) is set up on the
+        calling thread, and the audio callback switches over to it at the given position,
+        optionally crossfading from the old source into the new one.
+
+        Only one source can be queued at a time: queueing another one replaces it, and
+        calling setSource() cancels it. The old source carries on being used until the
+        switch and crossfade have finished, so it mustn't be deleted until
+        isSwitchingSource() returns false. A change message is sent when this happens.
+
+        If there's no current source, or newSource is null, this just calls setSource().
+
+        @param newSource            the source to play next. As with setSource(), this object
+                                    won't delete it
+        @param switchPosition       the position in the current source at which the new one
+                                    should start, in samples at the transport's sample rate. If
+                                    this is negative, it'll start when the current source ends
+                                    (which will never happen if it's looping)
+        @param crossfadeSamples     the number of samples over which to fade from the old source
+                                    into the new one. If the switch happens at the end of the
+                                    current source, the crossfade is timed to finish there
+        @param readAheadBufferSize              see setSource()
+        @param readAheadThread                  see setSource()
+        @param sourceSampleRateToCorrectFor     see setSource()
+        @param maxNumChannels                   see setSource()
+        @see setSource, isSwitchingSource
+    */
+    void queueNextSource (PositionableAudioSource* newSource,
+                          int64 switchPosition = -1,
+                          int crossfadeSamples = 0,
+                          int readAheadBufferSize = 0,
+                          TimeSliceThread* readAheadThread = nullptr,
+                          double sourceSampleRateToCorrectFor = 0.0,
+                          int maxNumChannels = 2);
+
+    /** Returns true if a queued source is waiting to start, or if the previous source is
+        still being used for a crossfade.
+        @see queueNextSource
+    */
+    bool isSwitchingSource() const noexcept             { return numQueuedSources.get() != 0; }
+
     //==============================================================================
     /** Changes the current playback position in the source stream.
 
@@ -127,6 +174,9 @@ public:
     //==============================================================================
     /** Changes the gain to apply to the output.
 
+        Rather than jumping straight to the new gain, the output glides to it over
+        about 20 milliseconds, to avoid clicks.
+
         @param newGain  a factor by which to multiply the outgoing samples,
                         so 1.0 = 0dB, 0.5 = -6dB, 2.0 = 6dB, etc.
     */
@@ -171,13 +221,33 @@ private:
     AudioSource* masterSource;
 
     CriticalSection callbackLock;
-    float volatile gain, lastGain;
+    float volatile gain;
+    LinearSmoothedValue smoothedGain;
     bool volatile playing, stopped;
     double sampleRate, sourceSampleRate;
     int blockSize, readAheadBufferSize;
     bool isPrepared, inputStreamEOF;
 
+    struct SourceChain;
+    Atomic<SourceChain*> queuedChain, retiredChains;
+    Atomic<int> numQueuedSources;
+    SourceChain* pendingChain;
+    SourceChain* outgoingChain;
+    AudioSampleBuffer crossfadeBuffer;
+    int crossfadePosition;
+
     void releaseMasterResources();
+    void createChain (SourceChain&, PositionableAudioSource*, int readAheadSize,
+                      TimeSliceThread*, double sourceSampleRateToCorrectFor, int maxNumChannels);
+    void prepareChain (SourceChain&);
+    void swapWithCurrentSource (SourceChain&) noexcept;
+    void takeQueuedChain() noexcept;
+    void switchToPendingChain() noexcept;
+    void retireChain (SourceChain*) noexcept;
+    void deleteRetiredChains();
+    int getNumSamplesBeforeSwitch (int numSamples) const;
+    void addOutgoingChain (const AudioSourceChannelInfo&);
+    void handleAsyncUpdate();
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioTransportSource)
 };
@@ -794,8 +794,8 @@ class MemoryMappedAiffReader   : public MemoryMappedAudioFormatReader
 public:
     MemoryMappedAiffReader (const File& file, const AiffAudioFormatReader& reader)
         : MemoryMappedAudioFormatReader (file, reader, reader.dataChunkStart,
-                                         reader.bytesPerFrame * reader.lengthInSamples, reader.bytesPerFrame),
-          littleEndian (reader.littleEndian)
+                                         reader.bytesPerFrame * reader.lengthInSamples, reader.bytesPerFrame,
+                                         reader.littleEndian)
     {
     }
 
@@ -851,8 +851,34 @@ public:
         }
     }
 
+protected:
+    bool convertMappedSamplesToFloat (float* const* destSamples, int numDestChannels, int startOffsetInDestBuffer,
+                                      int64 startSampleInFile, int numSamples) const
+    {
+        if (littleEndian)
+            return convertToFloat<AudioData::LittleEndian> (destSamples, numDestChannels, startOffsetInDestBuffer, startSampleInFile, numSamples);
+
+        return convertToFloat<AudioData::BigEndian> (destSamples, numDestChannels, startOffsetInDestBuffer, startSampleInFile, numSamples);
+    }
+
 private:
-    const bool littleEndian;
+    template <typename Endianness>
+    bool convertToFloat (float* const* destSamples, int numDestChannels, int startOffsetInDestBuffer,
+                         int64 startSampleInFile, int numSamples) const
+    {
+        const void* const sourceData = sampleToPointer (startSampleInFile);
+
+        switch (bitsPerSample)
+        {
+            case 8:     ReadHelper<AudioData::Float32, AudioData::Int8,  Endianness>::read (destSamples, startOffsetInDestBuffer, numDestChannels, sourceData, (int) numChannels, numSamples); return true;
+            case 16:    ReadHelper<AudioData::Float32, AudioData::Int16, Endianness>::read (destSamples, startOffsetInDestBuffer, numDestChannels, sourceData, (int) numChannels, numSamples); return true;
+            case 24:    ReadHelper<AudioData::Float32, AudioData::Int24, Endianness>::read (destSamples, startOffsetInDestBuffer, numDestChannels, sourceData, (int) numChannels, numSamples); return true;
+            case 32:    if (usesFloatingPointData) ReadHelper<AudioData::Float32, AudioData::Float32, Endianness>::read (destSamples, startOffsetInDestBuffer, numDestChannels, sourceData, (int) numChannels, numSamples);
+                        else                       ReadHelper<AudioData::Float32, AudioData::Int32,   Endianness>::read (destSamples, startOffsetInDestBuffer, numDestChannels, sourceData, (int) numChannels, numSamples);
+                        return true;
+            default:    return false;
+        }
+    }
 
     template <typename SampleType>
     void scanMinAndMax (int64 startSampleInFile, int64 numSamples,
@@ -903,6 +929,17 @@ Array<int> AiffAudioFormat::getPossibleBitDepths()
 bool AiffAudioFormat::canDoStereo() { return true; }
 bool AiffAudioFormat::canDoMono()   { return true; }
 
+bool AiffAudioFormat::canHandleData (const void* data, int numBytes)
+{
+    if (numBytes < 12)
+        return true;
+
+    const char* const d = static_cast<const char*> (data);
+
+    return memcmp (d, "FORM", 4) == 0
+             && (memcmp (d + 8, "AIFF", 4) == 0 || memcmp (d + 8, "AIFC", 4) == 0);
+}
+
 #if JUCE_MAC
 bool AiffAudioFormat::canHandleFile (const File& f)
 {
@@ -61,6 +61,7 @@ public:
     Array<int> getPossibleBitDepths();
     bool canDoStereo();
     bool canDoMono();
+    bool canHandleData (const void* firstBytesOfStream, int numBytes);
 
    #if JUCE_MAC
     bool canHandleFile (const File& fileToTest);
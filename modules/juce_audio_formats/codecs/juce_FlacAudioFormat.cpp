@@ -125,6 +125,8 @@ public:
                 FLAC__stream_decoder_process_until_end_of_metadata (decoder);
                 lengthInSamples = tempLength;
             }
+
+            blockCacheKey = AudioFormatReaderBlockCache::getKeyForStream (input, getFormatName());
         }
     }
 
@@ -320,17 +322,7 @@ public:
     {
         using namespace FlacNamespace;
         encoder = FLAC__stream_encoder_new();
-
-        if (qualityOptionIndex > 0)
-            FLAC__stream_encoder_set_compression_level (encoder, (uint32) jmin (8, qualityOptionIndex));
-
-        FLAC__stream_encoder_set_do_mid_side_stereo (encoder, numChannels == 2);
-        FLAC__stream_encoder_set_loose_mid_side_stereo (encoder, numChannels == 2);
-        FLAC__stream_encoder_set_channels (encoder, numChannels);
-        FLAC__stream_encoder_set_bits_per_sample (encoder, jmin ((unsigned int) 24, bitsPerSample));
-        FLAC__stream_encoder_set_sample_rate (encoder, (unsigned int) sampleRate);
-        FLAC__stream_encoder_set_blocksize (encoder, 0);
-        FLAC__stream_encoder_set_do_escape_coding (encoder, true);
+        setUpEncoder (encoder, sampleRate, numChannels, bitsPerSample, qualityOptionIndex);
 
         ok = FLAC__stream_encoder_init_stream (encoder,
                                                encodeWriteCallback, encodeSeekCallback,
@@ -404,10 +396,32 @@ public:
         }
     }
 
+    static void setUpEncoder (FlacNamespace::FLAC__StreamEncoder* const encoder, const double rate,
+                              const uint32 numChans, const uint32 bits, const int qualityOptionIndex)
+    {
+        using namespace FlacNamespace;
+
+        if (qualityOptionIndex > 0)
+            FLAC__stream_encoder_set_compression_level (encoder, (uint32) jmin (8, qualityOptionIndex));
+
+        FLAC__stream_encoder_set_do_mid_side_stereo (encoder, numChans == 2);
+        FLAC__stream_encoder_set_loose_mid_side_stereo (encoder, numChans == 2);
+        FLAC__stream_encoder_set_channels (encoder, numChans);
+        FLAC__stream_encoder_set_bits_per_sample (encoder, jmin ((unsigned int) 24, bits));
+        FLAC__stream_encoder_set_sample_rate (encoder, (unsigned int) rate);
+        FLAC__stream_encoder_set_blocksize (encoder, 0);
+        FLAC__stream_encoder_set_do_escape_coding (encoder, true);
+    }
+
     void writeMetaData (const FlacNamespace::FLAC__StreamMetadata* metadata)
+    {
+        writeStreamInfo (*output, metadata->data.stream_info);
+    }
+
+    // Overwrites the STREAMINFO block at the start of the stream
+    static void writeStreamInfo (OutputStream& out, const FlacNamespace::FLAC__StreamMetadata_StreamInfo& info)
     {
         using namespace FlacNamespace;
-        const FLAC__StreamMetadata_StreamInfo& info = metadata->data.stream_info;
 
         unsigned char buffer [FLAC__STREAM_METADATA_STREAMINFO_LENGTH];
         const unsigned int channelsMinus1 = info.channels - 1;
@@ -424,15 +438,15 @@ public:
         packUint32 ((FLAC__uint32) info.total_samples, buffer + 14, 4);
         memcpy (buffer + 18, info.md5sum, 16);
 
-        const bool seekOk = output->setPosition (4);
+        const bool seekOk = out.setPosition (4);
         (void) seekOk;
 
         // if this fails, you've given it an output stream that can't seek! It needs
         // to be able to seek back to write the header
         jassert (seekOk);
 
-        output->writeIntBigEndian (FLAC__STREAM_METADATA_STREAMINFO_LENGTH);
-        output->write (buffer, FLAC__STREAM_METADATA_STREAMINFO_LENGTH);
+        out.writeIntBigEndian (FLAC__STREAM_METADATA_STREAMINFO_LENGTH);
+        out.write (buffer, FLAC__STREAM_METADATA_STREAMINFO_LENGTH);
     }
 
     //==============================================================================
@@ -478,6 +492,455 @@ private:
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FlacWriter)
 };
 
+//==============================================================================
+/*  FLAC frames that use a fixed block size have their frame number in the header, so when
+    separate encoders have done different parts of a stream, their frames need to be
+    renumbered, and the two CRCs that cover the header need recalculating.
+
+    The CRC-16 covers the whole frame, but because a CRC is linear, the new one can be
+    worked out from the old one and the difference between the headers, without having
+    to go through the rest of the frame again.
+*/
+namespace FlacFrameRenumbering
+{
+    struct CRCTables
+    {
+        CRCTables() noexcept
+        {
+            for (int i = 0; i < 256; ++i)
+            {
+                uint32 crc8 = (uint32) i, crc16 = (uint32) i << 8;
+
+                for (int bit = 0; bit < 8; ++bit)
+                {
+                    crc8  = (crc8  & 0x80)   != 0 ? (crc8  << 1) ^ 0x07   : (crc8  << 1);
+                    crc16 = (crc16 & 0x8000) != 0 ? (crc16 << 1) ^ 0x8005 : (crc16 << 1);
+                }
+
+                crc8Table[i]  = (uint8)  crc8;
+                crc16Table[i] = (uint16) crc16;
+            }
+        }
+
+        uint8 crc8 (const uint8* data, size_t num) const noexcept
+        {
+            uint8 crc = 0;
+
+            while (num-- > 0)
+                crc = crc8Table [crc ^ *data++];
+
+            return crc;
+        }
+
+        uint16 crc16 (const uint8* data, size_t num) const noexcept
+        {
+            uint16 crc = 0;
+
+            while (num-- > 0)
+                crc = (uint16) ((crc << 8) ^ crc16Table [(crc >> 8) ^ *data++]);
+
+            return crc;
+        }
+
+        // Returns (a * b) mod the CRC-16 polynomial
+        static uint16 multiply (const uint16 a, const uint16 b) noexcept
+        {
+            uint32 result = 0;
+
+            for (int bit = 16; --bit >= 0;)
+            {
+                result = (result & 0x8000) != 0 ? ((result << 1) ^ 0x8005) : (result << 1);
+
+                if ((b & (1 << bit)) != 0)
+                    result ^= a;
+            }
+
+            return (uint16) result;
+        }
+
+        // Returns the CRC-16 that you'd get by appending this many zero bytes to a message
+        static uint16 appendZeros (const uint16 crc, size_t numBytes) noexcept
+        {
+            uint16 shift = 1, power = 0x100;
+
+            for (; numBytes > 0; numBytes >>= 1)
+            {
+                if ((numBytes & 1) != 0)
+                    shift = multiply (shift, power);
+
+                power = multiply (power, power);
+            }
+
+            return multiply (crc, shift);
+        }
+
+        uint8 crc8Table [256];
+        uint16 crc16Table [256];
+    };
+
+    static const CRCTables crcTables;
+
+    // Returns the length of the UTF-8-style coded number that begins with this byte
+    static int getCodedNumberLength (const uint8 firstByte) noexcept
+    {
+        if (firstByte < 0x80)  return 1;
+        if (firstByte < 0xe0)  return 2;
+        if (firstByte < 0xf0)  return 3;
+        if (firstByte < 0xf8)  return 4;
+        if (firstByte < 0xfc)  return 5;
+        return 6;
+    }
+
+    static int writeCodedNumber (uint8* const dest, const uint32 value) noexcept
+    {
+        if (value < 0x80)
+        {
+            dest[0] = (uint8) value;
+            return 1;
+        }
+
+        const int numBytes = value < 0x800 ? 2 : value < 0x10000 ? 3 : value < 0x200000 ? 4 : value < 0x4000000 ? 5 : 6;
+        uint32 v = value;
+
+        for (int i = numBytes; --i > 0;)
+        {
+            dest[i] = (uint8) (0x80 | (v & 0x3f));
+            v >>= 6;
+        }
+
+        dest[0] = (uint8) ((0xff00 >> numBytes) | v);
+        return numBytes;
+    }
+
+    /*  Writes a copy of a fixed-block-size frame with a new frame number. Returns false if
+        the frame doesn't look like something that libFLAC would have produced.
+    */
+    static bool writeFrame (OutputStream& out, const uint8* const frame, const size_t size, const uint32 newFrameNumber)
+    {
+        if (size < 8 || frame[0] != 0xff || frame[1] != 0xf8)
+            return false;
+
+        const int blockSizeCode  = frame[2] >> 4;
+        const int sampleRateCode = frame[2] & 15;
+        const int numExtraBytes = (blockSizeCode == 6 ? 1 : (blockSizeCode == 7 ? 2 : 0))
+                                    + (sampleRateCode == 12 ? 1 : (sampleRateCode == 13 || sampleRateCode == 14 ? 2 : 0));
+
+        const size_t oldHeaderSize = 4 + (size_t) getCodedNumberLength (frame[4]) + (size_t) numExtraBytes;
+
+        if (oldHeaderSize + 3 > size)
+            return false;
+
+        uint8 header [16];
+        memcpy (header, frame, 4);
+        const size_t numberLength = (size_t) writeCodedNumber (header + 4, newFrameNumber);
+        memcpy (header + 4 + numberLength, frame + oldHeaderSize - (size_t) numExtraBytes, (size_t) numExtraBytes);
+
+        const size_t headerSize = 4 + numberLength + (size_t) numExtraBytes;
+        header [headerSize] = crcTables.crc8 (header, headerSize);
+
+        const uint8* const body = frame + oldHeaderSize + 1;
+        const size_t bodySize = size - (oldHeaderSize + 1) - 2;
+        const uint16 headerDifference = crcTables.crc16 (frame, oldHeaderSize + 1) ^ crcTables.crc16 (header, headerSize + 1);
+        const uint16 oldCRC = (uint16) ((frame [size - 2] << 8) | frame [size - 1]);
+        const uint16 crc = oldCRC ^ CRCTables::appendZeros (headerDifference, bodySize);
+
+        const uint8 footer[] = { (uint8) (crc >> 8), (uint8) crc };
+
+        return out.write (header, headerSize + 1)
+                && out.write (body, bodySize)
+                && out.write (footer, sizeof (footer));
+    }
+}
+
+#if JUCE_INCLUDE_FLAC_CODE || ! defined (JUCE_INCLUDE_FLAC_CODE)
+ #define JUCE_FLAC_WRITER_CALCULATES_MD5 1  // (libFLAC's MD5 functions are only available when it's built-in)
+#endif
+
+//==============================================================================
+/*  Encodes the stream in chunks of whole blocks, each of which is given to a ThreadPool
+    job with its own libFLAC encoder. As the chunks finish, their frames are written out
+    in order, with their frame numbers changed to follow on from the previous chunk.
+*/
+class FlacParallelWriter  : public AudioFormatWriter
+{
+public:
+    //==============================================================================
+    FlacParallelWriter (OutputStream* const out, double sampleRate_, uint32 numChannels_,
+                        uint32 bitsPerSample_, const int qualityOptionIndex_, ThreadPool& pool)
+        : AudioFormatWriter (out, TRANS (flacFormatName), sampleRate_, numChannels_, bitsPerSample_),
+          threadPool (pool), qualityOptionIndex (qualityOptionIndex_),
+          blockSize (0), samplesPerChunk (0), nextFrameNumber (0), totalSamples (0),
+          minFrameSize (0), maxFrameSize (0),
+          maxChunksInProgress (jmax (2, SystemStats::getNumCpus() * 2)),
+          failed (false)
+    {
+        using namespace FlacNamespace;
+
+        // (this is the block size that libFLAC would pick for this quality setting)
+        FLAC__StreamEncoder* const encoder = FLAC__stream_encoder_new();
+        FlacWriter::setUpEncoder (encoder, sampleRate, numChannels, bitsPerSample, qualityOptionIndex);
+        blockSize = FLAC__stream_encoder_get_max_lpc_order (encoder) == 0 ? 1152 : 4096;
+        FLAC__stream_encoder_delete (encoder);
+
+        samplesPerChunk = blockSize * blocksPerChunk;
+
+       #if JUCE_FLAC_WRITER_CALCULATES_MD5
+        FLAC__MD5Init (&md5Context);
+       #endif
+
+        currentChunk = new EncoderJob (*this, 0, true);
+        ok = currentChunk->ok;
+    }
+
+    ~FlacParallelWriter()
+    {
+        if (ok)
+        {
+            if (currentChunk->numSamples > 0 || nextFrameNumber == 0)
+                startEncodingCurrentChunk();
+
+            writeFinishedChunks (0);
+
+            if (! failed)
+                writeStreamInfo();
+
+            output->flush();
+        }
+        else
+        {
+            output = nullptr; // to stop the base class deleting this, as it needs to be returned
+                              // to the caller of createWriterFor()
+        }
+    }
+
+    //==============================================================================
+    bool write (const int** samplesToWrite, int numSamples)
+    {
+        if (! ok)
+            return false;
+
+        int offset = 0;
+
+        while (numSamples > 0 && ! failed)
+        {
+            const int numToAdd = jmin (numSamples, samplesPerChunk - currentChunk->numSamples);
+            addToCurrentChunk (samplesToWrite, offset, numToAdd);
+            offset += numToAdd;
+            numSamples -= numToAdd;
+
+            if (currentChunk->numSamples == samplesPerChunk)
+            {
+                startEncodingCurrentChunk();
+                writeFinishedChunks (maxChunksInProgress);
+
+                if (! failed)
+                    currentChunk = new EncoderJob (*this, nextFrameNumber, false);
+            }
+        }
+
+        return ! failed;
+    }
+
+    bool ok;
+
+private:
+    //==============================================================================
+    class EncoderJob  : public ThreadPoolJob
+    {
+    public:
+        EncoderJob (FlacParallelWriter& w, const int64 firstFrame, const bool writeMetadataBlocks)
+            : ThreadPoolJob ("FLAC encoder"), numSamples (0),
+              firstFrameNumber (firstFrame), keepMetadata (writeMetadataBlocks)
+        {
+            using namespace FlacNamespace;
+
+            samples.malloc (w.numChannels * (size_t) w.samplesPerChunk);
+
+            for (uint32 i = 0; i < w.numChannels; ++i)
+                channels.add (samples + i * (size_t) w.samplesPerChunk);
+
+            encoder = FLAC__stream_encoder_new();
+            FlacWriter::setUpEncoder (encoder, w.sampleRate, w.numChannels, w.bitsPerSample, w.qualityOptionIndex);
+            FLAC__stream_encoder_set_blocksize (encoder, (unsigned int) w.blockSize);
+            FLAC__stream_encoder_set_do_md5 (encoder, false);
+
+            ok = FLAC__stream_encoder_init_stream (encoder, encodeWriteCallback, nullptr, nullptr, nullptr, this)
+                    == FLAC__STREAM_ENCODER_INIT_STATUS_OK;
+        }
+
+        ~EncoderJob()
+        {
+            FlacNamespace::FLAC__stream_encoder_delete (encoder);
+        }
+
+        JobStatus runJob()
+        {
+            using namespace FlacNamespace;
+
+            ok = FLAC__stream_encoder_process (encoder, (const FLAC__int32**) channels.getRawDataPointer(), (unsigned int) numSamples) != 0
+                   && FLAC__stream_encoder_finish (encoder) != 0
+                   && ok;
+
+            samples.free();
+            return jobHasFinished;
+        }
+
+        HeapBlock<int> samples;
+        Array<int*> channels;
+        int numSamples;
+        MemoryOutputStream encodedData;
+        Array<int> frameSizes;
+        bool ok;
+
+    private:
+        FlacNamespace::FLAC__StreamEncoder* encoder;
+        const int64 firstFrameNumber;
+        const bool keepMetadata;
+
+        void addFrame (const uint8* const frame, const size_t size, const int64 frameNumber)
+        {
+            const size_t startPos = encodedData.getDataSize();
+
+            if (firstFrameNumber == 0)
+                encodedData.write (frame, size);
+            else if (! FlacFrameRenumbering::writeFrame (encodedData, frame, size, (uint32) (firstFrameNumber + frameNumber)))
+                ok = false;
+
+            frameSizes.add ((int) (encodedData.getDataSize() - startPos));
+        }
+
+        static FlacNamespace::FLAC__StreamEncoderWriteStatus encodeWriteCallback (const FlacNamespace::FLAC__StreamEncoder*,
+                                                                                  const FlacNamespace::FLAC__byte buffer[],
+                                                                                  size_t bytes,
+                                                                                  unsigned int samples,
+                                                                                  unsigned int currentFrame,
+                                                                                  void* client_data)
+        {
+            using namespace FlacNamespace;
+            EncoderJob* const job = static_cast <EncoderJob*> (client_data);
+
+            if (samples > 0)
+                job->addFrame (buffer, bytes, (int64) currentFrame);
+            else if (job->keepMetadata)
+                job->encodedData.write (buffer, bytes);
+
+            return FLAC__STREAM_ENCODER_WRITE_STATUS_OK;
+        }
+
+        JUCE_DECLARE_NON_COPYABLE (EncoderJob)
+    };
+
+    //==============================================================================
+    enum { blocksPerChunk = 32 };
+
+    ThreadPool& threadPool;
+    const int qualityOptionIndex;
+    int blockSize, samplesPerChunk;
+    ScopedPointer<EncoderJob> currentChunk;
+    OwnedArray<EncoderJob> chunksInProgress;
+    int64 nextFrameNumber, totalSamples;
+    int minFrameSize, maxFrameSize;
+    const int maxChunksInProgress;
+    bool failed;
+
+   #if JUCE_FLAC_WRITER_CALCULATES_MD5
+    FlacNamespace::FLAC__MD5Context md5Context;
+   #endif
+
+    void addToCurrentChunk (const int** samplesToWrite, const int offset, const int num)
+    {
+        const int bitsToShift = 32 - (int) bitsPerSample;
+        const int start = currentChunk->numSamples;
+
+        for (uint32 i = 0; i < numChannels; ++i)
+        {
+            int* const dest = currentChunk->channels.getUnchecked ((int) i) + start;
+            const int* const src = samplesToWrite[i];
+
+            if (src == nullptr)
+                zeromem (dest, sizeof (int) * (size_t) num);
+            else
+                for (int j = 0; j < num; ++j)
+                    dest[j] = (src[offset + j] >> bitsToShift);
+        }
+
+       #if JUCE_FLAC_WRITER_CALCULATES_MD5
+        HeapBlock<const FlacNamespace::FLAC__int32*> channelStarts (numChannels);
+
+        for (uint32 i = 0; i < numChannels; ++i)
+            channelStarts[i] = currentChunk->channels.getUnchecked ((int) i) + start;
+
+        FlacNamespace::FLAC__MD5Accumulate (&md5Context, channelStarts, numChannels, (unsigned int) num, (bitsPerSample + 7) / 8);
+       #endif
+
+        currentChunk->numSamples += num;
+        totalSamples += num;
+    }
+
+    void startEncodingCurrentChunk()
+    {
+        nextFrameNumber += (currentChunk->numSamples + blockSize - 1) / blockSize;
+        threadPool.addJob (currentChunk, false);
+        chunksInProgress.add (currentChunk.release());
+    }
+
+    // Writes out the finished chunks from the front of the queue, and waits until no
+    // more than the given number are still unwritten.
+    void writeFinishedChunks (const int maxChunksLeft)
+    {
+        while (chunksInProgress.size() > 0)
+        {
+            EncoderJob* const chunk = chunksInProgress.getFirst();
+
+            if (! threadPool.waitForJobToFinish (chunk, chunksInProgress.size() > maxChunksLeft ? -1 : 0))
+                break;
+
+            if (chunk->ok && ! failed)
+            {
+                for (int i = 0; i < chunk->frameSizes.size(); ++i)
+                {
+                    const int size = chunk->frameSizes.getUnchecked (i);
+                    minFrameSize = (minFrameSize == 0) ? size : jmin (minFrameSize, size);
+                    maxFrameSize = jmax (maxFrameSize, size);
+                }
+
+                failed = ! output->write (chunk->encodedData.getData(), chunk->encodedData.getDataSize());
+            }
+            else
+            {
+                failed = true;
+            }
+
+            chunksInProgress.remove (0);
+        }
+    }
+
+    void writeStreamInfo()
+    {
+        using namespace FlacNamespace;
+
+        FLAC__StreamMetadata_StreamInfo info;
+        zerostruct (info);
+        info.min_blocksize = info.max_blocksize = (unsigned int) blockSize;
+        info.min_framesize = (unsigned int) minFrameSize;
+        info.max_framesize = (unsigned int) maxFrameSize;
+        info.sample_rate = (unsigned int) sampleRate;
+        info.channels = numChannels;
+        info.bits_per_sample = jmin ((unsigned int) 24, bitsPerSample);
+        info.total_samples = (FLAC__uint64) totalSamples;
+
+       #if JUCE_FLAC_WRITER_CALCULATES_MD5
+        FLAC__MD5Final (info.md5sum, &md5Context);
+       #endif
+
+        FlacWriter::writeStreamInfo (*output, info);
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FlacParallelWriter)
+};
+
+#undef JUCE_FLAC_WRITER_CALCULATES_MD5
+
 
 //==============================================================================
 FlacAudioFormat::FlacAudioFormat()
@@ -506,6 +969,16 @@ Array<int> FlacAudioFormat::getPossibleBitDepths()
 
 bool FlacAudioFormat::canDoStereo()     { return true; }
 bool FlacAudioFormat::canDoMono()       { return true; }
+
+bool FlacAudioFormat::canHandleData (const void* data, int numBytes)
+{
+    if (numBytes < 4)
+        return true;
+
+    // (libFLAC will skip an ID3v2 tag at the start of the file, so that's allowed too)
+    return memcmp (data, "fLaC", 4) == 0
+            || memcmp (data, "ID3", 3) == 0;
+}
 bool FlacAudioFormat::isCompressed()    { return true; }
 
 AudioFormatReader* FlacAudioFormat::createReaderFor (InputStream* in, const bool deleteStreamIfOpeningFails)
@@ -539,6 +1012,24 @@ AudioFormatWriter* FlacAudioFormat::createWriterFor (OutputStream* out,
     return nullptr;
 }
 
+AudioFormatWriter* FlacAudioFormat::createWriterFor (OutputStream* out,
+                                                     double sampleRate,
+                                                     unsigned int numberOfChannels,
+                                                     int bitsPerSample,
+                                                     int qualityOptionIndex,
+                                                     ThreadPool& threadPool)
+{
+    if (getPossibleBitDepths().contains (bitsPerSample))
+    {
+        ScopedPointer<FlacParallelWriter> w (new FlacParallelWriter (out, sampleRate, numberOfChannels,
+                                                                     (uint32) bitsPerSample, qualityOptionIndex, threadPool));
+        if (w->ok)
+            return w.release();
+    }
+
+    return nullptr;
+}
+
 StringArray FlacAudioFormat::getQualityOptions()
 {
     const char* options[] = { "0 (Fastest)", "1", "2", "3", "4", "5 (Default)","6", "7", "8 (Highest quality)", 0 };
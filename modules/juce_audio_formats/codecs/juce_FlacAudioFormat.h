@@ -45,6 +45,7 @@ public:
     bool canDoStereo();
     bool canDoMono();
     bool isCompressed();
+    bool canHandleData (const void* firstBytesOfStream, int numBytes);
     StringArray getQualityOptions();
 
     //==============================================================================
@@ -57,6 +58,27 @@ public:
                                         int bitsPerSample,
                                         const StringPairArray& metadataValues,
                                         int qualityOptionIndex);
+
+    /** Creates a writer that shares the encoding out between the threads of a ThreadPool.
+
+        The incoming audio is split into chunks of several FLAC blocks, and each chunk is
+        encoded by a ThreadPoolJob, so a long file can be encoded on as many cores as the
+        pool has threads. The frames are still written to the stream in order, but the
+        writer keeps a few chunks queued, so it'll use more memory than a normal writer.
+        The file that's produced is a normal FLAC file, although it won't quite be
+        byte-for-byte identical to the one that the normal writer would create.
+
+        The stream must be seekable, because the STREAMINFO block at the start is filled in
+        when the writer is deleted. The ThreadPool must not be deleted before the writer,
+        and the writer shouldn't be used from inside one of that pool's own jobs.
+    */
+    AudioFormatWriter* createWriterFor (OutputStream* streamToWriteTo,
+                                        double sampleRateToUse,
+                                        unsigned int numberOfChannels,
+                                        int bitsPerSample,
+                                        int qualityOptionIndex,
+                                        ThreadPool& threadPool);
+
 private:
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FlacAudioFormat)
 };
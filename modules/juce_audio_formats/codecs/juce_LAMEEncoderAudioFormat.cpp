@@ -138,6 +138,295 @@ private:
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Writer)
 };
 
+//==============================================================================
+/*  Loads the libmp3lame shared library, and holds pointers to the functions that
+    LibraryWriter uses. It's reference-counted because writers can outlive the
+    format that created them.
+*/
+class LAMEEncoderAudioFormat::LAMELibrary  : public ReferenceCountedObject
+{
+public:
+    struct GlobalFlags;  // opaque lame_global_flags
+    typedef ReferenceCountedObjectPtr<LAMELibrary> Ptr;
+
+    LAMELibrary()
+        : init (nullptr), setInSampleRate (nullptr), setNumChannels (nullptr), setMode (nullptr),
+          setVBR (nullptr), setVBRQuality (nullptr), setBitrate (nullptr), initParams (nullptr),
+          encodeBufferInt (nullptr), encodeFlush (nullptr), getLameTagFrame (nullptr), close (nullptr),
+          id3Init (nullptr), id3SetTitle (nullptr), id3SetArtist (nullptr), id3SetAlbum (nullptr),
+          id3SetComment (nullptr), id3SetYear (nullptr), id3SetGenre (nullptr), id3SetTrack (nullptr)
+    {
+    }
+
+    bool load (const String& libraryName)
+    {
+        if (! library.open (libraryName))
+            return false;
+
+        loadFunction (init,             "lame_init");
+        loadFunction (setInSampleRate,  "lame_set_in_samplerate");
+        loadFunction (setNumChannels,   "lame_set_num_channels");
+        loadFunction (setMode,          "lame_set_mode");
+        loadFunction (setVBR,           "lame_set_VBR");
+        loadFunction (setVBRQuality,    "lame_set_VBR_q");
+        loadFunction (setBitrate,       "lame_set_brate");
+        loadFunction (initParams,       "lame_init_params");
+        loadFunction (encodeBufferInt,  "lame_encode_buffer_int");
+        loadFunction (encodeFlush,      "lame_encode_flush");
+        loadFunction (getLameTagFrame,  "lame_get_lametag_frame");
+        loadFunction (close,            "lame_close");
+
+        loadFunction (id3Init,          "id3tag_init");
+        loadFunction (id3SetTitle,      "id3tag_set_title");
+        loadFunction (id3SetArtist,     "id3tag_set_artist");
+        loadFunction (id3SetAlbum,      "id3tag_set_album");
+        loadFunction (id3SetComment,    "id3tag_set_comment");
+        loadFunction (id3SetYear,       "id3tag_set_year");
+        loadFunction (id3SetGenre,      "id3tag_set_genre");
+        loadFunction (id3SetTrack,      "id3tag_set_track");
+
+        // (older versions of lame don't have lame_get_lametag_frame, so that one's optional,
+        // as are the id3 functions)
+        return init != nullptr && setInSampleRate != nullptr && setNumChannels != nullptr
+                && setMode != nullptr && setVBR != nullptr && setVBRQuality != nullptr
+                && setBitrate != nullptr && initParams != nullptr && encodeBufferInt != nullptr
+                && encodeFlush != nullptr && close != nullptr;
+    }
+
+    bool loadDefault()
+    {
+        const char* const names[] =
+        {
+           #if JUCE_WINDOWS
+            "libmp3lame.dll",
+           #elif JUCE_MAC || JUCE_IOS
+            "libmp3lame.dylib", "/usr/local/lib/libmp3lame.dylib", "/opt/local/lib/libmp3lame.dylib",
+           #else
+            "libmp3lame.so.0", "libmp3lame.so",
+           #endif
+            nullptr
+        };
+
+        for (const char* const* name = names; *name != nullptr; ++name)
+            if (load (*name))
+                return true;
+
+        return false;
+    }
+
+    void setTags (GlobalFlags* flags, const StringPairArray& metadata) const
+    {
+        if (id3Init == nullptr)
+            return;
+
+        id3Init (flags);
+        setTag (flags, id3SetTitle,   metadata, "id3title");
+        setTag (flags, id3SetArtist,  metadata, "id3artist");
+        setTag (flags, id3SetAlbum,   metadata, "id3album");
+        setTag (flags, id3SetComment, metadata, "id3comment");
+        setTag (flags, id3SetYear,    metadata, "id3date");
+
+        const String genre (metadata.getValue ("id3genre", String::empty));
+        const String track (metadata.getValue ("id3trackNumber", String::empty));
+
+        if (genre.isNotEmpty() && id3SetGenre != nullptr)   id3SetGenre (flags, genre.toRawUTF8());
+        if (track.isNotEmpty() && id3SetTrack != nullptr)   id3SetTrack (flags, track.toRawUTF8());
+    }
+
+    // lame's MPEG_mode and vbr_mode values
+    enum { modeJointStereo = 1, modeMono = 3 };
+    enum { vbrOff = 0, vbrNew = 4 };
+
+    GlobalFlags* (*init) ();
+    int (*setInSampleRate) (GlobalFlags*, int);
+    int (*setNumChannels) (GlobalFlags*, int);
+    int (*setMode) (GlobalFlags*, int);
+    int (*setVBR) (GlobalFlags*, int);
+    int (*setVBRQuality) (GlobalFlags*, int);
+    int (*setBitrate) (GlobalFlags*, int);
+    int (*initParams) (GlobalFlags*);
+    int (*encodeBufferInt) (GlobalFlags*, const int*, const int*, int, unsigned char*, int);
+    int (*encodeFlush) (GlobalFlags*, unsigned char*, int);
+    size_t (*getLameTagFrame) (const GlobalFlags*, unsigned char*, size_t);
+    int (*close) (GlobalFlags*);
+
+    typedef void (*SetTagFunction) (GlobalFlags*, const char*);
+    void (*id3Init) (GlobalFlags*);
+    SetTagFunction id3SetTitle, id3SetArtist, id3SetAlbum, id3SetComment, id3SetYear;
+    int (*id3SetGenre) (GlobalFlags*, const char*);
+    int (*id3SetTrack) (GlobalFlags*, const char*);
+
+private:
+    DynamicLibrary library;
+
+    template <typename FunctionType>
+    void loadFunction (FunctionType& function, const char* name)
+    {
+        function = (FunctionType) library.getFunction (name);
+    }
+
+    static void setTag (GlobalFlags* flags, SetTagFunction function,
+                        const StringPairArray& metadata, const char* key)
+    {
+        const String value (metadata.getValue (key, String::empty));
+
+        if (value.isNotEmpty() && function != nullptr)
+            function (flags, value.toRawUTF8());
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LAMELibrary)
+};
+
+//==============================================================================
+/*  Encodes each block as it arrives, using the libmp3lame shared library, and writes
+    the mp3 data straight to the output stream.
+*/
+class LAMEEncoderAudioFormat::LibraryWriter   : public AudioFormatWriter
+{
+public:
+    LibraryWriter (OutputStream* destStream, const String& name, LAMELibrary* lib,
+                   int vbr, int cbr, double rate, unsigned int numChans,
+                   unsigned int bits, const StringPairArray& metadata)
+        : AudioFormatWriter (destStream, name, rate, numChans, bits),
+          library (lib), flags (nullptr),
+          encodedData ((size_t) maxEncodedBytes),
+          firstFramePosition (destStream->getPosition()),
+          hasWrittenData (false)
+    {
+        flags = library->init();
+
+        if (flags != nullptr)
+        {
+            library->setInSampleRate (flags, (int) rate);
+            library->setNumChannels (flags, (int) numChans);
+            library->setMode (flags, numChans == 1 ? (int) LAMELibrary::modeMono
+                                                   : (int) LAMELibrary::modeJointStereo);
+
+            if (cbr == 0)
+            {
+                library->setVBR (flags, LAMELibrary::vbrNew);
+                library->setVBRQuality (flags, vbr);
+            }
+            else
+            {
+                library->setVBR (flags, LAMELibrary::vbrOff);
+                library->setBitrate (flags, cbr);
+            }
+
+            library->setTags (flags, metadata);
+
+            if (library->initParams (flags) < 0)
+            {
+                library->close (flags);
+                flags = nullptr;
+            }
+        }
+    }
+
+    ~LibraryWriter()
+    {
+        if (flags != nullptr)
+        {
+            const int numBytes = library->encodeFlush (flags, getEncodedData(), maxEncodedBytes);
+
+            if (numBytes > 0)
+                writeEncodedData (numBytes);
+
+            writeLameTagFrame();
+            library->close (flags);
+            output->flush();
+        }
+    }
+
+    bool isOk() const noexcept      { return flags != nullptr; }
+
+    bool write (const int** samplesToWrite, int numSamples)
+    {
+        if (flags == nullptr)
+            return false;
+
+        const int* left = samplesToWrite[0];
+        const int* right = (numChannels > 1 && samplesToWrite[1] != nullptr) ? samplesToWrite[1] : left;
+
+        while (numSamples > 0)
+        {
+            const int numThisTime = jmin (numSamples, (int) maxSamplesPerCall);
+            const int numBytes = library->encodeBufferInt (flags, left, right, numThisTime,
+                                                           getEncodedData(), maxEncodedBytes);
+
+            if (numBytes < 0 || ! writeEncodedData (numBytes))
+                return false;
+
+            left += numThisTime;
+            right += numThisTime;
+            numSamples -= numThisTime;
+        }
+
+        return true;
+    }
+
+private:
+    // lame's recommended worst-case output size is 1.25 * numSamples + 7200 bytes
+    enum { maxSamplesPerCall = 8192, maxEncodedBytes = maxSamplesPerCall + maxSamplesPerCall / 4 + 7200 };
+
+    LAMELibrary::Ptr library;
+    LAMELibrary::GlobalFlags* flags;
+    MemoryBlock encodedData;
+    int64 firstFramePosition;
+    bool hasWrittenData;
+
+    unsigned char* getEncodedData() noexcept    { return static_cast <unsigned char*> (encodedData.getData()); }
+
+    bool writeEncodedData (const int numBytes)
+    {
+        if (numBytes == 0)
+            return true;
+
+        if (! hasWrittenData)
+        {
+            // the first frame comes after the ID3v2 tag, if lame has written one
+            hasWrittenData = true;
+            firstFramePosition += getID3v2TagSize (getEncodedData(), numBytes);
+        }
+
+        return output->write (getEncodedData(), (size_t) numBytes);
+    }
+
+    static int getID3v2TagSize (const unsigned char* data, const int numBytes) noexcept
+    {
+        if (numBytes < 10 || data[0] != 'I' || data[1] != 'D' || data[2] != '3')
+            return 0;
+
+        return 10 + ((data[5] & 0x10) != 0 ? 10 : 0)
+                 + (((data[6] & 0x7f) << 21) | ((data[7] & 0x7f) << 14) | ((data[8] & 0x7f) << 7) | (data[9] & 0x7f));
+    }
+
+    /*  The first frame is a placeholder for the Xing/LAME header, which holds the
+        frame count and seek table that players need for VBR files, so once all the
+        frames have been written, it gets replaced with the real one.
+    */
+    void writeLameTagFrame()
+    {
+        if (library->getLameTagFrame == nullptr || ! hasWrittenData)
+            return;
+
+        const size_t tagSize = library->getLameTagFrame (flags, getEncodedData(), (size_t) maxEncodedBytes);
+
+        if (tagSize > 0 && tagSize <= (size_t) maxEncodedBytes)
+        {
+            const int64 endPosition = output->getPosition();
+
+            if (output->setPosition (firstFramePosition))
+            {
+                output->write (getEncodedData(), tagSize);
+                output->setPosition (endPosition);
+            }
+        }
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LibraryWriter)
+};
+
 //==============================================================================
 static const char* const lameFormatName = "MP3 file";
 static const char* const lameExtensions[] = { ".mp3", nullptr };
@@ -148,6 +437,23 @@ LAMEEncoderAudioFormat::LAMEEncoderAudioFormat (const File& lameApplication)
 {
 }
 
+LAMEEncoderAudioFormat::LAMEEncoderAudioFormat (LAMELibrary* const lib)
+   : AudioFormat (TRANS (lameFormatName), StringArray (lameExtensions)),
+     library (lib)
+{
+}
+
+LAMEEncoderAudioFormat* LAMEEncoderAudioFormat::createUsingLibrary (const String& libraryName)
+{
+    LAMELibrary::Ptr lib (new LAMELibrary());
+
+    if (libraryName.isNotEmpty() ? lib->load (libraryName)
+                                 : lib->loadDefault())
+        return new LAMEEncoderAudioFormat (lib);
+
+    return nullptr;
+}
+
 LAMEEncoderAudioFormat::~LAMEEncoderAudioFormat()
 {
 }
@@ -212,6 +518,14 @@ AudioFormatWriter* LAMEEncoderAudioFormat::createWriterFor (OutputStream* stream
     else
         cbr = qual.getIntValue();
 
+    if (library != nullptr)
+    {
+        ScopedPointer<LibraryWriter> w (new LibraryWriter (streamToWriteTo, getFormatName(), library, vbr, cbr,
+                                                           sampleRateToUse, numberOfChannels,
+                                                           (unsigned int) bitsPerSample, metadataValues));
+        return w->isOk() ? w.release() : nullptr;
+    }
+
     return new Writer (streamToWriteTo, getFormatName(), lameApp, vbr, cbr,
                        sampleRateToUse, numberOfChannels, bitsPerSample, metadataValues);
 }
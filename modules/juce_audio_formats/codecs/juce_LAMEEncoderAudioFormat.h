@@ -36,6 +36,11 @@
     piped into the original OutputStream that was used when first creating
     the writer.
 
+    Alternatively, use createUsingLibrary() to get a format that loads the libmp3lame
+    shared library and encodes in-process: its writers encode each block as it's
+    written, and send the mp3 data straight to the output stream, without needing
+    any temporary files or a child process.
+
     @see AudioFormat
 */
 class JUCE_API  LAMEEncoderAudioFormat    : public AudioFormat
@@ -47,6 +52,22 @@ public:
     LAMEEncoderAudioFormat (const File& lameApplicationToUse);
     ~LAMEEncoderAudioFormat();
 
+    /** Creates a LAMEEncoderAudioFormat that encodes by calling the libmp3lame shared
+        library directly, rather than launching the executable.
+
+        The library name is passed to DynamicLibrary::open(), so it can be a full path, or
+        just a name for the OS to look for in its usual places. If it's empty, the platform's
+        usual names for libmp3lame are tried.
+
+        Returns nullptr if the library can't be loaded, or doesn't contain the functions
+        that are needed. The caller must delete the object that is returned.
+
+        If the output stream that you give to one of this format's writers can change its
+        position, the writer will go back and fill in the VBR header at the start of the
+        file when it's deleted, which is needed for players to get the length right.
+    */
+    static LAMEEncoderAudioFormat* createUsingLibrary (const String& libraryName = String::empty);
+
     bool canHandleFile (const File&);
     Array<int> getPossibleSampleRates();
     Array<int> getPossibleBitDepths();
@@ -62,8 +83,14 @@ public:
                                         const StringPairArray& metadataValues, int qualityOptionIndex);
 
 private:
-    File lameApp;
     class Writer;
+    class LAMELibrary;
+    class LibraryWriter;
+
+    File lameApp;
+    ReferenceCountedObjectPtr<LAMELibrary> library;
+
+    LAMEEncoderAudioFormat (LAMELibrary*);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LAMEEncoderAudioFormat)
 };
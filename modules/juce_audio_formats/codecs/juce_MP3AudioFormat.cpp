@@ -537,6 +537,134 @@ struct MP3Frame
     const AllocationTable* allocationTable;
 };
 
+//==============================================================================
+#if JUCE_USE_SSE_INTRINSICS || JUCE_USE_ARM_NEON
+/*  Four floats that are operated on together, so that the decoder's scalar code can be
+    compiled to process four channels of data at once.
+*/
+struct FloatLanes
+{
+   #if JUCE_USE_SSE_INTRINSICS
+    typedef __m128 Lanes;
+
+    FloatLanes (Lanes v) noexcept                    : lanes (v) {}
+    FloatLanes (const float v) noexcept              : lanes (_mm_load1_ps (&v)) {}
+
+    static FloatLanes load (const float* v) noexcept                            { return _mm_loadu_ps (v); }
+    void store (float* dest) const noexcept                                     { _mm_storeu_ps (dest, lanes); }
+    FloatLanes operator+ (const FloatLanes& other) const noexcept               { return _mm_add_ps (lanes, other.lanes); }
+    FloatLanes operator- (const FloatLanes& other) const noexcept               { return _mm_sub_ps (lanes, other.lanes); }
+    FloatLanes operator* (const FloatLanes& other) const noexcept               { return _mm_mul_ps (lanes, other.lanes); }
+
+    // Treats the four arguments as the rows of a 4x4 matrix, and swaps its rows and columns.
+    static void transpose (FloatLanes& a, FloatLanes& b, FloatLanes& c, FloatLanes& d) noexcept
+    {
+        _MM_TRANSPOSE4_PS (a.lanes, b.lanes, c.lanes, d.lanes);
+    }
+
+    static bool isAvailable() noexcept
+    {
+        static bool sse2Present = false;
+
+        if (! sse2Present)
+            sse2Present = SystemStats::hasSSE2();
+
+        return sse2Present;
+    }
+
+   #else
+    typedef float32x4_t Lanes;
+
+    FloatLanes (Lanes v) noexcept                    : lanes (v) {}
+    FloatLanes (const float v) noexcept              : lanes (vld1q_dup_f32 (&v)) {}
+
+    static FloatLanes load (const float* v) noexcept                            { return vld1q_f32 (v); }
+    void store (float* dest) const noexcept                                     { vst1q_f32 (dest, lanes); }
+    FloatLanes operator+ (const FloatLanes& other) const noexcept               { return vaddq_f32 (lanes, other.lanes); }
+    FloatLanes operator- (const FloatLanes& other) const noexcept               { return vsubq_f32 (lanes, other.lanes); }
+    FloatLanes operator* (const FloatLanes& other) const noexcept               { return vmulq_f32 (lanes, other.lanes); }
+
+    static void transpose (FloatLanes& a, FloatLanes& b, FloatLanes& c, FloatLanes& d) noexcept
+    {
+        const float32x4x2_t ab = vtrnq_f32 (a.lanes, b.lanes);
+        const float32x4x2_t cd = vtrnq_f32 (c.lanes, d.lanes);
+
+        a.lanes = vcombine_f32 (vget_low_f32  (ab.val[0]), vget_low_f32  (cd.val[0]));
+        b.lanes = vcombine_f32 (vget_low_f32  (ab.val[1]), vget_low_f32  (cd.val[1]));
+        c.lanes = vcombine_f32 (vget_high_f32 (ab.val[0]), vget_high_f32 (cd.val[0]));
+        d.lanes = vcombine_f32 (vget_high_f32 (ab.val[1]), vget_high_f32 (cd.val[1]));
+    }
+
+    // NEON is always present on the ARM targets that this gets compiled for
+    static bool isAvailable() noexcept      { return true; }
+   #endif
+
+    FloatLanes() noexcept {}
+
+    FloatLanes& operator+= (const FloatLanes& other) noexcept       { return *this = *this + other; }
+    FloatLanes& operator-= (const FloatLanes& other) noexcept       { return *this = *this - other; }
+    FloatLanes& operator*= (const FloatLanes& other) noexcept       { return *this = *this * other; }
+
+    // Returns the total of each of the four arguments' lanes.
+    static FloatLanes sumAcross (FloatLanes a, FloatLanes b, FloatLanes c, FloatLanes d) noexcept
+    {
+        transpose (a, b, c, d);
+        return (a + b) + (c + d);
+    }
+
+    /*  Loads element i of each of four arrays that are spaced 'stride' floats apart into
+        lanes[i], for i = 0 to num - 1.
+    */
+    static void interleave (const float* const source, const int stride, FloatLanes* const lanes, const int num) noexcept
+    {
+        int i = 0;
+
+        for (; i + 4 <= num; i += 4)
+        {
+            FloatLanes& a = lanes[i] = load (source + i);
+            FloatLanes& b = lanes[i + 1] = load (source + stride + i);
+            FloatLanes& c = lanes[i + 2] = load (source + stride * 2 + i);
+            FloatLanes& d = lanes[i + 3] = load (source + stride * 3 + i);
+            transpose (a, b, c, d);
+        }
+
+        for (; i < num; ++i)
+        {
+            const float values[] = { source[i], source[stride + i], source[stride * 2 + i], source[stride * 3 + i] };
+            lanes[i] = load (values);
+        }
+    }
+
+    // The reverse of interleave().
+    static void deinterleave (const FloatLanes* const lanes, float* const dest, const int stride, const int num) noexcept
+    {
+        int i = 0;
+
+        for (; i + 4 <= num; i += 4)
+        {
+            FloatLanes a (lanes[i]), b (lanes[i + 1]), c (lanes[i + 2]), d (lanes[i + 3]);
+            transpose (a, b, c, d);
+            a.store (dest + i);
+            b.store (dest + stride + i);
+            c.store (dest + stride * 2 + i);
+            d.store (dest + stride * 3 + i);
+        }
+
+        for (; i < num; ++i)
+        {
+            float values[4];
+            lanes[i].store (values);
+            dest[i] = values[0];
+            dest[stride + i] = values[1];
+            dest[stride * 2 + i] = values[2];
+            dest[stride * 3 + i] = values[3];
+        }
+    }
+
+    Lanes lanes;
+};
+#endif
+
 //==============================================================================
 struct Constants
 {
@@ -546,6 +674,10 @@ struct Constants
         initDecodeTables();
         initLayer2Tables();
         initLayer3Tables();
+
+       #if JUCE_USE_SSE_INTRINSICS || JUCE_USE_ARM_NEON
+        initSIMDTables();
+       #endif
     }
 
     const uint8* getGroupTable (const int16 d1, const int index) const noexcept
@@ -579,6 +711,17 @@ struct Constants
     float decodeWin[512 + 32];
     float* cosTables[5];
 
+   #if JUCE_USE_SSE_INTRINSICS || JUCE_USE_ARM_NEON
+    // The IMDCT windows for four adjacent subbands, where the odd ones use win1.
+    FloatLanes interleavedWin[4][36];
+
+    /*  For each of the synthesis buffer's 8 phases, the window coefficients for each output
+        sample, with the signs folded in, so each sample is just the dot product of 16 of
+        these with a row of the buffer.
+    */
+    float synthesisWindows[8][32][16];
+   #endif
+
 private:
     int mapbuf0[9][152];
     int mapbuf1[9][156];
@@ -623,6 +766,46 @@ private:
         }
     }
 
+   #if JUCE_USE_SSE_INTRINSICS || JUCE_USE_ARM_NEON
+    void initSIMDTables()
+    {
+        for (int blockType = 0; blockType < 4; ++blockType)
+        {
+            for (int i = 0; i < 36; ++i)
+            {
+                const float evenWin = win[blockType][i], oddWin = win1[blockType][i];
+                const float lanes[] = { evenWin, oddWin, evenWin, oddWin };
+                interleavedWin[blockType][i] = FloatLanes::load (lanes);
+            }
+        }
+
+        // (these index calculations are the same ones that MP3Stream::synthesise() uses)
+        for (int phase = 0; phase < 8; ++phase)
+        {
+            const int bo1 = phase * 2 + 1;
+            const float* const window = decodeWin + 16 - bo1;
+            float (*const coeffs)[16] = synthesisWindows [phase];
+
+            for (int n = 0; n < 16; ++n)
+                for (int k = 0; k < 16; ++k)
+                    coeffs[n][k] = (k & 1) != 0 ? -window[32 * n + k] : window[32 * n + k];
+
+            for (int k = 0; k < 16; ++k)
+                coeffs[16][k] = (k & 1) != 0 ? 0.0f : window[512 + k];
+
+            for (int n = 17; n < 32; ++n)
+            {
+                const float* const w = window + 480 + 2 * bo1 - 32 * (n - 17);
+
+                for (int k = 0; k < 15; ++k)
+                    coeffs[n][k] = -w[-1 - k];
+
+                coeffs[n][15] = -w[0];
+            }
+        }
+    }
+   #endif
+
     void initLayer2Tables()
     {
         static const uint8 base[3][9] =
@@ -1061,30 +1244,34 @@ namespace DCT
     static const float cos36[] = { 0.501909912f, 0.517638087f, 0.551688969f, 0.610387266f, 0.707106769f, 0.871723413f, 1.18310082f, 1.93185163f, 5.73685646f };
     static const float cos12[] = { 0.517638087f, 0.707106769f, 1.93185163f };
 
-    inline void dct36_0 (const int v, float* const ts, float* const out1, float* const out2,
-                         const float* const wintab, float sum0, const float sum1) noexcept
+    template <typename Sample, int tsStride>
+    inline void dct36_0 (const int v, Sample* const ts, Sample* const out1, Sample* const out2,
+                         const Sample* const wintab, Sample sum0, const Sample sum1) noexcept
     {
-        const float tmp = sum0 + sum1;
+        const Sample tmp = sum0 + sum1;
         out2[9 + v] = tmp * wintab[27 + v];
         out2[8 - v] = tmp * wintab[26 - v];
         sum0 -= sum1;
-        ts[SBLIMIT * (8 - v)] = out1[8 - v] + sum0 * wintab[8 - v];
-        ts[SBLIMIT * (9 + v)] = out1[9 + v] + sum0 * wintab[9 + v];
+        ts[tsStride * (8 - v)] = out1[8 - v] + sum0 * wintab[8 - v];
+        ts[tsStride * (9 + v)] = out1[9 + v] + sum0 * wintab[9 + v];
     }
 
-    inline void dct36_1 (const int v, float* const ts, float* const out1, float* const out2, const float* const wintab,
-                         const float tmp1a, const float tmp1b, const float tmp2a, const float tmp2b) noexcept
+    template <typename Sample, int tsStride>
+    inline void dct36_1 (const int v, Sample* const ts, Sample* const out1, Sample* const out2, const Sample* const wintab,
+                         const Sample tmp1a, const Sample tmp1b, const Sample tmp2a, const Sample tmp2b) noexcept
     {
-        dct36_0 (v, ts, out1, out2, wintab, tmp1a + tmp2a, (tmp1b + tmp2b) * cos36[v]);
+        dct36_0<Sample, tsStride> (v, ts, out1, out2, wintab, tmp1a + tmp2a, (tmp1b + tmp2b) * cos36[v]);
     }
 
-    inline void dct36_2 (const int v, float* const ts, float* const out1, float* const out2, const float* const wintab,
-                         const float tmp1a, const float tmp1b, const float tmp2a, const float tmp2b) noexcept
+    template <typename Sample, int tsStride>
+    inline void dct36_2 (const int v, Sample* const ts, Sample* const out1, Sample* const out2, const Sample* const wintab,
+                         const Sample tmp1a, const Sample tmp1b, const Sample tmp2a, const Sample tmp2b) noexcept
     {
-        dct36_0 (v, ts, out1, out2, wintab, tmp2a - tmp1a, (tmp2b - tmp1b) * cos36[v]);
+        dct36_0<Sample, tsStride> (v, ts, out1, out2, wintab, tmp2a - tmp1a, (tmp2b - tmp1b) * cos36[v]);
     }
 
-    void dct36 (float* const in, float* const out1, float* const out2, const float* const wintab, float* const ts) noexcept
+    template <typename Sample, int tsStride>
+    void dct36 (Sample* const in, Sample* const out1, Sample* const out2, const Sample* const wintab, Sample* const ts) noexcept
     {
         in[17] += in[16]; in[16] += in[15]; in[15] += in[14]; in[14] += in[13]; in[13] += in[12];
         in[12] += in[11]; in[11] += in[10]; in[10] += in[9];  in[9]  += in[8];  in[8]  += in[7];
@@ -1092,57 +1279,58 @@ namespace DCT
         in[2]  += in[1];  in[1]  += in[0];  in[17] += in[15]; in[15] += in[13]; in[13] += in[11];
         in[11] += in[9];  in[9]  += in[7];  in[7]  += in[5];  in[5]  += in[3];  in[3]  += in[1];
 
-        const float ta33 = in[6]  * cos9[3];
-        const float ta66 = in[12] * cos9[6];
-        const float tb33 = in[7]  * cos9[3];
-        const float tb66 = in[13] * cos9[6];
+        const Sample ta33 = in[6]  * cos9[3];
+        const Sample ta66 = in[12] * cos9[6];
+        const Sample tb33 = in[7]  * cos9[3];
+        const Sample tb66 = in[13] * cos9[6];
 
         {
-            const float tmp1a = in[2] * cos9[1] + ta33 + in[10] * cos9[5] + in[14] * cos9[7];
-            const float tmp1b = in[3] * cos9[1] + tb33 + in[11] * cos9[5] + in[15] * cos9[7];
-            const float tmp2a = in[0] + in[4] * cos9[2] + in[8] * cos9[4] + ta66 + in[16] * cos9[8];
-            const float tmp2b = in[1] + in[5] * cos9[2] + in[9] * cos9[4] + tb66 + in[17] * cos9[8];
-            dct36_1 (0, ts, out1, out2, wintab, tmp1a, tmp1b, tmp2a, tmp2b);
-            dct36_2 (8, ts, out1, out2, wintab, tmp1a, tmp1b, tmp2a, tmp2b);
+            const Sample tmp1a = in[2] * cos9[1] + ta33 + in[10] * cos9[5] + in[14] * cos9[7];
+            const Sample tmp1b = in[3] * cos9[1] + tb33 + in[11] * cos9[5] + in[15] * cos9[7];
+            const Sample tmp2a = in[0] + in[4] * cos9[2] + in[8] * cos9[4] + ta66 + in[16] * cos9[8];
+            const Sample tmp2b = in[1] + in[5] * cos9[2] + in[9] * cos9[4] + tb66 + in[17] * cos9[8];
+            dct36_1<Sample, tsStride> (0, ts, out1, out2, wintab, tmp1a, tmp1b, tmp2a, tmp2b);
+            dct36_2<Sample, tsStride> (8, ts, out1, out2, wintab, tmp1a, tmp1b, tmp2a, tmp2b);
         }
 
         {
-            const float tmp1a = (in[2] - in[10] - in[14]) * cos9[3];
-            const float tmp1b = (in[3] - in[11] - in[15]) * cos9[3];
-            const float tmp2a = (in[4] - in[8] - in[16]) * cos9[6] - in[12] + in[0];
-            const float tmp2b = (in[5] - in[9] - in[17]) * cos9[6] - in[13] + in[1];
-            dct36_1 (1, ts, out1, out2, wintab, tmp1a, tmp1b, tmp2a, tmp2b);
-            dct36_2 (7, ts, out1, out2, wintab, tmp1a, tmp1b, tmp2a, tmp2b);
+            const Sample tmp1a = (in[2] - in[10] - in[14]) * cos9[3];
+            const Sample tmp1b = (in[3] - in[11] - in[15]) * cos9[3];
+            const Sample tmp2a = (in[4] - in[8] - in[16]) * cos9[6] - in[12] + in[0];
+            const Sample tmp2b = (in[5] - in[9] - in[17]) * cos9[6] - in[13] + in[1];
+            dct36_1<Sample, tsStride> (1, ts, out1, out2, wintab, tmp1a, tmp1b, tmp2a, tmp2b);
+            dct36_2<Sample, tsStride> (7, ts, out1, out2, wintab, tmp1a, tmp1b, tmp2a, tmp2b);
         }
 
         {
-            const float tmp1a = in[2] * cos9[5] - ta33 - in[10] * cos9[7] + in[14] * cos9[1];
-            const float tmp1b = in[3] * cos9[5] - tb33 - in[11] * cos9[7] + in[15] * cos9[1];
-            const float tmp2a = in[0] - in[4] * cos9[8] - in[8] * cos9[2] + ta66 + in[16] * cos9[4];
-            const float tmp2b = in[1] - in[5] * cos9[8] - in[9] * cos9[2] + tb66 + in[17] * cos9[4];
-            dct36_1 (2, ts, out1, out2, wintab, tmp1a, tmp1b, tmp2a, tmp2b);
-            dct36_2 (6, ts, out1, out2, wintab, tmp1a, tmp1b, tmp2a, tmp2b);
+            const Sample tmp1a = in[2] * cos9[5] - ta33 - in[10] * cos9[7] + in[14] * cos9[1];
+            const Sample tmp1b = in[3] * cos9[5] - tb33 - in[11] * cos9[7] + in[15] * cos9[1];
+            const Sample tmp2a = in[0] - in[4] * cos9[8] - in[8] * cos9[2] + ta66 + in[16] * cos9[4];
+            const Sample tmp2b = in[1] - in[5] * cos9[8] - in[9] * cos9[2] + tb66 + in[17] * cos9[4];
+            dct36_1<Sample, tsStride> (2, ts, out1, out2, wintab, tmp1a, tmp1b, tmp2a, tmp2b);
+            dct36_2<Sample, tsStride> (6, ts, out1, out2, wintab, tmp1a, tmp1b, tmp2a, tmp2b);
         }
 
         {
-            const float tmp1a = in[2] * cos9[7] - ta33 + in[10] * cos9[1] - in[14] * cos9[5];
-            const float tmp1b = in[3] * cos9[7] - tb33 + in[11] * cos9[1] - in[15] * cos9[5];
-            const float tmp2a = in[0] - in[4] * cos9[4] + in[8] * cos9[8] + ta66 - in[16] * cos9[2];
-            const float tmp2b = in[1] - in[5] * cos9[4] + in[9] * cos9[8] + tb66 - in[17] * cos9[2];
-            dct36_1 (3, ts, out1, out2, wintab, tmp1a, tmp1b, tmp2a, tmp2b);
-            dct36_2 (5, ts, out1, out2, wintab, tmp1a, tmp1b, tmp2a, tmp2b);
+            const Sample tmp1a = in[2] * cos9[7] - ta33 + in[10] * cos9[1] - in[14] * cos9[5];
+            const Sample tmp1b = in[3] * cos9[7] - tb33 + in[11] * cos9[1] - in[15] * cos9[5];
+            const Sample tmp2a = in[0] - in[4] * cos9[4] + in[8] * cos9[8] + ta66 - in[16] * cos9[2];
+            const Sample tmp2b = in[1] - in[5] * cos9[4] + in[9] * cos9[8] + tb66 - in[17] * cos9[2];
+            dct36_1<Sample, tsStride> (3, ts, out1, out2, wintab, tmp1a, tmp1b, tmp2a, tmp2b);
+            dct36_2<Sample, tsStride> (5, ts, out1, out2, wintab, tmp1a, tmp1b, tmp2a, tmp2b);
         }
 
-        const float sum0 =  in[0] - in[4] + in[8] - in[12] + in[16];
-        const float sum1 = (in[1] - in[5] + in[9] - in[13] + in[17]) * cos36[4];
-        dct36_0 (4, ts, out1, out2, wintab, sum0, sum1);
+        const Sample sum0 =  in[0] - in[4] + in[8] - in[12] + in[16];
+        const Sample sum1 = (in[1] - in[5] + in[9] - in[13] + in[17]) * cos36[4];
+        dct36_0<Sample, tsStride> (4, ts, out1, out2, wintab, sum0, sum1);
     }
 
+    template <typename Sample>
     struct DCT12Inputs
     {
-        float in0, in1, in2, in3, in4, in5;
+        Sample in0, in1, in2, in3, in4, in5;
 
-        inline DCT12Inputs (const float* const in) noexcept
+        inline DCT12Inputs (const Sample* const in) noexcept
         {
             in5 = in[5*3] + (in4 = in[4*3]);
             in4 += (in3 = in[3*3]);
@@ -1166,53 +1354,54 @@ namespace DCT
         }
     };
 
-    void dct12 (const float* in, float* const out1, float* const out2, const float* wi, float* ts) noexcept
+    template <typename Sample, int tsStride>
+    void dct12 (const Sample* in, Sample* const out1, Sample* const out2, const Sample* wi, Sample* ts) noexcept
     {
         {
             ts[0] = out1[0];
-            ts[SBLIMIT * 1] = out1[1];
-            ts[SBLIMIT * 2] = out1[2];
-            ts[SBLIMIT * 3] = out1[3];
-            ts[SBLIMIT * 4] = out1[4];
-            ts[SBLIMIT * 5] = out1[5];
+            ts[tsStride * 1] = out1[1];
+            ts[tsStride * 2] = out1[2];
+            ts[tsStride * 3] = out1[3];
+            ts[tsStride * 4] = out1[4];
+            ts[tsStride * 5] = out1[5];
 
-            DCT12Inputs inputs (in);
+            DCT12Inputs<Sample> inputs (in);
 
             {
-                float tmp1 = (inputs.in0 - inputs.in4);
-                const float tmp2 = (inputs.in1 - inputs.in5) * cos12[1];
-                const float tmp0 = tmp1 + tmp2;
+                Sample tmp1 = (inputs.in0 - inputs.in4);
+                const Sample tmp2 = (inputs.in1 - inputs.in5) * cos12[1];
+                const Sample tmp0 = tmp1 + tmp2;
                 tmp1 -= tmp2;
 
-                ts[16 * SBLIMIT] = out1[16] + tmp0 * wi[10];
-                ts[13 * SBLIMIT] = out1[13] + tmp0 * wi[7];
-                ts[7  * SBLIMIT] = out1[7]  + tmp1 * wi[1];
-                ts[10 * SBLIMIT] = out1[10] + tmp1 * wi[4];
+                ts[16 * tsStride] = out1[16] + tmp0 * wi[10];
+                ts[13 * tsStride] = out1[13] + tmp0 * wi[7];
+                ts[7  * tsStride] = out1[7]  + tmp1 * wi[1];
+                ts[10 * tsStride] = out1[10] + tmp1 * wi[4];
             }
 
             inputs.process();
 
-            ts[17 * SBLIMIT] = out1[17] + inputs.in2 * wi[11];
-            ts[12 * SBLIMIT] = out1[12] + inputs.in2 * wi[6];
-            ts[14 * SBLIMIT] = out1[14] + inputs.in3 * wi[8];
-            ts[15 * SBLIMIT] = out1[15] + inputs.in3 * wi[9];
+            ts[17 * tsStride] = out1[17] + inputs.in2 * wi[11];
+            ts[12 * tsStride] = out1[12] + inputs.in2 * wi[6];
+            ts[14 * tsStride] = out1[14] + inputs.in3 * wi[8];
+            ts[15 * tsStride] = out1[15] + inputs.in3 * wi[9];
 
-            ts[6  * SBLIMIT] = out1[6]  + inputs.in0 * wi[0];
-            ts[11 * SBLIMIT] = out1[11] + inputs.in0 * wi[5];
-            ts[8  * SBLIMIT] = out1[8]  + inputs.in4 * wi[2];
-            ts[9  * SBLIMIT] = out1[9]  + inputs.in4 * wi[3];
+            ts[6  * tsStride] = out1[6]  + inputs.in0 * wi[0];
+            ts[11 * tsStride] = out1[11] + inputs.in0 * wi[5];
+            ts[8  * tsStride] = out1[8]  + inputs.in4 * wi[2];
+            ts[9  * tsStride] = out1[9]  + inputs.in4 * wi[3];
         }
 
         {
-            DCT12Inputs inputs (++in);
-            float tmp1 = (inputs.in0 - inputs.in4);
-            const float tmp2 = (inputs.in1 - inputs.in5) * cos12[1];
-            const float tmp0 = tmp1 + tmp2;
+            DCT12Inputs<Sample> inputs (++in);
+            Sample tmp1 = (inputs.in0 - inputs.in4);
+            const Sample tmp2 = (inputs.in1 - inputs.in5) * cos12[1];
+            const Sample tmp0 = tmp1 + tmp2;
             tmp1 -= tmp2;
             out2[4] = tmp0 * wi[10];
             out2[1] = tmp0 * wi[7];
-            ts[13 * SBLIMIT] += tmp1 * wi[1];
-            ts[16 * SBLIMIT] += tmp1 * wi[4];
+            ts[13 * tsStride] += tmp1 * wi[1];
+            ts[16 * tsStride] += tmp1 * wi[4];
 
             inputs.process();
 
@@ -1220,19 +1409,19 @@ namespace DCT
             out2[0] = inputs.in2 * wi[6];
             out2[2] = inputs.in3 * wi[8];
             out2[3] = inputs.in3 * wi[9];
-            ts[12 * SBLIMIT] += inputs.in0 * wi[0];
-            ts[17 * SBLIMIT] += inputs.in0 * wi[5];
-            ts[14 * SBLIMIT] += inputs.in4 * wi[2];
-            ts[15 * SBLIMIT] += inputs.in4 * wi[5 - 2];
+            ts[12 * tsStride] += inputs.in0 * wi[0];
+            ts[17 * tsStride] += inputs.in0 * wi[5];
+            ts[14 * tsStride] += inputs.in4 * wi[2];
+            ts[15 * tsStride] += inputs.in4 * wi[5 - 2];
         }
 
         {
-            DCT12Inputs inputs (++in);
+            DCT12Inputs<Sample> inputs (++in);
             out2[12] = out2[13] = out2[14] = out2[15] = out2[16] = out2[17] = 0;
 
-            float tmp1 = (inputs.in0 - inputs.in4);
-            const float tmp2 = (inputs.in1 - inputs.in5) * cos12[1];
-            const float tmp0 = tmp1 + tmp2;
+            Sample tmp1 = (inputs.in0 - inputs.in4);
+            const Sample tmp2 = (inputs.in1 - inputs.in5) * cos12[1];
+            const Sample tmp0 = tmp1 + tmp2;
             tmp1 -= tmp2;
 
             out2[10] = tmp0 * wi[10];
@@ -1386,12 +1575,78 @@ namespace DCT
     }
 }
 
+//==============================================================================
+/*  The stream position of each audio frame in a file, which is found by reading the
+    frame headers without decoding them.
+*/
+struct MP3SeekIndex
+{
+    MP3SeekIndex() noexcept  : isComplete (false) {}
+
+    void writeTo (OutputStream& out, const int64 streamLength) const
+    {
+        out.writeInt (magicNumber);
+        out.writeInt64 (streamLength);
+        out.writeBool (isComplete);
+        out.writeInt (framePositions.size());
+
+        int64 lastPos = 0;
+
+        for (int i = 0; i < framePositions.size(); ++i)
+        {
+            const int64 pos = framePositions.getUnchecked (i);
+            out.writeCompressedInt ((int) (pos - lastPos));
+            lastPos = pos;
+        }
+    }
+
+    bool readFrom (InputStream& in, const int64 streamLength)
+    {
+        if (in.readInt() != magicNumber || in.readInt64() != streamLength)
+            return false;
+
+        const bool complete = in.readBool();
+        const int numPositions = in.readInt();
+
+        if (numPositions <= 0 || numPositions > streamLength / 4)
+            return false;
+
+        Array<int64> positions;
+        positions.ensureStorageAllocated (numPositions);
+        int64 pos = 0;
+
+        for (int i = 0; i < numPositions; ++i)
+        {
+            const int delta = in.readCompressedInt();
+
+            if (delta <= 0 && i > 0)
+                return false;
+
+            pos += delta;
+            positions.add (pos);
+        }
+
+        if (pos >= streamLength)
+            return false;
+
+        framePositions.swapWithArray (positions);
+        isComplete = complete;
+        return true;
+    }
+
+    Array<int64> framePositions;  // (doesn't include any VBR header frame)
+    bool isComplete;
+
+private:
+    enum { magicNumber = 0x4933504d };
+};
+
 //==============================================================================
 struct MP3Stream
 {
     MP3Stream (InputStream& source)
         : stream (source, 8192),
-          numFrames (0), currentFrameIndex (0), vbrHeaderFound (false)
+          numFrames (0), vbrHeaderFound (false)
     {
         reset();
     }
@@ -1550,34 +1805,110 @@ struct MP3Stream
         return result;
     }
 
-    bool seek (int frameIndex)
+    int getSamplesPerFrame() const noexcept
     {
-        frameIndex = jmax (0, frameIndex);
+        return frame.layer == 1 ? 384 : ((frame.layer == 3 && frame.lsf) ? 576 : 1152);
+    }
+
+    /*  Moves the stream to the start of a frame, ready to begin decoding from there.
 
-        while (frameIndex >= frameStreamPositions.size() * storedStartPosInterval)
+        The synthesis buffer offsets are set to what they'd have been if all the frames
+        before this one had been decoded, so that once the decoder has warmed up, its output
+        is exactly the same as if it had played through from the start.
+    */
+    void restartAt (const int64 framePos, const int64 frameIndex)
+    {
+        stream.setPosition (framePos);
+        reset();
+
+        synthBo = (int) ((1 - frameIndex * (getSamplesPerFrame() / 32)) & 15);
+        hybridBlockIndex[0] = hybridBlockIndex[1] = (frame.layer == 3 && frame.lsf) ? (int) (frameIndex & 1) : 0;
+    }
+
+    /*  Moves the synthesis state on as if some samples had been decoded. This is used when a
+        frame can't be fully decoded (e.g. the first one after a restart, whose bit reservoir
+        is missing), to keep the state in step with the number of frames.
+    */
+    void skipSamples (const int numSamples) noexcept
+    {
+        synthBo = (synthBo - numSamples / 32) & 15;
+
+        if (frame.layer == 3 && ((numSamples / 576) & 1) != 0)
         {
-            int dummy = 0;
-            const int result = decodeNextBlock (nullptr, nullptr, dummy);
+            hybridBlockIndex[0] = 1 - hybridBlockIndex[0];
+            hybridBlockIndex[1] = 1 - hybridBlockIndex[1];
+        }
+    }
 
-            if (result < 0)
-                return false;
+    /*  Finds the first audio frame, skipping any VBR header. This must be called after the
+        first frame has been decoded, so that the frame type is known.
+    */
+    void startSeekIndex (const int64 searchStartPos)
+    {
+        const int64 oldPos = stream.getPosition();
+        int64 pos = findNextFrameHeader (searchStartPos);
+
+        if (pos >= 0 && isVBRHeaderFrame (pos))
+            pos = findNextFrameHeader (pos + 4 + getFrameSize (pos));
 
-            if (result > 0)
+        seekIndex.framePositions.clearQuick();
+
+        if (pos >= 0)
+            seekIndex.framePositions.add (pos);
+        else
+            seekIndex.isComplete = true;
+
+        stream.setPosition (oldPos);
+    }
+
+    /*  Makes sure that the index contains the given frame, by reading the headers of any
+        frames after the last one that was indexed. Returns false if the frame is past the
+        end of the stream, or if its position can't be found without decoding the frames
+        before it (i.e. in a free-format stream).
+    */
+    bool indexFramesUpTo (const int frameIndex)
+    {
+        Array<int64>& positions = seekIndex.framePositions;
+
+        if (frameIndex < positions.size())
+            return true;
+
+        if (seekIndex.isComplete || positions.size() == 0)
+            return false;
+
+        const int64 oldPos = stream.getPosition();
+
+        while (positions.size() <= frameIndex)
+        {
+            const int64 lastPos = positions.getLast();
+            const int size = getFrameSize (lastPos);
+
+            if (size <= 0)
+            {
+                seekIndex.isComplete = true;
                 break;
+            }
+
+            const int64 nextPos = findNextFrameHeader (lastPos + 4 + size);
+
+            if (nextPos < 0)
+            {
+                seekIndex.isComplete = true;
+                break;
+            }
+
+            positions.add (nextPos);
         }
 
-        frameIndex = jmin (frameIndex & ~(storedStartPosInterval - 1),
-                           frameStreamPositions.size() * storedStartPosInterval - 1);
-        stream.setPosition (frameStreamPositions.getUnchecked (frameIndex / storedStartPosInterval));
-        currentFrameIndex = frameIndex;
-        reset();
-        return true;
+        stream.setPosition (oldPos);
+        return frameIndex < positions.size();
     }
 
     MP3Frame frame;
     VBRTagData vbrTagData;
     BufferedInputStream stream;
-    int numFrames, currentFrameIndex;
+    MP3SeekIndex seekIndex;
+    int numFrames;
     bool vbrHeaderFound;
 
 private:
@@ -1613,9 +1944,6 @@ private:
         zeromem (synthBuffers, sizeof (synthBuffers));
     }
 
-    enum { storedStartPosInterval = 4 };
-    Array<int64> frameStreamPositions;
-
     struct SideInfoLayer1
     {
         uint8 allocation[32][2];
@@ -1705,35 +2033,68 @@ private:
 
             header = (header << 8) | (uint8) stream.readByte();
 
-            if (offset >= 0 && isValidHeader (header, frame.layer))
-            {
-                if (! checkTypeAgainstLastFrame)
-                    break;
-
-                const bool mpeg25         = (header & (1 << 20)) == 0;
-                const int lsf             = mpeg25 ? 1 : ((header & (1 << 19)) ? 0 : 1);
-                const int sampleRateIndex = mpeg25 ? (6 + ((header >> 10) & 3)) : (((header >> 10) & 3) + (lsf * 3));
-                const int mode            = (header >> 6) & 3;
-                const int numChannels     = (mode == 3) ? 1 : 2;
-
-                if (numChannels == frame.numChannels && lsf == frame.lsf
-                      && mpeg25 == frame.mpeg25 && sampleRateIndex == frame.sampleRateIndex)
-                    break;
-            }
+            if (offset >= 0 && isValidHeader (header, frame.layer)
+                  && (! checkTypeAgainstLastFrame || matchesCurrentFrameType (header)))
+                break;
 
             ++offset;
         }
 
-        if (offset >= 0)
+        stream.setPosition (oldPos);
+        return offset;
+    }
+
+    bool matchesCurrentFrameType (const uint32 header) const noexcept
+    {
+        const bool mpeg25         = (header & (1 << 20)) == 0;
+        const int lsf             = mpeg25 ? 1 : ((header & (1 << 19)) ? 0 : 1);
+        const int sampleRateIndex = mpeg25 ? (6 + ((header >> 10) & 3)) : (((header >> 10) & 3) + (lsf * 3));
+        const int mode            = (header >> 6) & 3;
+        const int numChannels     = (mode == 3) ? 1 : 2;
+
+        return numChannels == frame.numChannels && lsf == frame.lsf
+                && mpeg25 == frame.mpeg25 && sampleRateIndex == frame.sampleRateIndex;
+    }
+
+    // Returns the position of the first frame header at or after the given position, or -1.
+    int64 findNextFrameHeader (const int64 startPos)
+    {
+        stream.setPosition (startPos);
+        uint32 header = 0;
+
+        for (int64 pos = startPos - 3;; ++pos)
         {
-            if ((currentFrameIndex & (storedStartPosInterval - 1)) == 0)
-                frameStreamPositions.set (currentFrameIndex / storedStartPosInterval, oldPos + offset);
+            if (stream.isExhausted() || pos > startPos + 32768)
+                return -1;
 
-            ++currentFrameIndex;
+            header = (header << 8) | (uint8) stream.readByte();
+
+            if (pos >= startPos && isValidHeader (header, frame.layer) && matchesCurrentFrameType (header))
+                return pos;
         }
+    }
 
-        stream.setPosition (oldPos);
-        return offset;
+    bool isVBRHeaderFrame (const int64 framePos)
+    {
+        stream.setPosition (framePos);
+        uint8 data[194];
+        VBRTagData tag;
+
+        return stream.read (data, sizeof (data)) == (int) sizeof (data) && tag.read (data);
+    }
+
+    // Returns the size of the frame at the given position, not including its header.
+    int getFrameSize (const int64 framePos)
+    {
+        stream.setPosition (framePos);
+        const uint32 header = (uint32) stream.readIntBigEndian();
+
+        if (! isValidHeader (header, frame.layer))
+            return -1;
+
+        MP3Frame f;
+        f.decodeHeader (header);
+        return f.frameSize;
     }
 
     void readVBRHeader()
@@ -2822,28 +3183,35 @@ private:
         if (granule.mixedBlockFlag)
         {
             sb = 2;
-            DCT::dct36 (fsIn[0], rawout1, rawout2, constants.win[0], ts);
-            DCT::dct36 (fsIn[1], rawout1 + 18, rawout2 + 18, constants.win1[0], ts + 1);
+            DCT::dct36<float, DCT::SBLIMIT> (fsIn[0], rawout1, rawout2, constants.win[0], ts);
+            DCT::dct36<float, DCT::SBLIMIT> (fsIn[1], rawout1 + 18, rawout2 + 18, constants.win1[0], ts + 1);
             rawout1 += 36;
             rawout2 += 36;
             ts += 2;
         }
 
         const int bt = granule.blockType;
+
+       #if JUCE_USE_SSE_INTRINSICS || JUCE_USE_ARM_NEON
+        if (FloatLanes::isAvailable())
+            for (; sb + 4 <= (int) granule.maxb; sb += 4, ts += 4, rawout1 += 72, rawout2 += 72)
+                hybridFourSubbands (fsIn[sb], rawout1, rawout2, bt, ts);
+       #endif
+
         if (bt == 2)
         {
             for (; sb < (int) granule.maxb; sb += 2, ts += 2, rawout1 += 36, rawout2 += 36)
             {
-                DCT::dct12 (fsIn[sb], rawout1, rawout2, constants.win[2], ts);
-                DCT::dct12 (fsIn[sb + 1], rawout1 + 18, rawout2 + 18, constants.win1[2], ts + 1);
+                DCT::dct12<float, DCT::SBLIMIT> (fsIn[sb], rawout1, rawout2, constants.win[2], ts);
+                DCT::dct12<float, DCT::SBLIMIT> (fsIn[sb + 1], rawout1 + 18, rawout2 + 18, constants.win1[2], ts + 1);
             }
         }
         else
         {
             for (; sb < (int) granule.maxb; sb += 2, ts += 2, rawout1 += 36, rawout2 += 36)
             {
-                DCT::dct36 (fsIn[sb], rawout1, rawout2, constants.win[bt], ts);
-                DCT::dct36 (fsIn[sb + 1], rawout1 + 18, rawout2 + 18, constants.win1[bt], ts + 1);
+                DCT::dct36<float, DCT::SBLIMIT> (fsIn[sb], rawout1, rawout2, constants.win[bt], ts);
+                DCT::dct36<float, DCT::SBLIMIT> (fsIn[sb + 1], rawout1 + 18, rawout2 + 18, constants.win1[bt], ts + 1);
             }
         }
 
@@ -2857,6 +3225,55 @@ private:
         }
     }
 
+   #if JUCE_USE_SSE_INTRINSICS || JUCE_USE_ARM_NEON
+    /*  Runs the IMDCT for four adjacent subbands at once, starting with an even-numbered
+        one, by running the same DCT code on vectors that hold one subband per lane.
+    */
+    static void hybridFourSubbands (float* const fsIn, const float* const rawout1, float* const rawout2,
+                                    const int blockType, float* const ts) noexcept
+    {
+        FloatLanes in[18], out1[18], out2[18], tsLanes[18];
+        FloatLanes::interleave (fsIn, 18, in, 18);
+        FloatLanes::interleave (rawout1, 18, out1, 18);
+
+        if (blockType == 2)
+            DCT::dct12<FloatLanes, 1> (in, out1, out2, constants.interleavedWin[2], tsLanes);
+        else
+            DCT::dct36<FloatLanes, 1> (in, out1, out2, constants.interleavedWin[blockType], tsLanes);
+
+        FloatLanes::deinterleave (out2, rawout2, 18, 18);
+
+        for (int i = 0; i < 18; ++i)
+            tsLanes[i].store (ts + i * DCT::SBLIMIT);
+    }
+
+    /*  Does the same job as the windowing loops in synthesise(), four output samples at a
+        time, using the pre-signed windows from Constants::synthesisWindows.
+    */
+    static void applySynthesisWindow (const float* const b0, const int bo1, float* const out) noexcept
+    {
+        const float (*const coeffs)[16] = constants.synthesisWindows [bo1 >> 1];
+
+        for (int n = 0; n < 32; n += 4)
+        {
+            FloatLanes sums[4];
+
+            for (int i = 0; i < 4; ++i)
+            {
+                const float* const row = b0 + 16 * (n + i <= 16 ? n + i : 32 - (n + i));
+                const float* const c = coeffs [n + i];
+
+                sums[i] = (FloatLanes::load (c)     * FloatLanes::load (row)
+                            + FloatLanes::load (c + 4) * FloatLanes::load (row + 4))
+                        + (FloatLanes::load (c + 8)  * FloatLanes::load (row + 8)
+                            + FloatLanes::load (c + 12) * FloatLanes::load (row + 12));
+            }
+
+            FloatLanes::sumAcross (sums[0], sums[1], sums[2], sums[3]).store (out + n);
+        }
+    }
+   #endif
+
     void synthesiseStereo (const float* bandPtr0, const float* bandPtr1, float* out0, float* out1, int& samplesDone) noexcept
     {
         int dummy = samplesDone;
@@ -2885,6 +3302,16 @@ private:
         }
 
         synthBo = bo;
+
+       #if JUCE_USE_SSE_INTRINSICS || JUCE_USE_ARM_NEON
+        if (FloatLanes::isAvailable())
+        {
+            applySynthesisWindow (b0, bo1, out);
+            samplesDone += 32;
+            return;
+        }
+       #endif
+
         const float* window = constants.decodeWin + 16 - bo1;
 
         for (j = 16; j != 0; --j, b0 += 16, window += 32)
@@ -2939,19 +3366,25 @@ class MP3Reader : public AudioFormatReader
 public:
     MP3Reader (InputStream* const in)
         : AudioFormatReader (in, TRANS (mp3FormatName)),
-          stream (*in), currentPosition (0),
-          decodedStart (0), decodedEnd (0)
+          stream (*in), audioDataStart (0), samplesPerFrame (maxSamplesPerFrame),
+          nextFrameToDecode (0), decodedFrames (numCachedFrames)
     {
+        for (int i = 0; i < numCachedFrames; ++i)
+            decodedFrames[i].frameIndex = -1;
+
         skipID3();
-        const int64 streamPos = stream.stream.getPosition();
+        audioDataStart = stream.stream.getPosition();
 
-        if (readNextBlock())
+        if (decodeNextFrame (decodedFrames[0]))
         {
             bitsPerSample = 32;
             usesFloatingPointData = true;
             sampleRate = stream.frame.getFrequency();
             numChannels = stream.frame.numChannels;
-            lengthInSamples = findLength (streamPos);
+            samplesPerFrame = stream.getSamplesPerFrame();
+            stream.startSeekIndex (audioDataStart);
+            lengthInSamples = findLength (audioDataStart);
+            blockCacheKey = AudioFormatReaderBlockCache::getKeyForStream (input, getFormatName());
         }
     }
 
@@ -2960,47 +3393,13 @@ public:
                       int64 startSampleInFile, int numSamples)
     {
         jassert (destSamples != nullptr);
-
-        if (currentPosition != startSampleInFile)
-        {
-            if (! stream.seek ((int) (startSampleInFile / 1152 - 1)))
-            {
-                currentPosition = -1;
-                createEmptyDecodedData();
-            }
-            else
-            {
-                decodedStart = decodedEnd = 0;
-                const int64 streamPos = stream.currentFrameIndex * 1152;
-                int toSkip = (int) (startSampleInFile - streamPos);
-                jassert (toSkip >= 0);
-
-                while (toSkip > 0)
-                {
-                    if (! readNextBlock())
-                    {
-                        createEmptyDecodedData();
-                        break;
-                    }
-
-                    const int numReady = decodedEnd - decodedStart;
-
-                    if (numReady > toSkip)
-                    {
-                        decodedStart += toSkip;
-                        break;
-                    }
-
-                    toSkip -= numReady;
-                }
-
-                currentPosition = startSampleInFile;
-            }
-        }
+        float* const* const dst = reinterpret_cast <float**> (destSamples);
 
         while (numSamples > 0)
         {
-            if (decodedEnd <= decodedStart && ! readNextBlock())
+            const DecodedFrame* const decoded = getDecodedFrame (startSampleInFile / samplesPerFrame);
+
+            if (decoded == nullptr)
             {
                 for (int i = numDestChannels; --i >= 0;)
                     if (destSamples[i] != nullptr)
@@ -3009,56 +3408,148 @@ public:
                 return false;
             }
 
-            const int numToCopy = jmin (decodedEnd - decodedStart, numSamples);
-            float* const* const dst = reinterpret_cast <float**> (destSamples);
-            memcpy (dst[0] + startOffsetInDestBuffer, decoded0 + decodedStart, sizeof (float) * numToCopy);
+            const int offsetInFrame = (int) (startSampleInFile % samplesPerFrame);
+            const int numToCopy = jmin (samplesPerFrame - offsetInFrame, numSamples);
+            memcpy (dst[0] + startOffsetInDestBuffer, decoded->samples[0] + offsetInFrame, sizeof (float) * numToCopy);
 
             if (numDestChannels > 1 && dst[1] != nullptr)
-                memcpy (dst[1] + startOffsetInDestBuffer, (numChannels < 2 ? decoded0 : decoded1) + decodedStart, sizeof (float) * numToCopy);
+                memcpy (dst[1] + startOffsetInDestBuffer, decoded->samples[numChannels < 2 ? 0 : 1] + offsetInFrame, sizeof (float) * numToCopy);
 
             startOffsetInDestBuffer += numToCopy;
-            decodedStart += numToCopy;
-            currentPosition += numToCopy;
+            startSampleInFile += numToCopy;
             numSamples -= numToCopy;
         }
 
         return true;
     }
 
+    //==============================================================================
+    void saveSeekIndex (MemoryBlock& destData)
+    {
+        // (the whole file gets indexed, so that a reader that's given this data never has to scan it)
+        stream.indexFramesUpTo (std::numeric_limits<int>::max());
+
+        MemoryOutputStream out (destData, false);
+        stream.seekIndex.writeTo (out, input->getTotalLength());
+    }
+
+    bool restoreSeekIndex (const MemoryBlock& indexData)
+    {
+        MemoryInputStream in (indexData, false);
+        MP3SeekIndex newIndex;
+
+        if (! (newIndex.readFrom (in, input->getTotalLength())
+                && newIndex.framePositions.getFirst() == stream.seekIndex.framePositions.getFirst()))
+            return false;
+
+        stream.seekIndex = newIndex;
+        return true;
+    }
+
 private:
+    enum { maxSamplesPerFrame = 1152, numCachedFrames = 16, numWarmUpFrames = 3 };
+
+    struct DecodedFrame
+    {
+        int64 frameIndex;
+        float samples [2][maxSamplesPerFrame];
+    };
+
     MP3Stream stream;
-    int64 currentPosition;
-    enum { decodedDataSize = 1152 };
-    float decoded0 [decodedDataSize], decoded1 [decodedDataSize];
-    int decodedStart, decodedEnd;
+    int64 audioDataStart;
+    int samplesPerFrame;
+    int64 nextFrameToDecode;
+    HeapBlock<DecodedFrame> decodedFrames;
+
+    /*  Returns the samples for a frame, either from the frames that were recently decoded,
+        or by decoding it. Each frame is kept in the slot given by the bottom bits of its
+        index, so a run of consecutive frames can all be cached at once.
+    */
+    const DecodedFrame* getDecodedFrame (const int64 frameIndex)
+    {
+        DecodedFrame& slot = decodedFrames [(int) (frameIndex & (numCachedFrames - 1))];
+
+        if (slot.frameIndex == frameIndex)
+            return &slot;
 
-    void createEmptyDecodedData() noexcept
+        if (frameIndex != nextFrameToDecode && ! seekToFrame (frameIndex))
+            return nullptr;
+
+        return decodeNextFrame (slot) ? &slot : nullptr;
+    }
+
+    /*  Gets the decoder ready to decode the given frame. The frames before it need to be
+        decoded first, because each layer-3 frame depends on the state that the previous
+        ones left behind.
+    */
+    bool seekToFrame (const int64 frameIndex)
     {
-        zeromem (decoded0, sizeof (decoded0));
-        zeromem (decoded1, sizeof (decoded1));
-        decodedStart = 0;
-        decodedEnd = decodedDataSize;
+        // (after restarting part-way through, the first frames won't be accurate)
+        bool framesAreAccurate = true;
+
+        if (frameIndex < nextFrameToDecode || frameIndex > nextFrameToDecode + numWarmUpFrames)
+        {
+            const int64 firstFrame = jmax ((int64) 0, frameIndex - numWarmUpFrames);
+
+            if (stream.indexFramesUpTo ((int) firstFrame))
+            {
+                stream.restartAt (stream.seekIndex.framePositions.getUnchecked ((int) firstFrame), firstFrame);
+                nextFrameToDecode = firstFrame;
+                framesAreAccurate = (firstFrame == 0);
+            }
+            else if (stream.seekIndex.isComplete && firstFrame >= stream.seekIndex.framePositions.size())
+            {
+                return false;
+            }
+            else if (frameIndex < nextFrameToDecode)
+            {
+                // without an index for this frame, the only way to find it is from the start..
+                stream.restartAt (audioDataStart, 0);
+                nextFrameToDecode = 0;
+            }
+        }
+
+        while (nextFrameToDecode < frameIndex)
+        {
+            DecodedFrame& slot = decodedFrames [(int) (nextFrameToDecode & (numCachedFrames - 1))];
+
+            if (! decodeNextFrame (slot))
+                return false;
+
+            if (! framesAreAccurate)
+                slot.frameIndex = -1;
+        }
+
+        return true;
     }
 
-    bool readNextBlock()
+    bool decodeNextFrame (DecodedFrame& dest)
     {
+        dest.frameIndex = -1;
+
         for (int attempts = 10; --attempts >= 0;)
         {
             int samplesDone = 0;
-            const int result = stream.decodeNextBlock (decoded0, decoded1, samplesDone);
+            const int result = stream.decodeNextBlock (dest.samples[0], dest.samples[1], samplesDone);
 
             if (result > 0 && stream.stream.isExhausted())
-            {
-                createEmptyDecodedData();
-                return true;
-            }
+                samplesDone = 0;
+            else if (result > 0)
+                continue;
+            else if (result < 0)
+                break;
 
-            if (result <= 0)
-            {
-                decodedStart = 0;
-                decodedEnd = samplesDone;
-                return result == 0;
-            }
+            // (any frames that come out short are padded, so that every frame starts at a known sample)
+            for (int i = 0; i < 2; ++i)
+                zeromem (dest.samples[i] + samplesDone, sizeof (float) * (size_t) (maxSamplesPerFrame - samplesDone));
+
+            const int samplesExpected = stream.getSamplesPerFrame();
+
+            if (result == 0 && samplesDone < samplesExpected)
+                stream.skipSamples (samplesExpected - samplesDone);
+
+            dest.frameIndex = nextFrameToDecode++;
+            return true;
         }
 
         return false;
@@ -3102,7 +3593,7 @@ private:
                 numFrames = (streamSize - streamStartPos) / (stream.frame.frameSize);
         }
 
-        return numFrames * 1152;
+        return numFrames * samplesPerFrame;
     }
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MP3Reader)
@@ -3137,6 +3628,25 @@ AudioFormatReader* MP3AudioFormat::createReaderFor (InputStream* sourceStream, c
     return nullptr;
 }
 
+bool MP3AudioFormat::saveSeekIndex (AudioFormatReader& reader, MemoryBlock& destData)
+{
+    if (MP3Decoder::MP3Reader* const r = dynamic_cast <MP3Decoder::MP3Reader*> (&reader))
+    {
+        r->saveSeekIndex (destData);
+        return true;
+    }
+
+    return false;
+}
+
+bool MP3AudioFormat::restoreSeekIndex (AudioFormatReader& reader, const MemoryBlock& indexData)
+{
+    if (MP3Decoder::MP3Reader* const r = dynamic_cast <MP3Decoder::MP3Reader*> (&reader))
+        return r->restoreSeekIndex (indexData);
+
+    return false;
+}
+
 AudioFormatWriter* MP3AudioFormat::createWriterFor (OutputStream*, double /*sampleRateToUse*/,
                                                     unsigned int /*numberOfChannels*/, int /*bitsPerSample*/,
                                                     const StringPairArray& /*metadataValues*/, int /*qualityOptionIndex*/)
@@ -59,6 +59,27 @@ public:
     AudioFormatWriter* createWriterFor (OutputStream*, double sampleRateToUse,
                                         unsigned int numberOfChannels, int bitsPerSample,
                                         const StringPairArray& metadataValues, int qualityOptionIndex);
+
+    //==============================================================================
+    /** Saves the index of frame positions that an MP3 reader uses for seeking.
+
+        A reader finds the position of each frame by reading the frame headers the first
+        time it needs to seek past them, so the first seek into a long file can take a
+        moment. Saving the index (e.g. alongside the file's data in an AudioThumbnailCache)
+        and giving it to the next reader that opens the same file with restoreSeekIndex()
+        means that it can seek straight to any frame. This will scan the rest of the file
+        if the reader hasn't already indexed all of it.
+
+        Returns false if the reader wasn't created by an MP3AudioFormat.
+    */
+    static bool saveSeekIndex (AudioFormatReader& reader, MemoryBlock& destData);
+
+    /** Gives a reader an index that was created by saveSeekIndex().
+
+        Returns false if the reader wasn't created by an MP3AudioFormat, or if the
+        data doesn't look like it came from the same file.
+    */
+    static bool restoreSeekIndex (AudioFormatReader& reader, const MemoryBlock& indexData);
 };
 
 #endif
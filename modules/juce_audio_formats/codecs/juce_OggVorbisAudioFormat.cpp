@@ -107,9 +107,7 @@ class OggReader : public AudioFormatReader
 public:
     OggReader (InputStream* const inp)
         : AudioFormatReader (inp, TRANS (oggFormatName)),
-          reservoir (2, 4096),
-          reservoirStart (0),
-          samplesInReservoir (0)
+          cacheCounter (0)
     {
         using namespace OggVorbisNamespace;
         sampleRate = 0;
@@ -130,8 +128,13 @@ public:
             bitsPerSample = 16;
             sampleRate = info->rate;
 
-            reservoir.setSize ((int) numChannels,
-                               (int) jmin (lengthInSamples, (int64) reservoir.getNumSamples()));
+            const int numBlocksNeeded = (int) jmin ((int64) numCachedBlocks,
+                                                    (lengthInSamples + samplesPerBlock - 1) / samplesPerBlock);
+
+            for (int i = 0; i < numBlocksNeeded; ++i)
+                cache.add (new CachedBlock ((int) numChannels));
+
+            blockCacheKey = AudioFormatReaderBlockCache::getKeyForStream (input, getFormatName());
         }
     }
 
@@ -144,79 +147,97 @@ public:
     bool readSamples (int** destSamples, int numDestChannels, int startOffsetInDestBuffer,
                       int64 startSampleInFile, int numSamples)
     {
-        while (numSamples > 0)
+        while (numSamples > 0 && startSampleInFile < lengthInSamples && cache.size() > 0)
         {
-            const int numAvailable = (int) (reservoirStart + samplesInReservoir - startSampleInFile);
+            const int64 blockIndex = startSampleInFile / samplesPerBlock;
+            const int offsetInBlock = (int) (startSampleInFile - blockIndex * samplesPerBlock);
+            const int numToUse = jmin (numSamples, samplesPerBlock - offsetInBlock);
 
-            if (startSampleInFile >= reservoirStart && numAvailable > 0)
-            {
-                // got a few samples overlapping, so use them before seeking..
+            const AudioSampleBuffer& block = getBlock (blockIndex);
 
-                const int numToUse = jmin (numSamples, numAvailable);
+            for (int i = jmin (numDestChannels, block.getNumChannels()); --i >= 0;)
+                if (destSamples[i] != nullptr)
+                    memcpy (destSamples[i] + startOffsetInDestBuffer,
+                            block.getSampleData (i, offsetInBlock),
+                            sizeof (float) * (size_t) numToUse);
 
-                for (int i = jmin (numDestChannels, reservoir.getNumChannels()); --i >= 0;)
-                    if (destSamples[i] != nullptr)
-                        memcpy (destSamples[i] + startOffsetInDestBuffer,
-                                reservoir.getSampleData (i, (int) (startSampleInFile - reservoirStart)),
-                                sizeof (float) * (size_t) numToUse);
+            startSampleInFile += numToUse;
+            numSamples -= numToUse;
+            startOffsetInDestBuffer += numToUse;
+        }
 
-                startSampleInFile += numToUse;
-                numSamples -= numToUse;
-                startOffsetInDestBuffer += numToUse;
+        if (numSamples > 0)
+        {
+            for (int i = numDestChannels; --i >= 0;)
+                if (destSamples[i] != nullptr)
+                    zeromem (destSamples[i] + startOffsetInDestBuffer, sizeof (int) * (size_t) numSamples);
+        }
 
-                if (numSamples == 0)
-                    break;
-            }
+        return true;
+    }
 
-            if (startSampleInFile < reservoirStart
-                || startSampleInFile + numSamples > reservoirStart + samplesInReservoir)
-            {
-                // buffer miss, so refill the reservoir
-                int bitStream = 0;
+    //==============================================================================
+    /** Reads the header of every page in the stream, so that later seeks can jump
+        straight to the right page instead of bisecting the file.
+    */
+    bool buildPageIndex()
+    {
+        using namespace OggVorbisNamespace;
 
-                reservoirStart = jmax (0, (int) startSampleInFile);
-                samplesInReservoir = reservoir.getNumSamples();
+        if (! (ovFile.seekable && ovFile.links == 1))
+            return false;   // chained streams aren't worth indexing, so keep using ov_pcm_seek for them
 
-                if (reservoirStart != (int) OggVorbisNamespace::ov_pcm_tell (&ovFile))
-                    OggVorbisNamespace::ov_pcm_seek (&ovFile, reservoirStart);
+        if (pageOffsets.size() > 0)
+            return true;
 
-                int offset = 0;
-                int numToRead = samplesInReservoir;
+        const int64 originalPosition = input->getPosition();
+        const int64 dataStart = ovFile.dataoffsets[0];
+        const int64 firstGranule = ovFile.pcmlengths[0];
+        const int serialNumber = (int) ovFile.serialnos[0];
 
-                while (numToRead > 0)
-                {
-                    float** dataIn = nullptr;
+        ogg_sync_state sync;
+        ogg_sync_init (&sync);
+        input->setPosition (0);
 
-                    const int samps = OggVorbisNamespace::ov_read_float (&ovFile, &dataIn, numToRead, &bitStream);
-                    if (samps <= 0)
-                        break;
+        int64 pageStart = 0;
 
-                    jassert (samps <= numToRead);
+        for (;;)
+        {
+            ogg_page page;
+            const long pageSize = ogg_sync_pageseek (&sync, &page);
 
-                    for (int i = jmin ((int) numChannels, reservoir.getNumChannels()); --i >= 0;)
-                    {
-                        memcpy (reservoir.getSampleData (i, offset),
-                                dataIn[i],
-                                sizeof (float) * (size_t) samps);
-                    }
+            if (pageSize == 0)
+            {
+                const int bytesToRead = 65536;
+                char* const buffer = ogg_sync_buffer (&sync, bytesToRead);
+                const int bytesRead = input->read (buffer, bytesToRead);
 
-                    numToRead -= samps;
-                    offset += samps;
-                }
+                if (bytesRead <= 0)
+                    break;
 
-                if (numToRead > 0)
-                    reservoir.clear (offset, numToRead);
+                ogg_sync_wrote (&sync, bytesRead);
             }
-        }
+            else if (pageSize < 0)
+            {
+                pageStart -= pageSize;  // skipped some junk
+            }
+            else
+            {
+                const int64 granule = (int64) ogg_page_granulepos (&page);
 
-        if (numSamples > 0)
-        {
-            for (int i = numDestChannels; --i >= 0;)
-                if (destSamples[i] != nullptr)
-                    zeromem (destSamples[i] + startOffsetInDestBuffer, sizeof (int) * (size_t) numSamples);
+                if (pageStart >= dataStart && granule >= 0 && ogg_page_serialno (&page) == serialNumber)
+                {
+                    pageOffsets.add (pageStart);
+                    pageEndSamples.add (granule - firstGranule);
+                }
+
+                pageStart += pageSize;
+            }
         }
 
-        return true;
+        ogg_sync_clear (&sync);
+        input->setPosition (originalPosition);
+        return pageOffsets.size() > 0;
     }
 
     //==============================================================================
@@ -251,8 +272,140 @@ public:
 private:
     OggVorbisNamespace::OggVorbis_File ovFile;
     OggVorbisNamespace::ov_callbacks callbacks;
-    AudioSampleBuffer reservoir;
-    int reservoirStart, samplesInReservoir;
+
+    enum { samplesPerBlock = 4096, numCachedBlocks = 8 };
+
+    struct CachedBlock
+    {
+        CachedBlock (const int numChans)
+            : samples (numChans, (int) samplesPerBlock), blockIndex (-1), lastUsed (0)
+        {}
+
+        AudioSampleBuffer samples;
+        int64 blockIndex;
+        uint32 lastUsed;
+    };
+
+    OwnedArray<CachedBlock> cache;
+    uint32 cacheCounter;
+    Array<int64> pageOffsets, pageEndSamples;
+
+    const AudioSampleBuffer& getBlock (const int64 blockIndex)
+    {
+        CachedBlock* leastRecentlyUsed = cache.getUnchecked (0);
+
+        for (int i = 0; i < cache.size(); ++i)
+        {
+            CachedBlock* const b = cache.getUnchecked (i);
+
+            if (b->blockIndex == blockIndex)
+            {
+                b->lastUsed = ++cacheCounter;
+                return b->samples;
+            }
+
+            if (b->lastUsed < leastRecentlyUsed->lastUsed)
+                leastRecentlyUsed = b;
+        }
+
+        leastRecentlyUsed->blockIndex = blockIndex;
+        leastRecentlyUsed->lastUsed = ++cacheCounter;
+        decodeBlock (leastRecentlyUsed->samples, blockIndex * samplesPerBlock);
+        return leastRecentlyUsed->samples;
+    }
+
+    void decodeBlock (AudioSampleBuffer& block, const int64 startSample)
+    {
+        if (startSample != (int64) OggVorbisNamespace::ov_pcm_tell (&ovFile))
+            seekTo (startSample);
+
+        int offset = 0;
+
+        while (offset < samplesPerBlock)
+        {
+            float** dataIn = nullptr;
+            const int samps = decodeNextSamples (dataIn, samplesPerBlock - offset);
+
+            if (samps <= 0)
+                break;
+
+            for (int i = jmin ((int) numChannels, block.getNumChannels()); --i >= 0;)
+                memcpy (block.getSampleData (i, offset), dataIn[i], sizeof (float) * (size_t) samps);
+
+            offset += samps;
+        }
+
+        if (offset < samplesPerBlock)
+            block.clear (offset, samplesPerBlock - offset);
+    }
+
+    int decodeNextSamples (float**& dataIn, const int maxSamples)
+    {
+        int bitStream = 0;
+        return (int) OggVorbisNamespace::ov_read_float (&ovFile, &dataIn, maxSamples, &bitStream);
+    }
+
+    void seekTo (const int64 targetSample)
+    {
+        using namespace OggVorbisNamespace;
+
+        if (pageOffsets.size() > 0)
+        {
+            // The first packet after a raw seek only primes the decoder, so if the target is
+            // near the start of its page, it won't be in the output, and we need to go back
+            // to the previous page instead.
+            int page = jmin (findPageContaining (targetSample), pageOffsets.size() - 1);
+
+            for (;;)
+            {
+                if (ov_raw_seek (&ovFile, (ogg_int64_t) pageOffsets.getUnchecked (page)) == 0)
+                {
+                    int64 position = (int64) ov_pcm_tell (&ovFile);
+
+                    if (position <= targetSample)
+                    {
+                        while (position < targetSample)
+                        {
+                            float** dataIn = nullptr;
+                            const int samps = decodeNextSamples (dataIn, (int) jmin ((int64) samplesPerBlock,
+                                                                                     targetSample - position));
+                            if (samps <= 0)
+                                break;
+
+                            position += samps;
+                        }
+
+                        if (position == targetSample)
+                            return;
+
+                        break;
+                    }
+                }
+
+                if (--page < 0)
+                    break;
+            }
+        }
+
+        ov_pcm_seek (&ovFile, (ogg_int64_t) targetSample);
+    }
+
+    int findPageContaining (const int64 sample) const
+    {
+        int start = 0, end = pageEndSamples.size();
+
+        while (start < end)
+        {
+            const int middle = (start + end) / 2;
+
+            if (pageEndSamples.getUnchecked (middle) > sample)
+                end = middle;
+            else
+                start = middle + 1;
+        }
+
+        return start;
+    }
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (OggReader)
 };
@@ -451,6 +604,11 @@ Array<int> OggVorbisAudioFormat::getPossibleBitDepths()
 
 bool OggVorbisAudioFormat::canDoStereo()    { return true; }
 bool OggVorbisAudioFormat::canDoMono()      { return true; }
+
+bool OggVorbisAudioFormat::canHandleData (const void* data, int numBytes)
+{
+    return numBytes < 4 || memcmp (data, "OggS", 4) == 0;
+}
 bool OggVorbisAudioFormat::isCompressed()   { return true; }
 
 AudioFormatReader* OggVorbisAudioFormat::createReaderFor (InputStream* in, const bool deleteStreamIfOpeningFails)
@@ -466,6 +624,14 @@ AudioFormatReader* OggVorbisAudioFormat::createReaderFor (InputStream* in, const
     return nullptr;
 }
 
+bool OggVorbisAudioFormat::buildSeekIndex (AudioFormatReader& reader)
+{
+    if (OggReader* const r = dynamic_cast <OggReader*> (&reader))
+        return r->buildPageIndex();
+
+    return false;
+}
+
 AudioFormatWriter* OggVorbisAudioFormat::createWriterFor (OutputStream* out,
                                                           double sampleRate,
                                                           unsigned int numChannels,
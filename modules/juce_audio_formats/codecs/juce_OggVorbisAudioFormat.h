@@ -44,6 +44,7 @@ public:
     Array<int> getPossibleBitDepths();
     bool canDoStereo();
     bool canDoMono();
+    bool canHandleData (const void* firstBytesOfStream, int numBytes);
     bool isCompressed();
     StringArray getQualityOptions();
 
@@ -85,6 +86,22 @@ public:
                                         const StringPairArray& metadataValues,
                                         int qualityOptionIndex);
 
+    //==============================================================================
+    /** Scans an Ogg reader's stream and builds an index of its pages, to make seeking faster.
+
+        Without an index, a reader has to bisect the file to find the page that contains a
+        position each time it needs to jump somewhere that isn't already in its cache of
+        recently decoded blocks. Once it has an index, it can go straight to the right page.
+        This reads the header of every page in the file, so it's worth doing for a reader
+        that will be used for a lot of random access (e.g. by a sampler), but not for one
+        that will just be read from start to end.
+
+        Returns false if the reader wasn't created by an OggVorbisAudioFormat, or if its
+        stream can't be indexed (e.g. a chained stream), in which case it'll carry on
+        seeking the normal way.
+    */
+    static bool buildSeekIndex (AudioFormatReader& reader);
+
 private:
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (OggVorbisAudioFormat)
 };
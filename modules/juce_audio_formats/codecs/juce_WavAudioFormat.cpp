@@ -639,9 +639,10 @@ public:
                             subFormat.data3 = (uint16) input->readShort();
                             input->read (subFormat.data4, sizeof (subFormat.data4));
 
-                            if (memcmp (&subFormat, &pcmFormat, sizeof (subFormat)) != 0
-                                 && memcmp (&subFormat, &IEEEFloatFormat, sizeof (subFormat)) != 0
-                                 && memcmp (&subFormat, &ambisonicFormat, sizeof (subFormat)) != 0)
+                            if (memcmp (&subFormat, &IEEEFloatFormat, sizeof (subFormat)) == 0)
+                                usesFloatingPointData = true;
+                            else if (memcmp (&subFormat, &pcmFormat, sizeof (subFormat)) != 0
+                                      && memcmp (&subFormat, &ambisonicFormat, sizeof (subFormat)) != 0)
                                 bytesPerFrame = 0;
                         }
                     }
@@ -834,6 +835,7 @@ public:
                           const unsigned int numChannels_, const unsigned int bits,
                           const StringPairArray& metadataValues)
         : AudioFormatWriter (out, TRANS (wavFormatName), sampleRate_, numChannels_, bits),
+          int16ScratchSize (0),
           lengthInSamples (0),
           bytesWritten (0),
           writeFailed (false)
@@ -889,7 +891,74 @@ public:
             default:    jassertfalse; break;
         }
 
-        if (! output->write (tempBlock.getData(), bytes))
+        return writeData (tempBlock.getData(), bytes, numSamples);
+    }
+
+    bool writeFromFloatArrays (const float** channels, int numSourceChannels, int numSamples)
+    {
+        if (numSamples <= 0)
+            return true;
+
+        if (writeFailed)
+            return false;
+
+        // (any channels that the caller hasn't provided get written as silence)
+        const float* chans [256];
+        jassert ((int) numChannels < numElementsInArray (chans));
+
+        for (int i = 0; i < (int) numChannels; ++i)
+            chans[i] = i < numSourceChannels ? channels[i] : nullptr;
+
+        chans[numChannels] = nullptr;
+
+        const size_t bytes = numChannels * (unsigned int) numSamples * bitsPerSample / 8;
+
+       #if JUCE_LITTLE_ENDIAN
+        // A mono float file is just the caller's data, so there's nothing to convert..
+        if (bitsPerSample == 32 && numChannels == 1 && chans[0] != nullptr)
+            return writeData (chans[0], bytes, numSamples);
+       #endif
+
+        tempBlock.ensureSize (bytes, false);
+
+        switch (bitsPerSample)
+        {
+            case 8:     WriteHelper<AudioData::UInt8,   AudioData::Float32, AudioData::LittleEndian>::write (tempBlock.getData(), (int) numChannels, (const int**) chans, numSamples); break;
+            case 16:    writeFloatsAsInt16 (chans, numSamples); break;
+            case 24:    WriteHelper<AudioData::Int24,   AudioData::Float32, AudioData::LittleEndian>::write (tempBlock.getData(), (int) numChannels, (const int**) chans, numSamples); break;
+            case 32:    WriteHelper<AudioData::Float32, AudioData::Float32, AudioData::LittleEndian>::write (tempBlock.getData(), (int) numChannels, (const int**) chans, numSamples); break;
+            default:    jassertfalse; break;
+        }
+
+        return writeData (tempBlock.getData(), bytes, numSamples);
+    }
+
+    bool flush()
+    {
+        if (writeFailed)
+            return false;
+
+        const int64 lastWritePos = output->getPosition();
+        writeHeader();
+
+        if (! output->setPosition (lastWritePos))
+            return false;
+
+        output->flush();
+        return true;
+    }
+
+private:
+    MemoryBlock tempBlock, bwavChunk, smplChunk, instChunk, cueChunk, listChunk;
+    HeapBlock<int16> int16Scratch;
+    int int16ScratchSize;
+    uint64 lengthInSamples, bytesWritten;
+    int64 headerPosition;
+    bool writeFailed;
+
+    bool writeData (const void* data, size_t bytes, int numSamples)
+    {
+        if (! output->write (data, bytes))
         {
             // failed to write to disk, so let's try writing the header.
             // If it's just run out of disk space, then if it does manage
@@ -898,20 +967,55 @@ public:
             writeFailed = true;
             return false;
         }
-        else
+
+        bytesWritten += bytes;
+        lengthInSamples += (uint64) numSamples;
+        return true;
+    }
+
+    // Converts each channel with the vectorised routine, and then interleaves the results into tempBlock
+    void writeFloatsAsInt16 (const float* const* chans, int numSamples)
+    {
+        // (this is the same full-scale value that the generic float-to-int path uses)
+        const float multiplier = 32768.0f;
+        int16* const dest = static_cast<int16*> (tempBlock.getData());
+
+        if (numChannels == 1 && chans[0] != nullptr)
         {
-            bytesWritten += bytes;
-            lengthInSamples += numSamples;
+            FloatVectorOperations::convertFloatToInt16 (dest, chans[0], multiplier, numSamples);
 
-            return true;
+           #if JUCE_BIG_ENDIAN
+            for (int i = 0; i < numSamples; ++i)
+                dest[i] = (int16) ByteOrder::swap ((uint16) dest[i]);
+           #endif
+
+            return;
         }
-    }
 
-private:
-    MemoryBlock tempBlock, bwavChunk, smplChunk, instChunk, cueChunk, listChunk;
-    uint64 lengthInSamples, bytesWritten;
-    int64 headerPosition;
-    bool writeFailed;
+        if (int16ScratchSize < numSamples)
+        {
+            int16ScratchSize = numSamples;
+            int16Scratch.malloc ((size_t) numSamples);
+        }
+
+        for (int ch = 0; ch < (int) numChannels; ++ch)
+        {
+            int16* d = dest + ch;
+
+            if (chans[ch] == nullptr)
+            {
+                for (int i = numSamples; --i >= 0; d += numChannels)
+                    *d = 0;
+            }
+            else
+            {
+                FloatVectorOperations::convertFloatToInt16 (int16Scratch, chans[ch], multiplier, numSamples);
+
+                for (int i = 0; i < numSamples; ++i, d += numChannels)
+                    *d = (int16) ByteOrder::swapIfBigEndian ((uint16) int16Scratch[i]);
+            }
+        }
+    }
 
     static int getChannelMask (const int numChannels) noexcept
     {
@@ -1111,6 +1215,24 @@ public:
         }
     }
 
+protected:
+    bool convertMappedSamplesToFloat (float* const* destSamples, int numDestChannels, int startOffsetInDestBuffer,
+                                      int64 startSampleInFile, int numSamples) const
+    {
+        const void* const sourceData = sampleToPointer (startSampleInFile);
+
+        switch (bitsPerSample)
+        {
+            case 8:     ReadHelper<AudioData::Float32, AudioData::UInt8, AudioData::LittleEndian>::read (destSamples, startOffsetInDestBuffer, numDestChannels, sourceData, (int) numChannels, numSamples); return true;
+            case 16:    ReadHelper<AudioData::Float32, AudioData::Int16, AudioData::LittleEndian>::read (destSamples, startOffsetInDestBuffer, numDestChannels, sourceData, (int) numChannels, numSamples); return true;
+            case 24:    ReadHelper<AudioData::Float32, AudioData::Int24, AudioData::LittleEndian>::read (destSamples, startOffsetInDestBuffer, numDestChannels, sourceData, (int) numChannels, numSamples); return true;
+            case 32:    if (usesFloatingPointData) ReadHelper<AudioData::Float32, AudioData::Float32, AudioData::LittleEndian>::read (destSamples, startOffsetInDestBuffer, numDestChannels, sourceData, (int) numChannels, numSamples);
+                        else                       ReadHelper<AudioData::Float32, AudioData::Int32,   AudioData::LittleEndian>::read (destSamples, startOffsetInDestBuffer, numDestChannels, sourceData, (int) numChannels, numSamples);
+                        return true;
+            default:    return false;
+        }
+    }
+
 private:
     template <typename SampleType>
     void scanMinAndMax (int64 startSampleInFile, int64 numSamples,
@@ -1155,6 +1277,17 @@ Array<int> WavAudioFormat::getPossibleBitDepths()
 bool WavAudioFormat::canDoStereo()  { return true; }
 bool WavAudioFormat::canDoMono()    { return true; }
 
+bool WavAudioFormat::canHandleData (const void* data, int numBytes)
+{
+    if (numBytes < 12)
+        return true;
+
+    const char* const d = static_cast<const char*> (data);
+
+    return (memcmp (d, "RIFF", 4) == 0 || memcmp (d, "RF64", 4) == 0)
+             && memcmp (d + 8, "WAVE", 4) == 0;
+}
+
 AudioFormatReader* WavAudioFormat::createReaderFor (InputStream* sourceStream,
                                                     const bool deleteStreamIfOpeningFails)
 {
@@ -136,6 +136,7 @@ public:
     Array<int> getPossibleBitDepths();
     bool canDoStereo();
     bool canDoMono();
+    bool canHandleData (const void* firstBytesOfStream, int numBytes);
 
     //==============================================================================
     AudioFormatReader* createReaderFor (InputStream* sourceStream,
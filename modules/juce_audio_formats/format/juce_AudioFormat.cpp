@@ -42,6 +42,11 @@ bool AudioFormat::canHandleFile (const File& f)
     return false;
 }
 
+bool AudioFormat::canHandleData (const void*, int)
+{
+    return true;
+}
+
 const String& AudioFormat::getFormatName() const                { return formatName; }
 const StringArray& AudioFormat::getFileExtensions() const       { return fileExtensions; }
 bool AudioFormat::isCompressed()                                { return false; }
@@ -68,6 +68,21 @@ public:
     */
     virtual bool canHandleFile (const File& fileToTest);
 
+    /** Checks whether some data could be the start of a stream in this format.
+
+        This is used by the AudioFormatManager to skip formats that obviously can't open a
+        stream without the expense of trying to create a reader for it, so it should
+        only look for a signature or "magic number" in the first few bytes. It should return
+        false only if it's sure that the data isn't in this format, so if there are too few
+        bytes to tell, it should return true. The base class implementation always returns
+        true.
+
+        @param firstBytesOfStream   the data from the start of the stream
+        @param numBytes             the number of bytes available, which may be fewer than
+                                    the format needs to make a decision
+    */
+    virtual bool canHandleData (const void* firstBytesOfStream, int numBytes);
+
     /** Returns a set of sample rates that the format can read and write. */
     virtual Array<int> getPossibleSampleRates() = 0;
 
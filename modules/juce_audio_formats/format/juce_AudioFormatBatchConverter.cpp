@@ -0,0 +1,147 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+
+class AudioFormatBatchConverter::ConversionJob  : public ThreadPoolJob
+{
+public:
+    ConversionJob (AudioFormatBatchConverter& c, AudioFormatReader* const r,
+                   AudioFormatWriter* const w, const int64 start, const int64 num)
+        : ThreadPoolJob ("Audio format conversion"),
+          owner (c), reader (r), writer (w), startSample (start), numSamples (num)
+    {
+        ++owner.numJobsRemaining;
+        owner.totalSamples += numSamples;
+    }
+
+    ~ConversionJob()
+    {
+        writer = nullptr;
+        reader = nullptr;
+
+        --owner.numJobsRemaining;
+        owner.jobFinished.signal();
+    }
+
+    JobStatus runJob()
+    {
+        const int64 samplesPerBlock = 65536;
+
+        for (int64 done = 0; done < numSamples && ! shouldExit();)
+        {
+            const int64 numToDo = jmin (samplesPerBlock, numSamples - done);
+
+            if (! writer->writeFromAudioReader (*reader, startSample + done, numToDo))
+            {
+                ++owner.numJobsFailed;
+                break;
+            }
+
+            done += numToDo;
+            owner.samplesDone += numToDo;
+        }
+
+        writer = nullptr;
+        reader = nullptr;
+        return jobHasFinished;
+    }
+
+private:
+    AudioFormatBatchConverter& owner;
+    ScopedPointer<AudioFormatReader> reader;
+    ScopedPointer<AudioFormatWriter> writer;
+    const int64 startSample, numSamples;
+
+    JUCE_DECLARE_NON_COPYABLE (ConversionJob)
+};
+
+//==============================================================================
+AudioFormatBatchConverter::AudioFormatBatchConverter()
+{
+}
+
+AudioFormatBatchConverter::AudioFormatBatchConverter (const int numJobsToRunAtOnce)
+    : threadPool (jmax (1, numJobsToRunAtOnce))
+{
+}
+
+AudioFormatBatchConverter::~AudioFormatBatchConverter()
+{
+    cancelAllJobs();
+}
+
+void AudioFormatBatchConverter::addJob (AudioFormatReader* const sourceReader,
+                                        AudioFormatWriter* const destWriter,
+                                        const int64 startSample, int64 numSamples)
+{
+    if (sourceReader == nullptr || destWriter == nullptr)
+    {
+        delete sourceReader;
+        delete destWriter;
+        return;
+    }
+
+    if (numSamples < 0)
+        numSamples = sourceReader->lengthInSamples - startSample;
+
+    threadPool.addJob (new ConversionJob (*this, sourceReader, destWriter, startSample, jmax ((int64) 0, numSamples)), true);
+}
+
+bool AudioFormatBatchConverter::waitUntilFinished (const int timeOutMilliseconds)
+{
+    const uint32 startTime = Time::getMillisecondCounter();
+
+    while (numJobsRemaining.get() > 0)
+    {
+        if (timeOutMilliseconds < 0)
+        {
+            jobFinished.wait (100);
+        }
+        else
+        {
+            const int remaining = timeOutMilliseconds - (int) (Time::getMillisecondCounter() - startTime);
+
+            if (remaining <= 0)
+                return false;
+
+            jobFinished.wait (jmin (100, remaining));
+        }
+    }
+
+    return true;
+}
+
+void AudioFormatBatchConverter::cancelAllJobs()
+{
+    threadPool.removeAllJobs (true, -1);
+}
+
+int AudioFormatBatchConverter::getNumJobsRemaining() const noexcept    { return numJobsRemaining.get(); }
+int AudioFormatBatchConverter::getNumJobsFailed() const noexcept       { return numJobsFailed.get(); }
+
+double AudioFormatBatchConverter::getProgress() const noexcept
+{
+    const int64 total = totalSamples.get();
+    return total > 0 ? samplesDone.get() / (double) total : 1.0;
+}
@@ -0,0 +1,125 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+
+#ifndef __JUCE_AUDIOFORMATBATCHCONVERTER_JUCEHEADER__
+#define __JUCE_AUDIOFORMATBATCHCONVERTER_JUCEHEADER__
+
+#include "juce_AudioFormatReader.h"
+#include "juce_AudioFormatWriter.h"
+
+
+//==============================================================================
+/**
+    Copies audio from a set of AudioFormatReaders into AudioFormatWriters, running
+    several of the copies at once on a pool of threads.
+
+    This is handy for converting a batch of files between formats, e.g.
+
+    @code
+    AudioFormatBatchConverter converter;
+
+    for (int i = 0; i < sourceFiles.size(); ++i)
+    {
+        AudioFormatReader* reader = formatManager.createReaderFor (sourceFiles[i]);
+
+        if (reader != nullptr)
+            converter.addJob (reader, flacFormat.createWriterFor (destStreams[i], reader->sampleRate,
+                                                                  reader->numChannels, 24,
+                                                                  StringPairArray(), 5));
+    }
+
+    converter.waitUntilFinished();
+    @endcode
+
+    Each writer is deleted (and so finishes its file) on the thread that ran its job,
+    so it's fine for the writers to be ones that take a long time to close.
+
+    @see AudioFormatWriter::writeFromAudioReader
+*/
+class JUCE_API  AudioFormatBatchConverter
+{
+public:
+    //==============================================================================
+    /** Creates a converter that runs one job for each CPU core at a time. */
+    AudioFormatBatchConverter();
+
+    /** Creates a converter that runs the given number of jobs at a time. */
+    explicit AudioFormatBatchConverter (int numJobsToRunAtOnce);
+
+    /** Destructor.
+        Any jobs that haven't finished are stopped, and their readers and writers are
+        deleted, so the files they were writing will be incomplete. Call
+        waitUntilFinished() first if you want to let them finish.
+    */
+    ~AudioFormatBatchConverter();
+
+    //==============================================================================
+    /** Adds a job that copies samples from a reader into a writer.
+
+        The converter takes ownership of both objects, and deletes them when the job has
+        finished. If numSamples is less than 0, everything from startSample to the end of
+        the reader is copied. If either object is null, the other one is just deleted.
+    */
+    void addJob (AudioFormatReader* sourceReader,
+                 AudioFormatWriter* destWriter,
+                 int64 startSample = 0,
+                 int64 numSamples = -1);
+
+    /** Waits for all the jobs that have been added to finish.
+        Returns false if the timeout expires first; a timeout of less than zero means
+        wait forever.
+    */
+    bool waitUntilFinished (int timeOutMilliseconds = -1);
+
+    /** Stops all the jobs, without waiting for them to finish their files. */
+    void cancelAllJobs();
+
+    //==============================================================================
+    /** Returns the number of jobs that are running or waiting to run. */
+    int getNumJobsRemaining() const noexcept;
+
+    /** Returns the number of jobs that stopped because their reader or writer failed. */
+    int getNumJobsFailed() const noexcept;
+
+    /** Returns the proportion of all the samples added so far that have been copied,
+        from 0 to 1.0.
+    */
+    double getProgress() const noexcept;
+
+private:
+    //==============================================================================
+    class ConversionJob;
+    friend class ConversionJob;
+
+    ThreadPool threadPool;
+    Atomic<int> numJobsRemaining, numJobsFailed;
+    Atomic<int64> totalSamples, samplesDone;
+    WaitableEvent jobFinished;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioFormatBatchConverter)
+};
+
+
+#endif   // __JUCE_AUDIOFORMATBATCHCONVERTER_JUCEHEADER__
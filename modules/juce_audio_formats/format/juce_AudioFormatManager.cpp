@@ -126,20 +126,42 @@ String AudioFormatManager::getWildcardForAllFormats() const
 }
 
 //==============================================================================
-AudioFormatReader* AudioFormatManager::createReaderFor (const File& file)
+AudioFormatReader* AudioFormatManager::createReaderFor (const File& file, const int streamAccessFlags)
 {
     // you need to actually register some formats before the manager can
     // use them to open a file!
     jassert (getNumKnownFormats() > 0);
 
+    ScopedPointer<InputStream> in;
+    char header [numBytesToSniff];
+    int headerSize = 0;
+
     for (int i = 0; i < getNumKnownFormats(); ++i)
     {
         AudioFormat* const af = getKnownFormat(i);
 
         if (af->canHandleFile (file))
-            if (InputStream* const in = file.createInputStream())
-                if (AudioFormatReader* const r = af->createReaderFor (in, true))
+        {
+            // (the file's only opened once a format has claimed its extension)
+            if (in == nullptr)
+            {
+                in = file.createInputStream (streamAccessFlags);
+
+                if (in == nullptr)
+                    return nullptr;
+
+                headerSize = jmax (0, in->read (header, sizeof (header)));
+            }
+
+            if (af->canHandleData (header, headerSize) && in->setPosition (0))
+            {
+                if (AudioFormatReader* const r = af->createReaderFor (in, false))
+                {
+                    in.release();
                     return r;
+                }
+            }
+        }
     }
 
     return nullptr;
@@ -157,9 +179,18 @@ AudioFormatReader* AudioFormatManager::createReaderFor (InputStream* audioFileSt
     {
         const int64 originalStreamPos = in->getPosition();
 
+        char header [numBytesToSniff];
+        const int headerSize = jmax (0, in->read (header, sizeof (header)));
+        in->setPosition (originalStreamPos);
+
         for (int i = 0; i < getNumKnownFormats(); ++i)
         {
-            if (AudioFormatReader* const r = getKnownFormat(i)->createReaderFor (in, false))
+            AudioFormat* const af = getKnownFormat(i);
+
+            if (! af->canHandleData (header, headerSize))
+                continue;
+
+            if (AudioFormatReader* const r = af->createReaderFor (in, false))
             {
                 in.release();
                 return r;
@@ -175,3 +206,118 @@ AudioFormatReader* AudioFormatManager::createReaderFor (InputStream* audioFileSt
 
     return nullptr;
 }
+
+//==============================================================================
+AudioFormatManager::FileInfo::FileInfo() noexcept
+    : sampleRate (0), lengthInSamples (0), numChannels (0),
+      bitsPerSample (0), usesFloatingPointData (false)
+{
+}
+
+AudioFormatManager::FileInfo AudioFormatManager::getFileInfo (const File& audioFile)
+{
+    FileInfo info;
+    info.file = audioFile;
+
+    const ScopedPointer<AudioFormatReader> reader (createReaderFor (audioFile, File::sequentialAccess));
+
+    if (reader != nullptr)
+    {
+        info.formatName             = reader->getFormatName();
+        info.sampleRate             = reader->sampleRate;
+        info.lengthInSamples        = reader->lengthInSamples;
+        info.numChannels            = reader->numChannels;
+        info.bitsPerSample          = reader->bitsPerSample;
+        info.usesFloatingPointData  = reader->usesFloatingPointData;
+        info.metadataValues         = reader->metadataValues;
+    }
+
+    return info;
+}
+
+namespace AudioFormatManagerHelpers
+{
+    struct FileInfoFunction
+    {
+        FileInfoFunction (AudioFormatManager& m, const Array<File>& f, Array<AudioFormatManager::FileInfo>& r) noexcept
+            : manager (&m), files (&f), results (&r)
+        {}
+
+        void operator() (const int index) const
+        {
+            results->getReference (index) = manager->getFileInfo (files->getReference (index));
+        }
+
+        AudioFormatManager* manager;
+        const Array<File>* files;
+        Array<AudioFormatManager::FileInfo>* results;
+    };
+}
+
+void AudioFormatManager::getFileInfo (const Array<File>& audioFiles, Array<FileInfo>& results, ThreadPool& threadPool)
+{
+    results.clearQuick();
+    results.insertMultiple (0, FileInfo(), audioFiles.size());
+
+    // (each file takes a while to open, so it's worth giving every one its own task)
+    threadPool.parallelFor (0, audioFiles.size(),
+                            AudioFormatManagerHelpers::FileInfoFunction (*this, audioFiles, results), 1);
+}
+
+//==============================================================================
+#if JUCE_BENCHMARKS
+
+class AudioFormatBenchmarks  : public Benchmark
+{
+public:
+    AudioFormatBenchmarks() : Benchmark ("Audio formats") {}
+
+    enum { numSamples = 44100 * 5 };
+
+    void runBenchmark()
+    {
+        AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+
+        AudioSampleBuffer source (2, numSamples), dest (2, numSamples);
+        Random r (1234);
+
+        for (int chan = 0; chan < 2; ++chan)
+            for (int i = 0; i < numSamples; ++i)
+                *source.getSampleData (chan, i) = (r.nextFloat() - 0.5f) * 0.5f;
+
+        for (int i = 0; i < formatManager.getNumKnownFormats(); ++i)
+        {
+            AudioFormat* const format = formatManager.getKnownFormat (i);
+
+            const Array<int> bitDepths (format->getPossibleBitDepths());
+            const int bitDepth = bitDepths.contains (16) ? 16 : bitDepths.getFirst();
+            const String name (format->getFormatName() + ", " + String (bitDepth) + " bit, 5 seconds of stereo");
+
+            MemoryBlock encoded;
+
+            beginMeasurement (name + ": write", 10, 1);
+            while (keepRunning())
+            {
+                encoded.setSize (0);
+                ScopedPointer<AudioFormatWriter> writer (format->createWriterFor (new MemoryOutputStream (encoded, false),
+                                                                                  44100.0, 2, bitDepth, StringPairArray(), 0));
+                if (writer != nullptr)
+                    writer->writeFromAudioSampleBuffer (source, 0, numSamples);
+            }
+
+            beginMeasurement (name + ": read", 10, 1);
+            while (keepRunning())
+            {
+                ScopedPointer<AudioFormatReader> reader (format->createReaderFor (new MemoryInputStream (encoded, false), true));
+
+                if (reader != nullptr)
+                    reader->read (&dest, 0, numSamples, 0, true, true);
+            }
+        }
+    }
+};
+
+static AudioFormatBenchmarks audioFormatBenchmarks;
+
+#endif
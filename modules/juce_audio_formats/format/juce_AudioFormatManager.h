@@ -116,8 +116,17 @@ public:
 
         If none of the registered formats can open the file, it'll return 0. If it
         returns a reader, it's the caller's responsibility to delete the reader.
+
+        The streamAccessFlags are passed to File::createInputStream() - e.g. a reader
+        that is streaming from disk could use File::sequentialAccess | File::dontCache,
+        so that playing it doesn't push other files out of the OS's cache.
+
+        The file is only opened once: the first few bytes are read and checked against
+        each format whose extension matches (see AudioFormat::canHandleData()), and the
+        same stream is then handed to each of the candidates in turn.
     */
-    AudioFormatReader* createReaderFor (const File& audioFile);
+    AudioFormatReader* createReaderFor (const File& audioFile,
+                                        int streamAccessFlags = File::defaultAccess);
 
     /** Searches through the known formats to try to create a suitable reader for
         this stream.
@@ -133,11 +142,57 @@ public:
     */
     AudioFormatReader* createReaderFor (InputStream* audioFileStream);
 
+    //==============================================================================
+    /** Describes an audio file's format and contents.
+        @see getFileInfo
+    */
+    struct JUCE_API  FileInfo
+    {
+        FileInfo() noexcept;
+
+        /** Returns true if the file could be opened. */
+        bool isValid() const noexcept           { return sampleRate > 0 && numChannels > 0; }
+
+        File file;                          /**< The file that this describes. */
+        String formatName;                  /**< The name of the format that opened the file, or empty if none could. */
+        double sampleRate;                  /**< As for AudioFormatReader::sampleRate. */
+        int64 lengthInSamples;              /**< As for AudioFormatReader::lengthInSamples. */
+        unsigned int numChannels;           /**< As for AudioFormatReader::numChannels. */
+        unsigned int bitsPerSample;         /**< As for AudioFormatReader::bitsPerSample. */
+        bool usesFloatingPointData;         /**< As for AudioFormatReader::usesFloatingPointData. */
+        StringPairArray metadataValues;     /**< As for AudioFormatReader::metadataValues. */
+    };
+
+    /** Opens a file just long enough to find out its format, length and metadata.
+
+        If no format can open it, the FileInfo that's returned will have its file set, but
+        isValid() will return false.
+    */
+    FileInfo getFileInfo (const File& audioFile);
+
+    /** Finds the FileInfo for a whole list of files, using a ThreadPool to open lots of
+        them at once.
+
+        This is much quicker than calling getFileInfo() on each file in turn when scanning
+        a big library, because the time is mostly spent waiting for the disk. The results
+        array is cleared and filled with one FileInfo for each file, in the same order as
+        the list. The method doesn't return until all the files have been done, and the
+        calling thread helps with the work while it's waiting.
+
+        The formats are used from several threads at once while this is running, so you
+        mustn't register or clear any formats until it returns.
+    */
+    void getFileInfo (const Array<File>& audioFiles,
+                      Array<FileInfo>& results,
+                      ThreadPool& threadPool);
+
 private:
     //==============================================================================
     OwnedArray<AudioFormat> knownFormats;
     int defaultFormatIndex;
 
+    enum { numBytesToSniff = 64 };
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioFormatManager)
 };
 
@@ -29,6 +29,7 @@ AudioFormatReader::AudioFormatReader (InputStream* const in, const String& name)
       numChannels (0),
       usesFloatingPointData (false),
       input (in),
+      blockCacheKey (0),
       formatName (name)
 {
 }
@@ -64,9 +65,9 @@ bool AudioFormatReader::read (int* const* destSamples,
     if (numSamplesToRead <= 0)
         return true;
 
-    if (! readSamples (const_cast <int**> (destSamples),
-                       jmin ((int) numChannels, numDestChannels), startOffsetInDestBuffer,
-                       startSampleInSource, numSamplesToRead))
+    if (! AudioFormatReaderBlockCache::readSamples (*this, const_cast <int**> (destSamples),
+                                                    jmin ((int) numChannels, numDestChannels), startOffsetInDestBuffer,
+                                                    startSampleInSource, numSamplesToRead))
         return false;
 
     if (numDestChannels > (int) numChannels)
@@ -159,104 +160,66 @@ void AudioFormatReader::read (AudioSampleBuffer* buffer,
     }
 }
 
-template <typename SampleType>
-static inline void getChannelMinAndMax (SampleType* channel, const int numSamples, SampleType& mn, SampleType& mx)
+void AudioFormatReader::readMaxLevels (int64 startSampleInFile, int64 numSamples,
+                                       Range<float>* const results, const int numChannelsToRead)
 {
-    findMinAndMax (channel, numSamples, mn, mx);
-}
+    jassert (numChannelsToRead > 0);
 
-static inline void getChannelMinAndMax (float* channel, const int numSamples, float& mn, float& mx)
-{
-    FloatVectorOperations::findMinAndMax (channel, numSamples, mn, mx);
-}
+    for (int i = 0; i < numChannelsToRead; ++i)
+        results[i] = Range<float>();
 
-template <typename SampleType>
-static void getStereoMinAndMax (SampleType* const* channels, const int numChannels, const int numSamples,
-                                SampleType& lmin, SampleType& lmax, SampleType& rmin, SampleType& rmax)
-{
-    SampleType bufMin, bufMax;
-    getChannelMinAndMax (channels[0], numSamples, bufMin, bufMax);
-    lmax = jmax (lmax, bufMax);
-    lmin = jmin (lmin, bufMin);
+    const int numChans = jmin (numChannelsToRead, (int) numChannels);
 
-    if (numChannels > 1)
-    {
-        getChannelMinAndMax (channels[1], numSamples, bufMin, bufMax);
-        rmax = jmax (rmax, bufMax);
-        rmin = jmin (rmin, bufMin);
-    }
-    else
-    {
-        rmax = lmax;
-        rmin = lmin;
-    }
-}
-
-void AudioFormatReader::readMaxLevels (int64 startSampleInFile, int64 numSamples,
-                                       float& lowestLeft, float& highestLeft,
-                                       float& lowestRight, float& highestRight)
-{
-    if (numSamples <= 0)
-    {
-        lowestLeft = 0;
-        lowestRight = 0;
-        highestLeft = 0;
-        highestRight = 0;
+    if (numSamples <= 0 || numChans <= 0)
         return;
-    }
 
-    const int bufferSize = (int) jmin (numSamples, (int64) 4096);
-    AudioSampleBuffer tempSampleBuffer ((int) numChannels, bufferSize);
+    const int bufferSize = (int) jmin (numSamples, (int64) 32768);
+    AudioSampleBuffer tempSampleBuffer (numChans, bufferSize);
 
     float** const floatBuffer = tempSampleBuffer.getArrayOfChannels();
     int* const* intBuffer = reinterpret_cast<int* const*> (floatBuffer);
+    bool isFirstBlock = true;
 
-    if (usesFloatingPointData)
+    while (numSamples > 0)
     {
-        float lmin = 1.0e6f;
-        float lmax = -lmin;
-        float rmin = lmin;
-        float rmax = lmax;
+        const int numToDo = (int) jmin (numSamples, (int64) bufferSize);
+        if (! read (intBuffer, numChans, startSampleInFile, numToDo, false))
+            break;
 
-        while (numSamples > 0)
+        for (int i = 0; i < numChans; ++i)
         {
-            const int numToDo = (int) jmin (numSamples, (int64) bufferSize);
-            if (! read (intBuffer, 2, startSampleInFile, numToDo, false))
-                break;
+            // (converting the ints to floats first lets both cases use the vectorised search)
+            if (! usesFloatingPointData)
+                FloatVectorOperations::convertFixedToFloat (floatBuffer[i], intBuffer[i],
+                                                            1.0f / (float) std::numeric_limits<int>::max(), numToDo);
+
+            float mn, mx;
+            FloatVectorOperations::findMinAndMax (floatBuffer[i], numToDo, mn, mx);
 
-            numSamples -= numToDo;
-            startSampleInFile += numToDo;
-            getStereoMinAndMax (floatBuffer, (int) numChannels, numToDo, lmin, lmax, rmin, rmax);
+            const Range<float> r (mn, mx);
+            results[i] = isFirstBlock ? r : results[i].getUnionWith (r);
         }
 
-        lowestLeft   = lmin;
-        highestLeft  = lmax;
-        lowestRight  = rmin;
-        highestRight = rmax;
+        isFirstBlock = false;
+        numSamples -= numToDo;
+        startSampleInFile += numToDo;
     }
-    else
-    {
-        int lmax = std::numeric_limits<int>::min();
-        int lmin = std::numeric_limits<int>::max();
-        int rmax = std::numeric_limits<int>::min();
-        int rmin = std::numeric_limits<int>::max();
+}
 
-        while (numSamples > 0)
-        {
-            const int numToDo = (int) jmin (numSamples, (int64) bufferSize);
-            if (! read (intBuffer, 2, startSampleInFile, numToDo, false))
-                break;
+void AudioFormatReader::readMaxLevels (int64 startSampleInFile, int64 numSamples,
+                                       float& lowestLeft, float& highestLeft,
+                                       float& lowestRight, float& highestRight)
+{
+    Range<float> levels[2];
+    readMaxLevels (startSampleInFile, numSamples, levels, 2);
 
-            numSamples -= numToDo;
-            startSampleInFile += numToDo;
-            getStereoMinAndMax (intBuffer, (int) numChannels, numToDo, lmin, lmax, rmin, rmax);
-        }
+    if (numChannels < 2)
+        levels[1] = levels[0];
 
-        lowestLeft   = lmin / (float) std::numeric_limits<int>::max();
-        highestLeft  = lmax / (float) std::numeric_limits<int>::max();
-        lowestRight  = rmin / (float) std::numeric_limits<int>::max();
-        highestRight = rmax / (float) std::numeric_limits<int>::max();
-    }
+    lowestLeft   = levels[0].getStart();
+    highestLeft  = levels[0].getEnd();
+    lowestRight  = levels[1].getStart();
+    highestRight = levels[1].getEnd();
 }
 
 int64 AudioFormatReader::searchForLevel (int64 startSample,
@@ -377,9 +340,11 @@ int64 AudioFormatReader::searchForLevel (int64 startSample,
 
 //==============================================================================
 MemoryMappedAudioFormatReader::MemoryMappedAudioFormatReader (const File& f, const AudioFormatReader& reader,
-                                                              int64 start, int64 length, int frameSize)
+                                                              int64 start, int64 length, int frameSize,
+                                                              bool dataIsLittleEndian)
     : AudioFormatReader (nullptr, reader.getFormatName()), file (f),
-      dataChunkStart (start), dataLength (length), bytesPerFrame (frameSize)
+      dataChunkStart (start), dataLength (length), bytesPerFrame (frameSize),
+      littleEndian (dataIsLittleEndian)
 {
     sampleRate      = reader.sampleRate;
     bitsPerSample   = reader.bitsPerSample;
@@ -427,3 +392,54 @@ void MemoryMappedAudioFormatReader::touchSample (int64 sample) const noexcept
         jassertfalse; // you must make sure that the window contains all the samples you're going to attempt to read.
     }
 }
+
+const void* MemoryMappedAudioFormatReader::getMappedSampleData (Range<int64> samples) const noexcept
+{
+    if (map != nullptr && mappedSection.contains (samples))
+        return sampleToPointer (samples.getStart());
+
+    return nullptr;
+}
+
+bool MemoryMappedAudioFormatReader::readFloatSamples (float* const* destSamples, int numDestChannels,
+                                                      int startOffsetInDestBuffer, int64 startSampleInFile,
+                                                      int numSamples)
+{
+    jassert (destSamples != nullptr);
+
+    if (numSamples <= 0)
+        return true;
+
+    const Range<int64> samplesInFile (Range<int64> (startSampleInFile, startSampleInFile + numSamples)
+                                        .getIntersectionWith (Range<int64> (0, lengthInSamples)));
+
+    const int numBefore = (int) jmin ((int64) numSamples, samplesInFile.getStart() - startSampleInFile);
+    const int numInFile = (int) samplesInFile.getLength();
+    const int numAfter  = numSamples - numBefore - numInFile;
+
+    if (numInFile > 0)
+    {
+        if (map == nullptr || ! mappedSection.contains (samplesInFile))
+            return false;
+
+        if (! convertMappedSamplesToFloat (destSamples, numDestChannels, startOffsetInDestBuffer + numBefore,
+                                           samplesInFile.getStart(), numInFile))
+            return false;
+    }
+
+    for (int i = numDestChannels; --i >= 0;)
+    {
+        if (float* const d = destSamples[i])
+        {
+            zeromem (d + startOffsetInDestBuffer, sizeof (float) * (size_t) numBefore);
+            zeromem (d + startOffsetInDestBuffer + numBefore + numInFile, sizeof (float) * (size_t) numAfter);
+        }
+    }
+
+    return true;
+}
+
+bool MemoryMappedAudioFormatReader::convertMappedSamplesToFloat (float* const*, int, int, int64, int) const
+{
+    return false;
+}
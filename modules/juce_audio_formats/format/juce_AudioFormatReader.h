@@ -147,6 +147,27 @@ public:
                                 float& lowestRight,
                                 float& highestRight);
 
+    /** Finds the highest and lowest sample levels in each channel of a section of the audio stream.
+
+        This works like the other readMaxLevels() method, but measures any number of channels
+        at once, putting the normalised lowest and highest levels of each channel into an
+        array of ranges.
+
+        @param startSample          the offset into the audio stream to start reading from. It's
+                                    ok for this to be beyond the start or end of the stream.
+        @param numSamples           how many samples to read
+        @param results              on return, this contains the range of levels for each
+                                    channel - it must have space for numChannelsToRead items.
+                                    Any channels that the stream doesn't have are set to
+                                    empty ranges.
+        @param numChannelsToRead    the number of channels to measure
+        @see read
+    */
+    void readMaxLevels (int64 startSample,
+                        int64 numSamples,
+                        Range<float>* results,
+                        int numChannelsToRead);
+
     /** Scans the source looking for a sample whose magnitude is in a specified range.
 
         This will read from the source, either forwards or backwards between two sample
@@ -203,6 +224,15 @@ public:
     /** The input stream, for use by subclasses. */
     InputStream* input;
 
+    /** Identifies the audio that this reader decodes, so that the blocks that it decodes can be
+        shared with other readers through the AudioFormatReaderBlockCache.
+
+        This is 0 by default, which means that the reader doesn't use the cache. Readers for
+        formats that are expensive to decode set it in their constructors, using
+        AudioFormatReaderBlockCache::getKeyForStream().
+    */
+    int64 blockCacheKey;
+
 
     //==============================================================================
     /** Subclasses must implement this method to perform the low-level read operation.
@@ -0,0 +1,367 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+namespace AudioFormatReaderBlockCacheHelpers
+{
+    //==============================================================================
+    class Block  : public ReferenceCountedObject
+    {
+    public:
+        Block (const int64 sourceKey, const int64 index, const int numChans, const int numSamps)
+            : key (sourceKey), blockIndex (index), numChannels (numChans), numSamples (numSamps),
+              bytesPerSample (4), previous (nullptr), next (nullptr)
+        {
+        }
+
+        typedef ReferenceCountedObjectPtr<Block> Ptr;
+
+        /* Packs the decoded samples, using only as many of each sample's high-order bytes
+           as are needed to hold the data in all of them without losing anything.
+        */
+        void store (const int* const* channels)
+        {
+            uint32 lowBits = 0;
+
+            for (int i = 0; i < numChannels; ++i)
+                for (int j = 0; j < numSamples; ++j)
+                    lowBits |= (uint32) channels[i][j];
+
+            bytesPerSample = (lowBits & 0xffff) == 0 ? 2 : ((lowBits & 0xff) == 0 ? 3 : 4);
+            data.malloc ((size_t) (numChannels * numSamples * bytesPerSample));
+
+            for (int i = 0; i < numChannels; ++i)
+            {
+                const int* src = channels[i];
+                uint8* dst = getChannelData (i);
+
+                switch (bytesPerSample)
+                {
+                    case 2:
+                        for (int j = 0; j < numSamples; ++j)
+                            reinterpret_cast<int16*> (dst)[j] = (int16) (src[j] >> 16);
+                        break;
+
+                    case 3:
+                        for (int j = 0; j < numSamples; ++j, dst += 3)
+                        {
+                            const uint32 v = ((uint32) src[j]) >> 8;
+                            dst[0] = (uint8) v;
+                            dst[1] = (uint8) (v >> 8);
+                            dst[2] = (uint8) (v >> 16);
+                        }
+                        break;
+
+                    default:
+                        memcpy (dst, src, sizeof (int) * (size_t) numSamples);
+                        break;
+                }
+            }
+        }
+
+        void copyTo (int* dest, const int channel, const int startSample, const int num) const noexcept
+        {
+            jassert (startSample >= 0 && startSample + num <= numSamples);
+            const uint8* src = getChannelData (channel) + startSample * bytesPerSample;
+
+            switch (bytesPerSample)
+            {
+                case 2:
+                    for (int j = 0; j < num; ++j)
+                        dest[j] = (int) (((uint32) (uint16) reinterpret_cast<const int16*> (src)[j]) << 16);
+                    break;
+
+                case 3:
+                    for (int j = 0; j < num; ++j, src += 3)
+                        dest[j] = (int) (((uint32) src[0] << 8) | ((uint32) src[1] << 16) | ((uint32) src[2] << 24));
+                    break;
+
+                default:
+                    memcpy (dest, src, sizeof (int) * (size_t) num);
+                    break;
+            }
+        }
+
+        int64 getNumBytes() const noexcept       { return numChannels * (int64) numSamples * bytesPerSample; }
+
+        const int64 key, blockIndex;
+        const int numChannels, numSamples;
+        int bytesPerSample;
+        HeapBlock<uint8> data;
+
+        // (the least-recently-used list, which is protected by the cache's lock)
+        Block* previous;
+        Block* next;
+
+    private:
+        uint8* getChannelData (const int channel) const noexcept
+        {
+            return data + channel * numSamples * bytesPerSample;
+        }
+
+        JUCE_DECLARE_NON_COPYABLE (Block)
+    };
+
+    //==============================================================================
+    class Cache
+    {
+    public:
+        Cache()  : memoryLimit (0), totalBytes (0), newest (nullptr), oldest (nullptr)
+        {
+        }
+
+        ~Cache()
+        {
+            clear();
+        }
+
+        bool isEnabled() const noexcept         { return memoryLimit > 0; }
+
+        Block::Ptr find (const int64 key, const int64 blockIndex)
+        {
+            const ScopedLock sl (lock);
+            Block* const b = blocks [getMapKey (key, blockIndex)];
+
+            if (b == nullptr || b->key != key || b->blockIndex != blockIndex)
+                return nullptr;
+
+            unlink (b);
+            linkAsNewest (b);
+            return b;
+        }
+
+        void add (Block* const b)
+        {
+            const ScopedLock sl (lock);
+
+            if (! isEnabled())
+                return;
+
+            const int64 mapKey = getMapKey (b->key, b->blockIndex);
+
+            if (Block* const old = blocks [mapKey])
+                remove (old);
+
+            b->incReferenceCount();
+            blocks.set (mapKey, b);
+            linkAsNewest (b);
+            totalBytes += b->getNumBytes();
+
+            while (totalBytes > memoryLimit && oldest != nullptr && oldest != b)
+                remove (oldest);
+        }
+
+        void setMemoryLimit (const int64 maxBytes)
+        {
+            const ScopedLock sl (lock);
+            memoryLimit = jmax ((int64) 0, maxBytes);
+
+            while (oldest != nullptr && totalBytes > memoryLimit)
+                remove (oldest);
+        }
+
+        void clear()
+        {
+            const ScopedLock sl (lock);
+
+            while (oldest != nullptr)
+                remove (oldest);
+        }
+
+        CriticalSection lock;
+        int64 memoryLimit, totalBytes;
+
+    private:
+        HashMap<int64, Block*> blocks;
+        Block* newest;
+        Block* oldest;
+
+        static int64 getMapKey (const int64 key, const int64 blockIndex) noexcept
+        {
+            return key ^ (int64) ((uint64) blockIndex * (uint64) 0x9e3779b97f4a7c15LL);
+        }
+
+        void linkAsNewest (Block* const b) noexcept
+        {
+            b->previous = nullptr;
+            b->next = newest;
+
+            if (newest != nullptr)
+                newest->previous = b;
+
+            newest = b;
+
+            if (oldest == nullptr)
+                oldest = b;
+        }
+
+        void unlink (Block* const b) noexcept
+        {
+            if (b->previous != nullptr)  b->previous->next = b->next;
+            else                         newest = b->next;
+
+            if (b->next != nullptr)      b->next->previous = b->previous;
+            else                         oldest = b->previous;
+
+            b->previous = b->next = nullptr;
+        }
+
+        void remove (Block* const b)
+        {
+            unlink (b);
+            blocks.remove (getMapKey (b->key, b->blockIndex));
+            totalBytes -= b->getNumBytes();
+            b->decReferenceCount();
+        }
+
+        JUCE_DECLARE_NON_COPYABLE (Cache)
+    };
+
+    static Cache& getCache()
+    {
+        static Cache cache;
+        return cache;
+    }
+
+    static Block::Ptr decodeBlock (AudioFormatReader& reader, const int64 blockIndex)
+    {
+        const int64 blockStart = blockIndex * AudioFormatReaderBlockCache::samplesPerBlock;
+        const int numSamples = (int) jmin ((int64) AudioFormatReaderBlockCache::samplesPerBlock,
+                                           reader.lengthInSamples - blockStart);
+        const int numChannels = (int) reader.numChannels;
+
+        HeapBlock<int> buffer ((size_t) (numChannels * numSamples));
+        HeapBlock<int*> channels ((size_t) numChannels);
+
+        for (int i = 0; i < numChannels; ++i)
+            channels[i] = buffer + i * numSamples;
+
+        if (! reader.readSamples (channels, numChannels, 0, blockStart, numSamples))
+            return nullptr;
+
+        Block::Ptr block (new Block (reader.blockCacheKey, blockIndex, numChannels, numSamples));
+        block->store (channels);
+        return block;
+    }
+}
+
+//==============================================================================
+void AudioFormatReaderBlockCache::setMemoryLimit (const int64 maxBytes)
+{
+    AudioFormatReaderBlockCacheHelpers::getCache().setMemoryLimit (maxBytes);
+}
+
+int64 AudioFormatReaderBlockCache::getMemoryLimit()
+{
+    AudioFormatReaderBlockCacheHelpers::Cache& cache = AudioFormatReaderBlockCacheHelpers::getCache();
+    const ScopedLock sl (cache.lock);
+    return cache.memoryLimit;
+}
+
+int64 AudioFormatReaderBlockCache::getMemoryUsage()
+{
+    AudioFormatReaderBlockCacheHelpers::Cache& cache = AudioFormatReaderBlockCacheHelpers::getCache();
+    const ScopedLock sl (cache.lock);
+    return cache.totalBytes;
+}
+
+void AudioFormatReaderBlockCache::clear()
+{
+    AudioFormatReaderBlockCacheHelpers::getCache().clear();
+}
+
+int64 AudioFormatReaderBlockCache::getKeyForStream (InputStream* const stream, const String& formatName)
+{
+    if (const FileInputStream* const fin = dynamic_cast <const FileInputStream*> (stream))
+    {
+        const File& file = fin->getFile();
+
+        const int64 key = file.hashCode64()
+                           ^ (file.getLastModificationTime().toMilliseconds() * 31)
+                           ^ (file.getSize() << 32)
+                           ^ (formatName.hashCode64() * 7);
+
+        return key != 0 ? key : 1;
+    }
+
+    return 0;
+}
+
+bool AudioFormatReaderBlockCache::readSamples (AudioFormatReader& reader,
+                                               int** const destSamples,
+                                               const int numDestChannels,
+                                               int startOffsetInDestBuffer,
+                                               int64 startSampleInFile,
+                                               int numSamples)
+{
+    using namespace AudioFormatReaderBlockCacheHelpers;
+    Cache& cache = getCache();
+
+    if (reader.blockCacheKey == 0 || ! cache.isEnabled())
+        return reader.readSamples (destSamples, numDestChannels, startOffsetInDestBuffer,
+                                   startSampleInFile, numSamples);
+
+    const int64 samplesAvailable = reader.lengthInSamples - startSampleInFile;
+
+    if (samplesAvailable < numSamples)
+    {
+        for (int i = numDestChannels; --i >= 0;)
+            if (destSamples[i] != nullptr)
+                zeromem (destSamples[i] + startOffsetInDestBuffer, sizeof (int) * (size_t) numSamples);
+
+        numSamples = (int) jmax ((int64) 0, samplesAvailable);
+    }
+
+    while (numSamples > 0)
+    {
+        const int64 blockIndex = startSampleInFile / samplesPerBlock;
+        const int offsetInBlock = (int) (startSampleInFile - blockIndex * samplesPerBlock);
+
+        Block::Ptr block (cache.find (reader.blockCacheKey, blockIndex));
+
+        if (block == nullptr)
+        {
+            block = decodeBlock (reader, blockIndex);
+
+            if (block == nullptr)
+                return false;
+
+            cache.add (block);
+        }
+
+        const int numToUse = jmin (numSamples, block->numSamples - offsetInBlock);
+
+        if (numToUse <= 0)
+            break;
+
+        for (int i = 0; i < numDestChannels; ++i)
+            if (destSamples[i] != nullptr)
+                block->copyTo (destSamples[i] + startOffsetInDestBuffer, i, offsetInBlock, numToUse);
+
+        startOffsetInDestBuffer += numToUse;
+        startSampleInFile += numToUse;
+        numSamples -= numToUse;
+    }
+
+    return true;
+}
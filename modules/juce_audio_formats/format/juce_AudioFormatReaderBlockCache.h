@@ -0,0 +1,114 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_AUDIOFORMATREADERBLOCKCACHE_JUCEHEADER__
+#define __JUCE_AUDIOFORMATREADERBLOCKCACHE_JUCEHEADER__
+
+#include "juce_AudioFormatReader.h"
+
+
+//==============================================================================
+/**
+    A process-wide cache of blocks of audio that have been decoded by AudioFormatReaders.
+
+    When lots of regions are cut from the same compressed files, e.g. by an editor that
+    uses an AudioSubsectionReader for each clip, every overlapping read would otherwise
+    have to decode the same data again. This cache keeps the decoded audio in fixed-size
+    blocks, keyed by the file and the block's position, so that any reader which is
+    decoding the same file can share them.
+
+    Readers take part if their AudioFormatReader::blockCacheKey is set, which the FLAC,
+    Ogg-Vorbis and MP3 readers do when they're reading from a file. AudioFormatReader::read()
+    and AudioSubsectionReader then go through the cache automatically, so it's used by
+    AudioFormatReaderSource and AudioThumbnail too. Because every read of a block is served
+    from the same decoded copy, overlapping reads always get exactly the same samples, even
+    from decoders whose seeking isn't sample-accurate.
+
+    Each block is stored using as few bytes per sample as it needs without losing any
+    precision, e.g. 16-bit audio takes 2 bytes per sample. Once the total size exceeds the
+    memory limit, the least recently used blocks are released.
+
+    The cache is disabled until you give it a memory limit with setMemoryLimit().
+
+    @see AudioFormatReader::blockCacheKey, AudioSubsectionReader
+*/
+class JUCE_API  AudioFormatReaderBlockCache
+{
+public:
+    //==============================================================================
+    /** The number of sample frames in each cached block. */
+    enum { samplesPerBlock = 16384 };
+
+    //==============================================================================
+    /** Sets the number of bytes of decoded audio that the cache may hold.
+        Setting it to 0 (the default) disables the cache, and releases all the blocks.
+    */
+    static void setMemoryLimit (int64 maxBytes);
+
+    /** Returns the number of bytes that the cache may hold.
+        @see setMemoryLimit
+    */
+    static int64 getMemoryLimit();
+
+    /** Returns the number of bytes of audio that the cache is currently holding. */
+    static int64 getMemoryUsage();
+
+    /** Releases all the cached blocks. */
+    static void clear();
+
+    //==============================================================================
+    /** Reads samples from a reader, using the cached blocks where possible.
+
+        This takes the same arguments as AudioFormatReader::readSamples(), and if the
+        reader has no blockCacheKey or the cache is disabled, it just calls that. Otherwise,
+        any blocks that aren't in the cache are decoded by the reader and added to it.
+
+        As with readSamples(), the caller must make sure that nothing else is using the
+        reader at the same time.
+    */
+    static bool readSamples (AudioFormatReader& reader,
+                             int** destSamples,
+                             int numDestChannels,
+                             int startOffsetInDestBuffer,
+                             int64 startSampleInFile,
+                             int numSamples);
+
+    /** Returns a suitable AudioFormatReader::blockCacheKey for a reader that's decoding
+        the given stream.
+
+        If the stream is a FileInputStream, the key is made from the file's path, size and
+        modification time, and the format name. For other types of stream, the data can't
+        be identified, so this returns 0.
+    */
+    static int64 getKeyForStream (InputStream* stream, const String& formatName);
+
+private:
+    //==============================================================================
+    AudioFormatReaderBlockCache();
+
+    JUCE_DECLARE_NON_COPYABLE (AudioFormatReaderBlockCache)
+};
+
+
+#endif   // __JUCE_AUDIOFORMATREADERBLOCKCACHE_JUCEHEADER__
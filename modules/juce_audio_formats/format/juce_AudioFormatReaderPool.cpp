@@ -0,0 +1,182 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+class AudioFormatReaderPool::Entry   : public ReferenceCountedObject
+{
+public:
+    Entry (const File& f) : file (f), lastUse (0) {}
+
+    const File file;
+    ScopedPointer<AudioFormatReader> reader;
+    CriticalSection readerLock;
+    uint32 lastUse;
+
+    typedef ReferenceCountedObjectPtr<Entry> Ptr;
+
+private:
+    JUCE_DECLARE_NON_COPYABLE (Entry)
+};
+
+//==============================================================================
+AudioFormatReaderPool::AudioFormatReaderPool (AudioFormatManager& fm, const int maxNumOpen, const int accessFlags)
+    : formatManager (fm),
+      streamAccessFlags (accessFlags),
+      maxNumReaders (jmax (1, maxNumOpen)),
+      useCounter (0)
+{
+}
+
+AudioFormatReaderPool::~AudioFormatReaderPool()
+{
+    const ScopedLock sl (lock);
+    closeUnusedReaders (0);
+
+    // deleting the pool while a ScopedReader is still using it is a bad idea!
+    jassert (entries.size() == 0);
+}
+
+void AudioFormatReaderPool::setMaxNumOpenReaders (const int newMax)
+{
+    const ScopedLock sl (lock);
+    maxNumReaders = jmax (1, newMax);
+    closeUnusedReaders (maxNumReaders);
+}
+
+int AudioFormatReaderPool::getNumOpenReaders() const
+{
+    const ScopedLock sl (lock);
+    return entries.size();
+}
+
+void AudioFormatReaderPool::closeFile (const File& file)
+{
+    const ScopedLock sl (lock);
+
+    for (int i = entries.size(); --i >= 0;)
+    {
+        Entry* const e = entries.getUnchecked (i);
+
+        // (the array holds one reference, so anything more means a ScopedReader is using it)
+        if (e->file == file && e->getReferenceCount() == 1)
+            entries.remove (i);
+    }
+}
+
+void AudioFormatReaderPool::closeAll()
+{
+    const ScopedLock sl (lock);
+    closeUnusedReaders (0);
+}
+
+AudioFormatReaderPool::EntryPtr AudioFormatReaderPool::getEntryFor (const File& file)
+{
+    const ScopedLock sl (lock);
+    EntryPtr entry;
+
+    for (int i = entries.size(); --i >= 0;)
+    {
+        if (entries.getUnchecked (i)->file == file)
+        {
+            entry = entries.getUnchecked (i);
+            break;
+        }
+    }
+
+    if (entry == nullptr)
+    {
+        entry = new Entry (file);
+        entries.add (entry);
+        closeUnusedReaders (maxNumReaders);
+    }
+
+    entry->lastUse = ++useCounter;
+    return entry;
+}
+
+void AudioFormatReaderPool::closeUnusedReaders (const int maxNumToKeep)
+{
+    while (entries.size() > maxNumToKeep)
+    {
+        int oldestIndex = -1;
+        uint32 oldestAge = 0;
+
+        for (int i = entries.size(); --i >= 0;)
+        {
+            const Entry* const e = entries.getUnchecked (i);
+
+            if (e->getReferenceCount() == 1)
+            {
+                // (the ages are compared relative to the counter, so that it can safely wrap around)
+                const uint32 age = useCounter - e->lastUse;
+
+                if (oldestIndex < 0 || age > oldestAge)
+                {
+                    oldestIndex = i;
+                    oldestAge = age;
+                }
+            }
+        }
+
+        if (oldestIndex < 0)
+            break;  // everything that's left is in use
+
+        entries.remove (oldestIndex);
+    }
+}
+
+bool AudioFormatReaderPool::read (const File& file, int* const* destSamples, int numDestChannels,
+                                  int64 startSampleInFile, int numSamplesToRead,
+                                  bool fillLeftoverChannelsWithCopies)
+{
+    const ScopedReader r (*this, file);
+
+    return r.isValid()
+            && r->read (destSamples, numDestChannels, startSampleInFile,
+                        numSamplesToRead, fillLeftoverChannelsWithCopies);
+}
+
+//==============================================================================
+AudioFormatReaderPool::ScopedReader::ScopedReader (AudioFormatReaderPool& pool, const File& file)
+    : owner (pool), entry (pool.getEntryFor (file))
+{
+    entry->readerLock.enter();
+
+    // (this is done outside the pool's lock, so opening a slow file doesn't hold up any others)
+    if (entry->reader == nullptr)
+        entry->reader = owner.formatManager.createReaderFor (file, owner.streamAccessFlags);
+}
+
+AudioFormatReaderPool::ScopedReader::~ScopedReader()
+{
+    entry->readerLock.exit();
+    entry = nullptr;
+
+    const ScopedLock sl (owner.lock);
+    owner.closeUnusedReaders (owner.maxNumReaders);
+}
+
+AudioFormatReader* AudioFormatReaderPool::ScopedReader::getReader() const noexcept
+{
+    return entry->reader;
+}
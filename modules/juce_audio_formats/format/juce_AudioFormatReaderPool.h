@@ -0,0 +1,164 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_AUDIOFORMATREADERPOOL_JUCEHEADER__
+#define __JUCE_AUDIOFORMATREADERPOOL_JUCEHEADER__
+
+#include "juce_AudioFormatManager.h"
+
+
+//==============================================================================
+/**
+    Keeps a limited number of AudioFormatReaders open, so that lots of files can be
+    read from at random without opening and parsing each one again every time.
+
+    When a reader is needed for a file that isn't open, the pool uses its
+    AudioFormatManager to create one. Once there are more readers open than the
+    limit you set, the ones that were least recently used get closed (a reader that
+    is in use by a ScopedReader is never closed).
+
+    The pool can be used by several threads at once. Each file has its own lock, so
+    threads that are reading different files don't hold each other up, but only one
+    thread at a time can use a particular file's reader.
+
+    @code
+    AudioFormatReaderPool pool (formatManager, 64);
+
+    {
+        AudioFormatReaderPool::ScopedReader r (pool, file);
+
+        if (r.isValid())
+            r->read (channels, numChannels, startSample, numSamples, false);
+    }
+    @endcode
+
+    @see AudioFormatManager
+*/
+class JUCE_API  AudioFormatReaderPool
+{
+public:
+    //==============================================================================
+    /** Creates a pool.
+
+        @param formatManager        the formats to use to open the files. This must not be
+                                    deleted or changed while the pool is using it
+        @param maxNumOpenReaders    the number of readers to keep open
+        @param streamAccessFlags    the flags to pass to File::createInputStream() when
+                                    opening the files
+    */
+    AudioFormatReaderPool (AudioFormatManager& formatManager,
+                           int maxNumOpenReaders,
+                           int streamAccessFlags = File::randomAccess);
+
+    /** Destructor.
+        There mustn't be any ScopedReaders still using the pool when it's deleted.
+    */
+    ~AudioFormatReaderPool();
+
+    //==============================================================================
+    /** Changes the number of readers that can be left open. */
+    void setMaxNumOpenReaders (int maxNumOpenReaders);
+
+    /** Returns the number of readers that can be left open. */
+    int getMaxNumOpenReaders() const noexcept           { return maxNumReaders; }
+
+    /** Returns the number of files that currently have a reader open. */
+    int getNumOpenReaders() const;
+
+    /** Closes the reader for a file, if it's open and not in use.
+        You should call this if the file has changed on disk.
+    */
+    void closeFile (const File& file);
+
+    /** Closes all the readers that aren't in use. */
+    void closeAll();
+
+private:
+    class Entry;
+
+public:
+    //==============================================================================
+    /**
+        Gives the current thread exclusive use of the reader for a file.
+
+        The reader is opened if it isn't already, and stays locked until this object
+        is deleted - so keep it in scope only for as long as you're reading.
+    */
+    class JUCE_API  ScopedReader
+    {
+    public:
+        /** Locks the reader for the given file, opening it if necessary. */
+        ScopedReader (AudioFormatReaderPool& pool, const File& file);
+
+        /** Destructor. */
+        ~ScopedReader();
+
+        /** Returns true if the file could be opened. */
+        bool isValid() const noexcept                           { return getReader() != nullptr; }
+
+        /** Returns the reader, or nullptr if the file couldn't be opened. */
+        AudioFormatReader* getReader() const noexcept;
+
+        /** Returns the reader. Only use this if isValid() returned true! */
+        AudioFormatReader* operator->() const noexcept          { return getReader(); }
+
+    private:
+        AudioFormatReaderPool& owner;
+        ReferenceCountedObjectPtr<Entry> entry;
+
+        JUCE_DECLARE_NON_COPYABLE (ScopedReader)
+    };
+
+    /** Reads some samples from a file, opening its reader if it isn't open already.
+
+        This is a shortcut for using a ScopedReader and calling AudioFormatReader::read()
+        on it. If the file can't be opened, it returns false.
+    */
+    bool read (const File& file,
+               int* const* destSamples,
+               int numDestChannels,
+               int64 startSampleInFile,
+               int numSamplesToRead,
+               bool fillLeftoverChannelsWithCopies);
+
+private:
+    //==============================================================================
+    friend class ScopedReader;
+    typedef ReferenceCountedObjectPtr<Entry> EntryPtr;
+
+    AudioFormatManager& formatManager;
+    const int streamAccessFlags;
+    int maxNumReaders;
+    uint32 useCounter;
+    ReferenceCountedArray<Entry> entries;
+    CriticalSection lock;
+
+    EntryPtr getEntryFor (const File&);
+    void closeUnusedReaders (int maxNumToKeep);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioFormatReaderPool)
+};
+
+
+#endif   // __JUCE_AUDIOFORMATREADERPOOL_JUCEHEADER__
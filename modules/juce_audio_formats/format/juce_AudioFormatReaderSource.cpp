@@ -25,6 +25,7 @@
 AudioFormatReaderSource::AudioFormatReaderSource (AudioFormatReader* const r,
                                                   const bool deleteReaderWhenThisIsDeleted)
     : reader (r, deleteReaderWhenThisIsDeleted),
+      mappedReader (dynamic_cast <MemoryMappedAudioFormatReader*> (r)),
       nextPlayPos (0),
       looping (false)
 {
@@ -59,27 +60,44 @@ void AudioFormatReaderSource::getNextAudioBlock (const AudioSourceChannelInfo& i
 
             if (newEnd > newStart)
             {
-                reader->read (info.buffer, info.startSample,
-                              newEnd - newStart, newStart, true, true);
+                readBufferSection (newStart, newEnd - newStart, *info.buffer, info.startSample);
             }
             else
             {
                 const int endSamps = (int) reader->lengthInSamples - newStart;
 
-                reader->read (info.buffer, info.startSample,
-                              endSamps, newStart, true, true);
-
-                reader->read (info.buffer, info.startSample + endSamps,
-                              newEnd, 0, true, true);
+                readBufferSection (newStart, endSamps, *info.buffer, info.startSample);
+                readBufferSection (0, newEnd, *info.buffer, info.startSample + endSamps);
             }
 
             nextPlayPos = newEnd;
         }
         else
         {
-            reader->read (info.buffer, info.startSample,
-                          info.numSamples, start, true, true);
+            readBufferSection (start, info.numSamples, *info.buffer, info.startSample);
             nextPlayPos += info.numSamples;
         }
     }
 }
+
+void AudioFormatReaderSource::readBufferSection (int64 start, int length, AudioSampleBuffer& buffer, int startSample)
+{
+    if (mappedReader != nullptr && length > 0)
+    {
+        const int numReaderChannels = (int) mappedReader->numChannels;
+        const int numTargetChannels = buffer.getNumChannels();
+        float* chans[2] = { buffer.getSampleData (0, startSample),
+                            numTargetChannels > 1 && numReaderChannels > 1 ? buffer.getSampleData (1, startSample) : nullptr };
+
+        if (mappedReader->readFloatSamples (chans, chans[1] != nullptr ? 2 : 1, 0, start, length))
+        {
+            // if this is a stereo buffer and the source was mono, dupe the first channel..
+            if (numTargetChannels > 1 && chans[1] == nullptr)
+                memcpy (buffer.getSampleData (1, startSample), chans[0], sizeof (float) * (size_t) length);
+
+            return;
+        }
+    }
+
+    reader->read (&buffer, startSample, length, start, true, true);
+}
@@ -30,6 +30,10 @@
 /**
     A type of AudioSource that will read from an AudioFormatReader.
 
+    If the reader is a MemoryMappedAudioFormatReader, any blocks that lie within its
+    mapped section are converted straight from the mapped file into the output buffer,
+    without going through the reader's intermediate integer buffers.
+
     @see PositionableAudioSource, AudioTransportSource, BufferingAudioSource
 */
 class JUCE_API  AudioFormatReaderSource  : public PositionableAudioSource
@@ -66,6 +70,12 @@ public:
     /** Returns the reader that's being used. */
     AudioFormatReader* getAudioFormatReader() const noexcept    { return reader; }
 
+    /** If the reader that's being used is a MemoryMappedAudioFormatReader, this returns it,
+        so that you can get direct access to its mapped data. Otherwise, it returns nullptr.
+        @see MemoryMappedAudioFormatReader::getMappedSampleData
+    */
+    MemoryMappedAudioFormatReader* getMemoryMappedReader() const noexcept   { return mappedReader; }
+
     //==============================================================================
     /** Implementation of the AudioSource method. */
     void prepareToPlay (int samplesPerBlockExpected, double sampleRate);
@@ -89,11 +99,12 @@ public:
 private:
     //==============================================================================
     OptionalScopedPointer<AudioFormatReader> reader;
+    MemoryMappedAudioFormatReader* const mappedReader;
 
     int64 volatile nextPlayPos;
     bool volatile looping;
 
-    void readBufferSection (int start, int length, AudioSampleBuffer& buffer, int startSample);
+    void readBufferSection (int64 start, int length, AudioSampleBuffer& buffer, int startSample);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioFormatReaderSource)
 };
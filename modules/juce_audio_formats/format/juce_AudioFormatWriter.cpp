@@ -164,6 +164,11 @@ bool AudioFormatWriter::writeFromFloatArrays (const float** channels, int numSou
     return true;
 }
 
+bool AudioFormatWriter::flush()
+{
+    return false;
+}
+
 bool AudioFormatWriter::writeFromAudioSampleBuffer (const AudioSampleBuffer& source, int startSample, int numSamples)
 {
     const int numSourceChannels = source.getNumChannels();
@@ -195,8 +200,13 @@ public:
           writer (w),
           receiver (nullptr),
           samplesWritten (0),
+          fileStream (nullptr),
+          numBytesReserved (0),
+          samplesSinceFlush (0),
+          lastWriteTime (Time::getMillisecondCounter()),
           isRunning (true)
     {
+        setWriteBatching (65536, 100);
         timeSliceThread.addTimeSliceClient (this);
     }
 
@@ -207,6 +217,8 @@ public:
 
         while (writePendingData() == 0)
         {}
+
+        releaseUnusedDiskSpace();
     }
 
     bool write (const float** data, int numSamples)
@@ -220,7 +232,11 @@ public:
         prepareToWrite (numSamples, start1, size1, start2, size2);
 
         if (size1 + size2 < numSamples)
+        {
+            ++numOverflows;
+            numSamplesRejected += numSamples;
             return false;
+        }
 
         for (int i = buffer.getNumChannels(); --i >= 0;)
         {
@@ -229,12 +245,36 @@ public:
         }
 
         finishedWrite (size1 + size2);
+
+        // (only this thread ever increases the high-water mark, so this doesn't need a CAS loop)
+        const int numReady = getNumReady();
+        if (numReady > highWaterMark.get())
+            highWaterMark = numReady;
+
         timeSliceThread.notify();
         return true;
     }
 
     int useTimeSlice()
     {
+        const int numReady = getNumReady();
+        const uint32 now = Time::getMillisecondCounter();
+
+        if (numReady == 0)
+        {
+            lastWriteTime = now;
+            return 10;
+        }
+
+        const int msSinceLastWrite = (int) (now - lastWriteTime);
+        const int maxMsBetweenWrites = maxMillisecondsBetweenWrites.get();
+
+        if (numReady < minSamplesPerWrite.get()
+             && numReady < getTotalSize() / 2
+             && msSinceLastWrite < maxMsBetweenWrites)
+            return jmin (10, maxMsBetweenWrites - msSinceLastWrite);
+
+        lastWriteTime = now;
         return writePendingData();
     }
 
@@ -267,6 +307,9 @@ public:
         }
 
         finishedRead (size1 + size2);
+        totalSamplesWritten += size1 + size2;
+        flushIfDue (size1 + size2);
+        reserveDiskSpace();
         return 0;
     }
 
@@ -280,6 +323,46 @@ public:
         samplesWritten = 0;
     }
 
+    void setWriteBatching (const int minimumBytesPerWrite, const int maxMsBetweenWrites)
+    {
+        const int bytesPerFrame = jmax (1, writer->getNumChannels() * writer->getBitsPerSample() / 8);
+
+        minSamplesPerWrite = jmax (0, minimumBytesPerWrite) / bytesPerFrame;
+        maxMillisecondsBetweenWrites = jmax (0, maxMsBetweenWrites);
+    }
+
+    void setDiskSpaceToReserve (FileOutputStream* const stream, const double secondsAhead)
+    {
+        const ScopedLock sl (thumbnailLock);
+        fileStream = stream;
+        numBytesToReserve = (int64) (jmax (0.0, secondsAhead) * writer->getSampleRate()
+                                       * writer->getNumChannels() * writer->getBitsPerSample() / 8);
+    }
+
+    void setFlushInterval (const int numSamplesPerFlush) noexcept
+    {
+        samplesPerFlush = jmax (0, numSamplesPerFlush);
+    }
+
+    // (TimeSliceClient has its own Statistics type, so this one has to be qualified)
+    ThreadedWriter::Statistics getStatistics() const noexcept
+    {
+        ThreadedWriter::Statistics s;
+        s.bufferSize         = getTotalSize();
+        s.highWaterMark      = highWaterMark.get();
+        s.numOverflows       = numOverflows.get();
+        s.numSamplesRejected = numSamplesRejected.get();
+        s.numSamplesWritten  = totalSamplesWritten.get();
+        return s;
+    }
+
+    void resetStatistics() noexcept
+    {
+        highWaterMark = 0;
+        numOverflows = 0;
+        numSamplesRejected = 0;
+    }
+
 private:
     AudioSampleBuffer buffer;
     TimeSliceThread& timeSliceThread;
@@ -287,13 +370,68 @@ private:
     CriticalSection thumbnailLock;
     IncomingDataReceiver* receiver;
     int64 samplesWritten;
+    FileOutputStream* fileStream;
+    int64 numBytesReserved;
+    int64 samplesSinceFlush;
+    uint32 lastWriteTime;
+    Atomic<int> minSamplesPerWrite, maxMillisecondsBetweenWrites, samplesPerFlush;
+    Atomic<int64> numBytesToReserve;
+    Atomic<int> highWaterMark, numOverflows;
+    Atomic<int64> numSamplesRejected, totalSamplesWritten;
     volatile bool isRunning;
 
+    void flushIfDue (const int numSamplesJustWritten)
+    {
+        const int interval = samplesPerFlush.get();
+
+        if (interval > 0)
+        {
+            samplesSinceFlush += numSamplesJustWritten;
+
+            if (samplesSinceFlush >= interval)
+            {
+                samplesSinceFlush = 0;
+                writer->flush();
+            }
+        }
+    }
+
+    void reserveDiskSpace()
+    {
+        const int64 numBytesAhead = numBytesToReserve.get();
+
+        if (fileStream != nullptr && numBytesAhead > 0)
+        {
+            const int64 pos = fileStream->getPosition();
+
+            // (topping-up the reservation when half of it has been used keeps the number of calls down)
+            if (pos + numBytesAhead / 2 > numBytesReserved)
+            {
+                numBytesReserved = pos + numBytesAhead;
+                fileStream->preallocate (numBytesReserved);
+            }
+        }
+    }
+
+    void releaseUnusedDiskSpace()
+    {
+        // Truncating the file at its end frees any space that was reserved beyond it. (This
+        // is done before the writer is deleted, but anything it writes after that is fine).
+        if (fileStream != nullptr && numBytesReserved > 0)
+        {
+            fileStream->flush();
+
+            if (fileStream->getPosition() == fileStream->getFile().getSize())
+                fileStream->truncate();
+        }
+    }
+
     JUCE_DECLARE_NON_COPYABLE (Buffer)
 };
 
 AudioFormatWriter::ThreadedWriter::ThreadedWriter (AudioFormatWriter* writer, TimeSliceThread& backgroundThread, int numSamplesToBuffer)
-    : buffer (new AudioFormatWriter::ThreadedWriter::Buffer (backgroundThread, writer, (int) writer->numChannels, numSamplesToBuffer))
+    : buffer (new AudioFormatWriter::ThreadedWriter::Buffer (backgroundThread, writer, (int) writer->numChannels, numSamplesToBuffer)),
+      outputFile (dynamic_cast<FileOutputStream*> (writer->output))
 {
 }
 
@@ -310,3 +448,33 @@ void AudioFormatWriter::ThreadedWriter::setDataReceiver (AudioFormatWriter::Thre
 {
     buffer->setDataReceiver (receiver);
 }
+
+int AudioFormatWriter::ThreadedWriter::getBufferSizeForDuration (const AudioFormatWriter& writer, const double numSeconds)
+{
+    return nextPowerOfTwo (jmax (1024, (int) (jmax (0.0, numSeconds) * writer.getSampleRate())));
+}
+
+void AudioFormatWriter::ThreadedWriter::setWriteBatching (int minimumBytesPerWrite, int maxMillisecondsBetweenWrites)
+{
+    buffer->setWriteBatching (minimumBytesPerWrite, maxMillisecondsBetweenWrites);
+}
+
+void AudioFormatWriter::ThreadedWriter::setDiskSpaceToReserve (double secondsAhead)
+{
+    buffer->setDiskSpaceToReserve (outputFile, secondsAhead);
+}
+
+void AudioFormatWriter::ThreadedWriter::setFlushInterval (int numSamplesPerFlush)
+{
+    buffer->setFlushInterval (numSamplesPerFlush);
+}
+
+AudioFormatWriter::ThreadedWriter::Statistics AudioFormatWriter::ThreadedWriter::getStatistics() const noexcept
+{
+    return buffer->getStatistics();
+}
+
+void AudioFormatWriter::ThreadedWriter::resetStatistics() noexcept
+{
+    buffer->resetStatistics();
+}
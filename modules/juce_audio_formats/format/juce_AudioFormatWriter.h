@@ -129,8 +129,26 @@ public:
     bool writeFromAudioSampleBuffer (const AudioSampleBuffer& source,
                                      int startSample, int numSamples);
 
-    /** Writes some samples from a set of float data channels. */
-    bool writeFromFloatArrays (const float** channels, int numChannels, int numSamples);
+    /** Writes some samples from a set of float data channels.
+
+        If there are fewer source channels than the writer has, the remaining ones are
+        filled with silence. The default implementation converts the data to integers and
+        passes it to write(), but formats that can convert straight from floats into their
+        own sample layout may override this to avoid the intermediate copy.
+    */
+    virtual bool writeFromFloatArrays (const float** channels, int numChannels, int numSamples);
+
+    /** Brings the file on disk up to date with everything that has been written so far.
+
+        For formats that support it, this rewrites the file's header to describe the data
+        that's been written, and flushes the stream, so that if the app crashes or the power
+        goes off before the writer is deleted, the file will still be readable up to that point.
+        The header has to be rewritten in place, so this needs an output stream that can seek.
+
+        @returns false if the format can't do this, or if the stream couldn't be updated
+        @see ThreadedWriter::setFlushInterval
+    */
+    virtual bool flush();
 
     //==============================================================================
     /** Returns the sample rate being used. */
@@ -149,6 +167,15 @@ public:
     /**
         Provides a FIFO for an AudioFormatWriter, allowing you to push incoming
         data into a buffer which will be flushed to disk by a background thread.
+
+        The FIFO is allocated when the ThreadedWriter is created, and write() doesn't lock
+        or allocate anything, so it's safe to call from an audio callback. Any number of
+        ThreadedWriters can share the same TimeSliceThread - e.g. when recording a lot of
+        tracks at once - and each one will group its data into reasonably large writes
+        (see setWriteBatching()) so that the disk isn't swamped with tiny ones.
+
+        Keep an eye on getStatistics() to find out whether the disk is keeping up: if
+        write() ever has to reject any data, it'll be counted there.
     */
     class ThreadedWriter
     {
@@ -181,6 +208,72 @@ public:
         */
         bool write (const float** data, int numSamples);
 
+        //==============================================================================
+        /** Works out a FIFO size to use for a writer, given how long the disk might
+            take to respond.
+
+            The FIFO needs to be able to hold all the audio that arrives while the background
+            thread is waiting for the disk, so this returns enough samples to cover the given
+            number of seconds at the writer's sample rate, rounded up to a power of two. If
+            lots of writers are sharing a thread, the disk will have to deal with all of them
+            in turn, so you should allow more time.
+        */
+        static int getBufferSizeForDuration (const AudioFormatWriter& writer, double numSeconds);
+
+        /** Controls how the background thread groups the buffered data into writes.
+
+            Rather than handing each block to the AudioFormatWriter as soon as it arrives,
+            the thread waits until there's enough data for at least minimumBytesPerWrite bytes
+            in the output file (judging by the writer's bit depth and number of channels), or
+            until maxMillisecondsBetweenWrites have passed since the last write. Whatever
+            these settings are, if the FIFO gets more than half full, it gets written straight
+            away. By default, the writes are 64KB, at least every 100ms.
+        */
+        void setWriteBatching (int minimumBytesPerWrite, int maxMillisecondsBetweenWrites);
+
+        /** Makes the writer reserve disk space ahead of the data it's writing.
+
+            If the writer's stream is a FileOutputStream, then as the file grows, the
+            background thread will keep enough space reserved for this many seconds of
+            audio beyond the current end of the file, using FileOutputStream::preallocate().
+            Any space that's left over is released when the ThreadedWriter is deleted.
+            Pass 0 to turn this off (which is the default). It has no effect on other kinds
+            of stream, or on file systems that don't support it.
+        */
+        void setDiskSpaceToReserve (double secondsAhead);
+
+        /** Makes the background thread call AudioFormatWriter::flush() periodically.
+
+            After each batch of data is written, if at least this many samples have gone to
+            the writer since its last flush, it'll be told to update the file on disk, so that
+            a long recording will survive a crash with no more than this much audio missing.
+            Pass 0 to turn this off (which is the default).
+        */
+        void setFlushInterval (int numSamplesPerFlush);
+
+        //==============================================================================
+        /** Describes how well the background thread is keeping up with the incoming data.
+            @see getStatistics
+        */
+        struct Statistics
+        {
+            int bufferSize;             /**< The size of the FIFO, in samples. */
+            int highWaterMark;          /**< The most samples that have been waiting in the FIFO at once. */
+            int numOverflows;           /**< The number of write() calls that failed because the FIFO was full. */
+            int64 numSamplesRejected;   /**< The total number of samples in the write() calls that failed. */
+            int64 numSamplesWritten;    /**< The number of samples that have been given to the AudioFormatWriter. */
+        };
+
+        /** Returns the statistics for this writer.
+            This can be called from any thread.
+        */
+        Statistics getStatistics() const noexcept;
+
+        /** Clears the high-water mark and overflow counts that getStatistics() returns. */
+        void resetStatistics() noexcept;
+
+        //==============================================================================
+
         class JUCE_API  IncomingDataReceiver
         {
         public:
@@ -205,6 +298,9 @@ public:
         class Buffer;
         friend class ScopedPointer<Buffer>;
         ScopedPointer<Buffer> buffer;
+        FileOutputStream* const outputFile;
+
+        JUCE_DECLARE_NON_COPYABLE (ThreadedWriter)
     };
 
 protected:
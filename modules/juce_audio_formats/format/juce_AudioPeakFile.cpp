@@ -0,0 +1,518 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+class AudioPeakFile::Level
+{
+public:
+    Level (const int64 spp, const int64 totalLength, const int numChans)
+        : samplesPerPeak (spp),
+          numPeaks ((int) ((totalLength + spp - 1) / spp)),
+          numChannels (numChans),
+          peaks ((size_t) numPeaks * (size_t) numChans, true)
+    {
+    }
+
+    inline Peak& getPeak (const int index, const int channel) const noexcept
+    {
+        jassert (isPositiveAndBelow (index, numPeaks) && isPositiveAndBelow (channel, numChannels));
+        return peaks [(size_t) index * (size_t) numChannels + (size_t) channel];
+    }
+
+    inline void setPeak (const int index, const int channel, const float minValue,
+                         const float maxValue, const float rmsValue) const noexcept
+    {
+        Peak& p = getPeak (index, channel);
+        p.minValue = toInt16 (minValue);
+        p.maxValue = toInt16 (maxValue);
+        p.rmsValue = toInt16 (rmsValue);
+    }
+
+    static inline int16 toInt16 (const float value) noexcept     { return (int16) jlimit (-32767, 32767, roundFloatToInt (value * 32767.0f)); }
+    static inline float toFloat (const int16 value) noexcept     { return value * (1.0f / 32767.0f); }
+
+    const int64 samplesPerPeak;
+    const int numPeaks, numChannels;
+    HeapBlock<Peak> peaks;
+
+private:
+    JUCE_DECLARE_NON_COPYABLE (Level)
+};
+
+//==============================================================================
+class AudioPeakFile::Builder
+{
+public:
+    Builder (AudioPeakFile& p, AudioFormatManager& fm, const File& f,
+             const int levelsInEachChunk, Listener* const l)
+        : peaks (p), formatManager (fm), file (f),
+          numLevelsInChunk (levelsInEachChunk),
+          chunkSize (p.getSamplesPerPeak (levelsInEachChunk - 1)),
+          listener (l), callingThread (Thread::getCurrentThread())
+    {
+    }
+
+    int getNumChunks() const noexcept   { return (int) ((peaks.lengthInSamples + chunkSize - 1) / chunkSize); }
+    bool hasFailed() const noexcept     { return failed.get() != 0; }
+
+    void processChunk (const int chunkIndex)
+    {
+        if (shouldStop())
+            return;
+
+        MemoryMappedAudioFormatReader* mappedReader = nullptr;
+        const ScopedPointer<AudioFormatReader> reader (createReader (mappedReader));
+
+        if (reader == nullptr || (int) reader->numChannels != peaks.numChannels)
+        {
+            failed = 1;
+            return;
+        }
+
+        const int numChans = peaks.numChannels;
+        const int64 samplesPerPeak = peaks.getSamplesPerPeak (0);
+        const int64 chunkStart = chunkIndex * chunkSize;
+        const int64 chunkEnd = jmin (chunkStart + chunkSize, peaks.lengthInSamples);
+        const int numPeaksInChunk = (int) ((chunkEnd - chunkStart + samplesPerPeak - 1) / samplesPerPeak);
+
+        // The levels are built up in these temporary arrays with full precision, and each
+        // level is folded down in-place to make the next one.
+        const size_t numValues = (size_t) numPeaksInChunk * (size_t) numChans;
+        HeapBlock<float> mins (numValues), maxs (numValues);
+        HeapBlock<double> sumsOfSquares (numValues);
+
+        const int blockSize = (int) (samplesPerPeak * jmax ((int64) 1, 65536 / samplesPerPeak));
+        AudioSampleBuffer buffer (numChans, (int) jmin ((int64) blockSize, chunkEnd - chunkStart));
+
+        for (int64 pos = chunkStart; pos < chunkEnd; pos += blockSize)
+        {
+            if (shouldStop())
+                return;
+
+            const int numToRead = (int) jmin ((int64) blockSize, chunkEnd - pos);
+
+            if (! readBlock (*reader, mappedReader, buffer, pos, numToRead))
+            {
+                failed = 1;
+                return;
+            }
+
+            const int firstPeak = (int) ((pos - chunkStart) / samplesPerPeak);
+
+            for (int chan = 0; chan < numChans; ++chan)
+            {
+                const float* const data = buffer.getSampleData (chan);
+
+                for (int i = 0; i * samplesPerPeak < numToRead; ++i)
+                {
+                    const int offset = (int) (i * samplesPerPeak);
+                    const int num = (int) jmin (samplesPerPeak, (int64) (numToRead - offset));
+                    const size_t index = (size_t) ((firstPeak + i) * numChans + chan);
+
+                    FloatVectorOperations::findMinAndMax (data + offset, num, mins[index], maxs[index]);
+                    sumsOfSquares[index] = FloatVectorOperations::sumOfSquares (data + offset, num);
+                }
+            }
+        }
+
+        int numPeaksInLevel = numPeaksInChunk;
+
+        for (int levelIndex = 0; levelIndex < numLevelsInChunk; ++levelIndex)
+        {
+            const Level& level = *peaks.levels.getUnchecked (levelIndex);
+            const int firstPeak = (int) (chunkStart / level.samplesPerPeak);
+
+            if (levelIndex > 0)
+            {
+                const int numChildren = numPeaksInLevel;
+                numPeaksInLevel = (numChildren + 3) / 4;
+
+                for (int i = 0; i < numPeaksInLevel; ++i)
+                {
+                    for (int chan = 0; chan < numChans; ++chan)
+                    {
+                        const size_t dest = (size_t) (i * numChans + chan);
+                        const int lastChild = jmin (i * 4 + 4, numChildren);
+                        float mn = mins [(size_t) (i * 4 * numChans + chan)];
+                        float mx = maxs [(size_t) (i * 4 * numChans + chan)];
+                        double sum = 0;
+
+                        for (int child = i * 4; child < lastChild; ++child)
+                        {
+                            const size_t source = (size_t) (child * numChans + chan);
+                            mn = jmin (mn, mins[source]);
+                            mx = jmax (mx, maxs[source]);
+                            sum += sumsOfSquares[source];
+                        }
+
+                        mins[dest] = mn;
+                        maxs[dest] = mx;
+                        sumsOfSquares[dest] = sum;
+                    }
+                }
+            }
+
+            for (int i = 0; i < numPeaksInLevel; ++i)
+            {
+                const int64 peakStart = (firstPeak + i) * level.samplesPerPeak;
+                const int64 num = jmin (level.samplesPerPeak, peaks.lengthInSamples - peakStart);
+
+                for (int chan = 0; chan < numChans; ++chan)
+                {
+                    const size_t index = (size_t) (i * numChans + chan);
+
+                    level.setPeak (firstPeak + i, chan, mins[index], maxs[index],
+                                   (float) std::sqrt (sumsOfSquares[index] / (double) num));
+                }
+            }
+        }
+
+        if (listener != nullptr)
+            listener->peaksReady (peaks, chunkStart, chunkEnd - chunkStart);
+    }
+
+private:
+    AudioPeakFile& peaks;
+    AudioFormatManager& formatManager;
+    const File file;
+    const int numLevelsInChunk;
+    const int64 chunkSize;
+    Listener* const listener;
+    Thread* const callingThread;
+    Atomic<int> failed;
+
+    bool shouldStop()
+    {
+        if (callingThread != nullptr && callingThread->threadShouldExit())
+            failed = 1;
+
+        return hasFailed();
+    }
+
+    AudioFormatReader* createReader (MemoryMappedAudioFormatReader*& mappedReader) const
+    {
+        if (AudioFormat* const format = formatManager.findFormatForFileExtension (file.getFileExtension()))
+        {
+            ScopedPointer<MemoryMappedAudioFormatReader> r (format->createMemoryMappedReader (file));
+
+            if (r != nullptr && r->mapEntireFile())
+            {
+                mappedReader = r;
+                return r.release();
+            }
+        }
+
+        return formatManager.createReaderFor (file, File::dontCache);
+    }
+
+    static bool readBlock (AudioFormatReader& reader, MemoryMappedAudioFormatReader* const mappedReader,
+                           AudioSampleBuffer& buffer, const int64 startSample, const int numSamples)
+    {
+        float** const floatData = buffer.getArrayOfChannels();
+
+        if (mappedReader != nullptr
+             && mappedReader->readFloatSamples (floatData, buffer.getNumChannels(), 0, startSample, numSamples))
+            return true;
+
+        int* const* const intData = reinterpret_cast<int* const*> (floatData);
+
+        if (! reader.read (intData, buffer.getNumChannels(), startSample, numSamples, false))
+            return false;
+
+        if (! reader.usesFloatingPointData)
+            for (int i = 0; i < buffer.getNumChannels(); ++i)
+                FloatVectorOperations::convertFixedToFloat (floatData[i], intData[i],
+                                                            1.0f / (float) std::numeric_limits<int>::max(), numSamples);
+
+        return true;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (Builder)
+};
+
+namespace AudioPeakFileHelpers
+{
+    template <class BuilderType>
+    struct ChunkFunction
+    {
+        ChunkFunction (BuilderType& b) noexcept : builder (&b) {}
+        void operator() (const int chunkIndex) const     { builder->processChunk (chunkIndex); }
+
+        BuilderType* builder;
+    };
+
+    static const char magicHeader[] = { 'j', 'a', 'p', 'k' };
+    static const int formatVersion = 1;
+}
+
+//==============================================================================
+void AudioPeakFile::Listener::peaksStarting (AudioPeakFile&) {}
+
+AudioPeakFile::AudioPeakFile()
+    : numChannels (0), sampleRate (0), lengthInSamples (0)
+{
+}
+
+AudioPeakFile::~AudioPeakFile()
+{
+}
+
+void AudioPeakFile::clear()
+{
+    levels.clear();
+    numChannels = 0;
+    sampleRate = 0;
+    lengthInSamples = 0;
+}
+
+void AudioPeakFile::initialise (const int numChans, const double rate, const int64 length, const int samplesPerPeak)
+{
+    clear();
+    jassert (samplesPerPeak > 0 && length > 0);
+
+    numChannels = numChans;
+    sampleRate = rate;
+    lengthInSamples = length;
+
+    for (int64 spp = samplesPerPeak;; spp *= 4)
+    {
+        levels.add (new Level (spp, length, numChans));
+
+        if (spp >= length)
+            break;
+    }
+}
+
+int64 AudioPeakFile::getSamplesPerPeak (const int level) const noexcept
+{
+    const Level* const l = levels [level];
+    return l != nullptr ? l->samplesPerPeak : 0;
+}
+
+int AudioPeakFile::getNumPeaks (const int level) const noexcept
+{
+    const Level* const l = levels [level];
+    return l != nullptr ? l->numPeaks : 0;
+}
+
+//==============================================================================
+bool AudioPeakFile::build (AudioFormatManager& formatManager, const File& audioFile,
+                           const int numThreads, const int samplesPerPeak, Listener* const listener)
+{
+    clear();
+
+    {
+        const ScopedPointer<AudioFormatReader> reader (formatManager.createReaderFor (audioFile));
+
+        if (reader == nullptr || reader->numChannels == 0 || reader->lengthInSamples <= 0)
+            return false;
+
+        initialise ((int) reader->numChannels, reader->sampleRate,
+                    reader->lengthInSamples, jmax (1, samplesPerPeak));
+    }
+
+    if (listener != nullptr)
+        listener->peaksStarting (*this);
+
+    // Each chunk that the threads work on contains a whole number of peaks in each of
+    // the first few levels, so the threads can calculate those levels independently.
+    const int64 minSamplesPerChunk = 1 << 20;
+    int numLevelsInChunk = 1;
+
+    while (numLevelsInChunk < levels.size() && getSamplesPerPeak (numLevelsInChunk - 1) < minSamplesPerChunk)
+        ++numLevelsInChunk;
+
+    Builder builder (*this, formatManager, audioFile, numLevelsInChunk, listener);
+
+    {
+        // (the thread that calls parallelFor helps to run the tasks, so it counts as one of the threads)
+        ThreadPool pool (jmax (1, (numThreads > 0 ? numThreads : SystemStats::getNumCpus()) - 1));
+        pool.parallelFor (0, builder.getNumChunks(), AudioPeakFileHelpers::ChunkFunction<Builder> (builder), 1);
+    }
+
+    if (builder.hasFailed())
+    {
+        clear();
+        return false;
+    }
+
+    for (int i = numLevelsInChunk; i < levels.size(); ++i)
+        calculateLevelFromPrevious (i);
+
+    if (listener != nullptr && numLevelsInChunk < levels.size())
+        listener->peaksReady (*this, 0, lengthInSamples);
+
+    return true;
+}
+
+void AudioPeakFile::calculateLevelFromPrevious (const int levelIndex)
+{
+    const Level& source = *levels.getUnchecked (levelIndex - 1);
+    const Level& dest = *levels.getUnchecked (levelIndex);
+
+    for (int i = 0; i < dest.numPeaks; ++i)
+    {
+        const int lastChild = jmin (i * 4 + 4, source.numPeaks);
+
+        for (int chan = 0; chan < numChannels; ++chan)
+        {
+            float mn = 1.0f, mx = -1.0f;
+            double sum = 0;
+
+            for (int child = i * 4; child < lastChild; ++child)
+            {
+                const Peak& p = source.getPeak (child, chan);
+                const double rms = Level::toFloat (p.rmsValue);
+                mn = jmin (mn, Level::toFloat (p.minValue));
+                mx = jmax (mx, Level::toFloat (p.maxValue));
+                sum += rms * rms * (double) jmin (source.samplesPerPeak, lengthInSamples - child * source.samplesPerPeak);
+            }
+
+            const int64 num = jmin (dest.samplesPerPeak, lengthInSamples - i * dest.samplesPerPeak);
+            dest.setPeak (i, chan, mn, mx, (float) std::sqrt (sum / (double) num));
+        }
+    }
+}
+
+//==============================================================================
+void AudioPeakFile::getLevels (int64 startSample, int64 numSamples, const int channel,
+                               float& minValue, float& maxValue, float& rmsValue) const noexcept
+{
+    minValue = maxValue = rmsValue = 0;
+
+    const int64 endSample = jmin (startSample + numSamples, lengthInSamples);
+    startSample = jmax ((int64) 0, startSample);
+
+    if (endSample <= startSample || ! isPositiveAndBelow (channel, numChannels) || levels.size() == 0)
+        return;
+
+    int levelIndex = 0;
+
+    while (levelIndex < levels.size() - 1 && getSamplesPerPeak (levelIndex + 1) <= numSamples)
+        ++levelIndex;
+
+    const Level& level = *levels.getUnchecked (levelIndex);
+    const int firstPeak = (int) (startSample / level.samplesPerPeak);
+    const int lastPeak  = (int) ((endSample - 1) / level.samplesPerPeak);
+
+    float mn = 1.0f, mx = -1.0f;
+    double sum = 0;
+    int64 total = 0;
+
+    for (int i = firstPeak; i <= lastPeak; ++i)
+    {
+        const Peak& p = level.getPeak (i, channel);
+        const double rms = Level::toFloat (p.rmsValue);
+        const int64 num = jmin (level.samplesPerPeak, lengthInSamples - i * level.samplesPerPeak);
+
+        mn = jmin (mn, Level::toFloat (p.minValue));
+        mx = jmax (mx, Level::toFloat (p.maxValue));
+        sum += rms * rms * (double) num;
+        total += num;
+    }
+
+    minValue = mn;
+    maxValue = mx;
+    rmsValue = (float) std::sqrt (sum / (double) total);
+}
+
+//==============================================================================
+bool AudioPeakFile::saveTo (OutputStream& output) const
+{
+    output.write (AudioPeakFileHelpers::magicHeader, sizeof (AudioPeakFileHelpers::magicHeader));
+    output.writeInt (AudioPeakFileHelpers::formatVersion);
+    output.writeInt (numChannels);
+    output.writeDouble (sampleRate);
+    output.writeInt64 (lengthInSamples);
+    output.writeInt64 (getSamplesPerPeak (0));
+    output.writeInt (levels.size());
+
+    for (int i = 0; i < levels.size(); ++i)
+    {
+        const Level& level = *levels.getUnchecked (i);
+        const size_t numValues = (size_t) level.numPeaks * (size_t) numChannels * 3;
+
+       #if JUCE_LITTLE_ENDIAN
+        if (! output.write (level.peaks.getData(), numValues * sizeof (int16)))
+            return false;
+       #else
+        const int16* const values = reinterpret_cast<const int16*> (level.peaks.getData());
+
+        for (size_t j = 0; j < numValues; ++j)
+            output.writeShort (values[j]);
+       #endif
+    }
+
+    return true;
+}
+
+bool AudioPeakFile::loadFrom (InputStream& input)
+{
+    clear();
+
+    char header [sizeof (AudioPeakFileHelpers::magicHeader)];
+
+    if (input.read (header, sizeof (header)) != (int) sizeof (header)
+         || memcmp (header, AudioPeakFileHelpers::magicHeader, sizeof (header)) != 0
+         || input.readInt() != AudioPeakFileHelpers::formatVersion)
+        return false;
+
+    const int numChans = input.readInt();
+    const double rate = input.readDouble();
+    const int64 length = input.readInt64();
+    const int64 samplesPerPeak = input.readInt64();
+    const int numLevels = input.readInt();
+
+    if (numChans <= 0 || numChans > 1024 || length <= 0
+         || samplesPerPeak <= 0 || samplesPerPeak > std::numeric_limits<int>::max()
+         || (length + samplesPerPeak - 1) / samplesPerPeak > std::numeric_limits<int>::max())
+        return false;
+
+    initialise (numChans, rate, length, (int) samplesPerPeak);
+
+    if (numLevels != levels.size())
+    {
+        clear();
+        return false;
+    }
+
+    for (int i = 0; i < levels.size(); ++i)
+    {
+        const Level& level = *levels.getUnchecked (i);
+        const size_t numValues = (size_t) level.numPeaks * (size_t) numChannels * 3;
+        int16* const values = reinterpret_cast<int16*> (level.peaks.getData());
+
+        if (input.read (values, (int) (numValues * sizeof (int16))) != (int) (numValues * sizeof (int16)))
+        {
+            clear();
+            return false;
+        }
+
+       #if JUCE_BIG_ENDIAN
+        for (size_t j = 0; j < numValues; ++j)
+            values[j] = (int16) ByteOrder::swapIfBigEndian ((uint16) values[j]);
+       #endif
+    }
+
+    return true;
+}
@@ -0,0 +1,201 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_AUDIOPEAKFILE_JUCEHEADER__
+#define __JUCE_AUDIOPEAKFILE_JUCEHEADER__
+
+#include "juce_AudioFormatManager.h"
+
+
+//==============================================================================
+/**
+    A multi-resolution summary of the levels in an audio file, for drawing overviews
+    of long recordings.
+
+    The file is scanned once, and for each channel the minimum, maximum and RMS levels
+    of every block of getSamplesPerPeak (0) samples are stored. Then a series of
+    coarser levels is built on top of that, each one combining four peaks of the level
+    below it, so that getLevels() can summarise any region of the file by looking at a
+    handful of peaks, however long the region is.
+
+    build() shares the file out between a set of threads, each of which opens its own
+    reader (using a memory-mapped reader if the file's format can provide one), so
+    even multi-gigabyte files can be scanned quickly. The peaks can then be saved
+    with saveTo() and reloaded later with loadFrom(), and can be given straight to an
+    AudioThumbnail with AudioThumbnail::setPeaks().
+
+    If you give build() a Listener, it'll be told about each region of the file as soon
+    as its peaks are ready, so you could show the overview filling in while the scan is
+    running, e.g.
+
+    @code
+    struct ThumbnailFiller  : public AudioPeakFile::Listener
+    {
+        ThumbnailFiller (AudioThumbnail& t) : thumb (t) {}
+
+        void peaksStarting (AudioPeakFile& peaks)
+        {
+            thumb.reset (peaks.getNumChannels(), peaks.getSampleRate(), peaks.getLengthInSamples());
+        }
+
+        void peaksReady (AudioPeakFile& peaks, int64 start, int64 num)
+        {
+            thumb.addPeaks (peaks, start, num);
+        }
+
+        AudioThumbnail& thumb;
+    };
+
+    // (on a background thread..)
+    ThumbnailFiller filler (thumbnail);
+    peaks.build (formatManager, file, 0, 256, &filler);
+    @endcode
+
+    @see AudioThumbnail, AudioFormatReader::readMaxLevels
+*/
+class JUCE_API  AudioPeakFile
+{
+public:
+    //==============================================================================
+    /** Creates an empty set of peaks. */
+    AudioPeakFile();
+
+    /** Destructor. */
+    ~AudioPeakFile();
+
+    //==============================================================================
+    /** Receives callbacks as an AudioPeakFile is being built.
+        @see AudioPeakFile::build
+    */
+    class JUCE_API  Listener
+    {
+    public:
+        /** Destructor. */
+        virtual ~Listener() {}
+
+        /** Called by build() once it has opened the file, before any peaks are calculated.
+            At this point the number of channels, sample rate and length are known, so
+            this is a good place to prepare for the peaksReady() callbacks. It's called
+            on the thread that called build().
+        */
+        virtual void peaksStarting (AudioPeakFile& peaks);
+
+        /** Called when the peaks for a region of the file have been calculated.
+
+            The peaks in all the levels that fit entirely within this region are ready
+            to be read with getLevels(). This is called on one of the threads that is
+            doing the scanning, and several threads may call it at once, so be careful
+            about what you do in here. The regions don't necessarily arrive in order.
+        */
+        virtual void peaksReady (AudioPeakFile& peaks, int64 startSample, int64 numSamples) = 0;
+    };
+
+    //==============================================================================
+    /** Scans an audio file and calculates its peaks, replacing any existing ones.
+
+        This blocks until the whole file has been scanned, sharing the work between
+        numThreads threads (or one for each CPU core if numThreads is 0 or less). If
+        it's called on a Thread, it'll stop early and return false if that thread is
+        asked to exit.
+
+        @param formatManager    used to open the file - each of the threads creates its own reader
+        @param audioFile        the file to scan
+        @param numThreads       the number of threads to use, or 0 for one per CPU core
+        @param samplesPerPeak   the number of samples that each peak in the finest level covers
+        @param listener         an optional listener to tell about each region as it's finished
+        @returns true if the whole file was scanned successfully
+    */
+    bool build (AudioFormatManager& formatManager,
+                const File& audioFile,
+                int numThreads = 0,
+                int samplesPerPeak = 256,
+                Listener* listener = nullptr);
+
+    /** Removes all the peaks. */
+    void clear();
+
+    //==============================================================================
+    /** Writes the peaks to a stream, so they can be reloaded with loadFrom(). */
+    bool saveTo (OutputStream& output) const;
+
+    /** Replaces the peaks with some data that was written by saveTo().
+        Returns false if the data isn't valid, in which case the object is cleared.
+    */
+    bool loadFrom (InputStream& input);
+
+    //==============================================================================
+    /** Returns the number of channels in the file that was scanned. */
+    int getNumChannels() const noexcept                 { return numChannels; }
+
+    /** Returns the sample rate of the file that was scanned. */
+    double getSampleRate() const noexcept               { return sampleRate; }
+
+    /** Returns the length of the file that was scanned. */
+    int64 getLengthInSamples() const noexcept           { return lengthInSamples; }
+
+    /** Returns the number of levels of resolution that are stored. */
+    int getNumLevels() const noexcept                   { return levels.size(); }
+
+    /** Returns the number of samples that each peak in one of the levels covers.
+        Level 0 is the finest one, and each level after that is four times coarser.
+    */
+    int64 getSamplesPerPeak (int level) const noexcept;
+
+    /** Returns the number of peaks in one of the levels. */
+    int getNumPeaks (int level) const noexcept;
+
+    /** Finds the lowest, highest and RMS levels in a region of one of the channels.
+
+        This uses the coarsest level whose peaks are no longer than the region, so the
+        region's edges are only accurate to within a peak at that level. The levels are
+        stored with 16-bit precision.
+    */
+    void getLevels (int64 startSample, int64 numSamples, int channel,
+                    float& minValue, float& maxValue, float& rmsValue) const noexcept;
+
+private:
+    //==============================================================================
+    struct Peak
+    {
+        int16 minValue, maxValue, rmsValue;
+    };
+
+    class Level;
+    class Builder;
+    friend class OwnedArray<Level>;
+    friend class Builder;
+
+    OwnedArray<Level> levels;
+    int numChannels;
+    double sampleRate;
+    int64 lengthInSamples;
+
+    void initialise (int numChans, double rate, int64 length, int samplesPerPeak);
+    void calculateLevelFromPrevious (int level);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioPeakFile)
+};
+
+
+#endif   // __JUCE_AUDIOPEAKFILE_JUCEHEADER__
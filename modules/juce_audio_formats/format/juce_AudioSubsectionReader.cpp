@@ -53,8 +53,12 @@ bool AudioSubsectionReader::readSamples (int** destSamples, int numDestChannels,
     clearSamplesBeyondAvailableLength (destSamples, numDestChannels, startOffsetInDestBuffer,
                                        startSampleInFile, numSamples, length);
 
-    return source->readSamples (destSamples, numDestChannels, startOffsetInDestBuffer,
-                                startSampleInFile + startSample, numSamples);
+    // (never ask the source for anything outside the subsection)
+    if (numSamples <= 0)
+        return true;
+
+    return AudioFormatReaderBlockCache::readSamples (*source, destSamples, numDestChannels, startOffsetInDestBuffer,
+                                                     startSampleInFile + startSample, numSamples);
 }
 
 void AudioSubsectionReader::readMaxLevels (int64 startSampleInFile,
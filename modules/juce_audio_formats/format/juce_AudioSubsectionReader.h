@@ -39,7 +39,11 @@
     actually read the first sample from the other's subsection, which might
     be at a non-zero position.
 
-    @see AudioFormatReader
+    Reads go through the AudioFormatReaderBlockCache, so if lots of subsections are
+    taken from the same compressed file, their overlapping parts only need to be
+    decoded once.
+
+    @see AudioFormatReader, AudioFormatReaderBlockCache
 */
 class JUCE_API  AudioSubsectionReader  : public AudioFormatReader
 {
@@ -76,6 +80,8 @@ public:
                         float& lowestRight,
                         float& highestRight);
 
+    using AudioFormatReader::readMaxLevels;
+
 
 private:
     //==============================================================================
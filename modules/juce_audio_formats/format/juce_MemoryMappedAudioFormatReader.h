@@ -38,6 +38,10 @@
     call mapEntireFile() or mapSectionOfFile() to ensure that the region you want to
     read has been mapped.
 
+    As well as the normal AudioFormatReader methods, you can use readFloatSamples() to
+    convert the mapped data straight into floating-point buffers, or getMappedSampleData()
+    to get a pointer to the raw frames in the file without any copying at all.
+
     @see AudioFormat::createMemoryMappedReader, AudioFormatReader
 */
 class JUCE_API  MemoryMappedAudioFormatReader  : public AudioFormatReader
@@ -51,7 +55,8 @@ protected:
         been mapped.
     */
     MemoryMappedAudioFormatReader (const File& file, const AudioFormatReader& details,
-                                   int64 dataChunkStart, int64 dataChunkLength, int bytesPerFrame);
+                                   int64 dataChunkStart, int64 dataChunkLength, int bytesPerFrame,
+                                   bool dataIsLittleEndian = true);
 
 public:
     /** Returns the file that is being mapped */
@@ -72,12 +77,57 @@ public:
     /** Returns the number of bytes currently being mapped */
     size_t getNumBytesUsed() const                          { return map != nullptr ? map->getSize() : 0; }
 
+    //==============================================================================
+    /** Returns a pointer to the raw sample data for a range of samples in the file.
+
+        This gives you direct access to the file's interleaved frames, without any copying
+        or conversion. The format of the data is described by the bitsPerSample and
+        usesFloatingPointData members, and by isLittleEndian(). The frames are contiguous,
+        so sample (samples.getStart() + n) begins at (n * getBytesPerFrame()) bytes after the
+        pointer that is returned.
+
+        Returns nullptr if any part of the range lies outside the mapped section. The pointer
+        remains valid until the mapped section is changed, or the reader is deleted.
+    */
+    const void* getMappedSampleData (Range<int64> samples) const noexcept;
+
+    /** Returns the number of bytes used by each frame (i.e. one sample for every channel). */
+    int getBytesPerFrame() const noexcept                   { return bytesPerFrame; }
+
+    /** Returns true if the sample data in the file is little-endian. */
+    bool isLittleEndian() const noexcept                    { return littleEndian; }
+
+    /** Reads samples straight from the mapped memory into floating-point buffers.
+
+        This converts the file's data to floats in a single pass, rather than going through
+        the integer buffers that readSamples() uses, so it's the quickest way to stream
+        samples out of a mapped file. Any samples that lie beyond the ends of the file are
+        set to zero, as are any destination channels that the file doesn't have. Null
+        channel pointers in the destination array are skipped.
+
+        Returns false without reading anything if the part of the range that lies within
+        the file hasn't been entirely mapped, or if this type of reader doesn't support
+        direct conversion.
+    */
+    bool readFloatSamples (float* const* destSamples, int numDestChannels, int startOffsetInDestBuffer,
+                           int64 startSampleInFile, int numSamples);
+
 protected:
     File file;
     Range<int64> mappedSection;
     ScopedPointer<MemoryMappedFile> map;
     int64 dataChunkStart, dataLength;
     int bytesPerFrame;
+    bool littleEndian;
+
+    /** Subclasses should override this to convert a block of mapped samples into floats.
+        The range of samples is guaranteed to lie within the mapped section of the file.
+        If the reader can't do the conversion, this should return false - the default
+        implementation just returns false.
+    */
+    virtual bool convertMappedSamplesToFloat (float* const* destSamples, int numDestChannels,
+                                              int startOffsetInDestBuffer, int64 startSampleInFile,
+                                              int numSamples) const;
 
     /** Converts a sample index to a byte position in the file. */
     inline int64 sampleToFilePos (int64 sample) const noexcept       { return dataChunkStart + sample * bytesPerFrame; }
@@ -0,0 +1,139 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+
+ResamplingAudioFormatReader::ResamplingAudioFormatReader (AudioFormatReader* const sourceReader,
+                                                          const double newSampleRate,
+                                                          const bool deleteSourceWhenDeleted,
+                                                          const PolyphaseResampler::Quality quality)
+    : AudioFormatReader (nullptr, sourceReader->getFormatName()),
+      source (sourceReader, deleteSourceWhenDeleted),
+      resampler (jmax (1, (int) sourceReader->numChannels), quality),
+      sourceBuffer (resampler.getNumChannels(), 4096),
+      spareOutput (resampler.getNumChannels(), 4096),
+      nextReadPosition (0),
+      nextSourcePosition (0)
+{
+    jassert (newSampleRate > 0 && source->sampleRate > 0);
+
+    sampleRate = newSampleRate;
+    bitsPerSample = 32;
+    numChannels = source->numChannels;
+    usesFloatingPointData = true;
+    metadataValues = source->metadataValues;
+    lengthInSamples = (int64) std::ceil (source->lengthInSamples * newSampleRate / source->sampleRate);
+
+    resampler.setSampleRates (source->sampleRate, newSampleRate);
+
+    outputChannels.malloc ((size_t) resampler.getNumChannels());
+
+    seek (0);
+}
+
+ResamplingAudioFormatReader::~ResamplingAudioFormatReader()
+{
+}
+
+//==============================================================================
+bool ResamplingAudioFormatReader::readSamples (int** destSamples, int numDestChannels, int startOffsetInDestBuffer,
+                                               int64 startSampleInFile, int numSamples)
+{
+    clearSamplesBeyondAvailableLength (destSamples, numDestChannels, startOffsetInDestBuffer,
+                                       startSampleInFile, numSamples, lengthInSamples);
+
+    if (numSamples <= 0)
+        return true;
+
+    if (startSampleInFile != nextReadPosition && ! seek (startSampleInFile))
+        return false;
+
+    const int numResamplerChannels = resampler.getNumChannels();
+
+    while (numSamples > 0)
+    {
+        const int numThisTime = jmin (numSamples, spareOutput.getNumSamples());
+
+        if (! readSource (resampler.getNumInputSamplesRequired (numThisTime)))
+            return false;
+
+        // (any channels that the caller doesn't want still have to be kept going, so go into a spare buffer)
+        for (int i = 0; i < numResamplerChannels; ++i)
+            outputChannels[i] = (i < numDestChannels && destSamples[i] != nullptr)
+                                    ? reinterpret_cast<float*> (destSamples[i] + startOffsetInDestBuffer)
+                                    : spareOutput.getSampleData (i);
+
+        resampler.process (sourceBuffer.getArrayOfChannels(), outputChannels, numResamplerChannels, numThisTime);
+
+        startOffsetInDestBuffer += numThisTime;
+        nextReadPosition += numThisTime;
+        numSamples -= numThisTime;
+    }
+
+    return true;
+}
+
+// Reads the next block of source data into the start of sourceBuffer, as floats.
+bool ResamplingAudioFormatReader::readSource (const int numSamples)
+{
+    if (numSamples <= 0)
+        return true;
+
+    if (sourceBuffer.getNumSamples() < numSamples)
+        sourceBuffer.setSize (sourceBuffer.getNumChannels(), numSamples);
+
+    float** const channels = sourceBuffer.getArrayOfChannels();
+
+    if (! source->read (reinterpret_cast<int* const*> (channels), sourceBuffer.getNumChannels(),
+                        nextSourcePosition, numSamples, false))
+        return false;
+
+    if (! source->usesFloatingPointData)
+        for (int i = sourceBuffer.getNumChannels(); --i >= 0;)
+            FloatVectorOperations::convertFixedToFloat (channels[i], reinterpret_cast<const int*> (channels[i]),
+                                                        1.0f / 0x7fffffff, numSamples);
+
+    nextSourcePosition += numSamples;
+    return true;
+}
+
+// Restarts the resampler at a new position, priming its filter with the source
+// data that comes just before it.
+bool ResamplingAudioFormatReader::seek (const int64 position)
+{
+    const double exactSourcePosition = (position * source->sampleRate) / sampleRate;
+    const int64 sourcePosition = (int64) std::floor (exactSourcePosition);
+
+    resampler.reset();
+    resampler.setSubSamplePosition (exactSourcePosition - sourcePosition);
+
+    const int numHistorySamples = resampler.getNumHistorySamples();
+    nextSourcePosition = sourcePosition - numHistorySamples;
+
+    if (! readSource (numHistorySamples))
+        return false;
+
+    resampler.setHistory (sourceBuffer.getArrayOfChannels(), sourceBuffer.getNumChannels());
+    nextReadPosition = position;
+    return true;
+}
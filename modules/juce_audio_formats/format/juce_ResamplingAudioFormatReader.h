@@ -0,0 +1,86 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+
+#ifndef __JUCE_RESAMPLINGAUDIOFORMATREADER_JUCEHEADER__
+#define __JUCE_RESAMPLINGAUDIOFORMATREADER_JUCEHEADER__
+
+#include "juce_AudioFormatReader.h"
+
+
+//==============================================================================
+/**
+    An AudioFormatReader that converts the data from another reader to a different
+    sample rate.
+
+    The conversion is done by a PolyphaseResampler, so this is suitable for offline
+    sample-rate conversion, e.g. by passing one of these to
+    AudioFormatWriter::writeFromAudioReader().
+
+    The samples are returned as 32-bit floating point data. Reading sequentially is
+    the most efficient way to use it, but it can also jump to any position, in which
+    case it reads a little extra source data before that point to get the filter
+    going.
+
+    @see PolyphaseResampler, AudioFormatReader
+*/
+class JUCE_API  ResamplingAudioFormatReader  : public AudioFormatReader
+{
+public:
+    //==============================================================================
+    /** Creates a reader.
+
+        @param sourceReader             the reader to take the data from
+        @param newSampleRate            the sample rate that this reader should produce
+        @param deleteSourceWhenDeleted  if true, the sourceReader object will be deleted when
+                                        this object is deleted
+        @param quality                  the quality setting to give the resampler
+    */
+    ResamplingAudioFormatReader (AudioFormatReader* sourceReader,
+                                 double newSampleRate,
+                                 bool deleteSourceWhenDeleted,
+                                 PolyphaseResampler::Quality quality = PolyphaseResampler::highQuality);
+
+    /** Destructor. */
+    ~ResamplingAudioFormatReader();
+
+    //==============================================================================
+    bool readSamples (int** destSamples, int numDestChannels, int startOffsetInDestBuffer,
+                      int64 startSampleInFile, int numSamples);
+
+private:
+    //==============================================================================
+    OptionalScopedPointer<AudioFormatReader> source;
+    PolyphaseResampler resampler;
+    AudioSampleBuffer sourceBuffer, spareOutput;
+    HeapBlock<float*> outputChannels;
+    int64 nextReadPosition, nextSourcePosition;
+
+    bool readSource (int numSamples);
+    bool seek (int64 position);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ResamplingAudioFormatReader)
+};
+
+#endif   // __JUCE_RESAMPLINGAUDIOFORMATREADER_JUCEHEADER__
@@ -84,6 +84,28 @@
  #endif
 #endif
 
+#ifndef JUCE_USE_SSE_INTRINSICS
+ #define JUCE_USE_SSE_INTRINSICS 1
+#endif
+
+#if ! JUCE_INTEL
+ #undef JUCE_USE_SSE_INTRINSICS
+#endif
+
+#if JUCE_USE_SSE_INTRINSICS
+ #include <emmintrin.h>
+#endif
+
+#ifndef JUCE_USE_ARM_NEON
+ #if defined (__ARM_NEON__) || defined (__ARM_NEON)
+  #define JUCE_USE_ARM_NEON 1
+ #endif
+#endif
+
+#if JUCE_USE_ARM_NEON
+ #include <arm_neon.h>
+#endif
+
 //==============================================================================
 namespace juce
 {
@@ -98,12 +120,17 @@ namespace juce
 #endif
 
 #include "format/juce_AudioFormat.cpp"
+#include "format/juce_AudioFormatBatchConverter.cpp"
 #include "format/juce_AudioFormatManager.cpp"
 #include "format/juce_AudioFormatReader.cpp"
+#include "format/juce_AudioFormatReaderBlockCache.cpp"
+#include "format/juce_AudioFormatReaderPool.cpp"
 #include "format/juce_AudioFormatReaderSource.cpp"
 #include "format/juce_AudioFormatWriter.cpp"
+#include "format/juce_AudioPeakFile.cpp"
 #include "format/juce_AudioSubsectionReader.cpp"
 #include "format/juce_BufferingAudioFormatReader.cpp"
+#include "format/juce_ResamplingAudioFormatReader.cpp"
 #include "sampler/juce_Sampler.cpp"
 #include "codecs/juce_AiffAudioFormat.cpp"
 #include "codecs/juce_CoreAudioFormat.cpp"
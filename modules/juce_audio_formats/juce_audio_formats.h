@@ -89,24 +89,39 @@ namespace juce
 #ifndef __JUCE_AUDIOFORMAT_JUCEHEADER__
  #include "format/juce_AudioFormat.h"
 #endif
+#ifndef __JUCE_AUDIOFORMATBATCHCONVERTER_JUCEHEADER__
+ #include "format/juce_AudioFormatBatchConverter.h"
+#endif
 #ifndef __JUCE_AUDIOFORMATMANAGER_JUCEHEADER__
  #include "format/juce_AudioFormatManager.h"
 #endif
 #ifndef __JUCE_AUDIOFORMATREADER_JUCEHEADER__
  #include "format/juce_AudioFormatReader.h"
 #endif
+#ifndef __JUCE_AUDIOFORMATREADERBLOCKCACHE_JUCEHEADER__
+ #include "format/juce_AudioFormatReaderBlockCache.h"
+#endif
+#ifndef __JUCE_AUDIOFORMATREADERPOOL_JUCEHEADER__
+ #include "format/juce_AudioFormatReaderPool.h"
+#endif
 #ifndef __JUCE_AUDIOFORMATREADERSOURCE_JUCEHEADER__
  #include "format/juce_AudioFormatReaderSource.h"
 #endif
 #ifndef __JUCE_AUDIOFORMATWRITER_JUCEHEADER__
  #include "format/juce_AudioFormatWriter.h"
 #endif
+#ifndef __JUCE_AUDIOPEAKFILE_JUCEHEADER__
+ #include "format/juce_AudioPeakFile.h"
+#endif
 #ifndef __JUCE_AUDIOSUBSECTIONREADER_JUCEHEADER__
  #include "format/juce_AudioSubsectionReader.h"
 #endif
 #ifndef __JUCE_BUFFERINGAUDIOFORMATREADER_JUCEHEADER__
  #include "format/juce_BufferingAudioFormatReader.h"
 #endif
+#ifndef __JUCE_RESAMPLINGAUDIOFORMATREADER_JUCEHEADER__
+ #include "format/juce_ResamplingAudioFormatReader.h"
+#endif
 #ifndef __JUCE_MEMORYMAPPEDAUDIOFORMATREADER_JUCEHEADER__
  #include "format/juce_MemoryMappedAudioFormatReader.h"
 #endif
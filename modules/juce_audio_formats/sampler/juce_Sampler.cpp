@@ -22,41 +22,434 @@
   ==============================================================================
 */
 
+
+namespace SamplerHelpers
+{
+    typedef AudioData::Pointer <AudioData::Float32, AudioData::NativeEndian, AudioData::NonInterleaved, AudioData::NonConst> FloatDest;
+    typedef AudioData::Pointer <AudioData::Float32, AudioData::NativeEndian, AudioData::NonInterleaved, AudioData::Const>    FloatSource;
+
+    template <class SampleType>
+    static void convertFromFloat (void* dest, const float* source, int numSamples) noexcept
+    {
+        AudioData::Pointer <SampleType, AudioData::NativeEndian, AudioData::NonInterleaved, AudioData::NonConst> (dest)
+            .convertSamples (FloatSource (source), numSamples);
+    }
+
+    template <class SampleType>
+    static void convertToFloat (float* dest, const void* source, int numSamples) noexcept
+    {
+        FloatDest (dest).convertSamples (AudioData::Pointer <SampleType, AudioData::NativeEndian,
+                                                             AudioData::NonInterleaved, AudioData::Const> (source),
+                                         numSamples);
+    }
+
+    //==============================================================================
+   #if JUCE_USE_SSE_INTRINSICS
+    struct SIMDOps
+    {
+        typedef __m128 Lanes;
+
+        static forcedinline Lanes load (const float* v) noexcept            { return _mm_loadu_ps (v); }
+        static forcedinline void store (float* dest, Lanes a) noexcept      { _mm_storeu_ps (dest, a); }
+        static forcedinline Lanes add (Lanes a, Lanes b) noexcept           { return _mm_add_ps (a, b); }
+        static forcedinline Lanes sub (Lanes a, Lanes b) noexcept           { return _mm_sub_ps (a, b); }
+        static forcedinline Lanes mul (Lanes a, Lanes b) noexcept           { return _mm_mul_ps (a, b); }
+        static forcedinline Lanes load1 (float v) noexcept                  { return _mm_load1_ps (&v); }
+
+        static forcedinline void transpose (Lanes& a, Lanes& b, Lanes& c, Lanes& d) noexcept
+        {
+            _MM_TRANSPOSE4_PS (a, b, c, d);
+        }
+    };
+
+   #elif JUCE_USE_ARM_NEON
+    struct SIMDOps
+    {
+        typedef float32x4_t Lanes;
+
+        static forcedinline Lanes load (const float* v) noexcept            { return vld1q_f32 (v); }
+        static forcedinline void store (float* dest, Lanes a) noexcept      { vst1q_f32 (dest, a); }
+        static forcedinline Lanes add (Lanes a, Lanes b) noexcept           { return vaddq_f32 (a, b); }
+        static forcedinline Lanes sub (Lanes a, Lanes b) noexcept           { return vsubq_f32 (a, b); }
+        static forcedinline Lanes mul (Lanes a, Lanes b) noexcept           { return vmulq_f32 (a, b); }
+        static forcedinline Lanes load1 (float v) noexcept                  { return vld1q_dup_f32 (&v); }
+
+        static forcedinline void transpose (Lanes& a, Lanes& b, Lanes& c, Lanes& d) noexcept
+        {
+            const float32x4x2_t ab = vtrnq_f32 (a, b);
+            const float32x4x2_t cd = vtrnq_f32 (c, d);
+
+            a = vcombine_f32 (vget_low_f32  (ab.val[0]), vget_low_f32  (cd.val[0]));
+            b = vcombine_f32 (vget_low_f32  (ab.val[1]), vget_low_f32  (cd.val[1]));
+            c = vcombine_f32 (vget_high_f32 (ab.val[0]), vget_high_f32 (cd.val[0]));
+            d = vcombine_f32 (vget_high_f32 (ab.val[1]), vget_high_f32 (cd.val[1]));
+        }
+    };
+   #endif
+
+    // This does the same job as the SIMD versions, one lane at a time.
+    struct ScalarOps
+    {
+        struct Lanes  { float v[4]; };
+
+        static forcedinline Lanes load (const float* v) noexcept            { Lanes r; memcpy (r.v, v, sizeof (r.v)); return r; }
+        static forcedinline void store (float* dest, Lanes a) noexcept      { memcpy (dest, a.v, sizeof (a.v)); }
+        static forcedinline Lanes add (Lanes a, Lanes b) noexcept           { for (int i = 0; i < 4; ++i) a.v[i] += b.v[i]; return a; }
+        static forcedinline Lanes sub (Lanes a, Lanes b) noexcept           { for (int i = 0; i < 4; ++i) a.v[i] -= b.v[i]; return a; }
+        static forcedinline Lanes mul (Lanes a, Lanes b) noexcept           { for (int i = 0; i < 4; ++i) a.v[i] *= b.v[i]; return a; }
+        static forcedinline Lanes load1 (float v) noexcept                  { Lanes r; for (int i = 0; i < 4; ++i) r.v[i] = v; return r; }
+
+        static forcedinline void transpose (Lanes& a, Lanes& b, Lanes& c, Lanes& d) noexcept
+        {
+            Lanes* const rows[] = { &a, &b, &c, &d };
+
+            for (int i = 0; i < 4; ++i)
+                for (int j = i + 1; j < 4; ++j)
+                    std::swap (rows[i]->v[j], rows[j]->v[i]);
+        }
+    };
+
+   #if JUCE_USE_SSE_INTRINSICS || JUCE_USE_ARM_NEON
+    typedef SIMDOps InterpolationOps;
+   #else
+    typedef ScalarOps InterpolationOps;
+   #endif
+
+    //==============================================================================
+    /*  The coefficients of an 8-point Blackman-windowed sinc filter, for a set of evenly-spaced
+        fractional positions between two samples. There's an extra row at the end, so that
+        the coefficients for any position can be interpolated from two adjacent rows.
+    */
+    struct SincTable
+    {
+        enum { numTaps = 8, numPhases = 64 };
+
+        SincTable() noexcept
+        {
+            for (int phase = 0; phase <= numPhases; ++phase)
+            {
+                float* const row = coefficients [phase];
+                double total = 0;
+
+                for (int i = 0; i < numTaps; ++i)
+                {
+                    // (the taps are at offsets -3 to +4 from the sample before the position)
+                    const double x = (i - 3) - phase / (double) numPhases;
+                    const double sinc = (x == 0) ? 1.0 : std::sin (double_Pi * x) / (double_Pi * x);
+                    const double window = 0.42 + 0.5 * std::cos (double_Pi * x / 4.0) + 0.08 * std::cos (double_Pi * x / 2.0);
+
+                    row[i] = (float) (sinc * window);
+                    total += row[i];
+                }
+
+                for (int i = 0; i < numTaps; ++i)
+                    row[i] = (float) (row[i] / total);
+            }
+        }
+
+        float coefficients [numPhases + 1][numTaps];
+    };
+
+    static const SincTable& getSincTable()
+    {
+        static const SincTable table;
+        return table;
+    }
+
+    static forcedinline void getCubicWeights (const float a, float* const weights) noexcept
+    {
+        const float a2 = a * a;
+        const float a3 = a2 * a;
+
+        weights[0] = -0.5f * a + a2 - 0.5f * a3;
+        weights[1] = 1.0f - 2.5f * a2 + 1.5f * a3;
+        weights[2] = 0.5f * a + 2.0f * a2 - 1.5f * a3;
+        weights[3] = -0.5f * a2 + 0.5f * a3;
+    }
+
+    /*  Each of the interpolators calculates both channels for a run of output samples, whose
+        positions are given relative to the first sample in the input arrays. Four output samples
+        are done at a time: each one's input samples are multiplied by their weights in one vector
+        operation per channel, and then the four sets of products are transposed and added, which
+        leaves the four results in a single vector.
+    */
+    template <class Ops>
+    static void interpolateCubic (const float* const inL, const float* const inR,
+                                  const double* const positions, const int64 offset,
+                                  float* const outL, float* const outR, const int num) noexcept
+    {
+        typedef typename Ops::Lanes Lanes;
+
+        for (int i = 0; i < num; i += 4)
+        {
+            const int numInGroup = jmin (4, num - i);
+            Lanes l[4], r[4];
+
+            for (int j = 0; j < 4; ++j)
+            {
+                // (any spare lanes at the end are filled by repeating the last sample)
+                const double pos = positions [i + jmin (j, numInGroup - 1)];
+                const int64 wholePos = (int64) pos;
+                const int index = (int) (wholePos - offset) - 1;
+
+                float weights[4];
+                getCubicWeights ((float) (pos - wholePos), weights);
+                const Lanes w (Ops::load (weights));
+
+                l[j] = Ops::mul (Ops::load (inL + index), w);
+                r[j] = Ops::mul (Ops::load (inR + index), w);
+            }
+
+            Ops::transpose (l[0], l[1], l[2], l[3]);
+            Ops::transpose (r[0], r[1], r[2], r[3]);
+
+            float resultL[4], resultR[4];
+            Ops::store (resultL, Ops::add (Ops::add (l[0], l[1]), Ops::add (l[2], l[3])));
+            Ops::store (resultR, Ops::add (Ops::add (r[0], r[1]), Ops::add (r[2], r[3])));
+
+            memcpy (outL + i, resultL, sizeof (float) * (size_t) numInGroup);
+            memcpy (outR + i, resultR, sizeof (float) * (size_t) numInGroup);
+        }
+    }
+
+    template <class Ops>
+    static void interpolateSinc (const float* const inL, const float* const inR,
+                                 const double* const positions, const int64 offset,
+                                 float* const outL, float* const outR, const int num) noexcept
+    {
+        typedef typename Ops::Lanes Lanes;
+        const SincTable& table = getSincTable();
+
+        for (int i = 0; i < num; i += 4)
+        {
+            const int numInGroup = jmin (4, num - i);
+            Lanes l[4], r[4];
+
+            for (int j = 0; j < 4; ++j)
+            {
+                const double pos = positions [i + jmin (j, numInGroup - 1)];
+                const int64 wholePos = (int64) pos;
+                const int index = (int) (wholePos - offset) - 3;
+
+                const float phase = (float) (pos - wholePos) * SincTable::numPhases;
+                const int row = jmin ((int) phase, (int) SincTable::numPhases - 1);
+                const Lanes proportion (Ops::load1 (phase - row));
+
+                const float* const c1 = table.coefficients [row];
+                const float* const c2 = table.coefficients [row + 1];
+
+                const Lanes lowerTaps (Ops::add (Ops::load (c1),     Ops::mul (Ops::sub (Ops::load (c2),     Ops::load (c1)),     proportion)));
+                const Lanes upperTaps (Ops::add (Ops::load (c1 + 4), Ops::mul (Ops::sub (Ops::load (c2 + 4), Ops::load (c1 + 4)), proportion)));
+
+                l[j] = Ops::add (Ops::mul (Ops::load (inL + index), lowerTaps), Ops::mul (Ops::load (inL + index + 4), upperTaps));
+                r[j] = Ops::add (Ops::mul (Ops::load (inR + index), lowerTaps), Ops::mul (Ops::load (inR + index + 4), upperTaps));
+            }
+
+            Ops::transpose (l[0], l[1], l[2], l[3]);
+            Ops::transpose (r[0], r[1], r[2], r[3]);
+
+            float resultL[4], resultR[4];
+            Ops::store (resultL, Ops::add (Ops::add (l[0], l[1]), Ops::add (l[2], l[3])));
+            Ops::store (resultR, Ops::add (Ops::add (r[0], r[1]), Ops::add (r[2], r[3])));
+
+            memcpy (outL + i, resultL, sizeof (float) * (size_t) numInGroup);
+            memcpy (outR + i, resultR, sizeof (float) * (size_t) numInGroup);
+        }
+    }
+
+    static void interpolateLinear (const float* const inL, const float* const inR,
+                                   const double* const positions, const int64 offset,
+                                   float* const outL, float* const outR, const int num) noexcept
+    {
+        for (int i = 0; i < num; ++i)
+        {
+            const int64 wholePos = (int64) positions[i];
+            const int index = (int) (wholePos - offset);
+            const float alpha = (float) (positions[i] - wholePos);
+            const float invAlpha = 1.0f - alpha;
+
+            outL[i] = inL [index] * invAlpha + inL [index + 1] * alpha;
+            outR[i] = inR [index] * invAlpha + inR [index + 1] * alpha;
+        }
+    }
+}
+
+//==============================================================================
 SamplerSound::SamplerSound (const String& name_,
                             AudioFormatReader& source,
                             const BigInteger& midiNotes_,
                             const int midiNoteForNormalPitch,
                             const double attackTimeSecs,
                             const double releaseTimeSecs,
-                            const double maxSampleLengthSeconds)
+                            const double maxSampleLengthSeconds,
+                            const StorageFormat storageFormat_)
     : name (name_),
+      storageFormat (storageFormat_),
       midiNotes (midiNotes_),
       midiRootNote (midiNoteForNormalPitch)
+{
+    initialise (source, attackTimeSecs, releaseTimeSecs, maxSampleLengthSeconds, maxSampleLengthSeconds);
+}
+
+SamplerSound::SamplerSound (const String& name_,
+                            AudioFormatReader* const sourceToStream,
+                            const BigInteger& midiNotes_,
+                            const int midiNoteForNormalPitch,
+                            const double attackTimeSecs,
+                            const double releaseTimeSecs,
+                            const double preloadLengthSeconds,
+                            const StorageFormat storageFormat_)
+    : name (name_),
+      storageFormat (storageFormat_),
+      midiNotes (midiNotes_),
+      midiRootNote (midiNoteForNormalPitch),
+      streamReader (sourceToStream)
+{
+    jassert (sourceToStream != nullptr);
+
+    if (sourceToStream != nullptr)
+    {
+        initialise (*sourceToStream, attackTimeSecs, releaseTimeSecs,
+                    sourceToStream->lengthInSamples / jmax (1.0, sourceToStream->sampleRate) + 1.0,
+                    preloadLengthSeconds);
+    }
+    else
+    {
+        sourceSampleRate = 0;
+        numChannels = length = preloadLength = attackSamples = releaseSamples = 0;
+    }
+}
+
+SamplerSound::SamplerSound (const String& name_,
+                            const File& audioFile,
+                            AudioFormatManager& formatManager,
+                            const BigInteger& midiNotes_,
+                            const int midiNoteForNormalPitch,
+                            const double attackTimeSecs,
+                            const double releaseTimeSecs,
+                            const double maxSampleLengthSeconds,
+                            const StorageFormat storageFormat_)
+    : name (name_),
+      storageFormat (storageFormat_),
+      midiNotes (midiNotes_),
+      midiRootNote (midiNoteForNormalPitch)
+{
+    ScopedPointer<AudioFormatReader> reader;
+
+    if (AudioFormat* const format = formatManager.findFormatForFileExtension (audioFile.getFileExtension()))
+    {
+        ScopedPointer<MemoryMappedAudioFormatReader> mappedReader (format->createMemoryMappedReader (audioFile));
+
+        if (mappedReader != nullptr && mappedReader->mapEntireFile())
+            reader = mappedReader.release();
+    }
+
+    if (reader == nullptr)
+        reader = formatManager.createReaderFor (audioFile);
+
+    if (reader != nullptr)
+    {
+        const String keyPrefix ("SamplerSound:" + String ((int) storageFormat) + ":" + String (maxSampleLengthSeconds));
+
+        initialise (*reader, attackTimeSecs, releaseTimeSecs, maxSampleLengthSeconds, maxSampleLengthSeconds,
+                    SharedResourceRegistry::createFileKey (keyPrefix, audioFile));
+    }
+    else
+    {
+        sourceSampleRate = 0;
+        numChannels = length = preloadLength = attackSamples = releaseSamples = 0;
+    }
+}
+
+SamplerSound::~SamplerSound()
+{
+}
+
+void SamplerSound::initialise (AudioFormatReader& source,
+                               const double attackTimeSecs, const double releaseTimeSecs,
+                               const double maxSampleLengthSeconds, const double preloadLengthSeconds,
+                               const String& sharedDataKey)
 {
     sourceSampleRate = source.sampleRate;
+    numChannels = jmin (2, (int) source.numChannels);
 
-    if (sourceSampleRate <= 0 || source.lengthInSamples <= 0)
+    if (sourceSampleRate <= 0 || source.lengthInSamples <= 0 || numChannels <= 0)
     {
+        numChannels = 0;
         length = 0;
+        preloadLength = 0;
         attackSamples = 0;
         releaseSamples = 0;
+        return;
+    }
+
+    length = (int) jmin (source.lengthInSamples,
+                         (int64) (maxSampleLengthSeconds * sourceSampleRate));
+
+    preloadLength = jlimit (0, length, (int) (preloadLengthSeconds * sourceSampleRate));
+
+    attackSamples = roundToInt (attackTimeSecs * sourceSampleRate);
+    releaseSamples = roundToInt (releaseTimeSecs * sourceSampleRate);
+
+    if (sharedDataKey.isNotEmpty())
+    {
+        preloaded = dynamic_cast <PreloadedAudio*> (SharedResourceRegistry::find (sharedDataKey).get());
+
+        if (preloaded != nullptr)
+            return;
+    }
+
+    preloaded = new PreloadedAudio();
+
+    if (storageFormat == storeAsFloat)
+    {
+        preloaded->floatData = new AudioSampleBuffer (numChannels, preloadLength + 4);
+        source.read (preloaded->floatData, 0, preloadLength + 4, 0, true, true);
     }
     else
     {
-        length = jmin ((int) source.lengthInSamples,
-                       (int) (maxSampleLengthSeconds * sourceSampleRate));
+        // (the audio is read in chunks, so that it never has to all be held as floats)
+        const int bytesPerSample = getBytesPerSample();
+        const int chunkSize = 16384;
+        AudioSampleBuffer chunk (numChannels, chunkSize);
 
-        data = new AudioSampleBuffer (jmin (2, (int) source.numChannels), length + 4);
+        preloaded->compactData.malloc ((size_t) (numChannels * preloadLength * bytesPerSample));
 
-        source.read (data, 0, length + 4, 0, true, true);
+        for (int pos = 0; pos < preloadLength; pos += chunkSize)
+        {
+            const int num = jmin (chunkSize, preloadLength - pos);
+            source.read (&chunk, 0, num, pos, true, true);
 
-        attackSamples = roundToInt (attackTimeSecs * sourceSampleRate);
-        releaseSamples = roundToInt (releaseTimeSecs * sourceSampleRate);
+            for (int i = 0; i < numChannels; ++i)
+            {
+                char* const dest = preloaded->compactData + (i * preloadLength + pos) * bytesPerSample;
+
+                if (storageFormat == storeAs16Bit)
+                    SamplerHelpers::convertFromFloat<AudioData::Int16> (dest, chunk.getSampleData (i), num);
+                else
+                    SamplerHelpers::convertFromFloat<AudioData::Int24> (dest, chunk.getSampleData (i), num);
+            }
+        }
     }
+
+    if (sharedDataKey.isNotEmpty())
+        preloaded = dynamic_cast <PreloadedAudio*> (SharedResourceRegistry::add (sharedDataKey, preloaded).get());
 }
 
-SamplerSound::~SamplerSound()
+int SamplerSound::getBytesPerSample() const noexcept
 {
+    return storageFormat == storeAs16Bit ? 2 : (storageFormat == storeAs24Bit ? 3 : 4);
+}
+
+size_t SamplerSound::getPreloadedDataSize() const noexcept
+{
+    if (preloaded == nullptr)
+        return 0;
+
+    if (const AudioSampleBuffer* const data = preloaded->floatData)
+        return (size_t) (data->getNumChannels() * data->getNumSamples()) * sizeof (float);
+
+    return (size_t) (numChannels * preloadLength * getBytesPerSample());
 }
 
 bool SamplerSound::appliesToNote (const int midiNoteNumber)
@@ -69,14 +462,157 @@ bool SamplerSound::appliesToChannel (const int /*midiChannel*/)
     return true;
 }
 
+void SamplerSound::readPreloadedSamples (AudioSampleBuffer& dest, const int destStart,
+                                         const int sourceStart, const int num) const noexcept
+{
+    jassert (sourceStart >= 0);
+    const int numAvailable = jlimit (0, num, preloadLength - sourceStart);
+
+    for (int i = 0; i < dest.getNumChannels(); ++i)
+    {
+        float* const d = dest.getSampleData (i, destStart);
+
+        if (numAvailable > 0)
+        {
+            // (a mono sample is played on both channels)
+            const int sourceChannel = jmin (i, numChannels - 1);
+
+            if (const AudioSampleBuffer* const data = preloaded->floatData)
+            {
+                memcpy (d, data->getSampleData (sourceChannel, sourceStart), sizeof (float) * (size_t) numAvailable);
+            }
+            else
+            {
+                const int bytesPerSample = getBytesPerSample();
+                const char* const src = preloaded->compactData + (sourceChannel * preloadLength + sourceStart) * bytesPerSample;
+
+                if (storageFormat == storeAs16Bit)
+                    SamplerHelpers::convertToFloat<AudioData::Int16> (d, src, numAvailable);
+                else
+                    SamplerHelpers::convertToFloat<AudioData::Int24> (d, src, numAvailable);
+            }
+        }
+
+        if (numAvailable < num)
+            zeromem (d + numAvailable, sizeof (float) * (size_t) (num - numAvailable));
+    }
+}
+
+void SamplerSound::readStreamedSamples (AudioSampleBuffer& dest, const int destStart,
+                                        const int64 sourceStart, const int num)
+{
+    const int numAvailable = (int) jlimit ((int64) 0, (int64) num, length - sourceStart);
+
+    if (numAvailable > 0 && streamReader != nullptr)
+    {
+        const ScopedLock sl (streamReaderLock);
+        streamReader->read (&dest, destStart, numAvailable, sourceStart, true, true);
+    }
+    else
+    {
+        dest.clear (destStart, num);
+        return;
+    }
+
+    if (numAvailable < num)
+        dest.clear (destStart + numAvailable, num - numAvailable);
+}
+
+//==============================================================================
+/*  The source that a voice's StreamingAudioSource reads from. It's pointed at each new
+    sound when a note starts, and is read by the streaming engine's threads.
+*/
+class SamplerVoice::SoundStream  : public PositionableAudioSource
+{
+public:
+    SoundStream() noexcept  : position (0) {}
+
+    void setSound (SamplerSound* newSound)
+    {
+        SynthesiserSound::Ptr oldSound;
+
+        {
+            const SpinLock::ScopedLockType sl (soundLock);
+            oldSound = sound;
+            sound = newSound;
+        }
+    }
+
+    void prepareToPlay (int, double)    {}
+    void releaseResources()             {}
+
+    void getNextAudioBlock (const AudioSourceChannelInfo& info)
+    {
+        const SynthesiserSound::Ptr s (getSound());
+
+        if (s != nullptr)
+            static_cast <SamplerSound*> (s.get())->readStreamedSamples (*info.buffer, info.startSample,
+                                                                        position, info.numSamples);
+        else
+            info.clearActiveBufferRegion();
+
+        position += info.numSamples;
+    }
+
+    void setNextReadPosition (int64 newPosition)    { position = newPosition; }
+    int64 getNextReadPosition() const               { return position; }
+    bool isLooping() const                          { return false; }
+
+    int64 getTotalLength() const
+    {
+        const SynthesiserSound::Ptr s (getSound());
+        return s != nullptr ? static_cast <SamplerSound*> (s.get())->length : 0;
+    }
+
+private:
+    SynthesiserSound::Ptr sound;
+    SpinLock soundLock;
+    int64 volatile position;
+
+    SynthesiserSound::Ptr getSound() const
+    {
+        const SpinLock::ScopedLockType sl (soundLock);
+        return sound;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (SoundStream)
+};
+
 //==============================================================================
 SamplerVoice::SamplerVoice()
-    : pitchRatio (0.0),
-      sourceSamplePosition (0.0),
+    : pitchRatio (0.0), notePitchRatio (0.0), targetPitchRatio (0.0), pitchRatioDelta (0.0),
+      sourceSamplePosition (0.0), pitchBendRange (2.0),
+      pitchRampSamplesLeft (0),
+      lgain (0.0f), rgain (0.0f),
+      attackReleaseLevel (0), attackDelta (0), releaseDelta (0),
+      isInAttack (false), isInRelease (false),
+      interpolation (linearInterpolation),
+      window (2, 4096),
+      windowStart (0), windowEnd (0), streamedEnd (0),
+      positions ((size_t) maxBlockSize + 1),
+      interpolated ((size_t) maxBlockSize * 2),
+      soundStream (nullptr)
+{
+}
+
+SamplerVoice::SamplerVoice (DiskStreamingEngine& engine, const int samplesToBuffer)
+    : pitchRatio (0.0), notePitchRatio (0.0), targetPitchRatio (0.0), pitchRatioDelta (0.0),
+      sourceSamplePosition (0.0), pitchBendRange (2.0),
+      pitchRampSamplesLeft (0),
       lgain (0.0f), rgain (0.0f),
       attackReleaseLevel (0), attackDelta (0), releaseDelta (0),
-      isInAttack (false), isInRelease (false)
+      isInAttack (false), isInRelease (false),
+      interpolation (linearInterpolation),
+      window (2, 4096),
+      windowStart (0), windowEnd (0), streamedEnd (0),
+      positions ((size_t) maxBlockSize + 1),
+      interpolated ((size_t) maxBlockSize * 2),
+      soundStream (new SoundStream())
 {
+    stream = new StreamingAudioSource (soundStream, engine, true, samplesToBuffer, 2);
+
+    // (the rate is only used by the engine to judge how urgently each stream needs filling)
+    stream->prepareToPlay (window.getNumSamples(), 44100.0);
 }
 
 SamplerVoice::~SamplerVoice()
@@ -91,12 +627,15 @@ bool SamplerVoice::canPlaySound (SynthesiserSound* sound)
 void SamplerVoice::startNote (const int midiNoteNumber,
                               const float velocity,
                               SynthesiserSound* s,
-                              const int /*currentPitchWheelPosition*/)
+                              const int currentPitchWheelPosition)
 {
-    if (const SamplerSound* const sound = dynamic_cast <const SamplerSound*> (s))
+    if (SamplerSound* const sound = dynamic_cast <SamplerSound*> (s))
     {
-        pitchRatio = pow (2.0, (midiNoteNumber - sound->midiRootNote) / 12.0)
-                        * sound->sourceSampleRate / getSampleRate();
+        notePitchRatio = pow (2.0, (midiNoteNumber - sound->midiRootNote) / 12.0)
+                            * sound->sourceSampleRate / getSampleRate();
+
+        pitchRatio = targetPitchRatio = notePitchRatio * getPitchBendRatio (currentPitchWheelPosition);
+        pitchRampSamplesLeft = 0;
 
         sourceSamplePosition = 0.0;
         lgain = velocity;
@@ -120,6 +659,33 @@ void SamplerVoice::startNote (const int midiNoteNumber,
             releaseDelta = (float) (-pitchRatio / sound->releaseSamples);
         else
             releaseDelta = 0.0f;
+
+        // The window must be able to hold the source samples for a reasonable number of output
+        // samples, so a note that's pitched a long way up (or could be bent up) may need a bigger one.
+        const double highestPitchRatio = notePitchRatio * pow (2.0, std::abs (pitchBendRange) / 12.0);
+        const int windowSizeNeeded = 16 * (int) (highestPitchRatio + 1.0) + 16;
+
+        if (window.getNumSamples() < windowSizeNeeded)
+            window.setSize (2, windowSizeNeeded, false, false, true);
+
+        // (the window starts a few samples before the sound, for the interpolators' earlier taps)
+        windowStart = windowEnd = -3;
+        streamedEnd = sound->preloadLength;
+
+        if (soundStream != nullptr)
+        {
+            // Start fetching the audio that follows the preloaded section straight away, so that
+            // it's ready by the time the voice has played through the preload.
+            if (sound->isStreamed())
+            {
+                soundStream->setSound (sound);
+                stream->setNextReadPosition (sound->preloadLength);
+            }
+            else
+            {
+                soundStream->setSound (nullptr);
+            }
+        }
     }
     else
     {
@@ -137,11 +703,29 @@ void SamplerVoice::stopNote (const bool allowTailOff)
     else
     {
         clearCurrentNote();
+
+        if (soundStream != nullptr)
+            soundStream->setSound (nullptr);
     }
 }
 
-void SamplerVoice::pitchWheelMoved (const int /*newValue*/)
+void SamplerVoice::pitchWheelMoved (const int newValue)
 {
+    if (getCurrentlyPlayingSound() != nullptr)
+    {
+        // Glide to the new pitch over a few samples, rather than jumping straight to it
+        // at the start of the next block, which can be heard as a click
+        const int rampLength = 32;
+
+        targetPitchRatio = notePitchRatio * getPitchBendRatio (newValue);
+        pitchRatioDelta = (targetPitchRatio - pitchRatio) / rampLength;
+        pitchRampSamplesLeft = rampLength;
+    }
+}
+
+double SamplerVoice::getPitchBendRatio (const int wheelPosition) const noexcept
+{
+    return pow (2.0, pitchBendRange * (wheelPosition - 0x2000) / (0x2000 * 12.0));
 }
 
 void SamplerVoice::controllerMoved (const int /*controllerNumber*/,
@@ -150,75 +734,182 @@ void SamplerVoice::controllerMoved (const int /*controllerNumber*/,
 }
 
 //==============================================================================
+int SamplerVoice::fillWindow (const SamplerSound& sound, const int64 start, const int64 end)
+{
+    jassert (start >= windowStart && start <= windowEnd);
+    jassert (end - start <= window.getNumSamples());
+
+    // move the samples that are still needed to the start of the window..
+    const int numToKeep = (int) (windowEnd - start);
+
+    if (start > windowStart && numToKeep > 0)
+        for (int i = window.getNumChannels(); --i >= 0;)
+            memmove (window.getSampleData (i, 0), window.getSampleData (i, (int) (start - windowStart)),
+                     sizeof (float) * (size_t) numToKeep);
+
+    windowStart = start;
+
+    // ..and then add the new ones, either from memory or from the stream
+    while (windowEnd < end)
+    {
+        const int destIndex = (int) (windowEnd - windowStart);
+        int num;
+
+        if (windowEnd < 0)
+        {
+            // the positions before the start of the sound are silent
+            num = (int) (jmin (end, (int64) 0) - windowEnd);
+            window.clear (destIndex, num);
+        }
+        else if (windowEnd < sound.preloadLength)
+        {
+            num = (int) (jmin (end, (int64) sound.preloadLength) - windowEnd);
+            sound.readPreloadedSamples (window, destIndex, (int) windowEnd, num);
+        }
+        else if (stream != nullptr && sound.isStreamed())
+        {
+            // the stream has to be read sequentially, so no samples can be skipped
+            jassert (windowEnd == streamedEnd);
+            num = (int) (end - windowEnd);
+
+            const AudioSourceChannelInfo info (&window, destIndex, num);
+            stream->getNextAudioBlock (info);
+            streamedEnd += num;
+        }
+        else
+        {
+            // a voice without a streaming engine can only play the preloaded part of a sound
+            jassert (! sound.isStreamed());
+            num = (int) (end - windowEnd);
+            window.clear (destIndex, num);
+        }
+
+        windowEnd += num;
+    }
+
+    return (int) (windowEnd - windowStart);
+}
+
 void SamplerVoice::renderNextBlock (AudioSampleBuffer& outputBuffer, int startSample, int numSamples)
 {
     if (const SamplerSound* const playingSound = static_cast <SamplerSound*> (getCurrentlyPlayingSound().get()))
     {
-        const float* const inL = playingSound->data->getSampleData (0, 0);
-        const float* const inR = playingSound->data->getNumChannels() > 1
-                                    ? playingSound->data->getSampleData (1, 0) : nullptr;
+        if (playingSound->length <= 0)
+        {
+            stopNote (false);
+            return;
+        }
 
         float* outL = outputBuffer.getSampleData (0, startSample);
         float* outR = outputBuffer.getNumChannels() > 1 ? outputBuffer.getSampleData (1, startSample) : nullptr;
 
-        while (--numSamples >= 0)
+        const bool isStereo = playingSound->numChannels > 1;
+
+        while (numSamples > 0)
         {
-            const int pos = (int) sourceSamplePosition;
-            const float alpha = (float) (sourceSamplePosition - pos);
-            const float invAlpha = 1.0f - alpha;
+            // work out how many output samples can be made from a window-full of source samples
+            const double highestRatio = jmax (pitchRatio, targetPitchRatio);
+            const int numThisTime = jmin (numSamples, (int) maxBlockSize,
+                                          jmax (1, (int) ((window.getNumSamples() - 16) / highestRatio)));
+            numSamples -= numThisTime;
+
+            // find the source position of each output sample, gliding the pitch if it's changing..
+            for (int i = 0; i < numThisTime; ++i)
+            {
+                positions[i] = sourceSamplePosition;
+                sourceSamplePosition += pitchRatio;
+
+                if (pitchRampSamplesLeft > 0)
+                    pitchRatio = (--pitchRampSamplesLeft == 0) ? targetPitchRatio
+                                                               : pitchRatio + pitchRatioDelta;
+            }
+
+            positions [numThisTime] = sourceSamplePosition;
 
-            // just using a very simple linear interpolation here..
-            float l = (inL [pos] * invAlpha + inL [pos + 1] * alpha);
-            float r = (inR != nullptr) ? (inR [pos] * invAlpha + inR [pos + 1] * alpha)
-                                       : l;
+            // ..then fetch the source samples around them, and interpolate
+            const int64 firstNeeded = jmin ((int64) positions[0] - 3, windowEnd);
+            const int64 lastNeeded  = (int64) positions [numThisTime - 1] + 5;
+            fillWindow (*playingSound, firstNeeded, lastNeeded);
 
-            l *= lgain;
-            r *= rgain;
+            interpolateBlock (numThisTime, isStereo);
 
-            if (isInAttack)
+            const float* const interpolatedL = interpolated;
+            const float* const interpolatedR = interpolated + maxBlockSize;
+
+            for (int i = 0; i < numThisTime; ++i)
             {
-                l *= attackReleaseLevel;
-                r *= attackReleaseLevel;
+                float l = interpolatedL[i];
+                float r = interpolatedR[i];
 
-                attackReleaseLevel += attackDelta;
+                l *= lgain;
+                r *= rgain;
 
-                if (attackReleaseLevel >= 1.0f)
+                if (isInAttack)
                 {
-                    attackReleaseLevel = 1.0f;
-                    isInAttack = false;
+                    l *= attackReleaseLevel;
+                    r *= attackReleaseLevel;
+
+                    attackReleaseLevel += attackDelta;
+
+                    if (attackReleaseLevel >= 1.0f)
+                    {
+                        attackReleaseLevel = 1.0f;
+                        isInAttack = false;
+                    }
+                }
+                else if (isInRelease)
+                {
+                    l *= attackReleaseLevel;
+                    r *= attackReleaseLevel;
+
+                    attackReleaseLevel += releaseDelta;
+
+                    if (attackReleaseLevel <= 0.0f)
+                    {
+                        stopNote (false);
+                        return;
+                    }
                 }
-            }
-            else if (isInRelease)
-            {
-                l *= attackReleaseLevel;
-                r *= attackReleaseLevel;
 
-                attackReleaseLevel += releaseDelta;
+                if (outR != nullptr)
+                {
+                    *outL++ += l;
+                    *outR++ += r;
+                }
+                else
+                {
+                    *outL++ += (l + r) * 0.5f;
+                }
 
-                if (attackReleaseLevel <= 0.0f)
+                if (positions [i + 1] > playingSound->length)
                 {
                     stopNote (false);
-                    break;
+                    return;
                 }
             }
+        }
+    }
+}
 
-            if (outR != nullptr)
-            {
-                *outL++ += l;
-                *outR++ += r;
-            }
-            else
-            {
-                *outL++ += (l + r) * 0.5f;
-            }
+void SamplerVoice::interpolateBlock (const int numSamples, const bool isStereo) noexcept
+{
+    const float* const inL = window.getSampleData (0, 0);
+    const float* const inR = isStereo ? window.getSampleData (1, 0) : inL;
+    float* const outL = interpolated;
+    float* const outR = interpolated + maxBlockSize;
 
-            sourceSamplePosition += pitchRatio;
+    switch (interpolation)
+    {
+        case cubicInterpolation:
+            SamplerHelpers::interpolateCubic<SamplerHelpers::InterpolationOps> (inL, inR, positions, windowStart, outL, outR, numSamples);
+            break;
 
-            if (sourceSamplePosition > playingSound->length)
-            {
-                stopNote (false);
-                break;
-            }
-        }
+        case sincInterpolation:
+            SamplerHelpers::interpolateSinc<SamplerHelpers::InterpolationOps> (inL, inR, positions, windowStart, outL, outR, numSamples);
+            break;
+
+        default:
+            SamplerHelpers::interpolateLinear (inL, inR, positions, windowStart, outL, outR, numSamples);
+            break;
     }
 }
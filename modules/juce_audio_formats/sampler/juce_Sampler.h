@@ -30,8 +30,13 @@
 /**
     A subclass of SynthesiserSound that represents a sampled audio clip.
 
-    This is a pretty basic sampler, and just attempts to load the whole audio stream
-    into memory.
+    A sound can either load the whole audio stream into memory, or keep just the first
+    part of it (the "preload") in memory, and stream the rest from disk while it plays.
+    Streamed sounds need SamplerVoices that were given a DiskStreamingEngine.
+
+    The in-memory audio can be stored as 16- or 24-bit integers rather than floats, which
+    uses a half or three-quarters of the memory, at the cost of converting the samples
+    as they're played.
 
     To use it, create a Synthesiser, add some SamplerVoice objects to it, then
     give it some SampledSound objects to play.
@@ -41,6 +46,15 @@
 class JUCE_API  SamplerSound    : public SynthesiserSound
 {
 public:
+    //==============================================================================
+    /** The ways in which a sound's in-memory audio can be stored. */
+    enum StorageFormat
+    {
+        storeAsFloat,       /**< 32-bit floats: the fastest to play, but uses the most memory. */
+        storeAs24Bit,       /**< Packed 24-bit integers. */
+        storeAs16Bit        /**< 16-bit integers: half the size of floats. */
+    };
+
     //==============================================================================
     /** Creates a sampled sound from an audio reader.
 
@@ -59,6 +73,7 @@ public:
         @param releaseTimeSecs  the decay (fade-out) time, in seconds
         @param maxSampleLengthSeconds   a maximum length of audio to read from the audio
                                         source, in seconds
+        @param storageFormat    the format in which the audio should be kept in memory
     */
     SamplerSound (const String& name,
                   AudioFormatReader& source,
@@ -66,7 +81,67 @@ public:
                   int midiNoteForNormalPitch,
                   double attackTimeSecs,
                   double releaseTimeSecs,
-                  double maxSampleLengthSeconds);
+                  double maxSampleLengthSeconds,
+                  StorageFormat storageFormat = storeAsFloat);
+
+    /** Creates a sampled sound from an audio file, sharing its audio with any other
+        SamplerSounds in the process that have loaded the same file.
+
+        This is intended for plugins, where each open instance might otherwise hold its own
+        copy of the same sample set: the first sound to load a file keeps its audio in a
+        SharedResourceRegistry, and any others that are created from the same file with the
+        same storage format and maximum length just take a reference to it. The file is
+        identified by its path, size and modification time, and if its format supports it,
+        the file is memory-mapped rather than streamed while it's being loaded.
+
+        @param name         a name for the sample
+        @param audioFile    the audio file to load
+        @param formatManager    the formats that can be used to read the file
+        @param midiNotes    the set of midi keys that this sound should be played on
+        @param midiNoteForNormalPitch   the midi note at which the sample should be played
+                                        with its natural rate
+        @param attackTimeSecs   the attack (fade-in) time, in seconds
+        @param releaseTimeSecs  the decay (fade-out) time, in seconds
+        @param maxSampleLengthSeconds   a maximum length of audio to read from the file, in seconds
+        @param storageFormat    the format in which the audio should be kept in memory
+        @see SharedResourceRegistry
+    */
+    SamplerSound (const String& name,
+                  const File& audioFile,
+                  AudioFormatManager& formatManager,
+                  const BigInteger& midiNotes,
+                  int midiNoteForNormalPitch,
+                  double attackTimeSecs,
+                  double releaseTimeSecs,
+                  double maxSampleLengthSeconds,
+                  StorageFormat storageFormat = storeAsFloat);
+
+    /** Creates a sampled sound which streams its audio from disk.
+
+        Only the first part of the audio is loaded into memory. When a note starts, the
+        voice plays this preloaded section while its DiskStreamingEngine fetches the
+        following audio from the reader, so the preload needs to be long enough to cover
+        the time that the engine might take to get round to reading it.
+
+        @param name             a name for the sample
+        @param sourceToStream   the audio to play. The sound will take ownership of this reader,
+                                and it'll be read from the streaming engine's threads
+        @param midiNotes        the set of midi keys that this sound should be played on
+        @param midiNoteForNormalPitch   the midi note at which the sample should be played
+                                        with its natural rate
+        @param attackTimeSecs   the attack (fade-in) time, in seconds
+        @param releaseTimeSecs  the decay (fade-out) time, in seconds
+        @param preloadLengthSeconds     the length of audio to keep in memory, in seconds
+        @param storageFormat    the format in which the preloaded audio should be kept
+    */
+    SamplerSound (const String& name,
+                  AudioFormatReader* sourceToStream,
+                  const BigInteger& midiNotes,
+                  int midiNoteForNormalPitch,
+                  double attackTimeSecs,
+                  double releaseTimeSecs,
+                  double preloadLengthSeconds,
+                  StorageFormat storageFormat = storeAsFloat);
 
     /** Destructor. */
     ~SamplerSound();
@@ -76,9 +151,21 @@ public:
     const String& getName() const                           { return name; }
 
     /** Returns the audio sample data.
-        This could be 0 if there was a problem loading it.
+        This could be 0 if there was a problem loading it, or if the audio is stored in one
+        of the integer formats. For a streamed sound, it only contains the preloaded section.
+        If the sound was loaded from a file, this buffer may be shared with other sounds, so
+        it mustn't be modified.
     */
-    AudioSampleBuffer* getAudioData() const                 { return data; }
+    AudioSampleBuffer* getAudioData() const                 { return preloaded != nullptr ? preloaded->floatData.get() : nullptr; }
+
+    /** Returns the format in which the in-memory audio is stored. */
+    StorageFormat getStorageFormat() const noexcept         { return storageFormat; }
+
+    /** Returns true if some of the audio is streamed from disk rather than held in memory. */
+    bool isStreamed() const noexcept                        { return preloadLength < length; }
+
+    /** Returns the number of bytes of memory used to hold the preloaded audio. */
+    size_t getPreloadedDataSize() const noexcept;
 
 
     //==============================================================================
@@ -90,13 +177,33 @@ private:
     //==============================================================================
     friend class SamplerVoice;
 
+    // (this may be shared by several sounds, via the SharedResourceRegistry)
+    struct PreloadedAudio  : public ReferenceCountedObject
+    {
+        typedef ReferenceCountedObjectPtr<PreloadedAudio> Ptr;
+
+        ScopedPointer <AudioSampleBuffer> floatData;
+        HeapBlock <char> compactData;
+    };
+
     String name;
-    ScopedPointer <AudioSampleBuffer> data;
+    PreloadedAudio::Ptr preloaded;
+    StorageFormat storageFormat;
     double sourceSampleRate;
     BigInteger midiNotes;
-    int length, attackSamples, releaseSamples;
+    int numChannels, length, preloadLength, attackSamples, releaseSamples;
     int midiRootNote;
 
+    ScopedPointer <AudioFormatReader> streamReader;
+    CriticalSection streamReaderLock;
+
+    void initialise (AudioFormatReader&, double attackTimeSecs, double releaseTimeSecs,
+                     double maxSampleLengthSeconds, double preloadLengthSeconds,
+                     const String& sharedDataKey = String::empty);
+    int getBytesPerSample() const noexcept;
+    void readPreloadedSamples (AudioSampleBuffer& dest, int destStart, int sourceStart, int num) const noexcept;
+    void readStreamedSamples (AudioSampleBuffer& dest, int destStart, int64 sourceStart, int num);
+
     JUCE_LEAK_DETECTOR (SamplerSound)
 };
 
@@ -115,12 +222,44 @@ class JUCE_API  SamplerVoice    : public SynthesiserVoice
 public:
     //==============================================================================
     /** Creates a SamplerVoice.
+        A voice created like this can only play the preloaded parts of streamed sounds.
     */
     SamplerVoice();
 
+    /** Creates a SamplerVoice that can play streamed sounds.
+
+        @param engine               the engine that will read the audio for this voice. It
+                                    must not be deleted until after the voice has been
+        @param samplesToBuffer      the number of samples that should be read ahead from disk
+    */
+    SamplerVoice (DiskStreamingEngine& engine, int samplesToBuffer = 65536);
+
     /** Destructor. */
     ~SamplerVoice();
 
+    //==============================================================================
+    /** The methods that a voice can use to calculate the values between source samples
+        when a sound is played at a different pitch.
+        @see setInterpolation
+    */
+    enum Interpolation
+    {
+        linearInterpolation,    /**< Straight lines between adjacent samples: the cheapest, but the noisiest. */
+        cubicInterpolation,     /**< A 4-point cubic Hermite (Catmull-Rom) curve. */
+        sincInterpolation       /**< An 8-point windowed-sinc filter, looked up from a polyphase table. */
+    };
+
+    /** Changes the interpolation that the voice uses. The default is linearInterpolation. */
+    void setInterpolation (Interpolation newInterpolation) noexcept     { interpolation = newInterpolation; }
+
+    /** Returns the interpolation that the voice is using. */
+    Interpolation getInterpolation() const noexcept                     { return interpolation; }
+
+    /** Sets the number of semitones that the pitch-wheel can bend notes up or down by.
+        The default is 2. A new range takes effect from the next note that the voice starts.
+    */
+    void setPitchBendRange (double semitones) noexcept                  { pitchBendRange = semitones; }
+
 
     //==============================================================================
     bool canPlaySound (SynthesiserSound* sound);
@@ -141,10 +280,31 @@ public:
 
 private:
     //==============================================================================
-    double pitchRatio;
-    double sourceSamplePosition;
+    class SoundStream;
+    friend class SoundStream;
+
+    double pitchRatio, notePitchRatio, targetPitchRatio, pitchRatioDelta;
+    double sourceSamplePosition, pitchBendRange;
+    int pitchRampSamplesLeft;
     float lgain, rgain, attackReleaseLevel, attackDelta, releaseDelta;
     bool isInAttack, isInRelease;
+    Interpolation interpolation;
+
+    // The source samples that the current block is being interpolated from
+    AudioSampleBuffer window;
+    int64 windowStart, windowEnd, streamedEnd;
+
+    // The source positions and interpolated values for each sample of the current block
+    enum { maxBlockSize = 256 };
+    HeapBlock<double> positions;
+    HeapBlock<float> interpolated;
+
+    SoundStream* soundStream;
+    ScopedPointer<StreamingAudioSource> stream;
+
+    int fillWindow (const SamplerSound&, int64 start, int64 end);
+    double getPitchBendRatio (int wheelPosition) const noexcept;
+    void interpolateBlock (int numSamples, bool isStereo) noexcept;
 
     JUCE_LEAK_DETECTOR (SamplerVoice)
 };
@@ -366,6 +366,7 @@ struct AAXClasses
             pluginInstance = createPluginFilterOfType (AudioProcessor::wrapperType_AAX);
             pluginInstance->setPlayHead (this);
             pluginInstance->addListener (this);
+            stateCache = new AudioProcessorStateCache (*pluginInstance);
 
             AAX_CEffectParameters::GetNumberOfChunks (&juceChunkIndex);
         }
@@ -404,8 +405,7 @@ struct AAXClasses
             if (chunkID != juceChunkType)
                 return AAX_CEffectParameters::GetChunkSize (chunkID, oSize);
 
-            tempFilterData.setSize (0);
-            pluginInstance->getStateInformation (tempFilterData);
+            stateCache->getState (tempFilterData, false);
             *oSize = (uint32_t) tempFilterData.getSize();
             return AAX_SUCCESS;
         }
@@ -416,7 +416,7 @@ struct AAXClasses
                 return AAX_CEffectParameters::GetChunk (chunkID, oChunk);
 
             if (tempFilterData.getSize() == 0)
-                pluginInstance->getStateInformation (tempFilterData);
+                stateCache->getState (tempFilterData, false);
 
             oChunk->fSize = (uint32_t) tempFilterData.getSize();
             tempFilterData.copyTo (oChunk->fData, 0, tempFilterData.getSize());
@@ -430,7 +430,7 @@ struct AAXClasses
             if (chunkID != juceChunkType)
                 return AAX_CEffectParameters::SetChunk (chunkID, chunk);
 
-            pluginInstance->setStateInformation ((void*) chunk->fData, chunk->fSize);
+            stateCache->setState ((void*) chunk->fData, chunk->fSize, false);
             return AAX_SUCCESS;
         }
 
@@ -763,6 +763,7 @@ struct AAXClasses
         JUCELibraryRefCount juceCount;
 
         ScopedPointer<AudioProcessor> pluginInstance;
+        ScopedPointer<AudioProcessorStateCache> stateCache;
         MidiBuffer midiBuffer;
         Array<float*> channelList;
         int32_t juceChunkIndex;
@@ -135,6 +135,7 @@ public:
 
         juceFilter->setPlayHead (this);
         juceFilter->addListener (this);
+        stateCache = new AudioProcessorStateCache (*juceFilter);
 
         Globals()->UseIndexedParameters (juceFilter->getNumParameters());
 
@@ -161,6 +162,7 @@ public:
     ~JuceAU()
     {
         deleteActiveEditors();
+        stateCache = nullptr;
         juceFilter = nullptr;
         clearPresetsArray();
 
@@ -307,7 +309,7 @@ public:
         if (juceFilter != nullptr)
         {
             juce::MemoryBlock state;
-            juceFilter->getCurrentProgramStateInformation (state);
+            stateCache->getState (state, true);
 
             if (state.getSize() > 0)
             {
@@ -346,7 +348,7 @@ public:
                     const juce::uint8* const rawBytes = CFDataGetBytePtr (data);
 
                     if (numBytes > 0)
-                        juceFilter->setCurrentProgramStateInformation (rawBytes, numBytes);
+                        stateCache->setState (rawBytes, numBytes, true);
                 }
             }
         }
@@ -1162,6 +1164,7 @@ public:
 private:
     //==============================================================================
     ScopedPointer<AudioProcessor> juceFilter;
+    ScopedPointer<AudioProcessorStateCache> stateCache;
     AudioSampleBuffer bufferSpace;
     HeapBlock <float*> channels;
     MidiBuffer midiEvents, incomingEvents;
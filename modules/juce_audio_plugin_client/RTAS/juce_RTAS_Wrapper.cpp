@@ -155,6 +155,7 @@ public:
     {
         asyncUpdater = new InternalAsyncUpdater (*this);
         juceFilter = createPluginFilterOfType (AudioProcessor::wrapperType_RTAS);
+        stateCache = new AudioProcessorStateCache (*juceFilter);
 
         AddChunk (juceChunkType, "Juce Audio Plugin Data");
 
@@ -174,6 +175,7 @@ public:
             if (prepared)
                 juceFilter->releaseResources();
 
+            stateCache = nullptr;
             juceFilter = nullptr;
             asyncUpdater = nullptr;
 
@@ -624,8 +626,7 @@ protected:
     {
         if (chunkID == juceChunkType)
         {
-            tempFilterData.setSize (0);
-            juceFilter->getStateInformation (tempFilterData);
+            stateCache->getState (tempFilterData, false);
 
             *size = sizeof (SFicPlugInChunkHeader) + tempFilterData.getSize();
             return noErr;
@@ -639,7 +640,7 @@ protected:
         if (chunkID == juceChunkType)
         {
             if (tempFilterData.getSize() == 0)
-                juceFilter->getStateInformation (tempFilterData);
+                stateCache->getState (tempFilterData, false);
 
             chunk->fSize = sizeof (SFicPlugInChunkHeader) + tempFilterData.getSize();
             tempFilterData.copyTo ((void*) chunk->fData, 0, tempFilterData.getSize());
@@ -660,8 +661,8 @@ protected:
 
             if (chunk->fSize - sizeof (SFicPlugInChunkHeader) > 0)
             {
-                juceFilter->setStateInformation ((void*) chunk->fData,
-                                                 chunk->fSize - sizeof (SFicPlugInChunkHeader));
+                stateCache->setState ((void*) chunk->fData,
+                                      chunk->fSize - sizeof (SFicPlugInChunkHeader), false);
             }
 
             return noErr;
@@ -793,6 +794,7 @@ public:
     //==============================================================================
 private:
     ScopedPointer<AudioProcessor> juceFilter;
+    ScopedPointer<AudioProcessorStateCache> stateCache;
     MidiBuffer midiEvents;
     ScopedPointer<CEffectMIDIOtherBufferedNode> midiBufferNode;
     ScopedPointer<CEffectMIDITransport> midiTransport;
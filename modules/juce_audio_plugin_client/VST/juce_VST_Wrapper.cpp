@@ -317,6 +317,7 @@ public:
     JuceVSTWrapper (audioMasterCallback audioMaster, AudioProcessor* const af)
        : AudioEffectX (audioMaster, af->getNumPrograms(), af->getNumParameters()),
          filter (af),
+         stateCache (new AudioProcessorStateCache (*af)),
          chunkMemoryTime (0),
          speakerIn (kSpeakerArrEmpty),
          speakerOut (kSpeakerArrEmpty),
@@ -364,6 +365,7 @@ public:
 
                 hasShutdown = true;
 
+                stateCache = nullptr;
                 delete filter;
                 filter = nullptr;
 
@@ -642,21 +644,8 @@ public:
         if (! midiEvents.isEmpty())
         {
            #if JucePlugin_ProducesMidiOutput
-            const int numEvents = midiEvents.getNumEvents();
-
-            outgoingEvents.ensureSize (numEvents);
             outgoingEvents.clear();
-
-            const juce::uint8* midiEventData;
-            int midiEventSize, midiEventPosition;
-            MidiBuffer::Iterator i (midiEvents);
-
-            while (i.getNextEvent (midiEventData, midiEventSize, midiEventPosition))
-            {
-                jassert (midiEventPosition >= 0 && midiEventPosition < numSamples);
-
-                outgoingEvents.addEvent (midiEventData, midiEventSize, midiEventPosition);
-            }
+            outgoingEvents.addEvents (midiEvents, numSamples);
 
             sendVstEventsToHost (outgoingEvents.events);
            #elif JUCE_DEBUG
@@ -717,7 +706,7 @@ public:
             AudioEffectX::resume();
 
            #if JucePlugin_ProducesMidiOutput
-            outgoingEvents.ensureSize (512);
+            outgoingEvents.prepare (512, 8192);
            #endif
         }
     }
@@ -1004,11 +993,7 @@ public:
         if (filter == nullptr)
             return 0;
 
-        chunkMemory.setSize (0);
-        if (onlyStoreCurrentProgramData)
-            filter->getCurrentProgramStateInformation (chunkMemory);
-        else
-            filter->getStateInformation (chunkMemory);
+        stateCache->getState (chunkMemory, onlyStoreCurrentProgramData);
 
         *data = (void*) chunkMemory.getData();
 
@@ -1027,12 +1012,7 @@ public:
             chunkMemoryTime = 0;
 
             if (byteSize > 0 && data != nullptr)
-            {
-                if (onlyRestoreCurrentProgramData)
-                    filter->setCurrentProgramStateInformation (data, byteSize);
-                else
-                    filter->setStateInformation (data, byteSize);
-            }
+                stateCache->setState (data, byteSize, onlyRestoreCurrentProgramData);
         }
 
         return 0;
@@ -1441,6 +1421,7 @@ public:
     //==============================================================================
 private:
     AudioProcessor* filter;
+    ScopedPointer<AudioProcessorStateCache> stateCache;
     juce::MemoryBlock chunkMemory;
     juce::uint32 chunkMemoryTime;
     ScopedPointer<EditorCompWrapper> editorComp;
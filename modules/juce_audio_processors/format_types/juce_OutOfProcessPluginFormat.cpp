@@ -0,0 +1,1365 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+
+namespace OutOfProcessPluginHelpers
+{
+    static const char* const commandLinePrefix = "--juce-plugin-host:";
+    static const uint32 magicMessageHeader = 0x3e8a5f27;
+
+    enum
+    {
+        blockMagic = 0x6a6f6272,
+        replyMagic = 0x6a6f7270,
+        maxMidiBytesPerBlock = 65536,
+        maxParameterChangesPerBlock = 1024
+    };
+
+    // These are sent through the shared-memory channel, so their layouts are kept the same
+    // for 32 and 64-bit processes.
+    struct BlockRequest
+    {
+        uint32 magic, sequenceNumber;
+        int32 numSamples, numParameterChanges, numMidiBytes, flags;
+
+        double bpm, timeInSeconds, editOriginTime, ppqPosition,
+               ppqPositionOfLastBarStart, ppqLoopStart, ppqLoopEnd;
+        int64 timeInSamples;
+        int32 timeSigNumerator, timeSigDenominator, frameRate, reserved;
+    };
+
+    enum
+    {
+        hasPositionFlag = 1,
+        isPlayingFlag   = 2,
+        isRecordingFlag = 4,
+        isLoopingFlag   = 8
+    };
+
+    struct BlockReply
+    {
+        uint32 magic, sequenceNumber;
+        int32 numMidiBytes, latencySamples;
+        int64 processingMicroseconds;
+    };
+
+    struct ParameterChange
+    {
+        int32 parameterIndex;
+        float value;
+    };
+
+    static MemoryBlock xmlToMemoryBlock (const XmlElement& xml)
+    {
+        const String text (xml.createDocument (String::empty, true, false));
+        return MemoryBlock (text.toRawUTF8(), text.getNumBytesAsUTF8());
+    }
+
+    static XmlElement* memoryBlockToXml (const MemoryBlock& data)
+    {
+        return XmlDocument::parse (String::fromUTF8 (static_cast<const char*> (data.getData()), (int) data.getSize()));
+    }
+
+    //==============================================================================
+    // MIDI events are packed as a 32-bit sample position, a 32-bit size, and the bytes.
+    static int getPackedMidiSize (const MidiBuffer& midi, const int startSample, const int numSamples) noexcept
+    {
+        MidiBuffer::Iterator i (midi);
+        i.setNextSamplePosition (startSample);
+
+        const uint8* data;
+        int numBytes, position, total = 0;
+
+        while (i.getNextEvent (data, numBytes, position) && position < startSample + numSamples)
+        {
+            if (total + 8 + numBytes > (int) maxMidiBytesPerBlock)
+                break;
+
+            total += 8 + numBytes;
+        }
+
+        return total;
+    }
+
+    static void packMidi (char* dest, const int maxBytes, const MidiBuffer& midi,
+                          const int startSample, const int numSamples) noexcept
+    {
+        MidiBuffer::Iterator i (midi);
+        i.setNextSamplePosition (startSample);
+
+        const uint8* data;
+        int numBytes, position, total = 0;
+
+        while (i.getNextEvent (data, numBytes, position) && position < startSample + numSamples
+                 && total + 8 + numBytes <= maxBytes)
+        {
+            const int32 header[2] = { (int32) (position - startSample), (int32) numBytes };
+            memcpy (dest + total, header, sizeof (header));
+            memcpy (dest + total + 8, data, (size_t) numBytes);
+            total += 8 + numBytes;
+        }
+    }
+
+    static void unpackMidi (const char* src, const int numBytesPacked, MidiBuffer& dest, const int sampleOffset)
+    {
+        for (int pos = 0; pos + 8 <= numBytesPacked;)
+        {
+            int32 header[2];
+            memcpy (header, src + pos, sizeof (header));
+
+            if (header[1] <= 0 || pos + 8 + header[1] > numBytesPacked)
+                break;
+
+            dest.addEvent (src + pos + 8, (int) header[1], (int) header[0] + sampleOffset);
+            pos += 8 + (int) header[1];
+        }
+    }
+
+    //==============================================================================
+    static XmlElement* createInfo (AudioPluginInstance& plugin)
+    {
+        XmlElement* const info = new XmlElement ("INFO");
+        info->setAttribute ("name", plugin.getName());
+        info->setAttribute ("numIns", plugin.getNumInputChannels());
+        info->setAttribute ("numOuts", plugin.getNumOutputChannels());
+        info->setAttribute ("acceptsMidi", plugin.acceptsMidi());
+        info->setAttribute ("producesMidi", plugin.producesMidi());
+        info->setAttribute ("silenceInSilenceOut", plugin.silenceInProducesSilenceOut());
+        info->setAttribute ("tail", plugin.getTailLengthSeconds());
+        info->setAttribute ("latency", plugin.getLatencySamples());
+        info->setAttribute ("numPrograms", plugin.getNumPrograms());
+        info->setAttribute ("program", plugin.getCurrentProgram());
+
+        for (int i = 0; i < plugin.getNumParameters(); ++i)
+        {
+            XmlElement* const param = info->createNewChildElement ("PARAM");
+            param->setAttribute ("name", plugin.getParameterName (i));
+            param->setAttribute ("label", plugin.getParameterLabel (i));
+            param->setAttribute ("value", plugin.getParameter (i));
+            param->setAttribute ("automatable", plugin.isParameterAutomatable (i));
+        }
+
+        return info;
+    }
+}
+
+//==============================================================================
+/*  Runs in the host process, and looks after one of the child processes, which
+    may be hosting several plugins.
+*/
+class OutOfProcessPluginFormat::HostProcess  : public ReferenceCountedObject,
+                                               public InterprocessConnection,
+                                               private AsyncChildProcess::Listener
+{
+public:
+    HostProcess (const File& exe, const int timeout)
+        : InterprocessConnection (false, OutOfProcessPluginHelpers::magicMessageHeader),
+          executable (exe), timeoutMs (timeout), lastRequestId (0), expectedRequestId (0)
+    {
+    }
+
+    ~HostProcess()
+    {
+        disconnect();
+
+        if (childProcess != nullptr)
+        {
+            childProcess->kill();
+            childProcess = nullptr;
+        }
+    }
+
+    typedef ReferenceCountedObjectPtr<HostProcess> Ptr;
+
+    bool start()
+    {
+        const String pipeName ("jucePluginHost_" + String::toHexString (Random::getSystemRandom().nextInt64()));
+
+        if (! createPipe (pipeName, timeoutMs))
+            return false;
+
+        StringArray args;
+        args.add (executable.getFullPathName());
+        args.add (OutOfProcessPluginHelpers::commandLinePrefix + pipeName);
+
+        childProcess = new AsyncChildProcess (*this);
+        return childProcess->start (args);
+    }
+
+    bool hasCrashed() const noexcept        { return crashed.get() != 0; }
+    int getNextInstanceId() noexcept        { return ++lastInstanceId; }
+
+    /** Sends a request to the child and waits for its reply. The caller must delete the
+        reply, which will be nullptr if the child didn't respond in time.
+    */
+    XmlElement* sendRequest (XmlElement& request)
+    {
+        if (hasCrashed())
+            return nullptr;
+
+        const ScopedLock sl (requestLock);
+
+        const int requestId = ++lastRequestId;
+        request.setAttribute ("requestId", requestId);
+
+        {
+            const ScopedLock rl (replyLock);
+            expectedRequestId = requestId;
+            reply = nullptr;
+            replyReceived.reset();
+        }
+
+        if (! sendMessage (OutOfProcessPluginHelpers::xmlToMemoryBlock (request)))
+            return nullptr;
+
+        const uint32 endTime = Time::getMillisecondCounter() + (uint32) timeoutMs;
+
+        // (if the child dies, processFinished() signals the event, so there's no need to poll quickly)
+        while (! replyReceived.wait (500))
+            if (hasCrashed() || Time::getMillisecondCounter() > endTime)
+                break;
+
+        const ScopedLock rl (replyLock);
+        expectedRequestId = 0;
+        return reply.release();
+    }
+
+    Atomic<int> numInstances;
+
+private:
+    //==============================================================================
+    const File executable;
+    const int timeoutMs;
+    ScopedPointer<AsyncChildProcess> childProcess;
+    Atomic<int> crashed, lastInstanceId;
+    CriticalSection requestLock, replyLock;
+    WaitableEvent replyReceived;
+    ScopedPointer<XmlElement> reply;
+    int lastRequestId, expectedRequestId;
+
+    void connectionMade() {}
+
+    void connectionLost()
+    {
+        crashed = 1;
+        replyReceived.signal();
+    }
+
+    void messageReceived (const MemoryBlock& message)
+    {
+        ScopedPointer<XmlElement> xml (OutOfProcessPluginHelpers::memoryBlockToXml (message));
+
+        if (xml != nullptr)
+        {
+            const ScopedLock rl (replyLock);
+
+            // (replies to requests that have already timed out are ignored)
+            if (expectedRequestId != 0 && xml->getIntAttribute ("requestId") == expectedRequestId)
+            {
+                reply = xml;
+                replyReceived.signal();
+            }
+        }
+    }
+
+    void processOutputReceived (AsyncChildProcess&, const void*, size_t) {}
+
+    void processFinished (AsyncChildProcess&, int)
+    {
+        crashed = 1;
+        replyReceived.signal();
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (HostProcess)
+};
+
+//==============================================================================
+/*  The AudioPluginInstance that the host sees, which passes everything on to the
+    plugin in the child process.
+*/
+class OutOfProcessPluginFormat::ProxyInstance  : public AudioPluginInstance
+{
+public:
+    ProxyInstance (HostProcess* const p, const int id, const PluginDescription& desc, const XmlElement& info)
+        : process (p), instanceId (id), description (desc),
+          isPrepared (false), maxChunkSize (0), numTransportChannels (0), lastSequenceNumber (0),
+          emptyBuffer (1, 0)
+    {
+        applyInfo (info);
+        setPlayConfigDetails (numIns, numOuts, 0, 0);
+        ++(process->numInstances);
+    }
+
+    ~ProxyInstance()
+    {
+        releaseResources();
+
+        XmlElement request ("DELETE");
+        request.setAttribute ("id", instanceId);
+        delete process->sendRequest (request);
+
+        --(process->numInstances);
+    }
+
+    //==============================================================================
+    void fillInPluginDescription (PluginDescription& desc) const
+    {
+        desc = description;
+        desc.numInputChannels = getNumInputChannels();
+        desc.numOutputChannels = getNumOutputChannels();
+    }
+
+    const String getName() const        { return description.name; }
+
+    //==============================================================================
+    void prepareToPlay (double newSampleRate, int estimatedSamplesPerBlock)
+    {
+        releaseResources();
+
+        maxChunkSize = jmax (512, estimatedSamplesPerBlock);
+        numTransportChannels = jmax (1, getNumInputChannels(), getNumOutputChannels());
+
+        const size_t audioBytes = 16 + (size_t) numTransportChannels * (size_t) ((maxChunkSize + 3) & ~3) * sizeof (float);
+        const size_t headerBytes = sizeof (OutOfProcessPluginHelpers::BlockRequest)
+                                    + OutOfProcessPluginHelpers::maxParameterChangesPerBlock * sizeof (OutOfProcessPluginHelpers::ParameterChange)
+                                    + OutOfProcessPluginHelpers::maxMidiBytesPerBlock;
+
+        const String channelName ("jucePluginAudio_" + String::toHexString (Random::getSystemRandom().nextInt64()));
+        ScopedPointer<SharedMemoryChannel> newChannel (new SharedMemoryChannel());
+
+        if (! newChannel->createNewChannel (channelName, (int) (2 * (audioBytes + headerBytes) + 4096)))
+            return;
+
+        XmlElement request ("PREPARE");
+        request.setAttribute ("id", instanceId);
+        request.setAttribute ("channel", channelName);
+        request.setAttribute ("sampleRate", newSampleRate);
+        request.setAttribute ("blockSize", maxChunkSize);
+        request.setAttribute ("numIns", getNumInputChannels());
+        request.setAttribute ("numOuts", getNumOutputChannels());
+
+        const ScopedPointer<XmlElement> info (process->sendRequest (request));
+
+        if (info != nullptr && info->hasTagName ("INFO"))
+        {
+            applyInfo (*info);
+            channel = newChannel;
+            audioChannel = new SharedMemoryAudioChannel (*channel);
+            emptyBuffer.setSize (1, maxChunkSize);
+            emptyBuffer.clear();
+            midiOut.ensureSize (OutOfProcessPluginHelpers::maxMidiBytesPerBlock);
+            getParameterChangeQueue().clear();
+            isPrepared = true;
+        }
+    }
+
+    void releaseResources()
+    {
+        if (isPrepared)
+        {
+            {
+                const ScopedLock sl (getCallbackLock());
+                isPrepared = false;
+            }
+
+            XmlElement request ("RELEASE");
+            request.setAttribute ("id", instanceId);
+            delete process->sendRequest (request);
+
+            audioChannel = nullptr;
+            channel = nullptr;
+        }
+    }
+
+    void processBlock (AudioSampleBuffer& buffer, MidiBuffer& midiMessages)
+    {
+        const int numSamples = buffer.getNumSamples();
+        ParameterChangeQueue& changes = getParameterChangeQueue();
+        const int numChanges = changes.readChanges (numSamples);
+
+        for (int i = 0; i < numChanges; ++i)
+        {
+            const ParameterChangeQueue::Change& c = changes.getChange (i);
+
+            if (isPositiveAndBelow (c.parameterIndex, parameterValues.size()))
+                parameterValues.getReference (c.parameterIndex) = c.value;
+        }
+
+        if (! isPrepared || process->hasCrashed())
+        {
+            jassert (isPrepared); // you need to call prepareToPlay() first!
+            buffer.clear();
+            midiMessages.clear();
+            return;
+        }
+
+        AudioPlayHead::CurrentPositionInfo position;
+        const bool hasPosition = getPlayHead() != nullptr && getPlayHead()->getCurrentPosition (position);
+
+        midiOut.clear();
+        int changeIndex = 0;
+
+        for (int start = 0; start < numSamples; start += maxChunkSize)
+        {
+            const int num = jmin (maxChunkSize, numSamples - start);
+
+            int numChangesInChunk = 0;
+            while (changeIndex + numChangesInChunk < numChanges
+                    && changes.getChange (changeIndex + numChangesInChunk).samplePosition < start + num)
+                ++numChangesInChunk;
+
+            if (! processChunk (buffer, start, num, midiMessages, changeIndex, numChangesInChunk,
+                                hasPosition ? &position : nullptr))
+            {
+                for (int i = buffer.getNumChannels(); --i >= 0;)
+                    buffer.clear (i, start, num);
+
+                ++blocksDropped;
+            }
+
+            changeIndex += numChangesInChunk;
+
+            if (hasPosition)
+            {
+                position.timeInSamples += num;
+                position.timeInSeconds += num / getSampleRate();
+                position.ppqPosition += num * position.bpm / (60.0 * getSampleRate());
+            }
+        }
+
+        midiMessages.swapWith (midiOut);
+    }
+
+    void reset()
+    {
+        XmlElement request ("RESET");
+        request.setAttribute ("id", instanceId);
+        delete process->sendRequest (request);
+    }
+
+    //==============================================================================
+    const String getInputChannelName (int index) const      { return "Input " + String (index + 1); }
+    const String getOutputChannelName (int index) const     { return "Output " + String (index + 1); }
+    bool isInputChannelStereoPair (int index) const         { return (index & 1) == 0 && index + 1 < getNumInputChannels(); }
+    bool isOutputChannelStereoPair (int index) const        { return (index & 1) == 0 && index + 1 < getNumOutputChannels(); }
+
+    bool silenceInProducesSilenceOut() const                { return silenceInSilenceOut; }
+    double getTailLengthSeconds() const                     { return tailLengthSeconds; }
+    bool acceptsMidi() const                                { return wantsMidi; }
+    bool producesMidi() const                               { return makesMidi; }
+
+    AudioProcessorEditor* createEditor()                    { return nullptr; }
+    bool hasEditor() const                                  { return false; }
+
+    //==============================================================================
+    int getNumParameters()                                  { return parameterValues.size(); }
+
+    const String getParameterName (int index)
+    {
+        const ScopedLock sl (infoLock);
+        return parameterNames [index];
+    }
+
+    String getParameterLabel (int index) const
+    {
+        const ScopedLock sl (infoLock);
+        return parameterLabels [index];
+    }
+
+    bool isParameterAutomatable (int index) const
+    {
+        const ScopedLock sl (infoLock);
+        return ! nonAutomatableParameters.contains (index);
+    }
+
+    float getParameter (int index)
+    {
+        return isPositiveAndBelow (index, parameterValues.size()) ? parameterValues.getUnchecked (index) : 0.0f;
+    }
+
+    const String getParameterText (int index)
+    {
+        XmlElement request ("GETPARAMTEXT");
+        request.setAttribute ("id", instanceId);
+        request.setAttribute ("index", index);
+
+        const ScopedPointer<XmlElement> reply (process->sendRequest (request));
+
+        return reply != nullptr ? reply->getStringAttribute ("text")
+                                : String (getParameter (index), 2);
+    }
+
+    void setParameter (int index, float newValue)
+    {
+        if (! isPositiveAndBelow (index, parameterValues.size()))
+            return;
+
+        parameterValues.getReference (index) = newValue;
+
+        // While the plugin's playing, changes travel to it along with the audio..
+        if (isPrepared && getParameterChangeQueue().addChange (index, newValue))
+            return;
+
+        XmlElement request ("SETPARAM");
+        request.setAttribute ("id", instanceId);
+        request.setAttribute ("index", index);
+        request.setAttribute ("value", newValue);
+        delete process->sendRequest (request);
+    }
+
+    //==============================================================================
+    int getNumPrograms()                                    { return numPrograms; }
+    int getCurrentProgram()                                 { return currentProgram; }
+
+    void setCurrentProgram (int index)
+    {
+        XmlElement request ("SETPROGRAM");
+        request.setAttribute ("id", instanceId);
+        request.setAttribute ("index", index);
+        sendRequestAndApplyInfo (request);
+    }
+
+    const String getProgramName (int index)
+    {
+        XmlElement request ("GETPROGRAMNAME");
+        request.setAttribute ("id", instanceId);
+        request.setAttribute ("index", index);
+
+        const ScopedPointer<XmlElement> reply (process->sendRequest (request));
+        return reply != nullptr ? reply->getStringAttribute ("text") : String::empty;
+    }
+
+    void changeProgramName (int index, const String& newName)
+    {
+        XmlElement request ("CHANGEPROGRAMNAME");
+        request.setAttribute ("id", instanceId);
+        request.setAttribute ("index", index);
+        request.setAttribute ("name", newName);
+        delete process->sendRequest (request);
+    }
+
+    //==============================================================================
+    void getStateInformation (MemoryBlock& destData)                    { getState (destData, false); }
+    void getCurrentProgramStateInformation (MemoryBlock& destData)      { getState (destData, true); }
+    void setStateInformation (const void* data, int sizeInBytes)        { setState (data, sizeInBytes, false); }
+    void setCurrentProgramStateInformation (const void* data, int size) { setState (data, size, true); }
+
+    //==============================================================================
+    void getStatistics (Statistics& s) const noexcept
+    {
+        s.blocksProcessed = blocksProcessed.get();
+        s.blocksDropped = blocksDropped.get();
+        s.hasCrashed = process->hasCrashed();
+
+        const double numBlocks = (double) jmax ((int64) 1, s.blocksProcessed);
+        s.averageRoundTripMs  = totalRoundTripMicroseconds.get() * 0.001 / numBlocks;
+        s.averageProcessingMs = totalProcessingMicroseconds.get() * 0.001 / numBlocks;
+        s.averageOverheadMs   = jmax (0.0, s.averageRoundTripMs - s.averageProcessingMs);
+        s.maxOverheadMs       = maxOverheadMicroseconds.get() * 0.001;
+    }
+
+private:
+    //==============================================================================
+    HostProcess::Ptr process;
+    const int instanceId;
+    PluginDescription description;
+
+    CriticalSection infoLock;
+    StringArray parameterNames, parameterLabels;
+    Array<int> nonAutomatableParameters;
+    Array<float> parameterValues;
+    int numIns, numOuts, numPrograms, currentProgram;
+    bool wantsMidi, makesMidi, silenceInSilenceOut;
+    double tailLengthSeconds;
+
+    ScopedPointer<SharedMemoryChannel> channel;
+    ScopedPointer<SharedMemoryAudioChannel> audioChannel;
+    bool isPrepared;
+    int maxChunkSize, numTransportChannels;
+    uint32 lastSequenceNumber;
+    AudioSampleBuffer emptyBuffer;
+    MidiBuffer midiOut;
+
+    Atomic<int64> blocksProcessed, blocksDropped, totalRoundTripMicroseconds,
+                  totalProcessingMicroseconds, maxOverheadMicroseconds;
+
+    //==============================================================================
+    void applyInfo (const XmlElement& info)
+    {
+        numIns = info.getIntAttribute ("numIns");
+        numOuts = info.getIntAttribute ("numOuts");
+        wantsMidi = info.getBoolAttribute ("acceptsMidi");
+        makesMidi = info.getBoolAttribute ("producesMidi");
+        silenceInSilenceOut = info.getBoolAttribute ("silenceInSilenceOut");
+        tailLengthSeconds = info.getDoubleAttribute ("tail");
+        numPrograms = info.getIntAttribute ("numPrograms");
+        currentProgram = info.getIntAttribute ("program");
+        setLatencySamples (info.getIntAttribute ("latency"));
+
+        StringArray names, labels;
+        Array<int> nonAutomatable;
+        Array<float> values;
+
+        forEachXmlChildElementWithTagName (info, e, "PARAM")
+        {
+            if (! e->getBoolAttribute ("automatable", true))
+                nonAutomatable.add (names.size());
+
+            names.add (e->getStringAttribute ("name"));
+            labels.add (e->getStringAttribute ("label"));
+            values.add ((float) e->getDoubleAttribute ("value"));
+        }
+
+        {
+            const ScopedLock sl (infoLock);
+            parameterNames.swapWith (names);
+            parameterLabels.swapWith (labels);
+            nonAutomatableParameters.swapWithArray (nonAutomatable);
+        }
+
+        const ScopedLock sl (getCallbackLock());
+        parameterValues.swapWithArray (values);
+    }
+
+    void sendRequestAndApplyInfo (XmlElement& request)
+    {
+        const ScopedPointer<XmlElement> info (process->sendRequest (request));
+
+        if (info != nullptr && info->hasTagName ("INFO"))
+        {
+            applyInfo (*info);
+            updateHostDisplay();
+        }
+    }
+
+    void getState (MemoryBlock& destData, const bool currentProgramOnly)
+    {
+        XmlElement request ("GETSTATE");
+        request.setAttribute ("id", instanceId);
+        request.setAttribute ("program", currentProgramOnly);
+
+        const ScopedPointer<XmlElement> reply (process->sendRequest (request));
+        destData.setSize (0);
+
+        if (reply != nullptr)
+            destData.fromBase64Encoding (reply->getStringAttribute ("data"));
+    }
+
+    void setState (const void* data, const int sizeInBytes, const bool currentProgramOnly)
+    {
+        XmlElement request ("SETSTATE");
+        request.setAttribute ("id", instanceId);
+        request.setAttribute ("program", currentProgramOnly);
+        request.setAttribute ("data", MemoryBlock (data, (size_t) sizeInBytes).toBase64Encoding());
+        sendRequestAndApplyInfo (request);
+    }
+
+    //==============================================================================
+    bool processChunk (AudioSampleBuffer& buffer, const int startSample, const int numSamples,
+                       const MidiBuffer& midiIn, const int firstChange, const int numChanges,
+                       const AudioPlayHead::CurrentPositionInfo* const position)
+    {
+        using namespace OutOfProcessPluginHelpers;
+
+        const int64 startTime = Time::getHighResolutionTicks();
+        const uint32 sequenceNumber = ++lastSequenceNumber;
+
+        if (! sendChunk (buffer, startSample, numSamples, midiIn, firstChange, numChanges, position, sequenceNumber))
+            return false;
+
+        const int timeoutMs = jmax (5, roundToInt (2000.0 * numSamples / getSampleRate()));
+        const uint32 timeoutEnd = Time::getMillisecondCounter() + (uint32) timeoutMs;
+
+        for (;;)
+        {
+            // Read the reply header and the MIDI that follows it..
+            const uint32 now = Time::getMillisecondCounter();
+            const int timeLeft = now < timeoutEnd ? (int) (timeoutEnd - now) : 0;
+
+            size_t size;
+            const char* const data = static_cast <const char*> (channel->startReadingMessage (size, timeLeft));
+
+            if (data == nullptr)
+                return false;
+
+            BlockReply reply;
+            zerostruct (reply);
+
+            if (size >= sizeof (reply))
+                memcpy (&reply, data, sizeof (reply));
+
+            if (reply.magic != (uint32) replyMagic)
+            {
+                // (probably the audio from a reply whose header we gave up on)
+                channel->finishReadingMessage();
+                continue;
+            }
+
+            const bool isCurrent = (reply.sequenceNumber == sequenceNumber);
+
+            if (isCurrent)
+                unpackMidi (data + sizeof (reply), jmin ((int) reply.numMidiBytes, (int) (size - sizeof (reply))),
+                            midiOut, startSample);
+
+            channel->finishReadingMessage();
+
+            // ..and then the audio
+            const AudioSampleBuffer* const processed = audioChannel->receiveAudio (timeoutMs);
+
+            if (processed == nullptr)
+                return false;
+
+            if (! isCurrent)
+            {
+                // (a late reply to a block that we've already given up on)
+                audioChannel->releaseAudio();
+                continue;
+            }
+
+            for (int i = jmin (buffer.getNumChannels(), processed->getNumChannels()); --i >= 0;)
+                buffer.copyFrom (i, startSample, *processed, i, 0, jmin (numSamples, processed->getNumSamples()));
+
+            audioChannel->releaseAudio();
+
+            if (reply.latencySamples != getLatencySamples())
+                setLatencySamples (reply.latencySamples);
+
+            const int64 roundTrip = (int64) (1.0e6 * Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - startTime));
+            const int64 overhead = roundTrip - reply.processingMicroseconds;
+
+            ++blocksProcessed;
+            totalRoundTripMicroseconds += roundTrip;
+            totalProcessingMicroseconds += reply.processingMicroseconds;
+
+            if (overhead > maxOverheadMicroseconds.get())
+                maxOverheadMicroseconds = overhead;
+
+            return true;
+        }
+    }
+
+    bool sendChunk (const AudioSampleBuffer& buffer, const int startSample, const int numSamples,
+                    const MidiBuffer& midiIn, const int firstChange, const int numChanges,
+                    const AudioPlayHead::CurrentPositionInfo* const position, const uint32 sequenceNumber)
+    {
+        using namespace OutOfProcessPluginHelpers;
+
+        const int numMidiBytes = wantsMidi ? getPackedMidiSize (midiIn, startSample, numSamples) : 0;
+        const size_t size = sizeof (BlockRequest) + (size_t) numChanges * sizeof (ParameterChange) + (size_t) numMidiBytes;
+
+        char* const dest = static_cast <char*> (channel->startWritingMessage (size, 0));
+
+        if (dest == nullptr)
+            return false;
+
+        BlockRequest request;
+        zerostruct (request);
+        request.magic = (uint32) blockMagic;
+        request.sequenceNumber = sequenceNumber;
+        request.numSamples = numSamples;
+        request.numParameterChanges = numChanges;
+        request.numMidiBytes = numMidiBytes;
+
+        if (position != nullptr)
+        {
+            request.flags = hasPositionFlag | (position->isPlaying   ? isPlayingFlag : 0)
+                                            | (position->isRecording ? isRecordingFlag : 0)
+                                            | (position->isLooping   ? isLoopingFlag : 0);
+            request.bpm = position->bpm;
+            request.timeInSeconds = position->timeInSeconds;
+            request.editOriginTime = position->editOriginTime;
+            request.ppqPosition = position->ppqPosition;
+            request.ppqPositionOfLastBarStart = position->ppqPositionOfLastBarStart;
+            request.ppqLoopStart = position->ppqLoopStart;
+            request.ppqLoopEnd = position->ppqLoopEnd;
+            request.timeInSamples = position->timeInSamples;
+            request.timeSigNumerator = position->timeSigNumerator;
+            request.timeSigDenominator = position->timeSigDenominator;
+            request.frameRate = (int32) position->frameRate;
+        }
+
+        memcpy (dest, &request, sizeof (request));
+        char* d = dest + sizeof (request);
+
+        for (int i = 0; i < numChanges; ++i)
+        {
+            const ParameterChangeQueue::Change& c = getParameterChangeQueue().getChange (firstChange + i);
+            const ParameterChange change = { (int32) c.parameterIndex, c.value };
+            memcpy (d, &change, sizeof (change));
+            d += sizeof (change);
+        }
+
+        packMidi (d, numMidiBytes, midiIn, startSample, numSamples);
+        channel->finishWritingMessage();
+
+        const int numChannels = jmin (numTransportChannels, buffer.getNumChannels());
+
+        if (numChannels == 0)
+            return audioChannel->sendAudio (emptyBuffer, 0, numSamples, 0);
+
+        const AudioSampleBuffer channels (buffer.getArrayOfChannels(), numChannels, buffer.getNumSamples());
+        return audioChannel->sendAudio (channels, startSample, numSamples, 0);
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ProxyInstance)
+};
+
+//==============================================================================
+/*  Runs in the child process, and looks after one of the plugins that it's hosting.
+    While the plugin is prepared, a thread waits for blocks to arrive from the host,
+    and sends back the processed audio.
+*/
+class OutOfProcessPluginFormat::HostedPlugin  : private Thread,
+                                                private AudioPlayHead
+{
+public:
+    HostedPlugin (const int id, AudioPluginInstance* const p)
+        : Thread ("Plugin audio"), instanceId (id), plugin (p),
+          processBuffer (1, 0), isPrepared (false), hasPosition (false)
+    {
+    }
+
+    ~HostedPlugin()
+    {
+        release();
+    }
+
+    bool prepare (const String& channelName, const double sampleRate, const int blockSize,
+                  const int numIns, const int numOuts)
+    {
+        release();
+
+        if (! channel.openExisting (channelName))
+            return false;
+
+        plugin->setPlayConfigDetails (numIns, numOuts, sampleRate, blockSize);
+        plugin->setPlayHead (this);
+        plugin->prepareToPlay (sampleRate, blockSize);
+
+        processBuffer.setSize (jmax (1, numIns, numOuts), blockSize);
+        midiBuffer.ensureSize (OutOfProcessPluginHelpers::maxMidiBytesPerBlock);
+        parameterChanges.calloc (OutOfProcessPluginHelpers::maxParameterChangesPerBlock);
+        audioChannel = new SharedMemoryAudioChannel (channel);
+        isPrepared = true;
+
+        startThread (9);
+        return true;
+    }
+
+    void release()
+    {
+        stopThread (5000);
+
+        if (isPrepared)
+        {
+            isPrepared = false;
+            plugin->releaseResources();
+            plugin->setPlayHead (nullptr);
+        }
+
+        audioChannel = nullptr;
+        channel.close();
+    }
+
+    const int instanceId;
+    const ScopedPointer<AudioPluginInstance> plugin;
+
+private:
+    //==============================================================================
+    SharedMemoryChannel channel;
+    ScopedPointer<SharedMemoryAudioChannel> audioChannel;
+    AudioSampleBuffer processBuffer;
+    MidiBuffer midiBuffer;
+    HeapBlock<OutOfProcessPluginHelpers::ParameterChange> parameterChanges;
+    bool isPrepared, hasPosition;
+    CurrentPositionInfo position;
+
+    void run()
+    {
+        using namespace OutOfProcessPluginHelpers;
+
+        while (! threadShouldExit())
+        {
+            size_t size;
+            const char* const data = static_cast <const char*> (channel.startReadingMessage (size, 100));
+
+            if (data == nullptr)
+                continue;
+
+            BlockRequest request;
+            zerostruct (request);
+
+            if (size >= sizeof (request))
+                memcpy (&request, data, sizeof (request));
+
+            if (request.magic != (uint32) blockMagic)
+            {
+                channel.finishReadingMessage();
+                continue;
+            }
+
+            const int numChanges = jlimit (0, (int) maxParameterChangesPerBlock,
+                                           jmin ((int) request.numParameterChanges,
+                                                 (int) ((size - sizeof (request)) / sizeof (ParameterChange))));
+            memcpy (parameterChanges, data + sizeof (request), (size_t) numChanges * sizeof (ParameterChange));
+
+            const size_t midiOffset = sizeof (request) + (size_t) numChanges * sizeof (ParameterChange);
+            midiBuffer.clear();
+            unpackMidi (data + midiOffset, jmin ((int) request.numMidiBytes, (int) (size - midiOffset)), midiBuffer, 0);
+            readPosition (request);
+            channel.finishReadingMessage();
+
+            const AudioSampleBuffer* const input = audioChannel->receiveAudio (1000);
+
+            if (input == nullptr)
+                continue;
+
+            const int numSamples = jmin (input->getNumSamples(), processBuffer.getNumSamples());
+            const int numChannels = jmin (input->getNumChannels(), processBuffer.getNumChannels());
+
+            for (int i = processBuffer.getNumChannels(); --i >= 0;)
+            {
+                if (i < numChannels)
+                    processBuffer.copyFrom (i, 0, *input, i, 0, numSamples);
+                else
+                    processBuffer.clear (i, 0, numSamples);
+            }
+
+            audioChannel->releaseAudio();
+
+            for (int i = 0; i < numChanges; ++i)
+                if (isPositiveAndBelow ((int) parameterChanges[i].parameterIndex, plugin->getNumParameters()))
+                    plugin->setParameter (parameterChanges[i].parameterIndex, parameterChanges[i].value);
+
+            AudioSampleBuffer block (processBuffer.getArrayOfChannels(), processBuffer.getNumChannels(), numSamples);
+            const int64 startTime = Time::getHighResolutionTicks();
+
+            {
+                const ScopedLock sl (plugin->getCallbackLock());
+
+                if (plugin->isSuspended())
+                    block.clear();
+                else
+                    plugin->processBlock (block, midiBuffer);
+            }
+
+            const int64 processingTime = (int64) (1.0e6 * Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - startTime));
+            sendReply (request.sequenceNumber, processingTime, block, jmax (1, numChannels), numSamples);
+        }
+    }
+
+    void sendReply (const uint32 sequenceNumber, const int64 processingTime,
+                    const AudioSampleBuffer& block, const int numChannels, const int numSamples)
+    {
+        using namespace OutOfProcessPluginHelpers;
+
+        const int numMidiBytes = getPackedMidiSize (midiBuffer, 0, numSamples);
+        char* const dest = static_cast <char*> (channel.startWritingMessage (sizeof (BlockReply) + (size_t) numMidiBytes, 1000));
+
+        if (dest == nullptr)
+            return;
+
+        BlockReply reply;
+        reply.magic = (uint32) replyMagic;
+        reply.sequenceNumber = sequenceNumber;
+        reply.numMidiBytes = numMidiBytes;
+        reply.latencySamples = plugin->getLatencySamples();
+        reply.processingMicroseconds = processingTime;
+
+        memcpy (dest, &reply, sizeof (reply));
+        packMidi (dest + sizeof (reply), numMidiBytes, midiBuffer, 0, numSamples);
+        channel.finishWritingMessage();
+
+        const AudioSampleBuffer channels (block.getArrayOfChannels(), jmin (numChannels, block.getNumChannels()), numSamples);
+        audioChannel->sendAudio (channels, 0, numSamples, 1000);
+    }
+
+    void readPosition (const OutOfProcessPluginHelpers::BlockRequest& request) noexcept
+    {
+        using namespace OutOfProcessPluginHelpers;
+
+        hasPosition = (request.flags & hasPositionFlag) != 0;
+
+        if (hasPosition)
+        {
+            position.bpm = request.bpm;
+            position.timeSigNumerator = request.timeSigNumerator;
+            position.timeSigDenominator = request.timeSigDenominator;
+            position.timeInSamples = request.timeInSamples;
+            position.timeInSeconds = request.timeInSeconds;
+            position.editOriginTime = request.editOriginTime;
+            position.ppqPosition = request.ppqPosition;
+            position.ppqPositionOfLastBarStart = request.ppqPositionOfLastBarStart;
+            position.frameRate = (FrameRateType) request.frameRate;
+            position.isPlaying = (request.flags & isPlayingFlag) != 0;
+            position.isRecording = (request.flags & isRecordingFlag) != 0;
+            position.ppqLoopStart = request.ppqLoopStart;
+            position.ppqLoopEnd = request.ppqLoopEnd;
+            position.isLooping = (request.flags & isLoopingFlag) != 0;
+        }
+    }
+
+    bool getCurrentPosition (CurrentPositionInfo& result)
+    {
+        if (hasPosition)
+            result = position;
+
+        return hasPosition;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (HostedPlugin)
+};
+
+//==============================================================================
+/*  Runs in the child process, and handles requests from the host. */
+class OutOfProcessPluginFormat::ChildConnection  : public InterprocessConnection,
+                                                   private DeletedAtShutdown
+{
+public:
+    ChildConnection (AudioPluginFormatManager& fm)
+        : InterprocessConnection (true, OutOfProcessPluginHelpers::magicMessageHeader),
+          formatManager (fm)
+    {
+    }
+
+    ~ChildConnection()
+    {
+        disconnect();
+        plugins.clear();
+    }
+
+    void connectionMade() {}
+
+    void connectionLost()
+    {
+        plugins.clear();
+        JUCEApplication::quit();
+    }
+
+    void messageReceived (const MemoryBlock& message)
+    {
+        ScopedPointer<XmlElement> request (OutOfProcessPluginHelpers::memoryBlockToXml (message));
+
+        if (request == nullptr)
+            return;
+
+        ScopedPointer<XmlElement> reply (handleRequest (*request));
+
+        if (reply == nullptr)
+            reply = new XmlElement ("OK");
+
+        reply->setAttribute ("requestId", request->getIntAttribute ("requestId"));
+        sendMessage (OutOfProcessPluginHelpers::xmlToMemoryBlock (*reply));
+    }
+
+private:
+    AudioPluginFormatManager& formatManager;
+    OwnedArray<HostedPlugin> plugins;
+
+    HostedPlugin* findPlugin (const int instanceId) const noexcept
+    {
+        for (int i = plugins.size(); --i >= 0;)
+            if (plugins.getUnchecked(i)->instanceId == instanceId)
+                return plugins.getUnchecked(i);
+
+        return nullptr;
+    }
+
+    static XmlElement* createTextReply (const String& text)
+    {
+        XmlElement* const reply = new XmlElement ("TEXT");
+        reply->setAttribute ("text", text);
+        return reply;
+    }
+
+    XmlElement* handleRequest (const XmlElement& request)
+    {
+        const int instanceId = request.getIntAttribute ("id");
+
+        if (request.hasTagName ("CREATE"))
+        {
+            PluginDescription desc;
+            String errorMessage;
+
+            if (const XmlElement* const descXml = request.getFirstChildElement())
+                desc.loadFromXml (*descXml);
+
+            if (AudioPluginInstance* const instance = formatManager.createPluginInstance (desc, errorMessage))
+            {
+                plugins.add (new HostedPlugin (instanceId, instance));
+                return OutOfProcessPluginHelpers::createInfo (*instance);
+            }
+
+            XmlElement* const reply = new XmlElement ("ERROR");
+            reply->setAttribute ("message", errorMessage);
+            return reply;
+        }
+
+        HostedPlugin* const hosted = findPlugin (instanceId);
+
+        if (hosted == nullptr)
+            return new XmlElement ("ERROR");
+
+        AudioPluginInstance& plugin = *(hosted->plugin);
+        const int index = request.getIntAttribute ("index");
+
+        if (request.hasTagName ("DELETE"))
+        {
+            plugins.removeObject (hosted);
+        }
+        else if (request.hasTagName ("PREPARE"))
+        {
+            if (! hosted->prepare (request.getStringAttribute ("channel"),
+                                   request.getDoubleAttribute ("sampleRate"),
+                                   request.getIntAttribute ("blockSize"),
+                                   request.getIntAttribute ("numIns"),
+                                   request.getIntAttribute ("numOuts")))
+                return new XmlElement ("ERROR");
+
+            return OutOfProcessPluginHelpers::createInfo (plugin);
+        }
+        else if (request.hasTagName ("RELEASE"))
+        {
+            hosted->release();
+        }
+        else if (request.hasTagName ("RESET"))
+        {
+            plugin.reset();
+        }
+        else if (request.hasTagName ("SETPARAM"))
+        {
+            plugin.setParameter (index, (float) request.getDoubleAttribute ("value"));
+        }
+        else if (request.hasTagName ("GETPARAMTEXT"))
+        {
+            return createTextReply (plugin.getParameterText (index));
+        }
+        else if (request.hasTagName ("SETPROGRAM"))
+        {
+            plugin.setCurrentProgram (index);
+            return OutOfProcessPluginHelpers::createInfo (plugin);
+        }
+        else if (request.hasTagName ("GETPROGRAMNAME"))
+        {
+            return createTextReply (plugin.getProgramName (index));
+        }
+        else if (request.hasTagName ("CHANGEPROGRAMNAME"))
+        {
+            plugin.changeProgramName (index, request.getStringAttribute ("name"));
+        }
+        else if (request.hasTagName ("GETSTATE"))
+        {
+            MemoryBlock state;
+
+            if (request.getBoolAttribute ("program"))
+                plugin.getCurrentProgramStateInformation (state);
+            else
+                plugin.getStateInformation (state);
+
+            XmlElement* const reply = new XmlElement ("STATE");
+            reply->setAttribute ("data", state.toBase64Encoding());
+            return reply;
+        }
+        else if (request.hasTagName ("SETSTATE"))
+        {
+            MemoryBlock state;
+            state.fromBase64Encoding (request.getStringAttribute ("data"));
+
+            if (request.getBoolAttribute ("program"))
+                plugin.setCurrentProgramStateInformation (state.getData(), (int) state.getSize());
+            else
+                plugin.setStateInformation (state.getData(), (int) state.getSize());
+
+            return OutOfProcessPluginHelpers::createInfo (plugin);
+        }
+
+        return nullptr;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ChildConnection)
+};
+
+//==============================================================================
+OutOfProcessPluginFormat::OutOfProcessPluginFormat (AudioPluginFormat& formatToWrap,
+                                                    const int maxPlugins,
+                                                    const int requestTimeoutMillisecs,
+                                                    const File& hostExecutable)
+    : wrappedFormat (formatToWrap),
+      maxPluginsPerProcess (jmax (1, maxPlugins)),
+      timeoutMs (requestTimeoutMillisecs),
+      executable (hostExecutable != File::nonexistent ? hostExecutable
+                                                      : File::getSpecialLocation (File::currentExecutableFile))
+{
+}
+
+OutOfProcessPluginFormat::~OutOfProcessPluginFormat()
+{
+    processes.clear();
+}
+
+bool OutOfProcessPluginFormat::startHostIfRequested (const String& commandLine,
+                                                     AudioPluginFormatManager& formatManager)
+{
+    StringArray args;
+    args.addTokens (commandLine, true);
+
+    for (int i = 0; i < args.size(); ++i)
+    {
+        const String arg (args[i].unquoted());
+
+        if (arg.startsWith (OutOfProcessPluginHelpers::commandLinePrefix))
+        {
+            ChildConnection* const connection = new ChildConnection (formatManager);
+
+            if (! connection->connectToPipe (arg.fromFirstOccurrenceOf (OutOfProcessPluginHelpers::commandLinePrefix, false, false), -1))
+            {
+                delete connection;
+                JUCEApplication::quit();
+            }
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+int OutOfProcessPluginFormat::getNumHostProcesses() const
+{
+    const ScopedLock sl (lock);
+    return processes.size();
+}
+
+bool OutOfProcessPluginFormat::getStatistics (AudioPluginInstance& instance, Statistics& result)
+{
+    if (ProxyInstance* const proxy = dynamic_cast <ProxyInstance*> (&instance))
+    {
+        proxy->getStatistics (result);
+        return true;
+    }
+
+    return false;
+}
+
+AudioPluginInstance* OutOfProcessPluginFormat::createInstanceFromDescription (const PluginDescription& desc)
+{
+    HostProcess::Ptr process;
+
+    {
+        const ScopedLock sl (lock);
+
+        // Get rid of any processes that have crashed, or that have no plugins left..
+        for (int i = processes.size(); --i >= 0;)
+        {
+            HostProcess* const p = processes.getUnchecked(i);
+
+            if (p->hasCrashed() || p->getReferenceCount() == 1)
+                processes.remove (i);
+        }
+
+        for (int i = 0; i < processes.size(); ++i)
+        {
+            HostProcess* const p = processes.getUnchecked(i);
+
+            if (p->numInstances.get() < maxPluginsPerProcess)
+            {
+                process = p;
+                ++(p->numInstances); // (reserves the slot until the proxy takes it over)
+                break;
+            }
+        }
+
+        if (process == nullptr)
+        {
+            process = new HostProcess (executable, timeoutMs);
+
+            if (! process->start())
+                return nullptr;
+
+            ++(process->numInstances);
+            processes.add (process);
+        }
+    }
+
+    const int instanceId = process->getNextInstanceId();
+
+    XmlElement request ("CREATE");
+    request.setAttribute ("id", instanceId);
+    request.addChildElement (desc.createXml());
+
+    const ScopedPointer<XmlElement> info (process->sendRequest (request));
+    ProxyInstance* result = nullptr;
+
+    if (info != nullptr && info->hasTagName ("INFO"))
+        result = new ProxyInstance (process, instanceId, desc, *info);
+
+    --(process->numInstances);
+    return result;
+}
+
+//==============================================================================
+String OutOfProcessPluginFormat::getName() const
+{
+    return wrappedFormat.getName();
+}
+
+void OutOfProcessPluginFormat::findAllTypesForFile (OwnedArray <PluginDescription>& results, const String& fileOrIdentifier)
+{
+    wrappedFormat.findAllTypesForFile (results, fileOrIdentifier);
+}
+
+bool OutOfProcessPluginFormat::fileMightContainThisPluginType (const String& fileOrIdentifier)
+{
+    return wrappedFormat.fileMightContainThisPluginType (fileOrIdentifier);
+}
+
+String OutOfProcessPluginFormat::getNameOfPluginFromIdentifier (const String& fileOrIdentifier)
+{
+    return wrappedFormat.getNameOfPluginFromIdentifier (fileOrIdentifier);
+}
+
+bool OutOfProcessPluginFormat::pluginNeedsRescanning (const PluginDescription& desc)
+{
+    return wrappedFormat.pluginNeedsRescanning (desc);
+}
+
+bool OutOfProcessPluginFormat::doesPluginStillExist (const PluginDescription& desc)
+{
+    return wrappedFormat.doesPluginStillExist (desc);
+}
+
+bool OutOfProcessPluginFormat::canScanForPlugins() const
+{
+    return wrappedFormat.canScanForPlugins();
+}
+
+StringArray OutOfProcessPluginFormat::searchPathsForPlugins (const FileSearchPath& directoriesToSearch, const bool recursive)
+{
+    return wrappedFormat.searchPathsForPlugins (directoriesToSearch, recursive);
+}
+
+FileSearchPath OutOfProcessPluginFormat::getDefaultLocationsToSearch()
+{
+    return wrappedFormat.getDefaultLocationsToSearch();
+}
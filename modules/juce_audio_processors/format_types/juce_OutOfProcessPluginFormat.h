@@ -0,0 +1,167 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+
+#ifndef __JUCE_OUTOFPROCESSPLUGINFORMAT_JUCEHEADER__
+#define __JUCE_OUTOFPROCESSPLUGINFORMAT_JUCEHEADER__
+
+#include "../format/juce_AudioPluginFormatManager.h"
+
+
+//==============================================================================
+/**
+    Wraps another AudioPluginFormat so that its plugins run in child processes.
+
+    The instances that this format creates are proxies: when the host calls their
+    processBlock(), the audio, MIDI, parameter changes and play-head position are passed
+    through a SharedMemoryChannel to the child process that has actually loaded the plugin,
+    and the processed block is passed back. Parameters, programs and state are sent over
+    a named pipe. If a plugin crashes, only the child process dies - its proxies then just
+    output silence, and their hasCrashed() flag is set in the Statistics.
+
+    Several plugins can share a child process, to save memory and start-up time, by
+    setting maxPluginsPerProcess - at the cost that if one of them crashes, it takes the
+    others in that process down with it. Each plugin still gets its own audio channel.
+
+    The child processes are launched by running your own app's executable again with a
+    special command-line argument, so your app must check for this when it starts, by
+    calling startHostIfRequested(), with a format manager that contains the real formats:
+
+    @code
+    void initialise (const String& commandLine)
+    {
+        formatManager.addDefaultFormats();
+
+        if (OutOfProcessPluginFormat::startHostIfRequested (commandLine, formatManager))
+            return; // this is a plugin host process, so don't create any windows!
+        ...
+    @endcode
+
+    To run 32-bit plugins from a 64-bit host, build a 32-bit version of your app (or of a
+    small app that just calls startHostIfRequested()), and pass it as the hostExecutable
+    for a second OutOfProcessPluginFormat.
+
+    This format has the same name as the one that it wraps, and scanning is done by the
+    wrapped format, so the PluginDescriptions are interchangeable between them. If you add
+    one of these to an AudioPluginFormatManager, add it instead of the format that it wraps,
+    not as well as it.
+
+    The plugins' editors aren't available - use a GenericAudioProcessorEditor instead.
+
+    @see OutOfProcessPluginScanner, SharedMemoryChannel
+*/
+class JUCE_API  OutOfProcessPluginFormat   : public AudioPluginFormat
+{
+public:
+    //==============================================================================
+    /** Creates a format.
+
+        @param formatToWrap             the format that the child processes should use to load
+                                        plugins. This must stay alive for as long as this object
+        @param maxPluginsPerProcess     the number of plugins that can share a child process
+        @param requestTimeoutMillisecs  if a child takes longer than this to load a plugin or
+                                        respond to any other request, it's assumed to have hung
+        @param hostExecutable           the program to launch - if this is empty, the app's
+                                        own executable will be used
+    */
+    OutOfProcessPluginFormat (AudioPluginFormat& formatToWrap,
+                              int maxPluginsPerProcess = 1,
+                              int requestTimeoutMillisecs = 30000,
+                              const File& hostExecutable = File::nonexistent);
+
+    /** Destructor.
+        Any child processes will keep running until all the instances that use them have
+        been deleted.
+    */
+    ~OutOfProcessPluginFormat();
+
+    //==============================================================================
+    /** Checks whether this process was launched by an OutOfProcessPluginFormat, and if
+        so, starts hosting plugins for it.
+
+        Call this when your app starts up, before creating any windows. If it returns true,
+        the app should do nothing else - it will load plugins using the formats in the
+        manager you pass in, and will quit when the host process disconnects. The
+        AudioPluginFormatManager must stay alive until the app quits.
+    */
+    static bool startHostIfRequested (const String& commandLine,
+                                      AudioPluginFormatManager& formatManager);
+
+    /** Returns the number of child processes that are currently running. */
+    int getNumHostProcesses() const;
+
+    //==============================================================================
+    /** Some measurements of how a plugin instance's processing is going. */
+    struct Statistics
+    {
+        int64 blocksProcessed;          /**< The number of blocks that were processed by the child. */
+        int64 blocksDropped;            /**< The number of blocks that were replaced by silence, because the
+                                             child didn't reply in time or has crashed. */
+        double averageRoundTripMs;      /**< The average time between sending a block and getting it back. */
+        double averageProcessingMs;     /**< The average time that the plugin's processBlock() took. */
+        double averageOverheadMs;       /**< The average round-trip time that wasn't spent in processBlock(),
+                                             i.e. the cost of running the plugin in another process. */
+        double maxOverheadMs;           /**< The worst overhead seen so far. */
+        bool hasCrashed;                /**< True if the child process has died. */
+    };
+
+    /** If this plugin instance was created by an OutOfProcessPluginFormat, this fills in
+        its statistics and returns true.
+    */
+    static bool getStatistics (AudioPluginInstance& instance, Statistics& result);
+
+    //==============================================================================
+    String getName() const;
+    void findAllTypesForFile (OwnedArray <PluginDescription>&, const String& fileOrIdentifier);
+    AudioPluginInstance* createInstanceFromDescription (const PluginDescription&);
+    bool fileMightContainThisPluginType (const String& fileOrIdentifier);
+    String getNameOfPluginFromIdentifier (const String& fileOrIdentifier);
+    bool pluginNeedsRescanning (const PluginDescription&);
+    bool doesPluginStillExist (const PluginDescription&);
+    bool canScanForPlugins() const;
+    StringArray searchPathsForPlugins (const FileSearchPath&, bool recursive);
+    FileSearchPath getDefaultLocationsToSearch();
+
+private:
+    //==============================================================================
+    class HostProcess;
+    class ProxyInstance;
+    class HostedPlugin;
+    class ChildConnection;
+    friend class HostProcess;
+    friend class ProxyInstance;
+    friend class HostedPlugin;
+    friend class ChildConnection;
+
+    AudioPluginFormat& wrappedFormat;
+    const int maxPluginsPerProcess, timeoutMs;
+    const File executable;
+    ReferenceCountedArray<HostProcess> processes;
+    CriticalSection lock;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (OutOfProcessPluginFormat)
+};
+
+
+#endif   // __JUCE_OUTOFPROCESSPLUGINFORMAT_JUCEHEADER__
@@ -33,13 +33,20 @@
     events to the list.
 
     This is used by both the VST hosting code and the plugin wrapper.
+
+    Call prepare() before processing starts, so that the event slots and the space
+    used for copies of sysex data are all allocated up-front. After that, clear() and
+    addEvents() won't touch the heap unless a block turns up with more events or sysex
+    data than the list has room for, in which case it grows to fit rather than losing
+    any events.
 */
 class VSTMidiEventList
 {
 public:
     //==============================================================================
     VSTMidiEventList()
-        : numEventsUsed (0), numEventsAllocated (0)
+        : numEventsUsed (0), numEventsAllocated (0),
+          sysexDataUsed (0), sysexDataAllocated (0)
     {
     }
 
@@ -49,54 +56,67 @@ public:
     }
 
     //==============================================================================
+    /** Preallocates enough space for the given number of events, and the given
+        number of bytes of sysex data to be copied by addEvent().
+    */
+    void prepare (const int maxNumEvents, const int maxSysexBytes)
+    {
+        ensureSize (maxNumEvents);
+        ensureSysexSpace (maxSysexBytes);
+    }
+
     void clear()
     {
         numEventsUsed = 0;
+        sysexDataUsed = 0;
 
         if (events != nullptr)
             events->numEvents = 0;
     }
 
+    /** Adds an event, making a copy of its data. */
     void addEvent (const void* const midiData, const int numBytes, const int frameOffset)
     {
-        ensureSize (numEventsUsed + 1);
-
-        VstMidiEvent* const e = (VstMidiEvent*) (events->events [numEventsUsed]);
-        events->numEvents = ++numEventsUsed;
-
         if (numBytes <= 4)
         {
-            if (e->type == kVstSysExType)
-            {
-                delete[] (((VstMidiSysexEvent*) e)->sysexDump);
-                e->type = kVstMidiType;
-                e->byteSize = sizeof (VstMidiEvent);
-                e->noteLength = 0;
-                e->noteOffset = 0;
-                e->detune = 0;
-                e->noteOffVelocity = 0;
-            }
-
-            e->deltaFrames = frameOffset;
-            memcpy (e->midiData, midiData, (size_t) numBytes);
+            addShortEvent (midiData, numBytes, frameOffset);
         }
         else
         {
-            VstMidiSysexEvent* const se = (VstMidiSysexEvent*) e;
+            ensureSysexSpace (sysexDataUsed + numBytes);
+
+            char* const dest = sysexData + sysexDataUsed;
+            memcpy (dest, midiData, (size_t) numBytes);
+            sysexDataUsed += numBytes;
+
+            addSysexEvent (dest, numBytes, frameOffset);
+        }
+    }
+
+    /** Adds all the events from a MidiBuffer.
 
-            if (se->type == kVstSysExType)
-                delete[] se->sysexDump;
+        Rather than being copied, any sysex events will point directly at the data inside
+        the MidiBuffer, so the buffer mustn't be modified or deleted while the events are
+        in use.
+
+        The events' frame offsets are limited to the range 0 to (numSamples - 1).
+    */
+    void addEvents (const MidiBuffer& source, const int numSamples)
+    {
+        ensureSize (numEventsUsed + source.getNumEvents());
 
-            se->sysexDump = new char [numBytes];
-            memcpy (se->sysexDump, midiData, (size_t) numBytes);
+        MidiBuffer::Iterator i (source);
+        const juce::uint8* midiData;
+        int numBytes, samplePosition;
 
-            se->type = kVstSysExType;
-            se->byteSize = sizeof (VstMidiSysexEvent);
-            se->deltaFrames = frameOffset;
-            se->flags = 0;
-            se->dumpBytes = numBytes;
-            se->resvd1 = 0;
-            se->resvd2 = 0;
+        while (i.getNextEvent (midiData, numBytes, samplePosition))
+        {
+            const int frameOffset = jlimit (0, numSamples - 1, samplePosition);
+
+            if (numBytes <= 4)
+                addShortEvent (midiData, numBytes, frameOffset);
+            else
+                addSysexEvent ((const char*) midiData, numBytes, frameOffset);
         }
     }
 
@@ -152,12 +172,16 @@ public:
         if (events != nullptr)
         {
             for (int i = numEventsAllocated; --i >= 0;)
-                freeVSTEvent (events->events[i]);
+                std::free (events->events[i]);
 
             events.free();
             numEventsUsed = 0;
             numEventsAllocated = 0;
         }
+
+        sysexData.free();
+        sysexDataUsed = 0;
+        sysexDataAllocated = 0;
     }
 
     //==============================================================================
@@ -165,6 +189,73 @@ public:
 
 private:
     int numEventsUsed, numEventsAllocated;
+    HeapBlock <char> sysexData;
+    int sysexDataUsed, sysexDataAllocated;
+
+    VstEvent* getNextEvent()
+    {
+        ensureSize (numEventsUsed + 1);
+
+        VstEvent* const e = events->events [numEventsUsed];
+        events->numEvents = ++numEventsUsed;
+        return e;
+    }
+
+    void addShortEvent (const void* const midiData, const int numBytes, const int frameOffset)
+    {
+        VstMidiEvent* const e = (VstMidiEvent*) getNextEvent();
+
+        if (e->type == kVstSysExType)
+        {
+            zeromem (e, sizeof (VstMidiEvent));
+            e->type = kVstMidiType;
+            e->byteSize = sizeof (VstMidiEvent);
+        }
+
+        e->deltaFrames = frameOffset;
+        zerostruct (e->midiData);
+        memcpy (e->midiData, midiData, (size_t) numBytes);
+    }
+
+    void addSysexEvent (const char* const sysexDump, const int numBytes, const int frameOffset)
+    {
+        VstMidiSysexEvent* const se = (VstMidiSysexEvent*) getNextEvent();
+
+        se->type = kVstSysExType;
+        se->byteSize = sizeof (VstMidiSysexEvent);
+        se->deltaFrames = frameOffset;
+        se->flags = 0;
+        se->dumpBytes = numBytes;
+        se->resvd1 = 0;
+        se->sysexDump = const_cast <char*> (sysexDump);
+        se->resvd2 = 0;
+    }
+
+    void ensureSysexSpace (const int numBytesNeeded)
+    {
+        if (numBytesNeeded > sysexDataAllocated)
+        {
+            const int newSize = (numBytesNeeded + numBytesNeeded / 2 + 256) & ~255;
+            HeapBlock <char> newData ((size_t) newSize);
+
+            if (sysexDataUsed > 0)
+                memcpy (newData, sysexData, (size_t) sysexDataUsed);
+
+            // any sysex events that were already copied into the old block need to be
+            // pointed at their new location
+            for (int i = 0; i < numEventsUsed; ++i)
+            {
+                VstMidiSysexEvent* const se = (VstMidiSysexEvent*) events->events[i];
+
+                if (se->type == kVstSysExType
+                     && se->sysexDump >= sysexData && se->sysexDump < sysexData + sysexDataUsed)
+                    se->sysexDump = newData + (se->sysexDump - sysexData);
+            }
+
+            sysexData.swapWith (newData);
+            sysexDataAllocated = newSize;
+        }
+    }
 
     static VstEvent* allocateVSTEvent()
     {
@@ -175,13 +266,7 @@ private:
         return e;
     }
 
-    static void freeVSTEvent (VstEvent* e)
-    {
-        if (e->type == kVstSysExType)
-            delete[] (((VstMidiSysexEvent*) e)->sysexDump);
-
-        std::free (e);
-    }
+    JUCE_DECLARE_NON_COPYABLE (VSTMidiEventList)
 };
 
 
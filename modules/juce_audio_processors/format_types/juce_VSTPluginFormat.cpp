@@ -927,10 +927,11 @@ public:
                                     || (dispatch (effCanDo, 0, 0, (void*) "receiveVstMidiEvent", 0) > 0);
 
             if (wantsMidiMessages)
-                midiEventsToSend.ensureSize (256);
+                midiEventsToSend.prepare (256, 8192);
             else
                 midiEventsToSend.freeEvents();
 
+            incomingMidi.ensureSize (2048);
             incomingMidi.clear();
 
             dispatch (effSetSampleRate, 0, 0, 0, (float) rate);
@@ -1035,16 +1036,7 @@ public:
             {
                 midiEventsToSend.clear();
                 midiEventsToSend.ensureSize (1);
-
-                MidiBuffer::Iterator iter (midiMessages);
-                const uint8* midiData;
-                int numBytesOfMidiData, samplePosition;
-
-                while (iter.getNextEvent (midiData, numBytesOfMidiData, samplePosition))
-                {
-                    midiEventsToSend.addEvent (midiData, numBytesOfMidiData,
-                                               jlimit (0, numSamples - 1, samplePosition));
-                }
+                midiEventsToSend.addEvents (midiMessages, numSamples);
 
                 effect->dispatcher (effect, effProcessEvents, 0, 0, midiEventsToSend.events, 0);
             }
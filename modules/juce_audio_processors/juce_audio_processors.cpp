@@ -78,12 +78,18 @@ static inline bool arrayContainsPlugin (const OwnedArray<PluginDescription>& lis
 #include "processors/juce_AudioProcessor.cpp"
 #include "processors/juce_AudioProcessorEditor.cpp"
 #include "processors/juce_AudioProcessorGraph.cpp"
+#include "processors/juce_AudioProcessorStateCache.cpp"
+#include "processors/juce_ConvolutionAudioProcessor.cpp"
 #include "processors/juce_GenericAudioProcessorEditor.cpp"
+#include "processors/juce_ParameterChangeQueue.cpp"
 #include "processors/juce_PluginDescription.cpp"
 #include "format_types/juce_LADSPAPluginFormat.cpp"
+#include "format_types/juce_OutOfProcessPluginFormat.cpp"
 #include "format_types/juce_VSTPluginFormat.cpp"
 #include "format_types/juce_AudioUnitPluginFormat.mm"
 #include "scanning/juce_KnownPluginList.cpp"
+#include "scanning/juce_KnownPluginListCache.cpp"
+#include "scanning/juce_OutOfProcessPluginScanner.cpp"
 #include "scanning/juce_PluginDirectoryScanner.cpp"
 #include "scanning/juce_PluginListComponent.cpp"
 // END_AUTOINCLUDE
@@ -83,9 +83,18 @@ namespace juce
 #ifndef __JUCE_AUDIOPROCESSORLISTENER_JUCEHEADER__
  #include "processors/juce_AudioProcessorListener.h"
 #endif
+#ifndef __JUCE_AUDIOPROCESSORSTATECACHE_JUCEHEADER__
+ #include "processors/juce_AudioProcessorStateCache.h"
+#endif
+#ifndef __JUCE_CONVOLUTIONAUDIOPROCESSOR_JUCEHEADER__
+ #include "processors/juce_ConvolutionAudioProcessor.h"
+#endif
 #ifndef __JUCE_GENERICAUDIOPROCESSOREDITOR_JUCEHEADER__
  #include "processors/juce_GenericAudioProcessorEditor.h"
 #endif
+#ifndef __JUCE_PARAMETERCHANGEQUEUE_JUCEHEADER__
+ #include "processors/juce_ParameterChangeQueue.h"
+#endif
 #ifndef __JUCE_PLUGINDESCRIPTION_JUCEHEADER__
  #include "processors/juce_PluginDescription.h"
 #endif
@@ -101,6 +110,9 @@ namespace juce
 #ifndef __JUCE_LADSPAPLUGINFORMAT_JUCEHEADER__
  #include "format_types/juce_LADSPAPluginFormat.h"
 #endif
+#ifndef __JUCE_OUTOFPROCESSPLUGINFORMAT_JUCEHEADER__
+ #include "format_types/juce_OutOfProcessPluginFormat.h"
+#endif
 #include "format_types/juce_VSTMidiEventList.h"
 #ifndef __JUCE_VSTPLUGINFORMAT_JUCEHEADER__
  #include "format_types/juce_VSTPluginFormat.h"
@@ -108,6 +120,12 @@ namespace juce
 #ifndef __JUCE_KNOWNPLUGINLIST_JUCEHEADER__
  #include "scanning/juce_KnownPluginList.h"
 #endif
+#ifndef __JUCE_KNOWNPLUGINLISTCACHE_JUCEHEADER__
+ #include "scanning/juce_KnownPluginListCache.h"
+#endif
+#ifndef __JUCE_OUTOFPROCESSPLUGINSCANNER_JUCEHEADER__
+ #include "scanning/juce_OutOfProcessPluginScanner.h"
+#endif
 #ifndef __JUCE_PLUGINDIRECTORYSCANNER_JUCEHEADER__
  #include "scanning/juce_PluginDirectoryScanner.h"
 #endif
@@ -24,6 +24,83 @@
 
 static ThreadLocalValue<AudioProcessor::WrapperType> wrapperTypeBeingCreated;
 
+//==============================================================================
+/*  Collects the parameter changes that need to be sent to the processor's message thread
+    listeners. A flag is set for each parameter that changes, and the next async update
+    sends one callback for each flagged parameter, with its latest value.
+*/
+class AudioProcessor::ParameterChangeNotifier  : private AsyncUpdater
+{
+public:
+    ParameterChangeNotifier (AudioProcessor& p)
+        : owner (p),
+          numParameters (jmax (0, p.getNumParameters())),
+          numFlagWords ((numParameters + 31) / 32),
+          latestValues ((size_t) numParameters, true),
+          changedFlags ((size_t) numFlagWords, true)
+    {
+    }
+
+    ~ParameterChangeNotifier()
+    {
+        cancelPendingUpdate();
+    }
+
+    void parameterChanged (const int parameterIndex, const float newValue) noexcept
+    {
+        if (isPositiveAndBelow (parameterIndex, numParameters))
+        {
+            latestValues [parameterIndex] = newValue;
+
+            Atomic<uint32>& flags = changedFlags [parameterIndex >> 5];
+            const uint32 bit = ((uint32) 1) << (parameterIndex & 31);
+
+            for (;;)
+            {
+                const uint32 oldFlags = flags.get();
+
+                if ((oldFlags & bit) != 0)
+                    return;  // (this parameter is already waiting to be sent)
+
+                if (flags.compareAndSetBool (oldFlags | bit, oldFlags))
+                    break;
+            }
+
+            triggerAsyncUpdate();
+        }
+    }
+
+private:
+    AudioProcessor& owner;
+    const int numParameters, numFlagWords;
+    HeapBlock<Atomic<float> > latestValues;
+    HeapBlock<Atomic<uint32> > changedFlags;
+
+    void handleAsyncUpdate()
+    {
+        for (int word = 0; word < numFlagWords; ++word)
+        {
+            uint32 flags = changedFlags[word].exchange (0);
+
+            for (int parameterIndex = word * 32; flags != 0; ++parameterIndex, flags >>= 1)
+            {
+                if ((flags & 1) != 0)
+                {
+                    const float value = latestValues [parameterIndex].get();
+
+                    for (int i = owner.messageThreadListeners.size(); --i >= 0;)
+                        if (AudioProcessorListener* l = owner.getMessageThreadListenerLocked (i))
+                            l->audioProcessorParameterChanged (&owner, parameterIndex, value);
+                }
+            }
+        }
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (ParameterChangeNotifier)
+};
+
+//==============================================================================
+
 void JUCE_CALLTYPE AudioProcessor::setTypeOfNextNewPlugin (AudioProcessor::WrapperType type)
 {
     wrapperTypeBeingCreated = type;
@@ -38,7 +115,11 @@ AudioProcessor::AudioProcessor()
       numOutputChannels (0),
       latencySamples (0),
       suspended (false),
-      nonRealtime (false)
+      nonRealtime (false),
+      processingPrecision (singlePrecision),
+      stateVersioningEnabled (false),
+      backgroundSerialisationAllowed (false),
+      conversionBuffer (1, 1)
 {
 }
 
@@ -63,13 +144,25 @@ void AudioProcessor::setPlayHead (AudioPlayHead* const newPlayHead) noexcept
 void AudioProcessor::addListener (AudioProcessorListener* const newListener)
 {
     const ScopedLock sl (listenerLock);
-    listeners.addIfNotAlreadyThere (newListener);
+
+    if (newListener->receivesParameterChangesOnMessageThread())
+    {
+        if (parameterChangeNotifier == nullptr)
+            parameterChangeNotifier = new ParameterChangeNotifier (*this);
+
+        messageThreadListeners.addIfNotAlreadyThere (newListener);
+    }
+    else
+    {
+        listeners.addIfNotAlreadyThere (newListener);
+    }
 }
 
 void AudioProcessor::removeListener (AudioProcessorListener* const listenerToRemove)
 {
     const ScopedLock sl (listenerLock);
     listeners.removeFirstMatchingValue (listenerToRemove);
+    messageThreadListeners.removeFirstMatchingValue (listenerToRemove);
 }
 
 void AudioProcessor::setPlayConfigDetails (const int newNumIns,
@@ -115,6 +208,7 @@ void AudioProcessor::setParameterNotifyingHost (const int parameterIndex,
                                                 const float newValue)
 {
     setParameter (parameterIndex, newValue);
+    markStateAsChanged();
     sendParamChangeMessageToListeners (parameterIndex, newValue);
 }
 
@@ -124,6 +218,12 @@ AudioProcessorListener* AudioProcessor::getListenerLocked (const int index) cons
     return listeners [index];
 }
 
+AudioProcessorListener* AudioProcessor::getMessageThreadListenerLocked (const int index) const noexcept
+{
+    const ScopedLock sl (listenerLock);
+    return messageThreadListeners [index];
+}
+
 void AudioProcessor::sendParamChangeMessageToListeners (const int parameterIndex, const float newValue)
 {
     jassert (isPositiveAndBelow (parameterIndex, getNumParameters()));
@@ -131,6 +231,10 @@ void AudioProcessor::sendParamChangeMessageToListeners (const int parameterIndex
     for (int i = listeners.size(); --i >= 0;)
         if (AudioProcessorListener* l = getListenerLocked (i))
             l->audioProcessorParameterChanged (this, parameterIndex, newValue);
+
+    // (this just sets a flag, so it's safe to call from the audio thread)
+    if (parameterChangeNotifier != nullptr && messageThreadListeners.size() > 0)
+        parameterChangeNotifier->parameterChanged (parameterIndex, newValue);
 }
 
 void AudioProcessor::beginParameterChangeGesture (int parameterIndex)
@@ -185,6 +289,38 @@ void AudioProcessor::suspendProcessing (const bool shouldBeSuspended)
 
 void AudioProcessor::reset() {}
 void AudioProcessor::processBlockBypassed (AudioSampleBuffer&, MidiBuffer&) {}
+void AudioProcessor::processBlockBypassed (DoubleAudioSampleBuffer&, MidiBuffer&) {}
+
+void AudioProcessor::processBlock (DoubleAudioSampleBuffer& buffer, MidiBuffer& midiMessages)
+{
+    const int numChannels = buffer.getNumChannels();
+    const int numSamples = buffer.getNumSamples();
+
+    // (this only has to re-allocate if the block is bigger than any that came before)
+    conversionBuffer.setSize (numChannels, numSamples, false, false, true);
+
+    for (int i = 0; i < numChannels; ++i)
+        buffer.copyTo (conversionBuffer, i, 0, i, 0, numSamples);
+
+    processBlock (conversionBuffer, midiMessages);
+
+    for (int i = 0; i < numChannels; ++i)
+        buffer.copyFrom (i, 0, conversionBuffer, i, 0, numSamples);
+}
+
+bool AudioProcessor::supportsDoublePrecisionProcessing() const
+{
+    return false;
+}
+
+void AudioProcessor::setProcessingPrecision (const ProcessingPrecision newPrecision) noexcept
+{
+    // If you hit this, you're trying to use double precision on a processor
+    // that doesn't have a double-precision processBlock() method!
+    jassert (newPrecision == singlePrecision || supportsDoublePrecisionProcessing());
+
+    processingPrecision = newPrecision;
+}
 
 //==============================================================================
 void AudioProcessor::editorBeingDeleted (AudioProcessorEditor* const editor) noexcept
@@ -200,7 +336,13 @@ AudioProcessorEditor* AudioProcessor::createEditorIfNeeded()
     if (activeEditor != nullptr)
         return activeEditor;
 
-    AudioProcessorEditor* const ed = createEditor();
+    const int64 startTicks = Time::getHighResolutionTicks();
+    AudioProcessorEditor* ed;
+
+    {
+        JUCE_TRACE_SCOPE ("AudioProcessor::createEditor");
+        ed = createEditor();
+    }
 
     // You must make your hasEditor() method return a consistent result!
     jassert (hasEditor() == (ed != nullptr));
@@ -210,6 +352,8 @@ AudioProcessorEditor* AudioProcessor::createEditorIfNeeded()
         // you must give your editor comp a size before returning it..
         jassert (ed->getWidth() > 0 && ed->getHeight() > 0);
 
+        ComponentProfiler::componentCreated (*ed, startTicks);
+
         const ScopedLock sl (callbackLock);
         activeEditor = ed;
     }
@@ -228,6 +372,14 @@ void AudioProcessor::setCurrentProgramStateInformation (const void* data, int si
     setStateInformation (data, sizeInBytes);
 }
 
+void AudioProcessor::setStateVersioningEnabled (const bool shouldBeEnabled,
+                                                const bool allowBackgroundSerialisation) noexcept
+{
+    stateVersioningEnabled = shouldBeEnabled;
+    backgroundSerialisationAllowed = allowBackgroundSerialisation;
+    markStateAsChanged();
+}
+
 //==============================================================================
 // magic number to identify memory blocks that we've stored as XML
 const uint32 magicXmlNumber = 0x21324356;
@@ -28,6 +28,7 @@
 #include "juce_AudioProcessorEditor.h"
 #include "juce_AudioProcessorListener.h"
 #include "juce_AudioPlayHead.h"
+#include "juce_ParameterChangeQueue.h"
 
 
 //==============================================================================
@@ -144,6 +145,56 @@ public:
     virtual void processBlockBypassed (AudioSampleBuffer& buffer,
                                        MidiBuffer& midiMessages);
 
+    /** Renders the next block in double precision.
+
+        The host will call this instead of the single-precision processBlock() when the
+        processor has been put into double-precision mode with setProcessingPrecision().
+        The rules for the buffer's contents are the same as for the single-precision version.
+
+        If you override this, you must also override supportsDoublePrecisionProcessing()
+        to return true. The default implementation converts the data to floats, calls the
+        single-precision processBlock(), and converts the results back again.
+    */
+    virtual void processBlock (DoubleAudioSampleBuffer& buffer,
+                               MidiBuffer& midiMessages);
+
+    /** Renders the next block in double precision when the processor is being bypassed.
+        The default implementation of this method will pass-through any incoming audio.
+        @see processBlockBypassed
+    */
+    virtual void processBlockBypassed (DoubleAudioSampleBuffer& buffer,
+                                       MidiBuffer& midiMessages);
+
+    //==============================================================================
+    /** The precisions in which a processor can be asked to render its audio.
+        @see setProcessingPrecision
+    */
+    enum ProcessingPrecision
+    {
+        singlePrecision,
+        doublePrecision
+    };
+
+    /** Returns true if the processor has its own double-precision processBlock() method.
+
+        If this returns false, hosts should only call the single-precision processBlock().
+        The default implementation returns false.
+    */
+    virtual bool supportsDoublePrecisionProcessing() const;
+
+    /** Changes the precision in which the host will call processBlock().
+
+        Hosts should call this before prepareToPlay(), and can only choose double
+        precision if supportsDoublePrecisionProcessing() returns true.
+    */
+    void setProcessingPrecision (ProcessingPrecision newPrecision) noexcept;
+
+    /** Returns the precision that the host has chosen with setProcessingPrecision(). */
+    ProcessingPrecision getProcessingPrecision() const noexcept { return processingPrecision; }
+
+    /** Returns true if the host will be calling the double-precision processBlock(). */
+    bool isUsingDoublePrecision() const noexcept                { return processingPrecision == doublePrecision; }
+
     //==============================================================================
     /** Returns the current AudioPlayHead object that should be used to find
         out the state and position of the playhead.
@@ -249,10 +300,20 @@ public:
     */
     void setLatencySamples (int newLatency);
 
-    /** Returns true if a silent input always produces a silent output. */
+    /** Returns true if a silent input always produces a silent output.
+
+        If this returns true, an AudioProcessorGraph will stop calling the processor once
+        its audio and midi inputs have been silent for longer than getTailLengthSeconds()
+        (plus its latency), and will just give it silent outputs until something arrives
+        at its inputs again.
+    */
     virtual bool silenceInProducesSilenceOut() const = 0;
 
-    /** Returns the length of the filter's tail, in seconds. */
+    /** Returns the length of the filter's tail, in seconds.
+        This is how long its output can carry on after its input goes silent. If the tail
+        can be endless, return std::numeric_limits<double>::infinity().
+        @see silenceInProducesSilenceOut
+    */
     virtual double getTailLengthSeconds() const = 0;
 
     /** Returns true if the processor wants midi messages. */
@@ -435,6 +496,18 @@ public:
     */
     void setParameterNotifyingHost (int parameterIndex, float newValue);
 
+    /** Returns a queue of timestamped parameter changes, which this processor's
+        processBlock() method can read.
+
+        Hosts and editors can add changes to the queue from any thread without blocking,
+        and the processor then applies each one at the right sample position as it renders.
+        Unlike with setParameter(), nothing happens to a queued change until processBlock()
+        reads it, so this should only be used with processors that are known to read it.
+
+        @see ParameterChangeQueue
+    */
+    ParameterChangeQueue& getParameterChangeQueue() noexcept        { return parameterChangeQueue; }
+
     /** Returns true if the host can automate this parameter.
 
         By default, this returns true for all parameters.
@@ -549,11 +622,55 @@ public:
     */
     virtual void setCurrentProgramStateInformation (const void* data, int sizeInBytes);
 
+    //==============================================================================
+    /** Lets the plugin wrappers cache the data returned by getStateInformation().
+
+        Some hosts ask for a plugin's state very often (e.g. for autosaving or undo), which
+        can be expensive if the state is large. If you enable state versioning, you're
+        promising to call markStateAsChanged() whenever anything that your
+        getStateInformation() or getCurrentProgramStateInformation() methods write has
+        changed - including when the host calls setParameter() or setCurrentProgram().
+        In return, the wrappers will hand the host a cached copy of the state for as long
+        as the version returned by getStateVersion() stays the same.
+
+        If allowBackgroundSerialisation is true, the wrappers may also call your
+        getStateInformation() methods on a background thread, to refresh the cached copy
+        after the state changes, so those methods must be thread-safe.
+
+        @see markStateAsChanged, AudioProcessorStateCache
+    */
+    void setStateVersioningEnabled (bool shouldBeEnabled,
+                                    bool allowBackgroundSerialisation = false) noexcept;
+
+    /** Returns true if setStateVersioningEnabled() has been used to turn on state versioning. */
+    bool isStateVersioningEnabled() const noexcept                  { return stateVersioningEnabled; }
+
+    /** Returns true if the processor's state may be serialised on a background thread.
+        @see setStateVersioningEnabled
+    */
+    bool canSerialiseStateInBackground() const noexcept             { return stateVersioningEnabled && backgroundSerialisationAllowed; }
+
+    /** Tells the plugin wrappers that the processor's state has changed, so any cached copy
+        of it needs to be refreshed. This can be called from any thread.
+
+        setParameterNotifyingHost() calls this for you.
+
+        @see setStateVersioningEnabled
+    */
+    void markStateAsChanged() noexcept                              { ++stateVersion; }
+
+    /** Returns a number that changes every time markStateAsChanged() is called. */
+    int getStateVersion() const noexcept                            { return stateVersion.get(); }
+
     /** This method is called when the number of input or output channels is changed. */
     virtual void numChannelsChanged();
 
     //==============================================================================
-    /** Adds a listener that will be called when an aspect of this processor changes. */
+    /** Adds a listener that will be called when an aspect of this processor changes.
+
+        If the listener's receivesParameterChangesOnMessageThread() method returns true,
+        its parameter change callbacks will be made asynchronously on the message thread.
+    */
     virtual void addListener (AudioProcessorListener* newListener);
 
     /** Removes a previously added listener. */
@@ -622,12 +739,21 @@ protected:
     void sendParamChangeMessageToListeners (int parameterIndex, float newValue);
 
 private:
-    Array <AudioProcessorListener*> listeners;
+    class ParameterChangeNotifier;
+    friend class ParameterChangeNotifier;
+
+    Array <AudioProcessorListener*> listeners, messageThreadListeners;
+    ScopedPointer<ParameterChangeNotifier> parameterChangeNotifier;
+    ParameterChangeQueue parameterChangeQueue;
     Component::SafePointer<AudioProcessorEditor> activeEditor;
     double sampleRate;
     int blockSize, numInputChannels, numOutputChannels, latencySamples;
     bool suspended, nonRealtime;
+    ProcessingPrecision processingPrecision;
+    Atomic<int> stateVersion;
+    bool stateVersioningEnabled, backgroundSerialisationAllowed;
     CriticalSection callbackLock, listenerLock;
+    AudioSampleBuffer conversionBuffer;
     String inputSpeakerArrangement, outputSpeakerArrangement;
 
    #if JUCE_DEBUG
@@ -635,6 +761,7 @@ private:
    #endif
 
     AudioProcessorListener* getListenerLocked (int) const noexcept;
+    AudioProcessorListener* getMessageThreadListenerLocked (int) const noexcept;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioProcessor)
 };
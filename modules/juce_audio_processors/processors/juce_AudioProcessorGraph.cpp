@@ -28,6 +28,76 @@ const int AudioProcessorGraph::midiChannelIndex = 0x1000;
 namespace GraphRenderingOps
 {
 
+//==============================================================================
+/** Describes which of the shared buffers a rendering op touches, so that the
+    parallel renderer can work out which ops are independent of each other.
+*/
+struct BufferUsage
+{
+    enum
+    {
+        midiBufferBase      = 0x10000000,
+        delayTimesResource  = 0x7ffffffe,  // stands for the delay times that the DelayLinePool updates
+        graphOutputResource = 0x7fffffff   // stands for the graph's own audio and midi output buffers
+    };
+
+    void readsAudio (const int channel)         { if (channel != 0) reads.addIfNotAlreadyThere (channel); }
+    void writesAudio (const int channel)        { jassert (channel != 0); writes.addIfNotAlreadyThere (channel); }
+    void readsMidi (const int bufferNum)        { reads.addIfNotAlreadyThere (midiBufferBase + bufferNum); }
+    void writesMidi (const int bufferNum)       { writes.addIfNotAlreadyThere (midiBufferBase + bufferNum); }
+    void writesGraphOutput()                    { writes.addIfNotAlreadyThere ((int) graphOutputResource); }
+    void readsDelayTimes()                      { reads.addIfNotAlreadyThere ((int) delayTimesResource); }
+    void writesDelayTimes()                     { writes.addIfNotAlreadyThere ((int) delayTimesResource); }
+
+    Array<int> reads, writes;
+};
+
+//==============================================================================
+/** Keeps a flag for each of the shared channels, saying whether it's known to contain
+    nothing but zeros.
+
+    The ops keep these up to date as they go, so that they can avoid mixing in silent
+    channels, and so that nodes whose inputs are silent can be put to sleep. Each flag
+    is only touched by the ops that use its channel, so the parallel renderer's ordering
+    keeps them consistent without any locking.
+*/
+class ChannelSilence
+{
+public:
+    ChannelSilence() {}
+
+    void setNumChannels (const int numChannels)
+    {
+        flags.clear();
+        flags.insertMultiple (0, 0, numChannels);
+
+        if (numChannels > 0)
+            flags.set (0, 1); // the first channel is the read-only empty one
+    }
+
+    bool isSilent (const int channel) const noexcept                { return flags.getUnchecked (channel) != 0; }
+    void setSilent (const int channel, const bool silent) noexcept  { flags.getReference (channel) = silent ? 1 : 0; }
+
+    static bool isSilent (const float* data, const int numSamples) noexcept
+    {
+        return FloatVectorOperations::isSilent (data, numSamples);
+    }
+
+    static bool isSilent (const double* data, const int numSamples) noexcept
+    {
+        for (int i = 0; i < numSamples; ++i)
+            if (data[i] != 0)
+                return false;
+
+        return true;
+    }
+
+private:
+    Array<uint8> flags;
+
+    JUCE_DECLARE_NON_COPYABLE (ChannelSilence)
+};
+
 //==============================================================================
 class AudioGraphRenderingOp
 {
@@ -39,81 +109,145 @@ public:
                           const OwnedArray <MidiBuffer>& sharedMidiBuffers,
                           const int numSamples) = 0;
 
+    virtual void perform (DoubleAudioSampleBuffer& sharedBufferChans,
+                          const OwnedArray <MidiBuffer>& sharedMidiBuffers,
+                          const int numSamples) = 0;
+
+    virtual void getBufferUsage (BufferUsage&) const = 0;
+
     JUCE_LEAK_DETECTOR (AudioGraphRenderingOp)
 };
 
 //==============================================================================
-class ClearChannelOp : public AudioGraphRenderingOp
+/** The ops derive from this, so that each one only needs to provide a performOn()
+    method that works with either type of buffer.
+*/
+template <class OpType>
+class AudioGraphRenderingOpBase  : public AudioGraphRenderingOp
 {
 public:
-    ClearChannelOp (const int channelNum_)
-        : channelNum (channelNum_)
+    void perform (AudioSampleBuffer& sharedBufferChans, const OwnedArray <MidiBuffer>& sharedMidiBuffers, const int numSamples)
+    {
+        static_cast <OpType*> (this)->performOn (sharedBufferChans, sharedMidiBuffers, numSamples);
+    }
+
+    void perform (DoubleAudioSampleBuffer& sharedBufferChans, const OwnedArray <MidiBuffer>& sharedMidiBuffers, const int numSamples)
+    {
+        static_cast <OpType*> (this)->performOn (sharedBufferChans, sharedMidiBuffers, numSamples);
+    }
+};
+
+//==============================================================================
+class ClearChannelOp : public AudioGraphRenderingOpBase <ClearChannelOp>
+{
+public:
+    ClearChannelOp (const int channelNum_, ChannelSilence& silence_)
+        : channelNum (channelNum_), silence (silence_)
     {}
 
-    void perform (AudioSampleBuffer& sharedBufferChans, const OwnedArray <MidiBuffer>&, const int numSamples)
+    template <class BufferType>
+    void performOn (BufferType& sharedBufferChans, const OwnedArray <MidiBuffer>&, const int numSamples)
     {
-        sharedBufferChans.clear (channelNum, 0, numSamples);
+        if (! silence.isSilent (channelNum))
+        {
+            sharedBufferChans.clear (channelNum, 0, numSamples);
+            silence.setSilent (channelNum, true);
+        }
     }
 
+    void getBufferUsage (BufferUsage& usage) const      { usage.writesAudio (channelNum); }
+
 private:
     const int channelNum;
+    ChannelSilence& silence;
 
     JUCE_DECLARE_NON_COPYABLE (ClearChannelOp)
 };
 
 //==============================================================================
-class CopyChannelOp : public AudioGraphRenderingOp
+class CopyChannelOp : public AudioGraphRenderingOpBase <CopyChannelOp>
 {
 public:
-    CopyChannelOp (const int srcChannelNum_, const int dstChannelNum_)
+    CopyChannelOp (const int srcChannelNum_, const int dstChannelNum_, ChannelSilence& silence_)
         : srcChannelNum (srcChannelNum_),
-          dstChannelNum (dstChannelNum_)
+          dstChannelNum (dstChannelNum_),
+          silence (silence_)
     {}
 
-    void perform (AudioSampleBuffer& sharedBufferChans, const OwnedArray <MidiBuffer>&, const int numSamples)
+    template <class BufferType>
+    void performOn (BufferType& sharedBufferChans, const OwnedArray <MidiBuffer>&, const int numSamples)
     {
-        sharedBufferChans.copyFrom (dstChannelNum, 0, sharedBufferChans, srcChannelNum, 0, numSamples);
+        if (silence.isSilent (srcChannelNum))
+        {
+            if (! silence.isSilent (dstChannelNum))
+                sharedBufferChans.clear (dstChannelNum, 0, numSamples);
+        }
+        else
+        {
+            sharedBufferChans.copyFrom (dstChannelNum, 0, sharedBufferChans, srcChannelNum, 0, numSamples);
+        }
+
+        silence.setSilent (dstChannelNum, silence.isSilent (srcChannelNum));
     }
 
+    void getBufferUsage (BufferUsage& usage) const      { usage.readsAudio (srcChannelNum); usage.writesAudio (dstChannelNum); }
+
 private:
     const int srcChannelNum, dstChannelNum;
+    ChannelSilence& silence;
 
     JUCE_DECLARE_NON_COPYABLE (CopyChannelOp)
 };
 
 //==============================================================================
-class AddChannelOp : public AudioGraphRenderingOp
+class AddChannelOp : public AudioGraphRenderingOpBase <AddChannelOp>
 {
 public:
-    AddChannelOp (const int srcChannelNum_, const int dstChannelNum_)
+    AddChannelOp (const int srcChannelNum_, const int dstChannelNum_, ChannelSilence& silence_)
         : srcChannelNum (srcChannelNum_),
-          dstChannelNum (dstChannelNum_)
+          dstChannelNum (dstChannelNum_),
+          silence (silence_)
     {}
 
-    void perform (AudioSampleBuffer& sharedBufferChans, const OwnedArray <MidiBuffer>&, const int numSamples)
+    template <class BufferType>
+    void performOn (BufferType& sharedBufferChans, const OwnedArray <MidiBuffer>&, const int numSamples)
     {
-        sharedBufferChans.addFrom (dstChannelNum, 0, sharedBufferChans, srcChannelNum, 0, numSamples);
+        if (silence.isSilent (srcChannelNum))
+            return;
+
+        if (silence.isSilent (dstChannelNum))
+            sharedBufferChans.copyFrom (dstChannelNum, 0, sharedBufferChans, srcChannelNum, 0, numSamples);
+        else
+            sharedBufferChans.addFrom (dstChannelNum, 0, sharedBufferChans, srcChannelNum, 0, numSamples);
+
+        silence.setSilent (dstChannelNum, false);
     }
 
+    void getBufferUsage (BufferUsage& usage) const      { usage.readsAudio (srcChannelNum); usage.readsAudio (dstChannelNum); usage.writesAudio (dstChannelNum); }
+
 private:
     const int srcChannelNum, dstChannelNum;
+    ChannelSilence& silence;
 
     JUCE_DECLARE_NON_COPYABLE (AddChannelOp)
 };
 
 //==============================================================================
-class ClearMidiBufferOp : public AudioGraphRenderingOp
+class ClearMidiBufferOp : public AudioGraphRenderingOpBase <ClearMidiBufferOp>
 {
 public:
     ClearMidiBufferOp (const int bufferNum_)
         : bufferNum (bufferNum_)
     {}
 
-    void perform (AudioSampleBuffer&, const OwnedArray <MidiBuffer>& sharedMidiBuffers, const int)
+    template <class BufferType>
+    void performOn (BufferType&, const OwnedArray <MidiBuffer>& sharedMidiBuffers, const int)
     {
         sharedMidiBuffers.getUnchecked (bufferNum)->clear();
     }
 
+    void getBufferUsage (BufferUsage& usage) const      { usage.writesMidi (bufferNum); }
+
 private:
     const int bufferNum;
 
@@ -121,7 +255,7 @@ private:
 };
 
 //==============================================================================
-class CopyMidiBufferOp : public AudioGraphRenderingOp
+class CopyMidiBufferOp : public AudioGraphRenderingOpBase <CopyMidiBufferOp>
 {
 public:
     CopyMidiBufferOp (const int srcBufferNum_, const int dstBufferNum_)
@@ -129,11 +263,14 @@ public:
           dstBufferNum (dstBufferNum_)
     {}
 
-    void perform (AudioSampleBuffer&, const OwnedArray <MidiBuffer>& sharedMidiBuffers, const int)
+    template <class BufferType>
+    void performOn (BufferType&, const OwnedArray <MidiBuffer>& sharedMidiBuffers, const int)
     {
         *sharedMidiBuffers.getUnchecked (dstBufferNum) = *sharedMidiBuffers.getUnchecked (srcBufferNum);
     }
 
+    void getBufferUsage (BufferUsage& usage) const      { usage.readsMidi (srcBufferNum); usage.writesMidi (dstBufferNum); }
+
 private:
     const int srcBufferNum, dstBufferNum;
 
@@ -141,89 +278,562 @@ private:
 };
 
 //==============================================================================
-class AddMidiBufferOp : public AudioGraphRenderingOp
+class AddMidiBufferOp : public AudioGraphRenderingOpBase <AddMidiBufferOp>
 {
 public:
-    AddMidiBufferOp (const int srcBufferNum_, const int dstBufferNum_)
-        : srcBufferNum (srcBufferNum_),
-          dstBufferNum (dstBufferNum_)
+    AddMidiBufferOp (const Array<int>& srcBufferNums_, const int dstBufferNum_)
+        : srcBufferNums (srcBufferNums_),
+          dstBufferNum (dstBufferNum_),
+          srcBuffers ((size_t) srcBufferNums_.size())
     {}
 
-    void perform (AudioSampleBuffer&, const OwnedArray <MidiBuffer>& sharedMidiBuffers, const int numSamples)
+    template <class BufferType>
+    void performOn (BufferType&, const OwnedArray <MidiBuffer>& sharedMidiBuffers, const int numSamples)
     {
-        sharedMidiBuffers.getUnchecked (dstBufferNum)
-            ->addEvents (*sharedMidiBuffers.getUnchecked (srcBufferNum), 0, numSamples, 0);
+        MidiBuffer& dest = *sharedMidiBuffers.getUnchecked (dstBufferNum);
+
+        if (srcBufferNums.size() == 1)
+        {
+            dest.addEvents (*sharedMidiBuffers.getUnchecked (srcBufferNums.getUnchecked (0)), 0, numSamples, 0);
+        }
+        else
+        {
+            // merge all the sources in a single pass rather than adding them one by one..
+            for (int i = 0; i < srcBufferNums.size(); ++i)
+                srcBuffers[i] = sharedMidiBuffers.getUnchecked (srcBufferNums.getUnchecked (i));
+
+            dest.addEvents (srcBuffers, srcBufferNums.size(), 0, numSamples);
+        }
+    }
+
+    void getBufferUsage (BufferUsage& usage) const
+    {
+        for (int i = 0; i < srcBufferNums.size(); ++i)
+            usage.readsMidi (srcBufferNums.getUnchecked (i));
+
+        usage.readsMidi (dstBufferNum);
+        usage.writesMidi (dstBufferNum);
     }
 
 private:
-    const int srcBufferNum, dstBufferNum;
+    const Array<int> srcBufferNums;
+    const int dstBufferNum;
+    HeapBlock<const MidiBuffer*> srcBuffers;
 
     JUCE_DECLARE_NON_COPYABLE (AddMidiBufferOp)
 };
 
 //==============================================================================
-class DelayChannelOp : public AudioGraphRenderingOp
+/** Delays one of the shared channels, to compensate for the latency of the nodes that
+    feed it.
+
+    The delay line's memory belongs to the DelayLinePool, which can also change the
+    delay time while the graph is running - when that happens, the op crossfades from
+    the old delay time to the new one.
+*/
+class DelayChannelOp : public AudioGraphRenderingOpBase <DelayChannelOp>
 {
 public:
-    DelayChannelOp (const int channel_, const int numSamplesDelay_)
-        : channel (channel_),
-          bufferSize (numSamplesDelay_ + 1),
-          readIndex (0), writeIndex (numSamplesDelay_)
+    DelayChannelOp (const int channel_, const int numSamplesDelay_,
+                    const int sourceNodeIndex_, const int destNodeIndex_,
+                    ChannelSilence& silence_)
+        : sourceNodeIndex (sourceNodeIndex_),
+          destNodeIndex (destNodeIndex_),
+          channel (channel_),
+          delaySamples (numSamplesDelay_), fadeTarget (numSamplesDelay_), targetDelay (numSamplesDelay_),
+          capacity (0), maxDelay (0), writeIndex (0), fadePosition (0), numSilentSamples (0),
+          floatLine (nullptr), doubleLine (nullptr),
+          silence (silence_)
     {
-        buffer.calloc ((size_t) bufferSize);
     }
 
-    void perform (AudioSampleBuffer& sharedBufferChans, const OwnedArray <MidiBuffer>&, const int numSamples)
+    template <class BufferType>
+    void performOn (BufferType& sharedBufferChans, const OwnedArray <MidiBuffer>&, const int numSamples)
     {
-        float* data = sharedBufferChans.getSampleData (channel, 0);
-
-        for (int i = numSamples; --i >= 0;)
+        if (silence.isSilent (channel))
         {
-            buffer [writeIndex] = *data;
-            *data++ = buffer [readIndex];
+            // Once the whole line is full of silence, running it would just copy zeros
+            // around, and it'll still be full of them when some input arrives..
+            if (numSilentSamples >= capacity)
+                return;
 
-            if (++readIndex  >= bufferSize) readIndex = 0;
-            if (++writeIndex >= bufferSize) writeIndex = 0;
+            numSilentSamples += numSamples;
         }
+        else
+        {
+            numSilentSamples = 0;
+        }
+
+        delay (sharedBufferChans.getSampleData (channel, 0), numSamples);
+
+        silence.setSilent (channel, numSilentSamples >= jmax (delaySamples, fadeTarget) + numSamples);
     }
 
+    void getBufferUsage (BufferUsage& usage) const
+    {
+        usage.readsAudio (channel);
+        usage.writesAudio (channel);
+        usage.readsDelayTimes();
+    }
+
+    //==============================================================================
+    /** Returns the size of line that's needed. This leaves some room for the delay to
+        grow later on, and is always a power of two.
+    */
+    int getRequiredCapacity (const int blockSize) const noexcept
+    {
+        return nextPowerOfTwo (2 * delaySamples + jmax (1, blockSize));
+    }
+
+    void setStorage (float* const floatLine_, double* const doubleLine_,
+                     const int capacity_, const int blockSize) noexcept
+    {
+        floatLine = floatLine_;
+        doubleLine = doubleLine_;
+        capacity = capacity_;
+        maxDelay = capacity - jmax (1, blockSize);
+        jassert (delaySamples <= maxDelay);
+    }
+
+    /** Changes the delay time. If the new time won't fit in the line, this uses the
+        longest time that does, and returns false.
+    */
+    bool setTargetDelay (const int newDelay) noexcept
+    {
+        targetDelay = jmin (newDelay, maxDelay);
+        return newDelay <= maxDelay;
+    }
+
+    const int sourceNodeIndex, destNodeIndex;
+
 private:
-    HeapBlock<float> buffer;
-    const int channel, bufferSize;
-    int readIndex, writeIndex;
+    enum { crossfadeLength = 256 };
+
+    const int channel;
+    int delaySamples, fadeTarget, targetDelay;
+    int capacity, maxDelay, writeIndex, fadePosition, numSilentSamples;
+    float* floatLine;
+    double* doubleLine;
+    ChannelSilence& silence;
+
+    void getLine (float*& line) const noexcept      { line = floatLine; }
+    void getLine (double*& line) const noexcept     { line = doubleLine; }
+
+    template <typename SampleType>
+    void delay (SampleType* data, int numSamples) noexcept
+    {
+        SampleType* line;
+        getLine (line);
+
+        if (line == nullptr)
+        {
+            jassertfalse; // the sequence was built for the other precision!
+            return;
+        }
+
+        while (numSamples > 0)
+        {
+            if (fadeTarget == delaySamples && targetDelay != delaySamples)
+                fadeTarget = targetDelay;
+
+            const int num = fadeTarget != delaySamples ? crossfade (line, data, numSamples)
+                                                       : delayBlock (line, data, jmin (numSamples, capacity - delaySamples));
+            data += num;
+            numSamples -= num;
+        }
+    }
+
+    /*  Delays a run of samples by swapping contiguous sections of memory. This only works
+        if the samples being written don't overwrite any that still need to be read, so
+        numSamples mustn't be more than (capacity - delaySamples).
+    */
+    template <typename SampleType>
+    int delayBlock (SampleType* const line, SampleType* const data, const int numSamples) noexcept
+    {
+        const int mask = capacity - 1;
+        const int readIndex = (writeIndex - delaySamples) & mask;
+
+        copyIntoLine (line, writeIndex, data, numSamples);
+        copyFromLine (line, readIndex, data, numSamples);
+
+        writeIndex = (writeIndex + numSamples) & mask;
+        return numSamples;
+    }
+
+    template <typename SampleType>
+    void copyIntoLine (SampleType* const line, const int index, const SampleType* const src, const int num) const noexcept
+    {
+        const int numBeforeWrap = jmin (num, capacity - index);
+        memcpy (line + index, src, sizeof (SampleType) * (size_t) numBeforeWrap);
+        memcpy (line, src + numBeforeWrap, sizeof (SampleType) * (size_t) (num - numBeforeWrap));
+    }
+
+    template <typename SampleType>
+    void copyFromLine (const SampleType* const line, const int index, SampleType* const dest, const int num) const noexcept
+    {
+        const int numBeforeWrap = jmin (num, capacity - index);
+        memcpy (dest, line + index, sizeof (SampleType) * (size_t) numBeforeWrap);
+        memcpy (dest + numBeforeWrap, line, sizeof (SampleType) * (size_t) (num - numBeforeWrap));
+    }
+
+    template <typename SampleType>
+    int crossfade (SampleType* const line, SampleType* const data, const int numSamples) noexcept
+    {
+        const int mask = capacity - 1;
+        const int num = jmin (numSamples, (int) crossfadeLength - fadePosition);
+        const SampleType step = (SampleType) (1.0 / crossfadeLength);
+        SampleType gain = step * (SampleType) fadePosition;
+
+        for (int i = 0; i < num; ++i)
+        {
+            line [writeIndex] = data[i];
+
+            const SampleType oldSample = line [(writeIndex - delaySamples) & mask];
+            const SampleType newSample = line [(writeIndex - fadeTarget) & mask];
+
+            data[i] = oldSample + (newSample - oldSample) * gain;
+            gain += step;
+            writeIndex = (writeIndex + 1) & mask;
+        }
+
+        fadePosition += num;
+
+        if (fadePosition >= crossfadeLength)
+        {
+            fadePosition = 0;
+            delaySamples = fadeTarget;
+        }
+
+        return num;
+    }
 
     JUCE_DECLARE_NON_COPYABLE (DelayChannelOp)
 };
 
+//==============================================================================
+/** Owns a single block of memory that's shared by all the DelayChannelOps in a
+    rendering sequence, and keeps their delay times in step with the nodes' latencies.
+
+    This is always the first op in the sequence. At the start of each block, it checks
+    whether any of the nodes have changed their latency, and if so, it works out the
+    new delays that are needed and passes them on to the DelayChannelOps, which will
+    crossfade to their new delay time. The graph only needs rebuilding if a delay gets
+    too long for its line, or if an input that used to need no compensation now needs
+    some - needsRebuilding() will then return true.
+*/
+class DelayLinePool : public AudioGraphRenderingOpBase <DelayLinePool>
+{
+public:
+    DelayLinePool (AudioProcessorGraph& graph, const Array<void*>& orderedNodes,
+                   const bool usingDoublePrecision_, const int blockSize_)
+        : usingDoublePrecision (usingDoublePrecision_),
+          blockSize (blockSize_),
+          outputNodeIndex (-1),
+          totalLatency (0),
+          rebuildNeeded (false)
+    {
+        for (int i = 0; i < orderedNodes.size(); ++i)
+        {
+            AudioProcessorGraph::Node* const node = (AudioProcessorGraph::Node*) orderedNodes.getUnchecked (i);
+
+            nodes.add (node);
+            nodeIndexes.set ((int) node->nodeId, i);
+            latencies.add (node->getProcessor()->getLatencySamples());
+
+            if (node->getProcessor()->getNumOutputChannels() == 0)
+                outputNodeIndex = i;
+        }
+
+        nodeDelays.insertMultiple (0, 0, nodes.size());
+        inputLatencies.insertMultiple (0, 0, nodes.size());
+        firstSourceIndexes.insertMultiple (0, 0, nodes.size() + 1);
+
+        // make a list of the sources of each node, grouped by destination..
+        Array<int> connectionSources, connectionDests;
+
+        for (int i = graph.getNumConnections(); --i >= 0;)
+        {
+            const AudioProcessorGraph::Connection* const c = graph.getConnection (i);
+
+            if (nodeIndexes.contains ((int) c->sourceNodeId) && nodeIndexes.contains ((int) c->destNodeId))
+            {
+                const int src = nodeIndexes [(int) c->sourceNodeId];
+                const int dest = nodeIndexes [(int) c->destNodeId];
+
+                if (c->destChannelIndex != AudioProcessorGraph::midiChannelIndex
+                     && ! audioPairs.contains (getPairKey (src, dest)))
+                    audioPairs.set (getPairKey (src, dest), false);
+
+                connectionSources.add (src);
+                connectionDests.add (dest);
+                firstSourceIndexes.getReference (dest + 1)++;
+            }
+        }
+
+        for (int i = 0; i < nodes.size(); ++i)
+            firstSourceIndexes.getReference (i + 1) += firstSourceIndexes.getUnchecked (i);
+
+        Array<int> nextSlots (firstSourceIndexes);
+        sourceIndexes.insertMultiple (0, 0, connectionSources.size());
+
+        for (int i = 0; i < connectionSources.size(); ++i)
+            sourceIndexes.set (nextSlots.getReference (connectionDests.getUnchecked (i))++,
+                               connectionSources.getUnchecked (i));
+
+        recalculateDelays();
+    }
+
+    int getNodeIndex (const uint32 nodeId) const
+    {
+        jassert (nodeIndexes.contains ((int) nodeId));
+        return nodeIndexes [(int) nodeId];
+    }
+
+    /** Registers one of the sequence's delay ops. */
+    void addDelayLine (DelayChannelOp* const op)
+    {
+        delayOps.add (op);
+        audioPairs.set (getPairKey (op->sourceNodeIndex, op->destNodeIndex), true);
+    }
+
+    /** Called once all the delay ops have been added, to allocate their memory. */
+    void allocateLines()
+    {
+        int total = 0;
+
+        for (int i = 0; i < delayOps.size(); ++i)
+            total += delayOps.getUnchecked (i)->getRequiredCapacity (blockSize);
+
+        if (usingDoublePrecision)
+            doubleLines.calloc ((size_t) jmax (1, total));
+        else
+            floatLines.calloc ((size_t) jmax (1, total));
+
+        for (int i = 0, offset = 0; i < delayOps.size(); ++i)
+        {
+            DelayChannelOp* const op = delayOps.getUnchecked (i);
+            const int capacity = op->getRequiredCapacity (blockSize);
+
+            op->setStorage (usingDoublePrecision ? nullptr : floatLines + offset,
+                            usingDoublePrecision ? doubleLines + offset : nullptr,
+                            capacity, blockSize);
+            offset += capacity;
+        }
+
+        for (HashMap<int64, bool>::Iterator i (audioPairs); i.next();)
+            if (! i.getValue())
+                uncompensatedPairs.add (i.getKey());
+    }
+
+    //==============================================================================
+    template <class BufferType>
+    void performOn (BufferType&, const OwnedArray <MidiBuffer>&, const int)
+    {
+        if (updateLatencies())
+        {
+            for (int i = delayOps.size(); --i >= 0;)
+            {
+                DelayChannelOp* const op = delayOps.getUnchecked (i);
+
+                if (! op->setTargetDelay (inputLatencies.getUnchecked (op->destNodeIndex)
+                                            - nodeDelays.getUnchecked (op->sourceNodeIndex)))
+                    rebuildNeeded = true;
+            }
+
+            for (int i = uncompensatedPairs.size(); --i >= 0;)
+            {
+                const int64 pair = uncompensatedPairs.getUnchecked (i);
+
+                if (inputLatencies.getUnchecked ((int) (pair & 0xffffffff))
+                      > nodeDelays.getUnchecked ((int) (pair >> 32)))
+                    rebuildNeeded = true;
+            }
+        }
+    }
+
+    void getBufferUsage (BufferUsage& usage) const      { usage.writesDelayTimes(); }
+
+    /** Returns the latency of the graph, as of the last block that was rendered. */
+    int getTotalLatency() const noexcept                { return totalLatency; }
+
+    /** Returns true if the latencies have changed in a way that needs new delay ops. */
+    bool needsRebuilding() const noexcept               { return rebuildNeeded; }
+
+private:
+    //==============================================================================
+    const bool usingDoublePrecision;
+    const int blockSize;
+    ReferenceCountedArray<AudioProcessorGraph::Node> nodes;
+    HashMap<int, int> nodeIndexes;
+    Array<int> latencies, nodeDelays, inputLatencies;
+    Array<int> sourceIndexes, firstSourceIndexes;
+    HashMap<int64, bool> audioPairs;
+    Array<int64> uncompensatedPairs;
+    Array<DelayChannelOp*> delayOps;
+    HeapBlock<float> floatLines;
+    HeapBlock<double> doubleLines;
+    int outputNodeIndex, totalLatency;
+    bool rebuildNeeded;
+
+    static int64 getPairKey (const int sourceIndex, const int destIndex) noexcept
+    {
+        return (((int64) sourceIndex) << 32) | (int64) (uint32) destIndex;
+    }
+
+    /*  Re-reads the nodes' latencies, and if any have changed, recalculates the delays. */
+    bool updateLatencies() noexcept
+    {
+        bool anyChanged = false;
+
+        for (int i = nodes.size(); --i >= 0;)
+        {
+            const int latency = nodes.getUnchecked (i)->getProcessor()->getLatencySamples();
+
+            if (latency != latencies.getUnchecked (i))
+            {
+                latencies.set (i, latency);
+                anyChanged = true;
+            }
+        }
+
+        if (anyChanged)
+            recalculateDelays();
+
+        return anyChanged;
+    }
+
+    /*  Works out the total delay at each node's inputs and outputs. (The nodes are in
+        rendering order, so each node's sources have always been done before it).
+    */
+    void recalculateDelays() noexcept
+    {
+        for (int i = 0; i < nodes.size(); ++i)
+        {
+            int maxLatency = 0;
+
+            for (int j = firstSourceIndexes.getUnchecked (i); j < firstSourceIndexes.getUnchecked (i + 1); ++j)
+                maxLatency = jmax (maxLatency, nodeDelays.getUnchecked (sourceIndexes.getUnchecked (j)));
+
+            inputLatencies.set (i, maxLatency);
+            nodeDelays.set (i, maxLatency + latencies.getUnchecked (i));
+        }
+
+        totalLatency = outputNodeIndex >= 0 ? inputLatencies.getUnchecked (outputNodeIndex) : 0;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (DelayLinePool)
+};
 
 //==============================================================================
-class ProcessBufferOp : public AudioGraphRenderingOp
+class ProcessBufferOp : public AudioGraphRenderingOpBase <ProcessBufferOp>
 {
 public:
     ProcessBufferOp (const AudioProcessorGraph::Node::Ptr& node_,
                      const Array <int>& audioChannelsToUse_,
                      const int totalChans_,
-                     const int midiBufferToUse_)
+                     const int midiBufferToUse_,
+                     const bool graphIsUsingDoublePrecision,
+                     const int blockSize,
+                     const AudioProcessorGraph& graph_,
+                     ChannelSilence& silence_)
         : node (node_),
           processor (node_->getProcessor()),
           audioChannelsToUse (audioChannelsToUse_),
           totalChans (jmax (1, totalChans_)),
-          midiBufferToUse (midiBufferToUse_)
+          numIns (processor->getNumInputChannels()),
+          numOuts (processor->getNumOutputChannels()),
+          midiBufferToUse (midiBufferToUse_),
+          conversionBuffer (1, 1),
+          graph (graph_),
+          silence (silence_),
+          canSleep (processor->silenceInProducesSilenceOut()),
+          numSilentInputSamples (0),
+          tailSamples (0)
     {
         channels.calloc ((size_t) totalChans);
+        doubleChannels.calloc ((size_t) totalChans);
 
         while (audioChannelsToUse.size() < totalChans)
             audioChannelsToUse.add (0);
+
+        if (graphIsUsingDoublePrecision && ! processor->isUsingDoublePrecision())
+            conversionBuffer.setSize (totalChans, jmax (1, blockSize));
     }
 
-    void perform (AudioSampleBuffer& sharedBufferChans, const OwnedArray <MidiBuffer>& sharedMidiBuffers, const int numSamples)
+    void performOn (AudioSampleBuffer& sharedBufferChans, const OwnedArray <MidiBuffer>& sharedMidiBuffers, const int numSamples)
     {
+        if (isAsleep (sharedBufferChans, *sharedMidiBuffers.getUnchecked (midiBufferToUse), numSamples))
+            return;
+
         for (int i = totalChans; --i >= 0;)
             channels[i] = sharedBufferChans.getSampleData (audioChannelsToUse.getUnchecked (i), 0);
 
         AudioSampleBuffer buffer (channels, totalChans, numSamples);
 
-        processor->processBlock (buffer, *sharedMidiBuffers.getUnchecked (midiBufferToUse));
+        {
+            const ScopedNodeTimer timer (*this, numSamples);
+            JUCE_TRACE_SCOPE_WITH_ID ("Graph node", (int) node->nodeId);
+            processor->processBlock (buffer, *sharedMidiBuffers.getUnchecked (midiBufferToUse));
+        }
+
+        updateSilenceFlags (channels.getData(), numSamples);
+    }
+
+    void performOn (DoubleAudioSampleBuffer& sharedBufferChans, const OwnedArray <MidiBuffer>& sharedMidiBuffers, const int numSamples)
+    {
+        if (isAsleep (sharedBufferChans, *sharedMidiBuffers.getUnchecked (midiBufferToUse), numSamples))
+            return;
+
+        for (int i = totalChans; --i >= 0;)
+            doubleChannels[i] = sharedBufferChans.getSampleData (audioChannelsToUse.getUnchecked (i), 0);
+
+        DoubleAudioSampleBuffer buffer (doubleChannels, totalChans, numSamples);
+        MidiBuffer& midiMessages = *sharedMidiBuffers.getUnchecked (midiBufferToUse);
+
+        const ScopedNodeTimer timer (*this, numSamples);
+        JUCE_TRACE_SCOPE_WITH_ID ("Graph node", (int) node->nodeId);
+
+        if (processor->isUsingDoublePrecision())
+        {
+            processor->processBlock (buffer, midiMessages);
+        }
+        else
+        {
+            // this processor can only work in single precision, so its data has to be converted..
+            conversionBuffer.setSize (totalChans, numSamples, false, false, true);
+
+            for (int i = totalChans; --i >= 0;)
+                buffer.copyTo (conversionBuffer, i, 0, i, 0, numSamples);
+
+            processor->processBlock (conversionBuffer, midiMessages);
+
+            for (int i = totalChans; --i >= 0;)
+                if (audioChannelsToUse.getUnchecked (i) != 0) // (the shared empty buffer is read-only)
+                    buffer.copyFrom (i, 0, conversionBuffer, i, 0, numSamples);
+        }
+
+        updateSilenceFlags (doubleChannels.getData(), numSamples);
+    }
+
+    void getBufferUsage (BufferUsage& usage) const
+    {
+        for (int i = totalChans; --i >= 0;)
+        {
+            const int chan = audioChannelsToUse.getUnchecked (i);
+            usage.readsAudio (chan);
+
+            if (chan != 0)
+                usage.writesAudio (chan);
+        }
+
+        usage.readsMidi (midiBufferToUse);
+        usage.writesMidi (midiBufferToUse);
+
+        // output nodes all mix into the graph's output buffers, so they mustn't run concurrently
+        if (const AudioProcessorGraph::AudioGraphIOProcessor* const ioProc
+                = dynamic_cast <const AudioProcessorGraph::AudioGraphIOProcessor*> (processor))
+            if (ioProc->isOutput())
+                usage.writesGraphOutput();
     }
 
     const AudioProcessorGraph::Node::Ptr node;
@@ -232,8 +842,107 @@ public:
 private:
     Array <int> audioChannelsToUse;
     HeapBlock <float*> channels;
-    int totalChans;
+    HeapBlock <double*> doubleChannels;
+    int totalChans, numIns, numOuts;
     int midiBufferToUse;
+    AudioSampleBuffer conversionBuffer;
+    const AudioProcessorGraph& graph;
+    ChannelSilence& silence;
+    const bool canSleep;
+    int numSilentInputSamples, tailSamples;
+
+    bool areInputsSilent (const MidiBuffer& midiMessages) const noexcept
+    {
+        for (int i = 0; i < numIns; ++i)
+            if (! silence.isSilent (audioChannelsToUse.getUnchecked (i)))
+                return false;
+
+        return midiMessages.isEmpty();
+    }
+
+    // Returns the number of samples after its input goes silent that the node's output
+    // may still be making a sound, or -1 if it might never stop.
+    int getTailLengthSamples() const
+    {
+        const double tail = jmax (0.0, processor->getTailLengthSeconds()) * processor->getSampleRate()
+                              + processor->getLatencySamples();
+
+        return tail < 0x3fffffff ? (int) tail : -1;
+    }
+
+    /*  Nodes that have promised that silence in produces silence out are put to sleep once
+        their inputs have been silent for longer than their tail. Instead of being called,
+        the node then just has its outputs cleared.
+    */
+    template <class BufferType>
+    bool isAsleep (BufferType& sharedBufferChans, const MidiBuffer& midiMessages, const int numSamples)
+    {
+        if (! (canSleep && areInputsSilent (midiMessages)))
+        {
+            numSilentInputSamples = 0;
+            return false;
+        }
+
+        // (the tail is checked each time the input goes quiet, as it may depend on the node's settings)
+        if (numSilentInputSamples == 0)
+            tailSamples = getTailLengthSamples();
+
+        if (tailSamples < 0 || numSilentInputSamples < tailSamples)
+        {
+            numSilentInputSamples = jmin (numSilentInputSamples + numSamples, 0x3fffffff);
+            return false;
+        }
+
+        for (int i = 0; i < numOuts; ++i)
+        {
+            const int chan = audioChannelsToUse.getUnchecked (i);
+
+            if (chan != 0 && ! silence.isSilent (chan))
+            {
+                sharedBufferChans.clear (chan, 0, numSamples);
+                silence.setSilent (chan, true);
+            }
+        }
+
+        return true;
+    }
+
+    // After the node has run, this checks which of the channels it has left silent
+    template <typename SampleType>
+    void updateSilenceFlags (SampleType* const* const data, const int numSamples) noexcept
+    {
+        for (int i = totalChans; --i >= 0;)
+        {
+            const int chan = audioChannelsToUse.getUnchecked (i);
+
+            if (chan != 0)
+                silence.setSilent (chan, ChannelSilence::isSilent (data[i], numSamples));
+        }
+    }
+
+    // Records how long the node takes, if the graph has a profiler
+    struct ScopedNodeTimer
+    {
+        ScopedNodeTimer (const ProcessBufferOp& op_, const int numSamples_) noexcept
+            : op (op_), profiler (op_.graph.getProfiler()), numSamples (numSamples_),
+              startTime (profiler != nullptr ? Time::getMillisecondCounterHiRes() : 0.0)
+        {
+        }
+
+        ~ScopedNodeTimer()
+        {
+            if (profiler != nullptr)
+                profiler->addEvent (AudioCallbackProfiler::Event::graphNode, (int) op.node->nodeId, numSamples,
+                                    startTime, Time::getMillisecondCounterHiRes() - startTime);
+        }
+
+        const ProcessBufferOp& op;
+        AudioCallbackProfiler* const profiler;
+        const int numSamples;
+        const double startTime;
+
+        JUCE_DECLARE_NON_COPYABLE (ScopedNodeTimer)
+    };
 
     JUCE_DECLARE_NON_COPYABLE (ProcessBufferOp)
 };
@@ -241,6 +950,11 @@ private:
 //==============================================================================
 /** Used to calculate the correct sequence of rendering ops needed, based on
     the best re-use of shared buffers at each stage.
+
+    Before building the sequence, it works out the last step at which each node output
+    is used. Each buffer's lifetime is then an interval of steps, and a buffer is freed
+    as soon as the step that last reads it has been rendered. Picking the lowest free
+    buffer for each new interval never needs more buffers than are live at once.
 */
 class RenderingOpSequenceCalculator
 {
@@ -248,16 +962,25 @@ public:
     //==============================================================================
     RenderingOpSequenceCalculator (AudioProcessorGraph& graph_,
                                    const Array<void*>& orderedNodes_,
-                                   Array<void*>& renderingOps)
+                                   Array<void*>& renderingOps,
+                                   ChannelSilence& silence_)
         : graph (graph_),
           orderedNodes (orderedNodes_),
-          totalLatency (0)
+          silence (silence_),
+          totalLatency (0),
+          numChannelCopies (0),
+          delayLines (nullptr)
     {
         nodeIds.add ((uint32) zeroNodeID); // first buffer is read-only zeros
         channels.add (0);
 
         midiNodeIds.add ((uint32) zeroNodeID);
 
+        analyseConnections();
+
+        delayLines = new DelayLinePool (graph, orderedNodes, graph.isUsingDoublePrecision(), graph.getBlockSize());
+        renderingOps.add (delayLines);
+
         for (int i = 0; i < orderedNodes.size(); ++i)
         {
             createRenderingOpsForNode ((AudioProcessorGraph::Node*) orderedNodes.getUnchecked(i),
@@ -266,16 +989,20 @@ public:
             markAnyUnusedBuffersAsFree (i);
         }
 
+        delayLines->allocateLines();
         graph.setLatencySamples (totalLatency);
     }
 
     int getNumBuffersNeeded() const         { return nodeIds.size(); }
     int getNumMidiBuffersNeeded() const     { return midiNodeIds.size(); }
+    int getNumChannelCopies() const         { return numChannelCopies; }
+    DelayLinePool* getDelayLinePool() const { return delayLines; }
 
 private:
     //==============================================================================
     AudioProcessorGraph& graph;
     const Array<void*>& orderedNodes;
+    ChannelSilence& silence;
     Array <int> channels;
     Array <uint32> nodeIds, midiNodeIds;
 
@@ -285,7 +1012,91 @@ private:
 
     Array <uint32> nodeDelayIDs;
     Array <int> nodeDelays;
-    int totalLatency;
+    int totalLatency, numChannelCopies;
+    DelayLinePool* delayLines;
+
+    /** The last place that a node's output channel is read: the step index of the
+        consuming node, and which of its input channels the output feeds.
+    */
+    struct LastUse
+    {
+        int step;
+        SortedSet<int> inputChannels;
+    };
+
+    HashMap<int64, LastUse> lastUses;
+    OwnedArray<Array<const AudioProcessorGraph::Connection*> > nodeInputs;
+
+    static int64 getLastUseKey (const uint32 nodeId, const int outputChannel) noexcept
+    {
+        // (the channel goes in the low bits, because they're the ones that get hashed)
+        return (((int64) nodeId) << 16) | (int64) (outputChannel & 0xffff);
+    }
+
+    /*  Makes a list of each node's input connections, and finds out where each node output
+        is last used.
+    */
+    void analyseConnections()
+    {
+        HashMap<int, int> stepIndexes;
+
+        for (int i = 0; i < orderedNodes.size(); ++i)
+        {
+            stepIndexes.set ((int) ((const AudioProcessorGraph::Node*) orderedNodes.getUnchecked(i))->nodeId, i);
+            nodeInputs.add (new Array<const AudioProcessorGraph::Connection*>());
+        }
+
+        for (int i = graph.getNumConnections(); --i >= 0;)
+        {
+            const AudioProcessorGraph::Connection* const c = graph.getConnection (i);
+
+            if (! stepIndexes.contains ((int) c->destNodeId))
+                continue;
+
+            const int step = stepIndexes [(int) c->destNodeId];
+            nodeInputs.getUnchecked (step)->add (c);
+            const AudioProcessorGraph::Node* const dest = (const AudioProcessorGraph::Node*) orderedNodes.getUnchecked (step);
+
+            if (c->destChannelIndex != AudioProcessorGraph::midiChannelIndex
+                 && c->destChannelIndex >= dest->getProcessor()->getNumInputChannels())
+                continue;
+
+            const int64 key = getLastUseKey (c->sourceNodeId, c->sourceChannelIndex);
+            LastUse use;
+
+            if (lastUses.contains (key))
+            {
+                use = lastUses [key];
+
+                if (use.step > step)
+                    continue;
+
+                if (use.step < step)
+                    use.inputChannels.clear();
+            }
+
+            use.step = step;
+            use.inputChannels.add (c->destChannelIndex);
+            lastUses.set (key, use);
+        }
+    }
+
+    void addCopyChannelOp (Array<void*>& renderingOps, const int srcIndex, const int dstIndex)
+    {
+        renderingOps.add (new CopyChannelOp (srcIndex, dstIndex, silence));
+        ++numChannelCopies;
+    }
+
+    void addDelayChannelOp (Array<void*>& renderingOps, const int bufIndex,
+                            const uint32 sourceNodeId, const uint32 destNodeId, const int numSamplesDelay)
+    {
+        DelayChannelOp* const op = new DelayChannelOp (bufIndex, numSamplesDelay,
+                                                       delayLines->getNodeIndex (sourceNodeId),
+                                                       delayLines->getNodeIndex (destNodeId),
+                                                       silence);
+        delayLines->addDelayLine (op);
+        renderingOps.add (op);
+    }
 
     int getNodeDelay (const uint32 nodeID) const          { return nodeDelays [nodeDelayIDs.indexOf (nodeID)]; }
 
@@ -304,17 +1115,13 @@ private:
         }
     }
 
-    int getInputLatencyForNode (const uint32 nodeID) const
+    int getInputLatencyForNode (const int stepIndex) const
     {
+        const Array<const AudioProcessorGraph::Connection*>& inputs = *nodeInputs.getUnchecked (stepIndex);
         int maxLatency = 0;
 
-        for (int i = graph.getNumConnections(); --i >= 0;)
-        {
-            const AudioProcessorGraph::Connection* const c = graph.getConnection (i);
-
-            if (c->destNodeId == nodeID)
-                maxLatency = jmax (maxLatency, getNodeDelay (c->sourceNodeId));
-        }
+        for (int i = 0; i < inputs.size(); ++i)
+            maxLatency = jmax (maxLatency, getNodeDelay (inputs.getUnchecked(i)->sourceNodeId));
 
         return maxLatency;
     }
@@ -331,7 +1138,8 @@ private:
         Array <int> audioChannelsToUse;
         int midiBufferToUse = -1;
 
-        int maxLatency = getInputLatencyForNode (node->nodeId);
+        int maxLatency = getInputLatencyForNode (ourRenderingIndex);
+        const Array<const AudioProcessorGraph::Connection*>& inputs = *nodeInputs.getUnchecked (ourRenderingIndex);
 
         for (int inputChan = 0; inputChan < numIns; ++inputChan)
         {
@@ -339,11 +1147,11 @@ private:
             Array <uint32> sourceNodes;
             Array<int> sourceOutputChans;
 
-            for (int i = graph.getNumConnections(); --i >= 0;)
+            for (int i = 0; i < inputs.size(); ++i)
             {
-                const AudioProcessorGraph::Connection* const c = graph.getConnection (i);
+                const AudioProcessorGraph::Connection* const c = inputs.getUnchecked (i);
 
-                if (c->destNodeId == node->nodeId && c->destChannelIndex == inputChan)
+                if (c->destChannelIndex == inputChan)
                 {
                     sourceNodes.add (c->sourceNodeId);
                     sourceOutputChans.add (c->sourceChannelIndex);
@@ -364,7 +1172,7 @@ private:
                 else
                 {
                     bufIndex = getFreeBuffer (false);
-                    renderingOps.add (new ClearChannelOp (bufIndex));
+                    renderingOps.add (new ClearChannelOp (bufIndex, silence));
                 }
             }
             else if (sourceNodes.size() == 1)
@@ -391,7 +1199,7 @@ private:
                     // need to use a copy of it..
                     const int newFreeBuffer = getFreeBuffer (false);
 
-                    renderingOps.add (new CopyChannelOp (bufIndex, newFreeBuffer));
+                    addCopyChannelOp (renderingOps, bufIndex, newFreeBuffer);
 
                     bufIndex = newFreeBuffer;
                 }
@@ -399,7 +1207,7 @@ private:
                 const int nodeDelay = getNodeDelay (srcNode);
 
                 if (nodeDelay < maxLatency)
-                    renderingOps.add (new DelayChannelOp (bufIndex, maxLatency - nodeDelay));
+                    addDelayChannelOp (renderingOps, bufIndex, srcNode, node->nodeId, maxLatency - nodeDelay);
             }
             else
             {
@@ -425,7 +1233,7 @@ private:
 
                         const int nodeDelay = getNodeDelay (sourceNodes.getUnchecked (i));
                         if (nodeDelay < maxLatency)
-                            renderingOps.add (new DelayChannelOp (sourceBufIndex, maxLatency - nodeDelay));
+                            addDelayChannelOp (renderingOps, sourceBufIndex, sourceNodes.getUnchecked (i), node->nodeId, maxLatency - nodeDelay);
 
                         break;
                     }
@@ -442,18 +1250,18 @@ private:
                     if (srcIndex < 0)
                     {
                         // if not found, this is probably a feedback loop
-                        renderingOps.add (new ClearChannelOp (bufIndex));
+                        renderingOps.add (new ClearChannelOp (bufIndex, silence));
                     }
                     else
                     {
-                        renderingOps.add (new CopyChannelOp (srcIndex, bufIndex));
+                        addCopyChannelOp (renderingOps, srcIndex, bufIndex);
                     }
 
                     reusableInputIndex = 0;
                     const int nodeDelay = getNodeDelay (sourceNodes.getFirst());
 
                     if (nodeDelay < maxLatency)
-                        renderingOps.add (new DelayChannelOp (bufIndex, maxLatency - nodeDelay));
+                        addDelayChannelOp (renderingOps, bufIndex, sourceNodes.getFirst(), node->nodeId, maxLatency - nodeDelay);
                 }
 
                 for (int j = 0; j < sourceNodes.size(); ++j)
@@ -472,18 +1280,18 @@ private:
                                                            sourceNodes.getUnchecked(j),
                                                            sourceOutputChans.getUnchecked(j)))
                                 {
-                                    renderingOps.add (new DelayChannelOp (srcIndex, maxLatency - nodeDelay));
+                                    addDelayChannelOp (renderingOps, srcIndex, sourceNodes.getUnchecked(j), node->nodeId, maxLatency - nodeDelay);
                                 }
                                 else // buffer is reused elsewhere, can't be delayed
                                 {
                                     const int bufferToDelay = getFreeBuffer (false);
-                                    renderingOps.add (new CopyChannelOp (srcIndex, bufferToDelay));
-                                    renderingOps.add (new DelayChannelOp (bufferToDelay, maxLatency - nodeDelay));
+                                    addCopyChannelOp (renderingOps, srcIndex, bufferToDelay);
+                                    addDelayChannelOp (renderingOps, bufferToDelay, sourceNodes.getUnchecked(j), node->nodeId, maxLatency - nodeDelay);
                                     srcIndex = bufferToDelay;
                                 }
                             }
 
-                            renderingOps.add (new AddChannelOp (srcIndex, bufIndex));
+                            renderingOps.add (new AddChannelOp (srcIndex, bufIndex, silence));
                         }
                     }
                 }
@@ -508,11 +1316,11 @@ private:
         // Now the same thing for midi..
         Array <uint32> midiSourceNodes;
 
-        for (int i = graph.getNumConnections(); --i >= 0;)
+        for (int i = 0; i < inputs.size(); ++i)
         {
-            const AudioProcessorGraph::Connection* const c = graph.getConnection (i);
+            const AudioProcessorGraph::Connection* const c = inputs.getUnchecked (i);
 
-            if (c->destNodeId == node->nodeId && c->destChannelIndex == AudioProcessorGraph::midiChannelIndex)
+            if (c->destChannelIndex == AudioProcessorGraph::midiChannelIndex)
                 midiSourceNodes.add (c->sourceNodeId);
         }
 
@@ -589,6 +1397,8 @@ private:
                 reusableInputIndex = 0;
             }
 
+            Array<int> buffersToAdd;
+
             for (int j = 0; j < midiSourceNodes.size(); ++j)
             {
                 if (j != reusableInputIndex)
@@ -596,9 +1406,12 @@ private:
                     const int srcIndex = getBufferContaining (midiSourceNodes.getUnchecked(j),
                                                               AudioProcessorGraph::midiChannelIndex);
                     if (srcIndex >= 0)
-                        renderingOps.add (new AddMidiBufferOp (srcIndex, midiBufferToUse));
+                        buffersToAdd.add (srcIndex);
                 }
             }
+
+            if (buffersToAdd.size() > 0)
+                renderingOps.add (new AddMidiBufferOp (buffersToAdd, midiBufferToUse));
         }
 
         if (node->getProcessor()->producesMidi())
@@ -611,7 +1424,8 @@ private:
             totalLatency = maxLatency;
 
         renderingOps.add (new ProcessBufferOp (node, audioChannelsToUse,
-                                               totalChans, midiBufferToUse));
+                                               totalChans, midiBufferToUse,
+                                               graph.isUsingDoublePrecision(), graph.getBlockSize(), graph, silence));
     }
 
     //==============================================================================
@@ -667,7 +1481,7 @@ private:
         for (int i = 0; i < nodeIds.size(); ++i)
         {
             if (isNodeBusy (nodeIds.getUnchecked(i))
-                 && ! isBufferNeededLater (stepIndex, -1,
+                 && ! isBufferNeededLater (stepIndex + 1, -1,
                                            nodeIds.getUnchecked(i),
                                            channels.getUnchecked(i)))
             {
@@ -678,7 +1492,7 @@ private:
         for (int i = 0; i < midiNodeIds.size(); ++i)
         {
             if (isNodeBusy (midiNodeIds.getUnchecked(i))
-                 && ! isBufferNeededLater (stepIndex, -1,
+                 && ! isBufferNeededLater (stepIndex + 1, -1,
                                            midiNodeIds.getUnchecked(i),
                                            AudioProcessorGraph::midiChannelIndex))
             {
@@ -687,189 +1501,452 @@ private:
         }
     }
 
-    bool isBufferNeededLater (int stepIndexToSearchFrom,
-                              int inputChannelOfIndexToIgnore,
+    /*  Returns true if the given output is read by a later node, or by the node at the
+        given step on an input channel other than inputChannelOfIndexToIgnore.
+
+        The exception is that the node's channels below inputChannelOfIndexToIgnore have
+        already been set up by the time this gets asked, so if they share this output and
+        are also outputs, they'll have been given their own copies of it, and the current
+        channel is free to use it in-place. (Input-only channels read it without a copy).
+    */
+    bool isBufferNeededLater (const int stepIndexToSearchFrom,
+                              const int inputChannelOfIndexToIgnore,
                               const uint32 nodeId,
                               const int outputChanIndex) const
     {
-        while (stepIndexToSearchFrom < orderedNodes.size())
+        const int64 key = getLastUseKey (nodeId, outputChanIndex);
+
+        if (! lastUses.contains (key))
+            return false;
+
+        const LastUse use (lastUses [key]);
+
+        if (use.step != stepIndexToSearchFrom)
+            return use.step > stepIndexToSearchFrom;
+
+        const AudioProcessorGraph::Node* const node = (const AudioProcessorGraph::Node*) orderedNodes.getUnchecked (stepIndexToSearchFrom);
+        const int numOuts = node->getProcessor()->getNumOutputChannels();
+
+        for (int i = use.inputChannels.size(); --i >= 0;)
+        {
+            const int chan = use.inputChannels.getUnchecked (i);
+
+            if (chan != inputChannelOfIndexToIgnore
+                 && (chan > inputChannelOfIndexToIgnore || chan >= numOuts))
+                return true;
+        }
+
+        return false;
+    }
+
+    void markBufferAsContaining (int bufferNum, uint32 nodeId, int outputIndex)
+    {
+        if (outputIndex == AudioProcessorGraph::midiChannelIndex)
+        {
+            jassert (bufferNum > 0 && bufferNum < midiNodeIds.size());
+
+            midiNodeIds.set (bufferNum, nodeId);
+        }
+        else
+        {
+            jassert (bufferNum >= 0 && bufferNum < nodeIds.size());
+
+            nodeIds.set (bufferNum, nodeId);
+            channels.set (bufferNum, outputIndex);
+        }
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (RenderingOpSequenceCalculator)
+};
+
+//==============================================================================
+struct ConnectionSorter
+{
+    static int compareElements (const AudioProcessorGraph::Connection* const first,
+                                const AudioProcessorGraph::Connection* const second) noexcept
+    {
+        if (first->sourceNodeId < second->sourceNodeId)                return -1;
+        if (first->sourceNodeId > second->sourceNodeId)                return 1;
+        if (first->destNodeId < second->destNodeId)                    return -1;
+        if (first->destNodeId > second->destNodeId)                    return 1;
+        if (first->sourceChannelIndex < second->sourceChannelIndex)    return -1;
+        if (first->sourceChannelIndex > second->sourceChannelIndex)    return 1;
+        if (first->destChannelIndex < second->destChannelIndex)        return -1;
+        if (first->destChannelIndex > second->destChannelIndex)        return 1;
+
+        return 0;
+    }
+};
+
+//==============================================================================
+/** Holds a dependency graph of a rendering op sequence, so that several threads
+    can work through the ops together.
+
+    Each op depends on the earlier ops that write to any buffer that it uses, and on the
+    earlier ops that read any buffer that it overwrites, so whatever order the threads pick
+    the ops in, each one sees exactly the same data that it would have seen in the serial
+    sequence.
+*/
+class ParallelRenderingSequence
+{
+public:
+    explicit ParallelRenderingSequence (const Array<void*>& ops_)
+        : ops (ops_),
+          sharedBufferChans (nullptr),
+          sharedDoubleBufferChans (nullptr),
+          sharedMidiBuffers (nullptr),
+          numSamples (0)
+    {
+        OwnedArray<BufferUsage> usages;
+        SortedSet<int> resources;
+
+        for (int i = 0; i < ops.size(); ++i)
+        {
+            BufferUsage* const usage = new BufferUsage();
+            usages.add (usage);
+            getOp (i)->getBufferUsage (*usage);
+
+            resources.addArray (usage->reads.getRawDataPointer(), usage->reads.size());
+            resources.addArray (usage->writes.getRawDataPointer(), usage->writes.size());
+        }
+
+        Array<int> lastWriter;
+        lastWriter.insertMultiple (0, -1, resources.size());
+        OwnedArray<SortedSet<int> > readersSinceLastWrite;
+
+        for (int i = 0; i < resources.size(); ++i)
+            readersSinceLastWrite.add (new SortedSet<int>());
+
+        for (int i = 0; i < ops.size(); ++i)
         {
-            const AudioProcessorGraph::Node* const node = (const AudioProcessorGraph::Node*) orderedNodes.getUnchecked (stepIndexToSearchFrom);
+            const BufferUsage& usage = *usages.getUnchecked (i);
+            SortedSet<int> dependencies;
 
-            if (outputChanIndex == AudioProcessorGraph::midiChannelIndex)
+            for (int j = 0; j < usage.reads.size(); ++j)
             {
-                if (inputChannelOfIndexToIgnore != AudioProcessorGraph::midiChannelIndex
-                     && graph.getConnectionBetween (nodeId, AudioProcessorGraph::midiChannelIndex,
-                                                    node->nodeId, AudioProcessorGraph::midiChannelIndex) != nullptr)
-                    return true;
+                const int writer = lastWriter.getUnchecked (resources.indexOf (usage.reads.getUnchecked (j)));
+
+                if (writer >= 0)
+                    dependencies.add (writer);
             }
-            else
+
+            for (int j = 0; j < usage.writes.size(); ++j)
             {
-                for (int i = 0; i < node->getProcessor()->getNumInputChannels(); ++i)
-                    if (i != inputChannelOfIndexToIgnore
-                         && graph.getConnectionBetween (nodeId, outputChanIndex,
-                                                        node->nodeId, i) != nullptr)
-                        return true;
+                const int resource = resources.indexOf (usage.writes.getUnchecked (j));
+                const int writer = lastWriter.getUnchecked (resource);
+
+                if (writer >= 0)
+                    dependencies.add (writer);
+
+                dependencies.addSet (*readersSinceLastWrite.getUnchecked (resource));
             }
 
-            inputChannelOfIndexToIgnore = -1;
-            ++stepIndexToSearchFrom;
+            for (int j = 0; j < usage.writes.size(); ++j)
+            {
+                const int resource = resources.indexOf (usage.writes.getUnchecked (j));
+                lastWriter.set (resource, i);
+                readersSinceLastWrite.getUnchecked (resource)->clear();
+            }
+
+            for (int j = 0; j < usage.reads.size(); ++j)
+                readersSinceLastWrite.getUnchecked (resources.indexOf (usage.reads.getUnchecked (j)))->add (i);
+
+            dependencies.removeValue (i);
+            numDependencies.add (dependencies.size());
+            dependents.add (new Array<int>());
+
+            for (int j = 0; j < dependencies.size(); ++j)
+                dependents.getUnchecked (dependencies.getUnchecked (j))->add (i);
         }
 
-        return false;
+        pendingDependencies.insertMultiple (0, Atomic<int>(), ops.size());
+        readyQueue.insertMultiple (0, Atomic<int> (-1), ops.size());
     }
 
-    void markBufferAsContaining (int bufferNum, uint32 nodeId, int outputIndex)
+    /** Resets the sequence ready to render a block. This must be called before any
+        threads start to call renderUntilFinished().
+    */
+    void startBlock (AudioSampleBuffer& sharedBufferChans_,
+                     const OwnedArray<MidiBuffer>& sharedMidiBuffers_,
+                     const int numSamples_) noexcept
     {
-        if (outputIndex == AudioProcessorGraph::midiChannelIndex)
+        sharedBufferChans = &sharedBufferChans_;
+        sharedDoubleBufferChans = nullptr;
+        startBlock (sharedMidiBuffers_, numSamples_);
+    }
+
+    void startBlock (DoubleAudioSampleBuffer& sharedBufferChans_,
+                     const OwnedArray<MidiBuffer>& sharedMidiBuffers_,
+                     const int numSamples_) noexcept
+    {
+        sharedBufferChans = nullptr;
+        sharedDoubleBufferChans = &sharedBufferChans_;
+        startBlock (sharedMidiBuffers_, numSamples_);
+    }
+
+    /** Runs any ops that are ready, until all the ops in the sequence have been performed.
+        Any number of threads can call this at the same time.
+    */
+    void renderUntilFinished() noexcept
+    {
+        while (numFinished.get() < ops.size())
+            if (! performNextReadyOp())
+                Thread::yield();
+    }
+
+private:
+    const Array<void*> ops;
+    Array<int> numDependencies;
+    OwnedArray<Array<int> > dependents;
+
+    Array<Atomic<int> > pendingDependencies, readyQueue;
+    Atomic<int> numQueued, numTaken, numFinished;
+
+    AudioSampleBuffer* sharedBufferChans;
+    DoubleAudioSampleBuffer* sharedDoubleBufferChans;
+    const OwnedArray<MidiBuffer>* sharedMidiBuffers;
+    int numSamples;
+
+    void startBlock (const OwnedArray<MidiBuffer>& sharedMidiBuffers_, const int numSamples_) noexcept
+    {
+        sharedMidiBuffers = &sharedMidiBuffers_;
+        numSamples = numSamples_;
+
+        numQueued = 0;
+        numTaken = 0;
+        numFinished = 0;
+
+        for (int i = ops.size(); --i >= 0;)
         {
-            jassert (bufferNum > 0 && bufferNum < midiNodeIds.size());
+            pendingDependencies.getReference (i) = numDependencies.getUnchecked (i);
+            readyQueue.getReference (i) = -1;
+        }
+
+        for (int i = 0; i < ops.size(); ++i)
+            if (numDependencies.getUnchecked (i) == 0)
+                addToReadyQueue (i);
+    }
+
+
+    AudioGraphRenderingOp* getOp (const int index) const noexcept
+    {
+        return static_cast<AudioGraphRenderingOp*> (ops.getUnchecked (index));
+    }
+
+    void addToReadyQueue (const int opIndex) noexcept
+    {
+        readyQueue.getReference (++numQueued - 1) = opIndex;
+    }
+
+    bool performNextReadyOp() noexcept
+    {
+        const int index = numTaken.get();
+
+        if (index >= numQueued.get())
+            return false;
+
+        if (numTaken.compareAndSetBool (index + 1, index))
+        {
+            int opIndex;
+
+            // the slot may have been claimed just before the thread that queued it has filled it in..
+            while ((opIndex = readyQueue.getReference (index).get()) < 0)
+            {}
+
+            if (sharedDoubleBufferChans != nullptr)
+                getOp (opIndex)->perform (*sharedDoubleBufferChans, *sharedMidiBuffers, numSamples);
+            else
+                getOp (opIndex)->perform (*sharedBufferChans, *sharedMidiBuffers, numSamples);
+
+            const Array<int>& ds = *dependents.getUnchecked (opIndex);
+
+            for (int i = 0; i < ds.size(); ++i)
+                if (--(pendingDependencies.getReference (ds.getUnchecked (i))) == 0)
+                    addToReadyQueue (ds.getUnchecked (i));
 
-            midiNodeIds.set (bufferNum, nodeId);
+            ++numFinished;
         }
-        else
-        {
-            jassert (bufferNum >= 0 && bufferNum < nodeIds.size());
 
-            nodeIds.set (bufferNum, nodeId);
-            channels.set (bufferNum, outputIndex);
-        }
+        return true;
     }
 
-    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (RenderingOpSequenceCalculator)
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ParallelRenderingSequence)
 };
 
+}
+
 //==============================================================================
-// Holds a fast lookup table for checking which nodes are inputs to others.
-class ConnectionLookupTable
+class AudioProcessorGraph::ParallelRenderer
 {
 public:
-    explicit ConnectionLookupTable (const OwnedArray<AudioProcessorGraph::Connection>& connections)
+    ParallelRenderer (const int numThreads, const double blockPeriodMs)
+        : sequence (nullptr), fpStatus (0)
     {
-        for (int i = 0; i < connections.size(); ++i)
-        {
-            const AudioProcessorGraph::Connection* const c = connections.getUnchecked(i);
-
-            int index;
-            Entry* entry = findEntry (c->destNodeId, index);
-
-            if (entry == nullptr)
-            {
-                entry = new Entry (c->destNodeId);
-                entries.insert (index, entry);
-            }
+        Thread::RealtimeOptions realtimeOptions;
+        realtimeOptions.priority = 9;
+        realtimeOptions.periodMs = blockPeriodMs;
 
-            entry->srcNodes.add (c->sourceNodeId);
+        // the audio thread does its share of the work too, so only needs numThreads - 1 helpers
+        for (int i = 1; i < numThreads; ++i)
+        {
+            RenderingThread* const t = new RenderingThread (*this);
+            threads.add (t);
+            t->setRealtime (realtimeOptions);
+            t->startThread (9);
         }
     }
 
-    bool isAnInputTo (const uint32 possibleInputId,
-                      const uint32 possibleDestinationId) const noexcept
+    ~ParallelRenderer()
     {
-        return isAnInputToRecursive (possibleInputId, possibleDestinationId, entries.size());
+        for (int i = threads.size(); --i >= 0;)
+            threads.getUnchecked(i)->signalThreadShouldExit();
+
+        if (threads.size() > 0)
+            helpersWanted.signal (threads.size());
+
+        threads.clear();
     }
 
-private:
-    //==============================================================================
-    struct Entry
+    int getNumThreads() const noexcept      { return threads.size() + 1; }
+
+    template <class BufferType>
+    void render (GraphRenderingOps::ParallelRenderingSequence& sequenceToRender,
+                 BufferType& sharedBufferChans,
+                 const OwnedArray<MidiBuffer>& sharedMidiBuffers,
+                 const int numSamples)
     {
-        explicit Entry (const uint32 destNodeId_) noexcept : destNodeId (destNodeId_) {}
+        sequence = &sequenceToRender;
+        sequence->startBlock (sharedBufferChans, sharedMidiBuffers, numSamples);
 
-        const uint32 destNodeId;
-        SortedSet<uint32> srcNodes;
+        // the helpers copy the audio thread's floating point mode, e.g. if it has turned
+        // off denormal support with a ScopedNoDenormals
+        fpStatus = FloatVectorOperations::getFpStatusRegister();
+        blockInProgress = 1;
 
-        JUCE_DECLARE_NON_COPYABLE (Entry)
-    };
+        if (threads.size() > 0)
+            helpersWanted.signal (threads.size());
+
+        sequence->renderUntilFinished();
+        blockInProgress = 0;
 
-    OwnedArray<Entry> entries;
+        // wait for any helpers that are still inside the sequence before it gets reset
+        while (numHelpersActive.get() > 0)
+            Thread::yield();
+    }
 
-    bool isAnInputToRecursive (const uint32 possibleInputId,
-                               const uint32 possibleDestinationId,
-                               int recursionCheck) const noexcept
+private:
+    //==============================================================================
+    class RenderingThread  : public Thread
     {
-        int index;
+    public:
+        RenderingThread (ParallelRenderer& owner_)
+            : Thread ("Audio graph renderer"), owner (owner_)
+        {}
 
-        if (const Entry* const entry = findEntry (possibleDestinationId, index))
+        ~RenderingThread()
         {
-            const SortedSet<uint32>& srcNodes = entry->srcNodes;
-
-            if (srcNodes.contains (possibleInputId))
-                return true;
+            stopThread (4000);
+        }
 
-            if (--recursionCheck >= 0)
+        void run()
+        {
+            for (;;)
             {
-                for (int i = 0; i < srcNodes.size(); ++i)
-                    if (isAnInputToRecursive (possibleInputId, srcNodes.getUnchecked(i), recursionCheck))
-                        return true;
+                owner.helpersWanted.wait();
+
+                if (threadShouldExit())
+                    break;
+
+                owner.helpWithCurrentBlock();
             }
         }
 
-        return false;
-    }
+    private:
+        ParallelRenderer& owner;
 
-    Entry* findEntry (const uint32 destNodeId, int& insertIndex) const noexcept
-    {
-        Entry* result = nullptr;
+        JUCE_DECLARE_NON_COPYABLE (RenderingThread)
+    };
 
-        int start = 0;
-        int end = entries.size();
+    OwnedArray<RenderingThread> threads;
+    GraphRenderingOps::ParallelRenderingSequence* sequence;
+    pointer_sized_int fpStatus;
+    Atomic<int> blockInProgress, numHelpersActive;
+    LightweightSemaphore helpersWanted;
 
-        for (;;)
-        {
-            if (start >= end)
-            {
-                break;
-            }
-            else if (destNodeId == entries.getUnchecked (start)->destNodeId)
-            {
-                result = entries.getUnchecked (start);
-                break;
-            }
-            else
-            {
-                const int halfway = (start + end) / 2;
+    void helpWithCurrentBlock() noexcept
+    {
+        ++numHelpersActive;
 
-                if (halfway == start)
-                {
-                    if (destNodeId >= entries.getUnchecked (halfway)->destNodeId)
-                        ++start;
+        if (blockInProgress.get() != 0)
+        {
+            if (FloatVectorOperations::getFpStatusRegister() != fpStatus)
+                FloatVectorOperations::setFpStatusRegister (fpStatus);
 
-                    break;
-                }
-                else if (destNodeId >= entries.getUnchecked (halfway)->destNodeId)
-                    start = halfway;
-                else
-                    end = halfway;
-            }
+            sequence->renderUntilFinished();
         }
 
-        insertIndex = start;
-        return result;
+        --numHelpersActive;
     }
 
-    JUCE_DECLARE_NON_COPYABLE (ConnectionLookupTable)
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ParallelRenderer)
 };
 
 //==============================================================================
-struct ConnectionSorter
+static void deleteRenderOpArray (Array<void*>& ops)
 {
-    static int compareElements (const AudioProcessorGraph::Connection* const first,
-                                const AudioProcessorGraph::Connection* const second) noexcept
+    for (int i = ops.size(); --i >= 0;)
+        delete static_cast<GraphRenderingOps::AudioGraphRenderingOp*> (ops.getUnchecked(i));
+}
+
+/*  Everything that the audio thread needs in order to render the graph: the ops, and
+    the buffers that they share. A new one of these is built on the message thread each
+    time the graph changes, and is handed over to the audio thread without any locking.
+*/
+class AudioProcessorGraph::RenderSequence
+{
+public:
+    RenderSequence()
+        : delayLines (nullptr), renderingBuffers (1, 1), doubleRenderingBuffers (1, 1)
     {
-        if (first->sourceNodeId < second->sourceNodeId)                return -1;
-        if (first->sourceNodeId > second->sourceNodeId)                return 1;
-        if (first->destNodeId < second->destNodeId)                    return -1;
-        if (first->destNodeId > second->destNodeId)                    return 1;
-        if (first->sourceChannelIndex < second->sourceChannelIndex)    return -1;
-        if (first->sourceChannelIndex > second->sourceChannelIndex)    return 1;
-        if (first->destChannelIndex < second->destChannelIndex)        return -1;
-        if (first->destChannelIndex > second->destChannelIndex)        return 1;
+    }
 
-        return 0;
+    ~RenderSequence()
+    {
+        parallelSequence = nullptr;
+        deleteRenderOpArray (ops);
     }
+
+    AudioSampleBuffer& getSharedBuffers (AudioSampleBuffer&) noexcept               { return renderingBuffers; }
+    DoubleAudioSampleBuffer& getSharedBuffers (DoubleAudioSampleBuffer&) noexcept   { return doubleRenderingBuffers; }
+
+    Array<void*> ops;
+    GraphRenderingOps::ChannelSilence silence;
+    GraphRenderingOps::DelayLinePool* delayLines;
+    ScopedPointer<GraphRenderingOps::ParallelRenderingSequence> parallelSequence;
+    AudioSampleBuffer renderingBuffers;
+    DoubleAudioSampleBuffer doubleRenderingBuffers;
+    OwnedArray<MidiBuffer> midiBuffers;
+
+private:
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (RenderSequence)
 };
 
-}
+/*  Deletes sequences that the audio thread has finished with, on the message thread. */
+class AudioProcessorGraph::SequenceReleaser  : public AsyncUpdater
+{
+public:
+    SequenceReleaser (AudioProcessorGraph& graph_) : graph (graph_) {}
+
+    void handleAsyncUpdate()
+    {
+        graph.deleteRetiredSequence();
+    }
+
+private:
+    AudioProcessorGraph& graph;
+
+    JUCE_DECLARE_NON_COPYABLE (SequenceReleaser)
+};
 
 //==============================================================================
 AudioProcessorGraph::Connection::Connection (const uint32 sourceNodeId_, const int sourceChannelIndex_,
@@ -883,14 +1960,19 @@ AudioProcessorGraph::Connection::Connection (const uint32 sourceNodeId_, const i
 AudioProcessorGraph::Node::Node (const uint32 nodeId_, AudioProcessor* const processor_) noexcept
     : nodeId (nodeId_),
       processor (processor_),
-      isPrepared (false)
+      isPrepared (false),
+      renderIndex (-1)
 {
     jassert (processor != nullptr);
 }
 
 void AudioProcessorGraph::Node::prepare (const double sampleRate, const int blockSize,
-                                         AudioProcessorGraph* const graph)
+                                         AudioProcessorGraph* const graph,
+                                         const ProcessingPrecision precision)
 {
+    // (an offline render should be offline all the way down, including nested graphs)
+    processor->setNonRealtime (graph->isNonRealtime());
+
     if (! isPrepared)
     {
         isPrepared = true;
@@ -900,6 +1982,10 @@ void AudioProcessorGraph::Node::prepare (const double sampleRate, const int bloc
                                          processor->getNumOutputChannels(),
                                          sampleRate, blockSize);
 
+        // nodes that can't work in double precision get their data converted by the graph
+        processor->setProcessingPrecision (precision == doublePrecision && processor->supportsDoublePrecisionProcessing()
+                                                ? doublePrecision : singlePrecision);
+
         processor->prepareToPlay (sampleRate, blockSize);
     }
 }
@@ -923,15 +2009,23 @@ void AudioProcessorGraph::Node::setParentGraph (AudioProcessorGraph* const graph
 //==============================================================================
 AudioProcessorGraph::AudioProcessorGraph()
     : lastNodeId (0),
-      renderingBuffers (1, 1),
+      renderOrderHasFeedback (false),
       currentAudioInputBuffer (nullptr),
       currentAudioOutputBuffer (1, 1),
-      currentMidiInputBuffer (nullptr)
+      currentDoubleAudioInputBuffer (nullptr),
+      currentDoubleAudioOutputBuffer (1, 1),
+      currentMidiInputBuffer (nullptr),
+      profiler (nullptr),
+      currentSequence (nullptr),
+      pendingSequence (nullptr),
+      retiredSequence (nullptr)
 {
+    sequenceReleaser = new SequenceReleaser (*this);
 }
 
 AudioProcessorGraph::~AudioProcessorGraph()
 {
+    parallelRenderer = nullptr;
     clearRenderingSequence();
     clear();
 }
@@ -946,6 +2040,8 @@ void AudioProcessorGraph::clear()
 {
     nodes.clear();
     connections.clear();
+    renderOrder.clear();
+    renderOrderHasFeedback = false;
     triggerAsyncUpdate();
 }
 
@@ -993,6 +2089,9 @@ AudioProcessorGraph::Node* AudioProcessorGraph::addNode (AudioProcessor* const n
 
     Node* const n = new Node (nodeId, newProcessor);
     nodes.add (n);
+
+    n->renderIndex = renderOrder.size();
+    renderOrder.add (n);
     triggerAsyncUpdate();
 
     n->setParentGraph (this);
@@ -1007,7 +2106,13 @@ bool AudioProcessorGraph::removeNode (const uint32 nodeId)
     {
         if (nodes.getUnchecked(i)->nodeId == nodeId)
         {
-            nodes.getUnchecked(i)->setParentGraph (nullptr);
+            Node* const n = nodes.getUnchecked(i);
+            renderOrder.remove (n->renderIndex);
+
+            for (int j = n->renderIndex; j < renderOrder.size(); ++j)
+                renderOrder.getUnchecked (j)->renderIndex = j;
+
+            n->setParentGraph (nullptr);
             nodes.remove (i);
             triggerAsyncUpdate();
 
@@ -1086,6 +2191,10 @@ bool AudioProcessorGraph::addConnection (const uint32 sourceNodeId,
     GraphRenderingOps::ConnectionSorter sorter;
     connections.addSorted (sorter, new Connection (sourceNodeId, sourceChannelIndex,
                                                    destNodeId, destChannelIndex));
+
+    if (! moveDownstreamNodesAfter (getNodeForId (sourceNodeId), getNodeForId (destNodeId)))
+        renderOrderHasFeedback = true;
+
     triggerAsyncUpdate();
     return true;
 }
@@ -1168,22 +2277,93 @@ bool AudioProcessorGraph::removeIllegalConnections()
 }
 
 //==============================================================================
-static void deleteRenderOpArray (Array<void*>& ops)
+void AudioProcessorGraph::clearRenderingSequence()
 {
-    for (int i = ops.size(); --i >= 0;)
-        delete static_cast<GraphRenderingOps::AudioGraphRenderingOp*> (ops.getUnchecked(i));
+    RenderSequence* oldSequence;
+
+    {
+        const ScopedLock sl (getCallbackLock());
+        oldSequence = currentSequence;
+        currentSequence = nullptr;
+    }
+
+    delete oldSequence;
+    delete pendingSequence.exchange (nullptr);
+    deleteRetiredSequence();
 }
 
-void AudioProcessorGraph::clearRenderingSequence()
+void AudioProcessorGraph::publishSequence (RenderSequence* const newSequence)
 {
-    Array<void*> oldOps;
+    deleteRetiredSequence();
 
+    // (if the audio thread never picked up the previous one, it can be thrown away)
+    delete pendingSequence.exchange (newSequence);
+}
+
+AudioProcessorGraph::RenderSequence* AudioProcessorGraph::takeNewSequenceIfAvailable() noexcept
+{
+    // a new sequence can only be taken once the last one to be retired has been deleted
+    if (pendingSequence.get() != nullptr && retiredSequence.get() == nullptr)
     {
-        const ScopedLock sl (getCallbackLock());
-        renderingOps.swapWithArray (oldOps);
+        if (RenderSequence* const newSequence = pendingSequence.exchange (nullptr))
+        {
+            if (currentSequence != nullptr)
+            {
+                retiredSequence = currentSequence;
+                sequenceReleaser->triggerAsyncUpdate();
+            }
+
+            currentSequence = newSequence;
+        }
+    }
+
+    return currentSequence;
+}
+
+void AudioProcessorGraph::deleteRetiredSequence()
+{
+    delete retiredSequence.exchange (nullptr);
+}
+
+void AudioProcessorGraph::setNumRenderingThreads (int numThreads)
+{
+    // the threads spin while they wait for each other, so there's no point in having more than one per core
+    numThreads = jlimit (1, jmax (1, SystemStats::getNumCpus()), numThreads);
+
+    if (numThreads != getNumRenderingThreads())
+    {
+        ScopedPointer<ParallelRenderer> newRenderer;
+
+        if (numThreads > 1)
+            newRenderer = new ParallelRenderer (numThreads, getSampleRate() > 0 ? getBlockSize() * 1000.0 / getSampleRate()
+                                                                                : 0.0);
+
+        {
+            const ScopedLock sl (getCallbackLock());
+            parallelRenderer.swapWith (newRenderer);
+        }
+
+        // the sequence needs rebuilding to include (or drop) the data for the parallel renderer
+        buildRenderingSequence();
     }
+}
+
+int AudioProcessorGraph::getNumRenderingThreads() const noexcept
+{
+    return parallelRenderer != nullptr ? parallelRenderer->getNumThreads() : 1;
+}
 
-    deleteRenderOpArray (oldOps);
+void AudioProcessorGraph::setProfiler (AudioCallbackProfiler* const newProfiler)
+{
+    const ScopedLock sl (getCallbackLock());
+    profiler = newProfiler;
+}
+
+//==============================================================================
+AudioProcessorGraph::RenderingStatistics::RenderingStatistics() noexcept
+    : numAudioBuffers (0), numMidiBuffers (0), numChannelCopiesPerBlock (0),
+      numBytesCopiedPerBlock (0), numAudioBufferBytes (0)
+{
 }
 
 bool AudioProcessorGraph::isAnInputTo (const uint32 possibleInputId,
@@ -1206,59 +2386,183 @@ bool AudioProcessorGraph::isAnInputTo (const uint32 possibleInputId,
     return false;
 }
 
+//==============================================================================
+/*  The nodes are kept in an order where every node comes after all of its sources, which
+    is the order in which they get rendered. After a new connection is added, only the
+    part of the order between its dest and source nodes has to be looked at: any nodes in
+    there which are downstream of the dest get moved to just after the source.
+
+    Returns false if the connection forms a feedback loop, in which case the order
+    is left as it is.
+*/
+bool AudioProcessorGraph::moveDownstreamNodesAfter (Node* const source, Node* const dest)
+{
+    jassert (source != nullptr && dest != nullptr);
+
+    const int start = dest->renderIndex;
+    const int end = source->renderIndex;
+
+    if (start > end)
+        return true;
+
+    HashMap<int, Node*> nodesInRange;
+
+    for (int i = start; i <= end; ++i)
+        nodesInRange.set ((int) renderOrder.getUnchecked (i)->nodeId, renderOrder.getUnchecked (i));
+
+    Array<bool> isDownstream;
+    isDownstream.insertMultiple (0, false, end - start + 1);
+    isDownstream.set (0, true);
+
+    Array<Node*> nodesToVisit;
+    nodesToVisit.add (dest);
+
+    while (nodesToVisit.size() > 0)
+    {
+        const Node* const n = nodesToVisit.getLast();
+        nodesToVisit.removeLast();
+
+        // (the connections are sorted by source, so each node's outputs are all together)
+        for (int i = findFirstConnectionFrom (n->nodeId); i < connections.size(); ++i)
+        {
+            const Connection* const c = connections.getUnchecked (i);
+
+            if (c->sourceNodeId != n->nodeId)
+                break;
+
+            if (nodesInRange.contains ((int) c->destNodeId))
+            {
+                Node* const downstreamNode = nodesInRange [(int) c->destNodeId];
+
+                if (downstreamNode == source)
+                    return false;
+
+                if (! isDownstream.getUnchecked (downstreamNode->renderIndex - start))
+                {
+                    isDownstream.set (downstreamNode->renderIndex - start, true);
+                    nodesToVisit.add (downstreamNode);
+                }
+            }
+        }
+    }
+
+    Array<Node*> reordered;
+
+    for (int pass = 0; pass < 2; ++pass)
+        for (int i = start; i <= end; ++i)
+            if (isDownstream.getUnchecked (i - start) == (pass == 1))
+                reordered.add (renderOrder.getUnchecked (i));
+
+    for (int i = start; i <= end; ++i)
+    {
+        Node* const n = reordered.getUnchecked (i - start);
+        n->renderIndex = i;
+        renderOrder.set (i, n);
+    }
+
+    return true;
+}
+
+int AudioProcessorGraph::findFirstConnectionFrom (const uint32 sourceNodeId) const noexcept
+{
+    int start = 0, end = connections.size();
+
+    while (start < end)
+    {
+        const int halfway = (start + end) / 2;
+
+        if (connections.getUnchecked (halfway)->sourceNodeId < sourceNodeId)
+            start = halfway + 1;
+        else
+            end = halfway;
+    }
+
+    return start;
+}
+
+void AudioProcessorGraph::sortFeedbackConnections()
+{
+    // if any connections were added that formed loops, they might not any more..
+    if (renderOrderHasFeedback)
+    {
+        renderOrderHasFeedback = false;
+
+        HashMap<int, Node*> nodesById;
+
+        for (int i = nodes.size(); --i >= 0;)
+            nodesById.set ((int) nodes.getUnchecked(i)->nodeId, nodes.getUnchecked(i));
+
+        for (int i = 0; i < connections.size(); ++i)
+        {
+            const Connection* const c = connections.getUnchecked (i);
+            Node* const source = nodesById [(int) c->sourceNodeId];
+            Node* const dest = nodesById [(int) c->destNodeId];
+
+            if (source != nullptr && dest != nullptr
+                 && source->renderIndex > dest->renderIndex
+                 && ! moveDownstreamNodesAfter (source, dest))
+                renderOrderHasFeedback = true;
+        }
+    }
+}
+
 void AudioProcessorGraph::buildRenderingSequence()
 {
-    Array<void*> newRenderingOps;
+    ScopedPointer<RenderSequence> newSequence (new RenderSequence());
     int numRenderingBuffersNeeded = 2;
     int numMidiBuffersNeeded = 1;
+    int numChannelCopies = 0;
 
     {
         MessageManagerLock mml;
 
+        sortFeedbackConnections();
+
         Array<void*> orderedNodes;
 
+        for (int i = 0; i < renderOrder.size(); ++i)
         {
-            const GraphRenderingOps::ConnectionLookupTable table (connections);
-
-            for (int i = 0; i < nodes.size(); ++i)
-            {
-                Node* const node = nodes.getUnchecked(i);
-
-                node->prepare (getSampleRate(), getBlockSize(), this);
-
-                int j = 0;
-                for (; j < orderedNodes.size(); ++j)
-                    if (table.isAnInputTo (node->nodeId, ((Node*) orderedNodes.getUnchecked(j))->nodeId))
-                      break;
-
-                orderedNodes.insert (j, node);
-            }
+            Node* const node = renderOrder.getUnchecked(i);
+            node->prepare (getSampleRate(), getBlockSize(), this, getProcessingPrecision());
+            orderedNodes.add (node);
         }
 
-        GraphRenderingOps::RenderingOpSequenceCalculator calculator (*this, orderedNodes, newRenderingOps);
+        GraphRenderingOps::RenderingOpSequenceCalculator calculator (*this, orderedNodes, newSequence->ops, newSequence->silence);
 
         numRenderingBuffersNeeded = calculator.getNumBuffersNeeded();
         numMidiBuffersNeeded = calculator.getNumMidiBuffersNeeded();
+        numChannelCopies = calculator.getNumChannelCopies();
+        newSequence->delayLines = calculator.getDelayLinePool();
     }
 
-    {
-        // swap over to the new rendering sequence..
-        const ScopedLock sl (getCallbackLock());
+    if (parallelRenderer != nullptr)
+        newSequence->parallelSequence = new GraphRenderingOps::ParallelRenderingSequence (newSequence->ops);
 
-        renderingBuffers.setSize (numRenderingBuffersNeeded, getBlockSize());
-        renderingBuffers.clear();
+    if (isUsingDoublePrecision())
+    {
+        newSequence->doubleRenderingBuffers.setSize (numRenderingBuffersNeeded, getBlockSize());
+        newSequence->doubleRenderingBuffers.clear();
+    }
+    else
+    {
+        newSequence->renderingBuffers.setSize (numRenderingBuffersNeeded, getBlockSize());
+        newSequence->renderingBuffers.clear();
+    }
 
-        for (int i = midiBuffers.size(); --i >= 0;)
-            midiBuffers.getUnchecked(i)->clear();
+    newSequence->silence.setNumChannels (numRenderingBuffersNeeded);
 
-        while (midiBuffers.size() < numMidiBuffersNeeded)
-            midiBuffers.add (new MidiBuffer());
+    while (newSequence->midiBuffers.size() < numMidiBuffersNeeded)
+        newSequence->midiBuffers.add (new MidiBuffer());
 
-        renderingOps.swapWithArray (newRenderingOps);
-    }
+    // the audio thread will swap over to the new sequence at the start of its next block..
+    publishSequence (newSequence.release());
 
-    // delete the old ones..
-    deleteRenderOpArray (newRenderingOps);
+    const int64 bytesPerChannel = getBlockSize() * (int64) (isUsingDoublePrecision() ? sizeof (double) : sizeof (float));
+    renderingStatistics.numAudioBuffers = numRenderingBuffersNeeded;
+    renderingStatistics.numMidiBuffers = numMidiBuffersNeeded;
+    renderingStatistics.numChannelCopiesPerBlock = numChannelCopies;
+    renderingStatistics.numBytesCopiedPerBlock = numChannelCopies * bytesPerChannel;
+    renderingStatistics.numAudioBufferBytes = numRenderingBuffersNeeded * bytesPerChannel;
 }
 
 void AudioProcessorGraph::handleAsyncUpdate()
@@ -1270,7 +2574,19 @@ void AudioProcessorGraph::handleAsyncUpdate()
 void AudioProcessorGraph::prepareToPlay (double /*sampleRate*/, int estimatedSamplesPerBlock)
 {
     currentAudioInputBuffer = nullptr;
-    currentAudioOutputBuffer.setSize (jmax (1, getNumOutputChannels()), estimatedSamplesPerBlock);
+    currentDoubleAudioInputBuffer = nullptr;
+
+    if (isUsingDoublePrecision())
+    {
+        currentDoubleAudioOutputBuffer.setSize (jmax (1, getNumOutputChannels()), estimatedSamplesPerBlock);
+        currentAudioOutputBuffer.setSize (1, 1);
+    }
+    else
+    {
+        currentAudioOutputBuffer.setSize (jmax (1, getNumOutputChannels()), estimatedSamplesPerBlock);
+        currentDoubleAudioOutputBuffer.setSize (1, 1);
+    }
+
     currentMidiInputBuffer = nullptr;
     currentMidiOutputBuffer.clear();
 
@@ -1280,14 +2596,15 @@ void AudioProcessorGraph::prepareToPlay (double /*sampleRate*/, int estimatedSam
 
 void AudioProcessorGraph::releaseResources()
 {
+    clearRenderingSequence();
+
     for (int i = 0; i < nodes.size(); ++i)
         nodes.getUnchecked(i)->unprepare();
 
-    renderingBuffers.setSize (1, 1);
-    midiBuffers.clear();
-
     currentAudioInputBuffer = nullptr;
     currentAudioOutputBuffer.setSize (1, 1);
+    currentDoubleAudioInputBuffer = nullptr;
+    currentDoubleAudioOutputBuffer.setSize (1, 1);
     currentMidiInputBuffer = nullptr;
     currentMidiOutputBuffer.clear();
 }
@@ -1302,24 +2619,69 @@ void AudioProcessorGraph::reset()
 
 void AudioProcessorGraph::processBlock (AudioSampleBuffer& buffer, MidiBuffer& midiMessages)
 {
+    // once the graph has been prepared in double precision, it must be called in double precision..
+    jassert (! isUsingDoublePrecision());
+
+    processAudio (buffer, midiMessages, currentAudioInputBuffer, currentAudioOutputBuffer);
+}
+
+void AudioProcessorGraph::processBlock (DoubleAudioSampleBuffer& buffer, MidiBuffer& midiMessages)
+{
+    if (isUsingDoublePrecision())
+        processAudio (buffer, midiMessages, currentDoubleAudioInputBuffer, currentDoubleAudioOutputBuffer);
+    else
+        AudioProcessor::processBlock (buffer, midiMessages);
+}
+
+bool AudioProcessorGraph::supportsDoublePrecisionProcessing() const
+{
+    return true;
+}
+
+template <class BufferType>
+void AudioProcessorGraph::processAudio (BufferType& buffer, MidiBuffer& midiMessages,
+                                        BufferType*& currentInputBuffer, BufferType& currentOutputBuffer)
+{
+    JUCE_TRACE_SCOPE ("AudioProcessorGraph");
     const int numSamples = buffer.getNumSamples();
 
-    currentAudioInputBuffer = &buffer;
-    currentAudioOutputBuffer.setSize (jmax (1, buffer.getNumChannels()), numSamples);
-    currentAudioOutputBuffer.clear();
+    currentInputBuffer = &buffer;
+    currentOutputBuffer.setSize (jmax (1, buffer.getNumChannels()), numSamples);
+    currentOutputBuffer.clear();
     currentMidiInputBuffer = &midiMessages;
     currentMidiOutputBuffer.clear();
 
-    for (int i = 0; i < renderingOps.size(); ++i)
+    if (RenderSequence* const sequence = takeNewSequenceIfAvailable())
     {
-        GraphRenderingOps::AudioGraphRenderingOp* const op
-            = (GraphRenderingOps::AudioGraphRenderingOp*) renderingOps.getUnchecked(i);
+        BufferType& sharedBufferChans = sequence->getSharedBuffers (buffer);
+
+        if (parallelRenderer != nullptr && sequence->parallelSequence != nullptr)
+        {
+            parallelRenderer->render (*sequence->parallelSequence, sharedBufferChans, sequence->midiBuffers, numSamples);
+        }
+        else
+        {
+            for (int i = 0; i < sequence->ops.size(); ++i)
+            {
+                GraphRenderingOps::AudioGraphRenderingOp* const op
+                    = (GraphRenderingOps::AudioGraphRenderingOp*) sequence->ops.getUnchecked(i);
+
+                op->perform (sharedBufferChans, sequence->midiBuffers, numSamples);
+            }
+        }
+
+        if (sequence->delayLines != nullptr)
+        {
+            // keep up with any changes to the nodes' latencies..
+            if (sequence->delayLines->needsRebuilding())
+                triggerAsyncUpdate();
 
-        op->perform (renderingBuffers, midiBuffers, numSamples);
+            setLatencySamples (sequence->delayLines->getTotalLatency());
+        }
     }
 
     for (int i = 0; i < buffer.getNumChannels(); ++i)
-        buffer.copyFrom (i, 0, currentAudioOutputBuffer, i, 0, numSamples);
+        buffer.copyFrom (i, 0, currentOutputBuffer, i, 0, numSamples);
 
     midiMessages.clear();
     midiMessages.addEvents (currentMidiOutputBuffer, 0, buffer.getNumSamples(), 0);
@@ -1402,15 +2764,34 @@ void AudioProcessorGraph::AudioGraphIOProcessor::processBlock (AudioSampleBuffer
                                                                MidiBuffer& midiMessages)
 {
     jassert (graph != nullptr);
+    processAudio (buffer, midiMessages, graph->currentAudioInputBuffer, graph->currentAudioOutputBuffer);
+}
+
+void AudioProcessorGraph::AudioGraphIOProcessor::processBlock (DoubleAudioSampleBuffer& buffer,
+                                                               MidiBuffer& midiMessages)
+{
+    jassert (graph != nullptr);
+    processAudio (buffer, midiMessages, graph->currentDoubleAudioInputBuffer, graph->currentDoubleAudioOutputBuffer);
+}
+
+bool AudioProcessorGraph::AudioGraphIOProcessor::supportsDoublePrecisionProcessing() const
+{
+    return true;
+}
 
+template <class BufferType>
+void AudioProcessorGraph::AudioGraphIOProcessor::processAudio (BufferType& buffer, MidiBuffer& midiMessages,
+                                                               BufferType* const graphInputBuffer,
+                                                               BufferType& graphOutputBuffer)
+{
     switch (type)
     {
         case audioOutputNode:
         {
-            for (int i = jmin (graph->currentAudioOutputBuffer.getNumChannels(),
+            for (int i = jmin (graphOutputBuffer.getNumChannels(),
                                buffer.getNumChannels()); --i >= 0;)
             {
-                graph->currentAudioOutputBuffer.addFrom (i, 0, buffer, i, 0, buffer.getNumSamples());
+                graphOutputBuffer.addFrom (i, 0, buffer, i, 0, buffer.getNumSamples());
             }
 
             break;
@@ -1418,10 +2799,10 @@ void AudioProcessorGraph::AudioGraphIOProcessor::processBlock (AudioSampleBuffer
 
         case audioInputNode:
         {
-            for (int i = jmin (graph->currentAudioInputBuffer->getNumChannels(),
+            for (int i = jmin (graphInputBuffer->getNumChannels(),
                                buffer.getNumChannels()); --i >= 0;)
             {
-                buffer.copyFrom (i, 0, *graph->currentAudioInputBuffer, i, 0, buffer.getNumSamples());
+                buffer.copyFrom (i, 0, *graphInputBuffer, i, 0, buffer.getNumSamples());
             }
 
             break;
@@ -43,6 +43,16 @@
 
     To play back a graph through an audio device, you might want to use an
     AudioProcessorPlayer object.
+
+    A graph can run in double precision (see AudioProcessor::setProcessingPrecision()),
+    in which case its shared buffers hold doubles, and any nodes that support double
+    precision are run in it directly. Nodes that don't are given a single-precision
+    copy of their data to work on.
+
+    While it renders, the graph keeps track of which of its buffers are silent, so that
+    it doesn't waste time mixing them. Nodes whose processors return true from
+    silenceInProducesSilenceOut() are put to sleep when their inputs have been silent
+    for longer than their tail, so an idle node costs almost nothing.
 */
 class JUCE_API  AudioProcessorGraph   : public AudioProcessor,
                                         private AsyncUpdater
@@ -92,11 +102,12 @@ public:
 
         const ScopedPointer<AudioProcessor> processor;
         bool isPrepared;
+        int renderIndex;
 
         Node (uint32 nodeId, AudioProcessor*) noexcept;
 
         void setParentGraph (AudioProcessorGraph*) const;
-        void prepare (double sampleRate, int blockSize, AudioProcessorGraph*);
+        void prepare (double sampleRate, int blockSize, AudioProcessorGraph*, ProcessingPrecision);
         void unprepare();
 
         JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Node)
@@ -255,6 +266,80 @@ public:
     */
     static const int midiChannelIndex;
 
+    //==============================================================================
+    /** Sets the number of threads that the graph should use to render its nodes.
+
+        By default the graph renders all of its nodes in sequence on the audio thread.
+        If you set a number greater than 1 here, the graph will work out which of its
+        rendering operations are independent of each other, and will spread them across
+        a set of worker threads, with the audio thread doing its share of the work too.
+        processBlock() still waits for all of the work to finish before it returns, and
+        the results are identical to those of the single-threaded renderer.
+
+        The number of threads is limited to the number of CPU cores in the machine.
+        Bear in mind that when this is enabled, the processBlock() methods of the nodes
+        may be called on threads other than the audio callback thread.
+    */
+    void setNumRenderingThreads (int numThreads);
+
+    /** Returns the number of threads that the graph uses for rendering.
+        @see setNumRenderingThreads
+    */
+    int getNumRenderingThreads() const noexcept;
+
+    //==============================================================================
+    /** Some information about the rendering sequence that the graph is currently using.
+        @see getRenderingStatistics
+    */
+    struct RenderingStatistics
+    {
+        RenderingStatistics() noexcept;
+
+        /** The number of audio channel buffers that the graph shares between its nodes. */
+        int numAudioBuffers;
+
+        /** The number of midi buffers that the graph shares between its nodes. */
+        int numMidiBuffers;
+
+        /** The number of audio channels that get copied from one buffer to another
+            in each block, because their data is needed by more than one node.
+        */
+        int numChannelCopiesPerBlock;
+
+        /** The number of bytes of audio that those copies move in each block, at the
+            graph's current block size and precision.
+        */
+        int64 numBytesCopiedPerBlock;
+
+        /** The number of bytes of memory used by the shared audio buffers. */
+        int64 numAudioBufferBytes;
+    };
+
+    /** Returns some information about the graph's current rendering sequence.
+        This is updated each time the graph rebuilds its sequence, e.g. after nodes or
+        connections have been changed, or prepareToPlay() has been called.
+    */
+    const RenderingStatistics& getRenderingStatistics() const noexcept     { return renderingStatistics; }
+
+    //==============================================================================
+    /** Gives the graph a profiler to record how long each of its nodes takes to process.
+
+        While a profiler is set, each node's processBlock() call adds a graphNode event to it,
+        whose id is the node's ID.
+
+        The graph doesn't delete the profiler, so the caller must keep it alive until it has
+        been removed by calling this method with a nullptr. This method takes the graph's
+        callback lock, so if whatever is playing the graph also holds that lock while it
+        calls processBlock() (as AudioProcessorPlayer does), the old profiler won't be used
+        again once this returns.
+
+        @see AudioCallbackProfiler
+    */
+    void setProfiler (AudioCallbackProfiler* newProfiler);
+
+    /** Returns the profiler that was set with setProfiler(), if there is one. */
+    AudioCallbackProfiler* getProfiler() const noexcept                     { return profiler; }
+
 
     //==============================================================================
     /** A special type of AudioProcessor that can live inside an AudioProcessorGraph
@@ -314,6 +399,8 @@ public:
         void prepareToPlay (double sampleRate, int estimatedSamplesPerBlock);
         void releaseResources();
         void processBlock (AudioSampleBuffer&, MidiBuffer&);
+        void processBlock (DoubleAudioSampleBuffer&, MidiBuffer&);
+        bool supportsDoublePrecisionProcessing() const;
 
         const String getInputChannelName (int channelIndex) const;
         const String getOutputChannelName (int channelIndex) const;
@@ -349,6 +436,9 @@ public:
         const IODeviceType type;
         AudioProcessorGraph* graph;
 
+        template <class BufferType>
+        void processAudio (BufferType&, MidiBuffer&, BufferType* graphInputBuffer, BufferType& graphOutputBuffer);
+
         JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioGraphIOProcessor)
     };
 
@@ -360,6 +450,8 @@ public:
     void prepareToPlay (double sampleRate, int estimatedSamplesPerBlock);
     void releaseResources();
     void processBlock (AudioSampleBuffer&, MidiBuffer&);
+    void processBlock (DoubleAudioSampleBuffer&, MidiBuffer&);
+    bool supportsDoublePrecisionProcessing() const;
     void reset();
 
     const String getInputChannelName (int channelIndex) const;
@@ -395,21 +487,46 @@ private:
     ReferenceCountedArray <Node> nodes;
     OwnedArray <Connection> connections;
     uint32 lastNodeId;
-    AudioSampleBuffer renderingBuffers;
-    OwnedArray <MidiBuffer> midiBuffers;
-    Array<void*> renderingOps;
+    Array<Node*> renderOrder;
+    bool renderOrderHasFeedback;
 
     friend class AudioGraphIOProcessor;
     AudioSampleBuffer* currentAudioInputBuffer;
     AudioSampleBuffer currentAudioOutputBuffer;
+    DoubleAudioSampleBuffer* currentDoubleAudioInputBuffer;
+    DoubleAudioSampleBuffer currentDoubleAudioOutputBuffer;
     MidiBuffer* currentMidiInputBuffer;
     MidiBuffer currentMidiOutputBuffer;
 
+    class ParallelRenderer;
+    friend class ParallelRenderer;
+    friend class ScopedPointer<ParallelRenderer>;
+    ScopedPointer<ParallelRenderer> parallelRenderer;
+    RenderingStatistics renderingStatistics;
+    AudioCallbackProfiler* volatile profiler;
+
+    class RenderSequence;
+    class SequenceReleaser;
+    friend class SequenceReleaser;
+    friend class ScopedPointer<SequenceReleaser>;
+    RenderSequence* currentSequence;
+    Atomic<RenderSequence*> pendingSequence, retiredSequence;
+    ScopedPointer<SequenceReleaser> sequenceReleaser;
+
     void handleAsyncUpdate();
     void clearRenderingSequence();
     void buildRenderingSequence();
+    void publishSequence (RenderSequence*);
+    RenderSequence* takeNewSequenceIfAvailable() noexcept;
+    void deleteRetiredSequence();
+    bool moveDownstreamNodesAfter (Node* source, Node* dest);
+    int findFirstConnectionFrom (uint32 sourceNodeId) const noexcept;
+    void sortFeedbackConnections();
     bool isAnInputTo (uint32 possibleInputId, uint32 possibleDestinationId, int recursionCheck) const;
 
+    template <class BufferType>
+    void processAudio (BufferType&, MidiBuffer&, BufferType*& currentInputBuffer, BufferType& currentOutputBuffer);
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioProcessorGraph)
 };
 
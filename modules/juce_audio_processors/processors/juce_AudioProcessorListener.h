@@ -49,13 +49,29 @@ public:
         many audio processors will change their parameter during their audio callback.
         This means that not only has your handler code got to be completely thread-safe,
         but it's also got to be VERY fast, and avoid blocking. If you need to handle
-        this event on your message thread, use this callback to trigger an AsyncUpdater
-        or ChangeBroadcaster which you can respond to on the message thread.
+        this event on your message thread, you can make receivesParameterChangesOnMessageThread()
+        return true, or use this callback to trigger an AsyncUpdater or ChangeBroadcaster
+        which you can respond to on the message thread.
     */
     virtual void audioProcessorParameterChanged (AudioProcessor* processor,
                                                  int parameterIndex,
                                                  float newValue) = 0;
 
+    /** If this returns true, audioProcessorParameterChanged() will be called on the
+        message thread, rather than synchronously by whichever thread changed the parameter.
+
+        The changes are coalesced, so if a parameter changes several times before the
+        message thread gets round to it, there'll be just one callback, with the most
+        recent value. This is the best choice for listeners that only need to update a
+        UI, because it keeps them off the audio thread, and means that a processor
+        with many automated parameters doesn't have to call them for every change.
+
+        The AudioProcessor checks this when the listener is added, so the result mustn't
+        change while the listener is registered. The default implementation returns false.
+        The other callbacks are always made synchronously.
+    */
+    virtual bool receivesParameterChangesOnMessageThread() const        { return false; }
+
     /** Called to indicate that something else in the plugin has changed, like its
         program, number of parameters, etc.
 
@@ -0,0 +1,158 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+
+/*  A low-priority thread that's shared by all the caches that serialise their state
+    in the background. It's created when the first one needs it, and deleted when
+    the last one goes away.
+*/
+class AudioProcessorStateCache::SharedThread
+{
+public:
+    static TimeSliceThread* addUser()
+    {
+        const ScopedLock sl (getLock());
+
+        if (++getNumUsers() == 1)
+        {
+            getInstance() = new TimeSliceThread ("Plugin state serialiser");
+            getInstance()->startThread (2);
+        }
+
+        return getInstance();
+    }
+
+    static void removeUser()
+    {
+        const ScopedLock sl (getLock());
+
+        if (--getNumUsers() == 0)
+            deleteAndZero (getInstance());
+    }
+
+private:
+    static CriticalSection& getLock()       { static CriticalSection lock; return lock; }
+    static int& getNumUsers() noexcept      { static int numUsers = 0; return numUsers; }
+    static TimeSliceThread*& getInstance() noexcept  { static TimeSliceThread* instance = nullptr; return instance; }
+};
+
+//==============================================================================
+AudioProcessorStateCache::AudioProcessorStateCache (AudioProcessor& p)
+    : processor (p), backgroundThread (nullptr), lastVersionSeen (0)
+{
+}
+
+AudioProcessorStateCache::~AudioProcessorStateCache()
+{
+    if (backgroundThread != nullptr)
+    {
+        backgroundThread->removeTimeSliceClient (this);
+        SharedThread::removeUser();
+    }
+}
+
+//==============================================================================
+void AudioProcessorStateCache::getState (juce::MemoryBlock& destData, const bool currentProgramOnly)
+{
+    if (! processor.isStateVersioningEnabled())
+    {
+        destData.setSize (0);
+
+        if (currentProgramOnly)
+            processor.getCurrentProgramStateInformation (destData);
+        else
+            processor.getStateInformation (destData);
+
+        return;
+    }
+
+    if (backgroundThread == nullptr && processor.canSerialiseStateInBackground())
+    {
+        backgroundThread = SharedThread::addUser();
+        backgroundThread->addTimeSliceClient (this, 500);
+    }
+
+    CachedState& state = currentProgramOnly ? programState : fullState;
+
+    const ScopedLock sl (lock);
+    state.wasRequested = true;
+
+    const int version = processor.getStateVersion();
+
+    if (! (state.isValid && state.version == version))
+        refresh (state, currentProgramOnly, version);
+
+    destData = state.data;
+}
+
+void AudioProcessorStateCache::setState (const void* const data, const int sizeInBytes, const bool currentProgramOnly)
+{
+    if (currentProgramOnly)
+        processor.setCurrentProgramStateInformation (data, sizeInBytes);
+    else
+        processor.setStateInformation (data, sizeInBytes);
+
+    processor.markStateAsChanged();
+}
+
+void AudioProcessorStateCache::refresh (CachedState& state, const bool currentProgramOnly, const int version)
+{
+    // (the version must be read before serialising, so that any change that happens
+    // while the processor is writing its state will cause it to be refreshed again)
+    state.data.setSize (0);
+
+    if (currentProgramOnly)
+        processor.getCurrentProgramStateInformation (state.data);
+    else
+        processor.getStateInformation (state.data);
+
+    state.version = version;
+    state.isValid = true;
+}
+
+int AudioProcessorStateCache::useTimeSlice()
+{
+    if (! processor.canSerialiseStateInBackground())
+        return 500;
+
+    const int version = processor.getStateVersion();
+
+    // wait for the state to stop changing before serialising it, so that a stream of
+    // parameter changes doesn't keep the thread permanently busy
+    if (version != lastVersionSeen)
+    {
+        lastVersionSeen = version;
+        return 250;
+    }
+
+    const ScopedLock sl (lock);
+
+    if (fullState.wasRequested && ! (fullState.isValid && fullState.version == version))
+        refresh (fullState, false, version);
+
+    if (programState.wasRequested && ! (programState.isValid && programState.version == version))
+        refresh (programState, true, version);
+
+    return 500;
+}
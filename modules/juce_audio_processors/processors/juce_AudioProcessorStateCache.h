@@ -0,0 +1,105 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+
+#ifndef __JUCE_AUDIOPROCESSORSTATECACHE_JUCEHEADER__
+#define __JUCE_AUDIOPROCESSORSTATECACHE_JUCEHEADER__
+
+#include "juce_AudioProcessor.h"
+
+
+//==============================================================================
+/**
+    Keeps a cached copy of an AudioProcessor's state, for the plugin wrappers to hand
+    to the host.
+
+    If the processor has turned on state versioning with
+    AudioProcessor::setStateVersioningEnabled(), getState() only calls the processor's
+    getStateInformation() methods when its state version has changed since they were
+    last called - otherwise it just returns a copy of the cached data. If the processor
+    also allows background serialisation, a shared background thread refreshes the cached
+    data once the state stops changing, so that the host rarely has to wait for it.
+
+    For processors that don't use versioning, this just calls getStateInformation()
+    every time.
+
+    @see AudioProcessor::setStateVersioningEnabled
+*/
+class JUCE_API  AudioProcessorStateCache  : private TimeSliceClient
+{
+public:
+    //==============================================================================
+    /** Creates a cache for a processor, which must not be deleted before the cache. */
+    explicit AudioProcessorStateCache (AudioProcessor& processor);
+
+    /** Destructor. */
+    ~AudioProcessorStateCache();
+
+    //==============================================================================
+    /** Copies the processor's state into a block of memory.
+
+        @param destData             the block to fill with the state
+        @param currentProgramOnly   if true, this gets the state that the processor's
+                                    getCurrentProgramStateInformation() method returns,
+                                    rather than its getStateInformation() method
+    */
+    void getState (juce::MemoryBlock& destData, bool currentProgramOnly);
+
+    /** Restores the processor's state, and marks the cached copy as out-of-date.
+
+        @param data                 the data to pass to the processor
+        @param sizeInBytes          the number of bytes of data
+        @param currentProgramOnly   if true, this calls the processor's
+                                    setCurrentProgramStateInformation() method rather
+                                    than its setStateInformation() method
+    */
+    void setState (const void* data, int sizeInBytes, bool currentProgramOnly);
+
+private:
+    //==============================================================================
+    struct CachedState
+    {
+        CachedState() noexcept : version (0), isValid (false), wasRequested (false) {}
+
+        juce::MemoryBlock data;
+        int version;
+        bool isValid, wasRequested;
+    };
+
+    class SharedThread;
+
+    AudioProcessor& processor;
+    CachedState fullState, programState;
+    CriticalSection lock;
+    TimeSliceThread* backgroundThread;
+    int lastVersionSeen;
+
+    void refresh (CachedState&, bool currentProgramOnly, int version);
+    int useTimeSlice();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioProcessorStateCache)
+};
+
+
+#endif   // __JUCE_AUDIOPROCESSORSTATECACHE_JUCEHEADER__
@@ -0,0 +1,129 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+ConvolutionAudioProcessor::ConvolutionAudioProcessor()
+{
+    setPlayConfigDetails (2, 2, getSampleRate(), getBlockSize());
+}
+
+ConvolutionAudioProcessor::~ConvolutionAudioProcessor()
+{
+}
+
+const String ConvolutionAudioProcessor::getName() const      { return "Convolution"; }
+
+//==============================================================================
+void ConvolutionAudioProcessor::prepareToPlay (double sampleRate, int)
+{
+    convolution.prepareToPlay (sampleRate, jmax (getNumInputChannels(), getNumOutputChannels()));
+    convolution.reset();
+}
+
+void ConvolutionAudioProcessor::releaseResources()
+{
+}
+
+void ConvolutionAudioProcessor::processBlock (AudioSampleBuffer& buffer, MidiBuffer&)
+{
+    for (int i = getNumInputChannels(); i < getNumOutputChannels(); ++i)
+        buffer.clear (i, 0, buffer.getNumSamples());
+
+    convolution.processSamples (buffer, 0, buffer.getNumSamples());
+}
+
+//==============================================================================
+const String ConvolutionAudioProcessor::getInputChannelName (int channelIndex) const     { return String (channelIndex + 1); }
+const String ConvolutionAudioProcessor::getOutputChannelName (int channelIndex) const    { return String (channelIndex + 1); }
+bool ConvolutionAudioProcessor::isInputChannelStereoPair (int) const                     { return true; }
+bool ConvolutionAudioProcessor::isOutputChannelStereoPair (int) const                    { return true; }
+bool ConvolutionAudioProcessor::silenceInProducesSilenceOut() const                      { return false; }
+double ConvolutionAudioProcessor::getTailLengthSeconds() const                           { return convolution.getImpulseResponseLengthSeconds(); }
+bool ConvolutionAudioProcessor::acceptsMidi() const                                      { return false; }
+bool ConvolutionAudioProcessor::producesMidi() const                                     { return false; }
+
+bool ConvolutionAudioProcessor::hasEditor() const                    { return false; }
+AudioProcessorEditor* ConvolutionAudioProcessor::createEditor()      { return nullptr; }
+
+//==============================================================================
+int ConvolutionAudioProcessor::getNumParameters()                    { return numParameters; }
+
+const String ConvolutionAudioProcessor::getParameterName (int index)
+{
+    switch (index)
+    {
+        case wetLevelParameter:  return "Wet Level";
+        case dryLevelParameter:  return "Dry Level";
+        default:                 return String::empty;
+    }
+}
+
+float ConvolutionAudioProcessor::getParameter (int index)
+{
+    switch (index)
+    {
+        case wetLevelParameter:  return convolution.getWetLevel();
+        case dryLevelParameter:  return convolution.getDryLevel();
+        default:                 return 0.0f;
+    }
+}
+
+const String ConvolutionAudioProcessor::getParameterText (int index)
+{
+    return Decibels::toString (Decibels::gainToDecibels (getParameter (index)));
+}
+
+void ConvolutionAudioProcessor::setParameter (int index, float newValue)
+{
+    switch (index)
+    {
+        case wetLevelParameter:  convolution.setLevels (newValue, convolution.getDryLevel()); break;
+        case dryLevelParameter:  convolution.setLevels (convolution.getWetLevel(), newValue); break;
+        default:                 break;
+    }
+}
+
+//==============================================================================
+int ConvolutionAudioProcessor::getNumPrograms()                                 { return 1; }
+int ConvolutionAudioProcessor::getCurrentProgram()                              { return 0; }
+void ConvolutionAudioProcessor::setCurrentProgram (int)                         {}
+const String ConvolutionAudioProcessor::getProgramName (int)                    { return String::empty; }
+void ConvolutionAudioProcessor::changeProgramName (int, const String&)          {}
+
+//==============================================================================
+void ConvolutionAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
+{
+    XmlElement xml ("CONVOLUTION");
+    xml.setAttribute ("wetLevel", convolution.getWetLevel());
+    xml.setAttribute ("dryLevel", convolution.getDryLevel());
+    copyXmlToBinary (xml, destData);
+}
+
+void ConvolutionAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
+{
+    const ScopedPointer<XmlElement> xml (getXmlFromBinary (data, sizeInBytes));
+
+    if (xml != nullptr && xml->hasTagName ("CONVOLUTION"))
+        convolution.setLevels ((float) xml->getDoubleAttribute ("wetLevel", convolution.getWetLevel()),
+                               (float) xml->getDoubleAttribute ("dryLevel", convolution.getDryLevel()));
+}
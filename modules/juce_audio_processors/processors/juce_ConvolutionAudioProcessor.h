@@ -0,0 +1,105 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_CONVOLUTIONAUDIOPROCESSOR_JUCEHEADER__
+#define __JUCE_CONVOLUTIONAUDIOPROCESSOR_JUCEHEADER__
+
+#include "juce_AudioProcessor.h"
+
+
+//==============================================================================
+/**
+    An AudioProcessor that applies a convolution reverb, so that one can be used as a
+    node in an AudioProcessorGraph.
+
+    Use getConvolution() to load an impulse response. The wet and dry levels are exposed
+    as parameters, and are saved by getStateInformation(). The impulse response itself
+    isn't saved, as it's usually far too big to go in a plugin's state.
+
+    @see ConvolutionReverb, ConvolutionAudioSource
+*/
+class JUCE_API  ConvolutionAudioProcessor  : public AudioProcessor
+{
+public:
+    //==============================================================================
+    /** Creates a ConvolutionAudioProcessor. */
+    ConvolutionAudioProcessor();
+
+    /** Destructor. */
+    ~ConvolutionAudioProcessor();
+
+    /** Returns the ConvolutionReverb that does the processing. */
+    ConvolutionReverb& getConvolution() noexcept            { return convolution; }
+
+    /** The indexes of the processor's parameters. */
+    enum Parameters
+    {
+        wetLevelParameter = 0,
+        dryLevelParameter,
+        numParameters
+    };
+
+    //==============================================================================
+    const String getName() const;
+
+    void prepareToPlay (double sampleRate, int estimatedSamplesPerBlock);
+    void releaseResources();
+    void processBlock (AudioSampleBuffer&, MidiBuffer&);
+
+    const String getInputChannelName (int channelIndex) const;
+    const String getOutputChannelName (int channelIndex) const;
+    bool isInputChannelStereoPair (int index) const;
+    bool isOutputChannelStereoPair (int index) const;
+    bool silenceInProducesSilenceOut() const;
+    double getTailLengthSeconds() const;
+    bool acceptsMidi() const;
+    bool producesMidi() const;
+
+    bool hasEditor() const;
+    AudioProcessorEditor* createEditor();
+
+    int getNumParameters();
+    const String getParameterName (int);
+    float getParameter (int);
+    const String getParameterText (int);
+    void setParameter (int, float);
+
+    int getNumPrograms();
+    int getCurrentProgram();
+    void setCurrentProgram (int);
+    const String getProgramName (int);
+    void changeProgramName (int, const String&);
+
+    void getStateInformation (juce::MemoryBlock& destData);
+    void setStateInformation (const void* data, int sizeInBytes);
+
+private:
+    //==============================================================================
+    ConvolutionReverb convolution;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ConvolutionAudioProcessor)
+};
+
+
+#endif   // __JUCE_CONVOLUTIONAUDIOPROCESSOR_JUCEHEADER__
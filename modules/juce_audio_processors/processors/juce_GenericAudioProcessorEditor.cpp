@@ -52,6 +52,8 @@ public:
 
     void audioProcessorChanged (AudioProcessor*)  {}
 
+    bool receivesParameterChangesOnMessageThread() const    { return true; }
+
     void audioProcessorParameterChanged (AudioProcessor*, int parameterIndex, float)
     {
         if (parameterIndex == index)
@@ -115,35 +117,46 @@ private:
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ProcessorParameterPropertyComp)
 };
 
-
 //==============================================================================
-GenericAudioProcessorEditor::GenericAudioProcessorEditor (AudioProcessor* const p)
-    : AudioProcessorEditor (p)
+// The sliders are only created as they're scrolled into view, as some plugins have
+// thousands of parameters.
+class ProcessorParameterSectionModel  : public PropertyPanel::SectionModel
 {
-    jassert (p != nullptr);
-    setOpaque (true);
-
-    addAndMakeVisible (&panel);
-
-    Array <PropertyComponent*> params;
+public:
+    ProcessorParameterSectionModel (AudioProcessor& p)  : owner (p) {}
 
-    const int numParams = p->getNumParameters();
-    int totalHeight = 0;
+    int getNumProperties()
+    {
+        return owner.getNumParameters();
+    }
 
-    for (int i = 0; i < numParams; ++i)
+    PropertyComponent* createPropertyComponent (const int index)
     {
-        String name (p->getParameterName (i));
+        String name (owner.getParameterName (index));
         if (name.trim().isEmpty())
             name = "Unnamed";
 
-        ProcessorParameterPropertyComp* const pc = new ProcessorParameterPropertyComp (name, *p, i);
-        params.add (pc);
-        totalHeight += pc->getPreferredHeight();
+        return new ProcessorParameterPropertyComp (name, owner, index);
     }
 
-    panel.addProperties (params);
+private:
+    AudioProcessor& owner;
+
+    JUCE_DECLARE_NON_COPYABLE (ProcessorParameterSectionModel)
+};
+
+
+//==============================================================================
+GenericAudioProcessorEditor::GenericAudioProcessorEditor (AudioProcessor* const p)
+    : AudioProcessorEditor (p)
+{
+    jassert (p != nullptr);
+    setOpaque (true);
+
+    addAndMakeVisible (&panel);
+    panel.addProperties (new ProcessorParameterSectionModel (*p));
 
-    setSize (400, jlimit (25, 400, totalHeight));
+    setSize (400, jlimit (25, 400, panel.getTotalContentHeight()));
 }
 
 GenericAudioProcessorEditor::~GenericAudioProcessorEditor()
@@ -0,0 +1,140 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+
+ParameterChangeQueue::ParameterChangeQueue (const int capacity)
+    : slots ((size_t) nextPowerOfTwo (jmax (2, capacity))),
+      changes ((size_t) nextPowerOfTwo (jmax (2, capacity))),
+      mask ((uint32) nextPowerOfTwo (jmax (2, capacity)) - 1),
+      readPosition (0),
+      numChanges (0), numHeldBack (0)
+{
+    // Each slot's sequence number tells a writer whether the slot is free for the
+    // position it's trying to claim, and the reader whether it has been filled yet.
+    for (uint32 i = 0; i <= mask; ++i)
+        slots[i].sequence.set (i);
+}
+
+ParameterChangeQueue::~ParameterChangeQueue()
+{
+}
+
+bool ParameterChangeQueue::addChange (const int parameterIndex, const float newValue, const int samplePosition) noexcept
+{
+    jassert (samplePosition >= 0);
+
+    uint32 pos = writePosition.get();
+
+    for (;;)
+    {
+        Slot& slot = slots [pos & mask];
+        const int distance = (int) (slot.sequence.get() - pos);
+
+        if (distance == 0)
+        {
+            if (writePosition.compareAndSetBool (pos + 1, pos))
+                break;
+
+            pos = writePosition.get();
+        }
+        else if (distance < 0)
+        {
+            return false;  // the reader hasn't caught up with this slot yet, so the queue is full
+        }
+        else
+        {
+            pos = writePosition.get();  // another writer got here first
+        }
+    }
+
+    Slot& slot = slots [pos & mask];
+    slot.change.samplePosition = jmax (0, samplePosition);
+    slot.change.parameterIndex = parameterIndex;
+    slot.change.value = newValue;
+
+    // (the change must be complete before the reader is allowed to see it)
+    Atomic<uint32>::memoryBarrier();
+    slot.sequence.set (pos + 1);
+    return true;
+}
+
+bool ParameterChangeQueue::readNextChange (Change& change) noexcept
+{
+    Slot& slot = slots [readPosition & mask];
+
+    if ((int) (slot.sequence.get() - (readPosition + 1)) < 0)
+        return false;
+
+    change = slot.change;
+
+    Atomic<uint32>::memoryBarrier();
+    slot.sequence.set (readPosition + mask + 1);
+    ++readPosition;
+    return true;
+}
+
+int ParameterChangeQueue::readChanges (const int numSamplesInBlock) noexcept
+{
+    // The changes that were held back last time are still in order after the previous
+    // block's ones, so move them to the front, and then sort the new ones in after them..
+    if (numHeldBack > 0 && numChanges > 0)
+        memmove (changes, changes + numChanges, sizeof (Change) * (size_t) numHeldBack);
+
+    const int capacity = (int) mask + 1;
+    int num = numHeldBack;
+    Change change;
+
+    while (num < capacity && readNextChange (change))
+    {
+        int i = num++;
+
+        for (; i > 0 && changes [i - 1].samplePosition > change.samplePosition; --i)
+            changes[i] = changes [i - 1];
+
+        changes[i] = change;
+    }
+
+    // ..and then hold back any that belong in a later block.
+    numChanges = 0;
+
+    while (numChanges < num && changes [numChanges].samplePosition < numSamplesInBlock)
+        ++numChanges;
+
+    numHeldBack = num - numChanges;
+
+    for (int i = numChanges; i < num; ++i)
+        changes[i].samplePosition -= numSamplesInBlock;
+
+    return numChanges;
+}
+
+void ParameterChangeQueue::clear() noexcept
+{
+    Change change;
+    while (readNextChange (change))
+    {}
+
+    numChanges = 0;
+    numHeldBack = 0;
+}
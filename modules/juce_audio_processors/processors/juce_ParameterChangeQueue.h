@@ -0,0 +1,149 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+
+#ifndef __JUCE_PARAMETERCHANGEQUEUE_JUCEHEADER__
+#define __JUCE_PARAMETERCHANGEQUEUE_JUCEHEADER__
+
+
+//==============================================================================
+/**
+    A queue of timestamped parameter changes, which an AudioProcessor can read
+    at the start of each processBlock() callback.
+
+    Changes can be added from any thread without blocking - e.g. by a host that's
+    playing back automation, or by an editor as the user drags a slider. Then, in
+    its processBlock() method, the processor calls readChanges() to collect the ones
+    that fall within the block, sorted by their sample position, and applies each one
+    at the right point as it renders, in the same way that it'd handle the block's
+    MidiBuffer:
+
+    @code
+    void processBlock (AudioSampleBuffer& buffer, MidiBuffer& midi)
+    {
+        ParameterChangeQueue& changes = getParameterChangeQueue();
+        const int numChanges = changes.readChanges (buffer.getNumSamples());
+
+        for (int i = 0; i < numChanges; ++i)
+        {
+            const ParameterChangeQueue::Change& c = changes.getChange (i);
+            ...render up to c.samplePosition, then apply c.value to parameter c.parameterIndex
+        }
+
+        ...render the rest of the block
+    }
+    @endcode
+
+    Any number of threads can add changes at once, but only one thread (i.e. the
+    audio thread) may read them.
+
+    @see AudioProcessor::getParameterChangeQueue
+*/
+class JUCE_API  ParameterChangeQueue
+{
+public:
+    //==============================================================================
+    /** Creates a queue which can hold up to the given number of changes. */
+    explicit ParameterChangeQueue (int capacity = 1024);
+
+    /** Destructor. */
+    ~ParameterChangeQueue();
+
+    //==============================================================================
+    /** Describes a change to one of a processor's parameters. */
+    struct Change
+    {
+        /** The position at which the change happens, in samples from the start of
+            the block that it's being read in.
+        */
+        int samplePosition;
+
+        /** The index of the parameter that changes. */
+        int parameterIndex;
+
+        /** The parameter's new value, between 0 and 1.0. */
+        float value;
+    };
+
+    //==============================================================================
+    /** Adds a change to the queue.
+
+        This can be called by any thread, and will never block or allocate memory.
+
+        The sample position is relative to the start of the next block that the processor
+        reads. Changes that are further ahead than that block are held back until the block
+        that they fall in.
+
+        Returns false if the queue is full, in which case the change is discarded.
+    */
+    bool addChange (int parameterIndex, float newValue, int samplePosition = 0) noexcept;
+
+    //==============================================================================
+    /** Collects the changes that happen during the next block of samples.
+
+        This must only be called by the thread that renders the processor's audio, and
+        should be called once per block, from processBlock(). It returns the number of
+        changes that fall within the block; you can then use getChange() to look at each
+        of them, in order of their sample positions (changes at the same position stay in
+        the order in which they were added).
+    */
+    int readChanges (int numSamplesInBlock) noexcept;
+
+    /** Returns the number of changes that the last call to readChanges() found. */
+    int getNumChanges() const noexcept                      { return numChanges; }
+
+    /** Returns one of the changes that the last call to readChanges() found. */
+    const Change& getChange (int index) const noexcept
+    {
+        jassert (isPositiveAndBelow (index, numChanges));
+        return changes [index];
+    }
+
+    /** Throws away any changes that haven't been read yet.
+        Like readChanges(), this must only be called by the thread that reads the changes.
+    */
+    void clear() noexcept;
+
+private:
+    //==============================================================================
+    struct Slot
+    {
+        Atomic<uint32> sequence;
+        Change change;
+    };
+
+    HeapBlock<Slot> slots;
+    HeapBlock<Change> changes;
+    const uint32 mask;
+    Atomic<uint32> writePosition;
+    uint32 readPosition;
+    int numChanges, numHeldBack;
+
+    bool readNextChange (Change&) noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ParameterChangeQueue)
+};
+
+
+#endif   // __JUCE_PARAMETERCHANGEQUEUE_JUCEHEADER__
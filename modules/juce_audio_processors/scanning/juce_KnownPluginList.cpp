@@ -22,25 +22,71 @@
   ==============================================================================
 */
 
-KnownPluginList::KnownPluginList()  {}
+KnownPluginList::KnownPluginList()  : fileIndexNeedsRebuilding (false) {}
 KnownPluginList::~KnownPluginList() {}
 
 void KnownPluginList::clear()
 {
+    const ScopedLock sl (scanLock);
+
     if (types.size() > 0)
     {
+        typesSortedByFile.clear();
+        fileIndexNeedsRebuilding = false;
         types.clear();
         sendChangeMessage();
     }
 }
 
+namespace KnownPluginListHelpers
+{
+    struct FileOrderSorter
+    {
+        static int compareElements (const PluginDescription* const first,
+                                    const PluginDescription* const second) noexcept
+        {
+            return first->fileOrIdentifier.compare (second->fileOrIdentifier);
+        }
+    };
+}
+
+// Returns the position in typesSortedByFile at which the types for this file start (or
+// would be inserted). These are in the same order as they appear in the main list.
+// The caller must hold the scanLock.
+int KnownPluginList::findFirstTypeIndexForFile (const String& fileOrIdentifier) const
+{
+    if (fileIndexNeedsRebuilding)
+    {
+        typesSortedByFile.clearQuick();
+        typesSortedByFile.addArray (static_cast <PluginDescription* const*> (types.begin()), types.size());
+
+        KnownPluginListHelpers::FileOrderSorter sorter;
+        typesSortedByFile.sort (sorter, true);
+        fileIndexNeedsRebuilding = false;
+    }
+
+    int start = 0, end = typesSortedByFile.size();
+
+    while (start < end)
+    {
+        const int mid = (start + end) / 2;
+
+        if (typesSortedByFile.getUnchecked (mid)->fileOrIdentifier.compare (fileOrIdentifier) < 0)
+            start = mid + 1;
+        else
+            end = mid;
+    }
+
+    return start;
+}
+
 PluginDescription* KnownPluginList::getTypeForFile (const String& fileOrIdentifier) const
 {
-    for (int i = 0; i < types.size(); ++i)
-        if (types.getUnchecked(i)->fileOrIdentifier == fileOrIdentifier)
-            return types.getUnchecked(i);
+    const ScopedLock sl (scanLock);
 
-    return nullptr;
+    PluginDescription* const d = typesSortedByFile [findFirstTypeIndexForFile (fileOrIdentifier)];
+
+    return (d != nullptr && d->fileOrIdentifier == fileOrIdentifier) ? d : nullptr;
 }
 
 PluginDescription* KnownPluginList::getTypeForIdentifierString (const String& identifierString) const
@@ -54,26 +100,41 @@ PluginDescription* KnownPluginList::getTypeForIdentifierString (const String& id
 
 bool KnownPluginList::addType (const PluginDescription& type)
 {
-    for (int i = types.size(); --i >= 0;)
+    const ScopedLock sl (scanLock);
+
+    // (duplicates always have the same file, so only the types for this file need checking)
+    const int firstForFile = findFirstTypeIndexForFile (type.fileOrIdentifier);
+
+    for (int i = firstForFile; i < typesSortedByFile.size(); ++i)
     {
-        if (types.getUnchecked(i)->isDuplicateOf (type))
+        PluginDescription* const d = typesSortedByFile.getUnchecked(i);
+
+        if (d->fileOrIdentifier != type.fileOrIdentifier)
+            break;
+
+        if (d->isDuplicateOf (type))
         {
             // strange - found a duplicate plugin with different info..
-            jassert (types.getUnchecked(i)->name == type.name);
-            jassert (types.getUnchecked(i)->isInstrument == type.isInstrument);
+            jassert (d->name == type.name);
+            jassert (d->isInstrument == type.isInstrument);
 
-            *types.getUnchecked(i) = type;
+            *d = type;
             return false;
         }
     }
 
-    types.insert (0, new PluginDescription (type));
+    PluginDescription* const newType = new PluginDescription (type);
+    types.insert (0, newType);
+    typesSortedByFile.insert (firstForFile, newType);
     sendChangeMessage();
     return true;
 }
 
 void KnownPluginList::removeType (const int index)
 {
+    const ScopedLock sl (scanLock);
+
+    typesSortedByFile.removeFirstMatchingValue (types [index]);
     types.remove (index);
     sendChangeMessage();
 }
@@ -81,21 +142,97 @@ void KnownPluginList::removeType (const int index)
 bool KnownPluginList::isListingUpToDate (const String& fileOrIdentifier,
                                          AudioPluginFormat& formatToUse) const
 {
-    if (getTypeForFile (fileOrIdentifier) == nullptr)
-        return false;
+    Array <PluginDescription> typesForFile;
 
-    for (int i = types.size(); --i >= 0;)
     {
-        const PluginDescription* const d = types.getUnchecked(i);
+        const ScopedLock sl (scanLock);
 
-        if (d->fileOrIdentifier == fileOrIdentifier
-             && formatToUse.pluginNeedsRescanning (*d))
-            return false;
+        for (int i = findFirstTypeIndexForFile (fileOrIdentifier); i < typesSortedByFile.size(); ++i)
+        {
+            const PluginDescription* const d = typesSortedByFile.getUnchecked(i);
+
+            if (d->fileOrIdentifier != fileOrIdentifier)
+                break;
+
+            typesForFile.add (*d);
+        }
     }
 
+    if (typesForFile.size() == 0)
+        return false;
+
+    // (the files are checked without holding the lock, so that other threads can check theirs)
+    for (int i = 0; i < typesForFile.size(); ++i)
+        if (formatToUse.pluginNeedsRescanning (typesForFile.getReference(i)))
+            return false;
+
     return true;
 }
 
+namespace KnownPluginListHelpers
+{
+    class RescanCheckJob  : public ThreadPoolJob
+    {
+    public:
+        RescanCheckJob (const KnownPluginList& l, AudioPluginFormat& f,
+                        const StringArray& filesToCheck, bool* const needsRescanning,
+                        const int start, const int end)
+            : ThreadPoolJob ("Plugin file checker"), list (l), format (f),
+              files (filesToCheck), results (needsRescanning), startIndex (start), endIndex (end)
+        {
+        }
+
+        JobStatus runJob()
+        {
+            for (int i = startIndex; i < endIndex && ! shouldExit(); ++i)
+                results[i] = ! list.isListingUpToDate (files[i], format);
+
+            return jobHasFinished;
+        }
+
+    private:
+        const KnownPluginList& list;
+        AudioPluginFormat& format;
+        const StringArray& files;
+        bool* const results;
+        const int startIndex, endIndex;
+
+        JUCE_DECLARE_NON_COPYABLE (RescanCheckJob)
+    };
+}
+
+StringArray KnownPluginList::getFilesThatNeedRescanning (const StringArray& files,
+                                                         AudioPluginFormat& formatToUse,
+                                                         ThreadPool& pool) const
+{
+    const int numFilesPerJob = 16;
+    HeapBlock<bool> needsRescanning ((size_t) files.size());
+    OwnedArray<KnownPluginListHelpers::RescanCheckJob> jobs;
+
+    for (int i = 0; i < files.size(); ++i)
+        needsRescanning[i] = true;
+
+    for (int start = 0; start < files.size(); start += numFilesPerJob)
+    {
+        KnownPluginListHelpers::RescanCheckJob* const job
+            = new KnownPluginListHelpers::RescanCheckJob (*this, formatToUse, files, needsRescanning, start,
+                                                          jmin (start + numFilesPerJob, files.size()));
+        jobs.add (job);
+        pool.addJob (job, false);
+    }
+
+    for (int i = 0; i < jobs.size(); ++i)
+        pool.waitForJobToFinish (jobs.getUnchecked(i), -1);
+
+    StringArray result;
+
+    for (int i = 0; i < files.size(); ++i)
+        if (needsRescanning[i])
+            result.add (files[i]);
+
+    return result;
+}
+
 void KnownPluginList::setCustomScanner (CustomScanner* newScanner)
 {
     scanner = newScanner;
@@ -113,11 +250,14 @@ bool KnownPluginList::scanAndAddFile (const String& fileOrIdentifier,
     {
         bool needsRescanning = false;
 
-        for (int i = types.size(); --i >= 0;)
+        for (int i = findFirstTypeIndexForFile (fileOrIdentifier); i < typesSortedByFile.size(); ++i)
         {
-            const PluginDescription* const d = types.getUnchecked(i);
+            const PluginDescription* const d = typesSortedByFile.getUnchecked(i);
+
+            if (d->fileOrIdentifier != fileOrIdentifier)
+                break;
 
-            if (d->fileOrIdentifier == fileOrIdentifier && d->pluginFormatName == format.getName())
+            if (d->pluginFormatName == format.getName())
             {
                 if (format.pluginNeedsRescanning (*d))
                     needsRescanning = true;
@@ -274,8 +414,11 @@ void KnownPluginList::sort (const SortMethod method)
 {
     if (method != defaultOrder)
     {
+        const ScopedLock sl (scanLock);
+
         PluginSorter sorter (method);
         types.sort (sorter, true);
+        fileIndexNeedsRebuilding = true;
 
         sendChangeMessage();
     }
@@ -314,6 +457,82 @@ void KnownPluginList::recreateFromXml (const XmlElement& xml)
     }
 }
 
+namespace KnownPluginListHelpers
+{
+    // Picks out the PLUGIN and BLACKLISTED elements from the top level of the document,
+    // reusing a single XmlElement to hold the attributes of each plugin in turn.
+    struct XmlReader  : public XmlDocument::ParseHandler
+    {
+        XmlReader (KnownPluginList& list_, StringArray& blacklist_)
+            : list (list_), blacklist (blacklist_), pluginXml ("PLUGIN"),
+              depth (0), isPlugin (false), isBlacklisted (false)
+        {}
+
+        bool elementStarted (const String& tagName)
+        {
+            if (++depth == 1)
+                return tagName == "KNOWNPLUGINS";
+
+            if (depth == 2)
+            {
+                isPlugin = (tagName == pluginXml.getTagName());
+                isBlacklisted = (tagName == "BLACKLISTED");
+
+                if (isPlugin)
+                    pluginXml.removeAllAttributes();
+            }
+
+            return true;
+        }
+
+        bool attributeFound (const Identifier& name, const String& value)
+        {
+            if (depth == 2)
+            {
+                if (isPlugin)
+                    pluginXml.setAttribute (name.toString(), value);
+                else if (isBlacklisted && name == Identifier ("id"))
+                    blacklist.add (value);
+            }
+
+            return true;
+        }
+
+        bool elementEnded (const String&)
+        {
+            if (depth-- == 2 && isPlugin)
+            {
+                PluginDescription info;
+
+                if (info.loadFromXml (pluginXml))
+                    list.addType (info);
+
+                isPlugin = false;
+            }
+
+            isBlacklisted = false;
+            return true;
+        }
+
+        KnownPluginList& list;
+        StringArray& blacklist;
+        XmlElement pluginXml;
+        int depth;
+        bool isPlugin, isBlacklisted;
+
+        JUCE_DECLARE_NON_COPYABLE (XmlReader)
+    };
+}
+
+bool KnownPluginList::recreateFromXml (XmlDocument& document)
+{
+    clear();
+    clearBlacklistedFiles();
+
+    KnownPluginListHelpers::XmlReader reader (*this, blacklist);
+    return document.parseDocument (reader);
+}
+
 //==============================================================================
 struct PluginTreeUtils
 {
@@ -106,6 +106,19 @@ public:
     bool isListingUpToDate (const String& possiblePluginFileOrIdentifier,
                             AudioPluginFormat& formatToUse) const;
 
+    /** Finds out which of a set of files need to be rescanned.
+
+        This calls isListingUpToDate() for each of the files, and returns the ones for
+        which it returned false. The checks are run on the thread pool, so that the
+        file-system lookups involved get done in parallel, which is a lot quicker than
+        checking them one-by-one when the plugins live on a slow or network drive. This
+        means that the format's pluginNeedsRescanning() method will be called by several
+        threads at once.
+    */
+    StringArray getFilesThatNeedRescanning (const StringArray& possiblePluginFilesOrIdentifiers,
+                                            AudioPluginFormat& formatToUse,
+                                            ThreadPool& pool) const;
+
     /** Scans and adds a bunch of files that might have been dragged-and-dropped.
         If any types are found in the files, their descriptions are returned in the array.
     */
@@ -165,6 +178,16 @@ public:
     /** Recreates the state of this list from its stored XML format. */
     void recreateFromXml (const XmlElement& xml);
 
+    /** Recreates the state of this list by reading an XML document in its stored format.
+
+        This scans through the document without building an XmlElement tree for the
+        whole thing, so is quicker than parsing it and calling recreateFromXml() when
+        the list is a long one.
+
+        @returns false if the document couldn't be parsed
+    */
+    bool recreateFromXml (XmlDocument& document);
+
     //==============================================================================
     /** A structure that recursively holds a tree of plugins.
         @see KnownPluginList::createTree()
@@ -203,6 +226,12 @@ private:
     ScopedPointer<CustomScanner> scanner;
     CriticalSection scanLock;
 
+    // all the types, kept sorted by file so that they can be looked up quickly
+    mutable Array <PluginDescription*> typesSortedByFile;
+    mutable bool fileIndexNeedsRebuilding;
+
+    int findFirstTypeIndexForFile (const String&) const;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (KnownPluginList)
 };
 
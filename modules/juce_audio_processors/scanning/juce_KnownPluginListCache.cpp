@@ -0,0 +1,392 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+
+namespace KnownPluginListCacheHelpers
+{
+    static const int magicNumber = (int) ByteOrder::littleEndianInt ("JPLC");
+    static const int formatVersion = 1;
+    static const int headerSize = 8;
+
+    // Each record is an int holding its size, followed by the record-type byte and its contents.
+    enum RecordType
+    {
+        pluginFileRecord = 1,   // a file name, followed by all the types that it contains
+        removedFileRecord,      // a file name that's no longer in the list
+        blacklistRecord         // the complete set of blacklisted files
+    };
+
+    static int64 calculateHash (const void* const data, const size_t numBytes) noexcept
+    {
+        const uint8* const bytes = static_cast <const uint8*> (data);
+        uint64 hash = 0xcbf29ce484222325ULL;
+
+        for (size_t i = 0; i < numBytes; ++i)
+            hash = (hash ^ bytes[i]) * 0x100000001b3ULL;
+
+        return (int64) hash;
+    }
+
+    static void writeType (OutputStream& out, const PluginDescription& d)
+    {
+        out.writeString (d.name);
+        out.writeString (d.descriptiveName);
+        out.writeString (d.pluginFormatName);
+        out.writeString (d.category);
+        out.writeString (d.manufacturerName);
+        out.writeString (d.version);
+        out.writeInt64 (d.lastFileModTime.toMilliseconds());
+        out.writeInt (d.uid);
+        out.writeBool (d.isInstrument);
+        out.writeInt (d.numInputChannels);
+        out.writeInt (d.numOutputChannels);
+    }
+
+    static void readType (InputStream& in, const String& fileOrIdentifier, PluginDescription& d)
+    {
+        d.name              = in.readString();
+        d.descriptiveName   = in.readString();
+        d.pluginFormatName  = in.readString();
+        d.category          = in.readString();
+        d.manufacturerName  = in.readString();
+        d.version           = in.readString();
+        d.fileOrIdentifier  = fileOrIdentifier;
+        d.lastFileModTime   = Time (in.readInt64());
+        d.uid               = in.readInt();
+        d.isInstrument      = in.readBool();
+        d.numInputChannels  = in.readInt();
+        d.numOutputChannels = in.readInt();
+    }
+
+    static bool readPluginFileRecord (const void* const data, const size_t numBytes,
+                                      OwnedArray <PluginDescription>& results)
+    {
+        MemoryInputStream in (data, numBytes, false);
+        in.readByte(); // (the record type)
+
+        const String fileOrIdentifier (in.readString());
+        const int numTypes = in.readInt();
+
+        if (numTypes < 0 || numTypes > (int) numBytes)
+            return false;
+
+        for (int i = 0; i < numTypes; ++i)
+        {
+            PluginDescription* const d = new PluginDescription();
+            results.add (d);
+            readType (in, fileOrIdentifier, *d);
+        }
+
+        // a record that doesn't end where its contents do must be corrupted..
+        return in.getNumBytesRemaining() == 0;
+    }
+
+    static void writeRecord (OutputStream& out, const MemoryOutputStream& record)
+    {
+        out.writeInt ((int) record.getDataSize());
+        out << record;
+    }
+
+    struct FileSorter
+    {
+        static int compareElements (const PluginDescription* const first,
+                                    const PluginDescription* const second) noexcept
+        {
+            return first->fileOrIdentifier.compare (second->fileOrIdentifier);
+        }
+    };
+
+    static void getTypesSortedByFile (const KnownPluginList& list, Array <const PluginDescription*>& sorted)
+    {
+        for (PluginDescription** i = list.begin(); i != list.end(); ++i)
+            sorted.add (*i);
+
+        FileSorter sorter;
+        sorted.sort (sorter, true);
+    }
+}
+
+//==============================================================================
+KnownPluginListCache::KnownPluginListCache (const File& cacheFile)
+    : file (cacheFile), liveBytes (0), fileSize (0)
+{
+}
+
+KnownPluginListCache::~KnownPluginListCache()
+{
+}
+
+void KnownPluginListCache::forgetSavedState()
+{
+    savedEntries.clear();
+    savedBlacklist = SavedEntry();
+    liveBytes = 0;
+    fileSize = 0;
+}
+
+//==============================================================================
+bool KnownPluginListCache::loadInto (KnownPluginList& list)
+{
+    using namespace KnownPluginListCacheHelpers;
+
+    const MemoryMappedFile mappedFile (file, MemoryMappedFile::readOnly);
+    const char* const data = static_cast <const char*> (mappedFile.getData());
+    const size_t dataSize = mappedFile.getSize();
+
+    if (data == nullptr || dataSize < (size_t) headerSize)
+        return false;
+
+    MemoryInputStream in (data, dataSize, false);
+
+    if (in.readInt() != magicNumber || in.readInt() != formatVersion)
+        return false;
+
+    // First, index the file to find the latest record for each plugin file..
+    HashMap <String, int64> latestRecords;
+    int64 blacklistRecordPos = -1;
+    int64 validDataSize = headerSize;
+
+    for (;;)
+    {
+        const int64 recordPos = in.getPosition();
+        const int recordSize = in.readInt();
+
+        // (a record that runs off the end must have been cut short while it was being written)
+        if (recordSize <= 0 || recordSize > in.getNumBytesRemaining())
+            break;
+
+        const int64 nextRecordPos = in.getPosition() + recordSize;
+        const int recordType = in.readByte();
+
+        if (recordType == pluginFileRecord || recordType == removedFileRecord)
+            latestRecords.set (in.readString(), recordType == pluginFileRecord ? recordPos : -1);
+        else if (recordType == blacklistRecord)
+            blacklistRecordPos = recordPos;
+
+        in.setPosition (nextRecordPos);
+        validDataSize = nextRecordPos;
+    }
+
+    // ..then decode just those records.
+    OwnedArray <PluginDescription> types;
+    StringArray blacklist;
+    HashMap <String, SavedEntry> entries;
+    SavedEntry blacklistEntry;
+    int64 totalLiveBytes = 0;
+
+    for (HashMap <String, int64>::Iterator i (latestRecords); i.next();)
+    {
+        const int64 recordPos = i.getValue();
+
+        if (recordPos >= 0)
+        {
+            const char* const record = data + recordPos + sizeof (int);
+            const int recordSize = (int) ByteOrder::littleEndianInt (data + recordPos);
+
+            if (! readPluginFileRecord (record, (size_t) recordSize, types))
+                return false;
+
+            SavedEntry entry;
+            entry.hash = calculateHash (record, (size_t) recordSize);
+            entry.numBytes = recordSize + (int64) sizeof (int);
+            entries.set (i.getKey(), entry);
+            totalLiveBytes += entry.numBytes;
+        }
+    }
+
+    if (blacklistRecordPos >= 0)
+    {
+        const char* const record = data + blacklistRecordPos + sizeof (int);
+        const int recordSize = (int) ByteOrder::littleEndianInt (data + blacklistRecordPos);
+
+        MemoryInputStream blacklistIn (record, (size_t) recordSize, false);
+        blacklistIn.readByte();
+
+        const int numFiles = blacklistIn.readInt();
+
+        for (int i = 0; i < numFiles && ! blacklistIn.isExhausted(); ++i)
+            blacklist.add (blacklistIn.readString());
+
+        if (blacklistIn.getNumBytesRemaining() != 0)
+            return false;
+
+        blacklistEntry.hash = calculateHash (record, (size_t) recordSize);
+        blacklistEntry.numBytes = recordSize + (int64) sizeof (int);
+        totalLiveBytes += blacklistEntry.numBytes;
+    }
+
+    list.clear();
+    list.clearBlacklistedFiles();
+
+    // (added in reverse because addType() puts each new type at the start of the list)
+    for (int i = types.size(); --i >= 0;)
+        list.addType (*types.getUnchecked(i));
+
+    for (int i = 0; i < blacklist.size(); ++i)
+        list.addToBlacklist (blacklist[i]);
+
+    savedEntries.swapWith (entries);
+    savedBlacklist = blacklistEntry;
+    liveBytes = totalLiveBytes;
+    fileSize = validDataSize;
+    return true;
+}
+
+//==============================================================================
+void KnownPluginListCache::writeChanges (const KnownPluginList& list, OutputStream& out)
+{
+    using namespace KnownPluginListCacheHelpers;
+
+    Array <const PluginDescription*> sorted;
+    getTypesSortedByFile (list, sorted);
+
+    HashMap <String, SavedEntry> currentEntries;
+    int64 totalLiveBytes = 0;
+
+    for (int start = 0; start < sorted.size();)
+    {
+        const String& fileOrIdentifier = sorted.getUnchecked (start)->fileOrIdentifier;
+        int end = start + 1;
+
+        while (end < sorted.size() && sorted.getUnchecked (end)->fileOrIdentifier == fileOrIdentifier)
+            ++end;
+
+        MemoryOutputStream record;
+        record.writeByte ((char) pluginFileRecord);
+        record.writeString (fileOrIdentifier);
+        record.writeInt (end - start);
+
+        for (int i = start; i < end; ++i)
+            writeType (record, *sorted.getUnchecked(i));
+
+        SavedEntry entry;
+        entry.hash = calculateHash (record.getData(), record.getDataSize());
+        entry.numBytes = (int64) (record.getDataSize() + sizeof (int));
+
+        const SavedEntry previous (savedEntries [fileOrIdentifier]);
+
+        if (previous.numBytes != entry.numBytes || previous.hash != entry.hash)
+            writeRecord (out, record);
+
+        currentEntries.set (fileOrIdentifier, entry);
+        totalLiveBytes += entry.numBytes;
+        start = end;
+    }
+
+    for (HashMap <String, SavedEntry>::Iterator i (savedEntries); i.next();)
+    {
+        if (! currentEntries.contains (i.getKey()))
+        {
+            MemoryOutputStream record;
+            record.writeByte ((char) removedFileRecord);
+            record.writeString (i.getKey());
+            writeRecord (out, record);
+        }
+    }
+
+    {
+        const StringArray& blacklist = list.getBlacklistedFiles();
+
+        MemoryOutputStream record;
+        record.writeByte ((char) blacklistRecord);
+        record.writeInt (blacklist.size());
+
+        for (int i = 0; i < blacklist.size(); ++i)
+            record.writeString (blacklist[i]);
+
+        SavedEntry entry;
+        entry.hash = calculateHash (record.getData(), record.getDataSize());
+        entry.numBytes = (int64) (record.getDataSize() + sizeof (int));
+
+        if (savedBlacklist.numBytes != entry.numBytes || savedBlacklist.hash != entry.hash)
+            writeRecord (out, record);
+
+        savedBlacklist = entry;
+        totalLiveBytes += entry.numBytes;
+    }
+
+    savedEntries.swapWith (currentEntries);
+    liveBytes = totalLiveBytes;
+}
+
+bool KnownPluginListCache::save (const KnownPluginList& list)
+{
+    if (fileSize > 0 && file.getSize() == fileSize)
+    {
+        MemoryOutputStream changes;
+        writeChanges (list, changes);
+
+        if (changes.getDataSize() == 0)
+            return true;
+
+        // If appending these would leave the file mostly full of out-of-date records,
+        // it's better to write it again from scratch.
+        if (fileSize + (int64) changes.getDataSize() <= liveBytes * 2 + 65536)
+        {
+            FileOutputStream out (file);
+
+            if (out.openedOk() && out.getPosition() == fileSize
+                 && out.write (changes.getData(), changes.getDataSize()))
+            {
+                fileSize += (int64) changes.getDataSize();
+                return true;
+            }
+        }
+    }
+
+    return rewriteFile (list);
+}
+
+bool KnownPluginListCache::rewriteFile (const KnownPluginList& list)
+{
+    using namespace KnownPluginListCacheHelpers;
+
+    forgetSavedState();
+
+    MemoryOutputStream data;
+    data.writeInt (magicNumber);
+    data.writeInt (formatVersion);
+    writeChanges (list, data);
+
+    const TemporaryFile temp (file);
+
+    {
+        FileOutputStream out (temp.getFile());
+
+        if (! (out.openedOk() && out.write (data.getData(), data.getDataSize())))
+        {
+            forgetSavedState();
+            return false;
+        }
+    }
+
+    if (! temp.overwriteTargetFileWithTemporary())
+    {
+        forgetSavedState();
+        return false;
+    }
+
+    fileSize = (int64) data.getDataSize();
+    return true;
+}
@@ -0,0 +1,117 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+
+#ifndef __JUCE_KNOWNPLUGINLISTCACHE_JUCEHEADER__
+#define __JUCE_KNOWNPLUGINLISTCACHE_JUCEHEADER__
+
+#include "juce_KnownPluginList.h"
+
+
+//==============================================================================
+/**
+    Stores the contents of a KnownPluginList in a binary file, which can be saved
+    incrementally and loaded much more quickly than the list's XML format.
+
+    The file is a log of records, each one holding all the types found in one plugin
+    file. When you call save(), only the plugin files whose types have changed since
+    the cache was last loaded or saved get written, by appending new records to the end
+    of the file, so updating one plugin doesn't mean rewriting the whole thing. When
+    the file has built up too many out-of-date records, save() rewrites it from scratch.
+
+    When loading, the file is memory-mapped and indexed by plugin file, so that only the
+    latest record for each one gets decoded.
+
+    The order of the types in the list isn't kept, so you may want to call
+    KnownPluginList::sort() after loading it.
+
+    @code
+    KnownPluginListCache cache (appDataFolder.getChildFile ("plugins.cache"));
+
+    if (! cache.loadInto (knownPluginList))
+        scanForPlugins();
+
+    ...
+
+    void changeListenerCallback (ChangeBroadcaster*)
+    {
+        cache.save (knownPluginList); // only writes the entries that have changed
+    }
+    @endcode
+
+    @see KnownPluginList
+*/
+class JUCE_API  KnownPluginListCache
+{
+public:
+    //==============================================================================
+    /** Creates a cache that uses the given file. Nothing is read or written until you
+        call loadInto() or save().
+    */
+    explicit KnownPluginListCache (const File& cacheFile);
+
+    /** Destructor. */
+    ~KnownPluginListCache();
+
+    //==============================================================================
+    /** Returns the file that this cache uses. */
+    const File& getFile() const noexcept                { return file; }
+
+    /** Replaces the types and blacklist in a list with the ones stored in the cache file.
+
+        Returns false if the file doesn't exist or isn't a valid cache, in which case the
+        list is left unchanged.
+    */
+    bool loadInto (KnownPluginList& list);
+
+    /** Brings the cache file up-to-date with the contents of a list.
+
+        This only appends the entries that have changed since the last call to loadInto()
+        or save(). Returns false if the file couldn't be written.
+    */
+    bool save (const KnownPluginList& list);
+
+private:
+    //==============================================================================
+    struct SavedEntry
+    {
+        SavedEntry() noexcept : hash (0), numBytes (0) {}
+
+        int64 hash, numBytes;
+    };
+
+    File file;
+    HashMap <String, SavedEntry> savedEntries;
+    SavedEntry savedBlacklist;
+    int64 liveBytes, fileSize;
+
+    void writeChanges (const KnownPluginList&, OutputStream&);
+    bool rewriteFile (const KnownPluginList&);
+    void forgetSavedState();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (KnownPluginListCache)
+};
+
+
+#endif   // __JUCE_KNOWNPLUGINLISTCACHE_JUCEHEADER__
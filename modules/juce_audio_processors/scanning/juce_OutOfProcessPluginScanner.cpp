@@ -0,0 +1,349 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+namespace PluginScannerHelpers
+{
+    static const char* const commandLinePrefix = "--juce-plugin-scanner:";
+    static const uint32 magicMessageHeader = 0x7a3bc91d;
+
+    static MemoryBlock xmlToMemoryBlock (const XmlElement& xml)
+    {
+        const String text (xml.createDocument (String::empty, true, false));
+        return MemoryBlock (text.toRawUTF8(), text.getNumBytesAsUTF8());
+    }
+
+    static XmlElement* memoryBlockToXml (const MemoryBlock& data)
+    {
+        return XmlDocument::parse (String::fromUTF8 (static_cast<const char*> (data.getData()), (int) data.getSize()));
+    }
+}
+
+//==============================================================================
+/*  Runs in the host process, and looks after one of the child processes.
+    Anything the child writes to stdout or stderr is discarded (by the shared
+    AsyncChildProcess I/O thread), so that it can't fill up the pipes and block.
+*/
+class OutOfProcessPluginScanner::ScannerProcess  : public InterprocessConnection,
+                                                   private AsyncChildProcess::Listener
+{
+public:
+    ScannerProcess (const File& exe, const int timeout)
+        : InterprocessConnection (false, PluginScannerHelpers::magicMessageHeader),
+          isBusy (false), executable (exe), timeoutMs (timeout)
+    {
+    }
+
+    ~ScannerProcess()
+    {
+        stop();
+    }
+
+    /** Returns false if the plugin crashed or hung the child process. */
+    bool scan (AudioPluginFormat& format, const String& fileOrIdentifier,
+               OwnedArray <PluginDescription>& result)
+    {
+        if (! ensureRunning())
+        {
+            // couldn't launch the scanner, so there's no way to tell whether the plugin is ok..
+            jassertfalse;
+            return true;
+        }
+
+        XmlElement request ("SCAN");
+        request.setAttribute ("format", format.getName());
+        request.setAttribute ("file", fileOrIdentifier);
+
+        replyReceived.reset();
+
+        {
+            const ScopedLock sl (replyLock);
+            replyData.setSize (0);
+        }
+
+        if (! sendMessage (PluginScannerHelpers::xmlToMemoryBlock (request)))
+        {
+            stop();
+            return false;
+        }
+
+        const uint32 endTime = Time::getMillisecondCounter() + (uint32) timeoutMs;
+
+        // (if the child crashes, processFinished() signals the event, so there's no need to poll quickly)
+        while (! replyReceived.wait (500))
+        {
+            if (! childProcess->isRunning() || Time::getMillisecondCounter() > endTime)
+            {
+                stop();
+                return false;
+            }
+        }
+
+        ScopedPointer<XmlElement> reply;
+
+        {
+            const ScopedLock sl (replyLock);
+            reply = PluginScannerHelpers::memoryBlockToXml (replyData);
+        }
+
+        // (the event is also signalled if the child dies without replying)
+        if (reply == nullptr && ! childProcess->isRunning())
+        {
+            stop();
+            return false;
+        }
+
+        if (reply == nullptr || ! reply->hasTagName ("SCANRESULT"))
+            return false;
+
+        forEachXmlChildElement (*reply, e)
+        {
+            PluginDescription desc;
+
+            if (desc.loadFromXml (*e))
+                result.add (new PluginDescription (desc));
+        }
+
+        return true;
+    }
+
+    bool isBusy;
+
+private:
+    //==============================================================================
+    const File executable;
+    const int timeoutMs;
+    ScopedPointer<AsyncChildProcess> childProcess;
+    WaitableEvent replyReceived;
+    CriticalSection replyLock;
+    MemoryBlock replyData;
+
+    bool ensureRunning()
+    {
+        if (childProcess != nullptr && childProcess->isRunning() && isConnected())
+            return true;
+
+        stop();
+
+        const String pipeName ("jucePluginScanner_" + String::toHexString (Random::getSystemRandom().nextInt64()));
+
+        if (! createPipe (pipeName, timeoutMs))
+            return false;
+
+        StringArray args;
+        args.add (executable.getFullPathName());
+        args.add (PluginScannerHelpers::commandLinePrefix + pipeName);
+
+        childProcess = new AsyncChildProcess (*this);
+
+        if (! childProcess->start (args))
+        {
+            stop();
+            return false;
+        }
+
+        return true;
+    }
+
+    void stop()
+    {
+        disconnect();
+
+        if (childProcess != nullptr)
+        {
+            childProcess->kill();
+            childProcess = nullptr;
+        }
+    }
+
+    void connectionMade() {}
+    void connectionLost() {}
+
+    void messageReceived (const MemoryBlock& message)
+    {
+        {
+            const ScopedLock sl (replyLock);
+            replyData = message;
+        }
+
+        replyReceived.signal();
+    }
+
+    void processOutputReceived (AsyncChildProcess&, const void*, size_t) {}
+
+    void processFinished (AsyncChildProcess&, int)
+    {
+        replyReceived.signal();
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ScannerProcess)
+};
+
+//==============================================================================
+/*  Runs in the child process, and scans each plugin that the host asks for. */
+class OutOfProcessPluginScanner::ScannerConnection  : public InterprocessConnection,
+                                                      private DeletedAtShutdown
+{
+public:
+    ScannerConnection (AudioPluginFormatManager& fm)
+        : InterprocessConnection (true, PluginScannerHelpers::magicMessageHeader),
+          formatManager (fm)
+    {
+    }
+
+    void connectionMade() {}
+
+    void connectionLost()
+    {
+        JUCEApplication::quit();
+    }
+
+    void messageReceived (const MemoryBlock& message)
+    {
+        ScopedPointer<XmlElement> request (PluginScannerHelpers::memoryBlockToXml (message));
+        XmlElement reply ("SCANRESULT");
+
+        if (request != nullptr && request->hasTagName ("SCAN"))
+        {
+            const String formatName (request->getStringAttribute ("format"));
+            const String fileOrIdentifier (request->getStringAttribute ("file"));
+
+            for (int i = 0; i < formatManager.getNumFormats(); ++i)
+            {
+                AudioPluginFormat* const format = formatManager.getFormat (i);
+
+                if (format->getName() == formatName)
+                {
+                    OwnedArray <PluginDescription> found;
+                    format->findAllTypesForFile (found, fileOrIdentifier);
+
+                    for (int j = 0; j < found.size(); ++j)
+                        reply.addChildElement (found.getUnchecked(j)->createXml());
+
+                    break;
+                }
+            }
+        }
+
+        sendMessage (PluginScannerHelpers::xmlToMemoryBlock (reply));
+    }
+
+private:
+    AudioPluginFormatManager& formatManager;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ScannerConnection)
+};
+
+//==============================================================================
+OutOfProcessPluginScanner::OutOfProcessPluginScanner (const int maxNumProcesses,
+                                                      const int timeoutMillisecsPerPlugin,
+                                                      const File& scannerExecutable)
+    : maxProcesses (jmax (1, maxNumProcesses)),
+      timeoutMs (timeoutMillisecsPerPlugin),
+      executable (scannerExecutable != File::nonexistent ? scannerExecutable
+                                                         : File::getSpecialLocation (File::currentExecutableFile))
+{
+}
+
+OutOfProcessPluginScanner::~OutOfProcessPluginScanner()
+{
+    processes.clear();
+}
+
+bool OutOfProcessPluginScanner::startScannerIfRequested (const String& commandLine,
+                                                         AudioPluginFormatManager& formatManager)
+{
+    StringArray args;
+    args.addTokens (commandLine, true);
+
+    for (int i = 0; i < args.size(); ++i)
+    {
+        const String arg (args[i].unquoted());
+
+        if (arg.startsWith (PluginScannerHelpers::commandLinePrefix))
+        {
+            ScannerConnection* const connection = new ScannerConnection (formatManager);
+
+            if (! connection->connectToPipe (arg.fromFirstOccurrenceOf (PluginScannerHelpers::commandLinePrefix, false, false), -1))
+            {
+                delete connection;
+                JUCEApplication::quit();
+            }
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+OutOfProcessPluginScanner::ScannerProcess* OutOfProcessPluginScanner::getFreeProcess()
+{
+    for (;;)
+    {
+        {
+            const ScopedLock sl (lock);
+
+            for (int i = 0; i < processes.size(); ++i)
+            {
+                ScannerProcess* const p = processes.getUnchecked(i);
+
+                if (! p->isBusy)
+                {
+                    p->isBusy = true;
+                    return p;
+                }
+            }
+
+            if (processes.size() < maxProcesses)
+            {
+                ScannerProcess* const p = new ScannerProcess (executable, timeoutMs);
+                p->isBusy = true;
+                processes.add (p);
+                return p;
+            }
+        }
+
+        processFreed.wait (100);
+    }
+}
+
+void OutOfProcessPluginScanner::releaseProcess (ScannerProcess* const process)
+{
+    {
+        const ScopedLock sl (lock);
+        process->isBusy = false;
+    }
+
+    processFreed.signal();
+}
+
+bool OutOfProcessPluginScanner::findPluginTypesFor (AudioPluginFormat& format,
+                                                    OwnedArray <PluginDescription>& result,
+                                                    const String& fileOrIdentifier)
+{
+    ScannerProcess* const process = getFreeProcess();
+    const bool ok = process->scan (format, fileOrIdentifier, result);
+    releaseProcess (process);
+    return ok;
+}
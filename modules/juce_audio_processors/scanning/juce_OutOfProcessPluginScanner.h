@@ -0,0 +1,120 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_OUTOFPROCESSPLUGINSCANNER_JUCEHEADER__
+#define __JUCE_OUTOFPROCESSPLUGINSCANNER_JUCEHEADER__
+
+#include "juce_KnownPluginList.h"
+#include "../format/juce_AudioPluginFormatManager.h"
+
+
+//==============================================================================
+/**
+    A KnownPluginList::CustomScanner that loads each plugin in a separate child process.
+
+    Plugins that crash or hang while they're being scanned will only take down the child
+    process, which is then restarted for the next file, so the host can't be brought down
+    by a bad plugin. If a plugin crashes, or doesn't finish loading within the timeout, it
+    gets added to the list's blacklist.
+
+    Each call to findPluginTypesFor() uses one of a pool of child processes, so if several
+    threads are scanning at the same time (e.g. by calling PluginListComponent::
+    setNumberOfThreadsForScanning(), or by calling PluginDirectoryScanner::scanNextFile()
+    from your own threads), that many plugins can be scanned in parallel.
+
+    The child processes are launched by running your own app's executable again with a
+    special command-line argument, so your app must check for this when it starts, by
+    calling startScannerIfRequested() - e.g.
+
+    @code
+    void initialise (const String& commandLine)
+    {
+        formatManager.addDefaultFormats();
+
+        if (OutOfProcessPluginScanner::startScannerIfRequested (commandLine, formatManager))
+            return; // this is a scanner process, so don't create any windows!
+
+        knownPluginList.setCustomScanner (new OutOfProcessPluginScanner (4));
+        ...
+    @endcode
+
+    @see KnownPluginList::setCustomScanner, PluginDirectoryScanner
+*/
+class JUCE_API  OutOfProcessPluginScanner  : public KnownPluginList::CustomScanner
+{
+public:
+    //==============================================================================
+    /** Creates a scanner.
+
+        @param maxNumProcesses              the maximum number of child processes that will be
+                                            running at once
+        @param timeoutMillisecsPerPlugin    if a child takes longer than this to scan a file, it
+                                            is assumed to have hung, and is killed
+        @param scannerExecutable            the program to launch - if this is empty, the app's
+                                            own executable will be used
+    */
+    OutOfProcessPluginScanner (int maxNumProcesses,
+                               int timeoutMillisecsPerPlugin = 60000,
+                               const File& scannerExecutable = File::nonexistent);
+
+    /** Destructor. This will kill any child processes that are still running. */
+    ~OutOfProcessPluginScanner();
+
+    //==============================================================================
+    /** Checks whether this process was launched by an OutOfProcessPluginScanner, and if
+        so, starts serving requests from it.
+
+        Call this when your app starts up, before creating any windows. If it returns true,
+        the app should do nothing else - it will scan plugins using the formats in the
+        manager you pass in, and will quit when the host process disconnects. The
+        AudioPluginFormatManager must stay alive until the app quits.
+    */
+    static bool startScannerIfRequested (const String& commandLine,
+                                         AudioPluginFormatManager& formatManager);
+
+    //==============================================================================
+    /** @internal */
+    bool findPluginTypesFor (AudioPluginFormat&, OwnedArray <PluginDescription>&, const String&);
+
+private:
+    //==============================================================================
+    class ScannerProcess;
+    class ScannerConnection;
+    friend class ScannerProcess;
+    friend class ScannerConnection;
+
+    const int maxProcesses, timeoutMs;
+    const File executable;
+    OwnedArray<ScannerProcess> processes;
+    CriticalSection lock;
+    WaitableEvent processFreed;
+
+    ScannerProcess* getFreeProcess();
+    void releaseProcess (ScannerProcess*);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (OutOfProcessPluginScanner)
+};
+
+
+#endif   // __JUCE_OUTOFPROCESSPLUGINSCANNER_JUCEHEADER__
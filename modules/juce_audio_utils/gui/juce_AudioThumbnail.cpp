@@ -360,7 +360,8 @@ public:
     CachedWindow()
         : cachedStart (0), cachedTimePerPixel (0),
           numChannelsCached (0), numSamplesCached (0),
-          cacheNeedsRefilling (true)
+          firstChangedThumbSample (std::numeric_limits<int>::max()),
+          cacheNeedsRefilling (true), cacheIsFromThumbData (false)
     {
     }
 
@@ -369,6 +370,13 @@ public:
         cacheNeedsRefilling = true;
     }
 
+    // Called when thumbnail data has been written at or after the given thumbnail sample
+    // index: the columns before that point can be kept when the cache is next refilled.
+    void invalidateFrom (const int thumbSampleIndex)
+    {
+        firstChangedThumbSample = jmin (firstChangedThumbSample, thumbSampleIndex);
+    }
+
     void drawChannel (Graphics& g, const Rectangle<int>& area,
                       const double startTime, const double endTime,
                       const int channelNum, const float verticalZoomFactor,
@@ -383,34 +391,35 @@ public:
 
             if (! clip.isEmpty())
             {
-                const float topY = (float) area.getY();
-                const float bottomY = (float) area.getBottom();
-                const float midY = (topY + bottomY) * 0.5f;
-                const float vscale = verticalZoomFactor * (bottomY - topY) / 256.0f;
-
-                const MinMaxValue* cacheData = getData (channelNum, clip.getX() - area.getX());
+                // The waveform is filled as a single path rather than one line per pixel,
+                // which lets the renderer rasterise it in one pass. The path is kept until
+                // the cached levels, the height, or the zoom factor change.
+                const Path& path = getPath (channelNum, area.getHeight(), verticalZoomFactor);
 
-                int x = clip.getX();
-                for (int w = clip.getWidth(); --w >= 0;)
-                {
-                    if (cacheData->isNonZero())
-                        g.drawVerticalLine (x, jmax (midY - cacheData->getMaxValue() * vscale - 0.3f, topY),
-                                               jmin (midY - cacheData->getMinValue() * vscale + 0.3f, bottomY));
-
-                    ++x;
-                    ++cacheData;
-                }
+                g.fillPath (path, AffineTransform::translation ((float) area.getX(), (float) area.getY()));
             }
         }
     }
 
 private:
+    struct ChannelPath
+    {
+        ChannelPath() : height (-1), zoom (0), isValid (false) {}
+
+        Path path;
+        int height;
+        float zoom;
+        bool isValid;
+    };
+
     Array <MinMaxValue> data;
+    OwnedArray<ChannelPath> paths;
+    Array<float> columnTops, columnBottoms;
     double cachedStart, cachedTimePerPixel;
-    int numChannelsCached, numSamplesCached;
-    bool cacheNeedsRefilling;
+    int numChannelsCached, numSamplesCached, firstChangedThumbSample;
+    bool cacheNeedsRefilling, cacheIsFromThumbData;
 
-    bool refillCache (const int numSamples, double startTime, const double endTime,
+    bool refillCache (const int numSamples, const double startTime, const double endTime,
                       const double rate, const int numChans, const int sampsPerThumbSample,
                       LevelDataSource* levelData, const OwnedArray<ThumbData>& chans)
     {
@@ -422,13 +431,31 @@ private:
             return false;
         }
 
+        const int firstChanged = firstChangedThumbSample;
+        firstChangedThumbSample = std::numeric_limits<int>::max();
+
         if (numSamples == numSamplesCached
              && numChannelsCached == numChans
              && startTime == cachedStart
              && timePerPixel == cachedTimePerPixel
-             && ! cacheNeedsRefilling)
+             && ! cacheNeedsRefilling
+             && (cacheIsFromThumbData || firstChanged == std::numeric_limits<int>::max()))
         {
-            return ! cacheNeedsRefilling;
+            // When new data has only been appended (e.g. while recording), just the
+            // columns that it overlaps need to be recalculated.
+            if (firstChanged != std::numeric_limits<int>::max())
+            {
+                const double timeToThumbSampleFactor = rate / (double) sampsPerThumbSample;
+                const int firstColumn = jmax (0, (int) ((firstChanged / timeToThumbSampleFactor - cachedStart) / timePerPixel) - 1);
+
+                if (firstColumn < numSamplesCached)
+                {
+                    fillFromThumbData (firstColumn, sampsPerThumbSample, rate, chans);
+                    invalidatePaths();
+                }
+            }
+
+            return true;
         }
 
         numSamplesCached = numSamples;
@@ -436,18 +463,21 @@ private:
         cachedStart = startTime;
         cachedTimePerPixel = timePerPixel;
         cacheNeedsRefilling = false;
+        invalidatePaths();
 
         ensureSize (numSamples);
 
         if (timePerPixel * rate <= sampsPerThumbSample && levelData != nullptr)
         {
+            cacheIsFromThumbData = false;
+
             int sample = roundToInt (startTime * rate);
             Array<float> levels;
 
             int i;
             for (i = 0; i < numSamples; ++i)
             {
-                const int nextSample = roundToInt ((startTime + timePerPixel) * rate);
+                const int nextSample = roundToInt ((startTime + (i + 1) * timePerPixel) * rate);
 
                 if (sample >= 0)
                 {
@@ -463,7 +493,6 @@ private:
                                                      levels.getUnchecked (chan * 2 + 1));
                 }
 
-                startTime += timePerPixel;
                 sample = nextSample;
             }
 
@@ -471,32 +500,119 @@ private:
         }
         else
         {
-            jassert (chans.size() == numChannelsCached);
+            cacheIsFromThumbData = true;
+            fillFromThumbData (0, sampsPerThumbSample, rate, chans);
+        }
+
+        return true;
+    }
+
+    void fillFromThumbData (const int firstColumn, const int sampsPerThumbSample,
+                            const double rate, const OwnedArray<ThumbData>& chans)
+    {
+        jassert (chans.size() == numChannelsCached);
+
+        const double timeToThumbSampleFactor = rate / (double) sampsPerThumbSample;
 
-            for (int channelNum = 0; channelNum < numChannelsCached; ++channelNum)
+        for (int channelNum = 0; channelNum < numChannelsCached; ++channelNum)
+        {
+            ThumbData* channelData = chans.getUnchecked (channelNum);
+            MinMaxValue* cacheData = getData (channelNum, firstColumn);
+
+            int sample = roundToInt ((cachedStart + firstColumn * cachedTimePerPixel) * timeToThumbSampleFactor);
+
+            for (int i = firstColumn; i < numSamplesCached; ++i)
             {
-                ThumbData* channelData = chans.getUnchecked (channelNum);
-                MinMaxValue* cacheData = getData (channelNum, 0);
+                const int nextSample = roundToInt ((cachedStart + (i + 1) * cachedTimePerPixel) * timeToThumbSampleFactor);
 
-                const double timeToThumbSampleFactor = rate / (double) sampsPerThumbSample;
+                channelData->getMinMax (sample, nextSample, *cacheData);
+
+                ++cacheData;
+                sample = nextSample;
+            }
+        }
+    }
+
+    void invalidatePaths() noexcept
+    {
+        for (int i = paths.size(); --i >= 0;)
+            paths.getUnchecked (i)->isValid = false;
+    }
+
+    const Path& getPath (const int channelNum, const int height, const float verticalZoomFactor)
+    {
+        while (paths.size() <= channelNum)
+            paths.add (new ChannelPath());
+
+        ChannelPath& p = *paths.getUnchecked (channelNum);
+
+        if (! (p.isValid && p.height == height && p.zoom == verticalZoomFactor))
+        {
+            p.isValid = true;
+            p.height = height;
+            p.zoom = verticalZoomFactor;
+            buildPath (p.path, channelNum, (float) height, verticalZoomFactor);
+        }
+
+        return p.path;
+    }
+
+    // Creates an outline around each run of non-empty columns. Each column covers the same
+    // area that a one-pixel-wide vertical line between its min and max levels would.
+    void buildPath (Path& path, const int channelNum, const float height, const float verticalZoomFactor)
+    {
+        path.clear();
+
+        const float midY = height * 0.5f;
+        const float vscale = verticalZoomFactor * height / 256.0f;
+        const MinMaxValue* const cacheData = getData (channelNum, 0);
+
+        columnTops.resize (numSamplesCached);
+        columnBottoms.resize (numSamplesCached);
+        float* const tops = columnTops.getRawDataPointer();
+        float* const bottoms = columnBottoms.getRawDataPointer();
+
+        for (int x = 0; x < numSamplesCached;)
+        {
+            int end = x;
+
+            for (; end < numSamplesCached; ++end)
+            {
+                const MinMaxValue& v = cacheData[end];
+
+                if (! v.isNonZero())
+                    break;
 
-                startTime = cachedStart;
-                int sample = roundToInt (startTime * timeToThumbSampleFactor);
+                tops[end]    = jmax (midY - v.getMaxValue() * vscale - 0.3f, 0.0f);
+                bottoms[end] = jmin (midY - v.getMinValue() * vscale + 0.3f, height);
 
-                for (int i = numSamples; --i >= 0;)
+                if (bottoms[end] <= tops[end])
+                    break;
+            }
+
+            if (end > x)
+            {
+                path.startNewSubPath ((float) x, tops[x]);
+
+                for (int i = x; i < end; ++i)
                 {
-                    const int nextSample = roundToInt ((startTime + timePerPixel) * timeToThumbSampleFactor);
+                    if (i > x)
+                        path.lineTo ((float) i, tops[i]);
 
-                    channelData->getMinMax (sample, nextSample, *cacheData);
+                    path.lineTo ((float) (i + 1), tops[i]);
+                }
 
-                    ++cacheData;
-                    startTime += timePerPixel;
-                    sample = nextSample;
+                for (int i = end; --i >= x;)
+                {
+                    path.lineTo ((float) (i + 1), bottoms[i]);
+                    path.lineTo ((float) i, bottoms[i]);
                 }
+
+                path.closeSubPath();
             }
-        }
 
-        return true;
+            x = end + 1;
+        }
     }
 
     MinMaxValue* getData (const int channelNum, const int cacheIndex) noexcept
@@ -709,7 +825,52 @@ void AudioThumbnail::addBlock (const int64 startSample, const AudioSampleBuffer&
     }
 }
 
+void AudioThumbnail::setPeaks (const AudioPeakFile& peaks)
+{
+    reset (peaks.getNumChannels(), peaks.getSampleRate(), peaks.getLengthInSamples());
+    addPeaks (peaks, 0, peaks.getLengthInSamples());
+}
+
+void AudioThumbnail::addPeaks (const AudioPeakFile& peaks, const int64 startSample, const int64 numSamples)
+{
+    jassert (startSample >= 0);
+
+    const int firstThumbIndex = (int) (startSample / samplesPerThumbSample);
+    const int lastThumbIndex  = (int) ((startSample + numSamples + (samplesPerThumbSample - 1)) / samplesPerThumbSample);
+    const int numToDo = lastThumbIndex - firstThumbIndex;
+
+    if (numToDo > 0)
+    {
+        const int numChans = jmin (channels.size(), peaks.getNumChannels());
+
+        const HeapBlock<MinMaxValue> thumbData ((size_t) (numToDo * numChans));
+        const HeapBlock<MinMaxValue*> thumbChannels ((size_t) numChans);
+
+        for (int chan = 0; chan < numChans; ++chan)
+        {
+            MinMaxValue* const dest = thumbData + numToDo * chan;
+            thumbChannels [chan] = dest;
+
+            for (int i = 0; i < numToDo; ++i)
+            {
+                float low, high, rms;
+                peaks.getLevels ((firstThumbIndex + i) * (int64) samplesPerThumbSample, samplesPerThumbSample,
+                                 chan, low, high, rms);
+                dest[i].setFloat (low, high);
+            }
+        }
+
+        setLevels (thumbChannels, firstThumbIndex, numChans, numToDo);
+    }
+}
+
 void AudioThumbnail::setLevels (const MinMaxValue* const* values, int thumbIndex, int numChans, int numValues)
+{
+    writeLevels (values, thumbIndex, numChans, numValues);
+    sendChangeMessage();
+}
+
+void AudioThumbnail::writeLevels (const MinMaxValue* const* values, int thumbIndex, int numChans, int numValues)
 {
     const ScopedLock sl (lock);
 
@@ -723,8 +884,7 @@ void AudioThumbnail::setLevels (const MinMaxValue* const* values, int thumbIndex
         numSamplesFinished = end;
 
     totalSamples = jmax (numSamplesFinished, totalSamples);
-    window->invalidate();
-    sendChangeMessage();
+    window->invalidateFrom (thumbIndex);
 }
 
 //==============================================================================
@@ -107,10 +107,32 @@ public:
 
     /** Adds a block of level data to the thumbnail.
         Call reset() before using this, to tell the thumbnail about the data format.
+
+        This locks the thumbnail and updates it on the calling thread, so if you're
+        recording live audio, use an AudioThumbnailRecorder in your audio callback
+        instead of calling this directly.
     */
     void addBlock (int64 sampleNumberInSource, const AudioSampleBuffer& newData,
                    int startOffsetInBuffer, int numSamples);
 
+    /** Replaces the thumbnail's data with the levels from an AudioPeakFile.
+
+        This resets the thumbnail to match the format of the file that the peaks were
+        made from, and fills it in from the peaks, so no audio needs to be read at all.
+        @see addPeaks
+    */
+    void setPeaks (const AudioPeakFile& peaks);
+
+    /** Fills in a region of the thumbnail from an AudioPeakFile.
+
+        Call reset() before using this, to tell the thumbnail about the data format.
+        This is handy for filling in the thumbnail while the peaks are being built - you
+        can call it from AudioPeakFile::Listener::peaksReady() for each region that
+        becomes ready.
+        @see setPeaks, AudioPeakFile::build
+    */
+    void addPeaks (const AudioPeakFile& peaks, int64 startSample, int64 numSamples);
+
     //==============================================================================
     /** Reloads the low res thumbnail data from an input stream.
 
@@ -206,6 +228,7 @@ private:
     friend class OwnedArray<ThumbData>;
     friend class CachedWindow;
     friend class ScopedPointer<CachedWindow>;
+    friend class AudioThumbnailRecorder;
 
     ScopedPointer<LevelDataSource> source;
     ScopedPointer<CachedWindow> window;
@@ -220,6 +243,7 @@ private:
     void clearChannelData();
     bool setDataSource (LevelDataSource* newSource);
     void setLevels (const MinMaxValue* const* values, int thumbIndex, int numChans, int numValues);
+    void writeLevels (const MinMaxValue* const* values, int thumbIndex, int numChans, int numValues);
     void createChannels (int length);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioThumbnail)
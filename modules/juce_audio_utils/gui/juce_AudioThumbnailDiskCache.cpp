@@ -0,0 +1,455 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+
+/*  The cache file contains a header, followed by the data for each thumbnail, followed
+    by an index which lists the hash code, file position, size and last-used time of
+    each thumbnail.
+
+    New thumbnails are appended after the end of the file, followed by a new copy of the
+    index, and the header is only updated to point to the new index once that has been
+    written, so the previous contents remain valid if the app dies while doing this.
+*/
+namespace AudioThumbnailDiskCacheFormat
+{
+    enum
+    {
+        version = 1,
+        headerSize = 24,
+        indexEntrySize = 28,
+        maxPendingBytes = 1024 * 1024,
+        maxPendingThumbs = 64,
+        minUnusedBytesBeforeCompacting = 1024 * 1024
+    };
+
+    static inline int getMagicHeader() noexcept
+    {
+        return (int) ByteOrder::littleEndianInt ("ThmD");
+    }
+
+    static void writeHeader (OutputStream& out, const int64 indexOffset, const int numEntries)
+    {
+        out.writeInt (getMagicHeader());
+        out.writeInt (version);
+        out.writeInt64 (indexOffset);
+        out.writeInt (numEntries);
+        out.writeInt (0); // (reserved)
+    }
+
+    template <class IndexType>
+    static void writeIndex (OutputStream& out, const IndexType& index)
+    {
+        for (typename IndexType::Iterator i (index); i.next();)
+        {
+            out.writeInt64 (i.getKey());
+            out.writeInt64 (i.getValue().offset);
+            out.writeInt64 (i.getValue().lastUsed);
+            out.writeInt (i.getValue().size);
+        }
+    }
+}
+
+//==============================================================================
+class AudioThumbnailDiskCache::PendingThumb
+{
+public:
+    PendingThumb (const int64 hashCode) noexcept
+        : hash (hashCode), lastUsed (Time::currentTimeMillis())
+    {
+    }
+
+    int getSize() const noexcept    { return (int) data.getSize(); }
+
+    const int64 hash;
+    int64 lastUsed;
+    MemoryBlock data;
+
+private:
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PendingThumb)
+};
+
+//==============================================================================
+AudioThumbnailDiskCache::AudioThumbnailDiskCache (const File& file, const int64 maxBytes,
+                                                  const int maxNumThumbsInMemory)
+    : AudioThumbnailCache (maxNumThumbsInMemory),
+      cacheFile (file),
+      maxBytesOnDisk (maxBytes),
+      bytesUsed (0), pendingBytes (0), unusedBytesInFile (0),
+      indexNeedsWriting (false), fileNeedsRewriting (false)
+{
+    jassert (maxBytesOnDisk > 0);
+
+    openFile();
+
+    if (! readIndex())
+    {
+        index.clear();
+        bytesUsed = unusedBytesInFile = 0;
+        fileNeedsRewriting = true;
+    }
+}
+
+AudioThumbnailDiskCache::~AudioThumbnailDiskCache()
+{
+    flush();
+}
+
+void AudioThumbnailDiskCache::openFile()
+{
+    mappedFile = nullptr;
+
+    if (cacheFile.existsAsFile())
+    {
+        mappedFile = new MemoryMappedFile (cacheFile, MemoryMappedFile::readOnly);
+
+        if (mappedFile->getData() == nullptr)
+            mappedFile = nullptr;
+    }
+}
+
+bool AudioThumbnailDiskCache::readIndex()
+{
+    using namespace AudioThumbnailDiskCacheFormat;
+
+    if (mappedFile == nullptr || mappedFile->getSize() < (size_t) headerSize)
+        return false;
+
+    const int64 fileSize = (int64) mappedFile->getSize();
+    MemoryInputStream in (mappedFile->getData(), mappedFile->getSize(), false);
+
+    if (in.readInt() != getMagicHeader() || in.readInt() != version)
+        return false;
+
+    const int64 indexOffset = in.readInt64();
+    const int numEntries = in.readInt();
+
+    if (indexOffset < headerSize || numEntries < 0
+         || indexOffset + numEntries * (int64) indexEntrySize > fileSize)
+        return false;
+
+    in.setPosition (indexOffset);
+    index.remapTable (jmax (101, numEntries + numEntries / 2));
+
+    for (int i = 0; i < numEntries; ++i)
+    {
+        const int64 hash = in.readInt64();
+
+        IndexEntry entry;
+        entry.offset   = in.readInt64();
+        entry.lastUsed = in.readInt64();
+        entry.size     = in.readInt();
+
+        if (entry.offset < headerSize || entry.size <= 0 || entry.offset + entry.size > indexOffset)
+            return false;
+
+        if (! index.contains (hash))
+        {
+            index.set (hash, entry);
+            bytesUsed += entry.size;
+        }
+    }
+
+    unusedBytesInFile = fileSize - headerSize - bytesUsed - numEntries * (int64) indexEntrySize;
+    return true;
+}
+
+AudioThumbnailDiskCache::PendingThumb* AudioThumbnailDiskCache::findPendingThumb (const int64 hash) const
+{
+    for (int i = pendingThumbs.size(); --i >= 0;)
+        if (pendingThumbs.getUnchecked(i)->hash == hash)
+            return pendingThumbs.getUnchecked(i);
+
+    return nullptr;
+}
+
+//==============================================================================
+bool AudioThumbnailDiskCache::loadNewThumb (AudioThumbnailBase& thumb, const int64 hashCode)
+{
+    const ScopedLock sl (lock);
+
+    if (PendingThumb* const p = findPendingThumb (hashCode))
+    {
+        p->lastUsed = Time::currentTimeMillis();
+
+        MemoryInputStream in (p->data, false);
+        return thumb.loadFrom (in);
+    }
+
+    if (mappedFile != nullptr && index.contains (hashCode))
+    {
+        IndexEntry entry (index[hashCode]);
+        entry.lastUsed = Time::currentTimeMillis();
+        index.set (hashCode, entry);
+        indexNeedsWriting = true;
+
+        // (only the pages that this thumbnail occupies will actually get read from disk)
+        MemoryInputStream in (addBytesToPointer (mappedFile->getData(), entry.offset), (size_t) entry.size, false);
+
+        if (thumb.loadFrom (in))
+            return true;
+
+        removeStoredThumb (hashCode);
+    }
+
+    return false;
+}
+
+void AudioThumbnailDiskCache::saveNewlyFinishedThumbnail (const AudioThumbnailBase& thumb, const int64 hashCode)
+{
+    ScopedPointer<PendingThumb> newThumb (new PendingThumb (hashCode));
+
+    {
+        MemoryOutputStream out (newThumb->data, false);
+        thumb.saveTo (out);
+    }
+
+    const ScopedLock sl (lock);
+
+    removeStoredThumb (hashCode);
+
+    bytesUsed += newThumb->getSize();
+    pendingBytes += newThumb->getSize();
+    pendingThumbs.add (newThumb.release());
+
+    while (bytesUsed > maxBytesOnDisk && index.size() > 0)
+        removeOldestThumb();
+
+    if (pendingBytes >= AudioThumbnailDiskCacheFormat::maxPendingBytes
+         || pendingThumbs.size() >= AudioThumbnailDiskCacheFormat::maxPendingThumbs)
+        flush();
+}
+
+void AudioThumbnailDiskCache::removeStoredThumb (const int64 hash)
+{
+    if (index.contains (hash))
+    {
+        const int size = index[hash].size;
+        bytesUsed -= size;
+        unusedBytesInFile += size;
+
+        index.remove (hash);
+        indexNeedsWriting = true;
+    }
+
+    for (int i = pendingThumbs.size(); --i >= 0;)
+    {
+        if (pendingThumbs.getUnchecked(i)->hash == hash)
+        {
+            bytesUsed -= pendingThumbs.getUnchecked(i)->getSize();
+            pendingBytes -= pendingThumbs.getUnchecked(i)->getSize();
+            pendingThumbs.remove (i);
+        }
+    }
+}
+
+void AudioThumbnailDiskCache::removeOldestThumb()
+{
+    int64 oldestHash = 0, oldestTime = std::numeric_limits<int64>::max();
+
+    for (HashMap<int64, IndexEntry>::Iterator i (index); i.next();)
+    {
+        if (i.getValue().lastUsed < oldestTime)
+        {
+            oldestHash = i.getKey();
+            oldestTime = i.getValue().lastUsed;
+        }
+    }
+
+    removeStoredThumb (oldestHash);
+}
+
+//==============================================================================
+bool AudioThumbnailDiskCache::flush()
+{
+    const ScopedLock sl (lock);
+
+    if (pendingThumbs.size() == 0 && ! (indexNeedsWriting || fileNeedsRewriting))
+        return true;
+
+    const bool ok = (fileNeedsRewriting || mappedFile == nullptr
+                      || unusedBytesInFile > jmax ((int64) AudioThumbnailDiskCacheFormat::minUnusedBytesBeforeCompacting,
+                                                   bytesUsed - pendingBytes))
+                        ? rewriteFile() : appendToFile();
+
+    if (ok)
+    {
+        pendingThumbs.clear();
+        pendingBytes = 0;
+        indexNeedsWriting = fileNeedsRewriting = false;
+    }
+    else
+    {
+        fileNeedsRewriting = true;
+    }
+
+    openFile();
+    return ok;
+}
+
+bool AudioThumbnailDiskCache::appendToFile()
+{
+    using namespace AudioThumbnailDiskCacheFormat;
+
+    mappedFile = nullptr; // (a file can't be written while it's mapped on all platforms)
+
+    FileOutputStream out (cacheFile);
+
+    if (out.failedToOpen() || out.getPosition() < headerSize)
+        return false;
+
+    int64 position = out.getPosition();
+
+    for (int i = 0; i < pendingThumbs.size(); ++i)
+    {
+        const PendingThumb& p = *pendingThumbs.getUnchecked(i);
+        out.write (p.data.getData(), p.data.getSize());
+
+        IndexEntry entry;
+        entry.offset = position;
+        entry.lastUsed = p.lastUsed;
+        entry.size = p.getSize();
+        index.set (p.hash, entry);
+
+        position += entry.size;
+    }
+
+    writeIndex (out, index);
+    out.flush();
+
+    if (out.getStatus().wasOk() && out.setPosition (0))
+    {
+        writeHeader (out, position, index.size());
+        out.flush();
+
+        if (out.getStatus().wasOk())
+        {
+            unusedBytesInFile = position - headerSize - bytesUsed;
+            return true;
+        }
+    }
+
+    for (int i = 0; i < pendingThumbs.size(); ++i)
+        index.remove (pendingThumbs.getUnchecked(i)->hash);
+
+    return false;
+}
+
+bool AudioThumbnailDiskCache::rewriteFile()
+{
+    using namespace AudioThumbnailDiskCacheFormat;
+
+    TemporaryFile temp (cacheFile);
+    HashMap<int64, IndexEntry> newIndex (jmax (101, index.size() + pendingThumbs.size()));
+    int64 position = headerSize;
+
+    {
+        FileOutputStream out (temp.getFile());
+
+        if (out.failedToOpen())
+            return false;
+
+        writeHeader (out, 0, 0);
+
+        if (mappedFile != nullptr)
+        {
+            for (HashMap<int64, IndexEntry>::Iterator i (index); i.next();)
+            {
+                IndexEntry entry (i.getValue());
+
+                if (entry.offset + entry.size <= (int64) mappedFile->getSize())
+                {
+                    out.write (addBytesToPointer (mappedFile->getData(), entry.offset), (size_t) entry.size);
+                    entry.offset = position;
+                    newIndex.set (i.getKey(), entry);
+                    position += entry.size;
+                }
+            }
+        }
+
+        for (int i = 0; i < pendingThumbs.size(); ++i)
+        {
+            const PendingThumb& p = *pendingThumbs.getUnchecked(i);
+            out.write (p.data.getData(), p.data.getSize());
+
+            IndexEntry entry;
+            entry.offset = position;
+            entry.lastUsed = p.lastUsed;
+            entry.size = p.getSize();
+            newIndex.set (p.hash, entry);
+
+            position += entry.size;
+        }
+
+        writeIndex (out, newIndex);
+        out.flush();
+
+        if (! (out.getStatus().wasOk() && out.setPosition (0)))
+            return false;
+
+        writeHeader (out, position, newIndex.size());
+        out.flush();
+
+        if (! out.getStatus().wasOk())
+            return false;
+    }
+
+    mappedFile = nullptr;
+
+    if (! temp.overwriteTargetFileWithTemporary())
+        return false;
+
+    index.swapWith (newIndex);
+    bytesUsed = position - headerSize;
+    unusedBytesInFile = 0;
+    return true;
+}
+
+//==============================================================================
+void AudioThumbnailDiskCache::clearDiskCache()
+{
+    clear();
+
+    const ScopedLock sl (lock);
+
+    mappedFile = nullptr;
+    cacheFile.deleteFile();
+
+    index.clear();
+    pendingThumbs.clear();
+    bytesUsed = pendingBytes = unusedBytesInFile = 0;
+    indexNeedsWriting = false;
+    fileNeedsRewriting = true;
+}
+
+int AudioThumbnailDiskCache::getNumThumbsOnDisk() const
+{
+    const ScopedLock sl (lock);
+    return index.size() + pendingThumbs.size();
+}
+
+int64 AudioThumbnailDiskCache::getTotalBytesUsed() const
+{
+    const ScopedLock sl (lock);
+    return bytesUsed;
+}
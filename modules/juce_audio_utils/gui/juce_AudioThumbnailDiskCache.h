@@ -0,0 +1,133 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+
+#ifndef __JUCE_AUDIOTHUMBNAILDISKCACHE_JUCEHEADER__
+#define __JUCE_AUDIOTHUMBNAILDISKCACHE_JUCEHEADER__
+
+#include "juce_AudioThumbnailCache.h"
+
+
+//==============================================================================
+/**
+    An AudioThumbnailCache that keeps its thumbnails in a file on disk, so that
+    they survive between runs of your app.
+
+    All the thumbnails are kept in a single file, which holds their data followed
+    by an index of the hash codes. When the cache is created, it memory-maps this
+    file and reads just the index, so opening it is quick even when it holds many
+    thousands of thumbnails. A thumbnail's level data is only paged in from the
+    file when an AudioThumbnail actually asks the cache for it.
+
+    Newly-generated thumbnails are collected in memory and appended to the file
+    in batches (or when you call flush()). When the total size of the stored
+    thumbnails goes over the byte budget you give it, the least-recently used ones
+    are dropped, and the file is compacted once enough of it has become unused.
+
+    The base class's in-memory cache is still used for the thumbnails that were
+    used most recently, so its size can be kept small.
+
+    @see AudioThumbnailCache, AudioThumbnail
+*/
+class JUCE_API  AudioThumbnailDiskCache  : public AudioThumbnailCache
+{
+public:
+    //==============================================================================
+    /** Creates a cache which uses the given file.
+
+        If the file exists and was written by an AudioThumbnailDiskCache, its index
+        is loaded; otherwise it will be (re)created when the cache is next flushed.
+
+        @param cacheFile                the file in which to keep the thumbnails
+        @param maxBytesOnDisk           the size that the stored thumbnails may use
+                                        before the least-recently used ones are removed
+        @param maxNumThumbsInMemory     the size of the base class's in-memory cache
+    */
+    AudioThumbnailDiskCache (const File& cacheFile,
+                             int64 maxBytesOnDisk,
+                             int maxNumThumbsInMemory = 32);
+
+    /** Destructor.
+        This writes any thumbnails that haven't yet been saved to the file.
+    */
+    ~AudioThumbnailDiskCache();
+
+    //==============================================================================
+    /** Writes any newly-stored thumbnails and the updated index to the file.
+        Returns false if the file couldn't be written.
+    */
+    bool flush();
+
+    /** Deletes the cache file and forgets about all the thumbnails that it contains. */
+    void clearDiskCache();
+
+    /** Returns the file that this cache is using. */
+    const File& getCacheFile() const noexcept                   { return cacheFile; }
+
+    /** Returns the number of thumbnails that are currently stored. */
+    int getNumThumbsOnDisk() const;
+
+    /** Returns the total number of bytes used by the stored thumbnails. */
+    int64 getTotalBytesUsed() const;
+
+protected:
+    //==============================================================================
+    /** @internal */
+    void saveNewlyFinishedThumbnail (const AudioThumbnailBase&, int64 hashCode);
+    /** @internal */
+    bool loadNewThumb (AudioThumbnailBase&, int64 hashCode);
+
+private:
+    //==============================================================================
+    struct IndexEntry
+    {
+        int64 offset, lastUsed;
+        int size;
+    };
+
+    class PendingThumb;
+    friend class OwnedArray<PendingThumb>;
+
+    const File cacheFile;
+    const int64 maxBytesOnDisk;
+    ScopedPointer<MemoryMappedFile> mappedFile;
+    HashMap<int64, IndexEntry> index;
+    OwnedArray<PendingThumb> pendingThumbs;
+    int64 bytesUsed, pendingBytes, unusedBytesInFile;
+    bool indexNeedsWriting, fileNeedsRewriting;
+    CriticalSection lock;
+
+    void openFile();
+    bool readIndex();
+    PendingThumb* findPendingThumb (int64 hash) const;
+    void removeStoredThumb (int64 hash);
+    void removeOldestThumb();
+    bool appendToFile();
+    bool rewriteFile();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioThumbnailDiskCache)
+};
+
+
+#endif   // __JUCE_AUDIOTHUMBNAILDISKCACHE_JUCEHEADER__
@@ -0,0 +1,244 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+
+AudioThumbnailRecorder::AudioThumbnailRecorder (AudioThumbnail& thumbnailToWriteTo,
+                                                TimeSliceThread& backgroundThread)
+    : thumbnail (thumbnailToWriteTo),
+      thread (backgroundThread),
+      fifo (1),
+      numChannels (0), fifoSize (0), samplesPerThumbSample (1),
+      numSamplesInCurrent (0), currentIndex (0),
+      refreshIntervalMs (1000 / 30),
+      lastChangeMessageTime (0),
+      recording (false), changeMessagePending (false)
+{
+}
+
+AudioThumbnailRecorder::~AudioThumbnailRecorder()
+{
+    stopRecording();
+}
+
+void AudioThumbnailRecorder::setMaximumRefreshRate (const int updatesPerSecond) noexcept
+{
+    jassert (updatesPerSecond > 0);
+    refreshIntervalMs = 1000 / jmax (1, updatesPerSecond);
+}
+
+//==============================================================================
+void AudioThumbnailRecorder::startRecording (const int numChans, const double sampleRate, const int newFifoSize)
+{
+    jassert (numChans > 0 && newFifoSize > 0);
+
+    stopRecording();
+    thumbnail.reset (numChans, sampleRate);
+
+    numChannels = numChans;
+    fifoSize = jmax (1, newFifoSize);
+    samplesPerThumbSample = jmax (1, (int) thumbnail.samplesPerThumbSample);
+    numSamplesInCurrent = 0;
+    currentIndex = 0;
+    numDropped = 0;
+    changeMessagePending = false;
+
+    fifo.setTotalSize (fifoSize + 1);
+    fifoLevels.malloc ((size_t) (fifoSize * numChannels * 2));
+    fifoIndexes.malloc ((size_t) fifoSize);
+    currentLevels.calloc ((size_t) (numChannels * 2));
+    thumbLevels.malloc ((size_t) (fifoSize * numChannels));
+    thumbChannels.malloc ((size_t) numChannels);
+
+    recording = true;
+    thread.addTimeSliceClient (this);
+}
+
+void AudioThumbnailRecorder::stopRecording()
+{
+    if (recording)
+    {
+        thread.removeTimeSliceClient (this);
+        recording = false;
+
+        readLevelsFromFifo();
+
+        if (numSamplesInCurrent > 0)
+        {
+            writeLevels (currentLevels, currentIndex, 1);
+            numSamplesInCurrent = 0;
+        }
+
+        changeMessagePending = false;
+        thumbnail.sendChangeMessage();
+    }
+}
+
+//==============================================================================
+void AudioThumbnailRecorder::addBlock (const float* const* channelData, const int numChans, const int numSamples) noexcept
+{
+    addSamples (channelData, numChans, 0, numSamples);
+}
+
+void AudioThumbnailRecorder::addBlock (const AudioSampleBuffer& buffer, const int startOffsetInBuffer, const int numSamples) noexcept
+{
+    jassert (startOffsetInBuffer >= 0 && startOffsetInBuffer + numSamples <= buffer.getNumSamples());
+
+    addSamples (buffer.getArrayOfChannels(), buffer.getNumChannels(), startOffsetInBuffer, numSamples);
+}
+
+void AudioThumbnailRecorder::addSamples (const float* const* channelData, const int numChans,
+                                         const int startOffset, const int numSamples) noexcept
+{
+    // you need to call startRecording() before the audio starts!
+    jassert (recording);
+
+    if (! recording)
+        return;
+
+    for (int done = 0; done < numSamples;)
+    {
+        const int num = jmin (numSamples - done, samplesPerThumbSample - numSamplesInCurrent);
+
+        for (int chan = 0; chan < numChannels; ++chan)
+        {
+            float low = 0, high = 0;
+
+            if (chan < numChans && channelData[chan] != nullptr)
+                FloatVectorOperations::findMinAndMax (channelData[chan] + startOffset + done, num, low, high);
+
+            float* const current = currentLevels + chan * 2;
+
+            if (numSamplesInCurrent == 0)
+            {
+                current[0] = low;
+                current[1] = high;
+            }
+            else
+            {
+                current[0] = jmin (current[0], low);
+                current[1] = jmax (current[1], high);
+            }
+        }
+
+        done += num;
+        numSamplesInCurrent += num;
+
+        if (numSamplesInCurrent >= samplesPerThumbSample)
+        {
+            pushCurrentLevels();
+            numSamplesInCurrent = 0;
+            ++currentIndex;
+        }
+    }
+}
+
+void AudioThumbnailRecorder::pushCurrentLevels() noexcept
+{
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite (1, start1, size1, start2, size2);
+
+    if (size1 == 0)
+    {
+        ++numDropped;
+        return;
+    }
+
+    fifoIndexes[start1] = currentIndex;
+    memcpy (fifoLevels + start1 * numChannels * 2, currentLevels, sizeof (float) * (size_t) (numChannels * 2));
+    fifo.finishedWrite (1);
+}
+
+//==============================================================================
+int AudioThumbnailRecorder::useTimeSlice()
+{
+    readLevelsFromFifo();
+
+    if (changeMessagePending)
+    {
+        const uint32 now = Time::getMillisecondCounter();
+        const int elapsed = (int) (now - lastChangeMessageTime);
+
+        if (elapsed < refreshIntervalMs)
+            return refreshIntervalMs - elapsed;
+
+        changeMessagePending = false;
+        lastChangeMessageTime = now;
+        thumbnail.sendChangeMessage();
+    }
+
+    return refreshIntervalMs;
+}
+
+void AudioThumbnailRecorder::readLevelsFromFifo()
+{
+    const int numReady = fifo.getNumReady();
+
+    if (numReady > 0)
+    {
+        int start1, size1, start2, size2;
+        fifo.prepareToRead (numReady, start1, size1, start2, size2);
+
+        sendLevelsToThumbnail (start1, size1);
+        sendLevelsToThumbnail (start2, size2);
+
+        fifo.finishedRead (size1 + size2);
+        changeMessagePending = true;
+    }
+}
+
+void AudioThumbnailRecorder::sendLevelsToThumbnail (const int fifoStart, const int numToSend)
+{
+    // Levels that were dropped leave gaps in the indexes, so write each contiguous run separately.
+    for (int i = 0; i < numToSend;)
+    {
+        const int runStart = fifoStart + i;
+        int runLength = 1;
+
+        while (i + runLength < numToSend
+                && fifoIndexes[runStart + runLength] == fifoIndexes[runStart] + runLength)
+            ++runLength;
+
+        writeLevels (fifoLevels + runStart * numChannels * 2, fifoIndexes[runStart], runLength);
+        i += runLength;
+    }
+}
+
+void AudioThumbnailRecorder::writeLevels (const float* const levels, const int thumbIndex, const int numThumbSamples)
+{
+    jassert (numThumbSamples <= fifoSize);
+
+    for (int chan = 0; chan < numChannels; ++chan)
+    {
+        AudioThumbnail::MinMaxValue* const dest = thumbLevels + chan * fifoSize;
+        thumbChannels[chan] = dest;
+
+        for (int i = 0; i < numThumbSamples; ++i)
+        {
+            const float* const level = levels + (i * numChannels + chan) * 2;
+            dest[i].setFloat (level[0], level[1]);
+        }
+    }
+
+    thumbnail.writeLevels (thumbChannels, thumbIndex, numChannels, numThumbSamples);
+}
@@ -0,0 +1,155 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+
+#ifndef __JUCE_AUDIOTHUMBNAILRECORDER_JUCEHEADER__
+#define __JUCE_AUDIOTHUMBNAILRECORDER_JUCEHEADER__
+
+#include "juce_AudioThumbnail.h"
+
+
+//==============================================================================
+/**
+    Feeds live audio into an AudioThumbnail without locking or allocating on the
+    audio thread.
+
+    AudioThumbnail::addBlock() takes the thumbnail's lock and updates its data on
+    whatever thread calls it, which isn't something you want to do in an audio
+    callback. Instead, give your recording callback one of these: its addBlock()
+    method just works out the min and max levels of each incoming block and pushes
+    them into a lock-free FIFO. A TimeSliceThread then collects these and writes
+    them into the thumbnail, and sends the thumbnail's change message no more
+    often than the refresh rate you set.
+
+    E.g.
+    @code
+    // on the message thread, before the recording starts:
+    recorder.startRecording (2, 44100.0);
+
+    // in your audio callback:
+    recorder.addBlock (inputChannelData, numInputChannels, numSamples);
+
+    // on the message thread, after the audio has stopped:
+    recorder.stopRecording();
+    @endcode
+
+    @see AudioThumbnail
+*/
+class JUCE_API  AudioThumbnailRecorder  : private TimeSliceClient
+{
+public:
+    //==============================================================================
+    /** Creates a recorder that will write to the given thumbnail, using the given
+        thread to do the work.
+
+        Neither the thumbnail nor the thread must be deleted while this object exists.
+        If you don't have a thread to hand, AudioThumbnailCache::getTimeSliceThread()
+        is a good choice.
+    */
+    AudioThumbnailRecorder (AudioThumbnail& thumbnailToWriteTo,
+                            TimeSliceThread& backgroundThread);
+
+    /** Destructor.
+        If a recording is still in progress, this will stop it.
+    */
+    ~AudioThumbnailRecorder();
+
+    //==============================================================================
+    /** Clears the thumbnail and gets ready to record.
+
+        This allocates all the memory that addBlock() will need, so it must be called
+        before the audio thread starts calling addBlock().
+
+        @param numChannels      the number of channels that will be recorded
+        @param sampleRate       the sample rate of the recording
+        @param fifoSize         the number of thumbnail samples that the FIFO can hold.
+                                If the background thread can't keep up, any levels that
+                                don't fit in the FIFO will be lost.
+    */
+    void startRecording (int numChannels, double sampleRate, int fifoSize = 8192);
+
+    /** Writes any levels that are still waiting to the thumbnail, and stops the
+        background thread from processing them.
+
+        This mustn't be called while the audio thread could be inside addBlock().
+    */
+    void stopRecording();
+
+    /** Returns true if startRecording() has been called without a matching stopRecording(). */
+    bool isRecording() const noexcept                       { return recording; }
+
+    //==============================================================================
+    /** Adds some incoming audio to the recording.
+
+        This is safe to call on the audio thread: it doesn't lock, allocate or send
+        any messages. It must only ever be called by one thread at a time.
+
+        Any channels beyond the number passed to startRecording() are ignored, and any
+        channels whose pointer is null are treated as silent.
+    */
+    void addBlock (const float* const* channelData, int numChannels, int numSamples) noexcept;
+
+    /** Adds part of an AudioSampleBuffer to the recording.
+        @see addBlock
+    */
+    void addBlock (const AudioSampleBuffer& buffer, int startOffsetInBuffer, int numSamples) noexcept;
+
+    //==============================================================================
+    /** Sets the maximum number of times per second that the thumbnail's change
+        message is sent while recording. The default is 30.
+    */
+    void setMaximumRefreshRate (int updatesPerSecond) noexcept;
+
+    /** Returns the number of thumbnail samples that have been dropped because the FIFO
+        was full since recording started.
+    */
+    int getNumDroppedLevels() const noexcept                { return numDropped.get(); }
+
+private:
+    //==============================================================================
+    AudioThumbnail& thumbnail;
+    TimeSliceThread& thread;
+    AbstractFifo fifo;
+    HeapBlock<float> fifoLevels, currentLevels;
+    HeapBlock<int> fifoIndexes;
+    HeapBlock<AudioThumbnail::MinMaxValue> thumbLevels;
+    HeapBlock<AudioThumbnail::MinMaxValue*> thumbChannels;
+    int numChannels, fifoSize, samplesPerThumbSample, numSamplesInCurrent, currentIndex;
+    int refreshIntervalMs;
+    uint32 lastChangeMessageTime;
+    bool recording, changeMessagePending;
+    Atomic<int> numDropped;
+
+    int useTimeSlice();
+    void addSamples (const float* const* channelData, int numChans, int startOffset, int numSamples) noexcept;
+    void pushCurrentLevels() noexcept;
+    void readLevelsFromFifo();
+    void sendLevelsToThumbnail (int fifoStart, int numToSend);
+    void writeLevels (const float* levels, int thumbIndex, int numThumbSamples);
+
+    JUCE_DECLARE_NON_COPYABLE (AudioThumbnailRecorder)
+};
+
+
+#endif   // __JUCE_AUDIOTHUMBNAILRECORDER_JUCEHEADER__
@@ -351,6 +351,10 @@ void MidiKeyboardComponent::paint (Graphics& g)
     const Colour lineColour (findColour (keySeparatorLineColourId));
     const Colour textColour (findColour (textLabelColourId));
 
+    // When only a few keys have changed, only those keys will be in the clip region, so
+    // skip any keys that are outside it rather than drawing the whole keyboard.
+    const Rectangle<int> clip (g.getClipBounds());
+
     int octave;
 
     for (octave = 0; octave < 128; octave += 12)
@@ -363,9 +367,10 @@ void MidiKeyboardComponent::paint (Graphics& g)
             {
                 const Rectangle<int> pos (getWhiteNotePos (noteNum));
 
-                drawWhiteNote (noteNum, g, pos.getX(), pos.getY(), pos.getWidth(), pos.getHeight(),
-                               state.isNoteOnForChannels (midiInChannelMask, noteNum),
-                               mouseOverNotes.contains (noteNum), lineColour, textColour);
+                if (clip.intersects (pos.expanded (1)))
+                    drawWhiteNote (noteNum, g, pos.getX(), pos.getY(), pos.getWidth(), pos.getHeight(),
+                                   state.isNoteOnForChannels (midiInChannelMask, noteNum),
+                                   mouseOverNotes.contains (noteNum), lineColour, textColour);
             }
         }
     }
@@ -430,9 +435,10 @@ void MidiKeyboardComponent::paint (Graphics& g)
                     default: break;
                 }
 
-                drawBlackNote (noteNum, g, pos.getX(), pos.getY(), pos.getWidth(), pos.getHeight(),
-                               state.isNoteOnForChannels (midiInChannelMask, noteNum),
-                               mouseOverNotes.contains (noteNum), blackNoteColour);
+                if (clip.intersects (pos))
+                    drawBlackNote (noteNum, g, pos.getX(), pos.getY(), pos.getWidth(), pos.getHeight(),
+                                   state.isNoteOnForChannels (midiInChannelMask, noteNum),
+                                   mouseOverNotes.contains (noteNum), blackNoteColour);
             }
         }
     }
@@ -650,14 +656,45 @@ void MidiKeyboardComponent::resized()
 }
 
 //==============================================================================
-void MidiKeyboardComponent::handleNoteOn (MidiKeyboardState*, int /*midiChannel*/, int /*midiNoteNumber*/, float /*velocity*/)
+void MidiKeyboardComponent::handleNoteOn (MidiKeyboardState*, int midiChannel, int midiNoteNumber, float /*velocity*/)
+{
+    noteStateChanged (midiChannel, midiNoteNumber);
+}
+
+void MidiKeyboardComponent::handleNoteOff (MidiKeyboardState*, int midiChannel, int midiNoteNumber)
+{
+    noteStateChanged (midiChannel, midiNoteNumber);
+}
+
+void MidiKeyboardComponent::noteStateChanged (const int midiChannel, const int midiNoteNumber) noexcept
 {
-    shouldCheckState = true; // (probably being called from the audio thread, so avoid blocking in here)
+    // This is probably being called from the audio thread, so rather than blocking, it just
+    // sets a bit for the note, and the timer will repaint the keys that have actually changed.
+    if (isPositiveAndBelow (midiNoteNumber, 128)
+         && midiChannel > 0 && (midiInChannelMask & (1 << (midiChannel - 1))) != 0)
+    {
+        Atomic<int>& bits = notesToCheck [midiNoteNumber >> 5];
+        const int bit = 1 << (midiNoteNumber & 31);
+
+        for (;;)
+        {
+            const int oldBits = bits.get();
+
+            if ((oldBits & bit) != 0 || bits.compareAndSetBool (oldBits | bit, oldBits))
+                break;
+        }
+    }
 }
 
-void MidiKeyboardComponent::handleNoteOff (MidiKeyboardState*, int /*midiChannel*/, int /*midiNoteNumber*/)
+void MidiKeyboardComponent::updateKeyDrawnState (const int midiNoteNumber)
 {
-    shouldCheckState = true; // (probably being called from the audio thread, so avoid blocking in here)
+    const bool isOn = state.isNoteOnForChannels (midiInChannelMask, midiNoteNumber);
+
+    if (keysCurrentlyDrawnDown [midiNoteNumber] != isOn)
+    {
+        keysCurrentlyDrawnDown.setBit (midiNoteNumber, isOn);
+        repaintNote (midiNoteNumber);
+    }
 }
 
 //==============================================================================
@@ -806,12 +843,27 @@ void MidiKeyboardComponent::timerCallback()
     {
         shouldCheckState = false;
 
+        for (int i = 0; i < numElementsInArray (notesToCheck); ++i)
+            notesToCheck[i] = 0;
+
         for (int i = rangeStart; i <= rangeEnd; ++i)
+            updateKeyDrawnState (i);
+    }
+    else
+    {
+        for (int i = 0; i < numElementsInArray (notesToCheck); ++i)
         {
-            if (keysCurrentlyDrawnDown[i] != state.isNoteOnForChannels (midiInChannelMask, i))
+            const int bits = notesToCheck[i].exchange (0);
+
+            if (bits != 0)
             {
-                keysCurrentlyDrawnDown.setBit (i, state.isNoteOnForChannels (midiInChannelMask, i));
-                repaintNote (i);
+                for (int bit = 0; bit < 32; ++bit)
+                {
+                    const int noteNum = i * 32 + bit;
+
+                    if ((bits & (1 << bit)) != 0 && noteNum >= rangeStart && noteNum <= rangeEnd)
+                        updateKeyDrawnState (noteNum);
+                }
             }
         }
     }
@@ -381,6 +381,7 @@ private:
 
     Array<int> mouseOverNotes, mouseDownNotes;
     BigInteger keysPressed, keysCurrentlyDrawnDown;
+    Atomic<int> notesToCheck[4];
     bool shouldCheckState;
 
     int rangeStart, rangeEnd;
@@ -397,6 +398,8 @@ private:
     static const uint8 blackNotes[];
 
     void getKeyPos (int midiNoteNumber, int& x, int& w) const;
+    void noteStateChanged (int midiChannel, int midiNoteNumber) noexcept;
+    void updateKeyDrawnState (int midiNoteNumber);
     int xyToNote (Point<int>, float& mousePositionVelocity);
     int remappedXYToNote (Point<int>, float& mousePositionVelocity) const;
     void resetAnyKeysInUse();
@@ -45,7 +45,10 @@ namespace juce
 #include "gui/juce_AudioDeviceSelectorComponent.cpp"
 #include "gui/juce_AudioThumbnail.cpp"
 #include "gui/juce_AudioThumbnailCache.cpp"
+#include "gui/juce_AudioThumbnailDiskCache.cpp"
+#include "gui/juce_AudioThumbnailRecorder.cpp"
 #include "gui/juce_MidiKeyboardComponent.cpp"
+#include "players/juce_AudioProcessorOfflineRenderer.cpp"
 #include "players/juce_AudioProcessorPlayer.cpp"
 // END_AUTOINCLUDE
 
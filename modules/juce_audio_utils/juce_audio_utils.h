@@ -46,9 +46,18 @@ namespace juce
 #ifndef __JUCE_AUDIOTHUMBNAILCACHE_JUCEHEADER__
  #include "gui/juce_AudioThumbnailCache.h"
 #endif
+#ifndef __JUCE_AUDIOTHUMBNAILDISKCACHE_JUCEHEADER__
+ #include "gui/juce_AudioThumbnailDiskCache.h"
+#endif
+#ifndef __JUCE_AUDIOTHUMBNAILRECORDER_JUCEHEADER__
+ #include "gui/juce_AudioThumbnailRecorder.h"
+#endif
 #ifndef __JUCE_MIDIKEYBOARDCOMPONENT_JUCEHEADER__
  #include "gui/juce_MidiKeyboardComponent.h"
 #endif
+#ifndef __JUCE_AUDIOPROCESSOROFFLINERENDERER_JUCEHEADER__
+ #include "players/juce_AudioProcessorOfflineRenderer.h"
+#endif
 #ifndef __JUCE_AUDIOPROCESSORPLAYER_JUCEHEADER__
  #include "players/juce_AudioProcessorPlayer.h"
 #endif
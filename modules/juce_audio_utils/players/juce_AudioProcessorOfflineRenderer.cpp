@@ -0,0 +1,189 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+
+AudioProcessorOfflineRenderer::AudioProcessorOfflineRenderer (AudioProcessor& processorToRender)
+    : processor (processorToRender),
+      inputSource (nullptr),
+      midiInput (nullptr),
+      blockSize (4096),
+      numThreads (0),
+      shouldStop (false),
+      numSamplesRendered (0),
+      numSamplesToRender (0),
+      speedRelativeToRealtime (0)
+{
+}
+
+AudioProcessorOfflineRenderer::~AudioProcessorOfflineRenderer()
+{
+}
+
+//==============================================================================
+void AudioProcessorOfflineRenderer::setBlockSize (const int newBlockSize)
+{
+    jassert (newBlockSize > 0);
+    blockSize = jmax (1, newBlockSize);
+}
+
+void AudioProcessorOfflineRenderer::setNumThreads (const int newNumThreads)
+{
+    numThreads = jmax (0, newNumThreads);
+}
+
+void AudioProcessorOfflineRenderer::setInputSource (AudioSource* const source)
+{
+    inputSource = source;
+}
+
+void AudioProcessorOfflineRenderer::setMidiInput (const MidiMessageSequence* const sequence)
+{
+    midiInput = sequence;
+}
+
+void AudioProcessorOfflineRenderer::stop() noexcept
+{
+    shouldStop = true;
+}
+
+double AudioProcessorOfflineRenderer::getProgress() const noexcept
+{
+    return numSamplesToRender > 0 ? numSamplesRendered / (double) numSamplesToRender : 0.0;
+}
+
+//==============================================================================
+bool AudioProcessorOfflineRenderer::render (AudioFormatWriter& writer, const int64 numSamples)
+{
+    const double sampleRate = writer.getSampleRate();
+    const int numWriterChannels = writer.getNumChannels();
+    jassert (sampleRate > 0 && numWriterChannels > 0);
+
+    shouldStop = false;
+    numSamplesRendered = 0;
+    numSamplesToRender = numSamples;
+    speedRelativeToRealtime = 0;
+
+    const int numIns = processor.getNumInputChannels();
+    const int numOuts = processor.getNumOutputChannels();
+    const bool wasNonRealtime = processor.isNonRealtime();
+
+    AudioProcessorGraph* const graph = dynamic_cast <AudioProcessorGraph*> (&processor);
+    const int oldNumGraphThreads = graph != nullptr ? graph->getNumRenderingThreads() : 1;
+
+    processor.setNonRealtime (true);
+    processor.setPlayConfigDetails (numIns, numOuts, sampleRate, blockSize);
+    processor.setProcessingPrecision (AudioProcessor::singlePrecision);
+
+    if (graph != nullptr)
+        graph->setNumRenderingThreads (numThreads > 0 ? numThreads : SystemStats::getNumCpus());
+
+    processor.prepareToPlay (sampleRate, blockSize);
+
+    if (inputSource != nullptr)
+        inputSource->prepareToPlay (blockSize, sampleRate);
+
+    AudioSampleBuffer buffer (jmax (1, numIns, numOuts, numWriterChannels), blockSize);
+    MidiBuffer midi;
+    int nextMidiIndex = 0;
+    bool writtenOk = true;
+
+    const double startTime = Time::getMillisecondCounterHiRes();
+
+    for (int64 position = 0; position < numSamples && ! shouldStop;)
+    {
+        const int numThisTime = (int) jmin ((int64) blockSize, numSamples - position);
+        buffer.setSize (buffer.getNumChannels(), numThisTime, false, false, true);
+
+        if (inputSource != nullptr)
+        {
+            AudioSourceChannelInfo info (&buffer, 0, numThisTime);
+            inputSource->getNextAudioBlock (info);
+        }
+
+        for (int i = (inputSource != nullptr ? numIns : 0); i < buffer.getNumChannels(); ++i)
+            buffer.clear (i, 0, numThisTime);
+
+        midi.clear();
+        addMidiMessages (midi, nextMidiIndex, position, numThisTime, sampleRate);
+
+        {
+            const ScopedLock sl (processor.getCallbackLock());
+
+            if (processor.isSuspended())
+                buffer.clear();
+            else
+                processor.processBlock (buffer, midi);
+        }
+
+        for (int i = numOuts; i < numWriterChannels; ++i)
+            buffer.clear (i, 0, numThisTime);
+
+        if (! writer.writeFromFloatArrays (const_cast <const float**> (buffer.getArrayOfChannels()),
+                                           numWriterChannels, numThisTime))
+        {
+            writtenOk = false;
+            break;
+        }
+
+        position += numThisTime;
+        numSamplesRendered = position;
+
+        const double elapsedSeconds = (Time::getMillisecondCounterHiRes() - startTime) * 0.001;
+
+        if (elapsedSeconds > 0)
+            speedRelativeToRealtime = (position / sampleRate) / elapsedSeconds;
+    }
+
+    if (inputSource != nullptr)
+        inputSource->releaseResources();
+
+    processor.releaseResources();
+
+    if (graph != nullptr)
+        graph->setNumRenderingThreads (oldNumGraphThreads);
+
+    processor.setNonRealtime (wasNonRealtime);
+
+    return writtenOk && numSamplesRendered == numSamples;
+}
+
+void AudioProcessorOfflineRenderer::addMidiMessages (MidiBuffer& midi, int& nextMidiIndex, const int64 startSample,
+                                                     const int numSamples, const double sampleRate) const
+{
+    if (midiInput != nullptr)
+    {
+        const double endTime = (startSample + numSamples) / sampleRate;
+
+        for (; nextMidiIndex < midiInput->getNumEvents(); ++nextMidiIndex)
+        {
+            const MidiMessage& m = midiInput->getEventPointer (nextMidiIndex)->message;
+
+            if (m.getTimeStamp() >= endTime)
+                break;
+
+            const int samplePosition = (int) (roundToInt (m.getTimeStamp() * sampleRate) - startSample);
+            midi.addEvent (m, jlimit (0, numSamples - 1, samplePosition));
+        }
+    }
+}
@@ -0,0 +1,137 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+
+#ifndef __JUCE_AUDIOPROCESSOROFFLINERENDERER_JUCEHEADER__
+#define __JUCE_AUDIOPROCESSOROFFLINERENDERER_JUCEHEADER__
+
+#include "../../juce_audio_processors/processors/juce_AudioProcessor.h"
+
+
+//==============================================================================
+/**
+    Renders the output of an AudioProcessor into an AudioFormatWriter, as fast as
+    the processor can go.
+
+    Rather than pretending to be an audio device, this calls the processor directly
+    from render(), using much bigger blocks than a device would, and with the
+    processor's isNonRealtime() flag set, so that plugins can switch to their
+    offline-quality modes. If the processor is an AudioProcessorGraph, the flag is
+    passed on to all its nodes, and the graph is given some rendering threads so
+    that its independent branches are processed in parallel.
+
+    The processor mustn't be being played by anything else while it's being rendered.
+
+    @see AudioProcessorPlayer, AudioProcessorGraph::setNumRenderingThreads
+*/
+class JUCE_API  AudioProcessorOfflineRenderer
+{
+public:
+    //==============================================================================
+    /** Creates a renderer for the given processor, which must outlive it. */
+    explicit AudioProcessorOfflineRenderer (AudioProcessor& processorToRender);
+
+    /** Destructor. */
+    ~AudioProcessorOfflineRenderer();
+
+    //==============================================================================
+    /** Sets the number of samples that the processor is asked for in each call.
+        The default is 4096.
+    */
+    void setBlockSize (int newBlockSize);
+
+    /** Returns the block size that will be used. */
+    int getBlockSize() const noexcept                           { return blockSize; }
+
+    /** Sets the number of threads that an AudioProcessorGraph should be rendered with.
+        If this is 0 (the default), it uses one thread per CPU core. It has no effect on
+        other types of processor.
+    */
+    void setNumThreads (int numThreads);
+
+    /** Gives the renderer a source of audio to feed into the processor's inputs.
+        The source isn't owned by the renderer. It's prepared at the start of render(),
+        and released at the end. If there's no source, the inputs get silence.
+    */
+    void setInputSource (AudioSource* source);
+
+    /** Gives the renderer a sequence of midi messages to send to the processor.
+        The sequence isn't owned by the renderer, and its timestamps must be in seconds.
+    */
+    void setMidiInput (const MidiMessageSequence* sequence);
+
+    //==============================================================================
+    /** Prepares the processor, renders the given number of samples into the writer, and
+        then releases the processor again.
+
+        The sample rate and number of channels are taken from the writer. If the
+        processor has fewer outputs than the writer has channels, the others are silent.
+
+        This blocks until the render has finished, so you'll probably want to call it on a
+        background thread. You can call stop() from another thread to cancel it. (If the
+        processor is an AudioProcessorGraph, and this is called on a thread other than the
+        message thread, the message thread mustn't be blocked while it's waiting, because
+        the graph needs to lock it while it's being prepared).
+
+        @returns true if all the samples were rendered and written successfully
+    */
+    bool render (AudioFormatWriter& writer, int64 numSamplesToRender);
+
+    /** Makes a render() call that's in progress on another thread stop as soon as it has
+        finished its current block.
+    */
+    void stop() noexcept;
+
+    //==============================================================================
+    /** Returns the number of samples that the current (or last) render has produced. */
+    int64 getNumSamplesRendered() const noexcept                { return numSamplesRendered; }
+
+    /** Returns the proportion of the current (or last) render that has been completed,
+        from 0 to 1.
+    */
+    double getProgress() const noexcept;
+
+    /** Returns how fast the current (or last) render has been going, as a multiple of
+        real time. E.g. 10.0 means that 10 seconds of audio were rendered per second.
+    */
+    double getSpeedRelativeToRealtime() const noexcept          { return speedRelativeToRealtime; }
+
+private:
+    //==============================================================================
+    AudioProcessor& processor;
+    AudioSource* inputSource;
+    const MidiMessageSequence* midiInput;
+    int blockSize, numThreads;
+
+    volatile bool shouldStop;
+    volatile int64 numSamplesRendered, numSamplesToRender;
+    volatile double speedRelativeToRealtime;
+
+    void addMidiMessages (MidiBuffer&, int& nextMidiIndex, int64 startSample, int numSamples, double sampleRate) const;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioProcessorOfflineRenderer)
+};
+
+
+#endif   // __JUCE_AUDIOPROCESSOROFFLINERENDERER_JUCEHEADER__
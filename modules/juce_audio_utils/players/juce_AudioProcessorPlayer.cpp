@@ -27,9 +27,12 @@ AudioProcessorPlayer::AudioProcessorPlayer()
       sampleRate (0),
       blockSize (0),
       isPrepared (false),
+      useDoublePrecision (false),
+      denormalProtection (true),
       numInputChans (0),
       numOutputChans (0),
-      tempBuffer (1, 1)
+      tempBuffer (1, 1),
+      conversionBuffer (1, 1)
 {
 }
 
@@ -48,6 +51,10 @@ void AudioProcessorPlayer::setProcessor (AudioProcessor* const processorToPlay)
             processorToPlay->setPlayConfigDetails (numInputChans, numOutputChans,
                                                    sampleRate, blockSize);
 
+            processorToPlay->setProcessingPrecision (useDoublePrecision && processorToPlay->supportsDoublePrecisionProcessing()
+                                                        ? AudioProcessor::doublePrecision
+                                                        : AudioProcessor::singlePrecision);
+
             processorToPlay->prepareToPlay (sampleRate, blockSize);
         }
 
@@ -65,6 +72,22 @@ void AudioProcessorPlayer::setProcessor (AudioProcessor* const processorToPlay)
     }
 }
 
+void AudioProcessorPlayer::setDoublePrecisionProcessing (const bool shouldUseDoublePrecision)
+{
+    if (useDoublePrecision != shouldUseDoublePrecision)
+    {
+        useDoublePrecision = shouldUseDoublePrecision;
+
+        // the processor has to be re-prepared for its precision to change..
+        if (processor != nullptr && sampleRate > 0 && blockSize > 0)
+        {
+            AudioProcessor* const oldProcessor = processor;
+            setProcessor (nullptr);
+            setProcessor (oldProcessor);
+        }
+    }
+}
+
 //==============================================================================
 void AudioProcessorPlayer::audioDeviceIOCallback (const float** const inputChannelData,
                                                   const int numInputChannels,
@@ -75,6 +98,8 @@ void AudioProcessorPlayer::audioDeviceIOCallback (const float** const inputChann
     // these should have been prepared by audioDeviceAboutToStart()...
     jassert (sampleRate > 0 && blockSize > 0);
 
+    const ScopedNoDenormals noDenormals (denormalProtection);
+
     incomingMidi.clear();
     messageCollector.removeNextBlockOfMessages (incomingMidi, numSamples);
     int totalNumChans = 0;
@@ -131,6 +156,18 @@ void AudioProcessorPlayer::audioDeviceIOCallback (const float** const inputChann
             for (int i = 0; i < numOutputChannels; ++i)
                 zeromem (outputChannelData[i], sizeof (float) * (size_t) numSamples);
         }
+        else if (processor->isUsingDoublePrecision())
+        {
+            conversionBuffer.setSize (totalNumChans, numSamples, false, false, true);
+
+            for (int i = 0; i < totalNumChans; ++i)
+                conversionBuffer.copyFrom (i, 0, buffer, i, 0, numSamples);
+
+            processor->processBlock (conversionBuffer, incomingMidi);
+
+            for (int i = 0; i < totalNumChans; ++i)
+                conversionBuffer.copyTo (buffer, i, 0, i, 0, numSamples);
+        }
         else
         {
             processor->processBlock (buffer, incomingMidi);
@@ -154,6 +191,7 @@ void AudioProcessorPlayer::audioDeviceAboutToStart (AudioIODevice* const device)
 
     messageCollector.reset (sampleRate);
     channels.calloc (jmax (numChansIn, numChansOut) + 2);
+    conversionBuffer.setSize (jmax (1, numChansIn, numChansOut), jmax (1, newBlockSize));
 
     if (processor != nullptr)
     {
@@ -177,6 +215,7 @@ void AudioProcessorPlayer::audioDeviceStopped()
     blockSize = 0;
     isPrepared = false;
     tempBuffer.setSize (1, 1);
+    conversionBuffer.setSize (1, 1);
 }
 
 void AudioProcessorPlayer::handleIncomingMidiMessage (MidiInput*, const MidiMessage& message)
@@ -68,6 +68,32 @@ public:
     */
     MidiMessageCollector& getMidiMessageCollector()                 { return messageCollector; }
 
+    /** Chooses whether processors that support it should be run in double precision.
+
+        If this is enabled, any processor whose supportsDoublePrecisionProcessing() method
+        returns true will be prepared and called in double precision, with the device's
+        audio being converted to and from doubles around each call.
+        @see AudioProcessor::setProcessingPrecision
+    */
+    void setDoublePrecisionProcessing (bool shouldUseDoublePrecision);
+
+    /** Returns true if the player will use double precision wherever it can.
+        @see setDoublePrecisionProcessing
+    */
+    bool getDoublePrecisionProcessing() const noexcept              { return useDoublePrecision; }
+
+    /** Chooses whether the processor is called with denormalised number support turned off.
+        This is on by default, so that filters and reverbs don't get expensive as their
+        output decays into silence.
+        @see ScopedNoDenormals
+    */
+    void setDenormalProtection (bool shouldProtectAgainstDenormals) noexcept    { denormalProtection = shouldProtectAgainstDenormals; }
+
+    /** Returns true if the processor is called with denormalised number support turned off.
+        @see setDenormalProtection
+    */
+    bool hasDenormalProtection() const noexcept                     { return denormalProtection; }
+
     //==============================================================================
     /** @internal */
     void audioDeviceIOCallback (const float** inputChannelData,
@@ -88,11 +114,12 @@ private:
     CriticalSection lock;
     double sampleRate;
     int blockSize;
-    bool isPrepared;
+    bool isPrepared, useDoublePrecision, denormalProtection;
 
     int numInputChans, numOutputChans;
     HeapBlock<float*> channels;
     AudioSampleBuffer tempBuffer;
+    DoubleAudioSampleBuffer conversionBuffer;
 
     MidiBuffer incomingMidi;
     MidiMessageCollector messageCollector;
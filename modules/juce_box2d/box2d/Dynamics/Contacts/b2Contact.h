@@ -140,6 +140,7 @@ public:
 
 protected:
 	friend class b2ContactManager;
+	friend class b2ContactUpdateTask;
 	friend class b2World;
 	friend class b2ContactSolver;
 	friend class b2Body;
@@ -183,6 +184,12 @@ protected:
 
 	void Update(b2ContactListener* listener);
 
+	// Update() is split into these two halves so that the manifolds of many contacts can be
+	// evaluated in parallel. UpdateManifold() only modifies the contact itself, and returns
+	// whether it's touching. FinishUpdate() wakes the bodies and calls the listener.
+	bool UpdateManifold(b2Manifold* oldManifold);
+	void FinishUpdate(b2ContactListener* listener, const b2Manifold& oldManifold, bool touching);
+
 	static b2ContactRegister s_registers[b2Shape::e_typeCount][b2Shape::e_typeCount];
 	static bool s_initialized;
 
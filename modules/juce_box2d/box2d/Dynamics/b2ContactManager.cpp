@@ -21,10 +21,46 @@
 #include "b2Fixture.h"
 #include "b2WorldCallbacks.h"
 #include "Contacts/b2Contact.h"
+#include "../Common/b2StackAllocator.h"
 
 b2ContactFilter b2_defaultFilter;
 b2ContactListener b2_defaultListener;
 
+// A contact that's waiting to be updated by Collide().
+struct b2ContactUpdate
+{
+	b2Contact* contact;
+	b2Manifold oldManifold;
+	bool touching;
+	bool sensor;
+	bool active;
+};
+
+// Evaluates the manifolds of a list of contacts. Sensors are left for the calling
+// thread, because b2TestOverlap() updates some global statistics.
+class b2ContactUpdateTask : public b2Task
+{
+public:
+	b2ContactUpdateTask(b2ContactUpdate* updates) : m_updates(updates) {}
+
+	void Run(int32 begin, int32 end, int32 threadIndex)
+	{
+		B2_NOT_USED(threadIndex);
+
+		for (int32 i = begin; i < end; ++i)
+		{
+			b2ContactUpdate* u = m_updates + i;
+
+			if (u->active && u->sensor == false)
+			{
+				u->touching = u->contact->UpdateManifold(&u->oldManifold);
+			}
+		}
+	}
+
+	b2ContactUpdate* m_updates;
+};
+
 b2ContactManager::b2ContactManager()
 {
 	m_contactList = NULL;
@@ -102,8 +138,18 @@ void b2ContactManager::Destroy(b2Contact* c)
 // This is the top level collision call for the time step. Here
 // all the narrow phase collision is processed for the world
 // contact list.
-void b2ContactManager::Collide()
+void b2ContactManager::Collide(b2TaskExecutor* executor, b2StackAllocator* allocator)
 {
+	// When running in parallel, the contacts that persist are gathered up first, and
+	// are then updated in a separate pass.
+	b2ContactUpdate* updates = NULL;
+	int32 updateCount = 0;
+
+	if (executor)
+	{
+		updates = (b2ContactUpdate*)allocator->Allocate(b2Max(m_contactCount, 1) * sizeof(b2ContactUpdate));
+	}
+
 	// Update awake contacts.
 	b2Contact* c = m_contactList;
 	while (c)
@@ -146,6 +192,14 @@ void b2ContactManager::Collide()
 		// At least one body must be awake and it must be dynamic or kinematic.
 		if (activeA == false && activeB == false)
 		{
+			// (when running in parallel, an earlier contact may still wake one of the bodies)
+			if (updates)
+			{
+				b2ContactUpdate* u = updates + updateCount++;
+				u->contact = c;
+				u->active = false;
+			}
+
 			c = c->GetNext();
 			continue;
 		}
@@ -164,9 +218,72 @@ void b2ContactManager::Collide()
 		}
 
 		// The contact persists.
-		c->Update(m_contactListener);
+		if (updates)
+		{
+			b2ContactUpdate* u = updates + updateCount++;
+			u->contact = c;
+			u->sensor = fixtureA->IsSensor() || fixtureB->IsSensor();
+			u->active = true;
+		}
+		else
+		{
+			c->Update(m_contactListener);
+		}
+
 		c = c->GetNext();
 	}
+
+	if (updates)
+	{
+		b2ContactUpdateTask task(updates);
+		executor->RunTask(&task, updateCount);
+
+		// Waking bodies and calling the listener happens here, in the original order.
+		for (int32 i = 0; i < updateCount; ++i)
+		{
+			b2ContactUpdate* u = updates + i;
+
+			if (u->active == false)
+			{
+				// If one of its bodies has been woken by an earlier contact, this contact
+				// would have been updated in a serial step, so it's updated here instead.
+				c = u->contact;
+				b2Fixture* fixtureA = c->GetFixtureA();
+				b2Fixture* fixtureB = c->GetFixtureB();
+				b2Body* bodyA = fixtureA->GetBody();
+				b2Body* bodyB = fixtureB->GetBody();
+
+				bool activeA = bodyA->IsAwake() && bodyA->m_type != b2_staticBody;
+				bool activeB = bodyB->IsAwake() && bodyB->m_type != b2_staticBody;
+
+				if (activeA == false && activeB == false)
+				{
+					continue;
+				}
+
+				int32 proxyIdA = fixtureA->m_proxies[c->GetChildIndexA()].proxyId;
+				int32 proxyIdB = fixtureB->m_proxies[c->GetChildIndexB()].proxyId;
+
+				if (m_broadPhase.TestOverlap(proxyIdA, proxyIdB) == false)
+				{
+					Destroy(c);
+					continue;
+				}
+
+				c->Update(m_contactListener);
+			}
+			else if (u->sensor)
+			{
+				u->contact->Update(m_contactListener);
+			}
+			else
+			{
+				u->contact->FinishUpdate(m_contactListener, u->oldManifold, u->touching);
+			}
+		}
+
+		allocator->Free(updates);
+	}
 }
 
 void b2ContactManager::FindNewContacts()
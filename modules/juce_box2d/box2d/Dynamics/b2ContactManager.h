@@ -25,6 +25,8 @@ class b2Contact;
 class b2ContactFilter;
 class b2ContactListener;
 class b2BlockAllocator;
+class b2StackAllocator;
+class b2TaskExecutor;
 
 // Delegate of b2World.
 class b2ContactManager
@@ -39,7 +41,9 @@ public:
 
 	void Destroy(b2Contact* c);
 
-	void Collide();
+	// If an executor is supplied, the contact manifolds are evaluated in parallel,
+	// using the allocator for temporary storage.
+	void Collide(b2TaskExecutor* executor, b2StackAllocator* allocator);
 
 	b2BroadPhase m_broadPhase;
 	b2Contact* m_contactList;
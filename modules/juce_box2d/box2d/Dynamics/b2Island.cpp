@@ -162,6 +162,9 @@ b2Island::b2Island(
 	m_allocator = allocator;
 	m_listener = listener;
 
+	m_needsIndexes = false;
+	m_sharedBodyLock = NULL;
+
 	m_bodies = (b2Body**)m_allocator->Allocate(bodyCapacity * sizeof(b2Body*));
 	m_contacts = (b2Contact**)m_allocator->Allocate(contactCapacity	 * sizeof(b2Contact*));
 	m_joints = (b2Joint**)m_allocator->Allocate(jointCapacity * sizeof(b2Joint*));
@@ -180,12 +183,46 @@ b2Island::~b2Island()
 	m_allocator->Free(m_bodies);
 }
 
+void b2Island::Set(b2Body** bodies, int32 bodyCount, b2Contact** contacts, int32 contactCount,
+				   b2Joint** joints, int32 jointCount, b2TaskExecutor* sharedBodyLock)
+{
+	b2Assert(bodyCount <= m_bodyCapacity);
+	b2Assert(contactCount <= m_contactCapacity);
+	b2Assert(jointCount <= m_jointCapacity);
+
+	memcpy(m_bodies, bodies, bodyCount * sizeof(b2Body*));
+	memcpy(m_contacts, contacts, contactCount * sizeof(b2Contact*));
+	memcpy(m_joints, joints, jointCount * sizeof(b2Joint*));
+
+	m_bodyCount = bodyCount;
+	m_contactCount = contactCount;
+	m_jointCount = jointCount;
+
+	m_needsIndexes = true;
+	m_sharedBodyLock = sharedBodyLock;
+}
+
 void b2Island::Solve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& gravity, bool allowSleep)
 {
 	b2Timer timer;
 
 	float32 h = step.dt;
 
+	// The contact solver and joints look up each body's island index while they're
+	// being initialized, so the indexes must stay put until then.
+	if (m_needsIndexes)
+	{
+		if (m_sharedBodyLock)
+		{
+			m_sharedBodyLock->Lock();
+		}
+
+		for (int32 i = 0; i < m_bodyCount; ++i)
+		{
+			m_bodies[i]->m_islandIndex = i;
+		}
+	}
+
 	// Integrate velocities and apply damping. Initialize the body state.
 	for (int32 i = 0; i < m_bodyCount; ++i)
 	{
@@ -196,9 +233,13 @@ void b2Island::Solve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& g
 		b2Vec2 v = b->m_linearVelocity;
 		float32 w = b->m_angularVelocity;
 
-		// Store positions for continuous collision.
-		b->m_sweep.c0 = b->m_sweep.c;
-		b->m_sweep.a0 = b->m_sweep.a;
+		// Store positions for continuous collision. (Static bodies never move, and
+		// may be shared with other islands, so they're left alone).
+		if (b->m_type != b2_staticBody)
+		{
+			b->m_sweep.c0 = b->m_sweep.c;
+			b->m_sweep.a0 = b->m_sweep.a;
+		}
 
 		if (b->m_type == b2_dynamicBody)
 		{
@@ -253,6 +294,11 @@ void b2Island::Solve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& g
 		m_joints[i]->InitVelocityConstraints(solverData);
 	}
 
+	if (m_sharedBodyLock)
+	{
+		m_sharedBodyLock->Unlock();
+	}
+
 	profile->solveInit = timer.GetMilliseconds();
 
 	// Solve velocity constraints
@@ -330,6 +376,11 @@ void b2Island::Solve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& g
 	for (int32 i = 0; i < m_bodyCount; ++i)
 	{
 		b2Body* body = m_bodies[i];
+		if (body->m_type == b2_staticBody)
+		{
+			continue;
+		}
+
 		body->m_sweep.c = m_positions[i].c;
 		body->m_sweep.a = m_positions[i].a;
 		body->m_linearVelocity = m_velocities[i].v;
@@ -375,7 +426,10 @@ void b2Island::Solve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& g
 			for (int32 i = 0; i < m_bodyCount; ++i)
 			{
 				b2Body* b = m_bodies[i];
-				b->SetAwake(false);
+				if (b->GetType() != b2_staticBody)
+				{
+					b->SetAwake(false);
+				}
 			}
 		}
 	}
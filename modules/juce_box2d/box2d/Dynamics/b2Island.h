@@ -27,6 +27,7 @@ class b2Contact;
 class b2Joint;
 class b2StackAllocator;
 class b2ContactListener;
+class b2TaskExecutor;
 struct b2ContactVelocityConstraint;
 struct b2Profile;
 
@@ -69,6 +70,14 @@ public:
 		m_joints[m_jointCount++] = joint;
 	}
 
+	/// Fills the island with bodies, contacts and joints that were gathered elsewhere.
+	/// Unlike Add(), this doesn't touch the bodies: their island indexes get assigned by
+	/// Solve() instead, because a static body can belong to several islands that are being
+	/// solved at the same time. If sharedBodyLock is non-null, Solve() holds it for as
+	/// long as it needs the indexes of the bodies.
+	void Set(b2Body** bodies, int32 bodyCount, b2Contact** contacts, int32 contactCount,
+			 b2Joint** joints, int32 jointCount, b2TaskExecutor* sharedBodyLock);
+
 	void Report(const b2ContactVelocityConstraint* constraints);
 
 	b2StackAllocator* m_allocator;
@@ -88,6 +97,9 @@ public:
 	int32 m_bodyCapacity;
 	int32 m_contactCapacity;
 	int32 m_jointCapacity;
+
+	bool m_needsIndexes;
+	b2TaskExecutor* m_sharedBodyLock;
 };
 
 #endif
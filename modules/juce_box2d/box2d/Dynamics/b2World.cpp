@@ -39,6 +39,10 @@ b2World::b2World(const b2Vec2& gravity)
 	m_destructionListener = NULL;
 	m_debugDraw = NULL;
 
+	m_taskExecutor = NULL;
+	m_threadAllocators = NULL;
+	m_threadAllocatorCount = 0;
+
 	m_bodyList = NULL;
 	m_jointList = NULL;
 
@@ -82,6 +86,8 @@ b2World::~b2World()
 
 		b = bNext;
 	}
+
+	SetTaskExecutor(NULL);
 }
 
 void b2World::SetDestructionListener(b2DestructionListener* listener)
@@ -104,6 +110,37 @@ void b2World::SetDebugDraw(b2Draw* debugDraw)
 	m_debugDraw = debugDraw;
 }
 
+void b2World::SetTaskExecutor(b2TaskExecutor* executor)
+{
+	b2Assert(IsLocked() == false);
+	if (IsLocked())
+	{
+		return;
+	}
+
+	for (int32 i = 0; i < m_threadAllocatorCount; ++i)
+	{
+		m_threadAllocators[i].~b2StackAllocator();
+	}
+
+	b2Free(m_threadAllocators);
+	m_threadAllocators = NULL;
+	m_threadAllocatorCount = 0;
+
+	m_taskExecutor = executor;
+
+	if (executor)
+	{
+		m_threadAllocatorCount = b2Max(executor->GetThreadCount(), 1);
+		m_threadAllocators = (b2StackAllocator*)b2Alloc(m_threadAllocatorCount * sizeof(b2StackAllocator));
+
+		for (int32 i = 0; i < m_threadAllocatorCount; ++i)
+		{
+			new (m_threadAllocators + i) b2StackAllocator();
+		}
+	}
+}
+
 b2Body* b2World::CreateBody(const b2BodyDef* def)
 {
 	b2Assert(IsLocked() == false);
@@ -383,14 +420,81 @@ void b2World::SetAllowSleeping(bool flag)
 }
 
 // Find islands, integrate and solve constraints, solve position constraints
+// A section of the island that b2World::Solve() gathers when it's solving in parallel.
+struct b2IslandRange
+{
+	int32 bodyStart, bodyCount;
+	int32 contactStart, contactCount;
+	int32 jointStart, jointCount;
+	bool hasStaticBodies;
+	b2Profile profile;
+};
+
+// Solves a list of islands, each one using the stack allocator of the thread it's running on.
+class b2IslandTask : public b2Task
+{
+public:
+	void Run(int32 begin, int32 end, int32 threadIndex)
+	{
+		for (int32 i = begin; i < end; ++i)
+		{
+			b2IslandRange* r = m_ranges + i;
+
+			b2Island island(r->bodyCount, r->contactCount, r->jointCount,
+							m_allocators + threadIndex, m_source->m_listener);
+
+			island.Set(m_source->m_bodies + r->bodyStart, r->bodyCount,
+					   m_source->m_contacts + r->contactStart, r->contactCount,
+					   m_source->m_joints + r->jointStart, r->jointCount,
+					   r->hasStaticBodies ? m_executor : NULL);
+
+			island.Solve(&r->profile, *m_step, m_gravity, m_allowSleep);
+		}
+	}
+
+	const b2Island* m_source;
+	b2IslandRange* m_ranges;
+	b2StackAllocator* m_allocators;
+	b2TaskExecutor* m_executor;
+	const b2TimeStep* m_step;
+	b2Vec2 m_gravity;
+	bool m_allowSleep;
+};
+
+void b2World::SolveIslands(const b2Island& source, b2IslandRange* ranges, int32 rangeCount, const b2TimeStep& step)
+{
+	b2IslandTask task;
+	task.m_source = &source;
+	task.m_ranges = ranges;
+	task.m_allocators = m_threadAllocators;
+	task.m_executor = m_taskExecutor;
+	task.m_step = &step;
+	task.m_gravity = m_gravity;
+	task.m_allowSleep = m_allowSleep;
+
+	m_taskExecutor->RunTask(&task, rangeCount);
+
+	for (int32 i = 0; i < rangeCount; ++i)
+	{
+		m_profile.solveInit += ranges[i].profile.solveInit;
+		m_profile.solveVelocity += ranges[i].profile.solveVelocity;
+		m_profile.solvePosition += ranges[i].profile.solvePosition;
+	}
+}
+
 void b2World::Solve(const b2TimeStep& step)
 {
 	m_profile.solveInit = 0.0f;
 	m_profile.solveVelocity = 0.0f;
 	m_profile.solvePosition = 0.0f;
 
+	// When solving in parallel, all the islands are gathered up first and then solved
+	// together. Static bodies aren't propagated across, so they may appear in more
+	// than one island.
+	const bool parallel = m_threadAllocatorCount > 1;
+
 	// Size the island for the worst case.
-	b2Island island(m_bodyCount,
+	b2Island island(parallel ? m_bodyCount + m_contactManager.m_contactCount + m_jointCount : m_bodyCount,
 					m_contactManager.m_contactCount,
 					m_jointCount,
 					&m_stackAllocator,
@@ -413,6 +517,14 @@ void b2World::Solve(const b2TimeStep& step)
 	// Build and simulate all awake islands.
 	int32 stackSize = m_bodyCount;
 	b2Body** stack = (b2Body**)m_stackAllocator.Allocate(stackSize * sizeof(b2Body*));
+
+	b2IslandRange* ranges = NULL;
+	int32 rangeCount = 0;
+	if (parallel)
+	{
+		ranges = (b2IslandRange*)m_stackAllocator.Allocate(b2Max(m_bodyCount, 1) * sizeof(b2IslandRange));
+	}
+
 	for (b2Body* seed = m_bodyList; seed; seed = seed->m_next)
 	{
 		if (seed->m_flags & b2Body::e_islandFlag)
@@ -432,7 +544,14 @@ void b2World::Solve(const b2TimeStep& step)
 		}
 
 		// Reset island and stack.
-		island.Clear();
+		int32 bodyStart = island.m_bodyCount;
+		int32 contactStart = island.m_contactCount;
+		int32 jointStart = island.m_jointCount;
+		if (parallel == false)
+		{
+			island.Clear();
+		}
+
 		int32 stackCount = 0;
 		stack[stackCount++] = seed;
 		seed->m_flags |= b2Body::e_islandFlag;
@@ -527,6 +646,31 @@ void b2World::Solve(const b2TimeStep& step)
 			}
 		}
 
+		if (parallel)
+		{
+			b2IslandRange* r = ranges + rangeCount++;
+			r->bodyStart = bodyStart;
+			r->bodyCount = island.m_bodyCount - bodyStart;
+			r->contactStart = contactStart;
+			r->contactCount = island.m_contactCount - contactStart;
+			r->jointStart = jointStart;
+			r->jointCount = island.m_jointCount - jointStart;
+			r->hasStaticBodies = false;
+
+			// Allow static bodies to participate in other islands.
+			for (int32 i = bodyStart; i < island.m_bodyCount; ++i)
+			{
+				b2Body* b = island.m_bodies[i];
+				if (b->GetType() == b2_staticBody)
+				{
+					b->m_flags &= ~b2Body::e_islandFlag;
+					r->hasStaticBodies = true;
+				}
+			}
+
+			continue;
+		}
+
 		b2Profile profile;
 		island.Solve(&profile, step, m_gravity, m_allowSleep);
 		m_profile.solveInit += profile.solveInit;
@@ -545,6 +689,12 @@ void b2World::Solve(const b2TimeStep& step)
 		}
 	}
 
+	if (parallel)
+	{
+		SolveIslands(island, ranges, rangeCount, step);
+		m_stackAllocator.Free(ranges);
+	}
+
 	m_stackAllocator.Free(stack);
 
 	{
@@ -927,7 +1077,7 @@ void b2World::Step(float32 dt, int32 velocityIterations, int32 positionIteration
 	// Update contacts. This is where some contacts are destroyed.
 	{
 		b2Timer timer;
-		m_contactManager.Collide();
+		m_contactManager.Collide(m_threadAllocatorCount > 1 ? m_taskExecutor : NULL, &m_stackAllocator);
 		m_profile.collide = timer.GetMilliseconds();
 	}
 
@@ -30,9 +30,11 @@ struct b2AABB;
 struct b2BodyDef;
 struct b2Color;
 struct b2JointDef;
+struct b2IslandRange;
 class b2Body;
 class b2Draw;
 class b2Fixture;
+class b2Island;
 class b2Joint;
 
 /// The world class manages all physics entities, dynamic simulation,
@@ -66,6 +68,14 @@ public:
 	/// by you and must remain in scope.
 	void SetDebugDraw(b2Draw* debugDraw);
 
+	/// Register a task executor, which lets Step() evaluate contacts and solve separate
+	/// islands on several threads. The executor is owned by you and must remain in scope.
+	/// Pass NULL to do all the work on the thread that calls Step().
+	/// @warning while an executor is in use, b2ContactListener::PostSolve may be called
+	/// from any of its threads, and calls for different islands may overlap.
+	/// @warning This function is locked during callbacks.
+	void SetTaskExecutor(b2TaskExecutor* executor);
+
 	/// Create a rigid body given a definition. No reference to the definition
 	/// is retained.
 	/// @warning This function is locked during callbacks.
@@ -221,6 +231,7 @@ private:
 
 	void Solve(const b2TimeStep& step);
 	void SolveTOI(const b2TimeStep& step);
+	void SolveIslands(const b2Island& source, b2IslandRange* ranges, int32 rangeCount, const b2TimeStep& step);
 
 	void DrawJoint(b2Joint* joint);
 	void DrawShape(b2Fixture* shape, const b2Transform& xf, const b2Color& color);
@@ -244,6 +255,11 @@ private:
 	b2DestructionListener* m_destructionListener;
 	b2Draw* m_debugDraw;
 
+	// When solving in parallel, each thread has its own stack allocator.
+	b2TaskExecutor* m_taskExecutor;
+	b2StackAllocator* m_threadAllocators;
+	int32 m_threadAllocatorCount;
+
 	// This is used to compute the time step ratio to
 	// support a variable time step.
 	float32 m_inv_dt0;
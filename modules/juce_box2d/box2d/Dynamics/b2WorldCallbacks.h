@@ -152,4 +152,35 @@ public:
 									const b2Vec2& normal, float32 fraction) = 0;
 };
 
+/// A piece of work that a b2TaskExecutor can split across several threads.
+class b2Task
+{
+public:
+	virtual ~b2Task() {}
+
+	/// Performs the items in the range [begin, end).
+	/// @param threadIndex identifies the calling thread, in the range [0, GetThreadCount()).
+	virtual void Run(int32 begin, int32 end, int32 threadIndex) = 0;
+};
+
+/// Implement this class to let b2World::Step update contacts and solve separate islands
+/// on several threads. See b2World::SetTaskExecutor.
+class b2TaskExecutor
+{
+public:
+	virtual ~b2TaskExecutor() {}
+
+	/// Returns the number of threads, including the caller, that RunTask() may use.
+	virtual int32 GetThreadCount() const = 0;
+
+	/// Runs all the items in the range [0, count) by calling b2Task::Run() on one or more
+	/// threads, and returns when they have all finished. No two threads that are running
+	/// at the same time may be given the same thread index.
+	virtual void RunTask(b2Task* task, int32 count) = 0;
+
+	/// Enters and exits a lock that is shared by all the threads.
+	virtual void Lock() = 0;
+	virtual void Unlock() = 0;
+};
+
 #endif
@@ -86,4 +86,5 @@
 namespace juce
 {
 #include "utils/juce_Box2DRenderer.cpp"
+#include "utils/juce_Box2DTaskExecutor.cpp"
 }
@@ -33,6 +33,7 @@
 namespace juce
 {
   #include "utils/juce_Box2DRenderer.h"
+  #include "utils/juce_Box2DTaskExecutor.h"
 }
 
 #endif   // __JUCE_BOX2D_JUCEHEADER__
@@ -22,11 +22,26 @@
   ==============================================================================
 */
 
+// All the shapes of one colour, waiting to be drawn.
+// (Box2D's polygons are anticlockwise, and so are the ellipses that Path creates, so
+// overlapping filled shapes simply merge together under the non-zero winding rule).
+struct Box2DRenderer::ColourBatch
+{
+    ColourBatch (const b2Color& c)  : colour (c) {}
+
+    b2Color colour;
+    Path fill, outline;
+};
+
 Box2DRenderer::Box2DRenderer() noexcept   : graphics (nullptr)
 {
     SetFlags (e_shapeBit);
 }
 
+Box2DRenderer::~Box2DRenderer()
+{
+}
+
 void Box2DRenderer::render (Graphics& g, b2World& world,
                             float left, float top, float right, float bottom,
                             const Rectangle<float>& target)
@@ -39,6 +54,46 @@ void Box2DRenderer::render (Graphics& g, b2World& world,
 
     world.SetDebugDraw (this);
     world.DrawDebugData();
+
+    drawBatches();
+}
+
+Box2DRenderer::ColourBatch& Box2DRenderer::getBatch (const b2Color& c)
+{
+    // (there are only ever a handful of different colours, so a linear search is fine)
+    for (int i = 0; i < batches.size(); ++i)
+    {
+        ColourBatch& b = *batches.getUnchecked (i);
+
+        if (b.colour.r == c.r && b.colour.g == c.g && b.colour.b == c.b)
+            return b;
+    }
+
+    batches.add (new ColourBatch (c));
+    return *batches.getLast();
+}
+
+void Box2DRenderer::drawBatches()
+{
+    for (int i = 0; i < batches.size(); ++i)
+    {
+        ColourBatch& b = *batches.getUnchecked (i);
+
+        if (b.fill.isEmpty() && b.outline.isEmpty())
+            continue;
+
+        graphics->setColour (getColour (b.colour));
+
+        if (! b.fill.isEmpty())
+            graphics->fillPath (b.fill);
+
+        if (! b.outline.isEmpty())
+            graphics->strokePath (b.outline, PathStrokeType (getLineThickness()));
+
+        // (clearing the paths keeps their storage, so the next frame won't need to reallocate it)
+        b.fill.clear();
+        b.outline.clear();
+    }
 }
 
 Colour Box2DRenderer::getColour (const b2Color& c) const
@@ -57,45 +112,37 @@ static void createPath (Path& p, const b2Vec2* vertices, int32 vertexCount)
 
     for (int i = 1; i < vertexCount; ++i)
         p.lineTo (vertices[i].x, vertices[i].y);
+
+    p.closeSubPath();
 }
 
 void Box2DRenderer::DrawPolygon (const b2Vec2* vertices, int32 vertexCount, const b2Color& color)
 {
-    graphics->setColour (getColour (color));
-
-    Path p;
-    createPath (p, vertices, vertexCount);
-    graphics->strokePath (p, PathStrokeType (getLineThickness()));
+    createPath (getBatch (color).outline, vertices, vertexCount);
 }
 
 void Box2DRenderer::DrawSolidPolygon (const b2Vec2* vertices, int32 vertexCount, const b2Color& color)
 {
-    graphics->setColour (getColour (color));
-
-    Path p;
-    createPath (p, vertices, vertexCount);
-    graphics->fillPath (p);
+    createPath (getBatch (color).fill, vertices, vertexCount);
 }
 
 void Box2DRenderer::DrawCircle (const b2Vec2& center, float32 radius, const b2Color& color)
 {
-    graphics->setColour (getColour (color));
-    graphics->drawEllipse (center.x - radius, center.y - radius,
-                           radius * 2.0f, radius * 2.0f,
-                           getLineThickness());
+    getBatch (color).outline.addEllipse (center.x - radius, center.y - radius,
+                                         radius * 2.0f, radius * 2.0f);
 }
 
-void Box2DRenderer::DrawSolidCircle (const b2Vec2& center, float32 radius, const b2Vec2& axis, const b2Color& color)
+void Box2DRenderer::DrawSolidCircle (const b2Vec2& center, float32 radius, const b2Vec2& /*axis*/, const b2Color& color)
 {
-    graphics->setColour (getColour (color));
-    graphics->fillEllipse (center.x - radius, center.y - radius,
-                           radius * 2.0f, radius * 2.0f);
+    getBatch (color).fill.addEllipse (center.x - radius, center.y - radius,
+                                      radius * 2.0f, radius * 2.0f);
 }
 
 void Box2DRenderer::DrawSegment (const b2Vec2& p1, const b2Vec2& p2, const b2Color& color)
 {
-    graphics->setColour (getColour (color));
-    graphics->drawLine (p1.x, p1.y, p2.x, p2.y, getLineThickness());
+    Path& p = getBatch (color).outline;
+    p.startNewSubPath (p1.x, p1.y);
+    p.lineTo (p2.x, p2.y);
 }
 
 void Box2DRenderer::DrawTransform (const b2Transform&)
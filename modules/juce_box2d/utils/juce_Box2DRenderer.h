@@ -30,6 +30,11 @@
 
     To use it, simply create an instance of this class in your paint() method,
     and call its render() method.
+
+    Rather than drawing each shape as it arrives, the renderer gathers all the shapes
+    that share a colour into one path, and then draws each path with a single call at
+    the end of render(). So shapes of different colours may not overlap each other in
+    the same order that Box2D supplied them.
 */
 class Box2DRenderer   : public b2Draw
 
@@ -37,6 +42,9 @@ class Box2DRenderer   : public b2Draw
 public:
     Box2DRenderer() noexcept;
 
+    /** Destructor. */
+    ~Box2DRenderer();
+
     /** Renders the world.
 
         @param g        the context to render into
@@ -70,6 +78,13 @@ public:
 protected:
     Graphics* graphics;
 
+private:
+    struct ColourBatch;
+    OwnedArray<ColourBatch> batches;
+
+    ColourBatch& getBatch (const b2Color&);
+    void drawBatches();
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Box2DRenderer)
 };
 
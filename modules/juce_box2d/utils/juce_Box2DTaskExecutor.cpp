@@ -0,0 +1,142 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+
+class Box2DTaskExecutor::Worker  : public Thread
+{
+public:
+    Worker (Box2DTaskExecutor& o, int index)
+        : Thread ("Box2D worker"), owner (o), threadIndex (index)
+    {
+        startThread (8);
+    }
+
+    ~Worker()
+    {
+        signalThreadShouldExit();
+        start.signal();
+        stopThread (4000);
+    }
+
+    void run() override
+    {
+        for (;;)
+        {
+            start.wait (-1);
+
+            if (threadShouldExit())
+                break;
+
+            owner.runChunks (threadIndex);
+
+            if (--(owner.numWorkersBusy) == 0)
+                owner.finished.signal();
+        }
+    }
+
+    WaitableEvent start;
+
+private:
+    Box2DTaskExecutor& owner;
+    const int threadIndex;
+
+    JUCE_DECLARE_NON_COPYABLE (Worker)
+};
+
+//==============================================================================
+Box2DTaskExecutor::Box2DTaskExecutor (int numThreads)
+    : currentTask (nullptr), numItems (0), itemsPerChunk (1)
+{
+    if (numThreads <= 0)
+        numThreads = SystemStats::getNumCpus();
+
+    // (thread index 0 is used by the thread that calls RunTask)
+    for (int i = 1; i < numThreads; ++i)
+        workers.add (new Worker (*this, i));
+}
+
+Box2DTaskExecutor::~Box2DTaskExecutor()
+{
+    workers.clear();
+}
+
+int32 Box2DTaskExecutor::GetThreadCount() const
+{
+    return workers.size() + 1;
+}
+
+void Box2DTaskExecutor::RunTask (b2Task* task, int32 count)
+{
+    jassert (task != nullptr);
+
+    if (count <= 0)
+        return;
+
+    // Small jobs aren't worth waking the other threads for..
+    if (count == 1 || workers.size() == 0)
+    {
+        task->Run (0, count, 0);
+        return;
+    }
+
+    // The items are handed out in chunks, several per thread, so that a thread that
+    // gets a few expensive items doesn't hold everyone else up for too long.
+    currentTask = task;
+    numItems = count;
+    itemsPerChunk = jmax (1, count / (GetThreadCount() * 8));
+    nextItem = 0;
+    numWorkersBusy = workers.size();
+    finished.reset();
+
+    for (int i = workers.size(); --i >= 0;)
+        workers.getUnchecked (i)->start.signal();
+
+    runChunks (0);
+    finished.wait (-1);
+
+    currentTask = nullptr;
+}
+
+void Box2DTaskExecutor::runChunks (const int threadIndex)
+{
+    for (;;)
+    {
+        const int begin = (nextItem += itemsPerChunk) - itemsPerChunk;
+
+        if (begin >= numItems)
+            break;
+
+        currentTask->Run (begin, jmin (begin + itemsPerChunk, numItems), threadIndex);
+    }
+}
+
+void Box2DTaskExecutor::Lock()
+{
+    sharedLock.enter();
+}
+
+void Box2DTaskExecutor::Unlock()
+{
+    sharedLock.exit();
+}
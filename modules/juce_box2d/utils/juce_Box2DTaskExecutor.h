@@ -0,0 +1,79 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_BOX2DTASKEXECUTOR_JUCEHEADER__
+#define __JUCE_BOX2DTASKEXECUTOR_JUCEHEADER__
+
+//=============================================================================
+/** A set of worker threads that lets a b2World spread the work of each step across
+    several CPU cores.
+
+    Create one of these, and pass it to b2World::SetTaskExecutor(). Each call to
+    b2World::Step() will then evaluate its contacts and solve its separate islands
+    in parallel. The thread that calls Step() does its share of the work too, so an
+    executor with N threads only starts N - 1 threads of its own.
+
+    Bear in mind that while an executor is in use, a b2ContactListener's PostSolve()
+    method may be called on any of these threads.
+
+    The executor must not be deleted while it's still registered with a world.
+*/
+class Box2DTaskExecutor   : public b2TaskExecutor
+{
+public:
+    /** Creates an executor.
+        @param numThreads   the total number of threads to use, including the one that
+                            calls b2World::Step(). If this is 0 or less, it will use one
+                            thread for each CPU core.
+    */
+    explicit Box2DTaskExecutor (int numThreads = 0);
+
+    /** Destructor. */
+    ~Box2DTaskExecutor();
+
+    // b2TaskExecutor methods:
+    int32 GetThreadCount() const override;
+    void RunTask (b2Task*, int32 count) override;
+    void Lock() override;
+    void Unlock() override;
+
+private:
+    class Worker;
+    friend class Worker;
+
+    OwnedArray<Worker> workers;
+    CriticalSection sharedLock;
+    WaitableEvent finished;
+
+    b2Task* currentTask;
+    int numItems, itemsPerChunk;
+    Atomic<int> nextItem, numWorkersBusy;
+
+    void runChunks (int threadIndex);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Box2DTaskExecutor)
+};
+
+
+#endif   // __JUCE_BOX2DTASKEXECUTOR_JUCEHEADER__
@@ -231,4 +231,152 @@ public:
 
 static AbstractFifoTests fifoUnitTests;
 
+//==============================================================================
+class LockFreeQueueTests  : public UnitTest
+{
+public:
+    LockFreeQueueTests() : UnitTest ("Lock-free queues") {}
+
+    class QueueWriterThread  : public Thread
+    {
+    public:
+        QueueWriterThread (LockFreeQueue<String>& queue_, const int numToWrite_)
+            : Thread ("queue writer"), queue (queue_), numToWrite (numToWrite_)
+        {
+            startThread();
+        }
+
+        ~QueueWriterThread()
+        {
+            stopThread (5000);
+        }
+
+        void run()
+        {
+            Random r;
+            int n = 0;
+
+            while (n < numToWrite && ! threadShouldExit())
+            {
+                if (queue.getFreeSpace() == 0)
+                {
+                    wait (1);
+                }
+                else if (r.nextBool())
+                {
+                    if (queue.push (String (n)))
+                        ++n;
+                }
+                else
+                {
+                    String items [16];
+                    const int num = jmin (numToWrite - n, r.nextInt (16) + 1);
+
+                    for (int i = 0; i < num; ++i)
+                        items[i] = String (n + i);
+
+                    n += queue.pushMultiple (items, num);
+                }
+            }
+        }
+
+    private:
+        LockFreeQueue<String>& queue;
+        const int numToWrite;
+    };
+
+    class ConcurrentWriterThread  : public Thread
+    {
+    public:
+        ConcurrentWriterThread (ConcurrentQueue<int>& queue_, const int firstValue_, const int numToWrite_)
+            : Thread ("queue writer"), queue (queue_), firstValue (firstValue_), numToWrite (numToWrite_)
+        {
+            startThread();
+        }
+
+        ~ConcurrentWriterThread()
+        {
+            stopThread (5000);
+        }
+
+        void run()
+        {
+            for (int i = 0; i < numToWrite && ! threadShouldExit();)
+            {
+                if (queue.push (firstValue + i))
+                    ++i;
+                else
+                    wait (1);
+            }
+        }
+
+    private:
+        ConcurrentQueue<int>& queue;
+        const int firstValue, numToWrite;
+    };
+
+    void runTest()
+    {
+        beginTest ("LockFreeQueue");
+
+        {
+            const int numItems = 50000;
+            LockFreeQueue<String> queue (100);
+            expectEquals (queue.getCapacity(), 100);
+
+            QueueWriterThread writer (queue, numItems);
+
+            Random r;
+            int n = 0;
+            bool failed = false;
+
+            while (n < numItems && ! failed)
+            {
+                String items [20];
+                const int num = queue.popMultiple (items, r.nextInt (20) + 1);
+
+                for (int i = 0; i < num; ++i)
+                    failed = (items[i] != String (n++)) || failed;
+            }
+
+            expect (! failed, "read values were incorrect");
+            expect (queue.isEmpty());
+        }
+
+        beginTest ("ConcurrentQueue");
+
+        {
+            const int numWriters = 4, numPerWriter = 20000;
+            ConcurrentQueue<int> queue (50);
+            expectEquals (queue.getCapacity(), 64);
+
+            OwnedArray<ConcurrentWriterThread> writers;
+
+            for (int i = 0; i < numWriters; ++i)
+                writers.add (new ConcurrentWriterThread (queue, i * numPerWriter, numPerWriter));
+
+            int nextExpected [numWriters] = { 0 };
+            bool failed = false;
+
+            for (int numRead = 0; numRead < numWriters * numPerWriter && ! failed;)
+            {
+                int value;
+
+                if (queue.pop (value))
+                {
+                    const int writer = value / numPerWriter;
+                    failed = ! isPositiveAndBelow (writer, numWriters)
+                               || value % numPerWriter != nextExpected [writer]++;
+                    ++numRead;
+                }
+            }
+
+            expect (! failed, "read values were incorrect");
+            expectEquals (queue.getNumReady(), 0);
+        }
+    }
+};
+
+static LockFreeQueueTests lockFreeQueueUnitTests;
+
 #endif
@@ -56,11 +56,15 @@
     To make all the array's methods thread-safe, pass in "CriticalSection" as the templated
     TypeOfCriticalSectionToUse parameter, instead of the default DummyCriticalSection.
 
+    The AllocationPolicy parameter controls where the array's storage comes from - see
+    StandardAllocationPolicy and ArenaAllocationPolicy.
+
     @see OwnedArray, ReferenceCountedArray, StringArray, CriticalSection
 */
 template <typename ElementType,
           typename TypeOfCriticalSectionToUse = DummyCriticalSection,
-          int minimumAllocatedSize = 0>
+          int minimumAllocatedSize = 0,
+          class AllocationPolicy = StandardAllocationPolicy>
 class Array
 {
 private:
@@ -77,7 +81,7 @@ public:
     /** Creates a copy of another array.
         @param other    the array to copy
     */
-    Array (const Array<ElementType, TypeOfCriticalSectionToUse>& other)
+    Array (const Array& other)
     {
         const ScopedLockType lock (other.getLock());
         numUsed = other.numUsed;
@@ -88,8 +92,8 @@ public:
     }
 
    #if JUCE_COMPILER_SUPPORTS_MOVE_SEMANTICS
-    Array (Array<ElementType, TypeOfCriticalSectionToUse>&& other) noexcept
-        : data (static_cast <ArrayAllocationBase<ElementType, TypeOfCriticalSectionToUse>&&> (other.data)),
+    Array (Array&& other) noexcept
+        : data (static_cast <ArrayAllocationBase<ElementType, TypeOfCriticalSectionToUse, AllocationPolicy>&&> (other.data)),
           numUsed (other.numUsed)
     {
         other.numUsed = 0;
@@ -136,7 +140,7 @@ public:
     {
         if (this != &other)
         {
-            Array<ElementType, TypeOfCriticalSectionToUse> otherCopy (other);
+            Array otherCopy (other);
             swapWithArray (otherCopy);
         }
 
@@ -147,7 +151,7 @@ public:
     Array& operator= (Array&& other) noexcept
     {
         const ScopedLockType lock (getLock());
-        data = static_cast <ArrayAllocationBase<ElementType, TypeOfCriticalSectionToUse>&&> (other.data);
+        data = static_cast <ArrayAllocationBase<ElementType, TypeOfCriticalSectionToUse, AllocationPolicy>&&> (other.data);
         numUsed = other.numUsed;
         other.numUsed = 0;
         return *this;
@@ -1006,6 +1010,23 @@ public:
         sortArray (comparator, data.elements.getData(), 0, size() - 1, retainOrderOfEquivalentItems);
     }
 
+    /** Sorts the elements in the array, using the threads of a ThreadPool to do the work.
+
+        This is the same as the other sort() method, but for large arrays the work is split
+        between the pool's threads, using parallelSortArray(). The comparator's
+        compareElements() method will be called concurrently, so must be thread-safe.
+
+        @see sort, parallelSortArray
+    */
+    template <class ElementComparator>
+    void sort (ElementComparator& comparator,
+               ThreadPool& pool,
+               const bool retainOrderOfEquivalentItems = false) const
+    {
+        const ScopedLockType lock (getLock());
+        parallelSortArray (pool, comparator, data.elements.getData(), size(), retainOrderOfEquivalentItems);
+    }
+
     //==============================================================================
     /** Returns the CriticalSection that locks this array.
         To lock, you can call getLock().enter() and getLock().exit(), or preferably use
@@ -1019,7 +1040,7 @@ public:
 
 private:
     //==============================================================================
-    ArrayAllocationBase <ElementType, TypeOfCriticalSectionToUse> data;
+    ArrayAllocationBase <ElementType, TypeOfCriticalSectionToUse, AllocationPolicy> data;
     int numUsed;
 
     void removeInternal (const int indexToRemove)
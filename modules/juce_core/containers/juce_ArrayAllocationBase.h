@@ -42,9 +42,12 @@
     It inherits from a critical section class to allow the arrays to use
     the "empty base class optimisation" pattern to reduce their footprint.
 
+    The AllocationPolicy parameter determines where the storage comes from - see
+    StandardAllocationPolicy and ArenaAllocationPolicy.
+
     @see Array, OwnedArray, ReferenceCountedArray
 */
-template <class ElementType, class TypeOfCriticalSectionToUse>
+template <class ElementType, class TypeOfCriticalSectionToUse, class AllocationPolicy = StandardAllocationPolicy>
 class ArrayAllocationBase  : public TypeOfCriticalSectionToUse
 {
 public:
@@ -61,15 +64,15 @@ public:
     }
 
    #if JUCE_COMPILER_SUPPORTS_MOVE_SEMANTICS
-    ArrayAllocationBase (ArrayAllocationBase<ElementType, TypeOfCriticalSectionToUse>&& other) noexcept
-        : elements (static_cast <HeapBlock <ElementType>&&> (other.elements)),
+    ArrayAllocationBase (ArrayAllocationBase&& other) noexcept
+        : elements (static_cast <HeapBlock <ElementType, false, AllocationPolicy>&&> (other.elements)),
           numAllocated (other.numAllocated)
     {
     }
 
-    ArrayAllocationBase& operator= (ArrayAllocationBase<ElementType, TypeOfCriticalSectionToUse>&& other) noexcept
+    ArrayAllocationBase& operator= (ArrayAllocationBase&& other) noexcept
     {
-        elements = static_cast <HeapBlock <ElementType>&&> (other.elements);
+        elements = static_cast <HeapBlock <ElementType, false, AllocationPolicy>&&> (other.elements);
         numAllocated = other.numAllocated;
         return *this;
     }
@@ -120,14 +123,14 @@ public:
     }
 
     /** Swap the contents of two objects. */
-    void swapWith (ArrayAllocationBase <ElementType, TypeOfCriticalSectionToUse>& other) noexcept
+    void swapWith (ArrayAllocationBase& other) noexcept
     {
         elements.swapWith (other.elements);
         std::swap (numAllocated, other.numAllocated);
     }
 
     //==============================================================================
-    HeapBlock <ElementType> elements;
+    HeapBlock <ElementType, false, AllocationPolicy> elements;
     int numAllocated;
 
 private:
@@ -0,0 +1,260 @@
+/*
+  ==============================================================================
+
+   This file is part of the juce_core module of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission to use, copy, modify, and/or distribute this software for any purpose with
+   or without fee is hereby granted, provided that the above copyright notice and this
+   permission notice appear in all copies.
+
+   THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+   TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+   NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+   DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+   IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+   ------------------------------------------------------------------------------
+
+   NOTE! This permissive ISC license applies ONLY to files within the juce_core module!
+   All other JUCE modules are covered by a dual GPL/commercial license, so if you are
+   using any other modules, be sure to check that you also comply with their license.
+
+   For more details, visit www.juce.com
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_CONCURRENTQUEUE_JUCEHEADER__
+#define __JUCE_CONCURRENTQUEUE_JUCEHEADER__
+
+#include "../memory/juce_Atomic.h"
+#include "../memory/juce_HeapBlock.h"
+
+
+//==============================================================================
+/**
+    A bounded, lock-free queue that any number of threads can push to and pop from.
+
+    The queue is a ring of slots, each holding a sequence number that tells a thread
+    whether the slot is ready to be written or read, so pushing or popping an item only
+    needs a single compare-and-swap in the common case. Neither operation ever blocks
+    or allocates, so this is suitable for sending messages to or from an audio thread.
+
+    The capacity is rounded up to the next power of two. Items are constructed in place
+    by push() and destroyed by pop(), and will be moved rather than copied if your
+    compiler supports rvalue references, so move-only types can be used.
+
+    If there's only ever a single reader and a single writer, a LockFreeQueue will be a
+    little faster.
+
+    @see LockFreeQueue, AbstractFifo
+*/
+template <typename ElementType>
+class ConcurrentQueue
+{
+public:
+    //==============================================================================
+    /** Creates a queue that can hold at least the given number of items. */
+    explicit ConcurrentQueue (const int minimumCapacity)
+        : mask ((uint32) nextPowerOfTwo (jmax (2, minimumCapacity)) - 1),
+          storage ((size_t) (mask + 1) * sizeof (ElementType)),
+          sequences ((size_t) (mask + 1))
+    {
+        jassert (minimumCapacity > 0);
+        resetSequences();
+    }
+
+    /** Destructor.
+        Any items that are still in the queue will be deleted.
+    */
+    ~ConcurrentQueue()
+    {
+        clear();
+    }
+
+    //==============================================================================
+    /** Returns the maximum number of items that the queue can hold. */
+    int getCapacity() const noexcept                { return (int) mask + 1; }
+
+    /** Returns the approximate number of items waiting in the queue.
+        If other threads are using the queue, this may be out-of-date by the time it returns.
+    */
+    int getNumReady() const noexcept                { return jlimit (0, getCapacity(), (int) (writePosition.get() - readPosition.get())); }
+
+    /** Deletes any items that are waiting in the queue.
+        This isn't thread-safe, so it must only be called when no other threads could
+        be using the queue.
+    */
+    void clear()
+    {
+        for (uint32 pos = readPosition.get(); pos != writePosition.get(); ++pos)
+            getSlot (pos)->~ElementType();
+
+        readPosition = 0;
+        writePosition = 0;
+        resetSequences();
+    }
+
+    //==============================================================================
+    /** Adds a copy of an item to the end of the queue.
+        @returns false if the queue was full, in which case nothing is added
+    */
+    bool push (const ElementType& item)
+    {
+        uint32 pos;
+
+        if (! claimSlotForWriting (pos))
+            return false;
+
+        new (getSlot (pos)) ElementType (item);
+        sequences[pos & mask] = pos + 1;
+        return true;
+    }
+
+   #if JUCE_COMPILER_SUPPORTS_MOVE_SEMANTICS
+    /** Moves an item onto the end of the queue.
+        @returns false if the queue was full, in which case the item is left untouched
+    */
+    bool push (ElementType&& item)
+    {
+        uint32 pos;
+
+        if (! claimSlotForWriting (pos))
+            return false;
+
+        new (getSlot (pos)) ElementType (static_cast<ElementType&&> (item));
+        sequences[pos & mask] = pos + 1;
+        return true;
+    }
+   #endif
+
+    /** Adds copies of as many items from an array as will fit into the queue.
+        If other threads are also pushing, the items may be interleaved with theirs.
+        @returns the number of items that were actually added
+    */
+    int pushMultiple (const ElementType* items, const int numItems)
+    {
+        int numDone = 0;
+
+        while (numDone < numItems && push (items[numDone]))
+            ++numDone;
+
+        return numDone;
+    }
+
+    //==============================================================================
+    /** Removes the item at the front of the queue.
+        @returns false if the queue was empty, in which case result is left unchanged
+    */
+    bool pop (ElementType& result)
+    {
+        uint32 pos;
+
+        if (! claimSlotForReading (pos))
+            return false;
+
+        ElementType* const e = getSlot (pos);
+
+       #if JUCE_COMPILER_SUPPORTS_MOVE_SEMANTICS
+        result = static_cast<ElementType&&> (*e);
+       #else
+        result = *e;
+       #endif
+
+        e->~ElementType();
+        sequences[pos & mask] = pos + mask + 1;
+        return true;
+    }
+
+    /** Removes up to the given number of items from the front of the queue.
+        @returns the number of items that were actually removed and stored in the
+                 destination array
+    */
+    int popMultiple (ElementType* dest, const int maxItems)
+    {
+        int numDone = 0;
+
+        while (numDone < maxItems && pop (dest[numDone]))
+            ++numDone;
+
+        return numDone;
+    }
+
+private:
+    //==============================================================================
+    enum { cacheLineSize = 64 };
+
+    const uint32 mask;
+    HeapBlock<char> storage;
+    HeapBlock<Atomic<uint32> > sequences;
+
+    // The positions are kept on separate cache lines, so that readers and writers
+    // don't keep stealing the line from each other.
+    char padding1 [cacheLineSize];
+    Atomic<uint32> writePosition;
+    char padding2 [cacheLineSize - sizeof (Atomic<uint32>)];
+    Atomic<uint32> readPosition;
+    char padding3 [cacheLineSize - sizeof (Atomic<uint32>)];
+
+    ElementType* getSlot (const uint32 pos) const noexcept
+    {
+        return reinterpret_cast<ElementType*> (storage + (size_t) (pos & mask) * sizeof (ElementType));
+    }
+
+    void resetSequences() noexcept
+    {
+        for (uint32 i = 0; i <= mask; ++i)
+            sequences[i] = i;
+    }
+
+    bool claimSlotForWriting (uint32& pos) noexcept
+    {
+        pos = writePosition.get();
+
+        for (;;)
+        {
+            const int diff = (int) (sequences[pos & mask].get() - pos);
+
+            if (diff == 0)
+            {
+                if (writePosition.compareAndSetBool (pos + 1, pos))
+                    return true;
+            }
+            else if (diff < 0)
+            {
+                return false; // full
+            }
+
+            pos = writePosition.get();
+        }
+    }
+
+    bool claimSlotForReading (uint32& pos) noexcept
+    {
+        pos = readPosition.get();
+
+        for (;;)
+        {
+            const int diff = (int) (sequences[pos & mask].get() - (pos + 1));
+
+            if (diff == 0)
+            {
+                if (readPosition.compareAndSetBool (pos + 1, pos))
+                    return true;
+            }
+            else if (diff < 0)
+            {
+                return false; // empty
+            }
+
+            pos = readPosition.get();
+        }
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (ConcurrentQueue)
+};
+
+
+#endif   // __JUCE_CONCURRENTQUEUE_JUCEHEADER__
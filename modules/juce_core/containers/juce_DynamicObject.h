@@ -114,6 +114,15 @@ public:
     /** Returns the NamedValueSet that holds the object's properties. */
     NamedValueSet& getProperties() noexcept     { return properties; }
 
+    //==============================================================================
+    /** DynamicObjects take their memory from the current MemoryArena, if there is one.
+        This means that a big structure such as a parsed JSON document can be built inside
+        a MemoryArena::ScopedUse without an individual heap allocation for each object.
+        @see ArenaAllocationPolicy
+    */
+    static void* operator new (size_t size)     { return ArenaAllocationPolicy::allocate (size); }
+    static void operator delete (void* p)       { ArenaAllocationPolicy::release (p); }
+
 private:
     //==============================================================================
     NamedValueSet properties;
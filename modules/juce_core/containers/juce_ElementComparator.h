@@ -30,6 +30,22 @@
 #define __JUCE_ELEMENTCOMPARATOR_JUCEHEADER__
 
 
+//==============================================================================
+/** Adapts an object with a compareElements() method into the kind of less-than
+    predicate that the standard library's sorting and searching functions expect.
+*/
+template <class ElementComparator>
+struct SortFunctionConverter
+{
+    SortFunctionConverter (ElementComparator& e) noexcept  : comparator (e) {}
+
+    template <typename Type>
+    bool operator() (Type a, Type b)    { return comparator.compareElements (a, b) < 0; }
+
+private:
+    ElementComparator& comparator;
+};
+
 //==============================================================================
 /**
     Sorts a range of elements in an array.
@@ -56,7 +72,7 @@
                             comparator deems the same will be maintained - this will be
                             a slower algorithm than if they are allowed to be moved around.
 
-    @see sortArrayRetainingOrder
+    @see parallelSortArray
 */
 template <class ElementType, class ElementComparator>
 static void sortArray (ElementComparator& comparator,
@@ -70,114 +86,45 @@ static void sortArray (ElementComparator& comparator,
 
     if (lastElement > firstElement)
     {
-        if (retainOrderOfEquivalentItems)
-        {
-            for (int i = firstElement; i < lastElement; ++i)
-            {
-                if (comparator.compareElements (array[i], array [i + 1]) > 0)
-                {
-                    std::swap (array[i], array[i + 1]);
+        SortFunctionConverter<ElementComparator> converter (comparator);
 
-                    if (i > firstElement)
-                        i -= 2;
-                }
-            }
-        }
+        if (retainOrderOfEquivalentItems)
+            std::stable_sort (array + firstElement, array + lastElement + 1, converter);
         else
-        {
-            int fromStack[30], toStack[30];
-            int stackIndex = 0;
-
-            for (;;)
-            {
-                const int size = (lastElement - firstElement) + 1;
-
-                if (size <= 8)
-                {
-                    int j = lastElement;
-                    int maxIndex;
-
-                    while (j > firstElement)
-                    {
-                        maxIndex = firstElement;
-                        for (int k = firstElement + 1; k <= j; ++k)
-                            if (comparator.compareElements (array[k], array [maxIndex]) > 0)
-                                maxIndex = k;
-
-                        std::swap (array[j], array[maxIndex]);
-                        --j;
-                    }
-                }
-                else
-                {
-                    const int mid = firstElement + (size >> 1);
-                    std::swap (array[mid], array[firstElement]);
-
-                    int i = firstElement;
-                    int j = lastElement + 1;
-
-                    for (;;)
-                    {
-                        while (++i <= lastElement
-                                && comparator.compareElements (array[i], array [firstElement]) <= 0)
-                        {}
-
-                        while (--j > firstElement
-                                && comparator.compareElements (array[j], array [firstElement]) >= 0)
-                        {}
-
-                        if (j < i)
-                            break;
-
-                        std::swap (array[i], array[j]);
-                    }
-
-                    std::swap (array[j], array[firstElement]);
-
-                    if (j - 1 - firstElement >= lastElement - i)
-                    {
-                        if (firstElement + 1 < j)
-                        {
-                            fromStack [stackIndex] = firstElement;
-                            toStack [stackIndex] = j - 1;
-                            ++stackIndex;
-                        }
-
-                        if (i < lastElement)
-                        {
-                            firstElement = i;
-                            continue;
-                        }
-                    }
-                    else
-                    {
-                        if (i < lastElement)
-                        {
-                            fromStack [stackIndex] = i;
-                            toStack [stackIndex] = lastElement;
-                            ++stackIndex;
-                        }
-
-                        if (firstElement + 1 < j)
-                        {
-                            lastElement = j - 1;
-                            continue;
-                        }
-                    }
-                }
-
-                if (--stackIndex < 0)
-                    break;
-
-                jassert (stackIndex < numElementsInArray (fromStack));
-
-                firstElement = fromStack [stackIndex];
-                lastElement = toStack [stackIndex];
-            }
-        }
+            std::sort (array + firstElement, array + lastElement + 1, converter);
     }
 }
 
+//==============================================================================
+class ThreadPool;
+
+/**
+    Sorts an array of elements, sharing the work out between the threads of a ThreadPool.
+
+    The comparator is used in exactly the same way as for sortArray(), but the
+    compareElements() method will be called concurrently from several threads, so it
+    mustn't modify any shared state.
+
+    The array is split into chunks which are sorted in parallel, and these are then
+    merged together in a series of parallel passes, using a temporary copy of the
+    elements. Small arrays are just sorted on the calling thread.
+
+    @param pool             the pool whose threads should do the work - the calling
+                            thread will also help out while it waits
+    @param comparator       an object which defines a compareElements() method
+    @param array            the array to sort
+    @param numElements      the number of elements in the array
+    @param retainOrderOfEquivalentItems     if true, the order of items that the
+                            comparator deems the same will be maintained
+
+    @see sortArray, ThreadPool::parallelFor
+*/
+template <class ElementType, class ElementComparator>
+void parallelSortArray (ThreadPool& pool,
+                        ElementComparator& comparator,
+                        ElementType* array,
+                        int numElements,
+                        bool retainOrderOfEquivalentItems);
 
 //==============================================================================
 /**
@@ -0,0 +1,591 @@
+/*
+  ==============================================================================
+
+   This file is part of the juce_core module of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission to use, copy, modify, and/or distribute this software for any purpose with
+   or without fee is hereby granted, provided that the above copyright notice and this
+   permission notice appear in all copies.
+
+   THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+   TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+   NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+   DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+   IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+   ------------------------------------------------------------------------------
+
+   NOTE! This permissive ISC license applies ONLY to files within the juce_core module!
+   All other JUCE modules are covered by a dual GPL/commercial license, so if you are
+   using any other modules, be sure to check that you also comply with their license.
+
+   For more details, visit www.juce.com
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_FLATHASHMAP_JUCEHEADER__
+#define __JUCE_FLATHASHMAP_JUCEHEADER__
+
+#include "../memory/juce_HeapBlock.h"
+
+
+//==============================================================================
+/**
+    Generates well-mixed 32-bit hash codes for some primitive types, intended for
+    use with the FlatHashMap class.
+
+    Because a FlatHashMap picks a slot using the low bits of the hash code, these
+    functions make sure that every bit of the key affects every bit of the result.
+
+    @see FlatHashMap
+*/
+class FlatHashFunctions
+{
+public:
+    /** Generates a hash from a 32-bit integer. */
+    static uint32 generateHash (const uint32 key) noexcept
+    {
+        uint32 h = key;
+        h ^= h >> 16;
+        h *= 0x85ebca6b;
+        h ^= h >> 13;
+        h *= 0xc2b2ae35;
+        h ^= h >> 16;
+        return h;
+    }
+
+    /** Generates a hash from an integer. */
+    static uint32 generateHash (const int key) noexcept            { return generateHash ((uint32) key); }
+
+    /** Generates a hash from an int64. */
+    static uint32 generateHash (const int64 key) noexcept
+    {
+        uint64 h = (uint64) key;
+        h ^= h >> 33;
+        h *= (((uint64) 0xff51afd7) << 32) | 0xed558ccd;
+        h ^= h >> 33;
+        h *= (((uint64) 0xc4ceb9fe) << 32) | 0x1a85ec53;
+        h ^= h >> 33;
+        return (uint32) (h ^ (h >> 32));
+    }
+
+    /** Generates a hash from a pointer. */
+    static uint32 generateHash (const void* const key) noexcept    { return generateHash ((int64) (pointer_sized_int) key); }
+
+    /** Generates a hash from a string. */
+    static uint32 generateHash (const String& key) noexcept        { return generateHash (key.hashCode64()); }
+
+    /** Generates a hash from a variant. */
+    static uint32 generateHash (const var& key) noexcept           { return generateHash (key.toString()); }
+};
+
+
+//==============================================================================
+/**
+    Holds a set of mappings between some key/value pairs, in a single flat table.
+
+    This does the same job as HashMap, but rather than keeping each item in its own
+    heap-allocated node, it stores them all in one contiguous array using open
+    addressing with linear probing. Items are kept ordered by how far they are from
+    their ideal slot ("robin-hood" hashing), which keeps probe sequences short, and the
+    table doubles in size whenever it becomes more than 3/4 full.
+
+    This means that looking up a key never allocates any memory or follows any pointers
+    other than into the table itself, so it's a lot more cache-friendly than HashMap,
+    particularly for big maps or small value types.
+
+    The hash function class must have a static method that returns a 32-bit hash code
+    for the key type. The map uses the low bits of this value to pick a slot, so it must
+    be well-mixed - see FlatHashFunctions for some examples:
+
+    @code
+    struct MyHashGenerator
+    {
+        static uint32 generateHash (const MyKeyType& key)
+        {
+            return FlatHashFunctions::generateHash (someFunctionOfMyKeyType (key));
+        }
+    };
+    @endcode
+
+    As with HashMap, the key and value types are copy-by-value types. If your compiler
+    supports move semantics, the value type can also be a move-only type, in which case
+    you'll need to add items with the rvalue version of set(), and use getPointer() or an
+    Iterator rather than operator[] to get at them.
+
+    Adding or removing items can move other items around in the table, so any pointers
+    returned by getPointer() and any Iterators become invalid when the map is modified.
+
+    @code
+    FlatHashMap<int, String> hash;
+    hash.set (1, "item1");
+    hash.set (2, "item2");
+
+    DBG (hash [1]); // prints "item1"
+    DBG (hash [2]); // prints "item2"
+
+    // This iterates the map, printing all of its key -> value pairs..
+    for (FlatHashMap<int, String>::Iterator i (hash); i.next();)
+        DBG (i.getKey() << " -> " << i.getValue());
+    @endcode
+
+    @see HashMap, FlatHashFunctions
+*/
+template <typename KeyType,
+          typename ValueType,
+          class HashFunctionToUse = FlatHashFunctions,
+          class TypeOfCriticalSectionToUse = DummyCriticalSection>
+class FlatHashMap
+{
+private:
+    typedef PARAMETER_TYPE (KeyType)   KeyTypeParameter;
+    typedef PARAMETER_TYPE (ValueType) ValueTypeParameter;
+
+public:
+    //==============================================================================
+    /** Creates an empty map.
+        If you know roughly how many items will be added, you can pass it in here to
+        avoid the table having to be resized as it grows.
+    */
+    explicit FlatHashMap (const int numItemsToAllocate = 0)
+        : capacity (0), numItems (0)
+    {
+        if (numItemsToAllocate > 0)
+            ensureStorageAllocated (numItemsToAllocate);
+    }
+
+    /** Destructor. */
+    ~FlatHashMap()
+    {
+        deleteAllEntries();
+    }
+
+    //==============================================================================
+    /** Removes all values from the map.
+        This leaves the table's storage allocated, so refilling it won't need to reallocate.
+    */
+    void clear()
+    {
+        const ScopedLockType sl (getLock());
+        deleteAllEntries();
+    }
+
+    /** Returns the current number of items in the map. */
+    inline int size() const noexcept
+    {
+        return numItems;
+    }
+
+    /** Returns the number of items that can be added before the table needs to grow. */
+    inline int getNumAllocated() const noexcept
+    {
+        return (capacity * 3) / 4;
+    }
+
+    /** Makes sure that the table is big enough to hold at least the given number of
+        items without needing to be resized.
+    */
+    void ensureStorageAllocated (const int minNumItems)
+    {
+        const ScopedLockType sl (getLock());
+
+        int newCapacity = jmax (capacity, (int) minimumCapacity);
+
+        while ((newCapacity * 3) / 4 < minNumItems)
+            newCapacity *= 2;
+
+        if (newCapacity != capacity)
+            resizeTable (newCapacity);
+    }
+
+    //==============================================================================
+    /** Returns the value corresponding to a given key.
+        If the map doesn't contain the key, a default instance of the value type is returned.
+    */
+    inline ValueType operator[] (KeyTypeParameter keyToLookFor) const
+    {
+        const ScopedLockType sl (getLock());
+        const int index = findIndex (keyToLookFor);
+        return index >= 0 ? getEntry (index).value : ValueType();
+    }
+
+    /** Returns a pointer to the value corresponding to a given key, or nullptr if the map
+        doesn't contain the key.
+        The pointer will only remain valid until the map is next modified.
+    */
+    inline ValueType* getPointer (KeyTypeParameter keyToLookFor) const noexcept
+    {
+        const ScopedLockType sl (getLock());
+        const int index = findIndex (keyToLookFor);
+        return index >= 0 ? &(getEntry (index).value) : nullptr;
+    }
+
+    /** Returns true if the map contains an item with the specified key. */
+    inline bool contains (KeyTypeParameter keyToLookFor) const noexcept
+    {
+        const ScopedLockType sl (getLock());
+        return findIndex (keyToLookFor) >= 0;
+    }
+
+    /** Returns true if the map contains at least one occurrence of a given value. */
+    bool containsValue (ValueTypeParameter valueToLookFor) const
+    {
+        const ScopedLockType sl (getLock());
+
+        for (int i = capacity; --i >= 0;)
+            if (hashes[i] != 0 && getEntry (i).value == valueToLookFor)
+                return true;
+
+        return false;
+    }
+
+    //==============================================================================
+    /** Adds or replaces an element in the map.
+        If there's already an item with the given key, this will replace its value. Otherwise, a new item
+        will be added to the map.
+    */
+    void set (KeyTypeParameter newKey, const ValueType& newValue)
+    {
+        const ScopedLockType sl (getLock());
+        const uint32 hash = generateHashFor (newKey);
+        const int index = findIndex (newKey, hash);
+
+        if (index >= 0)
+            getEntry (index).value = newValue;
+        else
+            new (getEntryStorage (insertionSlot (hash))) Entry (newKey, newValue);
+    }
+
+   #if JUCE_COMPILER_SUPPORTS_MOVE_SEMANTICS
+    /** Adds or replaces an element in the map, moving the new value into it.
+        If there's already an item with the given key, this will replace its value. Otherwise, a new item
+        will be added to the map.
+    */
+    void set (KeyTypeParameter newKey, ValueType&& newValue)
+    {
+        const ScopedLockType sl (getLock());
+        const uint32 hash = generateHashFor (newKey);
+        const int index = findIndex (newKey, hash);
+
+        if (index >= 0)
+            getEntry (index).value = static_cast<ValueType&&> (newValue);
+        else
+            new (getEntryStorage (insertionSlot (hash))) Entry (newKey, static_cast<ValueType&&> (newValue));
+    }
+   #endif
+
+    /** Removes the item with the given key, if there is one. */
+    void remove (KeyTypeParameter keyToRemove)
+    {
+        const ScopedLockType sl (getLock());
+        const int index = findIndex (keyToRemove);
+
+        if (index >= 0)
+            removeEntry (index);
+    }
+
+    /** Removes all items with the given value. */
+    void removeValue (ValueTypeParameter valueToRemove)
+    {
+        const ScopedLockType sl (getLock());
+
+        for (int i = 0; i < capacity;)
+        {
+            // removing an item may shift the next one back into this slot, so only
+            // move on if nothing was removed
+            if (hashes[i] != 0 && getEntry (i).value == valueToRemove)
+                removeEntry (i);
+            else
+                ++i;
+        }
+    }
+
+    //==============================================================================
+    /** Efficiently swaps the contents of two maps. */
+    void swapWith (FlatHashMap& otherHashMap) noexcept
+    {
+        const ScopedLockType lock1 (getLock());
+        const ScopedLockType lock2 (otherHashMap.getLock());
+
+        hashes.swapWith (otherHashMap.hashes);
+        storage.swapWith (otherHashMap.storage);
+        std::swap (capacity, otherHashMap.capacity);
+        std::swap (numItems, otherHashMap.numItems);
+    }
+
+    //==============================================================================
+    /** Returns the CriticalSection that locks this structure.
+        To lock, you can call getLock().enter() and getLock().exit(), or preferably use
+        an object of ScopedLockType as an RAII lock for it.
+    */
+    inline const TypeOfCriticalSectionToUse& getLock() const noexcept      { return lock; }
+
+    /** Returns the type of scoped lock to use for locking this map */
+    typedef typename TypeOfCriticalSectionToUse::ScopedLockType ScopedLockType;
+
+private:
+    //==============================================================================
+    struct Entry
+    {
+        Entry (KeyTypeParameter k, const ValueType& v)  : key (k), value (v) {}
+
+       #if JUCE_COMPILER_SUPPORTS_MOVE_SEMANTICS
+        Entry (KeyTypeParameter k, ValueType&& v)  : key (k), value (static_cast<ValueType&&> (v)) {}
+
+        Entry (Entry&& other)
+            : key (static_cast<KeyType&&> (other.key)),
+              value (static_cast<ValueType&&> (other.value))
+        {}
+       #else
+        Entry (const Entry& other)  : key (other.key), value (other.value) {}
+       #endif
+
+        KeyType key;
+        ValueType value;
+
+    private:
+        Entry& operator= (const Entry&);
+    };
+
+public:
+    //==============================================================================
+    /** Iterates over the items in a FlatHashMap.
+
+        To use it, repeatedly call next() until it returns false, e.g.
+        @code
+        FlatHashMap <String, String> myMap;
+
+        FlatHashMap<String, String>::Iterator i (myMap);
+
+        while (i.next())
+        {
+            DBG (i.getKey() << " -> " << i.getValue());
+        }
+        @endcode
+
+        The order in which items are iterated bears no resemblence to the order in which
+        they were originally added!
+
+        As soon as you call any non-const methods on the original map, any iterators that
+        were created beforehand will cease to be valid, and should not be used.
+
+        @see FlatHashMap
+    */
+    class Iterator
+    {
+    public:
+        //==============================================================================
+        Iterator (const FlatHashMap& hashMapToIterate) noexcept
+            : hashMap (hashMapToIterate), index (-1)
+        {}
+
+        /** Moves to the next item, if one is available.
+            When this returns true, you can get the item's key and value using getKey() and
+            getValue(). If it returns false, the iteration has finished and you should stop.
+        */
+        bool next() noexcept
+        {
+            while (++index < hashMap.capacity)
+                if (hashMap.hashes[index] != 0)
+                    return true;
+
+            return false;
+        }
+
+        /** Returns the current item's key.
+            This should only be called when a call to next() has just returned true.
+        */
+        const KeyType& getKey() const noexcept
+        {
+            return hashMap.getEntry (index).key;
+        }
+
+        /** Returns the current item's value.
+            This should only be called when a call to next() has just returned true.
+        */
+        ValueType& getValue() const noexcept
+        {
+            return hashMap.getEntry (index).value;
+        }
+
+    private:
+        //==============================================================================
+        const FlatHashMap& hashMap;
+        int index;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Iterator)
+    };
+
+private:
+    //==============================================================================
+    enum { minimumCapacity = 16 };
+    friend class Iterator;
+
+    // For each slot, this holds the hash code of the item in it, or 0 if it's empty
+    HeapBlock<uint32> hashes;
+    HeapBlock<char> storage;
+    int capacity, numItems;
+    TypeOfCriticalSectionToUse lock;
+
+    static uint32 generateHashFor (KeyTypeParameter key) noexcept
+    {
+        const uint32 hash = HashFunctionToUse::generateHash (key);
+        return hash != 0 ? hash : 1;
+    }
+
+    inline void* getEntryStorage (const int index) const noexcept    { return storage + (size_t) index * sizeof (Entry); }
+    inline Entry& getEntry (const int index) const noexcept          { return *static_cast<Entry*> (getEntryStorage (index)); }
+
+    // The number of slots between this slot and the one that its item would ideally be in
+    inline int getProbeDistance (const int index) const noexcept
+    {
+        return (index - (int) (hashes[index] & (uint32) (capacity - 1))) & (capacity - 1);
+    }
+
+    inline int findIndex (KeyTypeParameter key) const noexcept
+    {
+        return findIndex (key, generateHashFor (key));
+    }
+
+    int findIndex (KeyTypeParameter key, const uint32 hash) const noexcept
+    {
+        if (numItems > 0)
+        {
+            const int mask = capacity - 1;
+
+            for (int index = (int) (hash & (uint32) mask), distance = 0;; index = (index + 1) & mask, ++distance)
+            {
+                const uint32 h = hashes[index];
+
+                // an empty slot, or one whose item is nearer its ideal slot than the
+                // key would be, means that the key can't be any further along
+                if (h == 0 || getProbeDistance (index) < distance)
+                    break;
+
+                if (h == hash && getEntry (index).key == key)
+                    return index;
+            }
+        }
+
+        return -1;
+    }
+
+    // Makes space for a new item with this hash, and returns the slot that it should be
+    // constructed in. The caller must already have checked that the key isn't in the map.
+    int insertionSlot (const uint32 hash)
+    {
+        if (numItems >= getNumAllocated())
+            resizeTable (jmax (capacity * 2, (int) minimumCapacity));
+
+        const int mask = capacity - 1;
+        int index = (int) (hash & (uint32) mask);
+
+        // find the first item that's nearer its ideal slot than the new one would be..
+        for (int distance = 0; hashes[index] != 0 && getProbeDistance (index) >= distance; ++distance)
+            index = (index + 1) & mask;
+
+        // ..then shuffle that item and the rest of its run along by one, to leave a gap
+        int gap = index;
+
+        while (hashes[gap] != 0)
+            gap = (gap + 1) & mask;
+
+        while (gap != index)
+        {
+            const int previous = (gap - 1) & mask;
+            moveEntry (previous, gap);
+            gap = previous;
+        }
+
+        hashes[index] = hash;
+        ++numItems;
+        return index;
+    }
+
+    void removeEntry (int index)
+    {
+        getEntry (index).~Entry();
+        hashes[index] = 0;
+        --numItems;
+
+        // shift any following items that aren't in their ideal slots back into the gap
+        const int mask = capacity - 1;
+
+        for (int next = (index + 1) & mask; hashes[next] != 0 && getProbeDistance (next) > 0; next = (next + 1) & mask)
+        {
+            moveEntry (next, index);
+            index = next;
+        }
+    }
+
+    void moveEntry (const int source, const int dest)
+    {
+        jassert (hashes[dest] == 0);
+
+       #if JUCE_COMPILER_SUPPORTS_MOVE_SEMANTICS
+        new (getEntryStorage (dest)) Entry (static_cast<Entry&&> (getEntry (source)));
+       #else
+        new (getEntryStorage (dest)) Entry (getEntry (source));
+       #endif
+
+        getEntry (source).~Entry();
+        hashes[dest] = hashes[source];
+        hashes[source] = 0;
+    }
+
+    void resizeTable (const int newCapacity)
+    {
+        jassert (isPowerOfTwo (newCapacity) && (newCapacity * 3) / 4 >= numItems);
+
+        FlatHashMap newTable;
+        newTable.hashes.calloc ((size_t) newCapacity);
+        newTable.storage.malloc ((size_t) newCapacity * sizeof (Entry));
+        newTable.capacity = newCapacity;
+
+        for (int i = 0; i < capacity; ++i)
+        {
+            if (hashes[i] != 0)
+            {
+                Entry& e = getEntry (i);
+                void* const dest = newTable.getEntryStorage (newTable.insertionSlot (hashes[i]));
+
+               #if JUCE_COMPILER_SUPPORTS_MOVE_SEMANTICS
+                new (dest) Entry (static_cast<Entry&&> (e));
+               #else
+                new (dest) Entry (e);
+               #endif
+
+                e.~Entry();
+                hashes[i] = 0;
+            }
+        }
+
+        numItems = 0;
+        hashes.swapWith (newTable.hashes);
+        storage.swapWith (newTable.storage);
+        std::swap (capacity, newTable.capacity);
+        std::swap (numItems, newTable.numItems);
+    }
+
+    void deleteAllEntries()
+    {
+        for (int i = capacity; --i >= 0;)
+        {
+            if (hashes[i] != 0)
+            {
+                getEntry (i).~Entry();
+                hashes[i] = 0;
+            }
+        }
+
+        numItems = 0;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FlatHashMap)
+};
+
+
+#endif   // __JUCE_FLATHASHMAP_JUCEHEADER__
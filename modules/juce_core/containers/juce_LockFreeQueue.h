@@ -0,0 +1,229 @@
+/*
+  ==============================================================================
+
+   This file is part of the juce_core module of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission to use, copy, modify, and/or distribute this software for any purpose with
+   or without fee is hereby granted, provided that the above copyright notice and this
+   permission notice appear in all copies.
+
+   THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+   TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+   NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+   DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+   IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+   ------------------------------------------------------------------------------
+
+   NOTE! This permissive ISC license applies ONLY to files within the juce_core module!
+   All other JUCE modules are covered by a dual GPL/commercial license, so if you are
+   using any other modules, be sure to check that you also comply with their license.
+
+   For more details, visit www.juce.com
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_LOCKFREEQUEUE_JUCEHEADER__
+#define __JUCE_LOCKFREEQUEUE_JUCEHEADER__
+
+#include "juce_AbstractFifo.h"
+#include "../memory/juce_HeapBlock.h"
+
+
+//==============================================================================
+/**
+    A lock-free, fixed-size queue of objects, for passing data from one thread to another.
+
+    This is a typed wrapper around an AbstractFifo: exactly one thread may push items
+    into the queue, and exactly one (other) thread may pop them out. Neither of these
+    operations ever blocks or allocates memory, so it's safe to use one of these to send
+    messages to or from an audio callback.
+
+    All the storage is allocated when the queue is created. Items are constructed in
+    their slot by push(), and destroyed by pop() - if your compiler supports rvalue
+    references, they'll be moved rather than copied, so move-only types can be used.
+
+    If you need more than one thread to push or pop items, use a ConcurrentQueue instead.
+
+    @see AbstractFifo, ConcurrentQueue
+*/
+template <typename ElementType>
+class LockFreeQueue
+{
+public:
+    //==============================================================================
+    /** Creates a queue that can hold up to the given number of items. */
+    explicit LockFreeQueue (const int capacity)
+        : fifo (capacity + 1),
+          storage ((size_t) (capacity + 1) * sizeof (ElementType))
+    {
+        jassert (capacity > 0);
+    }
+
+    /** Destructor.
+        Any items that are still in the queue will be deleted.
+    */
+    ~LockFreeQueue()
+    {
+        clear();
+    }
+
+    //==============================================================================
+    /** Returns the maximum number of items that the queue can hold. */
+    int getCapacity() const noexcept                { return fifo.getTotalSize() - 1; }
+
+    /** Returns the number of items that are waiting to be read. */
+    int getNumReady() const noexcept                { return fifo.getNumReady(); }
+
+    /** Returns the number of items that could be pushed without the queue overflowing. */
+    int getFreeSpace() const noexcept               { return fifo.getFreeSpace() - 1; }
+
+    /** Returns true if there's nothing waiting to be read. */
+    bool isEmpty() const noexcept                   { return fifo.getNumReady() == 0; }
+
+    /** Deletes any items that are waiting in the queue.
+        This isn't thread-safe, so it must only be called when neither the reader nor
+        the writer could be using the queue.
+    */
+    void clear()
+    {
+        int start1, size1, start2, size2;
+        fifo.prepareToRead (fifo.getNumReady(), start1, size1, start2, size2);
+
+        destroyItems (start1, size1);
+        destroyItems (start2, size2);
+
+        fifo.reset();
+    }
+
+    //==============================================================================
+    /** Adds a copy of an item to the end of the queue.
+        This must only be called by the writer thread.
+        @returns false if the queue was full, in which case nothing is added
+    */
+    bool push (const ElementType& item)
+    {
+        int start1, size1, start2, size2;
+        fifo.prepareToWrite (1, start1, size1, start2, size2);
+
+        if (size1 == 0)
+            return false;
+
+        new (getSlot (start1)) ElementType (item);
+        fifo.finishedWrite (1);
+        return true;
+    }
+
+   #if JUCE_COMPILER_SUPPORTS_MOVE_SEMANTICS
+    /** Moves an item onto the end of the queue.
+        This must only be called by the writer thread.
+        @returns false if the queue was full, in which case the item is left untouched
+    */
+    bool push (ElementType&& item)
+    {
+        int start1, size1, start2, size2;
+        fifo.prepareToWrite (1, start1, size1, start2, size2);
+
+        if (size1 == 0)
+            return false;
+
+        new (getSlot (start1)) ElementType (static_cast<ElementType&&> (item));
+        fifo.finishedWrite (1);
+        return true;
+    }
+   #endif
+
+    /** Adds copies of as many items from an array as will fit into the queue.
+        This must only be called by the writer thread.
+        @returns the number of items that were actually added
+    */
+    int pushMultiple (const ElementType* items, const int numItems)
+    {
+        int start1, size1, start2, size2;
+        fifo.prepareToWrite (numItems, start1, size1, start2, size2);
+
+        for (int i = 0; i < size1; ++i)
+            new (getSlot (start1 + i)) ElementType (*items++);
+
+        for (int i = 0; i < size2; ++i)
+            new (getSlot (start2 + i)) ElementType (*items++);
+
+        fifo.finishedWrite (size1 + size2);
+        return size1 + size2;
+    }
+
+    //==============================================================================
+    /** Removes the item at the front of the queue.
+        This must only be called by the reader thread.
+        @returns false if the queue was empty, in which case result is left unchanged
+    */
+    bool pop (ElementType& result)
+    {
+        int start1, size1, start2, size2;
+        fifo.prepareToRead (1, start1, size1, start2, size2);
+
+        if (size1 == 0)
+            return false;
+
+        takeItem (start1, result);
+        fifo.finishedRead (1);
+        return true;
+    }
+
+    /** Removes up to the given number of items from the front of the queue.
+        This must only be called by the reader thread.
+        @returns the number of items that were actually removed and stored in the
+                 destination array
+    */
+    int popMultiple (ElementType* dest, const int maxItems)
+    {
+        int start1, size1, start2, size2;
+        fifo.prepareToRead (maxItems, start1, size1, start2, size2);
+
+        for (int i = 0; i < size1; ++i)
+            takeItem (start1 + i, *dest++);
+
+        for (int i = 0; i < size2; ++i)
+            takeItem (start2 + i, *dest++);
+
+        fifo.finishedRead (size1 + size2);
+        return size1 + size2;
+    }
+
+private:
+    //==============================================================================
+    AbstractFifo fifo;
+    HeapBlock<char> storage;
+
+    ElementType* getSlot (const int index) const noexcept
+    {
+        return reinterpret_cast<ElementType*> (storage + (size_t) index * sizeof (ElementType));
+    }
+
+    void takeItem (const int index, ElementType& result)
+    {
+        ElementType* const e = getSlot (index);
+
+       #if JUCE_COMPILER_SUPPORTS_MOVE_SEMANTICS
+        result = static_cast<ElementType&&> (*e);
+       #else
+        result = *e;
+       #endif
+
+        e->~ElementType();
+    }
+
+    void destroyItems (const int start, const int num)
+    {
+        for (int i = 0; i < num; ++i)
+            getSlot (start + i)->~ElementType();
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (LockFreeQueue)
+};
+
+
+#endif   // __JUCE_LOCKFREEQUEUE_JUCEHEADER__
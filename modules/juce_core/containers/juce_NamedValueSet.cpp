@@ -26,10 +26,6 @@
   ==============================================================================
 */
 
-NamedValueSet::NamedValue::NamedValue() noexcept
-{
-}
-
 inline NamedValueSet::NamedValue::NamedValue (const Identifier n, const var& v)
     : name (n), value (v)
 {
@@ -49,8 +45,7 @@ NamedValueSet::NamedValue& NamedValueSet::NamedValue::operator= (const NamedValu
 
 #if JUCE_COMPILER_SUPPORTS_MOVE_SEMANTICS
 NamedValueSet::NamedValue::NamedValue (NamedValue&& other) noexcept
-    : nextListItem (static_cast <LinkedListPointer<NamedValue>&&> (other.nextListItem)),
-      name (static_cast <Identifier&&> (other.name)),
+    : name (static_cast <Identifier&&> (other.name)),
       value (static_cast <var&&> (other.value))
 {
 }
@@ -62,7 +57,6 @@ inline NamedValueSet::NamedValue::NamedValue (const Identifier n, var&& v)
 
 NamedValueSet::NamedValue& NamedValueSet::NamedValue::operator= (NamedValue&& other) noexcept
 {
-    nextListItem = static_cast <LinkedListPointer<NamedValue>&&> (other.nextListItem);
     name = static_cast <Identifier&&> (other.name);
     value = static_cast <var&&> (other.value);
     return *this;
@@ -74,32 +68,73 @@ bool NamedValueSet::NamedValue::operator== (const NamedValueSet::NamedValue& oth
     return name == other.name && value == other.value;
 }
 
+//==============================================================================
+namespace NamedValueSetHelpers
+{
+    static inline uint32 hashIdentifier (const Identifier name) noexcept
+    {
+        // identifiers are pooled, so the address of the string uniquely identifies the name
+        return ((uint32) (((pointer_sized_uint) name.getCharPointer().getAddress()) >> 3)) * 0x9e3779b1u;
+    }
+
+    template <typename Type>
+    static inline void relocate (Type* const dest, Type* const source) noexcept
+    {
+       #if JUCE_COMPILER_SUPPORTS_MOVE_SEMANTICS
+        new (dest) Type (static_cast <Type&&> (*source));
+       #else
+        new (dest) Type (*source);
+       #endif
+        source->~Type();
+    }
+}
+
 //==============================================================================
 NamedValueSet::NamedValueSet() noexcept
+    : heapValues (nullptr), numValues (0), numAllocated (numInlineValues), hashTableMask (0)
 {
 }
 
 NamedValueSet::NamedValueSet (const NamedValueSet& other)
+    : heapValues (nullptr), numValues (0), numAllocated (numInlineValues), hashTableMask (0)
 {
-    values.addCopyOfList (other.values);
+    operator= (other);
 }
 
 NamedValueSet& NamedValueSet::operator= (const NamedValueSet& other)
 {
-    clear();
-    values.addCopyOfList (other.values);
+    if (this != &other)
+    {
+        clear();
+        ensureAllocatedSize (other.numValues);
+
+        const NamedValue* const source = other.getValues();
+
+        for (int i = 0; i < other.numValues; ++i)
+        {
+            new (addSpaceForNewValue()) NamedValue (source[i]);
+            valueAdded();
+        }
+    }
+
     return *this;
 }
 
 #if JUCE_COMPILER_SUPPORTS_MOVE_SEMANTICS
 NamedValueSet::NamedValueSet (NamedValueSet&& other) noexcept
-    : values (static_cast <LinkedListPointer<NamedValue>&&> (other.values))
+    : heapValues (nullptr), numValues (0), numAllocated (numInlineValues), hashTableMask (0)
 {
+    takeValuesFrom (other);
 }
 
 NamedValueSet& NamedValueSet::operator= (NamedValueSet&& other) noexcept
 {
-    other.values.swapWith (values);
+    if (this != &other)
+    {
+        clear();
+        takeValuesFrom (other);
+    }
+
     return *this;
 }
 #endif
@@ -111,22 +146,159 @@ NamedValueSet::~NamedValueSet()
 
 void NamedValueSet::clear()
 {
-    values.deleteAll();
+    NamedValue* const v = getValues();
+
+    for (int i = numValues; --i >= 0;)
+        v[i].~NamedValue();
+
+    if (heapValues != nullptr)
+        ArenaAllocationPolicy::release (heapValues);
+
+    heapValues = nullptr;
+    numValues = 0;
+    numAllocated = numInlineValues;
+    hashTable.free();
+    hashTableMask = 0;
 }
 
-bool NamedValueSet::operator== (const NamedValueSet& other) const
+void NamedValueSet::takeValuesFrom (NamedValueSet& other) noexcept
 {
-    const NamedValue* i1 = values;
-    const NamedValue* i2 = other.values;
+    jassert (numValues == 0 && heapValues == nullptr);
 
-    while (i1 != nullptr && i2 != nullptr)
+    if (other.heapValues != nullptr)
     {
-        if (! (*i1 == *i2))
-            return false;
+        heapValues = other.heapValues;
+        numAllocated = other.numAllocated;
+        other.heapValues = nullptr;
+        other.numAllocated = numInlineValues;
+    }
+    else
+    {
+        NamedValue* const source = other.getValues();
+        NamedValue* const dest = getValues();
+
+        for (int i = 0; i < other.numValues; ++i)
+            NamedValueSetHelpers::relocate (dest + i, source + i);
+    }
+
+    numValues = other.numValues;
+    other.numValues = 0;
+    hashTable.swapWith (other.hashTable);
+    std::swap (hashTableMask, other.hashTableMask);
+}
 
-        i1 = i1->nextListItem;
-        i2 = i2->nextListItem;
+//==============================================================================
+inline NamedValueSet::NamedValue* NamedValueSet::getValues() const noexcept
+{
+    return heapValues != nullptr ? heapValues
+                                 : reinterpret_cast <NamedValue*> (const_cast <char*> (inlineStorage.data));
+}
+
+int NamedValueSet::indexOf (const Identifier name) const noexcept
+{
+    const NamedValue* const v = getValues();
+
+    if (hashTable != nullptr)
+    {
+        for (uint32 slot = NamedValueSetHelpers::hashIdentifier (name);; ++slot)
+        {
+            const int index = hashTable [slot & (uint32) hashTableMask] - 1;
+
+            if (index < 0 || v[index].name == name)
+                return index;
+        }
+    }
+
+    for (int i = 0; i < numValues; ++i)
+        if (v[i].name == name)
+            return i;
+
+    return -1;
+}
+
+void NamedValueSet::ensureAllocatedSize (const int minNumValues)
+{
+    if (minNumValues > numAllocated)
+    {
+        const int newAllocated = jmax (minNumValues, numAllocated + numAllocated / 2 + 4);
+        NamedValue* const newValues = static_cast <NamedValue*> (ArenaAllocationPolicy::allocate ((size_t) newAllocated * sizeof (NamedValue)));
+        NamedValue* const oldValues = getValues();
+
+        for (int i = 0; i < numValues; ++i)
+            NamedValueSetHelpers::relocate (newValues + i, oldValues + i);
+
+        if (heapValues != nullptr)
+            ArenaAllocationPolicy::release (heapValues);
+
+        heapValues = newValues;
+        numAllocated = newAllocated;
     }
+}
+
+// The caller must construct the new value and then call valueAdded()
+NamedValueSet::NamedValue* NamedValueSet::addSpaceForNewValue()
+{
+    ensureAllocatedSize (numValues + 1);
+    return getValues() + numValues;
+}
+
+void NamedValueSet::valueAdded()
+{
+    const int index = numValues++;
+
+    if (hashTable != nullptr && numValues * 2 <= hashTableMask + 1)
+    {
+        uint32 slot = NamedValueSetHelpers::hashIdentifier (getValues()[index].name);
+
+        while (hashTable [slot & (uint32) hashTableMask] != 0)
+            ++slot;
+
+        hashTable [slot & (uint32) hashTableMask] = index + 1;
+    }
+    else if (numValues >= minValuesForHashTable)
+    {
+        rebuildHashTable();
+    }
+}
+
+void NamedValueSet::rebuildHashTable()
+{
+    if (numValues < minValuesForHashTable / 2)
+    {
+        hashTable.free();
+        hashTableMask = 0;
+        return;
+    }
+
+    int tableSize = 64;
+    while (tableSize < numValues * 4)
+        tableSize *= 2;
+
+    hashTable.allocate ((size_t) tableSize, true);
+    hashTableMask = tableSize - 1;
+
+    const NamedValue* const v = getValues();
+
+    for (int i = 0; i < numValues; ++i)
+    {
+        uint32 slot = NamedValueSetHelpers::hashIdentifier (v[i].name);
+
+        while (hashTable [slot & (uint32) hashTableMask] != 0)
+            ++slot;
+
+        hashTable [slot & (uint32) hashTableMask] = i + 1;
+    }
+}
+
+//==============================================================================
+bool NamedValueSet::operator== (const NamedValueSet& other) const
+{
+    const NamedValue* const v1 = getValues();
+    const NamedValue* const v2 = other.getValues();
+
+    for (int i = jmin (numValues, other.numValues); --i >= 0;)
+        if (! (v1[i] == v2[i]))
+            return false;
 
     return true;
 }
@@ -138,16 +310,13 @@ bool NamedValueSet::operator!= (const NamedValueSet& other) const
 
 int NamedValueSet::size() const noexcept
 {
-    return values.size();
+    return numValues;
 }
 
 const var& NamedValueSet::operator[] (const Identifier name) const
 {
-    for (NamedValue* i = values; i != nullptr; i = i->nextListItem)
-        if (i->name == name)
-            return i->value;
-
-    return var::null;
+    const int index = indexOf (name);
+    return index >= 0 ? getValues()[index].value : var::null;
 }
 
 var NamedValueSet::getWithDefault (const Identifier name, const var& defaultReturnValue) const
@@ -160,111 +329,88 @@ var NamedValueSet::getWithDefault (const Identifier name, const var& defaultRetu
 
 var* NamedValueSet::getVarPointer (const Identifier name) const noexcept
 {
-    for (NamedValue* i = values; i != nullptr; i = i->nextListItem)
-        if (i->name == name)
-            return &(i->value);
-
-    return nullptr;
+    const int index = indexOf (name);
+    return index >= 0 ? &(getValues()[index].value) : nullptr;
 }
 
 #if JUCE_COMPILER_SUPPORTS_MOVE_SEMANTICS
 bool NamedValueSet::set (const Identifier name, var&& newValue)
 {
-    LinkedListPointer<NamedValue>* i = &values;
-
-    while (i->get() != nullptr)
+    if (var* const v = getVarPointer (name))
     {
-        NamedValue* const v = i->get();
-
-        if (v->name == name)
-        {
-            if (v->value.equalsWithSameType (newValue))
-                return false;
-
-            v->value = static_cast <var&&> (newValue);
-            return true;
-        }
+        if (v->equalsWithSameType (newValue))
+            return false;
 
-        i = &(v->nextListItem);
+        *v = static_cast <var&&> (newValue);
+        return true;
     }
 
-    i->insertNext (new NamedValue (name, static_cast <var&&> (newValue)));
+    new (addSpaceForNewValue()) NamedValue (name, static_cast <var&&> (newValue));
+    valueAdded();
     return true;
 }
 #endif
 
 bool NamedValueSet::set (const Identifier name, const var& newValue)
 {
-    LinkedListPointer<NamedValue>* i = &values;
-
-    while (i->get() != nullptr)
+    if (var* const v = getVarPointer (name))
     {
-        NamedValue* const v = i->get();
-
-        if (v->name == name)
-        {
-            if (v->value.equalsWithSameType (newValue))
-                return false;
-
-            v->value = newValue;
-            return true;
-        }
+        if (v->equalsWithSameType (newValue))
+            return false;
 
-        i = &(v->nextListItem);
+        *v = newValue;
+        return true;
     }
 
-    i->insertNext (new NamedValue (name, newValue));
+    new (addSpaceForNewValue()) NamedValue (name, newValue);
+    valueAdded();
     return true;
 }
 
 bool NamedValueSet::contains (const Identifier name) const
 {
-    return getVarPointer (name) != nullptr;
+    return indexOf (name) >= 0;
 }
 
 bool NamedValueSet::remove (const Identifier name)
 {
-    LinkedListPointer<NamedValue>* i = &values;
+    const int index = indexOf (name);
 
-    for (;;)
-    {
-        NamedValue* const v = i->get();
+    if (index < 0)
+        return false;
 
-        if (v == nullptr)
-            break;
+    NamedValue* const v = getValues();
+    v[index].~NamedValue();
 
-        if (v->name == name)
-        {
-            delete i->removeNext();
-            return true;
-        }
+    for (int i = index + 1; i < numValues; ++i)
+        NamedValueSetHelpers::relocate (v + i - 1, v + i);
 
-        i = &(v->nextListItem);
-    }
+    --numValues;
 
-    return false;
+    if (hashTable != nullptr)
+        rebuildHashTable();
+
+    return true;
 }
 
 const Identifier NamedValueSet::getName (const int index) const
 {
-    const NamedValue* const v = values[index];
-    jassert (v != nullptr);
-    return v->name;
+    jassert (isPositiveAndBelow (index, numValues));
+    return getValues()[index].name;
 }
 
 const var& NamedValueSet::getValueAt (const int index) const
 {
-    const NamedValue* const v = values[index];
-    jassert (v != nullptr);
-    return v->value;
+    jassert (isPositiveAndBelow (index, numValues));
+    return getValues()[index].value;
 }
 
 void NamedValueSet::setFromXmlAttributes (const XmlElement& xml)
 {
     clear();
-    LinkedListPointer<NamedValue>::Appender appender (values);
 
     const int numAtts = xml.getNumAttributes(); // xxx inefficient - should write an att iterator..
+    ensureAllocatedSize (numAtts);
 
     for (int i = 0; i < numAtts; ++i)
     {
@@ -277,33 +423,100 @@ void NamedValueSet::setFromXmlAttributes (const XmlElement& xml)
 
             if (mb.fromBase64Encoding (value))
             {
-                appender.append (new NamedValue (name.substring (7), var (mb)));
+                new (addSpaceForNewValue()) NamedValue (name.substring (7), var (mb));
+                valueAdded();
                 continue;
             }
         }
 
-        appender.append (new NamedValue (name, var (value)));
+        new (addSpaceForNewValue()) NamedValue (name, var (value));
+        valueAdded();
     }
 }
 
 void NamedValueSet::copyToXmlAttributes (XmlElement& xml) const
 {
-    for (NamedValue* i = values; i != nullptr; i = i->nextListItem)
+    const NamedValue* const v = getValues();
+
+    for (int i = 0; i < numValues; ++i)
     {
-        if (const MemoryBlock* mb = i->value.getBinaryData())
+        if (const MemoryBlock* mb = v[i].value.getBinaryData())
         {
-            xml.setAttribute ("base64:" + i->name.toString(),
+            xml.setAttribute ("base64:" + v[i].name.toString(),
                               mb->toBase64Encoding());
         }
         else
         {
             // These types can't be stored as XML!
-            jassert (! i->value.isObject());
-            jassert (! i->value.isMethod());
-            jassert (! i->value.isArray());
+            jassert (! v[i].value.isObject());
+            jassert (! v[i].value.isMethod());
+            jassert (! v[i].value.isArray());
 
-            xml.setAttribute (i->name.toString(),
-                              i->value.toString());
+            xml.setAttribute (v[i].name.toString(),
+                              v[i].value.toString());
         }
     }
 }
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class NamedValueSetTests  : public UnitTest
+{
+public:
+    NamedValueSetTests() : UnitTest ("NamedValueSet") {}
+
+    void runTest()
+    {
+        beginTest ("Basics");
+
+        for (int numItems = 1; numItems <= 200; numItems += 7)
+        {
+            NamedValueSet set;
+
+            for (int i = 0; i < numItems; ++i)
+                expect (set.set ("item" + String (i), i));
+
+            expectEquals (set.size(), numItems);
+            expect (! set.set ("item0", 0));
+
+            for (int i = 0; i < numItems; ++i)
+            {
+                expect ((int) set ["item" + String (i)] == i);
+                expect (set.getName (i) == Identifier ("item" + String (i)));  // insertion order is kept
+            }
+
+            expect (set ["missing"].isVoid());
+            expect (! set.contains ("missing"));
+
+            NamedValueSet copy (set);
+            expect (copy == set);
+
+            for (int i = 0; i < numItems; i += 2)
+                expect (set.remove ("item" + String (i)));
+
+            expectEquals (set.size(), numItems / 2);
+
+            for (int i = 0; i < numItems; ++i)
+                expect (set.contains ("item" + String (i)) == ((i & 1) != 0));
+
+            set.set ("extra", "x");
+            expect (set ["extra"] == "x");
+            expect (set.getName (set.size() - 1) == Identifier ("extra"));
+
+            expectEquals (copy.size(), numItems);
+            expect ((int) copy.getWithDefault ("item0", -1) == 0);
+
+            copy = set;
+            expect (copy.size() == set.size() && copy ["extra"] == "x");
+
+            set.clear();
+            expectEquals (set.size(), 0);
+            expect (! set.contains ("extra"));
+        }
+    }
+};
+
+static NamedValueSetTests namedValueSetTests;
+
+#endif
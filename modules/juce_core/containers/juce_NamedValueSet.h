@@ -30,11 +30,9 @@
 #define __JUCE_NAMEDVALUESET_JUCEHEADER__
 
 #include "juce_Variant.h"
-#include "../containers/juce_LinkedListPointer.h"
+#include "../memory/juce_HeapBlock.h"
+#include "../memory/juce_MemoryArena.h"
 class XmlElement;
-#ifndef DOXYGEN
- class JSONFormatter;
-#endif
 
 
 //==============================================================================
@@ -42,6 +40,12 @@ class XmlElement;
 
     This can be used as a basic structure to hold a set of var object, which can
     be retrieved by using their identifier.
+
+    The values are kept in a contiguous array in the order in which they were added,
+    with room for the first few stored inside the object itself, so small sets don't
+    need any heap allocation. Once a set grows beyond a few dozen values, it also
+    builds a hash table of the identifiers, so that looking up a value doesn't
+    involve scanning the whole set.
 */
 class JUCE_API  NamedValueSet
 {
@@ -140,7 +144,6 @@ private:
     class NamedValue
     {
     public:
-        NamedValue() noexcept;
         NamedValue (const NamedValue&);
         NamedValue (const Identifier name, const var& value);
         NamedValue& operator= (const NamedValue&);
@@ -151,18 +154,41 @@ private:
        #endif
         bool operator== (const NamedValue& other) const noexcept;
 
-        LinkedListPointer<NamedValue> nextListItem;
         Identifier name;
         var value;
+    };
 
-    private:
-        JUCE_LEAK_DETECTOR (NamedValue)
+    enum
+    {
+        numInlineValues = 4,
+        minValuesForHashTable = 24
     };
 
-    friend class LinkedListPointer<NamedValue>;
-    LinkedListPointer<NamedValue> values;
+    // The values live in inlineStorage until there are too many of them, and then move to
+    // a block from ArenaAllocationPolicy. (There's deliberately no pointer to the inline
+    // storage, so that a set can safely be moved around in memory by an Array).
+    NamedValue* heapValues;
+    int numValues, numAllocated;
 
-    friend class JSONFormatter;
+    // If there are enough values, this holds (index + 1) of each one, at a position found
+    // by hashing its identifier, with 0 marking an empty slot.
+    HeapBlock<int, false, ArenaAllocationPolicy> hashTable;
+    int hashTableMask;
+
+    union
+    {
+        char data [numInlineValues * sizeof (NamedValue)];
+        double alignmentDummy1;
+        void* alignmentDummy2;
+    } inlineStorage;
+
+    NamedValue* getValues() const noexcept;
+    int indexOf (const Identifier name) const noexcept;
+    void ensureAllocatedSize (int minNumValues);
+    NamedValue* addSpaceForNewValue();
+    void valueAdded();
+    void rebuildHashTable();
+    void takeValuesFrom (NamedValueSet& other) noexcept;
 };
 
 
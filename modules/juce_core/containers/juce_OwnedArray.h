@@ -51,10 +51,14 @@
     To make all the array's methods thread-safe, pass in "CriticalSection" as the templated
     TypeOfCriticalSectionToUse parameter, instead of the default DummyCriticalSection.
 
+    The AllocationPolicy parameter controls where the array's storage comes from - see
+    StandardAllocationPolicy and ArenaAllocationPolicy.
+
     @see Array, ReferenceCountedArray, StringArray, CriticalSection
 */
 template <class ObjectClass,
-          class TypeOfCriticalSectionToUse = DummyCriticalSection>
+          class TypeOfCriticalSectionToUse = DummyCriticalSection,
+          class AllocationPolicy = StandardAllocationPolicy>
 
 class OwnedArray
 {
@@ -78,7 +82,7 @@ public:
 
    #if JUCE_COMPILER_SUPPORTS_MOVE_SEMANTICS
     OwnedArray (OwnedArray&& other) noexcept
-        : data (static_cast <ArrayAllocationBase <ObjectClass*, TypeOfCriticalSectionToUse>&&> (other.data)),
+        : data (static_cast <ArrayAllocationBase <ObjectClass*, TypeOfCriticalSectionToUse, AllocationPolicy>&&> (other.data)),
           numUsed (other.numUsed)
     {
         other.numUsed = 0;
@@ -89,7 +93,7 @@ public:
         const ScopedLockType lock (getLock());
         deleteAllObjects();
 
-        data = static_cast <ArrayAllocationBase <ObjectClass*, TypeOfCriticalSectionToUse>&&> (other.data);
+        data = static_cast <ArrayAllocationBase <ObjectClass*, TypeOfCriticalSectionToUse, AllocationPolicy>&&> (other.data);
         numUsed = other.numUsed;
         other.numUsed = 0;
         return *this;
@@ -841,6 +845,23 @@ public:
         sortArray (comparator, data.elements.getData(), 0, size() - 1, retainOrderOfEquivalentItems);
     }
 
+    /** Sorts the elements in the array, using the threads of a ThreadPool to do the work.
+
+        This is the same as the other sort() method, but for large arrays the work is split
+        between the pool's threads, using parallelSortArray(). The comparator's
+        compareElements() method will be called concurrently, so must be thread-safe.
+
+        @see sort, parallelSortArray
+    */
+    template <class ElementComparator>
+    void sort (ElementComparator& comparator,
+               ThreadPool& pool,
+               const bool retainOrderOfEquivalentItems = false) const
+    {
+        const ScopedLockType lock (getLock());
+        parallelSortArray (pool, comparator, data.elements.getData(), size(), retainOrderOfEquivalentItems);
+    }
+
     //==============================================================================
     /** Returns the CriticalSection that locks this array.
         To lock, you can call getLock().enter() and getLock().exit(), or preferably use
@@ -854,7 +875,7 @@ public:
 
 private:
     //==============================================================================
-    ArrayAllocationBase <ObjectClass*, TypeOfCriticalSectionToUse> data;
+    ArrayAllocationBase <ObjectClass*, TypeOfCriticalSectionToUse, AllocationPolicy> data;
     int numUsed;
 
     void deleteAllObjects()
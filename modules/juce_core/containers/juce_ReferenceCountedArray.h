@@ -46,9 +46,14 @@
     To make all the array's methods thread-safe, pass in "CriticalSection" as the templated
     TypeOfCriticalSectionToUse parameter, instead of the default DummyCriticalSection.
 
+    The AllocationPolicy parameter controls where the array's storage comes from - see
+    StandardAllocationPolicy and ArenaAllocationPolicy.
+
     @see Array, OwnedArray, StringArray
 */
-template <class ObjectClass, class TypeOfCriticalSectionToUse = DummyCriticalSection>
+template <class ObjectClass,
+          class TypeOfCriticalSectionToUse = DummyCriticalSection,
+          class AllocationPolicy = StandardAllocationPolicy>
 class ReferenceCountedArray
 {
 public:
@@ -77,10 +82,10 @@ public:
     }
 
     /** Creates a copy of another array */
-    template <class OtherObjectClass, class OtherCriticalSection>
-    ReferenceCountedArray (const ReferenceCountedArray<OtherObjectClass, OtherCriticalSection>& other) noexcept
+    template <class OtherObjectClass, class OtherCriticalSection, class OtherAllocationPolicy>
+    ReferenceCountedArray (const ReferenceCountedArray<OtherObjectClass, OtherCriticalSection, OtherAllocationPolicy>& other) noexcept
     {
-        const typename ReferenceCountedArray<OtherObjectClass, OtherCriticalSection>::ScopedLockType lock (other.getLock());
+        const typename ReferenceCountedArray<OtherObjectClass, OtherCriticalSection, OtherAllocationPolicy>::ScopedLockType lock (other.getLock());
         numUsed = other.size();
         data.setAllocatedSize (numUsed);
         memcpy (data.elements, other.getRawDataPointer(), numUsed * sizeof (ObjectClass*));
@@ -104,9 +109,9 @@ public:
         Any existing objects in this array will first be released.
     */
     template <class OtherObjectClass>
-    ReferenceCountedArray<ObjectClass, TypeOfCriticalSectionToUse>& operator= (const ReferenceCountedArray<OtherObjectClass, TypeOfCriticalSectionToUse>& other) noexcept
+    ReferenceCountedArray& operator= (const ReferenceCountedArray<OtherObjectClass, TypeOfCriticalSectionToUse, AllocationPolicy>& other) noexcept
     {
-        ReferenceCountedArray<ObjectClass, TypeOfCriticalSectionToUse> otherCopy (other);
+        ReferenceCountedArray otherCopy (other);
         swapWithArray (otherCopy);
         return *this;
     }
@@ -407,7 +412,7 @@ public:
                                     all available elements will be copied.
         @see add
     */
-    void addArray (const ReferenceCountedArray<ObjectClass, TypeOfCriticalSectionToUse>& arrayToAddFrom,
+    void addArray (const ReferenceCountedArray& arrayToAddFrom,
                    int startIndex = 0,
                    int numElementsToAdd = -1) noexcept
     {
@@ -771,7 +776,7 @@ public:
 
         @see operator==
     */
-    bool operator!= (const ReferenceCountedArray<ObjectClass, TypeOfCriticalSectionToUse>& other) const noexcept
+    bool operator!= (const ReferenceCountedArray& other) const noexcept
     {
         return ! operator== (other);
     }
@@ -852,7 +857,7 @@ public:
 
 private:
     //==============================================================================
-    ArrayAllocationBase <ObjectClass*, TypeOfCriticalSectionToUse> data;
+    ArrayAllocationBase <ObjectClass*, TypeOfCriticalSectionToUse, AllocationPolicy> data;
     int numUsed;
 };
 
@@ -270,8 +270,8 @@ public:
     VariantType_Array() noexcept {}
     static const VariantType_Array instance;
 
-    void cleanUp (ValueUnion& data) const noexcept                      { delete data.arrayValue; }
-    void createCopy (ValueUnion& dest, const ValueUnion& source) const  { dest.arrayValue = new Array<var> (*(source.arrayValue)); }
+    void cleanUp (ValueUnion& data) const noexcept                      { deleteArray (data.arrayValue); }
+    void createCopy (ValueUnion& dest, const ValueUnion& source) const  { dest.arrayValue = createArray (*(source.arrayValue)); }
 
     String toString (const ValueUnion&) const                           { return "[Array]"; }
     bool isArray() const noexcept                                       { return true; }
@@ -296,6 +296,22 @@ public:
         output.writeByte (varMarker_Array);
         output << buffer;
     }
+
+    // the arrays come from the current MemoryArena, if there is one
+    typedef Array<var> VarArray;
+
+    static VarArray* createArray (const VarArray& source)
+    {
+        void* const space = ArenaAllocationPolicy::allocate (sizeof (VarArray));
+        jassert (space != nullptr);
+        return new (space) VarArray (source);
+    }
+
+    static void deleteArray (VarArray* const array) noexcept
+    {
+        array->~VarArray();
+        ArenaAllocationPolicy::release (array);
+    }
 };
 
 //==============================================================================
@@ -386,7 +402,7 @@ var::var (const int64 v) noexcept     : type (&VariantType_Int64::instance)  { v
 var::var (const bool v) noexcept      : type (&VariantType_Bool::instance)   { value.boolValue = v; }
 var::var (const double v) noexcept    : type (&VariantType_Double::instance) { value.doubleValue = v; }
 var::var (MethodFunction m) noexcept  : type (&VariantType_Method::instance) { value.methodValue = m; }
-var::var (const Array<var>& v)        : type (&VariantType_Array::instance)  { value.arrayValue = new Array<var> (v); }
+var::var (const Array<var>& v)        : type (&VariantType_Array::instance)  { value.arrayValue = VariantType_Array::createArray (v); }
 var::var (const String& v)            : type (&VariantType_String::instance) { new (value.stringValue) String (v); }
 var::var (const char* const v)        : type (&VariantType_String::instance) { new (value.stringValue) String (v); }
 var::var (const wchar_t* const v)     : type (&VariantType_String::instance) { new (value.stringValue) String (v); }
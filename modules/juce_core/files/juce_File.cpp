@@ -253,9 +253,14 @@ bool File::moveFileTo (const File& newFile) const
 }
 
 bool File::copyFileTo (const File& newFile) const
+{
+    return copyFileTo (newFile, nullptr);
+}
+
+bool File::copyFileTo (const File& newFile, CopyProgressCallback* const progressCallback) const
 {
     return (*this == newFile)
-            || (exists() && newFile.deleteFile() && copyInternal (newFile));
+            || (exists() && newFile.deleteFile() && copyInternal (newFile, progressCallback));
 }
 
 bool File::copyDirectoryTo (const File& newDirectory) const
@@ -655,9 +660,9 @@ bool File::startAsProcess (const String& parameters) const
 }
 
 //==============================================================================
-FileInputStream* File::createInputStream() const
+FileInputStream* File::createInputStream (const int streamAccessFlags) const
 {
-    ScopedPointer<FileInputStream> fin (new FileInputStream (*this));
+    ScopedPointer<FileInputStream> fin (new FileInputStream (*this, streamAccessFlags));
 
     if (fin->openedOk())
         return fin.release();
@@ -665,9 +670,9 @@ FileInputStream* File::createInputStream() const
     return nullptr;
 }
 
-FileOutputStream* File::createOutputStream (const int bufferSize) const
+FileOutputStream* File::createOutputStream (const int bufferSize, const int streamAccessFlags) const
 {
-    ScopedPointer<FileOutputStream> out (new FileOutputStream (*this, bufferSize));
+    ScopedPointer<FileOutputStream> out (new FileOutputStream (*this, bufferSize, streamAccessFlags));
 
     return out->failedToOpen() ? nullptr
                                : out.release();
@@ -1031,6 +1036,10 @@ public:
             fo.write ("789", 3);
             fo.flush();
             expect (tempFile.getSize() == 10);
+
+            fo.preallocate (65536);  // (the file system may not support this, but it mustn't change the length)
+            expect (tempFile.getSize() == 10);
+            expect (fo.getPosition() == 10);
         }
 
         beginTest ("Memory-mapped files");
@@ -1064,6 +1073,66 @@ public:
             expect (tempFile2.deleteFile());
         }
 
+        beginTest ("Unbuffered streams");
+
+        {
+            const File tempFile2 (tempFile.getNonexistentSibling (false));
+            const int flags[] = { File::sequentialAccess, File::randomAccess | File::dontCache,
+                                  File::unbufferedAccess, File::unbufferedAccess | File::dontCache };
+
+            for (int i = 0; i < numElementsInArray (flags); ++i)
+            {
+                Random r;
+                MemoryBlock data (300000 + (size_t) r.nextInt (10000));
+
+                for (size_t j = 0; j < data.getSize(); ++j)
+                    data[j] = (char) r.nextInt (256);
+
+                {
+                    FileOutputStream fo (tempFile2, 0x8000, flags[i]);
+                    expect (fo.openedOk());
+
+                    for (size_t pos = 0; pos < data.getSize();)
+                    {
+                        const size_t num = jmin (data.getSize() - pos, (size_t) r.nextInt (40000));
+                        expect (fo.write (static_cast<const char*> (data.getData()) + pos, num));
+                        pos += num;
+                    }
+
+                    // overwrite a section in the middle, which won't be aligned
+                    const int64 overwritePos = 12345;
+                    for (int j = 0; j < 100000; ++j)
+                        data [(size_t) (overwritePos + j)] = (char) r.nextInt (256);
+
+                    expect (fo.setPosition (overwritePos));
+                    expect (fo.write (static_cast<const char*> (data.getData()) + overwritePos, 100000));
+                    expect (fo.getPosition() == overwritePos + 100000);
+                }
+
+                expect (tempFile2.getSize() == (int64) data.getSize());
+
+                {
+                    FileInputStream fi (tempFile2, flags[i]);
+                    expect (fi.openedOk());
+
+                    MemoryBlock readBack (data.getSize());
+                    expect (fi.read (readBack.getData(), (int) readBack.getSize()) == (int) data.getSize());
+                    expect (readBack == data);
+
+                    for (int j = 0; j < 20; ++j)
+                    {
+                        const int pos = r.nextInt ((int) data.getSize());
+                        const int num = jmin ((int) data.getSize() - pos, r.nextInt (20000));
+                        expect (fi.setPosition (pos));
+                        expect (fi.read (readBack.getData(), num) == num);
+                        expect (memcmp (readBack.getData(), static_cast<const char*> (data.getData()) + pos, (size_t) num) == 0);
+                    }
+                }
+
+                expect (tempFile2.deleteFile());
+            }
+        }
+
         beginTest ("More writing");
 
         expect (tempFile.appendData ("abcdefghij", 10));
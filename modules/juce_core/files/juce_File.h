@@ -498,6 +498,34 @@ public:
     */
     bool copyFileTo (const File& targetLocation) const;
 
+    /** Receives progress reports while a file is being copied.
+        @see copyFileTo, FileCopier
+    */
+    class JUCE_API  CopyProgressCallback
+    {
+    public:
+        /** Destructor. */
+        virtual ~CopyProgressCallback() {}
+
+        /** Called on the copying thread each time another block of data has been copied.
+            If this returns false, the copy is abandoned and the partly-written target
+            file is deleted.
+        */
+        virtual bool copyProgress (int64 bytesCopied, int64 totalBytes) = 0;
+    };
+
+    /** Copies a file, reporting its progress to a callback.
+
+        This works like the other copyFileTo() method, and the copy is done by the OS
+        wherever possible: on Linux the data is moved by the kernel (or the file is
+        reflinked, on filesystems that support it), on OSX the file is cloned where
+        possible, and on Windows CopyFileEx is used.
+
+        @returns    true if the operation succeeds, or false if it fails or the
+                    callback cancels it
+    */
+    bool copyFileTo (const File& targetLocation, CopyProgressCallback* progressCallback) const;
+
     /** Copies a directory.
 
         Tries to copy an entire directory, recursively.
@@ -571,13 +599,36 @@ public:
     bool containsSubDirectories() const;
 
     //==============================================================================
+    /** Hints that can be given to a FileInputStream or FileOutputStream about how the
+        file is going to be used.
+
+        These can be combined with a bitwise-or. They don't change what the stream does,
+        but they let the OS make better use of its file cache - e.g. when streaming or
+        recording lots of large audio files, using dontCache or unbufferedAccess stops
+        them from pushing more useful things (like sample libraries) out of the cache.
+
+        @see createInputStream, createOutputStream
+    */
+    enum StreamAccessFlags
+    {
+        defaultAccess       = 0,
+        sequentialAccess    = 1,    /**< The file will mostly be read from start to end, so the OS should read well ahead. */
+        randomAccess        = 2,    /**< The file will be read in a random order, so the OS shouldn't bother reading ahead. */
+        dontCache           = 4,    /**< Once the stream has finished with some data, the OS needn't keep it in its cache. */
+        unbufferedAccess    = 8     /**< Data should go straight between the disk and the stream, bypassing the OS cache
+                                         where the platform allows it. On some platforms this needs the reads and writes
+                                         to be aligned to the disk's sectors, but the streams take care of that. If the
+                                         file system can't do it, this falls back to behaving like dontCache. */
+    };
+
     /** Creates a stream to read from this file.
 
+        @param streamAccessFlags    a combination of values from the StreamAccessFlags enum
         @returns    a stream that will read from this file (initially positioned at the
                     start of the file), or nullptr if the file can't be opened for some reason
         @see createOutputStream, loadFileAsData
     */
-    FileInputStream* createInputStream() const;
+    FileInputStream* createInputStream (int streamAccessFlags = defaultAccess) const;
 
     /** Creates a stream to write to this file.
 
@@ -585,11 +636,14 @@ public:
         writing at the end of the file, so you might want to use deleteFile() first
         to write to an empty file.
 
+        @param bufferSize           the size of the stream's internal buffer
+        @param streamAccessFlags    a combination of values from the StreamAccessFlags enum
         @returns    a stream that will write to this file (initially positioned at the
                     end of the file), or nullptr if the file can't be opened for some reason
         @see createInputStream, appendData, appendText
     */
-    FileOutputStream* createOutputStream (int bufferSize = 0x8000) const;
+    FileOutputStream* createOutputStream (int bufferSize = 0x8000,
+                                          int streamAccessFlags = defaultAccess) const;
 
     //==============================================================================
     /** Loads a file's contents into memory as a block of binary data.
@@ -948,7 +1002,7 @@ private:
     String getPathUpToLastSlash() const;
 
     Result createDirectoryInternal (const String&) const;
-    bool copyInternal (const File&) const;
+    bool copyInternal (const File&, CopyProgressCallback*) const;
     bool moveInternal (const File&) const;
     bool setFileTimesInternal (int64 m, int64 a, int64 c) const;
     void getFileTimesInternal (int64& m, int64& a, int64& c) const;
@@ -0,0 +1,300 @@
+/*
+  ==============================================================================
+
+   This file is part of the juce_core module of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission to use, copy, modify, and/or distribute this software for any purpose with
+   or without fee is hereby granted, provided that the above copyright notice and this
+   permission notice appear in all copies.
+
+   THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+   TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+   NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+   DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+   IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+   ------------------------------------------------------------------------------
+
+   NOTE! This permissive ISC license applies ONLY to files within the juce_core module!
+   All other JUCE modules are covered by a dual GPL/commercial license, so if you are
+   using any other modules, be sure to check that you also comply with their license.
+
+   For more details, visit www.juce.com
+
+  ==============================================================================
+*/
+
+class FileCopier::CopyFileTask  : public ThreadPoolTask,
+                                  private File::CopyProgressCallback
+{
+public:
+    CopyFileTask (FileCopier& f, const File& s, const File& d, Listener* l)
+        : owner (f), source (s), destination (d), listener (l)
+    {}
+
+    void runTask()
+    {
+        const bool ok = owner.shouldStop.get() == 0
+                         && source.copyFileTo (destination, this);
+
+        if (ok)
+            ++(owner.numFilesCopied);
+        else if (owner.shouldStop.get() == 0)
+            ++(owner.numFailures);
+
+        if (listener != nullptr)
+            listener->fileCopyFinished (source, destination, ok);
+
+        owner.taskFinished();
+    }
+
+private:
+    FileCopier& owner;
+    const File source, destination;
+    Listener* const listener;
+
+    bool copyProgress (int64 bytesCopied, int64 totalBytes)
+    {
+        return owner.shouldStop.get() == 0
+                && (listener == nullptr || listener->fileCopyProgress (source, destination, bytesCopied, totalBytes));
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (CopyFileTask)
+};
+
+class FileCopier::CopyDirectoryTask  : public ThreadPoolTask
+{
+public:
+    CopyDirectoryTask (FileCopier& f, const File& s, const File& d, Listener* l)
+        : owner (f), source (s), destination (d), listener (l)
+    {}
+
+    void runTask()
+    {
+        if (owner.shouldStop.get() == 0)
+            owner.copyDirectoryContents (source, destination, listener);
+
+        owner.taskFinished();
+    }
+
+private:
+    FileCopier& owner;
+    const File source, destination;
+    Listener* const listener;
+
+    JUCE_DECLARE_NON_COPYABLE (CopyDirectoryTask)
+};
+
+//==============================================================================
+bool FileCopier::Listener::fileCopyProgress (const File&, const File&, int64, int64)
+{
+    return true;
+}
+
+//==============================================================================
+FileCopier::FileCopier (ThreadPool& poolToUse)
+    : pool (poolToUse), finished (true)
+{
+    finished.signal();
+}
+
+FileCopier::~FileCopier()
+{
+    cancelAll();
+}
+
+void FileCopier::copyFile (const File& source, const File& destination, Listener* const listener)
+{
+    addTask (new CopyFileTask (*this, source, destination, listener));
+}
+
+void FileCopier::copyDirectory (const File& source, const File& destination, Listener* const listener)
+{
+    if (source.isDirectory())
+        addTask (new CopyDirectoryTask (*this, source, destination, listener));
+    else
+        ++numFailures;
+}
+
+void FileCopier::cancelAll()
+{
+    shouldStop = 1;
+    waitForCopiesToFinish();
+    shouldStop = 0;
+}
+
+bool FileCopier::waitForCopiesToFinish (const int timeOutMilliseconds) const
+{
+    const uint32 startTime = Time::getMillisecondCounter();
+
+    for (;;)
+    {
+        // (the event is reset before checking the count, so a task that finishes in
+        // between can't leave us waiting for a signal that's already been and gone)
+        finished.reset();
+
+        if (! isCopying())
+            return true;
+
+        int timeout = -1;
+
+        if (timeOutMilliseconds >= 0)
+        {
+            timeout = timeOutMilliseconds - (int) (Time::getMillisecondCounter() - startTime);
+
+            if (timeout <= 0)
+                return false;
+        }
+
+        finished.wait (timeout);
+    }
+}
+
+void FileCopier::addTask (ThreadPoolTask* const task)
+{
+    ++numTasksPending;
+    pool.addTask (task);
+}
+
+void FileCopier::taskFinished()
+{
+    if (--numTasksPending == 0)
+        finished.signal();
+}
+
+void FileCopier::copyDirectoryContents (const File& source, const File& destination, Listener* const listener)
+{
+    if (destination.createDirectory().failed())
+    {
+        ++numFailures;
+        return;
+    }
+
+    DirectoryIterator iter (source, false, "*", File::findFilesAndDirectories);
+    bool isDirectory;
+
+    while (shouldStop.get() == 0 && iter.next (&isDirectory, nullptr, nullptr, nullptr, nullptr, nullptr))
+    {
+        const File& file = iter.getFile();
+        const File target (destination.getChildFile (file.getFileName()));
+
+        // subdirectories go back into the pool, so that idle threads can start on them
+        // while this one carries on reading..
+        if (isDirectory)
+            addTask (new CopyDirectoryTask (*this, file, target, listener));
+        else
+            addTask (new CopyFileTask (*this, file, target, listener));
+    }
+}
+
+//==============================================================================
+bool FileCopier::copyDirectory (ThreadPool& pool, const File& source, const File& destination)
+{
+    FileCopier copier (pool);
+    copier.copyDirectory (source, destination);
+    copier.waitForCopiesToFinish();
+    return copier.getNumFailures() == 0;
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class FileCopierTests  : public UnitTest
+{
+public:
+    FileCopierTests() : UnitTest ("FileCopier") {}
+
+    struct ProgressRecorder  : public File::CopyProgressCallback
+    {
+        ProgressRecorder (int64 limit) : numCalls (0), lastBytesCopied (0), cancelAfter (limit) {}
+
+        bool copyProgress (int64 bytesCopied, int64)
+        {
+            ++numCalls;
+            lastBytesCopied = bytesCopied;
+            return bytesCopied < cancelAfter;
+        }
+
+        int numCalls;
+        int64 lastBytesCopied, cancelAfter;
+    };
+
+    void runTest()
+    {
+        const File root (File::createTempFile ("FileCopier"));
+        Random r;
+
+        beginTest ("Copying a file with progress");
+
+        {
+            expect (root.createDirectory());
+
+            MemoryBlock data (20 * 1024 * 1024 + 123);
+            for (size_t i = 0; i < data.getSize(); ++i)
+                data[i] = (char) r.nextInt (256);
+
+            const File source (root.getChildFile ("source.dat"));
+            const File dest (root.getChildFile ("dest.dat"));
+            expect (source.replaceWithData (data.getData(), data.getSize()));
+
+            ProgressRecorder progress (std::numeric_limits<int64>::max());
+            expect (source.copyFileTo (dest, &progress));
+            expect (progress.numCalls > 0);
+            expect (progress.lastBytesCopied == (int64) data.getSize());
+
+            MemoryBlock copied;
+            expect (dest.loadFileAsData (copied));
+            expect (copied == data);
+
+            ProgressRecorder canceller (1);
+            expect (! source.copyFileTo (dest, &canceller));
+            expect (! dest.exists());
+        }
+
+        beginTest ("Copying a directory tree");
+
+        {
+            const File tree (root.getChildFile ("tree"));
+            StringArray relativePaths;
+
+            for (int i = 0; i < 10; ++i)
+            {
+                String dir ("dir" + String (i));
+
+                for (int depth = r.nextInt (4); --depth >= 0;)
+                    dir << "/sub" << depth;
+
+                expect (tree.getChildFile (dir).createDirectory());
+
+                for (int j = r.nextInt (8); --j >= 0;)
+                {
+                    const String path (dir + "/file" + String (j) + ".txt");
+                    expect (tree.getChildFile (path).replaceWithText (path + String (r.nextInt())));
+                    relativePaths.add (path);
+                }
+            }
+
+            ThreadPool pool (3);
+            const File copy (root.getChildFile ("copy"));
+            expect (FileCopier::copyDirectory (pool, tree, copy));
+
+            for (int i = 0; i < relativePaths.size(); ++i)
+                expect (copy.getChildFile (relativePaths[i]).loadFileAsString()
+                          == tree.getChildFile (relativePaths[i]).loadFileAsString());
+
+            Array<File> originals, copies;
+            expectEquals (tree.findChildFiles (originals, File::findFilesAndDirectories, true),
+                          copy.findChildFiles (copies, File::findFilesAndDirectories, true));
+
+            expect (! FileCopier::copyDirectory (pool, root.getChildFile ("missing"), root.getChildFile ("x")));
+        }
+
+        root.deleteRecursively();
+    }
+};
+
+static FileCopierTests fileCopierTests;
+
+#endif
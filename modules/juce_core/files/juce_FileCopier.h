@@ -0,0 +1,163 @@
+/*
+  ==============================================================================
+
+   This file is part of the juce_core module of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission to use, copy, modify, and/or distribute this software for any purpose with
+   or without fee is hereby granted, provided that the above copyright notice and this
+   permission notice appear in all copies.
+
+   THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+   TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+   NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+   DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+   IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+   ------------------------------------------------------------------------------
+
+   NOTE! This permissive ISC license applies ONLY to files within the juce_core module!
+   All other JUCE modules are covered by a dual GPL/commercial license, so if you are
+   using any other modules, be sure to check that you also comply with their license.
+
+   For more details, visit www.juce.com
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_FILECOPIER_JUCEHEADER__
+#define __JUCE_FILECOPIER_JUCEHEADER__
+
+#include "juce_File.h"
+#include "../threads/juce_ThreadPool.h"
+
+
+//==============================================================================
+/**
+    Copies files and directory trees in the background, using a ThreadPool.
+
+    Each file is copied by its own ThreadPoolTask using File::copyFileTo(), so the data
+    is moved by the OS wherever possible. When a directory is copied, each of its
+    subdirectories is read by a separate task too, so big trees of small files get
+    copied by several threads at once.
+
+    Progress and completion are reported to a Listener, on whichever pool thread is
+    doing the work. If you just want to copy a directory and wait for it, the static
+    copyDirectory() method does the whole thing for you.
+
+    @code
+    ThreadPool pool;
+    FileCopier::copyDirectory (pool, File ("/samples/piano"), File ("/backup/piano"));
+    @endcode
+
+    @see File::copyFileTo, File::copyDirectoryTo, ParallelFileFinder
+*/
+class JUCE_API  FileCopier
+{
+public:
+    //==============================================================================
+    /** Receives progress reports from a FileCopier.
+
+        The callbacks are made on the pool's threads, and several of them can be
+        running at once, so they must be thread-safe.
+    */
+    class JUCE_API  Listener
+    {
+    public:
+        /** Destructor. */
+        virtual ~Listener() {}
+
+        /** Called each time another block of a file has been copied. If this returns
+            false, that file's copy is abandoned. The default implementation returns true.
+        */
+        virtual bool fileCopyProgress (const File& source, const File& destination,
+                                       int64 bytesCopied, int64 totalBytes);
+
+        /** Called when a file has been copied, or has failed to copy. */
+        virtual void fileCopyFinished (const File& source, const File& destination,
+                                       bool succeeded) = 0;
+    };
+
+    //==============================================================================
+    /** Creates a copier that will use the given pool.
+        The pool must not be deleted before this object is.
+    */
+    explicit FileCopier (ThreadPool& poolToUse);
+
+    /** Destructor.
+        If any copies are still running, this cancels them and waits for them to stop.
+    */
+    ~FileCopier();
+
+    //==============================================================================
+    /** Starts copying a file, and returns immediately.
+
+        If the destination file already exists, it'll be replaced.
+
+        @param source       the file to copy
+        @param destination  the name of the new file (not the directory to put it in)
+        @param listener     an optional listener to receive progress reports. It must
+                            stay valid until the copy has finished
+    */
+    void copyFile (const File& source, const File& destination, Listener* listener = nullptr);
+
+    /** Starts copying a directory and everything inside it, and returns immediately.
+
+        @param source       the directory to copy
+        @param destination  the directory to create, as for File::copyDirectoryTo()
+        @param listener     an optional listener to receive progress reports. It must
+                            stay valid until the copy has finished
+    */
+    void copyDirectory (const File& source, const File& destination, Listener* listener = nullptr);
+
+    /** Cancels all the copies that are pending or in progress, and waits for them to stop.
+        Any files that were only partly copied are deleted.
+    */
+    void cancelAll();
+
+    /** Waits for all the pending copies to finish.
+        @returns true if they finished, or false if the timeout expired first
+    */
+    bool waitForCopiesToFinish (int timeOutMilliseconds = -1) const;
+
+    /** Returns true if any copies are still pending or running. */
+    bool isCopying() const noexcept                 { return numTasksPending.get() > 0; }
+
+    /** Returns the number of files that have been copied successfully. */
+    int getNumFilesCopied() const noexcept          { return numFilesCopied.get(); }
+
+    /** Returns the number of files or directories that couldn't be copied. */
+    int getNumFailures() const noexcept             { return numFailures.get(); }
+
+    //==============================================================================
+    /** Copies a directory tree using the pool's threads, and waits for it to finish.
+
+        This works like File::copyDirectoryTo(), but copies several files at once. Don't
+        call it from one of the pool's own threads, as it blocks until everything has
+        been copied.
+
+        @returns true if every file and directory was copied successfully
+    */
+    static bool copyDirectory (ThreadPool& pool, const File& source, const File& destination);
+
+private:
+    //==============================================================================
+    class CopyFileTask;
+    class CopyDirectoryTask;
+    friend class CopyFileTask;
+    friend class CopyDirectoryTask;
+
+    ThreadPool& pool;
+    Atomic<int> numTasksPending, numFilesCopied, numFailures, shouldStop;
+    WaitableEvent finished;
+
+    void addTask (ThreadPoolTask*);
+    void taskFinished();
+    void copyDirectoryContents (const File& source, const File& destination, Listener*);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FileCopier)
+};
+
+
+#endif   // __JUCE_FILECOPIER_JUCEHEADER__
@@ -27,20 +27,50 @@
 */
 
 int64 juce_fileSetPosition (void* handle, int64 pos);
+void juce_releaseCachedFileData (void* handle, int64 start, int64 numBytes, bool writeBackFirst);
+
+namespace FileStreamHelpers
+{
+    // Unbuffered reads and writes must be aligned to the disk's sectors - this covers
+    // both 512-byte and 4K sectors.
+    static const size_t unbufferedAlignment = 4096;
+    static const size_t unbufferedReadSize = 256 * 1024;
+
+    // Once this much data has been read or written, a dontCache stream tells the OS to drop it.
+    static const int64 cacheReleaseInterval = 4 * 1024 * 1024;
+
+    static char* allocateAligned (HeapBlock<char>& storage, const size_t numBytes)
+    {
+        storage.malloc (numBytes + unbufferedAlignment);
+
+        const pointer_sized_int mask = (pointer_sized_int) unbufferedAlignment - 1;
+        return reinterpret_cast<char*> ((reinterpret_cast<pointer_sized_int> (storage.getData()) + mask) & ~mask);
+    }
+}
 
 //==============================================================================
-FileInputStream::FileInputStream (const File& f)
+FileInputStream::FileInputStream (const File& f, const int streamAccessFlags)
     : file (f),
       fileHandle (nullptr),
       currentPosition (0),
       status (Result::ok()),
-      needToSeek (true)
+      needToSeek (true),
+      accessFlags (streamAccessFlags),
+      needsAlignedAccess (false),
+      alignedBuffer (nullptr),
+      alignedBufferStart (0),
+      cacheReleaseStart (0),
+      numBytesInAlignedBuffer (0)
 {
     openHandle();
+
+    if (needsAlignedAccess)
+        alignedBuffer = FileStreamHelpers::allocateAligned (alignedBufferStorage, FileStreamHelpers::unbufferedReadSize);
 }
 
 FileInputStream::~FileInputStream()
 {
+    releaseCachedData (true);
     closeHandle();
 }
 
@@ -55,6 +85,9 @@ int FileInputStream::read (void* buffer, int bytesToRead)
     jassert (openedOk());
     jassert (buffer != nullptr && bytesToRead >= 0);
 
+    if (alignedBuffer != nullptr)
+        return (int) readAligned (static_cast<char*> (buffer), (size_t) bytesToRead);
+
     if (needToSeek)
     {
         if (juce_fileSetPosition (fileHandle, currentPosition) < 0)
@@ -65,10 +98,59 @@ int FileInputStream::read (void* buffer, int bytesToRead)
 
     const size_t num = readInternal (buffer, (size_t) bytesToRead);
     currentPosition += num;
+    releaseCachedData (false);
 
     return (int) num;
 }
 
+size_t FileInputStream::readAligned (char* const buffer, const size_t numBytes)
+{
+    size_t numDone = 0;
+
+    while (numDone < numBytes)
+    {
+        if (currentPosition < alignedBufferStart
+             || currentPosition >= alignedBufferStart + (int64) numBytesInAlignedBuffer)
+        {
+            // (the file position, size and memory address of unbuffered reads all need to be aligned)
+            alignedBufferStart = currentPosition - (currentPosition % (int64) FileStreamHelpers::unbufferedAlignment);
+            numBytesInAlignedBuffer = 0;
+
+            if (juce_fileSetPosition (fileHandle, alignedBufferStart) < 0)
+                break;
+
+            numBytesInAlignedBuffer = readInternal (alignedBuffer, FileStreamHelpers::unbufferedReadSize);
+
+            if (currentPosition >= alignedBufferStart + (int64) numBytesInAlignedBuffer)
+                break;
+        }
+
+        const size_t offset = (size_t) (currentPosition - alignedBufferStart);
+        const size_t num = jmin (numBytes - numDone, numBytesInAlignedBuffer - offset);
+
+        memcpy (buffer + numDone, alignedBuffer + offset, num);
+        numDone += num;
+        currentPosition += (int64) num;
+    }
+
+    return numDone;
+}
+
+void FileInputStream::releaseCachedData (const bool force)
+{
+    // (an unbuffered stream doesn't go through the cache in the first place)
+    if ((accessFlags & (File::dontCache | File::unbufferedAccess)) != 0 && alignedBuffer == nullptr)
+    {
+        const int64 numBytes = currentPosition - cacheReleaseStart;
+
+        if (numBytes >= FileStreamHelpers::cacheReleaseInterval || (force && numBytes > 0))
+        {
+            juce_releaseCachedFileData (fileHandle, cacheReleaseStart, numBytes, false);
+            cacheReleaseStart = currentPosition;
+        }
+    }
+}
+
 bool FileInputStream::isExhausted()
 {
     return currentPosition >= getTotalLength();
@@ -87,8 +169,10 @@ bool FileInputStream::setPosition (int64 pos)
     {
         pos = jlimit ((int64) 0, getTotalLength(), pos);
 
+        releaseCachedData (true);
         needToSeek |= (currentPosition != pos);
         currentPosition = pos;
+        cacheReleaseStart = pos;
     }
 
     return true;
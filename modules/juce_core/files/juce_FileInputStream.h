@@ -45,10 +45,13 @@ public:
     //==============================================================================
     /** Creates a FileInputStream.
 
-        @param fileToRead   the file to read from - if the file can't be accessed for some
-                            reason, then the stream will just contain no data
+        @param fileToRead           the file to read from - if the file can't be accessed for some
+                                    reason, then the stream will just contain no data
+        @param streamAccessFlags    a combination of values from File::StreamAccessFlags, to tell
+                                    the OS how the file is going to be read
     */
-    explicit FileInputStream (const File& fileToRead);
+    explicit FileInputStream (const File& fileToRead,
+                              int streamAccessFlags = File::defaultAccess);
 
     /** Destructor. */
     ~FileInputStream();
@@ -88,10 +91,18 @@ private:
     int64 currentPosition;
     Result status;
     bool needToSeek;
+    const int accessFlags;
+    bool needsAlignedAccess;
+    HeapBlock<char> alignedBufferStorage;
+    char* alignedBuffer;
+    int64 alignedBufferStart, cacheReleaseStart;
+    size_t numBytesInAlignedBuffer;
 
     void openHandle();
     void closeHandle();
     size_t readInternal (void* buffer, size_t numBytes);
+    size_t readAligned (char* buffer, size_t numBytes);
+    void releaseCachedData (bool force);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FileInputStream)
 };
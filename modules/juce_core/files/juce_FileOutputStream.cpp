@@ -27,24 +27,44 @@
 */
 
 int64 juce_fileSetPosition (void* handle, int64 pos);
+void juce_releaseCachedFileData (void* handle, int64 start, int64 numBytes, bool writeBackFirst);
 
 //==============================================================================
-FileOutputStream::FileOutputStream (const File& f, const int bufferSize_)
+FileOutputStream::FileOutputStream (const File& f, const int bufferSize_, const int streamAccessFlags)
     : file (f),
       fileHandle (nullptr),
+      unbufferedHandle (nullptr),
       status (Result::ok()),
       currentPosition (0),
-      bufferSize (bufferSize_),
+      cacheReleasePosition (0),
+      bufferSize ((size_t) jmax (bufferSize_, 16)),
       bytesInBuffer (0),
-      buffer ((size_t) jmax (bufferSize_, 16))
+      buffer (nullptr),
+      accessFlags (streamAccessFlags)
 {
     openHandle();
+    cacheReleasePosition = currentPosition;
+
+    if (unbufferedHandle != nullptr)
+    {
+        // Unbuffered writes are done in whole blocks, straight from this buffer, so it
+        // has to be aligned, and big enough to make the writes efficient.
+        const size_t alignment = FileStreamHelpers::unbufferedAlignment;
+        bufferSize = jmax ((size_t) 65536, ((bufferSize + alignment - 1) / alignment) * alignment);
+        buffer = FileStreamHelpers::allocateAligned (bufferStorage, bufferSize);
+    }
+    else
+    {
+        bufferStorage.malloc (bufferSize);
+        buffer = bufferStorage;
+    }
 }
 
 FileOutputStream::~FileOutputStream()
 {
     flushBuffer();
     flushInternal();
+    releaseCachedData (true);
     closeHandle();
 }
 
@@ -58,7 +78,9 @@ bool FileOutputStream::setPosition (int64 newPosition)
     if (newPosition != currentPosition)
     {
         flushBuffer();
+        releaseCachedData (true);
         currentPosition = juce_fileSetPosition (fileHandle, newPosition);
+        cacheReleasePosition = currentPosition;
     }
 
     return newPosition == currentPosition;
@@ -66,17 +88,108 @@ bool FileOutputStream::setPosition (int64 newPosition)
 
 bool FileOutputStream::flushBuffer()
 {
+    if (unbufferedHandle != nullptr)
+        return writeAlignedBlocks (true);
+
     bool ok = true;
 
     if (bytesInBuffer > 0)
     {
         ok = (writeInternal (buffer, bytesInBuffer) == (ssize_t) bytesInBuffer);
         bytesInBuffer = 0;
+        releaseCachedData (false);
+    }
+
+    return ok;
+}
+
+bool FileOutputStream::writeToAlignedBuffer (const char* data, size_t numBytes)
+{
+    while (numBytes > 0)
+    {
+        const size_t numToCopy = jmin (numBytes, bufferSize - bytesInBuffer);
+
+        memcpy (buffer + bytesInBuffer, data, numToCopy);
+        bytesInBuffer += numToCopy;
+        currentPosition += (int64) numToCopy;
+        data += numToCopy;
+        numBytes -= numToCopy;
+
+        if (bytesInBuffer == bufferSize && ! writeAlignedBlocks (false))
+            return false;
+    }
+
+    return true;
+}
+
+/*  Writes as much of the buffer as possible in whole, aligned blocks through the unbuffered
+    handle. Any bytes before the first block boundary go through the normal handle, and so
+    does any partial block at the end if writeEverything is true - otherwise that's moved to
+    the start of the buffer, ready to be completed by the next write.
+*/
+bool FileOutputStream::writeAlignedBlocks (const bool writeEverything)
+{
+    const int64 alignment = (int64) FileStreamHelpers::unbufferedAlignment;
+    const int64 bufferStart = currentPosition - (int64) bytesInBuffer;
+
+    char* data = buffer;
+    size_t numLeft = bytesInBuffer;
+    bool ok = true;
+
+    const size_t numBeforeBoundary = (size_t) jmin ((int64) numLeft, (alignment - bufferStart % alignment) % alignment);
+
+    if (numBeforeBoundary > 0 && numBeforeBoundary < numLeft)
+    {
+        ok = (writeInternal (data, numBeforeBoundary) == (ssize_t) numBeforeBoundary);
+        numLeft -= numBeforeBoundary;
+
+        // (unbuffered writes have to come from an aligned address, too)
+        memmove (buffer, data + numBeforeBoundary, numLeft);
     }
 
+    const size_t numInBlocks = (size_t) (((int64) numLeft / alignment) * alignment);
+
+    if (ok && numInBlocks > 0)
+    {
+        const int64 blockStart = bufferStart + (int64) numBeforeBoundary;
+
+        ok = (writeUnbufferedInternal (data, numInBlocks, blockStart) == (ssize_t) numInBlocks)
+               && juce_fileSetPosition (fileHandle, blockStart + (int64) numInBlocks) >= 0;
+
+        data += numInBlocks;
+        numLeft -= numInBlocks;
+    }
+
+    if (ok && writeEverything && numLeft > 0)
+    {
+        ok = (writeInternal (data, numLeft) == (ssize_t) numLeft);
+        numLeft = 0;
+    }
+
+    if (! ok)
+        numLeft = 0;
+
+    if (numLeft > 0 && data != buffer)
+        memmove (buffer, data, numLeft);
+
+    bytesInBuffer = numLeft;
     return ok;
 }
 
+void FileOutputStream::releaseCachedData (const bool force)
+{
+    if ((accessFlags & (File::dontCache | File::unbufferedAccess)) != 0)
+    {
+        const int64 numBytes = currentPosition - (int64) bytesInBuffer - cacheReleasePosition;
+
+        if (numBytes >= FileStreamHelpers::cacheReleaseInterval || (force && numBytes > 0))
+        {
+            juce_releaseCachedFileData (fileHandle, cacheReleasePosition, numBytes, true);
+            cacheReleasePosition += numBytes;
+        }
+    }
+}
+
 void FileOutputStream::flush()
 {
     flushBuffer();
@@ -87,6 +200,9 @@ bool FileOutputStream::write (const void* const src, const size_t numBytes)
 {
     jassert (src != nullptr && ((ssize_t) numBytes) >= 0);
 
+    if (unbufferedHandle != nullptr)
+        return writeToAlignedBuffer (static_cast<const char*> (src), numBytes);
+
     if (bytesInBuffer + numBytes < bufferSize)
     {
         memcpy (buffer + bytesInBuffer, src, numBytes);
@@ -112,6 +228,7 @@ bool FileOutputStream::write (const void* const src, const size_t numBytes)
                 return false;
 
             currentPosition += bytesWritten;
+            releaseCachedData (false);
             return bytesWritten == (ssize_t) numBytes;
         }
     }
@@ -119,6 +236,33 @@ bool FileOutputStream::write (const void* const src, const size_t numBytes)
     return true;
 }
 
+bool FileOutputStream::writeBlocks (const void* const* blocks, const size_t* blockSizes, const int numBlocks)
+{
+    jassert (numBlocks == 0 || (blocks != nullptr && blockSizes != nullptr));
+
+    size_t totalBytes = 0;
+
+    for (int i = 0; i < numBlocks; ++i)
+        totalBytes += blockSizes[i];
+
+    // (small sets are cheaper to copy into the buffer, and unbuffered writes have to go
+    // through it anyway to be split into aligned blocks)
+    if (unbufferedHandle != nullptr || bytesInBuffer + totalBytes < bufferSize)
+        return OutputStream::writeBlocks (blocks, blockSizes, numBlocks);
+
+    if (! flushBuffer())
+        return false;
+
+    const ssize_t bytesWritten = writeGatheredInternal (blocks, blockSizes, numBlocks);
+
+    if (bytesWritten < 0)
+        return false;
+
+    currentPosition += bytesWritten;
+    releaseCachedData (false);
+    return bytesWritten == (ssize_t) totalBytes;
+}
+
 void FileOutputStream::writeRepeatedByte (uint8 byte, size_t numBytes)
 {
     jassert (((ssize_t) numBytes) >= 0);
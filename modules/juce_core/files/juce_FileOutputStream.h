@@ -54,10 +54,16 @@ public:
         use File::deleteFile() before opening the stream, or use setPosition(0)
         after it's opened (although this won't truncate the file).
 
+        The streamAccessFlags are a combination of values from File::StreamAccessFlags,
+        which tell the OS how the file is going to be written. If you use
+        File::unbufferedAccess, the buffer may be made bigger, so that it can be written
+        in whole blocks.
+
         @see TemporaryFile
     */
     FileOutputStream (const File& fileToWriteTo,
-                      int bufferSizeToUse = 16384);
+                      int bufferSizeToUse = 16384,
+                      int streamAccessFlags = File::defaultAccess);
 
     /** Destructor. */
     ~FileOutputStream();
@@ -89,11 +95,26 @@ public:
     */
     Result truncate();
 
+    /** Asks the file system to reserve space for the file, up to the given total size.
+
+        This doesn't change the file's length or the stream's position - it just allocates
+        the disk space in advance, so that the writes that follow are less likely to stall
+        while the file system looks for free blocks, or to leave the file badly fragmented.
+        On some platforms, any reserved space that isn't written to stays allocated
+        until the file is truncated, so you may want to call truncate() when you've
+        finished writing.
+
+        If the platform or file system can't do this, an error is returned, but the stream
+        carries on working normally.
+    */
+    Result preallocate (int64 totalNumBytes);
+
     //==============================================================================
     void flush();
     int64 getPosition();
     bool setPosition (int64 pos);
     bool write (const void* data, size_t numBytes);
+    bool writeBlocks (const void* const* blocks, const size_t* blockSizes, int numBlocks);
     void writeRepeatedByte (uint8 byte, size_t numTimesToRepeat);
 
 
@@ -101,10 +122,13 @@ private:
     //==============================================================================
     File file;
     void* fileHandle;
+    void* unbufferedHandle;
     Result status;
-    int64 currentPosition;
+    int64 currentPosition, cacheReleasePosition;
     size_t bufferSize, bytesInBuffer;
-    HeapBlock <char> buffer;
+    HeapBlock <char> bufferStorage;
+    char* buffer;
+    const int accessFlags;
 
     void openHandle();
     void closeHandle();
@@ -112,6 +136,11 @@ private:
     bool flushBuffer();
     int64 setPositionInternal (int64);
     ssize_t writeInternal (const void*, size_t);
+    ssize_t writeUnbufferedInternal (const void*, size_t, int64 filePosition);
+    ssize_t writeGatheredInternal (const void* const*, const size_t*, int);
+    bool writeToAlignedBuffer (const char*, size_t);
+    bool writeAlignedBlocks (bool writeEverything);
+    void releaseCachedData (bool force);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FileOutputStream)
 };
@@ -0,0 +1,272 @@
+/*
+  ==============================================================================
+
+   This file is part of the juce_core module of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission to use, copy, modify, and/or distribute this software for any purpose with
+   or without fee is hereby granted, provided that the above copyright notice and this
+   permission notice appear in all copies.
+
+   THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+   TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+   NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+   DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+   IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+   ------------------------------------------------------------------------------
+
+   NOTE! This permissive ISC license applies ONLY to files within the juce_core module!
+   All other JUCE modules are covered by a dual GPL/commercial license, so if you are
+   using any other modules, be sure to check that you also comply with their license.
+
+   For more details, visit www.juce.com
+
+  ==============================================================================
+*/
+
+class ParallelFileFinder::SearchTask  : public ThreadPoolTask
+{
+public:
+    SearchTask (ParallelFileFinder& f, const File& d)  : owner (f), directory (d) {}
+
+    void runTask()
+    {
+        if (owner.shouldStop.get() == 0)
+            owner.searchDirectory (directory);
+
+        if (--(owner.numDirectoriesPending) == 0)
+            owner.finished.signal();
+    }
+
+private:
+    ParallelFileFinder& owner;
+    const File directory;
+
+    JUCE_DECLARE_NON_COPYABLE (SearchTask)
+};
+
+//==============================================================================
+bool ParallelFileFinder::Listener::shouldSearchDirectory (const File&)
+{
+    return true;
+}
+
+//==============================================================================
+ParallelFileFinder::ParallelFileFinder (ThreadPool& poolToUse)
+    : pool (poolToUse),
+      listener (nullptr),
+      whatToLookFor (File::findFiles),
+      isRecursive (false),
+      finished (true)
+{
+    finished.signal();
+}
+
+ParallelFileFinder::~ParallelFileFinder()
+{
+    stopSearch();
+}
+
+void ParallelFileFinder::startSearch (const File& directory, const bool searchRecursively,
+                                      const String& wildCardPattern, const int typesToFind,
+                                      Listener* const newListener)
+{
+    // you have to specify the type of files you're looking for!
+    jassert ((typesToFind & (File::findFiles | File::findDirectories)) != 0);
+    jassert (newListener != nullptr);
+
+    stopSearch();
+
+    listener = newListener;
+    whatToLookFor = typesToFind;
+    isRecursive = searchRecursively;
+
+    wildCards.clear();
+    wildCards.addTokens (wildCardPattern, ";,", "\"'");
+    wildCards.trim();
+    wildCards.removeEmptyStrings();
+
+    numFilesFound = 0;
+    shouldStop = 0;
+
+    if (listener != nullptr && directory.isDirectory())
+    {
+        finished.reset();
+        numDirectoriesPending = 1;
+        pool.addTask (new SearchTask (*this, directory));
+    }
+}
+
+void ParallelFileFinder::stopSearch()
+{
+    shouldStop = 1;
+    finished.wait();
+}
+
+bool ParallelFileFinder::waitForSearchToFinish (const int timeOutMilliseconds) const
+{
+    return finished.wait (timeOutMilliseconds);
+}
+
+bool ParallelFileFinder::matchesWildcard (const String& filename) const
+{
+    for (int i = 0; i < wildCards.size(); ++i)
+        if (filename.matchesWildcard (wildCards[i], ! File::areFileNamesCaseSensitive()))
+            return true;
+
+    return false;
+}
+
+void ParallelFileFinder::searchDirectory (const File& directory)
+{
+    DirectoryIterator iter (directory, false, "*",
+                            File::findFilesAndDirectories | (whatToLookFor & File::ignoreHiddenFiles));
+
+    bool isDirectory;
+    int64 fileSize;
+    Time modTime;
+
+    while (shouldStop.get() == 0
+            && iter.next (&isDirectory, nullptr, &fileSize, &modTime, nullptr, nullptr))
+    {
+        const File& file = iter.getFile();
+
+        // hand any subdirectories straight back to the pool, so that idle threads can
+        // start on them while this one carries on reading..
+        if (isDirectory && isRecursive && listener->shouldSearchDirectory (file))
+        {
+            ++numDirectoriesPending;
+            pool.addTask (new SearchTask (*this, file));
+        }
+
+        if ((whatToLookFor & (isDirectory ? File::findDirectories : File::findFiles)) != 0
+             && matchesWildcard (file.getFileName()))
+        {
+            ++numFilesFound;
+            listener->fileFound (file, isDirectory, fileSize, modTime);
+        }
+    }
+}
+
+//==============================================================================
+namespace ParallelFileFinderHelpers
+{
+    struct FileCollector  : public ParallelFileFinder::Listener
+    {
+        void fileFound (const File& file, bool, int64, Time)
+        {
+            const ScopedLock sl (lock);
+            files.add (file);
+        }
+
+        static int compareElements (const File& first, const File& second)
+        {
+            return first.getFullPathName().compare (second.getFullPathName());
+        }
+
+        CriticalSection lock;
+        Array<File> files;
+    };
+}
+
+int ParallelFileFinder::findChildFiles (ThreadPool& pool, Array<File>& results, const File& directory,
+                                        const int whatToLookFor, const bool searchRecursively,
+                                        const String& wildCardPattern)
+{
+    ParallelFileFinderHelpers::FileCollector collector;
+
+    {
+        ParallelFileFinder finder (pool);
+        finder.startSearch (directory, searchRecursively, wildCardPattern, whatToLookFor, &collector);
+        finder.waitForSearchToFinish();
+    }
+
+    collector.files.sort (collector);
+    results.addArray (collector.files);
+    return collector.files.size();
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class ParallelFileFinderTests  : public UnitTest
+{
+public:
+    ParallelFileFinderTests() : UnitTest ("ParallelFileFinder") {}
+
+    void runTest()
+    {
+        const File root (File::createTempFile ("ParallelFileFinder"));
+        Random r;
+
+        beginTest ("Finds the same files as File::findChildFiles");
+
+        {
+            expect (root.createDirectory());
+
+            for (int i = 0; i < 20; ++i)
+            {
+                File dir (root.getChildFile ("dir" + String (i)));
+
+                for (int depth = r.nextInt (4); --depth >= 0;)
+                    dir = dir.getChildFile ("sub" + String (depth));
+
+                expect (dir.createDirectory());
+
+                for (int j = r.nextInt (10); --j >= 0;)
+                    expect (dir.getChildFile ("file" + String (j) + (j % 3 == 0 ? ".txt" : ".dat")).create());
+            }
+
+            ThreadPool pool (4);
+
+            for (int i = 0; i < 4; ++i)
+            {
+                const int type = (i & 1) ? File::findFiles : File::findFilesAndDirectories;
+                const String pattern ((i & 2) ? "*.txt;*.dat" : "*.txt");
+
+                Array<File> expected, found;
+                root.findChildFiles (expected, type, true, pattern);
+                expected.sort (*this);
+
+                expectEquals (ParallelFileFinder::findChildFiles (pool, found, root, type, true, pattern), expected.size());
+                expect (found == expected);
+            }
+
+            Array<File> expected, found;
+            root.findChildFiles (expected, File::findFilesAndDirectories, false);
+            expected.sort (*this);
+            ParallelFileFinder::findChildFiles (pool, found, root, File::findFilesAndDirectories, false);
+            expect (found == expected);
+        }
+
+        beginTest ("Stopping a search");
+
+        {
+            ThreadPool pool (2);
+
+            struct SlowListener  : public ParallelFileFinder::Listener
+            {
+                void fileFound (const File&, bool, int64, Time)   { Thread::sleep (5); }
+            };
+
+            SlowListener listener;
+            ParallelFileFinder finder (pool);
+            finder.startSearch (root, true, "*", File::findFilesAndDirectories, &listener);
+            finder.stopSearch();
+            expect (! finder.isSearching());
+        }
+
+        root.deleteRecursively();
+    }
+
+    static int compareElements (const File& first, const File& second)
+    {
+        return first.getFullPathName().compare (second.getFullPathName());
+    }
+};
+
+static ParallelFileFinderTests parallelFileFinderTests;
+
+#endif
@@ -0,0 +1,160 @@
+/*
+  ==============================================================================
+
+   This file is part of the juce_core module of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission to use, copy, modify, and/or distribute this software for any purpose with
+   or without fee is hereby granted, provided that the above copyright notice and this
+   permission notice appear in all copies.
+
+   THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+   TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+   NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+   DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+   IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+   ------------------------------------------------------------------------------
+
+   NOTE! This permissive ISC license applies ONLY to files within the juce_core module!
+   All other JUCE modules are covered by a dual GPL/commercial license, so if you are
+   using any other modules, be sure to check that you also comply with their license.
+
+   For more details, visit www.juce.com
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_PARALLELFILEFINDER_JUCEHEADER__
+#define __JUCE_PARALLELFILEFINDER_JUCEHEADER__
+
+#include "juce_File.h"
+#include "../threads/juce_ThreadPool.h"
+
+
+//==============================================================================
+/**
+    Searches a directory tree for files, using a ThreadPool to read several
+    subdirectories at the same time.
+
+    Each directory is read by a separate ThreadPoolTask, and each subdirectory that it
+    finds is handed back to the pool as a new task, so on a disk or network share that
+    can serve several requests at once, a big tree gets searched much faster than it
+    would be by a single recursive DirectoryIterator.
+
+    The results are passed to a Listener as they're found, on whichever pool thread
+    happened to find them, so they arrive in no particular order. If you just want an
+    array of files, the static findChildFiles() method does the whole thing for you.
+
+    @code
+    ThreadPool pool;
+    Array<File> wavFiles;
+    ParallelFileFinder::findChildFiles (pool, wavFiles, File ("/samples"),
+                                        File::findFiles, true, "*.wav;*.aif");
+    @endcode
+
+    @see DirectoryIterator, File::findChildFiles, ThreadPool
+*/
+class JUCE_API  ParallelFileFinder
+{
+public:
+    //==============================================================================
+    /** Receives the results of a ParallelFileFinder search.
+
+        The callbacks are made on the pool's threads, and several of them can be
+        running at once, so they must be thread-safe.
+    */
+    class JUCE_API  Listener
+    {
+    public:
+        /** Destructor. */
+        virtual ~Listener() {}
+
+        /** Called for each file or directory that matches the search. */
+        virtual void fileFound (const File& file, bool isDirectory,
+                                int64 fileSize, Time modificationTime) = 0;
+
+        /** Called before searching inside a subdirectory, so that whole branches of the
+            tree can be skipped. The default implementation searches them all.
+        */
+        virtual bool shouldSearchDirectory (const File& directory);
+    };
+
+    //==============================================================================
+    /** Creates a finder that will use the given pool.
+        The pool must not be deleted before this object is.
+    */
+    explicit ParallelFileFinder (ThreadPool& poolToUse);
+
+    /** Destructor.
+        If a search is still running, this stops it and waits for it to finish.
+    */
+    ~ParallelFileFinder();
+
+    //==============================================================================
+    /** Starts searching a directory, and returns immediately.
+
+        Any search that's already running is stopped first.
+
+        @param directory        the directory to search
+        @param searchRecursively    whether to search all its subdirectories too
+        @param wildCardPattern  the pattern to match the filenames against. This may contain
+                                several patterns separated by semi-colons or commas, and
+                                doesn't apply to the directories that get searched
+        @param whatToLookFor    a value from the File::TypesOfFileToFind enum
+        @param listener         the object that receives the results. It must stay valid
+                                until the search has finished
+    */
+    void startSearch (const File& directory, bool searchRecursively,
+                      const String& wildCardPattern, int whatToLookFor,
+                      Listener* listener);
+
+    /** Stops the current search, waiting for any callbacks in progress to return. */
+    void stopSearch();
+
+    /** Waits for the current search to finish.
+        @returns true if it finished, or false if the timeout expired first
+    */
+    bool waitForSearchToFinish (int timeOutMilliseconds = -1) const;
+
+    /** Returns true if a search is still running. */
+    bool isSearching() const noexcept               { return numDirectoriesPending.get() > 0; }
+
+    /** Returns the number of matching files that the current search has found so far. */
+    int getNumFilesFound() const noexcept           { return numFilesFound.get(); }
+
+    //==============================================================================
+    /** Searches a directory and adds all the matching files to an array.
+
+        This works like File::findChildFiles(), but reads the subdirectories on the
+        pool's threads. The results are sorted by their full path names. Don't call it
+        from one of the pool's own threads, as it blocks until the search has finished.
+
+        @returns the number of files that were added to the array
+    */
+    static int findChildFiles (ThreadPool& pool, Array<File>& results, const File& directory,
+                               int whatToLookFor, bool searchRecursively,
+                               const String& wildCardPattern = "*");
+
+private:
+    //==============================================================================
+    class SearchTask;
+    friend class SearchTask;
+
+    ThreadPool& pool;
+    Listener* listener;
+    StringArray wildCards;
+    int whatToLookFor;
+    bool isRecursive;
+    Atomic<int> numDirectoriesPending, numFilesFound, shouldStop;
+    WaitableEvent finished;
+
+    void searchDirectory (const File&);
+    bool matchesWildcard (const String& filename) const;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ParallelFileFinder)
+};
+
+
+#endif   // __JUCE_PARALLELFILEFINDER_JUCEHEADER__
@@ -29,147 +29,222 @@
 class JSONParser
 {
 public:
-    static Result parseObjectOrArray (String::CharPointerType t, var& result)
+    JSONParser (const char* const start, const char* const end_, JSON::ParseHandler& handler_)
+        : t (start), end (end_), handler (handler_), stopped (false)
     {
-        t = t.findEndOfWhitespace();
+    }
+
+    Result parseObjectOrArray()
+    {
+        skipWhitespace();
 
-        switch (t.getAndAdvance())
+        switch (getAndAdvance())
         {
-            case 0:      result = var::null; return Result::ok();
-            case '{':    return parseObject (t, result);
-            case '[':    return parseArray  (t, result);
+            case 0:      return Result::ok();
+            case '{':    return parseObject();
+            case '[':    return parseArray();
         }
 
-        return createFail ("Expected '{' or '['", &t);
+        return createFail ("Expected '{' or '['", t);
     }
 
 private:
-    static Result parseAny (String::CharPointerType& t, var& result)
+    const char* t;
+    const char* const end;
+    JSON::ParseHandler& handler;
+    MemoryOutputStream decodedString;
+    bool stopped;
+
+    // The input is treated as ending at either the end pointer or a null byte, whichever
+    // comes first, so that the data doesn't have to be null-terminated.
+    inline char peek() const noexcept           { return t < end ? *t : 0; }
+
+    inline char getAndAdvance() noexcept
+    {
+        const char c = peek();
+
+        if (c != 0)
+            ++t;
+
+        return c;
+    }
+
+    inline void skipWhitespace() noexcept
+    {
+        while (t < end && CharacterFunctions::isWhitespace (*t))
+            ++t;
+    }
+
+    bool skipIfMatches (const char* const text, const int numChars) noexcept
     {
-        t = t.findEndOfWhitespace();
-        String::CharPointerType t2 (t);
+        if (end - t < numChars || memcmp (t, text, (size_t) numChars) != 0)
+            return false;
 
-        switch (t2.getAndAdvance())
+        t += numChars;
+        return true;
+    }
+
+    Result stop()
+    {
+        stopped = true;
+        return Result::ok();
+    }
+
+    Result createFail (const char* const message, const char* const location = nullptr) const
+    {
+        String m (message);
+
+        if (location != nullptr)
         {
-            case '{':    t = t2; return parseObject (t, result);
-            case '[':    t = t2; return parseArray  (t, result);
-            case '"':    t = t2; return parseString (t, result);
+            // show the next 20 characters of the input..
+            const char* e = location;
+
+            for (int numChars = 0; e < end && *e != 0;)
+            {
+                if ((*e & 0xc0) != 0x80 && ++numChars > 20)
+                    break;
+
+                ++e;
+            }
+
+            m << ": \"" << String (CharPointer_UTF8 (location), CharPointer_UTF8 (e)) << '"';
+        }
+
+        return Result::fail (m);
+    }
+
+    Result parseAny()
+    {
+        skipWhitespace();
+        const char* const start = t;
+
+        switch (getAndAdvance())
+        {
+            case '{':    return parseObject();
+            case '[':    return parseArray();
+
+            case '"':
+            {
+                JSON::StringView text (t, t);
+                Result r (parseString (text));
+
+                if (r.failed())
+                    return r;
+
+                return handler.stringValue (text) ? Result::ok() : stop();
+            }
 
             case '-':
-                t2 = t2.findEndOfWhitespace();
-                if (! CharacterFunctions::isDigit (*t2))
+                skipWhitespace();
+                if (! CharacterFunctions::isDigit (peek()))
                     break;
 
-                t = t2;
-                return parseNumber (t, result, true);
+                return parseNumber (true);
 
             case '0': case '1': case '2': case '3': case '4':
             case '5': case '6': case '7': case '8': case '9':
-                return parseNumber (t, result, false);
+                t = start;
+                return parseNumber (false);
 
-            case 't':   // "true"
-                if (t2.getAndAdvance() == 'r' && t2.getAndAdvance() == 'u' && t2.getAndAdvance() == 'e')
-                {
-                    t = t2;
-                    result = var (true);
-                    return Result::ok();
-                }
+            case 't':
+                if (skipIfMatches ("rue", 3))
+                    return handler.boolValue (true) ? Result::ok() : stop();
                 break;
 
-            case 'f':   // "false"
-                if (t2.getAndAdvance() == 'a' && t2.getAndAdvance() == 'l'
-                      && t2.getAndAdvance() == 's' && t2.getAndAdvance() == 'e')
-                {
-                    t = t2;
-                    result = var (false);
-                    return Result::ok();
-                }
+            case 'f':
+                if (skipIfMatches ("alse", 4))
+                    return handler.boolValue (false) ? Result::ok() : stop();
                 break;
 
-            case 'n':   // "null"
-                if (t2.getAndAdvance() == 'u' && t2.getAndAdvance() == 'l' && t2.getAndAdvance() == 'l')
-                {
-                    t = t2;
-                    result = var::null;
-                    return Result::ok();
-                }
+            case 'n':
+                if (skipIfMatches ("ull", 3))
+                    return handler.nullValue() ? Result::ok() : stop();
                 break;
 
             default:
                 break;
         }
 
-        return createFail ("Syntax error", &t);
+        return createFail ("Syntax error", start);
     }
 
-    static Result createFail (const char* const message, const String::CharPointerType* location = nullptr)
+    Result parseNumber (const bool isNegative)
     {
-        String m (message);
-        if (location != nullptr)
-            m << ": \"" << String (*location, 20) << '"';
-
-        return Result::fail (m);
-    }
+        const char* const numberStart = t;
 
-    static Result parseNumber (String::CharPointerType& t, var& result, const bool isNegative)
-    {
-        String::CharPointerType oldT (t);
-
-        int64 intValue = t.getAndAdvance() - '0';
+        int64 intValue = getAndAdvance() - '0';
         jassert (intValue >= 0 && intValue < 10);
 
         for (;;)
         {
-            String::CharPointerType previousChar (t);
-            const juce_wchar c = t.getAndAdvance();
+            const char c = peek();
             const int digit = ((int) c) - '0';
 
             if (isPositiveAndBelow (digit, 10))
             {
                 intValue = intValue * 10 + digit;
+                ++t;
                 continue;
             }
 
             if (c == 'e' || c == 'E' || c == '.')
             {
-                t = oldT;
-                const double asDouble = CharacterFunctions::readDoubleValue (t);
-                result = isNegative ? -asDouble : asDouble;
-                return Result::ok();
+                t = numberStart;
+                const double asDouble = readDoubleValue();
+                return handler.doubleValue (isNegative ? -asDouble : asDouble) ? Result::ok() : stop();
             }
 
             if (CharacterFunctions::isWhitespace (c)
                  || c == ',' || c == '}' || c == ']' || c == 0)
-            {
-                t = previousChar;
                 break;
-            }
 
-            return createFail ("Syntax error in number", &oldT);
+            return createFail ("Syntax error in number", numberStart);
         }
 
-        const int64 correctedValue = isNegative ? -intValue : intValue;
+        return handler.integerValue (isNegative ? -intValue : intValue) ? Result::ok() : stop();
+    }
 
-        if ((intValue >> 31) != 0)
-            result = correctedValue;
-        else
-            result = (int) correctedValue;
+    double readDoubleValue()
+    {
+        // CharacterFunctions::readDoubleValue() needs a null-terminated string, so the
+        // number is copied into a local buffer first..
+        const char* e = t;
 
-        return Result::ok();
+        while (e < end && (CharacterFunctions::isDigit (*e) || *e == '.' || *e == 'e'
+                             || *e == 'E' || *e == '+' || *e == '-'))
+            ++e;
+
+        const size_t numBytes = (size_t) (e - t);
+        char localBuffer [64];
+        HeapBlock<char> heapBuffer;
+        char* buffer = localBuffer;
+
+        if (numBytes >= sizeof (localBuffer))
+        {
+            heapBuffer.malloc (numBytes + 1);
+            buffer = heapBuffer;
+        }
+
+        memcpy (buffer, t, numBytes);
+        buffer [numBytes] = 0;
+
+        CharPointer_ASCII text (buffer);
+        const double value = CharacterFunctions::readDoubleValue (text);
+        t += text.getAddress() - buffer;
+        return value;
     }
 
-    static Result parseObject (String::CharPointerType& t, var& result)
+    Result parseObject()
     {
-        DynamicObject* const resultObject = new DynamicObject();
-        result = resultObject;
-        NamedValueSet& resultProperties = resultObject->getProperties();
+        if (! handler.objectStarted())
+            return stop();
 
         for (;;)
         {
-            t = t.findEndOfWhitespace();
+            skipWhitespace();
 
-            String::CharPointerType oldT (t);
-            const juce_wchar c = t.getAndAdvance();
+            const char* oldT = t;
+            const char c = getAndAdvance();
 
             if (c == '}')
                 break;
@@ -179,35 +254,32 @@ private:
 
             if (c == '"')
             {
-                var propertyNameVar;
-                Result r (parseString (t, propertyNameVar));
+                JSON::StringView propertyName (t, t);
+                Result r (parseString (propertyName));
 
                 if (r.failed())
                     return r;
 
-                const String propertyName (propertyNameVar.toString());
-
-                if (propertyName.isNotEmpty())
+                if (! propertyName.isEmpty())
                 {
-                    t = t.findEndOfWhitespace();
+                    skipWhitespace();
                     oldT = t;
 
-                    const juce_wchar c2 = t.getAndAdvance();
-                    if (c2 != ':')
-                        return createFail ("Expected ':', but found", &oldT);
+                    if (getAndAdvance() != ':')
+                        return createFail ("Expected ':', but found", oldT);
 
-                    resultProperties.set (propertyName, var::null);
-                    var* propertyValue = resultProperties.getVarPointer (propertyName);
+                    if (! handler.propertyName (propertyName))
+                        return stop();
 
-                    Result r2 (parseAny (t, *propertyValue));
+                    Result r2 (parseAny());
 
-                    if (r2.failed())
+                    if (r2.failed() || stopped)
                         return r2;
 
-                    t = t.findEndOfWhitespace();
+                    skipWhitespace();
                     oldT = t;
 
-                    const juce_wchar nextChar = t.getAndAdvance();
+                    const char nextChar = getAndAdvance();
 
                     if (nextChar == ',')
                         continue;
@@ -217,41 +289,41 @@ private:
                 }
             }
 
-            return createFail ("Expected object member declaration, but found", &oldT);
+            return createFail ("Expected object member declaration, but found", oldT);
         }
 
-        return Result::ok();
+        return handler.objectEnded() ? Result::ok() : stop();
     }
 
-    static Result parseArray (String::CharPointerType& t, var& result)
+    Result parseArray()
     {
-        result = var (Array<var>());
-        Array<var>* const destArray = result.getArray();
+        if (! handler.arrayStarted())
+            return stop();
 
         for (;;)
         {
-            t = t.findEndOfWhitespace();
+            skipWhitespace();
 
-            String::CharPointerType oldT (t);
-            const juce_wchar c = t.getAndAdvance();
+            const char c = peek();
 
             if (c == ']')
+            {
+                ++t;
                 break;
+            }
 
             if (c == 0)
                 return createFail ("Unexpected end-of-input in array declaration");
 
-            t = oldT;
-            destArray->add (var::null);
-            Result r (parseAny (t, destArray->getReference (destArray->size() - 1)));
+            Result r (parseAny());
 
-            if (r.failed())
+            if (r.failed() || stopped)
                 return r;
 
-            t = t.findEndOfWhitespace();
-            oldT = t;
+            skipWhitespace();
+            const char* const oldT = t;
 
-            const juce_wchar nextChar = t.getAndAdvance();
+            const char nextChar = getAndAdvance();
 
             if (nextChar == ',')
                 continue;
@@ -259,33 +331,48 @@ private:
             if (nextChar == ']')
                 break;
 
-            return createFail ("Expected object array item, but found", &oldT);
+            return createFail ("Expected object array item, but found", oldT);
         }
 
-        return Result::ok();
+        return handler.arrayEnded() ? Result::ok() : stop();
+    }
+
+    static const char* findEndOfPlainText (const char* p, const char* const e) noexcept
+    {
+        while (p < e && *p != '"' && *p != '\\' && *p != 0)
+            ++p;
+
+        return p;
     }
 
-    static Result parseString (String::CharPointerType& t, var& result)
+    Result parseString (JSON::StringView& result)
     {
-        MemoryOutputStream buffer (256);
+        const char* const start = t;
+        t = findEndOfPlainText (t, end);
+
+        if (peek() == '"')
+        {
+            // no escape sequences, so the text can be used in-place..
+            result = JSON::StringView (start, t++);
+            return Result::ok();
+        }
+
+        decodedString.reset();
+        decodedString.write (start, (size_t) (t - start));
 
         for (;;)
         {
-            juce_wchar c = t.getAndAdvance();
+            juce_wchar c = (juce_wchar) (uint8) getAndAdvance();
 
             if (c == '"')
                 break;
 
             if (c == '\\')
             {
-                c = t.getAndAdvance();
+                c = (juce_wchar) (uint8) getAndAdvance();
 
                 switch (c)
                 {
-                    case '"':
-                    case '\\':
-                    case '/':  break;
-
                     case 'b':  c = '\b'; break;
                     case 'f':  c = '\f'; break;
                     case 'n':  c = '\n'; break;
@@ -294,31 +381,201 @@ private:
 
                     case 'u':
                     {
-                        c = 0;
+                        c = readHexCharacter();
 
-                        for (int i = 4; --i >= 0;)
-                        {
-                            const int digitValue = CharacterFunctions::getHexDigitValue (t.getAndAdvance());
-                            if (digitValue < 0)
-                                return createFail ("Syntax error in unicode escape sequence");
+                        if (c == (juce_wchar) -1)
+                            return createFail ("Syntax error in unicode escape sequence");
 
-                            c = (juce_wchar) ((c << 4) + digitValue);
+                        if (c >= 0xd800 && c < 0xdc00 && end - t >= 6 && t[0] == '\\' && t[1] == 'u')
+                        {
+                            // try to join up a UTF-16 surrogate pair..
+                            const char* const oldT = t;
+                            t += 2;
+                            const juce_wchar c2 = readHexCharacter();
+
+                            if (c2 >= 0xdc00 && c2 < 0xe000)
+                                c = (juce_wchar) (0x10000 + ((c - 0xd800) << 10) + (c2 - 0xdc00));
+                            else
+                                t = oldT;
                         }
 
                         break;
                     }
+
+                    default:
+                        if (c >= 0x80)
+                        {
+                            // (a multi-byte character has been escaped - the rest of it
+                            // will get copied along with the text that follows)
+                            decodedString.writeByte ((char) c);
+                            continue;
+                        }
+
+                        break;
                 }
-            }
 
-            if (c == 0)
-                return createFail ("Unexpected end-of-input in string constant");
+                if (c == 0)
+                    return createFail ("Unexpected end-of-input in string constant");
+
+                decodedString.appendUTF8Char (c);
+            }
+            else
+            {
+                if (c == 0)
+                    return createFail ("Unexpected end-of-input in string constant");
 
-            buffer.appendUTF8Char (c);
+                const char* const runStart = t - 1;
+                t = findEndOfPlainText (t, end);
+                decodedString.write (runStart, (size_t) (t - runStart));
+            }
         }
 
-        result = buffer.toString();
+        const char* const decoded = static_cast <const char*> (decodedString.getData());
+        result = JSON::StringView (decoded, decoded + decodedString.getDataSize());
         return Result::ok();
     }
+
+    juce_wchar readHexCharacter() noexcept
+    {
+        juce_wchar c = 0;
+
+        for (int i = 4; --i >= 0;)
+        {
+            const int digitValue = CharacterFunctions::getHexDigitValue ((juce_wchar) (uint8) getAndAdvance());
+
+            if (digitValue < 0)
+                return (juce_wchar) -1;
+
+            c = (juce_wchar) ((c << 4) + digitValue);
+        }
+
+        return c;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (JSONParser)
+};
+
+//==============================================================================
+class JSONVarBuilder  : public JSON::ParseHandler
+{
+public:
+    JSONVarBuilder (var& result_)  : result (result_)
+    {
+        result = var::null;
+    }
+
+    bool objectStarted()
+    {
+        var newObject (new DynamicObject());
+        var& v = addValue (newObject);
+        stack.add (Level (&v));
+        return true;
+    }
+
+    bool arrayStarted()
+    {
+        var newArray ((Array<var>()));
+        var& v = addValue (newArray);
+        stack.add (Level (&v));
+        return true;
+    }
+
+    bool objectEnded()                                  { stack.removeLast(); return true; }
+    bool arrayEnded()                                   { stack.removeLast(); return true; }
+
+    bool propertyName (const JSON::StringView& name)
+    {
+        stack.getReference (stack.size() - 1).propertyName = getIdentifier (name);
+        return true;
+    }
+
+    bool stringValue (const JSON::StringView& text)     { var v (text.toString()); addValue (v); return true; }
+    bool doubleValue (double value)                     { var v (value); addValue (v); return true; }
+    bool boolValue (bool value)                         { var v (value); addValue (v); return true; }
+    bool nullValue()                                    { var v; addValue (v); return true; }
+
+    bool integerValue (int64 value)
+    {
+        var v;
+
+        if (((value < 0 ? -value : value) >> 31) != 0)
+            v = value;
+        else
+            v = (int) value;
+
+        addValue (v);
+        return true;
+    }
+
+private:
+    struct Level
+    {
+        Level() noexcept : container (nullptr) {}
+        Level (var* container_) noexcept : container (container_) {}
+
+        var* container;
+        Identifier propertyName;
+    };
+
+    var& result;
+    Array<Level> stack;
+
+    // Property names tend to be repeated many times throughout a document, so this
+    // caches the Identifiers for them, to avoid looking each one up in the string pool.
+    enum { identifierCacheSize = 256 };
+    Identifier identifierCache [identifierCacheSize];
+
+    // Takes the value passed in (leaving it void) and stores it in the current
+    // container, returning a reference to where it ended up.
+    var& addValue (var& newValue)
+    {
+        if (stack.size() == 0)
+        {
+            result.swapWith (newValue);
+            return result;
+        }
+
+        const Level& level = stack.getReference (stack.size() - 1);
+
+        if (Array<var>* const array = level.container->getArray())
+        {
+            array->add (var::null);
+            var& dest = array->getReference (array->size() - 1);
+            dest.swapWith (newValue);
+            return dest;
+        }
+
+        NamedValueSet& properties = level.container->getDynamicObject()->getProperties();
+        properties.set (level.propertyName, var::null);
+        var& dest = *properties.getVarPointer (level.propertyName);
+        dest.swapWith (newValue);
+        return dest;
+    }
+
+    Identifier getIdentifier (const JSON::StringView& name)
+    {
+        const char* const text = name.getStart();
+        const size_t numBytes = name.getNumBytes();
+        uint32 hash = (uint32) numBytes;
+
+        for (size_t i = 0; i < numBytes; ++i)
+            hash = hash * 31 + (uint32) (uint8) text[i];
+
+        Identifier& cached = identifierCache [hash & (identifierCacheSize - 1)];
+
+        if (cached.isValid())
+        {
+            const char* const cachedText = cached.getCharPointer().getAddress();
+
+            if (memcmp (cachedText, text, numBytes) == 0 && cachedText [numBytes] == 0)
+                return cached;
+        }
+
+        cached = Identifier (name.toString());
+        return cached;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (JSONVarBuilder)
 };
 
 //==============================================================================
@@ -460,23 +717,16 @@ private:
         if (! allOnOneLine)
             out << newLine;
 
-        LinkedListPointer<NamedValueSet::NamedValue>* i = &(props.values);
-
-        for (;;)
+        for (int i = 0; i < props.size(); ++i)
         {
-            NamedValueSet::NamedValue* const v = i->get();
-
-            if (v == nullptr)
-                break;
-
             if (! allOnOneLine)
                 writeSpaces (out, indentLevel + indentSize);
 
-            writeString (out, v->name);
+            writeString (out, props.getName (i));
             out << ": ";
-            write (out, v->value, indentLevel + indentSize, allOnOneLine);
+            write (out, props.getValueAt (i), indentLevel + indentSize, allOnOneLine);
 
-            if (v->nextListItem.get() != nullptr)
+            if (i < props.size() - 1)
             {
                 if (allOnOneLine)
                     out << ", ";
@@ -485,8 +735,6 @@ private:
             }
             else if (! allOnOneLine)
                 out << newLine;
-
-            i = &(v->nextListItem);
         }
 
         if (! allOnOneLine)
@@ -496,12 +744,27 @@ private:
     }
 };
 
+//==============================================================================
+bool JSON::StringView::operator== (const char* other) const noexcept
+{
+    for (const char* p = start; p < end; ++p, ++other)
+        if (*p != *other || *other == 0)
+            return false;
+
+    return *other == 0;
+}
+
+bool JSON::StringView::operator!= (const char* other) const noexcept
+{
+    return ! operator== (other);
+}
+
 //==============================================================================
 var JSON::parse (const String& text)
 {
     var result;
 
-    if (! JSONParser::parseObjectOrArray (text.getCharPointer(), result))
+    if (! parse (text, result))
         result = var::null;
 
     return result;
@@ -514,19 +777,69 @@ var JSON::parse (InputStream& input)
 
 var JSON::parse (const File& file)
 {
-    return parse (file.loadFileAsString());
+    var result;
+
+    if (! parse (file, result))
+        result = var::null;
+
+    return result;
 }
 
 Result JSON::parse (const String& text, var& result)
 {
-    return JSONParser::parseObjectOrArray (text.getCharPointer(), result);
+    JSONVarBuilder builder (result);
+    return parse (text, builder);
+}
+
+Result JSON::parse (const File& file, var& result)
+{
+    JSONVarBuilder builder (result);
+    return parse (file, builder);
+}
+
+Result JSON::parse (const String& text, ParseHandler& handler)
+{
+    const char* const utf8 = text.toRawUTF8();
+    return JSONParser (utf8, utf8 + text.getNumBytesAsUTF8(), handler).parseObjectOrArray();
+}
+
+Result JSON::parse (const void* const utf8Data, const size_t numBytes, ParseHandler& handler)
+{
+    const char* start = static_cast <const char*> (utf8Data);
+    const char* const end = start + numBytes;
+
+    if (numBytes >= 3
+          && start[0] == (char) CharPointer_UTF8::byteOrderMark1
+          && start[1] == (char) CharPointer_UTF8::byteOrderMark2
+          && start[2] == (char) CharPointer_UTF8::byteOrderMark3)
+        start += 3;
+
+    return JSONParser (start, end, handler).parseObjectOrArray();
+}
+
+Result JSON::parse (const File& file, ParseHandler& handler)
+{
+    if (! file.existsAsFile())
+        return Result::fail ("Couldn't open " + file.getFullPathName());
+
+    const MemoryMappedFile mappedFile (file, MemoryMappedFile::readOnly);
+    const uint8* const data = static_cast <const uint8*> (mappedFile.getData());
+
+    // if the file can't be mapped (or it's empty, or in UTF-16), fall back to loading it as a string.
+    if (data == nullptr
+         || (mappedFile.getSize() >= 2
+              && ((data[0] == (uint8) CharPointer_UTF16::byteOrderMarkBE1 && data[1] == (uint8) CharPointer_UTF16::byteOrderMarkBE2)
+                   || (data[0] == (uint8) CharPointer_UTF16::byteOrderMarkLE1 && data[1] == (uint8) CharPointer_UTF16::byteOrderMarkLE2))))
+        return parse (file.loadFileAsString(), handler);
+
+    return parse (data, mappedFile.getSize(), handler);
 }
 
 String JSON::toString (const var& data, const bool allOnOneLine)
 {
-    MemoryOutputStream mo (1024);
-    JSONFormatter::write (mo, data, 0, allOnOneLine);
-    return mo.toString();
+    StringBuilder sb;
+    JSONFormatter::write (sb, data, 0, allOnOneLine);
+    return sb.toString();
 }
 
 void JSON::writeToStream (OutputStream& output, const var& data, const bool allOnOneLine)
@@ -628,6 +941,26 @@ public:
         expect (JSON::parse ("[ -1234]")[0].isInt());
         expect (JSON::parse ("[-12345678901234]")[0].isInt64());
         expect (JSON::parse ("[-1.123e3]")[0].isDouble());
+        expect (JSON::parse ("[\"a\\u00e9\\n\"]")[0].toString() == CharPointer_UTF8 ("a\xc3\xa9\n"));
+        expect (JSON::parse ("[\"\\ud83d\\ude00\"]")[0].toString().length() == 1);
+        expect (JSON::parse ("{ \"a\": 1, \"b\": [ 2, ] }")["b"][0].isInt());
+        expect (JSON::parse ("[ 1, 2").isVoid());
+
+        {
+            struct Counter  : public JSON::ParseHandler
+            {
+                Counter() : numValues (0), numNamesMatched (0) {}
+
+                bool integerValue (int64)                           { return ++numValues < 3; }
+                bool propertyName (const JSON::StringView& name)    { numNamesMatched += (name == "xyz" ? 1 : 0); return true; }
+
+                int numValues, numNamesMatched;
+            };
+
+            Counter counter;
+            expect (JSON::parse ("[ { \"xyz\": 1, \"xy\": 2, \"xyz\": 3, \"xyz\": 4 } ]", counter).wasOk());
+            expect (counter.numValues == 3 && counter.numNamesMatched == 2);
+        }
 
         for (int i = 100; --i >= 0;)
         {
@@ -91,6 +91,158 @@ public:
     */
     static var parse (InputStream& input);
 
+    /** Parses a JSON-formatted file, and returns a result code containing any parse errors.
+
+        Unlike parse (const File&), this doesn't read the whole file into a String first:
+        the file is memory-mapped and parsed in-place, which is much quicker and lighter on
+        memory for large files.
+
+        If you need to build a big structure quickly, you can also do this inside a
+        MemoryArena::ScopedUse, in which case all the objects and arrays that are created
+        will be allocated from the arena.
+    */
+    static Result parse (const File& file, var& parsedResult);
+
+    //==============================================================================
+    /**
+        A reference to a run of UTF-8 text in a JSON document that is being parsed.
+
+        Wherever possible, this points straight into the source data, so no copy of the
+        text is made. Strings containing escape sequences have to be decoded, so they
+        point into a temporary buffer instead. Either way, a StringView is only valid
+        during the ParseHandler callback that it's passed to.
+
+        @see JSON::ParseHandler
+    */
+    class JUCE_API  StringView
+    {
+    public:
+        /** Creates a view of the UTF-8 text between two pointers. */
+        StringView (const char* start_, const char* end_) noexcept  : start (start_), end (end_) {}
+
+        /** Returns a pointer to the first byte of the text. Note that this isn't null-terminated. */
+        const char* getStart() const noexcept       { return start; }
+
+        /** Returns a pointer to the byte after the end of the text. */
+        const char* getEnd() const noexcept         { return end; }
+
+        /** Returns the number of bytes in the text. */
+        size_t getNumBytes() const noexcept         { return (size_t) (end - start); }
+
+        /** Returns true if the text is empty. */
+        bool isEmpty() const noexcept               { return start == end; }
+
+        /** Creates a String containing a copy of the text. */
+        String toString() const                     { return String (CharPointer_UTF8 (start), CharPointer_UTF8 (end)); }
+
+        /** Compares the text with a null-terminated UTF-8 string. */
+        bool operator== (const char* other) const noexcept;
+
+        /** Compares the text with a null-terminated UTF-8 string. */
+        bool operator!= (const char* other) const noexcept;
+
+    private:
+        const char* start;
+        const char* end;
+    };
+
+    //==============================================================================
+    /**
+        Receives a stream of callbacks as a JSON document is parsed.
+
+        This lets you pick out the parts of a document that you're interested in without
+        building a var for the whole thing. Each callback returns true to carry on, or
+        false to stop parsing - in which case the parse method will return a successful
+        result straight away.
+
+        The default implementations just ignore the event, so you only need to override
+        the ones you need.
+
+        @code
+        struct PresetNameFinder  : public JSON::ParseHandler
+        {
+            PresetNameFinder() : depth (0), nextIsName (false) {}
+
+            bool objectStarted()                                { ++depth; return true; }
+            bool objectEnded()                                  { --depth; return true; }
+            bool propertyName (const JSON::StringView& name)    { nextIsName = (depth == 2 && name == "name"); return true; }
+
+            bool stringValue (const JSON::StringView& text)
+            {
+                if (nextIsName)
+                    names.add (text.toString());
+
+                return true;
+            }
+
+            StringArray names;
+            int depth;
+            bool nextIsName;
+        };
+        @endcode
+
+        @see JSON::parse
+    */
+    class JUCE_API  ParseHandler
+    {
+    public:
+        /** Destructor. */
+        virtual ~ParseHandler() {}
+
+        /** Called at the start of an object, i.e. at its opening brace. */
+        virtual bool objectStarted()                            { return true; }
+
+        /** Called at the end of an object, after all its properties. */
+        virtual bool objectEnded()                              { return true; }
+
+        /** Called at the start of an array. */
+        virtual bool arrayStarted()                             { return true; }
+
+        /** Called at the end of an array, after all its elements. */
+        virtual bool arrayEnded()                               { return true; }
+
+        /** Called with the name of an object property. The next value to arrive
+            (or object or array to start) will be that property's value.
+        */
+        virtual bool propertyName (const StringView& /*name*/)  { return true; }
+
+        /** Called for a string value. */
+        virtual bool stringValue (const StringView& /*text*/)   { return true; }
+
+        /** Called for a number that has no fractional part or exponent. */
+        virtual bool integerValue (int64 /*value*/)             { return true; }
+
+        /** Called for a number with a fractional part or exponent. */
+        virtual bool doubleValue (double /*value*/)             { return true; }
+
+        /** Called for 'true' or 'false'. */
+        virtual bool boolValue (bool /*value*/)                 { return true; }
+
+        /** Called for 'null'. */
+        virtual bool nullValue()                                { return true; }
+    };
+
+    /** Parses some JSON-formatted text, passing each item to a ParseHandler rather than
+        building a var.
+        @returns    a Result which will contain an error message if the text couldn't be parsed
+    */
+    static Result parse (const String& text, ParseHandler& handler);
+
+    /** Parses a block of UTF-8 JSON-formatted text, passing each item to a ParseHandler rather
+        than building a var.
+        The data doesn't need to be null-terminated, and any UTF-8 byte-order mark is skipped.
+        @returns    a Result which will contain an error message if the text couldn't be parsed
+    */
+    static Result parse (const void* utf8Data, size_t numBytes, ParseHandler& handler);
+
+    /** Parses a JSON-formatted file, passing each item to a ParseHandler rather than
+        building a var.
+        The file is memory-mapped rather than being loaded, so even very large files can be
+        scanned quickly.
+        @returns    a Result which will contain an error message if the file couldn't be read or parsed
+    */
+    static Result parse (const File& file, ParseHandler& handler);
+
     //==============================================================================
     /** Returns a string which contains a JSON-formatted representation of the var object.
         If allOnOneLine is true, the result will be compacted into a single line of text
@@ -56,6 +56,10 @@
  #include <winsock2.h>
  #include <ws2tcpip.h>
 
+ #if JUCE_MSVC
+  #include <intrin.h>
+ #endif
+
  #if ! JUCE_MINGW
   #include <Dbghelp.h>
 
@@ -75,6 +79,8 @@
   #include <sys/errno.h>
   #include <unistd.h>
   #include <netinet/in.h>
+  #include <sys/syscall.h>
+  #include <linux/futex.h>
  #endif
 
  #if JUCE_LINUX
@@ -89,6 +95,7 @@
  #include <sys/time.h>
  #include <net/if.h>
  #include <sys/ioctl.h>
+ #include <sys/uio.h>
 
  #if ! JUCE_ANDROID
   #include <execinfo.h>
@@ -116,30 +123,41 @@ namespace juce
 #include "containers/juce_Variant.cpp"
 #include "files/juce_DirectoryIterator.cpp"
 #include "files/juce_File.cpp"
+#include "files/juce_FileCopier.cpp"
 #include "files/juce_FileInputStream.cpp"
 #include "files/juce_FileOutputStream.cpp"
 #include "files/juce_FileSearchPath.cpp"
+#include "files/juce_ParallelFileFinder.cpp"
 #include "files/juce_TemporaryFile.cpp"
 #include "json/juce_JSON.cpp"
+#include "logging/juce_AsyncFileLogger.cpp"
 #include "logging/juce_FileLogger.cpp"
 #include "logging/juce_Logger.cpp"
 #include "maths/juce_BigInteger.cpp"
+#include "maths/juce_CompiledExpression.cpp"
 #include "maths/juce_Expression.cpp"
+#include "maths/juce_FastRandom.cpp"
 #include "maths/juce_Random.cpp"
+#include "memory/juce_MemoryArena.cpp"
 #include "memory/juce_MemoryBlock.cpp"
+#include "memory/juce_SharedResourceRegistry.cpp"
 #include "misc/juce_Result.cpp"
 #include "misc/juce_Uuid.cpp"
+#include "misc/juce_XXHash64.cpp"
 #include "network/juce_MACAddress.cpp"
 #include "network/juce_NamedPipe.cpp"
 #include "network/juce_Socket.cpp"
 #include "network/juce_URL.cpp"
+#include "network/juce_HTTPClient.cpp"
 #include "network/juce_IPAddress.cpp"
+#include "streams/juce_AsyncStreamReader.cpp"
 #include "streams/juce_BufferedInputStream.cpp"
 #include "streams/juce_FileInputSource.cpp"
 #include "streams/juce_InputStream.cpp"
 #include "streams/juce_MemoryInputStream.cpp"
 #include "streams/juce_MemoryOutputStream.cpp"
 #include "streams/juce_OutputStream.cpp"
+#include "streams/juce_SegmentedMemoryOutputStream.cpp"
 #include "streams/juce_SubregionStream.cpp"
 #include "system/juce_SystemStats.cpp"
 #include "text/juce_CharacterFunctions.cpp"
@@ -147,17 +165,22 @@ namespace juce
 #include "text/juce_LocalisedStrings.cpp"
 #include "text/juce_String.cpp"
 #include "text/juce_StringArray.cpp"
+#include "text/juce_StringBuilder.cpp"
 #include "text/juce_StringPairArray.cpp"
 #include "text/juce_StringPool.cpp"
 #include "text/juce_TextDiff.cpp"
 #include "threads/juce_ChildProcess.cpp"
 #include "threads/juce_ReadWriteLock.cpp"
+#include "threads/juce_ScalableReadWriteLock.cpp"
 #include "threads/juce_Thread.cpp"
 #include "threads/juce_ThreadPool.cpp"
+#include "threads/juce_TimeSlicePool.cpp"
 #include "threads/juce_TimeSliceThread.cpp"
 #include "time/juce_PerformanceCounter.cpp"
 #include "time/juce_RelativeTime.cpp"
 #include "time/juce_Time.cpp"
+#include "time/juce_TraceLog.cpp"
+#include "unit_tests/juce_Benchmark.cpp"
 #include "unit_tests/juce_UnitTest.cpp"
 #include "xml/juce_XmlDocument.cpp"
 #include "xml/juce_XmlElement.cpp"
@@ -177,6 +200,7 @@ namespace juce
 #if ! JUCE_WINDOWS
 #include "native/juce_posix_SharedCode.h"
 #include "native/juce_posix_NamedPipe.cpp"
+#include "native/juce_posix_SharedMemoryChannel.cpp"
 #endif
 
 //==============================================================================
@@ -213,6 +237,31 @@ namespace juce
 
 #endif
 
+#include "threads/juce_AdaptiveCriticalSection.cpp"
+#include "threads/juce_AsyncChildProcess.cpp"
 #include "threads/juce_HighResolutionTimer.cpp"
+#include "threads/juce_LightweightEvent.cpp"
+#include "network/juce_SharedMemoryChannel.cpp"
 
 }
+
+//==============================================================================
+#if JUCE_BENCHMARK_COUNT_ALLOCATIONS
+void* operator new (size_t size)
+{
+    juce::juce_countBenchmarkAllocation();
+
+    if (void* const p = std::malloc (size > 0 ? size : 1))
+        return p;
+
+    throw std::bad_alloc();
+}
+
+void* operator new[] (size_t size)
+{
+    return operator new (size);
+}
+
+void operator delete (void* p) noexcept     { std::free (p); }
+void operator delete[] (void* p) noexcept   { std::free (p); }
+#endif
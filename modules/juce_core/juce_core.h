@@ -91,6 +91,33 @@
  #define JUCE_CHECK_MEMORY_LEAKS 1
 #endif
 
+//=============================================================================
+/** Config: JUCE_ENABLE_TRACING
+
+    Enables the JUCE_TRACE_SCOPE macros, and the trace points that are built into classes such
+    as MessageManager, ThreadPool, TimeSliceThread and AudioProcessorGraph, as well as the image
+    decoding, SVG parsing, typeface loading and window startup and painting that are measured by
+    the GUI modules. When it's disabled, the macros compile to nothing.
+
+    @see TraceLog
+*/
+#ifndef JUCE_ENABLE_TRACING
+ #define JUCE_ENABLE_TRACING 0
+#endif
+
+//=============================================================================
+/** Config: JUCE_BENCHMARK_COUNT_ALLOCATIONS
+
+    If enabled, the Benchmark class will count the number of memory allocations made by the
+    code that it measures. This replaces the global operator new and delete, and adds a
+    counter to HeapBlock's allocations, so should only be turned on in benchmarking builds.
+
+    @see Benchmark
+*/
+#ifndef JUCE_BENCHMARK_COUNT_ALLOCATIONS
+ #define JUCE_BENCHMARK_COUNT_ALLOCATIONS 0
+#endif
+
 //=============================================================================
 /** Config: JUCE_DONT_AUTOLINK_TO_WIN32_LIBRARIES
 
@@ -152,18 +179,27 @@ namespace juce
 #ifndef __JUCE_ARRAYALLOCATIONBASE_JUCEHEADER__
  #include "containers/juce_ArrayAllocationBase.h"
 #endif
+#ifndef __JUCE_CONCURRENTQUEUE_JUCEHEADER__
+ #include "containers/juce_ConcurrentQueue.h"
+#endif
 #ifndef __JUCE_DYNAMICOBJECT_JUCEHEADER__
  #include "containers/juce_DynamicObject.h"
 #endif
 #ifndef __JUCE_ELEMENTCOMPARATOR_JUCEHEADER__
  #include "containers/juce_ElementComparator.h"
 #endif
+#ifndef __JUCE_FLATHASHMAP_JUCEHEADER__
+ #include "containers/juce_FlatHashMap.h"
+#endif
 #ifndef __JUCE_HASHMAP_JUCEHEADER__
  #include "containers/juce_HashMap.h"
 #endif
 #ifndef __JUCE_LINKEDLISTPOINTER_JUCEHEADER__
  #include "containers/juce_LinkedListPointer.h"
 #endif
+#ifndef __JUCE_LOCKFREEQUEUE_JUCEHEADER__
+ #include "containers/juce_LockFreeQueue.h"
+#endif
 #ifndef __JUCE_NAMEDVALUESET_JUCEHEADER__
  #include "containers/juce_NamedValueSet.h"
 #endif
@@ -194,6 +230,9 @@ namespace juce
 #ifndef __JUCE_FILE_JUCEHEADER__
  #include "files/juce_File.h"
 #endif
+#ifndef __JUCE_FILECOPIER_JUCEHEADER__
+ #include "files/juce_FileCopier.h"
+#endif
 #ifndef __JUCE_FILEINPUTSTREAM_JUCEHEADER__
  #include "files/juce_FileInputStream.h"
 #endif
@@ -206,12 +245,18 @@ namespace juce
 #ifndef __JUCE_MEMORYMAPPEDFILE_JUCEHEADER__
  #include "files/juce_MemoryMappedFile.h"
 #endif
+#ifndef __JUCE_PARALLELFILEFINDER_JUCEHEADER__
+ #include "files/juce_ParallelFileFinder.h"
+#endif
 #ifndef __JUCE_TEMPORARYFILE_JUCEHEADER__
  #include "files/juce_TemporaryFile.h"
 #endif
 #ifndef __JUCE_JSON_JUCEHEADER__
  #include "json/juce_JSON.h"
 #endif
+#ifndef __JUCE_ASYNCFILELOGGER_JUCEHEADER__
+ #include "logging/juce_AsyncFileLogger.h"
+#endif
 #ifndef __JUCE_FILELOGGER_JUCEHEADER__
  #include "logging/juce_FileLogger.h"
 #endif
@@ -221,9 +266,15 @@ namespace juce
 #ifndef __JUCE_BIGINTEGER_JUCEHEADER__
  #include "maths/juce_BigInteger.h"
 #endif
+#ifndef __JUCE_COMPILEDEXPRESSION_JUCEHEADER__
+ #include "maths/juce_CompiledExpression.h"
+#endif
 #ifndef __JUCE_EXPRESSION_JUCEHEADER__
  #include "maths/juce_Expression.h"
 #endif
+#ifndef __JUCE_FASTRANDOM_JUCEHEADER__
+ #include "maths/juce_FastRandom.h"
+#endif
 #ifndef __JUCE_MATHSFUNCTIONS_JUCEHEADER__
  #include "maths/juce_MathsFunctions.h"
 #endif
@@ -248,6 +299,9 @@ namespace juce
 #ifndef __JUCE_MEMORY_JUCEHEADER__
  #include "memory/juce_Memory.h"
 #endif
+#ifndef __JUCE_MEMORYARENA_JUCEHEADER__
+ #include "memory/juce_MemoryArena.h"
+#endif
 #ifndef __JUCE_MEMORYBLOCK_JUCEHEADER__
  #include "memory/juce_MemoryBlock.h"
 #endif
@@ -260,6 +314,12 @@ namespace juce
 #ifndef __JUCE_SCOPEDPOINTER_JUCEHEADER__
  #include "memory/juce_ScopedPointer.h"
 #endif
+#ifndef __JUCE_SHAREDRESOURCEPOINTER_JUCEHEADER__
+ #include "memory/juce_SharedResourcePointer.h"
+#endif
+#ifndef __JUCE_SHAREDRESOURCEREGISTRY_JUCEHEADER__
+ #include "memory/juce_SharedResourceRegistry.h"
+#endif
 #ifndef __JUCE_SINGLETON_JUCEHEADER__
  #include "memory/juce_Singleton.h"
 #endif
@@ -275,6 +335,12 @@ namespace juce
 #ifndef __JUCE_WINDOWSREGISTRY_JUCEHEADER__
  #include "misc/juce_WindowsRegistry.h"
 #endif
+#ifndef __JUCE_XXHASH64_JUCEHEADER__
+ #include "misc/juce_XXHash64.h"
+#endif
+#ifndef __JUCE_HTTPCLIENT_JUCEHEADER__
+ #include "network/juce_HTTPClient.h"
+#endif
 #ifndef __JUCE_IPADDRESS_JUCEHEADER__
  #include "network/juce_IPAddress.h"
 #endif
@@ -284,12 +350,18 @@ namespace juce
 #ifndef __JUCE_NAMEDPIPE_JUCEHEADER__
  #include "network/juce_NamedPipe.h"
 #endif
+#ifndef __JUCE_SHAREDMEMORYCHANNEL_JUCEHEADER__
+ #include "network/juce_SharedMemoryChannel.h"
+#endif
 #ifndef __JUCE_SOCKET_JUCEHEADER__
  #include "network/juce_Socket.h"
 #endif
 #ifndef __JUCE_URL_JUCEHEADER__
  #include "network/juce_URL.h"
 #endif
+#ifndef __JUCE_ASYNCSTREAMREADER_JUCEHEADER__
+ #include "streams/juce_AsyncStreamReader.h"
+#endif
 #ifndef __JUCE_BUFFEREDINPUTSTREAM_JUCEHEADER__
  #include "streams/juce_BufferedInputStream.h"
 #endif
@@ -311,6 +383,9 @@ namespace juce
 #ifndef __JUCE_OUTPUTSTREAM_JUCEHEADER__
  #include "streams/juce_OutputStream.h"
 #endif
+#ifndef __JUCE_SEGMENTEDMEMORYOUTPUTSTREAM_JUCEHEADER__
+ #include "streams/juce_SegmentedMemoryOutputStream.h"
+#endif
 #ifndef __JUCE_SUBREGIONSTREAM_JUCEHEADER__
  #include "streams/juce_SubregionStream.h"
 #endif
@@ -356,15 +431,27 @@ namespace juce
 #ifndef __JUCE_STRINGARRAY_JUCEHEADER__
  #include "text/juce_StringArray.h"
 #endif
+#ifndef __JUCE_STRINGBUILDER_JUCEHEADER__
+ #include "text/juce_StringBuilder.h"
+#endif
 #ifndef __JUCE_STRINGPAIRARRAY_JUCEHEADER__
  #include "text/juce_StringPairArray.h"
 #endif
 #ifndef __JUCE_STRINGPOOL_JUCEHEADER__
  #include "text/juce_StringPool.h"
 #endif
+#ifndef __JUCE_STRINGREF_JUCEHEADER__
+ #include "text/juce_StringRef.h"
+#endif
 #ifndef __JUCE_TEXTDIFF_JUCEHEADER__
  #include "text/juce_TextDiff.h"
 #endif
+#ifndef __JUCE_ADAPTIVECRITICALSECTION_JUCEHEADER__
+ #include "threads/juce_AdaptiveCriticalSection.h"
+#endif
+#ifndef __JUCE_ASYNCCHILDPROCESS_JUCEHEADER__
+ #include "threads/juce_AsyncChildProcess.h"
+#endif
 #ifndef __JUCE_CHILDPROCESS_JUCEHEADER__
  #include "threads/juce_ChildProcess.h"
 #endif
@@ -380,12 +467,18 @@ namespace juce
 #ifndef __JUCE_INTERPROCESSLOCK_JUCEHEADER__
  #include "threads/juce_InterProcessLock.h"
 #endif
+#ifndef __JUCE_LIGHTWEIGHTEVENT_JUCEHEADER__
+ #include "threads/juce_LightweightEvent.h"
+#endif
 #ifndef __JUCE_PROCESS_JUCEHEADER__
  #include "threads/juce_Process.h"
 #endif
 #ifndef __JUCE_READWRITELOCK_JUCEHEADER__
  #include "threads/juce_ReadWriteLock.h"
 #endif
+#ifndef __JUCE_SCALABLEREADWRITELOCK_JUCEHEADER__
+ #include "threads/juce_ScalableReadWriteLock.h"
+#endif
 #ifndef __JUCE_SCOPEDLOCK_JUCEHEADER__
  #include "threads/juce_ScopedLock.h"
 #endif
@@ -407,6 +500,9 @@ namespace juce
 #ifndef __JUCE_THREADPOOL_JUCEHEADER__
  #include "threads/juce_ThreadPool.h"
 #endif
+#ifndef __JUCE_TIMESLICEPOOL_JUCEHEADER__
+ #include "threads/juce_TimeSlicePool.h"
+#endif
 #ifndef __JUCE_TIMESLICETHREAD_JUCEHEADER__
  #include "threads/juce_TimeSliceThread.h"
 #endif
@@ -422,6 +518,12 @@ namespace juce
 #ifndef __JUCE_TIME_JUCEHEADER__
  #include "time/juce_Time.h"
 #endif
+#ifndef __JUCE_TRACELOG_JUCEHEADER__
+ #include "time/juce_TraceLog.h"
+#endif
+#ifndef __JUCE_BENCHMARK_JUCEHEADER__
+ #include "unit_tests/juce_Benchmark.h"
+#endif
 #ifndef __JUCE_UNITTEST_JUCEHEADER__
  #include "unit_tests/juce_UnitTest.h"
 #endif
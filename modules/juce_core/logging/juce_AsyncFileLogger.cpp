@@ -0,0 +1,274 @@
+/*
+  ==============================================================================
+
+   This file is part of the juce_core module of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission to use, copy, modify, and/or distribute this software for any purpose with
+   or without fee is hereby granted, provided that the above copyright notice and this
+   permission notice appear in all copies.
+
+   THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+   TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+   NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+   DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+   IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+   ------------------------------------------------------------------------------
+
+   NOTE! This permissive ISC license applies ONLY to files within the juce_core module!
+   All other JUCE modules are covered by a dual GPL/commercial license, so if you are
+   using any other modules, be sure to check that you also comply with their license.
+
+   For more details, visit www.juce.com
+
+  ==============================================================================
+*/
+
+AsyncFileLogger::AsyncFileLogger (const File& file,
+                                  const String& welcomeMessage,
+                                  const int64 maxFileSizeBytes,
+                                  RelativeTime maxFileAge,
+                                  const int numOldFilesToKeep,
+                                  const int maxQueuedMessages)
+    : Thread ("AsyncFileLogger"),
+      logFile (file),
+      maxFileSize (maxFileSizeBytes),
+      maxAge (maxFileAge),
+      numOldFiles (jmax (0, numOldFilesToKeep)),
+      queue (maxQueuedMessages)
+{
+    String welcome;
+    welcome << newLine
+            << "**********************************************************" << newLine
+            << welcomeMessage << newLine
+            << "Log started: " << Time::getCurrentTime().toString (true, true) << newLine;
+
+    AsyncFileLogger::logMessage (welcome);
+
+    startThread (3);
+}
+
+AsyncFileLogger::~AsyncFileLogger()
+{
+    signalThreadShouldExit();
+    messagesQueued.signal();
+    stopThread (-1);
+}
+
+//==============================================================================
+void AsyncFileLogger::logMessage (const String& message)
+{
+    DBG (message);
+
+    while (! queue.push (message))
+    {
+        // The queue is full, so wait for the writer thread to catch up..
+        messagesQueued.signal();
+        messagesWritten.wait (1);
+    }
+
+    ++numQueued;
+    messagesQueued.signal();
+}
+
+void AsyncFileLogger::flush()
+{
+    const int target = numQueued.get();
+
+    while (numWritten.get() - target < 0)
+    {
+        messagesQueued.signal();
+        messagesWritten.wait (10);
+    }
+}
+
+File AsyncFileLogger::getOldLogFile (const int index) const
+{
+    return logFile.getSiblingFile (logFile.getFileNameWithoutExtension()
+                                    + "." + String (index) + logFile.getFileExtension());
+}
+
+//==============================================================================
+void AsyncFileLogger::run()
+{
+    while (! threadShouldExit())
+    {
+        writeQueuedMessages();
+        messagesQueued.wait (-1);
+    }
+
+    writeQueuedMessages();
+    stream = nullptr;
+}
+
+void AsyncFileLogger::writeQueuedMessages()
+{
+    enum { batchSize = 256 };
+    String batch [batchSize];
+    int numDone = 0;
+
+    for (;;)
+    {
+        const int num = queue.popMultiple (batch, batchSize);
+
+        if (num == 0)
+            break;
+
+        for (int i = 0; i < num; ++i)
+        {
+            if (stream == nullptr || shouldRotate())
+            {
+                if (stream != nullptr)
+                    rotateFiles();
+
+                openFile();
+            }
+
+            if (stream != nullptr)
+                *stream << batch[i] << newLine;
+
+            batch[i] = String::empty;
+        }
+
+        numDone += num;
+    }
+
+    if (numDone > 0)
+    {
+        if (stream != nullptr)
+            stream->flush();
+
+        numWritten += numDone;
+        messagesWritten.signal();
+    }
+}
+
+bool AsyncFileLogger::shouldRotate() const
+{
+    return (maxFileSize > 0 && stream->getPosition() >= maxFileSize)
+        || (maxAge > RelativeTime() && Time::getCurrentTime() >= fileOpenedTime + maxAge);
+}
+
+void AsyncFileLogger::rotateFiles()
+{
+    stream = nullptr;
+
+    if (numOldFiles > 0)
+    {
+        getOldLogFile (numOldFiles).deleteFile();
+
+        for (int i = numOldFiles; --i > 0;)
+            getOldLogFile (i).moveFileTo (getOldLogFile (i + 1));
+
+        logFile.moveFileTo (getOldLogFile (1));
+    }
+    else
+    {
+        logFile.deleteFile();
+    }
+}
+
+void AsyncFileLogger::openFile()
+{
+    if (! logFile.exists())
+        logFile.create();  // (to create the parent directories)
+
+    stream = new FileOutputStream (logFile, 65536);
+    fileOpenedTime = Time::getCurrentTime();
+
+    if (stream->failedToOpen())
+        stream = nullptr;
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class AsyncFileLoggerTests  : public UnitTest
+{
+public:
+    AsyncFileLoggerTests() : UnitTest ("AsyncFileLogger") {}
+
+    enum { numThreads = 4, numMessagesPerThread = 1000 };
+
+    struct LoggingThread  : public Thread
+    {
+        LoggingThread (AsyncFileLogger& l, int id_)  : Thread ("logging thread"), logger (l), id (id_) {}
+
+        void run()
+        {
+            for (int i = 0; i < numMessagesPerThread; ++i)
+                logger.logMessage ("message " + String (id) + " " + String (i));
+        }
+
+        AsyncFileLogger& logger;
+        const int id;
+    };
+
+    static int countMessages (const File& file)
+    {
+        StringArray lines;
+        lines.addLines (file.loadFileAsString());
+
+        int num = 0;
+        for (int i = 0; i < lines.size(); ++i)
+            if (lines[i].startsWith ("message "))
+                ++num;
+
+        return num;
+    }
+
+    void runTest()
+    {
+        const File folder (File::getSpecialLocation (File::tempDirectory)
+                             .getNonexistentChildFile ("AsyncFileLoggerTests", String::empty));
+        const File file (folder.getChildFile ("log.txt"));
+
+        beginTest ("Messages from several threads");
+
+        {
+            // (a small queue, so that the threads will have to wait for the writer)
+            AsyncFileLogger logger (file, "test", 0, RelativeTime(), 0, 64);
+
+            OwnedArray<LoggingThread> threads;
+
+            for (int i = 0; i < numThreads; ++i)
+            {
+                threads.add (new LoggingThread (logger, i));
+                threads.getLast()->startThread();
+            }
+
+            for (int i = 0; i < numThreads; ++i)
+                threads.getUnchecked (i)->waitForThreadToExit (-1);
+
+            logger.flush();
+            expectEquals (countMessages (file), numThreads * numMessagesPerThread);
+        }
+
+        folder.deleteRecursively();
+
+        beginTest ("Rotation by size");
+
+        {
+            AsyncFileLogger logger (file, "test", 4096, RelativeTime(), 2);
+
+            for (int i = 0; i < 2000; ++i)
+                logger.logMessage ("message 0 " + String (i));
+
+            logger.flush();
+
+            expect (file.getSize() < 4096 + 64);
+            expect (logger.getOldLogFile (1).existsAsFile());
+            expect (logger.getOldLogFile (2).existsAsFile());
+            expect (! logger.getOldLogFile (3).exists());
+            expect (file.loadFileAsString().contains ("message 0 1999"));
+        }
+
+        folder.deleteRecursively();
+    }
+};
+
+static AsyncFileLoggerTests asyncFileLoggerTests;
+
+#endif
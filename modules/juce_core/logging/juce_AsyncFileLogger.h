@@ -0,0 +1,140 @@
+/*
+  ==============================================================================
+
+   This file is part of the juce_core module of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission to use, copy, modify, and/or distribute this software for any purpose with
+   or without fee is hereby granted, provided that the above copyright notice and this
+   permission notice appear in all copies.
+
+   THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+   TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+   NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+   DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+   IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+   ------------------------------------------------------------------------------
+
+   NOTE! This permissive ISC license applies ONLY to files within the juce_core module!
+   All other JUCE modules are covered by a dual GPL/commercial license, so if you are
+   using any other modules, be sure to check that you also comply with their license.
+
+   For more details, visit www.juce.com
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_ASYNCFILELOGGER_JUCEHEADER__
+#define __JUCE_ASYNCFILELOGGER_JUCEHEADER__
+
+#include "juce_Logger.h"
+#include "../files/juce_File.h"
+#include "../files/juce_FileOutputStream.h"
+#include "../containers/juce_ConcurrentQueue.h"
+#include "../threads/juce_Thread.h"
+#include "../threads/juce_LightweightEvent.h"
+#include "../time/juce_RelativeTime.h"
+#include "../memory/juce_ScopedPointer.h"
+
+
+//==============================================================================
+/**
+    A Logger that writes to a file on a background thread.
+
+    Unlike FileLogger, which opens, appends to and closes its file inside every call
+    to logMessage(), this just pushes the message onto a lock-free queue and returns.
+    A single writer thread keeps the file open, and writes out whatever messages have
+    accumulated in one go, so any number of threads can log without contending for a
+    lock or making a system call per line. Because Strings are reference-counted, queueing
+    a message doesn't allocate any memory.
+
+    The file can also be rotated when it grows beyond a certain size or age: the current
+    file is renamed to "name.1.ext" (with any older files being shuffled along to
+    "name.2.ext" and so on), and a fresh file is started. This is done on the writer
+    thread, so it never holds up the threads that are logging.
+
+    If messages arrive faster than they can be written and the queue fills up,
+    logMessage() will wait for the writer to make some space, rather than drop them.
+
+    @see FileLogger, Logger
+*/
+class JUCE_API  AsyncFileLogger  : public Logger,
+                                   private Thread
+{
+public:
+    //==============================================================================
+    /** Creates an AsyncFileLogger for a given file, and starts its writer thread.
+
+        @param fileToWriteTo        the file to use - new messages will be appended to it.
+                                    If the file doesn't exist, it will be created, along with any
+                                    parent directories that are needed.
+        @param welcomeMessage       when opened, the logger will write a header to the log, along
+                                    with the current date and time, and this welcome message
+        @param maxFileSizeBytes     if this is greater than zero, the file will be rotated before
+                                    a message is written to it once it has reached this size
+        @param maxFileAge           if this is greater than zero, the file will be rotated before
+                                    a message is written to it once this much time has passed since
+                                    the logger started writing to it
+        @param numOldFilesToKeep    the number of rotated files to keep - older ones are deleted.
+                                    If this is zero, the current file is simply deleted when it's
+                                    rotated
+        @param maxQueuedMessages    the number of messages that can be waiting to be written before
+                                    logMessage() has to wait for the writer thread
+    */
+    AsyncFileLogger (const File& fileToWriteTo,
+                     const String& welcomeMessage,
+                     int64 maxFileSizeBytes = 0,
+                     RelativeTime maxFileAge = RelativeTime(),
+                     int numOldFilesToKeep = 4,
+                     int maxQueuedMessages = 8192);
+
+    /** Destructor.
+        Any messages that are still queued will be written before the file is closed.
+    */
+    ~AsyncFileLogger();
+
+    //==============================================================================
+    /** Returns the file that this logger is writing to. */
+    const File& getLogFile() const noexcept             { return logFile; }
+
+    /** Returns the name that a rotated log file will be given.
+        An index of 1 is the most recently rotated file, 2 is the one before that, etc.
+    */
+    File getOldLogFile (int index) const;
+
+    /** Blocks until all the messages that were logged before this call have been
+        written to the file.
+    */
+    void flush();
+
+    //==============================================================================
+    // (implementation of the Logger virtual method)
+    void logMessage (const String&);
+
+private:
+    //==============================================================================
+    const File logFile;
+    const int64 maxFileSize;
+    const RelativeTime maxAge;
+    const int numOldFiles;
+
+    ConcurrentQueue<String> queue;
+    LightweightEvent messagesQueued, messagesWritten;
+    Atomic<int> numQueued, numWritten;
+
+    ScopedPointer<FileOutputStream> stream;
+    Time fileOpenedTime;
+
+    void run();
+    void writeQueuedMessages();
+    bool shouldRotate() const;
+    void rotateFiles();
+    void openFile();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AsyncFileLogger)
+};
+
+
+#endif   // __JUCE_ASYNCFILELOGGER_JUCEHEADER__
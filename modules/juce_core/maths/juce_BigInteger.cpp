@@ -131,6 +131,18 @@ BigInteger& BigInteger::operator= (const BigInteger& other)
     return *this;
 }
 
+void BigInteger::setWords (const uint32* const words, size_t numWords)
+{
+    while (numWords > 0 && words [numWords - 1] == 0)
+        --numWords;
+
+    clear();
+    ensureSize (numWords);
+    memcpy (values, words, sizeof (uint32) * numWords);
+    highestBit = (int) (numWords << 5) - 1;
+    highestBit = getHighestBit();
+}
+
 void BigInteger::ensureSize (const size_t numVals)
 {
     if (numVals + 2 >= numValues)
@@ -481,26 +493,314 @@ BigInteger& BigInteger::operator-= (const BigInteger& other)
     return *this;
 }
 
-BigInteger& BigInteger::operator*= (const BigInteger& other)
+//==============================================================================
+namespace BigIntegerHelpers
 {
-    BigInteger total;
-    highestBit = getHighestBit();
-    const bool wasNegative = isNegative();
-    setNegative (false);
+    // Below this many words, Karatsuba multiplication is slower than the simple method.
+    enum { karatsubaThreshold = 40 };
+
+    // result[0 .. numA + numB) = a * b  (the result mustn't overlap either input)
+    static void multiplyWords (uint32* const result, const uint32* const a, const size_t numA,
+                               const uint32* const b, const size_t numB) noexcept
+    {
+        zeromem (result, sizeof (uint32) * (numA + numB));
+
+        for (size_t i = 0; i < numA; ++i)
+        {
+            const uint64 ai = a[i];
+
+            if (ai != 0)
+            {
+                uint64 carry = 0;
+
+                for (size_t j = 0; j < numB; ++j)
+                {
+                    carry += ai * b[j] + result[i + j];
+                    result[i + j] = (uint32) carry;
+                    carry >>= 32;
+                }
+
+                result[i + numB] = (uint32) carry;
+            }
+        }
+    }
+
+    // a[0 .. numA) += b[0 .. numB), returning the carry (numA must be >= numB)
+    static uint32 addWords (uint32* const a, const size_t numA, const uint32* const b, const size_t numB) noexcept
+    {
+        uint64 carry = 0;
+        size_t i = 0;
+
+        for (; i < numB; ++i)
+        {
+            carry += (uint64) a[i] + b[i];
+            a[i] = (uint32) carry;
+            carry >>= 32;
+        }
+
+        for (; carry != 0 && i < numA; ++i)
+        {
+            carry += a[i];
+            a[i] = (uint32) carry;
+            carry >>= 32;
+        }
+
+        return (uint32) carry;
+    }
+
+    // a[0 .. numA) -= b[0 .. numB), where a >= b
+    static void subtractWords (uint32* const a, const size_t numA, const uint32* const b, const size_t numB) noexcept
+    {
+        int64 borrow = 0;
+        size_t i = 0;
+
+        for (; i < numB; ++i)
+        {
+            borrow += (int64) a[i] - b[i];
+            a[i] = (uint32) borrow;
+            borrow >>= 32;
+        }
+
+        for (; borrow != 0 && i < numA; ++i)
+        {
+            borrow += a[i];
+            a[i] = (uint32) borrow;
+            borrow >>= 32;
+        }
+    }
 
-    for (int i = 0; i <= highestBit; ++i)
+    // result[0 .. 2n) = a * b, where both inputs are n words long
+    static void karatsubaMultiply (uint32* const result, const uint32* const a, const uint32* const b, const size_t n)
     {
-        if (operator[](i))
+        if (n < karatsubaThreshold)
         {
-            BigInteger n (other);
-            n.setNegative (false);
-            n <<= i;
-            total += n;
+            multiplyWords (result, a, n, b, n);
+            return;
         }
+
+        // a = a1 * 2^(32 * low) + a0, and similarly for b..
+        const size_t low = n / 2, high = n - low;
+
+        karatsubaMultiply (result, a, b, low);                  // a0 * b0
+        HeapBlock<uint32> highProduct (high * 2);
+        karatsubaMultiply (highProduct, a + low, b + low, high); // a1 * b1
+        memcpy (result + low * 2, highProduct, sizeof (uint32) * high * 2);
+
+        // (a0 + a1) * (b0 + b1) - a0 * b0 - a1 * b1 = a0 * b1 + a1 * b0
+        const size_t sumSize = high + 1;
+        HeapBlock<uint32> sumA (sumSize, true), sumB (sumSize, true), middle (sumSize * 2);
+
+        memcpy (sumA, a + low, sizeof (uint32) * high);
+        memcpy (sumB, b + low, sizeof (uint32) * high);
+        addWords (sumA, sumSize, a, low);
+        addWords (sumB, sumSize, b, low);
+
+        karatsubaMultiply (middle, sumA, sumB, sumSize);
+        subtractWords (middle, sumSize * 2, result, low * 2);
+        subtractWords (middle, sumSize * 2, highProduct, high * 2);
+
+        addWords (result + low, n * 2 - low, middle, jmin (sumSize * 2, n * 2 - low));
+    }
+
+    //==============================================================================
+    // Does a long division of u[0 .. numU) by v[0 .. numV), using Knuth's algorithm D.
+    // The quotient goes into q[0 .. numU - numV + 1), and the remainder replaces u.
+    // v's top word must be non-zero, numV must be at least 2, and u needs a spare word at u[numU].
+    static void divideWords (uint32* const q, uint32* const u, const size_t numU,
+                             const uint32* const divisor, const size_t numV)
+    {
+        // Normalise, so that the divisor's top bit is set..
+        const int shift = 31 - BitFunctions::highestBitInInt (divisor [numV - 1]);
+        HeapBlock<uint32> v (numV);
+
+        for (size_t i = numV; --i > 0;)
+            v[i] = (divisor[i] << shift) | (shift != 0 ? (divisor[i - 1] >> (32 - shift)) : 0);
+
+        v[0] = divisor[0] << shift;
+
+        u[numU] = shift != 0 ? (u[numU - 1] >> (32 - shift)) : 0;
+
+        for (size_t i = numU; --i > 0;)
+            u[i] = (u[i] << shift) | (shift != 0 ? (u[i - 1] >> (32 - shift)) : 0);
+
+        u[0] <<= shift;
+
+        const uint64 base = ((uint64) 1) << 32;
+        const uint64 vTop = v[numV - 1], vNext = v[numV - 2];
+
+        for (size_t j = numU - numV + 1; j-- > 0;)
+        {
+            // Estimate the next quotient word from the top words, and correct it if it's too big..
+            const uint64 top = (((uint64) u[j + numV]) << 32) | u[j + numV - 1];
+            uint64 qHat = top / vTop;
+            uint64 rHat = top % vTop;
+
+            while (qHat >= base || qHat * vNext > ((rHat << 32) | u[j + numV - 2]))
+            {
+                --qHat;
+                rHat += vTop;
+
+                if (rHat >= base)
+                    break;
+            }
+
+            // ..then multiply and subtract..
+            int64 borrow = 0;
+
+            for (size_t i = 0; i < numV; ++i)
+            {
+                const uint64 p = qHat * v[i];
+                const int64 t = (int64) u[i + j] - borrow - (int64) (p & 0xffffffff);
+                u[i + j] = (uint32) t;
+                borrow = (int64) (p >> 32) - (t >> 32);
+            }
+
+            const int64 t = (int64) u[j + numV] - borrow;
+            u[j + numV] = (uint32) t;
+
+            // ..and if that went negative, the estimate was one too big, so add the divisor back on.
+            if (t < 0)
+            {
+                --qHat;
+                u[j + numV] += addWords (u + j, numV, v, numV);
+            }
+
+            q[j] = (uint32) qHat;
+        }
+
+        // Un-normalise the remainder..
+        for (size_t i = 0; i < numV; ++i)
+            u[i] = (u[i] >> shift) | (shift != 0 ? (u[i + 1] << (32 - shift)) : 0);
+
+        zeromem (u + numV, sizeof (uint32) * (numU + 1 - numV));
+    }
+
+    //==============================================================================
+    /*  Holds a modulus in a form that allows modular multiplications to be done with
+        Montgomery's method, which replaces the division in each step with some
+        multiplications and a shift.
+    */
+    struct MontgomeryContext
+    {
+        MontgomeryContext (const uint32* const mod, const size_t numWords)
+            : modulus (numWords), n (numWords), temp (numWords + 2)
+        {
+            memcpy (modulus, mod, sizeof (uint32) * n);
+
+            // Find -1 / modulus (mod 2^32), using Newton's iteration..
+            uint32 inverse = modulus[0];
+
+            for (int i = 0; i < 5; ++i)
+                inverse *= 2 - modulus[0] * inverse;
+
+            negativeInverse = 0 - inverse;
+        }
+
+        // result = a * b / 2^(32n) (mod modulus). The result may be the same array as a or b.
+        void multiply (uint32* const result, const uint32* const a, const uint32* const b) noexcept
+        {
+            uint32* const t = temp;
+            zeromem (t, sizeof (uint32) * (n + 2));
+
+            for (size_t i = 0; i < n; ++i)
+            {
+                const uint64 bi = b[i];
+                uint64 carry = 0;
+
+                for (size_t j = 0; j < n; ++j)
+                {
+                    carry += t[j] + a[j] * bi;
+                    t[j] = (uint32) carry;
+                    carry >>= 32;
+                }
+
+                carry += t[n];
+                t[n] = (uint32) carry;
+                t[n + 1] = (uint32) (carry >> 32);
+
+                const uint64 m = (uint32) (t[0] * negativeInverse);
+                carry = (t[0] + m * modulus[0]) >> 32;
+
+                for (size_t j = 1; j < n; ++j)
+                {
+                    carry += t[j] + m * modulus[j];
+                    t[j - 1] = (uint32) carry;
+                    carry >>= 32;
+                }
+
+                carry += t[n];
+                t[n - 1] = (uint32) carry;
+                t[n] = t[n + 1] + (uint32) (carry >> 32);
+            }
+
+            if (t[n] != 0 || ! isLessThanModulus (t))
+                subtractWords (t, n + 1, modulus, n);
+
+            memcpy (result, t, sizeof (uint32) * n);
+        }
+
+        bool isLessThanModulus (const uint32* const value) const noexcept
+        {
+            for (size_t i = n; i-- > 0;)
+                if (value[i] != modulus[i])
+                    return value[i] < modulus[i];
+
+            return false;
+        }
+
+        HeapBlock<uint32> modulus;
+        const size_t n;
+        uint32 negativeInverse;
+
+    private:
+        HeapBlock<uint32> temp;
+
+        JUCE_DECLARE_NON_COPYABLE (MontgomeryContext)
+    };
+
+    static void copyWords (const BigInteger& source, uint32* const dest, const size_t numWords)
+    {
+        for (size_t i = 0; i < numWords; ++i)
+            dest[i] = source.getBitRangeAsInt ((int) (i << 5), 32);
+    }
+}
+
+BigInteger& BigInteger::operator*= (const BigInteger& other)
+{
+    using namespace BigIntegerHelpers;
+
+    const int ourHB = getHighestBit();
+    const int otherHB = other.getHighestBit();
+    const bool willBeNegative = isNegative() ^ other.isNegative();
+
+    if (ourHB < 0 || otherHB < 0)
+    {
+        clear();
+        return *this;
     }
 
-    total.setNegative (wasNegative ^ other.isNegative());
-    swapWith (total);
+    const size_t numA = bitToIndex (ourHB) + 1;
+    const size_t numB = bitToIndex (otherHB) + 1;
+    HeapBlock<uint32> product (numA + numB);
+
+    if (jmin (numA, numB) >= karatsubaThreshold && jmax (numA, numB) <= jmin (numA, numB) * 2)
+    {
+        // Karatsuba needs both inputs the same size, so the shorter one gets padded with zeros.
+        const size_t n = jmax (numA, numB);
+        HeapBlock<uint32> a (n, true), b (n, true), fullProduct (n * 2);
+        memcpy (a, values, sizeof (uint32) * numA);
+        memcpy (b, other.values, sizeof (uint32) * numB);
+
+        karatsubaMultiply (fullProduct, a, b, n);
+        memcpy (product, fullProduct, sizeof (uint32) * (numA + numB));
+    }
+    else
+    {
+        multiplyWords (product, values, numA, other.values, numB);
+    }
+
+    setWords (product, numA + numB);
+    negative = willBeNegative && highestBit >= 0;
     return *this;
 }
 
@@ -520,31 +820,44 @@ void BigInteger::divideBy (const BigInteger& divisor, BigInteger& remainder)
     else
     {
         const bool wasNegative = isNegative();
+        const bool divisorWasNegative = divisor.isNegative();
 
-        swapWith (remainder);
-        remainder.setNegative (false);
-        clear();
-
-        BigInteger temp (divisor);
-        temp.setNegative (false);
-
-        int leftShift = ourHB - divHB;
-        temp <<= leftShift;
+        const size_t numU = bitToIndex (ourHB) + 1;
+        const size_t numV = bitToIndex (divHB) + 1;
 
-        while (leftShift >= 0)
+        if (ourHB < divHB)
         {
-            if (remainder.compareAbsolute (temp) >= 0)
+            swapWith (remainder);
+            clear();
+        }
+        else if (numV == 1)
+        {
+            const uint64 d = divisor.values[0];
+            uint64 rem = 0;
+
+            for (size_t i = numU; i-- > 0;)
             {
-                remainder -= temp;
-                setBit (leftShift);
+                rem = (rem << 32) | values[i];
+                values[i] = (uint32) (rem / d);
+                rem %= d;
             }
 
-            if (--leftShift >= 0)
-                temp >>= 1;
+            highestBit = getHighestBit();
+            remainder = BigInteger ((int64) rem);
         }
+        else
+        {
+            HeapBlock<uint32> u (numU + 1), q (numU - numV + 1);
+            memcpy (u, values, sizeof (uint32) * numU);
+
+            BigIntegerHelpers::divideWords (q, u, numU, divisor.values, numV);
 
-        negative = wasNegative ^ divisor.isNegative();
-        remainder.setNegative (wasNegative);
+            remainder.setWords (u, numV);
+            setWords (q, numU - numV + 1);
+        }
+
+        negative = (wasNegative ^ divisorWasNegative) && highestBit >= 0;
+        remainder.setNegative (wasNegative && ! remainder.isZero());
     }
 }
 
@@ -825,6 +1138,12 @@ BigInteger BigInteger::findGreatestCommonDivisor (BigInteger n) const
 
 void BigInteger::exponentModulo (const BigInteger& exponent, const BigInteger& modulus)
 {
+    if (modulus[0] && modulus.getHighestBit() > 0 && ! (modulus.isNegative() || exponent.isNegative() || isNegative()))
+    {
+        montgomeryExponentModulo (exponent, modulus);
+        return;
+    }
+
     BigInteger exp (exponent);
     exp %= modulus;
 
@@ -846,6 +1165,78 @@ void BigInteger::exponentModulo (const BigInteger& exponent, const BigInteger& m
     }
 }
 
+void BigInteger::montgomeryExponentModulo (const BigInteger& exponent, const BigInteger& modulus)
+{
+    using namespace BigIntegerHelpers;
+
+    const size_t n = bitToIndex (modulus.getHighestBit()) + 1;
+    HeapBlock<uint32> mod (n);
+    copyWords (modulus, mod, n);
+    MontgomeryContext context (mod, n);
+
+    // Convert the base and 1 into Montgomery form, i.e. multiply them by 2^(32n) mod modulus..
+    BigInteger base (*this);
+    base %= modulus;
+    base <<= (int) (n << 5);
+    base %= modulus;
+
+    BigInteger one (1);
+    one <<= (int) (n << 5);
+    one %= modulus;
+
+    // Choose a window size that balances the precalculation against the number of multiplies..
+    const int numExponentBits = exponent.getHighestBit() + 1;
+    const int windowSize = numExponentBits > 671 ? 6 : (numExponentBits > 239 ? 5 : (numExponentBits > 79 ? 4 : (numExponentBits > 23 ? 3 : 1)));
+
+    // ..and precalculate the odd powers of the base: base^1, base^3, base^5, etc.
+    const size_t numPowers = (size_t) 1 << (windowSize - 1);
+    HeapBlock<uint32> powers (numPowers * n), squared (n), x (n);
+    copyWords (base, powers, n);
+
+    if (numPowers > 1)
+    {
+        context.multiply (squared, powers, powers);
+
+        for (size_t i = 1; i < numPowers; ++i)
+            context.multiply (powers + i * n, powers + (i - 1) * n, squared);
+    }
+
+    copyWords (one, x, n);
+
+    for (int i = numExponentBits - 1; i >= 0;)
+    {
+        if (! exponent[i])
+        {
+            context.multiply (x, x, x);
+            --i;
+            continue;
+        }
+
+        // Find the longest run of bits (up to the window size) that starts and ends with a 1..
+        int windowStart = jmax (0, i - windowSize + 1);
+
+        while (! exponent [windowStart])
+            ++windowStart;
+
+        const int windowLength = i - windowStart + 1;
+
+        for (int j = 0; j < windowLength; ++j)
+            context.multiply (x, x, x);
+
+        const uint32 windowValue = exponent.getBitRangeAsInt (windowStart, windowLength);
+        context.multiply (x, x, powers + (windowValue >> 1) * n);
+
+        i = windowStart - 1;
+    }
+
+    // Finally, convert back from Montgomery form by multiplying by 1.
+    HeapBlock<uint32> plainOne (n, true);
+    plainOne[0] = 1;
+    context.multiply (x, x, plainOne);
+
+    setWords (x, n);
+}
+
 void BigInteger::inverseModulo (const BigInteger& modulus)
 {
     if (modulus.isOne() || modulus.isNegative())
@@ -1019,3 +1410,112 @@ void BigInteger::loadFromMemoryBlock (const MemoryBlock& data)
     for (int i = (int) data.getSize(); --i >= 0;)
         this->setBitRangeAsInt (i << 3, 8, (uint32) data [i]);
 }
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class BigIntegerTests  : public UnitTest
+{
+public:
+    BigIntegerTests() : UnitTest ("BigInteger") {}
+
+    static BigInteger getRandomNumber (Random& r, const int maxBits)
+    {
+        BigInteger b;
+        r.fillBitsRandomly (b, 0, r.nextInt (maxBits) + 1);
+        return b;
+    }
+
+    // (a bit-at-a-time multiply, to check the fast ones against)
+    static BigInteger simpleMultiply (const BigInteger& a, const BigInteger& b)
+    {
+        BigInteger total;
+
+        for (int i = 0; i <= a.getHighestBit(); ++i)
+            if (a[i])
+                total += b << i;
+
+        return total;
+    }
+
+    void runTest()
+    {
+        Random r (0x3456);
+
+        beginTest ("Multiplication");
+
+        for (int i = 0; i < 200; ++i)
+        {
+            const BigInteger a (getRandomNumber (r, i < 100 ? 200 : 6000));
+            const BigInteger b (getRandomNumber (r, i < 100 ? 200 : 6000));
+            expect (a * b == simpleMultiply (a, b));
+        }
+
+        expect (BigInteger (-7) * BigInteger (6) == BigInteger (-42));
+        expect (BigInteger (-7) * BigInteger (-6) == BigInteger (42));
+
+        beginTest ("Division");
+
+        for (int i = 0; i < 200; ++i)
+        {
+            const BigInteger a (getRandomNumber (r, 3000));
+            BigInteger b (getRandomNumber (r, i < 100 ? 40 : 2000));
+
+            if (b.isZero())
+                b = 1;
+
+            BigInteger quotient (a), remainder;
+            quotient.divideBy (b, remainder);
+
+            expect (remainder.compareAbsolute (b) < 0);
+            expect (quotient * b + remainder == a);
+        }
+
+        {
+            BigInteger quotient (-43), remainder;
+            quotient.divideBy (BigInteger (5), remainder);
+            expect (quotient == BigInteger (-8) && remainder == BigInteger (-3));
+        }
+
+        beginTest ("Exponent modulo");
+
+        for (int i = 0; i < 50; ++i)
+        {
+            const BigInteger base (getRandomNumber (r, 600));
+            const BigInteger exponent (getRandomNumber (r, 64));
+            BigInteger modulus (getRandomNumber (r, 600));
+            modulus.setBit (0);
+
+            if (modulus.isOne())
+                modulus = 3;
+
+            BigInteger expected (1);
+
+            for (int bit = exponent.getHighestBit(); bit >= 0; --bit)
+            {
+                expected = (expected * expected) % modulus;
+
+                if (exponent [bit])
+                    expected = (expected * base) % modulus;
+            }
+
+            BigInteger result (base);
+            result.exponentModulo (exponent, modulus);
+            expect (result == expected);
+        }
+
+        {
+            // 2^127 - 1 is prime, so Fermat's little theorem applies..
+            BigInteger prime;
+            prime.setRange (0, 127, true);
+
+            BigInteger result (getRandomNumber (r, 120) + 2);
+            result.exponentModulo (prime - 1, prime);
+            expect (result.isOne());
+        }
+    }
+};
+
+static BigIntegerTests bigIntegerTests;
+
+#endif
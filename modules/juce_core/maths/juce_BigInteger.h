@@ -248,6 +248,9 @@ public:
 
     /** Performs a combined exponent and modulo operation.
         This BigInteger's value becomes (this ^ exponent) % modulus.
+
+        When the modulus is odd (as it is for RSA keys), this uses Montgomery
+        multiplication with a sliding window over the exponent's bits.
     */
     void exponentModulo (const BigInteger& exponent, const BigInteger& modulus);
 
@@ -315,6 +318,8 @@ private:
     bool negative;
 
     void ensureSize (size_t numVals);
+    void setWords (const uint32* words, size_t numWords);
+    void montgomeryExponentModulo (const BigInteger& exponent, const BigInteger& modulus);
     void shiftLeft (int bits, int startBit);
     void shiftRight (int bits, int startBit);
 
@@ -0,0 +1,346 @@
+/*
+  ==============================================================================
+
+   This file is part of the juce_core module of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission to use, copy, modify, and/or distribute this software for any purpose with
+   or without fee is hereby granted, provided that the above copyright notice and this
+   permission notice appear in all copies.
+
+   THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+   TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+   NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+   DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+   IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+   ------------------------------------------------------------------------------
+
+   NOTE! This permissive ISC license applies ONLY to files within the juce_core module!
+   All other JUCE modules are covered by a dual GPL/commercial license, so if you are
+   using any other modules, be sure to check that you also comply with their license.
+
+   For more details, visit www.juce.com
+
+  ==============================================================================
+*/
+
+CompiledExpression::CompiledExpression()
+    : isDirty (false)
+{
+}
+
+CompiledExpression::CompiledExpression (const Expression& e)
+    : expression (e), isDirty (true)
+{
+    Array<int> parents;
+    compile (expression, parents);
+
+    // Each symbol needs to know which nodes will be affected when its value changes,
+    // i.e. its own node, and all the nodes above that one..
+    for (int i = 0; i < nodes.size(); ++i)
+    {
+        const Node& node = nodes.getReference (i);
+
+        if (node.type == symbolNode)
+        {
+            Array<int>& dependents = symbols.getReference (node.input1).dependentNodes;
+
+            for (int n = i; n >= 0; n = parents.getUnchecked (n))
+                dependents.addIfNotAlreadyThere (n);
+        }
+    }
+}
+
+CompiledExpression::~CompiledExpression()
+{
+}
+
+//==============================================================================
+int CompiledExpression::compile (const Expression& e, Array<int>& parents)
+{
+    switch (e.getType())
+    {
+        case Expression::constantType:
+            return createNode (constantNode, 0, 0, e.evaluate(), parents);
+
+        case Expression::symbolType:
+            return createNode (symbolNode, getSlotFor (e.getSymbolOrFunction(), e), 0, 0, parents);
+
+        case Expression::operatorType:
+        {
+            const String op (e.getSymbolOrFunction());
+
+            // (a relative-scope reference like "parent.right" is treated as a single symbol)
+            if (op == ".")
+                return createNode (symbolNode, getSlotFor (e.toString(), e), 0, 0, parents);
+
+            if (e.getNumInputs() == 1)
+            {
+                const int input = compile (e.getInput (0), parents);
+                const int node = createNode (negateNode, input, 0, 0, parents);
+                parents.set (input, node);
+                return node;
+            }
+
+            jassert (e.getNumInputs() == 2);
+            const NodeType type = (op == "+") ? addNode
+                                : (op == "-") ? subtractNode
+                                : (op == "*") ? multiplyNode
+                                              : divideNode;
+
+            const int left  = compile (e.getInput (0), parents);
+            const int right = compile (e.getInput (1), parents);
+            const int node = createNode (type, left, right, 0, parents);
+            parents.set (left, node);
+            parents.set (right, node);
+            return node;
+        }
+
+        case Expression::functionType:
+        {
+            const int numParams = e.getNumInputs();
+            Array<int> params;
+
+            for (int i = 0; i < numParams; ++i)
+                params.add (compile (e.getInput (i), parents));
+
+            const int firstParam = functionParameters.size();
+            functionParameters.add (numParams);
+            functionParameters.addArray (params);
+
+            functionNames.add (e.getSymbolOrFunction());
+            const int node = createNode (functionNode, functionNames.size() - 1, firstParam, 0, parents);
+
+            for (int i = 0; i < numParams; ++i)
+                parents.set (params.getUnchecked (i), node);
+
+            return node;
+        }
+
+        default:
+            jassertfalse;
+            return createNode (constantNode, 0, 0, 0, parents);
+    }
+}
+
+int CompiledExpression::createNode (NodeType type, int input1, int input2, double value, Array<int>& parents)
+{
+    const Node node = { type, input1, input2, value, true };
+    nodes.add (node);
+    parents.add (-1);
+    return nodes.size() - 1;
+}
+
+int CompiledExpression::getSlotFor (const String& name, const Expression& e)
+{
+    const int existing = indexOfSymbol (name);
+
+    if (existing >= 0)
+        return existing;
+
+    SymbolSlot slot;
+    slot.name = name;
+    slot.expression = e;
+    slot.value = 0;
+    symbols.add (slot);
+    return symbols.size() - 1;
+}
+
+//==============================================================================
+String CompiledExpression::getSymbolName (int symbolIndex) const
+{
+    return isPositiveAndBelow (symbolIndex, symbols.size()) ? symbols.getReference (symbolIndex).name
+                                                            : String::empty;
+}
+
+int CompiledExpression::indexOfSymbol (const String& symbolName) const
+{
+    for (int i = 0; i < symbols.size(); ++i)
+        if (symbols.getReference (i).name == symbolName)
+            return i;
+
+    return -1;
+}
+
+double CompiledExpression::getSymbolValue (int symbolIndex) const noexcept
+{
+    jassert (isPositiveAndBelow (symbolIndex, symbols.size()));
+    return symbols.getReference (symbolIndex).value;
+}
+
+void CompiledExpression::setSymbolValue (int symbolIndex, double newValue) noexcept
+{
+    jassert (isPositiveAndBelow (symbolIndex, symbols.size()));
+    SymbolSlot& slot = symbols.getReference (symbolIndex);
+
+    if (slot.value != newValue)
+    {
+        slot.value = newValue;
+
+        for (int i = slot.dependentNodes.size(); --i >= 0;)
+            nodes.getReference (slot.dependentNodes.getUnchecked (i)).isDirty = true;
+
+        isDirty = true;
+    }
+}
+
+bool CompiledExpression::updateSymbolValues (const Expression::Scope& scope)
+{
+    const bool wasDirty = isDirty;
+    isDirty = false;
+
+    for (int i = 0; i < symbols.size(); ++i)
+    {
+        String error;
+        setSymbolValue (i, symbols.getReference (i).expression.evaluate (scope, error));
+    }
+
+    const bool changed = isDirty;
+    isDirty = isDirty || wasDirty;
+    return changed;
+}
+
+//==============================================================================
+double CompiledExpression::evaluate()
+{
+    return evaluate (Expression::Scope());
+}
+
+double CompiledExpression::evaluate (const Expression::Scope& functionScope)
+{
+    if (nodes.size() == 0)
+        return 0;
+
+    if (isDirty)
+    {
+        try
+        {
+            // (the inputs to each node always come before it, so a single pass is enough)
+            for (int i = 0; i < nodes.size(); ++i)
+            {
+                Node& node = nodes.getReference (i);
+
+                if (node.isDirty)
+                {
+                    node.value = calculate (node, functionScope);
+                    node.isDirty = false;
+                }
+            }
+        }
+        catch (std::exception&)
+        {
+            return 0; // (the failed nodes are left dirty, so they'll be retried next time)
+        }
+
+        isDirty = false;
+    }
+
+    return nodes.getLast().value;
+}
+
+double CompiledExpression::calculate (const Node& node, const Expression::Scope& functionScope)
+{
+    switch (node.type)
+    {
+        case symbolNode:    return symbols.getReference (node.input1).value;
+        case addNode:       return nodes.getReference (node.input1).value + nodes.getReference (node.input2).value;
+        case subtractNode:  return nodes.getReference (node.input1).value - nodes.getReference (node.input2).value;
+        case multiplyNode:  return nodes.getReference (node.input1).value * nodes.getReference (node.input2).value;
+        case divideNode:    return nodes.getReference (node.input1).value / nodes.getReference (node.input2).value;
+        case negateNode:    return -nodes.getReference (node.input1).value;
+
+        case functionNode:
+        {
+            const int numParams = functionParameters.getUnchecked (node.input2);
+            parameterValues.clearQuick();
+
+            for (int i = 0; i < numParams; ++i)
+                parameterValues.add (nodes.getReference (functionParameters.getUnchecked (node.input2 + 1 + i)).value);
+
+            return functionScope.evaluateFunction (functionNames [node.input1],
+                                                   parameterValues.getRawDataPointer(), numParams);
+        }
+
+        default:
+            return node.value;
+    }
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class CompiledExpressionTests  : public UnitTest
+{
+public:
+    CompiledExpressionTests() : UnitTest ("CompiledExpression") {}
+
+    struct TestScope  : public Expression::Scope
+    {
+        TestScope() : x (3.0), y (-2.5) {}
+
+        Expression getSymbolValue (const String& symbol) const
+        {
+            if (symbol == "x")  return Expression (x);
+            if (symbol == "y")  return Expression (y);
+            if (symbol == "xy") return Expression ("x * y");
+
+            return Expression::Scope::getSymbolValue (symbol);
+        }
+
+        double x, y;
+    };
+
+    void checkMatches (const String& text, TestScope& scope)
+    {
+        const Expression e (text);
+        CompiledExpression compiled (e);
+
+        compiled.updateSymbolValues (scope);
+        expectEquals (compiled.evaluate (scope), e.evaluate (scope));
+
+        scope.x = 7.25;
+        expect (compiled.updateSymbolValues (scope) == (compiled.indexOfSymbol ("x") >= 0 || compiled.indexOfSymbol ("xy") >= 0));
+        expectEquals (compiled.evaluate (scope), e.evaluate (scope));
+
+        expect (! compiled.updateSymbolValues (scope));
+        expect (! compiled.needsEvaluating());
+        expectEquals (compiled.evaluate (scope), e.evaluate (scope));
+
+        scope.x = 3.0;
+    }
+
+    void runTest()
+    {
+        beginTest ("Evaluation");
+
+        TestScope scope;
+        checkMatches ("1 + 2 * 3", scope);
+        checkMatches ("x", scope);
+        checkMatches ("-(x - y) / 4", scope);
+        checkMatches ("x * (y + 1) - x", scope);
+        checkMatches ("max (x, y, 10 - x) + min (y, 2)", scope);
+        checkMatches ("xy + y", scope);
+        checkMatches ("abs (y) * sin (x)", scope);
+
+        beginTest ("Symbols");
+
+        CompiledExpression compiled (Expression ("a * b + a"));
+        expectEquals (compiled.getNumSymbols(), 2);
+        expectEquals (compiled.getSymbolName (compiled.indexOfSymbol ("b")), String ("b"));
+        expectEquals (compiled.indexOfSymbol ("c"), -1);
+
+        compiled.setSymbolValue (compiled.indexOfSymbol ("a"), 2.0);
+        compiled.setSymbolValue (compiled.indexOfSymbol ("b"), 5.0);
+        expectEquals (compiled.evaluate(), 12.0);
+
+        compiled.setSymbolValue (compiled.indexOfSymbol ("b"), 1.0);
+        expect (compiled.needsEvaluating());
+        expectEquals (compiled.evaluate(), 4.0);
+    }
+};
+
+static CompiledExpressionTests compiledExpressionTests;
+
+#endif
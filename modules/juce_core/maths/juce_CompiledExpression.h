@@ -0,0 +1,157 @@
+/*
+  ==============================================================================
+
+   This file is part of the juce_core module of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission to use, copy, modify, and/or distribute this software for any purpose with
+   or without fee is hereby granted, provided that the above copyright notice and this
+   permission notice appear in all copies.
+
+   THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+   TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+   NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+   DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+   IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+   ------------------------------------------------------------------------------
+
+   NOTE! This permissive ISC license applies ONLY to files within the juce_core module!
+   All other JUCE modules are covered by a dual GPL/commercial license, so if you are
+   using any other modules, be sure to check that you also comply with their license.
+
+   For more details, visit www.juce.com
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_COMPILEDEXPRESSION_JUCEHEADER__
+#define __JUCE_COMPILEDEXPRESSION_JUCEHEADER__
+
+#include "juce_Expression.h"
+
+
+//==============================================================================
+/**
+    A pre-processed form of an Expression, for evaluating it repeatedly.
+
+    When an Expression is evaluated, it walks its tree of terms, creating temporary
+    objects for all the intermediate results, and looks up each symbol by name. A
+    CompiledExpression flattens the tree into an array once, and gives each of the
+    symbols it uses a numbered slot, which you fill in with setSymbolValue() or
+    updateSymbolValues().
+
+    It also caches the results of all its sub-expressions, so when evaluate() is called
+    after some of the symbols have changed, only the parts of the expression that depend
+    on those symbols are recalculated, and if none have changed, it just returns the
+    previous result.
+
+    A symbol that refers to another scope, like "parent.right", gets a single slot, whose
+    name is the whole dotted string.
+
+    Function calls are made to the Scope that's passed to evaluate(), and their results
+    are cached as well, so they're assumed to depend only on their parameters.
+
+    @see Expression
+*/
+class JUCE_API  CompiledExpression
+{
+public:
+    //==============================================================================
+    /** Creates an empty CompiledExpression, which evaluates to 0. */
+    CompiledExpression();
+
+    /** Compiles an expression. */
+    explicit CompiledExpression (const Expression& expression);
+
+    /** Destructor. */
+    ~CompiledExpression();
+
+    /** Returns the expression that was compiled. */
+    const Expression& getExpression() const noexcept        { return expression; }
+
+    //==============================================================================
+    /** Returns the number of symbols that the expression uses. */
+    int getNumSymbols() const noexcept                      { return symbols.size(); }
+
+    /** Returns the name of one of the expression's symbols. */
+    String getSymbolName (int symbolIndex) const;
+
+    /** Returns the slot used by a symbol, or -1 if the expression doesn't use it. */
+    int indexOfSymbol (const String& symbolName) const;
+
+    /** Returns the value that was last given to a symbol. */
+    double getSymbolValue (int symbolIndex) const noexcept;
+
+    /** Sets the value of one of the symbols.
+        If the value has changed, the sub-expressions that use it will be recalculated
+        the next time that evaluate() is called.
+    */
+    void setSymbolValue (int symbolIndex, double newValue) noexcept;
+
+    /** Looks up the values of all the symbols in a scope, and updates any that have changed.
+        This is the equivalent of calling setSymbolValue() for each one.
+        @returns true if any of the values changed
+    */
+    bool updateSymbolValues (const Expression::Scope& scope);
+
+    //==============================================================================
+    /** Returns true if any symbols have changed since the last call to evaluate(). */
+    bool needsEvaluating() const noexcept                   { return isDirty; }
+
+    /** Evaluates the expression, using the current symbol values. */
+    double evaluate();
+
+    /** Evaluates the expression, using the current symbol values, and calling the given
+        scope to perform any functions that it uses.
+    */
+    double evaluate (const Expression::Scope& functionScope);
+
+private:
+    //==============================================================================
+    enum NodeType
+    {
+        constantNode,
+        symbolNode,
+        addNode,
+        subtractNode,
+        multiplyNode,
+        divideNode,
+        negateNode,
+        functionNode
+    };
+
+    struct Node
+    {
+        NodeType type;
+        int input1, input2;     // (for a symbol, this is its slot, and for a function, its name and parameters)
+        double value;
+        bool isDirty;
+    };
+
+    struct SymbolSlot
+    {
+        String name;
+        Expression expression;
+        double value;
+        Array<int> dependentNodes;
+    };
+
+    Expression expression;
+    Array<Node> nodes;
+    Array<SymbolSlot> symbols;
+    StringArray functionNames;
+    Array<int> functionParameters;
+    Array<double> parameterValues;
+    bool isDirty;
+
+    int compile (const Expression&, Array<int>& parents);
+    int createNode (NodeType, int input1, int input2, double value, Array<int>& parents);
+    int getSlotFor (const String& name, const Expression&);
+    double calculate (const Node&, const Expression::Scope&);
+
+    JUCE_LEAK_DETECTOR (CompiledExpression)
+};
+
+#endif   // __JUCE_COMPILEDEXPRESSION_JUCEHEADER__
@@ -0,0 +1,373 @@
+/*
+  ==============================================================================
+
+   This file is part of the juce_core module of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission to use, copy, modify, and/or distribute this software for any purpose with
+   or without fee is hereby granted, provided that the above copyright notice and this
+   permission notice appear in all copies.
+
+   THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+   TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+   NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+   DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+   IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+   ------------------------------------------------------------------------------
+
+   NOTE! This permissive ISC license applies ONLY to files within the juce_core module!
+   All other JUCE modules are covered by a dual GPL/commercial license, so if you are
+   using any other modules, be sure to check that you also comply with their license.
+
+   For more details, visit www.juce.com
+
+  ==============================================================================
+*/
+
+namespace FastRandomHelpers
+{
+    static inline uint32 rotateLeft (const uint32 x, const int bits) noexcept
+    {
+        return (x << bits) | (x >> (32 - bits));
+    }
+
+    // Used to spread the seed over the generators' state, as recommended by xoshiro's authors.
+    static inline uint64 splitMix64 (uint64& state) noexcept
+    {
+        uint64 z = (state += literal64bit (0x9e3779b97f4a7c15));
+        z = (z ^ (z >> 30)) * literal64bit (0xbf58476d1ce4e5b9);
+        z = (z ^ (z >> 27)) * literal64bit (0x94d049bb133111eb);
+        return z ^ (z >> 31);
+    }
+
+    // Turns the top 24 bits of a value into a float in the range 0 to 1.0 (exclusive).
+    static inline float toFloat (const uint32 n) noexcept
+    {
+        return (float) (int) (n >> 8) * (1.0f / 16777216.0f);
+    }
+
+    enum { blockSize = 256 };
+}
+
+//==============================================================================
+FastRandom::FastRandom (const int64 seedValue) noexcept
+{
+    setSeed (seedValue);
+}
+
+FastRandom::FastRandom()
+{
+    setSeed (Random().nextInt64());
+}
+
+FastRandom::~FastRandom() noexcept
+{
+}
+
+void FastRandom::setSeed (const int64 newSeed) noexcept
+{
+    uint64 state = (uint64) newSeed;
+
+    for (int i = 0; i < numLanes; ++i)
+    {
+        const uint64 a = FastRandomHelpers::splitMix64 (state);
+        const uint64 b = FastRandomHelpers::splitMix64 (state);
+
+        s0[i] = (uint32) a;
+        s1[i] = (uint32) (a >> 32);
+        s2[i] = (uint32) b;
+        s3[i] = (uint32) (b >> 32);
+
+        if ((s0[i] | s1[i] | s2[i] | s3[i]) == 0) // (an all-zero state would get stuck)
+            s0[i] = 1;
+    }
+
+    nextBuffered = numLanes;
+}
+
+void FastRandom::generateBlocks (uint32* dest, int numBlocks) noexcept
+{
+    using FastRandomHelpers::rotateLeft;
+
+    // Working on local copies lets the compiler keep the state in registers.
+    uint32 a[numLanes], b[numLanes], c[numLanes], d[numLanes];
+
+    for (int i = 0; i < numLanes; ++i)
+    {
+        a[i] = s0[i];
+        b[i] = s1[i];
+        c[i] = s2[i];
+        d[i] = s3[i];
+    }
+
+    while (--numBlocks >= 0)
+    {
+        for (int i = 0; i < numLanes; ++i)
+        {
+            dest[i] = rotateLeft (a[i] + d[i], 7) + a[i];
+
+            const uint32 t = b[i] << 9;
+            c[i] ^= a[i];
+            d[i] ^= b[i];
+            b[i] ^= c[i];
+            a[i] ^= d[i];
+            c[i] ^= t;
+            d[i] = rotateLeft (d[i], 11);
+        }
+
+        dest += numLanes;
+    }
+
+    for (int i = 0; i < numLanes; ++i)
+    {
+        s0[i] = a[i];
+        s1[i] = b[i];
+        s2[i] = c[i];
+        s3[i] = d[i];
+    }
+}
+
+//==============================================================================
+uint32 FastRandom::nextUInt32() noexcept
+{
+    if (nextBuffered >= numLanes)
+    {
+        generateBlocks (buffered, 1);
+        nextBuffered = 0;
+    }
+
+    return buffered [nextBuffered++];
+}
+
+int FastRandom::nextInt (const int maxValue) noexcept
+{
+    jassert (maxValue > 0);
+    return (int) ((nextUInt32() * (uint64) maxValue) >> 32);
+}
+
+float FastRandom::nextFloat() noexcept
+{
+    return FastRandomHelpers::toFloat (nextUInt32());
+}
+
+void FastRandom::fillUInt32 (uint32* dest, int numValues) noexcept
+{
+    while (numValues > 0 && nextBuffered < numLanes)
+    {
+        *dest++ = buffered [nextBuffered++];
+        --numValues;
+    }
+
+    const int numBlocks = numValues / numLanes;
+    generateBlocks (dest, numBlocks);
+    dest += numBlocks * numLanes;
+    numValues -= numBlocks * numLanes;
+
+    while (--numValues >= 0)
+        *dest++ = nextUInt32();
+}
+
+//==============================================================================
+void FastRandom::fillUniform (float* dest, int numValues, const float minValue, const float maxValue) noexcept
+{
+    const float range = maxValue - minValue;
+    uint32 raw [FastRandomHelpers::blockSize];
+
+    while (numValues > 0)
+    {
+        const int num = jmin (numValues, (int) FastRandomHelpers::blockSize);
+        fillUInt32 (raw, num);
+
+        for (int i = 0; i < num; ++i)
+            dest[i] = minValue + range * FastRandomHelpers::toFloat (raw[i]);
+
+        dest += num;
+        numValues -= num;
+    }
+}
+
+void FastRandom::fillTPDF (float* dest, int numValues, const float amplitude) noexcept
+{
+    const float scale = amplitude * (1.0f / 16777216.0f);
+    uint32 raw [FastRandomHelpers::blockSize];
+
+    while (numValues > 0)
+    {
+        const int num = jmin (numValues, (int) FastRandomHelpers::blockSize / 2);
+        fillUInt32 (raw, num * 2);
+
+        for (int i = 0; i < num; ++i)
+            dest[i] = scale * (float) ((int) (raw [2 * i] >> 8) - (int) (raw [2 * i + 1] >> 8));
+
+        dest += num;
+        numValues -= num;
+    }
+}
+
+void FastRandom::fillGaussian (float* dest, int numValues, const float mean, const float standardDeviation) noexcept
+{
+    const double twoPi = 2.0 * double_Pi;
+    uint32 raw [FastRandomHelpers::blockSize];
+
+    while (numValues > 0)
+    {
+        const int numPairs = jmin ((numValues + 1) / 2, (int) FastRandomHelpers::blockSize / 2);
+        fillUInt32 (raw, numPairs * 2);
+
+        for (int i = 0; i < numPairs; ++i)
+        {
+            // (u1 is in the range (0, 1], so the log can't blow up)
+            const double u1 = ((raw [2 * i] >> 8) + 1) * (1.0 / 16777216.0);
+            const double angle = FastRandomHelpers::toFloat (raw [2 * i + 1]) * twoPi;
+            const double radius = standardDeviation * std::sqrt (-2.0 * std::log (u1));
+
+            dest [2 * i] = (float) (mean + radius * std::cos (angle));
+
+            if (2 * i + 1 < numValues)
+                dest [2 * i + 1] = (float) (mean + radius * std::sin (angle));
+        }
+
+        dest += numPairs * 2;
+        numValues -= numPairs * 2;
+    }
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class FastRandomTests  : public UnitTest
+{
+public:
+    FastRandomTests() : UnitTest ("FastRandom") {}
+
+    void runTest()
+    {
+        beginTest ("Ranges");
+
+        {
+            FastRandom r (12345);
+
+            for (int i = 1000; --i >= 0;)
+            {
+                const float f = r.nextFloat();
+                expect (f >= 0.0f && f < 1.0f);
+
+                const int n = r.nextInt (7);
+                expect (n >= 0 && n < 7);
+                expect (r.nextInt (1) == 0);
+            }
+        }
+
+        beginTest ("Repeatability");
+
+        {
+            FastRandom r1 (999), r2 (999), r3 (1000);
+            HeapBlock<uint32> a (1000), b (1000), c (1000);
+
+            r1.fillUInt32 (a, 1000);
+
+            // splitting the stream up in odd ways, and mixing in single values, gives the same results..
+            for (int i = 0; i < 1000;)
+            {
+                if ((i % 3) == 0)
+                {
+                    b[i++] = r2.nextUInt32();
+                }
+                else
+                {
+                    const int num = jmin (1000 - i, 1 + i % 11);
+                    r2.fillUInt32 (b + i, num);
+                    i += num;
+                }
+            }
+
+            r3.fillUInt32 (c, 1000);
+
+            expect (memcmp (a, b, sizeof (uint32) * 1000) == 0);
+            expect (memcmp (a, c, sizeof (uint32) * 1000) != 0);
+        }
+
+        beginTest ("Uniform");
+
+        {
+            const int num = 100000;
+            HeapBlock<float> data (num);
+            FastRandom r (1);
+            r.fillUniform (data, num, -2.0f, 3.0f);
+
+            int buckets[5] = { 0 };
+            double sum = 0;
+
+            for (int i = 0; i < num; ++i)
+            {
+                expect (data[i] >= -2.0f && data[i] < 3.0f);
+                ++buckets [jlimit (0, 4, (int) std::floor (data[i] + 2.0f))];
+                sum += data[i];
+            }
+
+            expect (std::abs (sum / num - 0.5) < 0.05);
+
+            for (int i = 0; i < 5; ++i)
+                expect (std::abs (buckets[i] - num / 5) < num / 50);
+        }
+
+        beginTest ("TPDF");
+
+        {
+            const int num = 100000;
+            HeapBlock<float> data (num), data2 (num);
+            FastRandom r (2), r2 (2);
+            r.fillTPDF (data, num, 1.0f);
+            r2.fillTPDF (data2, 123, 1.0f);
+            r2.fillTPDF (data2 + 123, num - 123, 1.0f);
+
+            int numInCentre = 0;
+            double sum = 0;
+
+            for (int i = 0; i < num; ++i)
+            {
+                expect (data[i] > -1.0f && data[i] < 1.0f);
+                sum += data[i];
+
+                if (std::abs (data[i]) < 0.5f)
+                    ++numInCentre;
+            }
+
+            // a triangular distribution has 3/4 of its values within half its width of the centre
+            expect (std::abs (sum / num) < 0.01);
+            expect (std::abs (numInCentre - num * 3 / 4) < num / 50);
+            expect (memcmp (data, data2, sizeof (float) * (size_t) num) == 0);
+        }
+
+        beginTest ("Gaussian");
+
+        {
+            const int num = 100000;
+            HeapBlock<float> data (num);
+            FastRandom r (3);
+            r.fillGaussian (data, num - 1, 10.0f, 2.0f);
+
+            double sum = 0, sumOfSquares = 0;
+            int numWithinOneDeviation = 0;
+
+            for (int i = 0; i < num - 1; ++i)
+            {
+                sum += data[i];
+                sumOfSquares += (data[i] - 10.0) * (data[i] - 10.0);
+
+                if (std::abs (data[i] - 10.0f) < 2.0f)
+                    ++numWithinOneDeviation;
+            }
+
+            expect (std::abs (sum / (num - 1) - 10.0) < 0.05);
+            expect (std::abs (std::sqrt (sumOfSquares / (num - 1)) - 2.0) < 0.05);
+            expect (std::abs (numWithinOneDeviation / (double) (num - 1) - 0.6827) < 0.01);
+        }
+    }
+};
+
+static FastRandomTests fastRandomTests;
+
+#endif
@@ -0,0 +1,125 @@
+/*
+  ==============================================================================
+
+   This file is part of the juce_core module of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission to use, copy, modify, and/or distribute this software for any purpose with
+   or without fee is hereby granted, provided that the above copyright notice and this
+   permission notice appear in all copies.
+
+   THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+   TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+   NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+   DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+   IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+   ------------------------------------------------------------------------------
+
+   NOTE! This permissive ISC license applies ONLY to files within the juce_core module!
+   All other JUCE modules are covered by a dual GPL/commercial license, so if you are
+   using any other modules, be sure to check that you also comply with their license.
+
+   For more details, visit www.juce.com
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_FASTRANDOM_JUCEHEADER__
+#define __JUCE_FASTRANDOM_JUCEHEADER__
+
+
+//==============================================================================
+/**
+    A fast, high-quality random number generator, designed for filling large blocks of
+    audio with noise.
+
+    This uses four interleaved xoshiro128++ generators, which have a much longer period
+    and much better statistical properties than the simple LCG inside the Random class.
+    The four generators are stepped together, so the bulk-fill methods compile down to
+    vector instructions on any compiler that can auto-vectorise a fixed-length loop.
+
+    All the methods draw from the same stream of numbers, and the bulk methods give the
+    same results however a buffer is split up, so e.g. filling 1000 samples in one call
+    produces exactly the same noise as filling them in blocks of 100. (The only exception
+    is fillGaussian(), which uses values in pairs - see its description).
+
+    Like Random, this isn't thread-safe, so each thread should use its own object.
+
+    @see Random
+*/
+class JUCE_API  FastRandom
+{
+public:
+    //==============================================================================
+    /** Creates a FastRandom object based on a seed value.
+        For a given seed value, the numbers generated will always be the same.
+    */
+    explicit FastRandom (int64 seedValue) noexcept;
+
+    /** Creates a FastRandom object with a seed taken from a randomly-seeded Random object. */
+    FastRandom();
+
+    /** Destructor. */
+    ~FastRandom() noexcept;
+
+    //==============================================================================
+    /** Resets the generator to a given seed value. */
+    void setSeed (int64 newSeed) noexcept;
+
+    /** Returns the next random 32-bit unsigned value. */
+    uint32 nextUInt32() noexcept;
+
+    /** Returns the next random number, limited to a given range.
+        The maxValue parameter may not be negative, or zero.
+        @returns a random integer between 0 (inclusive) and maxValue (exclusive).
+    */
+    int nextInt (int maxValue) noexcept;
+
+    /** Returns the next random floating-point number.
+        @returns a random value in the range 0 (inclusive) to 1.0 (exclusive)
+    */
+    float nextFloat() noexcept;
+
+    //==============================================================================
+    /** Fills a buffer with random values evenly distributed between minValue (inclusive)
+        and maxValue (exclusive).
+    */
+    void fillUniform (float* dest, int numValues, float minValue, float maxValue) noexcept;
+
+    /** Fills a buffer with normally-distributed random values.
+
+        This uses the Box-Muller transform, which turns each pair of uniform values into
+        a pair of gaussian ones. If numValues is odd, the second value of the last pair is
+        thrown away, so to get the same results when splitting a stream into blocks, use
+        blocks of an even size.
+    */
+    void fillGaussian (float* dest, int numValues, float mean, float standardDeviation) noexcept;
+
+    /** Fills a buffer with triangular-PDF dither noise.
+
+        Each value is the difference between two uniform random values, so the results
+        lie between -amplitude and +amplitude, with a triangular distribution centred on
+        zero. For dithering a conversion to integers, use an amplitude of 1 LSB.
+    */
+    void fillTPDF (float* dest, int numValues, float amplitude) noexcept;
+
+    /** Fills a buffer with raw random 32-bit values. */
+    void fillUInt32 (uint32* dest, int numValues) noexcept;
+
+private:
+    //==============================================================================
+    enum { numLanes = 4 };
+
+    uint32 s0[numLanes], s1[numLanes], s2[numLanes], s3[numLanes];
+    uint32 buffered[numLanes];
+    int nextBuffered;
+
+    void generateBlocks (uint32* dest, int numBlocks) noexcept;
+
+    JUCE_LEAK_DETECTOR (FastRandom)
+};
+
+
+#endif   // __JUCE_FASTRANDOM_JUCEHEADER__
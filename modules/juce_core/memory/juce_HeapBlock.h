@@ -40,6 +40,34 @@ namespace HeapBlockHelper
 }
 #endif
 
+//==============================================================================
+#if JUCE_BENCHMARK_COUNT_ALLOCATIONS
+ /** Used by the Benchmark class to count allocations. */
+ JUCE_API void JUCE_CALLTYPE juce_countBenchmarkAllocation() noexcept;
+ #define JUCE_COUNT_BENCHMARK_ALLOCATION    juce_countBenchmarkAllocation();
+#else
+ #define JUCE_COUNT_BENCHMARK_ALLOCATION
+#endif
+
+//==============================================================================
+/**
+    The default allocation policy used by HeapBlock and the array classes, which
+    simply calls the standard malloc/calloc/realloc/free functions.
+
+    An allocation policy is a class with these four static methods, and it can be
+    passed as a template parameter to HeapBlock, Array, OwnedArray, etc. to change
+    where their storage comes from.
+
+    @see HeapBlock, ArenaAllocationPolicy
+*/
+struct StandardAllocationPolicy
+{
+    static void* allocate (size_t numBytes)                                 { JUCE_COUNT_BENCHMARK_ALLOCATION return std::malloc (numBytes); }
+    static void* allocateZeroed (size_t numElements, size_t elementSize)    { JUCE_COUNT_BENCHMARK_ALLOCATION return std::calloc (numElements, elementSize); }
+    static void* reallocate (void* data, size_t numBytes)                   { JUCE_COUNT_BENCHMARK_ALLOCATION return std::realloc (data, numBytes); }
+    static void release (void* data)                                        { std::free (data); }
+};
+
 //==============================================================================
 /**
     Very simple container class to hold a pointer to some data on the heap.
@@ -84,9 +112,12 @@ namespace HeapBlockHelper
     then a failed allocation will just leave the heapblock with a null pointer (assuming
     that the system's malloc() function doesn't throw).
 
+    The AllocationPolicy template parameter lets you supply a class that provides the
+    underlying memory - see StandardAllocationPolicy for the functions that it needs.
+
     @see Array, OwnedArray, MemoryBlock
 */
-template <class ElementType, bool throwOnFailure = false>
+template <class ElementType, bool throwOnFailure = false, class AllocationPolicy = StandardAllocationPolicy>
 class HeapBlock
 {
 public:
@@ -109,7 +140,7 @@ public:
         other constructor that takes an InitialisationState parameter.
     */
     explicit HeapBlock (const size_t numElements)
-        : data (static_cast <ElementType*> (std::malloc (numElements * sizeof (ElementType))))
+        : data (static_cast <ElementType*> (AllocationPolicy::allocate (numElements * sizeof (ElementType))))
     {
         throwOnAllocationFailure();
     }
@@ -121,8 +152,8 @@ public:
     */
     HeapBlock (const size_t numElements, const bool initialiseToZero)
         : data (static_cast <ElementType*> (initialiseToZero
-                                               ? std::calloc (numElements, sizeof (ElementType))
-                                               : std::malloc (numElements * sizeof (ElementType))))
+                                               ? AllocationPolicy::allocateZeroed (numElements, sizeof (ElementType))
+                                               : AllocationPolicy::allocate (numElements * sizeof (ElementType))))
     {
         throwOnAllocationFailure();
     }
@@ -132,7 +163,7 @@ public:
     */
     ~HeapBlock()
     {
-        std::free (data);
+        AllocationPolicy::release (data);
     }
 
    #if JUCE_COMPILER_SUPPORTS_MOVE_SEMANTICS
@@ -219,8 +250,8 @@ public:
     */
     void malloc (const size_t newNumElements, const size_t elementSize = sizeof (ElementType))
     {
-        std::free (data);
-        data = static_cast <ElementType*> (std::malloc (newNumElements * elementSize));
+        AllocationPolicy::release (data);
+        data = static_cast <ElementType*> (AllocationPolicy::allocate (newNumElements * elementSize));
         throwOnAllocationFailure();
     }
 
@@ -229,8 +260,8 @@ public:
     */
     void calloc (const size_t newNumElements, const size_t elementSize = sizeof (ElementType))
     {
-        std::free (data);
-        data = static_cast <ElementType*> (std::calloc (newNumElements, elementSize));
+        AllocationPolicy::release (data);
+        data = static_cast <ElementType*> (AllocationPolicy::allocateZeroed (newNumElements, elementSize));
         throwOnAllocationFailure();
     }
 
@@ -240,10 +271,10 @@ public:
     */
     void allocate (const size_t newNumElements, bool initialiseToZero)
     {
-        std::free (data);
+        AllocationPolicy::release (data);
         data = static_cast <ElementType*> (initialiseToZero
-                                             ? std::calloc (newNumElements, sizeof (ElementType))
-                                             : std::malloc (newNumElements * sizeof (ElementType)));
+                                             ? AllocationPolicy::allocateZeroed (newNumElements, sizeof (ElementType))
+                                             : AllocationPolicy::allocate (newNumElements * sizeof (ElementType)));
         throwOnAllocationFailure();
     }
 
@@ -254,8 +285,8 @@ public:
     */
     void realloc (const size_t newNumElements, const size_t elementSize = sizeof (ElementType))
     {
-        data = static_cast <ElementType*> (data == nullptr ? std::malloc (newNumElements * elementSize)
-                                                           : std::realloc (data, newNumElements * elementSize));
+        data = static_cast <ElementType*> (data == nullptr ? AllocationPolicy::allocate (newNumElements * elementSize)
+                                                           : AllocationPolicy::reallocate (data, newNumElements * elementSize));
         throwOnAllocationFailure();
     }
 
@@ -264,7 +295,7 @@ public:
     */
     void free()
     {
-        std::free (data);
+        AllocationPolicy::release (data);
         data = nullptr;
     }
 
@@ -272,7 +303,7 @@ public:
         The two objects simply exchange their data pointers.
     */
     template <bool otherBlockThrows>
-    void swapWith (HeapBlock <ElementType, otherBlockThrows>& other) noexcept
+    void swapWith (HeapBlock <ElementType, otherBlockThrows, AllocationPolicy>& other) noexcept
     {
         std::swap (data, other.data);
     }
@@ -0,0 +1,201 @@
+/*
+  ==============================================================================
+
+   This file is part of the juce_core module of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission to use, copy, modify, and/or distribute this software for any purpose with
+   or without fee is hereby granted, provided that the above copyright notice and this
+   permission notice appear in all copies.
+
+   THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+   TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+   NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+   DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+   IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+   ------------------------------------------------------------------------------
+
+   NOTE! This permissive ISC license applies ONLY to files within the juce_core module!
+   All other JUCE modules are covered by a dual GPL/commercial license, so if you are
+   using any other modules, be sure to check that you also comply with their license.
+
+   For more details, visit www.juce.com
+
+  ==============================================================================
+*/
+
+namespace MemoryArenaHelpers
+{
+    // This lets the allocation policy skip the thread-local lookup when no arena is in use anywhere.
+    static Atomic<int> numActiveScopes;
+
+    static ThreadLocalValue<MemoryArena*>& getCurrentArena()
+    {
+        static ThreadLocalValue<MemoryArena*> currentArena;
+        return currentArena;
+    }
+
+    struct BlockHeader
+    {
+        MemoryArena* arena;
+        size_t size;
+    };
+
+    enum { headerSize = (sizeof (BlockHeader) + 15) & ~15 };
+
+    static inline BlockHeader* getHeader (void* data) noexcept
+    {
+        return reinterpret_cast <BlockHeader*> (static_cast <char*> (data) - headerSize);
+    }
+}
+
+//==============================================================================
+MemoryArena::MemoryArena (const size_t blockSizeInBytes)
+    : position (nullptr),
+      numBytesLeftInBlock (0),
+      numBytesReserved (0),
+      blockSize (jmax ((size_t) 1024, blockSizeInBytes))
+{
+}
+
+MemoryArena::~MemoryArena()
+{
+    for (int i = blocks.size(); --i >= 0;)
+        std::free (blocks.getUnchecked (i));
+}
+
+void* MemoryArena::allocate (size_t numBytes)
+{
+    numBytes = (numBytes + 15) & ~(size_t) 15;
+
+    if (numBytes > numBytesLeftInBlock)
+    {
+        const bool needsOwnBlock = numBytes > blockSize / 4;
+        const size_t newBlockSize = needsOwnBlock ? numBytes : blockSize;
+
+        char* const newBlock = static_cast <char*> (std::malloc (newBlockSize));
+
+        if (newBlock == nullptr)
+            return nullptr;
+
+        blocks.add (newBlock);
+        numBytesReserved += newBlockSize;
+
+        // a big allocation gets a block to itself, so that the rest of the current block isn't wasted
+        if (needsOwnBlock)
+            return newBlock;
+
+        position = newBlock;
+        numBytesLeftInBlock = newBlockSize;
+    }
+
+    void* const result = position;
+    position += numBytes;
+    numBytesLeftInBlock -= numBytes;
+    return result;
+}
+
+MemoryArena* MemoryArena::getCurrent() noexcept
+{
+    return MemoryArenaHelpers::numActiveScopes.get() > 0 ? MemoryArenaHelpers::getCurrentArena().get()
+                                                         : nullptr;
+}
+
+//==============================================================================
+MemoryArena::ScopedUse::ScopedUse (MemoryArena* const arenaToUse)
+    : arena (arenaToUse),
+      previous (MemoryArenaHelpers::getCurrentArena().get())
+{
+    MemoryArenaHelpers::getCurrentArena() = arenaToUse;
+    ++MemoryArenaHelpers::numActiveScopes;
+}
+
+MemoryArena::ScopedUse::~ScopedUse()
+{
+    --MemoryArenaHelpers::numActiveScopes;
+    MemoryArenaHelpers::getCurrentArena() = previous;
+}
+
+//==============================================================================
+void* ArenaAllocationPolicy::allocate (const size_t numBytes)
+{
+    using namespace MemoryArenaHelpers;
+
+    MemoryArena* const arena = MemoryArena::getCurrent();
+
+    char* const block = static_cast <char*> (arena != nullptr ? arena->allocate (numBytes + headerSize)
+                                                              : std::malloc (numBytes + headerSize));
+    if (block == nullptr)
+        return nullptr;
+
+    BlockHeader* const header = reinterpret_cast <BlockHeader*> (block);
+    header->arena = arena;
+    header->size = numBytes;
+
+    if (arena != nullptr)
+        arena->incReferenceCount();
+
+    return block + headerSize;
+}
+
+void* ArenaAllocationPolicy::allocateZeroed (const size_t numElements, const size_t elementSize)
+{
+    const size_t numBytes = numElements * elementSize;
+    void* const data = allocate (numBytes);
+
+    if (data != nullptr)
+        zeromem (data, numBytes);
+
+    return data;
+}
+
+void* ArenaAllocationPolicy::reallocate (void* const data, const size_t numBytes)
+{
+    using namespace MemoryArenaHelpers;
+
+    if (data == nullptr)
+        return allocate (numBytes);
+
+    BlockHeader* const header = getHeader (data);
+
+    if (header->arena == nullptr)
+    {
+        char* const block = static_cast <char*> (std::realloc (header, numBytes + headerSize));
+
+        if (block == nullptr)
+            return nullptr;
+
+        reinterpret_cast <BlockHeader*> (block)->size = numBytes;
+        return block + headerSize;
+    }
+
+    if (numBytes <= header->size)
+        return data;
+
+    void* const newData = allocate (numBytes);
+
+    if (newData != nullptr)
+    {
+        memcpy (newData, data, header->size);
+        release (data);
+    }
+
+    return newData;
+}
+
+void ArenaAllocationPolicy::release (void* const data)
+{
+    using namespace MemoryArenaHelpers;
+
+    if (data != nullptr)
+    {
+        BlockHeader* const header = getHeader (data);
+
+        if (header->arena != nullptr)
+            header->arena->decReferenceCount();
+        else
+            std::free (header);
+    }
+}
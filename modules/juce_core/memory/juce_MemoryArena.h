@@ -0,0 +1,168 @@
+/*
+  ==============================================================================
+
+   This file is part of the juce_core module of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission to use, copy, modify, and/or distribute this software for any purpose with
+   or without fee is hereby granted, provided that the above copyright notice and this
+   permission notice appear in all copies.
+
+   THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+   TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+   NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+   DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+   IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+   ------------------------------------------------------------------------------
+
+   NOTE! This permissive ISC license applies ONLY to files within the juce_core module!
+   All other JUCE modules are covered by a dual GPL/commercial license, so if you are
+   using any other modules, be sure to check that you also comply with their license.
+
+   For more details, visit www.juce.com
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_MEMORYARENA_JUCEHEADER__
+#define __JUCE_MEMORYARENA_JUCEHEADER__
+
+#include "juce_ReferenceCountedObject.h"
+#include "../containers/juce_Array.h"
+
+
+//==============================================================================
+/**
+    A monotonic memory arena, which hands out memory from a few large blocks.
+
+    Allocating from an arena is just a matter of bumping a pointer, and the memory
+    is never given back individually - all the blocks are freed together when the
+    arena is deleted. This makes it ideal for building a large structure with lots
+    of small objects in one go, e.g. when loading a big ValueTree from a stream.
+
+    You don't normally call allocate() yourself: instead, you make the arena active
+    on the current thread with a MemoryArena::ScopedUse object, and any classes that
+    use ArenaAllocationPolicy (e.g. ValueTree nodes and their properties, or an
+    Array declared with ArenaAllocationPolicy as its allocation policy) will take
+    their memory from it while the ScopedUse is in scope.
+
+    The arena is reference-counted, and every block that ArenaAllocationPolicy takes
+    from it holds a reference, so it's safe for those objects to outlive the
+    ScopedUse - the arena is only deleted when the last of them has been released.
+    The flip-side is that none of the arena's memory is reclaimed until then.
+
+    @see ArenaAllocationPolicy, StandardAllocationPolicy
+*/
+class JUCE_API  MemoryArena  : public ReferenceCountedObject
+{
+public:
+    //==============================================================================
+    /** Creates an empty arena.
+        @param blockSizeInBytes     the size of each block that the arena allocates. Any
+                                    request larger than a quarter of this will get a
+                                    block of its own
+    */
+    explicit MemoryArena (size_t blockSizeInBytes = 65536);
+
+    /** Destructor.
+        This frees all the memory that the arena has allocated.
+    */
+    ~MemoryArena();
+
+    /** A pointer to a MemoryArena. */
+    typedef ReferenceCountedObjectPtr<MemoryArena> Ptr;
+
+    //==============================================================================
+    /** Returns some memory from the arena.
+
+        The memory is aligned to 16 bytes, and remains valid until the arena is deleted.
+        This isn't thread-safe, so an arena should only be used by one thread at a time.
+        Returns nullptr if the system runs out of memory.
+    */
+    void* allocate (size_t numBytes);
+
+    /** Returns the total number of bytes that the arena has taken from the system. */
+    size_t getNumBytesReserved() const noexcept         { return numBytesReserved; }
+
+    /** Returns the number of blocks that the arena has taken from the system. */
+    int getNumBlocks() const noexcept                   { return blocks.size(); }
+
+    //==============================================================================
+    /** Returns the arena that's currently active on the calling thread, or nullptr
+        if there isn't one.
+        @see ScopedUse
+    */
+    static MemoryArena* getCurrent() noexcept;
+
+    /**
+        Makes an arena active on the current thread for the lifetime of this object.
+
+        While it's in scope, any allocations made through ArenaAllocationPolicy on this
+        thread will come from the arena. When it's deleted, whichever arena was previously
+        active is restored, so these can be safely nested.
+
+        @code
+        ValueTree tree;
+
+        {
+            const MemoryArena::ScopedUse arena (new MemoryArena());
+            tree = ValueTree::readFromStream (stream);
+        }
+        @endcode
+    */
+    class JUCE_API  ScopedUse
+    {
+    public:
+        /** Makes the given arena active on this thread. If the arena is nullptr, then
+            ArenaAllocationPolicy will use the normal heap until this object is deleted.
+        */
+        explicit ScopedUse (MemoryArena* arenaToUse);
+
+        /** Destructor. */
+        ~ScopedUse();
+
+    private:
+        MemoryArena::Ptr arena;
+        MemoryArena* previous;
+
+        JUCE_DECLARE_NON_COPYABLE (ScopedUse)
+    };
+
+private:
+    //==============================================================================
+    Array<char*> blocks;
+    char* position;
+    size_t numBytesLeftInBlock, numBytesReserved;
+    const size_t blockSize;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MemoryArena)
+};
+
+
+//==============================================================================
+/**
+    An allocation policy that takes its memory from the MemoryArena that's active on the
+    calling thread, or from the normal heap if there isn't one.
+
+    This can be used as the AllocationPolicy template parameter of HeapBlock, Array,
+    OwnedArray and ReferenceCountedArray, or to implement a class's operator new and
+    operator delete. Each block carries a small header saying where it came from, so
+    memory from either source can be freed or reallocated at any time, on any thread.
+
+    Reallocating arena memory has to allocate a new block and copy the data, so it's
+    best to reserve the size you need in advance when you know it.
+
+    @see MemoryArena, StandardAllocationPolicy
+*/
+struct JUCE_API  ArenaAllocationPolicy
+{
+    static void* allocate (size_t numBytes);
+    static void* allocateZeroed (size_t numElements, size_t elementSize);
+    static void* reallocate (void* data, size_t numBytes);
+    static void release (void* data);
+};
+
+
+#endif   // __JUCE_MEMORYARENA_JUCEHEADER__
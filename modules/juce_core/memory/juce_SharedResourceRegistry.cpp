@@ -0,0 +1,215 @@
+/*
+  ==============================================================================
+
+   This file is part of the juce_core module of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission to use, copy, modify, and/or distribute this software for any purpose with
+   or without fee is hereby granted, provided that the above copyright notice and this
+   permission notice appear in all copies.
+
+   THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+   TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+   NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+   DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+   IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+   ------------------------------------------------------------------------------
+
+   NOTE! This permissive ISC license applies ONLY to files within the juce_core module!
+   All other JUCE modules are covered by a dual GPL/commercial license, so if you are
+   using any other modules, be sure to check that you also comply with their license.
+
+   For more details, visit www.juce.com
+
+  ==============================================================================
+*/
+
+namespace SharedResourceRegistryHelpers
+{
+    typedef ReferenceCountedObjectPtr<ReferenceCountedObject> ObjectPtr;
+
+    struct Table
+    {
+        CriticalSection lock;
+        HashMap<String, ObjectPtr> objects;
+
+        // (must be called with the lock held)
+        void releaseUnused()
+        {
+            StringArray unused;
+
+            for (HashMap<String, ObjectPtr>::Iterator i (objects); i.next();)
+            {
+                // (the iterator returns a copy of the pointer, so an unused object has two references)
+                const ObjectPtr object (i.getValue());
+
+                if (object == nullptr || object->getReferenceCount() <= 2)
+                    unused.add (i.getKey());
+            }
+
+            for (int i = unused.size(); --i >= 0;)
+                objects.remove (unused[i]);
+        }
+    };
+
+    static Table& getTable()
+    {
+        static Table table;
+        return table;
+    }
+}
+
+ReferenceCountedObjectPtr<ReferenceCountedObject> SharedResourceRegistry::find (const String& key)
+{
+    SharedResourceRegistryHelpers::Table& table = SharedResourceRegistryHelpers::getTable();
+    const ScopedLock sl (table.lock);
+    return table.objects [key];
+}
+
+ReferenceCountedObjectPtr<ReferenceCountedObject> SharedResourceRegistry::add (const String& key,
+                                                                              ReferenceCountedObject* const newObject)
+{
+    jassert (key.isNotEmpty());
+
+    // (if nobody else gets a reference to the new object, this makes sure it's deleted)
+    const SharedResourceRegistryHelpers::ObjectPtr object (newObject);
+
+    SharedResourceRegistryHelpers::Table& table = SharedResourceRegistryHelpers::getTable();
+    const ScopedLock sl (table.lock);
+
+    const SharedResourceRegistryHelpers::ObjectPtr existing (table.objects [key]);
+
+    if (existing != nullptr)
+        return existing;
+
+    table.releaseUnused();
+
+    if (object != nullptr)
+        table.objects.set (key, object);
+
+    return object;
+}
+
+void SharedResourceRegistry::remove (const String& key)
+{
+    SharedResourceRegistryHelpers::Table& table = SharedResourceRegistryHelpers::getTable();
+    const ScopedLock sl (table.lock);
+    table.objects.remove (key);
+}
+
+void SharedResourceRegistry::releaseUnusedResources()
+{
+    SharedResourceRegistryHelpers::Table& table = SharedResourceRegistryHelpers::getTable();
+    const ScopedLock sl (table.lock);
+    table.releaseUnused();
+}
+
+int SharedResourceRegistry::getNumResources()
+{
+    SharedResourceRegistryHelpers::Table& table = SharedResourceRegistryHelpers::getTable();
+    const ScopedLock sl (table.lock);
+    return table.objects.size();
+}
+
+//==============================================================================
+int64 SharedResourceRegistry::getContentHash (const void* const data, const size_t numBytes) noexcept
+{
+    return (int64) XXHash64::hash (data, numBytes);
+}
+
+String SharedResourceRegistry::createContentKey (const String& typePrefix, const void* const data, const size_t numBytes)
+{
+    return typePrefix + ":" + String::toHexString (getContentHash (data, numBytes))
+                      + ":" + String ((int64) numBytes);
+}
+
+String SharedResourceRegistry::createFileKey (const String& typePrefix, const File& file)
+{
+    return typePrefix + ":" + file.getFullPathName()
+                      + ":" + String (file.getSize())
+                      + ":" + String (file.getLastModificationTime().toMilliseconds());
+}
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class SharedResourceRegistryTests  : public UnitTest
+{
+public:
+    SharedResourceRegistryTests()  : UnitTest ("SharedResourceRegistry") {}
+
+    struct TestResource  : public ReferenceCountedObject
+    {
+        typedef ReferenceCountedObjectPtr<TestResource> Ptr;
+    };
+
+    struct SharedThing
+    {
+        SharedThing()   { ++numThings; }
+        ~SharedThing()  { --numThings; }
+
+        static int numThings;
+    };
+
+    void runTest()
+    {
+        beginTest ("Registry");
+
+        const char data1[] = "some resource data";
+        const char data2[] = "some resource dat!";
+
+        const String key1 (SharedResourceRegistry::createContentKey ("Test", data1, sizeof (data1)));
+        const String key2 (SharedResourceRegistry::createContentKey ("Test", data2, sizeof (data2)));
+
+        expect (key1 != key2);
+        expect (key1 == SharedResourceRegistry::createContentKey ("Test", data1, sizeof (data1)));
+        expect (key1 != SharedResourceRegistry::createContentKey ("Other", data1, sizeof (data1)));
+
+        expect (SharedResourceRegistry::find (key1) == nullptr);
+
+        {
+            TestResource::Ptr r1 (dynamic_cast<TestResource*> (SharedResourceRegistry::add (key1, new TestResource()).get()));
+            TestResource::Ptr r2 (dynamic_cast<TestResource*> (SharedResourceRegistry::add (key1, new TestResource()).get()));
+
+            expect (r1 != nullptr);
+            expect (r1 == r2);
+            expect (SharedResourceRegistry::find (key1).get() == r1.get());
+            expect (SharedResourceRegistry::find (key2) == nullptr);
+
+            SharedResourceRegistry::releaseUnusedResources();
+            expect (SharedResourceRegistry::find (key1).get() == r1.get());
+        }
+
+        SharedResourceRegistry::releaseUnusedResources();
+        expect (SharedResourceRegistry::find (key1) == nullptr);
+
+        beginTest ("SharedResourcePointer");
+
+        expectEquals (SharedThing::numThings, 0);
+
+        {
+            SharedResourcePointer<SharedThing> p1;
+            expectEquals (SharedThing::numThings, 1);
+
+            {
+                SharedResourcePointer<SharedThing> p2;
+                expectEquals (SharedThing::numThings, 1);
+                expect (&p1.get() == &p2.get());
+                expectEquals (p1.getReferenceCount(), 2);
+            }
+
+            expectEquals (SharedThing::numThings, 1);
+        }
+
+        expectEquals (SharedThing::numThings, 0);
+    }
+};
+
+int SharedResourceRegistryTests::SharedThing::numThings = 0;
+
+static SharedResourceRegistryTests sharedResourceRegistryTests;
+
+#endif
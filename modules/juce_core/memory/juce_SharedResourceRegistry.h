@@ -0,0 +1,126 @@
+/*
+  ==============================================================================
+
+   This file is part of the juce_core module of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission to use, copy, modify, and/or distribute this software for any purpose with
+   or without fee is hereby granted, provided that the above copyright notice and this
+   permission notice appear in all copies.
+
+   THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+   TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+   NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+   DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+   IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+   ------------------------------------------------------------------------------
+
+   NOTE! This permissive ISC license applies ONLY to files within the juce_core module!
+   All other JUCE modules are covered by a dual GPL/commercial license, so if you are
+   using any other modules, be sure to check that you also comply with their license.
+
+   For more details, visit www.juce.com
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_SHAREDRESOURCEREGISTRY_JUCEHEADER__
+#define __JUCE_SHAREDRESOURCEREGISTRY_JUCEHEADER__
+
+#include "juce_ReferenceCountedObject.h"
+#include "../text/juce_String.h"
+class File;
+
+
+//==============================================================================
+/**
+    A process-wide table of reference-counted objects, which lets unrelated bits of
+    code share a single copy of some expensive resource.
+
+    Each object is stored against a string key which identifies its contents, so
+    that anything that would have loaded an identical object can look up the one
+    that's already there instead. The classic use for this is in plugins, where
+    every instance that's open in a host would otherwise load its own copy of the
+    same samples, images or fonts: with a registry, the first instance loads them,
+    and the others just take a reference to the same objects.
+
+    A typical use looks like this:
+    @code
+    const String key (SharedResourceRegistry::createContentKey ("MyTable", data, dataSize));
+
+    MyTable::Ptr table (dynamic_cast<MyTable*> (SharedResourceRegistry::find (key).get()));
+
+    if (table == nullptr)
+        table = dynamic_cast<MyTable*> (SharedResourceRegistry::add (key, new MyTable (data, dataSize)).get());
+    @endcode
+
+    The registry holds a reference to each of its objects, so they'll stay in memory
+    after their last user has released them, until releaseUnusedResources() is called.
+    This is done automatically whenever a new object is added, and by shutdownJuce_GUI(),
+    so in most cases you won't need to call it yourself.
+
+    All the methods are thread-safe.
+
+    @see SharedResourcePointer, ReferenceCountedObject
+*/
+class JUCE_API  SharedResourceRegistry
+{
+public:
+    //==============================================================================
+    /** Returns the object that was registered with the given key, or nullptr if there isn't one. */
+    static ReferenceCountedObjectPtr<ReferenceCountedObject> find (const String& key);
+
+    /** Registers an object with the given key.
+
+        If an object is already registered with this key (e.g. because another thread
+        has just loaded the same resource), then the new object is discarded, and the
+        existing one is returned, so you should always carry on using the object that
+        this method returns rather than the one you passed in.
+    */
+    static ReferenceCountedObjectPtr<ReferenceCountedObject> add (const String& key,
+                                                                 ReferenceCountedObject* newObject);
+
+    /** Removes the object with the given key from the registry.
+        This doesn't delete it if anything else is still holding a reference to it - it just
+        means that later calls to find() won't return it.
+    */
+    static void remove (const String& key);
+
+    /** Releases any objects which aren't being used by anything except the registry itself. */
+    static void releaseUnusedResources();
+
+    /** Returns the number of objects that are currently registered. */
+    static int getNumResources();
+
+    //==============================================================================
+    /** Returns a 64-bit hash of a block of data.
+        This uses XXHash64, which is fast enough to run over large resources, but
+        isn't suitable for anything security-related.
+        @see XXHash64
+    */
+    static int64 getContentHash (const void* data, size_t numBytes) noexcept;
+
+    /** Creates a key which identifies an object by the contents of some data.
+
+        The prefix should describe the type of object that will be made from the
+        data, so that different kinds of object created from the same data don't clash.
+    */
+    static String createContentKey (const String& typePrefix, const void* data, size_t numBytes);
+
+    /** Creates a key which identifies an object by the file that it was loaded from.
+
+        Hashing a big file would be almost as slow as loading it, so this uses the file's
+        full path, size and modification time instead, which means that a file will be
+        reloaded if it's modified on disk.
+    */
+    static String createFileKey (const String& typePrefix, const File& file);
+
+private:
+    SharedResourceRegistry();
+    JUCE_DECLARE_NON_COPYABLE (SharedResourceRegistry)
+};
+
+
+#endif   // __JUCE_SHAREDRESOURCEREGISTRY_JUCEHEADER__
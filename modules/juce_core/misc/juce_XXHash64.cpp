@@ -0,0 +1,245 @@
+/*
+  ==============================================================================
+
+   This file is part of the juce_core module of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission to use, copy, modify, and/or distribute this software for any purpose with
+   or without fee is hereby granted, provided that the above copyright notice and this
+   permission notice appear in all copies.
+
+   THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+   TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+   NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+   DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+   IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+   ------------------------------------------------------------------------------
+
+   NOTE! This permissive ISC license applies ONLY to files within the juce_core module!
+   All other JUCE modules are covered by a dual GPL/commercial license, so if you are
+   using any other modules, be sure to check that you also comply with their license.
+
+   For more details, visit www.juce.com
+
+  ==============================================================================
+*/
+
+namespace XXHash64Helpers
+{
+    static const uint64 prime1 = (uint64) literal64bit (0x9E3779B185EBCA87);
+    static const uint64 prime2 = (uint64) literal64bit (0xC2B2AE3D27D4EB4F);
+    static const uint64 prime3 = (uint64) literal64bit (0x165667B19E3779F9);
+    static const uint64 prime4 = (uint64) literal64bit (0x85EBCA77C2B2AE63);
+    static const uint64 prime5 = (uint64) literal64bit (0x27D4EB2F165667C5);
+
+    static inline uint64 rotateLeft (const uint64 x, const int bits) noexcept   { return (x << bits) | (x >> (64 - bits)); }
+
+    static inline uint64 read64 (const uint8* const p) noexcept
+    {
+        uint64 v;
+        memcpy (&v, p, sizeof (v));
+        return ByteOrder::swapIfBigEndian (v);
+    }
+
+    static inline uint32 read32 (const uint8* const p) noexcept
+    {
+        uint32 v;
+        memcpy (&v, p, sizeof (v));
+        return ByteOrder::swapIfBigEndian (v);
+    }
+
+    static inline uint64 round (uint64 acc, const uint64 input) noexcept
+    {
+        acc += input * prime2;
+        return rotateLeft (acc, 31) * prime1;
+    }
+
+    static inline uint64 mergeRound (uint64 acc, const uint64 value) noexcept
+    {
+        acc ^= round (0, value);
+        return acc * prime1 + prime4;
+    }
+
+    // processes as many 32-byte stripes as possible, and returns the number of bytes used
+    static size_t processStripes (uint64* const acc, const uint8* const data, const size_t numBytes) noexcept
+    {
+        uint64 v1 = acc[0], v2 = acc[1], v3 = acc[2], v4 = acc[3];
+        const uint8* p = data;
+        const uint8* const end = data + (numBytes & ~(size_t) 31);
+
+        while (p < end)
+        {
+            v1 = round (v1, read64 (p));
+            v2 = round (v2, read64 (p + 8));
+            v3 = round (v3, read64 (p + 16));
+            v4 = round (v4, read64 (p + 24));
+            p += 32;
+        }
+
+        acc[0] = v1; acc[1] = v2; acc[2] = v3; acc[3] = v4;
+        return (size_t) (p - data);
+    }
+
+    static uint64 finish (const uint64* const acc, const uint64 seed, const uint64 totalLength,
+                          const uint8* p, size_t numBytesLeft) noexcept
+    {
+        uint64 h;
+
+        if (totalLength >= 32)
+        {
+            h = rotateLeft (acc[0], 1) + rotateLeft (acc[1], 7) + rotateLeft (acc[2], 12) + rotateLeft (acc[3], 18);
+            h = mergeRound (h, acc[0]);
+            h = mergeRound (h, acc[1]);
+            h = mergeRound (h, acc[2]);
+            h = mergeRound (h, acc[3]);
+        }
+        else
+        {
+            h = seed + prime5;
+        }
+
+        h += totalLength;
+
+        for (; numBytesLeft >= 8; numBytesLeft -= 8, p += 8)
+            h = rotateLeft (h ^ round (0, read64 (p)), 27) * prime1 + prime4;
+
+        if (numBytesLeft >= 4)
+        {
+            h = rotateLeft (h ^ (read32 (p) * prime1), 23) * prime2 + prime3;
+            p += 4;
+            numBytesLeft -= 4;
+        }
+
+        for (; numBytesLeft > 0; --numBytesLeft)
+            h = rotateLeft (h ^ (*p++ * prime5), 11) * prime1;
+
+        h ^= h >> 33;
+        h *= prime2;
+        h ^= h >> 29;
+        h *= prime3;
+        h ^= h >> 32;
+        return h;
+    }
+}
+
+//==============================================================================
+XXHash64::XXHash64 (const uint64 seed_) noexcept
+{
+    reset (seed_);
+}
+
+XXHash64::~XXHash64() noexcept {}
+
+void XXHash64::reset (const uint64 seed_) noexcept
+{
+    using namespace XXHash64Helpers;
+
+    seed = seed_;
+    accumulators[0] = seed + prime1 + prime2;
+    accumulators[1] = seed + prime2;
+    accumulators[2] = seed;
+    accumulators[3] = seed - prime1;
+    totalLength = 0;
+    bufferSize = 0;
+}
+
+void XXHash64::update (const void* const data, size_t numBytes) noexcept
+{
+    jassert (data != nullptr || numBytes == 0);
+
+    const uint8* p = static_cast <const uint8*> (data);
+    totalLength += numBytes;
+
+    if (bufferSize > 0)
+    {
+        const size_t num = jmin (numBytes, sizeof (buffer) - bufferSize);
+        memcpy (buffer + bufferSize, p, num);
+        bufferSize += (uint32) num;
+        p += num;
+        numBytes -= num;
+
+        if (bufferSize < sizeof (buffer))
+            return;
+
+        XXHash64Helpers::processStripes (accumulators, buffer, sizeof (buffer));
+        bufferSize = 0;
+    }
+
+    const size_t numDone = XXHash64Helpers::processStripes (accumulators, p, numBytes);
+    memcpy (buffer, p + numDone, numBytes - numDone);
+    bufferSize = (uint32) (numBytes - numDone);
+}
+
+uint64 XXHash64::getHash() const noexcept
+{
+    return XXHash64Helpers::finish (accumulators, seed, totalLength, buffer, bufferSize);
+}
+
+//==============================================================================
+uint64 XXHash64::hash (const void* const data, const size_t numBytes, const uint64 seed) noexcept
+{
+    XXHash64 h (seed);
+    h.update (data, numBytes);
+    return h.getHash();
+}
+
+uint64 XXHash64::hash (const MemoryBlock& data, const uint64 seed) noexcept
+{
+    return hash (data.getData(), data.getSize(), seed);
+}
+
+uint64 XXHash64::hash (const String& text, const uint64 seed) noexcept
+{
+    return hash (text.toRawUTF8(), text.getNumBytesAsUTF8(), seed);
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class XXHash64Tests  : public UnitTest
+{
+public:
+    XXHash64Tests() : UnitTest ("XXHash64") {}
+
+    void runTest()
+    {
+        beginTest ("Known values");
+
+        expect (XXHash64::hash ("", 0) == (uint64) literal64bit (0xef46db3751d8e999));
+        expect (XXHash64::hash (String ("a")) == (uint64) literal64bit (0xd24ec4f1a98c6e5b));
+        expect (XXHash64::hash (String ("abc")) == (uint64) literal64bit (0x44bc2cf5ad770999));
+        expect (XXHash64::hash (String ("Nobody inspects the spammish repetition"))
+                  == (uint64) literal64bit (0xfbcea83c8a378bf1));
+
+        beginTest ("Incremental");
+
+        Random r (0x5678);
+        MemoryBlock data (1000);
+
+        for (int i = 0; i < (int) data.getSize(); ++i)
+            data[i] = (char) r.nextInt (256);
+
+        for (int i = 0; i < 50; ++i)
+        {
+            const size_t size = (size_t) r.nextInt ((int) data.getSize());
+            const uint64 seed = (uint64) r.nextInt64();
+
+            XXHash64 h (seed);
+
+            for (size_t pos = 0; pos < size;)
+            {
+                const size_t num = jmin (size - pos, (size_t) r.nextInt (70));
+                h.update (static_cast <const char*> (data.getData()) + pos, num);
+                pos += num;
+            }
+
+            expect (h.getHash() == XXHash64::hash (data.getData(), size, seed));
+        }
+    }
+};
+
+static XXHash64Tests xxHash64Tests;
+
+#endif
@@ -0,0 +1,92 @@
+/*
+  ==============================================================================
+
+   This file is part of the juce_core module of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission to use, copy, modify, and/or distribute this software for any purpose with
+   or without fee is hereby granted, provided that the above copyright notice and this
+   permission notice appear in all copies.
+
+   THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+   TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+   NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+   DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+   IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+   ------------------------------------------------------------------------------
+
+   NOTE! This permissive ISC license applies ONLY to files within the juce_core module!
+   All other JUCE modules are covered by a dual GPL/commercial license, so if you are
+   using any other modules, be sure to check that you also comply with their license.
+
+   For more details, visit www.juce.com
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_XXHASH64_JUCEHEADER__
+#define __JUCE_XXHASH64_JUCEHEADER__
+
+#include "../text/juce_String.h"
+#include "../memory/juce_MemoryBlock.h"
+
+
+//==============================================================================
+/**
+    A fast, non-cryptographic 64-bit hash function.
+
+    This implements the xxHash64 algorithm, which runs at close to memory bandwidth
+    and has very good distribution, making it suitable for things like cache keys and
+    hash tables. It offers no protection against deliberately-constructed collisions,
+    so if you need that, use SHA256 instead.
+
+    You can either hash a block of data in one go with the static hash() methods, or
+    create an XXHash64 object and feed it a sequence of blocks with update(). Both give
+    the same result for the same data.
+*/
+class JUCE_API  XXHash64
+{
+public:
+    //==============================================================================
+    /** Creates an object ready to hash some data, using the given seed value. */
+    explicit XXHash64 (uint64 seed = 0) noexcept;
+
+    /** Destructor. */
+    ~XXHash64() noexcept;
+
+    /** Resets the object, discarding any data that has been added. */
+    void reset (uint64 seed = 0) noexcept;
+
+    /** Adds a block of data to the hash. */
+    void update (const void* data, size_t numBytes) noexcept;
+
+    /** Returns the hash of all the data that has been added so far.
+        This doesn't change the object's state, so you can carry on adding more data afterwards.
+    */
+    uint64 getHash() const noexcept;
+
+    //==============================================================================
+    /** Returns the hash of a block of data. */
+    static uint64 hash (const void* data, size_t numBytes, uint64 seed = 0) noexcept;
+
+    /** Returns the hash of a block of data. */
+    static uint64 hash (const MemoryBlock& data, uint64 seed = 0) noexcept;
+
+    /** Returns the hash of the UTF-8 representation of a string. */
+    static uint64 hash (const String& text, uint64 seed = 0) noexcept;
+
+private:
+    //==============================================================================
+    uint64 accumulators[4];
+    uint64 totalLength;
+    uint8 buffer[32];
+    uint32 bufferSize;
+    uint64 seed;
+
+    JUCE_LEAK_DETECTOR (XXHash64)
+};
+
+
+#endif   // __JUCE_XXHASH64_JUCEHEADER__
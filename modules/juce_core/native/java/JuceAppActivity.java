@@ -696,4 +696,29 @@ public final class JuceAppActivity   extends Activity
     {
         new SingleMediaScanner (this, filename);
     }
+
+    //==============================================================================
+    // (AudioManager.getProperty() only exists from API level 17, so it's called by reflection)
+    public final String audioManagerGetProperty (String property)
+    {
+        Object audioManager = getSystemService (AUDIO_SERVICE);
+
+        if (audioManager == null)
+            return null;
+
+        try
+        {
+            java.lang.reflect.Method method = audioManager.getClass().getMethod ("getProperty", String.class);
+            return (String) method.invoke (audioManager, property);
+        }
+        catch (Exception e)
+        {
+            return null;
+        }
+    }
+
+    public final boolean hasSystemFeature (String feature)
+    {
+        return getPackageManager().hasSystemFeature (feature);
+    }
 }
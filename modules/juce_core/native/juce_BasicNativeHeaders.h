@@ -53,11 +53,14 @@
 
  #include <sys/socket.h>
  #include <sys/sysctl.h>
+ #include <copyfile.h>
  #include <sys/stat.h>
  #include <sys/param.h>
  #include <sys/mount.h>
  #include <sys/utsname.h>
  #include <sys/mman.h>
+ #include <semaphore.h>
+ #include <poll.h>
  #include <fnmatch.h>
  #include <utime.h>
  #include <dlfcn.h>
@@ -190,6 +193,8 @@
  #include <sys/sysinfo.h>
  #include <sys/file.h>
  #include <sys/prctl.h>
+ #include <sys/sendfile.h>
+ #include <poll.h>
  #include <signal.h>
  #include <stddef.h>
 
@@ -212,6 +217,7 @@
  #include <dirent.h>
  #include <fnmatch.h>
  #include <sys/wait.h>
+ #include <poll.h>
 #endif
 
 // Need to clear various moronic redefinitions made by system headers..
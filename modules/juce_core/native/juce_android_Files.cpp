@@ -26,7 +26,7 @@
   ==============================================================================
 */
 
-bool File::copyInternal (const File& dest) const
+bool File::copyInternal (const File& dest, CopyProgressCallback* const progress) const
 {
     FileInputStream in (*this);
 
@@ -38,7 +38,26 @@ bool File::copyInternal (const File& dest) const
             if (out.failedToOpen())
                 return false;
 
-            if (out.writeFromInputStream (in, -1) == getSize())
+            const int64 totalSize = getSize();
+            int64 bytesCopied = 0;
+
+            for (;;)
+            {
+                const int64 numDone = out.writeFromInputStream (in, 8 * 1024 * 1024);
+
+                if (numDone <= 0)
+                    break;
+
+                bytesCopied += numDone;
+
+                if (progress != nullptr && ! progress->copyProgress (bytesCopied, jmax (totalSize, bytesCopied)))
+                {
+                    bytesCopied = -1;
+                    break;
+                }
+            }
+
+            if (bytesCopied == totalSize)
                 return true;
         }
 
@@ -210,6 +210,11 @@ String SystemStats::getCpuVendor()
     return AndroidStatsHelpers::getSystemProperty ("os.arch");
 }
 
+BigInteger SystemStats::getIsolatedCpus()
+{
+    return BigInteger();
+}
+
 int SystemStats::getCpuSpeedInMegaherz()
 {
     return 0; // TODO
@@ -275,6 +280,22 @@ SystemStats::CPUFlags::CPUFlags()
     hasSSE2 = false;
     has3DNow = false;
 
+    detectExtendedFeatures();
+
+    // (on ARM, the kernel reports NEON as "neon", or "asimd" on 64-bit chips)
+    StringArray lines;
+    File ("/proc/cpuinfo").readLines (lines);
+
+    for (int i = 0; i < lines.size(); ++i)
+    {
+        if (lines[i].startsWithIgnoreCase ("Features"))
+        {
+            const String features (lines[i].fromFirstOccurrenceOf (":", false, false));
+            hasNeon = hasNeon || features.contains ("neon") || features.contains ("asimd");
+            break;
+        }
+    }
+
     numCpus = jmax (1, sysconf (_SC_NPROCESSORS_ONLN));
 }
 
@@ -35,26 +35,148 @@ enum
 };
 
 //==============================================================================
-bool File::copyInternal (const File& dest) const
+namespace LinuxFileCopyHelpers
 {
-    FileInputStream in (*this);
+   #ifndef FICLONE
+    #define FICLONE _IOW (0x94, 9, int)
+   #endif
 
-    if (dest.deleteFile())
+    enum CopyMethod
     {
+        useCopyFileRange,
+        useSendFile,
+        useReadWrite
+    };
+
+    // Copies everything from the current position of one file descriptor to the other.
+    // copy_file_range() keeps the data inside the kernel (and lets filesystems like NFS or
+    // XFS do the copy server-side or by sharing blocks); sendfile() still avoids copying
+    // through user-space; and plain read/write is the last resort.
+    static bool copyData (const int in, const int out, const int64 totalSize,
+                          File::CopyProgressCallback* const progress)
+    {
+        // when reporting progress, copy in smaller blocks so that the callback gets called
+        const size_t blockSize = progress != nullptr ? (size_t) 8 * 1024 * 1024
+                                                     : (size_t) 1024 * 1024 * 1024;
+
+       #ifdef __NR_copy_file_range
+        CopyMethod method = useCopyFileRange;
+       #else
+        CopyMethod method = useSendFile;
+       #endif
+
+        HeapBlock<char> buffer;
+        int64 bytesCopied = 0;
+
+        for (;;)
         {
-            FileOutputStream out (dest);
+            ssize_t numDone = -1;
+
+            if (method == useCopyFileRange)
+            {
+               #ifdef __NR_copy_file_range
+                numDone = (ssize_t) syscall (__NR_copy_file_range, in, nullptr, out, nullptr, blockSize, 0);
+
+                if (numDone < 0 && (errno == ENOSYS || errno == EXDEV || errno == EINVAL
+                                      || errno == EOPNOTSUPP || errno == EPERM))
+                {
+                    method = useSendFile;
+                    continue;
+                }
+               #endif
+            }
+            else if (method == useSendFile)
+            {
+                numDone = sendfile (out, in, nullptr, blockSize);
+
+                if (numDone < 0 && (errno == ENOSYS || errno == EINVAL))
+                {
+                    method = useReadWrite;
+                    continue;
+                }
+            }
+            else
+            {
+                const size_t bufferSize = 256 * 1024;
+
+                if (buffer == nullptr)
+                    buffer.malloc (bufferSize);
+
+                numDone = read (in, buffer, bufferSize);
+
+                for (ssize_t written = 0; written < numDone;)
+                {
+                    const ssize_t n = write (out, buffer + written, (size_t) (numDone - written));
+
+                    if (n < 0)
+                    {
+                        if (errno == EINTR)
+                            continue;
+
+                        return false;
+                    }
+
+                    written += n;
+                }
+            }
+
+            if (numDone < 0)
+            {
+                if (errno == EINTR)
+                    continue;
 
-            if (out.failedToOpen())
                 return false;
+            }
 
-            if (out.writeFromInputStream (in, -1) == getSize())
+            if (numDone == 0)
                 return true;
+
+            bytesCopied += numDone;
+
+            if (progress != nullptr && ! progress->copyProgress (bytesCopied, jmax (totalSize, bytesCopied)))
+                return false;
         }
+    }
+}
+
+bool File::copyInternal (const File& dest, CopyProgressCallback* const progress) const
+{
+    const int in = open (fullPath.toUTF8(), O_RDONLY);
+
+    if (in < 0)
+        return false;
 
-        dest.deleteFile();
+    bool ok = false;
+    struct stat64 info;
+
+    if (fstat64 (in, &info) == 0)
+    {
+        const int out = open (dest.getFullPathName().toUTF8(), O_WRONLY | O_CREAT | O_TRUNC,
+                              info.st_mode & 07777);
+
+        if (out >= 0)
+        {
+            // on filesystems that can share blocks between files (btrfs, XFS, etc.), a
+            // reflink copies nothing at all until one of the files gets modified
+            if (ioctl (out, FICLONE, in) == 0)
+            {
+                ok = progress == nullptr || progress->copyProgress ((int64) info.st_size, (int64) info.st_size);
+            }
+            else
+            {
+                ok = LinuxFileCopyHelpers::copyData (in, out, (int64) info.st_size, progress);
+            }
+
+            if (close (out) != 0)
+                ok = false;
+
+            if (! ok)
+                dest.deleteFile();
+        }
     }
 
-    return false;
+    close (in);
+    return ok;
 }
 
 void File::findFileSystemRoots (Array<File>& destArray)
@@ -284,7 +406,7 @@ public:
                 {
                     filenameFound = CharPointer_UTF8 (de->d_name);
 
-                    updateStatInfoForFile (parentDir + filenameFound, isDir, fileSize, modTime, creationTime, isReadOnly);
+                    updateStatInfo (*de, isDir, fileSize, modTime, creationTime, isReadOnly);
 
                     if (isHidden != nullptr)
                         *isHidden = filenameFound.startsWithChar ('.');
@@ -301,6 +423,33 @@ private:
     String parentDir, wildCard;
     DIR* dir;
 
+    // If the caller only wants to know whether it's a directory, the type that readdir()
+    // returns is enough. Otherwise this does a single stat relative to the open directory,
+    // rather than making the kernel walk the whole path again for every file.
+    void updateStatInfo (const struct dirent& de, bool* const isDir, int64* const fileSize,
+                         Time* const modTime, Time* const creationTime, bool* const isReadOnly) const
+    {
+        if (fileSize == nullptr && modTime == nullptr && creationTime == nullptr
+             && de.d_type != DT_UNKNOWN && de.d_type != DT_LNK)
+        {
+            if (isDir != nullptr)
+                *isDir = (de.d_type == DT_DIR);
+        }
+        else if (isDir != nullptr || fileSize != nullptr || modTime != nullptr || creationTime != nullptr)
+        {
+            juce_statStruct info;
+            const bool statOk = fstatat64 (dirfd (dir), de.d_name, &info, 0) == 0;
+
+            if (isDir != nullptr)         *isDir        = statOk && ((info.st_mode & S_IFDIR) != 0);
+            if (fileSize != nullptr)      *fileSize     = statOk ? info.st_size : 0;
+            if (modTime != nullptr)       *modTime      = Time (statOk ? (int64) info.st_mtime * 1000 : 0);
+            if (creationTime != nullptr)  *creationTime = Time (statOk ? (int64) info.st_ctime * 1000 : 0);
+        }
+
+        if (isReadOnly != nullptr)
+            *isReadOnly = faccessat (dirfd (dir), de.d_name, W_OK, 0) != 0;
+    }
+
     JUCE_DECLARE_NON_COPYABLE (Pimpl)
 };
 
@@ -78,6 +78,11 @@ int SystemStats::getCpuSpeedInMegaherz()
     return roundToInt (LinuxStatsHelpers::getCpuInfo ("cpu MHz").getFloatValue());
 }
 
+BigInteger SystemStats::getIsolatedCpus()
+{
+    return juce_parseCpuList (File ("/sys/devices/system/cpu/isolated").loadFileAsString());
+}
+
 int SystemStats::getMemorySizeInMegabytes()
 {
     struct sysinfo sysi;
@@ -142,6 +147,12 @@ SystemStats::CPUFlags::CPUFlags()
     hasSSE2  = flags.contains ("sse2");
     has3DNow = flags.contains ("3dnow");
 
+    detectExtendedFeatures();
+
+    // (on ARM, the kernel reports NEON as "neon", or "asimd" on 64-bit chips)
+    const String features (LinuxStatsHelpers::getCpuInfo ("Features"));
+    hasNeon = hasNeon || features.contains ("neon") || features.contains ("asimd");
+
     numCpus = LinuxStatsHelpers::getCpuInfo ("processor").getIntValue() + 1;
 }
 
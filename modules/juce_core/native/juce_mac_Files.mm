@@ -32,8 +32,63 @@
 */
 
 //==============================================================================
-bool File::copyInternal (const File& dest) const
+namespace MacFileCopyHelpers
 {
+    struct ProgressInfo
+    {
+        File::CopyProgressCallback* callback;
+        int64 totalSize;
+    };
+
+    static int copyStatusCallback (int what, int stage, copyfile_state_t state,
+                                   const char*, const char*, void* context)
+    {
+        if (what == COPYFILE_COPY_DATA && stage == COPYFILE_PROGRESS)
+        {
+            const ProgressInfo& info = *static_cast<const ProgressInfo*> (context);
+            off_t bytesCopied = 0;
+
+            if (copyfile_state_get (state, COPYFILE_STATE_COPIED, &bytesCopied) == 0
+                 && ! info.callback->copyProgress ((int64) bytesCopied, jmax (info.totalSize, (int64) bytesCopied)))
+                return COPYFILE_QUIT;
+        }
+
+        return COPYFILE_CONTINUE;
+    }
+}
+
+bool File::copyInternal (const File& dest, CopyProgressCallback* const progress) const
+{
+    if (! isDirectory())
+    {
+        // copyfile() does the copy in the kernel, and on APFS, COPYFILE_CLONE turns
+        // it into a clone that shares the file's blocks until either copy is changed
+        copyfile_flags_t flags = COPYFILE_ALL;
+
+       #ifdef COPYFILE_CLONE
+        flags |= COPYFILE_CLONE;
+       #endif
+
+        MacFileCopyHelpers::ProgressInfo info = { progress, getSize() };
+        copyfile_state_t state = copyfile_state_alloc();
+
+        if (progress != nullptr)
+        {
+            copyfile_state_set (state, COPYFILE_STATE_STATUS_CB, (const void*) &MacFileCopyHelpers::copyStatusCallback);
+            copyfile_state_set (state, COPYFILE_STATE_STATUS_CTX, &info);
+        }
+
+        const int result = copyfile (fullPath.toUTF8(), dest.getFullPathName().toUTF8(), state, flags);
+        copyfile_state_free (state);
+
+        // (a successful clone doesn't make any status callbacks, so report it here)
+        if (result == 0 && (progress == nullptr || progress->copyProgress (info.totalSize, info.totalSize)))
+            return true;
+
+        dest.deleteFile();
+        return false;
+    }
+
     JUCE_AUTORELEASEPOOL
     {
         NSFileManager* fm = [NSFileManager defaultManager];
@@ -86,6 +86,8 @@ SystemStats::CPUFlags::CPUFlags()
     has3DNow = false;
    #endif
 
+    detectExtendedFeatures();
+
    #if JUCE_IOS || (MAC_OS_X_VERSION_MIN_REQUIRED >= MAC_OS_X_VERSION_10_5)
     numCpus = (int) [[NSProcessInfo processInfo] activeProcessorCount];
    #else
@@ -181,6 +183,62 @@ String SystemStats::getCpuVendor()
    #endif
 }
 
+BigInteger SystemStats::getIsolatedCpus()
+{
+    return BigInteger();
+}
+
+//==============================================================================
+namespace CpuTopologyHelpers
+{
+    static int getSysctlInt (const char* name, const int defaultValue)
+    {
+        int64 value = 0;
+        size_t size = sizeof (value);
+
+        if (sysctlbyname (name, &value, &size, nullptr, 0) != 0)
+            return defaultValue;
+
+        // (some of these values are 32-bit, some are 64-bit)
+        return size == sizeof (int32) ? (int) *reinterpret_cast <int32*> (&value)
+                                      : (int) value;
+    }
+}
+
+/*  The kernel doesn't say which logical cpu belongs to which core, so this assumes that the
+    hyperthreads of each core are numbered next to each other, and that on chips with
+    efficiency cores (hw.perflevel1), those are numbered first. Both are true of all
+    current hardware, but should be treated as approximations.
+*/
+void juce_fillCpuTopology (SystemStats::CpuTopology& topology)
+{
+    using namespace CpuTopologyHelpers;
+
+    const int numLogical  = jmax (1, getSysctlInt ("hw.logicalcpu", SystemStats::getNumCpus()));
+    const int numPhysical = jlimit (1, numLogical, getSysctlInt ("hw.physicalcpu", numLogical));
+    const int numPackages = jlimit (1, numPhysical, getSysctlInt ("hw.packages", 1));
+    const int threadsPerCore = jmax (1, numLogical / numPhysical);
+    const int coresPerPackage = jmax (1, numPhysical / numPackages);
+
+    const int numEfficiencyCpus = getSysctlInt ("hw.nperflevels", 1) > 1 ? getSysctlInt ("hw.perflevel1.logicalcpu", 0) : 0;
+
+    for (int i = 0; i < numLogical; ++i)
+    {
+        SystemStats::CpuTopology::LogicalCpu cpu;
+        cpu.cpuIndex = i;
+        cpu.coreIndex = jmin (numPhysical - 1, i / threadsPerCore);
+        cpu.packageIndex = jmin (numPackages - 1, cpu.coreIndex / coresPerPackage);
+        cpu.numaNode = 0;
+        cpu.efficiencyClass = i < numEfficiencyCpus ? 0 : 1;
+        topology.cpus.add (cpu);
+    }
+
+    topology.cacheLineSize   = getSysctlInt ("hw.cachelinesize", 0);
+    topology.l1DataCacheSize = getSysctlInt ("hw.l1dcachesize", 0);
+    topology.l2CacheSize     = getSysctlInt ("hw.l2cachesize", 0);
+    topology.l3CacheSize     = getSysctlInt ("hw.l3cachesize", 0);
+}
+
 int SystemStats::getCpuSpeedInMegaherz()
 {
     uint64 speedHz = 0;
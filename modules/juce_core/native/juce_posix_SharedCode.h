@@ -141,6 +141,247 @@ void WaitableEvent::reset() const noexcept
     pthread_mutex_unlock (&mutex);
 }
 
+//==============================================================================
+#if JUCE_LINUX || JUCE_ANDROID
+
+#ifndef FUTEX_WAIT_PRIVATE
+ #define FUTEX_WAIT_PRIVATE  FUTEX_WAIT
+ #define FUTEX_WAKE_PRIVATE  FUTEX_WAKE
+#endif
+
+void AddressWaiter::wait (volatile int32* const address, const int32 expectedValue, const int timeOutMillisecs) noexcept
+{
+    if (timeOutMillisecs < 0)
+    {
+        syscall (SYS_futex, address, FUTEX_WAIT_PRIVATE, expectedValue, nullptr, nullptr, 0);
+    }
+    else
+    {
+        struct timespec time;
+        time.tv_sec  = timeOutMillisecs / 1000;
+        time.tv_nsec = (timeOutMillisecs % 1000) * 1000000;
+
+        syscall (SYS_futex, address, FUTEX_WAIT_PRIVATE, expectedValue, &time, nullptr, 0);
+    }
+}
+
+void AddressWaiter::wake (volatile int32* const address, const int numThreadsToWake) noexcept
+{
+    syscall (SYS_futex, address, FUTEX_WAKE_PRIVATE, numThreadsToWake, nullptr, nullptr, 0);
+}
+
+#else
+
+// Without futexes, waiters are parked on a condition variable chosen by hashing
+// the address they're waiting on. Checking the value and going to sleep both happen
+// with the bucket's mutex held, so a wake-up can't slip in between them.
+namespace AddressWaiterHelpers
+{
+    struct Bucket
+    {
+        Bucket() noexcept
+        {
+            pthread_mutex_init (&mutex, 0);
+            pthread_cond_init (&condition, 0);
+        }
+
+        pthread_mutex_t mutex;
+        pthread_cond_t condition;
+    };
+
+    static Bucket& getBucket (volatile int32* const address) noexcept
+    {
+        static Bucket buckets [64];
+        return buckets [(((pointer_sized_uint) address) >> 4) & 63];
+    }
+}
+
+void AddressWaiter::wait (volatile int32* const address, const int32 expectedValue, const int timeOutMillisecs) noexcept
+{
+    AddressWaiterHelpers::Bucket& b = AddressWaiterHelpers::getBucket (address);
+    pthread_mutex_lock (&b.mutex);
+
+    if (*address == expectedValue)
+    {
+        if (timeOutMillisecs < 0)
+        {
+            pthread_cond_wait (&b.condition, &b.mutex);
+        }
+        else
+        {
+            struct timeval now;
+            gettimeofday (&now, 0);
+
+            struct timespec time;
+            time.tv_sec  = now.tv_sec  + (timeOutMillisecs / 1000);
+            time.tv_nsec = (now.tv_usec + ((timeOutMillisecs % 1000) * 1000)) * 1000;
+
+            if (time.tv_nsec >= 1000000000)
+            {
+                time.tv_nsec -= 1000000000;
+                time.tv_sec++;
+            }
+
+            pthread_cond_timedwait (&b.condition, &b.mutex, &time);
+        }
+    }
+
+    pthread_mutex_unlock (&b.mutex);
+}
+
+void AddressWaiter::wake (volatile int32* const address, int) noexcept
+{
+    // other addresses may share the bucket, so everything waiting on it has to be woken
+    AddressWaiterHelpers::Bucket& b = AddressWaiterHelpers::getBucket (address);
+    pthread_mutex_lock (&b.mutex);
+    pthread_cond_broadcast (&b.condition);
+    pthread_mutex_unlock (&b.mutex);
+}
+
+#endif
+
+//==============================================================================
+#if JUCE_LINUX || JUCE_ANDROID
+// Parses the kernel's format for sets of cpus, which is a comma-separated list of ranges, e.g. "0-3,8,10-11"
+static BigInteger juce_parseCpuList (const String& list)
+{
+    StringArray ranges;
+    ranges.addTokens (list.trim(), ",", String::empty);
+
+    BigInteger cpus;
+
+    for (int i = 0; i < ranges.size(); ++i)
+    {
+        const String& range = ranges[i];
+
+        if (range.containsOnly ("0123456789-") && range.isNotEmpty())
+        {
+            const int first = range.upToFirstOccurrenceOf ("-", false, false).getIntValue();
+            const int last = range.containsChar ('-') ? range.fromFirstOccurrenceOf ("-", false, false).getIntValue()
+                                                      : first;
+
+            if (last >= first)
+                cpus.setRange (first, last + 1 - first, true);
+        }
+    }
+
+    return cpus;
+}
+
+namespace CpuTopologyHelpers
+{
+    static String readSysFile (const String& path)
+    {
+        return File (path).loadFileAsString().trim();
+    }
+
+    static int readSysInt (const String& path, const int defaultValue)
+    {
+        const String s (readSysFile (path));
+        return s.isEmpty() ? defaultValue : s.getIntValue();
+    }
+
+    // cache sizes are given like "32K" or "8192K"
+    static int parseCacheSize (const String& s)
+    {
+        const int size = s.getIntValue();
+
+        if (s.endsWithIgnoreCase ("K"))  return size * 1024;
+        if (s.endsWithIgnoreCase ("M"))  return size * 1024 * 1024;
+
+        return size;
+    }
+
+    static void readCacheSizes (SystemStats::CpuTopology& topology)
+    {
+        for (int i = 0;; ++i)
+        {
+            const File cacheDir ("/sys/devices/system/cpu/cpu0/cache/index" + String (i));
+
+            if (! cacheDir.isDirectory())
+                break;
+
+            const int level = readSysInt (cacheDir.getChildFile ("level").getFullPathName(), 0);
+            const String type (readSysFile (cacheDir.getChildFile ("type").getFullPathName()));
+            const int size = parseCacheSize (readSysFile (cacheDir.getChildFile ("size").getFullPathName()));
+
+            if (topology.cacheLineSize == 0)
+                topology.cacheLineSize = readSysInt (cacheDir.getChildFile ("coherency_line_size").getFullPathName(), 0);
+
+            if (level == 1 && type != "Instruction")  topology.l1DataCacheSize = size;
+            else if (level == 2)                      topology.l2CacheSize = size;
+            else if (level == 3)                      topology.l3CacheSize = size;
+        }
+    }
+
+    static void readNumaNodes (SystemStats::CpuTopology& topology)
+    {
+        Array<File> nodeDirs;
+        File ("/sys/devices/system/node").findChildFiles (nodeDirs, File::findDirectories, false, "node*");
+
+        for (int i = 0; i < nodeDirs.size(); ++i)
+        {
+            const String nodeName (nodeDirs.getReference (i).getFileName().substring (4));
+
+            if (nodeName.isEmpty() || ! nodeName.containsOnly ("0123456789"))
+                continue;
+
+            const int node = nodeName.getIntValue();
+            const BigInteger nodeCpus (juce_parseCpuList (readSysFile (nodeDirs.getReference (i).getChildFile ("cpulist").getFullPathName())));
+
+            for (int j = 0; j < topology.cpus.size(); ++j)
+            {
+                SystemStats::CpuTopology::LogicalCpu& cpu = topology.cpus.getReference (j);
+
+                if (nodeCpus [cpu.cpuIndex])
+                    cpu.numaNode = node;
+            }
+        }
+    }
+}
+
+void juce_fillCpuTopology (SystemStats::CpuTopology& topology)
+{
+    using namespace CpuTopologyHelpers;
+
+    const String cpuDir ("/sys/devices/system/cpu/");
+    const BigInteger online (juce_parseCpuList (readSysFile (cpuDir + "online")));
+
+    // Hybrid Intel chips list their efficiency cores here. Other big.LITTLE designs
+    // give each cpu a relative capacity instead, which finalise() turns into a ranking.
+    const BigInteger atomCpus (juce_parseCpuList (readSysFile ("/sys/devices/cpu_atom/cpus")));
+
+    Array<int64> coreIds; // (package << 32) | core_id, in order of appearance
+
+    for (int i = online.findNextSetBit (0); i >= 0; i = online.findNextSetBit (i + 1))
+    {
+        const String dir (cpuDir + "cpu" + String (i) + "/");
+        const int package = jmax (0, readSysInt (dir + "topology/physical_package_id", 0));
+        const int64 coreId = (((int64) package) << 32) | (uint32) readSysInt (dir + "topology/core_id", i);
+
+        int coreIndex = coreIds.indexOf (coreId);
+
+        if (coreIndex < 0)
+        {
+            coreIndex = coreIds.size();
+            coreIds.add (coreId);
+        }
+
+        SystemStats::CpuTopology::LogicalCpu cpu;
+        cpu.cpuIndex = i;
+        cpu.coreIndex = coreIndex;
+        cpu.packageIndex = package;
+        cpu.numaNode = 0;
+        cpu.efficiencyClass = atomCpus.isZero() ? readSysInt (dir + "cpu_capacity", 1024)
+                                                : (atomCpus[i] ? 0 : 1);
+        topology.cpus.add (cpu);
+    }
+
+    readNumaNodes (topology);
+    readCacheSizes (topology);
+}
+#endif
+
 //==============================================================================
 void JUCE_CALLTYPE Thread::sleep (int millisecs)
 {
@@ -210,6 +451,7 @@ namespace
         return statfs (f.getFullPathName().toUTF8(), &result) == 0;
     }
 
+   #if ! JUCE_LINUX  // (linux gets this from the open directory handle instead)
     void updateStatInfoForFile (const String& path, bool* const isDir, int64* const fileSize,
                                 Time* const modTime, Time* const creationTime, bool* const isReadOnly)
     {
@@ -227,6 +469,7 @@ namespace
         if (isReadOnly != nullptr)
             *isReadOnly = access (path.toUTF8(), W_OK) != 0;
     }
+   #endif
 
     Result getResultForErrno()
     {
@@ -240,6 +483,38 @@ namespace
 
     int getFD (void* handle) noexcept        { return (int) (pointer_sized_int) handle; }
     void* fdToVoidPointer (int fd) noexcept  { return (void*) (pointer_sized_int) fd; }
+
+    void applyFileAccessHints (const int fd, const int accessFlags)
+    {
+       #if JUCE_LINUX
+        if ((accessFlags & File::sequentialAccess) != 0)
+            posix_fadvise (fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+        else if ((accessFlags & File::randomAccess) != 0)
+            posix_fadvise (fd, 0, 0, POSIX_FADV_RANDOM);
+       #elif JUCE_MAC || JUCE_IOS
+        if ((accessFlags & File::sequentialAccess) != 0)
+            fcntl (fd, F_RDAHEAD, 1);
+        else if ((accessFlags & File::randomAccess) != 0)
+            fcntl (fd, F_RDAHEAD, 0);
+
+        // (F_NOCACHE doesn't need the I/O to be aligned, so it covers unbufferedAccess too)
+        if ((accessFlags & (File::dontCache | File::unbufferedAccess)) != 0)
+            fcntl (fd, F_NOCACHE, 1);
+       #else
+        (void) fd; (void) accessFlags;
+       #endif
+    }
+
+    // Opens a file with O_DIRECT, if the platform and file system support it.
+    int openUnbuffered (const File& file, const int openFlags)
+    {
+       #if JUCE_LINUX && defined (O_DIRECT)
+        return open (file.getFullPathName().toUTF8(), openFlags | O_DIRECT, 00644);
+       #else
+        (void) file; (void) openFlags;
+        return -1;
+       #endif
+    }
 }
 
 bool File::isDirectory() const
@@ -343,7 +618,7 @@ bool File::moveInternal (const File& dest) const
     if (rename (fullPath.toUTF8(), dest.getFullPathName().toUTF8()) == 0)
         return true;
 
-    if (hasWriteAccess() && copyInternal (dest))
+    if (hasWriteAccess() && copyInternal (dest, nullptr))
     {
         if (deleteFile())
             return true;
@@ -368,14 +643,51 @@ int64 juce_fileSetPosition (void* handle, int64 pos)
     return -1;
 }
 
+void juce_releaseCachedFileData (void* handle, int64 start, int64 numBytes, bool writeBackFirst)
+{
+   #if JUCE_LINUX
+    if (handle != 0 && numBytes > 0)
+    {
+        const int fd = getFD (handle);
+
+        // (the OS won't drop dirty pages, so they need to be written out first)
+        if (writeBackFirst)
+            sync_file_range (fd, (off_t) start, (off_t) numBytes,
+                             SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE | SYNC_FILE_RANGE_WAIT_AFTER);
+
+        posix_fadvise (fd, (off_t) start, (off_t) numBytes, POSIX_FADV_DONTNEED);
+    }
+   #else
+    (void) handle; (void) start; (void) numBytes; (void) writeBackFirst;
+   #endif
+}
+
 void FileInputStream::openHandle()
 {
+    if ((accessFlags & File::unbufferedAccess) != 0)
+    {
+        const int f = openUnbuffered (file, O_RDONLY);
+
+        if (f != -1)
+        {
+            fileHandle = fdToVoidPointer (f);
+            needsAlignedAccess = true;
+            applyFileAccessHints (f, accessFlags);
+            return;
+        }
+    }
+
     const int f = open (file.getFullPathName().toUTF8(), O_RDONLY, 00644);
 
     if (f != -1)
+    {
         fileHandle = fdToVoidPointer (f);
+        applyFileAccessHints (f, accessFlags);
+    }
     else
+    {
         status = getResultForErrno();
+    }
 }
 
 void FileInputStream::closeHandle()
@@ -440,10 +752,31 @@ void FileOutputStream::openHandle()
         else
             status = getResultForErrno();
     }
+
+    if (fileHandle != 0)
+    {
+        applyFileAccessHints (getFD (fileHandle), accessFlags);
+
+        if ((accessFlags & File::unbufferedAccess) != 0)
+        {
+            // Whole aligned blocks are written through this second handle, and
+            // everything else goes through the normal one.
+            const int f = openUnbuffered (file, O_WRONLY);
+
+            if (f != -1)
+                unbufferedHandle = fdToVoidPointer (f);
+        }
+    }
 }
 
 void FileOutputStream::closeHandle()
 {
+    if (unbufferedHandle != 0)
+    {
+        close (getFD (unbufferedHandle));
+        unbufferedHandle = 0;
+    }
+
     if (fileHandle != 0)
     {
         close (getFD (fileHandle));
@@ -466,6 +799,63 @@ ssize_t FileOutputStream::writeInternal (const void* const data, const size_t nu
     return result;
 }
 
+ssize_t FileOutputStream::writeUnbufferedInternal (const void* const data, const size_t numBytes, const int64 filePosition)
+{
+    ssize_t result = 0;
+
+    if (unbufferedHandle != 0)
+    {
+        result = ::pwrite (getFD (unbufferedHandle), data, numBytes, (off_t) filePosition);
+
+        if (result == -1)
+            status = getResultForErrno();
+    }
+
+    return result;
+}
+
+ssize_t FileOutputStream::writeGatheredInternal (const void* const* blocks, const size_t* blockSizes, const int numBlocks)
+{
+    ssize_t totalWritten = 0;
+
+    if (fileHandle != 0)
+    {
+        // (IOV_MAX is 1024 on Linux and OSX - larger sets of blocks are written in chunks)
+        const int maxBlocksPerCall = 1024;
+        HeapBlock<struct iovec> bufs ((size_t) jmin (numBlocks, maxBlocksPerCall));
+
+        for (int first = 0; first < numBlocks;)
+        {
+            const int num = jmin (numBlocks - first, maxBlocksPerCall);
+            size_t numBytes = 0;
+
+            for (int i = 0; i < num; ++i)
+            {
+                bufs[i].iov_base = const_cast <void*> (blocks [first + i]);
+                bufs[i].iov_len = blockSizes [first + i];
+                numBytes += blockSizes [first + i];
+            }
+
+            const ssize_t result = ::writev (getFD (fileHandle), bufs, num);
+
+            if (result == -1)
+            {
+                status = getResultForErrno();
+                return totalWritten > 0 ? totalWritten : -1;
+            }
+
+            totalWritten += result;
+
+            if ((size_t) result != numBytes)
+                break;
+
+            first += num;
+        }
+    }
+
+    return totalWritten;
+}
+
 void FileOutputStream::flushInternal()
 {
     if (fileHandle != 0)
@@ -493,6 +883,38 @@ Result FileOutputStream::truncate()
     return getResultForReturnValue (ftruncate (getFD (fileHandle), (off_t) currentPosition));
 }
 
+Result FileOutputStream::preallocate (const int64 totalNumBytes)
+{
+    if (fileHandle == 0)
+        return status;
+
+   #if JUCE_LINUX && defined (FALLOC_FL_KEEP_SIZE)
+    return getResultForReturnValue (fallocate (getFD (fileHandle), FALLOC_FL_KEEP_SIZE, 0, (off_t) totalNumBytes));
+   #elif JUCE_MAC || JUCE_IOS
+    struct stat info;
+
+    if (fstat (getFD (fileHandle), &info) != 0)
+        return getResultForErrno();
+
+    // F_PEOFPOSMODE allocates from the end of the space that's already allocated
+    const int64 numBytesAllocated = (int64) info.st_blocks * 512;
+
+    if (totalNumBytes <= numBytesAllocated)
+        return Result::ok();
+
+    fstore_t store = { F_ALLOCATECONTIG | F_ALLOCATEALL, F_PEOFPOSMODE, 0, (off_t) (totalNumBytes - numBytesAllocated), 0 };
+
+    if (fcntl (getFD (fileHandle), F_PREALLOCATE, &store) != -1)
+        return Result::ok();
+
+    store.fst_flags = F_ALLOCATEALL;  // (try again without insisting on a contiguous block)
+    return getResultForReturnValue (fcntl (getFD (fileHandle), F_PREALLOCATE, &store));
+   #else
+    (void) totalNumBytes;
+    return Result::fail ("Preallocation isn't supported on this platform");
+   #endif
+}
+
 //==============================================================================
 String SystemStats::getEnvironmentVariable (const String& name, const String& defaultValue)
 {
@@ -919,15 +1341,36 @@ void Thread::yield()
  #define SUPPORT_AFFINITIES 1
 #endif
 
-void Thread::setCurrentThreadAffinityMask (const uint32 affinityMask)
+bool Thread::setCurrentThreadAffinity (const BigInteger& cpus)
 {
    #if SUPPORT_AFFINITIES
+    if (cpus.isZero())
+        return false;
+
+    bool ok;
+
+   #ifdef CPU_ALLOC
+    // (this uses a dynamically-sized set so that any number of CPUs can be covered)
+    const int numCpus = cpus.getHighestBit() + 1;
+    const size_t size = CPU_ALLOC_SIZE (numCpus);
+    cpu_set_t* const affinity = CPU_ALLOC (numCpus);
+
+    if (affinity == nullptr)
+        return false;
+
+    CPU_ZERO_S (size, affinity);
+
+    for (int i = cpus.findNextSetBit (0); i >= 0; i = cpus.findNextSetBit (i + 1))
+        CPU_SET_S (i, size, affinity);
+
+    ok = sched_setaffinity (0, size, affinity) == 0;
+    CPU_FREE (affinity);
+   #else
     cpu_set_t affinity;
     CPU_ZERO (&affinity);
 
-    for (int i = 0; i < 32; ++i)
-        if ((affinityMask & (1 << i)) != 0)
-            CPU_SET (i, &affinity);
+    for (int i = cpus.findNextSetBit (0); i >= 0 && i < CPU_SETSIZE; i = cpus.findNextSetBit (i + 1))
+        CPU_SET (i, &affinity);
 
     /*
        N.B. If this line causes a compile error, then you've probably not got the latest
@@ -936,18 +1379,66 @@ void Thread::setCurrentThreadAffinityMask (const uint32 affinityMask)
        If you don't want to update your copy of glibc and don't care about cpu affinities,
        then you can just disable all this stuff by setting the SUPPORT_AFFINITIES macro to 0.
     */
-    sched_setaffinity (getpid(), sizeof (cpu_set_t), &affinity);
+    ok = sched_setaffinity (0, sizeof (cpu_set_t), &affinity) == 0;
+   #endif
+
     sched_yield();
+    return ok;
 
    #else
     /* affinities aren't supported because either the appropriate header files weren't found,
        or the SUPPORT_AFFINITIES macro was turned off
     */
     jassertfalse;
-    (void) affinityMask;
+    (void) cpus;
+    return false;
    #endif
 }
 
+bool Thread::setThreadRealtime (void* handle, const RealtimeOptions& options)
+{
+    if (handle == 0)
+        handle = (void*) pthread_self();
+
+   #if JUCE_LINUX || JUCE_ANDROID
+    // (failing to lock the memory isn't treated as an error - the scheduling is what matters)
+    if (options.lockMemory)
+        mlockall (MCL_CURRENT | MCL_FUTURE);
+   #endif
+
+   #if JUCE_MAC || JUCE_IOS
+    if (options.periodMs > 0)
+    {
+        mach_timebase_info_data_t timebase;
+        (void) mach_timebase_info (&timebase);
+        const double ticksPerMs = 1000000.0 * timebase.denom / timebase.numer;
+
+        const double computationMs = jlimit (0.05, options.periodMs,
+                                             options.computationMs > 0 ? options.computationMs
+                                                                       : options.periodMs * 0.5);
+
+        thread_time_constraint_policy_data_t policy;
+        policy.period      = (uint32_t) (options.periodMs * ticksPerMs);
+        policy.computation = (uint32_t) (computationMs * ticksPerMs);
+        policy.constraint  = policy.period;
+        policy.preemptible = true;
+
+        return thread_policy_set (pthread_mach_thread_np ((pthread_t) handle),
+                                  THREAD_TIME_CONSTRAINT_POLICY,
+                                  (thread_policy_t) &policy,
+                                  THREAD_TIME_CONSTRAINT_POLICY_COUNT) == KERN_SUCCESS;
+    }
+   #endif
+
+    const int minPriority = sched_get_priority_min (SCHED_FIFO);
+    const int maxPriority = sched_get_priority_max (SCHED_FIFO);
+
+    struct sched_param param;
+    param.sched_priority = ((maxPriority - minPriority) * jlimit (0, 10, options.priority)) / 10 + minPriority;
+
+    return pthread_setschedparam ((pthread_t) handle, SCHED_FIFO, &param) == 0;
+}
+
 //==============================================================================
 bool DynamicLibrary::open (const String& name)
 {
@@ -1103,6 +1594,408 @@ bool ChildProcess::kill()
     return activeProcess == nullptr || activeProcess->killProcess();
 }
 
+//==============================================================================
+class AsyncChildProcess::ActiveProcess
+{
+public:
+    ActiveProcess (AsyncChildProcess& o, const StringArray& arguments)
+        : owner (o), childPID (0), pollIndex (-1), inputPipe (-1), outputPipe (-1), errorPipe (-1),
+          exitCode (-1), exited (false), closeInputWhenWritten (false), finished (true)
+    {
+        // (the arguments have to be prepared before forking, because it's not safe to allocate in the child)
+        Array<char*> argv;
+        for (int i = 0; i < arguments.size(); ++i)
+            if (arguments[i].isNotEmpty())
+                argv.add (const_cast<char*> (arguments[i].toRawUTF8()));
+
+        argv.add (nullptr);
+
+        int in[2]  = { -1, -1 };
+        int out[2] = { -1, -1 };
+        int err[2] = { -1, -1 };
+
+        // All the pipes are made close-on-exec as soon as they're created, so that any other
+        // processes being launched at the same time can't inherit them and hold them open.
+        static CriticalSection launchLock;
+        const ScopedLock sl (launchLock);
+
+        if (createPipe (in) && createPipe (out) && createPipe (err))
+        {
+            const pid_t result = fork();
+
+            if (result == 0)
+            {
+                // we're the child process..
+                dup2 (in[0], 0);
+                dup2 (out[1], 1);
+                dup2 (err[1], 2);
+
+                execvp (argv[0], argv.getRawDataPointer());
+                _exit (-1);
+            }
+
+            if (result > 0)
+            {
+                // we're the parent process..
+                childPID = result;
+                std::swap (inputPipe, in[1]);
+                std::swap (outputPipe, out[0]);
+                std::swap (errorPipe, err[0]);
+
+                fcntl (inputPipe,  F_SETFL, fcntl (inputPipe,  F_GETFL) | O_NONBLOCK);
+                fcntl (outputPipe, F_SETFL, fcntl (outputPipe, F_GETFL) | O_NONBLOCK);
+                fcntl (errorPipe,  F_SETFL, fcntl (errorPipe,  F_GETFL) | O_NONBLOCK);
+            }
+        }
+
+        closePipe (in[0]);  closePipe (in[1]);
+        closePipe (out[0]); closePipe (out[1]);
+        closePipe (err[0]); closePipe (err[1]);
+    }
+
+    ~ActiveProcess()
+    {
+        closePipe (inputPipe);
+        closePipe (outputPipe);
+        closePipe (errorPipe);
+    }
+
+    //==============================================================================
+    bool isRunning() const noexcept     { return childPID != 0 && ! exited; }
+    int getExitCode() const noexcept    { return exitCode; }
+
+    bool waitForProcessToFinish (const int timeoutMs) const
+    {
+        return finished.wait (timeoutMs);
+    }
+
+    bool killProcess()
+    {
+        // (holding the lock stops the process being reaped and its ID being reused while we do this)
+        const ScopedLock sl (lock);
+        return exited || ::kill (childPID, SIGKILL) == 0;
+    }
+
+    bool writeToStdIn (const void* data, size_t numBytes);
+    void closeStdIn();
+
+    //==============================================================================
+    // These are only called by the I/O thread..
+    void addPollEntries (Array<pollfd>& fds)
+    {
+        pollIndex = fds.size();
+
+        bool wantsToWrite;
+
+        {
+            const ScopedLock sl (lock);
+            wantsToWrite = pendingInput.getSize() > 0;
+
+            if (closeInputWhenWritten && ! wantsToWrite)
+                closePipe (inputPipe);
+        }
+
+        addPollEntry (fds, outputPipe, POLLIN);
+        addPollEntry (fds, errorPipe, POLLIN);
+        addPollEntry (fds, wantsToWrite ? inputPipe : -1, POLLOUT);
+    }
+
+    bool isWaitingForExit() const noexcept
+    {
+        return outputPipe < 0 && errorPipe < 0 && ! exited;
+    }
+
+    void service (const Array<pollfd>& fds)
+    {
+        const pollfd* const entries = fds.begin() + pollIndex;
+
+        if (entries[0].revents != 0)  readFrom (outputPipe, false, 16);
+        if (entries[1].revents != 0)  readFrom (errorPipe, true, 16);
+        if (entries[2].revents != 0)  writePendingInput();
+
+        checkForExit();
+    }
+
+    AsyncChildProcess& owner;
+    int childPID, pollIndex;
+
+private:
+    int inputPipe, outputPipe, errorPipe;
+    int exitCode;
+    bool volatile exited;
+    bool closeInputWhenWritten;
+    CriticalSection lock;
+    MemoryBlock pendingInput;
+    WaitableEvent finished;
+
+    static bool createPipe (int* fds)
+    {
+        if (pipe (fds) != 0)
+            return false;
+
+        fcntl (fds[0], F_SETFD, FD_CLOEXEC);
+        fcntl (fds[1], F_SETFD, FD_CLOEXEC);
+        return true;
+    }
+
+    static void closePipe (int& fd)
+    {
+        if (fd >= 0)
+        {
+            close (fd);
+            fd = -1;
+        }
+    }
+
+    static void addPollEntry (Array<pollfd>& fds, const int fd, const short events)
+    {
+        pollfd p = { fd, events, 0 };
+        fds.add (p);
+    }
+
+    // (the number of reads is limited so that one very chatty process can't starve the others)
+    void readFrom (int& fd, const bool isErrorStream, int maxNumReads)
+    {
+        char buffer [8192];
+
+        while (fd >= 0 && --maxNumReads >= 0)
+        {
+            const ssize_t num = ::read (fd, buffer, sizeof (buffer));
+
+            if (num > 0)
+            {
+                if (isErrorStream)
+                    owner.listener.processErrorOutputReceived (owner, buffer, (size_t) num);
+                else
+                    owner.listener.processOutputReceived (owner, buffer, (size_t) num);
+            }
+            else if (num < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR))
+            {
+                break;
+            }
+            else
+            {
+                closePipe (fd);
+            }
+        }
+    }
+
+    void writePendingInput()
+    {
+        const ScopedLock sl (lock);
+
+        if (inputPipe >= 0 && pendingInput.getSize() > 0)
+        {
+            const ssize_t num = ::write (inputPipe, pendingInput.getData(), pendingInput.getSize());
+
+            if (num > 0)
+            {
+                pendingInput.removeSection (0, (size_t) num);
+            }
+            else if (! (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR))
+            {
+                // the process has closed its stdin
+                pendingInput.setSize (0);
+                closePipe (inputPipe);
+            }
+        }
+    }
+
+    void checkForExit()
+    {
+        {
+            const ScopedLock sl (lock);
+
+            if (exited)
+                return;
+
+            int status = 0;
+
+            if (waitpid (childPID, &status, WNOHANG) != childPID)
+                return;
+
+            exitCode = WIFEXITED (status) ? WEXITSTATUS (status) : -1;
+            exited = true;
+            closePipe (inputPipe);
+        }
+
+        // Anything the process wrote before it exited is already in the pipes, so read it all
+        // before announcing that it has finished. (The pipes are then closed, because they may
+        // be held open by other processes that it launched).
+        readFrom (outputPipe, false, std::numeric_limits<int>::max());
+        readFrom (errorPipe, true, std::numeric_limits<int>::max());
+        closePipe (outputPipe);
+        closePipe (errorPipe);
+
+        owner.listener.processFinished (owner, exitCode);
+        finished.signal();
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ActiveProcess)
+};
+
+//==============================================================================
+class AsyncChildProcess::IOThread  : public Thread
+{
+public:
+    IOThread()  : Thread ("JUCE child process I/O")
+    {
+        wakeUpPipe[0] = wakeUpPipe[1] = -1;
+
+        if (pipe (wakeUpPipe) == 0)
+        {
+            for (int i = 0; i < 2; ++i)
+            {
+                fcntl (wakeUpPipe[i], F_SETFD, FD_CLOEXEC);
+                fcntl (wakeUpPipe[i], F_SETFL, fcntl (wakeUpPipe[i], F_GETFL) | O_NONBLOCK);
+            }
+        }
+
+        startThread();
+    }
+
+    ~IOThread()
+    {
+        signalThreadShouldExit();
+        wakeUp();
+        stopThread (4000);
+
+        close (wakeUpPipe[0]);
+        close (wakeUpPipe[1]);
+    }
+
+    void addProcess (ActiveProcess* const p)
+    {
+        {
+            const ScopedLock sl (lock);
+            processes.add (p);
+        }
+
+        wakeUp();
+    }
+
+    // Blocks until any callbacks that are in progress have finished, so the process
+    // can be safely deleted afterwards.
+    void removeProcess (ActiveProcess* const p)
+    {
+        // You can't delete an AsyncChildProcess from inside one of its own callbacks!
+        jassert (getCurrentThreadId() != getThreadId());
+
+        const ScopedLock sl (lock);
+        processes.removeFirstMatchingValue (p);
+
+        // (it'll need to be reaped eventually, to stop it becoming a zombie)
+        if (p->isRunning())
+            orphanedProcessIDs.add (p->childPID);
+    }
+
+    void wakeUp()
+    {
+        const char c = 0;
+        ssize_t result = ::write (wakeUpPipe[1], &c, 1);
+        (void) result;
+    }
+
+    void run()
+    {
+        // Writing to the stdin of a process that has died raises SIGPIPE, which would kill us
+        // unless it's blocked. Only this thread ever writes to those pipes.
+        sigset_t signalsToBlock;
+        sigemptyset (&signalsToBlock);
+        sigaddset (&signalsToBlock, SIGPIPE);
+        pthread_sigmask (SIG_BLOCK, &signalsToBlock, nullptr);
+
+        Array<pollfd> fds;
+
+        while (! threadShouldExit())
+        {
+            fds.clearQuick();
+            int timeoutMs = -1;
+
+            {
+                const ScopedLock sl (lock);
+
+                pollfd wakeUpEntry = { wakeUpPipe[0], POLLIN, 0 };
+                fds.add (wakeUpEntry);
+
+                for (int i = 0; i < processes.size(); ++i)
+                {
+                    ActiveProcess* const p = processes.getUnchecked (i);
+                    p->addPollEntries (fds);
+
+                    // A process's exit can only be detected with waitpid, which is checked after
+                    // every poll - so this keeps polling quickly once its pipes have closed, and
+                    // slowly for processes whose pipes are held open by their own children.
+                    timeoutMs = p->isWaitingForExit() ? 5 : (timeoutMs < 0 ? 100 : timeoutMs);
+                }
+
+                if (orphanedProcessIDs.size() > 0 && timeoutMs < 0)
+                    timeoutMs = 100;
+            }
+
+            poll (fds.getRawDataPointer(), (nfds_t) fds.size(), timeoutMs);
+
+            if (fds.getReference(0).revents != 0)
+            {
+                char buffer [64];
+                while (::read (wakeUpPipe[0], buffer, sizeof (buffer)) > 0) {}
+            }
+
+            const ScopedLock sl (lock);
+
+            // (any processes that were added during the poll haven't got any entries yet)
+            for (int i = 0; i < processes.size(); ++i)
+            {
+                ActiveProcess* const p = processes.getUnchecked (i);
+
+                if (p->pollIndex >= 0)
+                    p->service (fds);
+            }
+
+            for (int i = orphanedProcessIDs.size(); --i >= 0;)
+            {
+                int status = 0;
+
+                if (waitpid (orphanedProcessIDs.getUnchecked (i), &status, WNOHANG) != 0)
+                    orphanedProcessIDs.remove (i);
+            }
+        }
+    }
+
+private:
+    CriticalSection lock;
+    Array<ActiveProcess*> processes;
+    Array<int> orphanedProcessIDs;
+    int wakeUpPipe[2];
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (IOThread)
+};
+
+bool AsyncChildProcess::ActiveProcess::writeToStdIn (const void* data, size_t numBytes)
+{
+    {
+        const ScopedLock sl (lock);
+
+        if (inputPipe < 0 || closeInputWhenWritten)
+            return false;
+
+        pendingInput.append (data, numBytes);
+    }
+
+    owner.ioThread->wakeUp();
+    return true;
+}
+
+void AsyncChildProcess::ActiveProcess::closeStdIn()
+{
+    {
+        const ScopedLock sl (lock);
+        closeInputWhenWritten = true;
+    }
+
+    owner.ioThread->wakeUp();
+}
+
 //==============================================================================
 struct HighResolutionTimer::Pimpl
 {
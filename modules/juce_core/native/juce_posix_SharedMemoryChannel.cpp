@@ -0,0 +1,204 @@
+/*
+  ==============================================================================
+
+   This file is part of the juce_core module of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission to use, copy, modify, and/or distribute this software for any purpose with
+   or without fee is hereby granted, provided that the above copyright notice and this
+   permission notice appear in all copies.
+
+   THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+   TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+   NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+   DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+   IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+   ------------------------------------------------------------------------------
+
+   NOTE! This permissive ISC license applies ONLY to files within the juce_core module!
+   All other JUCE modules are covered by a dual GPL/commercial license, so if you are
+   using any other modules, be sure to check that you also comply with their license.
+
+   For more details, visit www.juce.com
+
+  ==============================================================================
+*/
+
+class SharedMemoryChannel::Pimpl
+{
+public:
+    Pimpl (const String& channelName, const size_t sizeToCreate, const bool createChannel)
+       : objectName ("/juce_" + String::toHexString (channelName.hashCode64())),
+         data (nullptr), size (0), createdChannel (createChannel)
+    {
+       #if ! (JUCE_LINUX || JUCE_ANDROID)
+        for (int i = 0; i < numSemaphores; ++i)
+            semaphores[i] = SEM_FAILED;
+       #endif
+
+       #if JUCE_ANDROID
+        (void) sizeToCreate; // shm_open isn't available on Android
+       #else
+        const int fd = createChannel ? createObject (sizeToCreate)
+                                     : shm_open (objectName.toUTF8(), O_RDWR, 0);
+
+        if (fd == -1)
+            return;
+
+        struct stat info;
+
+        if (fstat (fd, &info) == 0 && info.st_size > 0)
+        {
+            void* const mapped = mmap (nullptr, (size_t) info.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+            if (mapped != MAP_FAILED)
+            {
+                data = mapped;
+                size = (size_t) info.st_size;
+            }
+        }
+
+        ::close (fd);
+
+        #if ! JUCE_LINUX
+         for (int i = 0; i < numSemaphores; ++i)
+         {
+             semaphores[i] = sem_open (getSemaphoreName (i).toUTF8(), O_CREAT, 0600, 0);
+
+             if (semaphores[i] == SEM_FAILED)
+                 releaseMemory();
+         }
+        #endif
+       #endif
+    }
+
+    ~Pimpl()
+    {
+        releaseMemory();
+
+       #if ! (JUCE_LINUX || JUCE_ANDROID)
+        for (int i = 0; i < numSemaphores; ++i)
+        {
+            if (semaphores[i] != SEM_FAILED)
+                sem_close (semaphores[i]);
+
+            if (createdChannel)
+                sem_unlink (getSemaphoreName (i).toUTF8());
+        }
+       #endif
+
+       #if ! JUCE_ANDROID
+        if (createdChannel)
+            shm_unlink (objectName.toUTF8());
+       #endif
+    }
+
+    void* getData() const noexcept      { return data; }
+    size_t getSize() const noexcept     { return size; }
+
+   #if JUCE_LINUX || JUCE_ANDROID
+    // The signal words live in the shared block, so a (non-private) futex can be used on them directly..
+    void wait (int, Atomic<int32>& word, const int32 expectedValue, const int timeOutMilliseconds) noexcept
+    {
+        if (timeOutMilliseconds < 0)
+        {
+            syscall (SYS_futex, &(word.value), FUTEX_WAIT, expectedValue, nullptr, nullptr, 0);
+        }
+        else
+        {
+            struct timespec time;
+            time.tv_sec  = timeOutMilliseconds / 1000;
+            time.tv_nsec = (timeOutMilliseconds % 1000) * 1000000;
+
+            syscall (SYS_futex, &(word.value), FUTEX_WAIT, expectedValue, &time, nullptr, 0);
+        }
+    }
+
+    void wake (int, Atomic<int32>& word) noexcept
+    {
+        syscall (SYS_futex, &(word.value), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+    }
+   #else
+    // Other systems have no futexes, and no sem_timedwait(), so this uses a named
+    // semaphore for each signal, and polls it when there's a timeout.
+    void wait (const int signalIndex, Atomic<int32>&, int32, const int timeOutMilliseconds) noexcept
+    {
+        sem_t* const sem = semaphores [signalIndex];
+
+        if (timeOutMilliseconds < 0)
+        {
+            while (sem_wait (sem) != 0 && errno == EINTR) {}
+            return;
+        }
+
+        const uint32 timeoutEnd = Time::getMillisecondCounter() + (uint32) timeOutMilliseconds;
+
+        while (sem_trywait (sem) != 0)
+        {
+            if (Time::getMillisecondCounter() >= timeoutEnd)
+                break;
+
+            Thread::sleep (1);
+        }
+    }
+
+    void wake (const int signalIndex, Atomic<int32>&) noexcept
+    {
+        sem_post (semaphores [signalIndex]);
+    }
+   #endif
+
+private:
+    const String objectName;
+    void* data;
+    size_t size;
+    const bool createdChannel;
+
+   #if ! (JUCE_LINUX || JUCE_ANDROID)
+    enum { numSemaphores = 4 };
+    sem_t* semaphores [numSemaphores];
+
+    String getSemaphoreName (const int index) const
+    {
+        return objectName + "_" + String (index);
+    }
+   #endif
+
+   #if ! JUCE_ANDROID
+    int createObject (const size_t sizeToCreate) const
+    {
+        // If a previous process crashed without closing its channel, the name will still
+        // be in use, so this replaces it with a new object..
+        shm_unlink (objectName.toUTF8());
+
+       #if ! JUCE_LINUX
+        for (int i = 0; i < numSemaphores; ++i)
+            sem_unlink (getSemaphoreName (i).toUTF8());
+       #endif
+
+        const int fd = shm_open (objectName.toUTF8(), O_RDWR | O_CREAT | O_EXCL, 0600);
+
+        if (fd != -1 && ftruncate (fd, (off_t) sizeToCreate) != 0)
+        {
+            ::close (fd);
+            shm_unlink (objectName.toUTF8());
+            return -1;
+        }
+
+        return fd;
+    }
+   #endif
+
+    void releaseMemory() noexcept
+    {
+        if (data != nullptr)
+            munmap (data, size);
+
+        data = nullptr;
+        size = 0;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (Pimpl)
+};
@@ -198,9 +198,35 @@ bool File::moveToTrash() const
     return SHFileOperation (&fos) == 0;
 }
 
-bool File::copyInternal (const File& dest) const
+namespace WindowsFileCopyHelpers
 {
-    return CopyFile (fullPath.toWideCharPointer(), dest.getFullPathName().toWideCharPointer(), false) != 0;
+    static DWORD CALLBACK copyProgressRoutine (LARGE_INTEGER totalSize, LARGE_INTEGER bytesCopied,
+                                               LARGE_INTEGER, LARGE_INTEGER, DWORD, DWORD,
+                                               HANDLE, HANDLE, LPVOID context)
+    {
+        File::CopyProgressCallback* const callback = static_cast<File::CopyProgressCallback*> (context);
+
+        return callback->copyProgress ((int64) bytesCopied.QuadPart, (int64) totalSize.QuadPart)
+                 ? PROGRESS_CONTINUE : PROGRESS_CANCEL;
+    }
+}
+
+bool File::copyInternal (const File& dest, CopyProgressCallback* const progress) const
+{
+    // CopyFileEx leaves the copying to the system, which can use block cloning on ReFS
+    // volumes and server-side copies on SMB shares. If the progress routine cancels the
+    // copy, it deletes the partly-written file itself.
+    DWORD flags = 0;
+
+   #ifdef COPY_FILE_NO_BUFFERING
+    // for very large files, skipping the cache is faster and avoids evicting everything else from it
+    if (getSize() > 256 * 1024 * 1024)
+        flags |= COPY_FILE_NO_BUFFERING;
+   #endif
+
+    return CopyFileEx (fullPath.toWideCharPointer(), dest.getFullPathName().toWideCharPointer(),
+                       progress != nullptr ? WindowsFileCopyHelpers::copyProgressRoutine : nullptr,
+                       progress, nullptr, flags) != 0;
 }
 
 bool File::moveInternal (const File& dest) const
@@ -223,10 +249,31 @@ int64 juce_fileSetPosition (void* handle, int64 pos)
     return li.QuadPart;
 }
 
+void juce_releaseCachedFileData (void*, int64, int64, bool)
+{
+    // (on Windows, dontCache streams are opened with FILE_FLAG_NO_BUFFERING instead)
+}
+
 void FileInputStream::openHandle()
 {
+    const DWORD flags = FILE_ATTRIBUTE_NORMAL | ((accessFlags & File::randomAccess) != 0 ? FILE_FLAG_RANDOM_ACCESS
+                                                                                          : FILE_FLAG_SEQUENTIAL_SCAN);
+
+    if ((accessFlags & (File::dontCache | File::unbufferedAccess)) != 0)
+    {
+        HANDLE h = CreateFile (file.getFullPathName().toWideCharPointer(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, 0,
+                               OPEN_EXISTING, flags | FILE_FLAG_NO_BUFFERING, 0);
+
+        if (h != INVALID_HANDLE_VALUE)
+        {
+            fileHandle = (void*) h;
+            needsAlignedAccess = true;
+            return;
+        }
+    }
+
     HANDLE h = CreateFile (file.getFullPathName().toWideCharPointer(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, 0,
-                           OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, 0);
+                           OPEN_EXISTING, flags, 0);
 
     if (h != INVALID_HANDLE_VALUE)
         fileHandle = (void*) h;
@@ -256,8 +303,13 @@ size_t FileInputStream::readInternal (void* buffer, size_t numBytes)
 //==============================================================================
 void FileOutputStream::openHandle()
 {
-    HANDLE h = CreateFile (file.getFullPathName().toWideCharPointer(), GENERIC_WRITE, FILE_SHARE_READ, 0,
-                           OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, 0);
+    const bool wantsUnbuffered = (accessFlags & (File::dontCache | File::unbufferedAccess)) != 0;
+    const DWORD flags = FILE_ATTRIBUTE_NORMAL | ((accessFlags & File::randomAccess) != 0 ? FILE_FLAG_RANDOM_ACCESS :
+                                                 (accessFlags & File::sequentialAccess) != 0 ? FILE_FLAG_SEQUENTIAL_SCAN : 0);
+
+    HANDLE h = CreateFile (file.getFullPathName().toWideCharPointer(), GENERIC_WRITE,
+                           wantsUnbuffered ? (FILE_SHARE_READ | FILE_SHARE_WRITE) : FILE_SHARE_READ, 0,
+                           OPEN_ALWAYS, flags, 0);
 
     if (h != INVALID_HANDLE_VALUE)
     {
@@ -269,6 +321,19 @@ void FileOutputStream::openHandle()
         {
             fileHandle = (void*) h;
             currentPosition = li.QuadPart;
+
+            if (wantsUnbuffered)
+            {
+                // Whole aligned blocks are written through this second handle, and
+                // everything else goes through the normal one.
+                HANDLE u = CreateFile (file.getFullPathName().toWideCharPointer(), GENERIC_WRITE,
+                                       FILE_SHARE_READ | FILE_SHARE_WRITE, 0,
+                                       OPEN_EXISTING, flags | FILE_FLAG_NO_BUFFERING, 0);
+
+                if (u != INVALID_HANDLE_VALUE)
+                    unbufferedHandle = (void*) u;
+            }
+
             return;
         }
     }
@@ -278,6 +343,9 @@ void FileOutputStream::openHandle()
 
 void FileOutputStream::closeHandle()
 {
+    if (unbufferedHandle != nullptr)
+        CloseHandle ((HANDLE) unbufferedHandle);
+
     CloseHandle ((HANDLE) fileHandle);
 }
 
@@ -295,6 +363,42 @@ ssize_t FileOutputStream::writeInternal (const void* buffer, size_t numBytes)
     return 0;
 }
 
+ssize_t FileOutputStream::writeGatheredInternal (const void* const* blocks, const size_t* blockSizes, const int numBlocks)
+{
+    // WriteFileGather only works on unbuffered handles with page-sized blocks, so each
+    // block is written separately here - but still without being copied into the buffer.
+    ssize_t totalWritten = 0;
+
+    for (int i = 0; i < numBlocks; ++i)
+    {
+        const ssize_t result = writeInternal (blocks[i], blockSizes[i]);
+        totalWritten += result;
+
+        if (result != (ssize_t) blockSizes[i])
+            break;
+    }
+
+    return totalWritten;
+}
+
+ssize_t FileOutputStream::writeUnbufferedInternal (const void* const data, const size_t numBytes, const int64 filePosition)
+{
+    if (unbufferedHandle != nullptr)
+    {
+        OVERLAPPED position = { 0 };
+        position.Offset     = (DWORD) filePosition;
+        position.OffsetHigh = (DWORD) (filePosition >> 32);
+
+        DWORD actualNum = 0;
+        if (! WriteFile ((HANDLE) unbufferedHandle, data, (DWORD) numBytes, &actualNum, &position))
+            status = WindowsFileHelpers::getResultForLastError();
+
+        return (ssize_t) actualNum;
+    }
+
+    return 0;
+}
+
 void FileOutputStream::flushInternal()
 {
     if (fileHandle != nullptr)
@@ -312,6 +416,29 @@ Result FileOutputStream::truncate()
                                               : WindowsFileHelpers::getResultForLastError();
 }
 
+Result FileOutputStream::preallocate (const int64 totalNumBytes)
+{
+    if (fileHandle == nullptr)
+        return status;
+
+    // SetFileInformationByHandle is only available on Vista and later
+    typedef BOOL (WINAPI* SetFileInfoFunc) (HANDLE, int, LPVOID, DWORD);
+    static SetFileInfoFunc setFileInfo
+        = (SetFileInfoFunc) GetProcAddress (GetModuleHandleA ("kernel32"), "SetFileInformationByHandle");
+
+    if (setFileInfo == nullptr)
+        return Result::fail ("Preallocation isn't supported on this version of Windows");
+
+    struct AllocationInfo  { LARGE_INTEGER allocationSize; };  // (a FILE_ALLOCATION_INFO)
+    AllocationInfo info;
+    info.allocationSize.QuadPart = totalNumBytes;
+
+    const int fileAllocationInfoClass = 5;
+
+    return setFileInfo ((HANDLE) fileHandle, fileAllocationInfoClass, &info, sizeof (info))
+                ? Result::ok() : WindowsFileHelpers::getResultForLastError();
+}
+
 //==============================================================================
 void MemoryMappedFile::openInternal (const File& file, AccessMode mode)
 {
@@ -959,3 +1086,88 @@ int NamedPipe::write (const void* sourceBuffer, int numBytesToWrite, int timeOut
     ScopedReadLock sl (lock);
     return pimpl != nullptr ? pimpl->write (sourceBuffer, numBytesToWrite, timeOutMilliseconds) : -1;
 }
+
+//==============================================================================
+class SharedMemoryChannel::Pimpl
+{
+public:
+    Pimpl (const String& channelName, const size_t sizeToCreate, const bool createChannel)
+        : mappingHandle (0), data (nullptr), size (0)
+    {
+        const String objectName ("Local\\juce_shm_" + String::toHexString (channelName.hashCode64()));
+
+        for (int i = 0; i < numElementsInArray (events); ++i)
+            events[i] = 0;
+
+        if (createChannel)
+        {
+            mappingHandle = CreateFileMapping (INVALID_HANDLE_VALUE, 0, PAGE_READWRITE,
+                                               (DWORD) (((uint64) sizeToCreate) >> 32), (DWORD) sizeToCreate,
+                                               objectName.toWideCharPointer());
+
+            if (mappingHandle != 0 && GetLastError() == ERROR_ALREADY_EXISTS)
+            {
+                CloseHandle (mappingHandle);
+                mappingHandle = 0;
+            }
+        }
+        else
+        {
+            mappingHandle = OpenFileMapping (FILE_MAP_ALL_ACCESS, FALSE, objectName.toWideCharPointer());
+        }
+
+        if (mappingHandle == 0)
+            return;
+
+        for (int i = 0; i < numElementsInArray (events); ++i)
+        {
+            // (auto-reset events, which will be shared with the other end if it already created them)
+            events[i] = CreateEvent (0, FALSE, FALSE, (objectName + "_" + String (i)).toWideCharPointer());
+
+            if (events[i] == 0)
+                return;
+        }
+
+        data = MapViewOfFile (mappingHandle, FILE_MAP_ALL_ACCESS, 0, 0, createChannel ? sizeToCreate : 0);
+
+        if (data != nullptr)
+        {
+            MEMORY_BASIC_INFORMATION info;
+            size = VirtualQuery (data, &info, sizeof (info)) != 0 ? (size_t) info.RegionSize : 0;
+        }
+    }
+
+    ~Pimpl()
+    {
+        if (data != nullptr)
+            UnmapViewOfFile (data);
+
+        for (int i = 0; i < numElementsInArray (events); ++i)
+            if (events[i] != 0)
+                CloseHandle (events[i]);
+
+        if (mappingHandle != 0)
+            CloseHandle (mappingHandle);
+    }
+
+    void* getData() const noexcept      { return data; }
+    size_t getSize() const noexcept     { return size; }
+
+    void wait (const int signalIndex, Atomic<int32>&, int32, const int timeOutMilliseconds) noexcept
+    {
+        WaitForSingleObject (events [signalIndex], timeOutMilliseconds < 0 ? INFINITE : (DWORD) timeOutMilliseconds);
+    }
+
+    void wake (const int signalIndex, Atomic<int32>&) noexcept
+    {
+        SetEvent (events [signalIndex]);
+    }
+
+private:
+    HANDLE mappingHandle;
+    HANDLE events[4];
+    void* data;
+    size_t size;
+
+    JUCE_DECLARE_NON_COPYABLE (Pimpl)
+};
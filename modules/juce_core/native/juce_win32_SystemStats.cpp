@@ -115,6 +115,8 @@ SystemStats::CPUFlags::CPUFlags()
     has3DNow = IsProcessorFeaturePresent (PF_3DNOW_INSTRUCTIONS_AVAILABLE) != 0;
    #endif
 
+    detectExtendedFeatures();
+
     SYSTEM_INFO systemInfo;
     GetNativeSystemInfo (&systemInfo);
     numCpus = (int) systemInfo.dwNumberOfProcessors;
@@ -317,6 +319,152 @@ static int64 juce_getClockCycleCounter() noexcept
    #endif
 }
 
+BigInteger SystemStats::getIsolatedCpus()
+{
+    return BigInteger();
+}
+
+//==============================================================================
+namespace CpuTopologyHelpers
+{
+    // The efficiency class field only appears in the Windows 10 SDK, so this mirrors the layout
+    // of a SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX holding a PROCESSOR_RELATIONSHIP.
+    struct ProcessorCoreInfoEx
+    {
+        DWORD relationship, size;
+        BYTE flags, efficiencyClass, reserved[20];
+        WORD groupCount;
+
+        struct GroupAffinity
+        {
+            KAFFINITY mask;
+            WORD group, reserved[3];
+        };
+
+        GroupAffinity groupMask[1];
+    };
+
+    static void setEfficiencyClasses (SystemStats::CpuTopology& topology)
+    {
+        DynamicLibrary dll ("kernel32.dll");
+        JUCE_LOAD_WINAPI_FUNCTION (dll, GetLogicalProcessorInformationEx, getLogicalProcessorInformationEx, BOOL, (int, void*, DWORD*))
+
+        if (getLogicalProcessorInformationEx == nullptr)
+            return;
+
+        const int relationProcessorCore = 0;
+        DWORD bufferSize = 0;
+        getLogicalProcessorInformationEx (relationProcessorCore, nullptr, &bufferSize);
+
+        if (bufferSize == 0)
+            return;
+
+        HeapBlock<char> buffer (bufferSize);
+
+        if (! getLogicalProcessorInformationEx (relationProcessorCore, buffer, &bufferSize))
+            return;
+
+        for (DWORD offset = 0; offset + sizeof (ProcessorCoreInfoEx) <= bufferSize;)
+        {
+            const ProcessorCoreInfoEx& info = *reinterpret_cast <const ProcessorCoreInfoEx*> (buffer + offset);
+
+            if (info.size == 0)
+                break;
+
+            // (only the first processor group is counted by getNumCpus())
+            if (info.relationship == (DWORD) relationProcessorCore && info.groupCount > 0 && info.groupMask[0].group == 0)
+            {
+                for (int i = 0; i < topology.cpus.size(); ++i)
+                {
+                    SystemStats::CpuTopology::LogicalCpu& cpu = topology.cpus.getReference (i);
+
+                    if ((info.groupMask[0].mask & (((KAFFINITY) 1) << cpu.cpuIndex)) != 0)
+                        cpu.efficiencyClass = info.efficiencyClass;
+                }
+            }
+
+            offset += info.size;
+        }
+    }
+}
+
+void juce_fillCpuTopology (SystemStats::CpuTopology& topology)
+{
+   #if ! JUCE_MINGW
+    DWORD bufferSize = 0;
+    GetLogicalProcessorInformation (nullptr, &bufferSize);
+
+    if (bufferSize == 0)
+        return;
+
+    HeapBlock<SYSTEM_LOGICAL_PROCESSOR_INFORMATION> items;
+    items.malloc (bufferSize, 1);
+
+    if (! GetLogicalProcessorInformation (items, &bufferSize))
+        return;
+
+    const int numItems = (int) (bufferSize / sizeof (SYSTEM_LOGICAL_PROCESSOR_INFORMATION));
+    const int numCpus = jmin (SystemStats::getNumCpus(), (int) sizeof (ULONG_PTR) * 8);
+
+    for (int i = 0; i < numCpus; ++i)
+    {
+        SystemStats::CpuTopology::LogicalCpu cpu;
+        cpu.cpuIndex = i;
+        cpu.coreIndex = -1;
+        cpu.packageIndex = 0;
+        cpu.numaNode = 0;
+        cpu.efficiencyClass = 0;
+        topology.cpus.add (cpu);
+    }
+
+    int numCores = 0, numPackages = 0;
+
+    for (int j = 0; j < numItems; ++j)
+    {
+        const SYSTEM_LOGICAL_PROCESSOR_INFORMATION& item = items[j];
+
+        if (item.Relationship == RelationCache)
+        {
+            const CACHE_DESCRIPTOR& cache = item.Cache;
+
+            if (topology.cacheLineSize == 0)
+                topology.cacheLineSize = (int) cache.LineSize;
+
+            if (cache.Level == 1 && cache.Type != CacheInstruction)  topology.l1DataCacheSize = (int) cache.Size;
+            else if (cache.Level == 2)                               topology.l2CacheSize = (int) cache.Size;
+            else if (cache.Level == 3)                               topology.l3CacheSize = (int) cache.Size;
+
+            continue;
+        }
+
+        const int coreIndex = numCores, packageIndex = numPackages;
+
+        if (item.Relationship == RelationProcessorCore)     ++numCores;
+        if (item.Relationship == RelationProcessorPackage)  ++numPackages;
+
+        for (int i = 0; i < numCpus; ++i)
+        {
+            if ((item.ProcessorMask & (((ULONG_PTR) 1) << i)) != 0)
+            {
+                SystemStats::CpuTopology::LogicalCpu& cpu = topology.cpus.getReference (i);
+
+                if (item.Relationship == RelationProcessorCore)     cpu.coreIndex = coreIndex;
+                if (item.Relationship == RelationProcessorPackage)  cpu.packageIndex = packageIndex;
+                if (item.Relationship == RelationNumaNode)          cpu.numaNode = (int) item.NumaNode.NodeNumber;
+            }
+        }
+    }
+
+    for (int i = 0; i < numCpus; ++i)
+        if (topology.cpus.getReference (i).coreIndex < 0)
+            topology.cpus.getReference (i).coreIndex = numCores++;
+
+    CpuTopologyHelpers::setEfficiencyClasses (topology);
+   #else
+    (void) topology;
+   #endif
+}
+
 int SystemStats::getCpuSpeedInMegaherz()
 {
     const int64 cycles = juce_getClockCycleCounter();
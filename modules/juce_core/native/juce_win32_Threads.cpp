@@ -110,6 +110,59 @@ void WaitableEvent::reset() const noexcept
     ResetEvent (internal);
 }
 
+//==============================================================================
+namespace AddressWaiterHelpers
+{
+    // WaitOnAddress is only available on Windows 8 and later, so it has to be loaded dynamically
+    typedef BOOL (WINAPI* WaitOnAddressFunc) (volatile VOID*, PVOID, SIZE_T, DWORD);
+    typedef void (WINAPI* WakeByAddressFunc) (PVOID);
+
+    struct Functions
+    {
+        Functions() noexcept  : waitOnAddress (nullptr), wakeByAddressSingle (nullptr), wakeByAddressAll (nullptr)
+        {
+            if (HMODULE dll = LoadLibraryA ("API-MS-Win-Core-Synch-l1-2-0.dll"))
+            {
+                waitOnAddress       = (WaitOnAddressFunc) GetProcAddress (dll, "WaitOnAddress");
+                wakeByAddressSingle = (WakeByAddressFunc) GetProcAddress (dll, "WakeByAddressSingle");
+                wakeByAddressAll    = (WakeByAddressFunc) GetProcAddress (dll, "WakeByAddressAll");
+            }
+        }
+
+        WaitOnAddressFunc waitOnAddress;
+        WakeByAddressFunc wakeByAddressSingle, wakeByAddressAll;
+    };
+
+    static const Functions& getFunctions() noexcept
+    {
+        static const Functions functions;
+        return functions;
+    }
+}
+
+void AddressWaiter::wait (volatile int32* const address, int32 expectedValue, const int timeOutMillisecs) noexcept
+{
+    const AddressWaiterHelpers::Functions& f = AddressWaiterHelpers::getFunctions();
+
+    if (f.waitOnAddress != nullptr)
+        f.waitOnAddress (address, &expectedValue, sizeof (int32), timeOutMillisecs < 0 ? INFINITE : (DWORD) timeOutMillisecs);
+    else if (*address == expectedValue)
+        Sleep (timeOutMillisecs == 0 ? 0 : 1); // (older systems just have to poll)
+}
+
+void AddressWaiter::wake (volatile int32* const address, const int numThreadsToWake) noexcept
+{
+    const AddressWaiterHelpers::Functions& f = AddressWaiterHelpers::getFunctions();
+
+    if (f.wakeByAddressSingle != nullptr)
+    {
+        if (numThreadsToWake == 1)
+            f.wakeByAddressSingle ((PVOID) address);
+        else
+            f.wakeByAddressAll ((PVOID) address);
+    }
+}
+
 //==============================================================================
 void JUCE_API juce_threadEntryPoint (void*);
 
@@ -199,9 +252,53 @@ bool Thread::setThreadPriority (void* handle, int priority)
     return SetThreadPriority (handle, pri) != FALSE;
 }
 
-void Thread::setCurrentThreadAffinityMask (const uint32 affinityMask)
+bool Thread::setCurrentThreadAffinity (const BigInteger& cpus)
 {
-    SetThreadAffinityMask (GetCurrentThread(), affinityMask);
+    // A thread can only be given an affinity within its own processor group, so only
+    // the first 64 CPUs (or 32 in a 32-bit process) can be used here.
+    jassert (cpus.getHighestBit() < (int) sizeof (DWORD_PTR) * 8);
+
+    DWORD_PTR mask = (DWORD_PTR) cpus.getBitRangeAsInt (0, 32);
+
+   #if JUCE_64BIT
+    mask |= ((DWORD_PTR) cpus.getBitRangeAsInt (32, 32)) << 32;
+   #endif
+
+    return mask != 0 && SetThreadAffinityMask (GetCurrentThread(), mask) != 0;
+}
+
+bool Thread::setThreadRealtime (void* handle, const RealtimeOptions& options)
+{
+    // (there's no equivalent to mlockall, so options.lockMemory is ignored here)
+
+    if (handle == 0)
+    {
+        // MMCSS can only be applied by a thread to itself..
+        enum { avrtPriorityLow = -1, avrtPriorityNormal, avrtPriorityHigh, avrtPriorityCritical };
+
+        DynamicLibrary dll ("avrt.dll");
+        JUCE_LOAD_WINAPI_FUNCTION (dll, AvSetMmThreadCharacteristicsW, avSetMmThreadCharacteristics, HANDLE, (LPCWSTR, LPDWORD))
+        JUCE_LOAD_WINAPI_FUNCTION (dll, AvSetMmThreadPriority, avSetMmThreadPriority, BOOL, (HANDLE, int))
+
+        if (avSetMmThreadCharacteristics != 0 && avSetMmThreadPriority != 0)
+        {
+            DWORD taskIndex = 0;
+
+            if (HANDLE h = avSetMmThreadCharacteristics (L"Pro Audio", &taskIndex))
+            {
+                const int priority = options.priority >= 9 ? avrtPriorityCritical
+                                   : options.priority >= 7 ? avrtPriorityHigh
+                                   : options.priority >= 4 ? avrtPriorityNormal
+                                                           : avrtPriorityLow;
+
+                return avSetMmThreadPriority (h, priority) != FALSE;
+            }
+        }
+
+        handle = GetCurrentThread();
+    }
+
+    return SetThreadPriority (handle, THREAD_PRIORITY_TIME_CRITICAL) != FALSE;
 }
 
 //==============================================================================
@@ -586,6 +683,332 @@ bool ChildProcess::kill()
     return activeProcess == nullptr || activeProcess->killProcess();
 }
 
+//==============================================================================
+class AsyncChildProcess::ActiveProcess
+{
+public:
+    ActiveProcess (AsyncChildProcess& o, const StringArray& arguments)
+        : owner (o), childPID (0), inputPipe (0), outputPipe (0), errorPipe (0),
+          exitCode (-1), exited (false), closeInputWhenWritten (false), finished (true)
+    {
+        zerostruct (processInfo);
+
+        HANDLE childInput = 0, childOutput = 0, childError = 0;
+
+        // (the lock stops any other processes being launched at the same time from inheriting
+        // this one's pipes, and holding them open)
+        static CriticalSection launchLock;
+        const ScopedLock sl (launchLock);
+
+        if (createPipe (childInput, inputPipe, inputPipe)
+             && createPipe (outputPipe, childOutput, outputPipe)
+             && createPipe (errorPipe, childError, errorPipe))
+        {
+            // (this stops writes to stdin blocking if the process isn't reading it)
+            DWORD mode = PIPE_READMODE_BYTE | PIPE_NOWAIT;
+            SetNamedPipeHandleState (inputPipe, &mode, nullptr, nullptr);
+
+            STARTUPINFOW startupInfo = { 0 };
+            startupInfo.cb = sizeof (startupInfo);
+            startupInfo.hStdInput  = childInput;
+            startupInfo.hStdOutput = childOutput;
+            startupInfo.hStdError  = childError;
+            startupInfo.dwFlags = STARTF_USESTDHANDLES;
+
+            const String command (arguments.joinIntoString (" "));
+
+            if (CreateProcess (nullptr, const_cast <LPWSTR> (command.toWideCharPointer()),
+                               nullptr, nullptr, TRUE, CREATE_NO_WINDOW | CREATE_UNICODE_ENVIRONMENT,
+                               nullptr, nullptr, &startupInfo, &processInfo) != FALSE)
+            {
+                childPID = (int) processInfo.dwProcessId;
+                CloseHandle (processInfo.hThread);
+            }
+        }
+
+        closeHandle (childInput);
+        closeHandle (childOutput);
+        closeHandle (childError);
+    }
+
+    ~ActiveProcess()
+    {
+        closeHandle (inputPipe);
+        closeHandle (outputPipe);
+        closeHandle (errorPipe);
+
+        if (childPID != 0)
+            CloseHandle (processInfo.hProcess);
+    }
+
+    //==============================================================================
+    bool isRunning() const noexcept     { return childPID != 0 && ! exited; }
+    int getExitCode() const noexcept    { return exitCode; }
+    HANDLE getProcessHandle() const     { return processInfo.hProcess; }
+
+    bool waitForProcessToFinish (const int timeoutMs) const
+    {
+        return finished.wait (timeoutMs);
+    }
+
+    bool killProcess()
+    {
+        const ScopedLock sl (lock);
+        return exited || TerminateProcess (processInfo.hProcess, (UINT) -1) != FALSE;
+    }
+
+    bool writeToStdIn (const void* data, size_t numBytes);
+    void closeStdIn();
+
+    //==============================================================================
+    // Called by the I/O thread. Returns true if any data was read or written.
+    bool service()
+    {
+        bool anyActivity = readFrom (outputPipe, false, 16);
+        anyActivity = readFrom (errorPipe, true, 16) || anyActivity;
+        anyActivity = writePendingInput() || anyActivity;
+
+        checkForExit();
+        return anyActivity;
+    }
+
+    AsyncChildProcess& owner;
+    int childPID;
+
+private:
+    HANDLE inputPipe, outputPipe, errorPipe;
+    PROCESS_INFORMATION processInfo;
+    int exitCode;
+    bool volatile exited;
+    bool closeInputWhenWritten;
+    CriticalSection lock;
+    MemoryBlock pendingInput;
+    WaitableEvent finished;
+
+    // Creates a pipe where only the parent's end isn't inheritable
+    static bool createPipe (HANDLE& readEnd, HANDLE& writeEnd, HANDLE& parentEnd)
+    {
+        SECURITY_ATTRIBUTES securityAtts = { 0 };
+        securityAtts.nLength = sizeof (securityAtts);
+        securityAtts.bInheritHandle = TRUE;
+
+        return CreatePipe (&readEnd, &writeEnd, &securityAtts, 0)
+                && SetHandleInformation (parentEnd, HANDLE_FLAG_INHERIT, 0);
+    }
+
+    static void closeHandle (HANDLE& h)
+    {
+        if (h != 0)
+        {
+            CloseHandle (h);
+            h = 0;
+        }
+    }
+
+    // (the number of reads is limited so that one very chatty process can't starve the others)
+    bool readFrom (HANDLE& pipe, const bool isErrorStream, int maxNumReads)
+    {
+        char buffer [8192];
+        bool anyRead = false;
+
+        while (pipe != 0 && --maxNumReads >= 0)
+        {
+            DWORD available = 0;
+
+            if (! PeekNamedPipe (pipe, nullptr, 0, nullptr, &available, nullptr))
+            {
+                closeHandle (pipe);  // the process has closed its end
+                break;
+            }
+
+            if (available == 0)
+                break;
+
+            DWORD numRead = 0;
+
+            if (! ReadFile (pipe, buffer, jmin (available, (DWORD) sizeof (buffer)), &numRead, nullptr))
+            {
+                closeHandle (pipe);
+                break;
+            }
+
+            anyRead = true;
+
+            if (isErrorStream)
+                owner.listener.processErrorOutputReceived (owner, buffer, (size_t) numRead);
+            else
+                owner.listener.processOutputReceived (owner, buffer, (size_t) numRead);
+        }
+
+        return anyRead;
+    }
+
+    bool writePendingInput()
+    {
+        const ScopedLock sl (lock);
+
+        if (inputPipe != 0 && pendingInput.getSize() > 0)
+        {
+            DWORD numWritten = 0;
+
+            if (WriteFile (inputPipe, pendingInput.getData(), (DWORD) pendingInput.getSize(), &numWritten, nullptr))
+            {
+                pendingInput.removeSection (0, (size_t) numWritten);
+                return numWritten > 0;
+            }
+
+            // the process has closed its stdin
+            pendingInput.setSize (0);
+            closeHandle (inputPipe);
+        }
+
+        if (closeInputWhenWritten && pendingInput.getSize() == 0)
+            closeHandle (inputPipe);
+
+        return false;
+    }
+
+    void checkForExit()
+    {
+        {
+            const ScopedLock sl (lock);
+
+            if (exited || WaitForSingleObject (processInfo.hProcess, 0) != WAIT_OBJECT_0)
+                return;
+
+            DWORD code = 0;
+            exitCode = GetExitCodeProcess (processInfo.hProcess, &code) ? (int) code : -1;
+            exited = true;
+            closeHandle (inputPipe);
+        }
+
+        // Anything the process wrote before it exited is already in the pipes, so read it all
+        // before announcing that it has finished. (The pipes are then closed, because they may
+        // be held open by other processes that it launched).
+        readFrom (outputPipe, false, std::numeric_limits<int>::max());
+        readFrom (errorPipe, true, std::numeric_limits<int>::max());
+        closeHandle (outputPipe);
+        closeHandle (errorPipe);
+
+        owner.listener.processFinished (owner, exitCode);
+        finished.signal();
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ActiveProcess)
+};
+
+//==============================================================================
+class AsyncChildProcess::IOThread  : public Thread
+{
+public:
+    IOThread()  : Thread ("JUCE child process I/O"),
+                  wakeUpEvent (CreateEvent (nullptr, FALSE, FALSE, nullptr))
+    {
+        startThread();
+    }
+
+    ~IOThread()
+    {
+        signalThreadShouldExit();
+        wakeUp();
+        stopThread (4000);
+
+        CloseHandle (wakeUpEvent);
+    }
+
+    void addProcess (ActiveProcess* const p)
+    {
+        {
+            const ScopedLock sl (lock);
+            processes.add (p);
+        }
+
+        wakeUp();
+    }
+
+    // Blocks until any callbacks that are in progress have finished, so the process
+    // can be safely deleted afterwards.
+    void removeProcess (ActiveProcess* const p)
+    {
+        // You can't delete an AsyncChildProcess from inside one of its own callbacks!
+        jassert (getCurrentThreadId() != getThreadId());
+
+        const ScopedLock sl (lock);
+        processes.removeFirstMatchingValue (p);
+    }
+
+    void wakeUp()
+    {
+        SetEvent (wakeUpEvent);
+    }
+
+    void run()
+    {
+        Array<HANDLE> handles;
+
+        while (! threadShouldExit())
+        {
+            bool anyActivity = false;
+            handles.clearQuick();
+            handles.add (wakeUpEvent);
+
+            {
+                const ScopedLock sl (lock);
+
+                for (int i = 0; i < processes.size(); ++i)
+                {
+                    ActiveProcess* const p = processes.getUnchecked (i);
+
+                    if (p->service())
+                        anyActivity = true;
+
+                    if (p->isRunning() && handles.size() < MAXIMUM_WAIT_OBJECTS)
+                        handles.add (p->getProcessHandle());
+                }
+            }
+
+            // Anonymous pipes can't be waited on, so while there are any processes, this has to
+            // wake up regularly to check them. Process exits and new data to write wake it
+            // immediately, though.
+            if (! anyActivity)
+                WaitForMultipleObjects ((DWORD) handles.size(), handles.getRawDataPointer(), FALSE,
+                                        handles.size() > 1 ? 10 : INFINITE);
+        }
+    }
+
+private:
+    CriticalSection lock;
+    Array<ActiveProcess*> processes;
+    HANDLE wakeUpEvent;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (IOThread)
+};
+
+bool AsyncChildProcess::ActiveProcess::writeToStdIn (const void* data, size_t numBytes)
+{
+    {
+        const ScopedLock sl (lock);
+
+        if (inputPipe == 0 || closeInputWhenWritten)
+            return false;
+
+        pendingInput.append (data, numBytes);
+    }
+
+    owner.ioThread->wakeUp();
+    return true;
+}
+
+void AsyncChildProcess::ActiveProcess::closeStdIn()
+{
+    {
+        const ScopedLock sl (lock);
+        closeInputWhenWritten = true;
+    }
+
+    owner.ioThread->wakeUp();
+}
+
 //==============================================================================
 struct HighResolutionTimer::Pimpl
 {
@@ -0,0 +1,1199 @@
+/*
+  ==============================================================================
+
+   This file is part of the juce_core module of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission to use, copy, modify, and/or distribute this software for any purpose with
+   or without fee is hereby granted, provided that the above copyright notice and this
+   permission notice appear in all copies.
+
+   THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+   TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+   NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+   DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+   IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+   ------------------------------------------------------------------------------
+
+   NOTE! This permissive ISC license applies ONLY to files within the juce_core module!
+   All other JUCE modules are covered by a dual GPL/commercial license, so if you are
+   using any other modules, be sure to check that you also comply with their license.
+
+   For more details, visit www.juce.com
+
+  ==============================================================================
+*/
+
+namespace HTTPClientHelpers
+{
+    static String getUserAgent()
+    {
+        return "JUCE/" JUCE_STRINGIFY(JUCE_MAJOR_VERSION)
+                   "." JUCE_STRINGIFY(JUCE_MINOR_VERSION)
+                   "." JUCE_STRINGIFY(JUCE_BUILDNUMBER);
+    }
+
+    static bool getHostAndPort (const URL& url, String& host, int& port)
+    {
+        if (! url.getScheme().equalsIgnoreCase ("http"))
+        {
+            jassertfalse; // HTTPClient only handles plain http
+            return false;
+        }
+
+        host = url.getDomain();
+        port = url.getPort();
+
+        if (port <= 0)
+            port = 80;
+
+        return host.isNotEmpty();
+    }
+
+    static void writeRequest (MemoryOutputStream& out, const URL& url, const bool isPost,
+                              const String& extraHeaders, const String& host, const int port)
+    {
+        String headers;
+        MemoryBlock postData;
+
+        if (isPost)
+            URLHelpers::createHeadersAndPostData (url, headers, postData);
+
+        headers += extraHeaders;
+
+        if (headers.isNotEmpty() && ! headers.endsWithChar ('\n'))
+            headers << "\r\n";
+
+        const String fullURL (url.toString (! isPost));
+        const int startOfPath = URLHelpers::findStartOfPath (fullURL);
+
+        out << (isPost ? "POST /" : "GET /")
+            << (startOfPath > 0 ? fullURL.substring (startOfPath) : String::empty)
+            << " HTTP/1.1\r\nHost: " << host;
+
+        if (port != 80)
+            out << ':' << port;
+
+        out << "\r\n";
+
+        if (! headers.containsIgnoreCase ("User-Agent:"))
+            out << "User-Agent: " << getUserAgent() << "\r\n";
+
+        if (isPost && ! headers.containsIgnoreCase ("Content-Length:"))
+            out << "Content-Length: " << (int64) postData.getSize() << "\r\n";
+
+        out << headers << "\r\n" << postData;
+    }
+
+    static bool isNumericAddress (const String& host)
+    {
+        return host.containsOnly ("0123456789.") || host.containsChar (':');
+    }
+
+    enum
+    {
+        maxRequestAttempts = 3
+    };
+}
+
+//==============================================================================
+struct HTTPClient::CachedAddress
+{
+    String host, address;
+    uint32 expiryTime;
+};
+
+struct HTTPClient::PendingRequest
+{
+    PendingRequest (const URL& url_, bool isPost_, const String& extraHeaders_, Listener& listener_)
+        : url (url_), extraHeaders (extraHeaders_), listener (listener_),
+          isPost (isPost_), cancelled (false), numAttempts (0)
+    {
+    }
+
+    const URL url;
+    const String extraHeaders;
+    Listener& listener;
+    const bool isPost;
+    bool cancelled;
+    int numAttempts;
+
+    JUCE_DECLARE_NON_COPYABLE (PendingRequest)
+};
+
+class HTTPClient::HostQueue
+{
+public:
+    HostQueue (const String& host_, int port_)
+        : host (host_), port (port_), key (host_ + ":" + String (port_)), numActiveJobs (0)
+    {
+    }
+
+    const String host;
+    const int port;
+    const String key;
+    OwnedArray<PendingRequest> waiting;
+    Array<PendingRequest*> active;
+    int numActiveJobs;
+
+private:
+    JUCE_DECLARE_NON_COPYABLE (HostQueue)
+};
+
+//==============================================================================
+/*  A keep-alive socket, with a read buffer that lets it parse one response after
+    another from the same stream of bytes.
+*/
+class HTTPClient::Connection
+{
+public:
+    Connection (const String& key_)
+        : key (key_), lastUsedTime (0), buffer ((size_t) bufferSize),
+          bufferStart (0), bufferEnd (0), bytesLeft (0), totalLength (-1),
+          isChunked (false), readsUntilClosed (false), bodyFinished (true), keepAlive (false)
+    {
+    }
+
+    bool connect (const String& address, const int port, const int timeoutMs)
+    {
+        if (! socket.connect (address, port, timeoutMs))
+            return false;
+
+        socket.setNoDelay (true);
+        return true;
+    }
+
+    bool write (const void* data, const int numBytes)
+    {
+        return socket.write (data, numBytes) == numBytes;
+    }
+
+    /*  An idle connection should have nothing to read - if it's readable, then either the
+        server has closed it, or it's sent something that we weren't expecting.
+    */
+    bool isStillUsable()
+    {
+        return socket.isConnected() && bufferStart == bufferEnd && socket.waitUntilReady (true, 0) == 0;
+    }
+
+    //==============================================================================
+    bool readResponseHead (Response& response, const int timeoutMs)
+    {
+        jassert (bodyFinished); // the last response hasn't been read yet!
+
+        String statusLine;
+
+        do
+        {
+            if (! (readLine (statusLine, timeoutMs) && statusLine.startsWith ("HTTP/")))
+                return false;
+
+            response.statusCode = statusLine.fromFirstOccurrenceOf (" ", false, false).getIntValue();
+            response.headers.clear();
+
+            for (;;)
+            {
+                String line;
+
+                if (! readLine (line, timeoutMs))
+                    return false;
+
+                if (line.isEmpty())
+                    break;
+
+                const String key (line.upToFirstOccurrenceOf (":", false, false).trim());
+                const String value (line.fromFirstOccurrenceOf (":", false, false).trim());
+                const String previousValue (response.headers [key]);
+
+                response.headers.set (key, previousValue.isEmpty() ? value : (previousValue + "," + value));
+            }
+        }
+        while (response.statusCode >= 100 && response.statusCode < 200); // (skips any "100 Continue" responses)
+
+        const String connectionHeader (response.headers ["Connection"]);
+        const String contentLength (response.headers ["Content-Length"]);
+
+        keepAlive = statusLine.startsWith ("HTTP/1.0") ? connectionHeader.containsIgnoreCase ("keep-alive")
+                                                       : ! connectionHeader.containsIgnoreCase ("close");
+        isChunked = false;
+        readsUntilClosed = false;
+        bytesLeft = 0;
+        totalLength = -1;
+
+        if (response.statusCode == 204 || response.statusCode == 304)
+        {
+            bodyFinished = true;
+        }
+        else if (response.headers ["Transfer-Encoding"].containsIgnoreCase ("chunked"))
+        {
+            isChunked = true;
+            bodyFinished = false;
+        }
+        else if (contentLength.isNotEmpty())
+        {
+            bytesLeft = totalLength = jmax ((int64) 0, contentLength.getLargeIntValue());
+            bodyFinished = (bytesLeft == 0);
+        }
+        else
+        {
+            readsUntilClosed = true;
+            bodyFinished = false;
+            keepAlive = false;
+        }
+
+        return true;
+    }
+
+    /*  Reads some of the body of the current response.
+        Returns the number of bytes read, 0 at the end of the body, or -1 if it fails.
+    */
+    int readBody (void* const dest, const int numBytes, const int timeoutMs)
+    {
+        if (bodyFinished)
+            return 0;
+
+        if (isChunked && bytesLeft == 0)
+        {
+            String line;
+
+            if (! readLine (line, timeoutMs))
+                return -1;
+
+            bytesLeft = line.upToFirstOccurrenceOf (";", false, false).trim().getHexValue64();
+
+            if (bytesLeft < 0)
+                return -1;
+
+            if (bytesLeft == 0)
+            {
+                do
+                {
+                    if (! readLine (line, timeoutMs))   // (skips any trailing headers)
+                        return -1;
+                }
+                while (line.isNotEmpty());
+
+                bodyFinished = true;
+                return 0;
+            }
+        }
+
+        const int numToRead = readsUntilClosed ? numBytes : (int) jmin ((int64) numBytes, bytesLeft);
+        const int numRead = read (dest, numToRead, timeoutMs);
+
+        if (numRead <= 0)
+        {
+            if (numRead == 0 && readsUntilClosed)
+            {
+                bodyFinished = true;
+                return 0;
+            }
+
+            return -1;
+        }
+
+        if (! readsUntilClosed)
+        {
+            bytesLeft -= numRead;
+
+            if (bytesLeft == 0)
+            {
+                if (isChunked)
+                {
+                    String line;
+
+                    if (! readLine (line, timeoutMs))   // (the CRLF after each chunk)
+                        return -1;
+                }
+                else
+                {
+                    bodyFinished = true;
+                }
+            }
+        }
+
+        return numRead;
+    }
+
+    bool readBody (MemoryBlock& dest, const int timeoutMs)
+    {
+        MemoryOutputStream out (dest, true);
+
+        if (totalLength > 0)
+            out.preallocate ((size_t) totalLength);
+
+        HeapBlock<char> temp ((size_t) bufferSize);
+
+        for (;;)
+        {
+            const int numRead = readBody (temp, bufferSize, timeoutMs);
+
+            if (numRead < 0)
+                return false;
+
+            if (numRead == 0)
+                return true;
+
+            out.write (temp, (size_t) numRead);
+        }
+    }
+
+    bool isBodyFinished() const noexcept        { return bodyFinished; }
+    bool canBeReused() const noexcept           { return bodyFinished && keepAlive; }
+    int64 getTotalLength() const noexcept       { return totalLength; }
+
+    const String key;
+    uint32 lastUsedTime;
+
+private:
+    enum { bufferSize = 16384 };
+
+    StreamingSocket socket;
+    HeapBlock<char> buffer;
+    int bufferStart, bufferEnd;
+    int64 bytesLeft, totalLength;
+    bool isChunked, readsUntilClosed, bodyFinished, keepAlive;
+
+    // Returns 1 if some data was read, 0 if the socket was closed, or -1 if it timed out.
+    int fillBuffer (const int timeoutMs)
+    {
+        bufferStart = bufferEnd = 0;
+
+        if (socket.waitUntilReady (true, timeoutMs) != 1)
+            return -1;
+
+        const int numRead = socket.read (buffer, bufferSize, false);
+
+        if (numRead <= 0)
+            return 0;
+
+        bufferEnd = numRead;
+        return 1;
+    }
+
+    int read (void* const dest, const int numBytes, const int timeoutMs)
+    {
+        if (bufferStart == bufferEnd)
+        {
+            if (numBytes >= bufferSize)
+            {
+                // (big reads can go straight from the socket into the caller's buffer)
+                if (socket.waitUntilReady (true, timeoutMs) != 1)
+                    return -1;
+
+                return jmax (0, socket.read (dest, numBytes, false));
+            }
+
+            const int result = fillBuffer (timeoutMs);
+
+            if (result <= 0)
+                return result;
+        }
+
+        const int num = jmin (numBytes, bufferEnd - bufferStart);
+        memcpy (dest, buffer + bufferStart, (size_t) num);
+        bufferStart += num;
+        return num;
+    }
+
+    bool readLine (String& result, const int timeoutMs)
+    {
+        MemoryOutputStream line;
+
+        for (;;)
+        {
+            if (bufferStart == bufferEnd && fillBuffer (timeoutMs) <= 0)
+                return false;
+
+            const char* const start = buffer + bufferStart;
+            const int numAvailable = bufferEnd - bufferStart;
+            const char* const newLine = static_cast <const char*> (memchr (start, '\n', (size_t) numAvailable));
+
+            if (newLine != nullptr)
+            {
+                line.write (start, (size_t) (newLine - start));
+                bufferStart += (int) (newLine - start) + 1;
+                break;
+            }
+
+            line.write (start, (size_t) numAvailable);
+            bufferStart = bufferEnd;
+
+            if (line.getDataSize() > 65536)
+                return false;
+        }
+
+        result = String::fromUTF8 (static_cast <const char*> (line.getData()), (int) line.getDataSize())
+                    .trimCharactersAtEnd ("\r");
+        return true;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (Connection)
+};
+
+//==============================================================================
+class HTTPClient::ResponseStream  : public InputStream
+{
+public:
+    ResponseStream (HTTPClient& owner_, Connection* connection_)
+        : owner (owner_), connection (connection_), position (0),
+          totalLength (connection_->getTotalLength())
+    {
+        checkIfFinished();
+    }
+
+    int64 getTotalLength()          { return totalLength; }
+    bool isExhausted()              { return connection == nullptr; }
+    int64 getPosition()             { return position; }
+
+    bool setPosition (int64 newPosition)
+    {
+        // (it's only possible to skip forwards in a network stream)
+        if (newPosition > position)
+            skipNextBytes (newPosition - position);
+
+        return newPosition == position;
+    }
+
+    int read (void* destBuffer, int maxBytesToRead)
+    {
+        if (connection == nullptr)
+            return 0;
+
+        const int numRead = connection->readBody (destBuffer, maxBytesToRead, owner.timeoutMs);
+
+        if (numRead < 0)
+        {
+            connection = nullptr;
+            return 0;
+        }
+
+        position += numRead;
+        checkIfFinished();
+        return numRead;
+    }
+
+private:
+    HTTPClient& owner;
+    ScopedPointer<Connection> connection;
+    int64 position;
+    const int64 totalLength;
+
+    void checkIfFinished()
+    {
+        if (connection->isBodyFinished())
+        {
+            if (connection->canBeReused())
+                owner.releaseConnection (connection.release());
+            else
+                connection = nullptr;
+        }
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (ResponseStream)
+};
+
+//==============================================================================
+class HTTPClient::HostJob  : public ThreadPoolJob
+{
+public:
+    HostJob (HTTPClient& owner_, HostQueue& host_)
+        : ThreadPoolJob ("HTTP: " + host_.key), owner (owner_), host (host_)
+    {
+    }
+
+    JobStatus runJob()
+    {
+        for (;;)
+        {
+            OwnedArray<PendingRequest> batch;
+
+            {
+                const ScopedLock sl (owner.lock);
+
+                if (shouldExit() || host.waiting.size() == 0)
+                {
+                    --host.numActiveJobs;
+                    return jobHasFinished;
+                }
+
+                // GETs can be pipelined, but a POST always goes on its own
+                do
+                {
+                    PendingRequest* const r = host.waiting.removeAndReturn (0);
+                    batch.add (r);
+                    host.active.add (r);
+                }
+                while (batch.size() < owner.maxPipelineDepth
+                        && host.waiting.size() > 0
+                        && ! (batch.getFirst()->isPost || host.waiting.getFirst()->isPost));
+            }
+
+            owner.performPipelined (host, batch);
+        }
+    }
+
+private:
+    HTTPClient& owner;
+    HostQueue& host;
+
+    JUCE_DECLARE_NON_COPYABLE (HostJob)
+};
+
+//==============================================================================
+HTTPClient::Response::Response()  : statusCode (0)
+{
+}
+
+HTTPClient::HTTPClient (const int maxConnectionsPerHost_, const int numThreads)
+    : maxConnectionsPerHost (jmax (1, maxConnectionsPerHost_)),
+      timeoutMs (30000),
+      keepAliveTimeoutMs (15000),
+      maxPipelineDepth (8),
+      dnsCacheTimeoutMs (60000),
+      threadPool (jmax (1, numThreads))
+{
+    zerostruct (stats);
+}
+
+HTTPClient::~HTTPClient()
+{
+    threadPool.removeAllJobs (true, 30000);
+}
+
+//==============================================================================
+void HTTPClient::setTimeout (const int milliseconds) noexcept           { timeoutMs = jmax (1, milliseconds); }
+void HTTPClient::setKeepAliveTimeout (const int milliseconds) noexcept  { keepAliveTimeoutMs = jmax (0, milliseconds); }
+void HTTPClient::setMaxPipelineDepth (const int maxRequests) noexcept   { maxPipelineDepth = jmax (1, maxRequests); }
+void HTTPClient::setDNSCacheTimeout (const int milliseconds) noexcept   { dnsCacheTimeoutMs = jmax (0, milliseconds); }
+
+void HTTPClient::closeIdleConnections()
+{
+    OwnedArray<Connection> toClose;
+
+    {
+        const ScopedLock sl (lock);
+        toClose.swapWithArray (idleConnections);
+        addressCache.clear();
+    }
+}
+
+HTTPClient::Statistics HTTPClient::getStatistics() const
+{
+    const ScopedLock sl (lock);
+    return stats;
+}
+
+//==============================================================================
+String HTTPClient::lookUpAddress (const String& host)
+{
+    if (HTTPClientHelpers::isNumericAddress (host))
+        return host;
+
+    const uint32 now = Time::getMillisecondCounter();
+
+    {
+        const ScopedLock sl (lock);
+
+        for (int i = addressCache.size(); --i >= 0;)
+        {
+            const CachedAddress& cached = addressCache.getReference (i);
+
+            if (cached.host == host)
+            {
+                if ((int) (cached.expiryTime - now) > 0)
+                {
+                    ++stats.dnsCacheHits;
+                    return cached.address;
+                }
+
+                addressCache.remove (i);
+            }
+        }
+
+        ++stats.dnsLookups;
+    }
+
+    struct addrinfo hints;
+    zerostruct (hints);
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+
+    struct addrinfo* info = nullptr;
+
+    if (getaddrinfo (host.toUTF8(), nullptr, &hints, &info) != 0 || info == nullptr)
+        return String::empty;
+
+    // Prefer an IPv4 address if there is one, as that's all that a lot of servers listen on
+    const struct addrinfo* chosen = info;
+
+    for (const struct addrinfo* i = info; i != nullptr; i = i->ai_next)
+    {
+        if (i->ai_family == AF_INET)
+        {
+            chosen = i;
+            break;
+        }
+    }
+
+    char name [NI_MAXHOST] = { 0 };
+    const bool ok = getnameinfo (chosen->ai_addr, (juce_socklen_t) chosen->ai_addrlen,
+                                 name, sizeof (name), nullptr, 0, NI_NUMERICHOST) == 0;
+    freeaddrinfo (info);
+
+    if (! ok)
+        return String::empty;
+
+    CachedAddress cached;
+    cached.host = host;
+    cached.address = name;
+    cached.expiryTime = now + (uint32) dnsCacheTimeoutMs;
+
+    const ScopedLock sl (lock);
+    addressCache.add (cached);
+    return cached.address;
+}
+
+HTTPClient::Connection* HTTPClient::getConnection (const String& host, const int port, bool& isReused)
+{
+    const String key (host + ":" + String (port));
+
+    {
+        OwnedArray<Connection> stale;
+        const ScopedLock sl (lock);
+        const uint32 now = Time::getMillisecondCounter();
+
+        // (the most recently used connections are at the end of the list)
+        for (int i = idleConnections.size(); --i >= 0;)
+        {
+            Connection* const c = idleConnections.getUnchecked (i);
+
+            if (now - c->lastUsedTime > (uint32) keepAliveTimeoutMs)
+            {
+                stale.add (idleConnections.removeAndReturn (i));
+            }
+            else if (c->key == key)
+            {
+                idleConnections.remove (i, false);
+
+                if (c->isStillUsable())
+                {
+                    ++stats.connectionsReused;
+                    isReused = true;
+                    return c;
+                }
+
+                stale.add (c);
+            }
+        }
+    }
+
+    isReused = false;
+    const String address (lookUpAddress (host));
+
+    if (address.isEmpty())
+        return nullptr;
+
+    ScopedPointer<Connection> c (new Connection (key));
+
+    if (! c->connect (address, port, timeoutMs))
+    {
+        // (in case the host has moved, don't keep using the same address)
+        const ScopedLock sl (lock);
+
+        for (int i = addressCache.size(); --i >= 0;)
+            if (addressCache.getReference (i).host == host)
+                addressCache.remove (i);
+
+        return nullptr;
+    }
+
+    const ScopedLock sl (lock);
+    ++stats.connectionsOpened;
+    return c.release();
+}
+
+void HTTPClient::releaseConnection (Connection* const c)
+{
+    ScopedPointer<Connection> surplus;
+    c->lastUsedTime = Time::getMillisecondCounter();
+
+    const ScopedLock sl (lock);
+    int numForHost = 0;
+
+    for (int i = idleConnections.size(); --i >= 0;)
+        if (idleConnections.getUnchecked (i)->key == c->key)
+            ++numForHost;
+
+    if (numForHost < maxConnectionsPerHost)
+        idleConnections.add (c);
+    else
+        surplus = c;
+}
+
+//==============================================================================
+InputStream* HTTPClient::createInputStream (const URL& url, const bool usePost, const String& extraHeaders,
+                                            int* const statusCode, StringPairArray* const responseHeaders)
+{
+    String host;
+    int port;
+
+    if (! HTTPClientHelpers::getHostAndPort (url, host, port))
+        return nullptr;
+
+    MemoryOutputStream request;
+    HTTPClientHelpers::writeRequest (request, url, usePost, extraHeaders, host, port);
+
+    for (;;)
+    {
+        bool isReused = false;
+        ScopedPointer<Connection> connection (getConnection (host, port, isReused));
+
+        if (connection == nullptr)
+            return nullptr;
+
+        {
+            const ScopedLock sl (lock);
+            ++stats.requestsSent;
+        }
+
+        Response response;
+
+        if (connection->write (request.getData(), (int) request.getDataSize())
+             && connection->readResponseHead (response, timeoutMs))
+        {
+            if (statusCode != nullptr)
+                *statusCode = response.statusCode;
+
+            if (responseHeaders != nullptr)
+                responseHeaders->addArray (response.headers);
+
+            return new ResponseStream (*this, connection.release());
+        }
+
+        // If a pooled connection fails, it's probably because the server closed it while
+        // it was idle, so it's worth trying again with a new one.
+        if (! isReused)
+            return nullptr;
+    }
+}
+
+HTTPClient::Response HTTPClient::get (const URL& url, const String& extraHeaders)
+{
+    Response response;
+    const ScopedPointer<InputStream> in (createInputStream (url, false, extraHeaders,
+                                                           &response.statusCode, &response.headers));
+
+    if (in != nullptr)
+        in->readIntoMemoryBlock (response.body);
+
+    return response;
+}
+
+HTTPClient::Response HTTPClient::post (const URL& url, const String& extraHeaders)
+{
+    Response response;
+    const ScopedPointer<InputStream> in (createInputStream (url, true, extraHeaders,
+                                                           &response.statusCode, &response.headers));
+
+    if (in != nullptr)
+        in->readIntoMemoryBlock (response.body);
+
+    return response;
+}
+
+//==============================================================================
+void HTTPClient::getAsync (const URL& url, Listener& listener, const String& extraHeaders)
+{
+    addRequest (url, false, listener, extraHeaders);
+}
+
+void HTTPClient::postAsync (const URL& url, Listener& listener, const String& extraHeaders)
+{
+    addRequest (url, true, listener, extraHeaders);
+}
+
+HTTPClient::HostQueue* HTTPClient::findHost (const String& hostKey) const
+{
+    for (int i = hosts.size(); --i >= 0;)
+        if (hosts.getUnchecked (i)->key == hostKey)
+            return hosts.getUnchecked (i);
+
+    return nullptr;
+}
+
+void HTTPClient::addRequest (const URL& url, const bool isPost, Listener& listener, const String& extraHeaders)
+{
+    String host;
+    int port;
+
+    if (! HTTPClientHelpers::getHostAndPort (url, host, port))
+    {
+        const ScopedLock sl (callbackLock);
+        listener.httpRequestFinished (url, Response());
+        return;
+    }
+
+    const ScopedLock sl (lock);
+    HostQueue* h = findHost (host + ":" + String (port));
+
+    if (h == nullptr)
+    {
+        h = new HostQueue (host, port);
+        hosts.add (h);
+    }
+
+    h->waiting.add (new PendingRequest (url, isPost, extraHeaders, listener));
+
+    if (h->numActiveJobs < maxConnectionsPerHost
+         && h->numActiveJobs < h->waiting.size())
+    {
+        ++(h->numActiveJobs);
+        threadPool.addJob (new HostJob (*this, *h), true);
+    }
+}
+
+void HTTPClient::cancelRequests (Listener& listener)
+{
+    {
+        const ScopedLock sl (lock);
+
+        for (int i = hosts.size(); --i >= 0;)
+        {
+            HostQueue& h = *hosts.getUnchecked (i);
+
+            for (int j = h.waiting.size(); --j >= 0;)
+                if (&(h.waiting.getUnchecked (j)->listener) == &listener)
+                    h.waiting.remove (j);
+
+            for (int j = h.active.size(); --j >= 0;)
+                if (&(h.active.getUnchecked (j)->listener) == &listener)
+                    h.active.getUnchecked (j)->cancelled = true;
+        }
+    }
+
+    // (waits for any callback that's in progress)
+    const ScopedLock sl (callbackLock);
+}
+
+int HTTPClient::getNumPendingRequests() const
+{
+    const ScopedLock sl (lock);
+    int num = 0;
+
+    for (int i = hosts.size(); --i >= 0;)
+        num += hosts.getUnchecked (i)->waiting.size() + hosts.getUnchecked (i)->active.size();
+
+    return num;
+}
+
+void HTTPClient::finishRequest (HostQueue& host, PendingRequest* const r, const Response& response)
+{
+    const ScopedLock sl (callbackLock);
+    bool cancelled;
+
+    {
+        const ScopedLock sl2 (lock);
+        cancelled = r->cancelled;
+        host.active.removeFirstMatchingValue (r);
+    }
+
+    if (! cancelled)
+        r->listener.httpRequestFinished (r->url, response);
+}
+
+void HTTPClient::performPipelined (HostQueue& host, OwnedArray<PendingRequest>& batch)
+{
+    bool isReused = false;
+    ScopedPointer<Connection> connection (getConnection (host.host, host.port, isReused));
+    const bool connected = (connection != nullptr);
+    int numDone = 0;
+
+    if (connected)
+    {
+        MemoryOutputStream requests;
+
+        for (int i = 0; i < batch.size(); ++i)
+        {
+            const PendingRequest& r = *batch.getUnchecked (i);
+            HTTPClientHelpers::writeRequest (requests, r.url, r.isPost, r.extraHeaders, host.host, host.port);
+        }
+
+        {
+            const ScopedLock sl (lock);
+            stats.requestsSent += batch.size();
+            stats.requestsPipelined += batch.size() - 1;
+        }
+
+        if (connection->write (requests.getData(), (int) requests.getDataSize()))
+        {
+            while (numDone < batch.size())
+            {
+                Response response;
+
+                if (! (connection->readResponseHead (response, timeoutMs)
+                        && connection->readBody (response.body, timeoutMs)))
+                    break;
+
+                finishRequest (host, batch.getUnchecked (numDone++), response);
+
+                if (! connection->canBeReused())
+                    break;
+            }
+        }
+
+        if (numDone == batch.size() && connection->canBeReused())
+            releaseConnection (connection.release());
+        else
+            connection = nullptr;
+    }
+
+    // Any requests that didn't get a response are tried again, unless the very first
+    // one failed on a brand new connection, which means that something's really wrong.
+    Array<PendingRequest*> retries;
+
+    for (int i = numDone; i < batch.size(); ++i)
+    {
+        PendingRequest* const r = batch.getUnchecked (i);
+
+        if (connected && (numDone > 0 || isReused || i > numDone)
+             && ++(r->numAttempts) < HTTPClientHelpers::maxRequestAttempts)
+        {
+            retries.add (r);
+            batch.set (i, nullptr, false);
+        }
+        else
+        {
+            finishRequest (host, r, Response());
+        }
+    }
+
+    if (retries.size() > 0)
+    {
+        const ScopedLock sl (lock);
+
+        for (int i = retries.size(); --i >= 0;)
+        {
+            host.active.removeFirstMatchingValue (retries.getUnchecked (i));
+            host.waiting.insert (0, retries.getUnchecked (i));
+        }
+    }
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class HTTPClientTests  : public UnitTest
+{
+public:
+    HTTPClientTests() : UnitTest ("HTTPClient") {}
+
+    // A minimal server, which handles one connection at a time, and answers each request
+    // according to its path: "/len/N" sends N bytes with a Content-Length, "/wait/N" sends
+    // an empty body after N milliseconds, "/chunked" sends a chunked body, and "/close"
+    // sends a body that ends when the connection closes.
+    class TestServer  : public Thread
+    {
+    public:
+        TestServer() : Thread ("HTTPClient test server"), port (0), numConnections (0)
+        {
+            for (int p = 39217; p < 39317 && port == 0; ++p)
+                if (listener.createListener (p))
+                    port = p;
+
+            startThread();
+        }
+
+        ~TestServer()
+        {
+            signalThreadShouldExit();
+            listener.close();
+            stopThread (5000);
+        }
+
+        void run()
+        {
+            while (! threadShouldExit())
+            {
+                const ScopedPointer<StreamingSocket> s (listener.waitForNextConnection());
+
+                if (s == nullptr)
+                    break;
+
+                ++numConnections;
+                serve (*s);
+            }
+        }
+
+        void serve (StreamingSocket& s)
+        {
+            MemoryBlock received;
+            char buffer [4096];
+
+            for (;;)
+            {
+                String text (static_cast <const char*> (received.getData()), received.getSize());
+                const int endOfHead = text.indexOf ("\r\n\r\n");
+
+                if (endOfHead >= 0)
+                {
+                    received.removeSection (0, (size_t) endOfHead + 4);
+                    const String path (text.fromFirstOccurrenceOf (" ", false, false).upToFirstOccurrenceOf (" ", false, false));
+
+                    if (! respond (s, path))
+                        return;
+
+                    continue;
+                }
+
+                if (s.waitUntilReady (true, 5000) != 1)
+                    return;
+
+                const int num = s.read (buffer, sizeof (buffer), false);
+
+                if (num <= 0)
+                    return;
+
+                received.append (buffer, (size_t) num);
+            }
+        }
+
+        static bool respond (StreamingSocket& s, const String& path)
+        {
+            MemoryOutputStream out;
+
+            if (path.startsWith ("/len/"))
+            {
+                const int len = path.substring (5).getIntValue();
+                out << "HTTP/1.1 200 OK\r\nContent-Length: " << len << "\r\n\r\n";
+                out.writeRepeatedByte ('x', (size_t) len);
+            }
+            else if (path.startsWith ("/wait/"))
+            {
+                Thread::sleep (path.substring (6).getIntValue());
+                out << "HTTP/1.1 200 OK\r\nContent-Length: 0\r\n\r\n";
+            }
+            else if (path == "/chunked")
+            {
+                out << "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n"
+                    << "7\r\nHello, \r\n5;ext=1\r\nworld\r\n0\r\nX-Trailer: 1\r\n\r\n";
+            }
+            else
+            {
+                out << "HTTP/1.1 200 OK\r\nConnection: close\r\n\r\nclosed";
+                s.write (out.getData(), (int) out.getDataSize());
+                return false;
+            }
+
+            return s.write (out.getData(), (int) out.getDataSize()) == (int) out.getDataSize();
+        }
+
+        StreamingSocket listener;
+        int port;
+        Atomic<int> numConnections;
+    };
+
+    class Collector  : public HTTPClient::Listener
+    {
+    public:
+        void httpRequestFinished (const URL& url, const HTTPClient::Response& response)
+        {
+            const ScopedLock sl (lock);
+            urls.add (url.toString (true));
+            sizes.add (response.wasSuccessful() ? (int) response.body.getSize() : -1);
+
+            if (urls.size() == numExpected)
+                finished.signal();
+        }
+
+        CriticalSection lock;
+        StringArray urls;
+        Array<int> sizes;
+        int numExpected;
+        WaitableEvent finished;
+    };
+
+    void runTest()
+    {
+        TestServer server;
+        const String base ("http://localhost:" + String (server.port));
+
+        beginTest ("Keep-alive");
+        {
+            expect (server.port != 0);
+
+            HTTPClient client;
+
+            HTTPClient::Response r (client.get (URL (base + "/len/5000")));
+            expectEquals (r.statusCode, 200);
+            expectEquals ((int) r.body.getSize(), 5000);
+
+            r = client.get (URL (base + "/chunked"));
+            expectEquals (r.body.toString(), String ("Hello, world"));
+
+            r = client.get (URL (base + "/len/0"));
+            expectEquals (r.statusCode, 200);
+            expectEquals ((int) r.body.getSize(), 0);
+
+            HTTPClient::Statistics stats (client.getStatistics());
+            expectEquals ((int) stats.connectionsOpened, 1);
+            expectEquals ((int) stats.connectionsReused, 2);
+            expectEquals ((int) stats.dnsLookups, 1);
+
+            // a response that's ended by closing the connection can't leave it in the pool..
+            r = client.get (URL (base + "/close"));
+            expectEquals (r.body.toString(), String ("closed"));
+
+            r = client.get (URL (base + "/len/10"));
+            expectEquals ((int) r.body.getSize(), 10);
+
+            stats = client.getStatistics();
+            expectEquals ((int) stats.connectionsOpened, 2);
+            expectEquals ((int) stats.dnsCacheHits, 1);
+
+            // ..and neither can one that's abandoned before it's all been read
+            {
+                ScopedPointer<InputStream> in (client.createInputStream (URL (base + "/len/100000"), false));
+                expect (in != nullptr);
+                expectEquals ((int) in->getTotalLength(), 100000);
+                expectEquals (in->readByte(), 'x');
+            }
+
+            r = client.get (URL (base + "/len/10"));
+            expectEquals ((int) r.body.getSize(), 10);
+            expectEquals ((int) client.getStatistics().connectionsOpened, 3);
+        }
+
+        beginTest ("Pipelining");
+        {
+            HTTPClient client (1, 2);
+            Collector collector;
+            collector.numExpected = 51;
+
+            // (the others will queue up while this one's waiting)
+            client.getAsync (URL (base + "/wait/200"), collector);
+
+            for (int i = 1; i < collector.numExpected; ++i)
+                client.getAsync (URL (base + "/len/" + String (i * 100)), collector);
+
+            expect (collector.finished.wait (20000));
+            expectEquals (client.getNumPendingRequests(), 0);
+
+            for (int i = 1; i < collector.numExpected; ++i)
+            {
+                expectEquals (collector.urls[i], base + "/len/" + String (i * 100));
+                expectEquals (collector.sizes[i], i * 100);
+            }
+
+            const HTTPClient::Statistics stats (client.getStatistics());
+            expect (stats.requestsPipelined > 0);
+            expectEquals ((int) stats.connectionsOpened, 1);
+        }
+    }
+};
+
+static HTTPClientTests httpClientTests;
+
+#endif
@@ -0,0 +1,240 @@
+/*
+  ==============================================================================
+
+   This file is part of the juce_core module of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission to use, copy, modify, and/or distribute this software for any purpose with
+   or without fee is hereby granted, provided that the above copyright notice and this
+   permission notice appear in all copies.
+
+   THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+   TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+   NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+   DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+   IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+   ------------------------------------------------------------------------------
+
+   NOTE! This permissive ISC license applies ONLY to files within the juce_core module!
+   All other JUCE modules are covered by a dual GPL/commercial license, so if you are
+   using any other modules, be sure to check that you also comply with their license.
+
+   For more details, visit www.juce.com
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_HTTPCLIENT_JUCEHEADER__
+#define __JUCE_HTTPCLIENT_JUCEHEADER__
+
+#include "juce_URL.h"
+#include "../memory/juce_MemoryBlock.h"
+#include "../threads/juce_ThreadPool.h"
+#include "../containers/juce_OwnedArray.h"
+class InputStream;
+
+
+//==============================================================================
+/**
+    An HTTP/1.1 client that keeps connections open and re-uses them.
+
+    URL::createInputStream() opens a new connection (and looks up the host's address
+    again) for every request, which is fine for the odd download, but very slow when
+    an app needs to make a lot of small requests to the same server. An HTTPClient
+    keeps a pool of idle keep-alive connections for each host, caches the results of
+    DNS lookups, and can pipeline several GET requests down the same connection.
+
+    Requests can be made synchronously with get(), post() and createInputStream(), or
+    asynchronously with getAsync() and postAsync(), in which case they're performed
+    on the client's own ThreadPool, and a Listener is called back when each one has
+    finished. The responses to asynchronous requests for the same host are delivered
+    in the order in which the requests were made, unless more than one connection is
+    being used for that host.
+
+    Only plain "http://" URLs are supported - for anything else (or to go via a proxy),
+    use URL::createInputStream().
+
+    @see URL
+*/
+class JUCE_API  HTTPClient
+{
+public:
+    //==============================================================================
+    /** Creates a client.
+
+        @param maxConnectionsPerHost    the largest number of connections that will be
+                                        open to any one host at the same time
+        @param numThreads               the number of threads to use for asynchronous
+                                        requests
+    */
+    HTTPClient (int maxConnectionsPerHost = 4, int numThreads = 4);
+
+    /** Destructor.
+        Any asynchronous requests that haven't finished are abandoned, without their
+        listeners being called.
+    */
+    ~HTTPClient();
+
+    //==============================================================================
+    /** The result of a request. */
+    struct JUCE_API  Response
+    {
+        /** Creates an empty (failed) response. */
+        Response();
+
+        /** The HTTP status code, or 0 if no response was received. */
+        int statusCode;
+
+        /** The headers that the server sent. */
+        StringPairArray headers;
+
+        /** The body of the response. */
+        MemoryBlock body;
+
+        /** True if the status code is in the 2xx range. */
+        bool wasSuccessful() const noexcept         { return statusCode >= 200 && statusCode < 300; }
+    };
+
+    //==============================================================================
+    /** Performs a GET request, and waits for the response.
+
+        @param url              the URL to fetch, including any parameters
+        @param extraHeaders     any additional headers to send, each terminated by "\r\n"
+    */
+    Response get (const URL& url, const String& extraHeaders = String::empty);
+
+    /** Performs a POST request, and waits for the response.
+        The URL's parameters, POST data and any files to upload are sent in the same way
+        that URL::createInputStream() would send them.
+    */
+    Response post (const URL& url, const String& extraHeaders = String::empty);
+
+    /** Opens a stream that reads the body of a response as it arrives.
+
+        When the whole body has been read, the connection goes back into the pool, ready
+        to be used again. If you delete the stream before that, its connection is closed.
+
+        @param url              the URL to fetch
+        @param usePost          whether to make a POST request rather than a GET
+        @param extraHeaders     any additional headers to send, each terminated by "\r\n"
+        @param statusCode       if not null, this is set to the HTTP status code
+        @param responseHeaders  if not null, the response's headers are added to this
+        @returns a stream, which the caller must delete, or nullptr if the request failed
+    */
+    InputStream* createInputStream (const URL& url, bool usePost,
+                                    const String& extraHeaders = String::empty,
+                                    int* statusCode = nullptr,
+                                    StringPairArray* responseHeaders = nullptr);
+
+    //==============================================================================
+    /** Receives the results of asynchronous requests.
+        @see getAsync, postAsync
+    */
+    class JUCE_API  Listener
+    {
+    public:
+        /** Destructor. */
+        virtual ~Listener() {}
+
+        /** Called when a request has finished, or failed.
+            This is called on one of the client's threads, so be careful what you do in here.
+
+            @param url          the URL that was requested
+            @param response     the response, whose statusCode will be 0 if it failed
+        */
+        virtual void httpRequestFinished (const URL& url, const Response& response) = 0;
+    };
+
+    /** Starts a GET request on a background thread, and calls the listener when it's done.
+
+        GET requests that are waiting for the same host may be pipelined - i.e. sent
+        back-to-back on one connection without waiting for each response - which
+        avoids a network round-trip for each of them.
+    */
+    void getAsync (const URL& url, Listener& listener, const String& extraHeaders = String::empty);
+
+    /** Starts a POST request on a background thread, and calls the listener when it's done.
+        POST requests are never pipelined.
+    */
+    void postAsync (const URL& url, Listener& listener, const String& extraHeaders = String::empty);
+
+    /** Cancels any waiting requests that would call back the given listener.
+        If the listener is being called at the moment, this waits for it to return, so
+        after calling this, it's safe to delete the listener.
+    */
+    void cancelRequests (Listener& listener);
+
+    /** Returns the number of asynchronous requests that haven't yet finished. */
+    int getNumPendingRequests() const;
+
+    //==============================================================================
+    /** Sets the timeout for connecting, and for waiting for each part of a response. */
+    void setTimeout (int milliseconds) noexcept;
+
+    /** Sets how long an idle connection is kept open before it's closed.
+        Servers often close idle connections themselves after a few seconds, so there's
+        little point in keeping them for longer than that.
+    */
+    void setKeepAliveTimeout (int milliseconds) noexcept;
+
+    /** Sets the largest number of GET requests that will be sent down one connection
+        before waiting for their responses. A value of 1 turns pipelining off.
+    */
+    void setMaxPipelineDepth (int maxRequests) noexcept;
+
+    /** Sets how long the address of a host is remembered after being looked up. */
+    void setDNSCacheTimeout (int milliseconds) noexcept;
+
+    /** Closes all the idle connections, and forgets all the cached DNS results. */
+    void closeIdleConnections();
+
+    //==============================================================================
+    /** Some counters describing the client's activity. */
+    struct Statistics
+    {
+        int64 requestsSent;         /**< The number of requests that have been sent. */
+        int64 connectionsOpened;    /**< The number of new connections that were made. */
+        int64 connectionsReused;    /**< The number of times an idle connection was re-used. */
+        int64 requestsPipelined;    /**< The number of requests sent before a previous response had arrived. */
+        int64 dnsLookups;           /**< The number of times a host's address was looked up. */
+        int64 dnsCacheHits;         /**< The number of times a cached address was used. */
+    };
+
+    /** Returns the current statistics. */
+    Statistics getStatistics() const;
+
+private:
+    //==============================================================================
+    class Connection;
+    class HostQueue;
+    class HostJob;
+    class ResponseStream;
+    struct PendingRequest;
+    struct CachedAddress;
+    friend class HostJob;
+    friend class ResponseStream;
+
+    const int maxConnectionsPerHost;
+    int timeoutMs, keepAliveTimeoutMs, maxPipelineDepth, dnsCacheTimeoutMs;
+    ThreadPool threadPool;
+    CriticalSection lock, callbackLock;
+    OwnedArray<HostQueue> hosts;
+    OwnedArray<Connection> idleConnections;
+    Array<CachedAddress> addressCache;
+    Statistics stats;
+
+    void addRequest (const URL&, bool isPost, Listener&, const String& extraHeaders);
+    Connection* getConnection (const String& host, int port, bool& isReused);
+    void releaseConnection (Connection*);
+    String lookUpAddress (const String& host);
+    void performPipelined (HostQueue&, OwnedArray<PendingRequest>& batch);
+    void finishRequest (HostQueue&, PendingRequest*, const Response&);
+    HostQueue* findHost (const String& hostKey) const;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (HTTPClient)
+};
+
+
+#endif   // __JUCE_HTTPCLIENT_JUCEHEADER__
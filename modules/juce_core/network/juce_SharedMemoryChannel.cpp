@@ -0,0 +1,570 @@
+/*
+  ==============================================================================
+
+   This file is part of the juce_core module of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission to use, copy, modify, and/or distribute this software for any purpose with
+   or without fee is hereby granted, provided that the above copyright notice and this
+   permission notice appear in all copies.
+
+   THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+   TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+   NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+   DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+   IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+   ------------------------------------------------------------------------------
+
+   NOTE! This permissive ISC license applies ONLY to files within the juce_core module!
+   All other JUCE modules are covered by a dual GPL/commercial license, so if you are
+   using any other modules, be sure to check that you also comply with their license.
+
+   For more details, visit www.juce.com
+
+  ==============================================================================
+*/
+
+// The shared block starts with a SharedHeader, followed by the ring for messages
+// from the creator to the opener, and then the ring for the other direction.
+//
+// Each message in a ring is a 16-byte header (of which only the first word, the size,
+// is used) followed by the data, padded to a multiple of 16 bytes. A message is never
+// split across the end of the ring - if it won't fit, the writer puts a wrap marker in
+// place of a header, and it goes at the start instead. The read and write counters are
+// free-running byte counts, and the ring sizes are powers of two so that they wrap
+// correctly at 2^32.
+struct SharedMemoryChannel::Ring
+{
+    // written by the sender..
+    Atomic<int32> writeCount, dataSignal, writerWaiting;
+    char padding1 [64 - 3 * sizeof (Atomic<int32>)];
+
+    // written by the receiver..
+    Atomic<int32> readCount, spaceSignal, readerWaiting;
+    char padding2 [64 - 3 * sizeof (Atomic<int32>)];
+};
+
+struct SharedMemoryChannel::SharedHeader
+{
+    enum
+    {
+        magicNumber = 0x6a736d63,
+        dataOffset = 512,
+        messageHeaderSize = 16,
+        wrapMarker = 0xffffffff
+    };
+
+    uint32 magic, bufferSize;
+    Atomic<int32> attached[2];
+    Atomic<int32> hasBeenOpened;
+    char padding [64 - 2 * sizeof (uint32) - 3 * sizeof (Atomic<int32>)];
+
+    Ring rings[2];
+};
+
+namespace SharedMemoryChannelHelpers
+{
+    static uint32 getTimeoutEnd (const int timeOutMilliseconds) noexcept
+    {
+        return timeOutMilliseconds >= 0 ? Time::getMillisecondCounter() + (uint32) timeOutMilliseconds : 0;
+    }
+
+    // returns the time left before timeoutEnd, or -1 if there's no timeout
+    static int getTimeRemaining (const uint32 timeoutEnd) noexcept
+    {
+        if (timeoutEnd == 0)
+            return -1;
+
+        const uint32 now = Time::getMillisecondCounter();
+        return now < timeoutEnd ? (int) (timeoutEnd - now) : 0;
+    }
+
+    static uint32 getPaddedSize (const size_t numBytes) noexcept
+    {
+        return (uint32) ((numBytes + 15) & ~(size_t) 15);
+    }
+}
+
+//==============================================================================
+SharedMemoryChannel::SharedMemoryChannel()
+    : endIndex (0), pendingWriteSize (0), pendingReadSize (0)
+{
+    static_jassert (sizeof (SharedHeader) <= SharedHeader::dataOffset);
+}
+
+SharedMemoryChannel::~SharedMemoryChannel()
+{
+    close();
+}
+
+bool SharedMemoryChannel::createNewChannel (const String& channelName, const int bufferSizeBytes)
+{
+    close();
+
+    currentChannelName = channelName;
+    return openInternal (channelName, (size_t) nextPowerOfTwo (jlimit (4096, 1 << 29, bufferSizeBytes)), true);
+}
+
+bool SharedMemoryChannel::openExisting (const String& channelName)
+{
+    close();
+
+    currentChannelName = channelName;
+    return openInternal (channelName, 0, false);
+}
+
+bool SharedMemoryChannel::openInternal (const String& channelName, const size_t bufferSize, const bool createChannel)
+{
+    pimpl = new Pimpl (channelName, createChannel ? SharedHeader::dataOffset + bufferSize * 2 : 0, createChannel);
+
+    if (pimpl->getData() == nullptr)
+    {
+        pimpl = nullptr;
+        return false;
+    }
+
+    SharedHeader& header = *getHeader();
+
+    if (createChannel)
+    {
+        endIndex = 0;
+        header.bufferSize = (uint32) bufferSize;
+        header.attached[0] = 1;
+        Atomic<int32>::memoryBarrier();
+        header.magic = SharedHeader::magicNumber;
+        return true;
+    }
+
+    endIndex = 1;
+    Atomic<int32>::memoryBarrier();
+
+    if (header.magic == (uint32) SharedHeader::magicNumber
+         && header.bufferSize > 0 && isPowerOfTwo ((int) header.bufferSize)
+         && SharedHeader::dataOffset + header.bufferSize * (size_t) 2 <= pimpl->getSize()
+         && header.attached[0].get() != 0
+         && header.hasBeenOpened.compareAndSetBool (1, 0))
+    {
+        header.attached[1] = 1;
+        return true;
+    }
+
+    pimpl = nullptr;
+    return false;
+}
+
+void SharedMemoryChannel::close()
+{
+    if (pimpl != nullptr)
+    {
+        getHeader()->attached[endIndex] = 0;
+        Atomic<int32>::memoryBarrier();
+
+        // wake up anything at the other end that's waiting for us..
+        for (int i = 0; i < 2; ++i)
+        {
+            Ring& ring = getRing (i);
+            ++(ring.dataSignal);
+            ++(ring.spaceSignal);
+            pimpl->wake (i * 2, ring.dataSignal);
+            pimpl->wake (i * 2 + 1, ring.spaceSignal);
+        }
+
+        pimpl = nullptr;
+    }
+
+    pendingWriteSize = pendingReadSize = 0;
+}
+
+bool SharedMemoryChannel::isOpen() const noexcept
+{
+    return pimpl != nullptr;
+}
+
+bool SharedMemoryChannel::isConnected() const noexcept
+{
+    return pimpl != nullptr && getHeader()->attached [1 - endIndex].get() != 0;
+}
+
+String SharedMemoryChannel::getName() const
+{
+    return currentChannelName;
+}
+
+int SharedMemoryChannel::getMaximumMessageSize() const noexcept
+{
+    return pimpl != nullptr ? (int) (getHeader()->bufferSize / 2 - SharedHeader::messageHeaderSize) : 0;
+}
+
+SharedMemoryChannel::SharedHeader* SharedMemoryChannel::getHeader() const noexcept
+{
+    return static_cast <SharedHeader*> (pimpl->getData());
+}
+
+SharedMemoryChannel::Ring& SharedMemoryChannel::getRing (const int index) const noexcept
+{
+    return getHeader()->rings [index];
+}
+
+char* SharedMemoryChannel::getRingData (const int index) const noexcept
+{
+    return static_cast <char*> (pimpl->getData()) + SharedHeader::dataOffset + getHeader()->bufferSize * (size_t) index;
+}
+
+bool SharedMemoryChannel::isPeerGone() const noexcept
+{
+    const SharedHeader& header = *getHeader();
+
+    // (the creator waits for someone to open the channel, but gives up once they've left)
+    return header.attached [1 - endIndex].get() == 0
+            && (endIndex != 0 || header.hasBeenOpened.get() != 0);
+}
+
+bool SharedMemoryChannel::waitFor (const int ringIndex, const bool waitForData,
+                                   const uint32 bytesNeeded, const uint32 timeoutEnd)
+{
+    Ring& ring = getRing (ringIndex);
+    const uint32 bufferSize = getHeader()->bufferSize;
+
+    Atomic<int32>& signal  = waitForData ? ring.dataSignal    : ring.spaceSignal;
+    Atomic<int32>& waiting = waitForData ? ring.readerWaiting : ring.writerWaiting;
+
+    for (;;)
+    {
+        const int32 signalValue = signal.get();
+        const uint32 numUsed = (uint32) ring.writeCount.get() - (uint32) ring.readCount.get();
+
+        if (waitForData ? (numUsed != 0) : (bufferSize - numUsed >= bytesNeeded))
+            return true;
+
+        if (isPeerGone())
+            return false;
+
+        const int timeLeft = SharedMemoryChannelHelpers::getTimeRemaining (timeoutEnd);
+
+        if (timeLeft == 0)
+            return false;
+
+        // Announce that we're about to sleep, then check again, so that the other end
+        // will either see the flag and wake us, or will have already done what we need..
+        waiting = 1;
+        Atomic<int32>::memoryBarrier();
+
+        const uint32 numUsedNow = (uint32) ring.writeCount.get() - (uint32) ring.readCount.get();
+
+        if (numUsedNow == numUsed && ! isPeerGone())
+            pimpl->wait (ringIndex * 2 + (waitForData ? 0 : 1), signal, signalValue, timeLeft);
+
+        waiting = 0;
+    }
+}
+
+//==============================================================================
+void* SharedMemoryChannel::startWritingMessage (const size_t numBytes, const int timeOutMilliseconds)
+{
+    jassert (pendingWriteSize == 0); // you need to call finishWritingMessage() before starting another one!
+
+    if (pimpl == nullptr || numBytes > (size_t) getMaximumMessageSize())
+        return nullptr;
+
+    const uint32 bufferSize = getHeader()->bufferSize;
+    const uint32 needed = SharedHeader::messageHeaderSize + SharedMemoryChannelHelpers::getPaddedSize (numBytes);
+    const uint32 offset = (uint32) getRing (endIndex).writeCount.get() & (bufferSize - 1);
+    const uint32 wrapBytes = bufferSize - offset < needed ? bufferSize - offset : 0;
+
+    if (! waitFor (endIndex, false, wrapBytes + needed, SharedMemoryChannelHelpers::getTimeoutEnd (timeOutMilliseconds)))
+        return nullptr;
+
+    char* const ringData = getRingData (endIndex);
+    char* message = ringData + offset;
+
+    if (wrapBytes > 0)
+    {
+        *reinterpret_cast <uint32*> (message) = (uint32) SharedHeader::wrapMarker;
+        message = ringData;
+    }
+
+    *reinterpret_cast <uint32*> (message) = (uint32) numBytes;
+    pendingWriteSize = wrapBytes + needed;
+    return message + SharedHeader::messageHeaderSize;
+}
+
+void SharedMemoryChannel::finishWritingMessage()
+{
+    jassert (pendingWriteSize != 0); // this must follow a successful call to startWritingMessage()
+
+    if (pimpl != nullptr && pendingWriteSize != 0)
+    {
+        Ring& ring = getRing (endIndex);
+        ring.writeCount += (int32) pendingWriteSize;
+        pendingWriteSize = 0;
+
+        if (ring.readerWaiting.get() != 0)
+        {
+            ++(ring.dataSignal);
+            pimpl->wake (endIndex * 2, ring.dataSignal);
+        }
+    }
+}
+
+void* SharedMemoryChannel::startReadingMessage (size_t& numBytes, const int timeOutMilliseconds)
+{
+    jassert (pendingReadSize == 0); // you need to call finishReadingMessage() before starting another one!
+    numBytes = 0;
+
+    const int ringIndex = 1 - endIndex;
+
+    if (pimpl == nullptr || ! waitFor (ringIndex, true, 0, SharedMemoryChannelHelpers::getTimeoutEnd (timeOutMilliseconds)))
+        return nullptr;
+
+    const uint32 bufferSize = getHeader()->bufferSize;
+    const uint32 offset = (uint32) getRing (ringIndex).readCount.get() & (bufferSize - 1);
+
+    char* const ringData = getRingData (ringIndex);
+    char* message = ringData + offset;
+    uint32 skipped = 0;
+
+    if (*reinterpret_cast <const uint32*> (message) == (uint32) SharedHeader::wrapMarker)
+    {
+        skipped = bufferSize - offset;
+        message = ringData;
+    }
+
+    const uint32 size = *reinterpret_cast <const uint32*> (message);
+    jassert (size <= bufferSize / 2);
+
+    numBytes = size;
+    pendingReadSize = skipped + SharedHeader::messageHeaderSize + SharedMemoryChannelHelpers::getPaddedSize (size);
+    return message + SharedHeader::messageHeaderSize;
+}
+
+void SharedMemoryChannel::finishReadingMessage()
+{
+    jassert (pendingReadSize != 0); // this must follow a successful call to startReadingMessage()
+
+    if (pimpl != nullptr && pendingReadSize != 0)
+    {
+        const int ringIndex = 1 - endIndex;
+        Ring& ring = getRing (ringIndex);
+        ring.readCount += (int32) pendingReadSize;
+        pendingReadSize = 0;
+
+        if (ring.writerWaiting.get() != 0)
+        {
+            ++(ring.spaceSignal);
+            pimpl->wake (ringIndex * 2 + 1, ring.spaceSignal);
+        }
+    }
+}
+
+//==============================================================================
+bool SharedMemoryChannel::sendMessage (const void* const messageData, const size_t numBytes, const int timeOutMilliseconds)
+{
+    if (void* const dest = startWritingMessage (numBytes, timeOutMilliseconds))
+    {
+        memcpy (dest, messageData, numBytes);
+        finishWritingMessage();
+        return true;
+    }
+
+    return false;
+}
+
+bool SharedMemoryChannel::sendMessage (const MemoryBlock& message, const int timeOutMilliseconds)
+{
+    return sendMessage (message.getData(), message.getSize(), timeOutMilliseconds);
+}
+
+bool SharedMemoryChannel::receiveMessage (MemoryBlock& message, const int timeOutMilliseconds)
+{
+    size_t numBytes;
+
+    if (const void* const data = startReadingMessage (numBytes, timeOutMilliseconds))
+    {
+        message.replaceWith (data, numBytes);
+        finishReadingMessage();
+        return true;
+    }
+
+    return false;
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class SharedMemoryChannelTests  : public UnitTest
+{
+public:
+    SharedMemoryChannelTests() : UnitTest ("SharedMemoryChannel") {}
+
+    static String getUniqueName()
+    {
+        return "juce_test_" + String::toHexString (Random::getSystemRandom().nextInt64());
+    }
+
+    static void fillMessage (MemoryBlock& m, const int index, const size_t size)
+    {
+        m.setSize (size);
+
+        for (size_t i = 0; i < size; ++i)
+            static_cast <uint8*> (m.getData())[i] = (uint8) (index * 31 + (int) i);
+    }
+
+    class SenderThread  : public Thread
+    {
+    public:
+        SenderThread (SharedMemoryChannel& c, int num)
+            : Thread ("SharedMemoryChannel test"), channel (c), numMessages (num), failures (0)
+        {
+        }
+
+        void run()
+        {
+            Random r (1234);
+            MemoryBlock m;
+
+            for (int i = 0; i < numMessages; ++i)
+            {
+                fillMessage (m, i, (size_t) r.nextInt (3000));
+
+                if (! channel.sendMessage (m, 5000))
+                    ++failures;
+            }
+        }
+
+        SharedMemoryChannel& channel;
+        const int numMessages;
+        int failures;
+    };
+
+    void runTest()
+    {
+        beginTest ("Opening");
+        {
+            const String name (getUniqueName());
+            SharedMemoryChannel a, b, c;
+
+            expect (! b.openExisting (name));
+            expect (a.createNewChannel (name, 5000));
+            expect (a.isOpen() && ! a.isConnected());
+            expectEquals (a.getMaximumMessageSize(), 8192 / 2 - 16);
+
+            expect (b.openExisting (name));
+            expect (a.isConnected() && b.isConnected());
+            expectEquals (b.getMaximumMessageSize(), a.getMaximumMessageSize());
+            expect (! c.openExisting (name));
+
+            b.close();
+            expect (! a.isConnected());
+        }
+
+        beginTest ("Messages");
+        {
+            const String name (getUniqueName());
+            SharedMemoryChannel a, b;
+            expect (a.createNewChannel (name, 4096));
+            expect (b.openExisting (name));
+
+            MemoryBlock sent, received;
+            Random r (4321);
+
+            for (int i = 0; i < 500; ++i)
+            {
+                fillMessage (sent, i, (size_t) r.nextInt (2000));
+                SharedMemoryChannel& from = (i & 1) != 0 ? a : b;
+                SharedMemoryChannel& to   = (i & 1) != 0 ? b : a;
+
+                expect (from.sendMessage (sent, 0));
+                expect (to.receiveMessage (received, 0));
+                expect (received == sent);
+            }
+
+            expect (! a.receiveMessage (received, 0));
+            expect (! a.sendMessage (sent.getData(), (size_t) a.getMaximumMessageSize() + 1, 0));
+
+            size_t size = 0;
+            float* const samples = static_cast <float*> (a.startWritingMessage (64 * sizeof (float), 0));
+            expect (samples != nullptr && (((pointer_sized_int) samples) & 15) == 0);
+
+            for (int i = 0; i < 64; ++i)
+                samples[i] = (float) i;
+
+            a.finishWritingMessage();
+
+            const float* const read = static_cast <const float*> (b.startReadingMessage (size, 0));
+            expect (read != nullptr && size == 64 * sizeof (float));
+            expect (read[0] == 0.0f && read[63] == 63.0f);
+            b.finishReadingMessage();
+        }
+
+        beginTest ("Full buffer");
+        {
+            const String name (getUniqueName());
+            SharedMemoryChannel a, b;
+            expect (a.createNewChannel (name, 4096));
+            expect (b.openExisting (name));
+
+            MemoryBlock m (1000), received;
+            int numSent = 0;
+
+            while (a.sendMessage (m, 0))
+                ++numSent;
+
+            expectEquals (numSent, 4);
+            expect (b.receiveMessage (received, 0));
+            expect (a.sendMessage (m, 0));
+        }
+
+        beginTest ("Threads");
+        {
+            const String name (getUniqueName());
+            SharedMemoryChannel a, b;
+            expect (a.createNewChannel (name, 8192));
+            expect (b.openExisting (name));
+
+            const int numMessages = 2000;
+            SenderThread sender (a, numMessages);
+            sender.startThread();
+
+            Random r (1234);
+            MemoryBlock expected, received;
+            int numCorrect = 0;
+
+            for (int i = 0; i < numMessages; ++i)
+            {
+                fillMessage (expected, i, (size_t) r.nextInt (3000));
+
+                if (b.receiveMessage (received, 5000) && received == expected)
+                    ++numCorrect;
+            }
+
+            sender.stopThread (5000);
+            expectEquals (numCorrect, numMessages);
+            expectEquals (sender.failures, 0);
+        }
+
+        beginTest ("Closing");
+        {
+            const String name (getUniqueName());
+            SharedMemoryChannel a, b;
+            expect (a.createNewChannel (name, 4096));
+            expect (b.openExisting (name));
+
+            MemoryBlock m (100), received;
+            expect (a.sendMessage (m, 0));
+            a.close();
+
+            expect (! b.isConnected());
+            expect (b.receiveMessage (received, 1000));
+
+            const uint32 start = Time::getMillisecondCounter();
+            expect (! b.receiveMessage (received, 5000));
+            expect (Time::getMillisecondCounter() - start < 1000);
+        }
+    }
+};
+
+static SharedMemoryChannelTests sharedMemoryChannelTests;
+
+#endif
@@ -0,0 +1,175 @@
+/*
+  ==============================================================================
+
+   This file is part of the juce_core module of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission to use, copy, modify, and/or distribute this software for any purpose with
+   or without fee is hereby granted, provided that the above copyright notice and this
+   permission notice appear in all copies.
+
+   THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+   TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+   NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+   DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+   IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+   ------------------------------------------------------------------------------
+
+   NOTE! This permissive ISC license applies ONLY to files within the juce_core module!
+   All other JUCE modules are covered by a dual GPL/commercial license, so if you are
+   using any other modules, be sure to check that you also comply with their license.
+
+   For more details, visit www.juce.com
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_SHAREDMEMORYCHANNEL_JUCEHEADER__
+#define __JUCE_SHAREDMEMORYCHANNEL_JUCEHEADER__
+
+
+//==============================================================================
+/**
+    A two-way message channel between two processes, using a named block of shared
+    memory.
+
+    One process calls createNewChannel() and the other calls openExisting() with the
+    same name. The shared block contains a ring buffer for each direction, and a message
+    is written directly into the ring by one end and read directly out of it by the other,
+    so unlike a NamedPipe or socket, no system calls are needed to move the data. The
+    OS is only involved when one end has to wait for the other - a futex on Linux, and
+    named events or semaphores elsewhere - and even then, only if the other end really
+    is waiting.
+
+    As well as the sendMessage() and receiveMessage() methods, which copy the data, you can
+    use startWritingMessage() and startReadingMessage() to get a pointer directly into the
+    ring, so that e.g. an audio callback can write its samples straight into the shared
+    memory and the other process can process them in-place.
+
+    Each direction is a single-producer, single-consumer queue: at each end, only one
+    thread at a time may be sending and only one thread at a time may be receiving
+    (these can be different threads). The ends can't tell when the other process has
+    crashed, so use timeouts if that matters. Once either end has been closed, the
+    channel is finished, and a new one must be created to talk again.
+
+    @see NamedPipe, InterprocessConnection
+*/
+class JUCE_API  SharedMemoryChannel
+{
+public:
+    //==============================================================================
+    /** Creates a SharedMemoryChannel that isn't yet open. */
+    SharedMemoryChannel();
+
+    /** Destructor. */
+    ~SharedMemoryChannel();
+
+    //==============================================================================
+    /** Creates a new shared channel with the given name.
+
+        The bufferSizeBytes is the size of the ring buffer used for each direction, and
+        will be rounded up to a power of two. A single message can't be bigger than
+        getMaximumMessageSize(), which is a little under half of this.
+
+        Returns true if it succeeds.
+    */
+    bool createNewChannel (const String& channelName, int bufferSizeBytes);
+
+    /** Tries to connect to a channel that another process has created.
+        Returns true if it succeeds.
+    */
+    bool openExisting (const String& channelName);
+
+    /** Closes the channel, if it's open.
+        Any threads that are waiting for messages from this end, or from the other
+        end, will be woken and given up on.
+    */
+    void close();
+
+    /** True if the channel is currently open. */
+    bool isOpen() const noexcept;
+
+    /** True if the channel is open and the other end is also attached to it. */
+    bool isConnected() const noexcept;
+
+    /** Returns the last name that was used to try to open this channel. */
+    String getName() const;
+
+    /** Returns the size of the largest message that can be sent through the channel. */
+    int getMaximumMessageSize() const noexcept;
+
+    //==============================================================================
+    /** Sends a message to the other end.
+
+        If there's not enough free space in the ring, this will wait for the other end to
+        read some messages, for up to timeOutMilliseconds (or forever if this is less than
+        zero). Returns false if it times out, if the message is too big, or if the channel
+        has been closed.
+    */
+    bool sendMessage (const void* messageData, size_t numBytes, int timeOutMilliseconds);
+
+    /** Sends a message to the other end.
+        @see sendMessage
+    */
+    bool sendMessage (const MemoryBlock& message, int timeOutMilliseconds);
+
+    /** Waits for the next message from the other end, and copies it into a MemoryBlock.
+
+        If timeOutMilliseconds is less than zero, it will wait indefinitely. Returns false if
+        it times out, or if the channel has been closed and there are no more messages.
+    */
+    bool receiveMessage (MemoryBlock& message, int timeOutMilliseconds);
+
+    //==============================================================================
+    /** Reserves space for a message in the ring, and returns a pointer to it.
+
+        You can write up to numBytes bytes of data to the pointer that's returned (it's
+        aligned to 16 bytes), and must then call finishWritingMessage() to send it. Until
+        you do, no other message can be sent from this end.
+
+        Returns nullptr if it times out, if the message is too big, or if the channel has
+        been closed.
+    */
+    void* startWritingMessage (size_t numBytes, int timeOutMilliseconds);
+
+    /** Sends the message that was started with startWritingMessage(). */
+    void finishWritingMessage();
+
+    /** Waits for the next message, and returns a pointer to its data in the ring.
+
+        The data (which is aligned to 16 bytes) stays valid, and can be modified in-place,
+        until you call finishReadingMessage(), which you must do before receiving another
+        message. Returns nullptr if it times out, or if the channel has been closed and there
+        are no more messages.
+    */
+    void* startReadingMessage (size_t& numBytes, int timeOutMilliseconds);
+
+    /** Releases the message that was returned by startReadingMessage(), so that its
+        space in the ring can be re-used.
+    */
+    void finishReadingMessage();
+
+private:
+    //==============================================================================
+    JUCE_PUBLIC_IN_DLL_BUILD (class Pimpl)
+    ScopedPointer<Pimpl> pimpl;
+    String currentChannelName;
+    int endIndex;
+    uint32 pendingWriteSize, pendingReadSize;
+
+    struct SharedHeader;
+    struct Ring;
+    SharedHeader* getHeader() const noexcept;
+    Ring& getRing (int index) const noexcept;
+    char* getRingData (int index) const noexcept;
+    bool waitFor (int ringIndex, bool waitForData, uint32 bytesNeeded, uint32 timeoutEnd);
+    bool isPeerGone() const noexcept;
+    bool openInternal (const String& channelName, size_t bufferSize, bool createChannel);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SharedMemoryChannel)
+};
+
+
+#endif   // __JUCE_SHAREDMEMORYCHANNEL_JUCEHEADER__
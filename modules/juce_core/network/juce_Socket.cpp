@@ -127,6 +127,116 @@ namespace SocketHelpers
         return bytesRead;
     }
 
+    // (IOV_MAX is 1024 on Linux and OSX - larger sets of buffers are written in chunks)
+    enum { maxBuffersPerCall = 1024 };
+
+    static int writeGathered (const SocketHandle handle, const SocketBuffer* const buffers, const int numBuffers,
+                              const struct addrinfo* const destAddress, const bool writeEverything)
+    {
+        jassert (buffers != nullptr || numBuffers == 0);
+
+       #if JUCE_WINDOWS
+        HeapBlock<WSABUF> bufs ((size_t) numBuffers);
+
+        for (int i = 0; i < numBuffers; ++i)
+        {
+            bufs[i].buf = static_cast <char*> (buffers[i].data);
+            bufs[i].len = (ULONG) buffers[i].size;
+        }
+       #else
+        HeapBlock<struct iovec> bufs ((size_t) numBuffers);
+
+        for (int i = 0; i < numBuffers; ++i)
+        {
+            bufs[i].iov_base = buffers[i].data;
+            bufs[i].iov_len = (size_t) buffers[i].size;
+        }
+       #endif
+
+        int totalWritten = 0, first = 0;
+
+        while (first < numBuffers)
+        {
+            const int num = jmin (numBuffers - first, (int) maxBuffersPerCall);
+            int result;
+
+           #if JUCE_WINDOWS
+            DWORD bytesSent = 0;
+
+            if (destAddress != nullptr)
+                result = WSASendTo (handle, bufs + first, (DWORD) num, &bytesSent, 0,
+                                    destAddress->ai_addr, (int) destAddress->ai_addrlen, nullptr, nullptr);
+            else
+                result = WSASend (handle, bufs + first, (DWORD) num, &bytesSent, 0, nullptr, nullptr);
+
+            if (result == 0)
+                result = (int) bytesSent;
+           #else
+            struct msghdr message;
+            zerostruct (message);
+            message.msg_iov = bufs + first;
+            message.msg_iovlen = num;
+
+            if (destAddress != nullptr)
+            {
+                message.msg_name = destAddress->ai_addr;
+                message.msg_namelen = (juce_socklen_t) destAddress->ai_addrlen;
+            }
+
+            while ((result = (int) ::sendmsg (handle, &message, 0)) < 0
+                    && errno == EINTR)
+            {
+            }
+           #endif
+
+            if (result < 0)
+                return -1;
+
+            totalWritten += result;
+
+            if (! writeEverything)
+                break;
+
+            // skip past whatever was written, which may have ended part-way through a buffer
+           #if JUCE_WINDOWS
+            while (first < numBuffers && (ULONG) result >= bufs[first].len)
+            {
+                result -= (int) bufs[first++].len;
+            }
+
+            if (first < numBuffers)
+            {
+                bufs[first].buf += result;
+                bufs[first].len -= (ULONG) result;
+            }
+           #else
+            while (first < numBuffers && (size_t) result >= bufs[first].iov_len)
+            {
+                result -= (int) bufs[first++].iov_len;
+            }
+
+            if (first < numBuffers)
+            {
+                bufs[first].iov_base = static_cast <char*> (bufs[first].iov_base) + result;
+                bufs[first].iov_len -= (size_t) result;
+            }
+           #endif
+        }
+
+        return totalWritten;
+    }
+
+    static bool setBusyPolling (const SocketHandle handle, const int microseconds) noexcept
+    {
+       #if JUCE_LINUX && defined (SO_BUSY_POLL)
+        return handle > 0
+                && setsockopt (handle, SOL_SOCKET, SO_BUSY_POLL, (const char*) &microseconds, sizeof (microseconds)) == 0;
+       #else
+        (void) handle; (void) microseconds;
+        return false;
+       #endif
+    }
+
     static int waitForReadiness (const SocketHandle handle, const bool forReading, const int timeoutMsecs) noexcept
     {
         struct timeval timeout;
@@ -318,6 +428,27 @@ int StreamingSocket::write (const void* sourceBuffer, const int numBytesToWrite)
    #endif
 }
 
+int StreamingSocket::write (const SocketBuffer* const buffers, const int numBuffers)
+{
+    if (isListener || ! connected)
+        return -1;
+
+    return SocketHelpers::writeGathered (handle, buffers, numBuffers, nullptr, true);
+}
+
+bool StreamingSocket::setNoDelay (const bool shouldSendImmediately)
+{
+    const int flag = shouldSendImmediately ? 1 : 0;
+
+    return handle > 0
+            && setsockopt (handle, IPPROTO_TCP, TCP_NODELAY, (const char*) &flag, sizeof (flag)) == 0;
+}
+
+bool StreamingSocket::setBusyPolling (const int microseconds)
+{
+    return SocketHelpers::setBusyPolling (handle, microseconds);
+}
+
 //==============================================================================
 int StreamingSocket::waitUntilReady (const bool readyForReading,
                                      const int timeoutMsecs) const
@@ -580,6 +711,128 @@ int DatagramSocket::write (const void* sourceBuffer, const int numBytesToWrite)
                      : -1;
 }
 
+int DatagramSocket::write (const SocketBuffer* const buffers, const int numBuffers)
+{
+    // You need to call connect() first to set the server address..
+    jassert (serverAddress != nullptr && connected);
+
+    return connected ? SocketHelpers::writeGathered (handle, buffers, numBuffers,
+                                                     static_cast <const struct addrinfo*> (serverAddress), false)
+                     : -1;
+}
+
+int DatagramSocket::writeMultiple (const SocketBuffer* const datagrams, const int numDatagrams)
+{
+    // You need to call connect() first to set the server address..
+    jassert (serverAddress != nullptr && connected);
+
+    if (! connected)
+        return -1;
+
+    const struct addrinfo* const address = static_cast <const struct addrinfo*> (serverAddress);
+
+   #if JUCE_LINUX
+    HeapBlock<struct mmsghdr> messages ((size_t) numDatagrams, true);
+    HeapBlock<struct iovec> bufs ((size_t) numDatagrams);
+
+    for (int i = 0; i < numDatagrams; ++i)
+    {
+        bufs[i].iov_base = datagrams[i].data;
+        bufs[i].iov_len = (size_t) datagrams[i].size;
+
+        struct msghdr& m = messages[i].msg_hdr;
+        m.msg_iov = bufs + i;
+        m.msg_iovlen = 1;
+        m.msg_name = address->ai_addr;
+        m.msg_namelen = (juce_socklen_t) address->ai_addrlen;
+    }
+
+    int numSent = 0;
+
+    while (numSent < numDatagrams)
+    {
+        const int result = ::sendmmsg (handle, messages + numSent, (unsigned int) (numDatagrams - numSent), 0);
+
+        if (result < 0)
+        {
+            if (errno == EINTR)
+                continue;
+
+            return numSent > 0 ? numSent : -1;
+        }
+
+        numSent += result;
+    }
+
+    return numSent;
+   #else
+    for (int i = 0; i < numDatagrams; ++i)
+    {
+        if (sendto (handle, (const char*) datagrams[i].data, (size_t) datagrams[i].size, 0,
+                    address->ai_addr, (juce_socklen_t) address->ai_addrlen) < 0)
+            return i > 0 ? i : -1;
+    }
+
+    return numDatagrams;
+   #endif
+}
+
+int DatagramSocket::readMultiple (SocketBuffer* const datagrams, const int numDatagrams, const int timeoutMsecs)
+{
+    if (! connected || numDatagrams <= 0)
+        return -1;
+
+    const int ready = waitUntilReady (true, timeoutMsecs);
+
+    if (ready <= 0)
+        return ready;
+
+   #if JUCE_LINUX
+    HeapBlock<struct mmsghdr> messages ((size_t) numDatagrams, true);
+    HeapBlock<struct iovec> bufs ((size_t) numDatagrams);
+
+    for (int i = 0; i < numDatagrams; ++i)
+    {
+        bufs[i].iov_base = datagrams[i].data;
+        bufs[i].iov_len = (size_t) datagrams[i].size;
+        messages[i].msg_hdr.msg_iov = bufs + i;
+        messages[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    int result;
+
+    while ((result = ::recvmmsg (handle, messages, (unsigned int) numDatagrams, MSG_DONTWAIT, nullptr)) < 0
+            && errno == EINTR)
+    {
+    }
+
+    for (int i = 0; i < result; ++i)
+        datagrams[i].size = (int) messages[i].msg_len;
+
+    return result;
+   #else
+    int numRead = 0;
+
+    while (numRead < numDatagrams
+            && (numRead == 0 || waitUntilReady (true, 0) == 1))
+    {
+        const int result = (int) recv (handle, (char*) datagrams[numRead].data, (size_t) datagrams[numRead].size, 0);
+
+        if (result < 0)
+            return numRead > 0 ? numRead : -1;
+
+        datagrams[numRead++].size = result;
+    }
+
+    return numRead;
+   #endif
+}
+
+bool DatagramSocket::setBusyPolling (const int microseconds)
+{
+    return SocketHelpers::setBusyPolling (handle, microseconds);
+}
+
 bool DatagramSocket::isLocal() const noexcept
 {
     return hostName == "127.0.0.1";
@@ -32,6 +32,38 @@
 #include "../text/juce_String.h"
 
 
+//==============================================================================
+/**
+    Points to a block of memory that a socket can read into or write from.
+
+    Arrays of these are used by the socket methods that send several blocks of
+    data with one system call, without them having to be copied into a single
+    buffer first.
+
+    @see StreamingSocket::write, DatagramSocket::writeMultiple, DatagramSocket::readMultiple
+*/
+struct SocketBuffer
+{
+    /** Creates an empty buffer. */
+    SocketBuffer() noexcept                                 : data (nullptr), size (0) {}
+
+    /** Creates a buffer that refers to a block of memory. */
+    SocketBuffer (void* d, int numBytes) noexcept           : data (d), size (numBytes) {}
+
+    /** Creates a buffer that refers to a block of read-only memory, which can
+        only be used for writing to a socket.
+    */
+    SocketBuffer (const void* d, int numBytes) noexcept     : data (const_cast <void*> (d)), size (numBytes) {}
+
+    /** The start of the block. */
+    void* data;
+
+    /** The number of bytes in the block (for reading, this is the capacity on input,
+        and is set to the number of bytes received). */
+    int size;
+};
+
+
 //==============================================================================
 /**
     A wrapper for a streaming (TCP) socket.
@@ -134,6 +166,39 @@ public:
     */
     int write (const void* sourceBuffer, int numBytesToWrite);
 
+    /** Writes a set of separate blocks to the socket, as if they'd been joined together.
+
+        This uses a single gathering system call (writev or WSASend), so it avoids both
+        the cost of copying the blocks into one buffer and that of making one call per
+        block. Like the other write() method, it will block until all the data has been
+        sent, unless the socket was ready for writing.
+
+        @returns the total number of bytes written, or -1 if there was an error.
+    */
+    int write (const SocketBuffer* buffers, int numBuffers);
+
+    //==============================================================================
+    /** Enables or disables Nagle's algorithm (the TCP_NODELAY option).
+
+        Connected sockets have it disabled by default, so that small writes are sent
+        immediately - you might want to enable it if you're sending lots of tiny writes
+        and care more about bandwidth than latency.
+
+        @returns true if the option could be set
+    */
+    bool setNoDelay (bool shouldSendImmediately);
+
+    /** Asks the OS to busy-poll the network device for this socket's incoming data for
+        up to the given number of microseconds, rather than waiting for an interrupt.
+
+        This is the SO_BUSY_POLL option, which is only available on Linux (and may need
+        extra privileges to set). It can take a little latency off each blocking read,
+        at the expense of CPU time. Passing 0 turns it off.
+
+        @returns true if the option could be set
+    */
+    bool setBusyPolling (int microseconds);
+
     //==============================================================================
     /** Puts this socket into "listener" mode.
 
@@ -282,6 +347,43 @@ public:
     */
     int write (const void* sourceBuffer, int numBytesToWrite);
 
+    /** Sends a set of separate blocks as a single datagram, without copying them
+        into one buffer first (e.g. a packet header and its payload).
+
+        @returns the number of bytes written, or -1 if there was an error.
+    */
+    int write (const SocketBuffer* buffers, int numBuffers);
+
+    //==============================================================================
+    /** Sends each of a set of blocks as a separate datagram.
+
+        On Linux this sends all of them with a single sendmmsg() call, so it's much
+        cheaper than calling write() for each one.
+
+        @returns the number of datagrams that were sent, or -1 if there was an error
+                 before any could be sent.
+    */
+    int writeMultiple (const SocketBuffer* datagrams, int numDatagrams);
+
+    /** Receives as many datagrams as are waiting, up to the number of buffers supplied.
+
+        This blocks until at least one datagram arrives, unless the timeout expires, and
+        then returns any others that are already waiting without blocking again. Each
+        buffer's size is changed to the number of bytes in the datagram that was read into
+        it. On Linux, this uses a single recvmmsg() call.
+
+        @param datagrams        the buffers to read into
+        @param numDatagrams     the number of buffers
+        @param timeoutMsecs     how long to wait for the first datagram, or -1 to wait forever
+        @returns the number of datagrams that were received, or -1 if there was an error
+    */
+    int readMultiple (SocketBuffer* datagrams, int numDatagrams, int timeoutMsecs = -1);
+
+    /** Asks the OS to busy-poll the network device for this socket's incoming data.
+        @see StreamingSocket::setBusyPolling
+    */
+    bool setBusyPolling (int microseconds);
+
     //==============================================================================
     /** This waits for incoming data to be sent, and returns a socket that can be used
         to read it.
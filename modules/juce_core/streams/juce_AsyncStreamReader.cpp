@@ -0,0 +1,153 @@
+/*
+  ==============================================================================
+
+   This file is part of the juce_core module of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission to use, copy, modify, and/or distribute this software for any purpose with
+   or without fee is hereby granted, provided that the above copyright notice and this
+   permission notice appear in all copies.
+
+   THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+   TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+   NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+   DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+   IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+   ------------------------------------------------------------------------------
+
+   NOTE! This permissive ISC license applies ONLY to files within the juce_core module!
+   All other JUCE modules are covered by a dual GPL/commercial license, so if you are
+   using any other modules, be sure to check that you also comply with their license.
+
+   For more details, visit www.juce.com
+
+  ==============================================================================
+*/
+
+AsyncStreamReader::Request::Request (const int64 pos, void* const dest, const int numBytes, Listener* const l)
+    : position (pos), destData (dest), numBytesRequested (numBytes),
+      numBytesRead (0), listener (l), finished (false), cancelled (false),
+      finishedEvent (true)
+{
+}
+
+bool AsyncStreamReader::Request::waitUntilFinished (const int timeOutMilliseconds) const
+{
+    return finished || (finishedEvent.wait (timeOutMilliseconds) && finished);
+}
+
+void AsyncStreamReader::Request::finish (const int numRead, const bool wasCancelled)
+{
+    numBytesRead = numRead;
+    cancelled = wasCancelled;
+    finished = true;
+
+    if (listener != nullptr && ! wasCancelled)
+        listener->readFinished (*this);
+
+    finishedEvent.signal();
+}
+
+//==============================================================================
+AsyncStreamReader::AsyncStreamReader (InputStream* const sourceStream,
+                                      const bool deleteSourceWhenDestroyed,
+                                      TimeSliceThread& backgroundThread)
+    : source (sourceStream, deleteSourceWhenDestroyed),
+      thread (backgroundThread)
+{
+    // You need to supply a real stream!
+    jassert (sourceStream != nullptr);
+
+    thread.addTimeSliceClient (this);
+}
+
+AsyncStreamReader::~AsyncStreamReader()
+{
+    thread.removeTimeSliceClient (this);
+    cancelAll();
+}
+
+//==============================================================================
+AsyncStreamReader::Request::Ptr AsyncStreamReader::read (const int64 position, void* const destBuffer,
+                                                         const int numBytes, Listener* const listener)
+{
+    jassert (destBuffer != nullptr && numBytes >= 0 && position >= 0);
+
+    Request::Ptr request (new Request (position, destBuffer, numBytes, listener));
+
+    {
+        const ScopedLock sl (queueLock);
+        queue.add (request);
+    }
+
+    thread.moveToFrontOfQueue (this);
+    return request;
+}
+
+bool AsyncStreamReader::cancel (Request* const request)
+{
+    {
+        const ScopedLock sl (queueLock);
+
+        if (queue.contains (request))
+        {
+            queue.removeObject (request);
+            request->finish (0, true);
+            return true;
+        }
+    }
+
+    // if it wasn't in the queue, it's either finished or being read right now
+    const ScopedLock sl (readLock);
+    return false;
+}
+
+void AsyncStreamReader::cancelAll()
+{
+    ReferenceCountedArray<Request> cancelled;
+
+    {
+        const ScopedLock sl (queueLock);
+        cancelled.swapWithArray (queue);
+    }
+
+    for (int i = 0; i < cancelled.size(); ++i)
+        cancelled.getObjectPointerUnchecked (i)->finish (0, true);
+
+    const ScopedLock sl (readLock);
+}
+
+int AsyncStreamReader::getNumPendingRequests() const
+{
+    const ScopedLock sl (queueLock);
+    return queue.size();
+}
+
+int AsyncStreamReader::useTimeSlice()
+{
+    const ScopedLock sl (readLock);
+
+    Request::Ptr request;
+
+    {
+        const ScopedLock sl2 (queueLock);
+
+        if (queue.size() == 0)
+            return 500;
+
+        request = queue.getObjectPointerUnchecked (0);
+        queue.remove (0);
+    }
+
+    int numRead = 0;
+
+    if (source->getPosition() == request->position || source->setPosition (request->position))
+        numRead = jmax (0, source->read (request->destData, request->numBytesRequested));
+
+    request->finish (numRead, false);
+
+    const ScopedLock sl2 (queueLock);
+    return queue.size() > 0 ? 0 : 500;
+}
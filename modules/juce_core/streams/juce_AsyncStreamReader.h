@@ -0,0 +1,200 @@
+/*
+  ==============================================================================
+
+   This file is part of the juce_core module of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission to use, copy, modify, and/or distribute this software for any purpose with
+   or without fee is hereby granted, provided that the above copyright notice and this
+   permission notice appear in all copies.
+
+   THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+   TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+   NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+   DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+   IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+   ------------------------------------------------------------------------------
+
+   NOTE! This permissive ISC license applies ONLY to files within the juce_core module!
+   All other JUCE modules are covered by a dual GPL/commercial license, so if you are
+   using any other modules, be sure to check that you also comply with their license.
+
+   For more details, visit www.juce.com
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_ASYNCSTREAMREADER_JUCEHEADER__
+#define __JUCE_ASYNCSTREAMREADER_JUCEHEADER__
+
+#include "juce_InputStream.h"
+#include "../memory/juce_OptionalScopedPointer.h"
+#include "../memory/juce_ReferenceCountedObject.h"
+#include "../containers/juce_ReferenceCountedArray.h"
+#include "../threads/juce_TimeSliceThread.h"
+#include "../threads/juce_WaitableEvent.h"
+
+
+//==============================================================================
+/**
+    Reads blocks from an InputStream on a background thread, so that the thread
+    which asks for the data doesn't have to wait while it's read.
+
+    You call read() to queue a request, and it returns a Request object straight
+    away. The request's data is then read on a TimeSliceThread, in the order the
+    requests were made. When it's done, the Listener you supplied is called (on the
+    background thread), and anyone waiting in Request::waitUntilFinished() is woken.
+    So you can either use callbacks, or hang onto the Request and treat it like a
+    future.
+
+    The source stream belongs to the background thread while this object exists,
+    so you mustn't use it directly. For lots of small sequential requests, it's
+    worth wrapping the source in a BufferedInputStream.
+
+    e.g.
+    @code
+    AsyncStreamReader reader (file.createInputStream(), true, backgroundThread);
+
+    AsyncStreamReader::Request::Ptr request (reader.read (0, myBuffer, 65536));
+
+    ...do something else...
+
+    if (request->waitUntilFinished (1000))
+        useData (myBuffer, request->getNumBytesRead());
+    @endcode
+
+    @see BufferedInputStream::startReadAhead
+*/
+class JUCE_API  AsyncStreamReader  : private TimeSliceClient
+{
+public:
+    //==============================================================================
+    /** Creates a reader for a stream.
+
+        @param sourceStream                 the stream to read from
+        @param deleteSourceWhenDestroyed    whether the sourceStream that is passed in should be
+                                            deleted by this object when it is itself deleted
+        @param backgroundThread             the thread that will do the reading. This must be
+                                            started by the caller, and kept running for as long
+                                            as this reader exists. It can be shared with other clients.
+    */
+    AsyncStreamReader (InputStream* sourceStream,
+                       bool deleteSourceWhenDestroyed,
+                       TimeSliceThread& backgroundThread);
+
+    /** Destructor.
+        Any requests that haven't been started are cancelled, and if one is being read, this
+        will wait for it to finish.
+    */
+    ~AsyncStreamReader();
+
+    //==============================================================================
+    class Request;
+
+    /** Receives a callback when a request has finished. */
+    class JUCE_API  Listener
+    {
+    public:
+        /** Destructor. */
+        virtual ~Listener()  {}
+
+        /** Called on the background thread when a request has been read.
+            This isn't called for requests that get cancelled.
+        */
+        virtual void readFinished (Request& request) = 0;
+    };
+
+    //==============================================================================
+    /** A pending or finished read. */
+    class JUCE_API  Request  : public ReferenceCountedObject
+    {
+    public:
+        /** Returns the position in the source stream that the data is read from. */
+        int64 getPosition() const noexcept                      { return position; }
+
+        /** Returns the buffer that the data is read into. */
+        void* getDestData() const noexcept                      { return destData; }
+
+        /** Returns the number of bytes that were asked for. */
+        int getNumBytesRequested() const noexcept               { return numBytesRequested; }
+
+        /** Returns the number of bytes that were actually read.
+            This is only valid once isFinished() returns true - it may be less than the
+            number requested if the stream ran out of data.
+        */
+        int getNumBytesRead() const noexcept                    { return numBytesRead; }
+
+        /** Returns true if the read has been done, or has been cancelled. */
+        bool isFinished() const noexcept                        { return finished; }
+
+        /** Returns true if the request was cancelled before it could be read. */
+        bool wasCancelled() const noexcept                      { return cancelled; }
+
+        /** Waits for the request to finish.
+            @param timeOutMilliseconds  the maximum time to wait, or -1 to wait forever
+            @returns true if the request has finished
+        */
+        bool waitUntilFinished (int timeOutMilliseconds = -1) const;
+
+        /** A pointer to a Request. */
+        typedef ReferenceCountedObjectPtr<Request> Ptr;
+
+    private:
+        friend class AsyncStreamReader;
+        const int64 position;
+        void* const destData;
+        const int numBytesRequested;
+        int numBytesRead;
+        Listener* const listener;
+        bool volatile finished, cancelled;
+        WaitableEvent finishedEvent;
+
+        Request (int64, void*, int, Listener*);
+        void finish (int numRead, bool wasCancelled);
+
+        JUCE_DECLARE_NON_COPYABLE (Request)
+    };
+
+    //==============================================================================
+    /** Queues a read of some data from the stream.
+
+        The destination buffer must remain valid until the request has finished (or
+        been cancelled).
+
+        @param position     the position in the source stream to read from
+        @param destBuffer   the buffer to read the data into
+        @param numBytes     the number of bytes to read
+        @param listener     an optional listener to call when the data has been read
+        @returns the request, which can be used to wait for the data
+    */
+    Request::Ptr read (int64 position, void* destBuffer, int numBytes, Listener* listener = nullptr);
+
+    /** Cancels a request, if it hasn't been started yet.
+        If it's already being read, this will wait for it to finish.
+        @returns true if the request was cancelled before being read
+    */
+    bool cancel (Request* request);
+
+    /** Cancels all the requests that haven't been started, and waits for any that
+        is currently being read.
+    */
+    void cancelAll();
+
+    /** Returns the number of requests waiting to be read. */
+    int getNumPendingRequests() const;
+
+private:
+    //==============================================================================
+    OptionalScopedPointer<InputStream> source;
+    TimeSliceThread& thread;
+    CriticalSection queueLock, readLock;
+    ReferenceCountedArray<Request> queue;
+
+    int useTimeSlice();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AsyncStreamReader)
+};
+
+#endif   // __JUCE_ASYNCSTREAMREADER_JUCEHEADER__
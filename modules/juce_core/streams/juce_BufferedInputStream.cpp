@@ -43,6 +43,78 @@ namespace
     }
 }
 
+//==============================================================================
+/*  Keeps one block of the source stream, starting where the stream's buffer
+    ends, read in advance on a TimeSliceThread. All access to the source goes
+    through the lock while this exists.
+*/
+class BufferedInputStream::ReadAheadClient  : public TimeSliceClient
+{
+public:
+    ReadAheadClient (InputStream& s, TimeSliceThread& t, const int size)
+        : source (s), thread (t), blockSize (size),
+          blockStart (-1), wantedStart (-1), numBytesInBlock (0), blockHitEnd (false)
+    {
+        block.malloc ((size_t) blockSize);
+        thread.addTimeSliceClient (this);
+    }
+
+    ~ReadAheadClient()
+    {
+        thread.removeTimeSliceClient (this);
+    }
+
+    int useTimeSlice()
+    {
+        const ScopedLock sl (lock);
+
+        if (wantedStart < 0 || wantedStart == blockStart)
+            return 500;
+
+        blockStart = -1;
+
+        if (source.getPosition() == wantedStart || source.setPosition (wantedStart))
+        {
+            numBytesInBlock = jmax (0, source.read (block, blockSize));
+            blockHitEnd = numBytesInBlock < blockSize;
+            blockStart = wantedStart;
+        }
+        else
+        {
+            wantedStart = -1;
+        }
+
+        return 500;
+    }
+
+    // Asks for the block starting at this position to be read next.
+    void requestBlockAt (const int64 pos)
+    {
+        {
+            const ScopedLock sl (lock);
+
+            if (wantedStart == pos)
+                return;
+
+            wantedStart = pos;
+        }
+
+        thread.moveToFrontOfQueue (this);
+    }
+
+    InputStream& source;
+    TimeSliceThread& thread;
+    CriticalSection lock;
+    HeapBlock<char> block;
+    const int blockSize;
+    int64 blockStart, wantedStart;
+    int numBytesInBlock;
+    bool blockHitEnd;
+
+private:
+    JUCE_DECLARE_NON_COPYABLE (ReadAheadClient)
+};
+
 //==============================================================================
 BufferedInputStream::BufferedInputStream (InputStream* const sourceStream, const int bufferSize_,
                                           const bool deleteSourceWhenDestroyed)
@@ -51,7 +123,8 @@ BufferedInputStream::BufferedInputStream (InputStream* const sourceStream, const
      position (sourceStream->getPosition()),
      lastReadPos (0),
      bufferStart (position),
-     bufferOverlap (128)
+     bufferOverlap (128),
+     sourceExhausted (false)
 {
     buffer.malloc ((size_t) bufferSize);
 }
@@ -62,18 +135,98 @@ BufferedInputStream::BufferedInputStream (InputStream& sourceStream, const int b
      position (sourceStream.getPosition()),
      lastReadPos (0),
      bufferStart (position),
-     bufferOverlap (128)
+     bufferOverlap (128),
+     sourceExhausted (false)
 {
     buffer.malloc ((size_t) bufferSize);
 }
 
 BufferedInputStream::~BufferedInputStream()
 {
+    stopReadAhead();
+}
+
+//==============================================================================
+void BufferedInputStream::startReadAhead (TimeSliceThread& thread)
+{
+    stopReadAhead();
+    readAhead = new ReadAheadClient (*source, thread, bufferSize);
+
+    if (lastReadPos > bufferStart)
+        readAhead->requestBlockAt (lastReadPos);
+}
+
+void BufferedInputStream::stopReadAhead()
+{
+    if (readAhead != nullptr)
+    {
+        readAhead = nullptr;
+
+        // (the thread may have left the source somewhere else)
+        if (lastReadPos > bufferStart)
+            source->setPosition (lastReadPos);
+    }
+}
+
+int BufferedInputStream::readFromSource (const int64 sourcePosition, char* const dest,
+                                         const int numBytes, const bool sourceIsInPosition)
+{
+    if (readAhead == nullptr)
+    {
+        if (! sourceIsInPosition)
+            source->setPosition (sourcePosition);
+
+        const int num = source->read (dest, numBytes);
+        sourceExhausted = num < numBytes;
+        return num;
+    }
+
+    int numRead = 0;
+    sourceExhausted = false;
+
+    {
+        const ScopedLock sl (readAhead->lock);
+
+        const int64 blockStart = readAhead->blockStart;
+
+        if (blockStart >= 0
+             && sourcePosition >= blockStart
+             && sourcePosition < blockStart + readAhead->numBytesInBlock)
+        {
+            const int offset = (int) (sourcePosition - blockStart);
+            numRead = jmin (numBytes, readAhead->numBytesInBlock - offset);
+            memcpy (dest, readAhead->block + offset, (size_t) numRead);
+            sourceExhausted = numRead < numBytes && readAhead->blockHitEnd;
+        }
+
+        if (numRead < numBytes && ! sourceExhausted)
+        {
+            const int64 pos = sourcePosition + numRead;
+
+            if (source->getPosition() == pos || source->setPosition (pos))
+            {
+                const int num = jmax (0, source->read (dest + numRead, numBytes - numRead));
+                sourceExhausted = num < numBytes - numRead;
+                numRead += num;
+            }
+        }
+    }
+
+    if (! sourceExhausted)
+        readAhead->requestBlockAt (sourcePosition + numRead);
+
+    return numRead;
 }
 
 //==============================================================================
 int64 BufferedInputStream::getTotalLength()
 {
+    if (readAhead != nullptr)
+    {
+        const ScopedLock sl (readAhead->lock);
+        return source->getTotalLength();
+    }
+
     return source->getTotalLength();
 }
 
@@ -90,6 +243,9 @@ bool BufferedInputStream::setPosition (int64 newPosition)
 
 bool BufferedInputStream::isExhausted()
 {
+    if (readAhead != nullptr)
+        return position >= lastReadPos && sourceExhausted;
+
     return position >= lastReadPos && source->isExhausted();
 }
 
@@ -110,8 +266,8 @@ void BufferedInputStream::ensureBuffered()
 
             bufferStart = position;
 
-            bytesRead = source->read (buffer + bytesToKeep,
-                                      (int) (bufferSize - bytesToKeep));
+            bytesRead = readFromSource (lastReadPos, buffer + bytesToKeep,
+                                        (int) (bufferSize - bytesToKeep), true);
 
             lastReadPos += bytesRead;
             bytesRead += bytesToKeep;
@@ -119,8 +275,7 @@ void BufferedInputStream::ensureBuffered()
         else
         {
             bufferStart = position;
-            source->setPosition (bufferStart);
-            bytesRead = source->read (buffer, bufferSize);
+            bytesRead = readFromSource (bufferStart, buffer, bufferSize, false);
             lastReadPos = bufferStart + bytesRead;
         }
 
@@ -196,3 +351,95 @@ String BufferedInputStream::readString()
 
     return InputStream::readString();
 }
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class BufferedInputStreamTests  : public UnitTest
+{
+public:
+    BufferedInputStreamTests() : UnitTest ("BufferedInputStream & AsyncStreamReader") {}
+
+    void runTest()
+    {
+        Random r;
+        MemoryBlock data (100000 + (size_t) r.nextInt (1000));
+
+        for (size_t i = 0; i < data.getSize(); ++i)
+            data[i] = (char) r.nextInt (256);
+
+        TimeSliceThread thread ("read-ahead test");
+        thread.startThread();
+
+        for (int readingAhead = 0; readingAhead < 2; ++readingAhead)
+        {
+            beginTest (readingAhead != 0 ? "Reading ahead" : "Reading");
+
+            BufferedInputStream in (new MemoryInputStream (data, false), 4096, true);
+
+            if (readingAhead != 0)
+                in.startReadAhead (thread);
+
+            expect (in.isReadingAhead() == (readingAhead != 0));
+
+            MemoryBlock readBack (data.getSize());
+            char* const dest = static_cast<char*> (readBack.getData());
+            int64 pos = 0;
+
+            while (! in.isExhausted())
+            {
+                const int num = in.read (dest + pos, r.nextInt (3000));
+                expect (num >= 0);
+                pos += num;
+            }
+
+            expect (pos == (int64) data.getSize());
+            expect (readBack == data);
+
+            for (int i = 0; i < 50; ++i)
+            {
+                const int start = r.nextInt ((int) data.getSize());
+                const int num = jmin ((int) data.getSize() - start, r.nextInt (10000));
+
+                expect (in.setPosition (start));
+                expect (in.read (dest, num) == num);
+                expect (memcmp (dest, static_cast<const char*> (data.getData()) + start, (size_t) num) == 0);
+            }
+
+            in.stopReadAhead();
+            expect (! in.isReadingAhead());
+        }
+
+        beginTest ("Async reads");
+
+        {
+            AsyncStreamReader reader (new MemoryInputStream (data, false), true, thread);
+            MemoryBlock readBack (data.getSize());
+            char* const dest = static_cast<char*> (readBack.getData());
+
+            ReferenceCountedArray<AsyncStreamReader::Request> requests;
+            const int blockSize = 7000;
+
+            for (int pos = 0; pos < (int) data.getSize(); pos += blockSize)
+                requests.add (reader.read (pos, dest + pos, blockSize));
+
+            int total = 0;
+
+            for (int i = 0; i < requests.size(); ++i)
+            {
+                expect (requests[i]->waitUntilFinished (10000));
+                expect (! requests[i]->wasCancelled());
+                total += requests[i]->getNumBytesRead();
+            }
+
+            expect (total == (int) data.getSize());
+            expect (readBack == data);
+        }
+
+        thread.stopThread (5000);
+    }
+};
+
+static BufferedInputStreamTests bufferedInputStreamUnitTests;
+
+#endif
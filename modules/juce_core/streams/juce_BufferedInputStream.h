@@ -32,6 +32,9 @@
 #include "juce_InputStream.h"
 #include "../memory/juce_OptionalScopedPointer.h"
 #include "../memory/juce_HeapBlock.h"
+#include "../memory/juce_ScopedPointer.h"
+
+class TimeSliceThread;
 
 
 //==============================================================================
@@ -41,6 +44,11 @@
     small read accesses to it, it's probably sensible to wrap it in one of these,
     so that the source stream gets accessed in larger chunk sizes, meaning less
     work for the underlying stream.
+
+    If you call startReadAhead(), the next block of the source is read on a
+    background thread while you're busy with the current one, so that a thread
+    which is reading sequentially through a slow stream (e.g. a decoder reading
+    a file from disk) will rarely have to wait for it.
 */
 class JUCE_API  BufferedInputStream  : public InputStream
 {
@@ -81,14 +89,46 @@ public:
     String readString();
     bool isExhausted();
 
+    //==============================================================================
+    /** Starts reading ahead of the current position on a background thread.
+
+        Each time the stream refills its buffer, the thread is asked to read the
+        block that follows it, so if you're reading sequentially, the next refill
+        will usually just be a copy. Seeking elsewhere simply means that the next
+        refill reads from the source directly, and the read-ahead carries on from
+        there.
+
+        Once this has been called, the source stream is used by both the thread
+        and the reader, so you mustn't access it yourself until stopReadAhead() has
+        been called. The thread must be kept running for as long as read-ahead is
+        active, and it can be shared by any number of streams. Calling this when
+        read-ahead is already running simply moves it to the new thread.
+    */
+    void startReadAhead (TimeSliceThread& thread);
+
+    /** Stops the background read-ahead, if startReadAhead() was called.
+        This will wait for any read that the thread has in progress to finish. It's
+        also called automatically by the destructor.
+    */
+    void stopReadAhead();
+
+    /** Returns true if startReadAhead() is active. */
+    bool isReadingAhead() const noexcept                { return readAhead != nullptr; }
 
 private:
     //==============================================================================
+    class ReadAheadClient;
+    friend class ReadAheadClient;
+
     OptionalScopedPointer<InputStream> source;
     int bufferSize;
     int64 position, lastReadPos, bufferStart, bufferOverlap;
     HeapBlock <char> buffer;
+    ScopedPointer<ReadAheadClient> readAhead;
+    bool sourceExhausted;
+
     void ensureBuffered();
+    int readFromSource (int64 sourcePosition, char* dest, int numBytes, bool sourceIsInPosition);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (BufferedInputStream)
 };
@@ -130,6 +130,35 @@ public:
         expect (mi.readInt64BigEndian() == randomInt64);
         expect (mi.readDouble() == randomDouble);
         expect (mi.readDoubleBigEndian() == randomDouble);
+
+        beginTest ("Growth policy");
+        {
+            MemoryOutputStream grown (16);
+            grown.setGrowthPolicy (1.0, 4096);
+            grown.writeRepeatedByte (1, 100);
+            expect (grown.getCapacity() >= 200 && grown.getCapacity() <= 256);
+            grown.writeRepeatedByte (1, 10000);
+            expect (grown.getCapacity() >= 10100 + 4096 && grown.getCapacity() <= 10100 + 4096 + 64);
+            expectEquals ((int) grown.getDataSize(), 10100);
+        }
+
+        beginTest ("External buffer");
+        {
+            char buffer [16] = { 0 };
+            MemoryOutputStream fixed (buffer, sizeof (buffer));
+            expect (fixed.write ("abcdefgh", 8));
+            fixed.writeInt (0x64636261);
+            expect (fixed.getData() == buffer);
+            expectEquals ((int) fixed.getDataSize(), 12);
+            expect (! fixed.write ("12345", 5));
+            expectEquals ((int) fixed.getDataSize(), 12);
+            expect (fixed.write ("1234", 4));
+            expect (memcmp (buffer, "abcdefghabcd1234", 16) == 0);
+            expect (fixed.setPosition (2));
+            fixed.writeByte ('X');
+            expect (buffer[2] == 'X');
+            expectEquals ((int) fixed.getDataSize(), 16);
+        }
     }
 
     static String createRandomWideCharString()
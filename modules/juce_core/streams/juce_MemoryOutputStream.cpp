@@ -27,23 +27,31 @@
 */
 
 MemoryOutputStream::MemoryOutputStream (const size_t initialSize)
-  : data (internalBlock),
-    position (0),
-    size (0)
+  : blockToUse (&internalBlock), externalData (nullptr),
+    position (0), size (0), availableSize (0),
+    growthProportion (0.5), maxGrowthIncrement (1024 * 1024)
 {
     internalBlock.setSize (initialSize, false);
 }
 
 MemoryOutputStream::MemoryOutputStream (MemoryBlock& memoryBlockToWriteTo,
                                         const bool appendToExistingBlockContent)
-  : data (memoryBlockToWriteTo),
-    position (0),
-    size (0)
+  : blockToUse (&memoryBlockToWriteTo), externalData (nullptr),
+    position (0), size (0), availableSize (0),
+    growthProportion (0.5), maxGrowthIncrement (1024 * 1024)
 {
     if (appendToExistingBlockContent)
         position = size = memoryBlockToWriteTo.getSize();
 }
 
+MemoryOutputStream::MemoryOutputStream (void* destBuffer, size_t destBufferSize)
+  : blockToUse (nullptr), externalData (destBuffer),
+    position (0), size (0), availableSize (destBufferSize),
+    growthProportion (0.5), maxGrowthIncrement (1024 * 1024)
+{
+    jassert (externalData != nullptr || availableSize == 0);
+}
+
 MemoryOutputStream::~MemoryOutputStream()
 {
     trimExternalBlockSize();
@@ -56,13 +64,26 @@ void MemoryOutputStream::flush()
 
 void MemoryOutputStream::trimExternalBlockSize()
 {
-    if (&data != &internalBlock)
-        data.setSize (size, false);
+    if (blockToUse != &internalBlock && blockToUse != nullptr)
+        blockToUse->setSize (size, false);
 }
 
 void MemoryOutputStream::preallocate (const size_t bytesToPreallocate)
 {
-    data.ensureSize (bytesToPreallocate + 1);
+    if (blockToUse != nullptr)
+        blockToUse->ensureSize (bytesToPreallocate + 1);
+}
+
+void MemoryOutputStream::setGrowthPolicy (const double proportionToAdd, const size_t maximumIncrement) noexcept
+{
+    jassert (proportionToAdd >= 0);
+    growthProportion = proportionToAdd;
+    maxGrowthIncrement = maximumIncrement;
+}
+
+size_t MemoryOutputStream::getCapacity() const noexcept
+{
+    return blockToUse != nullptr ? blockToUse->getSize() : availableSize;
 }
 
 void MemoryOutputStream::reset() noexcept
@@ -74,12 +95,28 @@ void MemoryOutputStream::reset() noexcept
 char* MemoryOutputStream::prepareToWrite (size_t numBytes)
 {
     jassert ((ssize_t) numBytes >= 0);
-    size_t storageNeeded = position + numBytes;
+    const size_t storageNeeded = position + numBytes;
+    char* data;
 
-    if (storageNeeded >= data.getSize())
-        data.ensureSize ((storageNeeded + jmin (storageNeeded / 2, (size_t) (1024 * 1024)) + 32) & ~31u);
+    if (blockToUse != nullptr)
+    {
+        if (storageNeeded >= blockToUse->getSize())
+        {
+            const size_t extra = jmin ((size_t) (storageNeeded * growthProportion), maxGrowthIncrement);
+            blockToUse->ensureSize ((storageNeeded + extra + 32) & ~(size_t) 31);
+        }
 
-    char* const writePointer = static_cast <char*> (data.getData()) + position;
+        data = static_cast <char*> (blockToUse->getData());
+    }
+    else
+    {
+        if (storageNeeded > availableSize)
+            return nullptr;
+
+        data = static_cast <char*> (externalData);
+    }
+
+    char* const writePointer = data + position;
     position += numBytes;
     size = jmax (size, position);
     return writePointer;
@@ -89,21 +126,29 @@ bool MemoryOutputStream::write (const void* const buffer, size_t howMany)
 {
     jassert (buffer != nullptr && ((ssize_t) howMany) >= 0);
 
-    if (howMany > 0)
-        memcpy (prepareToWrite (howMany), buffer, howMany);
+    if (howMany == 0)
+        return true;
 
-    return true;
+    if (char* const dest = prepareToWrite (howMany))
+    {
+        memcpy (dest, buffer, howMany);
+        return true;
+    }
+
+    return false;
 }
 
 void MemoryOutputStream::writeRepeatedByte (uint8 byte, size_t howMany)
 {
     if (howMany > 0)
-        memset (prepareToWrite (howMany), byte, howMany);
+        if (char* const dest = prepareToWrite (howMany))
+            memset (dest, byte, howMany);
 }
 
 void MemoryOutputStream::appendUTF8Char (juce_wchar c)
 {
-    CharPointer_UTF8 (prepareToWrite (CharPointer_UTF8::getBytesRequiredFor (c))).write (c);
+    if (char* const dest = prepareToWrite (CharPointer_UTF8::getBytesRequiredFor (c)))
+        CharPointer_UTF8 (dest).write (c);
 }
 
 MemoryBlock MemoryOutputStream::getMemoryBlock() const
@@ -113,10 +158,13 @@ MemoryBlock MemoryOutputStream::getMemoryBlock() const
 
 const void* MemoryOutputStream::getData() const noexcept
 {
-    if (data.getSize() > size)
-        static_cast <char*> (data.getData()) [size] = 0;
+    if (blockToUse == nullptr)
+        return externalData;
+
+    if (blockToUse->getSize() > size)
+        static_cast <char*> (blockToUse->getData()) [size] = 0;
 
-    return data.getData();
+    return blockToUse->getData();
 }
 
 bool MemoryOutputStream::setPosition (int64 newPosition)
@@ -142,7 +190,8 @@ int MemoryOutputStream::writeFromInputStream (InputStream& source, int64 maxNumB
         if (maxNumBytesToWrite > availableData)
             maxNumBytesToWrite = availableData;
 
-        preallocate (data.getSize() + (size_t) maxNumBytesToWrite);
+        if (blockToUse != nullptr)
+            preallocate (blockToUse->getSize() + (size_t) maxNumBytesToWrite);
     }
 
     return OutputStream::writeFromInputStream (source, maxNumBytesToWrite);
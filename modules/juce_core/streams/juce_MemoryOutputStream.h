@@ -40,6 +40,13 @@
 
     The data that was written into the stream can then be accessed later as
     a contiguous block of memory.
+
+    The stream can also write into a fixed block of memory that you supply, in which
+    case it never allocates anything. For very large amounts of data, where growing a
+    single contiguous block means repeatedly reallocating and copying it, have a look
+    at SegmentedMemoryOutputStream instead.
+
+    @see SegmentedMemoryOutputStream
 */
 class JUCE_API  MemoryOutputStream  : public OutputStream
 {
@@ -66,6 +73,15 @@ public:
     MemoryOutputStream (MemoryBlock& memoryBlockToWriteTo,
                         bool appendToExistingBlockContent);
 
+    /** Creates a MemoryOutputStream that will write into a user-supplied, fixed-size
+        block of memory.
+
+        The stream never allocates or resizes anything in this mode: once the block is
+        full, any further writes will fail and return false. The caller must keep the
+        memory valid for as long as the stream is in use.
+    */
+    MemoryOutputStream (void* destBuffer, size_t destBufferSize);
+
     /** Destructor.
         This will free any data that was written to it.
     */
@@ -90,6 +106,24 @@ public:
     */
     void preallocate (size_t bytesToPreallocate);
 
+    /** Changes the way the stream's storage grows when more space is needed.
+
+        When a write goes beyond the end of the allocated space, the block is enlarged to the
+        size needed plus an extra amount of slack, so that the next few writes don't each have
+        to reallocate (and copy) it. That slack is the given proportion of the size needed,
+        but capped at maximumIncrement bytes. The default is 0.5 and 1MB, which suits most
+        streams - a stream that's going to build a very large block can reduce the number
+        of reallocations by raising the cap, or avoid them entirely by calling preallocate().
+
+        This has no effect on a stream that's writing into a fixed, user-supplied buffer.
+    */
+    void setGrowthPolicy (double proportionToAdd, size_t maximumIncrement) noexcept;
+
+    /** Returns the number of bytes that the stream can hold before it needs to grow.
+        For a stream writing into a fixed, user-supplied buffer, this is the buffer's size.
+    */
+    size_t getCapacity() const noexcept;
+
     /** Appends the utf-8 bytes for a unicode character */
     void appendUTF8Char (juce_wchar character);
 
@@ -119,9 +153,12 @@ public:
 
 private:
     //==============================================================================
-    MemoryBlock& data;
+    MemoryBlock* const blockToUse;
     MemoryBlock internalBlock;
-    size_t position, size;
+    void* externalData;
+    size_t position, size, availableSize;
+    double growthProportion;
+    size_t maxGrowthIncrement;
 
     void trimExternalBlockSize();
     char* prepareToWrite (size_t);
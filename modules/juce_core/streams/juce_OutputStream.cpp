@@ -72,6 +72,15 @@ void OutputStream::writeBool (const bool b)
                  : (char) 0);
 }
 
+bool OutputStream::writeBlocks (const void* const* blocks, const size_t* blockSizes, const int numBlocks)
+{
+    for (int i = 0; i < numBlocks; ++i)
+        if (blockSizes[i] > 0 && ! write (blocks[i], blockSizes[i]))
+            return false;
+
+    return true;
+}
+
 void OutputStream::writeByte (char byte)
 {
     write (&byte, 1);
@@ -93,6 +93,24 @@ public:
     virtual bool write (const void* dataToWrite,
                         size_t numberOfBytes) = 0;
 
+    /** Writes a set of separate blocks of data, one after the other, as if they'd been
+        joined together into a single block.
+
+        The default implementation just calls write() for each block in turn, but streams
+        that can do better, such as FileOutputStream, override this to pass the whole set
+        to the OS in one gathering call, so that the blocks never need to be copied into
+        a contiguous buffer first.
+
+        @param blocks           an array of numBlocks pointers to the blocks of data
+        @param blockSizes       an array of numBlocks sizes, in bytes
+        @param numBlocks        the number of blocks
+        @returns false if the write operation fails for some reason
+        @see SegmentedMemoryOutputStream::writeTo
+    */
+    virtual bool writeBlocks (const void* const* blocks,
+                              const size_t* blockSizes,
+                              int numBlocks);
+
     //==============================================================================
     /** Writes a single byte to the stream.
 
@@ -0,0 +1,291 @@
+/*
+  ==============================================================================
+
+   This file is part of the juce_core module of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission to use, copy, modify, and/or distribute this software for any purpose with
+   or without fee is hereby granted, provided that the above copyright notice and this
+   permission notice appear in all copies.
+
+   THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+   TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+   NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+   DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+   IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+   ------------------------------------------------------------------------------
+
+   NOTE! This permissive ISC license applies ONLY to files within the juce_core module!
+   All other JUCE modules are covered by a dual GPL/commercial license, so if you are
+   using any other modules, be sure to check that you also comply with their license.
+
+   For more details, visit www.juce.com
+
+  ==============================================================================
+*/
+
+SegmentedMemoryOutputStream::SegmentedMemoryOutputStream (const size_t segmentSize_)
+    : segmentSize (jmax ((size_t) 16, segmentSize_)),
+      position (0),
+      size (0)
+{
+}
+
+SegmentedMemoryOutputStream::~SegmentedMemoryOutputStream()
+{
+}
+
+int SegmentedMemoryOutputStream::getNumSegments() const noexcept
+{
+    return (int) ((size + segmentSize - 1) / segmentSize);
+}
+
+const void* SegmentedMemoryOutputStream::getSegmentData (const int segmentIndex) const noexcept
+{
+    jassert (isPositiveAndBelow (segmentIndex, getNumSegments()));
+    return segments.getUnchecked (segmentIndex)->getData();
+}
+
+size_t SegmentedMemoryOutputStream::getSegmentSize (const int segmentIndex) const noexcept
+{
+    jassert (isPositiveAndBelow (segmentIndex, getNumSegments()));
+    return jmin (segmentSize, size - (size_t) segmentIndex * segmentSize);
+}
+
+void SegmentedMemoryOutputStream::reset() noexcept
+{
+    position = 0;
+    size = 0;
+}
+
+void SegmentedMemoryOutputStream::preallocate (const size_t bytesToPreallocate)
+{
+    const int numNeeded = (int) ((bytesToPreallocate + segmentSize - 1) / segmentSize);
+
+    while (segments.size() < numNeeded)
+        segments.add (new MemoryBlock (segmentSize));
+}
+
+void SegmentedMemoryOutputStream::releaseUnusedSegments()
+{
+    const int numUsed = getNumSegments();
+
+    if (segments.size() > numUsed)
+        segments.removeRange (numUsed, segments.size() - numUsed);
+}
+
+char* SegmentedMemoryOutputStream::getSegmentForWriting (const size_t offset)
+{
+    const int index = (int) (offset / segmentSize);
+
+    if (index >= segments.size())
+        preallocate ((size_t) (index + 1) * segmentSize);
+
+    return static_cast <char*> (segments.getUnchecked (index)->getData());
+}
+
+//==============================================================================
+void SegmentedMemoryOutputStream::flush()
+{
+}
+
+bool SegmentedMemoryOutputStream::write (const void* const buffer, size_t howMany)
+{
+    jassert (buffer != nullptr && ((ssize_t) howMany) >= 0);
+
+    const char* src = static_cast <const char*> (buffer);
+
+    while (howMany > 0)
+    {
+        const size_t offsetInSegment = position % segmentSize;
+        const size_t numToCopy = jmin (howMany, segmentSize - offsetInSegment);
+
+        memcpy (getSegmentForWriting (position) + offsetInSegment, src, numToCopy);
+        src += numToCopy;
+        position += numToCopy;
+        howMany -= numToCopy;
+    }
+
+    size = jmax (size, position);
+    return true;
+}
+
+void SegmentedMemoryOutputStream::writeRepeatedByte (uint8 byte, size_t howMany)
+{
+    while (howMany > 0)
+    {
+        const size_t offsetInSegment = position % segmentSize;
+        const size_t numToSet = jmin (howMany, segmentSize - offsetInSegment);
+
+        memset (getSegmentForWriting (position) + offsetInSegment, byte, numToSet);
+        position += numToSet;
+        howMany -= numToSet;
+    }
+
+    size = jmax (size, position);
+}
+
+bool SegmentedMemoryOutputStream::setPosition (int64 newPosition)
+{
+    if (newPosition >= 0 && newPosition <= (int64) size)
+    {
+        // ok to seek backwards
+        position = (size_t) newPosition;
+        return true;
+    }
+
+    // can't move beyond the end of the stream..
+    return false;
+}
+
+//==============================================================================
+bool SegmentedMemoryOutputStream::writeTo (OutputStream& destStream) const
+{
+    const int numSegments = getNumSegments();
+
+    HeapBlock<const void*> blocks ((size_t) numSegments);
+    HeapBlock<size_t> blockSizes ((size_t) numSegments);
+
+    for (int i = 0; i < numSegments; ++i)
+    {
+        blocks[i] = getSegmentData (i);
+        blockSizes[i] = getSegmentSize (i);
+    }
+
+    return destStream.writeBlocks (blocks, blockSizes, numSegments);
+}
+
+void SegmentedMemoryOutputStream::copyTo (void* const destData) const noexcept
+{
+    char* dest = static_cast <char*> (destData);
+
+    for (int i = 0; i < getNumSegments(); ++i)
+    {
+        const size_t num = getSegmentSize (i);
+        memcpy (dest, getSegmentData (i), num);
+        dest += num;
+    }
+}
+
+MemoryBlock SegmentedMemoryOutputStream::getMemoryBlock() const
+{
+    MemoryBlock mb (size, false);
+    copyTo (mb.getData());
+    return mb;
+}
+
+String SegmentedMemoryOutputStream::toUTF8() const
+{
+    if (getNumSegments() == 1)
+    {
+        const char* const d = static_cast <const char*> (getSegmentData (0));
+        return String (CharPointer_UTF8 (d), CharPointer_UTF8 (d + size));
+    }
+
+    const MemoryBlock mb (getMemoryBlock());
+    const char* const d = static_cast <const char*> (mb.getData());
+    return String (CharPointer_UTF8 (d), CharPointer_UTF8 (d + size));
+}
+
+OutputStream& JUCE_CALLTYPE operator<< (OutputStream& stream, const SegmentedMemoryOutputStream& streamToRead)
+{
+    streamToRead.writeTo (stream);
+    return stream;
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class SegmentedMemoryOutputStreamTests  : public UnitTest
+{
+public:
+    SegmentedMemoryOutputStreamTests() : UnitTest ("SegmentedMemoryOutputStream") {}
+
+    void runTest()
+    {
+        beginTest ("Writing");
+        Random r;
+
+        MemoryOutputStream reference;
+        SegmentedMemoryOutputStream segmented (100);
+
+        for (int i = 0; i < 200; ++i)
+        {
+            const int num = r.nextInt (300);
+
+            if (r.nextInt (10) == 0)
+            {
+                const uint8 byte = (uint8) r.nextInt (256);
+                reference.writeRepeatedByte (byte, (size_t) num);
+                segmented.writeRepeatedByte (byte, (size_t) num);
+            }
+            else
+            {
+                HeapBlock<char> data ((size_t) num + 1);
+
+                for (int j = 0; j < num; ++j)
+                    data[j] = (char) r.nextInt (256);
+
+                expect (reference.write (data, (size_t) num));
+                expect (segmented.write (data, (size_t) num));
+            }
+        }
+
+        expectEquals ((int) segmented.getDataSize(), (int) reference.getDataSize());
+        expect (segmented.getMemoryBlock() == reference.getMemoryBlock());
+
+        size_t total = 0;
+
+        for (int i = 0; i < segmented.getNumSegments(); ++i)
+        {
+            expect (i == segmented.getNumSegments() - 1 || segmented.getSegmentSize (i) == 100);
+            expect (memcmp (segmented.getSegmentData (i), addBytesToPointer (reference.getData(), total),
+                            segmented.getSegmentSize (i)) == 0);
+            total += segmented.getSegmentSize (i);
+        }
+
+        expectEquals ((int) total, (int) segmented.getDataSize());
+
+        beginTest ("Seeking");
+        expect (segmented.setPosition (150));
+        expect (! segmented.setPosition ((int64) segmented.getDataSize() + 1));
+        expect (segmented.setPosition (150));
+        segmented.write ("0123456789", 10);
+        reference.setPosition (150);
+        reference.write ("0123456789", 10);
+        expect (segmented.getMemoryBlock() == reference.getMemoryBlock());
+
+        beginTest ("Writing to other streams");
+        MemoryOutputStream copy;
+        expect (segmented.writeTo (copy));
+        expect (copy.getMemoryBlock() == reference.getMemoryBlock());
+
+        const File tempFile (File::createTempFile (".tmp"));
+
+        {
+            FileOutputStream out (tempFile, 64);
+            expect (segmented.writeTo (out));
+        }
+
+        MemoryBlock fileData;
+        expect (tempFile.loadFileAsData (fileData));
+        expect (fileData == reference.getMemoryBlock());
+        tempFile.deleteFile();
+
+        beginTest ("Reset");
+        expect (segmented.getNumSegments() > 1);
+        segmented.reset();
+        expectEquals (segmented.getNumSegments(), 0);
+        segmented.write ("hello", 5);
+        expectEquals (segmented.getNumSegments(), 1);
+        expectEquals (segmented.toUTF8(), String ("hello"));
+        segmented.releaseUnusedSegments();
+        expectEquals (segmented.toUTF8(), String ("hello"));
+    }
+};
+
+static SegmentedMemoryOutputStreamTests segmentedMemoryOutputStreamTests;
+
+#endif
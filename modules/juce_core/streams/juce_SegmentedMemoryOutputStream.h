@@ -0,0 +1,144 @@
+/*
+  ==============================================================================
+
+   This file is part of the juce_core module of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission to use, copy, modify, and/or distribute this software for any purpose with
+   or without fee is hereby granted, provided that the above copyright notice and this
+   permission notice appear in all copies.
+
+   THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+   TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+   NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+   DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+   IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+   ------------------------------------------------------------------------------
+
+   NOTE! This permissive ISC license applies ONLY to files within the juce_core module!
+   All other JUCE modules are covered by a dual GPL/commercial license, so if you are
+   using any other modules, be sure to check that you also comply with their license.
+
+   For more details, visit www.juce.com
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_SEGMENTEDMEMORYOUTPUTSTREAM_JUCEHEADER__
+#define __JUCE_SEGMENTEDMEMORYOUTPUTSTREAM_JUCEHEADER__
+
+#include "juce_OutputStream.h"
+#include "../memory/juce_MemoryBlock.h"
+#include "../containers/juce_OwnedArray.h"
+
+
+//==============================================================================
+/**
+    Writes data into a chain of fixed-size blocks of memory, adding more blocks as
+    required.
+
+    Unlike a MemoryOutputStream, which keeps its data in one contiguous block and has
+    to reallocate and copy it as it grows, this stream never moves any data once it has
+    been written - when the last segment fills up, another one is simply added to the
+    end. That makes it a better choice for building very large amounts of data in memory,
+    such as a big XML or ValueTree dump.
+
+    The data can be read back one segment at a time with getSegmentData() and
+    getSegmentSize(), or written to another stream with writeTo(), which passes all the
+    segments to OutputStream::writeBlocks() at once, so that a FileOutputStream can write
+    them with a single gathering call. If you really need it as one contiguous block,
+    getMemoryBlock() or copyTo() will join the segments together.
+
+    @see MemoryOutputStream
+*/
+class JUCE_API  SegmentedMemoryOutputStream  : public OutputStream
+{
+public:
+    //==============================================================================
+    /** Creates an empty stream.
+        @param segmentSize  the size of each block of memory that the stream allocates
+    */
+    explicit SegmentedMemoryOutputStream (size_t segmentSize = 65536);
+
+    /** Destructor.
+        This will free any data that was written to it.
+    */
+    ~SegmentedMemoryOutputStream();
+
+    //==============================================================================
+    /** Returns the total number of bytes of data that have been written to the stream. */
+    size_t getDataSize() const noexcept                 { return size; }
+
+    /** Returns the size of the blocks that the stream allocates. */
+    size_t getSegmentCapacity() const noexcept          { return segmentSize; }
+
+    /** Returns the number of segments that contain some of the stream's data. */
+    int getNumSegments() const noexcept;
+
+    /** Returns a pointer to the start of one of the segments.
+        @see getNumSegments, getSegmentSize
+    */
+    const void* getSegmentData (int segmentIndex) const noexcept;
+
+    /** Returns the number of bytes of data in one of the segments.
+        This will be the segment capacity for all segments except the last one, which may
+        be only partly filled.
+    */
+    size_t getSegmentSize (int segmentIndex) const noexcept;
+
+    /** Resets the stream, clearing any data that has been written to it so far.
+        The segments that were allocated are kept, and will be re-used by later writes.
+    */
+    void reset() noexcept;
+
+    /** Allocates enough segments to hold at least the given number of bytes of data
+        without needing to allocate any more.
+    */
+    void preallocate (size_t bytesToPreallocate);
+
+    /** Frees any segments that don't contain any data. */
+    void releaseUnusedSegments();
+
+    //==============================================================================
+    /** Writes all the data from this stream to another stream.
+        @returns false if the destination stream fails to write the data
+        @see OutputStream::writeBlocks
+    */
+    bool writeTo (OutputStream& destStream) const;
+
+    /** Copies all the data into a contiguous block of memory, which must be at least
+        getDataSize() bytes long.
+    */
+    void copyTo (void* destData) const noexcept;
+
+    /** Returns a copy of the stream's data as a memory block. */
+    MemoryBlock getMemoryBlock() const;
+
+    /** Returns a String created from the (UTF8) data that has been written to the stream. */
+    String toUTF8() const;
+
+    //==============================================================================
+    void flush();
+    bool write (const void* buffer, size_t howMany);
+    int64 getPosition()                                 { return (int64) position; }
+    bool setPosition (int64 newPosition);
+    void writeRepeatedByte (uint8 byte, size_t numTimesToRepeat);
+
+private:
+    //==============================================================================
+    OwnedArray <MemoryBlock> segments;
+    const size_t segmentSize;
+    size_t position, size;
+
+    char* getSegmentForWriting (size_t offset);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SegmentedMemoryOutputStream)
+};
+
+/** Copies all the data that has been written to a SegmentedMemoryOutputStream into another stream. */
+OutputStream& JUCE_CALLTYPE operator<< (OutputStream& stream, const SegmentedMemoryOutputStream& streamToRead);
+
+
+#endif   // __JUCE_SEGMENTEDMEMORYOUTPUTSTREAM_JUCEHEADER__
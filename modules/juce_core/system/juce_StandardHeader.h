@@ -60,6 +60,7 @@
  #pragma warning (disable: 4514 4245 4100)
 #endif
 
+#include <algorithm>
 #include <cstdlib>
 #include <cstdarg>
 #include <climits>
@@ -32,6 +32,207 @@ const SystemStats::CPUFlags& SystemStats::getCPUFlags()
     return cpuFlags;
 }
 
+//==============================================================================
+#if JUCE_INTEL && (JUCE_MSVC ? (_MSC_FULL_VER >= 160040219) : ! JUCE_NO_INLINE_ASM)
+ #define JUCE_USE_CPUID 1
+
+static void juce_getCPUID (const uint32 leaf, const uint32 subLeaf, uint32* const regs) noexcept
+{
+   #if JUCE_MSVC
+    __cpuidex (reinterpret_cast <int*> (regs), (int) leaf, (int) subLeaf);
+   #elif JUCE_64BIT
+    asm ("cpuid" : "=a" (regs[0]), "=b" (regs[1]), "=c" (regs[2]), "=d" (regs[3]) : "a" (leaf), "c" (subLeaf));
+   #else
+    // (ebx may be the PIC register, so has to be preserved)
+    asm ("mov %%ebx, %%esi \n\t"
+         "cpuid \n\t"
+         "xchg %%esi, %%ebx"
+           : "=a" (regs[0]), "=S" (regs[1]), "=c" (regs[2]), "=d" (regs[3]) : "a" (leaf), "c" (subLeaf));
+   #endif
+}
+
+// Returns the XCR0 register, which says which sets of registers the OS saves when
+// switching threads. This must only be called if CPUID reports OSXSAVE.
+static uint64 juce_getXCR0() noexcept
+{
+   #if JUCE_MSVC
+    return (uint64) _xgetbv (0);
+   #else
+    uint32 lo, hi;
+    asm (".byte 0x0f, 0x01, 0xd0" : "=a" (lo), "=d" (hi) : "c" (0)); // (xgetbv, for assemblers that don't know it)
+    return lo | (((uint64) hi) << 32);
+   #endif
+}
+#endif
+
+void SystemStats::CPUFlags::detectExtendedFeatures() noexcept
+{
+    hasSSE3 = false;
+    hasSSSE3 = false;
+    hasSSE41 = false;
+    hasSSE42 = false;
+    hasAVX = false;
+    hasAVX2 = false;
+    hasFMA3 = false;
+    hasAVX512F = false;
+    hasNeon = false;
+
+   #if JUCE_USE_CPUID
+    uint32 regs[4];
+    juce_getCPUID (0, 0, regs);
+    const uint32 maxLeaf = regs[0];
+
+    if (maxLeaf >= 1)
+    {
+        juce_getCPUID (1, 0, regs);
+        const uint32 ecx = regs[2];
+
+        hasSSE3  = (ecx & (1u << 0))  != 0;
+        hasSSSE3 = (ecx & (1u << 9))  != 0;
+        hasSSE41 = (ecx & (1u << 19)) != 0;
+        hasSSE42 = (ecx & (1u << 20)) != 0;
+
+        // The AVX instructions can only be used if the OS saves the YMM registers,
+        // and AVX-512 also needs it to save the opmask and ZMM registers..
+        const uint64 xcr0 = (ecx & (1u << 27)) != 0 ? juce_getXCR0() : 0;
+        const bool osSavesYMM = (xcr0 & 6) == 6;
+        const bool osSavesZMM = (xcr0 & 0xe6) == 0xe6;
+
+        hasAVX  = osSavesYMM && (ecx & (1u << 28)) != 0;
+        hasFMA3 = osSavesYMM && (ecx & (1u << 12)) != 0;
+
+        if (maxLeaf >= 7)
+        {
+            juce_getCPUID (7, 0, regs);
+            hasAVX2    = osSavesYMM && (regs[1] & (1u << 5))  != 0;
+            hasAVX512F = osSavesZMM && (regs[1] & (1u << 16)) != 0;
+        }
+    }
+   #endif
+
+   #if defined (__ARM_NEON__) || defined (__ARM_NEON)
+    hasNeon = true;
+   #endif
+}
+
+//==============================================================================
+void juce_fillCpuTopology (SystemStats::CpuTopology&);
+
+SystemStats::CpuTopology::CpuTopology()
+    : numPhysicalCores (0), numPackages (0), numNumaNodes (0), numEfficiencyClasses (0),
+      cacheLineSize (0), l1DataCacheSize (0), l2CacheSize (0), l3CacheSize (0)
+{
+}
+
+void SystemStats::CpuTopology::finalise()
+{
+    if (cpus.size() == 0)
+    {
+        for (int i = 0; i < SystemStats::getNumCpus(); ++i)
+        {
+            LogicalCpu cpu;
+            cpu.cpuIndex = i;
+            cpu.coreIndex = i;
+            cpu.packageIndex = 0;
+            cpu.numaNode = 0;
+            cpu.efficiencyClass = 0;
+            cpus.add (cpu);
+        }
+    }
+
+    SortedSet<int> cores, packages, nodes, classes;
+
+    for (int i = 0; i < cpus.size(); ++i)
+    {
+        const LogicalCpu& cpu = cpus.getReference (i);
+        cores.add (cpu.coreIndex);
+        packages.add (cpu.packageIndex);
+        nodes.add (cpu.numaNode);
+        classes.add (cpu.efficiencyClass);
+    }
+
+    // The platform code can use any increasing values for the efficiency classes (e.g.
+    // a relative speed), so these are turned into a ranking here..
+    for (int i = 0; i < cpus.size(); ++i)
+    {
+        LogicalCpu& cpu = cpus.getReference (i);
+        cpu.efficiencyClass = classes.indexOf (cpu.efficiencyClass);
+    }
+
+    numPhysicalCores = cores.size();
+    numPackages = packages.size();
+    numNumaNodes = nodes.size();
+    numEfficiencyClasses = classes.size();
+}
+
+BigInteger SystemStats::CpuTopology::getCpusOnNumaNode (const int numaNode) const
+{
+    BigInteger result;
+
+    for (int i = 0; i < cpus.size(); ++i)
+        if (cpus.getReference (i).numaNode == numaNode)
+            result.setBit (cpus.getReference (i).cpuIndex);
+
+    return result;
+}
+
+BigInteger SystemStats::CpuTopology::getCpusWithEfficiencyClass (const int efficiencyClass) const
+{
+    BigInteger result;
+
+    for (int i = 0; i < cpus.size(); ++i)
+        if (cpus.getReference (i).efficiencyClass == efficiencyClass)
+            result.setBit (cpus.getReference (i).cpuIndex);
+
+    return result;
+}
+
+BigInteger SystemStats::CpuTopology::getPerformanceCpus() const
+{
+    return getCpusWithEfficiencyClass (numEfficiencyClasses - 1);
+}
+
+BigInteger SystemStats::CpuTopology::getOneCpuPerCore() const
+{
+    BigInteger result;
+    SortedSet<int> coresFound;
+
+    for (int i = 0; i < cpus.size(); ++i)
+    {
+        const LogicalCpu& cpu = cpus.getReference (i);
+
+        if (! coresFound.contains (cpu.coreIndex))
+        {
+            coresFound.add (cpu.coreIndex);
+            result.setBit (cpu.cpuIndex);
+        }
+    }
+
+    return result;
+}
+
+const SystemStats::CpuTopology& SystemStats::getCpuTopology()
+{
+    struct TopologyHolder
+    {
+        TopologyHolder()
+        {
+            juce_fillCpuTopology (topology);
+            topology.finalise();
+        }
+
+        CpuTopology topology;
+    };
+
+    static TopologyHolder holder;
+    return holder.topology;
+}
+
+int SystemStats::getNumPhysicalCpus()
+{
+    return getCpuTopology().numPhysicalCores;
+}
+
 String SystemStats::getJUCEVersion()
 {
     // Some basic tests, to keep an eye on things and make sure these types work ok
@@ -155,3 +356,55 @@ void SystemStats::setApplicationCrashHandler (CrashHandlerFunction handler)
     }
    #endif
 }
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class SystemStatsTests  : public UnitTest
+{
+public:
+    SystemStatsTests() : UnitTest ("SystemStats") {}
+
+    void runTest()
+    {
+        beginTest ("CPU topology");
+
+        const SystemStats::CpuTopology& topology = SystemStats::getCpuTopology();
+
+        expect (topology.cpus.size() >= 1);
+        expect (topology.numPhysicalCores >= 1 && topology.numPhysicalCores <= topology.cpus.size());
+        expect (topology.numPackages >= 1 && topology.numPackages <= topology.numPhysicalCores);
+        expect (topology.numNumaNodes >= 1);
+        expect (topology.numEfficiencyClasses >= 1);
+        expectEquals (SystemStats::getNumPhysicalCpus(), topology.numPhysicalCores);
+        expectEquals (topology.getOneCpuPerCore().countNumberOfSetBits(), topology.numPhysicalCores);
+        expect (! topology.getPerformanceCpus().isZero());
+
+        BigInteger allCpus;
+
+        for (int i = 0; i < topology.cpus.size(); ++i)
+        {
+            const SystemStats::CpuTopology::LogicalCpu& cpu = topology.cpus.getReference (i);
+
+            expect (! allCpus [cpu.cpuIndex]);
+            allCpus.setBit (cpu.cpuIndex);
+
+            expect (cpu.coreIndex >= 0);
+            expect (cpu.efficiencyClass >= 0 && cpu.efficiencyClass < topology.numEfficiencyClasses);
+            expect (topology.getCpusOnNumaNode (cpu.numaNode) [cpu.cpuIndex]);
+        }
+
+        beginTest ("CPU features");
+
+        // The newer instruction sets all imply the older ones..
+        if (SystemStats::hasAVX2())     expect (SystemStats::hasAVX());
+        if (SystemStats::hasAVX512F())  expect (SystemStats::hasAVX2());
+        if (SystemStats::hasSSE42())    expect (SystemStats::hasSSE41());
+        if (SystemStats::hasSSE41())    expect (SystemStats::hasSSSE3());
+        if (SystemStats::hasSSSE3())    expect (SystemStats::hasSSE3());
+    }
+};
+
+static SystemStatsTests systemStatsTests;
+
+#endif
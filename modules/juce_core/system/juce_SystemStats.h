@@ -30,6 +30,7 @@
 #define __JUCE_SYSTEMSTATS_JUCEHEADER__
 
 #include "../text/juce_StringArray.h"
+#include "../maths/juce_BigInteger.h"
 
 
 //==============================================================================
@@ -130,6 +131,12 @@ public:
     /** Returns the number of CPUs. */
     static int getNumCpus() noexcept            { return getCPUFlags().numCpus; }
 
+    /** Returns the number of physical processor cores.
+        This may be less than getNumCpus() if the cores use hyperthreading.
+        @see getCpuTopology
+    */
+    static int getNumPhysicalCpus();
+
     /** Returns the approximate CPU speed.
         @returns    the speed in megahertz, e.g. 1500, 2500, 32000 (depending on
                     what year you're reading this...)
@@ -141,6 +148,17 @@ public:
     */
     static String getCpuVendor();
 
+    /** Returns the set of CPUs that the OS has isolated from its scheduler.
+
+        On Linux, these are the CPUs listed by the "isolcpus" kernel parameter: no threads
+        will be scheduled on them unless they're explicitly given an affinity for them,
+        which makes them a good home for real-time threads. Each set bit in the result is
+        the index of an isolated CPU. On other platforms, this will always be empty.
+
+        @see Thread::setAffinity
+    */
+    static BigInteger getIsolatedCpus();
+
     /** Checks whether Intel MMX instructions are available. */
     static bool hasMMX() noexcept               { return getCPUFlags().hasMMX; }
 
@@ -153,6 +171,111 @@ public:
     /** Checks whether AMD 3DNOW instructions are available. */
     static bool has3DNow() noexcept             { return getCPUFlags().has3DNow; }
 
+    /** Checks whether Intel SSE3 instructions are available. */
+    static bool hasSSE3() noexcept              { return getCPUFlags().hasSSE3; }
+
+    /** Checks whether Intel SSSE3 instructions are available. */
+    static bool hasSSSE3() noexcept             { return getCPUFlags().hasSSSE3; }
+
+    /** Checks whether Intel SSE4.1 instructions are available. */
+    static bool hasSSE41() noexcept             { return getCPUFlags().hasSSE41; }
+
+    /** Checks whether Intel SSE4.2 instructions are available. */
+    static bool hasSSE42() noexcept             { return getCPUFlags().hasSSE42; }
+
+    /** Checks whether Intel AVX instructions are available.
+        This also checks that the OS saves the AVX registers when switching threads.
+    */
+    static bool hasAVX() noexcept               { return getCPUFlags().hasAVX; }
+
+    /** Checks whether Intel AVX2 instructions are available. */
+    static bool hasAVX2() noexcept              { return getCPUFlags().hasAVX2; }
+
+    /** Checks whether Intel FMA3 instructions are available. */
+    static bool hasFMA3() noexcept              { return getCPUFlags().hasFMA3; }
+
+    /** Checks whether Intel AVX-512 foundation instructions are available. */
+    static bool hasAVX512F() noexcept           { return getCPUFlags().hasAVX512F; }
+
+    /** Checks whether ARM NEON instructions are available. */
+    static bool hasNeon() noexcept              { return getCPUFlags().hasNeon; }
+
+    //==============================================================================
+    /**
+        Describes the layout of the machine's processors.
+
+        This tells you which of the logical CPUs share a physical core, a processor
+        package or a NUMA node, which ones are performance or efficiency cores on
+        machines that have both, and how big the caches are. It can be used to decide
+        how many threads a pool should have, or which CPUs to give them an affinity for.
+
+        Anything that the OS won't reveal is filled in with a sensible guess, e.g. each
+        logical CPU being a core of its own in a single package and NUMA node.
+
+        @see SystemStats::getCpuTopology
+    */
+    struct JUCE_API  CpuTopology
+    {
+        /** Describes one of the logical CPUs, i.e. a hardware thread that the OS can run a thread on. */
+        struct LogicalCpu
+        {
+            /** The OS's index for this CPU, as used by Thread::setAffinity(). */
+            int cpuIndex;
+
+            /** The index of the physical core that it belongs to. Logical CPUs that share
+                a core index are hyperthreads on the same core. */
+            int coreIndex;
+
+            /** The index of the processor package (i.e. socket) that it belongs to. */
+            int packageIndex;
+
+            /** The NUMA node that it belongs to. */
+            int numaNode;
+
+            /** The relative performance of the core: 0 for the slowest kind of core in the
+                machine, and higher for faster ones. On a machine where all the cores are the
+                same, this will be 0 for all of them. */
+            int efficiencyClass;
+        };
+
+        /** The logical CPUs, in order of their cpuIndex. */
+        Array<LogicalCpu> cpus;
+
+        int numPhysicalCores;       /**< The number of distinct physical cores. */
+        int numPackages;            /**< The number of processor packages. */
+        int numNumaNodes;           /**< The number of NUMA nodes. */
+        int numEfficiencyClasses;   /**< The number of different kinds of core: 1 unless the machine has both performance and efficiency cores. */
+
+        int cacheLineSize;          /**< The size of a cache line in bytes, or 0 if unknown. */
+        int l1DataCacheSize;        /**< The size of each core's L1 data cache in bytes, or 0 if unknown. */
+        int l2CacheSize;            /**< The size of an L2 cache in bytes, or 0 if unknown. */
+        int l3CacheSize;            /**< The size of an L3 cache in bytes, or 0 if unknown. */
+
+        /** Returns the logical CPUs that belong to a NUMA node. */
+        BigInteger getCpusOnNumaNode (int numaNode) const;
+
+        /** Returns the logical CPUs whose cores have the given efficiency class. */
+        BigInteger getCpusWithEfficiencyClass (int efficiencyClass) const;
+
+        /** Returns the logical CPUs on the fastest kind of core in the machine. */
+        BigInteger getPerformanceCpus() const;
+
+        /** Returns one logical CPU from each physical core, which is a good set to use
+            for threads that shouldn't compete with each other for the same core.
+        */
+        BigInteger getOneCpuPerCore() const;
+
+        /** @internal */
+        CpuTopology();
+        /** @internal */
+        void finalise();
+    };
+
+    /** Returns the layout of the machine's processors.
+        This is worked out when it's first needed, and then cached.
+    */
+    static const CpuTopology& getCpuTopology();
+
     //==============================================================================
     /** Finds out how much RAM is in the machine.
         @returns    the approximate number of megabytes of memory, or zero if
@@ -194,6 +317,17 @@ private:
         bool hasSSE : 1;
         bool hasSSE2 : 1;
         bool has3DNow : 1;
+        bool hasSSE3 : 1;
+        bool hasSSSE3 : 1;
+        bool hasSSE41 : 1;
+        bool hasSSE42 : 1;
+        bool hasAVX : 1;
+        bool hasAVX2 : 1;
+        bool hasFMA3 : 1;
+        bool hasAVX512F : 1;
+        bool hasNeon : 1;
+
+        void detectExtendedFeatures() noexcept;
     };
 
     SystemStats();
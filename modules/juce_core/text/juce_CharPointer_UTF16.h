@@ -263,10 +263,18 @@ public:
     static size_t getBytesRequiredFor (CharPointer text) noexcept
     {
         size_t count = 0;
-        juce_wchar n;
 
-        while ((n = text.getAndAdvance()) != 0)
+        for (;;)
+        {
+            count += sizeof (CharType) * CharacterFunctions::skipLeadingASCII (text);
+
+            const juce_wchar n = text.getAndAdvance();
+
+            if (n == 0)
+                break;
+
             count += getBytesRequiredFor (n);
+        }
 
         return count;
     }
@@ -243,6 +243,10 @@ public:
 
         for (;;)
         {
+            const size_t numASCII = CharacterFunctions::getNumLeadingASCIIBytes (d);
+            d += numASCII;
+            count += numASCII;
+
             const uint32 n = (uint32) (uint8) *d++;
 
             if ((n & 0x80) != 0)
@@ -318,10 +322,18 @@ public:
     static size_t getBytesRequiredFor (CharPointer text) noexcept
     {
         size_t count = 0;
-        juce_wchar n;
 
-        while ((n = text.getAndAdvance()) != 0)
+        for (;;)
+        {
+            count += CharacterFunctions::skipLeadingASCII (text);
+
+            const juce_wchar n = text.getAndAdvance();
+
+            if (n == 0)
+                break;
+
             count += getBytesRequiredFor (n);
+        }
 
         return count;
     }
@@ -509,8 +521,18 @@ public:
     /** Returns true if this data contains a valid string in this encoding. */
     static bool isValidString (const CharType* dataToTest, int maxBytesToRead)
     {
-        while (--maxBytesToRead >= 0 && *dataToTest != 0)
+        for (;;)
         {
+            if (maxBytesToRead > 0)
+            {
+                const int numASCII = (int) CharacterFunctions::getNumLeadingASCIIBytes (dataToTest, (size_t) maxBytesToRead);
+                dataToTest += numASCII;
+                maxBytesToRead -= numASCII;
+            }
+
+            if (--maxBytesToRead < 0 || *dataToTest == 0)
+                break;
+
             const signed char byte = (signed char) *dataToTest++;
 
             if (byte < 0)
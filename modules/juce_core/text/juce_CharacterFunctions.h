@@ -280,6 +280,76 @@ public:
         return isNeg ? -v : v;
     }
 
+    //==============================================================================
+    /** Returns the number of bytes at the start of an 8-bit string which are 7-bit ASCII
+        characters, stopping at the first null or non-ASCII byte, or after maxBytes.
+
+        Because ASCII characters are encoded the same way in UTF-8, this lets the UTF-8 code
+        skip through long runs of plain text without decoding every character. The bytes
+        are checked a whole machine word at a time - the word reads are always aligned, so
+        they can't stray into another page past the end of a null-terminated string, and
+        no bytes at or beyond maxBytes are ever read.
+    */
+    static size_t getNumLeadingASCIIBytes (const char* const text, const size_t maxBytes = ~(size_t) 0) noexcept
+    {
+        const size_t wordSize = sizeof (size_t);
+        size_t i = 0;
+
+        while (i < maxBytes && (((pointer_sized_int) (text + i)) & (wordSize - 1)) != 0)
+        {
+            if (! isASCIIByte (text[i]))
+                return i;
+
+            ++i;
+        }
+
+        // (an aligned word read can go past the end of a string's allocation, which is
+        // harmless, but AddressSanitizer would report it)
+       #if ! defined (__SANITIZE_ADDRESS__)
+        const size_t ones = ((size_t) -1) / 0xff;
+        const size_t highBits = ones * 0x80;
+
+        while (maxBytes - i >= wordSize)
+        {
+            size_t word;
+            memcpy (&word, text + i, wordSize);
+
+            // (sets a high bit if any byte is either zero or >= 0x80)
+            if (((word | (word - ones)) & highBits) != 0)
+                break;
+
+            i += wordSize;
+        }
+       #endif
+
+        while (i < maxBytes && isASCIIByte (text[i]))
+            ++i;
+
+        return i;
+    }
+
+    /** Strings that don't use 8-bit characters have no ASCII fast path. */
+    template <typename CharType>
+    static size_t getNumLeadingASCIIBytes (const CharType*, size_t = 0) noexcept
+    {
+        return 0;
+    }
+
+    /** Moves a string pointer past any ASCII characters at its start, returning the
+        number of characters skipped.
+        @see getNumLeadingASCIIBytes
+    */
+    template <typename CharPointerType>
+    static size_t skipLeadingASCII (CharPointerType& text, const size_t maxChars = ~(size_t) 0) noexcept
+    {
+        const size_t num = getNumLeadingASCIIBytes (text.getAddress(), maxChars);
+
+        if (num > 0)
+            text = CharPointerType (text.getAddress() + num);
+
+        return num;
+    }
+
     //==============================================================================
     /** Counts the number of characters in a given string, stopping if the count exceeds
         a specified limit. */
@@ -313,6 +383,8 @@ public:
     {
         for (;;)
         {
+            copyLeadingASCII (dest, src, ~(size_t) 0);
+
             const juce_wchar c = src.getAndAdvance();
 
             if (c == 0)
@@ -335,6 +407,10 @@ public:
 
         for (;;)
         {
+            if (maxBytes > 0)
+                maxBytes -= (ssize_t) (copyLeadingASCII (dest, src, (size_t) maxBytes / sizeof (typename DestCharPointerType::CharType))
+                                         * sizeof (typename DestCharPointerType::CharType));
+
             const juce_wchar c = src.getAndAdvance();
             const size_t bytesNeeded = DestCharPointerType::getBytesRequiredFor (c);
 
@@ -356,8 +432,13 @@ public:
     template <typename DestCharPointerType, typename SrcCharPointerType>
     static void copyWithCharLimit (DestCharPointerType& dest, SrcCharPointerType src, int maxChars) noexcept
     {
-        while (--maxChars > 0)
+        for (;;)
         {
+            maxChars -= (int) copyLeadingASCII (dest, src, (size_t) jmax (0, maxChars - 1));
+
+            if (--maxChars <= 0)
+                break;
+
             const juce_wchar c = src.getAndAdvance();
             if (c == 0)
                 break;
@@ -584,6 +665,32 @@ public:
 
 private:
     static double mulexp10 (const double value, int exponent) noexcept;
+
+    static inline bool isASCIIByte (const char c) noexcept
+    {
+        return (uint8) (c - 1) < 0x7f;
+    }
+
+    // Copies any run of ASCII characters at the start of src straight into dest, which is
+    // much quicker than encoding and decoding them one at a time.
+    template <typename DestCharPointerType, typename SrcCharPointerType>
+    static size_t copyLeadingASCII (DestCharPointerType& dest, SrcCharPointerType& src, const size_t maxChars) noexcept
+    {
+        const typename SrcCharPointerType::CharType* const s = src.getAddress();
+        const size_t num = skipLeadingASCII (src, maxChars);
+
+        if (num > 0)
+        {
+            typename DestCharPointerType::CharType* const d = dest.getAddress();
+
+            for (size_t i = 0; i < num; ++i)
+                d[i] = (typename DestCharPointerType::CharType) s[i];
+
+            dest = DestCharPointerType (d + num);
+        }
+
+        return num;
+    }
 };
 
 
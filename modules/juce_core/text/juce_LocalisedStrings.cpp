@@ -27,11 +27,13 @@
 */
 
 LocalisedStrings::LocalisedStrings (const String& fileContents, bool ignoreCase)
+    : slots (nullptr), numSlots (0), ignoresCase (ignoreCase), mappingsLoaded (true)
 {
     loadFromText (fileContents, ignoreCase);
 }
 
 LocalisedStrings::LocalisedStrings (const File& fileToLoad, bool ignoreCase)
+    : slots (nullptr), numSlots (0), ignoresCase (ignoreCase), mappingsLoaded (true)
 {
     loadFromText (fileToLoad.loadFileAsString(), ignoreCase);
 }
@@ -40,15 +42,267 @@ LocalisedStrings::~LocalisedStrings()
 {
 }
 
+//==============================================================================
+namespace
+{
+    /*  The compiled translation format is a block of little-endian uint32s:
+
+            header:   magic, flags, numEntries, numSlots, languageOffset, countriesOffset
+            slots:    numSlots x (hash, entry index + 1), an open-addressed hash table
+            entries:  numEntries x (keyOffset, valueOffset)
+
+        followed by the null-terminated UTF-8 strings that the offsets point to. The
+        offsets are all from the start of the data.
+    */
+    namespace CompiledTranslations
+    {
+        enum
+        {
+            magicNumber = 0x3152544a,   // "JTR1"
+            ignoreCaseFlag = 1,
+            headerSize = 6
+        };
+
+        uint32 read (const void* data, const size_t index) noexcept
+        {
+            return ByteOrder::littleEndianInt (static_cast<const uint32*> (data) + index);
+        }
+
+        const uint32* getSlots (const void* data) noexcept
+        {
+            return static_cast<const uint32*> (data) + headerSize;
+        }
+
+        const char* getString (const void* data, const uint32 offset) noexcept
+        {
+            return static_cast<const char*> (data) + offset;
+        }
+
+        const char* getEntryString (const void* data, const int entry, const int keyOrValue) noexcept
+        {
+            return getString (data, read (data, headerSize + 2 * read (data, 3) + 2 * (size_t) entry + (size_t) keyOrValue));
+        }
+
+        bool isValid (const void* data, const size_t size) noexcept
+        {
+            if (data == nullptr || size < headerSize * sizeof (uint32) + 1
+                 || read (data, 0) != magicNumber
+                 || static_cast<const char*> (data) [size - 1] != 0)
+                return false;
+
+            const uint32 numEntries = read (data, 2);
+            const uint32 numSlots   = read (data, 3);
+
+            if (numSlots == 0 || (numSlots & (numSlots - 1)) != 0 || numEntries >= numSlots
+                 || (headerSize + 2 * (uint64) numSlots + 2 * (uint64) numEntries) * sizeof (uint32) >= size
+                 || read (data, 4) >= size || read (data, 5) >= size)
+                return false;
+
+            for (uint32 i = 0; i < numSlots; ++i)
+                if (read (data, headerSize + 2 * i + 1) > numEntries)
+                    return false;
+
+            for (uint32 i = 0; i < 2 * numEntries; ++i)
+                if (read (data, headerSize + 2 * numSlots + i) >= size)
+                    return false;
+
+            return true;
+        }
+    }
+
+    uint32 hashTranslationKey (const String& text, const bool ignoreCase) noexcept
+    {
+        uint32 hash = 2166136261u;
+
+        for (String::CharPointerType t (text.getCharPointer()); ! t.isEmpty();)
+        {
+            juce_wchar c = t.getAndAdvance();
+
+            if (ignoreCase)
+                c = CharacterFunctions::toLowerCase (c);
+
+            hash = (hash ^ (uint32) c) * 16777619u;
+        }
+
+        return hash;
+    }
+
+    void fillHashSlots (HeapBlock<uint32>& slots, uint32& numSlots,
+                        const StringArray& keys, const bool ignoreCase)
+    {
+        // keep the table at most half full so that probe sequences stay short
+        numSlots = (uint32) nextPowerOfTwo (jmax (4, keys.size() * 2));
+        slots.calloc (2 * numSlots);
+
+        for (int i = 0; i < keys.size(); ++i)
+        {
+            const uint32 hash = hashTranslationKey (keys[i], ignoreCase);
+
+            for (uint32 slot = hash & (numSlots - 1);; slot = (slot + 1) & (numSlots - 1))
+            {
+                if (slots [2 * slot + 1] == 0)
+                {
+                    slots [2 * slot] = hash;
+                    slots [2 * slot + 1] = (uint32) i + 1;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+//==============================================================================
+LocalisedStrings::LocalisedStrings (MemoryMappedFile* const file)
+    : slots (CompiledTranslations::getSlots (file->getData())),
+      numSlots (CompiledTranslations::read (file->getData(), 3)),
+      ignoresCase ((CompiledTranslations::read (file->getData(), 1) & CompiledTranslations::ignoreCaseFlag) != 0),
+      compiledFile (file),
+      mappingsLoaded (false)
+{
+    const void* const data = file->getData();
+
+    languageName = String (CharPointer_UTF8 (CompiledTranslations::getString (data, CompiledTranslations::read (data, 4))));
+    countryCodes.addTokens (String (CharPointer_UTF8 (CompiledTranslations::getString (data, CompiledTranslations::read (data, 5)))), false);
+    countryCodes.removeEmptyStrings();
+}
+
+LocalisedStrings* LocalisedStrings::loadCompiledTranslations (const File& compiledFile)
+{
+    ScopedPointer<MemoryMappedFile> file (new MemoryMappedFile (compiledFile, MemoryMappedFile::readOnly));
+
+    if (! CompiledTranslations::isValid (file->getData(), file->getSize()))
+        return nullptr;
+
+    return new LocalisedStrings (file.release());
+}
+
+bool LocalisedStrings::writeCompiledTranslations (OutputStream& out) const
+{
+    const StringPairArray& mappings = getMappings();
+    const StringArray& keys = mappings.getAllKeys();
+    const StringArray& values = mappings.getAllValues();
+
+    HeapBlock<uint32> newSlots;
+    uint32 numNewSlots;
+    fillHashSlots (newSlots, numNewSlots, keys, ignoresCase);
+
+    MemoryOutputStream strings;
+    Array<uint32> stringOffsets;
+    const uint32 stringsStart = (uint32) ((CompiledTranslations::headerSize + 2 * numNewSlots + 2 * (uint32) keys.size()) * sizeof (uint32));
+
+    for (int i = 0; i < keys.size(); ++i)
+    {
+        stringOffsets.add (stringsStart + (uint32) strings.getDataSize());
+        strings.writeString (keys[i]);
+        stringOffsets.add (stringsStart + (uint32) strings.getDataSize());
+        strings.writeString (values[i]);
+    }
+
+    const uint32 languageOffset = stringsStart + (uint32) strings.getDataSize();
+    strings.writeString (languageName);
+    const uint32 countriesOffset = stringsStart + (uint32) strings.getDataSize();
+    strings.writeString (countryCodes.joinIntoString (" "));
+
+    MemoryOutputStream table;
+    table.writeInt (CompiledTranslations::magicNumber);
+    table.writeInt (ignoresCase ? CompiledTranslations::ignoreCaseFlag : 0);
+    table.writeInt (keys.size());
+    table.writeInt ((int) numNewSlots);
+    table.writeInt ((int) languageOffset);
+    table.writeInt ((int) countriesOffset);
+
+    for (uint32 i = 0; i < 2 * numNewSlots; ++i)
+        table.writeInt ((int) newSlots[i]);
+
+    for (int i = 0; i < stringOffsets.size(); ++i)
+        table.writeInt ((int) stringOffsets.getUnchecked (i));
+
+    return out.write (table.getData(), table.getDataSize())
+            && out.write (strings.getData(), strings.getDataSize());
+}
+
+//==============================================================================
+const StringPairArray& LocalisedStrings::getMappings() const
+{
+    const SpinLock::ScopedLockType sl (mappingsLock);
+
+    if (! mappingsLoaded)
+    {
+        const void* const data = compiledFile->getData();
+        const int numEntries = (int) CompiledTranslations::read (data, 2);
+
+        translations.setIgnoresCase (ignoresCase);
+
+        for (int i = 0; i < numEntries; ++i)
+            translations.set (String (CharPointer_UTF8 (CompiledTranslations::getEntryString (data, i, 0))),
+                              String (CharPointer_UTF8 (CompiledTranslations::getEntryString (data, i, 1))));
+
+        mappingsLoaded = true;
+    }
+
+    return translations;
+}
+
+void LocalisedStrings::buildHashTable()
+{
+    fillHashSlots (hashSlots, numSlots, translations.getAllKeys(), ignoresCase);
+    slots = hashSlots;
+}
+
+int LocalisedStrings::findIndex (const String& text) const noexcept
+{
+    if (numSlots == 0)
+        return -1;
+
+    const uint32 hash = hashTranslationKey (text, ignoresCase);
+
+    for (uint32 slot = hash & (numSlots - 1);; slot = (slot + 1) & (numSlots - 1))
+    {
+        const uint32 entry = slots [2 * slot + 1];
+
+        if (entry == 0)
+            return -1;
+
+        if (slots [2 * slot] == hash)
+        {
+            const int index = (int) entry - 1;
+
+            if (compiledFile != nullptr)
+            {
+                const CharPointer_UTF8 key (CompiledTranslations::getEntryString (compiledFile->getData(), index, 0));
+
+                if (ignoresCase ? text.getCharPointer().compareIgnoreCase (key) == 0
+                                : text.getCharPointer().compare (key) == 0)
+                    return index;
+            }
+            else
+            {
+                const String& key = translations.getAllKeys() [index];
+
+                if (ignoresCase ? key.equalsIgnoreCase (text) : key == text)
+                    return index;
+            }
+        }
+    }
+}
+
 //==============================================================================
 String LocalisedStrings::translate (const String& text) const
 {
-    return translations.getValue (text, text);
+    return translate (text, text);
 }
 
 String LocalisedStrings::translate (const String& text, const String& resultIfNotFound) const
 {
-    return translations.getValue (text, resultIfNotFound);
+    const int index = findIndex (text);
+
+    if (index < 0)
+        return resultIfNotFound;
+
+    if (compiledFile != nullptr)
+        return String (CharPointer_UTF8 (CompiledTranslations::getEntryString (compiledFile->getData(), index, 1)));
+
+    return translations.getAllValues() [index];
 }
 
 namespace
@@ -70,7 +324,8 @@ namespace
     LeakAvoidanceTrick leakAvoidanceTrick;
    #endif
 
-    SpinLock currentMappingsLock;
+    // translate() is called from all over the place, so readers mustn't contend with each other
+    ScalableReadWriteLock currentMappingsLock;
     ScopedPointer<LocalisedStrings> currentMappings;
 
     int findCloseQuote (const String& text, int startPos)
@@ -141,13 +396,24 @@ void LocalisedStrings::loadFromText (const String& fileContents, bool ignoreCase
             countryCodes.removeEmptyStrings();
         }
     }
+
+    buildHashTable();
 }
 
 //==============================================================================
 void LocalisedStrings::setCurrentMappings (LocalisedStrings* newTranslations)
 {
-    const SpinLock::ScopedLockType sl (currentMappingsLock);
-    currentMappings = newTranslations;
+    ScopedPointer<LocalisedStrings> oldMappings;
+
+    {
+        const ScalableReadWriteLock::ScopedWriteLockType sl (currentMappingsLock);
+
+        if (currentMappings != newTranslations)
+        {
+            oldMappings = currentMappings.release();
+            currentMappings = newTranslations;
+        }
+    }
 }
 
 LocalisedStrings* LocalisedStrings::getCurrentMappings()
@@ -178,10 +444,106 @@ String translate (const char* const literal)
 
 String translate (const String& text, const String& resultIfNotFound)
 {
-    const SpinLock::ScopedLockType sl (currentMappingsLock);
+    const ScalableReadWriteLock::ScopedReadLockType sl (currentMappingsLock);
 
     if (const LocalisedStrings* const mappings = LocalisedStrings::getCurrentMappings())
         return mappings->translate (text, resultIfNotFound);
 
     return resultIfNotFound;
 }
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class LocalisedStringsTests  : public UnitTest
+{
+public:
+    LocalisedStringsTests() : UnitTest ("LocalisedStrings") {}
+
+    static String createTranslationFile (const int numStrings)
+    {
+        String text ("language: French\ncountries: fr be mc ch lu\n\n"
+                     "\"hello\" = \"bonjour\"\n"
+                     "\"Quote \\\"this\\\"\" = \"Citez \\\"ceci\\\"\"\n");
+
+        for (int i = 0; i < numStrings; ++i)
+            text << "\"string " << i << "\" = \"" << String (CharPointer_UTF8 ("cha\xc3\xaene ")) << i << "\"\n";
+
+        return text;
+    }
+
+    void checkTranslations (const LocalisedStrings& strings, const bool ignoreCase, const int numStrings)
+    {
+        expectEquals (strings.getLanguageName(), String ("French"));
+        expectEquals (strings.getCountryCodes().joinIntoString (" "), String ("fr be mc ch lu"));
+
+        expectEquals (strings.translate ("hello"), String ("bonjour"));
+        expectEquals (strings.translate ("Quote \"this\""), String ("Citez \"ceci\""));
+        expectEquals (strings.translate ("goodbye"), String ("goodbye"));
+        expectEquals (strings.translate ("goodbye", "?"), String ("?"));
+        expectEquals (strings.translate ("HELLO"), String (ignoreCase ? "bonjour" : "HELLO"));
+
+        bool allFound = true;
+
+        for (int i = 0; i < numStrings; ++i)
+            allFound = allFound && strings.translate ("string " + String (i))
+                                     == String (CharPointer_UTF8 ("cha\xc3\xaene ")) + String (i);
+
+        expect (allFound);
+        expectEquals (strings.getMappings().size(), numStrings + 2);
+    }
+
+    void runTest()
+    {
+        const int numStrings = 3000;
+
+        beginTest ("Text files");
+
+        const LocalisedStrings caseSensitive (createTranslationFile (numStrings), false);
+        checkTranslations (caseSensitive, false, numStrings);
+
+        const LocalisedStrings caseInsensitive (createTranslationFile (numStrings), true);
+        checkTranslations (caseInsensitive, true, numStrings);
+
+        beginTest ("Compiled files");
+
+        for (int i = 0; i < 2; ++i)
+        {
+            const LocalisedStrings& original = (i == 0 ? caseSensitive : caseInsensitive);
+            const TemporaryFile temp;
+
+            {
+                FileOutputStream out (temp.getFile());
+                expect (original.writeCompiledTranslations (out));
+            }
+
+            const ScopedPointer<LocalisedStrings> compiled (LocalisedStrings::loadCompiledTranslations (temp.getFile()));
+            expect (compiled != nullptr);
+
+            if (compiled != nullptr)
+                checkTranslations (*compiled, i != 0, numStrings);
+        }
+
+        beginTest ("Invalid compiled files");
+
+        {
+            const TemporaryFile temp;
+            temp.getFile().replaceWithText ("\"hello\" = \"bonjour\"");
+            expect (LocalisedStrings::loadCompiledTranslations (temp.getFile()) == nullptr);
+            expect (LocalisedStrings::loadCompiledTranslations (temp.getFile().getSiblingFile ("doesNotExist")) == nullptr);
+        }
+
+        beginTest ("Current mappings");
+
+        LocalisedStrings::setCurrentMappings (new LocalisedStrings (createTranslationFile (0), false));
+        expectEquals (translate ("hello"), String ("bonjour"));
+        expectEquals (translate (String ("goodbye")), String ("goodbye"));
+
+        LocalisedStrings::setCurrentMappings (nullptr);
+        expectEquals (translate ("hello"), String ("hello"));
+    }
+};
+
+static LocalisedStringsTests localisedStringsTests;
+
+#endif
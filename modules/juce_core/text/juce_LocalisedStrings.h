@@ -31,6 +31,11 @@
 
 #include "juce_StringPairArray.h"
 #include "../files/juce_File.h"
+#include "../files/juce_MemoryMappedFile.h"
+#include "../streams/juce_OutputStream.h"
+#include "../memory/juce_HeapBlock.h"
+#include "../memory/juce_ScopedPointer.h"
+#include "../threads/juce_SpinLock.h"
 
 //==============================================================================
 /**
@@ -74,6 +79,12 @@
     intercept and translate any internal Juce text strings that might be shown. (You can easily
     get a list of all the messages by searching for the TRANS() macro in the Juce source
     code).
+
+    Look-ups use a hash table, so they take the same time however many strings there are,
+    and translating with the current mappings doesn't make threads contend for a lock.
+    For big tables, writeCompiledTranslations() can save the translations in a binary
+    form which loadCompiledTranslations() maps straight into memory, so that an app can
+    start up without having to parse the text file.
 */
 class JUCE_API  LocalisedStrings
 {
@@ -98,6 +109,27 @@ public:
     /** Destructor. */
     ~LocalisedStrings();
 
+    //==============================================================================
+    /** Loads a set of translations that was saved by writeCompiledTranslations().
+
+        The file is memory-mapped rather than read, and translations are looked up
+        directly in the mapped data, so this is very quick even for large tables. The
+        file mustn't be modified while the object exists.
+
+        Returns nullptr if the file can't be opened or isn't a valid compiled
+        translation file. The caller is responsible for deleting the object that is
+        returned (or passing it to setCurrentMappings()).
+    */
+    static LocalisedStrings* loadCompiledTranslations (const File& compiledFile);
+
+    /** Writes these translations to a stream in the binary format that
+        loadCompiledTranslations() reads.
+
+        The case-sensitivity, language name and country codes are stored with them.
+        @returns false if the stream couldn't be written to.
+    */
+    bool writeCompiledTranslations (OutputStream& destination) const;
+
     //==============================================================================
     /** Selects the current set of mappings to be used by the system.
 
@@ -171,16 +203,30 @@ public:
     */
     const StringArray& getCountryCodes() const            { return countryCodes; }
 
-    /** Provides access to the actual list of mappings. */
-    const StringPairArray& getMappings() const            { return translations; }
+    /** Provides access to the actual list of mappings.
+
+        For translations loaded with loadCompiledTranslations(), this list is only built
+        the first time it's asked for.
+    */
+    const StringPairArray& getMappings() const;
 
 private:
     //==============================================================================
     String languageName;
     StringArray countryCodes;
-    StringPairArray translations;
-
+    mutable StringPairArray translations;
+    HeapBlock<uint32> hashSlots;
+    const uint32* slots;
+    uint32 numSlots;
+    bool ignoresCase;
+    ScopedPointer<MemoryMappedFile> compiledFile;
+    mutable SpinLock mappingsLock;
+    mutable bool mappingsLoaded;
+
+    explicit LocalisedStrings (MemoryMappedFile*);
     void loadFromText (const String&, bool ignoreCase);
+    void buildHashTable();
+    int findIndex (const String&) const noexcept;
 
     JUCE_LEAK_DETECTOR (LocalisedStrings)
 };
@@ -55,7 +55,7 @@ class StringHolder
 {
 public:
     StringHolder() noexcept
-        : refCount (0x3fffffff), allocatedNumBytes (sizeof (*text))
+        : refCount (0x3fffffff), cachedLength (0), allocatedNumBytes (sizeof (*text))
     {
         text[0] = 0;
     }
@@ -68,6 +68,7 @@ public:
     {
         StringHolder* const s = reinterpret_cast <StringHolder*> (new char [sizeof (StringHolder) - sizeof (CharType) + numBytes]);
         s->refCount.value = 0;
+        s->cachedLength.value = -1;
         s->allocatedNumBytes = numBytes;
         return CharPointerType (s->text);
     }
@@ -78,12 +79,7 @@ public:
         if (text.getAddress() == nullptr || text.isEmpty())
             return getEmpty();
 
-        CharPointer t (text);
-        size_t bytesNeeded = sizeof (CharType);
-
-        while (! t.isEmpty())
-            bytesNeeded += CharPointerType::getBytesRequiredFor (t.getAndAdvance());
-
+        const size_t bytesNeeded = sizeof (CharType) + CharPointerType::getBytesRequiredFor (text);
         const CharPointerType dest (createUninitialisedBytes (bytesNeeded));
         CharPointerType (dest).writeAll (text);
         return dest;
@@ -178,7 +174,10 @@ public:
         StringHolder* const b = bufferFromText (text);
 
         if (b->refCount.get() <= 0)
+        {
+            b->cachedLength.value = -1;
             return text;
+        }
 
         CharPointerType newText (createUninitialisedBytes (b->allocatedNumBytes));
         memcpy (newText.getAddress(), text.getAddress(), b->allocatedNumBytes);
@@ -192,7 +191,10 @@ public:
         StringHolder* const b = bufferFromText (text);
 
         if (b->refCount.get() <= 0 && b->allocatedNumBytes >= numBytes)
+        {
+            b->cachedLength.value = -1;
             return text;
+        }
 
         CharPointerType newText (createUninitialisedBytes (jmax (b->allocatedNumBytes, numBytes)));
         memcpy (newText.getAddress(), text.getAddress(), b->allocatedNumBytes);
@@ -206,8 +208,28 @@ public:
         return bufferFromText (text)->allocatedNumBytes;
     }
 
+    // The number of characters is worked out the first time it's needed and then kept,
+    // because a holder's content can't change while it's shared, and anything that gets
+    // write access to it goes through makeUnique() or makeUniqueWithByteSize(), which
+    // clear the cached value. (Two threads may both fill it in at once, but they'll
+    // both be writing the same number).
+    static int getLength (const CharPointerType text) noexcept
+    {
+        StringHolder* const b = bufferFromText (text);
+        int len = b->cachedLength.value;
+
+        if (len < 0)
+        {
+            len = (int) text.length();
+            b->cachedLength.value = len;
+        }
+
+        return len;
+    }
+
     //==============================================================================
     Atomic<int> refCount;
+    Atomic<int> cachedLength;
     size_t allocatedNumBytes;
     CharType text[1];
 
@@ -509,7 +531,7 @@ String::String (const double number, const int numberOfDecimalPlaces)  : text (N
 //==============================================================================
 int String::length() const noexcept
 {
-    return (int) text.length();
+    return StringHolder::getLength (text);
 }
 
 size_t String::getByteOffsetOfEnd() const noexcept
@@ -2374,6 +2396,56 @@ public:
             TestUTFConversion <CharPointer_UTF16>::test (*this);
         }
 
+        {
+            beginTest ("ASCII runs");
+
+            Random r;
+
+            for (int i = 0; i < 200; ++i)
+            {
+                juce_wchar chars[80] = { 0 };
+                const int numChars = r.nextInt (numElementsInArray (chars) - 1);
+
+                for (int j = 0; j < numChars; ++j)
+                    chars[j] = r.nextInt (8) == 0 ? (juce_wchar) (0x80 + r.nextInt (0x3000))
+                                                  : (juce_wchar) (1 + r.nextInt (0x7f));
+
+                const String s (CharPointer_UTF32 (chars + 0));
+                expectEquals (s.length(), numChars);
+
+                const char* const utf8 = s.toRawUTF8();
+                size_t slowLength = 0;
+
+                for (CharPointer_UTF8 p (utf8); ! p.isEmpty(); ++p)
+                    ++slowLength;
+
+                expect (CharPointer_UTF8 (utf8).length() == slowLength);
+                expect (CharPointer_UTF8::isValidString (utf8, (int) strlen (utf8)));
+                expectEquals (String (s.toUTF16()), s);
+                expectEquals (String (s.toUTF32()), s);
+                expect (memcmp (s.toUTF32().getAddress(), chars, sizeof (juce_wchar) * (size_t) (numChars + 1)) == 0);
+
+                const size_t maxBytes = (size_t) r.nextInt (40);
+                CharPointer_UTF16::CharType utf16 [100];
+                s.copyToUTF16 (utf16, maxBytes);
+
+                if (maxBytes >= sizeof (CharPointer_UTF16::CharType))
+                    expect (String (CharPointer_UTF16 (utf16)) == s.substring (0, String (CharPointer_UTF16 (utf16)).length()));
+            }
+
+            const char invalid[] = "abcdefghijklmnopqrstuvwxyz\xc3";
+            expect (! CharPointer_UTF8::isValidString (invalid, (int) sizeof (invalid) - 1));
+            expect (CharPointer_UTF8::isValidString (invalid, 20));
+
+            String s ("0123456789");
+            expectEquals (s.length(), 10);
+            s << "abc";
+            expectEquals (s.length(), 13);
+            s += String (CharPointer_UTF8 ("\xc3\xa9"));
+            expectEquals (s.length(), 14);
+            expectEquals (String (s).length(), 14);
+        }
+
         {
             beginTest ("StringArray");
 
@@ -2409,3 +2481,111 @@ public:
 static StringTests stringUnitTests;
 
 #endif
+
+//==============================================================================
+#if JUCE_BENCHMARKS
+
+class StringBenchmarks  : public Benchmark
+{
+public:
+    StringBenchmarks() : Benchmark ("String class") {}
+
+    void runBenchmark()
+    {
+        const String sentence ("The quick brown fox jumps over the lazy dog");
+        const String other ("The quick brown fox jumps over the lazy cat");
+
+        beginMeasurement ("append 1000 short strings");
+        while (keepRunning())
+        {
+            String s;
+
+            for (int i = 0; i < 1000; ++i)
+                s << "abc";
+
+            preventOptimisation (s);
+        }
+
+        beginMeasurement ("1000 x String (int)");
+        while (keepRunning())
+        {
+            int total = 0;
+
+            for (int i = 0; i < 1000; ++i)
+                total += String (i * 12345).length();
+
+            preventOptimisation (total);
+        }
+
+        beginMeasurement ("1000 x getIntValue()");
+        const String number ("1234567");
+        while (keepRunning())
+        {
+            int total = 0;
+
+            for (int i = 0; i < 1000; ++i)
+                total += number.getIntValue();
+
+            preventOptimisation (total);
+        }
+
+        beginMeasurement ("1000 x compare");
+        while (keepRunning())
+        {
+            int total = 0;
+
+            for (int i = 0; i < 1000; ++i)
+                total += sentence.compare (other);
+
+            preventOptimisation (total);
+        }
+
+        beginMeasurement ("1000 x compareIgnoreCase");
+        while (keepRunning())
+        {
+            int total = 0;
+
+            for (int i = 0; i < 1000; ++i)
+                total += sentence.compareIgnoreCase (other);
+
+            preventOptimisation (total);
+        }
+
+        beginMeasurement ("1000 x indexOf");
+        while (keepRunning())
+        {
+            int total = 0;
+
+            for (int i = 0; i < 1000; ++i)
+                total += sentence.indexOf ("lazy");
+
+            preventOptimisation (total);
+        }
+
+        beginMeasurement ("1000 x toUpperCase");
+        while (keepRunning())
+        {
+            int total = 0;
+
+            for (int i = 0; i < 1000; ++i)
+                total += sentence.toUpperCase().length();
+
+            preventOptimisation (total);
+        }
+
+        beginMeasurement ("1000 x replace");
+        while (keepRunning())
+        {
+            int total = 0;
+
+            for (int i = 0; i < 1000; ++i)
+                total += sentence.replace ("fox", "badger").length();
+
+            preventOptimisation (total);
+        }
+    }
+};
+
+static StringBenchmarks stringBenchmarks;
+
+#endif
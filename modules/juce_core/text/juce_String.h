@@ -1347,5 +1347,6 @@ std::basic_ostream <wchar_t, traits>& JUCE_CALLTYPE operator<< (std::basic_ostre
 /** Writes a string to an OutputStream as UTF8. */
 JUCE_API OutputStream& JUCE_CALLTYPE operator<< (OutputStream& stream, const String& stringToWrite);
 
+#include "juce_StringRef.h"
 
 #endif   // __JUCE_STRING_JUCEHEADER__
@@ -289,28 +289,146 @@ void StringArray::trim()
 }
 
 //==============================================================================
-struct InternalStringArrayComparator_CaseSensitive
-{
-    static int compareElements (String& first, String& second)      { return first.compare (second); }
-};
+namespace StringArraySortHelpers
+{
+    /*  Sorting compares each string many times, so before sorting, the first few characters
+        of each string are packed into an integer whose ordering matches String::compare()
+        (or compareIgnoreCase(), using case-folded characters). Most comparisons can then be
+        decided by the keys alone, and the strings themselves are only compared when their
+        keys are the same and at least one of them is too long to fit completely in its key.
+    */
+    struct SortKey
+    {
+        uint64 key;
+        const String* string;
+        bool isWholeString;
+    };
 
-struct InternalStringArrayComparator_CaseInsensitive
-{
-    static int compareElements (String& first, String& second)      { return first.compareIgnoreCase (second); }
-};
+    enum { bitsPerChar = 21, charsPerKey = 3 };
 
-void StringArray::sort (const bool ignoreCase)
-{
-    if (ignoreCase)
+    static uint32 foldCase (const juce_wchar c) noexcept
     {
-        InternalStringArrayComparator_CaseInsensitive comp;
-        strings.sort (comp);
+       #if JUCE_STRING_UTF_TYPE == 8
+        // for UTF-8, String::compareIgnoreCase() uses strcasecmp/stricmp, which only folds ASCII
+        return (uint32) ((c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c);
+       #else
+        return (uint32) CharacterFunctions::toUpperCase (c);
+       #endif
     }
-    else
+
+    static SortKey createSortKey (const String& s, const bool ignoreCase) noexcept
     {
-        InternalStringArrayComparator_CaseSensitive comp;
-        strings.sort (comp);
+        SortKey k;
+        k.key = 0;
+        k.string = &s;
+        k.isWholeString = true;
+
+        String::CharPointerType t (s.getCharPointer());
+
+        for (int i = 0; i < charsPerKey; ++i)
+        {
+            uint32 c = (uint32) *t;
+
+            if (c != 0)
+            {
+                if (ignoreCase)
+                    c = foldCase ((juce_wchar) c);
+
+                ++t;
+
+                // (malformed strings can produce values that won't fit, but clamping them still
+                // gives the right order, and the full comparison will sort out any ties)
+                if (c >= (1u << bitsPerChar))
+                {
+                    c = (1u << bitsPerChar) - 1;
+                    k.isWholeString = false;
+                }
+            }
+
+            k.key = (k.key << bitsPerChar) | c;
+        }
+
+        if (! t.isEmpty())
+            k.isWholeString = false;
+
+        return k;
     }
+
+    struct KeyComparator
+    {
+        KeyComparator (bool shouldIgnoreCase) noexcept  : ignoreCase (shouldIgnoreCase) {}
+
+        int compareElements (const SortKey& first, const SortKey& second) const noexcept
+        {
+            if (first.key != second.key)
+                return first.key < second.key ? -1 : 1;
+
+            if (first.isWholeString && second.isWholeString)
+                return 0;
+
+            return ignoreCase ? first.string->compareIgnoreCase (*second.string)
+                              : first.string->compare (*second.string);
+        }
+
+        const bool ignoreCase;
+    };
+
+    struct CreateKeys
+    {
+        CreateKeys (SortKey* k, const String* s, bool ic) noexcept  : keys (k), strings (s), ignoreCase (ic) {}
+
+        void operator() (const int index) const noexcept
+        {
+            keys[index] = createSortKey (strings[index], ignoreCase);
+        }
+
+        SortKey* const keys;
+        const String* const strings;
+        const bool ignoreCase;
+    };
+
+    static void sort (Array<String>& strings, const bool ignoreCase, ThreadPool* const pool)
+    {
+        const int num = strings.size();
+
+        if (num < 2)
+            return;
+
+        HeapBlock<SortKey> keys ((size_t) num);
+        const CreateKeys createKeys (keys, strings.getRawDataPointer(), ignoreCase);
+        KeyComparator comparator (ignoreCase);
+
+        if (pool != nullptr)
+        {
+            pool->parallelFor (0, num, createKeys);
+            parallelSortArray (*pool, comparator, keys.getData(), num, false);
+        }
+        else
+        {
+            for (int i = 0; i < num; ++i)
+                createKeys (i);
+
+            sortArray (comparator, keys.getData(), 0, num - 1, false);
+        }
+
+        Array<String> sorted;
+        sorted.ensureStorageAllocated (num);
+
+        for (int i = 0; i < num; ++i)
+            sorted.add (*keys[i].string);
+
+        strings.swapWithArray (sorted);
+    }
+}
+
+void StringArray::sort (const bool ignoreCase)
+{
+    StringArraySortHelpers::sort (strings, ignoreCase, nullptr);
+}
+
+void StringArray::sort (const bool ignoreCase, ThreadPool& pool)
+{
+    StringArraySortHelpers::sort (strings, ignoreCase, &pool);
 }
 
 void StringArray::move (const int currentIndex, int newIndex) noexcept
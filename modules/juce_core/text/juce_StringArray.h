@@ -390,6 +390,14 @@ public:
     */
     void sort (bool ignoreCase);
 
+    /** Sorts the array into alphabetical order, sharing the work between the threads
+        of a ThreadPool.
+
+        This gives the same order as the other sort() method, but large arrays are sorted
+        in parallel using parallelSortArray().
+    */
+    void sort (bool ignoreCase, ThreadPool& pool);
+
     //==============================================================================
     /** Reduces the amount of storage being used by the array.
 
@@ -0,0 +1,120 @@
+/*
+  ==============================================================================
+
+   This file is part of the juce_core module of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission to use, copy, modify, and/or distribute this software for any purpose with
+   or without fee is hereby granted, provided that the above copyright notice and this
+   permission notice appear in all copies.
+
+   THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+   TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+   NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+   DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+   IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+   ------------------------------------------------------------------------------
+
+   NOTE! This permissive ISC license applies ONLY to files within the juce_core module!
+   All other JUCE modules are covered by a dual GPL/commercial license, so if you are
+   using any other modules, be sure to check that you also comply with their license.
+
+   For more details, visit www.juce.com
+
+  ==============================================================================
+*/
+
+StringBuilder::StringBuilder (const size_t chunkSize)
+    : SegmentedMemoryOutputStream (chunkSize)
+{
+}
+
+StringBuilder::~StringBuilder()
+{
+}
+
+void StringBuilder::appendCharacter (const juce_wchar character)
+{
+    char buffer [8];
+    CharPointer_UTF8 dest (buffer);
+    dest.write (character);
+    write (buffer, (size_t) getAddressDifference (dest.getAddress(), buffer));
+}
+
+String StringBuilder::toString() const
+{
+    const size_t numBytes = getDataSize();
+
+    if (numBytes == 0)
+        return String::empty;
+
+   #if (JUCE_STRING_UTF_TYPE == 8)
+    // The text is already in the String's own format, so it can be copied straight in..
+    String result;
+    result.preallocateBytes (numBytes);
+
+    char* const dest = result.getCharPointer().getAddress();
+    copyTo (dest);
+    dest [numBytes] = 0;
+    return result;
+   #else
+    const MemoryBlock data (getMemoryBlock());
+    return String::fromUTF8 (static_cast <const char*> (data.getData()), (int) numBytes);
+   #endif
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class StringBuilderTests  : public UnitTest
+{
+public:
+    StringBuilderTests() : UnitTest ("StringBuilder") {}
+
+    void runTest()
+    {
+        beginTest ("Basics");
+
+        {
+            StringBuilder sb;
+            expect (sb.isEmpty());
+            expect (sb.toString().isEmpty());
+
+            sb << "abc" << 123 << ' ' << String (CharPointer_UTF8 ("\xc3\xa9"));
+            sb.appendCharacter ((juce_wchar) 0x1d11e);
+            expect (! sb.isEmpty());
+
+            const String expected (String ("abc123 ") + String (CharPointer_UTF8 ("\xc3\xa9\xf0\x9d\x84\x9e")));
+            expectEquals (sb.toString(), expected);
+            expectEquals (sb.toString().length(), 9);
+
+            sb.clear();
+            expect (sb.toString().isEmpty());
+        }
+
+        beginTest ("Many chunks");
+
+        {
+            Random r;
+            StringBuilder sb (64);
+            String expected;
+
+            for (int i = 0; i < 500; ++i)
+            {
+                const String piece (r.nextBool() ? String (r.nextInt())
+                                                 : String::charToString ((juce_wchar) (1 + r.nextInt (0x2fff))));
+                sb << piece;
+                expected += piece;
+            }
+
+            expect (sb.getNumSegments() > 1);
+            expectEquals (sb.toString(), expected);
+        }
+    }
+};
+
+static StringBuilderTests stringBuilderTests;
+
+#endif
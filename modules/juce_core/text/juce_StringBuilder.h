@@ -0,0 +1,92 @@
+/*
+  ==============================================================================
+
+   This file is part of the juce_core module of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission to use, copy, modify, and/or distribute this software for any purpose with
+   or without fee is hereby granted, provided that the above copyright notice and this
+   permission notice appear in all copies.
+
+   THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+   TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+   NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+   DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+   IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+   ------------------------------------------------------------------------------
+
+   NOTE! This permissive ISC license applies ONLY to files within the juce_core module!
+   All other JUCE modules are covered by a dual GPL/commercial license, so if you are
+   using any other modules, be sure to check that you also comply with their license.
+
+   For more details, visit www.juce.com
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_STRINGBUILDER_JUCEHEADER__
+#define __JUCE_STRINGBUILDER_JUCEHEADER__
+
+#include "../streams/juce_SegmentedMemoryOutputStream.h"
+
+
+//==============================================================================
+/**
+    Collects lots of pieces of text, and then joins them into a single String.
+
+    Appending to a String with operator+= or operator<< means that its storage has to
+    be reallocated and copied whenever it runs out of space, and an expression like
+    a + b + c creates a temporary String for each step. When you're building a large
+    piece of text, it's much quicker to write it into one of these instead - the text
+    is stored as UTF-8 in fixed-size chunks which are never moved, and toString() then
+    creates the final String with a single allocation.
+
+    Because this is an OutputStream, all the usual stream operator<< methods can be used
+    to add text and numbers to it, and it can be passed to any function that writes its
+    output to a stream, e.g. XmlElement::writeToStream() or JSON::writeToStream().
+
+    @code
+    StringBuilder sb;
+
+    for (int i = 0; i < 1000; ++i)
+        sb << "item " << i << newLine;
+
+    String result (sb.toString());
+    @endcode
+
+    @see SegmentedMemoryOutputStream
+*/
+class JUCE_API  StringBuilder  : public SegmentedMemoryOutputStream
+{
+public:
+    //==============================================================================
+    /** Creates an empty builder.
+        @param chunkSize    the number of bytes in each of the blocks that the text is stored in
+    */
+    explicit StringBuilder (size_t chunkSize = 16384);
+
+    /** Destructor. */
+    ~StringBuilder();
+
+    //==============================================================================
+    /** Returns true if nothing has been added to the builder. */
+    bool isEmpty() const noexcept                       { return getDataSize() == 0; }
+
+    /** Removes all the text that has been added. */
+    void clear() noexcept                               { reset(); }
+
+    /** Appends a unicode character to the text. */
+    void appendCharacter (juce_wchar character);
+
+    /** Returns all the text that has been added, joined together into a String. */
+    String toString() const;
+
+private:
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (StringBuilder)
+};
+
+
+#endif   // __JUCE_STRINGBUILDER_JUCEHEADER__
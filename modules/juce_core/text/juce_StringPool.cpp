@@ -29,54 +29,125 @@
 StringPool::StringPool() noexcept   {}
 StringPool::~StringPool()           {}
 
-namespace StringPoolHelpers
+//==============================================================================
+/*  An open hash table of the pooled strings. Entries are only ever added, and each one
+    is completely written before the bucket that points to it is updated, so readers can
+    walk the chains without locking while a writer adds to them. When a table fills up,
+    its contents are copied into a bigger one, but the old table is kept alive until the
+    pool is deleted, in case another thread is still reading it.
+*/
+struct StringPool::Table
 {
-    template <class StringType>
-    String::CharPointerType getPooledStringFromArray (Array<String>& strings,
-                                                      StringType newString,
-                                                      const CriticalSection& lock)
+    explicit Table (const int numBuckets_)
+        : numBuckets (numBuckets_), numEntries (0),
+          buckets ((size_t) numBuckets_, true),
+          entries ((size_t) numBuckets_ / 2)
+    {
+        jassert (isPowerOfTwo (numBuckets));
+    }
+
+    struct Entry
     {
-        const ScopedLock sl (lock);
-        int start = 0;
-        int end = strings.size();
+        String::CharPointerType::CharType* text;
+        uint32 hash;
+        int next;  // index + 1 of the next entry in this bucket's chain, or 0
+    };
 
-        for (;;)
+    template <class CharPointer>
+    String::CharPointerType::CharType* find (const CharPointer text, const uint32 hash) const noexcept
+    {
+        for (int i = buckets [hash & (uint32) (numBuckets - 1)].value; i > 0;)
         {
-            if (start >= end)
-            {
-                jassert (start <= end);
-                strings.insert (start, newString);
-                return strings.getReference (start).getCharPointer();
-            }
-            else
-            {
-                const String& startString = strings.getReference (start);
+            const Entry& e = entries [i - 1];
 
-                if (startString == newString)
-                    return startString.getCharPointer();
+            if (e.hash == hash && CharacterFunctions::compare (String::CharPointerType (e.text), text) == 0)
+                return e.text;
 
-                const int halfway = (start + end) >> 1;
+            i = e.next;
+        }
 
-                if (halfway == start)
-                {
-                    if (startString.compare (newString) < 0)
-                        ++start;
+        return nullptr;
+    }
 
-                    strings.insert (start, newString);
-                    return strings.getReference (start).getCharPointer();
-                }
+    // (must only be called by a thread that holds the pool's lock)
+    void add (String::CharPointerType::CharType* const text, const uint32 hash) noexcept
+    {
+        jassert (! isFull());
 
-                const int comp = strings.getReference (halfway).compare (newString);
+        Entry& e = entries [numEntries++];
+        e.text = text;
+        e.hash = hash;
 
-                if (comp == 0)
-                    return strings.getReference (halfway).getCharPointer();
-                else if (comp < 0)
-                    start = halfway;
-                else
-                    end = halfway;
-            }
-        }
+        Atomic<int>& bucket = buckets [hash & (uint32) (numBuckets - 1)];
+        e.next = bucket.value;
+        bucket.set (numEntries);
     }
+
+    bool isFull() const noexcept    { return numEntries >= numBuckets / 2; }
+
+    const int numBuckets;
+    int numEntries;
+    HeapBlock<Atomic<int> > buckets;
+    HeapBlock<Entry> entries;
+
+private:
+    JUCE_DECLARE_NON_COPYABLE (Table)
+};
+
+namespace StringPoolHelpers
+{
+    template <class CharPointer>
+    static uint32 calculateHash (CharPointer text) noexcept
+    {
+        uint32 hash = 0;
+
+        while (const juce_wchar c = text.getAndAdvance())
+            hash = hash * 31 + (uint32) c;
+
+        return hash ^ (hash >> 16);
+    }
+
+    template <class CharPointer>
+    static String createString (const CharPointer text)         { return String (text); }
+    static String createString (const CharPointer_ASCII text)   { return String (text.getAddress()); }
+}
+
+template <class CharPointer>
+String::CharPointerType StringPool::getPooledCharPointer (const CharPointer text)
+{
+    const uint32 hash = StringPoolHelpers::calculateHash (text);
+
+    if (const Table* const table = currentTable.value)
+        if (String::CharPointerType::CharType* const found = table->find (text, hash))
+            return String::CharPointerType (found);
+
+    const ScopedLock sl (lock);
+    Table* table = currentTable.value;
+
+    if (table != nullptr)
+    {
+        // another thread may have added it while we were waiting for the lock..
+        if (String::CharPointerType::CharType* const found = table->find (text, hash))
+            return String::CharPointerType (found);
+    }
+
+    if (table == nullptr || table->isFull())
+    {
+        Table* const newTable = new Table (table != nullptr ? table->numBuckets * 2 : 256);
+        tables.add (newTable);
+
+        if (table != nullptr)
+            for (int i = 0; i < table->numEntries; ++i)
+                newTable->add (table->entries[i].text, table->entries[i].hash);
+
+        currentTable = newTable;
+        table = newTable;
+    }
+
+    strings.add (StringPoolHelpers::createString (text));
+    const String::CharPointerType pooled (strings.getReference (strings.size() - 1).getCharPointer());
+    table->add (pooled.getAddress(), hash);
+    return pooled;
 }
 
 String::CharPointerType StringPool::getPooledString (const String& s)
@@ -84,7 +155,7 @@ String::CharPointerType StringPool::getPooledString (const String& s)
     if (s.isEmpty())
         return String::empty.getCharPointer();
 
-    return StringPoolHelpers::getPooledStringFromArray (strings, s, lock);
+    return getPooledCharPointer (s.getCharPointer());
 }
 
 String::CharPointerType StringPool::getPooledString (const char* const s)
@@ -92,7 +163,7 @@ String::CharPointerType StringPool::getPooledString (const char* const s)
     if (s == nullptr || *s == 0)
         return String::empty.getCharPointer();
 
-    return StringPoolHelpers::getPooledStringFromArray (strings, s, lock);
+    return getPooledCharPointer (CharPointer_ASCII (s));
 }
 
 String::CharPointerType StringPool::getPooledString (const wchar_t* const s)
@@ -100,7 +171,7 @@ String::CharPointerType StringPool::getPooledString (const wchar_t* const s)
     if (s == nullptr || *s == 0)
         return String::empty.getCharPointer();
 
-    return StringPoolHelpers::getPooledStringFromArray (strings, s, lock);
+    return getPooledCharPointer (castToCharPointer_wchar_t (s));
 }
 
 int StringPool::size() const noexcept
@@ -110,5 +181,96 @@ int StringPool::size() const noexcept
 
 String::CharPointerType StringPool::operator[] (const int index) const noexcept
 {
+    const ScopedLock sl (lock);
     return strings [index].getCharPointer();
 }
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class StringPoolTests  : public UnitTest
+{
+public:
+    StringPoolTests() : UnitTest ("StringPool") {}
+
+    struct LookupThread  : public Thread
+    {
+        LookupThread (StringPool& p, const int offset_)
+            : Thread ("StringPool test"), pool (p), offset (offset_), numMismatches (0)
+        {}
+
+        void run()
+        {
+            for (int i = 0; i < 5000; ++i)
+            {
+                const String name ("item" + String ((i + offset) % 3000));
+
+                if (pool.getPooledString (name) != pool.getPooledString (name.toRawUTF8()))
+                    ++numMismatches;
+            }
+        }
+
+        StringPool& pool;
+        const int offset;
+        int numMismatches;
+    };
+
+    void runTest()
+    {
+        beginTest ("Basics");
+
+        {
+            StringPool pool;
+            const String::CharPointerType a (pool.getPooledString ("abc"));
+
+            expect (a == pool.getPooledString (String ("abc")));
+            expect (a == pool.getPooledString (L"abc"));
+            expect (a != pool.getPooledString ("abd"));
+            expect (String (a) == "abc");
+            expect (pool.getPooledString (String::empty) == String::empty.getCharPointer());
+
+            // enough strings to make the table grow several times
+            Array<const void*> pooled;
+
+            for (int i = 0; i < 2000; ++i)
+                pooled.add (pool.getPooledString ("s" + String (i)).getAddress());
+
+            expectEquals (pool.size(), 2002);
+
+            bool allMatch = true;
+
+            for (int i = 0; i < 2000; ++i)
+                allMatch = allMatch && pooled[i] == pool.getPooledString ("s" + String (i)).getAddress();
+
+            expect (allMatch);
+        }
+
+        beginTest ("Multiple threads");
+
+        {
+            StringPool pool;
+            OwnedArray<LookupThread> threads;
+
+            for (int i = 0; i < 4; ++i)
+                threads.add (new LookupThread (pool, i * 700));
+
+            for (int i = 0; i < threads.size(); ++i)
+                threads.getUnchecked(i)->startThread();
+
+            int numMismatches = 0;
+
+            for (int i = 0; i < threads.size(); ++i)
+            {
+                threads.getUnchecked(i)->waitForThreadToExit (-1);
+                numMismatches += threads.getUnchecked(i)->numMismatches;
+            }
+
+            expectEquals (numMismatches, 0);
+            expectEquals (pool.size(), 3000);
+        }
+    }
+};
+
+static StringPoolTests stringPoolTests;
+
+#endif
@@ -31,6 +31,8 @@
 
 #include "juce_String.h"
 #include "../containers/juce_Array.h"
+#include "../containers/juce_OwnedArray.h"
+#include "../memory/juce_Atomic.h"
 
 
 //==============================================================================
@@ -43,6 +45,10 @@
     is returned every time a matching string is asked for. This means that it's trivial to
     compare two pooled strings for equality, as you can simply compare their pointers. It
     also cuts down on storage if you're using many copies of the same string.
+
+    The pool is thread-safe. Looking up a string that's already in the pool doesn't take
+    any locks, so many threads can do it at once - only adding a new string needs to
+    lock out other writers.
 */
 class JUCE_API  StringPool
 {
@@ -87,8 +93,19 @@ public:
     String::CharPointerType operator[] (int index) const noexcept;
 
 private:
+    //==============================================================================
+    struct Table;
+    friend class OwnedArray<Table>;
+
     Array <String> strings;
+    OwnedArray<Table> tables;
+    Atomic<Table*> currentTable;
     CriticalSection lock;
+
+    template <class CharPointer>
+    String::CharPointerType getPooledCharPointer (CharPointer);
+
+    JUCE_DECLARE_NON_COPYABLE (StringPool)
 };
 
 
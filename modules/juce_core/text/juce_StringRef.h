@@ -0,0 +1,129 @@
+/*
+  ==============================================================================
+
+   This file is part of the juce_core module of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission to use, copy, modify, and/or distribute this software for any purpose with
+   or without fee is hereby granted, provided that the above copyright notice and this
+   permission notice appear in all copies.
+
+   THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+   TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+   NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+   DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+   IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+   ------------------------------------------------------------------------------
+
+   NOTE! This permissive ISC license applies ONLY to files within the juce_core module!
+   All other JUCE modules are covered by a dual GPL/commercial license, so if you are
+   using any other modules, be sure to check that you also comply with their license.
+
+   For more details, visit www.juce.com
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_STRINGREF_JUCEHEADER__
+#define __JUCE_STRINGREF_JUCEHEADER__
+
+#include "juce_String.h"
+
+
+//==============================================================================
+/**
+    A simple class for holding temporary references to a string literal or String.
+
+    Unlike a real String object, the StringRef does not allocate any memory or
+    take ownership of the strings you give to it - it simply holds a reference to
+    a string that has been allocated elsewhere.
+
+    The main purpose of the class is to be used instead of a const String& as the type
+    of function arguments where the caller may pass either a string literal or a String
+    object. This means that when the caller uses a string literal, the compiler doesn't
+    need to create a temporary String object, which would involve a heap allocation
+    and a string copy.
+
+    Because it doesn't own the string it refers to, you must make sure that the
+    original string stays in existence while the StringRef is being used - so it
+    should only really be used for function parameters and short-lived local
+    variables, and never kept as a member of a class.
+
+    Literal strings must be UTF-8 (or plain ASCII), as with the String class.
+
+    @see String
+*/
+class JUCE_API  StringRef
+{
+public:
+    /** Creates a StringRef from a raw string literal.
+        The StringRef object doesn't take ownership or copy the data, so you must
+        ensure that the data does not change during the lifetime of the StringRef.
+        Note that this pointer must not be null!
+    */
+    StringRef (const char* const stringLiteral) noexcept
+        : text (stringLiteral)
+    {
+        jassert (stringLiteral != nullptr); // This must be a valid string literal, not a null pointer!!
+
+        // If this assertion gets hit, the string contains non-ascii characters that haven't
+        // been correctly encoded as UTF-8 - see the notes about this in the String class.
+        jassert (CharPointer_UTF8::isValidString (stringLiteral, std::numeric_limits<int>::max()));
+    }
+
+    /** Creates a StringRef from a raw char pointer.
+        The StringRef object doesn't take ownership or copy the data, so you must
+        ensure that the data does not change during the lifetime of the StringRef.
+    */
+    StringRef (const String::CharPointerType stringLiteral) noexcept
+        : text (stringLiteral)
+    {
+        jassert (stringLiteral.getAddress() != nullptr); // This must be a valid string literal, not a null pointer!!
+    }
+
+    /** Creates a StringRef that refers to the contents of a String. */
+    StringRef (const String& string) noexcept
+        : text (string.getCharPointer())
+    {
+    }
+
+    //==============================================================================
+    /** Returns a raw pointer to the underlying string data. */
+    operator const String::CharPointerType::CharType*() const noexcept   { return text.getAddress(); }
+
+    /** Returns a pointer to the underlying string data as a char pointer object. */
+    operator String::CharPointerType() const noexcept                    { return text; }
+
+    /** Returns true if the string is empty. */
+    bool isEmpty() const noexcept                                           { return text.isEmpty(); }
+    /** Returns true if the string is not empty. */
+    bool isNotEmpty() const noexcept                                        { return ! text.isEmpty(); }
+    /** Returns the number of characters in the string. */
+    int length() const noexcept                                             { return (int) text.length(); }
+
+    /** Retrieves a character by index. */
+    juce_wchar operator[] (int index) const noexcept                        { return text[index]; }
+
+    /** Compares this StringRef with a String. */
+    bool operator== (const String& s) const noexcept                        { return text.compare (s.getCharPointer()) == 0; }
+    /** Compares this StringRef with a String. */
+    bool operator!= (const String& s) const noexcept                        { return text.compare (s.getCharPointer()) != 0; }
+
+    /** Case-insensitive comparison with a String. */
+    bool equalsIgnoreCase (const String& s) const noexcept                  { return text.compareIgnoreCase (s.getCharPointer()) == 0; }
+
+    //==============================================================================
+    /** The text that is referenced. */
+    String::CharPointerType text;
+};
+
+//==============================================================================
+/** Case-sensitive comparison of two strings. */
+inline bool operator== (const String& string1, StringRef string2) noexcept     { return string1.getCharPointer().compare (string2.text) == 0; }
+/** Case-sensitive comparison of two strings. */
+inline bool operator!= (const String& string1, StringRef string2) noexcept     { return string1.getCharPointer().compare (string2.text) != 0; }
+
+
+#endif   // __JUCE_STRINGREF_JUCEHEADER__
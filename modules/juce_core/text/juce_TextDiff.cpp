@@ -151,11 +151,402 @@ struct TextDiffHelpers
         indexInB -= bestLength - 1;
         return bestLength;
     }
+
+    //==============================================================================
+    /*  Myers' O(ND) diff, using the linear-space "middle snake" bisection. The sink is sent
+        a sequence of equal(), remove() and insert() calls, each with a number of items.
+    */
+    template <class Sink>
+    static void myersDiff (const int* a, int lenA, const int* b, int lenB, Sink& sink)
+    {
+        int prefix = 0;
+        while (prefix < lenA && prefix < lenB && a[prefix] == b[prefix])
+            ++prefix;
+
+        if (prefix > 0)
+        {
+            sink.equal (prefix);
+            a += prefix;    lenA -= prefix;
+            b += prefix;    lenB -= prefix;
+        }
+
+        int suffix = 0;
+        while (suffix < lenA && suffix < lenB && a[lenA - 1 - suffix] == b[lenB - 1 - suffix])
+            ++suffix;
+
+        lenA -= suffix;
+        lenB -= suffix;
+
+        if (lenA == 0)
+        {
+            if (lenB > 0)
+                sink.insert (lenB);
+        }
+        else if (lenB == 0)
+        {
+            sink.remove (lenA);
+        }
+        else
+        {
+            myersBisect (a, lenA, b, lenB, sink);
+        }
+
+        if (suffix > 0)
+            sink.equal (suffix);
+    }
+
+    template <class Sink>
+    static void myersBisect (const int* a, const int lenA, const int* b, const int lenB, Sink& sink)
+    {
+        const int maxD = (lenA + lenB + 1) / 2;
+        const int vOffset = maxD;
+        const int vLength = 2 * maxD + 2;
+
+        HeapBlock<int> vectors ((size_t) vLength * 2);
+        int* const v1 = vectors;
+        int* const v2 = vectors + vLength;
+
+        for (int i = 0; i < vLength * 2; ++i)
+            vectors[i] = -1;
+
+        v1[vOffset + 1] = 0;
+        v2[vOffset + 1] = 0;
+
+        const int delta = lenA - lenB;
+        const bool front = (delta & 1) != 0;   // if the delta is odd, the forward path will collide with the reverse one
+        int k1start = 0, k1end = 0, k2start = 0, k2end = 0;
+
+        for (int d = 0; d < maxD; ++d)
+        {
+            for (int k1 = -d + k1start; k1 <= d - k1end; k1 += 2)
+            {
+                const int k1Offset = vOffset + k1;
+                int x1 = (k1 == -d || (k1 != d && v1[k1Offset - 1] < v1[k1Offset + 1]))
+                            ? v1[k1Offset + 1] : v1[k1Offset - 1] + 1;
+                int y1 = x1 - k1;
+
+                while (x1 < lenA && y1 < lenB && a[x1] == b[y1])
+                {
+                    ++x1;
+                    ++y1;
+                }
+
+                v1[k1Offset] = x1;
+
+                if (x1 > lenA)
+                {
+                    k1end += 2;
+                }
+                else if (y1 > lenB)
+                {
+                    k1start += 2;
+                }
+                else if (front)
+                {
+                    const int k2Offset = vOffset + delta - k1;
+
+                    if (isPositiveAndBelow (k2Offset, vLength) && v2[k2Offset] != -1
+                         && x1 >= lenA - v2[k2Offset])
+                    {
+                        myersSplit (a, lenA, b, lenB, x1, y1, sink);
+                        return;
+                    }
+                }
+            }
+
+            for (int k2 = -d + k2start; k2 <= d - k2end; k2 += 2)
+            {
+                const int k2Offset = vOffset + k2;
+                int x2 = (k2 == -d || (k2 != d && v2[k2Offset - 1] < v2[k2Offset + 1]))
+                            ? v2[k2Offset + 1] : v2[k2Offset - 1] + 1;
+                int y2 = x2 - k2;
+
+                while (x2 < lenA && y2 < lenB && a[lenA - x2 - 1] == b[lenB - y2 - 1])
+                {
+                    ++x2;
+                    ++y2;
+                }
+
+                v2[k2Offset] = x2;
+
+                if (x2 > lenA)
+                {
+                    k2end += 2;
+                }
+                else if (y2 > lenB)
+                {
+                    k2start += 2;
+                }
+                else if (! front)
+                {
+                    const int k1Offset = vOffset + delta - k2;
+
+                    if (isPositiveAndBelow (k1Offset, vLength) && v1[k1Offset] != -1)
+                    {
+                        const int x1 = v1[k1Offset];
+
+                        if (x1 >= lenA - x2)
+                        {
+                            myersSplit (a, lenA, b, lenB, x1, vOffset + x1 - k1Offset, sink);
+                            return;
+                        }
+                    }
+                }
+            }
+        }
+
+        // (this can only happen if there's nothing in common at all)
+        sink.remove (lenA);
+        sink.insert (lenB);
+    }
+
+    template <class Sink>
+    static void myersSplit (const int* a, int lenA, const int* b, int lenB, int x, int y, Sink& sink)
+    {
+        myersDiff (a, x, b, y, sink);
+        myersDiff (a + x, lenA - x, b + y, lenB - y, sink);
+    }
+
+    //==============================================================================
+    // Turns a sequence of character edits into TextDiff::Change objects, merging adjacent ones.
+    struct ChangeBuilder
+    {
+        ChangeBuilder (TextDiff& td_, const String& target) noexcept
+            : td (td_), targetText (target.getCharPointer()), targetIndex (0) {}
+
+        void equal (const int num) noexcept
+        {
+            targetText += num;
+            targetIndex += num;
+        }
+
+        void remove (const int num)
+        {
+            if (TextDiff::Change* const last = getLastChange())
+            {
+                if (last->isDeletion() && last->start == targetIndex)
+                {
+                    last->length += num;
+                    return;
+                }
+            }
+
+            addDeletion (td, targetIndex, num);
+        }
+
+        void insert (const int num)
+        {
+            const String::CharPointerType text (targetText);
+            targetText += num;
+
+            TextDiff::Change* const last = getLastChange();
+
+            if (last != nullptr && ! last->isDeletion() && last->start + last->length == targetIndex)
+            {
+                last->insertedText += String (text, (size_t) num);
+                last->length += num;
+            }
+            else
+            {
+                addInsertion (td, text, targetIndex, num);
+            }
+
+            targetIndex += num;
+        }
+
+    private:
+        TextDiff& td;
+        String::CharPointerType targetText;
+        int targetIndex;
+
+        TextDiff::Change* getLastChange() const noexcept
+        {
+            return td.changes.size() > 0 ? &td.changes.getReference (td.changes.size() - 1) : nullptr;
+        }
+
+        JUCE_DECLARE_NON_COPYABLE (ChangeBuilder)
+    };
+
+    //==============================================================================
+    struct CharacterArray
+    {
+        CharacterArray (const String& s)
+            : length (s.length())
+        {
+            chars.malloc ((size_t) length + 1);
+
+            String::CharPointerType t (s.getCharPointer());
+
+            for (int i = 0; i < length; ++i)
+                chars[i] = (int) t.getAndAdvance();
+
+            lineStarts.add (0);
+
+            for (int i = 0; i < length; ++i)
+                if (chars[i] == '\n')
+                    lineStarts.add (i + 1);
+
+            if (lineStarts.getLast() != length)
+                lineStarts.add (length);
+        }
+
+        int getNumLines() const noexcept                    { return lineStarts.size() - 1; }
+        int getLineStart (const int line) const noexcept    { return lineStarts.getUnchecked (line); }
+        int getLineLength (const int line) const noexcept   { return getLineStart (line + 1) - getLineStart (line); }
+
+        HeapBlock<int> chars;
+        Array<int> lineStarts;
+        const int length;
+    };
+
+    // Gives each distinct line a unique ID, so that lines can be compared with a single int comparison
+    struct LineIdentifier
+    {
+        LineIdentifier (const int maxNumLines)  : numIDs (0)
+        {
+            idsForHashes.ensureStorageAllocated (maxNumLines);
+        }
+
+        void createIDs (const CharacterArray& text, HeapBlock<int>& ids)
+        {
+            ids.malloc ((size_t) text.getNumLines() + 1);
+
+            for (int i = 0; i < text.getNumLines(); ++i)
+                ids[i] = getID (text.chars + text.getLineStart (i), text.getLineLength (i));
+        }
+
+    private:
+        struct LineRef
+        {
+            const int* text;
+            int length;
+        };
+
+        FlatHashMap<int64, int> idsForHashes;
+        Array<LineRef> firstLinesWithIDs;
+        int numIDs;
+
+        int getID (const int* const text, const int length)
+        {
+            uint64 hash = (((uint64) 0xcbf29ce4) << 32) | 0x84222325; // FNV-1a
+
+            for (int i = 0; i < length; ++i)
+                hash = (hash ^ (uint32) text[i]) * ((((uint64) 0x100) << 32) | 0x1b3);
+
+            if (const int* const existing = idsForHashes.getPointer ((int64) hash))
+            {
+                const LineRef& ref = firstLinesWithIDs.getReference (*existing);
+
+                if (ref.length == length && memcmp (ref.text, text, sizeof (int) * (size_t) length) == 0)
+                    return *existing;
+
+                // A hash collision: this line just gets an ID of its own that nothing else will share.
+                return addLine (text, length);
+            }
+
+            const int newID = addLine (text, length);
+            idsForHashes.set ((int64) hash, newID);
+            return newID;
+        }
+
+        int addLine (const int* const text, const int length)
+        {
+            const LineRef ref = { text, length };
+            firstLinesWithIDs.add (ref);
+            return numIDs++;
+        }
+
+        JUCE_DECLARE_NON_COPYABLE (LineIdentifier)
+    };
+
+    // Receives the line-by-line edits, and diffs the characters of each block of changed lines.
+    struct LineChangeBuilder
+    {
+        LineChangeBuilder (ChangeBuilder& c, const CharacterArray& a, const CharacterArray& b) noexcept
+            : changes (c), textA (a), textB (b), lineA (0), lineB (0), numRemoved (0), numInserted (0)
+        {}
+
+        void equal (const int numLines)
+        {
+            flush();
+            changes.equal (textA.getLineStart (lineA + numLines) - textA.getLineStart (lineA));
+            lineA += numLines;
+            lineB += numLines;
+        }
+
+        void remove (const int numLines) noexcept    { numRemoved  += numLines; }
+        void insert (const int numLines) noexcept    { numInserted += numLines; }
+
+        void flush()
+        {
+            if (numRemoved == numInserted)
+            {
+                // When a block of lines has been replaced by the same number of lines, diffing
+                // them in pairs keeps the cost down if every line has been changed a bit.
+                for (; numRemoved > 0; --numRemoved, --numInserted)
+                    diffLines (1, 1);
+            }
+            else
+            {
+                diffLines (numRemoved, numInserted);
+                numRemoved = numInserted = 0;
+            }
+        }
+
+    private:
+        ChangeBuilder& changes;
+        const CharacterArray& textA;
+        const CharacterArray& textB;
+        int lineA, lineB, numRemoved, numInserted;
+
+        void diffLines (const int numLinesA, const int numLinesB)
+        {
+            const int startA = textA.getLineStart (lineA);
+            const int startB = textB.getLineStart (lineB);
+
+            myersDiff (textA.chars + startA, textA.getLineStart (lineA + numLinesA) - startA,
+                       textB.chars + startB, textB.getLineStart (lineB + numLinesB) - startB,
+                       changes);
+
+            lineA += numLinesA;
+            lineB += numLinesB;
+        }
+
+        JUCE_DECLARE_NON_COPYABLE (LineChangeBuilder)
+    };
+
+    static void diffWithMyers (TextDiff& td, const String& original, const String& target, const bool compareLinesFirst)
+    {
+        const CharacterArray a (original), b (target);
+        ChangeBuilder changes (td, target);
+
+        if (compareLinesFirst)
+        {
+            HeapBlock<int> linesA, linesB;
+
+            {
+                LineIdentifier lines (a.getNumLines() + b.getNumLines());
+                lines.createIDs (a, linesA);
+                lines.createIDs (b, linesB);
+            }
+
+            LineChangeBuilder lineChanges (changes, a, b);
+            myersDiff (linesA.getData(), a.getNumLines(), linesB.getData(), b.getNumLines(), lineChanges);
+            lineChanges.flush();
+        }
+        else
+        {
+            myersDiff (a.chars.getData(), a.length, b.chars.getData(), b.length, changes);
+        }
+    }
 };
 
-TextDiff::TextDiff (const String& original, const String& target)
+TextDiff::TextDiff (const String& original, const String& target, const Algorithm algorithmToUse)
 {
-    TextDiffHelpers::diffSkippingCommonStart (*this, original, target);
+    if (algorithmToUse == longestCommonSubstring)
+        TextDiffHelpers::diffSkippingCommonStart (*this, original, target);
+    else
+        TextDiffHelpers::diffWithMyers (*this, original, target, algorithmToUse == myersByLine);
 }
 
 String TextDiff::appliedTo (String text) const
@@ -208,11 +599,31 @@ public:
         return CharPointer_UTF32 (buffer);
     }
 
+    static String createMultiLineString (Random& r, const StringArray& lines)
+    {
+        String s;
+
+        for (int i = r.nextInt (40); --i >= 0;)
+            s << lines [r.nextInt (lines.size())] << (r.nextInt (4) == 0 ? "\r\n" : "\n");
+
+        return s;
+    }
+
     void testDiff (const String& a, const String& b)
     {
-        TextDiff diff (a, b);
-        const String result (diff.appliedTo (a));
-        expectEquals (result, b);
+        expectEquals (TextDiff (a, b).appliedTo (a), b);
+        expectEquals (TextDiff (a, b, TextDiff::myers).appliedTo (a), b);
+        expectEquals (TextDiff (a, b, TextDiff::myersByLine).appliedTo (a), b);
+    }
+
+    static int getNumChangedCharacters (const TextDiff& diff)
+    {
+        int num = 0;
+
+        for (int i = 0; i < diff.changes.size(); ++i)
+            num += diff.changes.getReference (i).length;
+
+        return num;
     }
 
     void runTest()
@@ -233,6 +644,30 @@ public:
             testDiff (s, createString());
             testDiff (s + createString(), s + createString());
         }
+
+        beginTest ("Myers");
+
+        {
+            // Myers finds a minimal edit, which the longest-common-substring search doesn't guarantee
+            expectEquals (getNumChangedCharacters (TextDiff ("abcabba", "cbabac", TextDiff::myers)), 5);
+            expectEquals (getNumChangedCharacters (TextDiff ("xaxbxc", "abc", TextDiff::myers)), 3);
+
+            Random r;
+            StringArray lines;
+            lines.add (String::empty);
+            lines.add ("foo");
+            lines.add ("bar");
+            lines.add ("    if (x != nullptr)");
+            lines.add (String (CharPointer_UTF8 ("\xc2\xa9 \xe2\x82\xac")));
+
+            for (int i = 2000; --i >= 0;)
+            {
+                const String s (createMultiLineString (r, lines));
+                testDiff (s, createMultiLineString (r, lines));
+                testDiff (s, s + createMultiLineString (r, lines));
+                testDiff (s + createString(), createString() + s);
+            }
+        }
     }
 };
 
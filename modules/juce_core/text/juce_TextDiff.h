@@ -41,9 +41,34 @@
 class JUCE_API TextDiff
 {
 public:
+    /** The methods that can be used to find the differences between two strings. */
+    enum Algorithm
+    {
+        /** Recursively searches for the longest common substring of the two strings.
+            This tends to keep long runs of text intact, but its time is proportional
+            to the product of the strings' lengths, so it's only suitable for short strings.
+        */
+        longestCommonSubstring,
+
+        /** Uses Myers' O(ND) algorithm to find a minimal set of character insertions and
+            deletions. It takes time proportional to the length of the strings multiplied by
+            the number of differences, and only needs a linear amount of memory.
+        */
+        myers,
+
+        /** Compares the strings line-by-line first, using a hash of each line, and then
+            uses Myers' algorithm to compare the characters within any blocks of lines that
+            differ (line-by-line, if a block has been replaced by the same number of lines).
+            The result may not be quite minimal, but this is the fastest choice for large texts
+            which are mostly the same, e.g. two versions of a source file.
+        */
+        myersByLine
+    };
+
     /** Creates a set of diffs for converting the original string into the target. */
     TextDiff (const String& original,
-              const String& target);
+              const String& target,
+              Algorithm algorithmToUse = longestCommonSubstring);
 
     /** Applies this sequence of changes to the original string, producing the
         target string that was specified when generating them.
@@ -0,0 +1,263 @@
+/*
+  ==============================================================================
+
+   This file is part of the juce_core module of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission to use, copy, modify, and/or distribute this software for any purpose with
+   or without fee is hereby granted, provided that the above copyright notice and this
+   permission notice appear in all copies.
+
+   THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+   TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+   NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+   DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+   IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+   ------------------------------------------------------------------------------
+
+   NOTE! This permissive ISC license applies ONLY to files within the juce_core module!
+   All other JUCE modules are covered by a dual GPL/commercial license, so if you are
+   using any other modules, be sure to check that you also comply with their license.
+
+   For more details, visit www.juce.com
+
+  ==============================================================================
+*/
+
+namespace AdaptiveCriticalSectionHelpers
+{
+    static inline void pauseWhileSpinning() noexcept
+    {
+       #if JUCE_INTEL && JUCE_GCC
+        __asm__ __volatile__ ("pause");
+       #elif JUCE_MSVC
+        YieldProcessor();
+       #endif
+    }
+}
+
+AdaptiveCriticalSection::AdaptiveCriticalSection (const bool shouldCollectStatistics) noexcept
+    : owner (nullptr), recursionCount (0), spinCount (0),
+      maxSpinCount (SystemStats::getNumCpus() > 1 ? 200 : 0),
+      collectStatistics (shouldCollectStatistics)
+{
+}
+
+AdaptiveCriticalSection::~AdaptiveCriticalSection() noexcept
+{
+    jassert (state.value == unlocked); // deleting a lock that's still held!
+}
+
+//==============================================================================
+void AdaptiveCriticalSection::enter() const noexcept
+{
+    void* const thisThread = Thread::getCurrentThreadId();
+
+    if (owner == thisThread)
+    {
+        ++recursionCount;
+        return;
+    }
+
+    if (! state.compareAndSetBool (locked, unlocked))
+        enterContended();
+
+    owner = thisThread;
+    recursionCount = 1;
+
+    if (collectStatistics)
+        ++numLocks;
+}
+
+bool AdaptiveCriticalSection::tryEnter() const noexcept
+{
+    void* const thisThread = Thread::getCurrentThreadId();
+
+    if (owner == thisThread)
+    {
+        ++recursionCount;
+        return true;
+    }
+
+    if (! state.compareAndSetBool (locked, unlocked))
+        return false;
+
+    owner = thisThread;
+    recursionCount = 1;
+
+    if (collectStatistics)
+        ++numLocks;
+
+    return true;
+}
+
+void AdaptiveCriticalSection::exit() const noexcept
+{
+    jassert (owner == Thread::getCurrentThreadId()); // releasing a lock that this thread doesn't hold!
+
+    if (--recursionCount > 0)
+        return;
+
+    owner = nullptr;
+
+    if (state.exchange (unlocked) == lockedWithWaiters)
+        AddressWaiter::wake (&state.value, 1);
+}
+
+void AdaptiveCriticalSection::enterContended() const noexcept
+{
+    const int64 startTicks = collectStatistics ? Time::getHighResolutionTicks() : 0;
+    bool acquired = false;
+
+    if (collectStatistics)
+        ++numContendedLocks;
+
+    if (maxSpinCount > 0)
+    {
+        // spin for up to about twice as long as it has recently taken for the lock to become free
+        const int spinLimit = jmin (maxSpinCount, spinCount * 2 + 10);
+
+        for (int i = 0; i < spinLimit; ++i)
+        {
+            AdaptiveCriticalSectionHelpers::pauseWhileSpinning();
+
+            if (state.value == unlocked && state.compareAndSetBool (locked, unlocked))
+            {
+                spinCount += (i - spinCount) / 8;
+                acquired = true;
+                break;
+            }
+        }
+
+        if (! acquired)
+            spinCount += (spinLimit - spinCount) / 8;
+    }
+
+    if (! acquired)
+    {
+        // Marking the lock as having waiters means that whoever releases it will wake one
+        // of them up. A thread that gets the lock this way can't know whether there are
+        // other waiters, so it leaves the mark in place, costing at most one spare wake-up.
+        while (state.exchange (lockedWithWaiters) != unlocked)
+        {
+            if (collectStatistics)
+                ++numSleeps;
+
+            AddressWaiter::wait (&state.value, lockedWithWaiters, -1);
+        }
+    }
+
+    if (collectStatistics)
+        totalWaitTicks += Time::getHighResolutionTicks() - startTicks;
+}
+
+//==============================================================================
+AdaptiveCriticalSection::Statistics::Statistics() noexcept
+    : numLocks (0), numContendedLocks (0), numSleeps (0), totalWaitTime (0)
+{
+}
+
+void AdaptiveCriticalSection::setCollectsStatistics (const bool shouldCollect) noexcept
+{
+    collectStatistics = shouldCollect;
+}
+
+AdaptiveCriticalSection::Statistics AdaptiveCriticalSection::getStatistics() const noexcept
+{
+    Statistics s;
+    s.numLocks          = numLocks.value;
+    s.numContendedLocks = numContendedLocks.value;
+    s.numSleeps         = numSleeps.value;
+    s.totalWaitTime     = Time::highResolutionTicksToSeconds (totalWaitTicks.value);
+    return s;
+}
+
+void AdaptiveCriticalSection::resetStatistics() noexcept
+{
+    numLocks = 0;
+    numContendedLocks = 0;
+    numSleeps = 0;
+    totalWaitTicks = 0;
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class AdaptiveCriticalSectionTests  : public UnitTest
+{
+public:
+    AdaptiveCriticalSectionTests() : UnitTest ("AdaptiveCriticalSection") {}
+
+    struct IncrementerThread  : public Thread
+    {
+        IncrementerThread (AdaptiveCriticalSection& lock_, int& counter_)
+            : Thread ("incrementer"), lock (lock_), counter (counter_)
+        {}
+
+        void run()
+        {
+            for (int i = 0; i < numIterations; ++i)
+            {
+                const AdaptiveCriticalSection::ScopedLockType sl1 (lock);
+                const AdaptiveCriticalSection::ScopedLockType sl2 (lock);  // re-entrant
+                ++counter;
+
+                if ((i & 255) == 0)
+                    Thread::yield();  // encourage some contention
+            }
+        }
+
+        enum { numIterations = 20000 };
+        AdaptiveCriticalSection& lock;
+        int& counter;
+    };
+
+    void runTest()
+    {
+        beginTest ("Basics");
+
+        {
+            AdaptiveCriticalSection lock (true);
+            lock.enter();
+            expect (lock.tryEnter());
+            lock.exit();
+            lock.exit();
+
+            const AdaptiveCriticalSection::Statistics stats (lock.getStatistics());
+            expectEquals (stats.numLocks, 1);
+            expectEquals (stats.numContendedLocks, 0);
+
+            lock.resetStatistics();
+            expectEquals (lock.getStatistics().numLocks, 0);
+        }
+
+        beginTest ("Mutual exclusion");
+
+        {
+            AdaptiveCriticalSection lock (true);
+            int counter = 0;
+
+            OwnedArray<IncrementerThread> threads;
+
+            for (int i = 0; i < 4; ++i)
+                threads.add (new IncrementerThread (lock, counter));
+
+            for (int i = 0; i < threads.size(); ++i)
+                threads.getUnchecked(i)->startThread();
+
+            for (int i = 0; i < threads.size(); ++i)
+                threads.getUnchecked(i)->waitForThreadToExit (20000);
+
+            expectEquals (counter, 4 * (int) IncrementerThread::numIterations);
+            expectEquals (lock.getStatistics().numLocks, 4 * (int) IncrementerThread::numIterations);
+            expect (lock.tryEnter());
+            lock.exit();
+        }
+    }
+};
+
+static AdaptiveCriticalSectionTests adaptiveCriticalSectionTests;
+
+#endif
@@ -0,0 +1,148 @@
+/*
+  ==============================================================================
+
+   This file is part of the juce_core module of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission to use, copy, modify, and/or distribute this software for any purpose with
+   or without fee is hereby granted, provided that the above copyright notice and this
+   permission notice appear in all copies.
+
+   THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+   TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+   NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+   DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+   IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+   ------------------------------------------------------------------------------
+
+   NOTE! This permissive ISC license applies ONLY to files within the juce_core module!
+   All other JUCE modules are covered by a dual GPL/commercial license, so if you are
+   using any other modules, be sure to check that you also comply with their license.
+
+   For more details, visit www.juce.com
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_ADAPTIVECRITICALSECTION_JUCEHEADER__
+#define __JUCE_ADAPTIVECRITICALSECTION_JUCEHEADER__
+
+#include "juce_ScopedLock.h"
+#include "../memory/juce_Atomic.h"
+
+
+//==============================================================================
+/**
+    A re-entrant mutex which spins for a while before putting a waiting thread
+    to sleep.
+
+    This can be used anywhere that a CriticalSection is used. Locking and unlocking
+    an uncontended AdaptiveCriticalSection never makes a system call, and when the
+    lock is held by another thread, the caller first spins for a number of
+    iterations which adapts to how long the lock has recently been held for, so
+    that short critical sections don't pay the cost of sleeping and waking up.
+    (On a single-core machine it never spins, because that can't help).
+
+    Unlike a CriticalSection, it doesn't use priority inheritance, so be wary of
+    sharing one between a high-priority thread and low-priority threads.
+
+    It can optionally keep count of how often it is contended, to help find the
+    locks that are causing trouble - see setCollectsStatistics().
+
+    @see CriticalSection, SpinLock
+*/
+class JUCE_API  AdaptiveCriticalSection
+{
+public:
+    //==============================================================================
+    /** Creates an AdaptiveCriticalSection.
+        @param collectStatistics    if true, the lock will keep count of how often it
+                                    is contended - see getStatistics()
+    */
+    explicit AdaptiveCriticalSection (bool collectStatistics = false) noexcept;
+
+    /** Destructor.
+        If the lock is deleted whilst it's held, any subsequent behaviour is unpredictable.
+    */
+    ~AdaptiveCriticalSection() noexcept;
+
+    //==============================================================================
+    /** Acquires the lock.
+        If the lock is already held by the caller thread, the method returns immediately.
+        @see CriticalSection::enter
+    */
+    void enter() const noexcept;
+
+    /** Attempts to lock without blocking.
+        @returns false if the lock is currently held by another thread, true otherwise.
+    */
+    bool tryEnter() const noexcept;
+
+    /** Releases the lock.
+        Each call to enter() or successful call to tryEnter() must be matched by a call
+        to exit().
+    */
+    void exit() const noexcept;
+
+    //==============================================================================
+    /** The counters kept by an AdaptiveCriticalSection when statistics are enabled. */
+    struct JUCE_API  Statistics
+    {
+        Statistics() noexcept;
+
+        /** The number of times the lock has been acquired (not counting re-entrant locks). */
+        int numLocks;
+
+        /** The number of times a thread found the lock already held by another thread. */
+        int numContendedLocks;
+
+        /** The number of times a thread had to go to sleep, after spinning didn't work. */
+        int numSleeps;
+
+        /** The total time, in seconds, that threads have spent waiting for the lock. */
+        double totalWaitTime;
+    };
+
+    /** Turns the contention counters on or off. */
+    void setCollectsStatistics (bool shouldCollect) noexcept;
+
+    /** Returns the counters that have been collected.
+        The fields are read separately while other threads may be updating them, so
+        treat the results as approximate.
+    */
+    Statistics getStatistics() const noexcept;
+
+    /** Clears the counters. */
+    void resetStatistics() noexcept;
+
+    //==============================================================================
+    /** Provides the type of scoped lock to use with an AdaptiveCriticalSection. */
+    typedef GenericScopedLock <AdaptiveCriticalSection>       ScopedLockType;
+
+    /** Provides the type of scoped unlocker to use with an AdaptiveCriticalSection. */
+    typedef GenericScopedUnlock <AdaptiveCriticalSection>     ScopedUnlockType;
+
+    /** Provides the type of scoped try-locker to use with an AdaptiveCriticalSection. */
+    typedef GenericScopedTryLock <AdaptiveCriticalSection>    ScopedTryLockType;
+
+private:
+    //==============================================================================
+    enum { unlocked = 0, locked = 1, lockedWithWaiters = 2 };
+
+    mutable Atomic<int32> state;
+    mutable void* volatile owner;
+    mutable int recursionCount, spinCount;
+    const int maxSpinCount;
+    bool collectStatistics;
+    mutable Atomic<int> numLocks, numContendedLocks, numSleeps;
+    mutable Atomic<int64> totalWaitTicks;
+
+    void enterContended() const noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE (AdaptiveCriticalSection)
+};
+
+
+#endif   // __JUCE_ADAPTIVECRITICALSECTION_JUCEHEADER__
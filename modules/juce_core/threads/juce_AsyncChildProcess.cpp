@@ -0,0 +1,230 @@
+/*
+  ==============================================================================
+
+   This file is part of the juce_core module of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission to use, copy, modify, and/or distribute this software for any purpose with
+   or without fee is hereby granted, provided that the above copyright notice and this
+   permission notice appear in all copies.
+
+   THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+   TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+   NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+   DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+   IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+   ------------------------------------------------------------------------------
+
+   NOTE! This permissive ISC license applies ONLY to files within the juce_core module!
+   All other JUCE modules are covered by a dual GPL/commercial license, so if you are
+   using any other modules, be sure to check that you also comply with their license.
+
+   For more details, visit www.juce.com
+
+  ==============================================================================
+*/
+void AsyncChildProcess::Listener::processErrorOutputReceived (AsyncChildProcess&, const void*, size_t) {}
+
+//==============================================================================
+AsyncChildProcess::AsyncChildProcess (Listener& l)  : listener (l) {}
+
+AsyncChildProcess::~AsyncChildProcess()
+{
+    detachProcess();
+}
+
+void AsyncChildProcess::detachProcess()
+{
+    if (activeProcess != nullptr)
+    {
+        ioThread->removeProcess (activeProcess);
+        activeProcess = nullptr;
+    }
+}
+
+bool AsyncChildProcess::start (const String& command)
+{
+    return start (StringArray::fromTokens (command, true));
+}
+
+bool AsyncChildProcess::start (const StringArray& args)
+{
+    detachProcess();
+
+    if (args.size() == 0)
+        return false;
+
+    ScopedPointer<ActiveProcess> newProcess (new ActiveProcess (*this, args));
+
+    if (newProcess->childPID == 0)
+        return false;
+
+    activeProcess = newProcess.release();
+    ioThread->addProcess (activeProcess);
+    return true;
+}
+
+bool AsyncChildProcess::isRunning() const
+{
+    return activeProcess != nullptr && activeProcess->isRunning();
+}
+
+int AsyncChildProcess::getExitCode() const
+{
+    return activeProcess != nullptr ? activeProcess->getExitCode() : -1;
+}
+
+bool AsyncChildProcess::waitForProcessToFinish (const int timeoutMs) const
+{
+    return activeProcess == nullptr || activeProcess->waitForProcessToFinish (timeoutMs);
+}
+
+bool AsyncChildProcess::kill()
+{
+    return activeProcess == nullptr || activeProcess->killProcess();
+}
+
+bool AsyncChildProcess::writeToStdIn (const void* const data, const size_t numBytes)
+{
+    return activeProcess != nullptr && activeProcess->writeToStdIn (data, numBytes);
+}
+
+void AsyncChildProcess::closeStdIn()
+{
+    if (activeProcess != nullptr)
+        activeProcess->closeStdIn();
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class AsyncChildProcessTests  : public UnitTest
+{
+public:
+    AsyncChildProcessTests() : UnitTest ("AsyncChildProcess") {}
+
+    struct OutputCollector  : public AsyncChildProcess::Listener
+    {
+        OutputCollector() : finishedCode (-2), numFinishedCallbacks (0) {}
+
+        void processOutputReceived (AsyncChildProcess&, const void* data, size_t numBytes)
+        {
+            output.write (data, numBytes);
+        }
+
+        void processErrorOutputReceived (AsyncChildProcess&, const void* data, size_t numBytes)
+        {
+            errorOutput.write (data, numBytes);
+        }
+
+        void processFinished (AsyncChildProcess&, int exitCode)
+        {
+            finishedCode = exitCode;
+            ++numFinishedCallbacks;
+        }
+
+        MemoryOutputStream output, errorOutput;
+        int finishedCode, numFinishedCallbacks;
+    };
+
+    static StringArray shellCommand (const String& script)
+    {
+        StringArray args;
+        args.add ("sh");
+        args.add ("-c");
+        args.add (script);
+        return args;
+    }
+
+    void runTest()
+    {
+      #if JUCE_MAC || JUCE_LINUX
+        beginTest ("Separate output streams and exit code");
+        {
+            OutputCollector collector;
+            AsyncChildProcess p (collector);
+
+            expect (p.start (shellCommand ("echo out; echo err 1>&2; exit 3")));
+            expect (p.waitForProcessToFinish (10000));
+            expect (! p.isRunning());
+            expectEquals (collector.output.toString(), String ("out\n"));
+            expectEquals (collector.errorOutput.toString(), String ("err\n"));
+            expectEquals (collector.finishedCode, 3);
+            expectEquals (collector.numFinishedCallbacks, 1);
+            expectEquals (p.getExitCode(), 3);
+        }
+
+        beginTest ("Writing to stdin");
+        {
+            OutputCollector collector;
+            AsyncChildProcess p (collector);
+
+            expect (p.start ("cat"));
+
+            String input;
+            for (int i = 0; i < 20000; ++i)
+                input << i << newLine;
+
+            expect (p.writeToStdIn (input.toRawUTF8(), input.getNumBytesAsUTF8()));
+            p.closeStdIn();
+            expect (! p.writeToStdIn ("x", 1));
+
+            expect (p.waitForProcessToFinish (10000));
+            expect (collector.output.toString() == input);
+            expectEquals (p.getExitCode(), 0);
+        }
+
+        beginTest ("Many processes");
+        {
+            OwnedArray<OutputCollector> collectors;
+            OwnedArray<AsyncChildProcess> processes;
+
+            for (int i = 0; i < 24; ++i)
+            {
+                OutputCollector* const collector = new OutputCollector();
+                collectors.add (collector);
+
+                AsyncChildProcess* const p = new AsyncChildProcess (*collector);
+                processes.add (p);
+                expect (p->start (shellCommand ("echo " + String (i) + "; exit " + String (i))));
+            }
+
+            for (int i = 0; i < processes.size(); ++i)
+            {
+                expect (processes.getUnchecked(i)->waitForProcessToFinish (10000));
+                expectEquals (collectors.getUnchecked(i)->output.toString(), String (i) + "\n");
+                expectEquals (collectors.getUnchecked(i)->finishedCode, i);
+            }
+        }
+
+        beginTest ("Killing");
+        {
+            OutputCollector collector;
+            AsyncChildProcess p (collector);
+
+            expect (p.start ("sleep 30"));
+            expect (p.isRunning());
+            expect (! p.waitForProcessToFinish (50));
+            expect (p.kill());
+            expect (p.waitForProcessToFinish (10000));
+            expectEquals (p.getExitCode(), -1);
+        }
+
+        beginTest ("Detaching a running process");
+        {
+            OutputCollector collector;
+            ScopedPointer<AsyncChildProcess> p (new AsyncChildProcess (collector));
+
+            expect (p->start ("sleep 1"));
+            p = nullptr;
+            expectEquals (collector.numFinishedCallbacks, 0);
+        }
+      #endif
+    }
+};
+
+static AsyncChildProcessTests asyncChildProcessUnitTests;
+
+#endif
@@ -0,0 +1,155 @@
+/*
+  ==============================================================================
+
+   This file is part of the juce_core module of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission to use, copy, modify, and/or distribute this software for any purpose with
+   or without fee is hereby granted, provided that the above copyright notice and this
+   permission notice appear in all copies.
+
+   THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+   TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+   NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+   DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+   IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+   ------------------------------------------------------------------------------
+
+   NOTE! This permissive ISC license applies ONLY to files within the juce_core module!
+   All other JUCE modules are covered by a dual GPL/commercial license, so if you are
+   using any other modules, be sure to check that you also comply with their license.
+
+   For more details, visit www.juce.com
+
+  ==============================================================================
+*/
+#ifndef __JUCE_ASYNCCHILDPROCESS_JUCEHEADER__
+#define __JUCE_ASYNCCHILDPROCESS_JUCEHEADER__
+
+
+//==============================================================================
+/**
+    Launches a child process, and delivers its output to a listener as it arrives.
+
+    Unlike ChildProcess, nothing here blocks: the process gets separate stdout and
+    stderr pipes, which are read by a single I/O thread that's shared by all the
+    AsyncChildProcess objects, so supervising dozens of processes doesn't need a
+    thread for each one. Data can be sent to the process's stdin with writeToStdIn(),
+    which queues it and returns immediately.
+
+    All the Listener callbacks are made on the shared I/O thread, so they need to be
+    quick, and mustn't delete the AsyncChildProcess that's calling them.
+
+    @see ChildProcess
+*/
+class JUCE_API  AsyncChildProcess
+{
+public:
+    //==============================================================================
+    /** Receives the output of an AsyncChildProcess.
+        The callbacks are all made on a shared background thread.
+    */
+    class JUCE_API  Listener
+    {
+    public:
+        /** Destructor. */
+        virtual ~Listener() {}
+
+        /** Called when the process has written some data to its stdout. */
+        virtual void processOutputReceived (AsyncChildProcess& process, const void* data, size_t numBytes) = 0;
+
+        /** Called when the process has written some data to its stderr.
+            By default this does nothing.
+        */
+        virtual void processErrorOutputReceived (AsyncChildProcess& process, const void* data, size_t numBytes);
+
+        /** Called once the process has exited, after all of its output has been delivered.
+            The exit code is the value the process returned, or -1 if it was killed.
+        */
+        virtual void processFinished (AsyncChildProcess& process, int exitCode) = 0;
+    };
+
+    //==============================================================================
+    /** Creates a process object, which will send its callbacks to the given listener.
+        To actually launch the process, use start().
+    */
+    explicit AsyncChildProcess (Listener& listener);
+
+    /** Destructor.
+        This stops any further callbacks and closes the process's pipes, but won't
+        terminate the process - call kill() first if you need to do that.
+    */
+    ~AsyncChildProcess();
+
+    //==============================================================================
+    /** Attempts to launch a child process command.
+
+        The command should be the name of the executable file, followed by any arguments
+        that are required. If a process has already been launched, it's detached (as if
+        this object had been deleted) and a new one is started.
+        Returns false if the process couldn't be launched.
+    */
+    bool start (const String& command);
+
+    /** Attempts to launch a child process command.
+
+        The first argument should be the name of the executable file, followed by any other
+        arguments that are needed. If a process has already been launched, it's detached (as
+        if this object had been deleted) and a new one is started.
+        Returns false if the process couldn't be launched.
+    */
+    bool start (const StringArray& arguments);
+
+    /** Returns true if the process has been started and hasn't yet finished.
+        This becomes false just before the listener's processFinished() callback.
+    */
+    bool isRunning() const;
+
+    /** Returns the process's exit code, or -1 if it hasn't finished, or was killed. */
+    int getExitCode() const;
+
+    /** Blocks until the process has finished and its processFinished() callback has been made.
+        Returns false if it timed out. A negative timeout waits forever.
+    */
+    bool waitForProcessToFinish (int timeoutMs) const;
+
+    /** Attempts to kill the child process.
+        Returns true if it succeeded. The listener's processFinished() callback will still be
+        made once the I/O thread notices that the process has gone.
+    */
+    bool kill();
+
+    //==============================================================================
+    /** Queues some data to be written to the process's stdin.
+        This never blocks - the data is copied and written by the I/O thread as quickly
+        as the process reads it. Returns false if the process isn't running, or its stdin
+        has been closed.
+    */
+    bool writeToStdIn (const void* data, size_t numBytes);
+
+    /** Closes the process's stdin, once any data that's been queued has been written.
+        Many programs wait for this before they finish.
+    */
+    void closeStdIn();
+
+private:
+    //==============================================================================
+    class ActiveProcess;
+    class IOThread;
+    friend class ActiveProcess;
+    friend class IOThread;
+    friend class ScopedPointer<ActiveProcess>;
+
+    Listener& listener;
+    SharedResourcePointer<IOThread> ioThread;
+    ScopedPointer<ActiveProcess> activeProcess;
+
+    void detachProcess();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AsyncChildProcess)
+};
+
+
+#endif   // __JUCE_ASYNCCHILDPROCESS_JUCEHEADER__
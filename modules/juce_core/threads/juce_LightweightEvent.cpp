@@ -0,0 +1,229 @@
+/*
+  ==============================================================================
+
+   This file is part of the juce_core module of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission to use, copy, modify, and/or distribute this software for any purpose with
+   or without fee is hereby granted, provided that the above copyright notice and this
+   permission notice appear in all copies.
+
+   THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+   TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+   NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+   DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+   IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+   ------------------------------------------------------------------------------
+
+   NOTE! This permissive ISC license applies ONLY to files within the juce_core module!
+   All other JUCE modules are covered by a dual GPL/commercial license, so if you are
+   using any other modules, be sure to check that you also comply with their license.
+
+   For more details, visit www.juce.com
+
+  ==============================================================================
+*/
+
+LightweightSemaphore::LightweightSemaphore (const int initialCount) noexcept
+    : count (initialCount)
+{
+    jassert (initialCount >= 0);
+}
+
+LightweightSemaphore::~LightweightSemaphore() noexcept
+{
+    jassert (numWaiters.value == 0); // deleting a semaphore while threads are still waiting on it!
+}
+
+bool LightweightSemaphore::tryWait() noexcept
+{
+    for (;;)
+    {
+        const int32 c = count.value;
+
+        if (c <= 0)
+            return false;
+
+        if (count.compareAndSetBool (c - 1, c))
+            return true;
+    }
+}
+
+bool LightweightSemaphore::wait (const int timeOutMilliseconds) noexcept
+{
+    const uint32 startTime = timeOutMilliseconds > 0 ? Time::getMillisecondCounter() : 0;
+
+    for (;;)
+    {
+        if (tryWait())
+            return true;
+
+        int timeToWait = timeOutMilliseconds;
+
+        if (timeOutMilliseconds >= 0)
+        {
+            timeToWait -= (int) (Time::getMillisecondCounter() - startTime);
+
+            if (timeToWait <= 0 || timeOutMilliseconds == 0)
+                return false;
+        }
+
+        // the waiter count must be raised before the count is re-checked by the kernel, so
+        // that signal() is guaranteed to see either the waiter or its own increment..
+        ++numWaiters;
+        AddressWaiter::wait (&count.value, 0, timeToWait);
+        --numWaiters;
+    }
+}
+
+void LightweightSemaphore::signal (const int amountToAdd) noexcept
+{
+    jassert (amountToAdd > 0);
+    count += amountToAdd;
+
+    if (numWaiters.value > 0)
+        AddressWaiter::wake (&count.value, amountToAdd);
+}
+
+//==============================================================================
+LightweightEvent::LightweightEvent (const bool useManualReset) noexcept
+    : manualReset (useManualReset)
+{
+}
+
+LightweightEvent::~LightweightEvent() noexcept
+{
+    jassert (numWaiters.value == 0); // deleting an event while threads are still waiting on it!
+}
+
+bool LightweightEvent::tryToConsumeSignal() const noexcept
+{
+    return manualReset ? (state.value != 0)
+                       : state.compareAndSetBool (0, 1);
+}
+
+bool LightweightEvent::wait (const int timeOutMilliseconds) const noexcept
+{
+    const uint32 startTime = timeOutMilliseconds > 0 ? Time::getMillisecondCounter() : 0;
+
+    for (;;)
+    {
+        if (tryToConsumeSignal())
+            return true;
+
+        int timeToWait = timeOutMilliseconds;
+
+        if (timeOutMilliseconds >= 0)
+        {
+            timeToWait -= (int) (Time::getMillisecondCounter() - startTime);
+
+            if (timeToWait <= 0 || timeOutMilliseconds == 0)
+                return false;
+        }
+
+        ++numWaiters;
+        AddressWaiter::wait (&state.value, 0, timeToWait);
+        --numWaiters;
+    }
+}
+
+void LightweightEvent::signal() const noexcept
+{
+    state = 1;
+
+    if (numWaiters.value > 0)
+        AddressWaiter::wake (&state.value, manualReset ? std::numeric_limits<int>::max() : 1);
+}
+
+void LightweightEvent::reset() const noexcept
+{
+    state = 0;
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class LightweightEventTests  : public UnitTest
+{
+public:
+    LightweightEventTests() : UnitTest ("LightweightEvent") {}
+
+    struct ConsumerThread  : public Thread
+    {
+        ConsumerThread (LightweightSemaphore& items_, LightweightEvent& finished_, int numItems_)
+            : Thread ("consumer"), items (items_), finished (finished_), numItems (numItems_), numReceived (0)
+        {}
+
+        void run()
+        {
+            while (numReceived < numItems && items.wait (5000))
+                ++numReceived;
+
+            finished.signal();
+        }
+
+        LightweightSemaphore& items;
+        LightweightEvent& finished;
+        const int numItems;
+        int numReceived;
+    };
+
+    void runTest()
+    {
+        beginTest ("Semaphore");
+
+        {
+            LightweightSemaphore sem (2);
+            expect (sem.tryWait());
+            expect (sem.wait (0));
+            expect (! sem.tryWait());
+            expect (! sem.wait (20));
+
+            sem.signal (3);
+            expectEquals (sem.getCount(), 3);
+            expect (sem.wait() && sem.wait() && sem.wait());
+            expect (! sem.tryWait());
+        }
+
+        beginTest ("Event");
+
+        {
+            LightweightEvent autoReset (false), manualReset (true);
+            expect (! autoReset.wait (0));
+            expect (! manualReset.wait (20));
+
+            autoReset.signal();
+            expect (autoReset.wait (0));
+            expect (! autoReset.wait (0));
+
+            manualReset.signal();
+            expect (manualReset.wait (0) && manualReset.wait (0));
+            manualReset.reset();
+            expect (! manualReset.wait (0));
+        }
+
+        beginTest ("Hand-off between threads");
+
+        {
+            const int numItems = 20000;
+            LightweightSemaphore items;
+            LightweightEvent finished;
+
+            ConsumerThread consumer (items, finished, numItems);
+            consumer.startThread();
+
+            for (int i = 0; i < numItems; ++i)
+                items.signal();
+
+            expect (finished.wait (10000));
+            expectEquals (consumer.numReceived, numItems);
+            consumer.stopThread (2000);
+        }
+    }
+};
+
+static LightweightEventTests lightweightEventTests;
+
+#endif
@@ -0,0 +1,180 @@
+/*
+  ==============================================================================
+
+   This file is part of the juce_core module of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission to use, copy, modify, and/or distribute this software for any purpose with
+   or without fee is hereby granted, provided that the above copyright notice and this
+   permission notice appear in all copies.
+
+   THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+   TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+   NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+   DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+   IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+   ------------------------------------------------------------------------------
+
+   NOTE! This permissive ISC license applies ONLY to files within the juce_core module!
+   All other JUCE modules are covered by a dual GPL/commercial license, so if you are
+   using any other modules, be sure to check that you also comply with their license.
+
+   For more details, visit www.juce.com
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_LIGHTWEIGHTEVENT_JUCEHEADER__
+#define __JUCE_LIGHTWEIGHTEVENT_JUCEHEADER__
+
+#include "../memory/juce_Atomic.h"
+
+
+//==============================================================================
+/**
+    Lets threads sleep until the value of a 32-bit integer changes.
+
+    This is a thin wrapper around the operating system's address-based wait
+    functions (a futex on Linux/Android, WaitOnAddress on Windows 8 and later), and
+    is the building block used by LightweightEvent, LightweightSemaphore and
+    AdaptiveCriticalSection. On other platforms it falls back to a small table of
+    condition variables.
+
+    Waiting can return spuriously, so callers must always re-check their condition
+    in a loop.
+
+    @see LightweightEvent, LightweightSemaphore
+*/
+struct JUCE_API  AddressWaiter
+{
+    /** Puts the calling thread to sleep as long as the value at the given address is
+        equal to expectedValue.
+
+        This returns when another thread calls wake() for the same address, when the
+        timeout expires (a negative timeout means wait forever), or spuriously.
+        If the value is already different when it's called, it returns immediately.
+    */
+    static void wait (volatile int32* address, int32 expectedValue, int timeOutMilliseconds) noexcept;
+
+    /** Wakes up to the given number of threads that are waiting on an address.
+        On some platforms this may wake more threads than requested.
+    */
+    static void wake (volatile int32* address, int numThreadsToWake) noexcept;
+};
+
+
+//==============================================================================
+/**
+    A counting semaphore that only calls into the operating system when a thread
+    actually needs to sleep or be woken up.
+
+    If no thread is waiting, signal() is just an atomic increment, and if the count
+    is non-zero, wait() is just an atomic decrement - so this is much cheaper than a
+    WaitableEvent for handing work between threads many thousands of times a second.
+
+    @see LightweightEvent, WaitableEvent
+*/
+class JUCE_API  LightweightSemaphore
+{
+public:
+    //==============================================================================
+    /** Creates a semaphore with the given initial count. */
+    explicit LightweightSemaphore (int initialCount = 0) noexcept;
+
+    /** Destructor.
+        Make sure that no threads are waiting on the semaphore when it gets deleted!
+    */
+    ~LightweightSemaphore() noexcept;
+
+    //==============================================================================
+    /** Waits until the count is greater than zero, and then decrements it.
+
+        @param timeOutMilliseconds  the maximum time to wait, in milliseconds. A negative
+                                    value will cause it to wait forever.
+        @returns    true if the count was decremented, or false if the timeout expired first
+    */
+    bool wait (int timeOutMilliseconds = -1) noexcept;
+
+    /** Decrements the count if it's greater than zero, without ever blocking.
+        @returns true if the count was decremented
+    */
+    bool tryWait() noexcept;
+
+    /** Increments the count, waking up to that many waiting threads. */
+    void signal (int amountToAdd = 1) noexcept;
+
+    /** Returns the current count.
+        By the time this returns, other threads may have changed it, so only use
+        this for diagnostic purposes.
+    */
+    int getCount() const noexcept           { return count.value; }
+
+private:
+    //==============================================================================
+    Atomic<int32> count, numWaiters;
+
+    JUCE_DECLARE_NON_COPYABLE (LightweightSemaphore)
+};
+
+
+//==============================================================================
+/**
+    A drop-in alternative to WaitableEvent which avoids making any system calls
+    unless a thread actually has to go to sleep or be woken.
+
+    Signalling an event that nobody is waiting on is just an atomic write, and
+    waiting on an event that's already been signalled is just an atomic
+    compare-and-swap, whereas a WaitableEvent has to lock a mutex and signal a
+    condition variable each time.
+
+    @see LightweightSemaphore, WaitableEvent
+*/
+class JUCE_API  LightweightEvent
+{
+public:
+    //==============================================================================
+    /** Creates a LightweightEvent object.
+
+        @param manualReset  If this is false, the event will be reset automatically when the wait()
+                            method is called. If manualReset is true, then once the event is signalled,
+                            the only way to reset it will be by calling the reset() method.
+    */
+    explicit LightweightEvent (bool manualReset = false) noexcept;
+
+    /** Destructor.
+        Make sure that no threads are waiting on the event when it gets deleted!
+    */
+    ~LightweightEvent() noexcept;
+
+    //==============================================================================
+    /** Suspends the calling thread until the event has been signalled.
+
+        @param timeOutMilliseconds  the maximum time to wait, in milliseconds. A negative
+                                    value will cause it to wait forever.
+        @returns    true if the object has been signalled, false if the timeout expires first.
+        @see WaitableEvent::wait
+    */
+    bool wait (int timeOutMilliseconds = -1) const noexcept;
+
+    /** Wakes up any threads that are currently waiting on this object.
+        @see WaitableEvent::signal
+    */
+    void signal() const noexcept;
+
+    /** Resets the event to an unsignalled state. */
+    void reset() const noexcept;
+
+private:
+    //==============================================================================
+    mutable Atomic<int32> state, numWaiters;
+    const bool manualReset;
+
+    bool tryToConsumeSignal() const noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE (LightweightEvent)
+};
+
+
+#endif   // __JUCE_LIGHTWEIGHTEVENT_JUCEHEADER__
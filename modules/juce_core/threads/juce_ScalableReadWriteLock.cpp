@@ -0,0 +1,511 @@
+/*
+  ==============================================================================
+
+   This file is part of the juce_core module of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission to use, copy, modify, and/or distribute this software for any purpose with
+   or without fee is hereby granted, provided that the above copyright notice and this
+   permission notice appear in all copies.
+
+   THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+   TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+   NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+   DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+   IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+   ------------------------------------------------------------------------------
+
+   NOTE! This permissive ISC license applies ONLY to files within the juce_core module!
+   All other JUCE modules are covered by a dual GPL/commercial license, so if you are
+   using any other modules, be sure to check that you also comply with their license.
+
+   For more details, visit www.juce.com
+
+  ==============================================================================
+*/
+
+namespace ScalableReadWriteLockHelpers
+{
+    static uint32 hashThreadId (const Thread::ThreadID threadId) noexcept
+    {
+        const uint64 n = (uint64) (pointer_sized_uint) threadId;
+        return ((uint32) n ^ (uint32) (n >> 32)) * 0x9e3779b1;
+    }
+}
+
+//==============================================================================
+ScalableReadWriteLock::ScalableReadWriteLock() noexcept
+    : readersEvent (true)
+   #if JUCE_DEBUG
+     , writerThreadId (0)
+   #endif
+{
+    readersEvent.signal();
+}
+
+ScalableReadWriteLock::~ScalableReadWriteLock() noexcept
+{
+    jassert (numWriters.get() == 0);
+    jassert (haveAllReadersExited());
+}
+
+ScalableReadWriteLock::Stripe& ScalableReadWriteLock::getStripeForCurrentThread() const noexcept
+{
+    return stripes [(ScalableReadWriteLockHelpers::hashThreadId (Thread::getCurrentThreadId()) >> 16) & (numStripes - 1)];
+}
+
+//==============================================================================
+void ScalableReadWriteLock::enterRead() const noexcept
+{
+    Stripe& stripe = getStripeForCurrentThread();
+
+    while (! tryEnterReadOnStripe (stripe))
+        readersEvent.wait();
+}
+
+bool ScalableReadWriteLock::tryEnterRead() const noexcept
+{
+    return tryEnterReadOnStripe (getStripeForCurrentThread());
+}
+
+bool ScalableReadWriteLock::tryEnterReadOnStripe (Stripe& stripe) const noexcept
+{
+    // This increment acts as a full barrier, so a writer that arrives after it is
+    // guaranteed to see our count, and we're guaranteed to see any writer that arrived
+    // before it.
+    ++(stripe.numReaders);
+
+    if (numWriters.value == 0)
+    {
+        Atomic<int>::memoryBarrier();
+        return true;
+    }
+
+    --(stripe.numReaders);
+    writerEvent.signal(); // (in case the writer saw our count and is waiting for it to clear)
+    return false;
+}
+
+void ScalableReadWriteLock::exitRead() const noexcept
+{
+    Stripe& stripe = getStripeForCurrentThread();
+    jassert (stripe.numReaders.get() > 0); // unlocking a lock that wasn't locked..
+
+    --(stripe.numReaders);
+
+    if (numWriters.value != 0)
+        writerEvent.signal();
+}
+
+//==============================================================================
+void ScalableReadWriteLock::enterWrite() const noexcept
+{
+    // Registering as a waiting writer first stops any new readers from getting in
+    // while we wait for the ones that are already there to leave.
+    addWaitingWriter();
+    writerLock.enter();
+
+   #if JUCE_DEBUG
+    // this lock isn't re-entrant - if you need that, use a ReentrantScalableReadWriteLock
+    jassert (writerThreadId == 0);
+    writerThreadId = Thread::getCurrentThreadId();
+   #endif
+
+    while (! haveAllReadersExited())
+        writerEvent.wait();
+}
+
+bool ScalableReadWriteLock::tryEnterWrite() const noexcept
+{
+    if (! writerLock.tryEnter())
+        return false;
+
+    addWaitingWriter();
+
+    if (haveAllReadersExited())
+    {
+       #if JUCE_DEBUG
+        jassert (writerThreadId == 0);
+        writerThreadId = Thread::getCurrentThreadId();
+       #endif
+
+        return true;
+    }
+
+    writerLock.exit();
+    removeWriter();
+    return false;
+}
+
+void ScalableReadWriteLock::exitWrite() const noexcept
+{
+   #if JUCE_DEBUG
+    // unlocking a lock that wasn't locked by this thread..
+    jassert (writerThreadId == Thread::getCurrentThreadId());
+    writerThreadId = 0;
+   #endif
+
+    writerLock.exit();
+    removeWriter();
+}
+
+//==============================================================================
+void ScalableReadWriteLock::addWaitingWriter() const noexcept
+{
+    const SpinLock::ScopedLockType sl (eventLock);
+
+    if (++numWriters == 1)
+        readersEvent.reset();
+}
+
+void ScalableReadWriteLock::removeWriter() const noexcept
+{
+    const SpinLock::ScopedLockType sl (eventLock);
+
+    if (--numWriters == 0)
+        readersEvent.signal();
+}
+
+bool ScalableReadWriteLock::haveAllReadersExited() const noexcept
+{
+    for (int i = 0; i < numStripes; ++i)
+        if (stripes[i].numReaders.get() != 0)
+            return false;
+
+    return true;
+}
+
+//==============================================================================
+ReentrantScalableReadWriteLock::ReentrantScalableReadWriteLock() noexcept
+    : writerThreadId (0),
+      numWrites (0),
+      numReadsInsideWrite (0)
+{
+    for (int i = 0; i < numThreadSlots; ++i)
+        slots[i].numReads = 0;
+}
+
+ReentrantScalableReadWriteLock::~ReentrantScalableReadWriteLock() noexcept
+{
+    jassert (numWrites == 0);
+}
+
+ReentrantScalableReadWriteLock::ThreadSlot* ReentrantScalableReadWriteLock::findSlot (const Thread::ThreadID threadId) const noexcept
+{
+    const uint32 start = ScalableReadWriteLockHelpers::hashThreadId (threadId) >> 16;
+
+    for (uint32 i = 0; i < (uint32) maxProbes; ++i)
+    {
+        ThreadSlot& slot = slots [(start + i) & (numThreadSlots - 1)];
+
+        if (slot.threadId.value == threadId)
+            return &slot;
+    }
+
+    return nullptr;
+}
+
+ReentrantScalableReadWriteLock::ThreadSlot* ReentrantScalableReadWriteLock::claimSlot (const Thread::ThreadID threadId) const noexcept
+{
+    const uint32 start = ScalableReadWriteLockHelpers::hashThreadId (threadId) >> 16;
+
+    for (uint32 i = 0; i < (uint32) maxProbes; ++i)
+    {
+        ThreadSlot& slot = slots [(start + i) & (numThreadSlots - 1)];
+
+        if (slot.threadId.value == nullptr && slot.threadId.compareAndSetBool (threadId, nullptr))
+            return &slot;
+    }
+
+    return nullptr;
+}
+
+//==============================================================================
+void ReentrantScalableReadWriteLock::enterRead() const noexcept
+{
+    const Thread::ThreadID threadId = Thread::getCurrentThreadId();
+
+    if (writerThreadId == threadId)
+    {
+        ++numReadsInsideWrite;
+        return;
+    }
+
+    if (ThreadSlot* const slot = findSlot (threadId))
+    {
+        ++(slot->numReads);
+        return;
+    }
+
+    lock.enterRead();
+
+    if (ThreadSlot* const slot = claimSlot (threadId))
+        slot->numReads = 1;
+    else
+        jassertfalse; // Too many threads are reading at once to keep track of them all, so if this
+                      // thread tries to re-enter while a writer is waiting, it'll deadlock!
+}
+
+bool ReentrantScalableReadWriteLock::tryEnterRead() const noexcept
+{
+    const Thread::ThreadID threadId = Thread::getCurrentThreadId();
+
+    if (writerThreadId == threadId)
+    {
+        ++numReadsInsideWrite;
+        return true;
+    }
+
+    if (ThreadSlot* const slot = findSlot (threadId))
+    {
+        ++(slot->numReads);
+        return true;
+    }
+
+    if (! lock.tryEnterRead())
+        return false;
+
+    if (ThreadSlot* const slot = claimSlot (threadId))
+        slot->numReads = 1;
+    else
+        jassertfalse; // (see the comment in enterRead)
+
+    return true;
+}
+
+void ReentrantScalableReadWriteLock::exitRead() const noexcept
+{
+    const Thread::ThreadID threadId = Thread::getCurrentThreadId();
+
+    if (writerThreadId == threadId)
+    {
+        jassert (numReadsInsideWrite > 0); // unlocking a lock that wasn't locked..
+        --numReadsInsideWrite;
+        return;
+    }
+
+    if (ThreadSlot* const slot = findSlot (threadId))
+    {
+        jassert (slot->numReads > 0);
+
+        if (--(slot->numReads) == 0)
+        {
+            slot->threadId = nullptr;
+            lock.exitRead();
+        }
+
+        return;
+    }
+
+    lock.exitRead();
+}
+
+//==============================================================================
+void ReentrantScalableReadWriteLock::enterWrite() const noexcept
+{
+    const Thread::ThreadID threadId = Thread::getCurrentThreadId();
+
+    if (writerThreadId == threadId)
+    {
+        ++numWrites;
+        return;
+    }
+
+    // You can't upgrade a read lock to a write lock, because if two threads tried
+    // to do that at the same time, they'd each wait forever for the other one!
+    jassert (findSlot (threadId) == nullptr);
+
+    lock.enterWrite();
+    writerThreadId = threadId;
+    numWrites = 1;
+}
+
+bool ReentrantScalableReadWriteLock::tryEnterWrite() const noexcept
+{
+    const Thread::ThreadID threadId = Thread::getCurrentThreadId();
+
+    if (writerThreadId == threadId)
+    {
+        ++numWrites;
+        return true;
+    }
+
+    if (! lock.tryEnterWrite())
+        return false;
+
+    writerThreadId = threadId;
+    numWrites = 1;
+    return true;
+}
+
+void ReentrantScalableReadWriteLock::exitWrite() const noexcept
+{
+    // unlocking a lock that wasn't locked by this thread..
+    jassert (writerThreadId == Thread::getCurrentThreadId() && numWrites > 0);
+
+    if (--numWrites == 0)
+    {
+        // any read locks taken while holding the write lock must be released first
+        jassert (numReadsInsideWrite == 0);
+
+        writerThreadId = 0;
+        lock.exitWrite();
+    }
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class ScalableReadWriteLockTests  : public UnitTest
+{
+public:
+    ScalableReadWriteLockTests() : UnitTest ("ScalableReadWriteLock") {}
+
+    template <class LockType>
+    struct TestThread  : public Thread
+    {
+        TestThread (const LockType& l, Atomic<int>& readers, Atomic<int>& writers, Atomic<int>& errors, int seed)
+            : Thread ("ScalableReadWriteLock test"), lock (l),
+              numReaders (readers), numWriters (writers), numErrors (errors), random (seed)
+        {}
+
+        void run()
+        {
+            for (int i = 0; i < 2000; ++i)
+            {
+                if (random.nextInt (10) == 0)
+                {
+                    const typename LockType::ScopedWriteLockType sl (lock);
+
+                    if (++numWriters != 1 || numReaders.get() != 0)
+                        ++numErrors;
+
+                    Thread::yield();
+                    --numWriters;
+                }
+                else
+                {
+                    const typename LockType::ScopedReadLockType sl (lock);
+                    ++numReaders;
+
+                    if (numWriters.get() != 0)
+                        ++numErrors;
+
+                    Thread::yield();
+                    --numReaders;
+                }
+            }
+        }
+
+        const LockType& lock;
+        Atomic<int>& numReaders;
+        Atomic<int>& numWriters;
+        Atomic<int>& numErrors;
+        Random random;
+    };
+
+    template <class LockType>
+    void testExclusion()
+    {
+        LockType lock;
+        Atomic<int> numReaders, numWriters, numErrors;
+        OwnedArray<Thread> threads;
+
+        for (int i = 0; i < 8; ++i)
+            threads.add (new TestThread<LockType> (lock, numReaders, numWriters, numErrors, i));
+
+        for (int i = 0; i < threads.size(); ++i)
+            threads.getUnchecked(i)->startThread();
+
+        for (int i = 0; i < threads.size(); ++i)
+            expect (threads.getUnchecked(i)->waitForThreadToExit (20000));
+
+        expectEquals (numErrors.get(), 0);
+    }
+
+    struct TryLockThread  : public Thread
+    {
+        TryLockThread (const ScalableReadWriteLock& l)  : Thread ("ScalableReadWriteLock test"), lock (l),
+                                                          gotReadLock (false), gotWriteLock (false) {}
+
+        void run()
+        {
+            gotReadLock = lock.tryEnterRead();
+
+            if (gotReadLock)
+                lock.exitRead();
+
+            gotWriteLock = lock.tryEnterWrite();
+
+            if (gotWriteLock)
+                lock.exitWrite();
+        }
+
+        const ScalableReadWriteLock& lock;
+        bool gotReadLock, gotWriteLock;
+    };
+
+    void runTest()
+    {
+        beginTest ("Exclusion");
+        testExclusion<ScalableReadWriteLock>();
+
+        beginTest ("Try-locks");
+        {
+            ScalableReadWriteLock lock;
+
+            {
+                const ScalableReadWriteLock::ScopedReadLockType sl (lock);
+                TryLockThread t (lock);
+                t.startThread();
+                expect (t.waitForThreadToExit (5000));
+                expect (t.gotReadLock);
+                expect (! t.gotWriteLock);
+            }
+
+            {
+                const ScalableReadWriteLock::ScopedWriteLockType sl (lock);
+                TryLockThread t (lock);
+                t.startThread();
+                expect (t.waitForThreadToExit (5000));
+                expect (! t.gotReadLock);
+                expect (! t.gotWriteLock);
+            }
+
+            TryLockThread t (lock);
+            t.startThread();
+            expect (t.waitForThreadToExit (5000));
+            expect (t.gotReadLock);
+            expect (t.gotWriteLock);
+        }
+
+        beginTest ("Re-entrant exclusion");
+        testExclusion<ReentrantScalableReadWriteLock>();
+
+        beginTest ("Re-entrant locking");
+        {
+            ReentrantScalableReadWriteLock lock;
+
+            lock.enterRead();
+            expect (lock.tryEnterRead());
+            lock.exitRead();
+            lock.exitRead();
+
+            lock.enterWrite();
+            expect (lock.tryEnterWrite());
+            lock.enterRead();
+            lock.exitRead();
+            lock.exitWrite();
+            lock.exitWrite();
+
+            expect (lock.tryEnterWrite());
+            lock.exitWrite();
+        }
+    }
+};
+
+static ScalableReadWriteLockTests scalableReadWriteLockTests;
+
+#endif
@@ -0,0 +1,250 @@
+/*
+  ==============================================================================
+
+   This file is part of the juce_core module of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission to use, copy, modify, and/or distribute this software for any purpose with
+   or without fee is hereby granted, provided that the above copyright notice and this
+   permission notice appear in all copies.
+
+   THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+   TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+   NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+   DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+   IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+   ------------------------------------------------------------------------------
+
+   NOTE! This permissive ISC license applies ONLY to files within the juce_core module!
+   All other JUCE modules are covered by a dual GPL/commercial license, so if you are
+   using any other modules, be sure to check that you also comply with their license.
+
+   For more details, visit www.juce.com
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_SCALABLEREADWRITELOCK_JUCEHEADER__
+#define __JUCE_SCALABLEREADWRITELOCK_JUCEHEADER__
+
+#include "juce_CriticalSection.h"
+#include "juce_SpinLock.h"
+#include "juce_WaitableEvent.h"
+#include "juce_Thread.h"
+#include "juce_ScopedReadLock.h"
+#include "juce_ScopedWriteLock.h"
+
+
+//==============================================================================
+/**
+    A read/write lock that lets large numbers of threads read at the same time
+    without contending with each other.
+
+    Unlike a ReadWriteLock, this doesn't keep a list of the threads that are reading.
+    Instead, each reader just increments one of a set of counters, chosen by hashing
+    its thread ID, and each counter is on a cache line of its own, so readers on
+    different threads will rarely touch the same memory. The price of this is that
+    taking the write lock has to check all the counters, so it's best suited to data
+    that is read far more often than it's written.
+
+    Writers take priority: as soon as a thread is waiting for the write lock, any new
+    readers are held back until it has been released, so a steady stream of readers
+    can't stop a writer from ever getting in.
+
+    This lock is not re-entrant: a thread mustn't try to take a read or write lock
+    that it already holds, and can't upgrade a read lock to a write lock. If you need
+    that, use a ReentrantScalableReadWriteLock.
+
+    @see ReentrantScalableReadWriteLock, ReadWriteLock, GenericScopedReadLock, GenericScopedWriteLock
+*/
+class JUCE_API  ScalableReadWriteLock
+{
+public:
+    //==============================================================================
+    /** Creates a ScalableReadWriteLock. */
+    ScalableReadWriteLock() noexcept;
+
+    /** Destructor.
+        If the object is deleted whilst locked, any subsequent behaviour is unpredictable.
+    */
+    ~ScalableReadWriteLock() noexcept;
+
+    //==============================================================================
+    /** Locks this object for reading.
+
+        Multiple threads can simultaneously lock the object for reading, but if another
+        thread has it locked for writing, or is waiting to do so, then this will block
+        until it has been released.
+
+        @see exitRead, ScopedReadLockType
+    */
+    void enterRead() const noexcept;
+
+    /** Tries to lock this object for reading without blocking.
+        @returns true if the lock was successfully gained.
+        @see exitRead
+    */
+    bool tryEnterRead() const noexcept;
+
+    /** Releases the read-lock.
+        This must be called by the same thread that locked it.
+        @see enterRead
+    */
+    void exitRead() const noexcept;
+
+    //==============================================================================
+    /** Locks this object for writing.
+
+        This will block until any other threads that have it locked for reading or
+        writing have released their lock.
+
+        @see exitWrite, ScopedWriteLockType
+    */
+    void enterWrite() const noexcept;
+
+    /** Tries to lock this object for writing without blocking.
+        @returns true if the lock was successfully gained.
+        @see enterWrite
+    */
+    bool tryEnterWrite() const noexcept;
+
+    /** Releases the write-lock.
+        This must be called by the same thread that locked it.
+        @see enterWrite
+    */
+    void exitWrite() const noexcept;
+
+    //==============================================================================
+    /** Provides the type of scoped read-lock to use with this type of lock. */
+    typedef GenericScopedReadLock <ScalableReadWriteLock>  ScopedReadLockType;
+
+    /** Provides the type of scoped write-lock to use with this type of lock. */
+    typedef GenericScopedWriteLock <ScalableReadWriteLock> ScopedWriteLockType;
+
+private:
+    //==============================================================================
+    enum { numStripes = 32, cacheLineSize = 64 };
+
+    struct Stripe
+    {
+        Atomic<int> numReaders;
+        char padding [cacheLineSize - sizeof (Atomic<int>)];
+    };
+
+    mutable Stripe stripes [numStripes];
+    mutable Atomic<int> numWriters;   // the number of writers that hold or are waiting for the lock
+    CriticalSection writerLock;
+    SpinLock eventLock;
+    WaitableEvent readersEvent, writerEvent;
+
+   #if JUCE_DEBUG
+    mutable Thread::ThreadID writerThreadId;
+   #endif
+
+    Stripe& getStripeForCurrentThread() const noexcept;
+    bool tryEnterReadOnStripe (Stripe&) const noexcept;
+    void addWaitingWriter() const noexcept;
+    void removeWriter() const noexcept;
+    bool haveAllReadersExited() const noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE (ScalableReadWriteLock)
+};
+
+
+//==============================================================================
+/**
+    A ScalableReadWriteLock that a thread can lock more than once.
+
+    This works like a ScalableReadWriteLock, but a thread that already holds the read
+    or write lock can lock it again (as long as each call is matched by a call to the
+    appropriate exit method), and a thread that holds the write lock can also take
+    the read lock.
+
+    To make this possible, the lock keeps track of how many times each thread has
+    locked it, in a small hash table that each thread can find its own entry in
+    without contending with any others. If the table gets too crowded to find room
+    for a thread (which is unlikely with fewer than a few dozen threads reading at
+    once), that thread's re-entrant reads won't be recognised, and in a debug build
+    you'll get an assertion.
+
+    In a debug build, this will also assert if you try to release a lock that the
+    thread doesn't hold, or try to upgrade a read lock to a write lock (which would
+    deadlock).
+
+    @see ScalableReadWriteLock, ReadWriteLock
+*/
+class JUCE_API  ReentrantScalableReadWriteLock
+{
+public:
+    //==============================================================================
+    /** Creates a ReentrantScalableReadWriteLock. */
+    ReentrantScalableReadWriteLock() noexcept;
+
+    /** Destructor.
+        If the object is deleted whilst locked, any subsequent behaviour is unpredictable.
+    */
+    ~ReentrantScalableReadWriteLock() noexcept;
+
+    //==============================================================================
+    /** Locks this object for reading.
+        If the calling thread already holds a read or write lock, this returns immediately.
+        @see ScalableReadWriteLock::enterRead
+    */
+    void enterRead() const noexcept;
+
+    /** Tries to lock this object for reading without blocking.
+        @returns true if the lock was successfully gained.
+    */
+    bool tryEnterRead() const noexcept;
+
+    /** Releases the read-lock. */
+    void exitRead() const noexcept;
+
+    //==============================================================================
+    /** Locks this object for writing.
+        If the calling thread already holds the write lock, this returns immediately.
+        @see ScalableReadWriteLock::enterWrite
+    */
+    void enterWrite() const noexcept;
+
+    /** Tries to lock this object for writing without blocking.
+        @returns true if the lock was successfully gained.
+    */
+    bool tryEnterWrite() const noexcept;
+
+    /** Releases the write-lock. */
+    void exitWrite() const noexcept;
+
+    //==============================================================================
+    /** Provides the type of scoped read-lock to use with this type of lock. */
+    typedef GenericScopedReadLock <ReentrantScalableReadWriteLock>  ScopedReadLockType;
+
+    /** Provides the type of scoped write-lock to use with this type of lock. */
+    typedef GenericScopedWriteLock <ReentrantScalableReadWriteLock> ScopedWriteLockType;
+
+private:
+    //==============================================================================
+    enum { numThreadSlots = 64, maxProbes = 8, cacheLineSize = 64 };
+
+    struct ThreadSlot
+    {
+        Atomic<Thread::ThreadID> threadId;
+        int numReads;
+        char padding [cacheLineSize - sizeof (Atomic<Thread::ThreadID>) - sizeof (int)];
+    };
+
+    ScalableReadWriteLock lock;
+    mutable ThreadSlot slots [numThreadSlots];
+    mutable Thread::ThreadID writerThreadId;
+    mutable int numWrites, numReadsInsideWrite;
+
+    ThreadSlot* findSlot (Thread::ThreadID) const noexcept;
+    ThreadSlot* claimSlot (Thread::ThreadID) const noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE (ReentrantScalableReadWriteLock)
+};
+
+
+#endif   // __JUCE_SCALABLEREADWRITELOCK_JUCEHEADER__
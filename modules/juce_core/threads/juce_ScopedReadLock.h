@@ -89,4 +89,40 @@ private:
 };
 
 
+//==============================================================================
+/**
+    Automatically locks and unlocks any kind of read/write lock for reading.
+
+    This works like a ScopedReadLock, but can be used with any class that has
+    enterRead() and exitRead() methods, such as a ScalableReadWriteLock.
+
+    @see ScopedReadLock, ScalableReadWriteLock
+*/
+template <class LockType>
+class GenericScopedReadLock
+{
+public:
+    //==============================================================================
+    /** Creates a GenericScopedReadLock.
+
+        As soon as it is created, this will call the lock's enterRead() method, and
+        when the object is deleted, its exitRead() method will be called.
+
+        Make sure this object is created and deleted by the same thread,
+        otherwise there are no guarantees what will happen!
+    */
+    inline explicit GenericScopedReadLock (const LockType& lock) noexcept   : lock_ (lock) { lock.enterRead(); }
+
+    /** Destructor. */
+    inline ~GenericScopedReadLock() noexcept                                 { lock_.exitRead(); }
+
+
+private:
+    //==============================================================================
+    const LockType& lock_;
+
+    JUCE_DECLARE_NON_COPYABLE (GenericScopedReadLock)
+};
+
+
 #endif   // __JUCE_SCOPEDREADLOCK_JUCEHEADER__
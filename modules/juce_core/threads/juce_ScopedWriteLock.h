@@ -89,4 +89,40 @@ private:
 };
 
 
+//==============================================================================
+/**
+    Automatically locks and unlocks any kind of read/write lock for writing.
+
+    This works like a ScopedWriteLock, but can be used with any class that has
+    enterWrite() and exitWrite() methods, such as a ScalableReadWriteLock.
+
+    @see ScopedWriteLock, ScalableReadWriteLock
+*/
+template <class LockType>
+class GenericScopedWriteLock
+{
+public:
+    //==============================================================================
+    /** Creates a GenericScopedWriteLock.
+
+        As soon as it is created, this will call the lock's enterWrite() method, and
+        when the object is deleted, its exitWrite() method will be called.
+
+        Make sure this object is created and deleted by the same thread,
+        otherwise there are no guarantees what will happen!
+    */
+    inline explicit GenericScopedWriteLock (const LockType& lock) noexcept   : lock_ (lock) { lock.enterWrite(); }
+
+    /** Destructor. */
+    inline ~GenericScopedWriteLock() noexcept                                 { lock_.exitWrite(); }
+
+
+private:
+    //==============================================================================
+    const LockType& lock_;
+
+    JUCE_DECLARE_NON_COPYABLE (GenericScopedWriteLock)
+};
+
+
 #endif   // __JUCE_SCOPEDWRITELOCK_JUCEHEADER__
@@ -31,8 +31,9 @@ Thread::Thread (const String& threadName_)
       threadHandle (nullptr),
       threadId (0),
       threadPriority (5),
-      affinityMask (0),
-      shouldExit (false)
+      wantsRealtime (false),
+      shouldExit (false),
+      realtime (false)
 {
 }
 
@@ -90,8 +91,11 @@ void Thread::threadEntryPoint()
         {
             jassert (getCurrentThreadId() == threadId);
 
-            if (affinityMask != 0)
-                setCurrentThreadAffinityMask (affinityMask);
+            if (! affinity.isZero())
+                setCurrentThreadAffinity (affinity);
+
+            if (wantsRealtime)
+                realtime = setCurrentThreadRealtime (realtimeOptions);
 
             run();
         }
@@ -229,7 +233,54 @@ bool Thread::setCurrentThreadPriority (const int newPriority)
 
 void Thread::setAffinityMask (const uint32 newAffinityMask)
 {
-    affinityMask = newAffinityMask;
+    affinity = BigInteger (newAffinityMask);
+}
+
+void Thread::setCurrentThreadAffinityMask (const uint32 newAffinityMask)
+{
+    setCurrentThreadAffinity (BigInteger (newAffinityMask));
+}
+
+void Thread::setAffinity (const BigInteger& cpus)
+{
+    affinity = cpus;
+}
+
+//==============================================================================
+Thread::RealtimeOptions::RealtimeOptions() noexcept
+    : priority (8),
+      periodMs (0),
+      computationMs (0),
+      lockMemory (false)
+{
+}
+
+bool Thread::setRealtime (const RealtimeOptions& options)
+{
+    // (as with setPriority(), the lock mustn't be taken if this is the thread itself)
+    if (getCurrentThreadId() == getThreadId())
+    {
+        realtimeOptions = options;
+        wantsRealtime = true;
+        realtime = setCurrentThreadRealtime (options);
+        return realtime;
+    }
+
+    const ScopedLock sl (startStopLock);
+
+    realtimeOptions = options;
+    wantsRealtime = true;
+
+    if (threadHandle == nullptr)
+        return true;
+
+    realtime = setThreadRealtime (threadHandle, options);
+    return realtime;
+}
+
+bool Thread::setCurrentThreadRealtime (const RealtimeOptions& options)
+{
+    return setThreadRealtime (0, options);
 }
 
 //==============================================================================
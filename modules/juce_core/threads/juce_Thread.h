@@ -31,6 +31,7 @@
 
 #include "juce_WaitableEvent.h"
 #include "juce_CriticalSection.h"
+#include "../maths/juce_BigInteger.h"
 
 
 //==============================================================================
@@ -175,13 +176,70 @@ public:
     */
     static bool setCurrentThreadPriority (int priority);
 
+    //==============================================================================
+    /** Describes the kind of real-time scheduling that a thread needs.
+        @see setRealtime, setCurrentThreadRealtime
+    */
+    struct JUCE_API  RealtimeOptions
+    {
+        /** Creates a set of options with a high priority and no timing hints. */
+        RealtimeOptions() noexcept;
+
+        /** The priority within the OS's range of real-time priorities, from 0 (lowest)
+            to 10 (highest).
+        */
+        int priority;
+
+        /** How often the thread expects to wake up, in milliseconds - e.g. the length of
+            an audio block. Leave this as 0 if the thread isn't periodic.
+
+            On OSX and iOS this is used to set up a time-constraint policy for the thread.
+        */
+        double periodMs;
+
+        /** The amount of CPU time that the thread will need in each period, in milliseconds.
+            If this is 0, the thread is assumed to need up to half of each period.
+        */
+        double computationMs;
+
+        /** If true, all of the process's current and future memory pages will be locked
+            into RAM, so that real-time threads can't be held up by page faults.
+        */
+        bool lockMemory;
+    };
+
+    /** Asks for this thread to be given real-time scheduling.
+
+        On Linux and Android this uses SCHED_FIFO, on OSX and iOS a time-constraint policy,
+        and on Windows it registers the thread with MMCSS as a "Pro Audio" task.
+
+        If the thread isn't running yet, the options will be applied when it starts. Most
+        OSes will only grant real-time scheduling to privileged processes, so call
+        isRealtime() to find out whether it actually took effect.
+
+        @returns false if the thread is running and its scheduling couldn't be changed
+        @see setCurrentThreadRealtime, isRealtime
+    */
+    bool setRealtime (const RealtimeOptions& options);
+
+    /** Returns true if this thread has been successfully given real-time scheduling
+        by setRealtime().
+    */
+    bool isRealtime() const noexcept                                { return realtime; }
+
+    /** Asks for the caller thread to be given real-time scheduling.
+        @returns true if the thread's scheduling was successfully changed
+        @see setRealtime
+    */
+    static bool setCurrentThreadRealtime (const RealtimeOptions& options);
+
     //==============================================================================
     /** Sets the affinity mask for the thread.
 
         This will only have an effect next time the thread is started - i.e. if the
         thread is already running when called, it'll have no effect.
 
-        @see setCurrentThreadAffinityMask
+        @see setAffinity, setCurrentThreadAffinityMask
     */
     void setAffinityMask (uint32 affinityMask);
 
@@ -193,6 +251,26 @@ public:
     */
     static void setCurrentThreadAffinityMask (uint32 affinityMask);
 
+    /** Sets the set of CPUs that the thread is allowed to run on.
+
+        Each set bit in the BigInteger is the index of a CPU, so unlike setAffinityMask(),
+        this can cover any number of cores. Like setAffinityMask(), this will only have an
+        effect the next time the thread is started.
+
+        @see setCurrentThreadAffinity, SystemStats::getIsolatedCpus
+    */
+    void setAffinity (const BigInteger& cpus);
+
+    /** Restricts the caller thread to running on a set of CPUs.
+
+        Each set bit in the BigInteger is the index of a CPU. This isn't supported on
+        OSX or iOS.
+
+        @returns true if the affinity was successfully changed
+        @see setAffinity
+    */
+    static bool setCurrentThreadAffinity (const BigInteger& cpus);
+
     //==============================================================================
     // this can be called from any thread that needs to pause..
     static void JUCE_CALLTYPE sleep (int milliseconds);
@@ -273,8 +351,10 @@ private:
     CriticalSection startStopLock;
     WaitableEvent startSuspensionEvent, defaultEvent;
     int threadPriority;
-    uint32 affinityMask;
-    bool volatile shouldExit;
+    BigInteger affinity;
+    RealtimeOptions realtimeOptions;
+    bool wantsRealtime;
+    bool volatile shouldExit, realtime;
 
    #ifndef DOXYGEN
     friend void JUCE_API juce_threadEntryPoint (void*);
@@ -285,6 +365,7 @@ private:
     void killThread();
     void threadEntryPoint();
     static bool setThreadPriority (void*, int);
+    static bool setThreadRealtime (void*, const RealtimeOptions&);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Thread)
 };
@@ -61,9 +61,10 @@ void ThreadPoolJob::signalJobShouldExit()
 class ThreadPool::ThreadPoolThread  : public Thread
 {
 public:
-    ThreadPoolThread (ThreadPool& pool_)
+    ThreadPoolThread (ThreadPool& pool_, const int index_)
         : Thread ("Pool"),
-          pool (pool_)
+          pool (pool_),
+          index (index_)
     {
     }
 
@@ -71,13 +72,87 @@ public:
     {
         while (! threadShouldExit())
         {
-            if (! pool.runNextJob())
+            if (! (pool.runNextTask (index) || pool.runNextJob()))
                 wait (500);
         }
     }
 
+    //==============================================================================
+    /** A double-ended queue of tasks: the owning thread pushes and pops at the back,
+        and other threads steal from the front, so that the oldest tasks get stolen.
+    */
+    class TaskQueue
+    {
+    public:
+        TaskQueue() noexcept : head (0), numTasks (0), capacity (0) {}
+
+        ~TaskQueue()
+        {
+            while (numTasks > 0)
+                delete popBack();
+        }
+
+        void pushBack (ThreadPoolTask* const task)
+        {
+            const ScopedLock sl (lock);
+
+            if (numTasks == capacity)
+            {
+                const int newCapacity = jmax (32, capacity * 2);
+                HeapBlock<ThreadPoolTask*> newTasks ((size_t) newCapacity);
+
+                for (int i = 0; i < numTasks; ++i)
+                    newTasks[i] = tasks [(head + i) & (capacity - 1)];
+
+                tasks.swapWith (newTasks);
+                capacity = newCapacity;
+                head = 0;
+            }
+
+            tasks [(head + numTasks) & (capacity - 1)] = task;
+            ++numTasks;
+        }
+
+        ThreadPoolTask* popBack()
+        {
+            const ScopedLock sl (lock);
+
+            if (numTasks == 0)
+                return nullptr;
+
+            --numTasks;
+            return tasks [(head + numTasks) & (capacity - 1)];
+        }
+
+        ThreadPoolTask* popFront()
+        {
+            const ScopedLock sl (lock);
+
+            if (numTasks == 0)
+                return nullptr;
+
+            ThreadPoolTask* const task = tasks [head];
+            head = (head + 1) & (capacity - 1);
+            --numTasks;
+            return task;
+        }
+
+        /** This is only a hint, as other threads may be changing the queue. */
+        bool isEmpty() const noexcept       { return numTasks == 0; }
+
+    private:
+        CriticalSection lock;
+        HeapBlock<ThreadPoolTask*> tasks;
+        int head, numTasks, capacity;
+
+        JUCE_DECLARE_NON_COPYABLE (TaskQueue)
+    };
+
+    TaskQueue tasks;
+
 private:
     ThreadPool& pool;
+    const int index;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ThreadPoolThread)
 };
@@ -103,8 +178,8 @@ ThreadPool::~ThreadPool()
 
 void ThreadPool::createThreads (int numThreads)
 {
-    for (int i = jmax (1, numThreads); --i >= 0;)
-        threads.add (new ThreadPoolThread (*this));
+    for (int i = 0; i < jmax (1, numThreads); ++i)
+        threads.add (new ThreadPoolThread (*this, i));
 
     for (int i = threads.size(); --i >= 0;)
         threads.getUnchecked(i)->startThread();
@@ -146,6 +221,11 @@ int ThreadPool::getNumJobs() const
     return jobs.size();
 }
 
+int ThreadPool::getNumThreads() const noexcept
+{
+    return threads.size();
+}
+
 ThreadPoolJob* ThreadPool::getJob (const int index) const
 {
     const ScopedLock sl (lock);
@@ -298,6 +378,95 @@ bool ThreadPool::setThreadPriorities (const int newPriority)
     return ok;
 }
 
+//==============================================================================
+void ThreadPool::addTask (ThreadPoolTask* const task)
+{
+    jassert (task != nullptr);
+
+    if (task != nullptr)
+    {
+        int index = getIndexOfCurrentThread();
+
+        if (index < 0)
+            index = (int) ((uint32) ++nextTaskThread % (uint32) threads.size());
+
+        ThreadPoolThread* const thread = threads.getUnchecked (index);
+        thread->tasks.pushBack (task);
+        thread->notify();
+    }
+}
+
+bool ThreadPool::runNextTask (const int threadIndex)
+{
+    const int numThreads = threads.size();
+    ThreadPoolTask* task = nullptr;
+
+    if (threadIndex >= 0)
+        task = threads.getUnchecked (threadIndex)->tasks.popBack();
+
+    // if our own queue is empty, try to steal the oldest task from one of the others..
+    for (int i = 1; task == nullptr && i <= numThreads; ++i)
+        task = threads.getUnchecked ((jmax (0, threadIndex) + i) % numThreads)->tasks.popFront();
+
+    if (task == nullptr)
+        return false;
+
+    // if there's more work waiting, wake up another thread to help steal it, so that
+    // a burst of tasks added to one queue gets spread across the pool quickly
+    if (threadIndex >= 0 && numThreads > 1
+         && ! threads.getUnchecked (threadIndex)->tasks.isEmpty())
+        threads.getUnchecked ((threadIndex + 1) % numThreads)->notify();
+
+    JUCE_TRY
+    {
+        task->runTask();
+    }
+    JUCE_CATCH_ALL_ASSERT
+
+    delete task;
+    return true;
+}
+
+int ThreadPool::getIndexOfCurrentThread() const noexcept
+{
+    const Thread* const currentThread = Thread::getCurrentThread();
+
+    if (currentThread != nullptr)
+        for (int i = threads.size(); --i >= 0;)
+            if (threads.getUnchecked(i) == currentThread)
+                return i;
+
+    return -1;
+}
+
+int ThreadPool::getChunkSize (const int numItems, const int grainSize) const noexcept
+{
+    if (grainSize > 0)
+        return grainSize;
+
+    // aim for a few chunks per thread, so that stealing can even out any imbalance
+    return jmax (1, numItems / (threads.size() * 4));
+}
+
+void ThreadPool::waitForTaskGroup (TaskGroup& group)
+{
+    const int threadIndex = getIndexOfCurrentThread();
+
+    for (;;)
+    {
+        if (group.numOutstanding.get() == 0)
+        {
+            // the last task may still be in the middle of signalling the event
+            group.finished.wait (-1);
+            break;
+        }
+
+        if (! runNextTask (threadIndex) && group.finished.wait (1))
+            break;
+    }
+}
+
+//==============================================================================
 ThreadPoolJob* ThreadPool::pickNextJobToRun()
 {
     OwnedArray<ThreadPoolJob> deletionList;
@@ -339,6 +508,7 @@ bool ThreadPool::runNextJob()
 
     JUCE_TRY
     {
+        JUCE_TRACE_SCOPE ("ThreadPoolJob");
         result = job->runJob();
     }
     JUCE_CATCH_ALL_ASSERT
@@ -378,3 +548,183 @@ void ThreadPool::addToDeleteList (OwnedArray<ThreadPoolJob>& deletionList, Threa
     if (job->shouldBeDeleted)
         deletionList.add (job);
 }
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class ThreadPoolTests  : public UnitTest
+{
+public:
+    ThreadPoolTests() : UnitTest ("ThreadPool") {}
+
+    struct CountingFunction
+    {
+        CountingFunction (Atomic<int>& c) : counter (c) {}
+        void operator()() const         { ++counter; }
+
+        Atomic<int>& counter;
+    };
+
+    struct MarkingFunction
+    {
+        MarkingFunction (Array<int>& h) : hits (h) {}
+        void operator() (int index) const   { ++(hits.getReference (index)); }
+
+        Array<int>& hits;
+    };
+
+    struct SquareFunction
+    {
+        int64 operator() (int index) const  { return (int64) index * index; }
+    };
+
+    struct AddFunction
+    {
+        int64 operator() (int64 a, int64 b) const  { return a + b; }
+    };
+
+    struct NestedFunction
+    {
+        NestedFunction (ThreadPool& p, Atomic<int>& t) : pool (p), total (t) {}
+
+        void operator() (int) const
+        {
+            total += (int) pool.parallelReduce (0, 100, (int64) 0, SquareFunction(), AddFunction(), 10);
+        }
+
+        ThreadPool& pool;
+        Atomic<int>& total;
+    };
+
+    struct KeyOnlyComparator
+    {
+        // values are key * 100000 + original index, and only the key is compared
+        static int compareElements (int first, int second) noexcept
+        {
+            return (first / 100000) - (second / 100000);
+        }
+    };
+
+    static String createRandomString (Random& r)
+    {
+        static const char* const chars = "aAbBcCzZ09_";
+        String s;
+
+        for (int len = r.nextInt (7); --len >= 0;)
+            s += (r.nextInt (20) == 0) ? (juce_wchar) (0xe0 + r.nextInt (30))
+                                       : (juce_wchar) chars [r.nextInt (11)];
+
+        return s;
+    }
+
+    void runTest()
+    {
+        ThreadPool pool (3);
+
+        beginTest ("Functions");
+        {
+            Atomic<int> counter;
+
+            for (int i = 0; i < 1000; ++i)
+                pool.addFunction (CountingFunction (counter));
+
+            for (int i = 0; i < 500 && counter.get() < 1000; ++i)
+                Thread::sleep (10);
+
+            expectEquals (counter.get(), 1000);
+        }
+
+        beginTest ("parallelFor");
+        {
+            Array<int> hits;
+            hits.insertMultiple (0, 0, 10000);
+
+            pool.parallelFor (0, hits.size(), MarkingFunction (hits));
+            pool.parallelFor (5000, hits.size(), MarkingFunction (hits), 7);
+
+            for (int i = 0; i < hits.size(); ++i)
+                if (hits[i] != (i < 5000 ? 1 : 2))
+                    expect (false, "index " + String (i) + " was visited " + String (hits[i]) + " times");
+        }
+
+        beginTest ("parallelReduce");
+        {
+            int64 expected = 0;
+            for (int i = 0; i < 20000; ++i)
+                expected += (int64) i * i;
+
+            expect (pool.parallelReduce (0, 20000, (int64) 0, SquareFunction(), AddFunction()) == expected);
+            expect (pool.parallelReduce (0, 20000, (int64) 0, SquareFunction(), AddFunction(), 1) == expected);
+            expect (pool.parallelReduce (10, 10, (int64) 42, SquareFunction(), AddFunction()) == 42);
+        }
+
+        beginTest ("Nested");
+        {
+            Atomic<int> total;
+            pool.parallelFor (0, 20, NestedFunction (pool, total), 1);
+            expectEquals (total.get(), 20 * 328350);
+        }
+
+        beginTest ("Parallel sort");
+        {
+            Random r (1234);
+            Array<int> values, expected;
+
+            for (int i = 0; i < 50000; ++i)
+                values.add (r.nextInt (300) * 100000 + i);
+
+            expected = values;
+            DefaultElementComparator<int> comparator;
+            expected.sort (comparator);
+            values.sort (comparator, pool);
+            expect (values == expected);
+
+            // shuffle the keys, and re-number them by their new positions, so that a stable
+            // sort by key alone must put the values back into ascending order
+            for (int i = values.size(); --i > 0;)
+                values.swap (i, r.nextInt (i + 1));
+
+            for (int i = 0; i < values.size(); ++i)
+                values.set (i, (values[i] / 100000) * 100000 + i);
+
+            KeyOnlyComparator keyComparator;
+            values.sort (keyComparator, pool, true);
+
+            for (int i = 1; i < values.size(); ++i)
+                if (values[i - 1] > values[i])
+                    expect (false, "not stable at index " + String (i));
+        }
+
+        beginTest ("StringArray sort");
+        {
+            Random r (5678);
+            StringArray strings;
+
+            for (int i = 0; i < 20000; ++i)
+                strings.add (createRandomString (r));
+
+            for (int ignoreCase = 0; ignoreCase < 2; ++ignoreCase)
+            {
+                StringArray serial (strings), parallel (strings);
+                serial.sort (ignoreCase != 0);
+                parallel.sort (ignoreCase != 0, pool);
+
+                for (int i = 1; i < serial.size(); ++i)
+                {
+                    const int order = ignoreCase != 0 ? serial[i - 1].compareIgnoreCase (serial[i])
+                                                      : serial[i - 1].compare (serial[i]);
+                    if (order > 0)
+                        expect (false, "wrong order: " + serial[i - 1] + ", " + serial[i]);
+
+                    if ((ignoreCase != 0 ? serial[i].compareIgnoreCase (parallel[i])
+                                         : serial[i].compare (parallel[i])) != 0)
+                        expect (false, "mismatch at index " + String (i));
+                }
+            }
+        }
+    }
+};
+
+static ThreadPoolTests threadPoolTests;
+
+#endif
@@ -33,6 +33,7 @@
 #include "../text/juce_StringArray.h"
 #include "../containers/juce_Array.h"
 #include "../containers/juce_OwnedArray.h"
+#include "../memory/juce_Atomic.h"
 class ThreadPool;
 class ThreadPoolThread;
 
@@ -135,6 +136,35 @@ private:
 };
 
 
+//==============================================================================
+/**
+    A lightweight task that can be given to a ThreadPool with ThreadPool::addTask().
+
+    Unlike a ThreadPoolJob, a task has no name and can't be interrupted, removed or
+    re-run: it's simply called once by whichever pool thread gets to it first, and
+    is then deleted by the pool. Tasks are kept in per-thread queues, so adding and
+    running them doesn't involve the lock that protects the pool's list of jobs.
+
+    Rather than subclassing this yourself, it's often easier to give the pool a
+    function object with ThreadPool::addFunction(), or to use ThreadPool::parallelFor()
+    and ThreadPool::parallelReduce().
+
+    @see ThreadPool::addTask, ThreadPoolJob
+*/
+class JUCE_API  ThreadPoolTask
+{
+public:
+    /** Destructor. */
+    virtual ~ThreadPoolTask() {}
+
+    /** Performs the task's work.
+        This is called exactly once, on one of the pool's threads (or on a thread that's
+        waiting inside ThreadPool::parallelFor() or ThreadPool::parallelReduce()).
+    */
+    virtual void runTask() = 0;
+};
+
+
 //==============================================================================
 /**
     A set of threads that will run a list of jobs.
@@ -142,7 +172,14 @@ private:
     When a ThreadPoolJob object is added to the ThreadPool's list, its runJob() method
     will be called by the next pooled thread that becomes free.
 
-    @see ThreadPoolJob, Thread
+    As well as these jobs, the pool can also run large numbers of short-lived
+    ThreadPoolTask objects. Each thread keeps its own queue of these tasks, and a
+    thread that runs out of work will steal tasks from the other threads' queues,
+    so the pool can churn through thousands of tiny tasks without all its threads
+    fighting over a single lock. See addTask(), addFunction(), parallelFor() and
+    parallelReduce().
+
+    @see ThreadPoolJob, ThreadPoolTask, Thread
 */
 class JUCE_API  ThreadPool
 {
@@ -248,6 +285,9 @@ public:
     */
     int getNumJobs() const;
 
+    /** Returns the number of threads that the pool is running. */
+    int getNumThreads() const noexcept;
+
     /** Returns one of the jobs in the queue.
 
         Note that this can be a very volatile list as jobs might be continuously getting shifted
@@ -288,6 +328,102 @@ public:
     */
     bool setThreadPriorities (int newPriority);
 
+    //==============================================================================
+    /** Adds a lightweight task to the pool.
+
+        The pool takes ownership of the task, and will delete it after its runTask()
+        method has been called. If this is called from one of the pool's own threads,
+        the task goes onto that thread's queue; otherwise, the tasks are shared out
+        between the threads in turn. Idle threads will steal tasks from busy ones.
+
+        Any tasks that are still waiting to run when the pool is deleted will be
+        deleted without being run.
+
+        @see addFunction, ThreadPoolTask
+    */
+    void addTask (ThreadPoolTask* task);
+
+    /** Adds a function object to the pool as a lightweight task.
+
+        A copy of the function object is made, and the pool will call it (with no
+        arguments) exactly once, on one of its threads.
+        @see addTask
+    */
+    template <typename FunctionType>
+    void addFunction (const FunctionType& function)
+    {
+        addTask (new FunctionTask<FunctionType> (function));
+    }
+
+    /** Calls a function object for each integer in the range start to (end - 1), sharing
+        the work out between the pool's threads.
+
+        The range is divided into chunks of grainSize indexes (or if grainSize is zero or
+        less, a size is chosen to give each thread a few chunks), and each chunk is run as
+        a task with its own copy of the function object, which is called as  function (index).
+
+        This method doesn't return until all the indexes have been processed. While it's
+        waiting, the calling thread helps by running tasks itself, so it's safe to call
+        it from inside a task or a job that's running on this pool.
+    */
+    template <typename FunctionType>
+    void parallelFor (int start, int end, const FunctionType& function, int grainSize = 0)
+    {
+        if (end > start)
+        {
+            const int chunkSize = getChunkSize (end - start, grainSize);
+            TaskGroup group ((end - start + chunkSize - 1) / chunkSize);
+
+            for (int i = start; i < end; i += chunkSize)
+                addTask (new ParallelForTask<FunctionType> (function, group, i, jmin (end, i + chunkSize)));
+
+            waitForTaskGroup (group);
+        }
+    }
+
+    /** Combines the results of calling a function object for each integer in the range
+        start to (end - 1), sharing the work out between the pool's threads.
+
+        The function object is called as  function (index)  and must return a value of
+        ResultType, and the combiner is called as  combiner (a, b)  to merge two results.
+        The combiner must be associative, and identityValue must be a value that leaves
+        any other value unchanged when they're combined (e.g. 0 for addition).
+
+        The range is chunked in the same way as parallelFor(), and the results of each
+        chunk are combined in order of their position in the range, so for a given grain
+        size and number of threads, the result is always the same.
+    */
+    template <typename ResultType, typename FunctionType, typename CombinerType>
+    ResultType parallelReduce (int start, int end, const ResultType& identityValue,
+                               const FunctionType& function, const CombinerType& combiner,
+                               int grainSize = 0)
+    {
+        ResultType result (identityValue);
+
+        if (end > start)
+        {
+            const int chunkSize = getChunkSize (end - start, grainSize);
+            const int numChunks = (end - start + chunkSize - 1) / chunkSize;
+
+            Array<ResultType> chunkResults;
+            chunkResults.insertMultiple (0, identityValue, numChunks);
+
+            TaskGroup group (numChunks);
+
+            for (int i = 0; i < numChunks; ++i)
+                addTask (new ParallelReduceTask<ResultType, FunctionType, CombinerType>
+                            (function, combiner, group, chunkResults.getReference (i),
+                             start + i * chunkSize, jmin (end, start + (i + 1) * chunkSize)));
+
+            waitForTaskGroup (group);
+
+            for (int i = 0; i < numChunks; ++i)
+                result = combiner (result, chunkResults.getReference (i));
+        }
+
+        return result;
+    }
+
 
 private:
     //==============================================================================
@@ -301,7 +437,100 @@ private:
     CriticalSection lock;
     WaitableEvent jobFinishedSignal;
 
+    class TaskGroup
+    {
+    public:
+        explicit TaskGroup (int numTasks) noexcept  : numOutstanding (numTasks) {}
+
+        void taskFinished()
+        {
+            if (--numOutstanding == 0)
+                finished.signal();
+        }
+
+        Atomic<int> numOutstanding;
+        WaitableEvent finished;
+
+        // marks a task as finished even if its function throws, so that the waiter isn't left hanging
+        class ScopedTaskFinisher
+        {
+        public:
+            explicit ScopedTaskFinisher (TaskGroup& g) noexcept  : group (g) {}
+            ~ScopedTaskFinisher()   { group.taskFinished(); }
+
+        private:
+            TaskGroup& group;
+
+            JUCE_DECLARE_NON_COPYABLE (ScopedTaskFinisher)
+        };
+
+    private:
+        JUCE_DECLARE_NON_COPYABLE (TaskGroup)
+    };
+
+    template <typename FunctionType>
+    class FunctionTask  : public ThreadPoolTask
+    {
+    public:
+        FunctionTask (const FunctionType& f)  : function (f) {}
+        void runTask()      { function(); }
+
+    private:
+        FunctionType function;
+    };
+
+    template <typename FunctionType>
+    class ParallelForTask  : public ThreadPoolTask
+    {
+    public:
+        ParallelForTask (const FunctionType& f, TaskGroup& g, int s, int e)
+            : function (f), group (g), start (s), end (e) {}
+
+        void runTask()
+        {
+            const TaskGroup::ScopedTaskFinisher finisher (group);
+
+            for (int i = start; i < end; ++i)
+                function (i);
+        }
+
+    private:
+        FunctionType function;
+        TaskGroup& group;
+        const int start, end;
+    };
+
+    template <typename ResultType, typename FunctionType, typename CombinerType>
+    class ParallelReduceTask  : public ThreadPoolTask
+    {
+    public:
+        ParallelReduceTask (const FunctionType& f, const CombinerType& c, TaskGroup& g,
+                            ResultType& r, int s, int e)
+            : function (f), combiner (c), group (g), result (r), start (s), end (e) {}
+
+        void runTask()
+        {
+            const TaskGroup::ScopedTaskFinisher finisher (group);
+
+            for (int i = start; i < end; ++i)
+                result = combiner (result, function (i));
+        }
+
+    private:
+        FunctionType function;
+        CombinerType combiner;
+        TaskGroup& group;
+        ResultType& result;
+        const int start, end;
+    };
+
+    Atomic<int> nextTaskThread;
+
     bool runNextJob();
+    bool runNextTask (int threadIndex);
+    int getIndexOfCurrentThread() const noexcept;
+    int getChunkSize (int numItems, int grainSize) const noexcept;
+    void waitForTaskGroup (TaskGroup&);
     ThreadPoolJob* pickNextJobToRun();
     void addToDeleteList (OwnedArray<ThreadPoolJob>&, ThreadPoolJob*) const;
     void createThreads (int numThreads);
@@ -314,5 +543,168 @@ private:
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ThreadPool)
 };
 
+//==============================================================================
+#ifndef DOXYGEN
+namespace ParallelSortHelpers
+{
+    template <class ElementType, class ElementComparator>
+    struct SortChunk
+    {
+        SortChunk (ElementComparator& c, ElementType* e, int num, int size, bool stable) noexcept
+            : comparator (c), elements (e), numElements (num), chunkSize (size), retainOrder (stable)
+        {}
+
+        void operator() (const int chunk) const
+        {
+            const int start = chunk * chunkSize;
+            sortArray (comparator, elements, start, jmin (numElements, start + chunkSize) - 1, retainOrder);
+        }
+
+        ElementComparator& comparator;
+        ElementType* const elements;
+        const int numElements, chunkSize;
+        const bool retainOrder;
+    };
+
+    /*  Merges pairs of adjacent sorted runs from source into dest. Each pair is split into
+        several pieces so that the last few passes (which only have a couple of pairs) can
+        still use all the threads: the first run is divided evenly, and a binary search finds
+        the matching split points in the second one. Equal elements are always taken from the
+        first run first, so the merge is stable.
+    */
+    template <class ElementType, class ElementComparator>
+    struct MergeRuns
+    {
+        MergeRuns (ElementComparator& c, ElementType* s, ElementType* d,
+                   int num, int length, int pieces) noexcept
+            : comparator (c), source (s), dest (d), numElements (num),
+              runLength (length), piecesPerPair (pieces)
+        {}
+
+        void operator() (const int task) const
+        {
+            const int piece = task % piecesPerPair;
+            const int start = (task / piecesPerPair) * 2 * runLength;
+            const int mid = jmin (numElements, start + runLength);
+            const int end = jmin (numElements, mid + runLength);
+
+            const int aStart = start + (int) (((int64) (mid - start) * piece) / piecesPerPair);
+            const int aEnd   = start + (int) (((int64) (mid - start) * (piece + 1)) / piecesPerPair);
+            const int bStart = piece == 0 ? mid : findSplit (aStart, mid, end);
+            const int bEnd   = piece == piecesPerPair - 1 ? end : findSplit (aEnd, mid, end);
+
+            merge (aStart, aEnd, bStart, bEnd, dest + aStart + (bStart - mid));
+        }
+
+        // returns the first element of the second run which mustn't come before source[splitIndex]
+        int findSplit (const int splitIndex, const int mid, int end) const
+        {
+            if (splitIndex >= mid)
+                return end;
+
+            int begin = mid;
+
+            while (begin < end)
+            {
+                const int halfway = begin + ((end - begin) >> 1);
+
+                if (comparator.compareElements (source[halfway], source[splitIndex]) < 0)
+                    begin = halfway + 1;
+                else
+                    end = halfway;
+            }
+
+            return begin;
+        }
+
+        void merge (int a, const int aEnd, int b, const int bEnd, ElementType* out) const
+        {
+            while (a < aEnd && b < bEnd)
+            {
+                if (comparator.compareElements (source[b], source[a]) < 0)
+                    *out++ = source[b++];
+                else
+                    *out++ = source[a++];
+            }
+
+            while (a < aEnd)  *out++ = source[a++];
+            while (b < bEnd)  *out++ = source[b++];
+        }
+
+        ElementComparator& comparator;
+        ElementType* const source;
+        ElementType* const dest;
+        const int numElements, runLength, piecesPerPair;
+    };
+
+    template <class ElementType>
+    struct CopyChunk
+    {
+        CopyChunk (const ElementType* s, ElementType* d, int num, int size) noexcept
+            : source (s), dest (d), numElements (num), chunkSize (size)
+        {}
+
+        void operator() (const int chunk) const
+        {
+            for (int i = chunk * chunkSize, end = jmin (numElements, i + chunkSize); i < end; ++i)
+                dest[i] = source[i];
+        }
+
+        const ElementType* const source;
+        ElementType* const dest;
+        const int numElements, chunkSize;
+    };
+}
+#endif
+
+template <class ElementType, class ElementComparator>
+void parallelSortArray (ThreadPool& pool,
+                        ElementComparator& comparator,
+                        ElementType* const array,
+                        const int numElements,
+                        const bool retainOrderOfEquivalentItems)
+{
+    using namespace ParallelSortHelpers;
+
+    // below this size, a chunk isn't worth the overhead of a task
+    const int minChunkSize = 2048;
+
+    int numChunks = 1;
+    while (numChunks < pool.getNumThreads() * 4 && numElements / (numChunks * 2) >= minChunkSize)
+        numChunks *= 2;
+
+    if (numChunks < 2)
+    {
+        sortArray (comparator, array, 0, numElements - 1, retainOrderOfEquivalentItems);
+        return;
+    }
+
+    const int chunkSize = (numElements + numChunks - 1) / numChunks;
+
+    pool.parallelFor (0, numChunks, SortChunk<ElementType, ElementComparator> (comparator, array, numElements,
+                                                                               chunkSize, retainOrderOfEquivalentItems), 1);
+
+    Array<ElementType> temp;
+    temp.addArray (static_cast<const ElementType*> (array), numElements);
+
+    ElementType* source = array;
+    ElementType* dest = temp.getRawDataPointer();
+
+    for (int runLength = chunkSize, numRuns = numChunks; numRuns > 1; runLength *= 2)
+    {
+        const int numPairs = (numRuns + 1) / 2;
+        const int piecesPerPair = numChunks / numPairs;
+
+        pool.parallelFor (0, numPairs * piecesPerPair,
+                          MergeRuns<ElementType, ElementComparator> (comparator, source, dest, numElements,
+                                                                     runLength, piecesPerPair), 1);
+        std::swap (source, dest);
+        numRuns = numPairs;
+    }
+
+    if (source != array)
+        pool.parallelFor (0, numChunks, CopyChunk<ElementType> (source, array, numElements, chunkSize), 1);
+}
+
 
 #endif   // __JUCE_THREADPOOL_JUCEHEADER__
@@ -0,0 +1,257 @@
+/*
+  ==============================================================================
+
+   This file is part of the juce_core module of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission to use, copy, modify, and/or distribute this software for any purpose with
+   or without fee is hereby granted, provided that the above copyright notice and this
+   permission notice appear in all copies.
+
+   THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+   TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+   NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+   DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+   IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+   ------------------------------------------------------------------------------
+
+   NOTE! This permissive ISC license applies ONLY to files within the juce_core module!
+   All other JUCE modules are covered by a dual GPL/commercial license, so if you are
+   using any other modules, be sure to check that you also comply with their license.
+
+   For more details, visit www.juce.com
+
+  ==============================================================================
+*/
+
+TimeSlicePool::TimeSlicePool (const String& threadName, const int numberOfThreads)
+{
+    jassert (numberOfThreads > 0); // not much point making a pool without any threads!
+
+    for (int i = 0; i < numberOfThreads; ++i)
+        threads.add (new TimeSliceThread (threadName + " " + String (i + 1)));
+}
+
+TimeSlicePool::~TimeSlicePool()
+{
+    stopThreads (2000);
+}
+
+//==============================================================================
+void TimeSlicePool::startThreads (const int priority)
+{
+    for (int i = 0; i < threads.size(); ++i)
+        threads.getUnchecked(i)->startThread (priority);
+}
+
+void TimeSlicePool::stopThreads (const int timeOutMilliseconds)
+{
+    for (int i = 0; i < threads.size(); ++i)
+        threads.getUnchecked(i)->signalThreadShouldExit();
+
+    for (int i = 0; i < threads.size(); ++i)
+        threads.getUnchecked(i)->stopThread (timeOutMilliseconds);
+}
+
+//==============================================================================
+void TimeSlicePool::addTimeSliceClient (TimeSliceClient* const client, const int millisecondsBeforeStarting)
+{
+    if (client != nullptr)
+    {
+        const ScopedLock sl (lock);
+
+        TimeSliceThread* thread = getThreadForClient (client);
+
+        if (thread == nullptr)
+            thread = getLeastBusyThread();
+
+        if (thread != nullptr)
+            thread->addTimeSliceClient (client, millisecondsBeforeStarting);
+    }
+}
+
+void TimeSlicePool::removeTimeSliceClient (TimeSliceClient* const client)
+{
+    const ScopedLock sl (lock);
+
+    if (TimeSliceThread* const thread = getThreadForClient (client))
+        thread->removeTimeSliceClient (client);
+}
+
+void TimeSlicePool::moveToFrontOfQueue (TimeSliceClient* const client)
+{
+    const ScopedLock sl (lock);
+
+    if (TimeSliceThread* const thread = getThreadForClient (client))
+        thread->moveToFrontOfQueue (client);
+}
+
+int TimeSlicePool::getNumClients() const
+{
+    int total = 0;
+
+    for (int i = threads.size(); --i >= 0;)
+        total += threads.getUnchecked(i)->getNumClients();
+
+    return total;
+}
+
+TimeSliceThread* TimeSlicePool::getThreadForClient (TimeSliceClient* const client) const
+{
+    for (int i = threads.size(); --i >= 0;)
+        if (threads.getUnchecked(i)->containsClient (client))
+            return threads.getUnchecked(i);
+
+    return nullptr;
+}
+
+TimeSliceClient::Statistics TimeSlicePool::getClientStatistics (TimeSliceClient* const client) const
+{
+    if (TimeSliceThread* const thread = getThreadForClient (client))
+        return thread->getClientStatistics (client);
+
+    return TimeSliceClient::Statistics();
+}
+
+TimeSliceThread* TimeSlicePool::getLeastBusyThread() const
+{
+    TimeSliceThread* best = nullptr;
+    int bestNumClients = 0;
+    double bestRunTime = 0;
+
+    for (int i = 0; i < threads.size(); ++i)
+    {
+        TimeSliceThread* const t = threads.getUnchecked(i);
+        const int numClients = t->getNumClients();
+        const double runTime = t->getTotalClientRunTime();
+
+        if (best == nullptr || numClients < bestNumClients
+             || (numClients == bestNumClients && runTime < bestRunTime))
+        {
+            best = t;
+            bestNumClients = numClients;
+            bestRunTime = runTime;
+        }
+    }
+
+    return best;
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class TimeSlicePoolTests  : public UnitTest
+{
+public:
+    TimeSlicePoolTests() : UnitTest ("TimeSlicePool") {}
+
+    struct TestClient  : public TimeSliceClient
+    {
+        TestClient (Array<int, CriticalSection>& order_, int id_, int runTimeMs_, int interval_)
+            : order (order_), id (id_), runTimeMs (runTimeMs_), interval (interval_)
+        {}
+
+        int useTimeSlice()
+        {
+            order.add (id);
+
+            if (runTimeMs > 0)
+                Thread::sleep (runTimeMs);
+
+            return interval;
+        }
+
+        Array<int, CriticalSection>& order;
+        const int id, runTimeMs, interval;
+    };
+
+    void runTest()
+    {
+        beginTest ("Clients are called in deadline order");
+
+        {
+            Array<int, CriticalSection> order;
+            TestClient c1 (order, 1, 0, -1), c2 (order, 2, 0, -1), c3 (order, 3, 0, -1);
+
+            TimeSliceThread thread ("test");
+            thread.addTimeSliceClient (&c1, 150);
+            thread.addTimeSliceClient (&c2, 50);
+            thread.addTimeSliceClient (&c3, 100);
+            expect (thread.getNumClients() == 3);
+            thread.startThread();
+
+            waitFor (order, 3);
+            expect (order.size() == 3 && order[0] == 2 && order[1] == 3 && order[2] == 1);
+            expect (thread.getNumClients() == 0);
+        }
+
+        beginTest ("Statistics");
+
+        {
+            Array<int, CriticalSection> order;
+            TestClient slow (order, 1, 20, 0), fast (order, 2, 0, 5);
+
+            TimeSliceThread thread ("test");
+            thread.addTimeSliceClient (&slow);
+            thread.addTimeSliceClient (&fast);
+            thread.startThread();
+
+            waitFor (order, 20);
+            thread.stopThread (2000);
+
+            const TimeSliceClient::Statistics slowStats (thread.getClientStatistics (&slow));
+            const TimeSliceClient::Statistics fastStats (thread.getClientStatistics (&fast));
+
+            expect (slowStats.numCalls > 0 && fastStats.numCalls > 0);
+            expect (slowStats.longestRunTime >= 0.015);
+            expect (slowStats.totalRunTime > fastStats.totalRunTime);
+            expect (fastStats.longestLateness > 0.005);  // it's being held up by the slow client
+            expect (thread.getTotalClientRunTime() >= slowStats.totalRunTime);
+
+            thread.removeTimeSliceClient (&slow);
+            expect (! thread.containsClient (&slow));
+            expect (thread.getClientStatistics (&slow).numCalls == 0);
+        }
+
+        beginTest ("Pool");
+
+        {
+            Array<int, CriticalSection> order;
+            TestClient c1 (order, 1, 0, 10), c2 (order, 2, 0, 10), c3 (order, 3, 0, 10), c4 (order, 4, 0, 10);
+
+            TimeSlicePool pool ("test", 2);
+            pool.addTimeSliceClient (&c1);
+            pool.addTimeSliceClient (&c2);
+            pool.addTimeSliceClient (&c3);
+            pool.addTimeSliceClient (&c4);
+
+            expect (pool.getNumClients() == 4);
+            expect (pool.getThread(0)->getNumClients() == 2);
+            expect (pool.getThread(1)->getNumClients() == 2);
+            expect (pool.getThreadForClient (&c1) != pool.getThreadForClient (&c2));
+
+            pool.startThreads();
+            waitFor (order, 20);
+
+            for (int i = 1; i <= 4; ++i)
+                expect (order.contains (i));
+
+            pool.removeTimeSliceClient (&c3);
+            expect (pool.getNumClients() == 3);
+            expect (pool.getThreadForClient (&c3) == nullptr);
+            pool.stopThreads (2000);
+        }
+    }
+
+    static void waitFor (const Array<int, CriticalSection>& order, const int numCalls)
+    {
+        for (int i = 0; i < 500 && order.size() < numCalls; ++i)
+            Thread::sleep (10);
+    }
+};
+
+static TimeSlicePoolTests timeSlicePoolTests;
+
+#endif
@@ -0,0 +1,133 @@
+/*
+  ==============================================================================
+
+   This file is part of the juce_core module of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission to use, copy, modify, and/or distribute this software for any purpose with
+   or without fee is hereby granted, provided that the above copyright notice and this
+   permission notice appear in all copies.
+
+   THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+   TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+   NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+   DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+   IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+   ------------------------------------------------------------------------------
+
+   NOTE! This permissive ISC license applies ONLY to files within the juce_core module!
+   All other JUCE modules are covered by a dual GPL/commercial license, so if you are
+   using any other modules, be sure to check that you also comply with their license.
+
+   For more details, visit www.juce.com
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_TIMESLICEPOOL_JUCEHEADER__
+#define __JUCE_TIMESLICEPOOL_JUCEHEADER__
+
+#include "juce_TimeSliceThread.h"
+#include "../containers/juce_OwnedArray.h"
+
+
+//==============================================================================
+/**
+    Shares a set of TimeSliceClient objects among several TimeSliceThreads.
+
+    A single TimeSliceThread can only call one client at a time, so a client that
+    takes a long time in its useTimeSlice() method (e.g. one that's waiting on a slow
+    disk) will delay all the others. A TimeSlicePool runs a number of threads and puts
+    each new client on whichever of them is least loaded, so that one slow client can
+    only hold up the clients that happen to share its thread.
+
+    You can use TimeSliceThread::getClientStatistics() on the threads returned by
+    getThreadForClient() to find out which clients are using the most time.
+
+    @see TimeSliceThread, TimeSliceClient
+*/
+class JUCE_API  TimeSlicePool
+{
+public:
+    //==============================================================================
+    /** Creates a pool with the given number of threads.
+
+        The threads are named by appending a number to the name that you supply.
+        When first created, the threads are not running - call startThreads() to
+        start them.
+    */
+    TimeSlicePool (const String& threadName, int numberOfThreads);
+
+    /** Destructor.
+        This will stop all the threads, so make sure your clients can cope with that.
+    */
+    ~TimeSlicePool();
+
+    //==============================================================================
+    /** Starts all the threads, at the given priority.
+        @see Thread::startThread
+    */
+    void startThreads (int priority = 5);
+
+    /** Stops all the threads, waiting up to the given time for each one to exit.
+        @see Thread::stopThread
+    */
+    void stopThreads (int timeOutMilliseconds);
+
+    //==============================================================================
+    /** Adds a client to the least busy of the pool's threads.
+
+        The thread chosen is the one with the fewest clients, or if several threads
+        have the same number, the one whose clients have been using the least time.
+
+        @see TimeSliceThread::addTimeSliceClient
+    */
+    void addTimeSliceClient (TimeSliceClient* client, int millisecondsBeforeStarting = 0);
+
+    /** Removes a client from whichever thread it's running on.
+
+        This method will make sure that all callbacks to the client have completely
+        finished before the method returns.
+    */
+    void removeTimeSliceClient (TimeSliceClient* client);
+
+    /** If the given client is waiting in the queue, it will be given a time-slice
+        as soon as possible.
+        @see TimeSliceThread::moveToFrontOfQueue
+    */
+    void moveToFrontOfQueue (TimeSliceClient* client);
+
+    /** Returns the total number of clients on all the threads. */
+    int getNumClients() const;
+
+    //==============================================================================
+    /** Returns the number of threads in the pool. */
+    int getNumThreads() const noexcept                      { return threads.size(); }
+
+    /** Returns one of the pool's threads. */
+    TimeSliceThread* getThread (int index) const noexcept   { return threads [index]; }
+
+    /** Returns the thread that the given client is running on, or nullptr if it
+        isn't registered with this pool.
+    */
+    TimeSliceThread* getThreadForClient (TimeSliceClient* client) const;
+
+    /** Returns the timing statistics for a client on any of the pool's threads.
+        @see TimeSliceThread::getClientStatistics
+    */
+    TimeSliceClient::Statistics getClientStatistics (TimeSliceClient* client) const;
+
+private:
+    //==============================================================================
+    OwnedArray<TimeSliceThread> threads;
+    CriticalSection lock;
+
+    TimeSliceThread* getLeastBusyThread() const;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TimeSlicePool)
+};
+
+
+#endif   // __JUCE_TIMESLICEPOOL_JUCEHEADER__
@@ -26,9 +26,17 @@
   ==============================================================================
 */
 
+TimeSliceClient::Statistics::Statistics() noexcept
+    : numCalls (0), totalRunTime (0), longestRunTime (0),
+      totalLateness (0), longestLateness (0)
+{
+}
+
+//==============================================================================
 TimeSliceThread::TimeSliceThread (const String& name)
     : Thread (name),
-      clientBeingCalled (nullptr)
+      clientBeingCalled (nullptr),
+      nextCallOrder (0)
 {
 }
 
@@ -43,8 +51,15 @@ void TimeSliceThread::addTimeSliceClient (TimeSliceClient* const client, int mil
     if (client != nullptr)
     {
         const ScopedLock sl (listLock);
-        client->nextCallTime = Time::getCurrentTime() + RelativeTime::milliseconds (millisecondsBeforeStarting);
-        clients.addIfNotAlreadyThere (client);
+
+        if (! isInHeap (client))
+        {
+            client->heapIndex = clients.size();
+            client->statistics = TimeSliceClient::Statistics();
+            clients.add (client);
+        }
+
+        rescheduleClient (client, Time::getCurrentTime() + RelativeTime::milliseconds (millisecondsBeforeStarting));
         notify();
     }
 }
@@ -62,11 +77,11 @@ void TimeSliceThread::removeTimeSliceClient (TimeSliceClient* const client)
         const ScopedLock sl2 (callbackLock);
         const ScopedLock sl3 (listLock);
 
-        clients.removeFirstMatchingValue (client);
+        removeFromHeap (client);
     }
     else
     {
-        clients.removeFirstMatchingValue (client);
+        removeFromHeap (client);
     }
 }
 
@@ -74,9 +89,11 @@ void TimeSliceThread::moveToFrontOfQueue (TimeSliceClient* client)
 {
     const ScopedLock sl (listLock);
 
-    if (clients.contains (client))
+    if (isInHeap (client))
     {
         client->nextCallTime = Time::getCurrentTime();
+        client->callOrder = 0;  // ahead of any other client that's due at the same moment
+        updateHeapPosition (client->heapIndex);
         notify();
     }
 }
@@ -92,29 +109,167 @@ TimeSliceClient* TimeSliceThread::getClient (const int i) const
     return clients [i];
 }
 
+bool TimeSliceThread::containsClient (TimeSliceClient* const client) const
+{
+    const ScopedLock sl (listLock);
+    return isInHeap (client);
+}
+
 //==============================================================================
-TimeSliceClient* TimeSliceThread::getNextClient (int index) const
+TimeSliceClient::Statistics TimeSliceThread::getClientStatistics (TimeSliceClient* const client) const
+{
+    const ScopedLock sl (listLock);
+    return isInHeap (client) ? client->statistics : TimeSliceClient::Statistics();
+}
+
+double TimeSliceThread::getTotalClientRunTime() const
+{
+    const ScopedLock sl (listLock);
+    double total = 0;
+
+    for (int i = clients.size(); --i >= 0;)
+        total += clients.getUnchecked(i)->statistics.totalRunTime;
+
+    return total;
+}
+
+void TimeSliceThread::resetClientStatistics()
 {
-    Time soonest;
-    TimeSliceClient* client = nullptr;
+    const ScopedLock sl (listLock);
 
     for (int i = clients.size(); --i >= 0;)
+        clients.getUnchecked(i)->statistics = TimeSliceClient::Statistics();
+}
+
+//==============================================================================
+bool TimeSliceThread::isInHeap (const TimeSliceClient* const client) const noexcept
+{
+    return client != nullptr
+            && isPositiveAndBelow (client->heapIndex, clients.size())
+            && clients.getUnchecked (client->heapIndex) == client;
+}
+
+bool TimeSliceThread::isDueBefore (const TimeSliceClient* const a, const TimeSliceClient* const b) const noexcept
+{
+    return a->nextCallTime < b->nextCallTime
+            || (a->nextCallTime == b->nextCallTime && a->callOrder < b->callOrder);
+}
+
+void TimeSliceThread::swapHeapEntries (const int index1, const int index2) noexcept
+{
+    clients.swap (index1, index2);
+    clients.getUnchecked (index1)->heapIndex = index1;
+    clients.getUnchecked (index2)->heapIndex = index2;
+}
+
+void TimeSliceThread::updateHeapPosition (int index) noexcept
+{
+    while (index > 0)
+    {
+        const int parent = (index - 1) / 2;
+
+        if (! isDueBefore (clients.getUnchecked (index), clients.getUnchecked (parent)))
+            break;
+
+        swapHeapEntries (index, parent);
+        index = parent;
+    }
+
+    for (;;)
     {
-        TimeSliceClient* const c = clients.getUnchecked ((i + index) % clients.size());
+        const int left = 2 * index + 1;
 
-        if (client == nullptr || c->nextCallTime < soonest)
+        if (left >= clients.size())
+            break;
+
+        const int right = left + 1;
+        const int child = (right < clients.size() && isDueBefore (clients.getUnchecked (right), clients.getUnchecked (left)))
+                            ? right : left;
+
+        if (! isDueBefore (clients.getUnchecked (child), clients.getUnchecked (index)))
+            break;
+
+        swapHeapEntries (index, child);
+        index = child;
+    }
+}
+
+void TimeSliceThread::removeFromHeap (TimeSliceClient* const client) noexcept
+{
+    if (isInHeap (client))
+    {
+        const int index = client->heapIndex;
+        const int last = clients.size() - 1;
+
+        if (index != last)
+            swapHeapEntries (index, last);
+
+        clients.removeLast();
+        client->heapIndex = -1;
+
+        if (index < clients.size())
+            updateHeapPosition (index);
+    }
+}
+
+void TimeSliceThread::rescheduleClient (TimeSliceClient* const client, Time nextCallTime) noexcept
+{
+    client->nextCallTime = nextCallTime;
+    client->callOrder = ++nextCallOrder;
+    updateHeapPosition (client->heapIndex);
+}
+
+//==============================================================================
+void TimeSliceThread::callNextClient()
+{
+    const ScopedLock sl (callbackLock);
+    const Time now (Time::getCurrentTime());
+    double lateness = 0;
+
+    {
+        const ScopedLock sl2 (listLock);
+        clientBeingCalled = clients.size() > 0 ? clients.getUnchecked (0) : nullptr;
+
+        if (clientBeingCalled != nullptr)
+            lateness = jmax (0.0, (now - clientBeingCalled->nextCallTime).inSeconds());
+    }
+
+    if (clientBeingCalled != nullptr)
+    {
+        const int64 startTicks = Time::getHighResolutionTicks();
+        const int msUntilNextCall = clientBeingCalled->useTimeSlice();
+        const int64 endTicks = Time::getHighResolutionTicks();
+        const double runTime = Time::highResolutionTicksToSeconds (endTicks - startTicks);
+
+       #if JUCE_ENABLE_TRACING
+        TraceLog::addCompleteEvent ("TimeSliceClient", startTicks, endTicks);
+       #endif
+
+        const ScopedLock sl2 (listLock);
+
+        // (the client may have removed itself during its callback)
+        if (isInHeap (clientBeingCalled))
         {
-            client = c;
-            soonest = c->nextCallTime;
+            TimeSliceClient::Statistics& stats = clientBeingCalled->statistics;
+            ++stats.numCalls;
+            stats.totalRunTime += runTime;
+            stats.longestRunTime = jmax (stats.longestRunTime, runTime);
+            stats.totalLateness += lateness;
+            stats.longestLateness = jmax (stats.longestLateness, lateness);
+
+            if (msUntilNextCall >= 0)
+                rescheduleClient (clientBeingCalled, now + RelativeTime::milliseconds (msUntilNextCall));
+            else
+                removeFromHeap (clientBeingCalled);
         }
-    }
 
-    return client;
+        clientBeingCalled = nullptr;
+    }
 }
 
 void TimeSliceThread::run()
 {
-    int index = 0;
+    int numCallsWithoutWaiting = 0;
 
     while (! threadShouldExit())
     {
@@ -122,50 +277,39 @@ void TimeSliceThread::run()
 
         {
             Time nextClientTime;
+            int numClients;
 
             {
                 const ScopedLock sl2 (listLock);
+                numClients = clients.size();
 
-                index = clients.size() > 0 ? ((index + 1) % clients.size()) : 0;
-
-                if (TimeSliceClient* const firstClient = getNextClient (index))
-                    nextClientTime = firstClient->nextCallTime;
+                if (numClients > 0)
+                    nextClientTime = clients.getUnchecked (0)->nextCallTime;
             }
 
-            const Time now (Time::getCurrentTime());
-
-            if (nextClientTime > now)
+            if (numClients > 0)
             {
-                timeToWait = (int) jmin ((int64) 500, (nextClientTime - now).inMilliseconds());
-            }
-            else
-            {
-                timeToWait = index == 0 ? 1 : 0;
-
-                const ScopedLock sl (callbackLock);
+                const Time now (Time::getCurrentTime());
 
+                if (nextClientTime > now)
                 {
-                    const ScopedLock sl2 (listLock);
-                    clientBeingCalled = getNextClient (index);
+                    timeToWait = (int) jmin ((int64) 500, (nextClientTime - now).inMilliseconds());
                 }
-
-                if (clientBeingCalled != nullptr)
+                else
                 {
-                    const int msUntilNextCall = clientBeingCalled->useTimeSlice();
-
-                    const ScopedLock sl2 (listLock);
-
-                    if (msUntilNextCall >= 0)
-                        clientBeingCalled->nextCallTime = now + RelativeTime::milliseconds (msUntilNextCall);
-                    else
-                        clients.removeFirstMatchingValue (clientBeingCalled);
+                    // after giving each client a turn without a break, have a short
+                    // rest to avoid hogging the CPU when they're all busy
+                    timeToWait = ++numCallsWithoutWaiting >= numClients ? 1 : 0;
 
-                    clientBeingCalled = nullptr;
+                    callNextClient();
                 }
             }
         }
 
         if (timeToWait > 0)
+        {
+            numCallsWithoutWaiting = 0;
             wait (timeToWait);
+        }
     }
 }
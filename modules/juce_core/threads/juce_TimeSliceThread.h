@@ -50,6 +50,9 @@ class TimeSliceThread;
 class JUCE_API  TimeSliceClient
 {
 public:
+    /** Creates a client. */
+    TimeSliceClient() noexcept   : callOrder (0), heapIndex (-1) {}
+
     /** Destructor. */
     virtual ~TimeSliceClient()   {}
 
@@ -70,10 +73,37 @@ public:
     */
     virtual int useTimeSlice() = 0;
 
+    //==============================================================================
+    /** Timing information that a TimeSliceThread gathers about each of its clients.
+
+        A client whose average or longest run time is large will delay every other
+        client on the same thread; the lateness figures show how far behind schedule
+        a client's callbacks have been running, i.e. how much it is being starved.
+
+        @see TimeSliceThread::getClientStatistics
+    */
+    struct JUCE_API  Statistics
+    {
+        Statistics() noexcept;
+
+        /** The number of times useTimeSlice() has been called. */
+        int numCalls;
+
+        /** The total and longest time spent inside useTimeSlice(), in seconds. */
+        double totalRunTime, longestRunTime;
+
+        /** The total and longest delay between the time at which a callback was due
+            and the time at which it actually started, in seconds.
+        */
+        double totalLateness, longestLateness;
+    };
 
 private:
     friend class TimeSliceThread;
     Time nextCallTime;
+    int64 callOrder;
+    int heapIndex;
+    Statistics statistics;
 };
 
 
@@ -82,7 +112,14 @@ private:
     A thread that keeps a list of clients, and calls each one in turn, giving them
     all a chance to run some sort of short task.
 
-    @see TimeSliceClient, Thread
+    Clients are called in order of the time at which they asked to be called back,
+    so a busy client can't stop others that are due from getting their turn, and
+    clients that are due at the same moment are served in first-come-first-served
+    order. If a single client is slow enough to hold up the others, you can move it
+    onto a different thread, or use a TimeSlicePool to share the clients among
+    several threads.
+
+    @see TimeSliceClient, TimeSlicePool, Thread
 */
 class JUCE_API  TimeSliceThread   : public Thread
 {
@@ -129,9 +166,30 @@ public:
     /** Returns the number of registered clients. */
     int getNumClients() const;
 
-    /** Returns one of the registered clients. */
+    /** Returns one of the registered clients.
+        The clients are not stored in any particular order.
+    */
     TimeSliceClient* getClient (int index) const;
 
+    /** Returns true if the given client is registered with this thread. */
+    bool containsClient (TimeSliceClient* client) const;
+
+    //==============================================================================
+    /** Returns the timing statistics that have been gathered for one of this
+        thread's clients.
+        If the client isn't registered with this thread, an empty set of statistics
+        is returned.
+    */
+    TimeSliceClient::Statistics getClientStatistics (TimeSliceClient* client) const;
+
+    /** Returns the total time, in seconds, that this thread has spent calling its
+        current clients since they were added or their statistics were last reset.
+    */
+    double getTotalClientRunTime() const;
+
+    /** Clears the timing statistics of all the registered clients. */
+    void resetClientStatistics();
+
     //==============================================================================
    #ifndef DOXYGEN
     void run();
@@ -140,10 +198,17 @@ public:
     //==============================================================================
 private:
     CriticalSection callbackLock, listLock;
-    Array <TimeSliceClient*> clients;
+    Array <TimeSliceClient*> clients;  // a binary heap, ordered by next call time
     TimeSliceClient* clientBeingCalled;
-
-    TimeSliceClient* getNextClient (int index) const;
+    int64 nextCallOrder;
+
+    bool isInHeap (const TimeSliceClient*) const noexcept;
+    bool isDueBefore (const TimeSliceClient*, const TimeSliceClient*) const noexcept;
+    void swapHeapEntries (int, int) noexcept;
+    void updateHeapPosition (int index) noexcept;
+    void removeFromHeap (TimeSliceClient*) noexcept;
+    void rescheduleClient (TimeSliceClient*, Time nextCallTime) noexcept;
+    void callNextClient();
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TimeSliceThread)
 };
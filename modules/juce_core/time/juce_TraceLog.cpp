@@ -0,0 +1,289 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+
+namespace TraceLogHelpers
+{
+    struct Event
+    {
+        const char* name;
+        int64 startTicks, endTicks;
+        int id;
+        bool isInstant;
+    };
+
+    //==============================================================================
+    // A ring buffer which is only written by its own thread. When the reader copies
+    // it, it checks the write position again afterwards so that it can throw away
+    // any events that were overwritten while it was copying them.
+    struct ThreadBuffer
+    {
+        ThreadBuffer (int capacity_, int threadIndex_)
+            : events ((size_t) capacity_), capacity (capacity_), threadIndex (threadIndex_), next (nullptr)
+        {
+            if (Thread* const t = Thread::getCurrentThread())
+                name = t->getThreadName();
+            else
+                name = "Thread " + String (threadIndex);
+        }
+
+        void add (const Event& e) noexcept
+        {
+            const int64 pos = writePosition.get();
+            events [(int) (pos % capacity)] = e;
+            writePosition.set (pos + 1);
+        }
+
+        void copyEvents (Array<Event>& dest) const
+        {
+            const int64 end = writePosition.get();
+            const int64 start = jmax (clearedPosition.get(), end - capacity);
+
+            dest.ensureStorageAllocated ((int) (end - start));
+
+            for (int64 i = start; i < end; ++i)
+                dest.add (events [(int) (i % capacity)]);
+
+            // (the writer may be halfway through replacing the slot after its last one)
+            const int64 oldestIntact = writePosition.get() - capacity + 1;
+
+            if (oldestIntact > start)
+                dest.removeRange (0, (int) jmin (oldestIntact - start, end - start));
+        }
+
+        void clear() noexcept
+        {
+            clearedPosition.set (writePosition.get());
+        }
+
+        String getName() const
+        {
+            const SpinLock::ScopedLockType sl (nameLock);
+            return name;
+        }
+
+        void setName (const String& newName)
+        {
+            const SpinLock::ScopedLockType sl (nameLock);
+            name = newName;
+        }
+
+        HeapBlock<Event> events;
+        const int capacity, threadIndex;
+        Atomic<int64> writePosition, clearedPosition;
+        ThreadBuffer* next;
+
+    private:
+        SpinLock nameLock;
+        String name;
+
+        JUCE_DECLARE_NON_COPYABLE (ThreadBuffer)
+    };
+
+    //==============================================================================
+    struct Registry
+    {
+        Registry() noexcept  : bufferSize (16384), enabled (1)
+        {
+        }
+
+        ~Registry()
+        {
+            for (ThreadBuffer* b = buffers.get(); b != nullptr;)
+            {
+                ThreadBuffer* const next = b->next;
+                delete b;
+                b = next;
+            }
+        }
+
+        ThreadBuffer& getBufferForThisThread()
+        {
+            ThreadBuffer*& b = localBuffer.get();
+
+            if (b == nullptr)
+            {
+                b = new ThreadBuffer (bufferSize.get(), ++numBuffers);
+
+                for (;;)
+                {
+                    b->next = buffers.get();
+
+                    if (buffers.compareAndSetBool (b, b->next))
+                        break;
+                }
+            }
+
+            return *b;
+        }
+
+        ThreadLocalValue<ThreadBuffer*> localBuffer;
+        Atomic<ThreadBuffer*> buffers;
+        Atomic<int> bufferSize, enabled, numBuffers;
+
+        JUCE_DECLARE_NON_COPYABLE (Registry)
+    };
+
+    static Registry& getRegistry()
+    {
+        static Registry registry;
+        return registry;
+    }
+
+    //==============================================================================
+    struct ThreadEvents
+    {
+        int threadIndex;
+        String name;
+        Array<Event> events;
+    };
+
+    static String toMicroseconds (int64 ticks)
+    {
+        return String (Time::highResolutionTicksToSeconds (ticks) * 1000000.0, 3);
+    }
+
+    static String quoted (const char* text)
+    {
+        return JSON::toString (var (String (CharPointer_UTF8 (text))));
+    }
+}
+
+//==============================================================================
+void TraceLog::addCompleteEvent (const char* name, int64 startTicks, int64 endTicks, int id) noexcept
+{
+    using namespace TraceLogHelpers;
+    Registry& registry = getRegistry();
+
+    if (registry.enabled.get() != 0)
+    {
+        const Event e = { name, startTicks, endTicks, id, false };
+        registry.getBufferForThisThread().add (e);
+    }
+}
+
+void TraceLog::addInstantEvent (const char* name, int id) noexcept
+{
+    using namespace TraceLogHelpers;
+    Registry& registry = getRegistry();
+
+    if (registry.enabled.get() != 0)
+    {
+        const int64 now = Time::getHighResolutionTicks();
+        const Event e = { name, now, now, id, true };
+        registry.getBufferForThisThread().add (e);
+    }
+}
+
+void TraceLog::setCurrentThreadName (const String& name)
+{
+    TraceLogHelpers::getRegistry().getBufferForThisThread().setName (name);
+}
+
+void TraceLog::setEnabled (const bool shouldBeEnabled) noexcept
+{
+    TraceLogHelpers::getRegistry().enabled.set (shouldBeEnabled ? 1 : 0);
+}
+
+bool TraceLog::isEnabled() noexcept
+{
+    return TraceLogHelpers::getRegistry().enabled.get() != 0;
+}
+
+void TraceLog::setBufferSizePerThread (const int numEvents) noexcept
+{
+    jassert (numEvents > 0);
+    TraceLogHelpers::getRegistry().bufferSize.set (jmax (1, numEvents));
+}
+
+void TraceLog::clear()
+{
+    for (TraceLogHelpers::ThreadBuffer* b = TraceLogHelpers::getRegistry().buffers.get(); b != nullptr; b = b->next)
+        b->clear();
+}
+
+void TraceLog::writeChromeTraceJSON (OutputStream& output)
+{
+    using namespace TraceLogHelpers;
+
+    OwnedArray<ThreadEvents> threads;
+    int64 earliestTicks = 0;
+    bool foundAny = false;
+
+    for (ThreadBuffer* b = getRegistry().buffers.get(); b != nullptr; b = b->next)
+    {
+        ThreadEvents* const t = new ThreadEvents();
+        threads.add (t);
+        t->threadIndex = b->threadIndex;
+        t->name = b->getName();
+        b->copyEvents (t->events);
+
+        for (int i = 0; i < t->events.size(); ++i)
+        {
+            const int64 start = t->events.getReference(i).startTicks;
+
+            if (start < earliestTicks || ! foundAny)
+                earliestTicks = start;
+
+            foundAny = true;
+        }
+    }
+
+    output << "{\"traceEvents\":[";
+    const char* separator = "";
+
+    for (int i = threads.size(); --i >= 0;)
+    {
+        const ThreadEvents& t = *threads.getUnchecked (i);
+        const String tid (t.threadIndex);
+
+        output << separator << newLine
+               << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << tid
+               << ",\"args\":{\"name\":" << JSON::toString (var (t.name)) << "}}";
+        separator = ",";
+
+        for (int j = 0; j < t.events.size(); ++j)
+        {
+            const Event& e = t.events.getReference (j);
+
+            output << separator << newLine
+                   << "{\"name\":" << quoted (e.name);
+
+            if (e.isInstant)
+                output << ",\"ph\":\"i\",\"s\":\"t\"";
+            else
+                output << ",\"ph\":\"X\",\"dur\":" << toMicroseconds (e.endTicks - e.startTicks);
+
+            output << ",\"ts\":" << toMicroseconds (e.startTicks - earliestTicks)
+                   << ",\"pid\":1,\"tid\":" << tid;
+
+            if (e.id >= 0)
+                output << ",\"args\":{\"id\":" << e.id << "}";
+
+            output << "}";
+        }
+    }
+
+    output << newLine << "],\"displayTimeUnit\":\"ms\"}" << newLine;
+}
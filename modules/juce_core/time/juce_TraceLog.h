@@ -0,0 +1,161 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+
+#ifndef __JUCE_TRACELOG_JUCEHEADER__
+#define __JUCE_TRACELOG_JUCEHEADER__
+
+#include "juce_Time.h"
+#include "../streams/juce_OutputStream.h"
+
+
+//==============================================================================
+/**
+    Records a timeline of events from all of your threads, so that it can be viewed
+    in a trace viewer such as chrome://tracing or Perfetto.
+
+    Each thread writes its events into its own ring buffer, so adding an event never
+    takes a lock or waits for another thread (the only exception being the first event
+    on each thread, which allocates that thread's buffer). When a buffer is full, its
+    oldest events are overwritten, so the log always holds the most recent activity.
+
+    You'd normally add events with the JUCE_TRACE_SCOPE macros rather than calling
+    this class directly, because the macros compile to nothing unless JUCE_ENABLE_TRACING
+    is turned on, e.g. @code
+
+    void MyProcessor::processBlock (AudioSampleBuffer& buffer, MidiBuffer&)
+    {
+        JUCE_TRACE_SCOPE ("processBlock");
+        ...
+    }
+    @endcode
+
+    Then call writeChromeTraceJSON() to save the timeline.
+
+    Event names are stored as raw pointers, so they must be string literals, or at least
+    strings that will outlive the log.
+
+    @see PerformanceCounter
+*/
+class JUCE_API  TraceLog
+{
+public:
+    //==============================================================================
+    /** Adds an event which started and finished at the given times.
+        The times are high-resolution tick counts, as returned by Time::getHighResolutionTicks().
+        If id isn't negative, it's shown as an argument of the event.
+    */
+    static void addCompleteEvent (const char* name, int64 startTicks, int64 endTicks, int id = -1) noexcept;
+
+    /** Adds an event which marks a single moment, i.e. now. */
+    static void addInstantEvent (const char* name, int id = -1) noexcept;
+
+    /** Sets the name which the calling thread will be given in the trace.
+        If you don't call this, JUCE threads will use their Thread name.
+    */
+    static void setCurrentThreadName (const String& name);
+
+    //==============================================================================
+    /** Turns recording on or off. Recording is on by default. */
+    static void setEnabled (bool shouldBeEnabled) noexcept;
+
+    /** Returns true if events are being recorded. */
+    static bool isEnabled() noexcept;
+
+    /** Sets the number of events that each thread's buffer can hold.
+        This only affects buffers that are created after it's called, so you should
+        call it before any events are added. The default is 16384.
+    */
+    static void setBufferSizePerThread (int numEvents) noexcept;
+
+    /** Discards all the events that have been recorded so far. */
+    static void clear();
+
+    //==============================================================================
+    /** Writes the recorded events to a stream in the Chrome trace-event JSON format.
+        The events are left in the log. Events that are overwritten by their threads
+        while this is reading them are left out.
+    */
+    static void writeChromeTraceJSON (OutputStream& output);
+
+    //==============================================================================
+    /** Records an event that lasts for the lifetime of this object.
+        @see JUCE_TRACE_SCOPE
+    */
+    class ScopedEvent
+    {
+    public:
+        inline explicit ScopedEvent (const char* eventName, int eventId = -1) noexcept
+            : name (eventName), id (eventId),
+              startTicks (isEnabled() ? Time::getHighResolutionTicks() : 0)
+        {}
+
+        inline ~ScopedEvent() noexcept
+        {
+            if (startTicks != 0)
+                addCompleteEvent (name, startTicks, Time::getHighResolutionTicks(), id);
+        }
+
+    private:
+        const char* const name;
+        const int id;
+        const int64 startTicks;
+
+        JUCE_DECLARE_NON_COPYABLE (ScopedEvent)
+    };
+
+private:
+    TraceLog();
+    JUCE_DECLARE_NON_COPYABLE (TraceLog)
+};
+
+//==============================================================================
+#if JUCE_ENABLE_TRACING || DOXYGEN
+ /** Records an event with the given name, lasting until the end of the enclosing scope.
+     This compiles to nothing unless JUCE_ENABLE_TRACING is enabled.
+     @see TraceLog
+ */
+ #define JUCE_TRACE_SCOPE(name)                 const juce::TraceLog::ScopedEvent JUCE_JOIN_MACRO (juceTraceEvent_, __LINE__) (name)
+
+ /** Like JUCE_TRACE_SCOPE, but also tags the event with an integer id. */
+ #define JUCE_TRACE_SCOPE_WITH_ID(name, id)     const juce::TraceLog::ScopedEvent JUCE_JOIN_MACRO (juceTraceEvent_, __LINE__) (name, id)
+
+ /** Records a single moment with the given name.
+     This compiles to nothing unless JUCE_ENABLE_TRACING is enabled.
+ */
+ #define JUCE_TRACE_INSTANT(name)               juce::TraceLog::addInstantEvent (name)
+
+ /** Sets the name that the current thread will be given in the trace.
+     This compiles to nothing unless JUCE_ENABLE_TRACING is enabled.
+ */
+ #define JUCE_TRACE_THREAD_NAME(name)           juce::TraceLog::setCurrentThreadName (name)
+#else
+ #define JUCE_TRACE_SCOPE(name)
+ #define JUCE_TRACE_SCOPE_WITH_ID(name, id)
+ #define JUCE_TRACE_INSTANT(name)
+ #define JUCE_TRACE_THREAD_NAME(name)
+#endif
+
+
+#endif   // __JUCE_TRACELOG_JUCEHEADER__
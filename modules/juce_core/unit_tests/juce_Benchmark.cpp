@@ -0,0 +1,440 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+
+#if JUCE_BENCHMARK_COUNT_ALLOCATIONS
+namespace BenchmarkHelpers
+{
+    static Atomic<int64> numAllocations;
+}
+
+void JUCE_CALLTYPE juce_countBenchmarkAllocation() noexcept
+{
+    ++BenchmarkHelpers::numAllocations;
+}
+#endif
+
+//==============================================================================
+const void* volatile Benchmark::optimisationSink = nullptr;
+
+Benchmark::Benchmark (const String& name_)
+    : name (name_), runner (nullptr),
+      iterationsLeft (0), warmUpIterationsLeft (0),
+      lastTicks (0), allocationsAtStart (0)
+{
+    getAllBenchmarks().add (this);
+}
+
+Benchmark::~Benchmark()
+{
+    getAllBenchmarks().removeFirstMatchingValue (this);
+}
+
+Array<Benchmark*>& Benchmark::getAllBenchmarks()
+{
+    static Array<Benchmark*> benchmarks;
+    return benchmarks;
+}
+
+void Benchmark::initialise()  {}
+void Benchmark::shutdown()   {}
+
+void Benchmark::performBenchmark (BenchmarkRunner* const runner_)
+{
+    jassert (runner_ != nullptr);
+    runner = runner_;
+
+    initialise();
+    runBenchmark();
+    shutdown();
+}
+
+void Benchmark::logMessage (const String& message)
+{
+    runner->logMessage (message);
+}
+
+int64 Benchmark::getNumAllocations() noexcept
+{
+   #if JUCE_BENCHMARK_COUNT_ALLOCATIONS
+    return BenchmarkHelpers::numAllocations.get();
+   #else
+    return -1;
+   #endif
+}
+
+void Benchmark::beginMeasurement (const String& measurementName_, int numIterations, int numWarmUpIterations)
+{
+    jassert (runner != nullptr); // this must be called from within runBenchmark()
+    jassert (iterationsLeft == 0); // the previous measurement hasn't finished!
+
+    measurementName = measurementName_;
+    iterationsLeft = jmax (1, roundToInt (numIterations * runner->iterationScale));
+    warmUpIterationsLeft = jmax (0, numWarmUpIterations);
+    lastTicks = 0;
+
+    times.clearQuick();
+    times.ensureStorageAllocated (iterationsLeft);
+}
+
+bool Benchmark::keepRunning()
+{
+    const int64 now = Time::getHighResolutionTicks();
+
+    if (lastTicks != 0)
+        times.add (Time::highResolutionTicksToSeconds (now - lastTicks));
+
+    if (warmUpIterationsLeft > 0)
+    {
+        --warmUpIterationsLeft;
+        lastTicks = 0;
+        return true;
+    }
+
+    if (iterationsLeft > 0)
+    {
+        if (lastTicks == 0)
+            allocationsAtStart = getNumAllocations();
+
+        --iterationsLeft;
+        lastTicks = Time::getHighResolutionTicks();
+        return true;
+    }
+
+    if (lastTicks != 0)
+        endMeasurement();
+
+    lastTicks = 0;
+    return false;
+}
+
+void Benchmark::endMeasurement()
+{
+    const int64 allocationsAtEnd = getNumAllocations();
+
+    runner->addResult (*this, measurementName, times,
+                       allocationsAtEnd >= 0 ? (allocationsAtEnd - allocationsAtStart) / (double) times.size()
+                                             : -1.0);
+}
+
+//==============================================================================
+namespace BenchmarkHelpers
+{
+    static String formatTime (const double seconds)
+    {
+        if (seconds < 1.0e-6)   return String (seconds * 1.0e9, 1) + " ns";
+        if (seconds < 1.0e-3)   return String (seconds * 1.0e6, 2) + " us";
+        if (seconds < 1.0)      return String (seconds * 1.0e3, 2) + " ms";
+
+        return String (seconds, 3) + " s";
+    }
+
+    static double getPercentile (const Array<double>& sortedTimes, const double proportion)
+    {
+        const int index = (int) std::ceil (proportion * sortedTimes.size()) - 1;
+        return sortedTimes [jlimit (0, sortedTimes.size() - 1, index)];
+    }
+
+    static String getKey (const String& benchmarkName, const String& measurementName)
+    {
+        return benchmarkName + "/" + measurementName;
+    }
+}
+
+BenchmarkRunner::BenchmarkRunner()
+    : iterationScale (1.0)
+{
+}
+
+BenchmarkRunner::~BenchmarkRunner()
+{
+}
+
+void BenchmarkRunner::setIterationScale (const double newScale) noexcept
+{
+    jassert (newScale > 0);
+    iterationScale = newScale;
+}
+
+int BenchmarkRunner::getNumResults() const noexcept
+{
+    return results.size();
+}
+
+const BenchmarkRunner::Result* BenchmarkRunner::getResult (int index) const noexcept
+{
+    return results [index];
+}
+
+void BenchmarkRunner::resultsUpdated()
+{
+}
+
+void BenchmarkRunner::runBenchmarks (const Array<Benchmark*>& benchmarks)
+{
+    results.clear();
+    resultsUpdated();
+
+    for (int i = 0; i < benchmarks.size(); ++i)
+    {
+        if (shouldAbortBenchmarks())
+            break;
+
+        Benchmark* const b = benchmarks.getUnchecked (i);
+        logMessage ("-----------------------------------------------------------------");
+        logMessage ("Benchmark: " + b->getName());
+
+        try
+        {
+            b->performBenchmark (this);
+        }
+        catch (...)
+        {
+            logMessage ("!!! An unhandled exception was thrown!");
+            jassertfalse;
+        }
+    }
+}
+
+void BenchmarkRunner::runAllBenchmarks()
+{
+    runBenchmarks (Benchmark::getAllBenchmarks());
+}
+
+void BenchmarkRunner::logMessage (const String& message)
+{
+    Logger::writeToLog (message);
+}
+
+bool BenchmarkRunner::shouldAbortBenchmarks()
+{
+    return false;
+}
+
+void BenchmarkRunner::addResult (const Benchmark& benchmark, const String& measurementName,
+                                 Array<double>& times, const double allocationsPerIteration)
+{
+    using namespace BenchmarkHelpers;
+
+    const int num = times.size();
+
+    if (num == 0)
+        return;
+
+    DefaultElementComparator<double> sorter;
+    times.sort (sorter);
+
+    double total = 0;
+    for (int i = 0; i < num; ++i)
+        total += times.getUnchecked (i);
+
+    Result* const r = new Result();
+    r->benchmarkName = benchmark.getName();
+    r->measurementName = measurementName;
+    r->numIterations = num;
+    r->minimum = times.getFirst();
+    r->median = (num & 1) != 0 ? times.getUnchecked (num / 2)
+                               : (times.getUnchecked (num / 2 - 1) + times.getUnchecked (num / 2)) * 0.5;
+    r->percentile90 = getPercentile (times, 0.9);
+    r->percentile99 = getPercentile (times, 0.99);
+    r->maximum = times.getLast();
+    r->mean = total / num;
+    r->allocationsPerIteration = allocationsPerIteration;
+    results.add (r);
+
+    String message;
+    message << measurementName << ": median " << formatTime (r->median)
+            << ", 90% " << formatTime (r->percentile90)
+            << ", 99% " << formatTime (r->percentile99)
+            << ", min " << formatTime (r->minimum)
+            << ", max " << formatTime (r->maximum)
+            << " (" << num << " iterations";
+
+    if (allocationsPerIteration >= 0)
+        message << ", " << String (allocationsPerIteration, 2) << " allocations each";
+
+    logMessage (message + ")");
+    resultsUpdated();
+}
+
+//==============================================================================
+var BenchmarkRunner::getResultsAsVar() const
+{
+    var list;
+
+    for (int i = 0; i < results.size(); ++i)
+    {
+        const Result& r = *results.getUnchecked (i);
+
+        DynamicObject* const d = new DynamicObject();
+        d->setProperty ("benchmark", r.benchmarkName);
+        d->setProperty ("measurement", r.measurementName);
+        d->setProperty ("iterations", r.numIterations);
+        d->setProperty ("min", r.minimum * 1.0e6);
+        d->setProperty ("median", r.median * 1.0e6);
+        d->setProperty ("p90", r.percentile90 * 1.0e6);
+        d->setProperty ("p99", r.percentile99 * 1.0e6);
+        d->setProperty ("max", r.maximum * 1.0e6);
+        d->setProperty ("mean", r.mean * 1.0e6);
+        d->setProperty ("allocations", r.allocationsPerIteration);
+        list.append (var (d));
+    }
+
+    DynamicObject* const root = new DynamicObject();
+    root->setProperty ("benchmarks", list);
+    return var (root);
+}
+
+void BenchmarkRunner::writeResultsAsJSON (OutputStream& output) const
+{
+    JSON::writeToStream (output, getResultsAsVar());
+}
+
+StringArray BenchmarkRunner::compareWithBaseline (const var& baseline, const double allowedSlowdown) const
+{
+    using namespace BenchmarkHelpers;
+
+    StringPairArray baselineMedians, baselineAllocations;
+    const var baselineResults (baseline ["benchmarks"]);
+
+    if (const Array<var>* const list = baselineResults.getArray())
+    {
+        for (int i = 0; i < list->size(); ++i)
+        {
+            const var& item = list->getReference (i);
+            const String key (getKey (item ["benchmark"], item ["measurement"]));
+
+            baselineMedians.set (key, item ["median"].toString());
+            baselineAllocations.set (key, item ["allocations"].toString());
+        }
+    }
+
+    StringArray regressions;
+
+    for (int i = 0; i < results.size(); ++i)
+    {
+        const Result& r = *results.getUnchecked (i);
+        const String key (getKey (r.benchmarkName, r.measurementName));
+
+        if (! baselineMedians.getAllKeys().contains (key))
+            continue;
+
+        const double oldMedian = baselineMedians [key].getDoubleValue() * 1.0e-6;
+        const double oldAllocations = baselineAllocations [key].getDoubleValue();
+
+        if (r.median > oldMedian * (1.0 + allowedSlowdown))
+            regressions.add (key + ": median went from " + formatTime (oldMedian)
+                               + " to " + formatTime (r.median));
+
+        if (r.allocationsPerIteration >= 0 && oldAllocations >= 0
+             && r.allocationsPerIteration > oldAllocations + 0.5)
+            regressions.add (key + ": allocations went from " + String (oldAllocations, 2)
+                               + " to " + String (r.allocationsPerIteration, 2));
+    }
+
+    return regressions;
+}
+
+//==============================================================================
+#if JUCE_BENCHMARKS
+
+class HashMapBenchmarks  : public Benchmark
+{
+public:
+    HashMapBenchmarks() : Benchmark ("HashMap") {}
+
+    enum { numItems = 10000 };
+
+    template <class MapType>
+    void measure (const String& mapName)
+    {
+        beginMeasurement (mapName + ": set 10000 ints", 20, 2);
+        while (keepRunning())
+        {
+            MapType map;
+
+            for (int i = 0; i < numItems; ++i)
+                map.set (i * 7919, i);
+
+            preventOptimisation (map);
+        }
+
+        MapType map;
+
+        for (int i = 0; i < numItems; ++i)
+            map.set (i * 7919, i);
+
+        beginMeasurement (mapName + ": look up 10000 ints");
+        while (keepRunning())
+        {
+            int total = 0;
+
+            for (int i = 0; i < numItems; ++i)
+                total += map [i * 7919];
+
+            preventOptimisation (total);
+        }
+
+        beginMeasurement (mapName + ": look up 10000 missing ints");
+        while (keepRunning())
+        {
+            int total = 0;
+
+            for (int i = 0; i < numItems; ++i)
+                total += map [i * 7919 + 1];
+
+            preventOptimisation (total);
+        }
+    }
+
+    void runBenchmark()
+    {
+        measure <HashMap<int, int> > ("HashMap");
+        measure <FlatHashMap<int, int> > ("FlatHashMap");
+
+        StringArray keys;
+        for (int i = 0; i < 1000; ++i)
+            keys.add ("key" + String (i));
+
+        beginMeasurement ("HashMap: set and look up 1000 strings", 50, 5);
+        while (keepRunning())
+        {
+            HashMap<String, int> map;
+
+            for (int i = 0; i < keys.size(); ++i)
+                map.set (keys[i], i);
+
+            int total = 0;
+
+            for (int i = 0; i < keys.size(); ++i)
+                total += map [keys[i]];
+
+            preventOptimisation (total);
+        }
+    }
+};
+
+static HashMapBenchmarks hashMapBenchmarks;
+
+#endif
@@ -0,0 +1,298 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+
+#ifndef __JUCE_BENCHMARK_JUCEHEADER__
+#define __JUCE_BENCHMARK_JUCEHEADER__
+
+#include "../containers/juce_Variant.h"
+#include "../containers/juce_OwnedArray.h"
+class BenchmarkRunner;
+
+
+//==============================================================================
+/**
+    This is a base class for classes that measure the performance of some code.
+
+    It works like UnitTest, but instead of checking results, each measurement runs a
+    piece of code many times and records how long each run took, e.g.
+
+    @code
+    class MyBenchmark  : public Benchmark
+    {
+    public:
+        MyBenchmark()  : Benchmark ("Foobar") {}
+
+        void runBenchmark()
+        {
+            Foobar foobar;
+
+            beginMeasurement ("doSomething", 1000);
+
+            while (keepRunning())
+                preventOptimisation (foobar.doSomething());
+
+            beginMeasurement ("doSomethingElse", 100);
+
+            while (keepRunning())
+                foobar.doSomethingElse();
+        }
+    };
+
+    // Creating a static instance will add it to the array returned by
+    // Benchmark::getAllBenchmarks(), so it'll be run by BenchmarkRunner::runAllBenchmarks()
+    static MyBenchmark benchmark;
+    @endcode
+
+    The benchmarks that come with JUCE are only compiled if you set JUCE_BENCHMARKS to 1
+    in your project. To have the results include the number of memory allocations
+    made by each iteration, also enable JUCE_BENCHMARK_COUNT_ALLOCATIONS.
+
+    @see BenchmarkRunner, UnitTest
+*/
+class JUCE_API  Benchmark
+{
+public:
+    //==============================================================================
+    /** Creates a benchmark with the given name. */
+    explicit Benchmark (const String& name);
+
+    /** Destructor. */
+    virtual ~Benchmark();
+
+    /** Returns the name of the benchmark. */
+    const String& getName() const noexcept       { return name; }
+
+    /** Runs the benchmark, using the specified BenchmarkRunner.
+        You shouldn't need to call this method directly - use
+        BenchmarkRunner::runBenchmarks() instead.
+    */
+    void performBenchmark (BenchmarkRunner* runner);
+
+    /** Returns the set of all Benchmark objects that currently exist. */
+    static Array<Benchmark*>& getAllBenchmarks();
+
+    //==============================================================================
+    /** You can optionally implement this method to set up your benchmark.
+        This method will be called before runBenchmark(), and isn't timed.
+    */
+    virtual void initialise();
+
+    /** You can optionally implement this method to clear up after your benchmark has been run.
+        This method will be called after runBenchmark() has returned.
+    */
+    virtual void shutdown();
+
+    /** Implement this method in your subclass to make your measurements.
+
+        It should call beginMeasurement() for each thing that it wants to measure,
+        followed by a loop which runs the code while keepRunning() returns true.
+    */
+    virtual void runBenchmark() = 0;
+
+    //==============================================================================
+    /** Starts a new measurement.
+
+        After calling this, you should repeatedly run the code that you want to measure
+        until keepRunning() returns false. The first few runs are treated as a warm-up and
+        ignored, and each of the rest is timed separately.
+
+        The runner may scale the number of iterations - see BenchmarkRunner::setIterationScale().
+        If the code being measured is very quick, you'll get more accurate results by making
+        each iteration do it many times, because the timer has a finite resolution.
+    */
+    void beginMeasurement (const String& measurementName,
+                           int numIterations = 100,
+                           int numWarmUpIterations = 10);
+
+    /** Returns true if the code being measured needs to be run again.
+        Each call ends the timing of the previous iteration and starts the next one.
+        @see beginMeasurement
+    */
+    bool keepRunning();
+
+    /** Stops the compiler from optimising away the calculation of a value.
+        Pass the result of the code that you're measuring to this if nothing else uses it.
+    */
+    template <typename Type>
+    static void preventOptimisation (const Type& value) noexcept
+    {
+        optimisationSink = &value;
+    }
+
+    //==============================================================================
+    /** Writes a message to the benchmark log.
+        This can only be called from within your runBenchmark() method.
+    */
+    void logMessage (const String& message);
+
+    //==============================================================================
+    /** Returns the number of memory allocations that have been made so far.
+        This is only counted when JUCE_BENCHMARK_COUNT_ALLOCATIONS is enabled, in which case
+        it includes everything allocated with operator new or by a HeapBlock. If it's
+        disabled, this returns -1.
+    */
+    static int64 getNumAllocations() noexcept;
+
+private:
+    //==============================================================================
+    const String name;
+    BenchmarkRunner* runner;
+    String measurementName;
+    Array<double> times;
+    int iterationsLeft, warmUpIterationsLeft;
+    int64 lastTicks, allocationsAtStart;
+    static const void* volatile optimisationSink;
+
+    void endMeasurement();
+
+    JUCE_DECLARE_NON_COPYABLE (Benchmark)
+};
+
+
+//==============================================================================
+/**
+    Runs a set of benchmarks, and collects their results.
+
+    As well as logging the results, this can write them as JSON, and compare them
+    with a set of results from an earlier run to look for regressions, e.g.
+
+    @code
+    BenchmarkRunner runner;
+    runner.runAllBenchmarks();
+
+    StringArray regressions (runner.compareWithBaseline (JSON::parse (baselineFile), 0.1));
+    @endcode
+
+    @see Benchmark
+*/
+class JUCE_API  BenchmarkRunner
+{
+public:
+    //==============================================================================
+    /** */
+    BenchmarkRunner();
+
+    /** Destructor. */
+    virtual ~BenchmarkRunner();
+
+    /** Runs a set of benchmarks.
+        The benchmarks are performed in order, and the results are logged. To run all the
+        registered Benchmark objects that exist, use runAllBenchmarks().
+    */
+    void runBenchmarks (const Array<Benchmark*>& benchmarks);
+
+    /** Runs all the Benchmark objects that currently exist.
+        This calls runBenchmarks() for all the objects listed in Benchmark::getAllBenchmarks().
+    */
+    void runAllBenchmarks();
+
+    /** Multiplies the number of iterations that each measurement asks for.
+        The default is 1.0. A smaller value gives a quicker but noisier run; a larger one
+        gives more stable results.
+    */
+    void setIterationScale (double newScale) noexcept;
+
+    //==============================================================================
+    /** Contains the results of a measurement.
+        All the times are in seconds, and are the times taken by a single iteration.
+    */
+    struct Result
+    {
+        /** The name of the Benchmark object that made the measurement. */
+        String benchmarkName;
+        /** The name that was passed to Benchmark::beginMeasurement(). */
+        String measurementName;
+
+        /** The number of timed iterations. */
+        int numIterations;
+
+        double minimum, median, percentile90, percentile99, maximum, mean;
+
+        /** The average number of memory allocations made by each iteration, or -1 if
+            allocations weren't being counted.
+        */
+        double allocationsPerIteration;
+    };
+
+    /** Returns the number of Result objects that have been recorded.
+        @see getResult
+    */
+    int getNumResults() const noexcept;
+
+    /** Returns one of the results of the benchmarks that have been run.
+        @see getNumResults
+    */
+    const Result* getResult (int index) const noexcept;
+
+    //==============================================================================
+    /** Returns the results as a JSON-compatible object.
+        Times are given in microseconds.
+    */
+    var getResultsAsVar() const;
+
+    /** Writes the results to a stream as JSON.
+        @see getResultsAsVar
+    */
+    void writeResultsAsJSON (OutputStream& output) const;
+
+    /** Compares the results with some that were saved by an earlier run.
+
+        The baseline should be an object in the format produced by getResultsAsVar(). Any
+        measurement whose median is more than (1 + allowedSlowdown) times its baseline median,
+        or which now makes more allocations, is reported in the array that's returned. Results
+        that don't appear in the baseline are ignored.
+    */
+    StringArray compareWithBaseline (const var& baseline, double allowedSlowdown = 0.1) const;
+
+protected:
+    /** Called when a measurement has been completed and added to the results. */
+    virtual void resultsUpdated();
+
+    /** Logs a message about the current benchmark progress.
+        By default this just writes the message to the Logger class, but you could override
+        this to do something else with the data.
+    */
+    virtual void logMessage (const String& message);
+
+    /** This can be overridden to let the runner know that it should abort the benchmarks
+        as soon as possible, e.g. because the thread needs to stop.
+    */
+    virtual bool shouldAbortBenchmarks();
+
+private:
+    //==============================================================================
+    friend class Benchmark;
+
+    OwnedArray <Result, CriticalSection> results;
+    double iterationScale;
+
+    void addResult (const Benchmark&, const String& measurementName,
+                    Array<double>& times, double allocationsPerIteration);
+
+    JUCE_DECLARE_NON_COPYABLE (BenchmarkRunner)
+};
+
+
+#endif   // __JUCE_BENCHMARK_JUCEHEADER__
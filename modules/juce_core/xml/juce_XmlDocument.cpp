@@ -32,7 +32,10 @@ XmlDocument::XmlDocument (const String& documentText)
       outOfData (false),
       errorOccurred (false),
       needToLoadDTD (false),
-      ignoreEmptyTextElements (true)
+      ignoreEmptyTextElements (true),
+      eventSink (nullptr),
+      nameCache (nullptr),
+      stopped (false)
 {
 }
 
@@ -42,7 +45,10 @@ XmlDocument::XmlDocument (const File& file)
       errorOccurred (false),
       needToLoadDTD (false),
       ignoreEmptyTextElements (true),
-      inputSource (new FileInputSource (file))
+      inputSource (new FileInputSource (file)),
+      eventSink (nullptr),
+      nameCache (nullptr),
+      stopped (false)
 {
 }
 
@@ -103,7 +109,194 @@ namespace XmlIdentifierChars
     }*/
 }
 
+//==============================================================================
+// The parser reports what it finds to one of these: either a TreeBuilder, which
+// creates the XmlElements, or a HandlerAdapter, which passes things on to a
+// user's ParseHandler.
+class XmlDocument::EventSink
+{
+public:
+    virtual ~EventSink() {}
+
+    virtual bool elementStarted (const String& tagName) = 0;
+    virtual bool attributeFound (NameCache& names, int nameIndex, const String& value) = 0;
+    virtual bool elementEnded (const String& tagName) = 0;
+    virtual bool textFound (const String& text) = 0;
+};
+
+//==============================================================================
+// Tag and attribute names are repeated over and over in most documents, so this keeps
+// a small cache of recently-seen names. Each element and attribute that shares a name
+// can then share the same String, rather than allocating a copy of its own.
+class XmlDocument::NameCache
+{
+public:
+    NameCache() {}
+
+    int findName (const String::CharPointerType start, const int numChars)
+    {
+        uint32 hash = (uint32) numChars;
+        String::CharPointerType t (start);
+
+        for (int i = numChars; --i >= 0;)
+            hash = hash * 31 + (uint32) t.getAndAdvance();
+
+        const int index = (int) (hash & (numEntries - 1));
+        Entry& e = entries [index];
+
+        if (! matches (e.name, start, numChars))
+        {
+            e.name = String (start, (size_t) numChars);
+            e.identifier = Identifier();
+        }
+
+        return index;
+    }
+
+    const String& getName (const int index) const noexcept      { return entries [index].name; }
+
+    const Identifier& getIdentifier (const int index)
+    {
+        Entry& e = entries [index];
+
+        if (e.identifier.isNull())
+            e.identifier = Identifier (e.name);
+
+        return e.identifier;
+    }
+
+private:
+    struct Entry
+    {
+        String name;
+        Identifier identifier;
+    };
+
+    enum { numEntries = 256 };
+    Entry entries [numEntries];
+
+    static bool matches (const String& name, String::CharPointerType t, int numChars) noexcept
+    {
+        String::CharPointerType n (name.getCharPointer());
+
+        while (--numChars >= 0)
+            if (n.getAndAdvance() != t.getAndAdvance())
+                return false;
+
+        return n.isEmpty();
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (NameCache)
+};
+
+//==============================================================================
+class XmlDocument::TreeBuilder  : public XmlDocument::EventSink
+{
+public:
+    TreeBuilder() {}
+
+    bool elementStarted (const String& tagName)
+    {
+        XmlElement* const e = new XmlElement (tagName);
+
+        if (stack.size() == 0)
+        {
+            jassert (root == nullptr);
+            root = e;
+        }
+        else
+        {
+            Level& parent = stack.getReference (stack.size() - 1);
+            *parent.endOfChildren = e;
+            parent.endOfChildren = &(e->nextListItem);
+        }
+
+        stack.add (Level (e));
+        return true;
+    }
+
+    bool attributeFound (NameCache& names, const int nameIndex, const String& value)
+    {
+        stack.getReference (stack.size() - 1).element
+            ->attributes.add (XmlElement::XmlAttributeNode (names.getName (nameIndex), value));
+        return true;
+    }
+
+    bool elementEnded (const String&)
+    {
+        stack.removeLast();
+        return true;
+    }
+
+    bool textFound (const String& text)
+    {
+        XmlElement* const e = XmlElement::createTextElement (text);
+
+        Level& current = stack.getReference (stack.size() - 1);
+        *current.endOfChildren = e;
+        current.endOfChildren = &(e->nextListItem);
+        return true;
+    }
+
+    ScopedPointer<XmlElement> root;
+
+private:
+    struct Level
+    {
+        Level() noexcept : element (nullptr), endOfChildren (nullptr) {}
+
+        Level (XmlElement* const e) noexcept
+            : element (e), endOfChildren (&(e->firstChildElement))
+        {}
+
+        XmlElement* element;
+        LinkedListPointer<XmlElement>* endOfChildren;
+    };
+
+    Array<Level> stack;
+
+    JUCE_DECLARE_NON_COPYABLE (TreeBuilder)
+};
+
+//==============================================================================
+class XmlDocument::HandlerAdapter  : public XmlDocument::EventSink
+{
+public:
+    HandlerAdapter (ParseHandler& handler_) noexcept  : handler (handler_) {}
+
+    bool elementStarted (const String& tagName)         { return handler.elementStarted (tagName); }
+    bool elementEnded (const String& tagName)           { return handler.elementEnded (tagName); }
+    bool textFound (const String& text)                 { return handler.textFound (text); }
+
+    bool attributeFound (NameCache& names, const int nameIndex, const String& value)
+    {
+        return handler.attributeFound (names.getIdentifier (nameIndex), value);
+    }
+
+private:
+    ParseHandler& handler;
+
+    JUCE_DECLARE_NON_COPYABLE (HandlerAdapter)
+};
+
+//==============================================================================
 XmlElement* XmlDocument::getDocumentElement (const bool onlyReadOuterDocumentElement)
+{
+    TreeBuilder builder;
+
+    if (parseDocument (builder, onlyReadOuterDocumentElement))
+        return builder.root.release();
+
+    return nullptr;
+}
+
+bool XmlDocument::parseDocument (ParseHandler& handler)
+{
+    HandlerAdapter adapter (handler);
+    return parseDocument (adapter, false);
+}
+
+bool XmlDocument::parseDocument (EventSink& sink, const bool onlyReadOuterDocumentElement)
 {
     String textToParse (originalText);
 
@@ -127,29 +320,28 @@ XmlElement* XmlDocument::getDocumentElement (const bool onlyReadOuterDocumentEle
     errorOccurred = false;
     outOfData = false;
     needToLoadDTD = true;
+    stopped = false;
 
     if (textToParse.isEmpty())
     {
         lastError = "not enough input";
+        return false;
     }
-    else
-    {
-        skipHeader();
 
-        if (input.getAddress() != nullptr)
-        {
-            ScopedPointer <XmlElement> result (readNextElement (! onlyReadOuterDocumentElement));
+    skipHeader();
 
-            if (! errorOccurred)
-                return result.release();
-        }
-        else
-        {
-            lastError = "incorrect xml header";
-        }
+    if (input.getAddress() == nullptr)
+    {
+        lastError = "incorrect xml header";
+        return false;
     }
 
-    return nullptr;
+    NameCache names;
+    const ScopedValueSetter<EventSink*> sinkSetter (eventSink, &sink, nullptr);
+    const ScopedValueSetter<NameCache*> cacheSetter (nameCache, &names, nullptr);
+
+    readNextElement (! onlyReadOuterDocumentElement);
+    return ! errorOccurred;
 }
 
 const String& XmlDocument::getLastParseError() const noexcept
@@ -360,111 +552,123 @@ void XmlDocument::readQuotedString (String& result)
     }
 }
 
-XmlElement* XmlDocument::readNextElement (const bool alsoParseSubElements)
+bool XmlDocument::readNextElement (const bool alsoParseSubElements)
 {
-    XmlElement* node = nullptr;
-
     skipNextWhiteSpace();
     if (outOfData)
-        return nullptr;
+        return false;
 
     const int openBracket = input.indexOf ((juce_wchar) '<');
 
-    if (openBracket >= 0)
+    if (openBracket < 0)
+        return false;
+
+    input += openBracket + 1;
+    int tagLen = findNextTokenLength();
+
+    if (tagLen == 0)
     {
-        input += openBracket + 1;
-        int tagLen = findNextTokenLength();
+        // no tag name - but allow for a gap after the '<' before giving an error
+        skipNextWhiteSpace();
+        tagLen = findNextTokenLength();
 
         if (tagLen == 0)
         {
-            // no tag name - but allow for a gap after the '<' before giving an error
-            skipNextWhiteSpace();
-            tagLen = findNextTokenLength();
-
-            if (tagLen == 0)
-            {
-                setLastError ("tag name missing", false);
-                return node;
-            }
+            setLastError ("tag name missing", false);
+            return false;
         }
+    }
 
-        node = new XmlElement (String (input, (size_t) tagLen));
-        input += tagLen;
-        LinkedListPointer<XmlElement::XmlAttributeNode>::Appender attributeAppender (node->attributes);
+    const String tagName (nameCache->getName (nameCache->findName (input, tagLen)));
+    input += tagLen;
 
-        // look for attributes
-        for (;;)
+    if (! eventSink->elementStarted (tagName))
+    {
+        stopped = true;
+        return false;
+    }
+
+    // look for attributes
+    for (;;)
+    {
+        skipNextWhiteSpace();
+
+        const juce_wchar c = *input;
+
+        // empty tag..
+        if (c == '/' && input[1] == '>')
         {
-            skipNextWhiteSpace();
+            input += 2;
+            break;
+        }
 
-            const juce_wchar c = *input;
+        // parse the guts of the element..
+        if (c == '>')
+        {
+            ++input;
 
-            // empty tag..
-            if (c == '/' && input[1] == '>')
+            if (alsoParseSubElements)
             {
-                input += 2;
-                break;
-            }
+                readChildElements();
 
-            // parse the guts of the element..
-            if (c == '>')
-            {
-                ++input;
+                if (stopped)
+                    return false;
+            }
 
-                if (alsoParseSubElements)
-                    readChildElements (node);
+            break;
+        }
 
-                break;
-            }
+        // get an attribute..
+        if (XmlIdentifierChars::isIdentifierChar (c))
+        {
+            const int attNameLen = findNextTokenLength();
 
-            // get an attribute..
-            if (XmlIdentifierChars::isIdentifierChar (c))
+            if (attNameLen > 0)
             {
-                const int attNameLen = findNextTokenLength();
+                const int attName = nameCache->findName (input, attNameLen);
+                input += attNameLen;
 
-                if (attNameLen > 0)
-                {
-                    const String::CharPointerType attNameStart (input);
-                    input += attNameLen;
+                skipNextWhiteSpace();
 
+                if (readNextChar() == '=')
+                {
                     skipNextWhiteSpace();
 
-                    if (readNextChar() == '=')
-                    {
-                        skipNextWhiteSpace();
+                    const juce_wchar nextChar = *input;
 
-                        const juce_wchar nextChar = *input;
+                    if (nextChar == '"' || nextChar == '\'')
+                    {
+                        String value;
+                        readQuotedString (value);
 
-                        if (nextChar == '"' || nextChar == '\'')
+                        if (! eventSink->attributeFound (*nameCache, attName, value))
                         {
-                            XmlElement::XmlAttributeNode* const newAtt
-                                = new XmlElement::XmlAttributeNode (String (attNameStart, (size_t) attNameLen),
-                                                                    String::empty);
-
-                            readQuotedString (newAtt->value);
-                            attributeAppender.append (newAtt);
-                            continue;
+                            stopped = true;
+                            return false;
                         }
+
+                        continue;
                     }
                 }
             }
-            else
-            {
-                if (! outOfData)
-                    setLastError ("illegal character found in " + node->getTagName() + ": '" + c + "'", false);
-            }
-
-            break;
         }
+        else
+        {
+            if (! outOfData)
+                setLastError ("illegal character found in " + tagName + ": '" + c + "'", false);
+        }
+
+        break;
     }
 
-    return node;
+    if (! eventSink->elementEnded (tagName))
+        stopped = true;
+
+    return true;
 }
 
-void XmlDocument::readChildElements (XmlElement* parent)
+void XmlDocument::readChildElements()
 {
-    LinkedListPointer<XmlElement>::Appender childAppender (parent->firstChildElement);
-
     for (;;)
     {
         const String::CharPointerType preWhitespaceInput (input);
@@ -522,14 +726,16 @@ void XmlDocument::readChildElements (XmlElement* parent)
                     ++len;
                 }
 
-                childAppender.append (XmlElement::createTextElement (String (inputStart, len)));
+                if (! eventSink->textFound (String (inputStart, len)))
+                {
+                    stopped = true;
+                    return;
+                }
             }
             else
             {
-                // this is some other element, so parse and add it..
-                if (XmlElement* const n = readNextElement (true))
-                    childAppender.append (n);
-                else
+                // this is some other element, so parse it..
+                if (! readNextElement (true) || stopped)
                     break;
             }
         }
@@ -565,18 +771,14 @@ void XmlDocument::readChildElements (XmlElement* parent)
                         input = entity.getCharPointer();
                         outOfData = false;
 
-                        for (;;)
-                        {
-                            XmlElement* const n = readNextElement (true);
-
-                            if (n == nullptr)
-                                break;
-
-                            childAppender.append (n);
-                        }
+                        while (readNextElement (true) && ! stopped)
+                        {}
 
                         input = oldInput;
                         outOfData = oldOutOfData;
+
+                        if (stopped)
+                            return;
                     }
                     else
                     {
@@ -613,7 +815,11 @@ void XmlDocument::readChildElements (XmlElement* parent)
 
             if ((! ignoreEmptyTextElements) || textElementContent.containsNonWhitespaceChars())
             {
-                childAppender.append (XmlElement::createTextElement (textElementContent));
+                if (! eventSink->textFound (textElementContent))
+                {
+                    stopped = true;
+                    return;
+                }
             }
         }
     }
@@ -152,6 +152,57 @@ public:
     */
     static XmlElement* parse (const String& xmlData);
 
+    //==============================================================================
+    /**
+        Receives a stream of callbacks as an XML document is parsed.
+
+        Passing one of these to XmlDocument::parseDocument() lets you scan through a
+        document without building an XmlElement tree for it, so that big files can be
+        read without having to create an object for every element and attribute.
+
+        Each callback returns true to carry on parsing, or false to stop, in which case
+        parseDocument() will return straight away. The default implementations just
+        ignore the event, so you only need to override the ones you need.
+
+        @see XmlDocument::parseDocument
+    */
+    class JUCE_API  ParseHandler
+    {
+    public:
+        /** Destructor. */
+        virtual ~ParseHandler() {}
+
+        /** Called when an element's opening tag is found.
+            This will be followed by calls to attributeFound() for each of its attributes,
+            then by its contents, and finally a call to elementEnded().
+        */
+        virtual bool elementStarted (const String& /*tagName*/)                           { return true; }
+
+        /** Called for each attribute of the element that was most recently started.
+            Attribute names come from the global Identifier pool, so they can be
+            compared very cheaply with other Identifiers.
+        */
+        virtual bool attributeFound (const Identifier& /*name*/, const String& /*value*/) { return true; }
+
+        /** Called when the end of an element is reached, after all its contents. */
+        virtual bool elementEnded (const String& /*tagName*/)                             { return true; }
+
+        /** Called for a block of text or a CDATA section inside the current element.
+            Blocks that only contain whitespace are skipped, unless you've turned this off
+            with setEmptyTextElementsIgnored().
+        */
+        virtual bool textFound (const String& /*text*/)                                   { return true; }
+    };
+
+    /** Parses the document, passing its contents to a ParseHandler rather than creating
+        an XmlElement tree.
+
+        @returns    true if the document was parsed successfully (or the handler asked for
+                    parsing to stop); false if there was an error, in which case you can find
+                    out what happened with getLastParseError()
+    */
+    bool parseDocument (ParseHandler& handler);
+
 
     //==============================================================================
 private:
@@ -164,12 +215,22 @@ private:
     bool needToLoadDTD, ignoreEmptyTextElements;
     ScopedPointer <InputSource> inputSource;
 
+    class EventSink;
+    class TreeBuilder;
+    class HandlerAdapter;
+    class NameCache;
+
+    EventSink* eventSink;
+    NameCache* nameCache;
+    bool stopped;
+
     void setLastError (const String& desc, bool carryOn);
+    bool parseDocument (EventSink&, bool onlyReadOuterDocumentElement);
     void skipHeader();
     void skipNextWhiteSpace();
     juce_wchar readNextChar() noexcept;
-    XmlElement* readNextElement (bool alsoParseSubElements);
-    void readChildElements (XmlElement* parent);
+    bool readNextElement (bool alsoParseSubElements);
+    void readChildElements();
     int findNextTokenLength() noexcept;
     void readQuotedString (String& result);
     void readEntity (String& result);
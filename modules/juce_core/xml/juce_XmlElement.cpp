@@ -26,6 +26,10 @@
   ==============================================================================
 */
 
+XmlElement::XmlAttributeNode::XmlAttributeNode() noexcept
+{
+}
+
 XmlElement::XmlAttributeNode::XmlAttributeNode (const XmlAttributeNode& other) noexcept
     : name (other.name),
       value (other.value)
@@ -42,11 +46,137 @@ XmlElement::XmlAttributeNode::XmlAttributeNode (const String& n, const String& v
    #endif
 }
 
-inline bool XmlElement::XmlAttributeNode::hasName (const String& nameToMatch) const noexcept
+inline bool XmlElement::XmlAttributeNode::hasName (StringRef nameToMatch) const noexcept
 {
-    return name.equalsIgnoreCase (nameToMatch);
+    // Names that were parsed by the same XmlDocument, or set using the same String object,
+    // share their text, so an identical pointer lets us skip the character comparison.
+    return name.getCharPointer() == nameToMatch.text
+            || nameToMatch.equalsIgnoreCase (name);
 }
 
+//==============================================================================
+/*  An index of an element's children, which is built on demand once an element has enough
+    children for linear scans to become a bottleneck. It holds the children by position,
+    plus an open-addressed hash table mapping each (case-insensitive) tag name to the index
+    of the first child with that name.
+
+    Because a child can be renamed by assigning another element to it, without its parent
+    knowing, every such rename bumps a global counter, and a name table built before the
+    latest rename is ignored in favour of a plain scan until the index is next rebuilt.
+*/
+struct XmlElement::ChildIndex
+{
+    ChildIndex (const XmlElement& parent)
+    {
+        for (XmlElement* child = parent.firstChildElement; child != nullptr; child = child->nextListItem)
+            children.add (child);
+
+        rebuildNameTable();
+    }
+
+    void add (XmlElement* const child)
+    {
+        children.add (child);
+
+        if (! child->isTextElement())
+        {
+            if ((numNamesUsed + 1) * 2 > numSlots)
+                rebuildNameTable();
+            else
+                addName (children.size() - 1);
+        }
+    }
+
+    bool isNameTableUpToDate() const noexcept
+    {
+        return nameTableGeneration == numTagNameChanges.get();
+    }
+
+    static void tagNameChanged() noexcept
+    {
+        ++numTagNameChanges;
+    }
+
+    XmlElement* findChildWithTagName (StringRef tagName) const noexcept
+    {
+        for (int slot = hashIgnoringCase (tagName.text) & (numSlots - 1);; slot = (slot + 1) & (numSlots - 1))
+        {
+            const int index = slots[slot];
+
+            if (index < 0)
+                return nullptr;
+
+            XmlElement* const e = children.getUnchecked (index);
+
+            if (e->hasTagName (tagName))
+                return e;
+        }
+    }
+
+    enum { minNumChildrenToIndex = 16 };
+
+    Array<XmlElement*> children;
+
+private:
+    HeapBlock<int> slots;
+    int numSlots, numNamesUsed, nameTableGeneration;
+    static Atomic<int> numTagNameChanges;
+
+    void rebuildNameTable()
+    {
+        nameTableGeneration = numTagNameChanges.get();
+        numSlots = minNumChildrenToIndex * 2;
+
+        while (numSlots < children.size() * 2)
+            numSlots <<= 1;
+
+        slots.malloc ((size_t) numSlots);
+
+        for (int i = 0; i < numSlots; ++i)
+            slots[i] = -1;
+
+        numNamesUsed = 0;
+
+        for (int i = 0; i < children.size(); ++i)
+            if (! children.getUnchecked (i)->isTextElement())
+                addName (i);
+    }
+
+    void addName (const int index) noexcept
+    {
+        const String& name = children.getUnchecked (index)->tagName;
+
+        for (int slot = hashIgnoringCase (name.getCharPointer()) & (numSlots - 1);; slot = (slot + 1) & (numSlots - 1))
+        {
+            const int existing = slots[slot];
+
+            if (existing < 0)
+            {
+                slots[slot] = index;
+                ++numNamesUsed;
+                return;
+            }
+
+            if (children.getUnchecked (existing)->tagName.equalsIgnoreCase (name))
+                return; // only the first child with each name is needed
+        }
+    }
+
+    static int hashIgnoringCase (String::CharPointerType t) noexcept
+    {
+        uint32 hash = 0;
+
+        while (! t.isEmpty())
+            hash = hash * 31 + (uint32) CharacterFunctions::toUpperCase (t.getAndAdvance());
+
+        return (int) (hash & 0x7fffffff);
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (ChildIndex)
+};
+
+Atomic<int> XmlElement::ChildIndex::numTagNameChanges;
+
 //==============================================================================
 XmlElement::XmlElement (const String& tag) noexcept
     : tagName (tag)
@@ -75,6 +205,9 @@ XmlElement& XmlElement::operator= (const XmlElement& other)
         removeAllAttributes();
         deleteAllChildElements();
 
+        if (tagName != other.tagName)
+            ChildIndex::tagNameChanged();
+
         tagName = other.tagName;
 
         copyChildrenAndAttributesFrom (other);
@@ -87,8 +220,9 @@ XmlElement& XmlElement::operator= (const XmlElement& other)
 XmlElement::XmlElement (XmlElement&& other) noexcept
     : nextListItem      (static_cast <LinkedListPointer <XmlElement>&&> (other.nextListItem)),
       firstChildElement (static_cast <LinkedListPointer <XmlElement>&&> (other.firstChildElement)),
-      attributes        (static_cast <LinkedListPointer <XmlAttributeNode>&&> (other.attributes)),
-      tagName           (static_cast <String&&> (other.tagName))
+      attributes        (static_cast <Array<XmlAttributeNode>&&> (other.attributes)),
+      tagName           (static_cast <String&&> (other.tagName)),
+      childIndex        (other.childIndex.exchange (nullptr))
 {
 }
 
@@ -99,10 +233,14 @@ XmlElement& XmlElement::operator= (XmlElement&& other) noexcept
     removeAllAttributes();
     deleteAllChildElements();
 
+    if (tagName != other.tagName)
+        ChildIndex::tagNameChanged();
+
     nextListItem      = static_cast <LinkedListPointer <XmlElement>&&> (other.nextListItem);
     firstChildElement = static_cast <LinkedListPointer <XmlElement>&&> (other.firstChildElement);
-    attributes        = static_cast <LinkedListPointer <XmlAttributeNode>&&> (other.attributes);
+    attributes        = static_cast <Array<XmlAttributeNode>&&> (other.attributes);
     tagName           = static_cast <String&&> (other.tagName);
+    childIndex        = other.childIndex.exchange (nullptr);
 
     return *this;
 }
@@ -113,14 +251,37 @@ void XmlElement::copyChildrenAndAttributesFrom (const XmlElement& other)
     jassert (firstChildElement.get() == nullptr);
     firstChildElement.addCopyOfList (other.firstChildElement);
 
-    jassert (attributes.get() == nullptr);
-    attributes.addCopyOfList (other.attributes);
+    jassert (attributes.size() == 0);
+    attributes = other.attributes;
 }
 
 XmlElement::~XmlElement() noexcept
 {
+    clearChildIndex();
     firstChildElement.deleteAll();
-    attributes.deleteAll();
+}
+
+const XmlElement::ChildIndex* XmlElement::getChildIndex (const int numChildrenScanned) const
+{
+    if (const ChildIndex* const existing = childIndex.get())
+        return existing;
+
+    if (numChildrenScanned < ChildIndex::minNumChildrenToIndex)
+        return nullptr;
+
+    // const methods may be called concurrently, so whichever thread gets in first publishes its index
+    ChildIndex* const newIndex = new ChildIndex (*this);
+
+    if (childIndex.compareAndSetBool (newIndex, nullptr))
+        return newIndex;
+
+    delete newIndex;
+    return childIndex.get();
+}
+
+void XmlElement::clearChildIndex() noexcept
+{
+    delete childIndex.exchange (nullptr);
 }
 
 //==============================================================================
@@ -233,8 +394,10 @@ void XmlElement::writeElementAsText (OutputStream& outputStream,
             const int attIndent = indentationLevel + tagName.length() + 1;
             int lineLen = 0;
 
-            for (const XmlAttributeNode* att = attributes; att != nullptr; att = att->nextListItem)
+            for (int i = 0; i < attributes.size(); ++i)
             {
+                const XmlAttributeNode* const att = &attributes.getReference (i);
+
                 if (lineLen > lineWrapLength && indentationLevel >= 0)
                 {
                     outputStream << newLine;
@@ -303,10 +466,10 @@ String XmlElement::createDocument (const String& dtdToUse,
                                    const String& encodingType,
                                    const int lineWrapLength) const
 {
-    MemoryOutputStream mem (2048);
-    writeToStream (mem, dtdToUse, allOnOneLine, includeXmlHeader, encodingType, lineWrapLength);
+    StringBuilder sb;
+    writeToStream (sb, dtdToUse, allOnOneLine, includeXmlHeader, encodingType, lineWrapLength);
 
-    return mem.toUTF8();
+    return sb.toString();
 }
 
 void XmlElement::writeToStream (OutputStream& output,
@@ -364,9 +527,9 @@ bool XmlElement::writeToFile (const File& file,
 }
 
 //==============================================================================
-bool XmlElement::hasTagName (const String& possibleTagName) const noexcept
+bool XmlElement::hasTagName (StringRef possibleTagName) const noexcept
 {
-    const bool matches = tagName.equalsIgnoreCase (possibleTagName);
+    const bool matches = possibleTagName.equalsIgnoreCase (tagName);
 
     // XML tags should be case-sensitive, so although this method allows a
     // case-insensitive match to pass, you should try to avoid this.
@@ -385,12 +548,12 @@ String XmlElement::getTagNameWithoutNamespace() const
     return tagName.fromLastOccurrenceOf (":", false, false);
 }
 
-bool XmlElement::hasTagNameIgnoringNamespace (const String& possibleTagName) const
+bool XmlElement::hasTagNameIgnoringNamespace (StringRef possibleTagName) const
 {
     return hasTagName (possibleTagName) || getTagNameWithoutNamespace() == possibleTagName;
 }
 
-XmlElement* XmlElement::getNextElementWithTagName (const String& requiredTagName) const
+XmlElement* XmlElement::getNextElementWithTagName (StringRef requiredTagName) const
 {
     XmlElement* e = nextListItem;
 
@@ -408,92 +571,91 @@ int XmlElement::getNumAttributes() const noexcept
 
 const String& XmlElement::getAttributeName (const int index) const noexcept
 {
-    const XmlAttributeNode* const att = attributes [index];
-    return att != nullptr ? att->name : String::empty;
+    return isPositiveAndBelow (index, attributes.size()) ? attributes.getReference (index).name
+                                                         : String::empty;
 }
 
 const String& XmlElement::getAttributeValue (const int index) const noexcept
 {
-    const XmlAttributeNode* const att = attributes [index];
-    return att != nullptr ? att->value : String::empty;
+    return isPositiveAndBelow (index, attributes.size()) ? attributes.getReference (index).value
+                                                         : String::empty;
 }
 
-bool XmlElement::hasAttribute (const String& attributeName) const noexcept
+XmlElement::XmlAttributeNode* XmlElement::findAttribute (StringRef attributeName) const noexcept
 {
-    for (const XmlAttributeNode* att = attributes; att != nullptr; att = att->nextListItem)
-        if (att->hasName (attributeName))
-            return true;
+    XmlAttributeNode* const atts = attributes.begin();
 
-    return false;
+    for (int i = 0; i < attributes.size(); ++i)
+        if (atts[i].hasName (attributeName))
+            return atts + i;
+
+    return nullptr;
+}
+
+bool XmlElement::hasAttribute (StringRef attributeName) const noexcept
+{
+    return findAttribute (attributeName) != nullptr;
 }
 
 //==============================================================================
-const String& XmlElement::getStringAttribute (const String& attributeName) const noexcept
+const String& XmlElement::getStringAttribute (StringRef attributeName) const noexcept
 {
-    for (const XmlAttributeNode* att = attributes; att != nullptr; att = att->nextListItem)
-        if (att->hasName (attributeName))
-            return att->value;
+    if (const XmlAttributeNode* const att = findAttribute (attributeName))
+        return att->value;
 
     return String::empty;
 }
 
-String XmlElement::getStringAttribute (const String& attributeName, const String& defaultReturnValue) const
+String XmlElement::getStringAttribute (StringRef attributeName, const String& defaultReturnValue) const
 {
-    for (const XmlAttributeNode* att = attributes; att != nullptr; att = att->nextListItem)
-        if (att->hasName (attributeName))
-            return att->value;
+    if (const XmlAttributeNode* const att = findAttribute (attributeName))
+        return att->value;
 
     return defaultReturnValue;
 }
 
-int XmlElement::getIntAttribute (const String& attributeName, const int defaultReturnValue) const
+int XmlElement::getIntAttribute (StringRef attributeName, const int defaultReturnValue) const
 {
-    for (const XmlAttributeNode* att = attributes; att != nullptr; att = att->nextListItem)
-        if (att->hasName (attributeName))
-            return att->value.getIntValue();
+    if (const XmlAttributeNode* const att = findAttribute (attributeName))
+        return att->value.getIntValue();
 
     return defaultReturnValue;
 }
 
-double XmlElement::getDoubleAttribute (const String& attributeName, const double defaultReturnValue) const
+double XmlElement::getDoubleAttribute (StringRef attributeName, const double defaultReturnValue) const
 {
-    for (const XmlAttributeNode* att = attributes; att != nullptr; att = att->nextListItem)
-        if (att->hasName (attributeName))
-            return att->value.getDoubleValue();
+    if (const XmlAttributeNode* const att = findAttribute (attributeName))
+        return att->value.getDoubleValue();
 
     return defaultReturnValue;
 }
 
-bool XmlElement::getBoolAttribute (const String& attributeName, const bool defaultReturnValue) const
+bool XmlElement::getBoolAttribute (StringRef attributeName, const bool defaultReturnValue) const
 {
-    for (const XmlAttributeNode* att = attributes; att != nullptr; att = att->nextListItem)
+    if (const XmlAttributeNode* const att = findAttribute (attributeName))
     {
-        if (att->hasName (attributeName))
-        {
-            juce_wchar firstChar = att->value[0];
+        juce_wchar firstChar = att->value[0];
 
-            if (CharacterFunctions::isWhitespace (firstChar))
-                firstChar = att->value.trimStart() [0];
+        if (CharacterFunctions::isWhitespace (firstChar))
+            firstChar = att->value.trimStart() [0];
 
-            return firstChar == '1'
-                || firstChar == 't'
-                || firstChar == 'y'
-                || firstChar == 'T'
-                || firstChar == 'Y';
-        }
+        return firstChar == '1'
+            || firstChar == 't'
+            || firstChar == 'y'
+            || firstChar == 'T'
+            || firstChar == 'Y';
     }
 
     return defaultReturnValue;
 }
 
-bool XmlElement::compareAttribute (const String& attributeName,
+bool XmlElement::compareAttribute (StringRef attributeName,
                                    const String& stringToCompareAgainst,
                                    const bool ignoreCase) const noexcept
 {
-    for (const XmlAttributeNode* att = attributes; att != nullptr; att = att->nextListItem)
-        if (att->hasName (attributeName))
-            return ignoreCase ? att->value.equalsIgnoreCase (stringToCompareAgainst)
-                              : att->value == stringToCompareAgainst;
+    if (const XmlAttributeNode* const att = findAttribute (attributeName))
+        return ignoreCase ? att->value.equalsIgnoreCase (stringToCompareAgainst)
+                          : att->value == stringToCompareAgainst;
 
     return false;
 }
@@ -501,27 +663,10 @@ bool XmlElement::compareAttribute (const String& attributeName,
 //==============================================================================
 void XmlElement::setAttribute (const String& attributeName, const String& value)
 {
-    if (attributes == nullptr)
-    {
-        attributes = new XmlAttributeNode (attributeName, value);
-    }
+    if (XmlAttributeNode* const att = findAttribute (attributeName))
+        att->value = value;
     else
-    {
-        for (XmlAttributeNode* att = attributes; ; att = att->nextListItem)
-        {
-            if (att->hasName (attributeName))
-            {
-                att->value = value;
-                break;
-            }
-
-            if (att->nextListItem == nullptr)
-            {
-                att->nextListItem = new XmlAttributeNode (attributeName, value);
-                break;
-            }
-        }
-    }
+        attributes.add (XmlAttributeNode (attributeName, value));
 }
 
 void XmlElement::setAttribute (const String& attributeName, const int number)
@@ -534,49 +679,76 @@ void XmlElement::setAttribute (const String& attributeName, const double number)
     setAttribute (attributeName, String (number));
 }
 
-void XmlElement::removeAttribute (const String& attributeName) noexcept
+void XmlElement::removeAttribute (StringRef attributeName) noexcept
 {
-    for (LinkedListPointer<XmlAttributeNode>* att = &attributes;
-         att->get() != nullptr;
-         att = &(att->get()->nextListItem))
-    {
-        if (att->get()->hasName (attributeName))
-        {
-            delete att->removeNext();
-            break;
-        }
-    }
+    if (const XmlAttributeNode* const att = findAttribute (attributeName))
+        attributes.removeRange ((int) (att - attributes.begin()), 1);
 }
 
 void XmlElement::removeAllAttributes() noexcept
 {
-    attributes.deleteAll();
+    attributes.clear();
 }
 
 //==============================================================================
 int XmlElement::getNumChildElements() const noexcept
 {
-    return firstChildElement.size();
+    if (const ChildIndex* const index = childIndex.get())
+        return index->children.size();
+
+    const int num = firstChildElement.size();
+    getChildIndex (num);
+    return num;
 }
 
 XmlElement* XmlElement::getChildElement (const int index) const noexcept
 {
+    if (const ChildIndex* const ci = getChildIndex (index))
+        return ci->children [index];
+
     return firstChildElement [index].get();
 }
 
-XmlElement* XmlElement::getChildByName (const String& childName) const noexcept
+XmlElement* XmlElement::getChildByName (StringRef childName) const noexcept
 {
+    const ChildIndex* const ci = childIndex.get();
+
+    if (ci != nullptr && ci->isNameTableUpToDate())
+        return ci->findChildWithTagName (childName);
+
+    int numScanned = 0;
+
     for (XmlElement* child = firstChildElement; child != nullptr; child = child->nextListItem)
+    {
         if (child->hasTagName (childName))
             return child;
 
+        ++numScanned;
+    }
+
+    getChildIndex (numScanned);
     return nullptr;
 }
 
 void XmlElement::addChildElement (XmlElement* const newNode) noexcept
 {
     if (newNode != nullptr)
-        firstChildElement.append (newNode);
+    {
+        if (ChildIndex* const ci = childIndex.get())
+        {
+            // the index knows where the end of the list is, so there's no need to walk it
+            if (XmlElement* const last = ci->children.getLast())
+                last->nextListItem = newNode;
+            else
+                firstChildElement = newNode;
+
+            ci->add (newNode);
+        }
+        else
+        {
+            firstChildElement.append (newNode);
+        }
+    }
 }
 
 void XmlElement::insertChildElement (XmlElement* const newNode,
@@ -585,6 +757,7 @@ void XmlElement::insertChildElement (XmlElement* const newNode,
     if (newNode != nullptr)
     {
         removeChildElement (newNode, false);
+        clearChildIndex();
         firstChildElement.insertAtIndex (indexToInsertAt, newNode);
     }
 }
@@ -604,7 +777,10 @@ bool XmlElement::replaceChildElement (XmlElement* const currentChildElement,
         if (LinkedListPointer<XmlElement>* const p = firstChildElement.findPointerTo (currentChildElement))
         {
             if (currentChildElement != newNode)
+            {
+                clearChildIndex();
                 delete p->replaceNext (newNode);
+            }
 
             return true;
         }
@@ -618,6 +794,7 @@ void XmlElement::removeChildElement (XmlElement* const childToRemove,
 {
     if (childToRemove != nullptr)
     {
+        clearChildIndex();
         firstChildElement.remove (childToRemove);
 
         if (shouldDeleteTheChild)
@@ -633,44 +810,24 @@ bool XmlElement::isEquivalentTo (const XmlElement* const other,
         if (other == nullptr || tagName != other->tagName)
             return false;
 
-        if (ignoreOrderOfAttributes)
+        if (attributes.size() != other->attributes.size())
+            return false;
+
+        for (int i = 0; i < attributes.size(); ++i)
         {
-            int totalAtts = 0;
+            const XmlAttributeNode& att = attributes.getReference (i);
 
-            for (const XmlAttributeNode* att = attributes; att != nullptr; att = att->nextListItem)
+            if (ignoreOrderOfAttributes)
             {
-                if (! other->compareAttribute (att->name, att->value))
+                if (! other->compareAttribute (att.name, att.value))
                     return false;
-
-                ++totalAtts;
             }
-
-            if (totalAtts != other->getNumAttributes())
-                return false;
-        }
-        else
-        {
-            const XmlAttributeNode* thisAtt = attributes;
-            const XmlAttributeNode* otherAtt = other->attributes;
-
-            for (;;)
+            else
             {
-                if (thisAtt == nullptr || otherAtt == nullptr)
-                {
-                    if (thisAtt == otherAtt) // both 0, so it's a match
-                        break;
-
-                    return false;
-                }
+                const XmlAttributeNode& otherAtt = other->attributes.getReference (i);
 
-                if (thisAtt->name != otherAtt->name
-                     || thisAtt->value != otherAtt->value)
-                {
+                if (att.name != otherAtt.name || att.value != otherAtt.value)
                     return false;
-                }
-
-                thisAtt = thisAtt->nextListItem;
-                otherAtt = otherAtt->nextListItem;
             }
         }
 
@@ -700,10 +857,11 @@ bool XmlElement::isEquivalentTo (const XmlElement* const other,
 
 void XmlElement::deleteAllChildElements() noexcept
 {
+    clearChildIndex();
     firstChildElement.deleteAll();
 }
 
-void XmlElement::deleteAllChildElementsWithTagName (const String& name) noexcept
+void XmlElement::deleteAllChildElementsWithTagName (StringRef name) noexcept
 {
     for (XmlElement* child = firstChildElement; child != nullptr;)
     {
@@ -745,6 +903,8 @@ void XmlElement::getChildElementsAsArray (XmlElement** elems) const noexcept
 
 void XmlElement::reorderChildElements (XmlElement** const elems, const int num) noexcept
 {
+    clearChildIndex();
+
     XmlElement* e = firstChildElement = elems[0];
 
     for (int i = 1; i < num; ++i)
@@ -267,13 +267,13 @@ public:
         @param possibleTagName  the tag name you're comparing it with
         @see getTagName
     */
-    bool hasTagName (const String& possibleTagName) const noexcept;
+    bool hasTagName (StringRef possibleTagName) const noexcept;
 
     /** Tests whether this element has a particular tag name, ignoring any XML namespace prefix.
         So a test for e.g. "xyz" will return true for "xyz" and also "foo:xyz", "bar::xyz", etc.
         @see getTagName
     */
-    bool hasTagNameIgnoringNamespace (const String& possibleTagName) const;
+    bool hasTagNameIgnoringNamespace (StringRef possibleTagName) const;
 
     //==============================================================================
     /** Returns the number of XML attributes this element contains.
@@ -305,13 +305,13 @@ public:
     // Attribute-handling methods..
 
     /** Checks whether the element contains an attribute with a certain name. */
-    bool hasAttribute (const String& attributeName) const noexcept;
+    bool hasAttribute (StringRef attributeName) const noexcept;
 
     /** Returns the value of a named attribute.
 
         @param attributeName        the name of the attribute to look up
     */
-    const String& getStringAttribute (const String& attributeName) const noexcept;
+    const String& getStringAttribute (StringRef attributeName) const noexcept;
 
     /** Returns the value of a named attribute.
 
@@ -319,7 +319,7 @@ public:
         @param defaultReturnValue   a value to return if the element doesn't have an attribute
                                     with this name
     */
-    String getStringAttribute (const String& attributeName,
+    String getStringAttribute (StringRef attributeName,
                                const String& defaultReturnValue) const;
 
     /** Compares the value of a named attribute with a value passed-in.
@@ -330,7 +330,7 @@ public:
         @returns    true if the value of the attribute is the same as the string passed-in;
                     false if it's different (or if no such attribute exists)
     */
-    bool compareAttribute (const String& attributeName,
+    bool compareAttribute (StringRef attributeName,
                            const String& stringToCompareAgainst,
                            bool ignoreCase = false) const noexcept;
 
@@ -344,7 +344,7 @@ public:
                                     with this name
         @see setAttribute
     */
-    int getIntAttribute (const String& attributeName,
+    int getIntAttribute (StringRef attributeName,
                          int defaultReturnValue = 0) const;
 
     /** Returns the value of a named attribute as floating-point.
@@ -357,7 +357,7 @@ public:
                                     with this name
         @see setAttribute
     */
-    double getDoubleAttribute (const String& attributeName,
+    double getDoubleAttribute (StringRef attributeName,
                                double defaultReturnValue = 0.0) const;
 
     /** Returns the value of a named attribute as a boolean.
@@ -370,7 +370,7 @@ public:
         @param defaultReturnValue   a value to return if the element doesn't have an attribute
                                     with this name
     */
-    bool getBoolAttribute (const String& attributeName,
+    bool getBoolAttribute (StringRef attributeName,
                            bool defaultReturnValue = false) const;
 
     /** Adds a named attribute to the element.
@@ -424,7 +424,7 @@ public:
         @param attributeName    the name of the attribute to remove
         @see removeAllAttributes
     */
-    void removeAttribute (const String& attributeName) noexcept;
+    void removeAttribute (StringRef attributeName) noexcept;
 
     /** Removes all attributes from this element.
     */
@@ -477,7 +477,7 @@ public:
 
         @see getNextElement, forEachXmlChildElementWithTagName
     */
-    XmlElement* getNextElementWithTagName (const String& requiredTagName) const;
+    XmlElement* getNextElementWithTagName (StringRef requiredTagName) const;
 
     /** Returns the number of sub-elements in this element.
 
@@ -487,8 +487,10 @@ public:
 
     /** Returns the sub-element at a certain index.
 
-        It's not very efficient to iterate the sub-elements by index - see
-        getNextElement() for an example of how best to iterate.
+        Once an element has more than a handful of children, the first indexed lookup
+        builds a small positional index, so that subsequent calls are constant-time until
+        the list of children is next modified (other than by appending). Iterating with
+        getNextElement() is still the cheapest way to visit every child, though.
 
         @returns the n'th child of this element, or nullptr if the index is out-of-range
         @see getNextElement, isTextElement, getChildByName
@@ -497,11 +499,14 @@ public:
 
     /** Returns the first sub-element with a given tag-name.
 
+        For elements with many children, this uses the same lazily-built index as
+        getChildElement(), so repeated lookups don't have to scan the whole list.
+
         @param tagNameToLookFor     the tag name of the element you want to find
         @returns the first element with this tag name, or nullptr if none is found
         @see getNextElement, isTextElement, getChildElement
     */
-    XmlElement* getChildByName (const String& tagNameToLookFor) const noexcept;
+    XmlElement* getChildByName (StringRef tagNameToLookFor) const noexcept;
 
     //==============================================================================
     /** Appends an element to this element's list of children.
@@ -574,7 +579,7 @@ public:
 
         @see removeChildElement
     */
-    void deleteAllChildElementsWithTagName (const String& tagName) noexcept;
+    void deleteAllChildElementsWithTagName (StringRef tagName) noexcept;
 
     /** Returns true if the given element is a child of this one. */
     bool containsChildElement (const XmlElement* possibleChild) const noexcept;
@@ -704,30 +709,32 @@ public:
 private:
     struct XmlAttributeNode
     {
+        XmlAttributeNode() noexcept;
         XmlAttributeNode (const XmlAttributeNode&) noexcept;
         XmlAttributeNode (const String& name, const String& value) noexcept;
 
-        LinkedListPointer<XmlAttributeNode> nextListItem;
         String name, value;
 
-        bool hasName (const String&) const noexcept;
-
-    private:
-        XmlAttributeNode& operator= (const XmlAttributeNode&);
+        bool hasName (StringRef) const noexcept;
     };
 
+    struct ChildIndex;
+
     friend class XmlDocument;
-    friend class LinkedListPointer <XmlAttributeNode>;
     friend class LinkedListPointer <XmlElement>;
     friend class LinkedListPointer <XmlElement>::Appender;
 
     LinkedListPointer <XmlElement> nextListItem;
     LinkedListPointer <XmlElement> firstChildElement;
-    LinkedListPointer <XmlAttributeNode> attributes;
+    Array<XmlAttributeNode> attributes;
     String tagName;
+    mutable Atomic<ChildIndex*> childIndex;
 
     XmlElement (int) noexcept;
     void copyChildrenAndAttributesFrom (const XmlElement&);
+    const ChildIndex* getChildIndex (int numChildrenScanned) const;
+    void clearChildIndex() noexcept;
+    XmlAttributeNode* findAttribute (StringRef) const noexcept;
     void writeElementAsText (OutputStream&, int indentationLevel, int lineWrapLength) const;
     void getChildElementsAsArray (XmlElement**) const noexcept;
     void reorderChildElements (XmlElement**, int) noexcept;
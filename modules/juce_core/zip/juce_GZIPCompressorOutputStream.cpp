@@ -118,6 +118,273 @@ private:
     JUCE_DECLARE_NON_COPYABLE (GZIPCompressorHelper)
 };
 
+//==============================================================================
+class GZIPCompressorOutputStream::ParallelCompressorHelper
+{
+public:
+    ParallelCompressorHelper (ThreadPool& threadPool, const int compressionLevel,
+                              const int windowBits, const int blockSize_)
+        : pool (threadPool),
+          compLevel ((compressionLevel < 1 || compressionLevel > 9) ? -1 : compressionLevel),
+          format (windowBits < 0 ? rawFormat : (windowBits > MAX_WBITS ? gzipFormat : zlibFormat)),
+          windowSize (windowBits == 0 ? MAX_WBITS : (windowBits < 0 ? -windowBits : (windowBits & 15))),
+          blockSize ((size_t) jmax (4096, blockSize_)),
+          maxBlocksInFlight (jmax (4, SystemStats::getNumCpus() * 2)),
+          currentBlockSize (0),
+          totalLength (0),
+          checksum (format == zlibFormat ? 1 : 0),
+          headerWritten (false),
+          finished (false),
+          failed (false)
+    {
+    }
+
+    bool write (const uint8* data, size_t dataSize, OutputStream& out)
+    {
+        // When you call flush() on a gzip stream, the stream is closed, and you can
+        // no longer continue to write data to it!
+        jassert (! finished);
+
+        while (dataSize > 0 && ! failed)
+        {
+            if (currentBlock == nullptr)
+            {
+                currentBlock = new Block();
+                currentBlock->input.malloc (blockSize);
+            }
+
+            const size_t num = jmin (dataSize, blockSize - currentBlockSize);
+            memcpy (currentBlock->input + currentBlockSize, data, num);
+            currentBlockSize += num;
+            data += num;
+            dataSize -= num;
+
+            if (currentBlockSize == blockSize)
+                submitCurrentBlock (false, out);
+        }
+
+        return ! failed;
+    }
+
+    void finish (OutputStream& out)
+    {
+        if (finished)
+            return;
+
+        finished = true;
+
+        if (currentBlock == nullptr)
+            currentBlock = new Block();
+
+        submitCurrentBlock (true, out);
+
+        while (pendingBlocks.size() > 0)
+            writeNextBlock (out);
+
+        if (! failed)
+            writeTrailer (out);
+    }
+
+private:
+    enum Format { rawFormat, zlibFormat, gzipFormat };
+
+    struct Block  : public ReferenceCountedObject
+    {
+        Block() : inputSize (0), checksum (0), isLast (false), ok (false), done (true) {}
+
+        typedef ReferenceCountedObjectPtr<Block> Ptr;
+
+        HeapBlock<uint8> input;
+        size_t inputSize;
+        Ptr previous;
+        MemoryOutputStream output;
+        zlibNamespace::uLong checksum;
+        bool isLast, ok;
+        WaitableEvent done;
+    };
+
+    class CompressionTask  : public ThreadPoolTask
+    {
+    public:
+        CompressionTask (ParallelCompressorHelper& owner_, Block* block_)
+            : block (block_), compLevel (owner_.compLevel),
+              windowSize (owner_.windowSize), format (owner_.format)
+        {
+        }
+
+        void runTask()
+        {
+            block->ok = compress();
+            block->previous = nullptr;
+            block->done.signal();
+        }
+
+    private:
+        Block::Ptr block;
+        const int compLevel, windowSize;
+        const Format format;
+
+        bool compress()
+        {
+            using namespace zlibNamespace;
+
+            Bytef* const input = block->input;
+            const uInt inputSize = (uInt) block->inputSize;
+
+            if (format == gzipFormat)       block->checksum = crc32 (0, input, inputSize);
+            else if (format == zlibFormat)  block->checksum = adler32 (1, input, inputSize);
+
+            z_stream stream;
+            zerostruct (stream);
+
+            if (deflateInit2 (&stream, compLevel, Z_DEFLATED, -windowSize, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+                return false;
+
+            bool ok = true;
+
+            if (block->previous != nullptr)
+            {
+                // Priming each block with the end of the one before means that matches can
+                // still reach back across the join, just as they would in a single stream.
+                const uInt dictionarySize = jmin ((uInt) block->previous->inputSize, (uInt) (1 << windowSize));
+                ok = deflateSetDictionary (&stream, block->previous->input + block->previous->inputSize - dictionarySize,
+                                           dictionarySize) == Z_OK;
+            }
+
+            stream.next_in  = input;
+            stream.avail_in = inputSize;
+
+            // A sync-flush leaves the block ending on a byte boundary without marking it as the
+            // last one, so the blocks can simply be concatenated.
+            const int flushMode = block->isLast ? Z_FINISH : Z_SYNC_FLUSH;
+            Bytef buffer [16384];
+
+            while (ok)
+            {
+                stream.next_out  = buffer;
+                stream.avail_out = (uInt) sizeof (buffer);
+
+                const int result = deflate (&stream, flushMode);
+
+                if (result != Z_OK && result != Z_STREAM_END && result != Z_BUF_ERROR)
+                    ok = false;
+
+                block->output.write (buffer, sizeof (buffer) - stream.avail_out);
+
+                if (result == Z_STREAM_END || (flushMode == Z_SYNC_FLUSH && stream.avail_out != 0))
+                    break;
+            }
+
+            deflateEnd (&stream);
+            return ok;
+        }
+
+        JUCE_DECLARE_NON_COPYABLE (CompressionTask)
+    };
+
+    ThreadPool& pool;
+    const int compLevel;
+    const Format format;
+    const int windowSize;
+    const size_t blockSize;
+    const int maxBlocksInFlight;
+    Block::Ptr currentBlock, lastSubmittedBlock;
+    size_t currentBlockSize;
+    ReferenceCountedArray<Block> pendingBlocks;
+    int64 totalLength;
+    zlibNamespace::uLong checksum;
+    bool headerWritten, finished, failed;
+
+    void submitCurrentBlock (const bool isLast, OutputStream& out)
+    {
+        while (pendingBlocks.size() >= maxBlocksInFlight
+                || (pendingBlocks.size() > 0 && pendingBlocks.getUnchecked (0)->done.wait (0)))
+            writeNextBlock (out);
+
+        currentBlock->inputSize = currentBlockSize;
+        currentBlock->isLast = isLast;
+        currentBlock->previous = lastSubmittedBlock;
+
+        pendingBlocks.add (currentBlock);
+        pool.addTask (new CompressionTask (*this, currentBlock));
+
+        lastSubmittedBlock = currentBlock;
+        currentBlock = nullptr;
+        currentBlockSize = 0;
+    }
+
+    void writeNextBlock (OutputStream& out)
+    {
+        const Block::Ptr block (pendingBlocks.getUnchecked (0));
+        block->done.wait();
+        pendingBlocks.remove (0);
+
+        if (failed)
+            return;
+
+        if (! headerWritten)
+        {
+            headerWritten = true;
+            writeHeader (out);
+        }
+
+        if (! block->ok)
+        {
+            failed = true;
+            return;
+        }
+
+        {
+            using namespace zlibNamespace;
+
+            if (format == gzipFormat)
+                checksum = crc32_combine (checksum, block->checksum, (z_off_t) block->inputSize);
+            else if (format == zlibFormat)
+                checksum = adler32_combine (checksum, block->checksum, (z_off_t) block->inputSize);
+        }
+
+        totalLength += (int64) block->inputSize;
+
+        if (! out.write (block->output.getData(), block->output.getDataSize()))
+            failed = true;
+    }
+
+    void writeHeader (OutputStream& out)
+    {
+        if (format == gzipFormat)
+        {
+            const uint8 header[] = { 0x1f, 0x8b, 8, 0, 0, 0, 0, 0,
+                                     (uint8) (compLevel == 9 ? 2 : (compLevel == 1 ? 4 : 0)),
+                                     0xff };
+            out.write (header, sizeof (header));
+        }
+        else if (format == zlibFormat)
+        {
+            const int levelFlags = compLevel < 0 ? 2 : (compLevel < 2 ? 0 : (compLevel < 6 ? 1 : (compLevel == 6 ? 2 : 3)));
+            int header = (((windowSize - 8) << 4) | Z_DEFLATED) << 8 | (levelFlags << 6);
+            header += 31 - (header % 31);
+
+            out.writeByte ((char) (header >> 8));
+            out.writeByte ((char) header);
+        }
+    }
+
+    void writeTrailer (OutputStream& out)
+    {
+        if (format == gzipFormat)
+        {
+            out.writeInt ((int) checksum);
+            out.writeInt ((int) totalLength);
+        }
+        else if (format == zlibFormat)
+        {
+            out.writeIntBigEndian ((int) checksum);
+        }
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (ParallelCompressorHelper)
+};
+
 //==============================================================================
 GZIPCompressorOutputStream::GZIPCompressorOutputStream (OutputStream* const out,
                                                         const int compressionLevel,
@@ -129,6 +396,18 @@ GZIPCompressorOutputStream::GZIPCompressorOutputStream (OutputStream* const out,
     jassert (out != nullptr);
 }
 
+GZIPCompressorOutputStream::GZIPCompressorOutputStream (OutputStream* const out,
+                                                        ThreadPool& threadPoolToUse,
+                                                        const int compressionLevel,
+                                                        const bool deleteDestStream,
+                                                        const int windowBits,
+                                                        const int blockSize)
+    : destStream (out, deleteDestStream),
+      parallelHelper (new ParallelCompressorHelper (threadPoolToUse, compressionLevel, windowBits, blockSize))
+{
+    jassert (out != nullptr);
+}
+
 GZIPCompressorOutputStream::~GZIPCompressorOutputStream()
 {
     flush();
@@ -136,7 +415,11 @@ GZIPCompressorOutputStream::~GZIPCompressorOutputStream()
 
 void GZIPCompressorOutputStream::flush()
 {
-    helper->finish (*destStream);
+    if (parallelHelper != nullptr)
+        parallelHelper->finish (*destStream);
+    else
+        helper->finish (*destStream);
+
     destStream->flush();
 }
 
@@ -144,6 +427,9 @@ bool GZIPCompressorOutputStream::write (const void* destBuffer, size_t howMany)
 {
     jassert (destBuffer != nullptr && (ssize_t) howMany >= 0);
 
+    if (parallelHelper != nullptr)
+        return parallelHelper->write (static_cast <const uint8*> (destBuffer), howMany, *destStream);
+
     return helper->write (static_cast <const uint8*> (destBuffer), howMany, *destStream);
 }
 
@@ -205,6 +491,67 @@ public:
                                 original.getData(),
                                 original.getDataSize()) == 0);
         }
+
+        beginTest ("Parallel");
+        ThreadPool pool (4);
+
+        for (int i = 30; --i >= 0;)
+        {
+            MemoryOutputStream original, compressed, uncompressed;
+            const int format = i % 3;
+            const int windowBits = format == 0 ? GZIPCompressorOutputStream::windowBitsRaw
+                                               : (format == 1 ? 0 : (int) GZIPCompressorOutputStream::windowBitsGZIP);
+
+            {
+                GZIPCompressorOutputStream zipper (&compressed, pool, rng.nextInt (10), false,
+                                                   windowBits, 4096 + rng.nextInt (10000));
+
+                for (int j = rng.nextInt (100); --j >= 0;)
+                {
+                    MemoryBlock data ((unsigned int) (rng.nextInt (2000) + 1));
+
+                    for (int k = (int) data.getSize(); --k >= 0;)
+                        data[k] = (char) ('a' + rng.nextInt (3));
+
+                    original << data;
+                    zipper   << data;
+                }
+            }
+
+            if (format == 2)
+            {
+                // (the decompressor stream can't read gzip headers, so this uses zlib directly)
+                using namespace zlibNamespace;
+                z_stream stream;
+                zerostruct (stream);
+                expect (inflateInit2 (&stream, 15 + 16) == Z_OK);
+
+                HeapBlock<Bytef> buffer (original.getDataSize() + 1);
+                stream.next_in   = (Bytef*) compressed.getData();
+                stream.avail_in  = (uInt) compressed.getDataSize();
+                stream.next_out  = buffer;
+                stream.avail_out = (uInt) original.getDataSize() + 1;
+
+                expect (inflate (&stream, Z_FINISH) == Z_STREAM_END);
+                uncompressed.write (buffer, stream.total_out);
+                inflateEnd (&stream);
+            }
+            else
+            {
+                MemoryInputStream compressedInput (compressed.getData(), compressed.getDataSize(), false);
+                GZIPDecompressorInputStream unzipper (&compressedInput, false, format == 0);
+
+                uncompressed << unzipper;
+            }
+
+            expectEquals ((int) uncompressed.getDataSize(),
+                          (int) original.getDataSize());
+
+            if (original.getDataSize() == uncompressed.getDataSize())
+                expect (memcmp (uncompressed.getData(),
+                                original.getData(),
+                                original.getDataSize()) == 0);
+        }
     }
 };
 
@@ -32,6 +32,7 @@
 #include "../streams/juce_OutputStream.h"
 #include "../memory/juce_OptionalScopedPointer.h"
 #include "../memory/juce_HeapBlock.h"
+#include "../threads/juce_ThreadPool.h"
 
 
 //==============================================================================
@@ -67,6 +68,26 @@ public:
                                 bool deleteDestStreamWhenDestroyed = false,
                                 int windowBits = 0);
 
+    /** Creates a compression stream which shares its work out between the threads of a pool.
+
+        The incoming data is split into blocks of blockSize bytes, which are compressed
+        independently on the pool's threads (each one being primed with the last 32K of the
+        block before it, so very little compression is lost), and the results are joined
+        together into a single valid stream, in the format that windowBits asks for.
+
+        The output won't be byte-for-byte identical to what the single-threaded stream would
+        produce, but it'll decompress to the same data. The pool must not be deleted until
+        this stream has been flushed or deleted.
+
+        The other parameters are the same as for the other constructor.
+    */
+    GZIPCompressorOutputStream (OutputStream* destStream,
+                                ThreadPool& threadPoolToUse,
+                                int compressionLevel = 0,
+                                bool deleteDestStreamWhenDestroyed = false,
+                                int windowBits = 0,
+                                int blockSize = 128 * 1024);
+
     /** Destructor. */
     ~GZIPCompressorOutputStream();
 
@@ -96,8 +117,11 @@ private:
     OptionalScopedPointer<OutputStream> destStream;
 
     class GZIPCompressorHelper;
+    class ParallelCompressorHelper;
     friend class ScopedPointer <GZIPCompressorHelper>;
+    friend class ScopedPointer <ParallelCompressorHelper>;
     ScopedPointer <GZIPCompressorHelper> helper;
+    ScopedPointer <ParallelCompressorHelper> parallelHelper;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (GZIPCompressorOutputStream)
 };
@@ -29,7 +29,7 @@
 class ZipFile::ZipEntryHolder
 {
 public:
-    ZipEntryHolder (const char* const buffer, const int fileNameLen)
+    ZipEntryHolder (const char* const buffer, const int fileNameLen, const int extraFieldLen)
     {
         entry.filename = String::fromUTF8 (buffer + 46, fileNameLen);
 
@@ -38,10 +38,11 @@ public:
         entry.fileTime = getFileTimeFromRawEncodings (time, date);
 
         compressed = ByteOrder::littleEndianShort (buffer + 10) != 0;
-        compressedSize = (size_t) ByteOrder::littleEndianInt (buffer + 20);
+        compressedSize = ByteOrder::littleEndianInt (buffer + 20);
         entry.uncompressedSize = ByteOrder::littleEndianInt (buffer + 24);
-
         streamOffset = ByteOrder::littleEndianInt (buffer + 42);
+
+        readZip64ExtraField (buffer + 46 + fileNameLen, extraFieldLen);
     }
 
     struct FileNameComparator
@@ -52,9 +53,24 @@ public:
         }
     };
 
+    // Sorts a list of entry indexes so that the biggest entries come first.
+    struct SizeComparator
+    {
+        SizeComparator (const OwnedArray<ZipEntryHolder>& e) : entryList (e) {}
+
+        int compareElements (const int first, const int second) const noexcept
+        {
+            const int64 diff = entryList.getUnchecked (second)->compressedSize
+                                - entryList.getUnchecked (first)->compressedSize;
+            return diff < 0 ? -1 : (diff > 0 ? 1 : 0);
+        }
+
+        const OwnedArray<ZipEntryHolder>& entryList;
+    };
+
     ZipEntry entry;
-    size_t streamOffset;
-    size_t compressedSize;
+    int64 streamOffset;
+    int64 compressedSize;
     bool compressed;
 
 private:
@@ -69,12 +85,70 @@ private:
 
         return Time (year, month, day, hours, minutes, seconds);
     }
+
+    static int64 readInt64 (const char* const data) noexcept
+    {
+        return (int64) ByteOrder::littleEndianInt (data)
+                 | (((int64) ByteOrder::littleEndianInt (data + 4)) << 32);
+    }
+
+    /*  In a Zip64 archive, any size or offset that doesn't fit into 32 bits is set to
+        0xffffffff, and its real value is stored in an extra field with the ID 1.
+    */
+    void readZip64ExtraField (const char* extra, int extraLen)
+    {
+        while (extraLen >= 4)
+        {
+            const int fieldID = ByteOrder::littleEndianShort (extra);
+            const int fieldLen = ByteOrder::littleEndianShort (extra + 2);
+            extra += 4;
+            extraLen -= 4;
+
+            if (fieldLen > extraLen)
+                break;
+
+            if (fieldID == 1)
+            {
+                const char* field = extra;
+                const char* const fieldEnd = extra + fieldLen;
+
+                if (entry.uncompressedSize == 0xffffffff && field + 8 <= fieldEnd)
+                {
+                    entry.uncompressedSize = readInt64 (field);
+                    field += 8;
+                }
+
+                if (compressedSize == 0xffffffff && field + 8 <= fieldEnd)
+                {
+                    compressedSize = readInt64 (field);
+                    field += 8;
+                }
+
+                if (streamOffset == 0xffffffff && field + 8 <= fieldEnd)
+                    streamOffset = readInt64 (field);
+
+                break;
+            }
+
+            extra += fieldLen;
+            extraLen -= fieldLen;
+        }
+    }
 };
 
 //==============================================================================
 namespace
 {
-    int findEndOfZipEntryTable (InputStream& input, int& numEntries)
+    String getEntryPath (const String& filename)
+    {
+       #if JUCE_WINDOWS
+        return filename;
+       #else
+        return filename.replaceCharacter ('\\', '/');
+       #endif
+    }
+
+    int64 findEndOfZipEntryTable (InputStream& input, int& numEntries)
     {
         BufferedInputStream in (input, 8192);
 
@@ -82,7 +156,7 @@ namespace
         int64 pos = in.getPosition();
         const int64 lowestPos = jmax ((int64) 0, pos - 1024);
 
-        char buffer [32] = { 0 };
+        char buffer [64] = { 0 };
 
         while (pos > lowestPos)
         {
@@ -97,11 +171,33 @@ namespace
             {
                 if (ByteOrder::littleEndianInt (buffer + i) == 0x06054b50)
                 {
-                    in.setPosition (pos + i);
+                    const int64 endOfTable = pos + i;
+                    in.setPosition (endOfTable);
                     in.read (buffer, 22);
                     numEntries = ByteOrder::littleEndianShort (buffer + 10);
-
-                    return (int) ByteOrder::littleEndianInt (buffer + 16);
+                    int64 tableStart = ByteOrder::littleEndianInt (buffer + 16);
+
+                    // If there's a Zip64 locator just before the end record, then the real values
+                    // are in the Zip64 end record that it points to.
+                    if (endOfTable >= 20
+                         && in.setPosition (endOfTable - 20)
+                         && in.read (buffer, 20) == 20
+                         && ByteOrder::littleEndianInt (buffer) == 0x07064b50)
+                    {
+                        const int64 zip64EndRecord = (int64) ByteOrder::littleEndianInt (buffer + 8)
+                                                       | (((int64) ByteOrder::littleEndianInt (buffer + 12)) << 32);
+
+                        if (in.setPosition (zip64EndRecord)
+                             && in.read (buffer, 56) == 56
+                             && ByteOrder::littleEndianInt (buffer) == 0x06064b50)
+                        {
+                            numEntries = (int) ByteOrder::littleEndianInt (buffer + 32);
+                            tableStart = (int64) ByteOrder::littleEndianInt (buffer + 48)
+                                          | (((int64) ByteOrder::littleEndianInt (buffer + 52)) << 32);
+                        }
+                    }
+
+                    return tableStart;
                 }
             }
         }
@@ -114,33 +210,39 @@ namespace
 class ZipFile::ZipInputStream  : public InputStream
 {
 public:
-    ZipInputStream (ZipFile& zf, ZipFile::ZipEntryHolder& zei)
+    ZipInputStream (ZipFile& zf, ZipFile::ZipEntryHolder& zei, InputStream* const sourceStream)
         : file (zf),
           zipEntryHolder (zei),
           pos (0),
           headerSize (0),
-          inputStream (zf.inputStream)
+          inputStream (sourceStream != nullptr ? sourceStream : zf.inputStream)
     {
-        if (zf.inputSource != nullptr)
-        {
-            inputStream = streamToDelete = file.inputSource->createInputStream();
-        }
-        else
+        if (sourceStream == nullptr)
         {
-           #if JUCE_DEBUG
-            zf.streamCounter.numOpenStreams++;
-           #endif
+            if (zf.inputSource != nullptr)
+            {
+                inputStream = streamToDelete = file.inputSource->createInputStream();
+            }
+            else
+            {
+               #if JUCE_DEBUG
+                zf.streamCounter.numOpenStreams++;
+               #endif
+            }
         }
 
-        char buffer [30];
-
-        if (inputStream != nullptr
-             && inputStream->setPosition (zei.streamOffset)
-             && inputStream->read (buffer, 30) == 30
-             && ByteOrder::littleEndianInt (buffer) == 0x04034b50)
+        if (inputStream != nullptr)
         {
-            headerSize = 30 + ByteOrder::littleEndianShort (buffer + 26)
-                            + ByteOrder::littleEndianShort (buffer + 28);
+            const ScopedLock sl (inputStream == zf.inputStream ? zf.lock : localLock);
+            char buffer [30];
+
+            if (inputStream->setPosition (zei.streamOffset)
+                 && inputStream->read (buffer, 30) == 30
+                 && ByteOrder::littleEndianInt (buffer) == 0x04034b50)
+            {
+                headerSize = 30 + ByteOrder::littleEndianShort (buffer + 26)
+                                + ByteOrder::littleEndianShort (buffer + 28);
+            }
         }
     }
 
@@ -162,21 +264,15 @@ public:
         if (headerSize <= 0)
             return 0;
 
-        howMany = (int) jmin ((int64) howMany, (int64) (zipEntryHolder.compressedSize - pos));
+        howMany = (int) jmin ((int64) howMany, zipEntryHolder.compressedSize - pos);
 
         if (inputStream == nullptr)
             return 0;
 
         int num;
 
-        if (inputStream == file.inputStream)
-        {
-            const ScopedLock sl (file.lock);
-            inputStream->setPosition (pos + zipEntryHolder.streamOffset + headerSize);
-            num = inputStream->read (buffer, howMany);
-        }
-        else
         {
+            const ScopedLock sl (inputStream == file.inputStream ? file.lock : localLock);
             inputStream->setPosition (pos + zipEntryHolder.streamOffset + headerSize);
             num = inputStream->read (buffer, howMany);
         }
@@ -187,7 +283,7 @@ public:
 
     bool isExhausted()
     {
-        return headerSize <= 0 || pos >= (int64) zipEntryHolder.compressedSize;
+        return headerSize <= 0 || pos >= zipEntryHolder.compressedSize;
     }
 
     int64 getPosition()
@@ -197,7 +293,7 @@ public:
 
     bool setPosition (int64 newPos)
     {
-        pos = jlimit ((int64) 0, (int64) zipEntryHolder.compressedSize, newPos);
+        pos = jlimit ((int64) 0, zipEntryHolder.compressedSize, newPos);
         return true;
     }
 
@@ -208,10 +304,76 @@ private:
     int headerSize;
     InputStream* inputStream;
     ScopedPointer<InputStream> streamToDelete;
+    CriticalSection localLock;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ZipInputStream)
 };
 
+//==============================================================================
+class ZipFile::ExtractionThread  : public Thread
+{
+public:
+    struct SharedState
+    {
+        SharedState (const Array<int>& indexes_, const File& targetDirectory_, bool shouldOverwriteFiles_)
+            : indexes (indexes_), targetDirectory (targetDirectory_),
+              shouldOverwriteFiles (shouldOverwriteFiles_), result (Result::ok())
+        {
+        }
+
+        const Array<int>& indexes;
+        const File targetDirectory;
+        const bool shouldOverwriteFiles;
+        Atomic<int> nextIndex;
+        CriticalSection lock;
+        Result result;
+
+        JUCE_DECLARE_NON_COPYABLE (SharedState)
+    };
+
+    ExtractionThread (ZipFile& owner_, SharedState& state_)
+        : Thread ("Zip extraction"), owner (owner_), state (state_)
+    {
+    }
+
+    void run()
+    {
+        // Each thread reads through its own stream if it can, so that they don't all have
+        // to wait for the lock on a shared one.
+        ScopedPointer<InputStream> source;
+
+        if (owner.inputSource != nullptr && owner.mappedFile == nullptr)
+            source = owner.inputSource->createInputStream();
+
+        while (! threadShouldExit())
+        {
+            const int i = (++state.nextIndex) - 1;
+
+            if (i >= state.indexes.size())
+                break;
+
+            const Result r (owner.uncompressEntryInt (state.indexes.getUnchecked (i), state.targetDirectory,
+                                                      state.shouldOverwriteFiles, source));
+
+            if (r.failed())
+            {
+                const ScopedLock sl (state.lock);
+
+                if (state.result.wasOk())
+                    state.result = r;
+
+                state.nextIndex = state.indexes.size(); // (stops the other threads)
+                break;
+            }
+        }
+    }
+
+private:
+    ZipFile& owner;
+    SharedState& state;
+
+    JUCE_DECLARE_NON_COPYABLE (ExtractionThread)
+};
 
 //==============================================================================
 ZipFile::ZipFile (InputStream* const stream, const bool deleteStreamWhenDestroyed)
@@ -229,10 +391,18 @@ ZipFile::ZipFile (InputStream& stream)
     init();
 }
 
-ZipFile::ZipFile (const File& file)
+ZipFile::ZipFile (const File& file, const bool useMemoryMapping)
     : inputStream (nullptr),
       inputSource (new FileInputSource (file))
 {
+    if (useMemoryMapping)
+    {
+        mappedFile = new MemoryMappedFile (file, MemoryMappedFile::readOnly);
+
+        if (mappedFile->getData() == nullptr)
+            mappedFile = nullptr;
+    }
+
     init();
 }
 
@@ -276,11 +446,7 @@ const ZipFile::ZipEntry* ZipFile::getEntry (const int index) const noexcept
 
 int ZipFile::getIndexOfFileName (const String& fileName) const noexcept
 {
-    for (int i = 0; i < entries.size(); ++i)
-        if (entries.getUnchecked (i)->entry.filename == fileName)
-            return i;
-
-    return -1;
+    return fileNameIndex.contains (fileName) ? fileNameIndex [fileName] : -1;
 }
 
 const ZipFile::ZipEntry* ZipFile::getEntry (const String& fileName) const noexcept
@@ -288,13 +454,48 @@ const ZipFile::ZipEntry* ZipFile::getEntry (const String& fileName) const noexce
     return getEntry (getIndexOfFileName (fileName));
 }
 
+const char* ZipFile::getMappedDataForEntry (const ZipEntryHolder& zei) const noexcept
+{
+    if (mappedFile == nullptr)
+        return nullptr;
+
+    const char* const data = static_cast <const char*> (mappedFile->getData());
+    const int64 size = (int64) mappedFile->getSize();
+    const int64 start = zei.streamOffset;
+
+    if (start < 0 || start + 30 > size || ByteOrder::littleEndianInt (data + start) != 0x04034b50)
+        return nullptr;
+
+    const int64 dataStart = start + 30 + ByteOrder::littleEndianShort (data + start + 26)
+                                       + ByteOrder::littleEndianShort (data + start + 28);
+
+    return dataStart + zei.compressedSize <= size ? data + dataStart : nullptr;
+}
+
+const void* ZipFile::getMappedEntryData (const int index) const noexcept
+{
+    if (const ZipEntryHolder* const zei = entries [index])
+        if (! zei->compressed)
+            return getMappedDataForEntry (*zei);
+
+    return nullptr;
+}
+
 InputStream* ZipFile::createStreamForEntry (const int index)
+{
+    return createStreamForEntryInt (index, nullptr);
+}
+
+InputStream* ZipFile::createStreamForEntryInt (const int index, InputStream* const sourceStream)
 {
     InputStream* stream = nullptr;
 
     if (ZipEntryHolder* const zei = entries[index])
     {
-        stream = new ZipInputStream (*this, *zei);
+        if (const char* const mappedData = getMappedDataForEntry (*zei))
+            stream = new MemoryInputStream (mappedData, (size_t) zei->compressedSize, false);
+        else
+            stream = new ZipInputStream (*this, *zei, sourceStream);
 
         if (zei->compressed)
         {
@@ -322,6 +523,17 @@ void ZipFile::sortEntriesByFilename()
 {
     ZipEntryHolder::FileNameComparator sorter;
     entries.sort (sorter);
+    buildFileNameIndex();
+}
+
+void ZipFile::buildFileNameIndex()
+{
+    fileNameIndex.clear();
+    fileNameIndex.remapTable (jmax (101, entries.size() + entries.size() / 2));
+
+    // (if there's more than one entry with the same name, the index refers to the first one)
+    for (int i = entries.size(); --i >= 0;)
+        fileNameIndex.set (entries.getUnchecked (i)->entry.filename, i);
 }
 
 //==============================================================================
@@ -330,7 +542,12 @@ void ZipFile::init()
     ScopedPointer <InputStream> toDelete;
     InputStream* in = inputStream;
 
-    if (inputSource != nullptr)
+    if (mappedFile != nullptr)
+    {
+        in = new MemoryInputStream (mappedFile->getData(), mappedFile->getSize(), false);
+        toDelete = in;
+    }
+    else if (inputSource != nullptr)
     {
         in = inputSource->createInputStream();
         toDelete = in;
@@ -339,17 +556,19 @@ void ZipFile::init()
     if (in != nullptr)
     {
         int numEntries = 0;
-        int pos = findEndOfZipEntryTable (*in, numEntries);
+        int64 pos = findEndOfZipEntryTable (*in, numEntries);
 
         if (pos >= 0 && pos < in->getTotalLength())
         {
-            const int size = (int) (in->getTotalLength() - pos);
+            const int64 size = in->getTotalLength() - pos;
 
             in->setPosition (pos);
             MemoryBlock headerData;
 
-            if (in->readIntoMemoryBlock (headerData, size) == size)
+            if (size < std::numeric_limits<int>::max()
+                 && in->readIntoMemoryBlock (headerData, (ssize_t) size) == (int) size)
             {
+                entries.ensureStorageAllocated (numEntries);
                 pos = 0;
 
                 for (int i = 0; i < numEntries; ++i)
@@ -360,52 +579,106 @@ void ZipFile::init()
                     const char* const buffer = static_cast <const char*> (headerData.getData()) + pos;
 
                     const int fileNameLen = ByteOrder::littleEndianShort (buffer + 28);
+                    const int extraFieldLen = ByteOrder::littleEndianShort (buffer + 30);
 
-                    if (pos + 46 + fileNameLen > size)
+                    if (pos + 46 + fileNameLen + extraFieldLen > size)
                         break;
 
-                    entries.add (new ZipEntryHolder (buffer, fileNameLen));
+                    entries.add (new ZipEntryHolder (buffer, fileNameLen, extraFieldLen));
 
-                    pos += 46 + fileNameLen
-                            + ByteOrder::littleEndianShort (buffer + 30)
+                    pos += 46 + fileNameLen + extraFieldLen
                             + ByteOrder::littleEndianShort (buffer + 32);
                 }
             }
         }
     }
+
+    buildFileNameIndex();
 }
 
 Result ZipFile::uncompressTo (const File& targetDirectory,
-                              const bool shouldOverwriteFiles)
+                              const bool shouldOverwriteFiles,
+                              const int numThreads)
 {
+    if (numThreads <= 1 || entries.size() < 2)
+    {
+        for (int i = 0; i < entries.size(); ++i)
+        {
+            Result result (uncompressEntry (i, targetDirectory, shouldOverwriteFiles));
+            if (result.failed())
+                return result;
+        }
+
+        return Result::ok();
+    }
+
+    // All the folders are created first, so that the threads don't race to create the same ones.
+    Array<int> fileIndexes;
+    File lastFolder;
+
     for (int i = 0; i < entries.size(); ++i)
     {
-        Result result (uncompressEntry (i, targetDirectory, shouldOverwriteFiles));
-        if (result.failed())
-            return result;
+        const String& name = entries.getUnchecked (i)->entry.filename;
+        const File targetFile (targetDirectory.getChildFile (getEntryPath (name)));
+        const bool isFolder = name.endsWithChar ('/') || name.endsWithChar ('\\');
+        const File folder (isFolder ? targetFile : targetFile.getParentDirectory());
+
+        if (folder != lastFolder)
+        {
+            const Result result (folder.createDirectory());
+
+            if (result.failed())
+                return isFolder ? result
+                                : Result::fail ("Failed to create target folder: " + folder.getFullPathName());
+
+            lastFolder = folder;
+        }
+
+        if (! isFolder)
+            fileIndexes.add (i);
     }
 
-    return Result::ok();
+    // Starting with the biggest entries means that the threads are less likely to be
+    // left waiting for one straggler at the end.
+    ZipEntryHolder::SizeComparator comparator (entries);
+    fileIndexes.sort (comparator);
+
+    ExtractionThread::SharedState state (fileIndexes, targetDirectory, shouldOverwriteFiles);
+    OwnedArray<ExtractionThread> threads;
+
+    for (int i = jmin (numThreads, fileIndexes.size()); --i >= 0;)
+    {
+        ExtractionThread* const t = new ExtractionThread (*this, state);
+        threads.add (t);
+        t->startThread();
+    }
+
+    for (int i = threads.size(); --i >= 0;)
+        threads.getUnchecked (i)->waitForThreadToExit (-1);
+
+    return state.result;
 }
 
 Result ZipFile::uncompressEntry (const int index,
                                  const File& targetDirectory,
                                  bool shouldOverwriteFiles)
 {
-    const ZipEntryHolder* zei = entries.getUnchecked (index);
-
-   #if JUCE_WINDOWS
-    const String entryPath (zei->entry.filename);
-   #else
-    const String entryPath (zei->entry.filename.replaceCharacter ('\\', '/'));
-   #endif
+    return uncompressEntryInt (index, targetDirectory, shouldOverwriteFiles, nullptr);
+}
 
+Result ZipFile::uncompressEntryInt (const int index,
+                                    const File& targetDirectory,
+                                    const bool shouldOverwriteFiles,
+                                    InputStream* const sourceStream)
+{
+    const ZipEntryHolder* zei = entries.getUnchecked (index);
+    const String entryPath (getEntryPath (zei->entry.filename));
     const File targetFile (targetDirectory.getChildFile (entryPath));
 
     if (entryPath.endsWithChar ('/') || entryPath.endsWithChar ('\\'))
         return targetFile.createDirectory(); // (entry is a directory, not a file)
 
-    ScopedPointer<InputStream> in (createStreamForEntry (index));
+    ScopedPointer<InputStream> in (createStreamForEntryInt (index, sourceStream));
 
     if (in == nullptr)
         return Result::fail ("Failed to open the zip file for reading");
@@ -451,28 +724,38 @@ public:
           compressionLevel (compression),
           compressedSize (0),
           headerStart (0),
-          checksum (0)
+          checksum (0),
+          compressedOk (false),
+          compressionFinished (true)
     {
     }
 
-    bool writeData (OutputStream& target, const int64 overallStartPosition)
+    bool compressData()
     {
-        MemoryOutputStream compressedData;
-
-        if (compressionLevel > 0)
         {
-            GZIPCompressorOutputStream compressor (&compressedData, compressionLevel, false,
-                                                   GZIPCompressorOutputStream::windowBitsRaw);
-            if (! writeSource (compressor))
-                return false;
-        }
-        else
-        {
-            if (! writeSource (compressedData))
-                return false;
+            MemoryOutputStream out (compressedData, false);
+
+            if (compressionLevel > 0)
+            {
+                GZIPCompressorOutputStream compressor (&out, compressionLevel, false,
+                                                       GZIPCompressorOutputStream::windowBitsRaw);
+                compressedOk = writeSource (compressor);
+            }
+            else
+            {
+                compressedOk = writeSource (out);
+            }
         }
 
-        compressedSize = (int) compressedData.getDataSize();
+        compressedSize = (int) compressedData.getSize();
+        return compressedOk;
+    }
+
+    bool writeData (OutputStream& target, const int64 overallStartPosition)
+    {
+        if (! compressedOk)
+            return false;
+
         headerStart = (int) (target.getPosition() - overallStartPosition);
 
         target.writeInt (0x04034b50);
@@ -480,9 +763,39 @@ public:
         target << storedPathname
                << compressedData;
 
+        compressedData.setSize (0); // (no need to keep this in memory once it's been written)
         return true;
     }
 
+    //==============================================================================
+    class CompressionTask  : public ThreadPoolTask
+    {
+    public:
+        CompressionTask (Item& item_) : item (item_) {}
+
+        void runTask()
+        {
+            item.compressData();
+            item.compressionFinished.signal();
+        }
+
+    private:
+        Item& item;
+
+        JUCE_DECLARE_NON_COPYABLE (CompressionTask)
+    };
+
+    void startCompressing (ThreadPool& pool)
+    {
+        compressionFinished.reset();
+        pool.addTask (new CompressionTask (*this));
+    }
+
+    void waitForCompression()
+    {
+        compressionFinished.wait();
+    }
+
     bool writeDirectoryEntry (OutputStream& target)
     {
         target.writeInt (0x02014b50);
@@ -503,6 +816,9 @@ private:
     String storedPathname;
     int compressionLevel, compressedSize, headerStart;
     unsigned long checksum;
+    MemoryBlock compressedData;
+    bool compressedOk;
+    WaitableEvent compressionFinished;
 
     void writeTimeAndDate (OutputStream& target) const
     {
@@ -561,19 +877,50 @@ void ZipFile::Builder::addFile (const File& fileToAdd, const int compressionLeve
     items.add (new Item (fileToAdd, compressionLevel, storedPathName));
 }
 
-bool ZipFile::Builder::writeToStream (OutputStream& target, double* const progress) const
+bool ZipFile::Builder::writeToStream (OutputStream& target, double* const progress,
+                                      ThreadPool* const threadPool) const
 {
     const int64 fileStart = target.getPosition();
 
+    // When compressing on a pool, only a limited number of items are allowed to be
+    // compressed ahead of the one being written, as each one is held in memory.
+    const int maxItemsAhead = threadPool != nullptr ? jmax (2, SystemStats::getNumCpus() * 2) : 0;
+    int numItemsStarted = 0;
+    bool ok = true;
+
     for (int i = 0; i < items.size(); ++i)
     {
         if (progress != nullptr)
             *progress = (i + 0.5) / items.size();
 
-        if (! items.getUnchecked (i)->writeData (target, fileStart))
-            return false;
+        Item& item = *items.getUnchecked (i);
+
+        if (threadPool != nullptr)
+        {
+            while (numItemsStarted < items.size() && numItemsStarted <= i + maxItemsAhead)
+                items.getUnchecked (numItemsStarted++)->startCompressing (*threadPool);
+
+            item.waitForCompression();
+        }
+        else
+        {
+            item.compressData();
+        }
+
+        if (! item.writeData (target, fileStart))
+        {
+            ok = false;
+            break;
+        }
     }
 
+    // (any items still being compressed must be finished before they can be deleted)
+    for (int i = 0; i < numItemsStarted; ++i)
+        items.getUnchecked (i)->waitForCompression();
+
+    if (! ok)
+        return false;
+
     const int64 directoryStart = target.getPosition();
 
     for (int i = 0; i < items.size(); ++i)
@@ -596,3 +943,231 @@ bool ZipFile::Builder::writeToStream (OutputStream& target, double* const progre
 
     return true;
 }
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class ZipFileTests  : public UnitTest
+{
+public:
+    ZipFileTests() : UnitTest ("ZipFile") {}
+
+    void runTest()
+    {
+        const File folder (File::getSpecialLocation (File::tempDirectory)
+                             .getNonexistentChildFile ("ZipFileTests", String::empty, false));
+        folder.createDirectory();
+
+        Random r (0x1234);
+        const int numFiles = 20;
+        Array<File> sourceFiles;
+
+        for (int i = 0; i < numFiles; ++i)
+        {
+            MemoryOutputStream content;
+
+            for (int j = r.nextInt (20000) + 10; --j >= 0;)
+                content << (char) ('a' + r.nextInt (4));
+
+            const File f (folder.getChildFile ("source").getChildFile ("file" + String (i) + ".txt"));
+            f.getParentDirectory().createDirectory();
+            f.replaceWithData (content.getData(), content.getDataSize());
+            sourceFiles.add (f);
+        }
+
+        const File zip (folder.getChildFile ("test.zip"));
+
+        {
+            ZipFile::Builder builder;
+
+            for (int i = 0; i < numFiles; ++i)
+                builder.addFile (sourceFiles[i], (i & 1) != 0 ? 9 : 0,
+                                 "sub" + String (i % 3) + "/" + sourceFiles[i].getFileName());
+
+            FileOutputStream out (zip);
+            builder.writeToStream (out, nullptr);
+        }
+
+        beginTest ("Reading");
+
+        {
+            ZipFile zf (zip);
+            expect (zf.getNumEntries() == numFiles);
+
+            for (int i = 0; i < numFiles; ++i)
+            {
+                const String name ("sub" + String (i % 3) + "/" + sourceFiles[i].getFileName());
+                expect (zf.getIndexOfFileName (name) == i);
+                expect (zf.getEntry (name)->uncompressedSize == sourceFiles[i].getSize());
+                expect (zf.getMappedEntryData (i) == nullptr);
+
+                ScopedPointer<InputStream> in (zf.createStreamForEntry (i));
+                expect (in != nullptr && in->readEntireStreamAsString() == sourceFiles[i].loadFileAsString());
+            }
+
+            expect (zf.getIndexOfFileName ("nonexistent") < 0);
+        }
+
+        beginTest ("Parallel compression");
+
+        {
+            const File zip2 (folder.getChildFile ("test2.zip"));
+
+            {
+                ThreadPool pool (4);
+                ZipFile::Builder builder;
+
+                for (int i = 0; i < numFiles; ++i)
+                    builder.addFile (sourceFiles[i], 1 + i % 9);
+
+                FileOutputStream out (zip2);
+                expect (builder.writeToStream (out, nullptr, &pool));
+            }
+
+            ZipFile zf (zip2);
+            expect (zf.getNumEntries() == numFiles);
+
+            for (int i = 0; i < numFiles; ++i)
+            {
+                ScopedPointer<InputStream> in (zf.createStreamForEntry (i));
+                expect (zf.getEntry (i)->filename == sourceFiles[i].getFileName());
+                expect (in != nullptr && in->readEntireStreamAsString() == sourceFiles[i].loadFileAsString());
+            }
+        }
+
+        beginTest ("Memory-mapped");
+
+        {
+            ZipFile zf (zip, true);
+            expect (zf.getNumEntries() == numFiles);
+
+            for (int i = 0; i < numFiles; ++i)
+            {
+                const String original (sourceFiles[i].loadFileAsString());
+
+                if ((i & 1) == 0)
+                {
+                    const char* const data = static_cast <const char*> (zf.getMappedEntryData (i));
+                    expect (data != nullptr && String (data, (size_t) original.length()) == original);
+                }
+                else
+                {
+                    expect (zf.getMappedEntryData (i) == nullptr);
+                }
+
+                ScopedPointer<InputStream> in (zf.createStreamForEntry (i));
+                expect (in != nullptr && in->readEntireStreamAsString() == original);
+            }
+        }
+
+        beginTest ("Multi-threaded extraction");
+
+        for (int mapped = 0; mapped < 2; ++mapped)
+        {
+            const File target (folder.getChildFile ("out" + String (mapped)));
+            ZipFile zf (zip, mapped != 0);
+            expect (zf.uncompressTo (target, true, 4).wasOk());
+
+            for (int i = 0; i < numFiles; ++i)
+            {
+                const File f (target.getChildFile ("sub" + String (i % 3)).getChildFile (sourceFiles[i].getFileName()));
+                expect (f.loadFileAsString() == sourceFiles[i].loadFileAsString());
+            }
+        }
+
+        beginTest ("Zip64");
+
+        {
+            MemoryBlock data (createZip64Archive ("big.txt", "hello zip64"));
+            ZipFile zf (new MemoryInputStream (data, false), true);
+
+            expect (zf.getNumEntries() == 1);
+            expect (zf.getIndexOfFileName ("big.txt") == 0);
+            expect (zf.getEntry (0)->uncompressedSize == 11);
+
+            ScopedPointer<InputStream> in (zf.createStreamForEntry (0));
+            expect (in != nullptr && in->readEntireStreamAsString() == "hello zip64");
+        }
+
+        folder.deleteRecursively();
+    }
+
+    // Builds an archive containing one stored entry, with all its sizes and offsets
+    // moved into Zip64 records.
+    static MemoryBlock createZip64Archive (const String& name, const String& content)
+    {
+        MemoryOutputStream out;
+        const int nameLen = (int) name.getNumBytesAsUTF8();
+        const int contentLen = (int) content.getNumBytesAsUTF8();
+
+        out.writeInt (0x04034b50);
+        out.writeShort (45);
+        out.writeShort (0);
+        out.writeShort (0);
+        out.writeInt (0);
+        out.writeInt ((int) juce_crc32 (0, (const unsigned char*) content.toRawUTF8(), (unsigned) contentLen));
+        out.writeInt (contentLen);
+        out.writeInt (contentLen);
+        out.writeShort ((short) nameLen);
+        out.writeShort (0);
+        out << name << content;
+
+        const int64 directoryStart = out.getPosition();
+
+        out.writeInt (0x02014b50);
+        out.writeShort (45);
+        out.writeShort (45);
+        out.writeShort (0);
+        out.writeShort (0);
+        out.writeInt (0);
+        out.writeInt (0);
+        out.writeInt (-1);
+        out.writeInt (-1);
+        out.writeShort ((short) nameLen);
+        out.writeShort (28);
+        out.writeShort (0);
+        out.writeShort (0);
+        out.writeShort (0);
+        out.writeInt (0);
+        out.writeInt (-1);
+        out << name;
+        out.writeShort (1);
+        out.writeShort (24);
+        out.writeInt64 (contentLen);
+        out.writeInt64 (contentLen);
+        out.writeInt64 (0);
+
+        const int64 directoryEnd = out.getPosition();
+
+        out.writeInt (0x06064b50);
+        out.writeInt64 (44);
+        out.writeShort (45);
+        out.writeShort (45);
+        out.writeInt (0);
+        out.writeInt (0);
+        out.writeInt64 (1);
+        out.writeInt64 (1);
+        out.writeInt64 (directoryEnd - directoryStart);
+        out.writeInt64 (directoryStart);
+
+        out.writeInt (0x07064b50);
+        out.writeInt (0);
+        out.writeInt64 (directoryEnd);
+        out.writeInt (1);
+
+        out.writeInt (0x06054b50);
+        out.writeShort (0);
+        out.writeShort (0);
+        out.writeShort (-1);
+        out.writeShort (-1);
+        out.writeInt (-1);
+        out.writeInt (-1);
+        out.writeShort (0);
+
+        return out.getMemoryBlock();
+    }
+};
+
+static ZipFileTests zipFileTests;
+
+#endif
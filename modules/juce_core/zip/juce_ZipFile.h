@@ -33,6 +33,9 @@
 #include "../streams/juce_InputSource.h"
 #include "../threads/juce_CriticalSection.h"
 #include "../containers/juce_OwnedArray.h"
+#include "../containers/juce_HashMap.h"
+#include "../files/juce_MemoryMappedFile.h"
+#include "../threads/juce_ThreadPool.h"
 
 
 //==============================================================================
@@ -45,8 +48,15 @@
 class JUCE_API  ZipFile
 {
 public:
-    /** Creates a ZipFile based for a file. */
-    explicit ZipFile (const File& file);
+    /** Creates a ZipFile based for a file.
+
+        If useMemoryMapping is true, the file will be mapped into memory rather than
+        read through a stream. This lets any number of entries be read at the same time
+        without contending for a shared stream, and means that the contents of entries
+        which were stored without compression can be accessed directly with
+        getMappedEntryData(). If the file can't be mapped, it'll be read normally.
+    */
+    explicit ZipFile (const File& file, bool useMemoryMapping = false);
 
     //==============================================================================
     /** Creates a ZipFile for a given stream.
@@ -85,7 +95,7 @@ public:
         String filename;
 
         /** The file's original size. */
-        unsigned int uncompressedSize;
+        int64 uncompressedSize;
 
         /** The last time the file was modified. */
         Time fileTime;
@@ -106,7 +116,8 @@ public:
     /** Returns the index of the first entry with a given filename.
 
         This uses a case-sensitive comparison to look for a filename in the
-        list of entries. It might return -1 if no match is found.
+        list of entries. It might return -1 if no match is found. The names are
+        indexed when the file is opened, so this doesn't need to search the list.
 
         @see ZipFile::ZipEntry
     */
@@ -146,6 +157,15 @@ public:
     */
     InputStream* createStreamForEntry (const ZipEntry& entry);
 
+    /** If the file was opened with memory-mapping enabled, and the given entry was
+        stored without compression, this returns a pointer to its contents in the mapped file.
+
+        The block's size is the entry's uncompressedSize, and it remains valid for as long
+        as this ZipFile object exists. In all other cases, this returns nullptr, and you'll
+        need to use createStreamForEntry() instead.
+    */
+    const void* getMappedEntryData (int index) const noexcept;
+
     //==============================================================================
     /** Uncompresses all of the files in the zip file.
 
@@ -154,10 +174,14 @@ public:
 
         @param targetDirectory      the root folder to uncompress to
         @param shouldOverwriteFiles whether to overwrite existing files with similarly-named ones
+        @param numThreads           the number of threads to use - if this is more than 1, the
+                                    entries will be decompressed in parallel, each thread reading
+                                    through its own stream where the source allows it
         @returns success if the file is successfully unzipped
     */
     Result uncompressTo (const File& targetDirectory,
-                         bool shouldOverwriteFiles = true);
+                         bool shouldOverwriteFiles = true,
+                         int numThreads = 1);
 
     /** Uncompresses one of the entries from the zip file.
 
@@ -204,8 +228,12 @@ public:
         /** Generates the zip file, writing it to the specified stream.
             If the progress parameter is non-null, it will be updated with an approximate
             progress status between 0 and 1.0
+
+            If a ThreadPool is supplied, the files will be compressed on its threads, several
+            at a time, and then written to the stream in the order they were added.
         */
-        bool writeToStream (OutputStream& target, double* progress) const;
+        bool writeToStream (OutputStream& target, double* progress,
+                            ThreadPool* threadPoolToUse = nullptr) const;
 
         //==============================================================================
     private:
@@ -220,14 +248,18 @@ private:
     //==============================================================================
     class ZipInputStream;
     class ZipEntryHolder;
+    class ExtractionThread;
     friend class ZipInputStream;
     friend class ZipEntryHolder;
+    friend class ExtractionThread;
 
     OwnedArray <ZipEntryHolder> entries;
     CriticalSection lock;
     InputStream* inputStream;
     ScopedPointer <InputStream> streamToDelete;
     ScopedPointer <InputSource> inputSource;
+    ScopedPointer <MemoryMappedFile> mappedFile;
+    HashMap <String, int> fileNameIndex;
 
    #if JUCE_DEBUG
     struct OpenStreamCounter
@@ -242,6 +274,11 @@ private:
    #endif
 
     void init();
+    void buildFileNameIndex();
+    const char* getMappedDataForEntry (const ZipEntryHolder&) const noexcept;
+    InputStream* createStreamForEntryInt (int index, InputStream* sourceStream);
+    Result uncompressEntryInt (int index, const File& targetDirectory,
+                               bool shouldOverwriteFiles, InputStream* sourceStream);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ZipFile)
 };
@@ -269,3 +269,419 @@ void BlowFish::decrypt (uint32& data1, uint32& data2) const noexcept
     data1 = r ^ p[0];
     data2 = l ^ p[1];
 }
+
+//==============================================================================
+// Each round of a block depends on the one before, so working on several independent
+// blocks side by side gives the CPU other S-box look-ups to do while it waits.
+template <int numBlocks>
+void BlowFish::encryptBlocks (uint32* const left, uint32* const right) const noexcept
+{
+    uint32 l [numBlocks], r [numBlocks];
+
+    for (int b = 0; b < numBlocks; ++b)
+    {
+        l[b] = left[b];
+        r[b] = right[b];
+    }
+
+    for (int i = 0; i < 16; i += 2)
+    {
+        for (int b = 0; b < numBlocks; ++b)   l[b] ^= p[i];
+        for (int b = 0; b < numBlocks; ++b)   r[b] ^= F (l[b]);
+        for (int b = 0; b < numBlocks; ++b)   r[b] ^= p[i + 1];
+        for (int b = 0; b < numBlocks; ++b)   l[b] ^= F (r[b]);
+    }
+
+    for (int b = 0; b < numBlocks; ++b)
+    {
+        left[b]  = r[b] ^ p[17];
+        right[b] = l[b] ^ p[16];
+    }
+}
+
+template <int numBlocks>
+void BlowFish::decryptBlocks (uint32* const left, uint32* const right) const noexcept
+{
+    uint32 l [numBlocks], r [numBlocks];
+
+    for (int b = 0; b < numBlocks; ++b)
+    {
+        l[b] = left[b];
+        r[b] = right[b];
+    }
+
+    for (int i = 17; i > 1; i -= 2)
+    {
+        for (int b = 0; b < numBlocks; ++b)   l[b] ^= p[i];
+        for (int b = 0; b < numBlocks; ++b)   r[b] ^= F (l[b]);
+        for (int b = 0; b < numBlocks; ++b)   r[b] ^= p[i - 1];
+        for (int b = 0; b < numBlocks; ++b)   l[b] ^= F (r[b]);
+    }
+
+    for (int b = 0; b < numBlocks; ++b)
+    {
+        left[b]  = r[b] ^ p[0];
+        right[b] = l[b] ^ p[1];
+    }
+}
+
+namespace BlowFishHelpers
+{
+    enum { numInterleavedBlocks = 4 };
+
+    static inline void loadBlocks (const uint8* const source, uint32* const left, uint32* const right, const int numBlocks) noexcept
+    {
+        for (int b = 0; b < numBlocks; ++b)
+        {
+            left[b]  = ByteOrder::bigEndianInt (source + b * BlowFish::blockSize);
+            right[b] = ByteOrder::bigEndianInt (source + b * BlowFish::blockSize + 4);
+        }
+    }
+
+    static inline void storeBlocks (uint8* const dest, const uint32* const left, const uint32* const right, const int numBlocks) noexcept
+    {
+        for (int b = 0; b < numBlocks; ++b)
+        {
+            const uint32 block[] = { ByteOrder::swapIfLittleEndian (left[b]),
+                                     ByteOrder::swapIfLittleEndian (right[b]) };
+
+            memcpy (dest + b * BlowFish::blockSize, block, sizeof (block));
+        }
+    }
+}
+
+void BlowFish::encryptECB (void* const data, size_t numBytes) const noexcept
+{
+    using namespace BlowFishHelpers;
+    jassert (numBytes % blockSize == 0);
+
+    uint8* d = static_cast <uint8*> (data);
+    uint32 l [numInterleavedBlocks], r [numInterleavedBlocks];
+
+    for (; numBytes >= numInterleavedBlocks * blockSize; numBytes -= numInterleavedBlocks * blockSize)
+    {
+        loadBlocks (d, l, r, numInterleavedBlocks);
+        encryptBlocks<numInterleavedBlocks> (l, r);
+        storeBlocks (d, l, r, numInterleavedBlocks);
+        d += numInterleavedBlocks * blockSize;
+    }
+
+    for (; numBytes >= blockSize; numBytes -= blockSize)
+    {
+        loadBlocks (d, l, r, 1);
+        encryptBlocks<1> (l, r);
+        storeBlocks (d, l, r, 1);
+        d += blockSize;
+    }
+}
+
+void BlowFish::decryptECB (void* const data, size_t numBytes) const noexcept
+{
+    using namespace BlowFishHelpers;
+    jassert (numBytes % blockSize == 0);
+
+    uint8* d = static_cast <uint8*> (data);
+    uint32 l [numInterleavedBlocks], r [numInterleavedBlocks];
+
+    for (; numBytes >= numInterleavedBlocks * blockSize; numBytes -= numInterleavedBlocks * blockSize)
+    {
+        loadBlocks (d, l, r, numInterleavedBlocks);
+        decryptBlocks<numInterleavedBlocks> (l, r);
+        storeBlocks (d, l, r, numInterleavedBlocks);
+        d += numInterleavedBlocks * blockSize;
+    }
+
+    for (; numBytes >= blockSize; numBytes -= blockSize)
+    {
+        loadBlocks (d, l, r, 1);
+        decryptBlocks<1> (l, r);
+        storeBlocks (d, l, r, 1);
+        d += blockSize;
+    }
+}
+
+void BlowFish::encryptCBC (void* const data, size_t numBytes, void* const initialisationVector) const noexcept
+{
+    using namespace BlowFishHelpers;
+    jassert (numBytes % blockSize == 0);
+
+    // (each block depends on the previous one's ciphertext, so this can't be interleaved)
+    uint8* d = static_cast <uint8*> (data);
+    uint32 chainL, chainR;
+    loadBlocks (static_cast <const uint8*> (initialisationVector), &chainL, &chainR, 1);
+
+    for (; numBytes >= blockSize; numBytes -= blockSize)
+    {
+        uint32 l, r;
+        loadBlocks (d, &l, &r, 1);
+        chainL ^= l;
+        chainR ^= r;
+        encryptBlocks<1> (&chainL, &chainR);
+        storeBlocks (d, &chainL, &chainR, 1);
+        d += blockSize;
+    }
+
+    storeBlocks (static_cast <uint8*> (initialisationVector), &chainL, &chainR, 1);
+}
+
+void BlowFish::decryptCBC (void* const data, size_t numBytes, void* const initialisationVector) const noexcept
+{
+    using namespace BlowFishHelpers;
+    jassert (numBytes % blockSize == 0);
+
+    uint8* d = static_cast <uint8*> (data);
+    uint32 chainL [numInterleavedBlocks + 1], chainR [numInterleavedBlocks + 1];
+    uint32 l [numInterleavedBlocks], r [numInterleavedBlocks];
+    loadBlocks (static_cast <const uint8*> (initialisationVector), chainL, chainR, 1);
+
+    while (numBytes >= blockSize)
+    {
+        const int numBlocks = numBytes >= numInterleavedBlocks * blockSize ? (int) numInterleavedBlocks : 1;
+
+        loadBlocks (d, l, r, numBlocks);
+        loadBlocks (d, chainL + 1, chainR + 1, numBlocks);
+
+        if (numBlocks == numInterleavedBlocks)
+            decryptBlocks<numInterleavedBlocks> (l, r);
+        else
+            decryptBlocks<1> (l, r);
+
+        for (int b = 0; b < numBlocks; ++b)
+        {
+            l[b] ^= chainL[b];
+            r[b] ^= chainR[b];
+        }
+
+        storeBlocks (d, l, r, numBlocks);
+
+        chainL[0] = chainL[numBlocks];
+        chainR[0] = chainR[numBlocks];
+        d += numBlocks * blockSize;
+        numBytes -= (size_t) numBlocks * blockSize;
+    }
+
+    storeBlocks (static_cast <uint8*> (initialisationVector), chainL, chainR, 1);
+}
+
+void BlowFish::applyCTR (void* const data, size_t numBytes, const void* const initialCounter,
+                         const uint64 streamPosition) const noexcept
+{
+    using namespace BlowFishHelpers;
+
+    uint8* d = static_cast <uint8*> (data);
+    uint32 counterL, counterR;
+    loadBlocks (static_cast <const uint8*> (initialCounter), &counterL, &counterR, 1);
+
+    uint64 counter = ((((uint64) counterL) << 32) | counterR) + streamPosition / blockSize;
+    size_t offsetInBlock = (size_t) (streamPosition % blockSize);
+    uint32 l [numInterleavedBlocks], r [numInterleavedBlocks];
+
+    while (numBytes > 0)
+    {
+        if (offsetInBlock == 0 && numBytes >= numInterleavedBlocks * blockSize)
+        {
+            for (int b = 0; b < numInterleavedBlocks; ++b)
+            {
+                l[b] = (uint32) ((counter + (uint64) b) >> 32);
+                r[b] = (uint32) (counter + (uint64) b);
+            }
+
+            encryptBlocks<numInterleavedBlocks> (l, r);
+
+            uint32 dataL [numInterleavedBlocks], dataR [numInterleavedBlocks];
+            loadBlocks (d, dataL, dataR, numInterleavedBlocks);
+
+            for (int b = 0; b < numInterleavedBlocks; ++b)
+            {
+                dataL[b] ^= l[b];
+                dataR[b] ^= r[b];
+            }
+
+            storeBlocks (d, dataL, dataR, numInterleavedBlocks);
+
+            counter += numInterleavedBlocks;
+            d += numInterleavedBlocks * blockSize;
+            numBytes -= numInterleavedBlocks * blockSize;
+        }
+        else
+        {
+            // a partial block at the start or end of the data
+            l[0] = (uint32) (counter >> 32);
+            r[0] = (uint32) counter;
+            encryptBlocks<1> (l, r);
+
+            uint8 keyStream [blockSize];
+            storeBlocks (keyStream, l, r, 1);
+
+            const size_t num = jmin (numBytes, (size_t) blockSize - offsetInBlock);
+
+            for (size_t i = 0; i < num; ++i)
+                d[i] ^= keyStream [offsetInBlock + i];
+
+            ++counter;
+            offsetInBlock = 0;
+            d += num;
+            numBytes -= num;
+        }
+    }
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class BlowFishTests  : public UnitTest
+{
+public:
+    BlowFishTests() : UnitTest ("BlowFish") {}
+
+    static MemoryBlock fromHex (const char* hex)
+    {
+        MemoryBlock m;
+        m.loadFromHexString (hex);
+        return m;
+    }
+
+    static String toHex (const MemoryBlock& m)
+    {
+        return String::toHexString (m.getData(), (int) m.getSize(), 0);
+    }
+
+    void expectECB (const char* key, const char* plainText, const char* cipherText)
+    {
+        const MemoryBlock k (fromHex (key));
+        const BlowFish bf (k.getData(), (int) k.getSize());
+
+        MemoryBlock data (fromHex (plainText));
+        bf.encryptECB (data.getData(), data.getSize());
+        expectEquals (toHex (data), String (cipherText));
+
+        bf.decryptECB (data.getData(), data.getSize());
+        expectEquals (toHex (data), String (plainText));
+    }
+
+    void runTest()
+    {
+        beginTest ("ECB");
+
+        expectECB ("0000000000000000", "0000000000000000", "4ef997456198dd78");
+        expectECB ("ffffffffffffffff", "ffffffffffffffff", "51866fd5b85ecb8a");
+        expectECB ("3000000000000000", "1000000000000001", "7d856f9a613063f2");
+
+        {
+            // the same block in several positions, so that the interleaved and single paths both get used
+            expectECB ("0123456789abcdef", "00000000000000000000000000000000000000000000000000000000000000000000000000000000",
+                       "245946885754369a245946885754369a245946885754369a245946885754369a245946885754369a");
+        }
+
+        const MemoryBlock key (fromHex ("0123456789abcdeff0e1d2c3b4a59687"));
+        const BlowFish bf (key.getData(), (int) key.getSize());
+
+        beginTest ("CBC");
+
+        {
+            MemoryBlock data ("7654321 Now is the time for \0\0\0\0", 32);
+            MemoryBlock iv (fromHex ("fedcba9876543210"));
+            bf.encryptCBC (data.getData(), data.getSize(), iv.getData());
+
+            expectEquals (toHex (data), String ("6b77b4d63006dee605b156e27403979358deb9e7154616d959f1652bd5ff92cc"));
+            expectEquals (toHex (iv), String ("59f1652bd5ff92cc"));
+
+            iv = fromHex ("fedcba9876543210");
+            bf.decryptCBC (data.getData(), 8, iv.getData());
+            bf.decryptCBC (static_cast <char*> (data.getData()) + 8, 24, iv.getData());
+            expect (data == MemoryBlock ("7654321 Now is the time for \0\0\0\0", 32));
+        }
+
+        Random r (0x4321);
+        MemoryBlock original (1000);
+        for (size_t i = 0; i < original.getSize(); ++i)
+            original[i] = (char) r.nextInt (256);
+
+        for (int i = 0; i < 20; ++i)
+        {
+            const size_t size = (size_t) r.nextInt (120) * BlowFish::blockSize;
+            MemoryBlock data (original.getData(), size);
+            MemoryBlock iv (fromHex ("0011223344556677"));
+
+            bf.encryptCBC (data.getData(), size, iv.getData());
+            iv = fromHex ("0011223344556677");
+            bf.decryptCBC (data.getData(), size, iv.getData());
+
+            expect (memcmp (data.getData(), original.getData(), size) == 0);
+        }
+
+        beginTest ("CTR");
+
+        {
+            const MemoryBlock counter (fromHex ("00000000fffffffe"));
+
+            // the key-stream should be the ECB encryption of the successive counter values
+            MemoryBlock keyStream (fromHex ("00000000fffffffe00000000ffffffff00000001000000000000000100000001"
+                                            "000000010000000200000001000000030000000100000004"));
+            bf.encryptECB (keyStream.getData(), keyStream.getSize());
+
+            MemoryBlock data (keyStream.getSize(), true);
+            bf.applyCTR (data.getData(), data.getSize(), counter.getData());
+            expect (data == keyStream);
+
+            // processing in uneven sections from different positions gives the same result
+            MemoryBlock sections (keyStream.getSize(), true);
+
+            for (size_t pos = 0; pos < sections.getSize();)
+            {
+                const size_t num = jmin (sections.getSize() - pos, (size_t) r.nextInt (20));
+                bf.applyCTR (static_cast <char*> (sections.getData()) + pos, num, counter.getData(), pos);
+                pos += num;
+            }
+
+            expect (sections == keyStream);
+
+            bf.applyCTR (data.getData(), data.getSize(), counter.getData());
+            expect (data == MemoryBlock (keyStream.getSize(), true));
+        }
+
+        beginTest ("Streams");
+
+        {
+            const MemoryBlock counter (fromHex ("a1b2c3d4e5f60718"));
+            MemoryBlock expected (original);
+            bf.applyCTR (expected.getData(), expected.getSize(), counter.getData());
+
+            MemoryOutputStream encrypted;
+
+            {
+                BlowFishOutputStream out (&encrypted, bf, counter.getData());
+
+                for (size_t pos = 0; pos < original.getSize();)
+                {
+                    const size_t num = jmin (original.getSize() - pos, (size_t) r.nextInt (100));
+                    expect (out.write (static_cast <const char*> (original.getData()) + pos, num));
+                    pos += num;
+                }
+
+                expectEquals (out.getPosition(), (int64) original.getSize());
+            }
+
+            expect (encrypted.getMemoryBlock() == expected);
+
+            BlowFishInputStream in (new MemoryInputStream (encrypted.getData(), encrypted.getDataSize(), false),
+                                    bf, counter.getData(), true);
+
+            expectEquals (in.getTotalLength(), (int64) original.getSize());
+
+            MemoryBlock decrypted;
+            in.readIntoMemoryBlock (decrypted);
+            expect (decrypted == original);
+            expect (in.isExhausted());
+
+            expect (in.setPosition (123));
+            char section [50];
+            expectEquals (in.read (section, sizeof (section)), (int) sizeof (section));
+            expect (memcmp (section, static_cast <const char*> (original.getData()) + 123, sizeof (section)) == 0);
+        }
+    }
+};
+
+static BlowFishTests blowFishTests;
+
+#endif
@@ -30,6 +30,11 @@
 /**
     BlowFish encryption class.
 
+    As well as encrypting single blocks, this can process whole buffers in ECB, CBC
+    or CTR mode. The buffer methods store blocks as big-endian pairs of 32-bit
+    integers, which is the standard byte order, so their output matches other
+    BlowFish implementations. To encrypt or decrypt data as it's streamed, see
+    BlowFishOutputStream and BlowFishInputStream.
 */
 class JUCE_API  BlowFish
 {
@@ -57,6 +62,54 @@ public:
     /** Decrypts a pair of 32-bit integers. */
     void decrypt (uint32& data1, uint32& data2) const noexcept;
 
+    //==============================================================================
+    /** The number of bytes in each block that BlowFish encrypts. */
+    enum { blockSize = 8 };
+
+    /** Encrypts a buffer in-place in ECB mode, where each block is encrypted on its own.
+        The number of bytes must be a multiple of blockSize.
+    */
+    void encryptECB (void* data, size_t numBytes) const noexcept;
+
+    /** Decrypts a buffer in-place in ECB mode.
+        The number of bytes must be a multiple of blockSize.
+    */
+    void decryptECB (void* data, size_t numBytes) const noexcept;
+
+    /** Encrypts a buffer in-place in CBC mode.
+
+        The number of bytes must be a multiple of blockSize. The initialisationVector is
+        a block of blockSize bytes. When this returns, it contains the last block of
+        ciphertext, so you can encrypt a long message by making several calls with the
+        same vector.
+    */
+    void encryptCBC (void* data, size_t numBytes, void* initialisationVector) const noexcept;
+
+    /** Decrypts a buffer in-place in CBC mode.
+
+        The number of bytes must be a multiple of blockSize. As with encryptCBC(), the
+        initialisationVector is updated so that a message can be decrypted in sections.
+    */
+    void decryptCBC (void* data, size_t numBytes, void* initialisationVector) const noexcept;
+
+    /** Encrypts or decrypts a buffer in-place in CTR mode.
+
+        In CTR mode the data is XORed with a key-stream made by encrypting successive
+        values of a 64-bit big-endian counter, so encryption and decryption are the same
+        operation, and the data can be any length.
+
+        @param data             the data to process
+        @param numBytes         the number of bytes of data
+        @param initialCounter   a block of blockSize bytes holding the counter's starting
+                                value. You should never use the same key and counter for
+                                two different messages.
+        @param streamPosition   the position of the first byte of data within the whole
+                                message. This lets you process a message in sections, or
+                                start part-way through one.
+    */
+    void applyCTR (void* data, size_t numBytes, const void* initialCounter,
+                   uint64 streamPosition = 0) const noexcept;
+
 
 private:
     //==============================================================================
@@ -65,6 +118,9 @@ private:
 
     uint32 F (uint32) const noexcept;
 
+    template <int numBlocks> void encryptBlocks (uint32* left, uint32* right) const noexcept;
+    template <int numBlocks> void decryptBlocks (uint32* left, uint32* right) const noexcept;
+
     JUCE_LEAK_DETECTOR (BlowFish)
 };
 
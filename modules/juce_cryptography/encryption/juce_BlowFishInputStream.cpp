@@ -0,0 +1,82 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+BlowFishInputStream::BlowFishInputStream (InputStream* const sourceStream,
+                                          const BlowFish& cipher_,
+                                          const void* const initialCounter,
+                                          const bool deleteSourceWhenDestroyed)
+  : source (sourceStream, deleteSourceWhenDestroyed),
+    cipher (cipher_),
+    startPositionInSource (sourceStream->getPosition()),
+    position (0)
+{
+    memcpy (counter, initialCounter, sizeof (counter));
+}
+
+BlowFishInputStream::~BlowFishInputStream()
+{
+}
+
+int64 BlowFishInputStream::getTotalLength()
+{
+    const int64 sourceLength = source->getTotalLength();
+
+    return sourceLength >= 0 ? sourceLength - startPositionInSource : -1;
+}
+
+int64 BlowFishInputStream::getPosition()
+{
+    return position;
+}
+
+bool BlowFishInputStream::setPosition (int64 newPosition)
+{
+    newPosition = jmax ((int64) 0, newPosition);
+
+    if (! source->setPosition (startPositionInSource + newPosition))
+        return false;
+
+    position = newPosition;
+    return true;
+}
+
+int BlowFishInputStream::read (void* destBuffer, int maxBytesToRead)
+{
+    jassert (destBuffer != nullptr && maxBytesToRead >= 0);
+
+    const int numRead = source->read (destBuffer, maxBytesToRead);
+
+    if (numRead > 0)
+    {
+        cipher.applyCTR (destBuffer, (size_t) numRead, counter, (uint64) position);
+        position += numRead;
+    }
+
+    return numRead;
+}
+
+bool BlowFishInputStream::isExhausted()
+{
+    return source->isExhausted();
+}
@@ -0,0 +1,84 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_BLOWFISHINPUTSTREAM_JUCEHEADER__
+#define __JUCE_BLOWFISHINPUTSTREAM_JUCEHEADER__
+
+#include "juce_BlowFish.h"
+
+
+//==============================================================================
+/**
+    An input stream that decrypts data from another stream as it's read, using
+    BlowFish in CTR mode.
+
+    The data is decrypted in place in the buffer that you read into, so no extra
+    copies are made. CTR mode allows random access, so this stream can be
+    repositioned if its source stream can be.
+
+    @see BlowFishOutputStream, BlowFish::applyCTR
+*/
+class JUCE_API  BlowFishInputStream  : public InputStream
+{
+public:
+    //==============================================================================
+    /** Creates a decrypting stream.
+
+        @param sourceStream                 the stream to read the encrypted data from. Its
+                                            current position is treated as the start of
+                                            the encrypted data.
+        @param cipher                       the key to use. The stream keeps its own copy
+                                            of this.
+        @param initialCounter               a block of BlowFish::blockSize bytes holding the
+                                            counter value that the data was encrypted with
+        @param deleteSourceWhenDestroyed    whether or not to delete the source stream when
+                                            this object is destroyed
+    */
+    BlowFishInputStream (InputStream* sourceStream,
+                         const BlowFish& cipher,
+                         const void* initialCounter,
+                         bool deleteSourceWhenDestroyed = false);
+
+    /** Destructor. */
+    ~BlowFishInputStream();
+
+    //==============================================================================
+    int64 getTotalLength();
+    int64 getPosition();
+    bool setPosition (int64 newPosition);
+    int read (void* destBuffer, int maxBytesToRead);
+    bool isExhausted();
+
+private:
+    //==============================================================================
+    OptionalScopedPointer<InputStream> source;
+    const BlowFish cipher;
+    uint8 counter [BlowFish::blockSize];
+    const int64 startPositionInSource;
+    int64 position;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (BlowFishInputStream)
+};
+
+#endif   // __JUCE_BLOWFISHINPUTSTREAM_JUCEHEADER__
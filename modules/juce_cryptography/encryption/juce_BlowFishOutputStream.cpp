@@ -0,0 +1,90 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+BlowFishOutputStream::BlowFishOutputStream (OutputStream* const destStream_,
+                                            const BlowFish& cipher_,
+                                            const void* const initialCounter,
+                                            const bool deleteDestStreamWhenDestroyed)
+  : destStream (destStream_, deleteDestStreamWhenDestroyed),
+    cipher (cipher_),
+    startPositionInDest (destStream_->getPosition()),
+    position (0)
+{
+    memcpy (counter, initialCounter, sizeof (counter));
+}
+
+BlowFishOutputStream::~BlowFishOutputStream()
+{
+}
+
+void BlowFishOutputStream::flush()
+{
+    destStream->flush();
+}
+
+int64 BlowFishOutputStream::getPosition()
+{
+    return position;
+}
+
+bool BlowFishOutputStream::setPosition (int64 newPosition)
+{
+    newPosition = jmax ((int64) 0, newPosition);
+
+    if (! destStream->setPosition (startPositionInDest + newPosition))
+        return false;
+
+    position = newPosition;
+    return true;
+}
+
+bool BlowFishOutputStream::write (const void* const dataToWrite, size_t numberOfBytes)
+{
+    jassert (dataToWrite != nullptr);
+
+    // the caller's data can't be changed, so it's encrypted in chunks in a working buffer
+    const size_t bufferSize = 16384;
+
+    if (buffer == nullptr)
+        buffer.malloc (bufferSize);
+
+    const uint8* source = static_cast <const uint8*> (dataToWrite);
+
+    while (numberOfBytes > 0)
+    {
+        const size_t numThisTime = jmin (numberOfBytes, bufferSize);
+
+        memcpy (buffer, source, numThisTime);
+        cipher.applyCTR (buffer, numThisTime, counter, (uint64) position);
+
+        if (! destStream->write (buffer, numThisTime))
+            return false;
+
+        position += (int64) numThisTime;
+        source += numThisTime;
+        numberOfBytes -= numThisTime;
+    }
+
+    return true;
+}
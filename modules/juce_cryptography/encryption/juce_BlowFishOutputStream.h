@@ -0,0 +1,85 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_BLOWFISHOUTPUTSTREAM_JUCEHEADER__
+#define __JUCE_BLOWFISHOUTPUTSTREAM_JUCEHEADER__
+
+#include "juce_BlowFish.h"
+
+
+//==============================================================================
+/**
+    An output stream that encrypts the data written to it with BlowFish in CTR
+    mode, and passes it on to another stream.
+
+    CTR mode doesn't need any padding, so the encrypted data is the same length as
+    the original. It can be decrypted with a BlowFishInputStream, or with
+    BlowFish::applyCTR(), using the same key and initial counter.
+
+    @see BlowFishInputStream, BlowFish::applyCTR
+*/
+class JUCE_API  BlowFishOutputStream  : public OutputStream
+{
+public:
+    //==============================================================================
+    /** Creates an encrypting stream.
+
+        @param destStream                       the stream that the encrypted data should be
+                                                written to. Its current position is treated as
+                                                the start of the encrypted data.
+        @param cipher                           the key to use. The stream keeps its own copy
+                                                of this.
+        @param initialCounter                   a block of BlowFish::blockSize bytes holding the
+                                                counter's starting value. Never use the same key
+                                                and counter for two different sets of data.
+        @param deleteDestStreamWhenDestroyed    whether or not to delete the destStream object
+                                                when this stream is destroyed
+    */
+    BlowFishOutputStream (OutputStream* destStream,
+                          const BlowFish& cipher,
+                          const void* initialCounter,
+                          bool deleteDestStreamWhenDestroyed = false);
+
+    /** Destructor. */
+    ~BlowFishOutputStream();
+
+    //==============================================================================
+    void flush();
+    int64 getPosition();
+    bool setPosition (int64 newPosition);
+    bool write (const void* dataToWrite, size_t numberOfBytes);
+
+private:
+    //==============================================================================
+    OptionalScopedPointer<OutputStream> destStream;
+    const BlowFish cipher;
+    uint8 counter [BlowFish::blockSize];
+    const int64 startPositionInDest;
+    int64 position;
+    HeapBlock<uint8> buffer;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (BlowFishOutputStream)
+};
+
+#endif   // __JUCE_BLOWFISHOUTPUTSTREAM_JUCEHEADER__
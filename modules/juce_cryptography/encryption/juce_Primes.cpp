@@ -80,17 +80,71 @@ namespace PrimesHelpers
         while (index < smallSieveSize);
     }
 
+    struct CandidateTester
+    {
+        CandidateTester (const BigInteger& base_, const Array<int>& candidates_,
+                         char* const results_, const int certainty_)
+            : base (base_), candidates (candidates_), results (results_), certainty (certainty_)
+        {
+        }
+
+        void operator() (const int index) const
+        {
+            results [index] = Primes::isProbablyPrime (base + (unsigned int) ((candidates.getUnchecked (index) << 1) + 1),
+                                                       certainty) ? 1 : 0;
+        }
+
+        const BigInteger& base;
+        const Array<int>& candidates;
+        char* const results;
+        const int certainty;
+    };
+
     static bool findCandidate (const BigInteger& base, const BigInteger& sieve,
-                               const int numBits, BigInteger& result, const int certainty)
+                               const int numBits, BigInteger& result, const int certainty,
+                               ThreadPool* const pool)
     {
+        if (pool == nullptr)
+        {
+            for (int i = 0; i < numBits; ++i)
+            {
+                if (! sieve[i])
+                {
+                    result = base + (unsigned int) ((i << 1) + 1);
+
+                    if (Primes::isProbablyPrime (result, certainty))
+                        return true;
+                }
+            }
+
+            return false;
+        }
+
+        // Test the candidates in batches, one per thread, and take the lowest one in each batch
+        // that passes, so that the result is the same as the single-threaded search would give.
+        Array<int> batch;
+        const int batchSize = jmax (2, SystemStats::getNumCpus());
+        HeapBlock<char> results ((size_t) batchSize);
+
         for (int i = 0; i < numBits; ++i)
         {
             if (! sieve[i])
+                batch.add (i);
+
+            if (batch.size() == batchSize || (i == numBits - 1 && batch.size() > 0))
             {
-                result = base + (unsigned int) ((i << 1) + 1);
+                pool->parallelFor (0, batch.size(), CandidateTester (base, batch, results, certainty), 1);
+
+                for (int j = 0; j < batch.size(); ++j)
+                {
+                    if (results[j] != 0)
+                    {
+                        result = base + (unsigned int) ((batch.getUnchecked (j) << 1) + 1);
+                        return true;
+                    }
+                }
 
-                if (Primes::isProbablyPrime (result, certainty))
-                    return true;
+                batch.clearQuick();
             }
         }
 
@@ -99,7 +153,7 @@ namespace PrimesHelpers
 
     static bool passesMillerRabin (const BigInteger& n, int iterations)
     {
-        const BigInteger one (1), two (2);
+        const BigInteger one (1);
         const BigInteger nMinusOne (n - one);
 
         BigInteger d (nMinusOne);
@@ -133,7 +187,8 @@ namespace PrimesHelpers
             {
                 for (int j = 0; j < s; ++j)
                 {
-                    r.exponentModulo (two, n);
+                    r *= r;
+                    r %= n;
 
                     if (r == nMinusOne)
                         break;
@@ -193,6 +248,12 @@ BigInteger Primes::createProbablePrime (const int bitLength,
 
     const int searchLen = jmax (1024, (bitLength / 20) * 64);
 
+    // For big primes, each Miller-Rabin test is slow enough to be worth spreading across the CPUs.
+    ScopedPointer<ThreadPool> pool;
+
+    if (bitLength >= 256 && SystemStats::getNumCpus() > 1)
+        pool = new ThreadPool();
+
     while (p.getHighestBit() < bitLength)
     {
         p += 2 * searchLen;
@@ -203,7 +264,7 @@ BigInteger Primes::createProbablePrime (const int bitLength,
 
         BigInteger candidate;
 
-        if (findCandidate (p, sieve, searchLen, candidate, certainty))
+        if (findCandidate (p, sieve, searchLen, candidate, certainty, pool))
             return candidate;
     }
 
@@ -46,6 +46,9 @@ public:
         The randomSeeds parameter lets you optionally pass it a set of values with
         which to seed the random number generation, improving the security of the
         keys generated.
+
+        For large bit-lengths, the candidates are tested on several threads at once.
+        The result is the same as it would be if they were tested one at a time.
     */
     static BigInteger createProbablePrime (int bitLength,
                                            int certainty,
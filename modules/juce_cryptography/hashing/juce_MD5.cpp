@@ -26,6 +26,11 @@ class MD5Generator
 {
 public:
     MD5Generator() noexcept
+    {
+        reset();
+    }
+
+    void reset() noexcept
     {
         state[0] = 0x67452301;
         state[1] = 0xefcdab89;
@@ -144,6 +149,25 @@ public:
         zerostruct (buffer);
     }
 
+    void processStream (InputStream& input, int64 numBytesToRead)
+    {
+        if (numBytesToRead < 0)
+            numBytesToRead = std::numeric_limits<int64>::max();
+
+        HeapBlock<uint8> tempBuffer (16384);
+
+        while (numBytesToRead > 0)
+        {
+            const int bytesRead = input.read (tempBuffer, (int) jmin (numBytesToRead, (int64) 16384));
+
+            if (bytesRead <= 0)
+                break;
+
+            numBytesToRead -= bytesRead;
+            processBlock (tempBuffer, (size_t) bytesRead);
+        }
+    }
+
 private:
     uint8 buffer [64];
     uint32 state [4];
@@ -264,22 +288,7 @@ void MD5::processData (const void* data, size_t numBytes) noexcept
 void MD5::processStream (InputStream& input, int64 numBytesToRead)
 {
     MD5Generator generator;
-
-    if (numBytesToRead < 0)
-        numBytesToRead = std::numeric_limits<int64>::max();
-
-    while (numBytesToRead > 0)
-    {
-        uint8 tempBuffer [512];
-        const int bytesRead = input.read (tempBuffer, (int) jmin (numBytesToRead, (int64) sizeof (tempBuffer)));
-
-        if (bytesRead <= 0)
-            break;
-
-        numBytesToRead -= bytesRead;
-        generator.processBlock (tempBuffer, (size_t) bytesRead);
-    }
-
+    generator.processStream (input, numBytesToRead);
     generator.finish (result);
 }
 
@@ -297,3 +306,35 @@ String MD5::toHexString() const
 //==============================================================================
 bool MD5::operator== (const MD5& other) const noexcept   { return memcmp (result, other.result, sizeof (result)) == 0; }
 bool MD5::operator!= (const MD5& other) const noexcept   { return ! operator== (other); }
+
+//==============================================================================
+class MD5::Generator::Pimpl  : public MD5Generator
+{
+};
+
+MD5::Generator::Generator()  : pimpl (new Pimpl()) {}
+MD5::Generator::~Generator() {}
+
+void MD5::Generator::update (const void* const data, const size_t numBytes)
+{
+    jassert (data != nullptr || numBytes == 0);
+    pimpl->processBlock (data, numBytes);
+}
+
+void MD5::Generator::update (InputStream& input, const int64 numBytesToRead)
+{
+    pimpl->processStream (input, numBytesToRead);
+}
+
+MD5 MD5::Generator::finalise()
+{
+    MD5 m;
+    pimpl->finish (m.result);
+    pimpl->reset();
+    return m;
+}
+
+void MD5::Generator::reset()
+{
+    pimpl->reset();
+}
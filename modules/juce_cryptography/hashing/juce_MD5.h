@@ -99,6 +99,47 @@ public:
     bool operator== (const MD5&) const noexcept;
     bool operator!= (const MD5&) const noexcept;
 
+    //==============================================================================
+    /**
+        Calculates an MD5 checksum incrementally.
+
+        Use this when the data isn't all available at once: call update() as many times
+        as you need to, and then finalise() to get the checksum of everything that was added.
+    */
+    class JUCE_API  Generator
+    {
+    public:
+        /** Creates a generator, ready to be given some data. */
+        Generator();
+
+        /** Destructor. */
+        ~Generator();
+
+        /** Adds a block of data to the checksum. */
+        void update (const void* data, size_t numBytes);
+
+        /** Reads data from a stream and adds it to the checksum.
+            This will read until the stream is exhausted, or until maxBytesToRead
+            bytes have been read. If maxBytesToRead is negative, the entire stream will be read.
+        */
+        void update (InputStream& input, int64 maxBytesToRead = -1);
+
+        /** Returns the checksum of all the data that has been added.
+            After this has been called, the generator is reset so that it can be re-used.
+        */
+        MD5 finalise();
+
+        /** Discards any data that has been added. */
+        void reset();
+
+    private:
+        class Pimpl;
+        friend class ScopedPointer<Pimpl>;
+        ScopedPointer<Pimpl> pimpl;
+
+        JUCE_DECLARE_NON_COPYABLE (Generator)
+    };
+
 
 private:
     //==============================================================================
@@ -22,11 +22,198 @@
   ==============================================================================
 */
 
+namespace SHA256Helpers
+{
+    static const uint32 roundConstants[] =
+    {
+        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+        0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+        0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+        0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+        0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+        0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+        0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+    };
+
+    static inline uint32 rotate (const uint32 x, const uint32 y) noexcept                { return (x >> y) | (x << (32 - y)); }
+    static inline uint32 ch  (const uint32 x, const uint32 y, const uint32 z) noexcept   { return z ^ ((y ^ z) & x); }
+    static inline uint32 maj (const uint32 x, const uint32 y, const uint32 z) noexcept   { return y ^ ((y ^ z) & (x ^ y)); }
+
+    static inline uint32 s0 (const uint32 x) noexcept     { return rotate (x, 7)  ^ rotate (x, 18) ^ (x >> 3); }
+    static inline uint32 s1 (const uint32 x) noexcept     { return rotate (x, 17) ^ rotate (x, 19) ^ (x >> 10); }
+    static inline uint32 S0 (const uint32 x) noexcept     { return rotate (x, 2)  ^ rotate (x, 13) ^ rotate (x, 22); }
+    static inline uint32 S1 (const uint32 x) noexcept     { return rotate (x, 6)  ^ rotate (x, 11) ^ rotate (x, 25); }
+
+    // processes a sequence of 64-byte blocks
+    static void processBlocksPortable (uint32* const state, const uint8* data, size_t numBlocks) noexcept
+    {
+        for (; numBlocks > 0; --numBlocks, data += 64)
+        {
+            uint32 block[16], s[8];
+            memcpy (s, state, sizeof (s));
+
+            for (int i = 0; i < 16; ++i)
+                block[i] = ByteOrder::bigEndianInt (data + i * 4);
+
+            for (uint32 j = 0; j < 64; j += 16)
+            {
+                #define JUCE_SHA256(i) \
+                    s[(7 - i) & 7] += S1 (s[(4 - i) & 7]) + ch (s[(4 - i) & 7], s[(5 - i) & 7], s[(6 - i) & 7]) + roundConstants[i + j] \
+                                         + (j != 0 ? (block[i & 15] += s1 (block[(i - 2) & 15]) + block[(i - 7) & 15] + s0 (block[(i - 15) & 15])) \
+                                                   : block[i]); \
+                    s[(3 - i) & 7] += s[(7 - i) & 7]; \
+                    s[(7 - i) & 7] += S0 (s[(0 - i) & 7]) + maj (s[(0 - i) & 7], s[(1 - i) & 7], s[(2 - i) & 7])
+
+                JUCE_SHA256(0);  JUCE_SHA256(1);  JUCE_SHA256(2);  JUCE_SHA256(3);  JUCE_SHA256(4);  JUCE_SHA256(5);  JUCE_SHA256(6);  JUCE_SHA256(7);
+                JUCE_SHA256(8);  JUCE_SHA256(9);  JUCE_SHA256(10); JUCE_SHA256(11); JUCE_SHA256(12); JUCE_SHA256(13); JUCE_SHA256(14); JUCE_SHA256(15);
+                #undef JUCE_SHA256
+            }
+
+            for (int i = 0; i < 8; ++i)
+                state[i] += s[i];
+        }
+    }
+
+   #if JUCE_USE_INTEL_SHA_INSTRUCTIONS
+    static bool checkForIntelSHAInstructions() noexcept
+    {
+       #if JUCE_MSVC
+        int info[4];
+        __cpuid (info, 0);
+
+        if (info[0] < 7)
+            return false;
+
+        __cpuid (info, 1);
+        const bool hasSSE41 = (info[2] & (1 << 19)) != 0;
+        __cpuidex (info, 7, 0);
+        return hasSSE41 && (info[1] & (1 << 29)) != 0;
+       #else
+        unsigned int a = 0, b = 0, c = 0, d = 0;
+
+        if (__get_cpuid_max (0, nullptr) < 7)
+            return false;
+
+        __cpuid (1, a, b, c, d);
+        const bool hasSSE41 = (c & (1u << 19)) != 0;
+        __cpuid_count (7, 0, a, b, c, d);
+        return hasSSE41 && (b & (1u << 29)) != 0;
+       #endif
+    }
+
+    static bool canUseIntelSHAInstructions() noexcept
+    {
+        static const bool canUse = checkForIntelSHAInstructions();
+        return canUse;
+    }
+
+   #if JUCE_GCC
+    __attribute__ ((target ("sha,ssse3,sse4.1")))
+   #endif
+    static void processBlocksIntel (uint32* const state, const uint8* data, size_t numBlocks) noexcept
+    {
+        const __m128i byteSwapMask = _mm_set_epi64x (literal64bit (0x0c0d0e0f08090a0b), literal64bit (0x0405060700010203));
+
+        // The SHA instructions want the state arranged as ABEF and CDGH..
+        __m128i cdab   = _mm_shuffle_epi32 (_mm_loadu_si128 ((const __m128i*) state), 0xb1);
+        __m128i state1 = _mm_shuffle_epi32 (_mm_loadu_si128 ((const __m128i*) (state + 4)), 0x1b);
+        __m128i state0 = _mm_alignr_epi8 (cdab, state1, 8);
+        state1 = _mm_blend_epi16 (state1, cdab, 0xf0);
+
+        for (; numBlocks > 0; --numBlocks, data += 64)
+        {
+            const __m128i savedState0 = state0, savedState1 = state1;
+            __m128i w[4];
+
+            for (int i = 0; i < 16; ++i)
+            {
+                __m128i& msg = w[i & 3];
+
+                if (i < 4)
+                    msg = _mm_shuffle_epi8 (_mm_loadu_si128 ((const __m128i*) (data + i * 16)), byteSwapMask);
+                else
+                    msg = _mm_sha256msg2_epu32 (_mm_add_epi32 (_mm_sha256msg1_epu32 (msg, w[(i + 1) & 3]),
+                                                               _mm_alignr_epi8 (w[(i + 3) & 3], w[(i + 2) & 3], 4)),
+                                                w[(i + 3) & 3]);
+
+                __m128i m = _mm_add_epi32 (msg, _mm_loadu_si128 ((const __m128i*) (roundConstants + i * 4)));
+                state1 = _mm_sha256rnds2_epu32 (state1, state0, m);
+                m = _mm_shuffle_epi32 (m, 0x0e);
+                state0 = _mm_sha256rnds2_epu32 (state0, state1, m);
+            }
+
+            state0 = _mm_add_epi32 (state0, savedState0);
+            state1 = _mm_add_epi32 (state1, savedState1);
+        }
+
+        const __m128i feba = _mm_shuffle_epi32 (state0, 0x1b);
+        state1 = _mm_shuffle_epi32 (state1, 0xb1);
+        _mm_storeu_si128 ((__m128i*) state,       _mm_blend_epi16 (feba, state1, 0xf0));
+        _mm_storeu_si128 ((__m128i*) (state + 4), _mm_alignr_epi8 (state1, feba, 8));
+    }
+   #endif
+
+   #if JUCE_USE_ARM_SHA_INSTRUCTIONS
+    static void processBlocksARM (uint32* const state, const uint8* data, size_t numBlocks) noexcept
+    {
+        uint32x4_t state0 = vld1q_u32 (state);
+        uint32x4_t state1 = vld1q_u32 (state + 4);
+
+        for (; numBlocks > 0; --numBlocks, data += 64)
+        {
+            const uint32x4_t savedState0 = state0, savedState1 = state1;
+            uint32x4_t w[4];
+
+            for (int i = 0; i < 16; ++i)
+            {
+                uint32x4_t& msg = w[i & 3];
+
+                if (i < 4)
+                    msg = vreinterpretq_u32_u8 (vrev32q_u8 (vld1q_u8 (data + i * 16)));
+                else
+                    msg = vsha256su1q_u32 (vsha256su0q_u32 (msg, w[(i + 1) & 3]), w[(i + 2) & 3], w[(i + 3) & 3]);
+
+                const uint32x4_t m = vaddq_u32 (msg, vld1q_u32 (roundConstants + i * 4));
+                const uint32x4_t previousState0 = state0;
+                state0 = vsha256hq_u32 (state0, state1, m);
+                state1 = vsha256h2q_u32 (state1, previousState0, m);
+            }
+
+            state0 = vaddq_u32 (state0, savedState0);
+            state1 = vaddq_u32 (state1, savedState1);
+        }
+
+        vst1q_u32 (state, state0);
+        vst1q_u32 (state + 4, state1);
+    }
+   #endif
+
+    static void processBlocks (uint32* const state, const uint8* const data, const size_t numBlocks) noexcept
+    {
+       #if JUCE_USE_INTEL_SHA_INSTRUCTIONS
+        if (canUseIntelSHAInstructions())
+            return processBlocksIntel (state, data, numBlocks);
+       #endif
+
+       #if JUCE_USE_ARM_SHA_INSTRUCTIONS
+        processBlocksARM (state, data, numBlocks);
+       #else
+        processBlocksPortable (state, data, numBlocks);
+       #endif
+    }
+}
+
+//==============================================================================
 class SHA256Processor
 {
 public:
     SHA256Processor() noexcept
-        : length (0)
+    {
+        reset();
+    }
+
+    void reset() noexcept
     {
         state[0] = 0x6a09e667;
         state[1] = 0xbb67ae85;
@@ -36,77 +223,72 @@ public:
         state[5] = 0x9b05688c;
         state[6] = 0x1f83d9ab;
         state[7] = 0x5be0cd19;
+
+        length = 0;
+        bufferSize = 0;
     }
 
-    // expects 64 bytes of data
-    void processFullBlock (const void* const data) noexcept
+    void update (const void* const data, size_t numBytes) noexcept
     {
-        const uint32 constants[] =
-        {
-            0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
-            0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
-            0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
-            0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
-            0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
-            0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
-            0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
-            0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
-        };
-
-        uint32 block[16], s[8];
-        memcpy (s, state, sizeof (s));
-
-        for (int i = 0; i < 16; ++i)
-            block[i] = ByteOrder::bigEndianInt (addBytesToPointer (data, i * 4));
-
-        for (uint32 j = 0; j < 64; j += 16)
+        const uint8* d = static_cast <const uint8*> (data);
+        length += numBytes;
+
+        if (bufferSize > 0)
         {
-            #define JUCE_SHA256(i) \
-                s[(7 - i) & 7] += S1 (s[(4 - i) & 7]) + ch (s[(4 - i) & 7], s[(5 - i) & 7], s[(6 - i) & 7]) + constants[i + j] \
-                                     + (j != 0 ? (block[i & 15] += s1 (block[(i - 2) & 15]) + block[(i - 7) & 15] + s0 (block[(i - 15) & 15])) \
-                                               : block[i]); \
-                s[(3 - i) & 7] += s[(7 - i) & 7]; \
-                s[(7 - i) & 7] += S0 (s[(0 - i) & 7]) + maj (s[(0 - i) & 7], s[(1 - i) & 7], s[(2 - i) & 7])
-
-            JUCE_SHA256(0);  JUCE_SHA256(1);  JUCE_SHA256(2);  JUCE_SHA256(3);  JUCE_SHA256(4);  JUCE_SHA256(5);  JUCE_SHA256(6);  JUCE_SHA256(7);
-            JUCE_SHA256(8);  JUCE_SHA256(9);  JUCE_SHA256(10); JUCE_SHA256(11); JUCE_SHA256(12); JUCE_SHA256(13); JUCE_SHA256(14); JUCE_SHA256(15);
-            #undef JUCE_SHA256
+            const size_t num = jmin (numBytes, sizeof (buffer) - bufferSize);
+            memcpy (buffer + bufferSize, d, num);
+            bufferSize += num;
+            d += num;
+            numBytes -= num;
+
+            if (bufferSize < sizeof (buffer))
+                return;
+
+            SHA256Helpers::processBlocks (state, buffer, 1);
+            bufferSize = 0;
         }
 
-        for (int i = 0; i < 8; ++i)
-            state[i] += s[i];
+        const size_t numBlocks = numBytes / 64;
 
-        length += 64;
+        if (numBlocks > 0)
+            SHA256Helpers::processBlocks (state, d, numBlocks);
+
+        bufferSize = numBytes - numBlocks * 64;
+        memcpy (buffer, d + numBlocks * 64, bufferSize);
     }
 
-    void processFinalBlock (const void* const data, unsigned int numBytes) noexcept
+    void update (InputStream& input, int64 numBytesToRead)
     {
-        jassert (numBytes < 64);
+        if (numBytesToRead < 0)
+            numBytesToRead = std::numeric_limits<int64>::max();
 
-        length += numBytes;
-        length *= 8; // (the length is stored as a count of bits, not bytes)
+        HeapBlock<uint8> tempBuffer (16384);
 
-        uint8 finalBlocks[128];
+        while (numBytesToRead > 0)
+        {
+            const int bytesRead = input.read (tempBuffer, (int) jmin (numBytesToRead, (int64) 16384));
 
-        memcpy (finalBlocks, data, numBytes);
-        finalBlocks [numBytes++] = 128; // append a '1' bit
+            if (bytesRead <= 0)
+                break;
 
-        while (numBytes != 56 && numBytes < 64 + 56)
-            finalBlocks [numBytes++] = 0; // pad with zeros..
+            numBytesToRead -= bytesRead;
+            update (tempBuffer, (size_t) bytesRead);
+        }
+    }
 
-        for (int i = 8; --i >= 0;)
-            finalBlocks [numBytes++] = (uint8) (length >> (i * 8)); // append the length.
+    void finish (uint8* result) noexcept
+    {
+        const uint64 lengthInBits = length * 8;
 
-        jassert (numBytes == 64 || numBytes == 128);
+        uint8 padding[72] = { 128 }; // a '1' bit, followed by zeros..
+        update (padding, ((bufferSize < 56) ? 56 : 120) - bufferSize);
 
-        processFullBlock (finalBlocks);
+        for (int i = 0; i < 8; ++i)
+            padding[i] = (uint8) (lengthInBits >> ((7 - i) * 8)); // ..and then the length.
 
-        if (numBytes > 64)
-            processFullBlock (finalBlocks + 64);
-    }
+        update (padding, 8);
+        jassert (bufferSize == 0);
 
-    void copyResult (uint8* result) const noexcept
-    {
         for (int i = 0; i < 8; ++i)
         {
             *result++ = (uint8) (state[i] >> 24);
@@ -114,43 +296,15 @@ public:
             *result++ = (uint8) (state[i] >> 8);
             *result++ = (uint8) state[i];
         }
-    }
 
-    void processStream (InputStream& input, int64 numBytesToRead, uint8* const result)
-    {
-        if (numBytesToRead < 0)
-            numBytesToRead = std::numeric_limits<int64>::max();
-
-        for (;;)
-        {
-            uint8 buffer [64];
-            const int bytesRead = input.read (buffer, (int) jmin (numBytesToRead, (int64) sizeof (buffer)));
-
-            if (bytesRead < (int) sizeof (buffer))
-            {
-                processFinalBlock (buffer, (unsigned int) bytesRead);
-                break;
-            }
-
-            numBytesToRead -= sizeof (buffer);
-            processFullBlock (buffer);
-        }
-
-        copyResult (result);
+        reset();
     }
 
 private:
     uint32 state[8];
     uint64 length;
-
-    static inline uint32 rotate (const uint32 x, const uint32 y) noexcept                { return (x >> y) | (x << (32 - y)); }
-    static inline uint32 ch  (const uint32 x, const uint32 y, const uint32 z) noexcept   { return z ^ ((y ^ z) & x); }
-    static inline uint32 maj (const uint32 x, const uint32 y, const uint32 z) noexcept   { return y ^ ((y ^ z) & (x ^ y)); }
-
-    static inline uint32 s0 (const uint32 x) noexcept     { return rotate (x, 7)  ^ rotate (x, 18) ^ (x >> 3); }
-    static inline uint32 s1 (const uint32 x) noexcept     { return rotate (x, 17) ^ rotate (x, 19) ^ (x >> 10); }
-    static inline uint32 S0 (const uint32 x) noexcept     { return rotate (x, 2)  ^ rotate (x, 13) ^ rotate (x, 22); }
-    static inline uint32 S1 (const uint32 x) noexcept     { return rotate (x, 6)  ^ rotate (x, 11) ^ rotate (x, 25); }
+    uint8 buffer[64];
+    size_t bufferSize;
 
     JUCE_DECLARE_NON_COPYABLE (SHA256Processor)
 };
@@ -187,7 +341,8 @@ SHA256::SHA256 (const void* const data, const size_t numBytes)
 SHA256::SHA256 (InputStream& input, const int64 numBytesToRead)
 {
     SHA256Processor processor;
-    processor.processStream (input, numBytesToRead, result);
+    processor.update (input, numBytesToRead);
+    processor.finish (result);
 }
 
 SHA256::SHA256 (const File& file)
@@ -197,7 +352,8 @@ SHA256::SHA256 (const File& file)
     if (fin.getStatus().wasOk())
     {
         SHA256Processor processor;
-        processor.processStream (fin, -1, result);
+        processor.update (fin, -1);
+        processor.finish (result);
     }
     else
     {
@@ -213,9 +369,9 @@ SHA256::SHA256 (CharPointer_UTF8 utf8) noexcept
 
 void SHA256::process (const void* const data, size_t numBytes)
 {
-    MemoryInputStream m (data, numBytes, false);
     SHA256Processor processor;
-    processor.processStream (m, -1, result);
+    processor.update (data, numBytes);
+    processor.finish (result);
 }
 
 MemoryBlock SHA256::getRawData() const
@@ -231,6 +387,37 @@ String SHA256::toHexString() const
 bool SHA256::operator== (const SHA256& other) const noexcept  { return memcmp (result, other.result, sizeof (result)) == 0; }
 bool SHA256::operator!= (const SHA256& other) const noexcept  { return ! operator== (other); }
 
+//==============================================================================
+class SHA256::Generator::Pimpl  : public SHA256Processor
+{
+};
+
+SHA256::Generator::Generator()  : pimpl (new Pimpl()) {}
+SHA256::Generator::~Generator() {}
+
+void SHA256::Generator::update (const void* const data, const size_t numBytes)
+{
+    jassert (data != nullptr || numBytes == 0);
+    pimpl->update (data, numBytes);
+}
+
+void SHA256::Generator::update (InputStream& input, const int64 numBytesToRead)
+{
+    pimpl->update (input, numBytesToRead);
+}
+
+SHA256 SHA256::Generator::finalise()
+{
+    SHA256 s;
+    pimpl->finish (s.result);
+    return s;
+}
+
+void SHA256::Generator::reset()
+{
+    pimpl->reset();
+}
+
 
 //==============================================================================
 #if JUCE_UNIT_TESTS
@@ -261,6 +448,55 @@ public:
             SHA256 sha (n, sizeof (n) - 1);
             expectEquals (sha.toHexString(), String ("ef537f25c895bfa782526529a9b63d97aa631564d5d789c2b765448c8635fb6c"));
         }
+
+        beginTest ("Incremental");
+
+        Random r (0x1234);
+        MemoryBlock data (2000);
+
+        for (int i = 0; i < (int) data.getSize(); ++i)
+            data[i] = (char) r.nextInt (256);
+
+        for (int i = 0; i < 50; ++i)
+        {
+            const size_t size = (size_t) r.nextInt ((int) data.getSize());
+            SHA256::Generator generator;
+
+            for (size_t pos = 0; pos < size;)
+            {
+                const size_t num = jmin (size - pos, (size_t) r.nextInt (150));
+                generator.update (static_cast <const char*> (data.getData()) + pos, num);
+                pos += num;
+            }
+
+            expect (generator.finalise() == SHA256 (data.getData(), size));
+        }
+
+        {
+            SHA256::Generator generator;
+            generator.update ("The quick brown fox ", 20);
+            generator.update ("jumps over the lazy dog", 23);
+            expectEquals (generator.finalise().toHexString(), String ("d7a8fbb307d7809469ca9abcb0082e4f8d5651e46d3cdb762d02d0bf37c9e592"));
+
+            // (after finalise(), the generator starts again from scratch)
+            expectEquals (generator.finalise().toHexString(), String ("e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855"));
+        }
+
+        beginTest ("Hardware and portable implementations match");
+
+        for (int i = 0; i < 20; ++i)
+        {
+            uint32 state1[8], state2[8];
+
+            for (int j = 0; j < 8; ++j)
+                state1[j] = state2[j] = (uint32) r.nextInt();
+
+            const size_t numBlocks = (size_t) r.nextInt ((int) data.getSize() / 64);
+            SHA256Helpers::processBlocksPortable (state1, static_cast <const uint8*> (data.getData()), numBlocks);
+            SHA256Helpers::processBlocks (state2, static_cast <const uint8*> (data.getData()), numBlocks);
+
+            expect (memcmp (state1, state2, sizeof (state1)) == 0);
+        }
     }
 };
 
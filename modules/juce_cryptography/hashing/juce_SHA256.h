@@ -94,6 +94,50 @@ public:
     bool operator== (const SHA256&) const noexcept;
     bool operator!= (const SHA256&) const noexcept;
 
+    //==============================================================================
+    /**
+        Calculates a SHA-256 hash incrementally.
+
+        Use this when the data isn't all available at once: call update() as many times
+        as you need to, and then finalise() to get the hash of everything that was added.
+
+        Where the CPU has SHA instructions (the Intel SHA extensions, or the ARMv8 crypto
+        extensions), they'll be used, both here and in the SHA256 constructors.
+    */
+    class JUCE_API  Generator
+    {
+    public:
+        /** Creates a generator, ready to be given some data. */
+        Generator();
+
+        /** Destructor. */
+        ~Generator();
+
+        /** Adds a block of data to the hash. */
+        void update (const void* data, size_t numBytes);
+
+        /** Reads data from a stream and adds it to the hash.
+            This will read until the stream is exhausted, or until maxBytesToRead
+            bytes have been read. If maxBytesToRead is negative, the entire stream will be read.
+        */
+        void update (InputStream& input, int64 maxBytesToRead = -1);
+
+        /** Returns the hash of all the data that has been added.
+            After this has been called, the generator is reset so that it can be re-used.
+        */
+        SHA256 finalise();
+
+        /** Discards any data that has been added. */
+        void reset();
+
+    private:
+        class Pimpl;
+        friend class ScopedPointer<Pimpl>;
+        ScopedPointer<Pimpl> pimpl;
+
+        JUCE_DECLARE_NON_COPYABLE (Generator)
+    };
+
 
 private:
     //==============================================================================
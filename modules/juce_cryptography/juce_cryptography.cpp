@@ -37,11 +37,26 @@
 
 #include "juce_cryptography.h"
 
+#if JUCE_INTEL && ((JUCE_GCC && (JUCE_CLANG || __GNUC__ >= 5)) || (JUCE_MSVC && _MSC_VER >= 1900))
+ #define JUCE_USE_INTEL_SHA_INSTRUCTIONS 1
+ #include <immintrin.h>
+ #if JUCE_MSVC
+  #include <intrin.h>
+ #else
+  #include <cpuid.h>
+ #endif
+#elif defined (__ARM_FEATURE_CRYPTO) || defined (__ARM_FEATURE_SHA2)
+ #define JUCE_USE_ARM_SHA_INSTRUCTIONS 1
+ #include <arm_neon.h>
+#endif
+
 namespace juce
 {
 
 // START_AUTOINCLUDE encryption/*.cpp, hashing/*.cpp
 #include "encryption/juce_BlowFish.cpp"
+#include "encryption/juce_BlowFishInputStream.cpp"
+#include "encryption/juce_BlowFishOutputStream.cpp"
 #include "encryption/juce_Primes.cpp"
 #include "encryption/juce_RSAKey.cpp"
 #include "hashing/juce_MD5.cpp"
@@ -35,6 +35,12 @@ namespace juce
 #ifndef __JUCE_BLOWFISH_JUCEHEADER__
  #include "encryption/juce_BlowFish.h"
 #endif
+#ifndef __JUCE_BLOWFISHINPUTSTREAM_JUCEHEADER__
+ #include "encryption/juce_BlowFishInputStream.h"
+#endif
+#ifndef __JUCE_BLOWFISHOUTPUTSTREAM_JUCEHEADER__
+ #include "encryption/juce_BlowFishOutputStream.h"
+#endif
 #ifndef __JUCE_PRIMES_JUCEHEADER__
  #include "encryption/juce_Primes.h"
 #endif
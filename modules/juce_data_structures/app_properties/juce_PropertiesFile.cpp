@@ -39,6 +39,7 @@ PropertiesFile::Options::Options()
       ignoreCaseOfKeyNames (false),
       millisecondsBeforeSaving (3000),
       storageFormat (PropertiesFile::storeAsXML),
+      saveInBackground (false),
       processLock (nullptr)
 {
 }
@@ -101,6 +102,85 @@ File PropertiesFile::Options::getDefaultFile() const
 }
 
 
+//==============================================================================
+/*  Writes snapshots of the values on its own thread. Only the most recent snapshot
+    is kept, so a burst of saves while a slow write is in progress costs one extra write.
+*/
+class PropertiesFile::BackgroundWriter  : private Thread
+{
+public:
+    BackgroundWriter (PropertiesFile& owner_)
+        : Thread ("PropertiesFile writer"),
+          owner (owner_), idle (true), hasPendingValues (false)
+    {
+        idle.signal();
+    }
+
+    ~BackgroundWriter()
+    {
+        waitUntilIdle (-1);
+        stopThread (-1);
+    }
+
+    void write (const StringPairArray& values)
+    {
+        {
+            const ScopedLock sl (lock);
+            pendingValues = values;
+            hasPendingValues = true;
+            idle.reset();
+        }
+
+        if (isThreadRunning())
+            notify();
+        else
+            startThread (3);
+    }
+
+    bool waitUntilIdle (const int timeOutMilliseconds)
+    {
+        return idle.wait (timeOutMilliseconds);
+    }
+
+private:
+    PropertiesFile& owner;
+    CriticalSection lock;
+    StringPairArray pendingValues;
+    WaitableEvent idle;
+    bool hasPendingValues;
+
+    void run()
+    {
+        while (! threadShouldExit())
+        {
+            StringPairArray values;
+            bool gotValues;
+
+            {
+                const ScopedLock sl (lock);
+                gotValues = hasPendingValues;
+
+                if (gotValues)
+                {
+                    values = pendingValues;
+                    hasPendingValues = false;
+                }
+                else
+                {
+                    idle.signal();
+                }
+            }
+
+            if (! gotValues)
+                wait (-1);
+            else if (! owner.writeValues (values))
+                owner.setNeedsToBeSaved (true);
+        }
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (BackgroundWriter)
+};
+
 //==============================================================================
 PropertiesFile::PropertiesFile (const File& f, const Options& o)
     : PropertySet (o.ignoreCaseOfKeyNames),
@@ -120,6 +200,8 @@ PropertiesFile::PropertiesFile (const Options& o)
 
 bool PropertiesFile::reload()
 {
+    waitForBackgroundSave();
+
     ProcessScopedLock pl (createProcessLock());
 
     if (pl != nullptr && ! pl->isLocked())
@@ -132,6 +214,7 @@ bool PropertiesFile::reload()
 PropertiesFile::~PropertiesFile()
 {
     saveIfNeeded();
+    backgroundWriter = nullptr;
 }
 
 InterProcessLock::ScopedLockType* PropertiesFile::createProcessLock() const
@@ -168,10 +251,35 @@ bool PropertiesFile::save()
          || ! file.getParentDirectory().createDirectory())
         return false;
 
+    if (options.saveInBackground)
+    {
+        if (backgroundWriter == nullptr)
+            backgroundWriter = new BackgroundWriter (*this);
+
+        backgroundWriter->write (getAllProperties());
+        needsWriting = false;
+        return true;
+    }
+
+    if (! writeValues (getAllProperties()))
+        return false;
+
+    needsWriting = false;
+    return true;
+}
+
+bool PropertiesFile::waitForBackgroundSave (const int timeOutMilliseconds)
+{
+    return backgroundWriter == nullptr
+            || backgroundWriter->waitUntilIdle (timeOutMilliseconds);
+}
+
+bool PropertiesFile::writeValues (const StringPairArray& values) const
+{
     if (options.storageFormat == storeAsXML)
-        return saveAsXml();
+        return saveAsXml (values);
 
-    return saveAsBinary();
+    return saveAsBinary (values);
 }
 
 bool PropertiesFile::loadAsXml()
@@ -212,21 +320,21 @@ bool PropertiesFile::loadAsXml()
     return false;
 }
 
-bool PropertiesFile::saveAsXml()
+bool PropertiesFile::saveAsXml (const StringPairArray& values) const
 {
     XmlElement doc (PropertyFileConstants::fileTag);
 
-    for (int i = 0; i < getAllProperties().size(); ++i)
+    for (int i = 0; i < values.size(); ++i)
     {
         XmlElement* const e = doc.createNewChildElement (PropertyFileConstants::valueTag);
-        e->setAttribute (PropertyFileConstants::nameAttribute, getAllProperties().getAllKeys() [i]);
+        e->setAttribute (PropertyFileConstants::nameAttribute, values.getAllKeys() [i]);
 
         // if the value seems to contain xml, store it as such..
-        if (XmlElement* const childElement = XmlDocument::parse (getAllProperties().getAllValues() [i]))
+        if (XmlElement* const childElement = XmlDocument::parse (values.getAllValues() [i]))
             e->addChildElement (childElement);
         else
             e->setAttribute (PropertyFileConstants::valueAttribute,
-                             getAllProperties().getAllValues() [i]);
+                             values.getAllValues() [i]);
     }
 
     ProcessScopedLock pl (createProcessLock());
@@ -234,13 +342,7 @@ bool PropertiesFile::saveAsXml()
     if (pl != nullptr && ! pl->isLocked())
         return false; // locking failure..
 
-    if (doc.writeToFile (file, String::empty))
-    {
-        needsWriting = false;
-        return true;
-    }
-
-    return false;
+    return doc.writeToFile (file, String::empty);
 }
 
 bool PropertiesFile::loadAsBinary()
@@ -285,7 +387,7 @@ bool PropertiesFile::loadAsBinary (InputStream& input)
     return true;
 }
 
-bool PropertiesFile::saveAsBinary()
+bool PropertiesFile::saveAsBinary (const StringPairArray& values) const
 {
     ProcessScopedLock pl (createProcessLock());
 
@@ -312,23 +414,19 @@ bool PropertiesFile::saveAsBinary()
             out->writeInt (PropertyFileConstants::magicNumber);
         }
 
-        const int numProperties = getAllProperties().size();
+        const int numProperties = values.size();
 
         out->writeInt (numProperties);
 
         for (int i = 0; i < numProperties; ++i)
         {
-            out->writeString (getAllProperties().getAllKeys() [i]);
-            out->writeString (getAllProperties().getAllValues() [i]);
+            out->writeString (values.getAllKeys() [i]);
+            out->writeString (values.getAllValues() [i]);
         }
 
         out = nullptr;
 
-        if (tempFile.overwriteTargetFileWithTemporary())
-        {
-            needsWriting = false;
-            return true;
-        }
+        return tempFile.overwriteTargetFileWithTemporary();
     }
 
     return false;
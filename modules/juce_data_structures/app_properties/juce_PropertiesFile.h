@@ -122,6 +122,16 @@ public:
         */
         StorageFormat storageFormat;
 
+        /** If true, saving the file won't block the calling thread: save() will take a
+            copy of the current values and hand it to a background thread, which serialises
+            it and writes it to a temporary file before moving that into place. If more saves
+            are requested while a write is in progress, only the most recent set of values
+            will be written when it finishes.
+            The default constructor initialises this value to false.
+            @see PropertiesFile::waitForBackgroundSave
+        */
+        bool saveInBackground;
+
         /** An optional InterprocessLock object that will be used to prevent multiple threads or
             processes from writing to the file at the same time. The PropertiesFile will keep a
             pointer to this object but will not take ownership of it - the caller is responsible for
@@ -166,7 +176,8 @@ public:
                     const Options& options);
 
     /** Destructor.
-        When deleted, the file will first call saveIfNeeded() to flush any changes to disk.
+        When deleted, the file will first call saveIfNeeded() to flush any changes to disk,
+        and will wait for any background save to complete.
     */
     ~PropertiesFile();
 
@@ -194,10 +205,20 @@ public:
         Returns false if it fails to write to the file for some reason (maybe because
         it's read-only or the directory doesn't exist or something).
 
-        @see saveIfNeeded
+        If the Options::saveInBackground flag was set, this just queues the values to be
+        written and returns true - if the background write later fails, the file will be
+        flagged as needing to be saved again.
+
+        @see saveIfNeeded, waitForBackgroundSave
     */
     bool save();
 
+    /** If a background save is pending or in progress, this waits for it to finish.
+        Returns false if the timeout expired before the write had completed. If
+        Options::saveInBackground isn't being used, this returns true immediately.
+    */
+    bool waitForBackgroundSave (int timeOutMilliseconds = -1);
+
     /** Returns true if the properties have been altered since the last time they were saved.
         The file is flagged as needing to be saved when you change a value, but you can
         explicitly set this flag with setNeedsToBeSaved().
@@ -227,12 +248,17 @@ private:
     Options options;
     bool loadedOk, needsWriting;
 
+    class BackgroundWriter;
+    friend class BackgroundWriter;
+    ScopedPointer<BackgroundWriter> backgroundWriter;
+
     typedef const ScopedPointer<InterProcessLock::ScopedLockType> ProcessScopedLock;
     InterProcessLock::ScopedLockType* createProcessLock() const;
 
     void timerCallback();
-    bool saveAsXml();
-    bool saveAsBinary();
+    bool writeValues (const StringPairArray&) const;
+    bool saveAsXml (const StringPairArray&) const;
+    bool saveAsBinary (const StringPairArray&) const;
     bool loadAsXml();
     bool loadAsBinary();
     bool loadAsBinary (InputStream&);
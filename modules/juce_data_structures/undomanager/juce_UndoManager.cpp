@@ -26,12 +26,18 @@ struct UndoManager::ActionSet
 {
     ActionSet (const String& transactionName)
         : name (transactionName),
-          time (Time::getCurrentTime())
+          time (Time::getCurrentTime()),
+          spillPosition (-1),
+          spillSize (0)
     {}
 
     OwnedArray <UndoableAction> actions;
     String name;
     Time time;
+    int64 spillPosition;  // where this set's data lives in the spill file, or -1 if it's all in memory
+    int spillSize;
+
+    bool isSpilled() const noexcept     { return spillPosition >= 0; }
 
     bool perform() const
     {
@@ -60,6 +66,54 @@ struct UndoManager::ActionSet
 
         return total;
     }
+
+    //==============================================================================
+    // Each action's data is written as a flag and a length-prefixed block, so that a
+    // restore can never read past the end of what the action wrote.
+    bool writeSpilledData (OutputStream& out) const
+    {
+        bool anyWritten = false;
+        GZIPCompressorOutputStream gzip (&out, 6, false);
+
+        for (int i = 0; i < actions.size(); ++i)
+        {
+            MemoryOutputStream actionData;
+            const bool wasSpilled = actions.getUnchecked(i)->spillDataToStream (actionData);
+            gzip.writeBool (wasSpilled);
+
+            if (wasSpilled)
+            {
+                gzip.writeCompressedInt ((int) actionData.getDataSize());
+                gzip.write (actionData.getData(), actionData.getDataSize());
+                anyWritten = true;
+            }
+        }
+
+        gzip.flush();
+        return anyWritten;
+    }
+
+    bool readSpilledData (InputStream& in) const
+    {
+        GZIPDecompressorInputStream gzip (&in, false);
+
+        for (int i = 0; i < actions.size(); ++i)
+        {
+            if (gzip.readBool())
+            {
+                const int size = gzip.readCompressedInt();
+                MemoryBlock actionData;
+
+                if (size < 0 || gzip.readIntoMemoryBlock (actionData, size) != size)
+                    return false;
+
+                MemoryInputStream actionStream (actionData, false);
+                actions.getUnchecked(i)->restoreSpilledData (actionStream);
+            }
+        }
+
+        return true;
+    }
 };
 
 //==============================================================================
@@ -67,6 +121,9 @@ UndoManager::UndoManager (const int maxNumberOfUnitsToKeep,
                           const int minimumTransactions)
    : totalUnitsStored (0),
      nextIndex (0),
+     spillFileSize (0),
+     spillBytesInUse (0),
+     maxSpillFileSize (0),
      newTransaction (true),
      reentrancyCheck (false)
 {
@@ -76,6 +133,7 @@ UndoManager::UndoManager (const int maxNumberOfUnitsToKeep,
 
 UndoManager::~UndoManager()
 {
+    spillFile.deleteFile();
 }
 
 //==============================================================================
@@ -84,6 +142,7 @@ void UndoManager::clearUndoHistory()
     transactions.clear();
     totalUnitsStored = 0;
     nextIndex = 0;
+    resetSpillFile();
     sendChangeMessage();
 }
 
@@ -99,6 +158,184 @@ void UndoManager::setMaxNumberOfStoredUnits (const int maxNumberOfUnitsToKeep,
     minimumTransactionsToKeep  = jmax (1, minimumTransactions);
 }
 
+//==============================================================================
+void UndoManager::setSpillFile (const File& file, const int64 maxFileSize)
+{
+    if (file != spillFile)
+    {
+        // bring everything back into memory before switching files
+        for (int i = 0; i < transactions.size(); ++i)
+        {
+            if (! restoreTransaction (*transactions.getUnchecked(i)))
+            {
+                clearUndoHistory();
+                break;
+            }
+        }
+
+        resetSpillFile();
+        spillFile = file;
+        resetSpillFile();
+    }
+
+    maxSpillFileSize = jmax ((int64) 0, maxFileSize);
+    trimHistory();
+}
+
+const File& UndoManager::getSpillFile() const noexcept      { return spillFile; }
+int64 UndoManager::getSpillFileSize() const noexcept        { return spillFileSize; }
+
+int UndoManager::getNumSpilledTransactions() const noexcept
+{
+    int num = 0;
+
+    for (int i = transactions.size(); --i >= 0;)
+        if (transactions.getUnchecked(i)->isSpilled())
+            ++num;
+
+    return num;
+}
+
+void UndoManager::resetSpillFile()
+{
+    if (spillFile != File::nonexistent)
+        spillFile.deleteFile();
+
+    spillFileSize = 0;
+    spillBytesInUse = 0;
+}
+
+bool UndoManager::spillTransaction (ActionSet& set)
+{
+    jassert (! set.isSpilled());
+
+    const int oldSize = set.getTotalSize();
+    MemoryOutputStream compressed;
+
+    if (! set.writeSpilledData (compressed))
+        return false;
+
+    {
+        FileOutputStream out (spillFile);
+
+        if (out.failedToOpen())
+        {
+            // the actions have already given up their data, so take it straight back
+            MemoryInputStream in (compressed.getData(), compressed.getDataSize(), false);
+            set.readSpilledData (in);
+            return false;
+        }
+
+        jassert (out.getPosition() == spillFileSize);
+        out.write (compressed.getData(), compressed.getDataSize());
+    }
+
+    set.spillPosition = spillFileSize;
+    set.spillSize = (int) compressed.getDataSize();
+    spillFileSize += set.spillSize;
+    spillBytesInUse += set.spillSize;
+    totalUnitsStored += set.getTotalSize() - oldSize;
+    return true;
+}
+
+bool UndoManager::restoreTransaction (ActionSet& set)
+{
+    if (! set.isSpilled())
+        return true;
+
+    MemoryBlock compressed;
+    bool ok = false;
+
+    {
+        FileInputStream in (spillFile);
+
+        if (in.openedOk() && in.setPosition (set.spillPosition))
+            ok = in.readIntoMemoryBlock (compressed, set.spillSize) == set.spillSize;
+    }
+
+    const int oldSize = set.getTotalSize();
+
+    if (ok)
+    {
+        MemoryInputStream in (compressed, false);
+        ok = set.readSpilledData (in);
+    }
+
+    forgetSpilledData (set);
+    totalUnitsStored += set.getTotalSize() - oldSize;
+    return ok;
+}
+
+void UndoManager::forgetSpilledData (ActionSet& set)
+{
+    if (set.isSpilled())
+    {
+        spillBytesInUse -= set.spillSize;
+        set.spillPosition = -1;
+        set.spillSize = 0;
+
+        if (spillBytesInUse == 0)
+            resetSpillFile();
+    }
+}
+
+void UndoManager::compactSpillFile()
+{
+    const File tempFile (spillFile.getNonexistentSibling (false));
+    Array<int64> newPositions;
+    int64 bytesWritten = 0;
+
+    {
+        FileInputStream in (spillFile);
+        FileOutputStream out (tempFile);
+
+        if (in.openedOk() && ! out.failedToOpen())
+        {
+            for (int i = 0; i < transactions.size(); ++i)
+            {
+                const ActionSet& set = *transactions.getUnchecked(i);
+
+                if (set.isSpilled())
+                {
+                    newPositions.add (out.getPosition());
+
+                    if (! (in.setPosition (set.spillPosition)
+                            && out.writeFromInputStream (in, set.spillSize) == set.spillSize))
+                        break;
+                }
+            }
+
+            bytesWritten = out.getPosition();
+        }
+    }
+
+    if (bytesWritten != spillBytesInUse || ! tempFile.moveFileTo (spillFile))
+    {
+        tempFile.deleteFile();  // leave the old file in place - it's still valid
+        return;
+    }
+
+    for (int i = 0, n = 0; i < transactions.size(); ++i)
+        if (transactions.getUnchecked(i)->isSpilled())
+            transactions.getUnchecked(i)->spillPosition = newPositions.getUnchecked (n++);
+
+    spillFileSize = spillBytesInUse;
+}
+
+void UndoManager::removeTransaction (const int index)
+{
+    if (ActionSet* const set = transactions [index])
+    {
+        totalUnitsStored -= set->getTotalSize();
+        forgetSpilledData (*set);
+        transactions.remove (index);
+
+        // if this fails, then some actions may not be returning
+        // consistent results from their getSizeInUnits() method
+        jassert (totalUnitsStored >= 0);
+    }
+}
+
 //==============================================================================
 bool UndoManager::perform (UndoableAction* const newAction, const String& actionName)
 {
@@ -155,22 +392,42 @@ bool UndoManager::perform (UndoableAction* const newAction, const String& action
 void UndoManager::clearFutureTransactions()
 {
     while (nextIndex < transactions.size())
+        removeTransaction (transactions.size() - 1);
+
+    trimHistory();
+}
+
+void UndoManager::trimHistory()
+{
+    // Before dropping anything, try moving the bulk of the older transactions out to disk..
+    if (spillFile != File::nonexistent)
     {
-        totalUnitsStored -= transactions.getLast()->getTotalSize();
-        transactions.removeLast();
+        for (int i = 0; totalUnitsStored > maxNumUnitsToKeep
+                         && i < transactions.size() - minimumTransactionsToKeep; ++i)
+        {
+            ActionSet& set = *transactions.getUnchecked(i);
+
+            // (the transaction that's still open has to stay in memory)
+            if (! (set.isSpilled() || (i == nextIndex - 1 && ! newTransaction)))
+                spillTransaction (set);
+        }
+
+        while (nextIndex > 0 && spillBytesInUse > maxSpillFileSize)
+        {
+            removeTransaction (0);
+            --nextIndex;
+        }
+
+        if (spillFileSize > jmax ((int64) 65536, spillBytesInUse * 2))
+            compactSpillFile();
     }
 
     while (nextIndex > 0
             && totalUnitsStored > maxNumUnitsToKeep
             && transactions.size() > minimumTransactionsToKeep)
     {
-        totalUnitsStored -= transactions.getFirst()->getTotalSize();
-        transactions.remove (0);
+        removeTransaction (0);
         --nextIndex;
-
-        // if this fails, then some actions may not be returning
-        // consistent results from their getSizeInUnits() method
-        jassert (totalUnitsStored >= 0);
     }
 }
 
@@ -194,11 +451,11 @@ bool UndoManager::canRedo() const   { return getNextSet()    != nullptr; }
 
 bool UndoManager::undo()
 {
-    if (const ActionSet* const s = getCurrentSet())
+    if (ActionSet* const s = getCurrentSet())
     {
         const ScopedValueSetter<bool> setter (reentrancyCheck, true);
 
-        if (s->undo())
+        if (restoreTransaction (*s) && s->undo())
             --nextIndex;
         else
             clearUndoHistory();
@@ -213,11 +470,11 @@ bool UndoManager::undo()
 
 bool UndoManager::redo()
 {
-    if (const ActionSet* const s = getNextSet())
+    if (ActionSet* const s = getNextSet())
     {
         const ScopedValueSetter<bool> setter (reentrancyCheck, true);
 
-        if (s->perform())
+        if (restoreTransaction (*s) && s->perform())
             ++nextIndex;
         else
             clearUndoHistory();
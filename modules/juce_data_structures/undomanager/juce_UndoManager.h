@@ -46,6 +46,13 @@
     The UndoManager is a ChangeBroadcaster, so listeners can register to be told
     when actions are performed or undone.
 
+    The amount of history that's kept is limited by the total of the actions'
+    UndoableAction::getSizeInUnits() values - the built-in ValueTree actions report
+    this in bytes, so it can be treated as a memory budget. If you give the manager
+    a spill file with setSpillFile(), then rather than discarding older transactions
+    when the budget is exceeded, it'll compress their data into that file and only
+    read it back if they're undone.
+
     @see UndoableAction
 */
 class JUCE_API  UndoManager  : public ChangeBroadcaster
@@ -97,6 +104,32 @@ public:
     void setMaxNumberOfStoredUnits (int maxNumberOfUnitsToKeep,
                                     int minimumTransactionsToKeep);
 
+    //==============================================================================
+    /** Gives the manager a file into which it can move the data of older transactions.
+
+        When the stored actions exceed the limit set by setMaxNumberOfStoredUnits(), the
+        oldest transactions will be asked to write their data into this file in compressed
+        form (see UndoableAction::spillDataToStream()), and are only dropped from the
+        history if that doesn't bring the size back within the limit, or if the amount of
+        data in the file would exceed maxSpillFileSize.
+
+        Any existing file will be overwritten, and the file is deleted when the history
+        is cleared or the UndoManager is destroyed. Pass File::nonexistent to turn this off,
+        which will load any spilled transactions back into memory.
+
+        @see getSpillFileSize, getNumSpilledTransactions
+    */
+    void setSpillFile (const File& file, int64 maxSpillFileSize = 64 * 1024 * 1024);
+
+    /** Returns the file that was set with setSpillFile(). */
+    const File& getSpillFile() const noexcept;
+
+    /** Returns the number of bytes that have currently been written to the spill file. */
+    int64 getSpillFileSize() const noexcept;
+
+    /** Returns the number of transactions whose data is currently held in the spill file. */
+    int getNumSpilledTransactions() const noexcept;
+
     //==============================================================================
     /** Performs an action and adds it to the undo history list.
 
@@ -220,10 +253,19 @@ private:
     OwnedArray<ActionSet> transactions;
     String currentTransactionName;
     int totalUnitsStored, maxNumUnitsToKeep, minimumTransactionsToKeep, nextIndex;
+    File spillFile;
+    int64 spillFileSize, spillBytesInUse, maxSpillFileSize;
     bool newTransaction, reentrancyCheck;
     ActionSet* getCurrentSet() const noexcept;
     ActionSet* getNextSet() const noexcept;
     void clearFutureTransactions();
+    void trimHistory();
+    void removeTransaction (int index);
+    bool spillTransaction (ActionSet&);
+    bool restoreTransaction (ActionSet&);
+    void forgetSpilledData (ActionSet&);
+    void compactSpillFile();
+    void resetSpillFile();
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (UndoManager)
 };
@@ -78,7 +78,9 @@ public:
         can work out how many to keep.
 
         The default value returned here is 10 - units are arbitrary and
-        don't have to be accurate.
+        don't have to be accurate, but if you want to give the UndoManager a
+        meaningful memory budget, it's best to return the approximate number of
+        bytes that the action keeps alive, as the built-in ValueTree actions do.
 
         @see UndoManager::getNumberOfUnitsTakenUpByStoredCommands,
              UndoManager::setMaxNumberOfStoredUnits
@@ -93,6 +95,26 @@ public:
         If it's not possible to merge the two actions, the method should return zero.
     */
     virtual UndoableAction* createCoalescedAction (UndoableAction* nextAction)  { (void) nextAction; return nullptr; }
+
+    //==============================================================================
+    /** Asks the action to move its bulky data out to a stream so that it can be freed.
+
+        If the UndoManager has been given a spill file (see UndoManager::setSpillFile()),
+        it'll call this on old transactions to shrink the in-memory history. An action that
+        supports it should write whatever it needs to the stream, release that data, and
+        return true - after which its getSizeInUnits() should reflect the smaller footprint.
+
+        The action won't be performed or undone until restoreSpilledData() has been called
+        with a stream positioned at the data that was written here.
+
+        The default implementation does nothing and returns false.
+    */
+    virtual bool spillDataToStream (OutputStream& output)    { (void) output; return false; }
+
+    /** Reloads the data that a previous call to spillDataToStream() wrote out.
+        @see spillDataToStream
+    */
+    virtual void restoreSpilledData (InputStream& input)     { (void) input; }
 };
 
 
@@ -22,20 +22,119 @@
   ==============================================================================
 */
 
+/*  The indexed binary format, as written by ValueTree::writeToIndexedStream():
+
+        int32           magic number ('VTix')
+        compressed int  format version
+        compressed int  number of identifiers, followed by each identifier as a string
+        node            the root node
+
+    ..where each node is:
+
+        compressed int  index of the node's type in the identifier table
+        compressed int  number of properties, followed by each one as the index of its name
+                        in the identifier table and a value written by var::writeToStream()
+        compressed int  number of children
+        int32           (only if there are children) the number of bytes taken up by the
+                        children's nodes, which follow it directly
+
+    The size of each block of children means that a reader can skip over a whole subtree
+    without decoding it, so the children of a node are only read when they're first needed.
+*/
+class ValueTree::IndexedSource  : public ReferenceCountedObject
+{
+public:
+    typedef ReferenceCountedObjectPtr<IndexedSource> Ptr;
+
+    IndexedSource() noexcept  : data (nullptr), dataSize (0), rootOffset (0) {}
+
+    enum
+    {
+        magicNumber = 0x78695456,
+        formatVersion = 1
+    };
+
+    bool initialise()
+    {
+        if (data == nullptr || dataSize < 8 || ByteOrder::littleEndianInt (data) != (uint32) magicNumber)
+            return false;
+
+        MemoryInputStream in (data + 4, dataSize - 4, false);
+
+        if (in.readCompressedInt() != formatVersion)
+            return false;
+
+        const int numIdentifiers = in.readCompressedInt();
+
+        if (numIdentifiers < 0 || numIdentifiers > (int) dataSize)
+            return false;
+
+        identifiers.ensureStorageAllocated (numIdentifiers);
+
+        for (int i = 0; i < numIdentifiers; ++i)
+        {
+            const String name (in.readString());
+
+            if (name.isEmpty())
+                return false;
+
+            identifiers.add (Identifier (name));
+        }
+
+        rootOffset = (size_t) (4 + in.getPosition());
+        return ! in.isExhausted();
+    }
+
+    const char* data;
+    size_t dataSize, rootOffset;
+    Array<Identifier> identifiers;
+    MemoryBlock memoryBlock;
+    ScopedPointer<MemoryMappedFile> mappedFile;
+
+private:
+    JUCE_DECLARE_NON_COPYABLE (IndexedSource)
+};
+
+//==============================================================================
+// An immutable copy of one node of a tree. Once built, a SnapshotObject is never
+// modified, so any number of threads can read it without locking, and unchanged
+// subtrees are shared between successive snapshots of the same tree.
+class ValueTree::SnapshotObject  : public ReferenceCountedObject
+{
+public:
+    typedef ReferenceCountedObjectPtr<SnapshotObject> Ptr;
+
+    SnapshotObject (const Identifier t, const NamedValueSet& props)
+        : type (t), properties (props)
+    {
+    }
+
+    const Identifier type;
+    const NamedValueSet properties;
+    ReferenceCountedArray<SnapshotObject> children;
+
+private:
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SnapshotObject)
+};
+
+//==============================================================================
 class ValueTree::SharedObject  : public ReferenceCountedObject
 {
 public:
     typedef ReferenceCountedObjectPtr<SharedObject> Ptr;
 
     explicit SharedObject (const Identifier t) noexcept
-        : type (t), parent (nullptr)
+        : type (t), parent (nullptr), pendingNotifications (nullptr)
     {
     }
 
     SharedObject (const SharedObject& other)
         : ReferenceCountedObject(),
-          type (other.type), properties (other.properties), parent (nullptr)
+          type (other.type), properties (other.properties), parent (nullptr),
+          pendingNotifications (nullptr), snapshot (other.snapshot)
     {
+        other.ensureChildrenLoaded();
+
         for (int i = 0; i < other.children.size(); ++i)
         {
             SharedObject* const child = new SharedObject (*other.children.getObjectPointerUnchecked(i));
@@ -64,8 +163,26 @@ public:
                 v->listeners.call (&ValueTree::Listener::valueTreePropertyChanged, tree, property);
     }
 
+    //==============================================================================
+    enum NotificationType
+    {
+        propertyChanged,
+        childAdded,
+        childRemoved,
+        childOrderChanged,
+        parentChanged
+    };
+
+    // If there's a ScopedNotificationBatch active on this node or one of its parents, this
+    // adds the notification to it and returns true, otherwise it returns false and the
+    // caller should send the notification straight away.
+    bool deferNotification (NotificationType, SharedObject* child, const Identifier property);
+
     void sendPropertyChangeMessage (const Identifier property)
     {
+        if (deferNotification (propertyChanged, nullptr, property))
+            return;
+
         ValueTree tree (this);
 
         for (ValueTree::SharedObject* t = this; t != nullptr; t = t->parent)
@@ -81,6 +198,9 @@ public:
 
     void sendChildAddedMessage (ValueTree child)
     {
+        if (deferNotification (childAdded, child.object, Identifier()))
+            return;
+
         ValueTree tree (this);
 
         for (ValueTree::SharedObject* t = this; t != nullptr; t = t->parent)
@@ -96,6 +216,9 @@ public:
 
     void sendChildRemovedMessage (ValueTree child)
     {
+        if (deferNotification (childRemoved, child.object, Identifier()))
+            return;
+
         ValueTree tree (this);
 
         for (ValueTree::SharedObject* t = this; t != nullptr; t = t->parent)
@@ -111,6 +234,9 @@ public:
 
     void sendChildOrderChangedMessage()
     {
+        if (deferNotification (childOrderChanged, nullptr, Identifier()))
+            return;
+
         ValueTree tree (this);
 
         for (ValueTree::SharedObject* t = this; t != nullptr; t = t->parent)
@@ -145,7 +271,10 @@ public:
         if (undoManager == nullptr)
         {
             if (properties.set (name, newValue))
+            {
+                invalidateSnapshot();
                 sendPropertyChangeMessage (name);
+            }
         }
         else
         {
@@ -171,7 +300,10 @@ public:
         if (undoManager == nullptr)
         {
             if (properties.remove (name))
+            {
+                invalidateSnapshot();
                 sendPropertyChangeMessage (name);
+            }
         }
         else
         {
@@ -188,6 +320,7 @@ public:
             {
                 const Identifier name (properties.getName (properties.size() - 1));
                 properties.remove (name);
+                invalidateSnapshot();
                 sendPropertyChangeMessage (name);
             }
         }
@@ -211,6 +344,8 @@ public:
 
     ValueTree getChildWithName (const Identifier typeToMatch) const
     {
+        ensureChildrenLoaded();
+
         for (int i = 0; i < children.size(); ++i)
         {
             SharedObject* const s = children.getObjectPointerUnchecked (i);
@@ -223,6 +358,8 @@ public:
 
     ValueTree getOrCreateChildWithName (const Identifier typeToMatch, UndoManager* undoManager)
     {
+        ensureChildrenLoaded();
+
         for (int i = 0; i < children.size(); ++i)
         {
             SharedObject* const s = children.getObjectPointerUnchecked (i);
@@ -238,6 +375,8 @@ public:
 
     ValueTree getChildWithProperty (const Identifier propertyName, const var& propertyValue) const
     {
+        ensureChildrenLoaded();
+
         for (int i = 0; i < children.size(); ++i)
         {
             SharedObject* const s = children.getObjectPointerUnchecked (i);
@@ -257,13 +396,16 @@ public:
         return false;
     }
 
-    int indexOf (const ValueTree& child) const noexcept
+    int indexOf (const ValueTree& child) const
     {
+        ensureChildrenLoaded();
         return children.indexOf (child.object);
     }
 
     void addChild (SharedObject* child, int index, UndoManager* const undoManager)
     {
+        ensureChildrenLoaded();
+
         if (child != nullptr && child->parent != this)
         {
             if (child != this && ! isAChildOf (child))
@@ -283,8 +425,11 @@ public:
                 {
                     children.insert (index, child);
                     child->parent = this;
+                    invalidateSnapshot();
                     sendChildAddedMessage (ValueTree (child));
-                    child->sendParentChangeMessage();
+
+                    if (! deferNotification (parentChanged, child, Identifier()))
+                        child->sendParentChangeMessage();
                 }
                 else
                 {
@@ -305,6 +450,7 @@ public:
 
     void removeChild (const int childIndex, UndoManager* const undoManager)
     {
+        ensureChildrenLoaded();
         const Ptr child (children.getObjectPointer (childIndex));
 
         if (child != nullptr)
@@ -313,8 +459,11 @@ public:
             {
                 children.remove (childIndex);
                 child->parent = nullptr;
+                invalidateSnapshot();
                 sendChildRemovedMessage (ValueTree (child));
-                child->sendParentChangeMessage();
+
+                if (! deferNotification (parentChanged, child, Identifier()))
+                    child->sendParentChangeMessage();
             }
             else
             {
@@ -325,12 +474,16 @@ public:
 
     void removeAllChildren (UndoManager* const undoManager)
     {
+        ensureChildrenLoaded();
+
         while (children.size() > 0)
             removeChild (children.size() - 1, undoManager);
     }
 
     void moveChild (int currentIndex, int newIndex, UndoManager* undoManager)
     {
+        ensureChildrenLoaded();
+
         // The source index must be a valid index!
         jassert (isPositiveAndBelow (currentIndex, children.size()));
 
@@ -340,6 +493,7 @@ public:
             if (undoManager == nullptr)
             {
                 children.move (currentIndex, newIndex);
+                invalidateSnapshot();
                 sendChildOrderChangedMessage();
             }
             else
@@ -354,6 +508,7 @@ public:
 
     void reorderChildren (const OwnedArray<ValueTree>& newOrder, UndoManager* undoManager)
     {
+        ensureChildrenLoaded();
         jassert (newOrder.size() == children.size());
 
         if (undoManager == nullptr)
@@ -364,6 +519,7 @@ public:
             for (int i = 0; i < newOrder.size(); ++i)
                 children.add (newOrder.getUnchecked(i)->object);
 
+            invalidateSnapshot();
             sendChildOrderChangedMessage();
         }
         else
@@ -384,6 +540,9 @@ public:
 
     bool isEquivalentTo (const SharedObject& other) const
     {
+        ensureChildrenLoaded();
+        other.ensureChildrenLoaded();
+
         if (type != other.type
              || properties.size() != other.properties.size()
              || children.size() != other.children.size()
@@ -399,6 +558,8 @@ public:
 
     XmlElement* createXml() const
     {
+        ensureChildrenLoaded();
+
         XmlElement* const xml = new XmlElement (type.toString());
         properties.copyToXmlAttributes (*xml);
 
@@ -410,6 +571,8 @@ public:
 
     void writeToStream (OutputStream& output) const
     {
+        ensureChildrenLoaded();
+
         output.writeString (type.toString());
         output.writeCompressedInt (properties.size());
 
@@ -439,6 +602,223 @@ public:
         }
     }
 
+    //==============================================================================
+    void writeToIndexedStream (MemoryOutputStream& output, HashMap<String, int>& identifierIndexes) const
+    {
+        ensureChildrenLoaded();
+
+        output.writeCompressedInt (identifierIndexes [type.toString()]);
+        output.writeCompressedInt (properties.size());
+
+        for (int j = 0; j < properties.size(); ++j)
+        {
+            output.writeCompressedInt (identifierIndexes [properties.getName (j).toString()]);
+            properties.getValueAt(j).writeToStream (output);
+        }
+
+        output.writeCompressedInt (children.size());
+
+        if (children.size() > 0)
+        {
+            // leave a gap for the size of the children, and fill it in once they've been written
+            const int64 sizePosition = output.getPosition();
+            output.writeInt (0);
+
+            for (int i = 0; i < children.size(); ++i)
+                children.getObjectPointerUnchecked(i)->writeToIndexedStream (output, identifierIndexes);
+
+            const int64 endPosition = output.getPosition();
+            output.setPosition (sizePosition);
+            output.writeInt ((int) (endPosition - sizePosition - 4));
+            output.setPosition (endPosition);
+        }
+    }
+
+    void addIdentifiersToTable (HashMap<String, int>& identifierIndexes, StringArray& identifiers) const
+    {
+        ensureChildrenLoaded();
+
+        addIdentifierToTable (type, identifierIndexes, identifiers);
+
+        for (int j = 0; j < properties.size(); ++j)
+            addIdentifierToTable (properties.getName (j), identifierIndexes, identifiers);
+
+        for (int i = 0; i < children.size(); ++i)
+            children.getObjectPointerUnchecked(i)->addIdentifiersToTable (identifierIndexes, identifiers);
+    }
+
+    static void addIdentifierToTable (const Identifier id, HashMap<String, int>& identifierIndexes, StringArray& identifiers)
+    {
+        const String name (id.toString());
+
+        if (! identifierIndexes.contains (name))
+        {
+            identifierIndexes.set (name, identifiers.size());
+            identifiers.add (name);
+        }
+    }
+
+    // Reads a node's type and properties, and makes a note of where its children are
+    // so that they can be decoded when something first asks for them.
+    static SharedObject* readFromIndexedSource (IndexedSource& source, MemoryInputStream& input)
+    {
+        const int typeIndex = input.readCompressedInt();
+
+        if (! isPositiveAndBelow (typeIndex, source.identifiers.size()))
+            return nullptr;
+
+        ScopedPointer<SharedObject> node (new SharedObject (source.identifiers.getReference (typeIndex)));
+
+        const int numProps = input.readCompressedInt();
+
+        for (int i = 0; i < numProps; ++i)
+        {
+            const int nameIndex = input.readCompressedInt();
+
+            if (! isPositiveAndBelow (nameIndex, source.identifiers.size()) || input.isExhausted())
+            {
+                jassertfalse;  // trying to read corrupted data!
+                return nullptr;
+            }
+
+            node->properties.set (source.identifiers.getReference (nameIndex), var::readFromStream (input));
+        }
+
+        const int numChildren = input.readCompressedInt();
+
+        if (numChildren > 0)
+        {
+            const int blockSize = input.readInt();
+
+            if (blockSize <= 0 || blockSize > input.getNumBytesRemaining())
+            {
+                jassertfalse;  // trying to read corrupted data!
+                return nullptr;
+            }
+
+            node->pendingChildren = new PendingChildren (source, static_cast <const char*> (input.getData())
+                                                                   + input.getPosition(),
+                                                         (size_t) blockSize, numChildren);
+            input.skipNextBytes (blockSize);
+        }
+
+        return node.release();
+    }
+
+    void ensureChildrenLoaded() const
+    {
+        if (pendingChildren != nullptr)
+            const_cast <SharedObject*> (this)->loadPendingChildren();
+    }
+
+    //==============================================================================
+    // Each node keeps the last snapshot that was taken of it, and this is thrown away
+    // whenever the node or any of its descendants changes. So taking a snapshot only
+    // has to rebuild the nodes on the paths to whatever has changed since the last one,
+    // and re-uses the existing snapshots of all the other subtrees.
+    SnapshotObject* getSnapshot()
+    {
+        if (snapshot == nullptr)
+        {
+            ensureChildrenLoaded();
+
+            SnapshotObject* const s = new SnapshotObject (type, properties);
+            s->children.ensureStorageAllocated (children.size());
+
+            for (int i = 0; i < children.size(); ++i)
+                s->children.add (children.getObjectPointerUnchecked(i)->getSnapshot());
+
+            snapshot = s;
+        }
+
+        return snapshot;
+    }
+
+    void invalidateSnapshot() noexcept
+    {
+        // (if a node has no snapshot, then neither can any of its parents)
+        for (SharedObject* t = this; t != nullptr && t->snapshot != nullptr; t = t->parent)
+            t->snapshot = nullptr;
+    }
+
+    static SharedObject* createFromSnapshot (SnapshotObject& s)
+    {
+        SharedObject* const node = new SharedObject (s.type);
+        node->properties = s.properties;
+        node->children.ensureStorageAllocated (s.children.size());
+
+        for (int i = 0; i < s.children.size(); ++i)
+        {
+            SharedObject* const child = createFromSnapshot (*s.children.getObjectPointerUnchecked(i));
+            node->children.add (child);
+            child->parent = node;
+        }
+
+        node->snapshot = &s;  // the new tree's contents are identical, so it can share the snapshot
+        return node;
+    }
+
+    //==============================================================================
+    // Rough byte counts, used by the undo actions to report what they're keeping alive.
+    static int getApproximateSizeOf (const var& v)
+    {
+        int size = (int) sizeof (var);
+
+        if (v.isString())
+        {
+            size += 2 * (int) sizeof (void*) + (int) v.toString().getCharPointer().sizeInBytes();
+        }
+        else if (const MemoryBlock* const mb = v.getBinaryData())
+        {
+            size += (int) (sizeof (MemoryBlock) + mb->getSize());
+        }
+        else if (const Array<var>* const array = v.getArray())
+        {
+            size += (int) sizeof (Array<var>);
+
+            for (int i = array->size(); --i >= 0;)
+                size += getApproximateSizeOf (array->getReference (i));
+        }
+        else if (DynamicObject* const object = v.getDynamicObject())
+        {
+            const NamedValueSet& props = object->getProperties();
+            size += (int) sizeof (DynamicObject);
+
+            for (int i = props.size(); --i >= 0;)
+                size += (int) sizeof (Identifier) + getApproximateSizeOf (props.getValueAt (i));
+        }
+
+        return size;
+    }
+
+    int getApproximateSize() const
+    {
+        int size = (int) sizeof (SharedObject);
+
+        for (int i = properties.size(); --i >= 0;)
+            size += (int) sizeof (Identifier) + getApproximateSizeOf (properties.getValueAt (i));
+
+        for (int i = children.size(); --i >= 0;)
+            size += (int) sizeof (SharedObject*) + children.getObjectPointerUnchecked (i)->getApproximateSize();
+
+        return size;
+    }
+
+    // Only values that var::writeToStream() can round-trip may be moved out to disk.
+    static bool canBeWrittenToStream (const var& v)
+    {
+        if (v.isObject() || v.isMethod())
+            return false;
+
+        if (const Array<var>* const array = v.getArray())
+            for (int i = array->size(); --i >= 0;)
+                if (! canBeWrittenToStream (array->getReference (i)))
+                    return false;
+
+        return true;
+    }
+
+    //==============================================================================
     //==============================================================================
     class SetPropertyAction  : public UndoableAction
     {
@@ -447,12 +827,14 @@ public:
                            const var& newValue_, const var& oldValue_,
                            const bool isAddingNewProperty_, const bool isDeletingProperty_)
             : target (target_), name (name_), newValue (newValue_), oldValue (oldValue_),
-              isAddingNewProperty (isAddingNewProperty_), isDeletingProperty (isDeletingProperty_)
+              isAddingNewProperty (isAddingNewProperty_), isDeletingProperty (isDeletingProperty_),
+              isSpilled (false)
         {
         }
 
         bool perform()
         {
+            jassert (! isSpilled);
             jassert (! (isAddingNewProperty && target->hasProperty (name)));
 
             if (isDeletingProperty)
@@ -465,6 +847,8 @@ public:
 
         bool undo()
         {
+            jassert (! isSpilled);
+
             if (isAddingNewProperty)
                 target->removeProperty (name, nullptr);
             else
@@ -475,28 +859,59 @@ public:
 
         int getSizeInUnits()
         {
-            return (int) sizeof (*this); //xxx should be more accurate
+            return (int) sizeof (*this) - 2 * (int) sizeof (var)
+                     + getApproximateSizeOf (newValue) + getApproximateSizeOf (oldValue);
         }
 
         UndoableAction* createCoalescedAction (UndoableAction* nextAction)
         {
-            if (! (isAddingNewProperty || isDeletingProperty))
-            {
-                if (SetPropertyAction* const next = dynamic_cast <SetPropertyAction*> (nextAction))
-                    if (next->target == target && next->name == name
-                          && ! (next->isAddingNewProperty || next->isDeletingProperty))
-                        return new SetPropertyAction (target, name, next->newValue, oldValue, false, false);
-            }
+            SetPropertyAction* const next = dynamic_cast <SetPropertyAction*> (nextAction);
 
-            return nullptr;
+            if (next == nullptr || next->target != target || next->name != name)
+                return nullptr;
+
+            if (isDeletingProperty)     // delete + re-add = change
+                return next->isAddingNewProperty ? new SetPropertyAction (target, name, next->newValue, oldValue, false, false)
+                                                 : nullptr;
+
+            if (next->isAddingNewProperty)
+                return nullptr;
+
+            if (next->isDeletingProperty)   // (add + delete = nothing, which can't be expressed as an action)
+                return isAddingNewProperty ? nullptr
+                                           : new SetPropertyAction (target, name, var::null, oldValue, false, true);
+
+            return new SetPropertyAction (target, name, next->newValue, oldValue, isAddingNewProperty, false);
+        }
+
+        bool spillDataToStream (OutputStream& output)
+        {
+            if (isSpilled || getSizeInUnits() <= (int) sizeof (*this)
+                 || ! (canBeWrittenToStream (newValue) && canBeWrittenToStream (oldValue)))
+                return false;
+
+            newValue.writeToStream (output);
+            oldValue.writeToStream (output);
+            newValue = var::null;
+            oldValue = var::null;
+            isSpilled = true;
+            return true;
+        }
+
+        void restoreSpilledData (InputStream& input)
+        {
+            jassert (isSpilled);
+            newValue = var::readFromStream (input);
+            oldValue = var::readFromStream (input);
+            isSpilled = false;
         }
 
     private:
         const Ptr target;
         const Identifier name;
-        const var newValue;
-        var oldValue;
+        var newValue, oldValue;
         const bool isAddingNewProperty : 1, isDeletingProperty : 1;
+        bool isSpilled : 1;
 
         JUCE_DECLARE_NON_COPYABLE (SetPropertyAction)
     };
@@ -509,7 +924,8 @@ public:
             : target (target_),
               child (newChild_ != nullptr ? newChild_ : target_->children.getObjectPointer (childIndex_)),
               childIndex (childIndex_),
-              isDeleting (newChild_ == nullptr)
+              isDeleting (newChild_ == nullptr),
+              sizeInBytes ((int) sizeof (*this) + child->getApproximateSize())
         {
             jassert (child != nullptr);
         }
@@ -543,13 +959,14 @@ public:
 
         int getSizeInUnits()
         {
-            return (int) sizeof (*this); //xxx should be more accurate
+            return sizeInBytes;
         }
 
     private:
         const Ptr target, child;
         const int childIndex;
         const bool isDeleting;
+        const int sizeInBytes;  // measured once, as the UndoManager needs a consistent value
 
         JUCE_DECLARE_NON_COPYABLE (AddOrRemoveChildAction)
     };
@@ -577,7 +994,7 @@ public:
 
         int getSizeInUnits()
         {
-            return (int) sizeof (*this); //xxx should be more accurate
+            return (int) sizeof (*this);
         }
 
         UndoableAction* createCoalescedAction (UndoableAction* nextAction)
@@ -596,18 +1013,181 @@ public:
         JUCE_DECLARE_NON_COPYABLE (MoveChildAction)
     };
 
+    //==============================================================================
+    // nodes come from the current MemoryArena, if there is one
+    static void* operator new (size_t size)     { return ArenaAllocationPolicy::allocate (size); }
+    static void operator delete (void* p)       { ArenaAllocationPolicy::release (p); }
+
     //==============================================================================
     const Identifier type;
     NamedValueSet properties;
-    ReferenceCountedArray<SharedObject> children;
+    ReferenceCountedArray<SharedObject, DummyCriticalSection, ArenaAllocationPolicy> children;
     SortedSet<ValueTree*> valueTreesWithListeners;
     SharedObject* parent;
+    PendingNotifications* pendingNotifications;
+    SnapshotObject::Ptr snapshot;
 
 private:
+    struct PendingChildren
+    {
+        PendingChildren (IndexedSource& source_, const char* data_, size_t size_, int num_) noexcept
+            : source (&source_), data (data_), size (size_), numChildren (num_)
+        {}
+
+        const IndexedSource::Ptr source;
+        const char* const data;
+        const size_t size;
+        const int numChildren;
+
+        JUCE_DECLARE_NON_COPYABLE (PendingChildren)
+    };
+
+    ScopedPointer<PendingChildren> pendingChildren;
+
+    void loadPendingChildren()
+    {
+        const ScopedPointer<PendingChildren> pending (pendingChildren.release());
+        MemoryInputStream input (pending->data, pending->size, false);
+        children.ensureStorageAllocated (pending->numChildren);
+
+        for (int i = 0; i < pending->numChildren; ++i)
+        {
+            SharedObject* const child = readFromIndexedSource (*pending->source, input);
+
+            if (child == nullptr)
+            {
+                jassertfalse;  // trying to read corrupted data!
+                break;
+            }
+
+            children.add (child);
+            child->parent = this;
+        }
+    }
+
     SharedObject& operator= (const SharedObject&);
     JUCE_LEAK_DETECTOR (SharedObject)
 };
 
+//==============================================================================
+// The notifications that have been held back by a ScopedNotificationBatch. Repeated
+// changes to the same property, and repeated re-orderings or parent changes of the same
+// node, are only kept once, in the position where they first happened.
+class ValueTree::PendingNotifications
+{
+public:
+    PendingNotifications() {}
+
+    void add (const SharedObject::NotificationType type, SharedObject* const target,
+              SharedObject* const child, const Identifier property)
+    {
+        if (type != SharedObject::childAdded && type != SharedObject::childRemoved)
+        {
+            const Key key (type, target, property);
+
+            if (keys.contains (key))
+                return;
+
+            keys.add (key);
+        }
+
+        notifications.add (new Notification (type, target, child, property));
+    }
+
+    void deliver()
+    {
+        for (int i = 0; i < notifications.size(); ++i)
+        {
+            const Notification& n = *notifications.getUnchecked (i);
+
+            switch (n.type)
+            {
+                case SharedObject::propertyChanged:     n.target->sendPropertyChangeMessage (n.property); break;
+                case SharedObject::childAdded:          n.target->sendChildAddedMessage (ValueTree (n.child)); break;
+                case SharedObject::childRemoved:        n.target->sendChildRemovedMessage (ValueTree (n.child)); break;
+                case SharedObject::childOrderChanged:   n.target->sendChildOrderChangedMessage(); break;
+                case SharedObject::parentChanged:       n.target->sendParentChangeMessage(); break;
+                default:                                jassertfalse; break;
+            }
+        }
+
+        notifications.clear();
+        keys.clear();
+    }
+
+    //==============================================================================
+    class DeliveryMessage  : public CallbackMessage
+    {
+    public:
+        DeliveryMessage (PendingNotifications* p) noexcept  : pending (p) {}
+        void messageCallback()                              { pending->deliver(); }
+
+    private:
+        const ScopedPointer<PendingNotifications> pending;
+    };
+
+private:
+    struct Notification
+    {
+        Notification (SharedObject::NotificationType t, SharedObject* target_,
+                      SharedObject* child_, const Identifier property_) noexcept
+            : type (t), target (target_), child (child_), property (property_)
+        {}
+
+        const SharedObject::NotificationType type;
+        const SharedObject::Ptr target, child;
+        const Identifier property;
+    };
+
+    struct Key
+    {
+        Key (int t, const void* target_, const Identifier property_) noexcept
+            : type (t), target (target_), property (property_.getCharPointer().getAddress())
+        {}
+
+        bool operator== (const Key& other) const noexcept
+        {
+            return type == other.type && target == other.target && property == other.property;
+        }
+
+        bool operator< (const Key& other) const noexcept
+        {
+            if (target != other.target)       return target < other.target;
+            if (property != other.property)   return property < other.property;
+            return type < other.type;
+        }
+
+        int type;
+        const void* target;
+        const void* property;
+    };
+
+    OwnedArray<Notification> notifications;
+    SortedSet<Key> keys;
+
+    JUCE_DECLARE_NON_COPYABLE (PendingNotifications)
+};
+
+bool ValueTree::SharedObject::deferNotification (const NotificationType type, SharedObject* const child,
+                                                 const Identifier property)
+{
+    for (SharedObject* t = this; t != nullptr; t = t->parent)
+    {
+        if (t->pendingNotifications != nullptr)
+        {
+            // (a parent-change notification goes to the child itself rather than to this node)
+            if (type == parentChanged)
+                t->pendingNotifications->add (type, child, nullptr, property);
+            else
+                t->pendingNotifications->add (type, this, child, property);
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
 //==============================================================================
 ValueTree::ValueTree() noexcept
 {
@@ -683,6 +1263,11 @@ ValueTree ValueTree::createCopy() const
     return ValueTree (createCopyIfNotNull (object.get()));
 }
 
+ValueTree::Snapshot ValueTree::createSnapshot() const
+{
+    return Snapshot (object != nullptr ? object->getSnapshot() : nullptr);
+}
+
 bool ValueTree::hasType (const Identifier typeName) const
 {
     return object != nullptr && object->type == typeName;
@@ -821,13 +1406,20 @@ Value ValueTree::getPropertyAsValue (const Identifier name, UndoManager* const u
 //==============================================================================
 int ValueTree::getNumChildren() const
 {
-    return object == nullptr ? 0 : object->children.size();
+    if (object == nullptr)
+        return 0;
+
+    object->ensureChildrenLoaded();
+    return object->children.size();
 }
 
 ValueTree ValueTree::getChild (int index) const
 {
-    return ValueTree (object != nullptr ? object->children.getObjectPointer (index)
-                                        : static_cast <SharedObject*> (nullptr));
+    if (object == nullptr)
+        return ValueTree();
+
+    object->ensureChildrenLoaded();
+    return ValueTree (object->children.getObjectPointer (index));
 }
 
 ValueTree ValueTree::getChildWithName (const Identifier type) const
@@ -872,7 +1464,7 @@ void ValueTree::removeChild (const int childIndex, UndoManager* const undoManage
 void ValueTree::removeChild (const ValueTree& child, UndoManager* const undoManager)
 {
     if (object != nullptr)
-        object->removeChild (object->children.indexOf (child.object), undoManager);
+        object->removeChild (object->indexOf (child), undoManager);
 }
 
 void ValueTree::removeAllChildren (UndoManager* const undoManager)
@@ -891,6 +1483,7 @@ void ValueTree::moveChild (int currentIndex, int newIndex, UndoManager* undoMana
 void ValueTree::createListOfChildren (OwnedArray<ValueTree>& list) const
 {
     jassert (object != nullptr);
+    object->ensureChildrenLoaded();
 
     for (int i = 0; i < object->children.size(); ++i)
         list.add (new ValueTree (object->children.getObjectPointerUnchecked(i)));
@@ -938,6 +1531,7 @@ ValueTree ValueTree::fromXml (const XmlElement& xml)
 {
     ValueTree v (xml.getTagName());
     v.object->properties.setFromXmlAttributes (xml);
+    v.object->children.ensureStorageAllocated (xml.getNumChildElements());
 
     forEachXmlChildElement (xml, e)
         v.addChild (fromXml (*e), -1, nullptr);
@@ -1009,8 +1603,209 @@ ValueTree ValueTree::readFromGZIPData (const void* const data, const size_t numB
     return readFromStream (gzipStream);
 }
 
+//==============================================================================
+void ValueTree::writeToIndexedStream (OutputStream& output) const
+{
+    HashMap<String, int> identifierIndexes;
+    StringArray identifiers;
+
+    if (object != nullptr)
+        object->addIdentifiersToTable (identifierIndexes, identifiers);
+
+    MemoryOutputStream mo;
+    mo.writeInt (IndexedSource::magicNumber);
+    mo.writeCompressedInt (IndexedSource::formatVersion);
+    mo.writeCompressedInt (identifiers.size());
+
+    for (int i = 0; i < identifiers.size(); ++i)
+        mo.writeString (identifiers[i]);
+
+    if (object != nullptr)
+        object->writeToIndexedStream (mo, identifierIndexes);
+
+    output.write (mo.getData(), mo.getDataSize());
+}
+
+ValueTree ValueTree::readFromIndexedSource (IndexedSource* const source)
+{
+    const IndexedSource::Ptr sourceHolder (source);
+
+    if (source->initialise())
+    {
+        MemoryInputStream in (source->data + source->rootOffset, source->dataSize - source->rootOffset, false);
+        return ValueTree (SharedObject::readFromIndexedSource (*source, in));
+    }
+
+    return ValueTree::invalid;
+}
+
+ValueTree ValueTree::readFromIndexedStream (InputStream& input)
+{
+    IndexedSource* const source = new IndexedSource();
+    input.readIntoMemoryBlock (source->memoryBlock);
+    source->data = static_cast <const char*> (source->memoryBlock.getData());
+    source->dataSize = source->memoryBlock.getSize();
+    return readFromIndexedSource (source);
+}
+
+ValueTree ValueTree::readFromIndexedData (const void* const data, const size_t numBytes)
+{
+    IndexedSource* const source = new IndexedSource();
+    source->memoryBlock = MemoryBlock (data, numBytes);
+    source->data = static_cast <const char*> (source->memoryBlock.getData());
+    source->dataSize = source->memoryBlock.getSize();
+    return readFromIndexedSource (source);
+}
+
+ValueTree ValueTree::readFromIndexedFile (const File& file, const bool useMemoryMapping)
+{
+    if (useMemoryMapping)
+    {
+        IndexedSource* const source = new IndexedSource();
+        source->mappedFile = new MemoryMappedFile (file, MemoryMappedFile::readOnly);
+        source->data = static_cast <const char*> (source->mappedFile->getData());
+        source->dataSize = source->mappedFile->getSize();
+        return readFromIndexedSource (source);
+    }
+
+    FileInputStream in (file);
+
+    if (in.openedOk())
+        return readFromIndexedStream (in);
+
+    return ValueTree::invalid;
+}
+
 void ValueTree::Listener::valueTreeRedirected (ValueTree&) {}
 
+//==============================================================================
+ValueTree::ScopedNotificationBatch::ScopedNotificationBatch (const ValueTree& tree_, const bool deliverAsynchronously_)
+    : object (tree_.object), deliverAsynchronously (deliverAsynchronously_)
+{
+    // if a batch is already active on this tree or one of its parents, that one
+    // will collect the notifications instead
+    for (SharedObject* t = object; t != nullptr; t = t->parent)
+        if (t->pendingNotifications != nullptr)
+            return;
+
+    if (object != nullptr)
+    {
+        pending = new PendingNotifications();
+        object->pendingNotifications = pending;
+    }
+}
+
+ValueTree::ScopedNotificationBatch::~ScopedNotificationBatch()
+{
+    if (pending != nullptr)
+    {
+        object->pendingNotifications = nullptr;
+
+        if (deliverAsynchronously)
+            (new PendingNotifications::DeliveryMessage (pending.release()))->post();
+        else
+            pending->deliver();
+    }
+}
+
+//==============================================================================
+ValueTree::Snapshot::Snapshot() noexcept {}
+ValueTree::Snapshot::Snapshot (SnapshotObject* const o) noexcept  : object (o) {}
+ValueTree::Snapshot::Snapshot (const Snapshot& other) noexcept     : object (other.object) {}
+ValueTree::Snapshot::~Snapshot() {}
+
+ValueTree::Snapshot& ValueTree::Snapshot::operator= (const Snapshot& other) noexcept
+{
+    object = other.object;
+    return *this;
+}
+
+bool ValueTree::Snapshot::operator== (const Snapshot& other) const noexcept   { return object == other.object; }
+bool ValueTree::Snapshot::operator!= (const Snapshot& other) const noexcept   { return object != other.object; }
+
+bool ValueTree::Snapshot::isValid() const noexcept
+{
+    return object != nullptr;
+}
+
+Identifier ValueTree::Snapshot::getType() const
+{
+    return object != nullptr ? object->type : Identifier();
+}
+
+bool ValueTree::Snapshot::hasType (const Identifier typeName) const
+{
+    return object != nullptr && object->type == typeName;
+}
+
+const var& ValueTree::Snapshot::getProperty (const Identifier name) const
+{
+    return object == nullptr ? var::null : object->properties [name];
+}
+
+var ValueTree::Snapshot::getProperty (const Identifier name, const var& defaultReturnValue) const
+{
+    return object == nullptr ? defaultReturnValue
+                             : object->properties.getWithDefault (name, defaultReturnValue);
+}
+
+const var& ValueTree::Snapshot::operator[] (const Identifier name) const
+{
+    return getProperty (name);
+}
+
+bool ValueTree::Snapshot::hasProperty (const Identifier name) const
+{
+    return object != nullptr && object->properties.contains (name);
+}
+
+int ValueTree::Snapshot::getNumProperties() const
+{
+    return object == nullptr ? 0 : object->properties.size();
+}
+
+Identifier ValueTree::Snapshot::getPropertyName (const int index) const
+{
+    return object == nullptr ? Identifier() : object->properties.getName (index);
+}
+
+int ValueTree::Snapshot::getNumChildren() const
+{
+    return object == nullptr ? 0 : object->children.size();
+}
+
+ValueTree::Snapshot ValueTree::Snapshot::getChild (const int index) const
+{
+    return Snapshot (object != nullptr ? object->children.getObjectPointer (index)
+                                       : static_cast <SnapshotObject*> (nullptr));
+}
+
+ValueTree::Snapshot ValueTree::Snapshot::getChildWithName (const Identifier type) const
+{
+    if (object != nullptr)
+        for (int i = 0; i < object->children.size(); ++i)
+            if (object->children.getObjectPointerUnchecked(i)->type == type)
+                return Snapshot (object->children.getObjectPointerUnchecked(i));
+
+    return Snapshot();
+}
+
+ValueTree::Snapshot ValueTree::Snapshot::getChildWithProperty (const Identifier propertyName, const var& propertyValue) const
+{
+    if (object != nullptr)
+        for (int i = 0; i < object->children.size(); ++i)
+            if (object->children.getObjectPointerUnchecked(i)->properties [propertyName] == propertyValue)
+                return Snapshot (object->children.getObjectPointerUnchecked(i));
+
+    return Snapshot();
+}
+
+ValueTree ValueTree::Snapshot::createValueTree() const
+{
+    return ValueTree (object != nullptr ? SharedObject::createFromSnapshot (*object)
+                                        : static_cast <SharedObject*> (nullptr));
+}
+
 //==============================================================================
 #if JUCE_UNIT_TESTS
 
@@ -1095,7 +1890,220 @@ public:
             ValueTree v4 = v2.createCopy();
             expect (v1.isEquivalentTo (v4));
         }
+
+        beginTest ("Indexed format");
+
+        for (int i = 10; --i >= 0;)
+        {
+            MemoryOutputStream mo;
+            ValueTree v1 (createRandomTree (nullptr, 0));
+            v1.writeToIndexedStream (mo);
+
+            ValueTree v2 (ValueTree::readFromIndexedData (mo.getData(), mo.getDataSize()));
+            expect (v1.isEquivalentTo (v2));
+
+            MemoryInputStream mi (mo.getData(), mo.getDataSize(), false);
+            ValueTree v3 (ValueTree::readFromIndexedStream (mi));
+
+            if (v3.getNumChildren() > 0)
+            {
+                ValueTree child (v3.getChild (0));
+                child.addChild (createRandomTree (nullptr, 3), 0, nullptr);
+                expect (child.getParent() == v3);
+                expect (! v1.isEquivalentTo (v3));
+            }
+
+            expect (ValueTree::readFromIndexedData (mo.getData(), 3) == ValueTree::invalid);
+        }
+
+        beginTest ("MemoryArena");
+
+        for (int i = 10; --i >= 0;)
+        {
+            MemoryOutputStream mo;
+            ValueTree v1 (createRandomTree (nullptr, 0));
+            v1.writeToStream (mo);
+            ScopedPointer <XmlElement> xml1 (v1.createXml());
+
+            ValueTree v2, v3;
+
+            {
+                const MemoryArena::ScopedUse arena (new MemoryArena (4096));
+                expect (MemoryArena::getCurrent() != nullptr);
+
+                MemoryInputStream mi (mo.getData(), mo.getDataSize(), false);
+                v2 = ValueTree::readFromStream (mi);
+                v3 = ValueTree::fromXml (*xml1);
+            }
+
+            expect (MemoryArena::getCurrent() == nullptr);
+            expect (v1.isEquivalentTo (v2));
+
+            ScopedPointer <XmlElement> xml3 (v3.createXml());
+            expect (xml1->isEquivalentTo (xml3, false));
+
+            // modifying the trees after the arena has gone out of scope must still work
+            v2.addChild (createRandomTree (nullptr, 3), 0, nullptr);
+            v3.removeAllChildren (nullptr);
+            v3.setProperty ("test", 123, nullptr);
+            expect (! v1.isEquivalentTo (v2));
+            expect ((int) v3.getProperty ("test") == 123);
+        }
+
+        beginTest ("Snapshots");
+
+        for (int i = 10; --i >= 0;)
+        {
+            ValueTree v1 (createRandomTree (nullptr, 0));
+            v1.addChild (createRandomTree (nullptr, 3), -1, nullptr);
+            v1.addChild (createRandomTree (nullptr, 3), -1, nullptr);
+
+            const ValueTree::Snapshot s1 (v1.createSnapshot());
+            expect (s1.isValid() && s1.hasType (v1.getType()));
+            expect (s1.createValueTree().isEquivalentTo (v1));
+            expect (v1.createSnapshot() == s1);  // nothing has changed, so the same snapshot is returned
+
+            const ValueTree original (v1.createCopy());
+            const int numChildren = v1.getNumChildren();
+            ValueTree lastChild (v1.getChild (numChildren - 1));
+
+            lastChild.setProperty ("snapshotTest", 123, nullptr);
+            const ValueTree::Snapshot s2 (v1.createSnapshot());
+
+            // the old snapshot is unaffected by the change..
+            expect (s1 != s2);
+            expect (s1.createValueTree().isEquivalentTo (original));
+            expect (! s1.getChild (numChildren - 1).hasProperty ("snapshotTest"));
+            expect ((int) s2.getChild (numChildren - 1)["snapshotTest"] == 123);
+
+            // ..and the unchanged subtrees are shared between the two versions
+            expect (s1.getChild (0) == s2.getChild (0));
+            expect (s1.getChild (numChildren - 1) != s2.getChild (numChildren - 1));
+
+            v1.removeChild (0, nullptr);
+            expect (v1.createSnapshot().getNumChildren() == numChildren - 1);
+            expect (s2.getNumChildren() == numChildren);
+            expect (v1.createSnapshot().createValueTree().isEquivalentTo (v1));
+        }
+
+        expect (! ValueTree().createSnapshot().isValid());
+
+        beginTest ("Batched notifications");
+
+        {
+            ValueTree root ("root"), child ("child"), other ("other");
+            root.addChild (child, -1, nullptr);
+
+            CountingListener listener;
+            root.addListener (&listener);
+
+            {
+                const ValueTree::ScopedNotificationBatch batch (root);
+
+                for (int i = 0; i < 100; ++i)
+                {
+                    child.setProperty ("a", i, nullptr);
+                    root.setProperty ("b", i, nullptr);
+                }
+
+                {
+                    const ValueTree::ScopedNotificationBatch nestedBatch (child);
+                    child.setProperty ("c", 1, nullptr);
+                }
+
+                root.addChild (other, -1, nullptr);
+                root.moveChild (0, 1, nullptr);
+                root.moveChild (0, 1, nullptr);
+                root.removeChild (other, nullptr);
+
+                expectEquals (listener.numPropertyChanges, 0);
+                expectEquals (listener.numChildAdditions + listener.numChildRemovals + listener.numReorders, 0);
+            }
+
+            expectEquals (listener.numPropertyChanges, 3);
+            expectEquals (listener.numChildAdditions, 1);
+            expectEquals (listener.numChildRemovals, 1);
+            expectEquals (listener.numReorders, 1);
+            expect ((int) child["a"] == 99 && (int) root["b"] == 99);
+
+            child.setProperty ("a", 0, nullptr);
+            expectEquals (listener.numPropertyChanges, 4);
+
+            root.removeListener (&listener);
+        }
+
+        beginTest ("Undo memory and spilling");
+
+        {
+            ValueTree v ("root");
+            UndoManager um (1, 1);
+
+            // consecutive changes to a property collapse into one action..
+            um.beginNewTransaction();
+            v.setProperty ("a", 1, &um);
+            v.setProperty ("a", 2, &um);
+            v.setProperty ("a", 3, &um);
+            expectEquals (um.getNumActionsInCurrentTransaction(), 1);
+            um.undo();
+            expect (! v.hasProperty ("a"));
+
+            v.setProperty ("b", 1, nullptr);
+            um.beginNewTransaction();
+            v.removeProperty ("b", &um);
+            v.setProperty ("b", 2, &um);
+            v.setProperty ("b", 3, &um);
+            expectEquals (um.getNumActionsInCurrentTransaction(), 1);
+            um.undo();
+            expect ((int) v["b"] == 1);
+
+            // ..and the size reported grows with the data being held
+            um.beginNewTransaction();
+            v.setProperty ("big", String::repeatedString ("x", 10000), &um);
+            expect (um.getNumberOfUnitsTakenUpByStoredCommands() > 10000);
+
+            um.clearUndoHistory();
+            const File spillFile (File::getSpecialLocation (File::tempDirectory).getNonexistentChildFile ("undo", ".tmp"));
+            um.setSpillFile (spillFile);
+            um.setMaxNumberOfStoredUnits (50000, 2);
+
+            for (int i = 0; i < 20; ++i)
+            {
+                um.beginNewTransaction();
+                v.setProperty ("big", String (i) + String::repeatedString ("x", 5000), &um);
+            }
+
+            expect (um.getNumSpilledTransactions() > 0);
+            expect (um.getNumberOfUnitsTakenUpByStoredCommands() <= 50000);
+            expect (spillFile.getSize() > 0 && spillFile.getSize() < 20 * 5000);
+
+            while (um.canUndo())
+                expect (um.undo());
+
+            expect (v["big"].toString() == String::repeatedString ("x", 10000));
+            expectEquals (um.getNumSpilledTransactions(), 0);
+
+            while (um.canRedo())
+                expect (um.redo());
+
+            expect (v["big"].toString().startsWith ("19"));
+
+            um.clearUndoHistory();
+            expect (! spillFile.exists());
+        }
     }
+
+    struct CountingListener  : public ValueTree::Listener
+    {
+        CountingListener() : numPropertyChanges (0), numChildAdditions (0), numChildRemovals (0), numReorders (0) {}
+
+        void valueTreePropertyChanged (ValueTree&, const Identifier&)   { ++numPropertyChanges; }
+        void valueTreeChildAdded (ValueTree&, ValueTree&)               { ++numChildAdditions; }
+        void valueTreeChildRemoved (ValueTree&, ValueTree&)             { ++numChildRemovals; }
+        void valueTreeChildOrderChanged (ValueTree&)                    { ++numReorders; }
+        void valueTreeParentChanged (ValueTree&)                        {}
+
+        int numPropertyChanges, numChildAdditions, numChildRemovals, numReorders;
+    };
 };
 
 static ValueTreeTests valueTreeTests;
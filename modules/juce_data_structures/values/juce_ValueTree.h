@@ -330,6 +330,10 @@ public:
 
         This isn't designed to cope with random XML data - for a sensible result, it should only
         be fed XML that was created by the createXml() method.
+
+        To build a big tree with fewer allocations, you can create a
+        MemoryArena::ScopedUse around the call, so that the nodes and their properties
+        are allocated in a few large blocks rather than one by one.
     */
     static ValueTree fromXml (const XmlElement& xml);
 
@@ -348,7 +352,13 @@ public:
     */
     void writeToStream (OutputStream& output) const;
 
-    /** Reloads a tree from a stream that was written with writeToStream(). */
+    /** Reloads a tree from a stream that was written with writeToStream().
+
+        To load a big tree with fewer allocations, you can create a
+        MemoryArena::ScopedUse around the call, so that the nodes and their properties
+        are allocated in a few large blocks rather than one by one.
+        @see MemoryArena
+    */
     static ValueTree readFromStream (InputStream& input);
 
     /** Reloads a tree from a data block that was written with writeToStream(). */
@@ -359,6 +369,197 @@ public:
     */
     static ValueTree readFromGZIPData (const void* data, size_t numBytes);
 
+    //==============================================================================
+    /** Stores this tree (and all its children) in an indexed binary format.
+
+        This format stores each identifier just once, in a table at the start of the
+        data, and records the size of each node's block of children, so that a reader
+        can skip over a subtree without decoding it. A tree loaded with one of the
+        readFromIndexed methods only decodes the children of each node when they're
+        first used, which makes opening a big file much quicker if you only look at
+        part of it.
+
+        The data starts with a magic number and version number, and can't be read
+        with readFromStream().
+
+        @see readFromIndexedStream, readFromIndexedData, readFromIndexedFile
+    */
+    void writeToIndexedStream (OutputStream& output) const;
+
+    /** Reloads a tree from a stream that was written with writeToIndexedStream().
+        The rest of the stream is read into memory, and the tree's children are
+        decoded from it as they're needed.
+        Returns an invalid tree if the data isn't in the right format.
+    */
+    static ValueTree readFromIndexedStream (InputStream& input);
+
+    /** Reloads a tree from a data block that was written with writeToIndexedStream().
+        The data is copied, so the block doesn't need to stay valid after this returns.
+        Returns an invalid tree if the data isn't in the right format.
+    */
+    static ValueTree readFromIndexedData (const void* data, size_t numBytes);
+
+    /** Reloads a tree from a file that was written with writeToIndexedStream().
+
+        If useMemoryMapping is true, the file is mapped into memory with a MemoryMappedFile
+        rather than being read in, so only the parts of it that get used are actually
+        paged in from disk. The mapping is held open until all the nodes that were loaded
+        from it have either been deleted or had their children decoded, so you shouldn't
+        modify the file while the tree is in use.
+
+        Returns an invalid tree if the file can't be read or isn't in the right format.
+    */
+    static ValueTree readFromIndexedFile (const File& file, bool useMemoryMapping = true);
+
+    //==============================================================================
+   #ifndef DOXYGEN
+    class SharedObject;
+    class SnapshotObject;
+    class PendingNotifications;
+   #endif
+
+    /**
+        An immutable, read-only copy of the state of a ValueTree at a particular moment.
+
+        Use ValueTree::createSnapshot() to get one of these, and then hand it to a
+        background thread (e.g. for saving, rendering or analysis). Because a snapshot
+        can never change, any number of threads can read it at the same time without
+        any locking, while the original tree carries on being edited.
+
+        Snapshots are cheap to take: a tree keeps hold of the last snapshot that was
+        made of each of its nodes, so taking a snapshot of a tree that hasn't changed
+        just returns the previous one, and after an edit, only the nodes between the
+        change and the root need to be rebuilt - all other subtrees are shared with
+        the previous snapshot. This also means that operator== can be used to quickly
+        find out whether a subtree has changed between two snapshots.
+
+        Copying a Snapshot object is just a reference-count increment, but like any other
+        object, a single Snapshot variable mustn't be assigned by one thread while another
+        one is reading it, so pass them between threads by value, or use a lock or FIFO.
+
+        @see ValueTree::createSnapshot
+    */
+    class JUCE_API  Snapshot
+    {
+    public:
+        /** Creates an invalid snapshot. */
+        Snapshot() noexcept;
+        /** Creates another reference to the same snapshot. */
+        Snapshot (const Snapshot& other) noexcept;
+        /** Makes this refer to the same snapshot as another one. */
+        Snapshot& operator= (const Snapshot& other) noexcept;
+        /** Destructor. */
+        ~Snapshot();
+
+        /** Returns true if both refer to the same version of the same node.
+            If this returns true, the two are guaranteed to contain identical data; if
+            it returns false, they may or may not.
+        */
+        bool operator== (const Snapshot& other) const noexcept;
+        /** Returns true if the two objects don't refer to the same version of the same node. */
+        bool operator!= (const Snapshot& other) const noexcept;
+
+        /** Returns false if this was taken of an invalid tree, or is an out-of-range child. */
+        bool isValid() const noexcept;
+
+        /** Returns the type of the node. @see ValueTree::getType */
+        Identifier getType() const;
+        /** Returns true if the node has this type. @see ValueTree::hasType */
+        bool hasType (const Identifier typeName) const;
+
+        /** Returns the value of a named property, or a void variant if it isn't there. */
+        const var& getProperty (const Identifier name) const;
+        /** Returns the value of a named property, or a default value if it isn't there. */
+        var getProperty (const Identifier name, const var& defaultReturnValue) const;
+        /** Returns the value of a named property, or a void variant if it isn't there. */
+        const var& operator[] (const Identifier name) const;
+        /** Returns true if the node contains a named property. */
+        bool hasProperty (const Identifier name) const;
+        /** Returns the total number of properties that the node contains. */
+        int getNumProperties() const;
+        /** Returns the identifier of the property with a given index. */
+        Identifier getPropertyName (int index) const;
+
+        /** Returns the number of child nodes. */
+        int getNumChildren() const;
+        /** Returns one of the child nodes, or an invalid snapshot if the index is out of range. */
+        Snapshot getChild (int index) const;
+        /** Returns the first child node with the specified type, or an invalid snapshot. */
+        Snapshot getChildWithName (const Identifier type) const;
+        /** Returns the first child node that has a property with the given value, or an invalid snapshot. */
+        Snapshot getChildWithProperty (const Identifier propertyName, const var& propertyValue) const;
+
+        /** Creates a new, editable ValueTree containing the data in this snapshot.
+            This can be used to restore a tree to an earlier state.
+        */
+        ValueTree createValueTree() const;
+
+    private:
+        friend class ValueTree;
+        ReferenceCountedObjectPtr<SnapshotObject> object;
+
+        explicit Snapshot (SnapshotObject*) noexcept;
+    };
+
+    /** Returns an immutable snapshot of the current state of this tree.
+
+        This must be called on the thread that modifies the tree (normally the message
+        thread), but the snapshot that it returns can be read from any thread.
+
+        @see Snapshot
+    */
+    Snapshot createSnapshot() const;
+
+    //==============================================================================
+    /**
+        Holds back the listener callbacks for a tree while it's being changed, and then
+        sends them all together.
+
+        Create one of these on the stack before making a lot of changes to a tree, e.g.
+        when loading a preset. While it exists, any changes made to the tree or to any of
+        its sub-trees don't call their listeners immediately; instead the notifications are
+        collected, and when the ScopedNotificationBatch is deleted they're sent in the order
+        in which they happened. Repeated changes to the same property are only notified once,
+        as are repeated re-orderings of the same node's children, so a listener that would
+        otherwise have been called thousands of times may only be called a handful of times.
+
+        By the time a listener is called, the tree will already have all of the changes
+        in the batch applied to it.
+
+        If a batch is already active for the tree or one of its parents, creating another
+        one has no effect, and its notifications are sent when the outer one ends.
+
+        @code
+        {
+            ValueTree::ScopedNotificationBatch batch (myTree);
+            loadAllThosePropertiesInto (myTree);
+
+        } // all the listeners get called here
+        @endcode
+    */
+    class JUCE_API  ScopedNotificationBatch
+    {
+    public:
+        /** Starts collecting notifications for the given tree and all of its sub-trees.
+
+            @param tree                     the tree to batch the notifications for
+            @param deliverAsynchronously    if false, the notifications are sent by the destructor;
+                                            if true, the destructor posts a message, and the
+                                            notifications are sent later on the message thread
+        */
+        explicit ScopedNotificationBatch (const ValueTree& tree, bool deliverAsynchronously = false);
+
+        /** Sends (or posts) all the notifications that have been collected. */
+        ~ScopedNotificationBatch();
+
+    private:
+        const ReferenceCountedObjectPtr<SharedObject> object;
+        ScopedPointer<PendingNotifications> pending;
+        const bool deliverAsynchronously;
+
+        JUCE_DECLARE_NON_COPYABLE (ScopedNotificationBatch)
+    };
+
     //==============================================================================
     /** Listener class for events that happen to a ValueTree.
 
@@ -495,8 +696,8 @@ public:
 
 private:
     //==============================================================================
-    class SharedObject;
     friend class SharedObject;
+    class IndexedSource;
 
     ReferenceCountedObjectPtr<SharedObject> object;
     ListenerList<Listener> listeners;
@@ -520,6 +721,7 @@ private:
     void reorderChildren (const OwnedArray<ValueTree>&, UndoManager*);
 
     explicit ValueTree (SharedObject*);
+    static ValueTree readFromIndexedSource (IndexedSource*);
 };
 
 
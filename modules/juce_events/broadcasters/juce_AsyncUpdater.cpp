@@ -22,18 +22,21 @@
   ==============================================================================
 */
 
-class AsyncUpdater::AsyncUpdaterMessage  : public CallbackMessage
+class AsyncUpdater::AsyncUpdaterMessage  : public ReferenceCountedObject
 {
 public:
-    AsyncUpdaterMessage (AsyncUpdater& au)  : owner (au) {}
+    AsyncUpdaterMessage (AsyncUpdater& au)  : nextInQueue (nullptr), owner (au) {}
 
-    void messageCallback()
+    void deliver()
     {
         if (shouldDeliver.compareAndSetBool (0, 1))
             owner.handleAsyncUpdate();
     }
 
-    Atomic<int> shouldDeliver;
+    Atomic<int> shouldDeliver, isQueued, isFrameAligned;
+    AsyncUpdaterMessage* nextInQueue;
+
+    typedef ReferenceCountedObjectPtr<AsyncUpdaterMessage> Ptr;
 
 private:
     AsyncUpdater& owner;
@@ -41,6 +44,133 @@ private:
     JUCE_DECLARE_NON_COPYABLE (AsyncUpdaterMessage)
 };
 
+//==============================================================================
+/*  Rather than each updater posting its own message, triggered updaters are pushed
+    onto a lock-free list, and the message thread delivers the whole list at once.
+    Only the first updater to arrive on an empty list needs to post a message, so
+    however many updaters fire between two turns of the event loop, it only has to
+    dispatch one message for them.
+*/
+class AsyncUpdater::PendingList
+{
+public:
+    PendingList (const bool postsMessages)  : shouldPostMessages (postsMessages) {}
+
+    ~PendingList()
+    {
+        // (anything left in here at shutdown just gets released)
+        for (AsyncUpdaterMessage* m = head.exchange (nullptr); m != nullptr;)
+        {
+            AsyncUpdaterMessage* const next = m->nextInQueue;
+            m->decReferenceCount();
+            m = next;
+        }
+    }
+
+    void add (AsyncUpdaterMessage* const m)
+    {
+        if (! m->isQueued.compareAndSetBool (1, 0))
+            return; // (already waiting in one of the lists)
+
+        m->incReferenceCount();
+
+        for (;;)
+        {
+            AsyncUpdaterMessage* const oldHead = head.get();
+            m->nextInQueue = oldHead;
+
+            if (head.compareAndSetBool (m, oldHead))
+                break;
+        }
+
+        if (shouldPostMessages)
+            postDispatchMessageIfNeeded();
+    }
+
+    void dispatch()
+    {
+        // Take the whole list, and reverse it so that the callbacks happen in the same order
+        // as the triggers did..
+        AsyncUpdaterMessage* list = nullptr;
+
+        for (AsyncUpdaterMessage* m = head.exchange (nullptr); m != nullptr;)
+        {
+            AsyncUpdaterMessage* const next = m->nextInQueue;
+            m->nextInQueue = list;
+            list = m;
+            m = next;
+        }
+
+        while (list != nullptr)
+        {
+            const AsyncUpdaterMessage::Ptr m (list);
+            list->decReferenceCount();
+            list = list->nextInQueue;
+
+            // (this must be cleared before delivering, so that a trigger that arrives during
+            // the callback will queue the updater again)
+            m->isQueued = 0;
+            m->deliver();
+        }
+    }
+
+private:
+    class DispatchMessage  : public CallbackMessage
+    {
+    public:
+        DispatchMessage (PendingList& l) noexcept : list (l), hasBeenDelivered (false) {}
+
+        ~DispatchMessage()
+        {
+            // If the message was thrown away without being delivered, the next
+            // trigger will have to post another one.
+            if (! hasBeenDelivered)
+                list.isMessagePosted = 0;
+        }
+
+        void messageCallback()
+        {
+            hasBeenDelivered = true;
+            list.isMessagePosted = 0;
+            list.dispatch();
+        }
+
+    private:
+        PendingList& list;
+        bool hasBeenDelivered;
+
+        JUCE_DECLARE_NON_COPYABLE (DispatchMessage)
+    };
+
+    Atomic<AsyncUpdaterMessage*> head;
+    Atomic<int> isMessagePosted, lastPostTime;
+    const bool shouldPostMessages;
+
+    void postDispatchMessageIfNeeded()
+    {
+        const int now = (int) Time::getMillisecondCounter();
+        const int lastPost = lastPostTime.get();
+
+        // Some hosts' modal loops can silently drop messages without deleting them, so if the
+        // message has been outstanding for a long time, another one gets sent (at most once
+        // a second) in case the list has got stuck.
+        if (isMessagePosted.compareAndSetBool (1, 0)
+             || (now - lastPost > 1000 && lastPostTime.compareAndSetBool (now, lastPost)))
+        {
+            lastPostTime = now;
+            (new DispatchMessage (*this))->post();
+        }
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (PendingList)
+};
+
+AsyncUpdater::PendingList& AsyncUpdater::getPendingList (const bool frameAligned)
+{
+    static PendingList immediateList (true), frameAlignedList (false);
+    return frameAligned ? frameAlignedList : immediateList;
+}
+
 //==============================================================================
 AsyncUpdater::AsyncUpdater()
 {
@@ -61,7 +191,7 @@ AsyncUpdater::~AsyncUpdater()
 void AsyncUpdater::triggerAsyncUpdate()
 {
     if (message->shouldDeliver.compareAndSetBool (1, 0))
-        message->post();
+        getPendingList (message->isFrameAligned.get() != 0).add (message);
 }
 
 void AsyncUpdater::cancelPendingUpdate() noexcept
@@ -82,3 +212,16 @@ bool AsyncUpdater::isUpdatePending() const noexcept
 {
     return message->shouldDeliver.value != 0;
 }
+
+void AsyncUpdater::setFrameAligned (const bool shouldWaitForFrame) noexcept
+{
+    message->isFrameAligned = shouldWaitForFrame ? 1 : 0;
+}
+
+void AsyncUpdater::dispatchFrameAlignedUpdates()
+{
+    // This can only be called by the event thread.
+    jassert (MessageManager::getInstance()->currentThreadHasLockedMessageManager());
+
+    getPendingList (true).dispatch();
+}
@@ -35,6 +35,11 @@
 
     Basically, one or more calls to the triggerAsyncUpdate() will result in the
     message thread calling handleAsyncUpdate() as soon as it can.
+
+    All the updaters that are triggered between two turns of the event loop share a
+    single message, and get their callbacks one after the other when it arrives, in
+    the order in which they were triggered - so it's fine to have thousands of them
+    firing at once without flooding the OS's message queue.
 */
 class JUCE_API  AsyncUpdater
 {
@@ -88,6 +93,25 @@ public:
     /** Returns true if there's an update callback in the pipeline. */
     bool isUpdatePending() const noexcept;
 
+    //==============================================================================
+    /** Makes this updater's callbacks wait for the next frame, rather than happening
+        as soon as possible.
+
+        A frame-aligned updater's callback is only delivered when something on the
+        message thread calls dispatchFrameAlignedUpdates(), which would normally be done
+        once per frame by whatever is driving the display, e.g. a Timer running at the
+        screen's refresh rate. This lets things that only need to be redrawn do all their
+        updating in one burst per frame. Nothing will ever be delivered if nobody calls
+        dispatchFrameAlignedUpdates(), so don't use this unless you know that something is!
+    */
+    void setFrameAligned (bool shouldWaitForFrame) noexcept;
+
+    /** Delivers the callbacks for all the frame-aligned updaters that have been triggered.
+        This must only be called on the message thread.
+        @see setFrameAligned
+    */
+    static void dispatchFrameAlignedUpdates();
+
     //==============================================================================
     /** Called back to do whatever your class needs to do.
 
@@ -99,9 +123,12 @@ public:
 private:
     //==============================================================================
     class AsyncUpdaterMessage;
+    class PendingList;
     friend class ReferenceCountedObjectPtr<AsyncUpdaterMessage>;
     ReferenceCountedObjectPtr<AsyncUpdaterMessage> message;
 
+    static PendingList& getPendingList (bool frameAligned);
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AsyncUpdater)
 };
 
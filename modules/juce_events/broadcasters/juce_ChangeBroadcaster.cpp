@@ -23,6 +23,7 @@
 */
 
 ChangeBroadcaster::ChangeBroadcaster() noexcept
+    : batchDepth (0), batchedMessagePending (false)
 {
     callback.owner = this;
 }
@@ -31,13 +32,13 @@ ChangeBroadcaster::~ChangeBroadcaster()
 {
 }
 
-void ChangeBroadcaster::addChangeListener (ChangeListener* const listener)
+void ChangeBroadcaster::addChangeListener (ChangeListener* const listener, const int priority)
 {
     // Listeners can only be safely added when the event thread is locked
     // You can  use a MessageManagerLock if you need to call this from another thread.
     jassert (MessageManager::getInstance()->currentThreadHasLockedMessageManager());
 
-    changeListeners.add (listener);
+    changeListeners.add (listener, priority);
 }
 
 void ChangeBroadcaster::removeChangeListener (ChangeListener* const listener)
@@ -70,7 +71,11 @@ void ChangeBroadcaster::sendSynchronousChangeMessage()
     jassert (MessageManager::getInstance()->isThisTheMessageThread());
 
     callback.cancelPendingUpdate();
-    callListeners();
+
+    if (batchDepth > 0)
+        batchedMessagePending = true;
+    else
+        callListeners();
 }
 
 void ChangeBroadcaster::dispatchPendingMessages()
@@ -83,6 +88,27 @@ void ChangeBroadcaster::callListeners()
     changeListeners.call (&ChangeListener::changeListenerCallback, this);
 }
 
+//==============================================================================
+ChangeBroadcaster::ScopedBatch::ScopedBatch (ChangeBroadcaster& b) noexcept
+    : broadcaster (b)
+{
+    // This can only be used by the event thread.
+    jassert (MessageManager::getInstance()->isThisTheMessageThread());
+
+    ++broadcaster.batchDepth;
+}
+
+ChangeBroadcaster::ScopedBatch::~ScopedBatch()
+{
+    jassert (broadcaster.batchDepth > 0);
+
+    if (--broadcaster.batchDepth == 0 && broadcaster.batchedMessagePending)
+    {
+        broadcaster.batchedMessagePending = false;
+        broadcaster.sendSynchronousChangeMessage();
+    }
+}
+
 //==============================================================================
 ChangeBroadcaster::ChangeBroadcasterCallback::ChangeBroadcasterCallback()
     : owner (nullptr)
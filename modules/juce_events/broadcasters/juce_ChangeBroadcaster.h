@@ -26,7 +26,7 @@
 #define __JUCE_CHANGEBROADCASTER_JUCEHEADER__
 
 #include "juce_ChangeListener.h"
-#include "juce_ListenerList.h"
+#include "juce_PrioritisedListenerList.h"
 #include "juce_AsyncUpdater.h"
 
 
@@ -34,6 +34,10 @@
 /**
     Holds a list of ChangeListeners, and sends messages to them when instructed.
 
+    The listeners are kept in a PrioritisedListenerList, so they can be given priorities,
+    and they can safely add or remove listeners (or delete the broadcaster) from inside
+    their callbacks.
+
     @see ChangeListener
 */
 class JUCE_API  ChangeBroadcaster
@@ -48,9 +52,11 @@ public:
 
     //==============================================================================
     /** Registers a listener to receive change callbacks from this broadcaster.
+
+        Listeners with a higher priority are called before those with a lower one.
         Trying to add a listener that's already on the list will have no effect.
     */
-    void addChangeListener (ChangeListener* listener);
+    void addChangeListener (ChangeListener* listener, int priority = 0);
 
     /** Unregisters a listener from the list.
         If the listener isn't on the list, this won't have any effect.
@@ -85,6 +91,33 @@ public:
     */
     void dispatchPendingMessages();
 
+    //==============================================================================
+    /** Merges the synchronous change messages that a broadcaster sends while this exists.
+
+        While a ScopedBatch exists, calling sendSynchronousChangeMessage() on its broadcaster
+        doesn't call the listeners straight away. Instead, if any messages were sent, the
+        listeners get a single callback when the last ScopedBatch for that broadcaster is
+        deleted. This saves calling a long list of listeners over and over again while a
+        series of changes is being made.
+
+        Asynchronous messages aren't affected, as they already get merged together. These
+        objects must only be used on the message thread, and mustn't outlive their broadcaster.
+    */
+    class JUCE_API  ScopedBatch
+    {
+    public:
+        /** Starts holding back the broadcaster's synchronous messages. */
+        explicit ScopedBatch (ChangeBroadcaster& broadcaster) noexcept;
+
+        /** Sends one synchronous message if any were held back. */
+        ~ScopedBatch();
+
+    private:
+        ChangeBroadcaster& broadcaster;
+
+        JUCE_DECLARE_NON_COPYABLE (ScopedBatch)
+    };
+
 private:
     //==============================================================================
     class ChangeBroadcasterCallback  : public AsyncUpdater
@@ -98,7 +131,9 @@ private:
 
     friend class ChangeBroadcasterCallback;
     ChangeBroadcasterCallback callback;
-    ListenerList <ChangeListener> changeListeners;
+    PrioritisedListenerList <ChangeListener> changeListeners;
+    int batchDepth;
+    bool batchedMessagePending;
 
     void callListeners();
 
@@ -0,0 +1,465 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_PRIORITISEDLISTENERLIST_JUCEHEADER__
+#define __JUCE_PRIORITISEDLISTENERLIST_JUCEHEADER__
+
+
+//==============================================================================
+/**
+    A list of listeners which are called in order of priority, and which copes with
+    any changes that are made to the list while it's calling them.
+
+    This is used in the same way as a ListenerList, but:
+    - Each listener can be given a priority when it's added. Listeners with higher
+      priorities are called first. Listeners with the same priority are called in
+      the same order that a ListenerList would use, i.e. the most recently added first.
+    - A listener that's removed during a callback is never called after that, and
+      a listener that's added during a callback won't be called until the next time
+      the list is called. Every other listener gets called exactly once, whatever
+      is added or removed while the list is being iterated.
+    - If the list itself is deleted by one of its callbacks, the call will stop
+      without touching it, so you don't need a bail-out checker for that. (Bail-out
+      checkers can still be used to stop for other reasons).
+    - Calling the listeners never allocates any memory.
+
+    Rather than shuffling the array while it's being iterated, removed listeners are
+    just marked as empty, and listeners that are added get stamped with a generation
+    number which tells the running iterations to skip them. The list is tidied up
+    when the outermost call has finished.
+
+    Like a ListenerList, this isn't thread-safe, so all the changes and calls must
+    happen on the same thread.
+
+    @see ListenerList, ChangeBroadcaster
+*/
+template <class ListenerClass>
+class PrioritisedListenerList
+{
+    // Horrible macros required to support VC7..
+    #ifndef DOXYGEN
+     #if JUCE_VC8_OR_EARLIER
+       #define PLL_TEMPLATE(a)   typename P##a, typename Q##a
+       #define PLL_PARAM(a)      Q##a& param##a
+     #else
+       #define PLL_TEMPLATE(a)   typename P##a
+       #define PLL_PARAM(a)      PARAMETER_TYPE(P##a) param##a
+     #endif
+    #endif
+
+    struct Entry;
+    struct IterationState;
+
+public:
+    //==============================================================================
+    /** Creates an empty list. */
+    PrioritisedListenerList() noexcept
+        : numListeners (0), generation (0), activeIterations (nullptr), needsTidying (false)
+    {
+    }
+
+    /** Destructor. */
+    ~PrioritisedListenerList()
+    {
+        // if this is being deleted by one of its own callbacks, the calls that are
+        // running need to know not to touch it again..
+        for (IterationState* i = activeIterations; i != nullptr; i = i->previous)
+            i->listWasDeleted = true;
+    }
+
+    //==============================================================================
+    /** Adds a listener to the list.
+
+        Listeners with a higher priority are called before those with a lower one.
+        A listener can only be added once, so if the listener is already in the list,
+        this method has no effect (and its priority isn't changed).
+
+        @see remove
+    */
+    void add (ListenerClass* const listenerToAdd, const int priority = 0)
+    {
+        // Listeners can't be null pointers!
+        jassert (listenerToAdd != nullptr);
+
+        if (listenerToAdd == nullptr || contains (listenerToAdd))
+            return;
+
+        const Entry entry = { listenerToAdd, priority, ++generation };
+
+        if (activeIterations != nullptr)
+        {
+            // (the running calls iterate by index, so it has to go on the end for now)
+            entries.add (entry);
+            needsTidying = true;
+        }
+        else
+        {
+            int insertIndex = 0;
+
+            while (insertIndex < entries.size() && entries.getReference (insertIndex).priority > priority)
+                ++insertIndex;
+
+            entries.insert (insertIndex, entry);
+        }
+
+        ++numListeners;
+    }
+
+    /** Removes a listener from the list.
+        If the listener wasn't in the list, this has no effect.
+    */
+    void remove (ListenerClass* const listenerToRemove)
+    {
+        // Listeners can't be null pointers!
+        jassert (listenerToRemove != nullptr);
+
+        const int index = indexOf (listenerToRemove);
+
+        if (index >= 0)
+        {
+            if (activeIterations != nullptr)
+            {
+                entries.getReference (index).listener = nullptr;
+                needsTidying = true;
+            }
+            else
+            {
+                entries.remove (index);
+            }
+
+            --numListeners;
+        }
+    }
+
+    /** Returns the number of registered listeners. */
+    int size() const noexcept                                   { return numListeners; }
+
+    /** Returns true if any listeners are registered. */
+    bool isEmpty() const noexcept                               { return numListeners == 0; }
+
+    /** Clears the list. */
+    void clear()
+    {
+        if (activeIterations != nullptr)
+        {
+            for (int i = entries.size(); --i >= 0;)
+                entries.getReference (i).listener = nullptr;
+
+            needsTidying = true;
+        }
+        else
+        {
+            entries.clear();
+        }
+
+        numListeners = 0;
+    }
+
+    /** Returns true if the specified listener has been added to the list. */
+    bool contains (ListenerClass* const listener) const noexcept
+    {
+        return listener != nullptr && indexOf (listener) >= 0;
+    }
+
+    //==============================================================================
+    /** Calls a member function on each listener in the list, with no parameters. */
+    void call (void (ListenerClass::*callbackFunction) ())
+    {
+        callChecked (static_cast <const DummyBailOutChecker&> (DummyBailOutChecker()), callbackFunction);
+    }
+
+    /** Calls a member function on each listener in the list, with no parameters and a bail-out-checker.
+        See the ListenerList notes for info about writing a bail-out checker. */
+    template <class BailOutCheckerType>
+    void callChecked (const BailOutCheckerType& bailOutChecker,
+                      void (ListenerClass::*callbackFunction) ())
+    {
+        for (Iterator<BailOutCheckerType> iter (*this, bailOutChecker); iter.next();)
+            (iter.getListener()->*callbackFunction) ();
+    }
+
+    //==============================================================================
+    /** Calls a member function on each listener in the list, with 1 parameter. */
+    template <PLL_TEMPLATE(1)>
+    void call (void (ListenerClass::*callbackFunction) (P1), PLL_PARAM(1))
+    {
+        callChecked (static_cast <const DummyBailOutChecker&> (DummyBailOutChecker()), callbackFunction, param1);
+    }
+
+    /** Calls a member function on each listener in the list, with one parameter and a bail-out-checker.
+        See the ListenerList notes for info about writing a bail-out checker. */
+    template <class BailOutCheckerType, PLL_TEMPLATE(1)>
+    void callChecked (const BailOutCheckerType& bailOutChecker,
+                      void (ListenerClass::*callbackFunction) (P1),
+                      PLL_PARAM(1))
+    {
+        for (Iterator<BailOutCheckerType> iter (*this, bailOutChecker); iter.next();)
+            (iter.getListener()->*callbackFunction) (param1);
+    }
+
+    //==============================================================================
+    /** Calls a member function on each listener in the list, with 2 parameters. */
+    template <PLL_TEMPLATE(1), PLL_TEMPLATE(2)>
+    void call (void (ListenerClass::*callbackFunction) (P1, P2),
+               PLL_PARAM(1), PLL_PARAM(2))
+    {
+        callChecked (static_cast <const DummyBailOutChecker&> (DummyBailOutChecker()), callbackFunction, param1, param2);
+    }
+
+    /** Calls a member function on each listener in the list, with 2 parameters and a bail-out-checker.
+        See the ListenerList notes for info about writing a bail-out checker. */
+    template <class BailOutCheckerType, PLL_TEMPLATE(1), PLL_TEMPLATE(2)>
+    void callChecked (const BailOutCheckerType& bailOutChecker,
+                      void (ListenerClass::*callbackFunction) (P1, P2),
+                      PLL_PARAM(1), PLL_PARAM(2))
+    {
+        for (Iterator<BailOutCheckerType> iter (*this, bailOutChecker); iter.next();)
+            (iter.getListener()->*callbackFunction) (param1, param2);
+    }
+
+    //==============================================================================
+    /** Calls a member function on each listener in the list, with 3 parameters. */
+    template <PLL_TEMPLATE(1), PLL_TEMPLATE(2), PLL_TEMPLATE(3)>
+    void call (void (ListenerClass::*callbackFunction) (P1, P2, P3),
+               PLL_PARAM(1), PLL_PARAM(2), PLL_PARAM(3))
+    {
+        callChecked (static_cast <const DummyBailOutChecker&> (DummyBailOutChecker()), callbackFunction, param1, param2, param3);
+    }
+
+    /** Calls a member function on each listener in the list, with 3 parameters and a bail-out-checker.
+        See the ListenerList notes for info about writing a bail-out checker. */
+    template <class BailOutCheckerType, PLL_TEMPLATE(1), PLL_TEMPLATE(2), PLL_TEMPLATE(3)>
+    void callChecked (const BailOutCheckerType& bailOutChecker,
+                      void (ListenerClass::*callbackFunction) (P1, P2, P3),
+                      PLL_PARAM(1), PLL_PARAM(2), PLL_PARAM(3))
+    {
+        for (Iterator<BailOutCheckerType> iter (*this, bailOutChecker); iter.next();)
+            (iter.getListener()->*callbackFunction) (param1, param2, param3);
+    }
+
+    //==============================================================================
+    /** Calls a member function on each listener in the list, with 4 parameters. */
+    template <PLL_TEMPLATE(1), PLL_TEMPLATE(2), PLL_TEMPLATE(3), PLL_TEMPLATE(4)>
+    void call (void (ListenerClass::*callbackFunction) (P1, P2, P3, P4),
+               PLL_PARAM(1), PLL_PARAM(2), PLL_PARAM(3), PLL_PARAM(4))
+    {
+        callChecked (static_cast <const DummyBailOutChecker&> (DummyBailOutChecker()), callbackFunction, param1, param2, param3, param4);
+    }
+
+    /** Calls a member function on each listener in the list, with 4 parameters and a bail-out-checker.
+        See the ListenerList notes for info about writing a bail-out checker. */
+    template <class BailOutCheckerType, PLL_TEMPLATE(1), PLL_TEMPLATE(2), PLL_TEMPLATE(3), PLL_TEMPLATE(4)>
+    void callChecked (const BailOutCheckerType& bailOutChecker,
+                      void (ListenerClass::*callbackFunction) (P1, P2, P3, P4),
+                      PLL_PARAM(1), PLL_PARAM(2), PLL_PARAM(3), PLL_PARAM(4))
+    {
+        for (Iterator<BailOutCheckerType> iter (*this, bailOutChecker); iter.next();)
+            (iter.getListener()->*callbackFunction) (param1, param2, param3, param4);
+    }
+
+    //==============================================================================
+    /** Calls a member function on each listener in the list, with 5 parameters. */
+    template <PLL_TEMPLATE(1), PLL_TEMPLATE(2), PLL_TEMPLATE(3), PLL_TEMPLATE(4), PLL_TEMPLATE(5)>
+    void call (void (ListenerClass::*callbackFunction) (P1, P2, P3, P4, P5),
+               PLL_PARAM(1), PLL_PARAM(2), PLL_PARAM(3), PLL_PARAM(4), PLL_PARAM(5))
+    {
+        callChecked (static_cast <const DummyBailOutChecker&> (DummyBailOutChecker()), callbackFunction, param1, param2, param3, param4, param5);
+    }
+
+    /** Calls a member function on each listener in the list, with 5 parameters and a bail-out-checker.
+        See the ListenerList notes for info about writing a bail-out checker. */
+    template <class BailOutCheckerType, PLL_TEMPLATE(1), PLL_TEMPLATE(2), PLL_TEMPLATE(3), PLL_TEMPLATE(4), PLL_TEMPLATE(5)>
+    void callChecked (const BailOutCheckerType& bailOutChecker,
+                      void (ListenerClass::*callbackFunction) (P1, P2, P3, P4, P5),
+                      PLL_PARAM(1), PLL_PARAM(2), PLL_PARAM(3), PLL_PARAM(4), PLL_PARAM(5))
+    {
+        for (Iterator<BailOutCheckerType> iter (*this, bailOutChecker); iter.next();)
+            (iter.getListener()->*callbackFunction) (param1, param2, param3, param4, param5);
+    }
+
+    //==============================================================================
+    /** Calls a member function on each listener in the list, with 6 parameters. */
+    template <PLL_TEMPLATE(1), PLL_TEMPLATE(2), PLL_TEMPLATE(3), PLL_TEMPLATE(4), PLL_TEMPLATE(5), PLL_TEMPLATE(6)>
+    void call (void (ListenerClass::*callbackFunction) (P1, P2, P3, P4, P5, P6),
+               PLL_PARAM(1), PLL_PARAM(2), PLL_PARAM(3), PLL_PARAM(4), PLL_PARAM(5), PLL_PARAM(6))
+    {
+        callChecked (static_cast <const DummyBailOutChecker&> (DummyBailOutChecker()), callbackFunction, param1, param2, param3, param4, param5, param6);
+    }
+
+    /** Calls a member function on each listener in the list, with 6 parameters and a bail-out-checker.
+        See the ListenerList notes for info about writing a bail-out checker. */
+    template <class BailOutCheckerType, PLL_TEMPLATE(1), PLL_TEMPLATE(2), PLL_TEMPLATE(3), PLL_TEMPLATE(4), PLL_TEMPLATE(5), PLL_TEMPLATE(6)>
+    void callChecked (const BailOutCheckerType& bailOutChecker,
+                      void (ListenerClass::*callbackFunction) (P1, P2, P3, P4, P5, P6),
+                      PLL_PARAM(1), PLL_PARAM(2), PLL_PARAM(3), PLL_PARAM(4), PLL_PARAM(5), PLL_PARAM(6))
+    {
+        for (Iterator<BailOutCheckerType> iter (*this, bailOutChecker); iter.next();)
+            (iter.getListener()->*callbackFunction) (param1, param2, param3, param4, param5, param6);
+    }
+
+    //==============================================================================
+    /** A dummy bail-out checker that always returns false.
+        See the ListenerList notes for more info about bail-out checkers.
+    */
+    class DummyBailOutChecker
+    {
+    public:
+        inline bool shouldBailOut() const noexcept     { return false; }
+    };
+
+    //==============================================================================
+    /** Iterates the listeners in a PrioritisedListenerList.
+
+        While an Iterator exists, changes to the list are deferred as described in the
+        PrioritisedListenerList notes.
+    */
+    template <class BailOutCheckerType>
+    class Iterator
+    {
+    public:
+        //==============================================================================
+        Iterator (PrioritisedListenerList& listToIterate, const BailOutCheckerType& checker) noexcept
+            : list (listToIterate), bailOutChecker (checker),
+              index (-1), lastGeneration (listToIterate.generation)
+        {
+            state.previous = list.activeIterations;
+            state.listWasDeleted = false;
+            list.activeIterations = &state;
+        }
+
+        ~Iterator()
+        {
+            if (! state.listWasDeleted)
+            {
+                // iterations must be nested, so this should be the most recent one..
+                jassert (list.activeIterations == &state);
+                list.activeIterations = state.previous;
+
+                if (state.previous == nullptr && list.needsTidying)
+                    list.tidyUp();
+            }
+        }
+
+        //==============================================================================
+        bool next() noexcept
+        {
+            if (state.listWasDeleted || bailOutChecker.shouldBailOut())
+                return false;
+
+            while (++index < list.entries.size())
+            {
+                const Entry& e = list.entries.getReference (index);
+
+                if (e.listener != nullptr && e.generation <= lastGeneration)
+                    return true;
+            }
+
+            return false;
+        }
+
+        ListenerClass* getListener() const noexcept
+        {
+            return list.entries.getReference (index).listener;
+        }
+
+    private:
+        //==============================================================================
+        PrioritisedListenerList& list;
+        const BailOutCheckerType& bailOutChecker;
+        IterationState state;
+        int index;
+        const uint32 lastGeneration;
+
+        JUCE_DECLARE_NON_COPYABLE (Iterator)
+    };
+
+private:
+    //==============================================================================
+    struct Entry
+    {
+        ListenerClass* listener;
+        int priority;
+        uint32 generation;
+    };
+
+    struct IterationState
+    {
+        IterationState* previous;
+        bool listWasDeleted;
+    };
+
+    Array<Entry> entries;
+    int numListeners;
+    uint32 generation;
+    IterationState* activeIterations;
+    bool needsTidying;
+
+    int indexOf (ListenerClass* const listener) const noexcept
+    {
+        for (int i = entries.size(); --i >= 0;)
+            if (entries.getReference (i).listener == listener)
+                return i;
+
+        return -1;
+    }
+
+    static bool isCalledBefore (const Entry& a, const Entry& b) noexcept
+    {
+        return a.priority > b.priority || (a.priority == b.priority && a.generation > b.generation);
+    }
+
+    void tidyUp()
+    {
+        needsTidying = false;
+
+        // strip out the entries that were removed, and put any that were added into order..
+        int numLeft = 0;
+
+        for (int i = 0; i < entries.size(); ++i)
+        {
+            const Entry e (entries.getReference (i));
+
+            if (e.listener != nullptr)
+            {
+                int j = numLeft++;
+
+                for (; j > 0 && isCalledBefore (e, entries.getReference (j - 1)); --j)
+                    entries.getReference (j) = entries.getReference (j - 1);
+
+                entries.getReference (j) = e;
+            }
+        }
+
+        entries.removeRange (numLeft, entries.size() - numLeft);
+        jassert (numLeft == numListeners);
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (PrioritisedListenerList)
+
+    #undef PLL_TEMPLATE
+    #undef PLL_PARAM
+};
+
+
+#endif   // __JUCE_PRIORITISEDLISTENERLIST_JUCEHEADER__
@@ -28,7 +28,9 @@ InterprocessConnection::InterprocessConnection (const bool callbacksOnMessageThr
       callbackConnectionState (false),
       useMessageThread (callbacksOnMessageThread),
       magicMessageHeader (magicMessageHeaderNumber),
-      pipeReceiveMessageTimeout (-1)
+      pipeReceiveMessageTimeout (-1),
+      multiplexer (nullptr),
+      socketIsMultiplexed (false)
 {
 }
 
@@ -53,7 +55,7 @@ bool InterprocessConnection::connectToSocket (const String& hostName,
     if (socket->connect (hostName, portNumber, timeOutMillisecs))
     {
         connectionMadeInt();
-        startThread();
+        startReadingSocket();
         return true;
     }
     else
@@ -99,6 +101,16 @@ bool InterprocessConnection::createPipe (const String& pipeName, const int timeo
 
 void InterprocessConnection::disconnect()
 {
+    if (multiplexer != nullptr)
+    {
+        // (this has to happen before the socket is closed, and without holding
+        // pipeAndSocketLock, which the multiplexer's threads may be waiting for)
+        multiplexer->removeConnection (*this);
+
+        const ScopedLock sl (pipeAndSocketLock);
+        socketIsMultiplexed = false;
+    }
+
     if (socket != nullptr)
         socket->close();
 
@@ -122,7 +134,18 @@ bool InterprocessConnection::isConnected() const
 
     return ((socket != nullptr && socket->isConnected())
               || (pipe != nullptr && pipe->isOpen()))
-            && isThreadRunning();
+            && (isThreadRunning() || socketIsMultiplexed);
+}
+
+void InterprocessConnection::setMultiplexer (InterprocessConnectionMultiplexer* const newMultiplexer)
+{
+    // You can't change the multiplexer while the connection is active!
+    jassert (! isConnected());
+
+    if (multiplexer != nullptr)
+        multiplexer->removeConnection (*this);
+
+    multiplexer = newMultiplexer;
 }
 
 String InterprocessConnection::getConnectedHostName() const
@@ -148,20 +171,29 @@ bool InterprocessConnection::sendMessage (const MemoryBlock& message)
     messageHeader [0] = ByteOrder::swapIfBigEndian (magicMessageHeader);
     messageHeader [1] = ByteOrder::swapIfBigEndian ((uint32) message.getSize());
 
-    MemoryBlock messageData (sizeof (messageHeader) + message.getSize());
-    messageData.copyFrom (messageHeader, 0, sizeof (messageHeader));
-    messageData.copyFrom (message.getData(), sizeof (messageHeader), message.getSize());
-
+    const int totalSize = (int) (sizeof (messageHeader) + message.getSize());
     int bytesWritten = 0;
 
     const ScopedLock sl (pipeAndSocketLock);
 
     if (socket != nullptr)
-        bytesWritten = socket->write (messageData.getData(), (int) messageData.getSize());
+    {
+        // (the header and data are sent with one call, without copying them into a single block)
+        const SocketBuffer buffers[] = { SocketBuffer (messageHeader, (int) sizeof (messageHeader)),
+                                         SocketBuffer (message.getData(), (int) message.getSize()) };
+
+        bytesWritten = socket->write (buffers, numElementsInArray (buffers));
+    }
     else if (pipe != nullptr)
-        bytesWritten = pipe->write (messageData.getData(), (int) messageData.getSize(), pipeReceiveMessageTimeout);
+    {
+        MemoryBlock messageData ((size_t) totalSize);
+        messageData.copyFrom (messageHeader, 0, sizeof (messageHeader));
+        messageData.copyFrom (message.getData(), sizeof (messageHeader), message.getSize());
+
+        bytesWritten = pipe->write (messageData.getData(), totalSize, pipeReceiveMessageTimeout);
+    }
 
-    return bytesWritten == (int) messageData.getSize();
+    return bytesWritten == totalSize;
 }
 
 //==============================================================================
@@ -170,7 +202,29 @@ void InterprocessConnection::initialiseWithSocket (StreamingSocket* const socket
     jassert (socket == nullptr);
     socket = socket_;
     connectionMadeInt();
-    startThread();
+    startReadingSocket();
+}
+
+void InterprocessConnection::startReadingSocket()
+{
+    const ScopedLock sl (pipeAndSocketLock);
+
+    if (multiplexer != nullptr && multiplexer->addConnection (*this))
+        socketIsMultiplexed = true;
+    else
+        startThread();
+}
+
+void InterprocessConnection::multiplexedSocketClosedInt (const bool notifyListeners)
+{
+    {
+        const ScopedLock sl (pipeAndSocketLock);
+        socketIsMultiplexed = false;
+        socket = nullptr;
+    }
+
+    if (notifyListeners)
+        connectionLostInt();
 }
 
 void InterprocessConnection::initialiseWithPipe (NamedPipe* const pipe_)
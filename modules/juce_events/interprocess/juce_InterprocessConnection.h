@@ -26,6 +26,7 @@
 #define __JUCE_INTERPROCESSCONNECTION_JUCEHEADER__
 
 class InterprocessConnectionServer;
+class InterprocessConnectionMultiplexer;
 class MemoryBlock;
 
 
@@ -133,6 +134,21 @@ public:
     */
     String getConnectedHostName() const;
 
+    /** Makes this connection's socket be serviced by a shared multiplexer, rather
+        than by a thread of its own.
+
+        This must be called before the connection is made - it'll take effect the next
+        time connectToSocket() is called, or when an InterprocessConnectionServer hands
+        it a socket. Pipe connections always use their own thread. Pass nullptr to go
+        back to using a thread. The multiplexer must outlive this connection.
+
+        @see InterprocessConnectionMultiplexer
+    */
+    void setMultiplexer (InterprocessConnectionMultiplexer* multiplexerToUse);
+
+    /** Returns the multiplexer that was set with setMultiplexer(), if any. */
+    InterprocessConnectionMultiplexer* getMultiplexer() const noexcept  { return multiplexer; }
+
     //==============================================================================
     /** Tries to send a message to the other end of this connection.
 
@@ -186,10 +202,15 @@ private:
     const bool useMessageThread;
     const uint32 magicMessageHeader;
     int pipeReceiveMessageTimeout;
+    InterprocessConnectionMultiplexer* multiplexer;
+    bool socketIsMultiplexed;
 
     friend class InterprocessConnectionServer;
+    friend class InterprocessConnectionMultiplexer;
     void initialiseWithSocket (StreamingSocket*);
     void initialiseWithPipe (NamedPipe*);
+    void startReadingSocket();
+    void multiplexedSocketClosedInt (bool notifyListeners);
     void connectionMadeInt();
     void connectionLostInt();
     void deliverDataInt (const MemoryBlock&);
@@ -0,0 +1,664 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+//==============================================================================
+/*  A thin wrapper around whichever mechanism the OS has for waiting on many sockets
+    at once. Each socket is added with a pointer that gets handed back when it has
+    data to read, and wake() interrupts a wait() that's in progress.
+*/
+class InterprocessConnectionMultiplexer::Poller
+{
+public:
+   #if JUCE_LINUX || JUCE_ANDROID || JUCE_MAC || JUCE_IOS
+    Poller()
+    {
+       #if JUCE_LINUX || JUCE_ANDROID
+        handle = epoll_create (64);
+       #else
+        handle = kqueue();
+       #endif
+
+        wakePipe[0] = wakePipe[1] = -1;
+
+        if (handle >= 0 && pipe (wakePipe) == 0)
+        {
+            fcntl (wakePipe[0], F_SETFL, O_NONBLOCK);
+            add (wakePipe[0], nullptr);
+        }
+    }
+
+    ~Poller()
+    {
+        if (wakePipe[0] >= 0)  { close (wakePipe[0]); close (wakePipe[1]); }
+        if (handle >= 0)       close (handle);
+    }
+
+    bool add (const int fd, void* const userData)
+    {
+       #if JUCE_LINUX || JUCE_ANDROID
+        struct epoll_event e;
+        zerostruct (e);
+        e.events = EPOLLIN;
+        e.data.ptr = userData;
+        return epoll_ctl (handle, EPOLL_CTL_ADD, fd, &e) == 0;
+       #else
+        struct kevent e;
+        EV_SET (&e, fd, EVFILT_READ, EV_ADD, 0, 0, userData);
+        return kevent (handle, &e, 1, nullptr, 0, nullptr) == 0;
+       #endif
+    }
+
+    void remove (const int fd)
+    {
+       #if JUCE_LINUX || JUCE_ANDROID
+        struct epoll_event e;  // (older kernels need a non-null pointer here)
+        zerostruct (e);
+        epoll_ctl (handle, EPOLL_CTL_DEL, fd, &e);
+       #else
+        struct kevent e;
+        EV_SET (&e, fd, EVFILT_READ, EV_DELETE, 0, 0, nullptr);
+        kevent (handle, &e, 1, nullptr, 0, nullptr);
+       #endif
+    }
+
+    int wait (void** const ready, const int maxReady, const int timeoutMs)
+    {
+        int numReady = 0;
+
+       #if JUCE_LINUX || JUCE_ANDROID
+        HeapBlock<struct epoll_event> events ((size_t) maxReady);
+        const int num = epoll_wait (handle, events, maxReady, timeoutMs);
+
+        for (int i = 0; i < num; ++i)
+            if (! isWakeEvent (events[i].data.ptr))
+                ready [numReady++] = events[i].data.ptr;
+       #else
+        HeapBlock<struct kevent> events ((size_t) maxReady);
+        struct timespec timeout;
+        timeout.tv_sec  = timeoutMs / 1000;
+        timeout.tv_nsec = (timeoutMs % 1000) * 1000000;
+        const int num = kevent (handle, nullptr, 0, events, maxReady, &timeout);
+
+        for (int i = 0; i < num; ++i)
+            if (! isWakeEvent (events[i].udata))
+                ready [numReady++] = events[i].udata;
+       #endif
+
+        return numReady;
+    }
+
+    void wake()
+    {
+        const char c = 0;
+        ssize_t result = ::write (wakePipe[1], &c, 1);
+        (void) result;
+    }
+
+    bool isValid() const noexcept      { return handle >= 0 && wakePipe[0] >= 0; }
+    static bool isSupported() noexcept { return true; }
+
+private:
+    int handle, wakePipe[2];
+
+    bool isWakeEvent (void* const userData)
+    {
+        if (userData != nullptr)
+            return false;
+
+        char buffer [64];
+        while (::read (wakePipe[0], buffer, sizeof (buffer)) > 0)
+        {}
+
+        return true;
+    }
+
+   #elif JUCE_WINDOWS && ! JUCE_MINGW
+    // WSAPoll has no way of being woken up, so the list is re-read on every call,
+    // and the waits are kept short so that changes are picked up quickly.
+    Poller() {}
+
+    bool add (const int fd, void* const userData)
+    {
+        WSAPOLLFD p;
+        zerostruct (p);
+        p.fd = (SOCKET) fd;
+        p.events = POLLRDNORM;
+
+        const ScopedLock sl (lock);
+        sockets.add (p);
+        userDatas.add (userData);
+        return true;
+    }
+
+    void remove (const int fd)
+    {
+        const ScopedLock sl (lock);
+
+        for (int i = sockets.size(); --i >= 0;)
+        {
+            if (sockets.getReference(i).fd == (SOCKET) fd)
+            {
+                sockets.remove (i);
+                userDatas.remove (i);
+            }
+        }
+    }
+
+    int wait (void** const ready, const int maxReady, const int timeoutMs)
+    {
+        Array<WSAPOLLFD> s;
+        Array<void*> u;
+
+        {
+            const ScopedLock sl (lock);
+            s = sockets;
+            u = userDatas;
+        }
+
+        if (s.size() == 0)
+        {
+            Thread::sleep (jmin (timeoutMs, 20));
+            return 0;
+        }
+
+        int numReady = 0;
+
+        if (WSAPoll (s.getRawDataPointer(), (ULONG) s.size(), jmin (timeoutMs, 20)) > 0)
+            for (int i = 0; i < s.size() && numReady < maxReady; ++i)
+                if (s.getReference(i).revents != 0)
+                    ready [numReady++] = u.getUnchecked(i);
+
+        return numReady;
+    }
+
+    void wake()                        {}
+    bool isValid() const noexcept      { return true; }
+    static bool isSupported() noexcept { return true; }
+
+private:
+    CriticalSection lock;
+    Array<WSAPOLLFD> sockets;
+    Array<void*> userDatas;
+
+   #else
+    bool add (int, void*)                       { return false; }
+    void remove (int)                           {}
+    int wait (void**, int, const int timeoutMs) { Thread::sleep (timeoutMs); return 0; }
+    void wake()                                 {}
+    bool isValid() const noexcept               { return false; }
+    static bool isSupported() noexcept          { return false; }
+   #endif
+
+    JUCE_DECLARE_NON_COPYABLE (Poller)
+};
+
+//==============================================================================
+/*  Passes the messages for one connection to its callbacks using jobs on a ThreadPool.
+    Only one job runs for each queue at a time, so the messages stay in order.
+*/
+class InterprocessConnectionMultiplexer::DeliveryQueue  : public ReferenceCountedObject
+{
+public:
+    DeliveryQueue (InterprocessConnection& c, ThreadPool& p)
+        : owner (&c), connection (&c), pool (p), jobIsActive (false)
+    {
+    }
+
+    bool isFor (const InterprocessConnection& c) const noexcept   { return owner == &c; }
+
+    void addMessage (const MemoryBlock& data)   { addItem (data, false); }
+    void addConnectionLost()                    { addItem (MemoryBlock(), true); }
+
+    // Stops any more callbacks being made, waiting for one that's in progress.
+    void detach()
+    {
+        const ScopedLock sl (callbackLock);
+        const ScopedLock sl2 (lock);
+        connection = nullptr;
+        items.clear();
+    }
+
+    bool deliverNext()
+    {
+        const ScopedLock sl (callbackLock);
+        ScopedPointer<Item> item;
+
+        {
+            const ScopedLock sl2 (lock);
+
+            if (connection == nullptr || items.size() == 0)
+            {
+                jobIsActive = false;
+                return false;
+            }
+
+            item = items.removeAndReturn (0);
+        }
+
+        if (item->isConnectionLost)
+            connection->connectionLostInt();
+        else
+            connection->deliverDataInt (item->data);
+
+        return true;
+    }
+
+    typedef ReferenceCountedObjectPtr<DeliveryQueue> Ptr;
+
+private:
+    struct Item
+    {
+        Item (const MemoryBlock& d, bool lost) : data (d), isConnectionLost (lost) {}
+
+        MemoryBlock data;
+        bool isConnectionLost;
+    };
+
+    CriticalSection lock, callbackLock;
+    const InterprocessConnection* const owner;
+    InterprocessConnection* connection;
+    ThreadPool& pool;
+    OwnedArray<Item> items;
+    bool jobIsActive;
+
+    void addItem (const MemoryBlock& data, const bool isConnectionLost);
+
+    JUCE_DECLARE_NON_COPYABLE (DeliveryQueue)
+};
+
+class InterprocessConnectionMultiplexer::DeliveryJob  : public ThreadPoolJob
+{
+public:
+    DeliveryJob (DeliveryQueue* q)  : ThreadPoolJob ("IPC delivery"), queue (q) {}
+
+    JobStatus runJob()
+    {
+        while (queue->deliverNext())
+            if (shouldExit())
+                return jobNeedsRunningAgain;
+
+        return jobHasFinished;
+    }
+
+private:
+    const DeliveryQueue::Ptr queue;
+
+    JUCE_DECLARE_NON_COPYABLE (DeliveryJob)
+};
+
+void InterprocessConnectionMultiplexer::DeliveryQueue::addItem (const MemoryBlock& data, const bool isConnectionLost)
+{
+    const ScopedLock sl (lock);
+
+    if (connection != nullptr)
+    {
+        items.add (new Item (data, isConnectionLost));
+
+        if (! jobIsActive)
+        {
+            jobIsActive = true;
+            pool.addJob (new DeliveryJob (this), true);
+        }
+    }
+}
+
+//==============================================================================
+class InterprocessConnectionMultiplexer::Entry
+{
+public:
+    Entry (InterprocessConnection* c, InterprocessConnectionServer* s, StreamingSocket& sock)
+        : connection (c), server (s), socket (sock),
+          fd (sock.getRawSocketHandle()),
+          removed (false), headerBytes (0), messageBytes (0)
+    {
+    }
+
+    const void* getOwner() const noexcept
+    {
+        return connection != nullptr ? static_cast<const void*> (connection)
+                                     : static_cast<const void*> (server);
+    }
+
+    InterprocessConnection* const connection;
+    InterprocessConnectionServer* const server;
+    StreamingSocket& socket;
+    const int fd;
+    DeliveryQueue::Ptr deliveryQueue;
+    bool volatile removed;
+
+    uint32 header[2];
+    int headerBytes, messageBytes;
+    MemoryBlock message;
+
+private:
+    JUCE_DECLARE_NON_COPYABLE (Entry)
+};
+
+//==============================================================================
+class InterprocessConnectionMultiplexer::IOThread  : public Thread
+{
+public:
+    IOThread()  : Thread ("Juce IPC multiplexer"), readBuffer ((size_t) readBufferSize)
+    {
+    }
+
+    ~IOThread()
+    {
+        signalThreadShouldExit();
+        poller.wake();
+        stopThread (4000);
+    }
+
+    bool add (Entry* const entry)
+    {
+        const ScopedLock sl (lock);
+        entries.add (entry);
+
+        if (poller.add (entry->fd, entry))
+            return true;
+
+        entries.removeObject (entry);
+        return false;
+    }
+
+    bool remove (const void* const owner)
+    {
+        const ScopedLock sl (callbackLock);
+        const ScopedLock sl2 (lock);
+
+        for (int i = entries.size(); --i >= 0;)
+        {
+            Entry& e = *entries.getUnchecked(i);
+
+            if (e.getOwner() == owner && ! e.removed)
+            {
+                poller.remove (e.fd);
+                e.removed = true;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    int getNumEntries() const
+    {
+        const ScopedLock sl (lock);
+        int num = 0;
+
+        for (int i = entries.size(); --i >= 0;)
+            if (! entries.getUnchecked(i)->removed)
+                ++num;
+
+        return num;
+    }
+
+    bool isValid() const noexcept   { return poller.isValid(); }
+
+    void run()
+    {
+        void* ready [64];
+
+        while (! threadShouldExit())
+        {
+            const int numReady = poller.wait (ready, numElementsInArray (ready), 500);
+
+            const ScopedLock sl (callbackLock);
+
+            for (int i = 0; i < numReady && ! threadShouldExit(); ++i)
+            {
+                Entry& e = *static_cast<Entry*> (ready[i]);
+
+                if (! e.removed)
+                {
+                    if (e.server != nullptr)
+                        e.server->handleIncomingConnectionInt();
+                    else
+                        readFromConnection (e);
+                }
+            }
+
+            deleteRemovedEntries();
+        }
+    }
+
+private:
+    enum { readBufferSize = 65536 };
+
+    Poller poller;
+    CriticalSection lock, callbackLock;
+    OwnedArray<Entry> entries;
+    HeapBlock<char> readBuffer;
+
+    void readFromConnection (Entry& e)
+    {
+        const int numRead = e.socket.read (readBuffer, readBufferSize, false);
+
+        if (numRead <= 0)
+        {
+            socketClosed (e);
+            return;
+        }
+
+        // This splits the data up using the same framing as InterprocessConnection::readNextMessageInt()
+        const char* data = readBuffer;
+        int numLeft = numRead;
+
+        while (numLeft > 0 && ! e.removed)
+        {
+            if (e.headerBytes < (int) sizeof (e.header))
+            {
+                const int num = jmin (numLeft, (int) sizeof (e.header) - e.headerBytes);
+                memcpy (addBytesToPointer (e.header, e.headerBytes), data, (size_t) num);
+                e.headerBytes += num;
+                data += num;
+                numLeft -= num;
+
+                if (e.headerBytes == (int) sizeof (e.header))
+                {
+                    const int messageSize = (int) ByteOrder::swapIfBigEndian (e.header[1]);
+
+                    if (ByteOrder::swapIfBigEndian (e.header[0]) == e.connection->magicMessageHeader
+                         && messageSize > 0)
+                    {
+                        e.message.setSize ((size_t) messageSize, false);
+                        e.messageBytes = 0;
+                    }
+                    else
+                    {
+                        e.headerBytes = 0;
+                    }
+                }
+            }
+            else
+            {
+                const int num = jmin (numLeft, (int) e.message.getSize() - e.messageBytes);
+                e.message.copyFrom (data, e.messageBytes, (size_t) num);
+                e.messageBytes += num;
+                data += num;
+                numLeft -= num;
+
+                if (e.messageBytes == (int) e.message.getSize())
+                {
+                    MemoryBlock m;
+                    m.swapWith (e.message);
+                    e.headerBytes = 0;
+
+                    if (e.deliveryQueue != nullptr)
+                        e.deliveryQueue->addMessage (m);
+                    else
+                        e.connection->deliverDataInt (m);
+                }
+            }
+        }
+    }
+
+    void socketClosed (Entry& e)
+    {
+        poller.remove (e.fd);
+        e.removed = true;
+
+        if (e.connection != nullptr)
+            e.connection->multiplexedSocketClosedInt (e.deliveryQueue == nullptr);
+
+        if (e.deliveryQueue != nullptr)
+            e.deliveryQueue->addConnectionLost();
+    }
+
+    void deleteRemovedEntries()
+    {
+        const ScopedLock sl (lock);
+
+        for (int i = entries.size(); --i >= 0;)
+            if (entries.getUnchecked(i)->removed)
+                entries.remove (i);
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (IOThread)
+};
+
+//==============================================================================
+InterprocessConnectionMultiplexer::InterprocessConnectionMultiplexer (const int numIOThreads,
+                                                                      ThreadPool* const callbackPool)
+    : pool (callbackPool)
+{
+    for (int i = jmax (1, numIOThreads); --i >= 0;)
+    {
+        IOThread* const t = new IOThread();
+        threads.add (t);
+
+        if (t->isValid())
+            t->startThread();
+    }
+}
+
+InterprocessConnectionMultiplexer::~InterprocessConnectionMultiplexer()
+{
+    // You must disconnect or delete all the connections and servers that are
+    // using a multiplexer before deleting it!
+    jassert (getNumSockets() == 0);
+
+    threads.clear();
+}
+
+int InterprocessConnectionMultiplexer::getNumSockets() const
+{
+    int num = 0;
+
+    for (int i = threads.size(); --i >= 0;)
+        num += threads.getUnchecked(i)->getNumEntries();
+
+    return num;
+}
+
+bool InterprocessConnectionMultiplexer::isSupported() noexcept
+{
+    return Poller::isSupported();
+}
+
+//==============================================================================
+bool InterprocessConnectionMultiplexer::addEntry (Entry* const entry)
+{
+    ScopedPointer<Entry> e (entry);
+    IOThread* const t = threads [(int) ((uint32) (++nextThread) % (uint32) threads.size())];
+
+    if (t != nullptr && t->isValid() && t->add (e))
+    {
+        e.release();
+        return true;
+    }
+
+    return false;
+}
+
+void InterprocessConnectionMultiplexer::removeEntry (const void* const owner)
+{
+    for (int i = threads.size(); --i >= 0;)
+        if (threads.getUnchecked(i)->remove (owner))
+            break;
+}
+
+bool InterprocessConnectionMultiplexer::addConnection (InterprocessConnection& c)
+{
+    jassert (c.socket != nullptr);
+
+    Entry* const e = new Entry (&c, nullptr, *c.socket);
+
+    if (pool != nullptr && ! c.useMessageThread)
+    {
+        e->deliveryQueue = new DeliveryQueue (c, *pool);
+
+        const ScopedLock sl (deliveryQueueLock);
+        deliveryQueues.add (e->deliveryQueue);
+    }
+
+    if (addEntry (e))
+        return true;
+
+    removeDeliveryQueue (c);
+    return false;
+}
+
+void InterprocessConnectionMultiplexer::removeConnection (InterprocessConnection& c)
+{
+    removeEntry (&c);
+    removeDeliveryQueue (c);
+}
+
+// The queue can outlive the socket, because it still has to deliver the connection-lost
+// callback, so it's only detached when the connection itself is disconnected or deleted.
+void InterprocessConnectionMultiplexer::removeDeliveryQueue (InterprocessConnection& c)
+{
+    DeliveryQueue::Ptr queue;
+
+    {
+        const ScopedLock sl (deliveryQueueLock);
+
+        for (int i = deliveryQueues.size(); --i >= 0;)
+        {
+            if (deliveryQueues.getObjectPointerUnchecked(i)->isFor (c))
+            {
+                queue = deliveryQueues.getObjectPointerUnchecked(i);
+                deliveryQueues.remove (i);
+                break;
+            }
+        }
+    }
+
+    // (this must be done without holding any other locks, as it may have to wait
+    // for a callback to finish)
+    if (queue != nullptr)
+        queue->detach();
+}
+
+bool InterprocessConnectionMultiplexer::addServer (InterprocessConnectionServer& s)
+{
+    jassert (s.socket != nullptr);
+    return addEntry (new Entry (nullptr, &s, *s.socket));
+}
+
+void InterprocessConnectionMultiplexer::removeServer (InterprocessConnectionServer& s)
+{
+    removeEntry (&s);
+}
@@ -0,0 +1,117 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+
+#ifndef __JUCE_INTERPROCESSCONNECTIONMULTIPLEXER_JUCEHEADER__
+#define __JUCE_INTERPROCESSCONNECTIONMULTIPLEXER_JUCEHEADER__
+
+class InterprocessConnection;
+class InterprocessConnectionServer;
+
+
+//==============================================================================
+/**
+    Services the sockets of many InterprocessConnection and InterprocessConnectionServer
+    objects using a small, fixed number of threads.
+
+    Normally, each socket-based InterprocessConnection runs its own thread, which
+    blocks on its socket, so a server with thousands of clients needs thousands of
+    threads. If you give the connections one of these instead, its threads wait on
+    all their sockets at once, using epoll on Linux and Android, kqueue on OSX and
+    iOS, and WSAPoll on Windows, and read messages from whichever sockets are ready.
+    The data on the wire is exactly the same, so either end of a connection can use
+    a multiplexer without the other end needing to know.
+
+    Messages are delivered according to the connection's callbacksOnMessageThread
+    setting. For connections that don't use the message thread, the callbacks are
+    made on one of this object's I/O threads - unless you give it a ThreadPool, in
+    which case they're made by jobs on the pool, so a slow messageReceived() won't
+    hold up the other connections. The messages for any one connection are always
+    delivered in order, and never by more than one thread at a time.
+
+    Named pipes aren't multiplexed - a connection that uses a pipe always has its
+    own thread.
+
+    The multiplexer must outlive all the connections and servers that use it.
+
+    @see InterprocessConnection::setMultiplexer, InterprocessConnectionServer::beginWaitingForSocket
+*/
+class JUCE_API  InterprocessConnectionMultiplexer
+{
+public:
+    //==============================================================================
+    /** Creates a multiplexer.
+
+        @param numIOThreads     the number of threads to use to wait for and read from
+                                the sockets. Connections are shared out between them.
+        @param callbackPool     an optional ThreadPool to use for the callbacks of connections
+                                that don't use the message thread. This must outlive the
+                                multiplexer.
+    */
+    explicit InterprocessConnectionMultiplexer (int numIOThreads = 1,
+                                                ThreadPool* callbackPool = nullptr);
+
+    /** Destructor.
+        All the connections and servers that use this must have been disconnected or
+        deleted before it is destroyed.
+    */
+    ~InterprocessConnectionMultiplexer();
+
+    //==============================================================================
+    /** Returns the number of sockets that are currently being serviced. */
+    int getNumSockets() const;
+
+    /** Returns false if the platform has no way of multiplexing sockets, in which case the
+        connections will just fall back to using a thread each.
+    */
+    static bool isSupported() noexcept;
+
+private:
+    //==============================================================================
+    class Poller;
+    class Entry;
+    class IOThread;
+    class DeliveryQueue;
+    class DeliveryJob;
+    friend class InterprocessConnection;
+    friend class InterprocessConnectionServer;
+
+    OwnedArray<IOThread> threads;
+    ThreadPool* const pool;
+    Atomic<int> nextThread;
+    CriticalSection deliveryQueueLock;
+    ReferenceCountedArray<DeliveryQueue> deliveryQueues;
+
+    bool addConnection (InterprocessConnection&);
+    void removeConnection (InterprocessConnection&);
+    bool addServer (InterprocessConnectionServer&);
+    void removeServer (InterprocessConnectionServer&);
+    bool addEntry (Entry*);
+    void removeEntry (const void* owner);
+    void removeDeliveryQueue (InterprocessConnection&);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (InterprocessConnectionMultiplexer)
+};
+
+#endif   // __JUCE_INTERPROCESSCONNECTIONMULTIPLEXER_JUCEHEADER__
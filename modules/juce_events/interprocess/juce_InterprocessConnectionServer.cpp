@@ -23,7 +23,8 @@
 */
 
 InterprocessConnectionServer::InterprocessConnectionServer()
-    : Thread ("Juce IPC server")
+    : Thread ("Juce IPC server"),
+      multiplexer (nullptr)
 {
 }
 
@@ -49,8 +50,37 @@ bool InterprocessConnectionServer::beginWaitingForSocket (const int portNumber)
     return false;
 }
 
+bool InterprocessConnectionServer::beginWaitingForSocket (const int portNumber,
+                                                          InterprocessConnectionMultiplexer& multiplexerToUse)
+{
+    stop();
+
+    socket = new StreamingSocket();
+
+    if (socket->createListener (portNumber))
+    {
+        multiplexer = &multiplexerToUse;
+
+        if (multiplexer->addServer (*this))
+            return true;
+
+        // this platform can't multiplex sockets, so use a thread instead
+        startThread();
+        return true;
+    }
+
+    socket = nullptr;
+    return false;
+}
+
 void InterprocessConnectionServer::stop()
 {
+    if (multiplexer != nullptr)
+    {
+        multiplexer->removeServer (*this);
+        multiplexer = nullptr;
+    }
+
     signalThreadShouldExit();
 
     if (socket != nullptr)
@@ -60,18 +90,26 @@ void InterprocessConnectionServer::stop()
     socket = nullptr;
 }
 
-void InterprocessConnectionServer::run()
+void InterprocessConnectionServer::handleIncomingConnectionInt()
 {
-    while ((! threadShouldExit()) && socket != nullptr)
+    ScopedPointer <StreamingSocket> clientSocket (socket->waitForNextConnection());
+
+    if (clientSocket != nullptr)
     {
-        ScopedPointer <StreamingSocket> clientSocket (socket->waitForNextConnection());
+        InterprocessConnection* newConnection = createConnectionObject();
 
-        if (clientSocket != nullptr)
+        if (newConnection != nullptr)
         {
-            InterprocessConnection* newConnection = createConnectionObject();
+            if (multiplexer != nullptr && newConnection->getMultiplexer() == nullptr)
+                newConnection->setMultiplexer (multiplexer);
 
-            if (newConnection != nullptr)
-                newConnection->initialiseWithSocket (clientSocket.release());
+            newConnection->initialiseWithSocket (clientSocket.release());
         }
     }
 }
+
+void InterprocessConnectionServer::run()
+{
+    while ((! threadShouldExit()) && socket != nullptr)
+        handleIncomingConnectionInt();
+}
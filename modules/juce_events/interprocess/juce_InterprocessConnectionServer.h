@@ -63,6 +63,17 @@ public:
     */
     bool beginWaitingForSocket (int portNumber);
 
+    /** Starts listening on the given port number, using a multiplexer rather than a thread.
+
+        This works like the other beginWaitingForSocket() method, except that the
+        listening socket is serviced by the multiplexer's threads. Any connection objects
+        that createConnectionObject() returns without a multiplexer of their own will also
+        be given this one. The multiplexer must outlive this object.
+
+        @see InterprocessConnectionMultiplexer
+    */
+    bool beginWaitingForSocket (int portNumber, InterprocessConnectionMultiplexer& multiplexer);
+
     /** Terminates the listener thread, if it's active.
 
         @see beginWaitingForSocket
@@ -85,7 +96,10 @@ protected:
 private:
     //==============================================================================
     ScopedPointer <StreamingSocket> socket;
+    InterprocessConnectionMultiplexer* multiplexer;
 
+    friend class InterprocessConnectionMultiplexer;
+    void handleIncomingConnectionInt();
     void run();
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (InterprocessConnectionServer)
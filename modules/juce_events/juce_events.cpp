@@ -49,6 +49,13 @@
  #import <IOKit/hid/IOHIDLib.h>
  #import <IOKit/hid/IOHIDKeys.h>
  #import <IOKit/pwr_mgt/IOPMLib.h>
+ #include <sys/event.h>
+
+#elif JUCE_IOS
+ #include <sys/event.h>
+
+#elif JUCE_WINDOWS
+ #include <winsock2.h>
 
 #elif JUCE_LINUX
  #include <X11/Xlib.h>
@@ -56,6 +63,11 @@
  #include <X11/Xutil.h>
  #undef KeyPress
  #include <unistd.h>
+ #include <sys/epoll.h>
+ #include <sys/eventfd.h>
+
+#elif JUCE_ANDROID
+ #include <sys/epoll.h>
 #endif
 
 //==============================================================================
@@ -74,6 +86,7 @@ namespace juce
 #include "timers/juce_MultiTimer.cpp"
 #include "timers/juce_Timer.cpp"
 #include "interprocess/juce_InterprocessConnection.cpp"
+#include "interprocess/juce_InterprocessConnectionMultiplexer.cpp"
 #include "interprocess/juce_InterprocessConnectionServer.cpp"
 // END_AUTOINCLUDE
 
@@ -72,6 +72,9 @@ namespace juce
 #ifndef __JUCE_LISTENERLIST_JUCEHEADER__
  #include "broadcasters/juce_ListenerList.h"
 #endif
+#ifndef __JUCE_PRIORITISEDLISTENERLIST_JUCEHEADER__
+ #include "broadcasters/juce_PrioritisedListenerList.h"
+#endif
 #ifndef __JUCE_MULTITIMER_JUCEHEADER__
  #include "timers/juce_MultiTimer.h"
 #endif
@@ -84,6 +87,9 @@ namespace juce
 #ifndef __JUCE_INTERPROCESSCONNECTIONSERVER_JUCEHEADER__
  #include "interprocess/juce_InterprocessConnectionServer.h"
 #endif
+#ifndef __JUCE_INTERPROCESSCONNECTIONMULTIPLEXER_JUCEHEADER__
+ #include "interprocess/juce_InterprocessConnectionMultiplexer.h"
+#endif
 #ifndef __JUCE_SCOPEDXLOCK_JUCEHEADER__
  #include "native/juce_ScopedXLock.h"
 #endif
@@ -45,6 +45,8 @@ MessageManager::MessageManager() noexcept
 {
     if (JUCEApplicationBase::isStandaloneApp())
         Thread::setCurrentThreadName ("Juce Message Thread");
+
+    JUCE_TRACE_THREAD_NAME ("Message Thread");
 }
 
 MessageManager::~MessageManager() noexcept
@@ -331,6 +333,7 @@ JUCE_API void JUCE_CALLTYPE shutdownJuce_GUI()
     JUCE_AUTORELEASEPOOL
     {
         DeletedAtShutdown::deleteAll();
+        SharedResourceRegistry::releaseUnusedResources();
         MessageManager::deleteInstance();
     }
 }
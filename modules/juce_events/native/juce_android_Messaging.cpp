@@ -47,6 +47,7 @@ JUCE_JNI_CALLBACK (JUCE_ANDROID_ACTIVITY_CLASSNAME, deliverMessage, void, (jobje
     JUCE_TRY
     {
         MessageManager::MessageBase* const message = (MessageManager::MessageBase*) (pointer_sized_uint) value;
+        JUCE_TRACE_SCOPE ("Message");
         message->messageCallback();
         message->decReferenceCount();
     }
@@ -45,44 +45,62 @@ class InternalMessageQueue
 {
 public:
     InternalMessageQueue()
-        : bytesInSocket (0),
+        : queue (4096),
+          wakeUpPending (0),
+          numOverflowMessages (0),
+          numBatchedMessages (0),
+          nextBatchedMessage (0),
           totalEventCount (0)
     {
-        int ret = ::socketpair (AF_LOCAL, SOCK_STREAM, 0, fd);
-        (void) ret; jassert (ret == 0);
+        eventFd = eventfd (0, EFD_NONBLOCK | EFD_CLOEXEC);
+        jassert (eventFd >= 0);
     }
 
     ~InternalMessageQueue()
     {
-        close (fd[0]);
-        close (fd[1]);
+        while (nextBatchedMessage < numBatchedMessages)
+            batch [nextBatchedMessage++]->decReferenceCount();
+
+        while (MessageManager::MessageBase* const m = popNextMessage())
+            m->decReferenceCount();
+
+        close (eventFd);
 
         clearSingletonInstance();
     }
 
     //==============================================================================
+    /*  Messages normally go straight into a lock-free queue. If that fills up, they spill
+        into a locked overflow list, and everything that's posted after that also goes into
+        the overflow list until the message thread has emptied it, so that the order
+        of messages posted from any one thread is always preserved.
+    */
     void postMessage (MessageManager::MessageBase* const msg)
     {
-        const int maxBytesInSocketQueue = 128;
-
-        ScopedLock sl (lock);
-        queue.add (msg);
+        msg->incReferenceCount();
 
-        if (bytesInSocket < maxBytesInSocketQueue)
+        if (numOverflowMessages.get() != 0 || ! queue.push (msg))
         {
-            ++bytesInSocket;
+            const ScopedLock sl (overflowLock);
+            overflow.add (msg);
+            ++numOverflowMessages;
+        }
 
-            ScopedUnlock ul (lock);
-            const unsigned char x = 0xff;
-            size_t bytesWritten = write (fd[0], &x, 1);
+        // Only the first message posted since the message thread last woke up needs
+        // to signal it - the rest of the batch will be picked up at the same time.
+        if (wakeUpPending.compareAndSetBool (1, 0))
+        {
+            const uint64 one = 1;
+            ssize_t bytesWritten = write (eventFd, &one, sizeof (one));
             (void) bytesWritten;
         }
     }
 
     bool isEmpty() const
     {
-        ScopedLock sl (lock);
-        return queue.size() == 0;
+        return nextBatchedMessage >= numBatchedMessages
+                && queue.getNumReady() == 0
+                && numOverflowMessages.get() == 0;
     }
 
     bool dispatchNextEvent()
@@ -90,9 +108,9 @@ public:
         // This alternates between giving priority to XEvents or internal messages,
         // to keep everything running smoothly..
         if ((++totalEventCount & 1) != 0)
-            return dispatchNextXEvent() || dispatchNextInternalMessage();
+            return dispatchNextXEvent() || dispatchNextInternalMessages();
 
-        return dispatchNextInternalMessage() || dispatchNextXEvent();
+        return dispatchNextInternalMessages() || dispatchNextXEvent();
     }
 
     // Wait for an event (either XEvent, or an internal Message)
@@ -111,7 +129,7 @@ public:
         struct timeval tv;
         tv.tv_sec = 0;
         tv.tv_usec = timeoutMs * 1000;
-        int fd0 = getWaitHandle();
+        int fd0 = eventFd;
         int fdmax = fd0;
 
         fd_set readset;
@@ -134,24 +152,17 @@ public:
     juce_DeclareSingleton_SingleThreaded_Minimal (InternalMessageQueue);
 
 private:
-    CriticalSection lock;
-    ReferenceCountedArray <MessageManager::MessageBase> queue;
-    int fd[2];
-    int bytesInSocket;
+    enum { maxMessagesPerBatch = 64 };
+
+    ConcurrentQueue <MessageManager::MessageBase*> queue;
+    CriticalSection overflowLock;
+    Array <MessageManager::MessageBase*> overflow;
+    Atomic <int> wakeUpPending, numOverflowMessages;
+    MessageManager::MessageBase* batch [maxMessagesPerBatch];
+    int numBatchedMessages, nextBatchedMessage;
+    int eventFd;
     int totalEventCount;
 
-    int getWaitHandle() const noexcept      { return fd[1]; }
-
-    static bool setNonBlocking (int handle)
-    {
-        int socketFlags = fcntl (handle, F_GETFL, 0);
-        if (socketFlags == -1)
-            return false;
-
-        socketFlags |= O_NONBLOCK;
-        return fcntl (handle, F_SETFL, socketFlags) == 0;
-    }
-
     static bool dispatchNextXEvent()
     {
         if (display == 0)
@@ -176,36 +187,89 @@ private:
         return true;
     }
 
-    MessageManager::MessageBase::Ptr popNextMessage()
+    MessageManager::MessageBase* popNextMessage()
     {
-        const ScopedLock sl (lock);
+        MessageManager::MessageBase* m = nullptr;
+
+        if (queue.pop (m))
+            return m;
 
-        if (bytesInSocket > 0)
+        // The overflow list can only be used once the lock-free queue is empty,
+        // otherwise messages could overtake older ones that are still in the queue.
+        if (numOverflowMessages.get() != 0)
         {
-            --bytesInSocket;
+            const ScopedLock sl (overflowLock);
 
-            const ScopedUnlock ul (lock);
-            unsigned char x;
-            size_t numBytes = read (fd[1], &x, 1);
-            (void) numBytes;
+            if (overflow.size() > 0)
+            {
+                m = overflow.remove (0);
+                --numOverflowMessages;
+            }
         }
 
-        return queue.removeAndReturn (0);
+        return m;
     }
 
-    bool dispatchNextInternalMessage()
+    void fillBatch()
     {
-        if (const MessageManager::MessageBase::Ptr msg = popNextMessage())
+        // The wake-up flag has to be cleared before looking at the queue, so that a
+        // message which arrives after we've looked will signal the event again.
+        if (wakeUpPending.get() != 0)
+        {
+            uint64 count;
+            ssize_t bytesRead = read (eventFd, &count, sizeof (count));
+            (void) bytesRead;
+
+            wakeUpPending.set (0);
+        }
+
+        numBatchedMessages = 0;
+        nextBatchedMessage = 0;
+
+        while (numBatchedMessages < maxMessagesPerBatch)
         {
+            MessageManager::MessageBase* const m = popNextMessage();
+
+            if (m == nullptr)
+                break;
+
+            batch [numBatchedMessages++] = m;
+        }
+    }
+
+    // Dispatches up to a batch's worth of messages, so that a flood of posted
+    // messages can't stop X events from being delivered.
+    bool dispatchNextInternalMessages()
+    {
+        if (nextBatchedMessage >= numBatchedMessages)
+        {
+            fillBatch();
+
+            if (numBatchedMessages == 0)
+                return false;
+        }
+
+        while (nextBatchedMessage < numBatchedMessages)
+        {
+            const MessageManager::MessageBase::Ptr msg (batch [nextBatchedMessage++]);
+            msg->decReferenceCount();
+
             JUCE_TRY
             {
+                JUCE_TRACE_SCOPE ("Message");
                 msg->messageCallback();
-                return true;
             }
             JUCE_CATCH_EXCEPTION
+
+            // once a quit message is on its way, go back to the dispatch loop after
+            // each message so that it can stop as soon as it arrives
+            MessageManager* const mm = MessageManager::getInstanceWithoutCreating();
+
+            if (mm == nullptr || mm->hasStopMessageBeenSent())
+                break;
         }
 
-        return false;
+        return true;
     }
 };
 
@@ -76,6 +76,7 @@ private:
         {
             JUCE_TRY
             {
+                JUCE_TRACE_SCOPE ("Message");
                 nextMessage->messageCallback();
             }
             JUCE_CATCH_EXCEPTION
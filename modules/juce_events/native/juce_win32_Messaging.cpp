@@ -42,6 +42,7 @@ namespace WindowsMessageHelpers
 
         JUCE_TRY
         {
+            JUCE_TRACE_SCOPE ("Message");
             message->messageCallback();
         }
         JUCE_CATCH_EXCEPTION
@@ -22,6 +22,13 @@
   ==============================================================================
 */
 
+/*  The running timers are kept in a hashed timing wheel: each timer lives in a
+    list for the slot that corresponds to its expiry time (modulo the wheel size),
+    so starting or stopping one is constant-time, and on each tick the thread only
+    has to look at the slots that have come due since the last tick, rather than
+    at every timer. Timers that are due get moved onto a single list which is then
+    dispatched by one message.
+*/
 class Timer::TimerThread  : private Thread,
                             private DeletedAtShutdown,
                             private AsyncUpdater
@@ -31,9 +38,12 @@ public:
 
     TimerThread()
         : Thread ("Juce Timer"),
-          firstTimer (nullptr),
+          lastProcessedTime (Time::getMillisecondCounter()),
+          lastDueTimer (nullptr),
           callbackNeeded (0)
     {
+        zeromem (lists, sizeof (lists));
+        zeromem (occupiedSlots, sizeof (occupiedSlots));
         triggerAsyncUpdate();
     }
 
@@ -48,26 +58,14 @@ public:
 
     void run()
     {
-        uint32 lastTime = Time::getMillisecondCounter();
         MessageManager::MessageBase::Ptr messageToSend (new CallTimersMessage());
 
         while (! threadShouldExit())
         {
             const uint32 now = Time::getMillisecondCounter();
+            const int timeUntilNextTimer = advanceWheel (now);
 
-            if (now == lastTime)
-            {
-                wait (1);
-                continue;
-            }
-
-            const int elapsed = (int) (now >= lastTime ? (now - lastTime)
-                                                       : (std::numeric_limits<uint32>::max() - (lastTime - now)));
-            lastTime = now;
-
-            const int timeUntilFirstTimer = getTimeUntilFirstTimer (elapsed);
-
-            if (timeUntilFirstTimer <= 0)
+            if (timeUntilNextTimer <= 0)
             {
                 /* If we managed to set the atomic boolean to true then send a message, this is needed
                    as a memory barrier so the message won't be sent before callbackNeeded is set to true,
@@ -98,12 +96,16 @@ public:
                         }
                     }
                 }
+                else
+                {
+                    wait (1);
+                }
             }
             else
             {
                 // don't wait for too long because running this loop also helps keep the
                 // Time::getApproximateMillisecondTimer value stay up-to-date
-                wait (jlimit (1, 50, timeUntilFirstTimer));
+                wait (jlimit (1, 50, timeUntilNextTimer));
             }
         }
     }
@@ -112,12 +114,12 @@ public:
     {
         const LockType::ScopedLockType sl (lock);
 
-        while (firstTimer != nullptr && firstTimer->countdownMs <= 0)
+        while (lists [dueList] != nullptr)
         {
-            Timer* const t = firstTimer;
-            t->countdownMs = t->periodMs;
+            Timer* const t = lists [dueList];
 
             removeTimer (t);
+            t->expiryTime = Time::getMillisecondCounter() + (uint32) t->periodMs;
             addTimer (t);
 
             const LockType::ScopedUnlockType ul (lock);
@@ -148,6 +150,7 @@ public:
             triggerAsyncUpdate();
         }
 
+        advanceWheel (Time::getMillisecondCounter());
         callTimers();
     }
 
@@ -169,15 +172,10 @@ public:
     {
         if (instance != nullptr)
         {
-            tim->countdownMs = newCounter;
-            tim->periodMs = newCounter;
-
-            if ((tim->next != nullptr && tim->next->countdownMs < tim->countdownMs)
-                 || (tim->previous != nullptr && tim->previous->countdownMs > tim->countdownMs))
-            {
-                instance->removeTimer (tim);
-                instance->addTimer (tim);
-            }
+            instance->removeTimer (tim);
+            tim->expiryTime = Time::getMillisecondCounter() + (uint32) jmax (0, newCounter);
+            tim->periodMs = jmax (1, newCounter);
+            instance->addTimer (tim);
         }
     }
 
@@ -185,7 +183,17 @@ public:
     static LockType lock;
 
 private:
-    Timer* volatile firstTimer;
+    enum
+    {
+        numSlots = 1024,        // (must be a power of two)
+        slotMask = numSlots - 1,
+        dueList  = numSlots     // index of the list of timers waiting for a callback
+    };
+
+    uint32 lastProcessedTime;
+    Timer* lists [numSlots + 1];
+    Timer* lastDueTimer;
+    uint32 occupiedSlots [numSlots / 32];
     Atomic <int> callbackNeeded;
 
     struct CallTimersMessage  : public MessageManager::MessageBase
@@ -200,6 +208,11 @@ private:
     };
 
     //==============================================================================
+    static bool hasExpired (const Timer* const t, const uint32 now) noexcept
+    {
+        return (int32) (now - t->expiryTime) >= 0;
+    }
+
     void addTimer (Timer* const t) noexcept
     {
        #if JUCE_DEBUG
@@ -208,30 +221,25 @@ private:
         jassert (! timerExists (t));
        #endif
 
-        Timer* i = firstTimer;
-
-        if (i == nullptr || i->countdownMs > t->countdownMs)
+        if (hasExpired (t, lastProcessedTime))
         {
-            t->next = firstTimer;
-            firstTimer = t;
+            // this slot has already been visited, so it goes straight onto the due list
+            appendToDueList (t);
         }
         else
         {
-            while (i->next != nullptr && i->next->countdownMs <= t->countdownMs)
-                i = i->next;
+            const int slot = (int) (t->expiryTime & slotMask);
 
-            jassert (i != nullptr);
+            t->wheelSlot = slot;
+            t->previous = nullptr;
+            t->next = lists [slot];
 
-            t->next = i->next;
-            t->previous = i;
-            i->next = t;
-        }
+            if (t->next != nullptr)
+                t->next->previous = t;
 
-        if (t->next != nullptr)
-            t->next->previous = t;
-
-        jassert ((t->next == nullptr || t->next->countdownMs >= t->countdownMs)
-                  && (t->previous == nullptr || t->previous->countdownMs <= t->countdownMs));
+            lists [slot] = t;
+            occupiedSlots [slot >> 5] |= (1u << (slot & 31));
+        }
 
         notify();
     }
@@ -244,32 +252,97 @@ private:
         jassert (timerExists (t));
        #endif
 
+        const int slot = t->wheelSlot;
+
         if (t->previous != nullptr)
         {
-            jassert (firstTimer != t);
+            jassert (lists [slot] != t);
             t->previous->next = t->next;
         }
         else
         {
-            jassert (firstTimer == t);
-            firstTimer = t->next;
+            jassert (lists [slot] == t);
+            lists [slot] = t->next;
         }
 
         if (t->next != nullptr)
             t->next->previous = t->previous;
+        else if (slot == dueList)
+            lastDueTimer = t->previous;
+
+        if (slot != dueList && lists [slot] == nullptr)
+            occupiedSlots [slot >> 5] &= ~(1u << (slot & 31));
 
         t->next = nullptr;
         t->previous = nullptr;
+        t->wheelSlot = -1;
+    }
+
+    void appendToDueList (Timer* const t) noexcept
+    {
+        t->wheelSlot = dueList;
+        t->next = nullptr;
+        t->previous = lastDueTimer;
+
+        if (lastDueTimer != nullptr)
+            lastDueTimer->next = t;
+        else
+            lists [dueList] = t;
+
+        lastDueTimer = t;
     }
 
-    int getTimeUntilFirstTimer (const int numMillisecsElapsed) const
+    // Moves any timers that have expired onto the due list, and returns the number of
+    // milliseconds until the next slot that has something in it.
+    int advanceWheel (const uint32 now)
     {
         const LockType::ScopedLockType sl (lock);
 
-        for (Timer* t = firstTimer; t != nullptr; t = t->next)
-            t->countdownMs -= numMillisecsElapsed;
+        const uint32 numSlotsToVisit = jmin (now - lastProcessedTime, (uint32) numSlots);
+
+        for (uint32 i = 1; i <= numSlotsToVisit; ++i)
+        {
+            const int slot = (int) ((lastProcessedTime + i) & slotMask);
+
+            for (Timer* t = lists [slot]; t != nullptr;)
+            {
+                Timer* const next = t->next;
+
+                if (hasExpired (t, now))
+                {
+                    removeTimer (t);
+                    appendToDueList (t);
+                }
+
+                t = next;
+            }
+        }
+
+        lastProcessedTime = now;
+
+        if (lists [dueList] != nullptr)
+            return 0;
+
+        for (int distance = 1; distance <= numSlots;)
+        {
+            const int slot = (int) ((now + (uint32) distance) & slotMask);
+            uint32 bits = occupiedSlots [slot >> 5] >> (slot & 31);
+
+            if (bits != 0)
+            {
+                while ((bits & 1) == 0)
+                {
+                    bits >>= 1;
+                    ++distance;
+                }
+
+                return distance;
+            }
+
+            distance += 32 - (slot & 31);
+        }
 
-        return firstTimer != nullptr ? firstTimer->countdownMs : 1000;
+        return 1000;
     }
 
     void handleAsyncUpdate()
@@ -280,9 +353,10 @@ private:
    #if JUCE_DEBUG
     bool timerExists (Timer* const t) const noexcept
     {
-        for (Timer* tt = firstTimer; tt != nullptr; tt = tt->next)
-            if (tt == t)
-                return true;
+        if (t->wheelSlot >= 0)
+            for (Timer* tt = lists [t->wheelSlot]; tt != nullptr; tt = tt->next)
+                if (tt == t)
+                    return true;
 
         return false;
     }
@@ -300,8 +374,9 @@ static SortedSet <Timer*> activeTimers;
 #endif
 
 Timer::Timer() noexcept
-   : countdownMs (0),
+   : expiryTime (0),
      periodMs (0),
+     wheelSlot (-1),
      previous (nullptr),
      next (nullptr)
 {
@@ -312,8 +387,9 @@ Timer::Timer() noexcept
 }
 
 Timer::Timer (const Timer&) noexcept
-   : countdownMs (0),
+   : expiryTime (0),
      periodMs (0),
+     wheelSlot (-1),
      previous (nullptr),
      next (nullptr)
 {
@@ -343,7 +419,7 @@ void Timer::startTimer (const int interval) noexcept
 
     if (periodMs == 0)
     {
-        countdownMs = interval;
+        expiryTime = Time::getMillisecondCounter() + (uint32) jmax (0, interval);
         periodMs = jmax (1, interval);
         TimerThread::add (this);
     }
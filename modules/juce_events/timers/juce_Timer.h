@@ -42,6 +42,10 @@
     anything that blocks the message queue for a period of time will also prevent
     any timers from running until it can carry on.
 
+    Starting and stopping a timer takes constant time, no matter how many other
+    timers are running, and all the timers that become due at the same moment are
+    called back from a single message, so it's fine to have thousands of them.
+
     If you need to have a single callback that is shared by multiple timers with
     different frequencies, then the MultiTimer class allows you to do that - its
     structure is very similar to the Timer class, but contains multiple timers
@@ -124,7 +128,8 @@ public:
 private:
     class TimerThread;
     friend class TimerThread;
-    int countdownMs, periodMs;
+    uint32 expiryTime;
+    int periodMs, wheelSlot;
     Timer* previous;
     Timer* next;
 
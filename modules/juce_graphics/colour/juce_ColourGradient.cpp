@@ -178,14 +178,20 @@ void ColourGradient::createLookupTable (PixelARGB* const lookupTable, const int
         lookupTable [index++] = pix1;
 }
 
-int ColourGradient::createLookupTable (const AffineTransform& transform, HeapBlock <PixelARGB>& lookupTable) const
+int ColourGradient::getNumLookupTableEntries (const AffineTransform& transform) const noexcept
 {
     JUCE_COLOURGRADIENT_CHECK_COORDS_INITIALISED // Trying to use this object without setting its co-ordinates?
+
+    return jlimit (1, jmax (1, (colours.size() - 1) << 8),
+                   3 * (int) point1.transformedBy (transform)
+                                .getDistanceFrom (point2.transformedBy (transform)));
+}
+
+int ColourGradient::createLookupTable (const AffineTransform& transform, HeapBlock <PixelARGB>& lookupTable) const
+{
     jassert (colours.size() >= 2);
 
-    const int numEntries = jlimit (1, jmax (1, (colours.size() - 1) << 8),
-                                   3 * (int) point1.transformedBy (transform)
-                                                .getDistanceFrom (point2.transformedBy (transform)));
+    const int numEntries = getNumLookupTableEntries (transform);
     lookupTable.malloc ((size_t) numEntries);
     createLookupTable (lookupTable, numEntries);
     return numEntries;
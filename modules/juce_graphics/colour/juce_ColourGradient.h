@@ -138,6 +138,11 @@ public:
     */
     void createLookupTable (PixelARGB* resultLookupTable, int numEntries) const noexcept;
 
+    /** Returns the number of entries that createLookupTable() would use for this gradient
+        when it's drawn with the given transform.
+    */
+    int getNumLookupTableEntries (const AffineTransform& transform) const noexcept;
+
     /** Returns true if all colours are opaque. */
     bool isOpaque() const noexcept;
 
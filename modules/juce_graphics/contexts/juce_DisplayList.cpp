@@ -0,0 +1,470 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+class DisplayList::Operation
+{
+public:
+    Operation() noexcept {}
+    virtual ~Operation() {}
+
+    /** Replays the operation. If shouldDraw is false, only the operation's effect on the
+        state is needed. */
+    virtual void perform (LowLevelGraphicsContext&, bool shouldDraw) const = 0;
+
+    /** For drawing operations, this is the device-space clip area that the operation
+        was recorded with, so a replay that doesn't overlap it can skip the operation. */
+    Rectangle<int> area;
+
+    JUCE_DECLARE_NON_COPYABLE (Operation)
+};
+
+struct DisplayList::Operations
+{
+    struct DrawingOperation  : public Operation
+    {
+        void perform (LowLevelGraphicsContext& g, bool shouldDraw) const
+        {
+            if (shouldDraw)
+                draw (g);
+        }
+
+        virtual void draw (LowLevelGraphicsContext&) const = 0;
+    };
+
+    //==============================================================================
+    struct SetOrigin  : public Operation
+    {
+        SetOrigin (int x_, int y_) noexcept : x (x_), y (y_) {}
+        void perform (LowLevelGraphicsContext& g, bool) const     { g.setOrigin (x, y); }
+        const int x, y;
+    };
+
+    struct AddTransform  : public Operation
+    {
+        AddTransform (const AffineTransform& t) noexcept : transform (t) {}
+        void perform (LowLevelGraphicsContext& g, bool) const     { g.addTransform (transform); }
+        const AffineTransform transform;
+    };
+
+    struct ClipToRectangle  : public Operation
+    {
+        ClipToRectangle (const Rectangle<int>& r) noexcept : area (r) {}
+        void perform (LowLevelGraphicsContext& g, bool) const     { g.clipToRectangle (area); }
+        const Rectangle<int> area;
+    };
+
+    struct ClipToRectangleList  : public Operation
+    {
+        ClipToRectangleList (const RectangleList& r) : region (r) {}
+        void perform (LowLevelGraphicsContext& g, bool) const     { g.clipToRectangleList (region); }
+        const RectangleList region;
+    };
+
+    struct ExcludeClipRectangle  : public Operation
+    {
+        ExcludeClipRectangle (const Rectangle<int>& r) noexcept : area (r) {}
+        void perform (LowLevelGraphicsContext& g, bool) const     { g.excludeClipRectangle (area); }
+        const Rectangle<int> area;
+    };
+
+    struct ClipToPath  : public Operation
+    {
+        ClipToPath (const Path& p, const AffineTransform& t) : path (p), transform (t) {}
+        void perform (LowLevelGraphicsContext& g, bool) const     { g.clipToPath (path, transform); }
+        const Path path;
+        const AffineTransform transform;
+    };
+
+    struct ClipToImageAlpha  : public Operation
+    {
+        ClipToImageAlpha (const Image& im, const AffineTransform& t) : image (im), transform (t) {}
+        void perform (LowLevelGraphicsContext& g, bool) const     { g.clipToImageAlpha (image, transform); }
+        const Image image;
+        const AffineTransform transform;
+    };
+
+    struct SaveState  : public Operation
+    {
+        void perform (LowLevelGraphicsContext& g, bool) const     { g.saveState(); }
+    };
+
+    struct RestoreState  : public Operation
+    {
+        void perform (LowLevelGraphicsContext& g, bool) const     { g.restoreState(); }
+    };
+
+    struct BeginTransparencyLayer  : public Operation
+    {
+        BeginTransparencyLayer (float o) noexcept : opacity (o) {}
+
+        void perform (LowLevelGraphicsContext& g, bool shouldDraw) const
+        {
+            if (shouldDraw)
+                g.beginTransparencyLayer (opacity);
+            else
+                g.saveState();
+        }
+
+        const float opacity;
+    };
+
+    struct EndTransparencyLayer  : public Operation
+    {
+        void perform (LowLevelGraphicsContext& g, bool shouldDraw) const
+        {
+            if (shouldDraw)
+                g.endTransparencyLayer();
+            else
+                g.restoreState();
+        }
+    };
+
+    struct SetFill  : public Operation
+    {
+        SetFill (const FillType& f) : fillType (f) {}
+        void perform (LowLevelGraphicsContext& g, bool) const     { g.setFill (fillType); }
+        const FillType fillType;
+    };
+
+    struct SetOpacity  : public Operation
+    {
+        SetOpacity (float o) noexcept : opacity (o) {}
+        void perform (LowLevelGraphicsContext& g, bool) const     { g.setOpacity (opacity); }
+        const float opacity;
+    };
+
+    struct SetInterpolationQuality  : public Operation
+    {
+        SetInterpolationQuality (Graphics::ResamplingQuality q) noexcept : quality (q) {}
+        void perform (LowLevelGraphicsContext& g, bool) const     { g.setInterpolationQuality (quality); }
+        const Graphics::ResamplingQuality quality;
+    };
+
+    struct SetFont  : public Operation
+    {
+        SetFont (const Font& f) : font (f) {}
+        void perform (LowLevelGraphicsContext& g, bool) const     { g.setFont (font); }
+        const Font font;
+    };
+
+    //==============================================================================
+    struct FillRect  : public DrawingOperation
+    {
+        FillRect (const Rectangle<int>& r, bool replace) noexcept : area (r), replaceExistingContents (replace) {}
+        void draw (LowLevelGraphicsContext& g) const              { g.fillRect (area, replaceExistingContents); }
+        const Rectangle<int> area;
+        const bool replaceExistingContents;
+    };
+
+    struct FillPath  : public DrawingOperation
+    {
+        FillPath (const Path& p, const AffineTransform& t) : path (p), transform (t) {}
+        void draw (LowLevelGraphicsContext& g) const              { g.fillPath (path, transform); }
+        const Path path;
+        const AffineTransform transform;
+    };
+
+    struct DrawImage  : public DrawingOperation
+    {
+        DrawImage (const Image& im, const AffineTransform& t) : image (im), transform (t) {}
+        void draw (LowLevelGraphicsContext& g) const              { g.drawImage (image, transform); }
+        const Image image;
+        const AffineTransform transform;
+    };
+
+    struct DrawLine  : public DrawingOperation
+    {
+        DrawLine (const Line<float>& l) noexcept : line (l) {}
+        void draw (LowLevelGraphicsContext& g) const              { g.drawLine (line); }
+        const Line<float> line;
+    };
+
+    struct DrawVerticalLine  : public DrawingOperation
+    {
+        DrawVerticalLine (int x_, float top_, float bottom_) noexcept : x (x_), top (top_), bottom (bottom_) {}
+        void draw (LowLevelGraphicsContext& g) const              { g.drawVerticalLine (x, top, bottom); }
+        const int x;
+        const float top, bottom;
+    };
+
+    struct DrawHorizontalLine  : public DrawingOperation
+    {
+        DrawHorizontalLine (int y_, float left_, float right_) noexcept : y (y_), left (left_), right (right_) {}
+        void draw (LowLevelGraphicsContext& g) const              { g.drawHorizontalLine (y, left, right); }
+        const int y;
+        const float left, right;
+    };
+
+    struct DrawGlyph  : public DrawingOperation
+    {
+        DrawGlyph (int glyph, const AffineTransform& t) noexcept : glyphNumber (glyph), transform (t) {}
+        void draw (LowLevelGraphicsContext& g) const              { g.drawGlyph (glyphNumber, transform); }
+        const int glyphNumber;
+        const AffineTransform transform;
+    };
+};
+
+
+//==============================================================================
+DisplayList::DisplayList (const Rectangle<int>& area)
+    : stateTracker (Image (Image::ARGB, 1, 1, false), Point<int>(), RectangleList (area)),
+      numDrawingOperations (0),
+      transparencyLayerDepth (0)
+{
+}
+
+DisplayList::DisplayList (const Image& image, Point<int> origin, const RectangleList& initialClip)
+    : stateTracker (image, origin, initialClip),
+      numDrawingOperations (0),
+      transparencyLayerDepth (0)
+{
+}
+
+DisplayList::~DisplayList()
+{
+}
+
+//==============================================================================
+void DisplayList::draw (Graphics& g) const
+{
+    LowLevelGraphicsContext& context = g.getInternalContext();
+
+    if (! context.isClipEmpty())
+    {
+        context.saveState();
+        replay (context, context.getClipBounds());
+        context.restoreState();
+    }
+}
+
+void DisplayList::replay (LowLevelGraphicsContext& target, const Rectangle<int>& area,
+                          const int firstOperationToDraw) const
+{
+    // the contents of a transparency layer can't be drawn until the layer's been ended
+    jassert (transparencyLayerDepth == 0);
+
+    for (int i = 0; i < operations.size(); ++i)
+    {
+        const Operation& op = *operations.getUnchecked(i);
+
+        op.perform (target, i >= firstOperationToDraw
+                             && (op.area.isEmpty() || op.area.intersects (area)));
+    }
+}
+
+int DisplayList::getNumOperations() const noexcept
+{
+    return operations.size();
+}
+
+int DisplayList::getNumDrawingOperations() const noexcept
+{
+    return numDrawingOperations;
+}
+
+void DisplayList::addOperation (Operation* const op)
+{
+    operations.add (op);
+}
+
+void DisplayList::addDrawingOperation (Operation* const op)
+{
+    ScopedPointer<Operation> o (op);
+
+    // (no need to keep anything that's completely clipped away)
+    if (! stateTracker.isClipEmpty())
+    {
+        o->area = stateTracker.getDeviceSpaceClipBounds();
+        operations.add (o.release());
+        ++numDrawingOperations;
+    }
+}
+
+//==============================================================================
+bool DisplayList::isVectorDevice() const                    { return false; }
+float DisplayList::getScaleFactor()                          { return stateTracker.getScaleFactor(); }
+Rectangle<int> DisplayList::getClipBounds() const            { return stateTracker.getClipBounds(); }
+bool DisplayList::isClipEmpty() const                        { return stateTracker.isClipEmpty(); }
+bool DisplayList::clipRegionIntersects (const Rectangle<int>& r)   { return stateTracker.clipRegionIntersects (r); }
+
+void DisplayList::setOrigin (int x, int y)
+{
+    stateTracker.setOrigin (x, y);
+    addOperation (new Operations::SetOrigin (x, y));
+}
+
+void DisplayList::addTransform (const AffineTransform& t)
+{
+    stateTracker.addTransform (t);
+    addOperation (new Operations::AddTransform (t));
+}
+
+bool DisplayList::clipToRectangle (const Rectangle<int>& r)
+{
+    addOperation (new Operations::ClipToRectangle (r));
+    return stateTracker.clipToRectangle (r);
+}
+
+bool DisplayList::clipToRectangleList (const RectangleList& r)
+{
+    addOperation (new Operations::ClipToRectangleList (r));
+    return stateTracker.clipToRectangleList (r);
+}
+
+void DisplayList::excludeClipRectangle (const Rectangle<int>& r)
+{
+    stateTracker.excludeClipRectangle (r);
+    addOperation (new Operations::ExcludeClipRectangle (r));
+}
+
+void DisplayList::clipToPath (const Path& path, const AffineTransform& t)
+{
+    stateTracker.clipToPath (path, t);
+    addOperation (new Operations::ClipToPath (path, t));
+}
+
+void DisplayList::clipToImageAlpha (const Image& sourceImage, const AffineTransform& t)
+{
+    stateTracker.clipToImageAlpha (sourceImage, t);
+    addOperation (new Operations::ClipToImageAlpha (sourceImage, t));
+}
+
+//==============================================================================
+void DisplayList::saveState()
+{
+    stateTracker.saveState();
+    addOperation (new Operations::SaveState());
+}
+
+void DisplayList::restoreState()
+{
+    stateTracker.restoreState();
+    addOperation (new Operations::RestoreState());
+}
+
+void DisplayList::beginTransparencyLayer (float opacity)
+{
+    // the tracker only needs to know about the state, not to allocate a layer image
+    stateTracker.saveState();
+    addOperation (new Operations::BeginTransparencyLayer (opacity));
+    ++transparencyLayerDepth;
+}
+
+void DisplayList::endTransparencyLayer()
+{
+    jassert (transparencyLayerDepth > 0);
+    --transparencyLayerDepth;
+
+    stateTracker.restoreState();
+    addOperation (new Operations::EndTransparencyLayer());
+    ++numDrawingOperations;
+}
+
+//==============================================================================
+void DisplayList::setFill (const FillType& fillType)
+{
+    stateTracker.setFill (fillType);
+    addOperation (new Operations::SetFill (fillType));
+}
+
+void DisplayList::setOpacity (float newOpacity)
+{
+    stateTracker.setOpacity (newOpacity);
+    addOperation (new Operations::SetOpacity (newOpacity));
+}
+
+void DisplayList::setInterpolationQuality (Graphics::ResamplingQuality quality)
+{
+    stateTracker.setInterpolationQuality (quality);
+    addOperation (new Operations::SetInterpolationQuality (quality));
+}
+
+//==============================================================================
+void DisplayList::fillRect (const Rectangle<int>& r, const bool replaceExistingContents)
+{
+    addDrawingOperation (new Operations::FillRect (r, replaceExistingContents));
+}
+
+void DisplayList::fillPath (const Path& path, const AffineTransform& t)
+{
+    addDrawingOperation (new Operations::FillPath (path, t));
+}
+
+void DisplayList::drawImage (const Image& sourceImage, const AffineTransform& t)
+{
+    addDrawingOperation (new Operations::DrawImage (sourceImage, t));
+}
+
+void DisplayList::drawLine (const Line <float>& line)
+{
+    addDrawingOperation (new Operations::DrawLine (line));
+}
+
+void DisplayList::drawVerticalLine (const int x, const float top, const float bottom)
+{
+    addDrawingOperation (new Operations::DrawVerticalLine (x, top, bottom));
+}
+
+void DisplayList::drawHorizontalLine (const int y, const float left, const float right)
+{
+    addDrawingOperation (new Operations::DrawHorizontalLine (y, left, right));
+}
+
+//==============================================================================
+void DisplayList::setFont (const Font& newFont)
+{
+    // The typeface is looked up now, so that the rendering threads don't all try to
+    // do it at the same time.
+    newFont.getTypeface();
+
+    stateTracker.setFont (newFont);
+    addOperation (new Operations::SetFont (newFont));
+}
+
+const Font& DisplayList::getFont()
+{
+    return stateTracker.getFont();
+}
+
+void DisplayList::drawGlyph (int glyphNumber, const AffineTransform& transform)
+{
+    if (transform.isOnlyTranslation() && stateTracker.getTransform().isOnlyTranslated)
+    {
+        // these glyphs are drawn from the shared glyph cache, which is thread-safe, so the
+        // list can be replayed on any thread
+        addDrawingOperation (new Operations::DrawGlyph (glyphNumber, transform));
+    }
+    else
+    {
+        // Other glyphs would have to be fetched from the typeface by each rendering
+        // thread, and typefaces aren't thread-safe, so their outlines are fetched here.
+        const Font& f = stateTracker.getFont();
+        const float fontHeight = f.getHeight();
+        Path p;
+        f.getTypeface()->getOutlineForGlyph (glyphNumber, p);
+
+        addDrawingOperation (new Operations::FillPath (p, AffineTransform::scale (fontHeight * f.getHorizontalScale(), fontHeight)
+                                                                                        .followedBy (transform)));
+    }
+}
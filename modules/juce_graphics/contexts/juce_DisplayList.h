@@ -0,0 +1,176 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_DISPLAYLIST_JUCEHEADER__
+#define __JUCE_DISPLAYLIST_JUCEHEADER__
+
+#include "juce_GraphicsContext.h"
+#include "juce_LowLevelGraphicsSoftwareRenderer.h"
+
+//==============================================================================
+/**
+    A graphics context that records the drawing operations that are performed on it,
+    so that they can be replayed later onto another context.
+
+    You can use a DisplayList to keep a compact recording of something that's expensive
+    to draw, and redraw it as many times as you like without running the original drawing
+    code again, e.g.
+    @code
+    DisplayList list (getLocalBounds());
+
+    {
+        Graphics recorder (&list);
+        paintSomethingComplicated (recorder);
+    }
+
+    // ... later, in a paint() method:
+    list.draw (g);
+    @endcode
+
+    The clip and transform are tracked as the operations are recorded, so that the clip
+    queries such as getClipBounds() and clipRegionIntersects() behave just as they would on
+    a software renderer whose clip region is the area that the list was created with.
+
+    When a list is replayed, any drawing operations that were recorded with a clip region
+    that doesn't overlap the target's clip are skipped. Replaying doesn't modify the list,
+    so a list that's no longer being recorded into can be replayed by several threads at
+    once. Any Images that are drawn into a list are referenced rather than copied, so they
+    must stay unmodified for as long as the list is in use.
+
+    @see Graphics, Component::setBufferedToDisplayList
+*/
+class JUCE_API  DisplayList    : public LowLevelGraphicsContext
+{
+public:
+    //==============================================================================
+    /** Creates an empty list to record into.
+
+        @param area     the initial clip region for the recording. The coordinate space of the
+                        recording starts off the same as the space of the Graphics context that
+                        it's replayed into.
+    */
+    explicit DisplayList (const Rectangle<int>& area);
+
+    /** Destructor. */
+    ~DisplayList();
+
+    //==============================================================================
+    /** Replays all the recorded drawing operations into a Graphics context.
+
+        The state of the context isn't changed by this, apart from the pixels that are
+        drawn, and the operations are drawn relative to the context's current origin and
+        transform.
+    */
+    void draw (Graphics& g) const;
+
+    /** Replays the recorded operations into a low-level context.
+
+        Unlike draw(), this doesn't save and restore the context's state around the
+        operations, so any state changes that they make will be left in the target.
+
+        @param target               the context to draw into
+        @param area                 the region of the recording that's being drawn, in the list's
+                                    device space. Drawing operations that were recorded with a
+                                    clip region that doesn't overlap this area are skipped.
+        @param firstOperationToDraw operations before this index will only have their effect on
+                                    the clip, transform and other state replayed, without
+                                    doing any drawing
+    */
+    void replay (LowLevelGraphicsContext& target, const Rectangle<int>& area,
+                 int firstOperationToDraw = 0) const;
+
+    /** Returns the number of operations that have been recorded. */
+    int getNumOperations() const noexcept;
+
+    /** Returns the number of recorded operations that actually draw something. */
+    int getNumDrawingOperations() const noexcept;
+
+    //==============================================================================
+    bool isVectorDevice() const;
+    void setOrigin (int x, int y);
+    void addTransform (const AffineTransform&);
+    float getScaleFactor();
+    bool clipToRectangle (const Rectangle<int>&);
+    bool clipToRectangleList (const RectangleList&);
+    void excludeClipRectangle (const Rectangle<int>&);
+    void clipToPath (const Path&, const AffineTransform&);
+    void clipToImageAlpha (const Image&, const AffineTransform&);
+    bool clipRegionIntersects (const Rectangle<int>&);
+    Rectangle<int> getClipBounds() const;
+    bool isClipEmpty() const;
+
+    void saveState();
+    void restoreState();
+
+    void beginTransparencyLayer (float opacity);
+    void endTransparencyLayer();
+
+    void setFill (const FillType&);
+    void setOpacity (float opacity);
+    void setInterpolationQuality (Graphics::ResamplingQuality);
+
+    void fillRect (const Rectangle<int>&, bool replaceExistingContents);
+    void fillPath (const Path&, const AffineTransform&);
+
+    void drawImage (const Image&, const AffineTransform&);
+
+    void drawLine (const Line <float>&);
+    void drawVerticalLine (int x, float top, float bottom);
+    void drawHorizontalLine (int x, float top, float bottom);
+
+    void setFont (const Font&);
+    const Font& getFont();
+    void drawGlyph (int glyphNumber, const AffineTransform&);
+
+protected:
+    //==============================================================================
+    /** Creates a list whose device space is that of a software renderer for the given image.
+        This is used by LowLevelGraphicsTiledRenderer, which records its operations in the
+        coordinate space of the image that it's drawing onto.
+    */
+    DisplayList (const Image& image, Point<int> origin, const RectangleList& initialClip);
+
+    /** Returns the number of transparency layers that have been started but not yet ended. */
+    int getTransparencyLayerDepth() const noexcept          { return transparencyLayerDepth; }
+
+private:
+    //==============================================================================
+    class Operation;
+    struct Operations;
+    friend class OwnedArray<Operation>;
+
+    // keeps track of the clip and transform as the operations are recorded, but doesn't draw anything
+    LowLevelGraphicsSoftwareRenderer stateTracker;
+
+    OwnedArray<Operation> operations;
+    int numDrawingOperations, transparencyLayerDepth;
+
+    void addOperation (Operation*);
+    void addDrawingOperation (Operation*);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DisplayList)
+};
+
+
+#endif   // __JUCE_DISPLAYLIST_JUCEHEADER__
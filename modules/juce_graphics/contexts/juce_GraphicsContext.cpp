@@ -34,6 +34,214 @@ namespace
             && (int) w >= -maxVal && (int) w <= maxVal
             && (int) h >= -maxVal && (int) h <= maxVal;
     }
+
+    //==============================================================================
+    /*  Keeps the most recently-used text layouts, so that repainting the same string in
+        the same font and box (e.g. a label that's redrawn every frame) doesn't need to
+        lay out the glyphs again.
+
+        Each layout is stored relative to the origin of its box, and translated to
+        wherever it's being drawn, so moving a component around doesn't invalidate it.
+    */
+    class GlyphArrangementCache  : private DeletedAtShutdown
+    {
+    public:
+        enum LayoutType
+        {
+            singleLine,
+            multiLine,
+            curtailedLine,
+            fittedText
+        };
+
+        struct Key
+        {
+            Key (LayoutType type_, const Font& font_, const String& text_, int width_, int height_,
+                 int justification_, int maxLines_, float minHorizontalScale_) noexcept
+                : type (type_), font (font_), text (text_), width (width_), height (height_),
+                  justification (justification_), maxLines (maxLines_), minHorizontalScale (minHorizontalScale_),
+                  hash ((uint32) text_.hashCode()
+                          ^ ((uint32) type_ << 28) ^ ((uint32) width_ * 7919u) ^ ((uint32) height_ * 104729u)
+                          ^ ((uint32) justification_ << 16) ^ (uint32) roundToInt (font_.getHeight() * 64.0f))
+            {}
+
+            bool operator== (const Key& other) const noexcept
+            {
+                return hash == other.hash
+                        && type == other.type
+                        && width == other.width
+                        && height == other.height
+                        && justification == other.justification
+                        && maxLines == other.maxLines
+                        && minHorizontalScale == other.minHorizontalScale
+                        && text == other.text
+                        && font == other.font;
+            }
+
+            void createArrangement (GlyphArrangement& arr) const
+            {
+                switch (type)
+                {
+                    case singleLine:
+                    {
+                        arr.addLineOfText (font, text, 0.0f, 0.0f);
+
+                        const int flags = Justification (justification).getOnlyHorizontalFlags();
+
+                        if (flags != Justification::left)
+                        {
+                            float w = arr.getBoundingBox (0, -1, true).getWidth();
+
+                            if ((flags & (Justification::horizontallyCentred | Justification::horizontallyJustified)) != 0)
+                                w /= 2.0f;
+
+                            arr.moveRangeOfGlyphs (0, -1, -w, 0.0f);
+                        }
+
+                        break;
+                    }
+
+                    case multiLine:
+                        arr.addJustifiedText (font, text, 0.0f, 0.0f, (float) width, Justification::left);
+                        break;
+
+                    case curtailedLine:
+                        arr.addCurtailedLineOfText (font, text, 0.0f, 0.0f, (float) width, maxLines != 0);
+                        arr.justifyGlyphs (0, arr.getNumGlyphs(), 0.0f, 0.0f, (float) width, (float) height,
+                                           Justification (justification));
+                        break;
+
+                    case fittedText:
+                        arr.addFittedText (font, text, 0.0f, 0.0f, (float) width, (float) height,
+                                           Justification (justification), maxLines, minHorizontalScale);
+                        break;
+
+                    default:
+                        jassertfalse;
+                        break;
+                }
+            }
+
+            LayoutType type;
+            Font font;
+            String text;
+            int width, height, justification, maxLines;
+            float minHorizontalScale;
+            uint32 hash;
+        };
+
+        GlyphArrangementCache()
+        {
+            for (int i = numSlots; --i >= 0;)
+                layouts.add (new CachedLayout());
+        }
+
+        ~GlyphArrangementCache()
+        {
+            getSingletonPointer() = nullptr;
+        }
+
+        static GlyphArrangementCache& getInstance()
+        {
+            GlyphArrangementCache*& c = getSingletonPointer();
+
+            if (c == nullptr)
+                c = new GlyphArrangementCache();
+
+            return *c;
+        }
+
+        void draw (const Graphics& g, const Key& key, const float x, const float y)
+        {
+            const AffineTransform transform (AffineTransform::translation (x, y));
+            ++accessCounter;
+
+            {
+                // (the layout is drawn while the lock is held, so that no other thread can
+                // replace it in the meantime)
+                const ScopedReadLock srl (lock);
+
+                if (CachedLayout* const layout = findExistingLayout (key))
+                {
+                    layout->lastAccessCount = accessCounter.value;
+                    layout->arrangement.draw (g, transform);
+                    return;
+                }
+            }
+
+            const ScopedWriteLock swl (lock);
+
+            // (another thread may have added this layout since the read lock was released)
+            CachedLayout* layout = findExistingLayout (key);
+
+            if (layout == nullptr)
+            {
+                layout = findLeastRecentlyUsedLayout();
+                layout->arrangement.clear();
+                layout->key = new Key (key);
+                key.createArrangement (layout->arrangement);
+            }
+
+            layout->lastAccessCount = accessCounter.value;
+            layout->arrangement.draw (g, transform);
+        }
+
+    private:
+        enum { numSlots = 256 };
+
+        struct CachedLayout
+        {
+            CachedLayout() noexcept : lastAccessCount (0) {}
+
+            ScopedPointer<Key> key;
+            GlyphArrangement arrangement;
+            int lastAccessCount;
+        };
+
+        OwnedArray<CachedLayout> layouts;
+        Atomic<int> accessCounter;
+        ReadWriteLock lock;
+
+        CachedLayout* findExistingLayout (const Key& key) const noexcept
+        {
+            for (int i = layouts.size(); --i >= 0;)
+            {
+                CachedLayout* const c = layouts.getUnchecked (i);
+
+                if (c->key != nullptr && *(c->key) == key)
+                    return c;
+            }
+
+            return nullptr;
+        }
+
+        CachedLayout* findLeastRecentlyUsedLayout() const noexcept
+        {
+            CachedLayout* oldest = layouts.getLast();
+            int oldestCounter = oldest->lastAccessCount;
+
+            for (int i = layouts.size() - 1; --i >= 0;)
+            {
+                CachedLayout* const c = layouts.getUnchecked (i);
+
+                if (c->lastAccessCount <= oldestCounter)
+                {
+                    oldestCounter = c->lastAccessCount;
+                    oldest = c;
+                }
+            }
+
+            return oldest;
+        }
+
+        static GlyphArrangementCache*& getSingletonPointer() noexcept
+        {
+            static GlyphArrangementCache* c = nullptr;
+            return c;
+        }
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (GlyphArrangementCache)
+    };
 }
 
 //==============================================================================
@@ -227,27 +435,13 @@ void Graphics::drawSingleLineText (const String& text, const int startX, const i
     if (text.isNotEmpty()
          && startX < context.getClipBounds().getRight())
     {
-        GlyphArrangement arr;
-        arr.addLineOfText (context.getFont(), text, (float) startX, (float) baselineY);
-
         // Don't pass any vertical placement flags to this method - they'll be ignored.
         jassert (justification.getOnlyVerticalFlags() == 0);
 
-        const int flags = justification.getOnlyHorizontalFlags();
+        const GlyphArrangementCache::Key key (GlyphArrangementCache::singleLine, context.getFont(), text, 0, 0,
+                                              justification.getOnlyHorizontalFlags(), 0, 0.0f);
 
-        if (flags != Justification::left)
-        {
-            float w = arr.getBoundingBox (0, -1, true).getWidth();
-
-            if ((flags & (Justification::horizontallyCentred | Justification::horizontallyJustified)) != 0)
-                w /= 2.0f;
-
-            arr.draw (*this, AffineTransform::translation (-w, 0));
-        }
-        else
-        {
-            arr.draw (*this);
-        }
+        GlyphArrangementCache::getInstance().draw (*this, key, (float) startX, (float) baselineY);
     }
 }
 
@@ -257,11 +451,10 @@ void Graphics::drawMultiLineText (const String& text, const int startX,
     if (text.isNotEmpty()
          && startX < context.getClipBounds().getRight())
     {
-        GlyphArrangement arr;
-        arr.addJustifiedText (context.getFont(), text,
-                              (float) startX, (float) baselineY, (float) maximumLineWidth,
-                              Justification::left);
-        arr.draw (*this);
+        const GlyphArrangementCache::Key key (GlyphArrangementCache::multiLine, context.getFont(), text,
+                                              maximumLineWidth, 0, Justification::left, 0, 0.0f);
+
+        GlyphArrangementCache::getInstance().draw (*this, key, (float) startX, (float) baselineY);
     }
 }
 
@@ -271,16 +464,11 @@ void Graphics::drawText (const String& text, const Rectangle<int>& area,
 {
     if (text.isNotEmpty() && context.clipRegionIntersects (area))
     {
-        GlyphArrangement arr;
-        arr.addCurtailedLineOfText (context.getFont(), text,
-                                    0.0f, 0.0f, (float) area.getWidth(),
-                                    useEllipsesIfTooBig);
-
-        arr.justifyGlyphs (0, arr.getNumGlyphs(),
-                           (float) area.getX(), (float) area.getY(),
-                           (float) area.getWidth(), (float) area.getHeight(),
-                           justificationType);
-        arr.draw (*this);
+        const GlyphArrangementCache::Key key (GlyphArrangementCache::curtailedLine, context.getFont(), text,
+                                              area.getWidth(), area.getHeight(), justificationType.getFlags(),
+                                              useEllipsesIfTooBig ? 1 : 0, 0.0f);
+
+        GlyphArrangementCache::getInstance().draw (*this, key, (float) area.getX(), (float) area.getY());
     }
 }
 
@@ -298,15 +486,11 @@ void Graphics::drawFittedText (const String& text, const Rectangle<int>& area,
 {
     if (text.isNotEmpty() && (! area.isEmpty()) && context.clipRegionIntersects (area))
     {
-        GlyphArrangement arr;
-        arr.addFittedText (context.getFont(), text,
-                           (float) area.getX(), (float) area.getY(),
-                           (float) area.getWidth(), (float) area.getHeight(),
-                           justification,
-                           maximumNumberOfLines,
-                           minimumHorizontalScale);
-
-        arr.draw (*this);
+        const GlyphArrangementCache::Key key (GlyphArrangementCache::fittedText, context.getFont(), text,
+                                              area.getWidth(), area.getHeight(), justification.getFlags(),
+                                              maximumNumberOfLines, minimumHorizontalScale);
+
+        GlyphArrangementCache::getInstance().draw (*this, key, (float) area.getX(), (float) area.getY());
     }
 }
 
@@ -146,3 +146,8 @@ void LowLevelGraphicsSoftwareRenderer::drawGlyph (int glyphNumber, const AffineT
 
 void LowLevelGraphicsSoftwareRenderer::setFont (const Font& newFont)    { savedState->font = newFont; }
 const Font& LowLevelGraphicsSoftwareRenderer::getFont()                 { return savedState->font; }
+
+Rectangle<int> LowLevelGraphicsSoftwareRenderer::getDeviceSpaceClipBounds() const
+{
+    return savedState->clip != nullptr ? savedState->clip->getClipBounds() : Rectangle<int>();
+}
@@ -84,6 +84,7 @@ public:
 
     const Image& getImage() const noexcept                                          { return savedState->image; }
     const RenderingHelpers::TranslationOrTransform& getTransform() const noexcept   { return savedState->transform; }
+    Rectangle<int> getDeviceSpaceClipBounds() const;
 
 protected:
     RenderingHelpers::SavedStateStack <RenderingHelpers::SoftwareRendererSavedState> savedState;
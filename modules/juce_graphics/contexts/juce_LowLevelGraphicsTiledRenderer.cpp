@@ -0,0 +1,120 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+class LowLevelGraphicsTiledRenderer::TileRenderer
+{
+public:
+    TileRenderer (const LowLevelGraphicsTiledRenderer& r, const Array<Rectangle<int> >& t) noexcept
+        : renderer (&r), tiles (&t)
+    {
+    }
+
+    void operator() (const int index) const
+    {
+        renderer->renderTile (tiles->getReference (index));
+    }
+
+private:
+    const LowLevelGraphicsTiledRenderer* renderer;
+    const Array<Rectangle<int> >* tiles;
+};
+
+//==============================================================================
+LowLevelGraphicsTiledRenderer::LowLevelGraphicsTiledRenderer (const Image& image_, Point<int> origin,
+                                                              const RectangleList& initialClip_,
+                                                              ThreadPool& threadPool_, const int tileHeight_)
+    : DisplayList (image_, origin, initialClip_),
+      image (image_),
+      initialClip (initialClip_),
+      initialOrigin (origin),
+      threadPool (threadPool_),
+      tileHeight (jmax (8, tileHeight_)),
+      firstPendingOperation (0),
+      numDrawingOperationsFlushed (0)
+{
+    using namespace RenderingHelpers;
+
+    // make sure the glyph cache exists before any of the threads try to use it
+    GlyphCache <CachedGlyphEdgeTable <SoftwareRendererSavedState>, SoftwareRendererSavedState>::getInstance();
+}
+
+LowLevelGraphicsTiledRenderer::~LowLevelGraphicsTiledRenderer()
+{
+    // you must end any transparency layers before the renderer is deleted!
+    jassert (getTransparencyLayerDepth() == 0);
+
+    renderPendingOperations();
+}
+
+//==============================================================================
+void LowLevelGraphicsTiledRenderer::flush()
+{
+    // the contents of a transparency layer can't be drawn until the layer's been ended
+    if (getTransparencyLayerDepth() == 0)
+        renderPendingOperations();
+}
+
+void LowLevelGraphicsTiledRenderer::renderPendingOperations()
+{
+    if (getNumPendingOperations() == 0)
+        return;
+
+    // The tiles are horizontal bands that span the whole width of the clip region. This is
+    // because the rasteriser treats the first pixel of each run slightly differently from the
+    // rest, so splitting a line at an arbitrary x position could change the result.
+    Array<Rectangle<int> > tiles;
+    const Rectangle<int> bounds (initialClip.getBounds());
+
+    for (int y = bounds.getY(); y < bounds.getBottom(); y += tileHeight)
+    {
+        const Rectangle<int> tile (bounds.getX(), y, bounds.getWidth(), jmin (tileHeight, bounds.getBottom() - y));
+
+        if (initialClip.intersectsRectangle (tile))
+            tiles.add (tile);
+    }
+
+    if (tiles.size() > 1)
+        threadPool.parallelFor (0, tiles.size(), TileRenderer (*this, tiles), 1);
+    else if (tiles.size() == 1)
+        renderTile (bounds);
+
+    firstPendingOperation = getNumOperations();
+    numDrawingOperationsFlushed = getNumDrawingOperations();
+}
+
+int LowLevelGraphicsTiledRenderer::getNumPendingOperations() const noexcept
+{
+    return getNumDrawingOperations() - numDrawingOperationsFlushed;
+}
+
+void LowLevelGraphicsTiledRenderer::renderTile (const Rectangle<int>& tile) const
+{
+    RectangleList tileClip (initialClip);
+
+    if (tileClip.clipTo (tile))
+    {
+        LowLevelGraphicsSoftwareRenderer g (image, initialOrigin, tileClip);
+        replay (g, tile, firstPendingOperation);
+    }
+}
@@ -0,0 +1,103 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_LOWLEVELGRAPHICSTILEDRENDERER_JUCEHEADER__
+#define __JUCE_LOWLEVELGRAPHICSTILEDRENDERER_JUCEHEADER__
+
+#include "juce_DisplayList.h"
+
+//==============================================================================
+/**
+    A software renderer that splits the area being drawn into tiles, and rasterises
+    them in parallel on a ThreadPool.
+
+    Rather than drawing anything immediately, this records all the drawing operations
+    that are performed on it into a DisplayList. When the object is deleted (or flush() is called), the
+    clip region it was created with is divided into horizontal bands, and each of the pool's threads
+    replays the recording into a LowLevelGraphicsSoftwareRenderer that's clipped to the
+    tile it's working on. The result is exactly the same as if a single
+    LowLevelGraphicsSoftwareRenderer had been used, but large repaints can use all the
+    CPU's cores.
+
+    The clip state is tracked as the drawing calls are made, so the clip queries such as
+    getClipBounds() and clipRegionIntersects() behave just as they would for a normal
+    software renderer.
+
+    Any Images or other objects that are used while drawing must stay unmodified until
+    the recording has been flushed. To use this for everything a ComponentPeer draws,
+    see LookAndFeel::setNumRenderingThreads().
+
+    @see LowLevelGraphicsSoftwareRenderer, DisplayList
+*/
+class JUCE_API  LowLevelGraphicsTiledRenderer    : public DisplayList
+{
+public:
+    //==============================================================================
+    /** Creates a renderer that will draw onto the given image.
+
+        @param imageToRenderOnto    the image to draw onto
+        @param origin               the initial origin, as for LowLevelGraphicsSoftwareRenderer
+        @param initialClip          the region of the image that may be drawn on, which is the
+                                    area that gets split up into tiles
+        @param threadPool           the pool to use for the rasterising. This must not be deleted
+                                    while the renderer is still in use.
+        @param tileHeight           the height of the bands that the clip region is split into
+    */
+    LowLevelGraphicsTiledRenderer (const Image& imageToRenderOnto, Point<int> origin,
+                                   const RectangleList& initialClip,
+                                   ThreadPool& threadPool, int tileHeight = 64);
+
+    /** Destructor. This will flush any drawing operations that haven't yet been rendered. */
+    ~LowLevelGraphicsTiledRenderer();
+
+    //==============================================================================
+    /** Renders all the drawing operations that have been recorded so far.
+
+        This blocks until all the tiles are finished. The current drawing state is left
+        unchanged, so more drawing operations can be performed and flushed afterwards.
+    */
+    void flush();
+
+    /** Returns the number of drawing operations that are waiting to be rendered. */
+    int getNumPendingOperations() const noexcept;
+
+private:
+    //==============================================================================
+    class TileRenderer;
+
+    Image image;
+    const RectangleList initialClip;
+    const Point<int> initialOrigin;
+    ThreadPool& threadPool;
+    const int tileHeight;
+    int firstPendingOperation, numDrawingOperationsFlushed;
+
+    void renderPendingOperations();
+    void renderTile (const Rectangle<int>& tile) const;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LowLevelGraphicsTiledRenderer)
+};
+
+
+#endif   // __JUCE_LOWLEVELGRAPHICSTILEDRENDERER_JUCEHEADER__
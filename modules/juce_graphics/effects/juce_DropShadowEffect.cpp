@@ -22,45 +22,216 @@
   ==============================================================================
 */
 
-static inline void blurDataTriplets (uint8* d, int num, const int delta) noexcept
+namespace BoxBlurHelpers
 {
-    uint32 last = d[0];
-    d[0] = (uint8) ((d[0] + d[delta] + 1) / 3);
-    d += delta;
+    // Finds the radii of three box filters which, applied one after the other, give
+    // roughly the same result as a gaussian blur with the given standard deviation.
+    static void getBoxRadii (const double sigma, int* radii) noexcept
+    {
+        const int numBoxes = 3;
+        const double variance = sigma * sigma;
+
+        int lowerWidth = (int) std::sqrt (12.0 * variance / numBoxes + 1.0);
+        if ((lowerWidth & 1) == 0)
+            --lowerWidth;
 
-    num -= 2;
+        const int numLower = roundToInt ((12.0 * variance - numBoxes * lowerWidth * lowerWidth
+                                            - 4.0 * numBoxes * lowerWidth - 3.0 * numBoxes)
+                                           / (-4.0 * lowerWidth - 4.0));
 
-    do
+        for (int i = 0; i < numBoxes; ++i)
+            radii[i] = jmax (0, ((i < numLower ? lowerWidth : lowerWidth + 2) - 1) / 2);
+    }
+
+    // Each output pixel is the average of the 2 * radius + 1 pixels around it, with
+    // pixels beyond the ends counting as zero. The sum is kept as a running total, so
+    // the cost doesn't depend on the radius.
+    static void blurRow (const uint8* const src, uint8* const dest, const int num, const int radius) noexcept
     {
-        const uint32 newLast = d[0];
-        d[0] = (uint8) ((last + d[0] + d[delta] + 1) / 3);
-        d += delta;
-        last = newLast;
+        const int scale = 65536 / (2 * radius + 1);
+        int sum = 0;
+
+        for (int i = jmin (radius, num); --i >= 0;)
+            sum += src[i];
+
+        for (int x = 0; x < num; ++x)
+        {
+            if (x + radius < num)
+                sum += src[x + radius];
+
+            dest[x] = (uint8) ((sum * scale + 32768) >> 16);
+
+            if (x >= radius)
+                sum -= src[x - radius];
+        }
     }
-    while (--num > 0);
 
-    d[0] = (uint8) ((last + d[0] + 1) / 3);
-}
+    // The vertical pass works along whole rows at a time, keeping a running total for
+    // each column, so that its inner loops run over contiguous memory.
+    static void blurColumns (const uint8* const src, const int srcStride,
+                             uint8* const dest, const int destStride,
+                             const int width, const int height, const int radius, int* const sums) noexcept
+    {
+        const int scale = 65536 / (2 * radius + 1);
 
-static void blurSingleChannelImage (uint8* const data, const int width, const int height,
-                                    const int lineStride, const int repetitions) noexcept
-{
-    jassert (width > 2 && height > 2);
+        for (int x = 0; x < width; ++x)
+            sums[x] = 0;
+
+        for (int y = jmin (radius, height); --y >= 0;)
+        {
+            const uint8* const line = src + y * srcStride;
+
+            for (int x = 0; x < width; ++x)
+                sums[x] += line[x];
+        }
+
+        for (int y = 0; y < height; ++y)
+        {
+            if (y + radius < height)
+            {
+                const uint8* const line = src + (y + radius) * srcStride;
+
+                for (int x = 0; x < width; ++x)
+                    sums[x] += line[x];
+            }
+
+            uint8* const out = dest + y * destStride;
+
+            for (int x = 0; x < width; ++x)
+                out[x] = (uint8) ((sums[x] * scale + 32768) >> 16);
+
+            if (y >= radius)
+            {
+                const uint8* const line = src + (y - radius) * srcStride;
+
+                for (int x = 0; x < width; ++x)
+                    sums[x] -= line[x];
+            }
+        }
+    }
+
+    // Applies an approximate gaussian blur to a single-channel image, and optionally
+    // multiplies the result by a gain factor.
+    static void blurSingleChannelImage (Image& image, const double sigma, const float gain = 1.0f)
+    {
+        const Image::BitmapData bm (image, Image::BitmapData::readWrite);
+        jassert (bm.pixelStride == 1);
+
+        const int w = bm.width;
+        const int h = bm.height;
+
+        if (w <= 0 || h <= 0)
+            return;
+
+        if (sigma > 0)
+        {
+            int radii[3];
+            getBoxRadii (sigma, radii);
+
+            HeapBlock<uint8> temp ((size_t) (w * h));
+            HeapBlock<int> sums ((size_t) w);
+
+            // Each pass goes between the image and the temp buffer, so that after an even
+            // number of passes the result ends up back in the image.
+            for (int y = 0; y < h; ++y)
+            {
+                uint8* const line = bm.getLinePointer (y);
+                uint8* const tempLine = temp + y * w;
+
+                blurRow (line, tempLine, w, radii[0]);
+                blurRow (tempLine, line, w, radii[1]);
+                blurRow (line, tempLine, w, radii[2]);
+            }
+
+            blurColumns (temp, w, bm.data, bm.lineStride, w, h, radii[0], sums);
+            blurColumns (bm.data, bm.lineStride, temp, w, w, h, radii[1], sums);
+            blurColumns (temp, w, bm.data, bm.lineStride, w, h, radii[2], sums);
+        }
+
+        if (gain != 1.0f)
+        {
+            const int intGain = roundToInt (gain * 256.0f);
 
-    for (int y = 0; y < height; ++y)
-        for (int i = repetitions; --i >= 0;)
-            blurDataTriplets (data + lineStride * y, width, 1);
+            for (int y = 0; y < h; ++y)
+            {
+                uint8* const line = bm.getLinePointer (y);
 
-    for (int x = 0; x < width; ++x)
-        for (int i = repetitions; --i >= 0;)
-            blurDataTriplets (data + x, height, lineStride);
+                for (int x = 0; x < w; ++x)
+                    line[x] = (uint8) jmin (255, (line[x] * intGain + 128) >> 8);
+            }
+        }
+    }
+
+    // Repeating the old three-pixel averaging filter 2 * radius times gave a blur with
+    // a variance of 4 * radius / 3, so shadows keep the same softness as they always had.
+    static double getSigmaForShadowRadius (const int radius) noexcept
+    {
+        return std::sqrt (4.0 * radius / 3.0);
+    }
 }
 
-static void blurSingleChannelImage (Image& image, int radius)
+//==============================================================================
+// Keeps the most recently blurred path shadows, so that repainting the same shape
+// doesn't need to blur it again.
+class DropShadowImageCache  : private DeletedAtShutdown
 {
-    const Image::BitmapData bm (image, Image::BitmapData::readWrite);
-    blurSingleChannelImage (bm.data, bm.width, bm.height, bm.lineStride, 2 * radius);
-}
+public:
+    DropShadowImageCache() {}
+
+    ~DropShadowImageCache()
+    {
+        clearSingletonInstance();
+    }
+
+    Image get (const int64 key)
+    {
+        const ScopedLock sl (lock);
+
+        for (int i = entries.size(); --i >= 0;)
+        {
+            if (entries.getReference (i).key == key)
+            {
+                const Entry e (entries.getReference (i));
+                entries.remove (i);
+                entries.add (e);
+                return e.image;
+            }
+        }
+
+        return Image::null;
+    }
+
+    void add (const int64 key, const Image& image)
+    {
+        const ScopedLock sl (lock);
+
+        if (entries.size() >= maxNumEntries)
+            entries.remove (0);
+
+        Entry e;
+        e.key = key;
+        e.image = image;
+        entries.add (e);
+    }
+
+    juce_DeclareSingleton (DropShadowImageCache, false);
+
+private:
+    struct Entry
+    {
+        int64 key;
+        Image image;
+    };
+
+    enum { maxNumEntries = 32 };
+
+    Array<Entry> entries;
+    CriticalSection lock;
+
+    JUCE_DECLARE_NON_COPYABLE (DropShadowImageCache)
+};
+
+juce_ImplementSingleton (DropShadowImageCache)
 
 //==============================================================================
 DropShadow::DropShadow() noexcept
@@ -83,7 +254,7 @@ void DropShadow::drawForImage (Graphics& g, const Image& srcImage) const
         Image shadowImage (srcImage.convertedToFormat (Image::SingleChannel));
         shadowImage.duplicateIfShared();
 
-        blurSingleChannelImage (shadowImage, radius);
+        BoxBlurHelpers::blurSingleChannelImage (shadowImage, BoxBlurHelpers::getSigmaForShadowRadius (radius));
 
         g.setColour (colour);
         g.drawImageAt (shadowImage, offset.x, offset.y, true);
@@ -94,22 +265,36 @@ void DropShadow::drawForPath (Graphics& g, const Path& path) const
 {
     jassert (radius > 0);
 
-    const Rectangle<int> area ((path.getBounds().getSmallestIntegerContainer() + offset)
-                                   .expanded (radius + 1)
-                                   .getIntersection (g.getClipBounds().expanded (radius + 1)));
+    const Rectangle<int> fullArea ((path.getBounds().getSmallestIntegerContainer() + offset).expanded (radius + 1));
+    const Rectangle<int> area (fullArea.getIntersection (g.getClipBounds().expanded (radius + 1)));
 
     if (area.getWidth() > 2 && area.getHeight() > 2)
     {
-        Image renderedPath (Image::SingleChannel, area.getWidth(), area.getHeight(), true);
+        // Only shadows that weren't cropped by the clip region can be re-used later.
+        const bool canCache = (area == fullArea);
+        const int64 key = ((path.hashCode64() * 101 + radius) * 101 + (offset.x - area.getX())) * 101 + (offset.y - area.getY());
+
+        Image renderedPath;
+
+        if (canCache)
+            renderedPath = DropShadowImageCache::getInstance()->get (key);
 
+        if (! renderedPath.isValid())
         {
-            Graphics g2 (renderedPath);
-            g2.setColour (Colours::white);
-            g2.fillPath (path, AffineTransform::translation ((float) (offset.x - area.getX()),
-                                                             (float) (offset.y - area.getY())));
-        }
+            renderedPath = Image (Image::SingleChannel, area.getWidth(), area.getHeight(), true);
+
+            {
+                Graphics g2 (renderedPath);
+                g2.setColour (Colours::white);
+                g2.fillPath (path, AffineTransform::translation ((float) (offset.x - area.getX()),
+                                                                 (float) (offset.y - area.getY())));
+            }
 
-        blurSingleChannelImage (renderedPath, radius);
+            BoxBlurHelpers::blurSingleChannelImage (renderedPath, BoxBlurHelpers::getSigmaForShadowRadius (radius));
+
+            if (canCache)
+                DropShadowImageCache::getInstance()->add (key, renderedPath);
+        }
 
         g.setColour (colour);
         g.drawImageAt (renderedPath, area.getX(), area.getY(), true);
@@ -41,14 +41,25 @@ void GlowEffect::setGlowProperties (const float newRadius,
 
 void GlowEffect::applyEffect (Image& image, Graphics& g, float scaleFactor, float alpha)
 {
-    Image temp (image.getFormat(), image.getWidth(), image.getHeight(), true);
-
-    ImageConvolutionKernel blurKernel (roundToInt (radius * scaleFactor * 2.0f));
-
-    blurKernel.createGaussianBlur (radius);
-    blurKernel.rescaleAllValues (radius);
-
-    blurKernel.applyToImage (temp, image, image.getBounds());
+    // Only the blurred alpha channel is used to draw the glow, so rather than convolving
+    // every channel with a 2D kernel, this blurs a single-channel copy with the separable
+    // box blur. The blur's width matches that of the kernel that used to be used: a
+    // gaussian with the given radius, cut off at the kernel's size and scaled up by radius.
+    Image temp (image.convertedToFormat (Image::SingleChannel));
+    temp.duplicateIfShared();
+
+    const int kernelSize = roundToInt (radius * scaleFactor * 2.0f);
+    double sum = 0, sumOfSquares = 0;
+
+    for (int i = 0; i < kernelSize; ++i)
+    {
+        const double d = i - (kernelSize >> 1);
+        const double weight = std::exp (-d * d / (2.0 * radius * radius));
+        sum += weight;
+        sumOfSquares += weight * d * d;
+    }
+
+    BoxBlurHelpers::blurSingleChannelImage (temp, sum > 0 ? std::sqrt (sumOfSquares / sum) : 0.0, radius);
 
     g.setColour (colour.withMultipliedAlpha (alpha));
     g.drawImageAt (temp, 0, 0, true);
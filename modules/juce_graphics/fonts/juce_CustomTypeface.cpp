@@ -148,6 +148,17 @@ CustomTypeface::~CustomTypeface()
 {
 }
 
+Typeface::Ptr CustomTypeface::createShared (const void* const serialisedTypefaceData, const size_t dataSize)
+{
+    const String key (SharedResourceRegistry::createContentKey ("CustomTypeface", serialisedTypefaceData, dataSize));
+
+    if (Typeface* const existing = dynamic_cast <Typeface*> (SharedResourceRegistry::find (key).get()))
+        return existing;
+
+    MemoryInputStream in (serialisedTypefaceData, dataSize, false);
+    return dynamic_cast <Typeface*> (SharedResourceRegistry::add (key, new CustomTypeface (in)).get());
+}
+
 //==============================================================================
 void CustomTypeface::clear()
 {
@@ -55,6 +55,18 @@ public:
     */
     explicit CustomTypeface (InputStream& serialisedTypefaceStream);
 
+    /** Returns a typeface loaded from a block of data that was created by writeToStream(),
+        sharing it with anything else in the process that has loaded identical data.
+
+        This is handy for fonts that are embedded in a plugin's binary data, because it means
+        that all the open instances of the plugin will share a single copy of the glyphs,
+        rather than each one loading its own. Because the typeface is shared, you mustn't
+        modify it.
+
+        @see SharedResourceRegistry
+    */
+    static Typeface::Ptr createShared (const void* serialisedTypefaceData, size_t dataSize);
+
     /** Destructor. */
     ~CustomTypeface();
 
@@ -51,16 +51,18 @@ public:
         clearSingletonInstance();
     }
 
-    juce_DeclareSingleton_SingleThreaded_Minimal (TypefaceCache);
+    juce_DeclareSingleton (TypefaceCache, false)
 
     void setSize (const int numToCache)
     {
+        const ScopedLock sl (lock);
         faces.clear();
         faces.insertMultiple (-1, CachedFace(), numToCache);
     }
 
     void clear()
     {
+        const ScopedLock sl (lock);
         setSize (faces.size());
         defaultFace = nullptr;
     }
@@ -72,54 +74,100 @@ public:
 
         jassert (faceName.isNotEmpty());
 
-        for (int i = faces.size(); --i >= 0;)
+        const PendingFace::Ptr pending (new PendingFace (faceName, faceStyle));
+
+        for (;;)
         {
-            CachedFace& face = faces.getReference(i);
+            PendingFace::Ptr other;
 
-            if (face.typefaceName == faceName
-                 && face.typefaceStyle == faceStyle
-                 && face.typeface != nullptr
-                 && face.typeface->isSuitableForFont (font))
             {
-                face.lastUsageCount = ++counter;
-                return face.typeface;
+                const ScopedLock sl (lock);
+
+                for (int i = faces.size(); --i >= 0;)
+                {
+                    CachedFace& face = faces.getReference(i);
+
+                    if (face.typefaceName == faceName
+                         && face.typefaceStyle == faceStyle
+                         && face.typeface != nullptr
+                         && face.typeface->isSuitableForFont (font))
+                    {
+                        face.lastUsageCount = ++counter;
+                        return face.typeface;
+                    }
+                }
+
+                for (int i = pendingFaces.size(); --i >= 0;)
+                    if (pendingFaces.getUnchecked(i)->typefaceName == faceName
+                         && pendingFaces.getUnchecked(i)->typefaceStyle == faceStyle)
+                        other = pendingFaces.getUnchecked(i);
+
+                if (other == nullptr)
+                {
+                    pendingFaces.add (pending);
+                    break;
+                }
             }
+
+            // another thread is already loading this face (e.g. an AssetPreloader), so
+            // wait for it to arrive in the cache rather than loading it a second time..
+            other->finished.wait();
         }
 
-        int replaceIndex = 0;
-        size_t bestLastUsageCount = std::numeric_limits<size_t>::max();
+        Typeface::Ptr typeface;
 
-        for (int i = faces.size(); --i >= 0;)
         {
-            const size_t lu = faces.getReference(i).lastUsageCount;
+            JUCE_TRACE_SCOPE ("Typeface load");
 
-            if (bestLastUsageCount > lu)
-            {
-                bestLastUsageCount = lu;
-                replaceIndex = i;
-            }
+            if (juce_getTypefaceForFont == nullptr)
+                typeface = Font::getDefaultTypefaceForFont (font);
+            else
+                typeface = juce_getTypefaceForFont (font);
         }
 
-        CachedFace& face = faces.getReference (replaceIndex);
-        face.typefaceName = faceName;
-        face.typefaceStyle = faceStyle;
-        face.lastUsageCount = ++counter;
+        jassert (typeface != nullptr); // the look and feel must return a typeface!
 
-        if (juce_getTypefaceForFont == nullptr)
-            face.typeface = Font::getDefaultTypefaceForFont (font);
-        else
-            face.typeface = juce_getTypefaceForFont (font);
+        const bool isDefaultFont = (font == Font());
+
+        {
+            const ScopedLock sl (lock);
+
+            int replaceIndex = 0;
+            size_t bestLastUsageCount = std::numeric_limits<size_t>::max();
+
+            for (int i = faces.size(); --i >= 0;)
+            {
+                const size_t lu = faces.getReference(i).lastUsageCount;
 
-        jassert (face.typeface != nullptr); // the look and feel must return a typeface!
+                if (bestLastUsageCount > lu)
+                {
+                    bestLastUsageCount = lu;
+                    replaceIndex = i;
+                }
+            }
+
+            if (faces.size() > 0)
+            {
+                CachedFace& face = faces.getReference (replaceIndex);
+                face.typefaceName = faceName;
+                face.typefaceStyle = faceStyle;
+                face.lastUsageCount = ++counter;
+                face.typeface = typeface;
+            }
+
+            if (defaultFace == nullptr && isDefaultFont)
+                defaultFace = typeface;
 
-        if (defaultFace == nullptr && font == Font())
-            defaultFace = face.typeface;
+            pendingFaces.removeObject (pending);
+        }
 
-        return face.typeface;
+        pending->finished.signal();
+        return typeface;
     }
 
     Typeface::Ptr getDefaultTypeface() const noexcept
     {
+        const ScopedLock sl (lock);
         return defaultFace;
     }
 
@@ -138,14 +186,28 @@ private:
         Typeface::Ptr typeface;
     };
 
+    struct PendingFace  : public ReferenceCountedObject
+    {
+        PendingFace (const String& name, const String& style)
+            : typefaceName (name), typefaceStyle (style), finished (true)
+        {}
+
+        typedef ReferenceCountedObjectPtr<PendingFace> Ptr;
+
+        const String typefaceName, typefaceStyle;
+        WaitableEvent finished;
+    };
+
     Array <CachedFace> faces;
+    ReferenceCountedArray<PendingFace> pendingFaces;
     Typeface::Ptr defaultFace;
     size_t counter;
+    CriticalSection lock;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TypefaceCache)
 };
 
-juce_ImplementSingleton_SingleThreaded (TypefaceCache)
+juce_ImplementSingleton (TypefaceCache)
 
 void Typeface::setTypefaceCacheSize (int numFontsToCache)
 {
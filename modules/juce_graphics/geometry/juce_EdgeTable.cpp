@@ -89,7 +89,7 @@ EdgeTable::EdgeTable (const Rectangle<int>& bounds_,
                     else if (x >= rightLimit)
                         x = rightLimit - 1;
 
-                    addEdgePoint (x, y1 >> 8, direction * step);
+                    addEdgePointUnsorted (x, y1 >> 8, direction * step);
                     y1 += step;
                 }
                 while (y1 < y2);
@@ -97,6 +97,7 @@ EdgeTable::EdgeTable (const Rectangle<int>& bounds_,
         }
     }
 
+    sortEdgePoints();
     sanitiseLevels (path.isUsingNonZeroWinding());
 }
 
@@ -335,6 +336,13 @@ void EdgeTable::remapTableForNumEdges (const int newNumEdgesPerLine)
     }
 }
 
+void EdgeTable::extendTableForMoreEdges()
+{
+    // The stride grows geometrically, because every resize has to copy the whole table: adding a
+    // fixed number of edges each time made complex paths spend most of their time re-copying it.
+    remapTableForNumEdges (maxEdgesPerLine + jmax (maxEdgesPerLine, juce_edgeTableDefaultEdgesPerLine));
+}
+
 void EdgeTable::optimiseTable()
 {
     int maxLineElements = 0;
@@ -375,7 +383,7 @@ void EdgeTable::addEdgePoint (const int x, const int y, const int winding)
 
         if (numPoints >= maxEdgesPerLine)
         {
-            remapTableForNumEdges (maxEdgesPerLine + juce_edgeTableDefaultEdgesPerLine);
+            extendTableForMoreEdges();
             jassert (numPoints < maxEdgesPerLine);
             line = table + lineStrideElements * y;
         }
@@ -388,6 +396,85 @@ void EdgeTable::addEdgePoint (const int x, const int y, const int winding)
     line[0]++;
 }
 
+void EdgeTable::addEdgePointUnsorted (const int x, const int y, const int winding)
+{
+    jassert (y >= 0 && y < bounds.getHeight());
+
+    int* line = table + lineStrideElements * y;
+    const int numPoints = line[0];
+
+    if (numPoints >= maxEdgesPerLine)
+    {
+        extendTableForMoreEdges();
+        jassert (numPoints < maxEdgesPerLine);
+        line = table + lineStrideElements * y;
+    }
+
+    line [(numPoints << 1) + 1] = x;
+    line [(numPoints << 1) + 2] = winding;
+    line[0]++;
+}
+
+namespace EdgeTableHelpers
+{
+    struct EdgePoint
+    {
+        int x, winding;
+    };
+
+    struct EdgePointComparator
+    {
+        static int compareElements (const EdgePoint& first, const EdgePoint& second) noexcept
+        {
+            return first.x < second.x ? -1 : (first.x > second.x ? 1 : 0);
+        }
+    };
+
+    static bool isSorted (const EdgePoint* const points, const int numPoints) noexcept
+    {
+        for (int i = 1; i < numPoints; ++i)
+            if (points[i].x <= points[i - 1].x)
+                return false;
+
+        return true;
+    }
+}
+
+void EdgeTable::sortEdgePoints() noexcept
+{
+    // Inserting each point into its sorted position as it arrives is quadratic when a line has
+    // lots of edges arriving in reverse order (e.g. the return side of a long stroked polyline),
+    // so the path constructor appends them unsorted, and they're sorted and merged here instead.
+    int* line = table;
+
+    for (int y = bounds.getHeight(); --y >= 0;)
+    {
+        const int numPoints = line[0];
+
+        EdgeTableHelpers::EdgePoint* const points = reinterpret_cast <EdgeTableHelpers::EdgePoint*> (line + 1);
+
+        if (numPoints > 1 && ! EdgeTableHelpers::isSorted (points, numPoints))
+        {
+            EdgeTableHelpers::EdgePointComparator comparator;
+            sortArray (comparator, points, 0, numPoints - 1, false);
+
+            int numMerged = 0;
+
+            for (int i = 1; i < numPoints; ++i)
+            {
+                if (points[i].x == points[numMerged].x)
+                    points[numMerged].winding += points[i].winding;
+                else
+                    points[++numMerged] = points[i];
+            }
+
+            line[0] = numMerged + 1;
+        }
+
+        line += lineStrideElements;
+    }
+}
+
 void EdgeTable::translate (float dx, const int dy) noexcept
 {
     bounds.translate ((int) std::floor (dx), dy);
@@ -495,7 +582,7 @@ void EdgeTable::intersectWithEdgeTableLine (const int y, const int* otherLine)
                 if (destTotal >= maxEdgesPerLine)
                 {
                     dest[0] = destTotal;
-                    remapTableForNumEdges (maxEdgesPerLine + juce_edgeTableDefaultEdgesPerLine);
+                    extendTableForMoreEdges();
                     dest = table + lineStrideElements * y;
                 }
 
@@ -512,7 +599,7 @@ void EdgeTable::intersectWithEdgeTableLine (const int y, const int* otherLine)
         if (destTotal >= maxEdgesPerLine)
         {
             dest[0] = destTotal;
-            remapTableForNumEdges (maxEdgesPerLine + juce_edgeTableDefaultEdgesPerLine);
+            extendTableForMoreEdges();
             dest = table + lineStrideElements * y;
         }
 
@@ -736,3 +823,74 @@ bool EdgeTable::isEmpty() noexcept
 
     return bounds.getHeight() == 0;
 }
+
+//==============================================================================
+#if JUCE_BENCHMARKS
+
+class EdgeTableBenchmarks  : public Benchmark
+{
+public:
+    EdgeTableBenchmarks() : Benchmark ("EdgeTable") {}
+
+    struct PixelCounter
+    {
+        PixelCounter() noexcept : total (0) {}
+
+        void setEdgeTableYPos (int) noexcept                                {}
+        void handleEdgeTablePixel (int, int alpha) noexcept                 { total += alpha; }
+        void handleEdgeTablePixelFull (int) noexcept                        { total += 255; }
+        void handleEdgeTableLine (int, int width, int alpha) noexcept       { total += width * alpha; }
+        void handleEdgeTableLineFull (int, int width) noexcept              { total += width * 255; }
+
+        int64 total;
+    };
+
+    void runBenchmark()
+    {
+        const Rectangle<int> clip (0, 0, 1000, 1000);
+
+        Path star;
+        star.addStar (Point<float> (500.0f, 500.0f), 50, 200.0f, 480.0f);
+
+        Path rectangles;
+        for (int i = 0; i < 40; ++i)
+            rectangles.addRoundedRectangle (20.0f + (i % 8) * 120.0f, 20.0f + (i / 8) * 190.0f, 100.0f, 170.0f, 15.0f);
+
+        beginMeasurement ("create from a 50-point star, 1000 x 1000");
+        while (keepRunning())
+        {
+            EdgeTable et (clip, star, AffineTransform::identity);
+            preventOptimisation (et);
+        }
+
+        beginMeasurement ("create from 40 rounded rectangles, 1000 x 1000");
+        while (keepRunning())
+        {
+            EdgeTable et (clip, rectangles, AffineTransform::rotation (0.1f, 500.0f, 500.0f));
+            preventOptimisation (et);
+        }
+
+        const EdgeTable starTable (clip, star, AffineTransform::identity);
+
+        beginMeasurement ("iterate a 50-point star, 1000 x 1000");
+        while (keepRunning())
+        {
+            PixelCounter counter;
+            starTable.iterate (counter);
+            preventOptimisation (counter.total);
+        }
+
+        beginMeasurement ("clip a 50-point star to 40 rounded rectangles");
+        const EdgeTable rectangleTable (clip, rectangles, AffineTransform::identity);
+        while (keepRunning())
+        {
+            EdgeTable et (starTable);
+            et.clipToEdgeTable (rectangleTable);
+            preventOptimisation (et);
+        }
+    }
+};
+
+static EdgeTableBenchmarks edgeTableBenchmarks;
+
+#endif
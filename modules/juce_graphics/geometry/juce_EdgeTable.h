@@ -197,7 +197,10 @@ private:
     bool needToCheckEmptinesss;
 
     void addEdgePoint (int x, int y, int winding);
+    void addEdgePointUnsorted (int x, int y, int winding);
+    void sortEdgePoints() noexcept;
     void remapTableForNumEdges (int newNumEdgesPerLine);
+    void extendTableForMoreEdges();
     void intersectWithEdgeTableLine (int y, const int* otherLine);
     void clipEdgeTableLineToRange (int* line, int x1, int x2) noexcept;
     void sanitiseLevels (bool useNonZeroWinding) noexcept;
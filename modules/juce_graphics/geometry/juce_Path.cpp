@@ -190,6 +190,24 @@ bool Path::operator!= (const Path& other) const noexcept
     return false;
 }
 
+int64 Path::hashCode64() const noexcept
+{
+    int64 hash = useNonZeroWinding ? 1 : 0;
+
+    for (size_t i = 0; i < numElements; ++i)
+    {
+        union { float asFloat; int32 asInt; } value;
+        value.asFloat = data.elements[i];
+
+        if (value.asFloat == 0)
+            value.asInt = 0; // (so that -0 and +0 produce the same hash, as they compare as equal)
+
+        hash = hash * 101 + value.asInt;
+    }
+
+    return hash;
+}
+
 void Path::clear() noexcept
 {
     numElements = 0;
@@ -207,6 +225,11 @@ void Path::swapWithPath (Path& other) noexcept
     std::swap (useNonZeroWinding, other.useNonZeroWinding);
 }
 
+void Path::preallocateSpace (int numExtraCoordsToMakeSpaceFor)
+{
+    data.ensureAllocatedSize ((int) numElements + numExtraCoordsToMakeSpaceFor);
+}
+
 //==============================================================================
 void Path::setUsingNonZeroWinding (const bool isNonZero) noexcept
 {
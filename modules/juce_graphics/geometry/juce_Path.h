@@ -91,6 +91,12 @@ public:
     bool operator== (const Path& other) const noexcept;
     bool operator!= (const Path& other) const noexcept;
 
+    /** Returns a hash code generated from the path's contents.
+        Paths that are equal will always produce the same hash code, so this can be used to
+        quickly check whether a path has changed since an earlier version of it was seen.
+    */
+    int64 hashCode64() const noexcept;
+
     //==============================================================================
     /** Returns true if the path doesn't contain any lines or curves. */
     bool isEmpty() const noexcept;
@@ -188,6 +194,17 @@ public:
     /** Removes all lines and curves, resetting the path completely. */
     void clear() noexcept;
 
+    /** Preallocates enough space for adding the given number of coordinates to the path.
+        If you're about to add a large number of lines or curves to the path, it can make
+        the task much more efficient to call this first and avoid costly reallocations
+        as the structure grows.
+        The actual value to pass is a bit tricky to calculate because the space required
+        depends on what you're adding - e.g. each lineTo() or startNewSubPath() will
+        require 3 coords (x, y and a type marker). Each quadraticTo() will need 5, and
+        a cubicTo() will require 7. Closing a sub-path will require 1.
+    */
+    void preallocateSpace (int numExtraCoordsToMakeSpaceFor);
+
     /** Begins a new subpath with a given starting position.
 
         This will move the path's current position to the co-ordinates passed in and
@@ -432,6 +432,10 @@ namespace PathStrokeHelpers
         if (arrowhead != nullptr)
             shortenSubPath (subPath, arrowhead->startLength, arrowhead->endLength);
 
+        // Each section adds at most two lines to both sides of the stroke for a mitred or bevelled
+        // joint, so make room for them all up-front rather than letting the path grow piecemeal..
+        destPath.preallocateSpace (subPath.size() * 12 + 32);
+
         const LineSection& firstLine = subPath.getReference (0);
 
         float lastX1 = firstLine.lx1;
@@ -319,6 +319,82 @@ namespace PNGHelpers
     }
 
     static void JUCE_CDECL warningCallback (png_structp, png_const_charp) {}
+
+    //==============================================================================
+    // Converts a row of pnglib's RGBA data to premultiplied PixelARGBs, giving the
+    // same results as calling PixelARGB::setARGB() and premultiply() on each pixel.
+    static void copyRowToARGB (uint8* dest, const int destStride, const uint8* src, int numPixels) noexcept
+    {
+       #if JUCE_USE_SSE_INTRINSICS
+        #if ! JUCE_64BIT
+        static const bool sse2Present = SystemStats::hasSSE2();
+        if (sse2Present)
+        #endif
+        {
+            if (destStride == (int) sizeof (PixelARGB))
+            {
+                const __m128i zero = _mm_setzero_si128();
+                const __m128i alphaLanes = _mm_set_epi16 (-1, 0, 0, 0, -1, 0, 0, 0);
+                const __m128i opaque = _mm_set1_epi16 (0xff);
+                const __m128i rounding = _mm_set1_epi16 (0x7f);
+
+                for (; numPixels >= 4; numPixels -= 4)
+                {
+                    const __m128i rgba = _mm_loadu_si128 ((const __m128i*) src);
+                    __m128i pixels[2] = { _mm_unpacklo_epi8 (rgba, zero), _mm_unpackhi_epi8 (rgba, zero) };
+
+                    for (int i = 0; i < 2; ++i)
+                    {
+                        // swap the R and B components to get PixelARGB's byte order..
+                        const __m128i p = _mm_shufflehi_epi16 (_mm_shufflelo_epi16 (pixels[i], _MM_SHUFFLE (3, 0, 1, 2)),
+                                                               _MM_SHUFFLE (3, 0, 1, 2));
+
+                        __m128i alpha = _mm_shufflehi_epi16 (_mm_shufflelo_epi16 (p, _MM_SHUFFLE (3, 3, 3, 3)),
+                                                             _MM_SHUFFLE (3, 3, 3, 3));
+
+                        // (multiplying by 256 leaves a component unchanged, so the alpha itself and
+                        // any opaque pixels come through untouched, as they do in premultiply())
+                        alpha = _mm_sub_epi16 (alpha, _mm_cmpeq_epi16 (alpha, opaque));
+                        alpha = _mm_or_si128 (_mm_andnot_si128 (alphaLanes, alpha),
+                                              _mm_and_si128 (alphaLanes, _mm_set1_epi16 (0x100)));
+
+                        pixels[i] = _mm_srli_epi16 (_mm_add_epi16 (_mm_mullo_epi16 (p, alpha), rounding), 8);
+                    }
+
+                    _mm_storeu_si128 ((__m128i*) dest, _mm_packus_epi16 (pixels[0], pixels[1]));
+                    dest += 16;
+                    src += 16;
+                }
+            }
+        }
+       #endif
+
+        while (--numPixels >= 0)
+        {
+            ((PixelARGB*) dest)->setARGB (src[3], src[0], src[1], src[2]);
+            ((PixelARGB*) dest)->premultiply();
+            dest += destStride;
+            src += 4;
+        }
+    }
+
+    static void copyRowToRGB (uint8* dest, const int destStride, const uint8* src, int numPixels) noexcept
+    {
+        while (--numPixels >= 0)
+        {
+            ((PixelRGB*) dest)->setARGB (0, src[0], src[1], src[2]);
+            dest += destStride;
+            src += 4;
+        }
+    }
+
+    static void copyRow (const Image::BitmapData& destData, const int y, const uint8* src, const bool hasAlphaChan) noexcept
+    {
+        if (hasAlphaChan)
+            copyRowToARGB (destData.getLinePointer (y), destData.pixelStride, src, destData.width);
+        else
+            copyRowToRGB (destData.getLinePointer (y), destData.pixelStride, src, destData.width);
+    }
    #endif
 }
 
@@ -399,25 +475,6 @@ Image PNGImageFormat::decodeImage (InputStream& in)
             bool hasAlphaChan = (colorType & PNG_COLOR_MASK_ALPHA) != 0
                                   || pngInfoStruct->num_trans > 0;
 
-            // Load the image into a temp buffer in the pnglib format..
-            const size_t lineStride = width * 4;
-            HeapBlock <uint8> tempBuffer (height * lineStride);
-
-            HeapBlock <png_bytep> rows (height);
-            for (int y = (int) height; --y >= 0;)
-                rows[y] = (png_bytep) (tempBuffer + lineStride * y);
-
-            try
-            {
-                png_read_image (pngReadStruct, rows);
-                png_read_end (pngReadStruct, pngInfoStruct);
-            }
-            catch (PNGHelpers::PNGErrorStruct&)
-            {}
-
-            png_destroy_read_struct (&pngReadStruct, &pngInfoStruct, 0);
-
-            // now convert the data to a juce image format..
             image = Image (hasAlphaChan ? Image::ARGB : Image::RGB,
                            (int) width, (int) height, hasAlphaChan);
 
@@ -425,32 +482,50 @@ Image PNGImageFormat::decodeImage (InputStream& in)
             hasAlphaChan = image.hasAlphaChannel(); // (the native image creator may not give back what we expect)
 
             const Image::BitmapData destData (image, Image::BitmapData::writeOnly);
+            const size_t lineStride = width * 4;
 
-            for (int y = 0; y < (int) height; ++y)
+            if (interlaceType == PNG_INTERLACE_NONE)
             {
-                const uint8* src = rows[y];
-                uint8* dest = destData.getLinePointer (y);
+                // Each row is converted to the juce image format as soon as it's been decoded,
+                // while it's still in the cache..
+                HeapBlock <uint8> rowBuffer (lineStride);
 
-                if (hasAlphaChan)
+                try
                 {
-                    for (int i = (int) width; --i >= 0;)
+                    for (int y = 0; y < (int) height; ++y)
                     {
-                        ((PixelARGB*) dest)->setARGB (src[3], src[0], src[1], src[2]);
-                        ((PixelARGB*) dest)->premultiply();
-                        dest += destData.pixelStride;
-                        src += 4;
+                        png_read_row (pngReadStruct, rowBuffer, 0);
+                        PNGHelpers::copyRow (destData, y, rowBuffer, hasAlphaChan);
                     }
+
+                    png_read_end (pngReadStruct, pngInfoStruct);
                 }
-                else
+                catch (PNGHelpers::PNGErrorStruct&)
+                {}
+            }
+            else
+            {
+                // An interlaced image has to be loaded into a temp buffer in the pnglib format
+                // before any of its rows are complete..
+                HeapBlock <uint8> tempBuffer (height * lineStride);
+
+                HeapBlock <png_bytep> rows (height);
+                for (int y = (int) height; --y >= 0;)
+                    rows[y] = (png_bytep) (tempBuffer + lineStride * y);
+
+                try
                 {
-                    for (int i = (int) width; --i >= 0;)
-                    {
-                        ((PixelRGB*) dest)->setARGB (0, src[0], src[1], src[2]);
-                        dest += destData.pixelStride;
-                        src += 4;
-                    }
+                    png_read_image (pngReadStruct, rows);
+                    png_read_end (pngReadStruct, pngInfoStruct);
                 }
+                catch (PNGHelpers::PNGErrorStruct&)
+                {}
+
+                for (int y = 0; y < (int) height; ++y)
+                    PNGHelpers::copyRow (destData, y, rows[y], hasAlphaChan);
             }
+
+            png_destroy_read_struct (&pngReadStruct, &pngInfoStruct, 0);
         }
         catch (PNGHelpers::PNGErrorStruct&)
         {}
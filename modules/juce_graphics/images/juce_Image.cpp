@@ -23,7 +23,7 @@
 */
 
 ImagePixelData::ImagePixelData (const Image::PixelFormat format, const int w, const int h)
-    : pixelFormat (format), width (w), height (h)
+    : pixelFormat (format), width (w), height (h), mipmapModificationCount (0)
 {
     jassert (format == Image::RGB || format == Image::ARGB || format == Image::SingleChannel);
     jassert (w > 0 && h > 0); // It's illegal to create a zero-sized image!
@@ -137,6 +137,7 @@ public:
 
     LowLevelGraphicsContext* createLowLevelContext()
     {
+        image->imageDataChanged();
         LowLevelGraphicsContext* g = image->createLowLevelContext();
         g->clipToRectangle (area);
         g->setOrigin (area.getX(), area.getY());
@@ -145,6 +146,9 @@ public:
 
     void initialiseBitmapData (Image::BitmapData& bitmap, int x, int y, Image::BitmapData::ReadWriteMode mode)
     {
+        if (mode != Image::BitmapData::readOnly)
+            image->imageDataChanged();
+
         image->initialiseBitmapData (bitmap, x + area.getX(), y + area.getY(), mode);
     }
 
@@ -166,6 +170,9 @@ public:
 
     ImageType* createType() const    { return image->createType(); }
 
+    // (all writes to a subsection are also counted by the image that it refers to)
+    int getModificationCount() const noexcept    { return image->getModificationCount(); }
+
 private:
     const ImagePixelData::Ptr image;
     const Rectangle<int> area;
@@ -245,7 +252,11 @@ bool Image::hasAlphaChannel() const noexcept            { return getFormat() !=
 
 LowLevelGraphicsContext* Image::createLowLevelContext() const
 {
-    return image == nullptr ? nullptr : image->createLowLevelContext();
+    if (image == nullptr)
+        return nullptr;
+
+    image->imageDataChanged();
+    return image->createLowLevelContext();
 }
 
 void Image::duplicateIfShared()
@@ -259,21 +270,99 @@ Image Image::createCopy() const
     return Image (image != nullptr ? image->clone() : nullptr);
 }
 
+//==============================================================================
+namespace ImageHelpers
+{
+    // Makes an image of half the size (rounded up) by averaging each 2x2 block of pixels.
+    // The pixel formats all store one byte per channel (premultiplied in the case of ARGB),
+    // so each byte of a pixel can simply be averaged independently.
+    static Image halveImageSize (const Image& source)
+    {
+        const int w = source.getWidth(), h = source.getHeight();
+        const int newW = (w + 1) / 2, newH = (h + 1) / 2;
+
+        const ScopedPointer<ImageType> type (source.getPixelData()->createType());
+        Image newImage (type->create (source.getFormat(), newW, newH, false));
+
+        const Image::BitmapData srcData (source, Image::BitmapData::readOnly);
+        const Image::BitmapData destData (newImage, Image::BitmapData::writeOnly);
+        jassert (srcData.pixelStride == destData.pixelStride);
+
+        const int stride = srcData.pixelStride;
+
+        for (int y = 0; y < newH; ++y)
+        {
+            const uint8* const line1 = srcData.getLinePointer (y * 2);
+            const uint8* const line2 = srcData.getLinePointer (jmin (y * 2 + 1, h - 1));
+            uint8* dest = destData.getLinePointer (y);
+
+            for (int x = 0; x < newW; ++x)
+            {
+                const int offset1 = x * 2 * stride;
+                const int offset2 = jmin (x * 2 + 1, w - 1) * stride;
+
+                for (int i = 0; i < stride; ++i)
+                    *dest++ = (uint8) ((line1[offset1 + i] + line1[offset2 + i]
+                                         + line2[offset1 + i] + line2[offset2 + i] + 2) >> 2);
+            }
+        }
+
+        return newImage;
+    }
+}
+
 Image Image::rescaled (const int newWidth, const int newHeight, const Graphics::ResamplingQuality quality) const
 {
     if (image == nullptr || (image->width == newWidth && image->height == newHeight))
         return *this;
 
+    Image source (*this);
+
+    if (quality != Graphics::lowResamplingQuality)
+        while (newWidth * 2 <= source.getWidth() && newHeight * 2 <= source.getHeight())
+            source = ImageHelpers::halveImageSize (source);
+
+    if (source.getWidth() == newWidth && source.getHeight() == newHeight)
+        return source;
+
     const ScopedPointer<ImageType> type (image->createType());
     Image newImage (type->create (image->pixelFormat, newWidth, newHeight, hasAlphaChannel()));
 
     Graphics g (newImage);
     g.setImageResamplingQuality (quality);
-    g.drawImage (*this, 0, 0, newWidth, newHeight, 0, 0, image->width, image->height, false);
+    g.drawImage (source, 0, 0, newWidth, newHeight, 0, 0, source.getWidth(), source.getHeight(), false);
 
     return newImage;
 }
 
+Image Image::getMipmapLevel (const int level) const
+{
+    if (image == nullptr || level <= 0)
+        return *this;
+
+    const ScopedLock sl (image->mipmapLock);
+
+    const int currentModificationCount = image->getModificationCount();
+
+    if (image->mipmapModificationCount != currentModificationCount)
+    {
+        image->mipmaps.clear();
+        image->mipmapModificationCount = currentModificationCount;
+    }
+
+    while (image->mipmaps.size() < level)
+    {
+        const Image previous (image->mipmaps.size() > 0 ? image->mipmaps.getLast() : *this);
+
+        if (previous.getWidth() <= 1 && previous.getHeight() <= 1)
+            break;
+
+        image->mipmaps.add (ImageHelpers::halveImageSize (previous));
+    }
+
+    return image->mipmaps.size() > 0 ? image->mipmaps [jmin (level, image->mipmaps.size()) - 1] : *this;
+}
+
 Image Image::convertedToFormat (PixelFormat newFormat) const
 {
     if (image == nullptr || newFormat == image->pixelFormat)
@@ -344,6 +433,9 @@ Image::BitmapData::BitmapData (Image& im, const int x, const int y, const int w,
     jassert (im.image != nullptr);
     jassert (x >= 0 && y >= 0 && w > 0 && h > 0 && x + w <= im.getWidth() && y + h <= im.getHeight());
 
+    if (mode != readOnly)
+        im.image->imageDataChanged();
+
     im.image->initialiseBitmapData (*this, x, y, mode);
     jassert (data != nullptr && pixelStride > 0 && lineStride != 0);
 }
@@ -366,6 +458,9 @@ Image::BitmapData::BitmapData (const Image& im, BitmapData::ReadWriteMode mode)
     // The BitmapData class must be given a valid image!
     jassert (im.image != nullptr);
 
+    if (mode != readOnly)
+        im.image->imageDataChanged();
+
     im.image->initialiseBitmapData (*this, 0, 0, mode);
     jassert (data != nullptr && pixelStride > 0 && lineStride != 0);
 }
@@ -193,12 +193,28 @@ public:
 
         A new image is returned which is a copy of this one, rescaled to the given size.
 
+        If the image is being shrunk to less than half its size and the quality isn't
+        lowResamplingQuality, it's first halved repeatedly by averaging blocks of pixels, so
+        that every source pixel contributes to the result rather than being skipped over.
+
         Note that if the new size is identical to the existing image, this will just return
         a reference to the original image, and won't actually create a duplicate.
     */
     Image rescaled (int newWidth, int newHeight,
                     Graphics::ResamplingQuality quality = Graphics::mediumResamplingQuality) const;
 
+    /** Returns a version of this image whose width and height have been halved the given number of times.
+
+        Each level is made by averaging 2x2 blocks of pixels from the level above it, and
+        level 0 is the image itself. The levels are kept alongside the image's pixel data, so
+        asking for them again is quick, and they get rebuilt if the image has been modified
+        since they were made. The renderer uses these when an image is drawn at less than half
+        its size, so that it doesn't alias.
+
+        If the image can't be halved that many times, the smallest available level is returned.
+    */
+    Image getMipmapLevel (int level) const;
+
     /** Creates a copy of this image.
         Note that it's usually more efficient to use duplicateIfShared(), because it may not be necessary
         to copy an image if nothing else is using it.
@@ -456,9 +472,26 @@ public:
     */
     NamedValueSet userData;
 
+    /** Marks any data that was derived from this image's pixels (e.g. its mipmaps) as stale.
+        This is called automatically when a writable BitmapData or a graphics context is
+        created for the image.
+    */
+    void imageDataChanged() noexcept                    { ++modificationCount; }
+
+    /** Returns a number that changes whenever imageDataChanged() is called, so that anything
+        that caches data derived from the image's pixels can tell when it has gone stale.
+    */
+    virtual int getModificationCount() const noexcept   { return modificationCount.get(); }
+
     typedef ReferenceCountedObjectPtr<ImagePixelData> Ptr;
 
 private:
+    friend class Image;
+    Atomic<int> modificationCount;
+    int mipmapModificationCount;
+    Array<Image> mipmaps;
+    CriticalSection mipmapLock;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ImagePixelData)
 };
 
@@ -26,12 +26,15 @@ class ImageCache::Pimpl     : private Timer,
                               private DeletedAtShutdown
 {
 public:
-    Pimpl()  : cacheTimeout (5000)
+    Pimpl()  : cacheTimeout (5000), deliveringLoad (nullptr), memoryLimit (0), totalBytes (0)
     {
     }
 
     ~Pimpl()
     {
+        if (decodePool != nullptr)
+            decodePool->removeAllJobs (true, 5000);
+
         clearSingletonInstance();
     }
 
@@ -41,16 +44,86 @@ public:
 
         for (int i = images.size(); --i >= 0;)
         {
-            const Item* const item = images.getUnchecked(i);
+            Item* const item = images.getUnchecked(i);
 
-            if (item->hashCode == hashCode)
+            if (item->hashCode == hashCode || item->aliases.contains (hashCode))
+            {
+                item->lastUseTime = Time::getApproximateMillisecondCounter();
                 return item->image;
+            }
         }
 
         return Image::null;
     }
 
-    void addImageToCache (const Image& image, const int64 hashCode)
+    /* Returns the image that's encoded in a block of data, using the key to look it up in
+       future. If an image with identical data is already cached (e.g. because another plugin
+       instance has loaded the same image from its own copy of a file), the new key just
+       becomes an alias for it, so that both share one decoded image.
+    */
+    Image getFromContent (const void* data, const size_t dataSize, const int64 hashCode)
+    {
+        const int64 contentHash = SharedResourceRegistry::getContentHash (data, dataSize);
+        const InFlightDecode::Ptr decode (new InFlightDecode (contentHash));
+
+        for (;;)
+        {
+            InFlightDecode::Ptr other;
+
+            {
+                const ScopedLock sl (lock);
+
+                for (int i = images.size(); --i >= 0;)
+                {
+                    Item* const item = images.getUnchecked(i);
+
+                    if (item->contentHash == contentHash && contentHash != 0)
+                    {
+                        item->aliases.addIfNotAlreadyThere (hashCode);
+                        item->lastUseTime = Time::getApproximateMillisecondCounter();
+                        return item->image;
+                    }
+                }
+
+                for (int i = inFlightDecodes.size(); --i >= 0;)
+                    if (inFlightDecodes.getUnchecked(i)->contentHash == contentHash && contentHash != 0)
+                        other = inFlightDecodes.getUnchecked(i);
+
+                if (other == nullptr)
+                {
+                    inFlightDecodes.add (decode);
+                    break;
+                }
+            }
+
+            // another thread (e.g. an AssetPreloader) is already decoding these
+            // same bytes, so wait for its result rather than decoding them twice..
+            other->finished.wait();
+
+            if (! other->succeeded)
+                break;
+        }
+
+        Image image;
+
+        {
+            JUCE_TRACE_SCOPE ("Image decode");
+            image = ImageFileFormat::loadFrom (data, dataSize);
+        }
+
+        addImageToCache (image, hashCode, contentHash);
+
+        {
+            const ScopedLock sl (lock);
+            inFlightDecodes.removeObject (decode);
+        }
+
+        decode->succeeded = image.isValid();
+        decode->finished.signal();
+        return image;
+    }
+
+    void addImageToCache (const Image& image, const int64 hashCode, const int64 contentHash = 0)
     {
         if (image.isValid())
         {
@@ -59,11 +132,17 @@ public:
 
             Item* const item = new Item();
             item->hashCode = hashCode;
+            item->contentHash = contentHash;
             item->image = image;
             item->lastUseTime = Time::getApproximateMillisecondCounter();
+            item->numBytes = getApproximateSize (image);
 
             const ScopedLock sl (lock);
             images.add (item);
+            totalBytes += item->numBytes;
+
+            if (memoryLimit > 0)
+                releaseLeastRecentlyUsed();
         }
     }
 
@@ -79,8 +158,9 @@ public:
 
             if (item->image.getReferenceCount() <= 1)
             {
-                if (now > item->lastUseTime + cacheTimeout || now < item->lastUseTime - 1000)
-                    images.remove (i);
+                if (memoryLimit == 0
+                     && (now > item->lastUseTime + cacheTimeout || now < item->lastUseTime - 1000))
+                    removeItem (i);
             }
             else
             {
@@ -88,6 +168,9 @@ public:
             }
         }
 
+        if (memoryLimit > 0)
+            releaseLeastRecentlyUsed();
+
         if (images.size() == 0)
             stopTimer();
     }
@@ -98,28 +181,248 @@ public:
 
         for (int i = images.size(); --i >= 0;)
             if (images.getUnchecked(i)->image.getReferenceCount() <= 1)
-                images.remove (i);
+                removeItem (i);
+    }
+
+    void setMemoryLimit (const int64 maxBytes)
+    {
+        const ScopedLock sl (lock);
+        memoryLimit = maxBytes;
+
+        if (memoryLimit > 0)
+            releaseLeastRecentlyUsed();
+    }
+
+    int64 getMemoryUsage() const
+    {
+        const ScopedLock sl (lock);
+        return totalBytes;
+    }
+
+    //==============================================================================
+    void loadAsync (const File& file, LoadCallback* const callback)
+    {
+        jassert (callback != nullptr);
+
+        const int64 hashCode = file.hashCode64();
+        const ScopedLock sl (lock);
+
+        for (int i = pendingLoads.size(); --i >= 0;)
+        {
+            PendingLoad* const p = pendingLoads.getUnchecked(i);
+
+            if (p->hashCode == hashCode)
+            {
+                p->callbacks.addIfNotAlreadyThere (callback);
+                return;
+            }
+        }
+
+        PendingLoad* const p = new PendingLoad (file, hashCode);
+        p->callbacks.add (callback);
+        pendingLoads.add (p);
+
+        const Image cached (getFromHashCode (hashCode));
+
+        if (cached.isValid())
+        {
+            (new DeliveryMessage (hashCode, cached))->post();
+        }
+        else
+        {
+            if (decodePool == nullptr)
+                decodePool = new ThreadPool (jlimit (1, 4, SystemStats::getNumCpus() - 1));
+
+            decodePool->addJob (new DecodeJob (file, hashCode), true);
+        }
+    }
+
+    void cancelAsyncLoads (LoadCallback* const callback)
+    {
+        const ScopedLock sl (lock);
+
+        for (int i = pendingLoads.size(); --i >= 0;)
+            pendingLoads.getUnchecked(i)->callbacks.removeAllInstancesOf (callback);
+
+        if (deliveringLoad != nullptr)
+            deliveringLoad->callbacks.removeAllInstancesOf (callback);
     }
 
     struct Item
     {
         Image image;
-        int64 hashCode;
+        int64 hashCode, contentHash;
+        Array<int64> aliases;
         uint32 lastUseTime;
+        int64 numBytes;
     };
 
     unsigned int cacheTimeout;
 
-    juce_DeclareSingleton_SingleThreaded_Minimal (ImageCache::Pimpl);
+    juce_DeclareSingleton (ImageCache::Pimpl, false);
 
 private:
+    //==============================================================================
+    struct InFlightDecode  : public ReferenceCountedObject
+    {
+        InFlightDecode (const int64 hash)  : contentHash (hash), finished (true), succeeded (false) {}
+
+        typedef ReferenceCountedObjectPtr<InFlightDecode> Ptr;
+
+        const int64 contentHash;
+        WaitableEvent finished;
+        bool succeeded;
+    };
+
+    //==============================================================================
+    struct PendingLoad
+    {
+        PendingLoad (const File& f, const int64 hash)  : file (f), hashCode (hash) {}
+
+        File file;
+        int64 hashCode;
+        Array<LoadCallback*> callbacks;
+    };
+
+    //==============================================================================
+    class DecodeJob  : public ThreadPoolJob
+    {
+    public:
+        DecodeJob (const File& f, const int64 hash)
+            : ThreadPoolJob ("Image decoder"), file (f), hashCode (hash)
+        {
+        }
+
+        JobStatus runJob()
+        {
+            if (! shouldExit())
+            {
+                JUCE_TRACE_SCOPE ("Image decode");
+                (new DeliveryMessage (hashCode, ImageFileFormat::loadFrom (file)))->post();
+            }
+
+            return jobHasFinished;
+        }
+
+    private:
+        const File file;
+        const int64 hashCode;
+
+        JUCE_DECLARE_NON_COPYABLE (DecodeJob)
+    };
+
+    //==============================================================================
+    class DeliveryMessage  : public CallbackMessage
+    {
+    public:
+        DeliveryMessage (const int64 hash, const Image& im)  : hashCode (hash), image (im) {}
+
+        void messageCallback()
+        {
+            if (Pimpl* const p = Pimpl::getInstanceWithoutCreating())
+                p->deliver (hashCode, image);
+        }
+
+    private:
+        const int64 hashCode;
+        const Image image;
+
+        JUCE_DECLARE_NON_COPYABLE (DeliveryMessage)
+    };
+
+    void deliver (const int64 hashCode, const Image& image)
+    {
+        ScopedPointer<PendingLoad> load;
+
+        {
+            const ScopedLock sl (lock);
+
+            for (int i = pendingLoads.size(); --i >= 0;)
+            {
+                if (pendingLoads.getUnchecked(i)->hashCode == hashCode)
+                {
+                    load = pendingLoads.removeAndReturn (i);
+                    break;
+                }
+            }
+
+            if (load == nullptr)
+                return;
+
+            if (image.isValid() && getFromHashCode (hashCode).isNull())
+                addImageToCache (image, hashCode);
+
+            deliveringLoad = load;
+        }
+
+        // (the list is re-checked each time, because a callback may cancel others while it runs)
+        for (;;)
+        {
+            LoadCallback* callback;
+
+            {
+                const ScopedLock sl (lock);
+
+                if (load->callbacks.size() == 0)
+                    break;
+
+                callback = load->callbacks.remove (0);
+            }
+
+            callback->imageLoaded (load->file, image);
+        }
+
+        const ScopedLock sl (lock);
+        deliveringLoad = nullptr;
+    }
+
+    //==============================================================================
     OwnedArray<Item> images;
+    OwnedArray<PendingLoad> pendingLoads;
+    ReferenceCountedArray<InFlightDecode> inFlightDecodes;
+    PendingLoad* deliveringLoad;
+    ScopedPointer<ThreadPool> decodePool;
     CriticalSection lock;
+    int64 memoryLimit, totalBytes;
+
+    static int64 getApproximateSize (const Image& image) noexcept
+    {
+        const int bytesPerPixel = image.isARGB() ? 4 : (image.isRGB() ? 3 : 1);
+        return image.getWidth() * (int64) image.getHeight() * bytesPerPixel;
+    }
+
+    void removeItem (const int index)
+    {
+        totalBytes -= images.getUnchecked (index)->numBytes;
+        images.remove (index);
+    }
+
+    void releaseLeastRecentlyUsed()
+    {
+        while (totalBytes > memoryLimit)
+        {
+            int oldest = -1;
+
+            for (int i = images.size(); --i >= 0;)
+            {
+                const Item* const item = images.getUnchecked(i);
+
+                if (item->image.getReferenceCount() <= 1
+                     && (oldest < 0 || item->lastUseTime < images.getUnchecked (oldest)->lastUseTime))
+                    oldest = i;
+            }
+
+            if (oldest < 0)
+                break;
+
+            removeItem (oldest);
+        }
+    }
 
     JUCE_DECLARE_NON_COPYABLE (Pimpl)
 };
 
-juce_ImplementSingleton_SingleThreaded (ImageCache::Pimpl);
+juce_ImplementSingleton (ImageCache::Pimpl);
 
 
 //==============================================================================
@@ -143,8 +446,21 @@ Image ImageCache::getFromFile (const File& file)
 
     if (image.isNull())
     {
-        image = ImageFileFormat::loadFrom (file);
-        addImageToCache (image, hashCode);
+        const MemoryMappedFile mappedFile (file, MemoryMappedFile::readOnly);
+
+        if (mappedFile.getData() != nullptr)
+        {
+            image = Pimpl::getInstance()->getFromContent (mappedFile.getData(), mappedFile.getSize(), hashCode);
+        }
+        else
+        {
+            {
+                JUCE_TRACE_SCOPE ("Image decode");
+                image = ImageFileFormat::loadFrom (file);
+            }
+
+            addImageToCache (image, hashCode);
+        }
     }
 
     return image;
@@ -156,20 +472,42 @@ Image ImageCache::getFromMemory (const void* imageData, const int dataSize)
     Image image (getFromHashCode (hashCode));
 
     if (image.isNull())
-    {
-        image = ImageFileFormat::loadFrom (imageData, (size_t) dataSize);
-        addImageToCache (image, hashCode);
-    }
+        image = Pimpl::getInstance()->getFromContent (imageData, (size_t) dataSize, hashCode);
 
     return image;
 }
 
+void ImageCache::getFromFileAsync (const File& file, LoadCallback* const callback)
+{
+    Pimpl::getInstance()->loadAsync (file, callback);
+}
+
+void ImageCache::cancelAsyncLoads (LoadCallback* const callback)
+{
+    if (Pimpl::getInstanceWithoutCreating() != nullptr)
+        Pimpl::getInstanceWithoutCreating()->cancelAsyncLoads (callback);
+}
+
 void ImageCache::setCacheTimeout (const int millisecs)
 {
     jassert (millisecs >= 0);
     Pimpl::getInstance()->cacheTimeout = (unsigned int) millisecs;
 }
 
+void ImageCache::setCacheMemoryLimit (const int64 maxBytes)
+{
+    jassert (maxBytes >= 0);
+    Pimpl::getInstance()->setMemoryLimit (maxBytes);
+}
+
+int64 ImageCache::getCacheMemoryUsage()
+{
+    if (Pimpl::getInstanceWithoutCreating() != nullptr)
+        return Pimpl::getInstanceWithoutCreating()->getMemoryUsage();
+
+    return 0;
+}
+
 void ImageCache::releaseUnusedImages()
 {
     Pimpl::getInstance()->releaseUnusedImages();
@@ -41,7 +41,17 @@
     loading/deleting the same image, it'll reduce the chances of having to reload it
     each time.
 
-    @see Image, ImageFileFormat
+    The cache is shared by everything in the process, and recognises images by their
+    contents as well as by where they came from, so e.g. several plugin instances that
+    each load the same image from a different file or block of memory will all end up
+    sharing a single decoded copy of it.
+
+    The cache can be used from any thread. If one thread asks for an image whose data is
+    already being decoded by another thread, it waits for that decode to finish instead
+    of repeating it, which is what lets an AssetPreloader warm the cache in the background
+    while a component is being built.
+
+    @see Image, ImageFileFormat, AssetPreloader
 */
 class JUCE_API  ImageCache
 {
@@ -49,9 +59,10 @@ public:
     //==============================================================================
     /** Loads an image from a file, (or just returns the image if it's already cached).
 
-        If the cache already contains an image that was loaded from this file,
-        that image will be returned. Otherwise, this method will try to load the
-        file, add it to the cache, and return it.
+        If the cache already contains an image that was loaded from this file, or
+        from any other file or block of memory with identical contents, that image will
+        be returned. Otherwise, this method will try to load the file, add it to the
+        cache, and return it.
 
         Remember that the image returned is shared, so drawing into it might
         affect other things that are using it! If you want to draw on it, first
@@ -66,8 +77,9 @@ public:
     /** Loads an image from an in-memory image file, (or just returns the image if it's already cached).
 
         If the cache already contains an image that was loaded from this block of memory,
-        that image will be returned. Otherwise, this method will try to load the
-        file, add it to the cache, and return it.
+        or from any other file or block of memory with identical contents, that image will
+        be returned. Otherwise, this method will try to load the file, add it to the cache,
+        and return it.
 
         Remember that the image returned is shared, so drawing into it might
         affect other things that are using it! If you want to draw on it, first
@@ -80,6 +92,49 @@ public:
     */
     static Image getFromMemory (const void* imageData, int dataSize);
 
+    //==============================================================================
+    /** Receives the images that are loaded by getFromFileAsync().
+        @see getFromFileAsync, cancelAsyncLoads
+    */
+    class JUCE_API  LoadCallback
+    {
+    public:
+        /** Destructor. */
+        virtual ~LoadCallback() {}
+
+        /** Called on the message thread when an image requested with getFromFileAsync()
+            is ready.
+
+            The image will be invalid if the file couldn't be loaded. If it is valid, it
+            will also have been added to the cache, so later calls to getFromFile() for the
+            same file will return it immediately.
+        */
+        virtual void imageLoaded (const File& file, const Image& image) = 0;
+    };
+
+    /** Loads an image from a file on a background thread, and delivers it to a callback on
+        the message thread.
+
+        This behaves like getFromFile(), except that the file is decoded by a background
+        thread pool, so a component that needs a lot of images (e.g. a skin with hundreds of
+        filmstrips) can request them all without blocking the message thread.
+
+        The callback is always invoked asynchronously, even if the image is already in the
+        cache. If several requests are made for the same file before it has finished loading,
+        it will only be decoded once, and each callback will receive the same image.
+
+        The callback object must stay valid until it has been called - if you need to delete
+        it before then, call cancelAsyncLoads() first.
+
+        @see getFromFile, cancelAsyncLoads
+    */
+    static void getFromFileAsync (const File& file, LoadCallback* callback);
+
+    /** Removes a callback from any pending getFromFileAsync() requests, so that it won't be
+        called. This must be called on the message thread.
+    */
+    static void cancelAsyncLoads (LoadCallback* callback);
+
     //==============================================================================
     /** Checks the cache for an image with a particular hashcode.
 
@@ -108,6 +163,26 @@ public:
     */
     static void setCacheTimeout (int millisecs);
 
+    /** Sets a limit on the amount of memory that the cache may use to hold images which
+        aren't being referenced anywhere else.
+
+        By default there's no limit, and unused images are released after the cache timeout
+        (see setCacheTimeout()). If you set a limit, unused images will be kept for as long
+        as they fit within it, and when it's exceeded, the least-recently used ones will be
+        released first. Images that are still in use are counted towards the total but are
+        never released.
+
+        @param maxBytes     the maximum size in bytes, or 0 to remove the limit and go back
+                            to using the timeout
+        @see getCacheMemoryUsage
+    */
+    static void setCacheMemoryLimit (int64 maxBytes);
+
+    /** Returns the approximate number of bytes of pixel data held by the images in the cache.
+        @see setCacheMemoryLimit
+    */
+    static int64 getCacheMemoryUsage();
+
     /** Releases any images in the cache that aren't being referenced by active
         Image objects.
     */
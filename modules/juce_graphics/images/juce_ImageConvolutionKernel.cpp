@@ -98,193 +98,262 @@ void ImageConvolutionKernel::createGaussianBlur (const float radius)
 }
 
 //==============================================================================
-void ImageConvolutionKernel::applyToImage (Image& destImage,
-                                           const Image& sourceImage,
-                                           const Rectangle<int>& destinationArea) const
+namespace ConvolutionHelpers
 {
-    if (sourceImage == destImage)
+    // Converts a run of pixels from a source line into floats. Any pixels that lie
+    // outside the image are set to zero.
+    static void loadLine (const Image::BitmapData& src, const int y, const int firstX,
+                          const int numPixels, float* const dest) noexcept
     {
-        destImage.duplicateIfShared();
+        const int numChannels = src.pixelStride;
+        const int start = jmax (0, -firstX);
+        const int end = jmin (numPixels, src.width - firstX);
+
+        for (int i = 0; i < numPixels * numChannels; ++i)
+            dest[i] = 0;
+
+        if (end > start)
+        {
+            const uint8* const s = src.getPixelPointer (firstX + start, y);
+            float* const d = dest + start * numChannels;
+
+            for (int i = 0; i < (end - start) * numChannels; ++i)
+                d[i] = s[i];
+        }
     }
-    else
+
+    static inline void addScaled (float* const dest, const float* const src, const float multiplier, const int num) noexcept
     {
-        if (sourceImage.getWidth() != destImage.getWidth()
-             || sourceImage.getHeight() != destImage.getHeight()
-             || sourceImage.getFormat() != destImage.getFormat())
+        for (int i = 0; i < num; ++i)
+            dest[i] += multiplier * src[i];
+    }
+
+    static void storeLine (const float* const src, uint8* const dest, const int num) noexcept
+    {
+        for (int i = 0; i < num; ++i)
+            dest[i] = (uint8) jlimit (0, 0xff, roundToInt (src[i]));
+    }
+
+    //==============================================================================
+    struct Convolver
+    {
+        Convolver (const float* kernelValues, const int kernelSize,
+                   const Image::BitmapData& source, const Image::BitmapData& dest, const Rectangle<int>& area)
+            : values (kernelValues), size (kernelSize), centre (kernelSize >> 1),
+              numChannels (dest.pixelStride), srcData (source), destData (dest), destArea (area),
+              isSeparable (findSeparableFactors())
         {
-            jassertfalse;
-            return;
         }
-    }
 
-    const Rectangle<int> area (destinationArea.getIntersection (destImage.getBounds()));
+        // Processes a range of the destination area's lines. Different ranges can be
+        // done at the same time on different threads.
+        void processLines (const int startLine, const int endLine) const
+        {
+            if (isSeparable)
+                processLinesSeparably (startLine, endLine);
+            else
+                processLinesDirectly (startLine, endLine);
+        }
 
-    if (area.isEmpty())
-        return;
+        const float* values;
+        const int size, centre, numChannels;
+        const Image::BitmapData& srcData;
+        const Image::BitmapData& destData;
+        const Rectangle<int> destArea;
+        HeapBlock<float> columnFactors, rowFactors;
+        const bool isSeparable;
+
+    private:
+        // If the kernel is the outer product of a column and a row (as blurs and many
+        // edge-detection kernels are), it can be applied as a horizontal pass followed
+        // by a vertical one, which costs 2 * size operations per pixel instead of size².
+        bool findSeparableFactors()
+        {
+            int pivot = 0;
 
-    const int right = area.getRight();
-    const int bottom = area.getBottom();
+            for (int i = 1; i < size * size; ++i)
+                if (std::abs (values[i]) > std::abs (values[pivot]))
+                    pivot = i;
 
-    const Image::BitmapData destData (destImage, area.getX(), area.getY(), area.getWidth(), area.getHeight(),
-                                      Image::BitmapData::writeOnly);
-    uint8* line = destData.data;
+            const float pivotValue = values[pivot];
 
-    const Image::BitmapData srcData (sourceImage, Image::BitmapData::readOnly);
+            if (size < 2 || pivotValue == 0)
+                return false;
 
-    if (destData.pixelStride == 4)
-    {
-        for (int y = area.getY(); y < bottom; ++y)
+            const int pivotX = pivot % size;
+            const int pivotY = pivot / size;
+
+            columnFactors.malloc ((size_t) size);
+            rowFactors.malloc ((size_t) size);
+
+            for (int i = 0; i < size; ++i)
+            {
+                columnFactors[i] = values [pivotX + i * size];
+                rowFactors[i] = values [i + pivotY * size] / pivotValue;
+            }
+
+            const float tolerance = std::abs (pivotValue) * 1.0e-5f;
+
+            for (int y = 0; y < size; ++y)
+                for (int x = 0; x < size; ++x)
+                    if (std::abs (values [x + y * size] - columnFactors[y] * rowFactors[x]) > tolerance)
+                        return false;
+
+            return true;
+        }
+
+        void processLinesDirectly (const int startLine, const int endLine) const
         {
-            uint8* dest = line;
-            line += destData.lineStride;
+            const int width = destArea.getWidth();
+            HeapBlock<float> sourceLine ((size_t) ((width + size) * numChannels));
+            HeapBlock<float> total ((size_t) (width * numChannels));
 
-            for (int x = area.getX(); x < right; ++x)
+            for (int line = startLine; line < endLine; ++line)
             {
-                float c1 = 0;
-                float c2 = 0;
-                float c3 = 0;
-                float c4 = 0;
+                const int y = destArea.getY() + line;
+
+                for (int i = 0; i < width * numChannels; ++i)
+                    total[i] = 0;
 
                 for (int yy = 0; yy < size; ++yy)
                 {
-                    const int sy = y + yy - (size >> 1);
-
-                    if (sy >= srcData.height)
-                        break;
+                    const int sy = y + yy - centre;
 
-                    if (sy >= 0)
+                    if (isPositiveAndBelow (sy, srcData.height))
                     {
-                        int sx = x - (size >> 1);
-                        const uint8* src = srcData.getPixelPointer (sx, sy);
+                        loadLine (srcData, sy, destArea.getX() - centre, width + size - 1, sourceLine);
 
                         for (int xx = 0; xx < size; ++xx)
-                        {
-                            if (sx >= srcData.width)
-                                break;
-
-                            if (sx >= 0)
-                            {
-                                const float kernelMult = values [xx + yy * size];
-                                c1 += kernelMult * *src++;
-                                c2 += kernelMult * *src++;
-                                c3 += kernelMult * *src++;
-                                c4 += kernelMult * *src++;
-                            }
-                            else
-                            {
-                                src += 4;
-                            }
-
-                            ++sx;
-                        }
+                            if (const float k = values [xx + yy * size])
+                                addScaled (total, sourceLine + xx * numChannels, k, width * numChannels);
                     }
                 }
 
-                *dest++ = (uint8) jmin (0xff, roundToInt (c1));
-                *dest++ = (uint8) jmin (0xff, roundToInt (c2));
-                *dest++ = (uint8) jmin (0xff, roundToInt (c3));
-                *dest++ = (uint8) jmin (0xff, roundToInt (c4));
+                storeLine (total, destData.getLinePointer (line), width * numChannels);
             }
         }
-    }
-    else if (destData.pixelStride == 3)
-    {
-        for (int y = area.getY(); y < bottom; ++y)
+
+        void processLinesSeparably (const int startLine, const int endLine) const
         {
-            uint8* dest = line;
-            line += destData.lineStride;
+            const int width = destArea.getWidth();
+            const int lineLength = width * numChannels;
+
+            // The horizontally-filtered lines are kept in a ring buffer with a slot for each
+            // row of the kernel, so each source line is only filtered once.
+            HeapBlock<float> sourceLine ((size_t) ((width + size) * numChannels));
+            HeapBlock<float> filteredLines ((size_t) (lineLength * size));
+            HeapBlock<float> total ((size_t) lineLength);
+            int nextLineToFilter = destArea.getY() + startLine - centre;
 
-            for (int x = area.getX(); x < right; ++x)
+            for (int line = startLine; line < endLine; ++line)
             {
-                float c1 = 0;
-                float c2 = 0;
-                float c3 = 0;
+                const int y = destArea.getY() + line;
+                const int lastNeeded = jmin (y + size - 1 - centre, srcData.height - 1);
 
-                for (int yy = 0; yy < size; ++yy)
+                for (nextLineToFilter = jmax (nextLineToFilter, 0); nextLineToFilter <= lastNeeded; ++nextLineToFilter)
                 {
-                    const int sy = y + yy - (size >> 1);
+                    float* const filtered = filteredLines + lineLength * (nextLineToFilter % size);
 
-                    if (sy >= srcData.height)
-                        break;
+                    loadLine (srcData, nextLineToFilter, destArea.getX() - centre, width + size - 1, sourceLine);
 
-                    if (sy >= 0)
-                    {
-                        int sx = x - (size >> 1);
-                        const uint8* src = srcData.getPixelPointer (sx, sy);
+                    for (int i = 0; i < lineLength; ++i)
+                        filtered[i] = 0;
 
-                        for (int xx = 0; xx < size; ++xx)
-                        {
-                            if (sx >= srcData.width)
-                                break;
-
-                            if (sx >= 0)
-                            {
-                                const float kernelMult = values [xx + yy * size];
-                                c1 += kernelMult * *src++;
-                                c2 += kernelMult * *src++;
-                                c3 += kernelMult * *src++;
-                            }
-                            else
-                            {
-                                src += 3;
-                            }
-
-                            ++sx;
-                        }
-                    }
+                    for (int xx = 0; xx < size; ++xx)
+                        if (const float k = rowFactors[xx])
+                            addScaled (filtered, sourceLine + xx * numChannels, k, lineLength);
+                }
+
+                for (int i = 0; i < lineLength; ++i)
+                    total[i] = 0;
+
+                for (int yy = 0; yy < size; ++yy)
+                {
+                    const int sy = y + yy - centre;
+
+                    if (isPositiveAndBelow (sy, srcData.height))
+                        if (const float k = columnFactors[yy])
+                            addScaled (total, filteredLines + lineLength * (sy % size), k, lineLength);
                 }
 
-                *dest++ = (uint8) roundToInt (c1);
-                *dest++ = (uint8) roundToInt (c2);
-                *dest++ = (uint8) roundToInt (c3);
+                storeLine (total, destData.getLinePointer (line), lineLength);
             }
         }
-    }
-    else if (destData.pixelStride == 1)
+
+        JUCE_DECLARE_NON_COPYABLE (Convolver)
+    };
+
+    struct LineBandRenderer
     {
-        for (int y = area.getY(); y < bottom; ++y)
-        {
-            uint8* dest = line;
-            line += destData.lineStride;
+        LineBandRenderer (const Convolver& c, const int linesPerBand)  : convolver (c), bandSize (linesPerBand) {}
 
-            for (int x = area.getX(); x < right; ++x)
-            {
-                float c1 = 0;
+        void operator() (const int band) const
+        {
+            convolver.processLines (band * bandSize,
+                                    jmin ((band + 1) * bandSize, convolver.destArea.getHeight()));
+        }
 
-                for (int yy = 0; yy < size; ++yy)
-                {
-                    const int sy = y + yy - (size >> 1);
+        const Convolver& convolver;
+        const int bandSize;
+    };
+}
 
-                    if (sy >= srcData.height)
-                        break;
+void ImageConvolutionKernel::applyToImage (Image& destImage,
+                                           const Image& sourceImage,
+                                           const Rectangle<int>& destinationArea) const
+{
+    applyToImage (destImage, sourceImage, destinationArea, nullptr);
+}
 
-                    if (sy >= 0)
-                    {
-                        int sx = x - (size >> 1);
-                        const uint8* src = srcData.getPixelPointer (sx, sy);
+void ImageConvolutionKernel::applyToImage (Image& destImage,
+                                           const Image& sourceImage,
+                                           const Rectangle<int>& destinationArea,
+                                           ThreadPool& threadPool) const
+{
+    applyToImage (destImage, sourceImage, destinationArea, &threadPool);
+}
 
-                        for (int xx = 0; xx < size; ++xx)
-                        {
-                            if (sx >= srcData.width)
-                                break;
-
-                            if (sx >= 0)
-                            {
-                                const float kernelMult = values [xx + yy * size];
-                                c1 += kernelMult * *src++;
-                            }
-                            else
-                            {
-                                src += 3;
-                            }
-
-                            ++sx;
-                        }
-                    }
-                }
+void ImageConvolutionKernel::applyToImage (Image& destImage,
+                                           const Image& sourceImage,
+                                           const Rectangle<int>& destinationArea,
+                                           ThreadPool* const threadPool) const
+{
+    Image source (sourceImage);
 
-                *dest++ = (uint8) roundToInt (c1);
-            }
+    if (sourceImage == destImage)
+    {
+        // the pixels are written back into the same image, so they need to be read from a copy
+        source = sourceImage.createCopy();
+        destImage.duplicateIfShared();
+    }
+    else
+    {
+        if (sourceImage.getWidth() != destImage.getWidth()
+             || sourceImage.getHeight() != destImage.getHeight()
+             || sourceImage.getFormat() != destImage.getFormat())
+        {
+            jassertfalse;
+            return;
         }
     }
+
+    const Rectangle<int> area (destinationArea.getIntersection (destImage.getBounds()));
+
+    if (area.isEmpty())
+        return;
+
+    const Image::BitmapData destData (destImage, area.getX(), area.getY(), area.getWidth(), area.getHeight(),
+                                      Image::BitmapData::writeOnly);
+
+    const Image::BitmapData srcData (source, Image::BitmapData::readOnly);
+
+    const ConvolutionHelpers::Convolver convolver (values, size, srcData, destData, area);
+
+    const int linesPerBand = 32;
+    const int numBands = (area.getHeight() + linesPerBand - 1) / linesPerBand;
+
+    if (threadPool != nullptr && numBands > 1)
+        threadPool->parallelFor (0, numBands, ConvolutionHelpers::LineBandRenderer (convolver, linesPerBand), 1);
+    else
+        convolver.processLines (0, area.getHeight());
 }
@@ -91,6 +91,11 @@ public:
     //==============================================================================
     /** Applies the kernel to an image.
 
+        If the kernel is separable (i.e. it's the product of a single column and a single
+        row, as a gaussian blur is), it's automatically applied as two one-dimensional passes,
+        which is much faster for larger kernels. Pixels beyond the edges of the source image
+        are treated as zero, and the results are clipped to the range 0 to 255.
+
         @param destImage        the image that will receive the resultant convoluted pixels.
         @param sourceImage      the source image to read from - this can be the same image as
                                 the destination, but if different, it must be exactly the same
@@ -101,11 +106,26 @@ public:
                        const Image& sourceImage,
                        const Rectangle<int>& destinationArea) const;
 
+    /** Applies the kernel to an image, sharing the work between the threads of a ThreadPool.
+
+        This does the same as the other applyToImage() method, but splits the image into
+        bands of lines which are processed in parallel. It doesn't return until the whole
+        area has been done.
+
+        @see ThreadPool::parallelFor
+    */
+    void applyToImage (Image& destImage,
+                       const Image& sourceImage,
+                       const Rectangle<int>& destinationArea,
+                       ThreadPool& threadPool) const;
+
 private:
     //==============================================================================
     HeapBlock <float> values;
     const int size;
 
+    void applyToImage (Image&, const Image&, const Rectangle<int>&, ThreadPool*) const;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ImageConvolutionKernel)
 };
 
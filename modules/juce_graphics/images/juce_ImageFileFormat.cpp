@@ -105,3 +105,49 @@ Image ImageFileFormat::loadFrom (const void* rawData, const size_t numBytes)
 
     return Image::null;
 }
+
+//==============================================================================
+class ImageFileDecodeJob  : public ThreadPoolJob
+{
+public:
+    ImageFileDecodeJob (const File& f)  : ThreadPoolJob ("Image decoder"), file (f) {}
+
+    JobStatus runJob()
+    {
+        image = ImageFileFormat::loadFrom (file);
+        return jobHasFinished;
+    }
+
+    const File file;
+    Image image;
+
+private:
+    JUCE_DECLARE_NON_COPYABLE (ImageFileDecodeJob)
+};
+
+Array<Image> ImageFileFormat::loadFrom (const Array<File>& files, ThreadPool& threadPool)
+{
+    DefaultImageFormats::get(); // (makes sure the static formats are created on this thread)
+
+    OwnedArray<ImageFileDecodeJob> jobs;
+
+    for (int i = 0; i < files.size(); ++i)
+    {
+        ImageFileDecodeJob* const job = new ImageFileDecodeJob (files.getReference (i));
+        jobs.add (job);
+        threadPool.addJob (job, false);
+    }
+
+    Array<Image> images;
+    images.ensureStorageAllocated (jobs.size());
+
+    for (int i = 0; i < jobs.size(); ++i)
+    {
+        ImageFileDecodeJob* const job = jobs.getUnchecked (i);
+        threadPool.waitForJobToFinish (job, -1);
+        images.add (job->image);
+    }
+
+    return images;
+}
+
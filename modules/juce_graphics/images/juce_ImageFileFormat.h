@@ -137,6 +137,19 @@ public:
     */
     static Image loadFrom (const void* rawData,
                            size_t numBytesOfData);
+
+    /** Loads a set of image files, decoding them in parallel on a thread pool.
+
+        This is handy for preloading a lot of images at once (e.g. all the assets for a
+        GUI, or a folder of thumbnails) in much less time than it'd take to load them one
+        at a time. It blocks until all the files have been loaded.
+
+        @param files        the files to load
+        @param threadPool   the pool whose threads should be used to do the decoding
+        @returns            an array of images, in the same order as the files. Any files
+                            that couldn't be loaded will have an invalid image in the array.
+    */
+    static Array<Image> loadFrom (const Array<File>& files, ThreadPool& threadPool);
 };
 
 //==============================================================================
@@ -38,6 +38,18 @@
 #include "../juce_core/native/juce_BasicNativeHeaders.h"
 #include "juce_graphics.h"
 
+#ifndef JUCE_USE_SSE_INTRINSICS
+ #define JUCE_USE_SSE_INTRINSICS 1
+#endif
+
+#if ! JUCE_INTEL
+ #undef JUCE_USE_SSE_INTRINSICS
+#endif
+
+#if JUCE_USE_SSE_INTRINSICS
+ #include <emmintrin.h>
+#endif
+
 //==============================================================================
 #if JUCE_MAC
  #import <QuartzCore/QuartzCore.h>
@@ -108,9 +120,12 @@ namespace juce
 #include "geometry/juce_RectangleList.cpp"
 #include "placement/juce_Justification.cpp"
 #include "placement/juce_RectanglePlacement.cpp"
+#include "contexts/juce_DisplayList.cpp"
 #include "contexts/juce_GraphicsContext.cpp"
 #include "contexts/juce_LowLevelGraphicsPostScriptRenderer.cpp"
 #include "contexts/juce_LowLevelGraphicsSoftwareRenderer.cpp"
+#include "contexts/juce_LowLevelGraphicsTiledRenderer.cpp"
+#include "native/juce_RenderingHelpers.cpp"
 #include "images/juce_Image.cpp"
 #include "images/juce_ImageCache.cpp"
 #include "images/juce_ImageConvolutionKernel.cpp"
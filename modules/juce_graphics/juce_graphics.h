@@ -48,6 +48,16 @@
  #define JUCE_USE_DIRECTWRITE 1
 #endif
 
+/** Config: JUCE_DIRECT2D
+
+    Enabling this flag makes a Direct2D renderer available to windows on Windows 7 and later.
+    It isn't used by default - a window can be switched over to it with
+    ComponentPeer::setCurrentRenderingEngine(). This needs JUCE_USE_DIRECTWRITE to be enabled.
+*/
+#ifndef JUCE_DIRECT2D
+ #define JUCE_DIRECT2D 0
+#endif
+
 #ifndef JUCE_INCLUDE_PNGLIB_CODE
  #define JUCE_INCLUDE_PNGLIB_CODE 1
 #endif
@@ -117,6 +127,9 @@ namespace juce
 #ifndef __JUCE_RECTANGLEPLACEMENT_JUCEHEADER__
  #include "placement/juce_RectanglePlacement.h"
 #endif
+#ifndef __JUCE_DISPLAYLIST_JUCEHEADER__
+ #include "contexts/juce_DisplayList.h"
+#endif
 #ifndef __JUCE_GRAPHICSCONTEXT_JUCEHEADER__
  #include "contexts/juce_GraphicsContext.h"
 #endif
@@ -129,6 +142,9 @@ namespace juce
 #ifndef __JUCE_LOWLEVELGRAPHICSSOFTWARERENDERER_JUCEHEADER__
  #include "contexts/juce_LowLevelGraphicsSoftwareRenderer.h"
 #endif
+#ifndef __JUCE_LOWLEVELGRAPHICSTILEDRENDERER_JUCEHEADER__
+ #include "contexts/juce_LowLevelGraphicsTiledRenderer.h"
+#endif
 #ifndef __JUCE_IMAGE_JUCEHEADER__
  #include "images/juce_Image.h"
 #endif
@@ -0,0 +1,296 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+namespace RenderingHelpers
+{
+
+#if JUCE_USE_SSE_INTRINSICS
+namespace SIMDSpanHelpers
+{
+    static bool isSSE2Present() noexcept
+    {
+       #if JUCE_64BIT
+        return true;
+       #else
+        static bool sse2Present = SystemStats::hasSSE2();
+        return sse2Present;
+       #endif
+    }
+
+    static forcedinline uint32 readUnaligned (const uint8* p) noexcept
+    {
+        uint32 v;
+        memcpy (&v, p, sizeof (v));
+        return v;
+    }
+
+    static forcedinline void writeUnaligned (uint8* p, const __m128i v) noexcept
+    {
+        const int n = _mm_cvtsi128_si32 (v);
+        memcpy (p, &n, sizeof (n));
+    }
+
+    // Does the same thing as PixelARGB::blend() for pairs of pixels whose
+    // components have been expanded to 16 bits
+    static forcedinline __m128i blendExpanded (const __m128i dest, const __m128i src) noexcept
+    {
+        const __m128i srcAlpha = _mm_shufflehi_epi16 (_mm_shufflelo_epi16 (src, _MM_SHUFFLE (3, 3, 3, 3)),
+                                                      _MM_SHUFFLE (3, 3, 3, 3));
+        const __m128i alpha = _mm_sub_epi16 (_mm_set1_epi16 (0x100), srcAlpha);
+
+        return _mm_add_epi16 (src, _mm_srli_epi16 (_mm_mullo_epi16 (dest, alpha), 8));
+    }
+
+    template <bool applyExtraAlpha>
+    static forcedinline __m128i blendFourPixels (const __m128i dest, const __m128i src, const __m128i extraAlpha) noexcept
+    {
+        const __m128i zero = _mm_setzero_si128();
+        __m128i srcLo = _mm_unpacklo_epi8 (src, zero);
+        __m128i srcHi = _mm_unpackhi_epi8 (src, zero);
+
+        if (applyExtraAlpha)
+        {
+            srcLo = _mm_srli_epi16 (_mm_mullo_epi16 (srcLo, extraAlpha), 8);
+            srcHi = _mm_srli_epi16 (_mm_mullo_epi16 (srcHi, extraAlpha), 8);
+        }
+
+        // (the saturating pack does the same job as clampPixelComponents())
+        return _mm_packus_epi16 (blendExpanded (_mm_unpacklo_epi8 (dest, zero), srcLo),
+                                 blendExpanded (_mm_unpackhi_epi8 (dest, zero), srcHi));
+    }
+
+    template <bool applyExtraAlpha>
+    static void blendLine (PixelARGB* dest, const PixelARGB* src, int numPixels, const uint32 extraAlpha) noexcept
+    {
+        const __m128i extra = _mm_set1_epi16 ((short) extraAlpha);
+
+        for (; numPixels >= 4; numPixels -= 4)
+        {
+            _mm_storeu_si128 ((__m128i*) dest,
+                              blendFourPixels<applyExtraAlpha> (_mm_loadu_si128 ((const __m128i*) dest),
+                                                                _mm_loadu_si128 ((const __m128i*) src), extra));
+            dest += 4;
+            src += 4;
+        }
+
+        while (--numPixels >= 0)
+        {
+            if (applyExtraAlpha)
+                dest->blend (*src, extraAlpha);
+            else
+                dest->blend (*src);
+
+            ++dest;
+            ++src;
+        }
+    }
+
+    template <bool applyExtraAlpha>
+    static void blendLine (PixelRGB* dest, const PixelARGB* src, int numPixels, const uint32 extraAlpha) noexcept
+    {
+        const __m128i extra = _mm_set1_epi16 ((short) extraAlpha);
+        const __m128i topBytes = _mm_set1_epi32 ((int) 0xff000000);
+
+        // Each group of four 3-byte pixels is loaded as four overlapping 32-bit words, so the
+        // top byte of the last one belongs to the next pixel along. That byte is put back
+        // unchanged, and the words are written back in order so that each write's extra
+        // byte gets overwritten by the next one.
+        for (; numPixels > 4; numPixels -= 4)
+        {
+            uint8* const d = reinterpret_cast<uint8*> (dest);
+
+            const __m128i original = _mm_set_epi32 ((int) readUnaligned (d + 9), (int) readUnaligned (d + 6),
+                                                    (int) readUnaligned (d + 3), (int) readUnaligned (d));
+
+            __m128i result = blendFourPixels<applyExtraAlpha> (original, _mm_loadu_si128 ((const __m128i*) src), extra);
+            result = _mm_or_si128 (_mm_andnot_si128 (topBytes, result), _mm_and_si128 (topBytes, original));
+
+            writeUnaligned (d, result);
+            writeUnaligned (d + 3, _mm_srli_si128 (result, 4));
+            writeUnaligned (d + 6, _mm_srli_si128 (result, 8));
+            writeUnaligned (d + 9, _mm_srli_si128 (result, 12));
+
+            dest += 4;
+            src += 4;
+        }
+
+        while (--numPixels >= 0)
+        {
+            if (applyExtraAlpha)
+                dest->blend (*src, extraAlpha);
+            else
+                dest->blend (*src);
+
+            ++dest;
+            ++src;
+        }
+    }
+
+    static forcedinline __m128i blendBytes (const __m128i dest, const __m128i srcLo, const __m128i srcHi, const __m128i alpha) noexcept
+    {
+        const __m128i zero = _mm_setzero_si128();
+
+        return _mm_packus_epi16 (_mm_add_epi16 (srcLo, _mm_srli_epi16 (_mm_mullo_epi16 (_mm_unpacklo_epi8 (dest, zero), alpha), 8)),
+                                 _mm_add_epi16 (srcHi, _mm_srli_epi16 (_mm_mullo_epi16 (_mm_unpackhi_epi8 (dest, zero), alpha), 8)));
+    }
+}
+#endif
+
+//==============================================================================
+bool SIMDSpanBlender::isAvailable() noexcept
+{
+   #if JUCE_USE_SSE_INTRINSICS
+    return SIMDSpanHelpers::isSSE2Present();
+   #else
+    return false;
+   #endif
+}
+
+bool SIMDSpanBlender::canBlendPixelsOnto (const PixelARGB*, const int pixelStride) noexcept
+{
+    return pixelStride == sizeof (PixelARGB) && isAvailable();
+}
+
+bool SIMDSpanBlender::canBlendPixelsOnto (const PixelRGB*, const int pixelStride) noexcept
+{
+    // the RGB code relies on the pixel's bytes being in the same order as a PixelARGB's
+    return (int) PixelRGB::indexB == (int) PixelARGB::indexB
+            && (int) PixelRGB::indexR == (int) PixelARGB::indexR
+            && pixelStride == sizeof (PixelRGB)
+            && isAvailable();
+}
+
+bool SIMDSpanBlender::blendColour (PixelARGB* dest, const PixelARGB colour, int numPixels) noexcept
+{
+   #if JUCE_USE_SSE_INTRINSICS
+    if (isAvailable())
+    {
+        using namespace SIMDSpanHelpers;
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i src = _mm_unpacklo_epi8 (_mm_set1_epi32 ((int) colour.getARGB()), zero);
+        const __m128i alpha = _mm_set1_epi16 ((short) (0x100 - colour.getAlpha()));
+
+        for (; numPixels >= 4; numPixels -= 4)
+        {
+            _mm_storeu_si128 ((__m128i*) dest, blendBytes (_mm_loadu_si128 ((const __m128i*) dest), src, src, alpha));
+            dest += 4;
+        }
+
+        while (--numPixels >= 0)
+            (dest++)->blend (colour);
+
+        return true;
+    }
+   #else
+    (void) dest; (void) colour; (void) numPixels;
+   #endif
+
+    return false;
+}
+
+bool SIMDSpanBlender::blendColour (PixelRGB* dest, const PixelARGB colour, int numPixels) noexcept
+{
+   #if JUCE_USE_SSE_INTRINSICS
+    if (isAvailable())
+    {
+        // Every destination byte is treated the same way, so a run of 16 pixels can be
+        // done as three registers full of bytes, using a repeating pattern of the colour's
+        // components as the source.
+        using namespace SIMDSpanHelpers;
+        PixelRGB pattern [16];
+
+        for (int i = 0; i < numElementsInArray (pattern); ++i)
+            pattern[i].set (colour);
+
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i alpha = _mm_set1_epi16 ((short) (0x100 - colour.getAlpha()));
+        const uint8* const p = reinterpret_cast<const uint8*> (pattern);
+        const __m128i p0 = _mm_loadu_si128 ((const __m128i*) p);
+        const __m128i p1 = _mm_loadu_si128 ((const __m128i*) (p + 16));
+        const __m128i p2 = _mm_loadu_si128 ((const __m128i*) (p + 32));
+        const __m128i p0Lo = _mm_unpacklo_epi8 (p0, zero), p0Hi = _mm_unpackhi_epi8 (p0, zero);
+        const __m128i p1Lo = _mm_unpacklo_epi8 (p1, zero), p1Hi = _mm_unpackhi_epi8 (p1, zero);
+        const __m128i p2Lo = _mm_unpacklo_epi8 (p2, zero), p2Hi = _mm_unpackhi_epi8 (p2, zero);
+
+        for (; numPixels >= 16; numPixels -= 16)
+        {
+            uint8* const bytes = reinterpret_cast<uint8*> (dest);
+            __m128i* const d = (__m128i*) bytes;
+            _mm_storeu_si128 (d,     blendBytes (_mm_loadu_si128 (d),     p0Lo, p0Hi, alpha));
+            _mm_storeu_si128 (d + 1, blendBytes (_mm_loadu_si128 (d + 1), p1Lo, p1Hi, alpha));
+            _mm_storeu_si128 (d + 2, blendBytes (_mm_loadu_si128 (d + 2), p2Lo, p2Hi, alpha));
+            dest += 16;
+        }
+
+        while (--numPixels >= 0)
+            (dest++)->blend (colour);
+
+        return true;
+    }
+   #else
+    (void) dest; (void) colour; (void) numPixels;
+   #endif
+
+    return false;
+}
+
+bool SIMDSpanBlender::blendPixels (PixelARGB* dest, const PixelARGB* src, int numPixels, uint32 extraAlpha) noexcept
+{
+   #if JUCE_USE_SSE_INTRINSICS
+    if (isAvailable())
+    {
+        if (extraAlpha >= 0x100)
+            SIMDSpanHelpers::blendLine<false> (dest, src, numPixels, extraAlpha);
+        else
+            SIMDSpanHelpers::blendLine<true> (dest, src, numPixels, extraAlpha);
+
+        return true;
+    }
+   #else
+    (void) dest; (void) src; (void) numPixels; (void) extraAlpha;
+   #endif
+
+    return false;
+}
+
+bool SIMDSpanBlender::blendPixels (PixelRGB* dest, const PixelARGB* src, int numPixels, uint32 extraAlpha) noexcept
+{
+   #if JUCE_USE_SSE_INTRINSICS
+    if (canBlendPixelsOnto (dest, sizeof (PixelRGB)))
+    {
+        if (extraAlpha >= 0x100)
+            SIMDSpanHelpers::blendLine<false> (dest, src, numPixels, extraAlpha);
+        else
+            SIMDSpanHelpers::blendLine<true> (dest, src, numPixels, extraAlpha);
+
+        return true;
+    }
+   #else
+    (void) dest; (void) src; (void) numPixels; (void) extraAlpha;
+   #endif
+
+    return false;
+}
+
+}
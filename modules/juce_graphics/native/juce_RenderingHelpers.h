@@ -188,26 +188,31 @@ public:
     void drawGlyph (RenderTargetType& target, const Font& font, const int glyphNumber, float x, float y)
     {
         ++accessCounter;
-        CachedGlyphType* glyph = nullptr;
 
-        const ScopedReadLock srl (lock);
-
-        for (int i = glyphs.size(); --i >= 0;)
         {
-            CachedGlyphType* const g = glyphs.getUnchecked (i);
+            // (the glyph is drawn while the lock is held, so that no other thread can
+            // regenerate it in the meantime)
+            const ScopedReadLock srl (lock);
 
-            if (g->glyph == glyphNumber && g->font == font)
+            if (CachedGlyphType* const glyph = findExistingGlyph (font, glyphNumber))
             {
-                glyph = g;
                 ++hits;
-                break;
+                glyph->lastAccessCount = accessCounter.value;
+                glyph->draw (target, x, y);
+                return;
             }
         }
 
+        // NB: the read lock must be released before taking the write lock, or two threads
+        // that both miss the cache at the same time would deadlock
+        const ScopedWriteLock swl (lock);
+
+        // (another thread may have added this glyph since the read lock was released)
+        CachedGlyphType* glyph = findExistingGlyph (font, glyphNumber);
+
         if (glyph == nullptr)
         {
             ++misses;
-            const ScopedWriteLock swl (lock);
 
             if (hits.value + misses.value > glyphs.size() * 16)
             {
@@ -243,6 +248,19 @@ private:
             glyphs.add (new CachedGlyphType());
     }
 
+    CachedGlyphType* findExistingGlyph (const Font& font, const int glyphNumber) const noexcept
+    {
+        for (int i = glyphs.size(); --i >= 0;)
+        {
+            CachedGlyphType* const g = glyphs.getUnchecked (i);
+
+            if (g->glyph == glyphNumber && g->font == font)
+                return g;
+        }
+
+        return nullptr;
+    }
+
     CachedGlyphType* findLeastRecentlyUsedGlyph() const noexcept
     {
         CachedGlyphType* oldest = glyphs.getLast();
@@ -271,6 +289,128 @@ private:
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (GlyphCache)
 };
 
+//==============================================================================
+/** Holds a cache of recently-used gradient lookup tables, so that filling lots of shapes
+    with the same gradient doesn't have to keep recalculating its colours.
+
+    The tables only depend on the gradient's colours and the number of entries, so
+    gradients that are drawn in different places can still share them.
+*/
+class GradientLookupTableCache  : private DeletedAtShutdown
+{
+public:
+    GradientLookupTableCache() {}
+
+    ~GradientLookupTableCache()
+    {
+        getSingletonPointer() = nullptr;
+    }
+
+    static GradientLookupTableCache& getInstance()
+    {
+        GradientLookupTableCache*& c = getSingletonPointer();
+
+        if (c == nullptr)
+            c = new GradientLookupTableCache();
+
+        return *c;
+    }
+
+    //==============================================================================
+    class LookupTable  : public ReferenceCountedObject
+    {
+    public:
+        LookupTable (const ColourGradient& g, const int numEntries_, const uint64 hash_)
+            : gradient (g), numEntries (numEntries_), hash (hash_)
+        {
+            table.malloc ((size_t) numEntries);
+            gradient.createLookupTable (table, numEntries);
+        }
+
+        bool matches (const ColourGradient& g, const int numEntries_, const uint64 hash_) const noexcept
+        {
+            if (hash != hash_ || numEntries != numEntries_ || gradient.getNumColours() != g.getNumColours())
+                return false;
+
+            for (int i = g.getNumColours(); --i >= 0;)
+                if (gradient.getColour (i) != g.getColour (i)
+                     || gradient.getColourPosition (i) != g.getColourPosition (i))
+                    return false;
+
+            return true;
+        }
+
+        typedef ReferenceCountedObjectPtr<LookupTable> Ptr;
+
+        const ColourGradient gradient;
+        HeapBlock<PixelARGB> table;
+        const int numEntries;
+        const uint64 hash;
+
+    private:
+        JUCE_DECLARE_NON_COPYABLE (LookupTable)
+    };
+
+    /** Returns a lookup table for the given gradient with the given number of entries. */
+    LookupTable::Ptr getLookupTable (const ColourGradient& gradient, const int numEntries)
+    {
+        const uint64 hash = getHash (gradient, numEntries);
+
+        const ScopedLock sl (lock);
+
+        for (int i = tables.size(); --i >= 0;)
+        {
+            LookupTable* const t = tables.getUnchecked (i);
+
+            if (t->matches (gradient, numEntries, hash))
+            {
+                // (the most recently used tables are kept at the end of the list)
+                tables.move (i, -1);
+                return t;
+            }
+        }
+
+        LookupTable::Ptr newTable (new LookupTable (gradient, numEntries, hash));
+
+        if (tables.size() >= maxNumTables)
+            tables.remove (0);
+
+        tables.add (newTable);
+        return newTable;
+    }
+
+    /** Returns a lookup table of the appropriate size for drawing the gradient with the given transform. */
+    LookupTable::Ptr getLookupTable (const ColourGradient& gradient, const AffineTransform& transform)
+    {
+        jassert (gradient.getNumColours() >= 2);
+        return getLookupTable (gradient, gradient.getNumLookupTableEntries (transform));
+    }
+
+private:
+    enum { maxNumTables = 32 };
+    ReferenceCountedArray<LookupTable> tables;
+    CriticalSection lock;
+
+    static uint64 getHash (const ColourGradient& gradient, const int numEntries) noexcept
+    {
+        uint64 hash = (uint64) numEntries;
+
+        for (int i = gradient.getNumColours(); --i >= 0;)
+            hash = hash * 101 + gradient.getColour (i).getARGB()
+                     + (uint64) (gradient.getColourPosition (i) * 65536.0) * 31;
+
+        return hash;
+    }
+
+    static GradientLookupTableCache*& getSingletonPointer() noexcept
+    {
+        static GradientLookupTableCache* c = nullptr;
+        return c;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (GradientLookupTableCache)
+};
+
 //==============================================================================
 /** Caches a glyph as an edge-table. */
 template <class RendererType>
@@ -571,6 +711,51 @@ namespace GradientPixelIterators
     do { dest->op; dest = addBytesToPointer (dest, destStride); } while (--width > 0); \
 }
 
+//==============================================================================
+/** Vectorised versions of the inner loops that the EdgeTableFillers use to blend
+    horizontal runs of pixels.
+
+    Where the CPU supports it (currently SSE2), these give exactly the same results as
+    the equivalent PixelARGB/PixelRGB::blend() loops, but work on several pixels at once.
+    Each blend method returns false without touching the destination if it can't handle
+    the pixel types or the CPU doesn't have the instructions it needs, in which case the
+    caller must use its usual scalar loop instead. The destination and source pixels
+    must be contiguous.
+*/
+class JUCE_API SIMDSpanBlender
+{
+public:
+    /** Returns true if the vectorised blending functions can be used on this machine. */
+    static bool isAvailable() noexcept;
+
+    /** Returns true if blendPixels() can be used for a line of the given pixel type and stride. */
+    static bool canBlendPixelsOnto (const PixelARGB*, int pixelStride) noexcept;
+    /** Returns true if blendPixels() can be used for a line of the given pixel type and stride. */
+    static bool canBlendPixelsOnto (const PixelRGB*, int pixelStride) noexcept;
+    template <class PixelType>
+    static bool canBlendPixelsOnto (const PixelType*, int) noexcept                         { return false; }
+
+    /** Blends a solid colour onto a line of pixels. */
+    static bool blendColour (PixelARGB* dest, PixelARGB colour, int numPixels) noexcept;
+    /** Blends a solid colour onto a line of pixels. */
+    static bool blendColour (PixelRGB* dest, PixelARGB colour, int numPixels) noexcept;
+    template <class PixelType>
+    static bool blendColour (PixelType*, PixelARGB, int) noexcept                          { return false; }
+
+    /** Blends a line of source pixels onto a line of destination pixels.
+
+        The extraAlpha value is applied to the source pixels as it is by PixelARGB::blend(),
+        and a value of 0x100 is equivalent to calling blend() with no extra alpha.
+    */
+    static bool blendPixels (PixelARGB* dest, const PixelARGB* src, int numPixels, uint32 extraAlpha) noexcept;
+    /** Blends a line of source pixels onto a line of destination pixels.
+        @see blendPixels
+    */
+    static bool blendPixels (PixelRGB* dest, const PixelARGB* src, int numPixels, uint32 extraAlpha) noexcept;
+    template <class DestPixelType, class SrcPixelType>
+    static bool blendPixels (DestPixelType*, const SrcPixelType*, int, uint32) noexcept  { return false; }
+};
+
 //==============================================================================
 /** Contains classes for filling edge tables with various fill types. */
 namespace EdgeTableFillers
@@ -652,7 +837,8 @@ namespace EdgeTableFillers
 
         inline void blendLine (PixelType* dest, const PixelARGB colour, int width) const noexcept
         {
-            JUCE_PERFORM_PIXEL_OP_LOOP (blend (colour))
+            if (destData.pixelStride != sizeof (*dest) || ! SIMDSpanBlender::blendColour (dest, colour, width))
+                JUCE_PERFORM_PIXEL_OP_LOOP (blend (colour))
         }
 
         forcedinline void replaceLine (PixelRGB* dest, const PixelARGB colour, int width) const noexcept
@@ -749,7 +935,9 @@ namespace EdgeTableFillers
         {
             PixelType* dest = getPixel (x);
 
-            if (alphaLevel < 0xff)
+            if (SIMDSpanBlender::canBlendPixelsOnto (dest, destData.pixelStride))
+                blendSpan (dest, x, width, alphaLevel < 0xff ? (uint32) alphaLevel : 0x100);
+            else if (alphaLevel < 0xff)
                 JUCE_PERFORM_PIXEL_OP_LOOP (blend (GradientType::getPixel (x++), (uint32) alphaLevel))
             else
                 JUCE_PERFORM_PIXEL_OP_LOOP (blend (GradientType::getPixel (x++)))
@@ -758,7 +946,11 @@ namespace EdgeTableFillers
         void handleEdgeTableLineFull (int x, int width) const noexcept
         {
             PixelType* dest = getPixel (x);
-            JUCE_PERFORM_PIXEL_OP_LOOP (blend (GradientType::getPixel (x++)))
+
+            if (SIMDSpanBlender::canBlendPixelsOnto (dest, destData.pixelStride))
+                blendSpan (dest, x, width, 0x100);
+            else
+                JUCE_PERFORM_PIXEL_OP_LOOP (blend (GradientType::getPixel (x++)))
         }
 
     private:
@@ -770,6 +962,24 @@ namespace EdgeTableFillers
             return addBytesToPointer (linePixels, x * destData.pixelStride);
         }
 
+        void blendSpan (PixelType* dest, int x, int width, const uint32 extraAlpha) const noexcept
+        {
+            // the gradient colours are generated in chunks, and each chunk blended in one go
+            PixelARGB span [64];
+
+            while (width > 0)
+            {
+                const int num = jmin (width, (int) numElementsInArray (span));
+
+                for (int i = 0; i < num; ++i)
+                    span[i] = GradientType::getPixel (x++);
+
+                SIMDSpanBlender::blendPixels (dest, span, num, extraAlpha);
+                dest += num;
+                width -= num;
+            }
+        }
+
         JUCE_DECLARE_NON_COPYABLE (Gradient)
     };
 
@@ -823,6 +1033,9 @@ namespace EdgeTableFillers
 
             jassert (repeatPattern || (x >= 0 && x + width <= srcData.width));
 
+            if (blendSpan (dest, x, width, alphaLevel < 0xfe ? (uint32) alphaLevel : 0x100))
+                return;
+
             if (alphaLevel < 0xfe)
             {
                 JUCE_PERFORM_PIXEL_OP_LOOP (blend (*getSrcPixel (repeatPattern ? (x++ % srcData.width) : x++), (uint32) alphaLevel))
@@ -843,6 +1056,9 @@ namespace EdgeTableFillers
 
             jassert (repeatPattern || (x >= 0 && x + width <= srcData.width));
 
+            if (blendSpan (dest, x, width, extraAlpha < 0xfe ? (uint32) extraAlpha : 0x100))
+                return;
+
             if (extraAlpha < 0xfe)
             {
                 JUCE_PERFORM_PIXEL_OP_LOOP (blend (*getSrcPixel (repeatPattern ? (x++ % srcData.width) : x++), (uint32) extraAlpha))
@@ -885,6 +1101,14 @@ namespace EdgeTableFillers
             return addBytesToPointer (sourceLineStart, x * srcData.pixelStride);
         }
 
+        bool blendSpan (DestPixelType* dest, const int srcX, const int width, const uint32 alpha) const noexcept
+        {
+            return (! repeatPattern)
+                     && srcData.pixelStride == sizeof (SrcPixelType)
+                     && SIMDSpanBlender::canBlendPixelsOnto (dest, destData.pixelStride)
+                     && SIMDSpanBlender::blendPixels (dest, getSrcPixel (srcX), width, alpha);
+        }
+
         forcedinline void copyRow (DestPixelType* dest, SrcPixelType const* src, int width) const noexcept
         {
             if (srcData.pixelStride == 3 && destData.pixelStride == 3)
@@ -1538,6 +1762,19 @@ namespace EdgeTableFillers
 //==============================================================================
 namespace ClipRegions
 {
+    /** Returns the bounds to use when rasterising a path that will then be clipped to
+        the given area.
+
+        EdgeTable clamps any edges that lie beyond the right-hand side of its bounds into
+        its last column, which makes the coverage of that column slightly wrong. Adding
+        an extra column that gets clipped away afterwards means that the pixels inside the
+        area come out the same, whatever the size of the clip region.
+    */
+    inline Rectangle<int> getBoundsForNewEdgeTable (const Rectangle<int>& clipBounds) noexcept
+    {
+        return clipBounds.withWidth (clipBounds.getWidth() + 1);
+    }
+
     class Base  : public SingleThreadedReferenceCountedObject
     {
     public:
@@ -1607,7 +1844,7 @@ namespace ClipRegions
 
         Ptr clipToPath (const Path& p, const AffineTransform& transform)
         {
-            EdgeTable et (edgeTable.getMaximumBounds(), p, transform);
+            EdgeTable et (getBoundsForNewEdgeTable (edgeTable.getMaximumBounds()), p, transform);
             edgeTable.clipToEdgeTable (et);
             return edgeTable.isEmpty() ? nullptr : this;
         }
@@ -1648,7 +1885,7 @@ namespace ClipRegions
             {
                 Path p;
                 p.addRectangle (0, 0, (float) srcData.width, (float) srcData.height);
-                EdgeTable et2 (edgeTable.getMaximumBounds(), p, transform);
+                EdgeTable et2 (getBoundsForNewEdgeTable (edgeTable.getMaximumBounds()), p, transform);
                 edgeTable.clipToEdgeTable (et2);
             }
 
@@ -1716,8 +1953,9 @@ namespace ClipRegions
 
         void fillAllWithGradient (Image::BitmapData& destData, ColourGradient& gradient, const AffineTransform& transform, bool isIdentity) const
         {
-            HeapBlock <PixelARGB> lookupTable;
-            const int numLookupEntries = gradient.createLookupTable (transform, lookupTable);
+            const GradientLookupTableCache::LookupTable::Ptr lut (GradientLookupTableCache::getInstance().getLookupTable (gradient, transform));
+            const PixelARGB* const lookupTable = lut->table;
+            const int numLookupEntries = lut->numEntries;
             jassert (numLookupEntries > 0);
 
             switch (destData.pixelFormat)
@@ -1848,8 +2086,9 @@ namespace ClipRegions
 
         void fillAllWithGradient (Image::BitmapData& destData, ColourGradient& gradient, const AffineTransform& transform, bool isIdentity) const
         {
-            HeapBlock <PixelARGB> lookupTable;
-            const int numLookupEntries = gradient.createLookupTable (transform, lookupTable);
+            const GradientLookupTableCache::LookupTable::Ptr lut (GradientLookupTableCache::getInstance().getLookupTable (gradient, transform));
+            const PixelARGB* const lookupTable = lut->table;
+            const int numLookupEntries = lut->numEntries;
             jassert (numLookupEntries > 0);
 
             switch (destData.pixelFormat)
@@ -2284,7 +2523,8 @@ public:
     void fillPath (const Path& path, const AffineTransform& t)
     {
         if (clip != nullptr)
-            fillShape (new ClipRegions::EdgeTableRegion (clip->getClipBounds(), path, transform.getTransformWith (t)), false);
+            fillShape (new ClipRegions::EdgeTableRegion (ClipRegions::getBoundsForNewEdgeTable (clip->getClipBounds()),
+                                                         path, transform.getTransformWith (t)), false);
     }
 
     void fillEdgeTable (const EdgeTable& edgeTable, const float x, const int y)
@@ -2410,11 +2650,51 @@ public:
                 c = c->clipToPath (p, t);
 
                 if (c != nullptr)
-                    c->renderImageTransformed (destData, srcData, alpha, t, interpolationQuality, false);
+                {
+                    const int mipmapLevel = getMipmapLevelFor (t);
+
+                    if (mipmapLevel > 0)
+                    {
+                        // When shrinking by more than half, sample from a pre-averaged copy
+                        // of the image instead, otherwise most of the source pixels get skipped.
+                        const Image mipmap (sourceImage.getMipmapLevel (mipmapLevel));
+                        const Image::BitmapData mipmapData (mipmap, Image::BitmapData::readOnly);
+
+                        const AffineTransform mipmapTransform (AffineTransform::scale (sourceImage.getWidth()  / (float) mipmap.getWidth(),
+                                                                                      sourceImage.getHeight() / (float) mipmap.getHeight())
+                                                                  .followedBy (t));
+
+                        c->renderImageTransformed (destData, mipmapData, alpha, mipmapTransform, interpolationQuality, false);
+                    }
+                    else
+                    {
+                        c->renderImageTransformed (destData, srcData, alpha, t, interpolationQuality, false);
+                    }
+                }
             }
         }
     }
 
+    int getMipmapLevelFor (const AffineTransform& t) const noexcept
+    {
+        if (interpolationQuality == Graphics::lowResamplingQuality)
+            return 0;
+
+        // Use the axis that's shrunk the least, so that the image never gets blurred more than necessary..
+        float scale = jmax (juce_hypot (t.mat00, t.mat10),
+                            juce_hypot (t.mat01, t.mat11));
+
+        int level = 0;
+
+        while (scale < 0.5f && level < 16)
+        {
+            scale *= 2.0f;
+            ++level;
+        }
+
+        return level;
+    }
+
     //==============================================================================
     Image image;
     ClipRegions::Base::Ptr clip;
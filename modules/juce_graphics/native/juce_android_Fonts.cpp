@@ -61,6 +61,11 @@ StringArray FTTypefaceList::getDefaultFontDirectories()
     return StringArray ("/system/fonts");
 }
 
+File FTTypefaceList::getFontCacheFile()
+{
+    return File::nonexistent;
+}
+
 Typeface::Ptr Typeface::createSystemTypefaceFor (const Font& font)
 {
     return new FreeTypeTypeface (font);
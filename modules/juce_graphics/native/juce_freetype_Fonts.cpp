@@ -74,9 +74,12 @@ struct FTFaceWrapper     : public ReferenceCountedObject
 class FTTypefaceList  : private DeletedAtShutdown
 {
 public:
-    FTTypefaceList()  : library (new FTLibWrapper())
+    FTTypefaceList()  : library (new FTLibWrapper()), cacheNeedsSaving (false)
     {
-        scanFontPaths (getDefaultFontDirectories());
+        loadFontCache();
+        scanFontDirectories (getDefaultFontDirectories());
+        removeUnusedCacheEntries();
+        saveFontCache();
     }
 
     ~FTTypefaceList()
@@ -97,6 +100,17 @@ public:
         {
         }
 
+        KnownTypeface (const File& f, const int index, const String& familyName,
+                       const String& styleName, const bool monospaced)
+           : file (f),
+             family (familyName),
+             style (styleName),
+             faceIndex (index),
+             isMonospaced (monospaced),
+             isSansSerif (isFaceSansSerif (family))
+        {
+        }
+
         const File file;
         const String family, style;
         const int faceIndex;
@@ -156,15 +170,8 @@ public:
 
     void scanFontPaths (const StringArray& paths)
     {
-        for (int i = 0; i < paths.size(); ++i)
-        {
-            DirectoryIterator iter (File::getCurrentWorkingDirectory()
-                                       .getChildFile (paths[i]), true);
-
-            while (iter.next())
-                if (iter.getFile().hasFileExtension ("ttf;pfb;pcf;otf"))
-                    scanFont (iter.getFile());
-        }
+        scanFontDirectories (paths);
+        saveFontCache();
     }
 
     void getMonospacedNames (StringArray& monoSpaced) const
@@ -191,13 +198,81 @@ public:
     juce_DeclareSingleton_SingleThreaded_Minimal (FTTypefaceList);
 
 private:
+    //==============================================================================
+    // The names found in each font file are kept in a cache file, so that the files
+    // only need to be opened with FreeType when they've been added or changed.
+    struct CachedFontFile
+    {
+        CachedFontFile (const String& path_, int64 size_, int64 modTime_)
+            : path (path_), size (size_), modTime (modTime_), isInUse (true)
+        {
+        }
+
+        const String path;
+        const int64 size, modTime;
+        OwnedArray<KnownTypeface> faces;
+        bool isInUse;
+
+        JUCE_DECLARE_NON_COPYABLE (CachedFontFile)
+    };
+
     FTLibWrapper::Ptr library;
     OwnedArray<KnownTypeface> faces;
+    OwnedArray<CachedFontFile> fontCache;
+    HashMap<String, CachedFontFile*> fontCacheLookup;
+    bool cacheNeedsSaving;
 
     static StringArray getDefaultFontDirectories();
+    static File getFontCacheFile();
+
+    enum { fontCacheMagicNumber = 0x4a464331 /* 'JFC1' */ };
 
-    void scanFont (const File& file)
+    void scanFontDirectories (const StringArray& paths)
     {
+        for (int i = 0; i < paths.size(); ++i)
+        {
+            DirectoryIterator iter (File::getCurrentWorkingDirectory()
+                                       .getChildFile (paths[i]), true);
+
+            bool isDirectory;
+            int64 fileSize;
+            Time modTime;
+
+            while (iter.next (&isDirectory, nullptr, &fileSize, &modTime, nullptr, nullptr))
+                if ((! isDirectory) && iter.getFile().hasFileExtension ("ttf;pfb;pcf;otf"))
+                    scanFont (iter.getFile(), fileSize, modTime.toMilliseconds());
+        }
+    }
+
+    void scanFont (const File& file, const int64 fileSize, const int64 modTime)
+    {
+        const String path (file.getFullPathName());
+        CachedFontFile* cached = fontCacheLookup [path];
+
+        if (cached != nullptr && cached->size == fileSize && cached->modTime == modTime)
+        {
+            if (! cached->isInUse)
+            {
+                cached->isInUse = true;
+
+                for (int i = 0; i < cached->faces.size(); ++i)
+                {
+                    const KnownTypeface& f = *cached->faces.getUnchecked (i);
+                    faces.add (new KnownTypeface (file, f.faceIndex, f.family, f.style, f.isMonospaced));
+                }
+            }
+
+            return;
+        }
+
+        if (cached != nullptr)
+            fontCache.removeObject (cached);
+
+        cached = new CachedFontFile (path, fileSize, modTime);
+        fontCache.add (cached);
+        fontCacheLookup.set (path, cached);
+        cacheNeedsSaving = true;
+
         int faceIndex = 0;
         int numFaces = 0;
 
@@ -211,7 +286,12 @@ private:
                     numFaces = face.face->num_faces;
 
                 if ((face.face->face_flags & FT_FACE_FLAG_SCALABLE) != 0)
-                    faces.add (new KnownTypeface (file, faceIndex, face));
+                {
+                    KnownTypeface* const known = new KnownTypeface (file, faceIndex, face);
+                    faces.add (known);
+                    cached->faces.add (new KnownTypeface (file, faceIndex, known->family,
+                                                          known->style, known->isMonospaced));
+                }
             }
 
             ++faceIndex;
@@ -219,6 +299,109 @@ private:
         while (faceIndex < numFaces);
     }
 
+    void loadFontCache()
+    {
+        const File cacheFile (getFontCacheFile());
+
+        if (cacheFile == File::nonexistent)
+            return;
+
+        FileInputStream stream (cacheFile);
+
+        if (stream.failedToOpen())
+            return;
+
+        BufferedInputStream in (stream, 16384);
+
+        if (in.readInt() != (int) fontCacheMagicNumber)
+            return;
+
+        for (int numFiles = in.readInt(); --numFiles >= 0 && ! in.isExhausted();)
+        {
+            const String path (in.readString());
+            const int64 size = in.readInt64();
+            const int64 modTime = in.readInt64();
+
+            CachedFontFile* const cached = new CachedFontFile (path, size, modTime);
+            cached->isInUse = false;
+            fontCache.add (cached);
+            fontCacheLookup.set (path, cached);
+
+            const File file (path);
+
+            for (int numFaces = in.readInt(); --numFaces >= 0 && ! in.isExhausted();)
+            {
+                const int faceIndex = in.readInt();
+                const String family (in.readString());
+                const String style (in.readString());
+                const bool isMonospaced = in.readBool();
+
+                cached->faces.add (new KnownTypeface (file, faceIndex, family, style, isMonospaced));
+            }
+        }
+    }
+
+    void removeUnusedCacheEntries()
+    {
+        for (int i = fontCache.size(); --i >= 0;)
+        {
+            const CachedFontFile* const cached = fontCache.getUnchecked (i);
+
+            if (! cached->isInUse)
+            {
+                fontCacheLookup.remove (cached->path);
+                fontCache.remove (i);
+                cacheNeedsSaving = true;
+            }
+        }
+    }
+
+    void saveFontCache()
+    {
+        if (! cacheNeedsSaving)
+            return;
+
+        cacheNeedsSaving = false;
+        const File cacheFile (getFontCacheFile());
+
+        if (cacheFile == File::nonexistent || ! cacheFile.getParentDirectory().createDirectory())
+            return;
+
+        TemporaryFile temp (cacheFile);
+
+        {
+            FileOutputStream out (temp.getFile());
+
+            if (out.failedToOpen())
+                return;
+
+            out.writeInt ((int) fontCacheMagicNumber);
+            out.writeInt (fontCache.size());
+
+            for (int i = 0; i < fontCache.size(); ++i)
+            {
+                const CachedFontFile& cached = *fontCache.getUnchecked (i);
+
+                out.writeString (cached.path);
+                out.writeInt64 (cached.size);
+                out.writeInt64 (cached.modTime);
+                out.writeInt (cached.faces.size());
+
+                for (int j = 0; j < cached.faces.size(); ++j)
+                {
+                    const KnownTypeface& f = *cached.faces.getUnchecked (j);
+
+                    out.writeInt (f.faceIndex);
+                    out.writeString (f.family);
+                    out.writeString (f.style);
+                    out.writeBool (f.isMonospaced);
+                }
+            }
+        }
+
+        temp.overwriteTargetFileWithTemporary();
+    }
+
     const KnownTypeface* matchTypeface (const String& familyName, const String& style) const noexcept
     {
         for (int i = 0; i < faces.size(); ++i)
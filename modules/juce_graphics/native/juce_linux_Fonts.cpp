@@ -64,6 +64,16 @@ StringArray FTTypefaceList::getDefaultFontDirectories()
     return fontDirs;
 }
 
+File FTTypefaceList::getFontCacheFile()
+{
+    String cacheDir (SystemStats::getEnvironmentVariable ("XDG_CACHE_HOME", String::empty).trim());
+
+    if (cacheDir.isEmpty())
+        cacheDir = "~/.cache";
+
+    return File (cacheDir).getChildFile ("juce").getChildFile ("fontcache");
+}
+
 Typeface::Ptr Typeface::createSystemTypefaceFor (const Font& font)
 {
     return new FreeTypeTypeface (font);
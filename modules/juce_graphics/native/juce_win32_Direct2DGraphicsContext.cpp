@@ -29,21 +29,7 @@ public:
         : hwnd (hwnd_),
           currentState (nullptr)
     {
-        RECT windowRect;
-        GetClientRect (hwnd, &windowRect);
-        D2D1_SIZE_U size = { windowRect.right - windowRect.left, windowRect.bottom - windowRect.top };
-        bounds.setSize (size.width, size.height);
-
-        D2D1_RENDER_TARGET_PROPERTIES props = D2D1::RenderTargetProperties();
-        D2D1_HWND_RENDER_TARGET_PROPERTIES propsHwnd = D2D1::HwndRenderTargetProperties (hwnd, size);
-
-        const Direct2DFactories& factories = Direct2DFactories::getInstance();
-        if (factories.d2dFactory != nullptr)
-        {
-            HRESULT hr = factories.d2dFactory->CreateHwndRenderTarget (props, propsHwnd, renderingTarget.resetAndGetPointerAddress());
-            jassert (SUCCEEDED (hr)); (void) hr;
-            hr = renderingTarget->CreateSolidColorBrush (D2D1::ColorF::ColorF (0.0f, 0.0f, 0.0f, 1.0f), colourBrush.resetAndGetPointerAddress());
-        }
+        createRenderTarget();
     }
 
     ~Direct2DLowLevelGraphicsContext()
@@ -57,7 +43,9 @@ public:
         GetClientRect (hwnd, &windowRect);
         D2D1_SIZE_U size = { windowRect.right - windowRect.left, windowRect.bottom - windowRect.top };
 
-        renderingTarget->Resize (size);
+        if (renderingTarget != nullptr)
+            renderingTarget->Resize (size);
+
         bounds.setSize (size.width, size.height);
     }
 
@@ -66,18 +54,40 @@ public:
         renderingTarget->Clear (D2D1::ColorF (D2D1::ColorF::White, 0.0f)); // xxx why white and not black?
     }
 
-    void start()
+    /** Returns false if the render target couldn't be created, in which case nothing should be drawn. */
+    bool start()
     {
+        if (renderingTarget == nullptr)
+            createRenderTarget();
+
+        if (renderingTarget == nullptr)
+            return false;
+
         renderingTarget->BeginDraw();
         saveState();
+        return true;
     }
 
     void end()
     {
         states.clear();
         currentState = 0;
-        renderingTarget->EndDraw();
+
+        const HRESULT hr = renderingTarget->EndDraw();
         renderingTarget->CheckWindowState();
+
+        if (hr == D2DERR_RECREATE_TARGET)
+        {
+            // The device has been lost, so everything that belongs to it has to be
+            // thrown away, and the target will be re-created before the next paint.
+            bitmapCache.clear();
+            colourBrush = nullptr;
+            renderingTarget = nullptr;
+        }
+        else
+        {
+            releaseUnusedBitmaps();
+        }
     }
 
     bool isVectorDevice() const { return false; }
@@ -105,23 +115,23 @@ public:
 
     bool clipToRectangleList (const RectangleList& clipRegion)
     {
-        currentState->clipToRectList (rectListToPathGeometry (clipRegion));
+        currentState->clipToRectList (rectListToPathGeometry (clipRegion, currentState->transform));
         return ! isClipEmpty();
     }
 
-    void excludeClipRectangle (const Rectangle<int>&)
+    void excludeClipRectangle (const Rectangle<int>& r)
     {
-        //xxx
+        currentState->excludeFromClip (rectListToPathGeometry (RectangleList (r), currentState->transform));
     }
 
     void clipToPath (const Path& path, const AffineTransform& transform)
     {
-        currentState->clipToPath (pathToPathGeometry (path, transform));
+        currentState->clipToPath (pathToPathGeometry (path, transform.followedBy (currentState->transform)));
     }
 
     void clipToImageAlpha (const Image& sourceImage, const AffineTransform& transform)
     {
-        currentState->clipToImage (sourceImage, transform);
+        currentState->clipToImage (sourceImage, transform.followedBy (currentState->transform));
     }
 
     bool clipRegionIntersects (const Rectangle<int>& r)
@@ -153,14 +163,16 @@ public:
         currentState = states.getLast();
     }
 
-    void beginTransparencyLayer (float /*opacity*/)
+    void beginTransparencyLayer (float opacity)
     {
-        jassertfalse; //xxx todo
+        saveState();
+        currentState->pushTransparencyLayer (opacity);
     }
 
     void endTransparencyLayer()
     {
-        jassertfalse; //xxx todo
+        // (the layer gets popped when the state that pushed it is deleted)
+        restoreState();
     }
 
     void setFill (const FillType& fillType)
@@ -173,16 +185,25 @@ public:
         currentState->setOpacity (newOpacity);
     }
 
-    void setInterpolationQuality (Graphics::ResamplingQuality /*quality*/)
+    void setInterpolationQuality (Graphics::ResamplingQuality quality)
     {
+        currentState->interpolationQuality = quality;
     }
 
     void fillRect (const Rectangle<int>& r, bool /*replaceExistingContents*/)
     {
-        renderingTarget->SetTransform (transformToMatrix (currentState->transform));
-        currentState->createBrush();
-        renderingTarget->FillRectangle (rectangleToRectF (r), currentState->currentBrush);
-        renderingTarget->SetTransform (D2D1::IdentityMatrix());
+        if (currentState->transform.isOnlyTranslation())
+        {
+            currentState->createBrush();
+            renderingTarget->FillRectangle (rectangleToRectF (r.toFloat().transformed (currentState->transform)),
+                                            currentState->currentBrush);
+        }
+        else
+        {
+            Path p;
+            p.addRectangle (r);
+            fillPath (p, AffineTransform::identity);
+        }
     }
 
     void fillPath (const Path& p, const AffineTransform& transform)
@@ -190,69 +211,46 @@ public:
         currentState->createBrush();
         ComSmartPtr <ID2D1Geometry> geometry (pathToPathGeometry (p, transform.followedBy (currentState->transform)));
 
-        if (renderingTarget != nullptr)
+        if (renderingTarget != nullptr && geometry != nullptr)
             renderingTarget->FillGeometry (geometry, currentState->currentBrush);
     }
 
     void drawImage (const Image& image, const AffineTransform& transform)
     {
-        renderingTarget->SetTransform (transformToMatrix (transform.followedBy (currentState->transform)));
-
-        D2D1_SIZE_U size;
-        size.width = image.getWidth();
-        size.height = image.getHeight();
-
-        D2D1_BITMAP_PROPERTIES bp = D2D1::BitmapProperties();
+        if (ID2D1Bitmap* const bitmap = getBitmapFor (image))
+        {
+            renderingTarget->SetTransform (transformToMatrix (transform.followedBy (currentState->transform)));
 
-        Image img (image.convertedToFormat (Image::ARGB));
-        Image::BitmapData bd (img, Image::BitmapData::readOnly);
-        bp.pixelFormat = renderingTarget->GetPixelFormat();
-        bp.pixelFormat.alphaMode = D2D1_ALPHA_MODE_PREMULTIPLIED;
+            renderingTarget->DrawBitmap (bitmap, nullptr, currentState->fillType.getOpacity(),
+                                         currentState->interpolationQuality == Graphics::lowResamplingQuality
+                                            ? D2D1_BITMAP_INTERPOLATION_MODE_NEAREST_NEIGHBOR
+                                            : D2D1_BITMAP_INTERPOLATION_MODE_LINEAR);
 
-        {
-            ComSmartPtr <ID2D1Bitmap> tempBitmap;
-            renderingTarget->CreateBitmap (size, bd.data, bd.lineStride, bp, tempBitmap.resetAndGetPointerAddress());
-            if (tempBitmap != nullptr)
-                renderingTarget->DrawBitmap (tempBitmap);
+            renderingTarget->SetTransform (D2D1::IdentityMatrix());
         }
-
-        renderingTarget->SetTransform (D2D1::IdentityMatrix());
     }
 
     void drawLine (const Line <float>& line)
     {
         // xxx doesn't seem to be correctly aligned, may need nudging by 0.5 to match the software renderer's behaviour
-        renderingTarget->SetTransform (transformToMatrix (currentState->transform));
         currentState->createBrush();
 
-        renderingTarget->DrawLine (D2D1::Point2F (line.getStartX(), line.getStartY()),
-                                   D2D1::Point2F (line.getEndX(), line.getEndY()),
+        const Line<float> l (line.getStart().transformedBy (currentState->transform),
+                             line.getEnd().transformedBy (currentState->transform));
+
+        renderingTarget->DrawLine (D2D1::Point2F (l.getStartX(), l.getStartY()),
+                                   D2D1::Point2F (l.getEndX(), l.getEndY()),
                                    currentState->currentBrush);
-        renderingTarget->SetTransform (D2D1::IdentityMatrix());
     }
 
     void drawVerticalLine (int x, float top, float bottom)
     {
-        // xxx doesn't seem to be correctly aligned, may need nudging by 0.5 to match the software renderer's behaviour
-        renderingTarget->SetTransform (transformToMatrix (currentState->transform));
-        currentState->createBrush();
-
-        renderingTarget->DrawLine (D2D1::Point2F ((FLOAT) x, top),
-                                   D2D1::Point2F ((FLOAT) x, bottom),
-                                   currentState->currentBrush);
-        renderingTarget->SetTransform (D2D1::IdentityMatrix());
+        drawLine (Line<float> ((float) x, top, (float) x, bottom));
     }
 
     void drawHorizontalLine (int y, float left, float right)
     {
-        // xxx doesn't seem to be correctly aligned, may need nudging by 0.5 to match the software renderer's behaviour
-        renderingTarget->SetTransform (transformToMatrix (currentState->transform));
-        currentState->createBrush();
-
-        renderingTarget->DrawLine (D2D1::Point2F (left, (FLOAT) y),
-                                   D2D1::Point2F (right, (FLOAT) y),
-                                   currentState->currentBrush);
-        renderingTarget->SetTransform (D2D1::IdentityMatrix());
+        drawLine (Line<float> (left, (float) y, right, (float) y));
     }
 
     void setFont (const Font& newFont)
@@ -267,12 +265,21 @@ public:
 
     void drawGlyph (int glyphNumber, const AffineTransform& transform)
     {
-        currentState->createBrush();
-        currentState->createFont();
+        const Font& font = currentState->font;
 
-        float hScale = currentState->font.getHorizontalScale();
+        if (! currentState->createFont())
+        {
+            // This isn't a DirectWrite typeface, so just fill the glyph's outline instead..
+            Path p;
+            font.getTypeface()->getOutlineForGlyph (glyphNumber, p);
+            fillPath (p, AffineTransform::scale (font.getHeight() * font.getHorizontalScale(), font.getHeight())
+                                         .followedBy (transform));
+            return;
+        }
 
-        renderingTarget->SetTransform (transformToMatrix (AffineTransform::scale (hScale, 1.0f)
+        currentState->createBrush();
+
+        renderingTarget->SetTransform (transformToMatrix (AffineTransform::scale (font.getHorizontalScale(), 1.0f)
                                                                           .followedBy (transform)
                                                                           .followedBy (currentState->transform)));
 
@@ -284,7 +291,7 @@ public:
 
         DWRITE_GLYPH_RUN glyphRun;
         glyphRun.fontFace = currentState->currentFontFace;
-        glyphRun.fontEmSize = (FLOAT) (currentState->font.getHeight() * currentState->fontHeightToEmSizeFactor);
+        glyphRun.fontEmSize = (FLOAT) (font.getHeight() * currentState->fontHeightToEmSizeFactor);
         glyphRun.glyphCount = 1;
         glyphRun.glyphIndices = &glyphIndices;
         glyphRun.glyphAdvances = &glyphAdvances;
@@ -315,6 +322,7 @@ public:
         SavedState (Direct2DLowLevelGraphicsContext& owner_)
           : owner (owner_), currentBrush (0),
             fontHeightToEmSizeFactor (1.0f), currentFontFace (0),
+            interpolationQuality (Graphics::mediumResamplingQuality),
             clipsRect (false), shouldClipRect (false),
             clipsRectList (false), shouldClipRectList (false),
             clipsComplex (false), shouldClipComplex (false),
@@ -328,9 +336,11 @@ public:
                 currentBrush = owner.currentState->currentBrush;
                 clipRect = owner.currentState->clipRect;
                 transform = owner.currentState->transform;
+                interpolationQuality = owner.currentState->interpolationQuality;
 
                 font = owner.currentState->font;
                 currentFontFace = owner.currentState->currentFontFace;
+                fontHeightToEmSizeFactor = owner.currentState->fontHeightToEmSizeFactor;
             }
             else
             {
@@ -349,6 +359,10 @@ public:
             clearImageClip();
             complexClipLayer = 0;
             bitmapMaskLayer = 0;
+
+            // this must be popped after any clips that were pushed inside it
+            if (transparencyLayer != nullptr)
+                owner.renderingTarget->PopLayer();
         }
 
         void clearClip()
@@ -360,7 +374,7 @@ public:
         void clipToRectangle (const Rectangle<int>& r)
         {
             clearClip();
-            clipRect = r.toFloat().transformed (transform).getSmallestIntegerContainer();
+            clipRect = clipRect.getIntersection (r.toFloat().transformed (transform).getSmallestIntegerContainer());
             shouldClipRect = true;
             pushClips();
         }
@@ -378,12 +392,18 @@ public:
 
         void clipToPath (ID2D1Geometry* geometry)
         {
+            // a second path clip in the same state has to be combined with the first one..
+            ComSmartPtr <ID2D1Geometry> newGeometry (geometry);
+
+            if (shouldClipComplex && complexClipGeometry != nullptr)
+                newGeometry = combineGeometries (complexClipGeometry, geometry, D2D1_COMBINE_MODE_INTERSECT);
+
             clearPathClip();
 
             if (complexClipLayer == 0)
                 owner.renderingTarget->CreateLayer (complexClipLayer.resetAndGetPointerAddress());
 
-            complexClipGeometry = geometry;
+            complexClipGeometry = newGeometry;
             shouldClipComplex = true;
             pushClips();
         }
@@ -399,18 +419,37 @@ public:
             }
         }
 
-        void clipToRectList (ID2D1Geometry* geometry)
+        void setRectListClip (ID2D1Geometry* geometry)
         {
+            ComSmartPtr <ID2D1Geometry> newGeometry (geometry);
             clearRectListClip();
 
             if (rectListLayer == 0)
                 owner.renderingTarget->CreateLayer (rectListLayer.resetAndGetPointerAddress());
 
-            rectListGeometry = geometry;
+            rectListGeometry = newGeometry;
             shouldClipRectList = true;
             pushClips();
         }
 
+        void clipToRectList (ID2D1Geometry* geometry)
+        {
+            if (shouldClipRectList && rectListGeometry != nullptr)
+                setRectListClip (combineGeometries (rectListGeometry, geometry, D2D1_COMBINE_MODE_INTERSECT));
+            else
+                setRectListClip (geometry);
+        }
+
+        void excludeFromClip (ID2D1Geometry* geometry)
+        {
+            ComSmartPtr <ID2D1Geometry> currentRegion (rectListGeometry);
+
+            if (! (shouldClipRectList && currentRegion != nullptr))
+                currentRegion = rectListToPathGeometry (RectangleList (clipRect), AffineTransform::identity);
+
+            setRectListClip (combineGeometries (currentRegion, geometry, D2D1_COMBINE_MODE_EXCLUDE));
+        }
+
         void clearImageClip()
         {
             popClips();
@@ -418,12 +457,13 @@ public:
             if (shouldClipBitmap)
             {
                 maskBitmap = 0;
+                maskGeometry = 0;
                 bitmapMaskBrush = 0;
                 shouldClipBitmap = false;
             }
         }
 
-        void clipToImage (const Image& image, const AffineTransform& transform)
+        void clipToImage (const Image& image, const AffineTransform& imageTransform)
         {
             clearImageClip();
 
@@ -432,31 +472,39 @@ public:
 
             D2D1_BRUSH_PROPERTIES brushProps;
             brushProps.opacity = 1;
-            brushProps.transform = transformToMatrix (transform);
+            brushProps.transform = transformToMatrix (imageTransform);
 
-            D2D1_BITMAP_BRUSH_PROPERTIES bmProps = D2D1::BitmapBrushProperties (D2D1_EXTEND_MODE_WRAP, D2D1_EXTEND_MODE_WRAP);
+            D2D1_BITMAP_BRUSH_PROPERTIES bmProps = D2D1::BitmapBrushProperties (D2D1_EXTEND_MODE_CLAMP, D2D1_EXTEND_MODE_CLAMP);
 
-            D2D1_SIZE_U size;
-            size.width = image.getWidth();
-            size.height = image.getHeight();
+            maskBitmap = owner.getBitmapFor (image);
 
-            D2D1_BITMAP_PROPERTIES bp = D2D1::BitmapProperties();
+            if (maskBitmap != nullptr)
+                owner.renderingTarget->CreateBitmapBrush (maskBitmap, bmProps, brushProps, bitmapMaskBrush.resetAndGetPointerAddress());
 
-            maskImage = image.convertedToFormat (Image::ARGB);
-            Image::BitmapData bd (this->image, Image::BitmapData::readOnly); // xxx should be maskImage?
-            bp.pixelFormat = owner.renderingTarget->GetPixelFormat();
-            bp.pixelFormat.alphaMode = D2D1_ALPHA_MODE_PREMULTIPLIED;
-
-            HRESULT hr = owner.renderingTarget->CreateBitmap (size, bd.data, bd.lineStride, bp, maskBitmap.resetAndGetPointerAddress());
-            hr = owner.renderingTarget->CreateBitmapBrush (maskBitmap, bmProps, brushProps, bitmapMaskBrush.resetAndGetPointerAddress());
+            // (the brush only covers the image itself, so anything outside it is masked off with a geometry)
+            maskGeometry = rectListToPathGeometry (RectangleList (image.getBounds()), imageTransform);
 
             imageMaskLayerParams = D2D1::LayerParameters();
+            imageMaskLayerParams.geometricMask = maskGeometry;
             imageMaskLayerParams.opacityBrush = bitmapMaskBrush;
 
             shouldClipBitmap = true;
             pushClips();
         }
 
+        void pushTransparencyLayer (float opacity)
+        {
+            jassert (transparencyLayer == nullptr);
+
+            owner.renderingTarget->CreateLayer (transparencyLayer.resetAndGetPointerAddress());
+
+            if (transparencyLayer != nullptr)
+                owner.renderingTarget->PushLayer (D2D1::LayerParameters (D2D1::InfiniteRect(), nullptr,
+                                                                         D2D1_ANTIALIAS_MODE_PER_PRIMITIVE,
+                                                                         D2D1::IdentityMatrix(), opacity),
+                                                  transparencyLayer);
+        }
+
         void popClips()
         {
             if (clipsBitmap)
@@ -540,14 +588,18 @@ public:
             }
         }
 
-        void createFont()
+        bool createFont()
         {
             if (currentFontFace == nullptr)
             {
-                WindowsDirectWriteTypeface* typeface = dynamic_cast<WindowsDirectWriteTypeface*> (font.getTypeface());
-                currentFontFace = typeface->getIDWriteFontFace();
-                fontHeightToEmSizeFactor = typeface->unitsToHeightScaleFactor();
+                if (WindowsDirectWriteTypeface* const typeface = dynamic_cast<WindowsDirectWriteTypeface*> (font.getTypeface()))
+                {
+                    currentFontFace = typeface->getIDWriteFontFace();
+                    fontHeightToEmSizeFactor = typeface->getUnitsToHeightScaleFactor();
+                }
             }
+
+            return currentFontFace != nullptr;
         }
 
         void setOpacity (float newOpacity)
@@ -563,7 +615,6 @@ public:
             gradientStops = 0;
             linearGradient = 0;
             radialGradient = 0;
-            bitmap = 0;
             bitmapBrush = 0;
             currentBrush = 0;
         }
@@ -582,27 +633,20 @@ public:
                 {
                     D2D1_BRUSH_PROPERTIES brushProps;
                     brushProps.opacity = fillType.getOpacity();
-                    brushProps.transform = transformToMatrix (fillType.transform);
+                    brushProps.transform = transformToMatrix (fillType.transform.followedBy (transform));
 
                     D2D1_BITMAP_BRUSH_PROPERTIES bmProps = D2D1::BitmapBrushProperties (D2D1_EXTEND_MODE_WRAP,D2D1_EXTEND_MODE_WRAP);
 
-                    image = fillType.image;
-
-                    D2D1_SIZE_U size;
-                    size.width = image.getWidth();
-                    size.height = image.getHeight();
-
-                    D2D1_BITMAP_PROPERTIES bp = D2D1::BitmapProperties();
-
-                    this->image = image.convertedToFormat (Image::ARGB);
-                    Image::BitmapData bd (this->image, Image::BitmapData::readOnly);
-                    bp.pixelFormat = owner.renderingTarget->GetPixelFormat();
-                    bp.pixelFormat.alphaMode = D2D1_ALPHA_MODE_PREMULTIPLIED;
-
-                    HRESULT hr = owner.renderingTarget->CreateBitmap (size, bd.data, bd.lineStride, bp, bitmap.resetAndGetPointerAddress());
-                    hr = owner.renderingTarget->CreateBitmapBrush (bitmap, bmProps, brushProps, bitmapBrush.resetAndGetPointerAddress());
-
-                    currentBrush = bitmapBrush;
+                    if (ID2D1Bitmap* const tileBitmap = owner.getBitmapFor (fillType.image))
+                    {
+                        owner.renderingTarget->CreateBitmapBrush (tileBitmap, bmProps, brushProps, bitmapBrush.resetAndGetPointerAddress());
+                        currentBrush = bitmapBrush;
+                    }
+                    else
+                    {
+                        owner.colourBrush->SetColor (colourToD2D (Colours::transparentBlack));
+                        currentBrush = owner.colourBrush;
+                    }
                 }
                 else if (fillType.isGradient())
                 {
@@ -672,9 +716,7 @@ public:
         ComSmartPtr <IDWriteFontFace> localFontFace;
 
         FillType fillType;
-
-        Image image;
-        ComSmartPtr <ID2D1Bitmap> bitmap; // xxx needs a better name - what is this for??
+        Graphics::ResamplingQuality interpolationQuality;
 
         Rectangle<int> clipRect;
         bool clipsRect, shouldClipRect;
@@ -689,13 +731,15 @@ public:
         ComSmartPtr <ID2D1Layer> rectListLayer;
         bool clipsRectList, shouldClipRectList;
 
-        Image maskImage;
         D2D1_LAYER_PARAMETERS imageMaskLayerParams;
         ComSmartPtr <ID2D1Layer> bitmapMaskLayer;
         ComSmartPtr <ID2D1Bitmap> maskBitmap;
+        ComSmartPtr <ID2D1Geometry> maskGeometry;
         ComSmartPtr <ID2D1BitmapBrush> bitmapMaskBrush;
         bool clipsBitmap, shouldClipBitmap;
 
+        ComSmartPtr <ID2D1Layer> transparencyLayer;
+
         ID2D1Brush* currentBrush;
         ComSmartPtr <ID2D1BitmapBrush> bitmapBrush;
         ComSmartPtr <ID2D1LinearGradientBrush> linearGradient;
@@ -716,12 +760,128 @@ private:
     SavedState* currentState;
     OwnedArray<SavedState> states;
 
+    //==============================================================================
+    void createRenderTarget()
+    {
+        RECT windowRect;
+        GetClientRect (hwnd, &windowRect);
+        D2D1_SIZE_U size = { windowRect.right - windowRect.left, windowRect.bottom - windowRect.top };
+        bounds.setSize (size.width, size.height);
+
+        D2D1_RENDER_TARGET_PROPERTIES props = D2D1::RenderTargetProperties();
+        D2D1_HWND_RENDER_TARGET_PROPERTIES propsHwnd = D2D1::HwndRenderTargetProperties (hwnd, size);
+
+        const Direct2DFactories& factories = Direct2DFactories::getInstance();
+        if (factories.d2dFactory != nullptr)
+        {
+            HRESULT hr = factories.d2dFactory->CreateHwndRenderTarget (props, propsHwnd, renderingTarget.resetAndGetPointerAddress());
+            jassert (SUCCEEDED (hr));
+
+            if (SUCCEEDED (hr))
+                hr = renderingTarget->CreateSolidColorBrush (D2D1::ColorF::ColorF (0.0f, 0.0f, 0.0f, 1.0f), colourBrush.resetAndGetPointerAddress());
+        }
+    }
+
+    //==============================================================================
+    /* Bitmaps are uploaded to the device once and then re-used for as long as the image
+       they came from is still alive and hasn't been modified.
+    */
+    struct CachedBitmap
+    {
+        Image image;
+        int modificationCount;
+        ComSmartPtr <ID2D1Bitmap> bitmap;
+        uint32 lastUseTime;
+    };
+
+    OwnedArray<CachedBitmap> bitmapCache;
+    enum { maxNumCachedBitmaps = 64 };
+
+    ID2D1Bitmap* getBitmapFor (const Image& image)
+    {
+        ImagePixelData* const pixelData = image.getPixelData();
+
+        if (pixelData == nullptr || renderingTarget == nullptr)
+            return nullptr;
+
+        const int modificationCount = pixelData->getModificationCount();
+        const uint32 now = Time::getApproximateMillisecondCounter();
+
+        for (int i = bitmapCache.size(); --i >= 0;)
+        {
+            CachedBitmap* const cached = bitmapCache.getUnchecked (i);
+
+            if (cached->image.getPixelData() == pixelData)
+            {
+                if (cached->modificationCount != modificationCount)
+                {
+                    cached->bitmap = createBitmap (image);
+                    cached->modificationCount = modificationCount;
+                }
+
+                cached->lastUseTime = now;
+                return cached->bitmap;
+            }
+        }
+
+        if (bitmapCache.size() >= maxNumCachedBitmaps)
+        {
+            int oldest = 0;
+
+            for (int i = 1; i < bitmapCache.size(); ++i)
+                if (bitmapCache.getUnchecked (i)->lastUseTime < bitmapCache.getUnchecked (oldest)->lastUseTime)
+                    oldest = i;
+
+            bitmapCache.remove (oldest);
+        }
+
+        CachedBitmap* const cached = new CachedBitmap();
+        cached->image = image;
+        cached->modificationCount = modificationCount;
+        cached->bitmap = createBitmap (image);
+        cached->lastUseTime = now;
+        bitmapCache.add (cached);
+
+        return cached->bitmap;
+    }
+
+    void releaseUnusedBitmaps()
+    {
+        // if the cache holds the only reference to an image, nobody can draw it again
+        for (int i = bitmapCache.size(); --i >= 0;)
+            if (bitmapCache.getUnchecked (i)->image.getReferenceCount() <= 1)
+                bitmapCache.remove (i);
+    }
+
+    ComSmartPtr <ID2D1Bitmap> createBitmap (const Image& image) const
+    {
+        D2D1_SIZE_U size;
+        size.width = image.getWidth();
+        size.height = image.getHeight();
+
+        D2D1_BITMAP_PROPERTIES bp = D2D1::BitmapProperties();
+        bp.pixelFormat = renderingTarget->GetPixelFormat();
+        bp.pixelFormat.alphaMode = D2D1_ALPHA_MODE_PREMULTIPLIED;
+
+        const Image argbImage (image.convertedToFormat (Image::ARGB));
+        const Image::BitmapData bd (argbImage, Image::BitmapData::readOnly);
+
+        ComSmartPtr <ID2D1Bitmap> bitmap;
+        renderingTarget->CreateBitmap (size, bd.data, bd.lineStride, bp, bitmap.resetAndGetPointerAddress());
+        return bitmap;
+    }
+
     //==============================================================================
     static D2D1_RECT_F rectangleToRectF (const Rectangle<int>& r)
     {
         return D2D1::RectF ((float) r.getX(), (float) r.getY(), (float) r.getRight(), (float) r.getBottom());
     }
 
+    static D2D1_RECT_F rectangleToRectF (const Rectangle<float>& r)
+    {
+        return D2D1::RectF (r.getX(), r.getY(), r.getRight(), r.getBottom());
+    }
+
     static D2D1_COLOR_F colourToD2D (const Colour& c)
     {
         return D2D1::ColorF::ColorF (c.getFloatRed(), c.getFloatGreen(), c.getFloatBlue(), c.getFloatAlpha());
@@ -729,38 +889,52 @@ private:
 
     static D2D1_POINT_2F pointTransformed (int x, int y, const AffineTransform& transform)
     {
-        transform.transformPoint (x, y);
-        return D2D1::Point2F ((FLOAT) x, (FLOAT) y);
+        float fx = (float) x, fy = (float) y;
+        transform.transformPoint (fx, fy);
+        return D2D1::Point2F (fx, fy);
     }
 
-    static void rectToGeometrySink (const Rectangle<int>& rect, ID2D1GeometrySink* sink)
+    static void rectToGeometrySink (const Rectangle<int>& rect, ID2D1GeometrySink* sink, const AffineTransform& transform)
     {
-        sink->BeginFigure (pointTransformed (rect.getX(), rect.getY()), D2D1_FIGURE_BEGIN_FILLED);
-        sink->AddLine (pointTransformed (rect.getRight(), rect.getY()));
-        sink->AddLine (pointTransformed (rect.getRight(), rect.getBottom()));
-        sink->AddLine (pointTransformed (rect.getX(), rect.getBottom()));
+        sink->BeginFigure (pointTransformed (rect.getX(),     rect.getY(),      transform), D2D1_FIGURE_BEGIN_FILLED);
+        sink->AddLine (pointTransformed (rect.getRight(), rect.getY(),      transform));
+        sink->AddLine (pointTransformed (rect.getRight(), rect.getBottom(), transform));
+        sink->AddLine (pointTransformed (rect.getX(),     rect.getBottom(), transform));
         sink->EndFigure (D2D1_FIGURE_END_CLOSED);
     }
 
-    static ID2D1PathGeometry* rectListToPathGeometry (const RectangleList& clipRegion)
+    static ComSmartPtr <ID2D1Geometry> rectListToPathGeometry (const RectangleList& clipRegion, const AffineTransform& transform)
     {
-        ID2D1PathGeometry* p = nullptr;
-        Direct2DFactories::getInstance().d2dFactory->CreatePathGeometry (&p);
+        ComSmartPtr <ID2D1PathGeometry> p;
+        Direct2DFactories::getInstance().d2dFactory->CreatePathGeometry (p.resetAndGetPointerAddress());
 
         ComSmartPtr <ID2D1GeometrySink> sink;
         HRESULT hr = p->Open (sink.resetAndGetPointerAddress()); // xxx handle error
         sink->SetFillMode (D2D1_FILL_MODE_WINDING);
 
         for (int i = clipRegion.getNumRectangles(); --i >= 0;)
-            rectToGeometrySink (clipRegion.getRectangle(i), sink);
+            rectToGeometrySink (clipRegion.getRectangle(i), sink, transform);
+
+        hr = sink->Close();
+        return ComSmartPtr <ID2D1Geometry> (p);
+    }
+
+    static ComSmartPtr <ID2D1Geometry> combineGeometries (ID2D1Geometry* first, ID2D1Geometry* second, D2D1_COMBINE_MODE mode)
+    {
+        ComSmartPtr <ID2D1PathGeometry> p;
+        Direct2DFactories::getInstance().d2dFactory->CreatePathGeometry (p.resetAndGetPointerAddress());
 
+        ComSmartPtr <ID2D1GeometrySink> sink;
+        HRESULT hr = p->Open (sink.resetAndGetPointerAddress());
+        first->CombineWithGeometry (second, mode, D2D1::IdentityMatrix(), sink);
         hr = sink->Close();
-        return p;
+        return ComSmartPtr <ID2D1Geometry> (p);
     }
 
     static void pathToGeometrySink (const Path& path, ID2D1GeometrySink* sink, const AffineTransform& transform)
     {
         Path::Iterator it (path);
+        bool isFigureOpen = false;
 
         while (it.next())
         {
@@ -807,32 +981,41 @@ private:
                 case Path::Iterator::closePath:
                 {
                     sink->EndFigure (D2D1_FIGURE_END_CLOSED);
+                    isFigureOpen = false;
                     break;
                 }
 
                 case Path::Iterator::startNewSubPath:
                 {
+                    // (sub-paths that aren't explicitly closed still have to be ended before the next one begins)
+                    if (isFigureOpen)
+                        sink->EndFigure (D2D1_FIGURE_END_CLOSED);
+
                     transform.transformPoint (it.x1, it.y1);
                     sink->BeginFigure (D2D1::Point2F (it.x1, it.y1), D2D1_FIGURE_BEGIN_FILLED);
+                    isFigureOpen = true;
                     break;
                 }
             }
         }
+
+        if (isFigureOpen)
+            sink->EndFigure (D2D1_FIGURE_END_CLOSED);
     }
 
-    static ID2D1PathGeometry* pathToPathGeometry (const Path& path, const AffineTransform& transform)
+    static ComSmartPtr <ID2D1Geometry> pathToPathGeometry (const Path& path, const AffineTransform& transform)
     {
-        ID2D1PathGeometry* p = nullptr;
-        Direct2DFactories::getInstance().d2dFactory->CreatePathGeometry (&p);
+        ComSmartPtr <ID2D1PathGeometry> p;
+        Direct2DFactories::getInstance().d2dFactory->CreatePathGeometry (p.resetAndGetPointerAddress());
 
         ComSmartPtr <ID2D1GeometrySink> sink;
         HRESULT hr = p->Open (sink.resetAndGetPointerAddress());
-        sink->SetFillMode (D2D1_FILL_MODE_WINDING); // xxx need to check Path::isUsingNonZeroWinding()
+        sink->SetFillMode (path.isUsingNonZeroWinding() ? D2D1_FILL_MODE_WINDING : D2D1_FILL_MODE_ALTERNATE);
 
         pathToGeometrySink (path, sink, transform);
 
         hr = sink->Close();
-        return p;
+        return ComSmartPtr <ID2D1Geometry> (p);
     }
 
     static D2D1::Matrix3x2F transformToMatrix (const AffineTransform& transform)
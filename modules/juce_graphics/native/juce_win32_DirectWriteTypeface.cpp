@@ -257,6 +257,7 @@ public:
     }
 
     IDWriteFontFace* getIDWriteFontFace() const noexcept    { return dwFontFace; }
+    float getUnitsToHeightScaleFactor() const noexcept      { return unitsToHeightScaleFactor; }
 
 private:
     ComSmartPtr<IDWriteFontFace> dwFontFace;
@@ -364,6 +364,126 @@ struct Component::ComponentHelpers
     }
 };
 
+//==============================================================================
+/*  A uniform grid over a component's local bounds, where each cell lists (in z-order)
+    the indexes of the children whose bounding boxes overlap it.
+*/
+struct Component::ChildHitTestIndex
+{
+    ChildHitTestIndex() noexcept
+        : needsRebuilding (true), numColumns (1), numRows (1), cellWidth (1), cellHeight (1)
+    {
+    }
+
+    static void invalidate (Component* const comp) noexcept
+    {
+        if (comp != nullptr && comp->childHitTestIndex != nullptr)
+            comp->childHitTestIndex->needsRebuilding = true;
+    }
+
+    Component* findComponentAt (Component& parent, Point<int> position)
+    {
+        if (needsRebuilding)
+            rebuild (parent);
+
+        const int cell = jlimit (0, numRows - 1, position.y / cellHeight) * numColumns
+                           + jlimit (0, numColumns - 1, position.x / cellWidth);
+
+        const int* const indexes = childIndexes.getRawDataPointer();
+
+        for (int i = cellStarts.getUnchecked (cell + 1); --i >= cellStarts.getUnchecked (cell);)
+        {
+            Component* child = parent.childComponentList.getUnchecked (indexes[i]);
+            child = child->getComponentAt (ComponentHelpers::convertFromParentSpace (*child, position));
+
+            if (child != nullptr)
+                return child;
+        }
+
+        return &parent;
+    }
+
+private:
+    Array<int> cellStarts, childIndexes;
+    bool needsRebuilding;
+    int numColumns, numRows, cellWidth, cellHeight;
+
+    void rebuild (Component& parent)
+    {
+        needsRebuilding = false;
+
+        const Array<Component*>& children = parent.childComponentList;
+        const int numChildren = children.size();
+        const int w = jmax (1, parent.getWidth());
+        const int h = jmax (1, parent.getHeight());
+
+        // aim for a handful of children per cell
+        const int divisions = jlimit (1, 128, roundToInt (std::sqrt (numChildren / 4.0)));
+        cellWidth  = jmax (1, (w + divisions - 1) / divisions);
+        cellHeight = jmax (1, (h + divisions - 1) / divisions);
+        numColumns = (w + cellWidth - 1) / cellWidth;
+        numRows    = (h + cellHeight - 1) / cellHeight;
+
+        const int numCells = numColumns * numRows;
+        const Rectangle<int> parentArea (w, h);
+
+        Array<Rectangle<int> > cellRanges;
+        cellRanges.ensureStorageAllocated (numChildren);
+
+        cellStarts.clearQuick();
+        cellStarts.insertMultiple (0, 0, numCells + 1);
+        int* const starts = cellStarts.getRawDataPointer();
+
+        for (int i = 0; i < numChildren; ++i)
+        {
+            const Component& child = *children.getUnchecked (i);
+            Rectangle<int> area (child.getBoundsInParent());
+
+            // (allow for the rounding when points are mapped through the child's transform)
+            if (child.affineTransform != nullptr)
+                area = area.expanded (1, 1);
+
+            area = area.getIntersection (parentArea);
+
+            Rectangle<int> range;
+
+            if (! area.isEmpty())
+            {
+                range.setBounds (area.getX() / cellWidth, area.getY() / cellHeight, 0, 0);
+                range.setRight  ((area.getRight()  - 1) / cellWidth  + 1);
+                range.setBottom ((area.getBottom() - 1) / cellHeight + 1);
+
+                for (int y = range.getY(); y < range.getBottom(); ++y)
+                    for (int x = range.getX(); x < range.getRight(); ++x)
+                        ++starts [y * numColumns + x + 1];
+            }
+
+            cellRanges.add (range);
+        }
+
+        for (int i = 1; i <= numCells; ++i)
+            starts[i] += starts[i - 1];
+
+        childIndexes.clearQuick();
+        childIndexes.insertMultiple (0, 0, starts[numCells]);
+        int* const indexes = childIndexes.getRawDataPointer();
+
+        Array<int> fillPositions (cellStarts);
+        int* const positions = fillPositions.getRawDataPointer();
+
+        for (int i = 0; i < numChildren; ++i)
+        {
+            const Rectangle<int>& range = cellRanges.getReference (i);
+
+            for (int y = range.getY(); y < range.getBottom(); ++y)
+                for (int x = range.getX(); x < range.getRight(); ++x)
+                    indexes [positions [y * numColumns + x]++] = i;
+        }
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (ChildHitTestIndex)
+};
+
 //==============================================================================
 Component::Component()
   : parentComponent (nullptr),
@@ -521,6 +641,7 @@ void Component::addToDesktop (int styleWanted, void* nativeWindowToAttachTo)
     // if component methods are being called from threads other than the message
     // thread, you'll need to use a MessageManagerLock object to make sure it's thread-safe.
     CHECK_MESSAGE_MANAGER_IS_LOCKED
+    JUCE_TRACE_SCOPE ("Component::addToDesktop");
 
     if (isOpaque())
         styleWanted &= ~ComponentPeer::windowIsSemiTransparent;
@@ -709,6 +830,8 @@ public:
             for (const Rectangle<int>* i = validArea.begin(), * const e = validArea.end(); i != e; ++i)
                 lg.excludeClipRectangle (*i);
 
+            ComponentProfiler::cachedImageDrawn (owner, ! lg.isClipEmpty());
+
             if (! lg.isClipEmpty())
             {
                 if (! owner.isOpaque())
@@ -740,6 +863,39 @@ private:
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (StandardCachedComponentImage)
 };
 
+//==============================================================================
+class DisplayListCachedComponentImage  : public CachedComponentImage
+{
+public:
+    DisplayListCachedComponentImage (Component& c) noexcept : owner (c) {}
+
+    void paint (Graphics& g)
+    {
+        ComponentProfiler::cachedImageDrawn (owner, displayList == nullptr);
+
+        if (displayList == nullptr)
+        {
+            displayList = new DisplayList (owner.getLocalBounds());
+            displayList->setFont (g.getCurrentFont());
+
+            Graphics recorder (displayList);
+            owner.paintEntireComponent (recorder, false);
+        }
+
+        displayList->draw (g);
+    }
+
+    void invalidateAll()                            { displayList = nullptr; }
+    void invalidate (const Rectangle<int>&)         { displayList = nullptr; }
+    void releaseResources()                         { displayList = nullptr; }
+
+private:
+    ScopedPointer<DisplayList> displayList;
+    Component& owner;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DisplayListCachedComponentImage)
+};
+
 void Component::setCachedComponentImage (CachedComponentImage* newCachedImage)
 {
     if (cachedImage != newCachedImage)
@@ -768,6 +924,24 @@ void Component::setBufferedToImage (const bool shouldBeBuffered)
     }
 }
 
+void Component::setBufferedToDisplayList (const bool shouldBeBuffered)
+{
+    // This assertion means that this component is already using a different CachedComponentImage,
+    // so by calling setBufferedToDisplayList, you'll be deleting it. If you really do want to do that,
+    // call setCachedComponentImage (nullptr) before setBufferedToDisplayList().
+    jassert (cachedImage == nullptr || dynamic_cast <DisplayListCachedComponentImage*> (cachedImage.get()) != nullptr);
+
+    if (shouldBeBuffered)
+    {
+        if (cachedImage == nullptr)
+            cachedImage = new DisplayListCachedComponentImage (*this);
+    }
+    else
+    {
+        cachedImage = nullptr;
+    }
+}
+
 //==============================================================================
 void Component::reorderChildInternal (const int sourceIndex, const int destIndex)
 {
@@ -778,6 +952,7 @@ void Component::reorderChildInternal (const int sourceIndex, const int destIndex
         c->repaintParent();
 
         childComponentList.move (sourceIndex, destIndex);
+        ChildHitTestIndex::invalidate (this);
 
         sendFakeMouseMove();
         internalChildrenChanged();
@@ -1024,22 +1199,33 @@ void Component::setBounds (const int x, const int y, int w, int h)
     if (wasMoved || wasResized)
     {
         const bool showing = isShowing();
+
+        // (if the peer has already scrolled this component's pixels into place, the parent
+        // doesn't need repainting)
+        const bool needsParentRepaint = ! (flags.hasHeavyweightPeerFlag || flags.movedByScrollingFlag);
+        flags.movedByScrollingFlag = false;
+
         if (showing)
         {
             // send a fake mouse move to trigger enter/exit messages if needed..
             sendFakeMouseMove();
 
-            if (! flags.hasHeavyweightPeerFlag)
+            if (needsParentRepaint)
                 repaintParent();
         }
 
         bounds.setBounds (x, y, w, h);
 
+        ChildHitTestIndex::invalidate (parentComponent);
+
+        if (wasResized)
+            ChildHitTestIndex::invalidate (this);
+
         if (showing)
         {
             if (wasResized)
                 repaint();
-            else if (! flags.hasHeavyweightPeerFlag)
+            else if (needsParentRepaint)
                 repaintParent();
         }
         else if (cachedImage != nullptr)
@@ -1069,7 +1255,10 @@ void Component::sendMovedResizedMessages (const bool wasMoved, const bool wasRes
 
     if (wasResized)
     {
-        resized();
+        {
+            const ComponentProfiler::ScopedTiming timing (*this, ComponentProfiler::resizedCall);
+            resized();
+        }
 
         if (checker.shouldBailOut())
             return;
@@ -1227,6 +1416,7 @@ void Component::setTransform (const AffineTransform& newTransform)
             affineTransform = nullptr;
             repaint();
 
+            ChildHitTestIndex::invalidate (parentComponent);
             sendMovedResizedMessages (false, false);
         }
     }
@@ -1235,6 +1425,7 @@ void Component::setTransform (const AffineTransform& newTransform)
         repaint();
         affineTransform = new AffineTransform (newTransform);
         repaint();
+        ChildHitTestIndex::invalidate (parentComponent);
         sendMovedResizedMessages (false, false);
     }
     else if (*affineTransform != newTransform)
@@ -1242,6 +1433,7 @@ void Component::setTransform (const AffineTransform& newTransform)
         repaint();
         *affineTransform = newTransform;
         repaint();
+        ChildHitTestIndex::invalidate (parentComponent);
         sendMovedResizedMessages (false, false);
     }
 }
@@ -1316,6 +1508,9 @@ Component* Component::getComponentAt (Point<int> position)
 {
     if (flags.visibleFlag && ComponentHelpers::hitTest (*this, position))
     {
+        if (childHitTestIndex != nullptr)
+            return childHitTestIndex->findComponentAt (*this, position);
+
         for (int i = childComponentList.size(); --i >= 0;)
         {
             Component* child = childComponentList.getUnchecked(i);
@@ -1336,6 +1531,17 @@ Component* Component::getComponentAt (const int x, const int y)
     return getComponentAt (Point<int> (x, y));
 }
 
+void Component::setUsesChildHitTestIndex (const bool shouldUseIndex)
+{
+    if (shouldUseIndex != isUsingChildHitTestIndex())
+        childHitTestIndex = shouldUseIndex ? new ChildHitTestIndex() : nullptr;
+}
+
+bool Component::isUsingChildHitTestIndex() const noexcept
+{
+    return childHitTestIndex != nullptr;
+}
+
 //==============================================================================
 void Component::addChildComponent (Component* const child, int zOrder)
 {
@@ -1370,6 +1576,7 @@ void Component::addChildComponent (Component* const child, int zOrder)
         }
 
         childComponentList.insert (zOrder, child);
+        ChildHitTestIndex::invalidate (this);
 
         child->internalHierarchyChanged();
         internalChildrenChanged();
@@ -1426,6 +1633,7 @@ Component* Component::removeChildComponent (const int index, bool sendParentEven
 
         childComponentList.remove (index);
         child->parentComponent = nullptr;
+        ChildHitTestIndex::invalidate (this);
 
         if (child->cachedImage != nullptr)
             child->cachedImage->releaseResources();
@@ -1777,6 +1985,8 @@ void Component::internalRepaintUnchecked (const Rectangle<int>& area, const bool
 {
     if (flags.visibleFlag)
     {
+        ComponentProfiler::repaintRequested (*this);
+
         if (cachedImage != nullptr)
         {
             if (isEntireComponent)
@@ -1832,6 +2042,7 @@ void Component::paintComponentAndChildren (Graphics& g)
 
     if (flags.dontClipGraphicsFlag)
     {
+        const ComponentProfiler::ScopedTiming timing (*this, ComponentProfiler::paintCall);
         paint (g);
     }
     else
@@ -1839,7 +2050,10 @@ void Component::paintComponentAndChildren (Graphics& g)
         g.saveState();
 
         if (ComponentHelpers::clipObscuredRegions (*this, g, clipBounds, Point<int>()) || ! g.isClipEmpty())
+        {
+            const ComponentProfiler::ScopedTiming timing (*this, ComponentProfiler::paintCall);
             paint (g);
+        }
 
         g.restoreState();
     }
@@ -1893,7 +2107,12 @@ void Component::paintComponentAndChildren (Graphics& g)
     }
 
     g.saveState();
-    paintOverChildren (g);
+
+    {
+        const ComponentProfiler::ScopedTiming timing (*this, ComponentProfiler::paintOverChildrenCall);
+        paintOverChildren (g);
+    }
+
     g.restoreState();
 }
 
@@ -931,6 +931,28 @@ public:
     */
     Component* getComponentAt (Point<int> position);
 
+    /** Enables a spatial index of this component's children, to speed up getComponentAt().
+
+        Normally, finding the child at a given position means testing every child in turn,
+        which becomes slow when a component has thousands of children and is being searched
+        on every mouse-move. When this is enabled, the component keeps a grid of its children's
+        bounding boxes, so that only the few children whose bounds overlap a point need to be
+        tested.
+
+        The index is thrown away whenever a child is added, removed, re-ordered, moved or
+        transformed, and is rebuilt the next time it's needed, so it's best suited to
+        components whose children don't move around continuously.
+
+        @see getComponentAt, isUsingChildHitTestIndex
+    */
+    void setUsesChildHitTestIndex (bool shouldUseIndex);
+
+    /** Returns true if setUsesChildHitTestIndex() has been used to enable a spatial index of
+        this component's children.
+        @see setUsesChildHitTestIndex
+    */
+    bool isUsingChildHitTestIndex() const noexcept;
+
     //==============================================================================
     /** Marks the whole component as needing to be redrawn.
 
@@ -1001,6 +1023,23 @@ public:
     */
     void setBufferedToImage (bool shouldBeBuffered);
 
+    /** Makes the component keep a recording of its drawing operations, to optimise its redrawing.
+
+        This is an alternative to setBufferedToImage() for components that are expensive to
+        paint but rarely change. Instead of an image, the component keeps a DisplayList of
+        the drawing operations that its paint() methods and its children perform, and when
+        it's asked to redraw itself, it replays the list rather than calling paint(). This
+        takes much less memory than an image buffer, and the result is drawn at the target's
+        real resolution and transform.
+
+        The recording is discarded when repaint() is called on this component or any of its
+        children (or when it's resized), and is re-recorded the next time that the component
+        is painted.
+
+        @see setBufferedToImage, DisplayList, repaint
+    */
+    void setBufferedToDisplayList (bool shouldBeBuffered);
+
     /** Generates a snapshot of part of this component.
 
         This will return a new Image, the size of the rectangle specified,
@@ -2242,6 +2281,10 @@ private:
     ImageEffectFilter* effect;
     ScopedPointer <CachedComponentImage> cachedImage;
 
+    struct ChildHitTestIndex;
+    friend struct ChildHitTestIndex;
+    ScopedPointer <ChildHitTestIndex> childHitTestIndex;
+
     class MouseListenerList;
     friend class MouseListenerList;
     friend class ScopedPointer <MouseListenerList>;
@@ -2272,6 +2315,7 @@ private:
         bool childCompFocusedFlag       : 1;
         bool dontClipGraphicsFlag       : 1;
         bool mouseDownWasBlocked        : 1;
+        bool movedByScrollingFlag       : 1;
       #if JUCE_DEBUG
         bool isInsidePaintCall          : 1;
       #endif
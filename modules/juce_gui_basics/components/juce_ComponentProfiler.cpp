@@ -0,0 +1,333 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+
+bool ComponentProfiler::enabled = false;
+ComponentProfiler* ComponentProfiler::instance = nullptr;
+
+ComponentProfiler::Statistics::Statistics() noexcept
+    : componentStillExists (true),
+      numPaints (0), numPaintOverChildren (0), numResizes (0),
+      numRepaintRequests (0), numCacheHits (0), numCacheMisses (0),
+      totalPaintMs (0), worstPaintMs (0), totalPaintOverChildrenMs (0), totalResizedMs (0),
+      constructionMs (0), timeToFirstPaintMs (0)
+{
+}
+
+double ComponentProfiler::Statistics::getTotalTimeMs() const noexcept
+{
+    return totalPaintMs + totalPaintOverChildrenMs + totalResizedMs + constructionMs;
+}
+
+double ComponentProfiler::Statistics::getAveragePaintMs() const noexcept
+{
+    return numPaints > 0 ? totalPaintMs / numPaints : 0.0;
+}
+
+double ComponentProfiler::Statistics::getCacheHitRate() const noexcept
+{
+    const int total = numCacheHits + numCacheMisses;
+    return total > 0 ? numCacheHits / (double) total : 0.0;
+}
+
+//==============================================================================
+ComponentProfiler::Entry::Entry (const Component& c)
+    : component (const_cast<Component*> (&c)),
+      firstSeenTicks (Time::getHighResolutionTicks())
+{
+    const String className (typeid (c).name());
+    const String name (c.getName().isNotEmpty() ? c.getName() : c.getComponentID());
+
+    stats.componentName = name.isNotEmpty() ? className + " \"" + name + "\""
+                                            : className;
+}
+
+//==============================================================================
+ComponentProfiler::ComponentProfiler()
+    : maxTraceEvents (100000),
+      startTicks (Time::getHighResolutionTicks())
+{
+}
+
+ComponentProfiler::~ComponentProfiler()
+{
+    enabled = false;
+    instance = nullptr;
+}
+
+ComponentProfiler& ComponentProfiler::getInstance()
+{
+    if (instance == nullptr)
+        instance = new ComponentProfiler();
+
+    return *instance;
+}
+
+void ComponentProfiler::setEnabled (const bool shouldBeEnabled)
+{
+    // the profiler isn't thread-safe, so must only be used on the message thread
+    jassert (MessageManager::getInstance()->currentThreadHasLockedMessageManager());
+
+    if (shouldBeEnabled)
+        getInstance();
+
+    enabled = shouldBeEnabled;
+}
+
+void ComponentProfiler::reset()
+{
+    entries.clear();
+    entryIndexes.clear();
+    traceEvents.clear();
+    startTicks = Time::getHighResolutionTicks();
+}
+
+void ComponentProfiler::setMaxTraceEvents (const int maxNumEvents)
+{
+    maxTraceEvents = jmax (0, maxNumEvents);
+
+    if (traceEvents.size() > maxTraceEvents)
+        traceEvents.removeRange (maxTraceEvents, traceEvents.size());
+}
+
+//==============================================================================
+int ComponentProfiler::getEntryIndex (const Component& c)
+{
+    const int64 key = (int64) (pointer_sized_int) &c;
+    const int existing = entryIndexes [key];
+
+    // (If the component that was measured at this address has been deleted, this must be
+    // a new one that's been allocated in the same place, so it gets a new entry)
+    if (existing > 0 && entries.getUnchecked (existing - 1)->component.get() == &c)
+        return existing - 1;
+
+    entries.add (new Entry (c));
+    entryIndexes.set (key, entries.size());
+    return entries.size() - 1;
+}
+
+ComponentProfiler::Entry& ComponentProfiler::getEntryFor (const Component& c)
+{
+    return *entries.getUnchecked (getEntryIndex (c));
+}
+
+void ComponentProfiler::addCall (const Component& c, const CallType type, const int64 start, const int64 end)
+{
+    const int index = getEntryIndex (c);
+    Entry& entry = *entries.getUnchecked (index);
+    Statistics& stats = entry.stats;
+    const double ms = Time::highResolutionTicksToSeconds (end - start) * 1000.0;
+
+    switch (type)
+    {
+        case paintCall:
+            if (stats.numPaints == 0)
+                stats.timeToFirstPaintMs = Time::highResolutionTicksToSeconds (end - entry.firstSeenTicks) * 1000.0;
+
+            stats.numPaints++;
+            stats.totalPaintMs += ms;
+            stats.worstPaintMs = jmax (stats.worstPaintMs, ms);
+            break;
+
+        case paintOverChildrenCall:
+            stats.numPaintOverChildren++;
+            stats.totalPaintOverChildrenMs += ms;
+            break;
+
+        case resizedCall:
+            stats.numResizes++;
+            stats.totalResizedMs += ms;
+            break;
+
+        case constructorCall:
+            stats.constructionMs += ms;
+            entry.firstSeenTicks = jmin (entry.firstSeenTicks, start);
+            break;
+
+        default:
+            jassertfalse;
+            break;
+    }
+
+    if (traceEvents.size() < maxTraceEvents)
+    {
+        const TraceEvent e = { index, type, start, end };
+        traceEvents.add (e);
+    }
+}
+
+//==============================================================================
+struct ComponentProfilerStatisticsComparator
+{
+    static int compareElements (const ComponentProfiler::Statistics& first,
+                                const ComponentProfiler::Statistics& second) noexcept
+    {
+        const double t1 = first.getTotalTimeMs();
+        const double t2 = second.getTotalTimeMs();
+
+        return t1 > t2 ? -1 : (t1 < t2 ? 1 : 0);
+    }
+};
+
+Array<ComponentProfiler::Statistics> ComponentProfiler::getStatistics() const
+{
+    Array<Statistics> results;
+    results.ensureStorageAllocated (entries.size());
+
+    for (int i = 0; i < entries.size(); ++i)
+    {
+        const Entry& e = *entries.getUnchecked (i);
+        results.add (e.stats);
+        results.getReference (i).componentStillExists = (e.component != nullptr);
+    }
+
+    ComponentProfilerStatisticsComparator comparator;
+    results.sort (comparator, true);
+    return results;
+}
+
+String ComponentProfiler::getChromeTraceJSON() const
+{
+    static const char* const categories[] = { "paint", "paintOverChildren", "resized", "constructor" };
+
+    MemoryOutputStream out;
+    out << "{\"traceEvents\":[";
+
+    for (int i = 0; i < traceEvents.size(); ++i)
+    {
+        const TraceEvent& e = traceEvents.getReference (i);
+        const int64 startMicros = (int64) (Time::highResolutionTicksToSeconds (e.startTicks - startTicks) * 1.0e6);
+        const int64 durationMicros = (int64) (Time::highResolutionTicksToSeconds (e.endTicks - e.startTicks) * 1.0e6);
+
+        if (i > 0)
+            out << ',';
+
+        out << newLine
+            << "{\"name\":" << JSON::toString (entries.getUnchecked (e.entryIndex)->stats.componentName)
+            << ",\"cat\":\"" << categories [e.type]
+            << "\",\"ph\":\"X\",\"ts\":" << startMicros
+            << ",\"dur\":" << durationMicros
+            << ",\"pid\":1,\"tid\":1}";
+    }
+
+    out << newLine << "]}" << newLine;
+    return out.toString();
+}
+
+bool ComponentProfiler::writeChromeTrace (const File& file) const
+{
+    return file.replaceWithText (getChromeTraceJSON());
+}
+
+//==============================================================================
+ComponentProfiler::OverlayComponent::OverlayComponent (const int maxNumComponentsToShow)
+    : maxNumToShow (maxNumComponentsToShow)
+{
+    setName ("ComponentProfiler overlay");
+    setInterceptsMouseClicks (false, false);
+    setAlwaysOnTop (true);
+
+    ComponentProfiler::setEnabled (true);
+    startTimer (250);
+}
+
+ComponentProfiler::OverlayComponent::~OverlayComponent()
+{
+}
+
+void ComponentProfiler::OverlayComponent::timerCallback()
+{
+    repaint();
+}
+
+void ComponentProfiler::OverlayComponent::parentSizeChanged()       { updateBounds(); }
+void ComponentProfiler::OverlayComponent::parentHierarchyChanged()  { updateBounds(); }
+
+void ComponentProfiler::OverlayComponent::updateBounds()
+{
+    const int lineHeight = 14;
+    const int h = (maxNumToShow + 3) * lineHeight + 8;
+
+    if (Component* const parent = getParentComponent())
+        setBounds (0, 0, jmin (parent->getWidth(), 700), jmin (parent->getHeight(), h));
+    else
+        setSize (700, h);
+}
+
+void ComponentProfiler::OverlayComponent::paint (Graphics& g)
+{
+    g.fillAll (Colours::black.withAlpha (0.75f));
+    g.setFont (Font (Font::getDefaultMonospacedFontName(), 12.0f, Font::plain));
+    g.setColour (Colours::white);
+
+    const int lineHeight = 14;
+    const int w = getWidth() - 8;
+    int y = 4;
+
+    if (ComponentPeer* const peer = getPeer())
+    {
+        if (const PaintScheduler* const scheduler = peer->getPaintScheduler())
+        {
+            const PaintScheduler::Statistics& frames = scheduler->getStatistics();
+
+            g.drawText ("Frames: " + String (frames.numFramesPainted)
+                          + "  dropped: " + String (frames.numFramesDropped)
+                          + "  last: " + String (frames.lastPaintTimeMs, 2)
+                          + "ms  avg: " + String (frames.averagePaintTimeMs, 2)
+                          + "ms  worst: " + String (frames.worstPaintTimeMs, 2) + "ms",
+                        4, y, w, lineHeight, Justification::centredLeft, true);
+        }
+    }
+
+    y += lineHeight;
+
+    g.drawText ("   total ms   paints  avg ms  worst ms  resizes  repaints  cache  1st paint  component",
+                4, y, w, lineHeight, Justification::centredLeft, true);
+    y += lineHeight;
+
+    const Array<Statistics> stats (ComponentProfiler::getInstance().getStatistics());
+
+    for (int i = 0; i < jmin (maxNumToShow, stats.size()); ++i)
+    {
+        const Statistics& s = stats.getReference (i);
+        const int numCacheDraws = s.numCacheHits + s.numCacheMisses;
+
+        String line;
+        line << String (s.getTotalTimeMs(), 2).paddedLeft (' ', 11)
+             << String (s.numPaints).paddedLeft (' ', 9)
+             << String (s.getAveragePaintMs(), 3).paddedLeft (' ', 8)
+             << String (s.worstPaintMs, 2).paddedLeft (' ', 10)
+             << String (s.numResizes).paddedLeft (' ', 9)
+             << String (s.numRepaintRequests).paddedLeft (' ', 10)
+             << (numCacheDraws > 0 ? String (roundToInt (s.getCacheHitRate() * 100.0)) + "%"
+                                   : String ("-")).paddedLeft (' ', 7)
+             << (s.numPaints > 0 ? String (s.timeToFirstPaintMs, 1)
+                                 : String ("-")).paddedLeft (' ', 11)
+             << "  " << s.componentName;
+
+        g.setColour (s.componentStillExists ? Colours::white : Colours::grey);
+        g.drawText (line, 4, y, w, lineHeight, Justification::centredLeft, true);
+        y += lineHeight;
+    }
+}
@@ -0,0 +1,278 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+
+#ifndef __JUCE_COMPONENTPROFILER_JUCEHEADER__
+#define __JUCE_COMPONENTPROFILER_JUCEHEADER__
+
+
+//==============================================================================
+/**
+    Measures how long components take to paint and lay themselves out.
+
+    When the profiler is enabled, every call to Component::paint(), Component::paintOverChildren()
+    and Component::resized() is timed, and the results are collected for each component, along
+    with the number of times it asked to be repainted, and how often its CachedComponentImage
+    (if it has one) was able to redraw itself without calling paint().
+
+    When it's disabled (the default), the only cost is a check of a static flag per call, so
+    it's safe to leave the profiler compiled into a release build and turn it on when a slow
+    widget needs to be tracked down.
+
+    You can look at the results with getStatistics(), show them live on top of a window with
+    an OverlayComponent, or save the individual calls with writeChromeTrace() and load the
+    file into a trace viewer such as Chrome's about:tracing page.
+
+    To find out why a window is slow to appear, it can also measure how long components take
+    to construct (see componentCreated(), which AudioProcessor calls for the editors it creates),
+    and how long it then takes until their first paint() has finished. To see where the rest of
+    the startup time goes, e.g. in image decoding or font loading, build with JUCE_ENABLE_TRACING
+    and look at the TraceLog, and use an AssetPreloader to move that work off the message thread.
+
+    All the methods must be called on the message thread.
+
+    @code
+    ComponentProfiler::setEnabled (true);
+    myWindow.addAndMakeVisible (overlay = new ComponentProfiler::OverlayComponent());
+    ...
+    ComponentProfiler::getInstance().writeChromeTrace (File ("~/paint_trace.json"));
+    @endcode
+*/
+class JUCE_API  ComponentProfiler  : private DeletedAtShutdown
+{
+public:
+    //==============================================================================
+    /** Returns the profiler, creating it if necessary. */
+    static ComponentProfiler& getInstance();
+
+    /** Turns the profiler on or off. */
+    static void setEnabled (bool shouldBeEnabled);
+
+    /** Returns true if the profiler is turned on. */
+    static bool isEnabled() noexcept                { return enabled; }
+
+    //==============================================================================
+    /** The timings that have been collected for a component.
+        @see getStatistics
+    */
+    struct JUCE_API  Statistics
+    {
+        Statistics() noexcept;
+
+        String componentName;               /**< The component's class and name. */
+        bool componentStillExists;          /**< False if the component has been deleted since it was measured. */
+
+        int numPaints;                      /**< The number of calls to paint(). */
+        int numPaintOverChildren;           /**< The number of calls to paintOverChildren(). */
+        int numResizes;                     /**< The number of calls to resized(). */
+        int numRepaintRequests;             /**< The number of times that repaint() was called. */
+        int numCacheHits;                   /**< The number of times its cached image was drawn without needing a paint. */
+        int numCacheMisses;                 /**< The number of times its cached image had to call paint(). */
+
+        double totalPaintMs;                /**< The total time spent in paint(). */
+        double worstPaintMs;                /**< The longest single call to paint(). */
+        double totalPaintOverChildrenMs;    /**< The total time spent in paintOverChildren(). */
+        double totalResizedMs;              /**< The total time spent in resized(). */
+        double constructionMs;              /**< The time taken by its constructor, if that was measured. */
+        double timeToFirstPaintMs;          /**< The time from its construction (or the first measured call, if its
+                                                 construction wasn't measured) until its first paint() finished. */
+
+        /** Returns the total time spent in all the measured methods. */
+        double getTotalTimeMs() const noexcept;
+
+        /** Returns the mean time taken by paint(). */
+        double getAveragePaintMs() const noexcept;
+
+        /** Returns the proportion (0 to 1) of cached-image draws that didn't need a paint. */
+        double getCacheHitRate() const noexcept;
+    };
+
+    /** Returns the statistics for all the components that have been measured, with the
+        most expensive ones first.
+    */
+    Array<Statistics> getStatistics() const;
+
+    /** Clears all the statistics and recorded calls. */
+    void reset();
+
+    //==============================================================================
+    /** Sets the maximum number of individual calls that will be kept for exporting as a trace.
+        Once this many have been recorded, further calls are still added to the statistics
+        but no longer recorded. The default is 100000.
+    */
+    void setMaxTraceEvents (int maxNumEvents);
+
+    /** Returns the recorded calls in the Chrome trace-event JSON format. */
+    String getChromeTraceJSON() const;
+
+    /** Writes the recorded calls to a file in the Chrome trace-event JSON format.
+        Returns false if the file couldn't be written.
+    */
+    bool writeChromeTrace (const File& file) const;
+
+    //==============================================================================
+    /** The kinds of call that are measured. */
+    enum CallType
+    {
+        paintCall = 0,
+        paintOverChildrenCall,
+        resizedCall,
+        constructorCall
+    };
+
+    /** Times a call to one of a component's methods, if the profiler is enabled.
+        The Component class uses this internally, but you can also use it to measure other
+        expensive methods of your own components.
+    */
+    class JUCE_API  ScopedTiming
+    {
+    public:
+        ScopedTiming (const Component& component, CallType type) noexcept
+            : comp (enabled ? &component : nullptr), callType (type),
+              startTicks (enabled ? Time::getHighResolutionTicks() : 0)
+        {
+        }
+
+        ~ScopedTiming()
+        {
+            if (comp != nullptr)
+                getInstance().addCall (*comp, callType, startTicks, Time::getHighResolutionTicks());
+        }
+
+    private:
+        const Component* const comp;
+        const CallType callType;
+        const int64 startTicks;
+
+        JUCE_DECLARE_NON_COPYABLE (ScopedTiming)
+    };
+
+    /** Records the construction of a component, given the time at which its constructor
+        was called (as returned by Time::getHighResolutionTicks()).
+
+        This must be called after the constructor has returned, so that the component's real
+        class can be found. AudioProcessor calls it for the editors that it creates.
+    */
+    static void componentCreated (const Component& component, int64 constructionStartTicks)
+    {
+        if (enabled)
+            getInstance().addCall (component, constructorCall, constructionStartTicks, Time::getHighResolutionTicks());
+    }
+
+    /** Counts a call to repaint(). Called internally by Component. */
+    static void repaintRequested (const Component& component)
+    {
+        if (enabled)
+            getInstance().getEntryFor (component).stats.numRepaintRequests++;
+    }
+
+    /** Counts a draw of a component's CachedComponentImage. Called internally by the
+        standard cached image types.
+    */
+    static void cachedImageDrawn (const Component& component, bool neededRepaint)
+    {
+        if (enabled)
+        {
+            Statistics& stats = getInstance().getEntryFor (component).stats;
+
+            if (neededRepaint)
+                stats.numCacheMisses++;
+            else
+                stats.numCacheHits++;
+        }
+    }
+
+    //==============================================================================
+    /**
+        A component that shows the profiler's statistics, updated a few times a second.
+
+        Add one of these on top of the other content in a window, and it'll list the
+        components that are taking the most time, along with the frame statistics of the
+        window's PaintScheduler. It ignores mouse-clicks, and enables the profiler when
+        it's created.
+    */
+    class JUCE_API  OverlayComponent  : public Component,
+                                        private Timer
+    {
+    public:
+        /** Creates an overlay that lists up to the given number of components. */
+        OverlayComponent (int maxNumComponentsToShow = 12);
+
+        /** Destructor. */
+        ~OverlayComponent();
+
+        /** @internal */
+        void paint (Graphics&);
+        /** @internal */
+        void parentSizeChanged();
+        /** @internal */
+        void parentHierarchyChanged();
+
+    private:
+        const int maxNumToShow;
+        void timerCallback();
+        void updateBounds();
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (OverlayComponent)
+    };
+
+private:
+    //==============================================================================
+    struct Entry
+    {
+        Entry (const Component&);
+
+        WeakReference<Component> component;
+        Statistics stats;
+        int64 firstSeenTicks;
+    };
+
+    struct TraceEvent
+    {
+        int entryIndex;
+        CallType type;
+        int64 startTicks, endTicks;
+    };
+
+    OwnedArray<Entry> entries;
+    HashMap<int64, int> entryIndexes;
+    Array<TraceEvent> traceEvents;
+    int maxTraceEvents;
+    int64 startTicks;
+
+    static bool enabled;
+    static ComponentProfiler* instance;
+
+    ComponentProfiler();
+    ~ComponentProfiler();
+
+    Entry& getEntryFor (const Component&);
+    int getEntryIndex (const Component&);
+    void addCall (const Component&, CallType, int64 start, int64 end);
+
+    JUCE_DECLARE_NON_COPYABLE (ComponentProfiler)
+};
+
+
+#endif   // __JUCE_COMPONENTPROFILER_JUCEHEADER__
@@ -31,6 +31,9 @@ Drawable::Drawable()
 Drawable::Drawable (const Drawable& other)
     : Component (other.getName())
 {
+    setInterceptsMouseClicks (false, false);
+    setPaintingIsUnclipped (true);
+
     setComponentID (other.getComponentID());
 }
 
@@ -122,6 +125,7 @@ void Drawable::setTransformToFit (const Rectangle<float>& area, const RectangleP
 //==============================================================================
 Drawable* Drawable::createFromImageData (const void* data, const size_t numBytes)
 {
+    JUCE_TRACE_SCOPE ("Drawable parse");
     Drawable* result = nullptr;
 
     Image image (ImageFileFormat::loadFrom (data, numBytes));
@@ -0,0 +1,251 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+class DrawableCache::Pimpl     : private Timer,
+                                 private DeletedAtShutdown
+{
+public:
+    Pimpl()  : cacheTimeout (5000)
+    {
+    }
+
+    ~Pimpl()
+    {
+        clearSingletonInstance();
+    }
+
+    Drawable* getFromHashCode (const int64 hashCode)
+    {
+        const ScopedLock sl (lock);
+
+        for (int i = items.size(); --i >= 0;)
+        {
+            Item* const item = items.getUnchecked(i);
+
+            if (item->hashCode == hashCode)
+            {
+                item->lastUseTime = Time::getApproximateMillisecondCounter();
+                return item->drawable->createCopy();
+            }
+        }
+
+        return nullptr;
+    }
+
+    /* Returns a copy of the cached drawable if there is one. If not, it returns nullptr,
+       and the caller must create the drawable and pass it to finishedCreating(). If another
+       thread is already creating a drawable with this hash, this waits for it to finish.
+    */
+    Drawable* findOrBeginCreating (const int64 hashCode)
+    {
+        for (;;)
+        {
+            PendingDrawable::Ptr other;
+
+            {
+                const ScopedLock sl (lock);
+
+                if (Drawable* const d = getFromHashCode (hashCode))
+                    return d;
+
+                for (int i = pendingDrawables.size(); --i >= 0;)
+                    if (pendingDrawables.getUnchecked(i)->hashCode == hashCode)
+                        other = pendingDrawables.getUnchecked(i);
+
+                if (other == nullptr)
+                {
+                    pendingDrawables.add (new PendingDrawable (hashCode));
+                    return nullptr;
+                }
+            }
+
+            other->finished.wait();
+        }
+    }
+
+    void finishedCreating (const int64 hashCode, const Drawable* const drawable)
+    {
+        if (drawable != nullptr)
+            addDrawableToCache (drawable->createCopy(), hashCode);
+
+        PendingDrawable::Ptr pending;
+
+        {
+            const ScopedLock sl (lock);
+
+            for (int i = pendingDrawables.size(); --i >= 0;)
+                if (pendingDrawables.getUnchecked(i)->hashCode == hashCode)
+                    pending = pendingDrawables.removeAndReturn (i);
+        }
+
+        if (pending != nullptr)
+            pending->finished.signal();
+    }
+
+    void addDrawableToCache (Drawable* const drawable, const int64 hashCode)
+    {
+        jassert (drawable != nullptr);
+
+        if (! isTimerRunning())
+            startTimer (2000);
+
+        Item* const item = new Item();
+        item->hashCode = hashCode;
+        item->drawable = drawable;
+        item->lastUseTime = Time::getApproximateMillisecondCounter();
+
+        const ScopedLock sl (lock);
+
+        for (int i = items.size(); --i >= 0;)
+            if (items.getUnchecked(i)->hashCode == hashCode)
+                items.remove (i);
+
+        items.add (item);
+    }
+
+    void timerCallback()
+    {
+        const uint32 now = Time::getApproximateMillisecondCounter();
+
+        const ScopedLock sl (lock);
+
+        for (int i = items.size(); --i >= 0;)
+        {
+            const Item* const item = items.getUnchecked(i);
+
+            if (now > item->lastUseTime + cacheTimeout || now < item->lastUseTime - 1000)
+                items.remove (i);
+        }
+
+        if (items.size() == 0)
+            stopTimer();
+    }
+
+    void releaseAll()
+    {
+        const ScopedLock sl (lock);
+        items.clear();
+    }
+
+    unsigned int cacheTimeout;
+
+    juce_DeclareSingleton (DrawableCache::Pimpl, false);
+
+private:
+    struct Item
+    {
+        ScopedPointer<Drawable> drawable;
+        int64 hashCode;
+        uint32 lastUseTime;
+    };
+
+    struct PendingDrawable  : public ReferenceCountedObject
+    {
+        PendingDrawable (const int64 hash)  : hashCode (hash), finished (true) {}
+
+        typedef ReferenceCountedObjectPtr<PendingDrawable> Ptr;
+
+        const int64 hashCode;
+        WaitableEvent finished;
+    };
+
+    OwnedArray<Item> items;
+    ReferenceCountedArray<PendingDrawable> pendingDrawables;
+    CriticalSection lock;
+
+    JUCE_DECLARE_NON_COPYABLE (Pimpl)
+};
+
+juce_ImplementSingleton (DrawableCache::Pimpl);
+
+
+//==============================================================================
+int64 DrawableCache::getHashCodeForData (const void* const data, const size_t numBytes) noexcept
+{
+    // 64-bit FNV-1a
+    uint64 hash = (uint64) 0xcbf29ce484222325LL;
+
+    for (const uint8* d = static_cast <const uint8*> (data), * const end = d + numBytes; d < end; ++d)
+        hash = (hash ^ *d) * (uint64) 0x100000001b3LL;
+
+    return (int64) hash;
+}
+
+Drawable* DrawableCache::getFromHashCode (const int64 hashCode)
+{
+    if (Pimpl::getInstanceWithoutCreating() != nullptr)
+        return Pimpl::getInstanceWithoutCreating()->getFromHashCode (hashCode);
+
+    return nullptr;
+}
+
+void DrawableCache::addDrawableToCache (const Drawable& drawable, const int64 hashCode)
+{
+    Pimpl::getInstance()->addDrawableToCache (drawable.createCopy(), hashCode);
+}
+
+Drawable* DrawableCache::getFromFile (const File& file)
+{
+    const int64 hashCode = file.hashCode64()
+                            ^ (file.getLastModificationTime().toMilliseconds() * 31)
+                            ^ (file.getSize() << 32);
+
+    Pimpl* const pimpl = Pimpl::getInstance();
+    Drawable* d = pimpl->findOrBeginCreating (hashCode);
+
+    if (d == nullptr)
+    {
+        d = Drawable::createFromImageFile (file);
+        pimpl->finishedCreating (hashCode, d);
+    }
+
+    return d;
+}
+
+Drawable* DrawableCache::getFromMemory (const void* const data, const size_t numBytes)
+{
+    const int64 hashCode = getHashCodeForData (data, numBytes);
+    Pimpl* const pimpl = Pimpl::getInstance();
+    Drawable* d = pimpl->findOrBeginCreating (hashCode);
+
+    if (d == nullptr)
+    {
+        d = Drawable::createFromImageData (data, numBytes);
+        pimpl->finishedCreating (hashCode, d);
+    }
+
+    return d;
+}
+
+void DrawableCache::setCacheTimeout (const int millisecs)
+{
+    jassert (millisecs >= 0);
+    Pimpl::getInstance()->cacheTimeout = (unsigned int) millisecs;
+}
+
+void DrawableCache::releaseAllDrawables()
+{
+    if (Pimpl::getInstanceWithoutCreating() != nullptr)
+        Pimpl::getInstanceWithoutCreating()->releaseAll();
+}
@@ -0,0 +1,120 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_DRAWABLECACHE_JUCEHEADER__
+#define __JUCE_DRAWABLECACHE_JUCEHEADER__
+
+#include "juce_Drawable.h"
+
+
+//==============================================================================
+/**
+    A global cache of Drawables that have been parsed from files or memory.
+
+    Parsing an SVG document means building an XML tree, and then converting it into
+    a tree of paths and fills, which is slow compared to copying the result. If the
+    same drawable is loaded in several places (or loaded again a short while after
+    being deleted), this keeps the parsed tree around so that each request just
+    needs a copy of it.
+
+    Unlike ImageCache, the objects returned are new copies which the caller owns
+    and must delete, so they can be modified without affecting each other. Cached
+    entries are released when they've not been asked for within the cache timeout.
+
+    The cache can be used from any thread, and if a drawable is requested while another
+    thread is already parsing the same one, the request waits for that result instead of
+    parsing it again. An AssetPreloader uses this to parse drawables in the background.
+
+    @see Drawable::createFromImageData, ImageCache, AssetPreloader
+*/
+class JUCE_API  DrawableCache
+{
+public:
+    //==============================================================================
+    /** Loads a drawable from a file, (or just copies the drawable if it's already cached).
+
+        The cache entry is keyed by the file's path, size and modification time, so
+        if the file is changed, it'll be re-parsed.
+
+        @param file     the file to try to load
+        @returns        a new Drawable for the caller to delete, or nullptr if the file
+                        couldn't be loaded
+        @see Drawable::createFromImageFile
+    */
+    static Drawable* getFromFile (const File& file);
+
+    /** Loads a drawable from an in-memory image or SVG file, (or just copies the drawable
+        if it's already cached).
+
+        The cache entry is keyed by a hash of the data's contents, so identical data
+        at different addresses will share the same entry.
+
+        @param data         the block of data to use as the source
+        @param numBytes     the number of bytes in the data block
+        @returns            a new Drawable for the caller to delete, or nullptr if the data
+                            couldn't be parsed
+        @see Drawable::createFromImageData
+    */
+    static Drawable* getFromMemory (const void* data, size_t numBytes);
+
+    //==============================================================================
+    /** Returns a copy of the drawable that was cached with a particular hashcode.
+
+        @returns a new Drawable for the caller to delete, or nullptr if there's nothing
+                 in the cache with this hash
+        @see addDrawableToCache
+    */
+    static Drawable* getFromHashCode (int64 hashCode);
+
+    /** Adds a copy of a drawable to the cache with a user-defined hash-code.
+
+        Any existing entry with the same hash-code is replaced.
+        @see getFromHashCode
+    */
+    static void addDrawableToCache (const Drawable& drawable, int64 hashCode);
+
+    /** Calculates the hash-code that getFromMemory() uses for a block of data. */
+    static int64 getHashCodeForData (const void* data, size_t numBytes) noexcept;
+
+    /** Changes the amount of time before an unrequested drawable will be removed from the cache.
+        By default this is about 5 seconds.
+    */
+    static void setCacheTimeout (int millisecs);
+
+    /** Removes everything from the cache. */
+    static void releaseAllDrawables();
+
+private:
+    //==============================================================================
+    class Pimpl;
+    friend class Pimpl;
+
+    DrawableCache();
+    ~DrawableCache();
+
+    JUCE_DECLARE_NON_COPYABLE (DrawableCache)
+};
+
+
+#endif   // __JUCE_DRAWABLECACHE_JUCEHEADER__
@@ -34,7 +34,6 @@ DrawableComposite::DrawableComposite()
 
 DrawableComposite::DrawableComposite (const DrawableComposite& other)
     : Drawable (other),
-      bounds (other.bounds),
       markersX (other.markersX),
       markersY (other.markersY),
       updateBoundsReentrant (false)
@@ -46,6 +45,9 @@ DrawableComposite::DrawableComposite (const DrawableComposite& other)
         if (d != nullptr)
             addAndMakeVisible (d->createCopy());
     }
+
+    // (this has to go through setBoundingBox() so that the transform or positioner gets set up)
+    setBoundingBox (other.bounds);
 }
 
 DrawableComposite::~DrawableComposite()
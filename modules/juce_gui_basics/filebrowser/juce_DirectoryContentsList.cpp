@@ -22,12 +22,101 @@
   ==============================================================================
 */
 
+//==============================================================================
+// The unfiltered results of a complete scan, which can be replayed instead of reading
+// the directory again for as long as its modification time stays the same.
+class DirectoryContentsList::CachedListing  : public ReferenceCountedObject
+{
+public:
+    CachedListing (const File& dir, const int flags, const Time modTime)
+        : directory (dir), typeFlags (flags), directoryModTime (modTime),
+          scanStartTime (Time::getCurrentTime())
+    {
+    }
+
+    typedef ReferenceCountedObjectPtr<CachedListing> Ptr;
+
+    const File directory;
+    const int typeFlags;
+    const Time directoryModTime, scanStartTime;
+    Array<FileInfo> files;
+
+    //==============================================================================
+    static Ptr find (const File& dir, const int flags, const Time modTime)
+    {
+        Cache& cache = getCache();
+        const ScopedLock sl (cache.lock);
+
+        for (int i = cache.listings.size(); --i >= 0;)
+        {
+            CachedListing* const l = cache.listings.getUnchecked (i);
+
+            if (l->directory == dir && l->typeFlags == flags)
+            {
+                if (l->directoryModTime != modTime)
+                {
+                    cache.listings.remove (i);
+                    return nullptr;
+                }
+
+                cache.listings.move (i, -1);
+                return l;
+            }
+        }
+
+        return nullptr;
+    }
+
+    static void add (CachedListing* const listing)
+    {
+        // if the directory was modified just before we started, a change made in the same
+        // second afterwards wouldn't show up in its modification time, so don't trust it..
+        if (listing->directoryModTime > listing->scanStartTime - RelativeTime (2.0))
+            return;
+
+        Cache& cache = getCache();
+        const ScopedLock sl (cache.lock);
+
+        for (int i = cache.listings.size(); --i >= 0;)
+        {
+            const CachedListing* const l = cache.listings.getUnchecked (i);
+
+            if (l->directory == listing->directory && l->typeFlags == listing->typeFlags)
+                cache.listings.remove (i);
+        }
+
+        cache.listings.add (listing);
+
+        while (cache.listings.size() > maxCachedListings)
+            cache.listings.remove (0);
+    }
+
+private:
+    enum { maxCachedListings = 16 };
+
+    struct Cache
+    {
+        CriticalSection lock;
+        ReferenceCountedArray<CachedListing> listings;
+    };
+
+    static Cache& getCache()
+    {
+        static Cache cache;
+        return cache;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (CachedListing)
+};
+
+//==============================================================================
 DirectoryContentsList::DirectoryContentsList (const FileFilter* const fileFilter_,
                                               TimeSliceThread& thread_)
    : fileFilter (fileFilter_),
      thread (thread_),
      fileTypeFlags (File::ignoreHiddenFiles | File::findFiles),
-     shouldStop (true)
+     shouldStop (true),
+     nextCachedFile (0)
 {
 }
 
@@ -80,7 +169,8 @@ void DirectoryContentsList::setTypeFlags (const int newFlags)
     if (fileTypeFlags != newFlags)
     {
         fileTypeFlags = newFlags;
-        refresh();
+        clear();
+        startSearching (true);
     }
 }
 
@@ -89,6 +179,9 @@ void DirectoryContentsList::stopSearching()
     shouldStop = true;
     thread.removeTimeSliceClient (this);
     fileFindHandle = nullptr;
+    cachedListing = nullptr;
+    newListing = nullptr;
+    pendingFiles.clear();
 }
 
 void DirectoryContentsList::clear()
@@ -105,10 +198,28 @@ void DirectoryContentsList::clear()
 void DirectoryContentsList::refresh()
 {
     clear();
+    startSearching (false);
+}
 
+void DirectoryContentsList::startSearching (const bool allowCachedListing)
+{
     if (root.isDirectory())
     {
-        fileFindHandle = new DirectoryIterator (root, false, "*", fileTypeFlags);
+        const Time modTime (root.getLastModificationTime());
+
+        if (allowCachedListing)
+            cachedListing = CachedListing::find (root, fileTypeFlags, modTime);
+
+        if (cachedListing != nullptr)
+        {
+            nextCachedFile = 0;
+        }
+        else
+        {
+            newListing = new CachedListing (root, fileTypeFlags, modTime);
+            fileFindHandle = new DirectoryIterator (root, false, "*", fileTypeFlags);
+        }
+
         shouldStop = false;
         thread.addTimeSliceClient (this);
     }
@@ -157,7 +268,7 @@ bool DirectoryContentsList::contains (const File& targetFile) const
 
 bool DirectoryContentsList::isStillLoading() const
 {
-    return fileFindHandle != nullptr;
+    return fileFindHandle != nullptr || cachedListing != nullptr;
 }
 
 void DirectoryContentsList::changed()
@@ -169,15 +280,12 @@ void DirectoryContentsList::changed()
 int DirectoryContentsList::useTimeSlice()
 {
     const uint32 startTime = Time::getApproximateMillisecondCounter();
-    bool hasChanged = false;
 
-    for (int i = 100; --i >= 0;)
+    for (;;)
     {
-        if (! checkNextFile (hasChanged))
+        if (! checkNextFile())
         {
-            if (hasChanged)
-                changed();
-
+            addPendingFiles();
             return 500;
         }
 
@@ -185,33 +293,45 @@ int DirectoryContentsList::useTimeSlice()
             break;
     }
 
-    if (hasChanged)
-        changed();
-
+    addPendingFiles();
     return 0;
 }
 
-bool DirectoryContentsList::checkNextFile (bool& hasChanged)
+bool DirectoryContentsList::checkNextFile()
 {
-    if (fileFindHandle != nullptr)
+    if (cachedListing != nullptr)
     {
-        bool fileFoundIsDir, isHidden, isReadOnly;
-        int64 fileSize;
-        Time modTime, creationTime;
+        if (nextCachedFile < cachedListing->files.size())
+        {
+            const FileInfo& info = cachedListing->files.getReference (nextCachedFile++);
+            addFile (root.getChildFile (info.filename), info);
+            return true;
+        }
 
-        if (fileFindHandle->next (&fileFoundIsDir, &isHidden, &fileSize,
-                                  &modTime, &creationTime, &isReadOnly))
+        cachedListing = nullptr;
+    }
+    else if (fileFindHandle != nullptr)
+    {
+        FileInfo info;
+        bool isHidden;
+
+        if (fileFindHandle->next (&info.isDirectory, &isHidden, &info.fileSize,
+                                  &info.modificationTime, &info.creationTime, &info.isReadOnly))
         {
-            if (addFile (fileFindHandle->getFile(), fileFoundIsDir,
-                         fileSize, modTime, creationTime, isReadOnly))
-            {
-                hasChanged = true;
-            }
+            const File& file = fileFindHandle->getFile();
+            info.filename = file.getFileName();
 
+            newListing->files.add (info);
+            addFile (file, info);
             return true;
         }
 
         fileFindHandle = nullptr;
+
+        if (! shouldStop)
+            CachedListing::add (newListing);
+
+        newListing = nullptr;
     }
 
     return false;
@@ -228,35 +348,64 @@ int DirectoryContentsList::compareElements (const DirectoryContentsList::FileInf
     return first->filename.compareIgnoreCase (second->filename);
 }
 
-bool DirectoryContentsList::addFile (const File& file,
-                                     const bool isDir,
-                                     const int64 fileSize,
-                                     const Time modTime,
-                                     const Time creationTime,
-                                     const bool isReadOnly)
+void DirectoryContentsList::addFile (const File& file, const FileInfo& info)
 {
     if (fileFilter == nullptr
-         || ((! isDir) && fileFilter->isFileSuitable (file))
-         || (isDir && fileFilter->isDirectorySuitable (file)))
+         || ((! info.isDirectory) && fileFilter->isFileSuitable (file))
+         || (info.isDirectory && fileFilter->isDirectorySuitable (file)))
     {
-        ScopedPointer <FileInfo> info (new FileInfo());
+        pendingFiles.add (new FileInfo (info));
+    }
+}
+
+void DirectoryContentsList::addPendingFiles()
+{
+    if (pendingFiles.size() == 0)
+        return;
 
-        info->filename = file.getFileName();
-        info->fileSize = fileSize;
-        info->modificationTime = modTime;
-        info->creationTime = creationTime;
-        info->isDirectory = isDir;
-        info->isReadOnly = isReadOnly;
+    pendingFiles.sort (*this);
 
+    {
         const ScopedLock sl (fileListLock);
 
-        for (int i = files.size(); --i >= 0;)
-            if (files.getUnchecked(i)->filename == info->filename)
-                return false;
+        // merge the sorted batch into the list in one pass, skipping any names that are
+        // already in there (which will be next to them, as they compare as equal)..
+        OwnedArray<FileInfo> merged;
+        merged.ensureStorageAllocated (files.size() + pendingFiles.size());
 
-        files.addSorted (*this, info.release());
-        return true;
+        int i = 0;
+
+        for (int j = 0; j < pendingFiles.size(); ++j)
+        {
+            FileInfo* const info = pendingFiles.getUnchecked (j);
+
+            while (i < files.size() && compareElements (files.getUnchecked (i), info) <= 0)
+                merged.add (files.getUnchecked (i++));
+
+            bool isDuplicate = false;
+
+            for (int k = merged.size(); --k >= 0 && compareElements (merged.getUnchecked (k), info) == 0;)
+            {
+                if (merged.getUnchecked (k)->filename == info->filename)
+                {
+                    isDuplicate = true;
+                    break;
+                }
+            }
+
+            if (isDuplicate)
+                delete info;
+            else
+                merged.add (info);
+        }
+
+        while (i < files.size())
+            merged.add (files.getUnchecked (i++));
+
+        files.clear (false);
+        pendingFiles.clear (false);
+        files.swapWithArray (merged);
     }
 
-    return false;
+    changed();
 }
@@ -36,6 +36,11 @@
     thread to scan for more files. As files are found, it broadcasts change messages
     to tell any listeners.
 
+    The files are added in batches, with one change message for each time-slice of
+    scanning rather than one for every file. The results of each complete scan are also
+    kept in a small shared cache, so that going back to a directory whose modification
+    time hasn't changed since it was last scanned won't have to read it again.
+
     @see FileListComponent, FileBrowserComponent
 */
 class JUCE_API  DirectoryContentsList   : public ChangeBroadcaster,
@@ -73,7 +78,8 @@ public:
     /** Sets the directory to look in for files.
 
         If the directory that's passed in is different to the current one, this will
-        also start the background thread scanning it for files.
+        also start the background thread scanning it for files. If the same directory has
+        been scanned recently and hasn't been modified since, the cached listing is used.
     */
     void setDirectory (const File& directory,
                        bool includeDirectories,
@@ -85,7 +91,11 @@ public:
     /** Clears the list, and stops the thread scanning for files. */
     void clear();
 
-    /** Clears the list and restarts scanning the directory for files. */
+    /** Clears the list and restarts scanning the directory for files.
+
+        This always re-reads the directory, even if a cached listing for it exists, so it
+        will also pick up changes to the sizes or times of the files it contains.
+    */
     void refresh();
 
     /** True if the background thread hasn't yet finished scanning for files. */
@@ -198,15 +208,20 @@ private:
     OwnedArray <FileInfo> files;
 
     ScopedPointer <DirectoryIterator> fileFindHandle;
+    OwnedArray <FileInfo> pendingFiles;
     bool volatile shouldStop;
 
+    class CachedListing;
+    ReferenceCountedObjectPtr<CachedListing> cachedListing, newListing;
+    int nextCachedFile;
+
     int useTimeSlice();
+    void startSearching (bool allowCachedListing);
     void stopSearching();
     void changed();
-    bool checkNextFile (bool& hasChanged);
-    bool addFile (const File& file, bool isDir,
-                  const int64 fileSize, const Time modTime,
-                  const Time creationTime, bool isReadOnly);
+    bool checkNextFile();
+    void addFile (const File& file, const FileInfo& info);
+    void addPendingFiles();
     void setTypeFlags (int newFlags);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DirectoryContentsList)
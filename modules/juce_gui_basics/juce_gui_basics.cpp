@@ -141,6 +141,7 @@ namespace juce
 // windows/*.cpp, commands/*.cpp, application/*.cpp, misc/*.cpp
 #include "components/juce_Component.cpp"
 #include "components/juce_ComponentListener.cpp"
+#include "components/juce_ComponentProfiler.cpp"
 #include "components/juce_Desktop.cpp"
 #include "components/juce_ModalComponentManager.cpp"
 #include "mouse/juce_ComponentDragger.cpp"
@@ -164,6 +165,7 @@ namespace juce
 #include "buttons/juce_ToggleButton.cpp"
 #include "buttons/juce_ToolbarButton.cpp"
 #include "drawables/juce_Drawable.cpp"
+#include "drawables/juce_DrawableCache.cpp"
 #include "drawables/juce_DrawableComposite.cpp"
 #include "drawables/juce_DrawableImage.cpp"
 #include "drawables/juce_DrawablePath.cpp"
@@ -226,6 +228,7 @@ namespace juce
 #include "widgets/juce_Slider.cpp"
 #include "widgets/juce_TableHeaderComponent.cpp"
 #include "widgets/juce_TableListBox.cpp"
+#include "widgets/juce_TableRowSorter.cpp"
 #include "widgets/juce_TextEditor.cpp"
 #include "widgets/juce_Toolbar.cpp"
 #include "widgets/juce_ToolbarItemComponent.cpp"
@@ -236,6 +239,7 @@ namespace juce
 #include "windows/juce_ComponentPeer.cpp"
 #include "windows/juce_DialogWindow.cpp"
 #include "windows/juce_DocumentWindow.cpp"
+#include "windows/juce_PaintScheduler.cpp"
 #include "windows/juce_ResizableWindow.cpp"
 #include "windows/juce_ThreadWithProgressWindow.cpp"
 #include "windows/juce_TooltipWindow.cpp"
@@ -245,6 +249,7 @@ namespace juce
 #include "commands/juce_ApplicationCommandTarget.cpp"
 #include "commands/juce_KeyPressMappingSet.cpp"
 #include "application/juce_Application.cpp"
+#include "misc/juce_AssetPreloader.cpp"
 #include "misc/juce_BubbleComponent.cpp"
 #include "misc/juce_DropShadower.cpp"
 // END_AUTOINCLUDE
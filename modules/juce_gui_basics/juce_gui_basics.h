@@ -84,6 +84,9 @@ namespace juce
 #ifndef __JUCE_COMPONENTLISTENER_JUCEHEADER__
  #include "components/juce_ComponentListener.h"
 #endif
+#ifndef __JUCE_COMPONENTPROFILER_JUCEHEADER__
+ #include "components/juce_ComponentProfiler.h"
+#endif
 #ifndef __JUCE_DESKTOP_JUCEHEADER__
  #include "components/juce_Desktop.h"
 #endif
@@ -180,6 +183,9 @@ namespace juce
 #ifndef __JUCE_DRAWABLE_JUCEHEADER__
  #include "drawables/juce_Drawable.h"
 #endif
+#ifndef __JUCE_DRAWABLECACHE_JUCEHEADER__
+ #include "drawables/juce_DrawableCache.h"
+#endif
 #ifndef __JUCE_DRAWABLECOMPOSITE_JUCEHEADER__
  #include "drawables/juce_DrawableComposite.h"
 #endif
@@ -369,6 +375,9 @@ namespace juce
 #ifndef __JUCE_TABLELISTBOX_JUCEHEADER__
  #include "widgets/juce_TableListBox.h"
 #endif
+#ifndef __JUCE_TABLEROWSORTER_JUCEHEADER__
+ #include "widgets/juce_TableRowSorter.h"
+#endif
 #ifndef __JUCE_TEXTEDITOR_JUCEHEADER__
  #include "widgets/juce_TextEditor.h"
 #endif
@@ -405,6 +414,9 @@ namespace juce
 #ifndef __JUCE_NATIVEMESSAGEBOX_JUCEHEADER__
  #include "windows/juce_NativeMessageBox.h"
 #endif
+#ifndef __JUCE_PAINTSCHEDULER_JUCEHEADER__
+ #include "windows/juce_PaintScheduler.h"
+#endif
 #ifndef __JUCE_RESIZABLEWINDOW_JUCEHEADER__
  #include "windows/juce_ResizableWindow.h"
 #endif
@@ -438,6 +450,9 @@ namespace juce
 #ifndef __JUCE_INITIALISATION_JUCEHEADER__
  #include "application/juce_Initialisation.h"
 #endif
+#ifndef __JUCE_ASSETPRELOADER_JUCEHEADER__
+ #include "misc/juce_AssetPreloader.h"
+#endif
 #ifndef __JUCE_BUBBLECOMPONENT_JUCEHEADER__
  #include "misc/juce_BubbleComponent.h"
 #endif
@@ -26,15 +26,21 @@ class ComponentAnimator::AnimationTask
 {
 public:
     AnimationTask (Component* const comp)
-        : component (comp)
+        : component (comp), cachedImage (nullptr)
     {
     }
 
+    ~AnimationTask()
+    {
+        setCachingImage (false);
+    }
+
     void reset (const Rectangle<int>& finalBounds,
                 float finalAlpha,
                 int millisecondsToSpendMoving,
                 bool useProxyComponent,
-                double startSpeed_, double endSpeed_)
+                double startSpeed_, double endSpeed_,
+                bool cacheImageWhileMoving)
     {
         msElapsed = 0;
         msTotal = jmax (1, millisecondsToSpendMoving);
@@ -61,13 +67,41 @@ public:
         else
             proxy = nullptr;
 
+        // (a component that's only moving can be drawn from a cached image, but one that's
+        // changing size would need to be repainted anyway)
+        setCachingImage (cacheImageWhileMoving && isMoving && ! useProxyComponent
+                          && finalBounds.getWidth()  == component->getWidth()
+                          && finalBounds.getHeight() == component->getHeight());
+
         component->setVisible (! useProxyComponent);
     }
 
     bool useTimeslice (const int elapsed)
     {
-        if (Component* const c = proxy != nullptr ? static_cast <Component*> (proxy)
-                                                  : static_cast <Component*> (component))
+        if (calculateTimeslice (elapsed))
+        {
+            applyTimeslice();
+            return true;
+        }
+
+        moveToFinalDestination();
+        return false;
+    }
+
+    Component* getTarget() const noexcept
+    {
+        return proxy != nullptr ? static_cast <Component*> (proxy)
+                                : static_cast <Component*> (component);
+    }
+
+    // Works out the component's next position and alpha without applying them, returning
+    // false if the animation has finished.
+    bool calculateTimeslice (const int elapsed)
+    {
+        hasNewBounds = false;
+        hasNewAlpha = false;
+
+        if (getTarget() != nullptr)
         {
             msElapsed += elapsed;
             double newProgress = msElapsed / (double) msTotal;
@@ -81,8 +115,6 @@ public:
 
                 if (delta < 1.0)
                 {
-                    bool stillBusy = false;
-
                     if (isMoving)
                     {
                         left   += (destination.getX()      - left)   * delta;
@@ -90,35 +122,40 @@ public:
                         right  += (destination.getRight()  - right)  * delta;
                         bottom += (destination.getBottom() - bottom) * delta;
 
-                        const Rectangle<int> newBounds (roundToInt (left),
-                                                        roundToInt (top),
-                                                        roundToInt (right - left),
-                                                        roundToInt (bottom - top));
+                        newBounds = Rectangle<int> (roundToInt (left),
+                                                    roundToInt (top),
+                                                    roundToInt (right - left),
+                                                    roundToInt (bottom - top));
 
-                        if (newBounds != destination)
-                        {
-                            c->setBounds (newBounds);
-                            stillBusy = true;
-                        }
+                        hasNewBounds = (newBounds != destination);
                     }
 
                     if (isChangingAlpha)
                     {
                         alpha += (destAlpha - alpha) * delta;
-                        c->setAlpha ((float) alpha);
-                        stillBusy = true;
+                        hasNewAlpha = true;
                     }
 
-                    if (stillBusy)
-                        return true;
+                    return hasNewBounds || hasNewAlpha;
                 }
             }
         }
 
-        moveToFinalDestination();
         return false;
     }
 
+    void applyTimeslice()
+    {
+        if (Component* const c = getTarget())
+        {
+            if (hasNewBounds)
+                c->setBounds (newBounds);
+
+            if (hasNewAlpha)
+                c->setAlpha ((float) alpha);
+        }
+    }
+
     void moveToFinalDestination()
     {
         if (component != nullptr)
@@ -169,16 +206,39 @@ public:
 
     WeakReference<Component> component;
     ScopedPointer<Component> proxy;
+    CachedComponentImage* cachedImage;
 
-    Rectangle<int> destination;
+    Rectangle<int> destination, newBounds;
     double destAlpha;
 
     int msElapsed, msTotal;
     double startSpeed, midSpeed, endSpeed, lastProgress;
     double left, top, right, bottom, alpha;
-    bool isMoving, isChangingAlpha;
+    bool isMoving, isChangingAlpha, hasNewBounds, hasNewAlpha, isFinished;
 
 private:
+    void setCachingImage (const bool shouldCache)
+    {
+        Component* const c = component;
+
+        if (shouldCache)
+        {
+            if (cachedImage == nullptr && c != nullptr && c->getCachedComponentImage() == nullptr)
+            {
+                c->setBufferedToImage (true);
+                cachedImage = c->getCachedComponentImage();
+            }
+        }
+        else if (cachedImage != nullptr)
+        {
+            // (only remove the image if it's still the one that was added here)
+            if (c != nullptr && c->getCachedComponentImage() == cachedImage)
+                c->setBufferedToImage (false);
+
+            cachedImage = nullptr;
+        }
+    }
+
     double timeToDistance (const double time) const noexcept
     {
         return (time < 0.5) ? time * (startSpeed + time * (midSpeed - startSpeed))
@@ -189,7 +249,7 @@ private:
 
 //==============================================================================
 ComponentAnimator::ComponentAnimator()
-    : lastTime (0)
+    : lastTime (0), batchUpdates (false), framePeriodMs (1000.0 / 60.0)
 {
 }
 
@@ -230,12 +290,12 @@ void ComponentAnimator::animateComponent (Component* const component,
         }
 
         at->reset (finalBounds, finalAlpha, millisecondsToSpendMoving,
-                   useProxyComponent, startSpeed, endSpeed);
+                   useProxyComponent, startSpeed, endSpeed, batchUpdates);
 
         if (! isTimerRunning())
         {
             lastTime = Time::getMillisecondCounter();
-            startTimer (1000 / 50);
+            startTimerForNextUpdate();
         }
     }
 }
@@ -307,6 +367,79 @@ bool ComponentAnimator::isAnimating() const noexcept
     return tasks.size() != 0;
 }
 
+//==============================================================================
+void ComponentAnimator::setBatchedUpdates (const bool shouldBatchUpdates, const double framesPerSecond)
+{
+    jassert (framesPerSecond > 0);
+
+    batchUpdates = shouldBatchUpdates;
+    framePeriodMs = 1000.0 / jlimit (1.0, 1000.0, framesPerSecond);
+
+    if (isTimerRunning())
+        startTimerForNextUpdate();
+}
+
+void ComponentAnimator::startTimerForNextUpdate()
+{
+    if (batchUpdates)
+    {
+        // This uses the same clock as PaintScheduler, so that the updates happen in step
+        // with the windows' frames.
+        const double now = Time::getMillisecondCounterHiRes();
+        const double nextFrame = (std::floor (now / framePeriodMs) + 1.0) * framePeriodMs;
+
+        startTimer (jmax (1, roundToInt (nextFrame - now)));
+    }
+    else
+    {
+        startTimer (1000 / 50);
+    }
+}
+
+void ComponentAnimator::applyBatchedUpdates (const int elapsed)
+{
+    // Work out where everything is going before moving anything..
+    for (int i = tasks.size(); --i >= 0;)
+    {
+        AnimationTask* const at = tasks.getUnchecked(i);
+        at->isFinished = ! at->calculateTimeslice (elapsed);
+    }
+
+    // ..then apply all the changes in one go. (The components' callbacks could
+    // cancel some of the animations, so the array is re-checked on each iteration)
+    for (int i = tasks.size(); --i >= 0;)
+    {
+        if (AnimationTask* const at = tasks[i])
+        {
+            if (at->isFinished)
+                at->moveToFinalDestination();
+            else
+                at->applyTimeslice();
+        }
+    }
+
+    // Now the windows can paint the whole area that's changed as a single frame.
+    Array<ComponentPeer*> peers;
+
+    for (int i = tasks.size(); --i >= 0;)
+        if (Component* const c = tasks.getUnchecked(i)->getTarget())
+            if (ComponentPeer* const peer = c->getPeer())
+                peers.addIfNotAlreadyThere (peer);
+
+    for (int i = peers.size(); --i >= 0;)
+        if (PaintScheduler* const scheduler = peers.getUnchecked(i)->getPaintScheduler())
+            scheduler->flush();
+
+    for (int i = tasks.size(); --i >= 0;)
+    {
+        if (tasks.getUnchecked(i)->isFinished)
+        {
+            tasks.remove (i);
+            sendChangeMessage();
+        }
+    }
+}
+
 void ComponentAnimator::timerCallback()
 {
     const uint32 timeNow = Time::getMillisecondCounter();
@@ -316,12 +449,19 @@ void ComponentAnimator::timerCallback()
 
     const int elapsed = (int) (timeNow - lastTime);
 
-    for (int i = tasks.size(); --i >= 0;)
+    if (batchUpdates)
+    {
+        applyBatchedUpdates (elapsed);
+    }
+    else
     {
-        if (! tasks.getUnchecked(i)->useTimeslice (elapsed))
+        for (int i = tasks.size(); --i >= 0;)
         {
-            tasks.remove (i);
-            sendChangeMessage();
+            if (! tasks.getUnchecked(i)->useTimeslice (elapsed))
+            {
+                tasks.remove (i);
+                sendChangeMessage();
+            }
         }
     }
 
@@ -329,4 +469,6 @@ void ComponentAnimator::timerCallback()
 
     if (tasks.size() == 0)
         stopTimer();
+    else if (batchUpdates)
+        startTimerForNextUpdate();
 }
@@ -147,13 +147,44 @@ public:
     /** Returns true if any components are currently being animated. */
     bool isAnimating() const noexcept;
 
+    //==============================================================================
+    /** Turns batched, frame-synchronised updates on or off.
+
+        By default, the animator just moves each of its components in turn, 50 times a second.
+        When batching is enabled:
+        - The animator's updates are aligned to the same frame clock that the windows'
+          PaintSchedulers use, at the given frame rate.
+        - At each frame, the new positions and alpha levels of all the components are
+          worked out before any of them is changed. Then they're all applied in one pass,
+          and the windows' PaintSchedulers are flushed once. The whole area that changed
+          is therefore painted together in that frame.
+        - A component that's moving without changing size is buffered into a cached image
+          (see Component::setBufferedToImage) for the duration of its animation. Moving it
+          then just redraws the cached image, rather than calling its paint() method again.
+          If the window is being rendered with OpenGL, the image is drawn as a texture. This
+          isn't done for components which already have a CachedComponentImage.
+
+        This mode is a good choice when a large number of components are being animated at
+        the same time.
+    */
+    void setBatchedUpdates (bool shouldBatchUpdates, double framesPerSecond = 60.0);
+
+    /** Returns true if batched updates are enabled.
+        @see setBatchedUpdates
+    */
+    bool isBatchingUpdates() const noexcept                 { return batchUpdates; }
+
 private:
     //==============================================================================
     class AnimationTask;
     OwnedArray <AnimationTask> tasks;
     uint32 lastTime;
+    bool batchUpdates;
+    double framePeriodMs;
 
     AnimationTask* findTaskFor (Component* component) const noexcept;
+    void startTimerForNextUpdate();
+    void applyBatchedUpdates (int elapsed);
     void timerCallback();
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ComponentAnimator)
@@ -112,7 +112,17 @@ void Viewport::setViewPosition (const int xPixelsOffset, const int yPixelsOffset
 void Viewport::setViewPosition (Point<int> newPosition)
 {
     if (contentComp != nullptr)
-        contentComp->setTopLeftPosition (viewportPosToCompPos (newPosition));
+        moveContentComp (viewportPosToCompPos (newPosition));
+}
+
+void Viewport::moveContentComp (const Point<int>& newPos)
+{
+    // If possible, the pixels that are still visible are scrolled on-screen, so that only
+    // the newly-exposed strip needs to be painted..
+    ComponentPeer* const peer = getPeer();
+
+    if (peer == nullptr || ! peer->moveComponentByScrolling (*contentComp, newPos))
+        contentComp->setTopLeftPosition (newPos);
 }
 
 void Viewport::setViewPositionProportionately (const double x, const double y)
@@ -156,8 +166,7 @@ bool Viewport::autoScroll (const int mouseX, const int mouseY, const int activeB
 
         if (dx != 0 || dy != 0)
         {
-            contentComp->setTopLeftPosition (contentComp->getX() + dx,
-                                             contentComp->getY() + dy);
+            moveContentComp (contentComp->getPosition() + Point<int> (dx, dy));
 
             return true;
         }
@@ -40,6 +40,10 @@
     A subclass of the viewport can be created which will receive calls to its
     visibleAreaChanged() method when the subcomponent changes position or size.
 
+    If the viewed component is opaque, scrolling will move the pixels that are already
+    on-screen rather than repainting them, so only the newly-exposed strip has to be
+    painted (see ComponentPeer::moveComponentByScrolling). So if your content component
+    fills its background, it's worth calling setOpaque (true) on it.
 */
 class JUCE_API  Viewport  : public Component,
                             private ComponentListener,
@@ -260,6 +264,7 @@ private:
     ScrollBar verticalScrollBar;
     ScrollBar horizontalScrollBar;
     Point<int> viewportPosToCompPos (Point<int>) const;
+    void moveContentComp (const Point<int>&);
 
     void updateVisibleArea();
     void deleteContentComp();
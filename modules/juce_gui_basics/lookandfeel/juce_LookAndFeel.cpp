@@ -62,6 +62,282 @@ namespace LookAndFeelHelpers
 typedef Typeface::Ptr (*GetTypefaceForFont) (const Font&);
 extern GetTypefaceForFont juce_getTypefaceForFont;
 
+//==============================================================================
+class LookAndFeel::WidgetCache
+{
+public:
+    WidgetCache (const int maxImages)
+        : maxNumImages (jmax (1, maxImages)), useCounter (0)
+    {
+    }
+
+    enum LayerType
+    {
+        buttonBackgroundLayer = 1,
+        linearSliderTrackLayer,
+        rotarySliderOutlineLayer
+    };
+
+    //==============================================================================
+    /** Everything that affects the appearance of a cached layer. */
+    struct Key
+    {
+        Key (const LayerType layerType, const Rectangle<int>& area) noexcept
+            : numValues (0)
+        {
+            zerostruct (values);
+            add ((uint32) layerType).add ((uint32) area.getWidth()).add ((uint32) area.getHeight());
+        }
+
+        Key& add (const uint32 value) noexcept
+        {
+            jassert (numValues < numElementsInArray (values));
+            values [numValues++] = value;
+            return *this;
+        }
+
+        Key& add (const float value) noexcept
+        {
+            union { float asFloat; uint32 asInt; } u;
+            u.asFloat = value;
+            return add (u.asInt);
+        }
+
+        Key& add (const Colour& colour) noexcept    { return add (colour.getARGB()); }
+
+        int64 getHash() const noexcept              { return (int64) XXHash64::hash (values, sizeof (uint32) * (size_t) numValues); }
+
+        bool operator== (const Key& other) const noexcept
+        {
+            return numValues == other.numValues
+                    && memcmp (values, other.values, sizeof (values)) == 0;
+        }
+
+        uint32 values [12];
+        int numValues;
+    };
+
+    //==============================================================================
+    /** Paints one cacheable layer, with the top-left of its area at the origin. */
+    struct Layer
+    {
+        virtual ~Layer() {}
+        virtual void draw (Graphics&) const = 0;
+    };
+
+    /** Draws a layer, either directly or from a cached image if the cache is enabled. */
+    static void drawLayer (WidgetCache* cache, Graphics& g, const Key& key,
+                           const Rectangle<int>& area, const Layer& layer)
+    {
+        if (cache == nullptr || ! cache->drawCached (g, key, area, layer))
+        {
+            g.saveState();
+            g.setOrigin (area.getX(), area.getY());
+            layer.draw (g);
+            g.restoreState();
+        }
+    }
+
+    void clear()
+    {
+        index.clear();
+        images.clear();
+    }
+
+    const int maxNumImages;
+
+    //==============================================================================
+    struct ButtonBackground  : public Layer
+    {
+        ButtonBackground (const Rectangle<float>& lozenge_, const Colour& colour_, const float outlineThickness_,
+                          const bool flatOnLeft_, const bool flatOnRight_, const bool flatOnTop_, const bool flatOnBottom_) noexcept
+            : lozenge (lozenge_), colour (colour_), outlineThickness (outlineThickness_),
+              flatOnLeft (flatOnLeft_), flatOnRight (flatOnRight_), flatOnTop (flatOnTop_), flatOnBottom (flatOnBottom_)
+        {
+        }
+
+        void draw (Graphics& g) const
+        {
+            LookAndFeel::drawGlassLozenge (g, lozenge.getX(), lozenge.getY(), lozenge.getWidth(), lozenge.getHeight(),
+                                           colour, outlineThickness, -1.0f,
+                                           flatOnLeft, flatOnRight, flatOnTop, flatOnBottom);
+        }
+
+        const Rectangle<float> lozenge;
+        const Colour colour;
+        const float outlineThickness;
+        const bool flatOnLeft, flatOnRight, flatOnTop, flatOnBottom;
+
+        JUCE_DECLARE_NON_COPYABLE (ButtonBackground)
+    };
+
+    struct LinearSliderTrack  : public Layer
+    {
+        LinearSliderTrack (const Rectangle<float>& indent_, const bool isHorizontal_,
+                           const Colour& trackColour_, const bool isEnabled_) noexcept
+            : indent (indent_), trackColour (trackColour_), isHorizontal (isHorizontal_), isEnabled (isEnabled_)
+        {
+        }
+
+        void draw (Graphics& g) const
+        {
+            const Colour gradCol1 (trackColour.overlaidWith (Colours::black.withAlpha (isEnabled ? 0.25f : 0.13f)));
+            const Colour gradCol2 (trackColour.overlaidWith (Colour (0x14000000)));
+
+            if (isHorizontal)
+                g.setGradientFill (ColourGradient (gradCol1, 0.0f, indent.getY(),
+                                                   gradCol2, 0.0f, indent.getBottom(), false));
+            else
+                g.setGradientFill (ColourGradient (gradCol1, indent.getX(), 0.0f,
+                                                   gradCol2, indent.getRight(), 0.0f, false));
+
+            Path p;
+            p.addRoundedRectangle (indent, 5.0f);
+            g.fillPath (p);
+
+            g.setColour (Colour (0x4c000000));
+            g.strokePath (p, PathStrokeType (0.5f));
+        }
+
+        const Rectangle<float> indent;
+        const Colour trackColour;
+        const bool isHorizontal, isEnabled;
+
+        JUCE_DECLARE_NON_COPYABLE (LinearSliderTrack)
+    };
+
+    struct RotarySliderOutline  : public Layer
+    {
+        RotarySliderOutline (const Rectangle<float>& bounds_, const float startAngle_, const float endAngle_,
+                             const float thickness_, const Colour& colour_, const float strokeWidth_) noexcept
+            : bounds (bounds_), startAngle (startAngle_), endAngle (endAngle_),
+              thickness (thickness_), colour (colour_), strokeWidth (strokeWidth_)
+        {
+        }
+
+        void draw (Graphics& g) const
+        {
+            Path outlineArc;
+            outlineArc.addPieSegment (bounds.getX(), bounds.getY(), bounds.getWidth(), bounds.getHeight(),
+                                      startAngle, endAngle, thickness);
+            outlineArc.closeSubPath();
+
+            g.setColour (colour);
+            g.strokePath (outlineArc, PathStrokeType (strokeWidth));
+        }
+
+        const Rectangle<float> bounds;
+        const float startAngle, endAngle, thickness;
+        const Colour colour;
+        const float strokeWidth;
+
+        JUCE_DECLARE_NON_COPYABLE (RotarySliderOutline)
+    };
+
+private:
+    struct CachedImage
+    {
+        CachedImage (const Key& key_, const Image& image_) noexcept
+            : key (key_), image (image_), lastUsed (0)
+        {
+        }
+
+        Key key;
+        Image image;
+        uint32 lastUsed;
+    };
+
+    OwnedArray<CachedImage> images;
+    HashMap<int64, CachedImage*> index;
+    uint32 useCounter;
+
+    bool drawCached (Graphics& g, const Key& unscaledKey, const Rectangle<int>& area, const Layer& layer)
+    {
+        LowLevelGraphicsContext& context = g.getInternalContext();
+
+        if (context.isVectorDevice() || area.isEmpty())
+            return false;
+
+        const float scale = context.getScaleFactor();
+        const int imageW = roundToInt (area.getWidth() * scale);
+        const int imageH = roundToInt (area.getHeight() * scale);
+
+        if (imageW <= 0 || imageH <= 0 || imageW > 2048 || imageH > 2048)
+            return false;
+
+        Key key (unscaledKey);
+        key.add (scale);
+
+        CachedImage* cached = findImage (key);
+
+        if (cached == nullptr)
+        {
+            Image image (Image::ARGB, imageW, imageH, true);
+
+            {
+                Graphics imageContext (image);
+                imageContext.addTransform (AffineTransform::scale (imageW / (float) area.getWidth(),
+                                                                   imageH / (float) area.getHeight()));
+                layer.draw (imageContext);
+            }
+
+            cached = addImage (key, image);
+        }
+
+        cached->lastUsed = ++useCounter;
+
+        Graphics::ScopedSaveState state (g);
+        g.setOpacity (1.0f);
+        g.drawImageTransformed (cached->image,
+                                AffineTransform::scale (area.getWidth() / (float) imageW,
+                                                        area.getHeight() / (float) imageH)
+                                                .translated ((float) area.getX(), (float) area.getY()));
+        return true;
+    }
+
+    CachedImage* findImage (const Key& key) const
+    {
+        CachedImage* const cached = index [key.getHash()];
+        return (cached != nullptr && cached->key == key) ? cached : nullptr;
+    }
+
+    CachedImage* addImage (const Key& key, const Image& image)
+    {
+        const int64 hash = key.getHash();
+
+        // (a different key with the same hash just gets replaced)
+        if (CachedImage* const existing = index [hash])
+            removeImage (existing);
+
+        while (images.size() >= maxNumImages)
+            removeImage (findLeastRecentlyUsed());
+
+        CachedImage* const cached = new CachedImage (key, image);
+        images.add (cached);
+        index.set (hash, cached);
+        return cached;
+    }
+
+    CachedImage* findLeastRecentlyUsed() const noexcept
+    {
+        CachedImage* oldest = images.getFirst();
+
+        for (int i = 1; i < images.size(); ++i)
+            if (images.getUnchecked(i)->lastUsed < oldest->lastUsed)
+                oldest = images.getUnchecked(i);
+
+        return oldest;
+    }
+
+    void removeImage (CachedImage* const cached)
+    {
+        index.remove (cached->key.getHash());
+        images.removeObject (cached);
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (WidgetCache)
+};
+
 //==============================================================================
 LookAndFeel::LookAndFeel()
     : useNativeAlertWindows (false)
@@ -245,6 +521,8 @@ void LookAndFeel::setColour (const int colourId, const Colour& colour) noexcept
         colourIds.add (colourId);
         colours.add (colour);
     }
+
+    clearWidgetCache();
 }
 
 bool LookAndFeel::isColourSpecified (const int colourId) const noexcept
@@ -302,9 +580,40 @@ MouseCursor LookAndFeel::getMouseCursorFor (Component& component)
 
 LowLevelGraphicsContext* LookAndFeel::createGraphicsContext (const Image& imageToRenderOn, const Point<int>& origin, const RectangleList& initialClip)
 {
+    if (renderingThreadPool != nullptr)
+        return new LowLevelGraphicsTiledRenderer (imageToRenderOn, origin, initialClip, *renderingThreadPool);
+
     return new LowLevelGraphicsSoftwareRenderer (imageToRenderOn, origin, initialClip);
 }
 
+void LookAndFeel::setNumRenderingThreads (const int numThreads)
+{
+    renderingThreadPool = nullptr;
+
+    if (numThreads > 1)
+        renderingThreadPool = new ThreadPool (numThreads);
+}
+
+//==============================================================================
+void LookAndFeel::setWidgetCachingEnabled (const bool shouldCacheWidgets, const int maxNumImages)
+{
+    if (! shouldCacheWidgets)
+        widgetCache = nullptr;
+    else if (widgetCache == nullptr || widgetCache->maxNumImages != jmax (1, maxNumImages))
+        widgetCache = new WidgetCache (maxNumImages);
+}
+
+bool LookAndFeel::isWidgetCachingEnabled() const noexcept
+{
+    return widgetCache != nullptr;
+}
+
+void LookAndFeel::clearWidgetCache()
+{
+    if (widgetCache != nullptr)
+        widgetCache->clear();
+}
+
 //==============================================================================
 void LookAndFeel::drawButtonBackground (Graphics& g,
                                         Button& button,
@@ -328,16 +637,23 @@ void LookAndFeel::drawButtonBackground (Graphics& g,
                                                                    isMouseOverButton, isButtonDown)
                                .withMultipliedAlpha (button.isEnabled() ? 1.0f : 0.5f));
 
-    drawGlassLozenge (g,
-                      indentL,
-                      indentT,
-                      width - indentL - indentR,
-                      height - indentT - indentB,
-                      baseColour, outlineThickness, -1.0f,
-                      button.isConnectedOnLeft(),
-                      button.isConnectedOnRight(),
-                      button.isConnectedOnTop(),
-                      button.isConnectedOnBottom());
+    const WidgetCache::ButtonBackground layer (Rectangle<float> (indentL, indentT,
+                                                                 width - indentL - indentR,
+                                                                 height - indentT - indentB),
+                                               baseColour, outlineThickness,
+                                               button.isConnectedOnLeft(),
+                                               button.isConnectedOnRight(),
+                                               button.isConnectedOnTop(),
+                                               button.isConnectedOnBottom());
+
+    const Rectangle<int> area (width, height);
+
+    WidgetCache::Key key (WidgetCache::buttonBackgroundLayer, area);
+    key.add (baseColour).add (outlineThickness)
+       .add ((uint32) ((layer.flatOnLeft ? 1 : 0) | (layer.flatOnRight ? 2 : 0)
+                        | (layer.flatOnTop ? 4 : 0) | (layer.flatOnBottom ? 8 : 0)));
+
+    WidgetCache::drawLayer (widgetCache, g, key, area, layer);
 }
 
 Font LookAndFeel::getTextButtonFont (TextButton& button)
@@ -1326,41 +1642,29 @@ void LookAndFeel::drawLinearSliderBackground (Graphics& g,
                                               Slider& slider)
 {
     const float sliderRadius = (float) (getSliderThumbRadius (slider) - 2);
+    const bool isHorizontal = slider.isHorizontal();
 
-    const Colour trackColour (slider.findColour (Slider::trackColourId));
-    const Colour gradCol1 (trackColour.overlaidWith (Colours::black.withAlpha (slider.isEnabled() ? 0.25f : 0.13f)));
-    const Colour gradCol2 (trackColour.overlaidWith (Colour (0x14000000)));
-    Path indent;
+    const Rectangle<float> indent (isHorizontal ? Rectangle<float> (x - sliderRadius * 0.5f,
+                                                                    y + height * 0.5f - sliderRadius * 0.5f,
+                                                                    width + sliderRadius, sliderRadius)
+                                                : Rectangle<float> (x + width * 0.5f - sliderRadius * 0.5f,
+                                                                    y - sliderRadius * 0.5f,
+                                                                    sliderRadius, height + sliderRadius));
 
-    if (slider.isHorizontal())
-    {
-        const float iy = y + height * 0.5f - sliderRadius * 0.5f;
-        const float ih = sliderRadius;
+    // the cached layer covers just the track, so its image doesn't depend on where the thumb is
+    const Rectangle<int> area (indent.getSmallestIntegerContainer().expanded (1, 1));
+    const Rectangle<float> relativeIndent (indent - area.getPosition().toFloat());
 
-        g.setGradientFill (ColourGradient (gradCol1, 0.0f, iy,
-                                           gradCol2, 0.0f, iy + ih, false));
+    const WidgetCache::LinearSliderTrack layer (relativeIndent, isHorizontal,
+                                                slider.findColour (Slider::trackColourId),
+                                                slider.isEnabled());
 
-        indent.addRoundedRectangle (x - sliderRadius * 0.5f, iy,
-                                    width + sliderRadius, ih,
-                                    5.0f);
-        g.fillPath (indent);
-    }
-    else
-    {
-        const float ix = x + width * 0.5f - sliderRadius * 0.5f;
-        const float iw = sliderRadius;
-
-        g.setGradientFill (ColourGradient (gradCol1, ix, 0.0f,
-                                           gradCol2, ix + iw, 0.0f, false));
+    WidgetCache::Key key (WidgetCache::linearSliderTrackLayer, area);
+    key.add (relativeIndent.getX()).add (relativeIndent.getY())
+       .add (relativeIndent.getWidth()).add (relativeIndent.getHeight())
+       .add (layer.trackColour).add ((uint32) ((isHorizontal ? 1 : 0) | (layer.isEnabled ? 2 : 0)));
 
-        indent.addRoundedRectangle (ix, y - sliderRadius * 0.5f,
-                                    iw, height + sliderRadius,
-                                    5.0f);
-        g.fillPath (indent);
-    }
-
-    g.setColour (Colour (0x4c000000));
-    g.strokePath (indent, PathStrokeType (0.5f));
+    WidgetCache::drawLayer (widgetCache, g, key, area, layer);
 }
 
 void LookAndFeel::drawLinearSliderThumb (Graphics& g,
@@ -1530,16 +1834,23 @@ void LookAndFeel::drawRotarySlider (Graphics& g,
             g.fillPath (p, AffineTransform::rotation (angle).translated (centreX, centreY));
         }
 
-        if (slider.isEnabled())
-            g.setColour (slider.findColour (Slider::rotarySliderOutlineColourId));
-        else
-            g.setColour (Colour (0x80808080));
+        const float strokeWidth = slider.isEnabled() ? (isMouseOver ? 2.0f : 1.2f) : 0.3f;
+        const Rectangle<int> area (Rectangle<float> (rx, ry, rw, rw).getSmallestIntegerContainer()
+                                                                     .expanded (2, 2));
+
+        const WidgetCache::RotarySliderOutline layer (Rectangle<float> (rx - area.getX(), ry - area.getY(), rw, rw),
+                                                      rotaryStartAngle, rotaryEndAngle, thickness,
+                                                      slider.isEnabled() ? slider.findColour (Slider::rotarySliderOutlineColourId)
+                                                                         : Colour (0x80808080),
+                                                      strokeWidth);
 
-        Path outlineArc;
-        outlineArc.addPieSegment (rx, ry, rw, rw, rotaryStartAngle, rotaryEndAngle, thickness);
-        outlineArc.closeSubPath();
+        WidgetCache::Key key (WidgetCache::rotarySliderOutlineLayer, area);
+        key.add (layer.bounds.getX()).add (layer.bounds.getY()).add (rw)
+           .add (rotaryStartAngle).add (rotaryEndAngle)
+           .add (layer.colour).add (strokeWidth);
 
-        g.strokePath (outlineArc, PathStrokeType (slider.isEnabled() ? (isMouseOver ? 2.0f : 1.2f) : 0.3f));
+        // the outline goes on top of the pointer, so it's drawn last even when it comes from the cache
+        WidgetCache::drawLayer (widgetCache, g, key, area, layer);
     }
     else
     {
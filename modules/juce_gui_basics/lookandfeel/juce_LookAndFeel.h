@@ -150,6 +150,45 @@ public:
                                                             const Point<int>& origin,
                                                             const RectangleList& initialClip);
 
+    /** Makes the default createGraphicsContext() method rasterise on multiple threads.
+
+        If numThreads is greater than 1, createGraphicsContext() will return a
+        LowLevelGraphicsTiledRenderer that uses a pool of this many threads, so that the
+        repaints of any windows that use this LookAndFeel are split into tiles and drawn
+        in parallel. A value of 0 or 1 turns this off again, which is the default.
+
+        @see LowLevelGraphicsTiledRenderer, SystemStats::getNumCpus
+    */
+    void setNumRenderingThreads (int numThreads);
+
+    //==============================================================================
+    /** Enables caching of the parts of the default widgets that don't depend on their value.
+
+        When this is turned on, the default button backgrounds, linear slider tracks and
+        rotary slider outlines are rendered once into images at the graphics context's
+        current scale, and those images are then re-used for each repaint of a widget with
+        the same size, state and colours. Only the moving parts (e.g. slider thumbs and
+        rotary pointers) are drawn from scratch each time.
+
+        Cached images are keyed on everything that affects their appearance, so there's no
+        need to invalidate them when a widget is resized, but calling setColour() on this
+        LookAndFeel will empty the cache. Once more than maxNumImages layers are stored,
+        the least-recently used ones are discarded.
+
+        This is off by default. Vector devices such as printers always get drawn directly.
+
+        @see clearWidgetCache
+    */
+    void setWidgetCachingEnabled (bool shouldCacheWidgets, int maxNumImages = 512);
+
+    /** Returns true if setWidgetCachingEnabled() has been turned on. */
+    bool isWidgetCachingEnabled() const noexcept;
+
+    /** Discards any images stored by the widget cache.
+        @see setWidgetCachingEnabled
+    */
+    void clearWidgetCache();
+
     //==============================================================================
     /** Draws the lozenge-shaped background for a standard button. */
     virtual void drawButtonBackground (Graphics& g,
@@ -654,6 +693,12 @@ private:
 
     bool useNativeAlertWindows;
 
+    ScopedPointer<ThreadPool> renderingThreadPool;
+
+    class WidgetCache;
+    friend class WidgetCache;
+    ScopedPointer<WidgetCache> widgetCache;
+
     void drawShinyButtonShape (Graphics& g,
                                float x, float y, float w, float h, float maxCornerSize,
                                const Colour& baseColour,
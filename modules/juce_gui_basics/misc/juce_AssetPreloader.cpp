@@ -0,0 +1,158 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+class AssetPreloader::LoadJob  : public ThreadPoolJob
+{
+public:
+    enum AssetType
+    {
+        imageFile,
+        imageData,
+        drawableFile,
+        drawableData,
+        typeface
+    };
+
+    LoadJob (AssetPreloader& p, const AssetType t, const File& f, const void* d, const size_t size, const Font& fnt)
+        : ThreadPoolJob ("Asset preloader"),
+          owner (p), type (t), file (f), data (d), dataSize (size), font (fnt)
+    {
+    }
+
+    JobStatus runJob()
+    {
+        Image image;
+        Typeface::Ptr face;
+
+        if (! shouldExit())
+        {
+            JUCE_TRACE_SCOPE_WITH_ID ("Asset preload", (int) type);
+
+            switch (type)
+            {
+                case imageFile:     image = ImageCache::getFromFile (file); break;
+                case imageData:     image = ImageCache::getFromMemory (data, (int) dataSize); break;
+                case drawableFile:  delete DrawableCache::getFromFile (file); break;
+                case drawableData:  delete DrawableCache::getFromMemory (data, dataSize); break;
+                case typeface:      face = font.getTypeface(); break;
+                default:            jassertfalse; break;
+            }
+        }
+
+        owner.jobFinished (image, face);
+        return jobHasFinished;
+    }
+
+private:
+    AssetPreloader& owner;
+    const AssetType type;
+    const File file;
+    const void* const data;
+    const size_t dataSize;
+    const Font font;
+
+    JUCE_DECLARE_NON_COPYABLE (LoadJob)
+};
+
+//==============================================================================
+AssetPreloader::AssetPreloader (const int numThreads)
+    : pool (numThreads > 0 ? numThreads : jmax (1, SystemStats::getNumCpus() - 1)),
+      allLoaded (true),
+      numPending (0)
+{
+    allLoaded.signal();
+}
+
+AssetPreloader::~AssetPreloader()
+{
+    pool.removeAllJobs (true, -1);
+}
+
+void AssetPreloader::addImage (const File& imageFile)
+{
+    addJob (new LoadJob (*this, LoadJob::imageFile, imageFile, nullptr, 0, Font()));
+}
+
+void AssetPreloader::addImage (const void* const imageData, const int dataSize)
+{
+    jassert (imageData != nullptr && dataSize > 0);
+    addJob (new LoadJob (*this, LoadJob::imageData, File::nonexistent, imageData, (size_t) dataSize, Font()));
+}
+
+void AssetPreloader::addDrawable (const File& drawableFile)
+{
+    addJob (new LoadJob (*this, LoadJob::drawableFile, drawableFile, nullptr, 0, Font()));
+}
+
+void AssetPreloader::addDrawable (const void* const data, const size_t numBytes)
+{
+    jassert (data != nullptr && numBytes > 0);
+    addJob (new LoadJob (*this, LoadJob::drawableData, File::nonexistent, data, numBytes, Font()));
+}
+
+void AssetPreloader::addTypeface (const Font& font)
+{
+    // (A Font shares its internal state with its copies, so the job needs a
+    // separate one, or the two threads would both try to set its typeface)
+    const Font copy (font.getTypefaceName(), font.getTypefaceStyle(), font.getHeight());
+
+    addJob (new LoadJob (*this, LoadJob::typeface, File::nonexistent, nullptr, 0, copy));
+}
+
+void AssetPreloader::addJob (LoadJob* const job)
+{
+    {
+        const ScopedLock sl (lock);
+
+        if (numPending++ == 0)
+            allLoaded.reset();
+    }
+
+    pool.addJob (job, true);
+}
+
+void AssetPreloader::jobFinished (const Image& image, Typeface* const face)
+{
+    const ScopedLock sl (lock);
+
+    if (image.isValid())
+        images.add (image);
+
+    if (face != nullptr)
+        typefaces.add (face);
+
+    if (--numPending == 0)
+        allLoaded.signal();
+}
+
+bool AssetPreloader::isFinished() const
+{
+    const ScopedLock sl (lock);
+    return numPending == 0;
+}
+
+bool AssetPreloader::waitUntilFinished (const int timeOutMilliseconds)
+{
+    return allLoaded.wait (timeOutMilliseconds);
+}
@@ -0,0 +1,144 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_ASSETPRELOADER_JUCEHEADER__
+#define __JUCE_ASSETPRELOADER_JUCEHEADER__
+
+#include "../drawables/juce_DrawableCache.h"
+
+
+//==============================================================================
+/**
+    Loads images, drawables and typefaces on background threads, so that they're
+    already in their caches by the time your components ask for them.
+
+    A big editor or window can spend most of its startup time decoding images, parsing
+    SVGs and loading fonts, one after another on the message thread. If you create one
+    of these at the start of the constructor and tell it about the assets that are going
+    to be needed, they'll be loaded in parallel while the components are being built.
+
+    The components must then get their assets through ImageCache::getFromFile(),
+    ImageCache::getFromMemory(), DrawableCache::getFromFile(), DrawableCache::getFromMemory()
+    or Font::getTypeface(). These will find the preloaded asset in the cache, or if it's
+    still being loaded, will wait for it to arrive rather than loading it a second time.
+
+    The preloader keeps a reference to every image and typeface that it has loaded, so
+    they won't be released by their caches while it exists. Drawables are only kept for
+    the DrawableCache's timeout, so don't preload them long before they're needed.
+
+    Typefaces are loaded with the current LookAndFeel's getTypefaceForFont() method, so
+    if you've overridden that, it must be safe to call on a background thread.
+
+    @code
+    MyEditor::MyEditor (MyProcessor& p)
+        : AudioProcessorEditor (&p)
+    {
+        preloader.addImage (BinaryData::background_png, BinaryData::background_pngSize);
+        preloader.addDrawable (BinaryData::knob_svg, (size_t) BinaryData::knob_svgSize);
+        preloader.addTypeface (Font ("Gill Sans", 15.0f, Font::plain));
+
+        // ...create the child components, which can now use ImageCache::getFromMemory()
+        // etc. without waiting for their assets to be decoded one at a time.
+    }
+    @endcode
+
+    @see ImageCache, DrawableCache, ComponentProfiler
+*/
+class JUCE_API  AssetPreloader
+{
+public:
+    //==============================================================================
+    /** Creates a preloader.
+
+        @param numThreads   the number of threads to load with, or 0 to use one fewer
+                            than the number of CPUs (the message thread needs the other)
+    */
+    explicit AssetPreloader (int numThreads = 0);
+
+    /** Destructor.
+        Any assets that haven't started loading yet are abandoned, and it waits for the
+        ones that are being loaded to finish.
+    */
+    ~AssetPreloader();
+
+    //==============================================================================
+    /** Starts loading an image file into the ImageCache.
+        @see ImageCache::getFromFile
+    */
+    void addImage (const File& imageFile);
+
+    /** Starts decoding an image from a block of memory into the ImageCache.
+        The data must stay valid until it's been loaded, and you must fetch the image with
+        the same pointer, because ImageCache::getFromMemory() uses it as the cache key.
+        @see ImageCache::getFromMemory
+    */
+    void addImage (const void* imageData, int dataSize);
+
+    /** Starts loading an SVG or image file into the DrawableCache.
+        @see DrawableCache::getFromFile
+    */
+    void addDrawable (const File& drawableFile);
+
+    /** Starts parsing an SVG or image from a block of memory into the DrawableCache.
+        The data must stay valid until it's been loaded.
+        @see DrawableCache::getFromMemory
+    */
+    void addDrawable (const void* data, size_t numBytes);
+
+    /** Starts loading the typeface that this font will use into the typeface cache.
+        Bear in mind that the cache only holds a few typefaces (see Typeface::setTypefaceCacheSize()),
+        so if you're preloading a lot of them you may need to make it bigger.
+        @see Font::getTypeface
+    */
+    void addTypeface (const Font& font);
+
+    //==============================================================================
+    /** Returns true if everything that's been added has finished loading. */
+    bool isFinished() const;
+
+    /** Blocks until everything that's been added has finished loading.
+        Returns false if the timeout expired first. A negative timeout waits forever.
+    */
+    bool waitUntilFinished (int timeOutMilliseconds = -1);
+
+private:
+    //==============================================================================
+    class LoadJob;
+    friend class LoadJob;
+
+    ThreadPool pool;
+    CriticalSection lock;
+    WaitableEvent allLoaded;
+    int numPending;
+    Array<Image> images;
+    ReferenceCountedArray<Typeface> typefaces;
+
+    void addJob (LoadJob*);
+    void jobFinished (const Image&, Typeface*);
+
+    JUCE_DECLARE_NON_COPYABLE (AssetPreloader)
+};
+
+
+#endif   // __JUCE_ASSETPRELOADER_JUCEHEADER__
@@ -22,14 +22,16 @@
   ==============================================================================
 */
 
-class MouseInputSourceInternal   : private AsyncUpdater
+class MouseInputSourceInternal   : private AsyncUpdater,
+                                   private Timer
 {
 public:
     //==============================================================================
     MouseInputSourceInternal (MouseInputSource& source_, const int index_, const bool isMouseDevice_)
         : index (index_), isMouseDevice (isMouseDevice_), source (source_), lastPeer (nullptr),
           isUnboundedMouseModeOn (false), isCursorVisibleUntilOffscreen (false), currentCursorHandle (nullptr),
-          mouseEventCounter (0), mouseMovedSignificantlySincePressed (false)
+          mouseEventCounter (0), hoverUpdatePeriodMs (0), lastHoverUpdateTime (0),
+          mouseMovedSignificantlySincePressed (false)
     {
     }
 
@@ -272,6 +274,15 @@ public:
         ++mouseEventCounter;
         const Point<int> screenPos (newPeer->localToGlobal (positionWithinPeer));
 
+        if (shouldDeferHoverUpdate (newPeer, newMods))
+        {
+            pendingHoverPos = screenPos;
+            return;
+        }
+
+        stopTimer(); // any deferred hover position is out-of-date now
+        lastHoverUpdateTime = Time::getMillisecondCounterHiRes();
+
         if (isDragging() && newMods.isAnyMouseButtonDown())
         {
             setScreenPos (screenPos, time, false);
@@ -367,6 +378,42 @@ public:
         setScreenPos (lastScreenPos, jmax (lastTime, Time::getCurrentTime()), true);
     }
 
+    //==============================================================================
+    void setMaximumHoverUpdateRate (const double updatesPerSecond)
+    {
+        hoverUpdatePeriodMs = updatesPerSecond > 0 ? 1000.0 / updatesPerSecond : 0;
+
+        if (hoverUpdatePeriodMs <= 0 && isTimerRunning())
+            timerCallback();
+    }
+
+    bool shouldDeferHoverUpdate (ComponentPeer* const newPeer, const ModifierKeys newMods)
+    {
+        if (hoverUpdatePeriodMs <= 0 || newPeer != lastPeer
+             || isDragging() || newMods.isAnyMouseButtonDown())
+            return false;
+
+        if (isTimerRunning())
+            return true;
+
+        const double msToWait = lastHoverUpdateTime + hoverUpdatePeriodMs - Time::getMillisecondCounterHiRes();
+
+        if (msToWait <= 0)
+            return false;
+
+        startTimer (jmax (1, roundToInt (msToWait)));
+        return true;
+    }
+
+    void timerCallback()
+    {
+        stopTimer();
+        lastHoverUpdateTime = Time::getMillisecondCounterHiRes();
+
+        if (getPeer() != nullptr)
+            setScreenPos (pendingHoverPos, lastTime, false);
+    }
+
     //==============================================================================
     void enableUnboundedMouseMovement (bool enable, bool keepCursorVisibleUntilOffscreen)
     {
@@ -477,6 +524,8 @@ private:
 
     RecentMouseDown mouseDowns[4];
     Time lastTime;
+    double hoverUpdatePeriodMs, lastHoverUpdateTime;
+    Point<int> pendingHoverPos;
     bool mouseMovedSignificantlySincePressed;
 
     void registerMouseDown (Point<int> screenPos, Time time,
@@ -524,6 +573,7 @@ Point<int> MouseInputSource::getScreenPosition() const                  { return
 ModifierKeys MouseInputSource::getCurrentModifiers() const              { return pimpl->getCurrentModifiers(); }
 Component* MouseInputSource::getComponentUnderMouse() const             { return pimpl->getComponentUnderMouse(); }
 void MouseInputSource::triggerFakeMove() const                          { pimpl->triggerFakeMove(); }
+void MouseInputSource::setMaximumHoverUpdateRate (double updatesPerSecond)  { pimpl->setMaximumHoverUpdateRate (updatesPerSecond); }
 int MouseInputSource::getNumberOfMultipleClicks() const noexcept        { return pimpl->getNumberOfMultipleClicks(); }
 Time MouseInputSource::getLastMouseDownTime() const noexcept            { return pimpl->getLastMouseDownTime(); }
 Point<int> MouseInputSource::getLastMouseDownPosition() const noexcept  { return pimpl->getLastMouseDownPosition(); }
@@ -108,6 +108,19 @@ public:
     */
     void triggerFakeMove() const;
 
+    /** Limits how often a hovering pointer will look for the component underneath it.
+
+        When the pointer moves without any buttons held down, each move normally involves
+        searching the component hierarchy for the component under it. If the moves arrive
+        faster than this rate, the later ones are held back and only the most recent position
+        is dispatched, once per period - so a value that matches the display's refresh rate
+        (e.g. 60) avoids doing work that could never be seen. Drags and button presses are
+        never delayed.
+
+        A rate of zero or less turns off the throttling, which is the default.
+    */
+    void setMaximumHoverUpdateRate (double updatesPerSecond);
+
     /** Returns the number of clicks that should be counted as belonging to the
         current mouse event.
         So the mouse is currently down and it's the second click of a double-click, this
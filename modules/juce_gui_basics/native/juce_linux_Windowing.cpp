@@ -519,27 +519,43 @@ public:
                                                  xImage->bytes_per_line * xImage->height,
                                                  IPC_CREAT | 0777)) >= 0)
                 {
-                    if (segmentInfo.shmid != -1)
+                    segmentInfo.shmaddr = (char*) shmat (segmentInfo.shmid, 0, 0);
+
+                    if (segmentInfo.shmaddr != (void*) -1)
                     {
-                        segmentInfo.shmaddr = (char*) shmat (segmentInfo.shmid, 0, 0);
+                        segmentInfo.readOnly = False;
 
-                        if (segmentInfo.shmaddr != (void*) -1)
-                        {
-                            segmentInfo.readOnly = False;
+                        xImage->data = segmentInfo.shmaddr;
+                        imageData = (uint8*) segmentInfo.shmaddr;
 
-                            xImage->data = segmentInfo.shmaddr;
-                            imageData = (uint8*) segmentInfo.shmaddr;
+                        // The attach can fail asynchronously (e.g. if the server can't see our
+                        // segment), so the error has to be trapped rather than just checking the result.
+                        XSHMHelpers::trappedErrorCode = 0;
+                        XErrorHandler oldHandler = XSetErrorHandler (XSHMHelpers::errorTrapHandler);
 
-                            if (XShmAttach (display, &segmentInfo) != 0)
-                                usingXShm = true;
-                            else
-                                jassertfalse;
-                        }
-                        else
+                        if (XShmAttach (display, &segmentInfo) != 0)
                         {
-                            shmctl (segmentInfo.shmid, IPC_RMID, 0);
+                            XSync (display, False);
+                            usingXShm = (XSHMHelpers::trappedErrorCode == 0);
                         }
+
+                        XSetErrorHandler (oldHandler);
+
+                        if (! usingXShm)
+                            shmdt (segmentInfo.shmaddr);
                     }
+
+                    // Once attached, the segment can be marked for removal straight away - it'll
+                    // stay alive until both we and the server have detached from it, and won't
+                    // be leaked if the app dies.
+                    shmctl (segmentInfo.shmid, IPC_RMID, 0);
+                }
+
+                if (! usingXShm)
+                {
+                    xImage->data = nullptr;
+                    XDestroyImage (xImage);
+                    xImage = nullptr;
                 }
             }
         }
@@ -605,7 +621,6 @@ public:
             XDestroyImage (xImage);
 
             shmdt (segmentInfo.shmaddr);
-            shmctl (segmentInfo.shmid, IPC_RMID, 0);
         }
         else
        #endif
@@ -636,6 +651,15 @@ public:
 
     ImageType* createType() const     { return new NativeImageType(); }
 
+   #if JUCE_USE_XSHM
+    /** True if this image is shared with the server, in which case its blits are asynchronous,
+        and an XShmCompletionEvent will be sent when each one has finished. */
+    bool isUsingXShm() const noexcept           { return usingXShm; }
+
+    /** The segment that will be identified by this image's completion events. */
+    ShmSeg getShmSegment() const noexcept       { return segmentInfo.shmseg; }
+   #endif
+
     void blitToWindow (Window window, int dx, int dy, int dw, int dh, int sx, int sy)
     {
         ScopedXLock xlock;
@@ -808,13 +832,15 @@ public:
           windowH (0), parentWindow (0),
           fullScreen (false), mapped (false),
           visual (nullptr), depth (0),
-          isAlwaysOnTop (comp.isAlwaysOnTop())
+          isAlwaysOnTop (comp.isAlwaysOnTop()),
+          scrollGC (0)
     {
         // it's dangerous to create a window on a thread other than the message thread..
         jassert (MessageManager::getInstance()->currentThreadHasLockedMessageManager());
 
         dispatchWindowMessage = windowMessageReceive;
         repainter = new LinuxRepaintManager (*this);
+        paintScheduler = new PaintScheduler (*repainter);
 
         if (isAlwaysOnTop)
             ++numAlwaysOnTopPeers;
@@ -829,7 +855,15 @@ public:
         // it's dangerous to delete a window on a thread other than the message thread..
         jassert (MessageManager::getInstance()->currentThreadHasLockedMessageManager());
 
+        paintScheduler = nullptr;
         deleteIconPixmaps();
+
+        if (scrollGC != 0)
+        {
+            ScopedXLock xlock;
+            XFreeGC (display, scrollGC);
+        }
+
         destroyWindow();
         windowH = 0;
 
@@ -1213,12 +1247,28 @@ public:
 
     void repaint (const Rectangle<int>& area)
     {
-        repainter->repaint (area.getIntersection (component.getLocalBounds()));
+        paintScheduler->invalidate (area.getIntersection (component.getLocalBounds()));
     }
 
     void performAnyPendingRepaintsNow()
     {
-        repainter->performAnyPendingRepaintsNow();
+        paintScheduler->flush();
+    }
+
+    bool copyWindowArea (const Rectangle<int>& sourceArea, const Point<int>& delta)
+    {
+        ScopedXLock xlock;
+
+        // (the default GC generates GraphicsExpose events for any parts of the source that
+        // were hidden, so those get repainted at their new position)
+        if (scrollGC == 0)
+            scrollGC = XCreateGC (display, windowH, 0, 0);
+
+        XCopyArea (display, windowH, windowH, scrollGC,
+                   sourceArea.getX(), sourceArea.getY(),
+                   (unsigned int) sourceArea.getWidth(), (unsigned int) sourceArea.getHeight(),
+                   sourceArea.getX() + delta.x, sourceArea.getY() + delta.y);
+        return true;
     }
 
     void setIcon (const Image& newIcon)
@@ -1293,6 +1343,7 @@ public:
             case FocusIn:               handleFocusInEvent(); break;
             case FocusOut:              handleFocusOutEvent(); break;
             case Expose:                handleExposeEvent (event.xexpose); break;
+            case GraphicsExpose:        handleGraphicsExposeEvent (event.xgraphicsexpose); break;
             case MappingNotify:         handleMappingNotify (event.xmapping); break;
             case ClientMessage:         handleClientMessageEvent (event.xclient, event); break;
             case SelectionNotify:       handleDragAndDropSelection (event); break;
@@ -1302,6 +1353,7 @@ public:
             case SelectionClear:        handleExternalSelectionClear(); break;
             case SelectionRequest:      handleExternalSelectionRequest (event); break;
 
+            case NoExpose:
             case CirculateNotify:
             case CreateNotify:
             case DestroyNotify:
@@ -1321,8 +1373,8 @@ public:
                #if JUCE_USE_XSHM
                 {
                     ScopedXLock xlock;
-                    if (event.xany.type == XShmGetEventBase (display))
-                        repainter->notifyPaintCompleted();
+                    if (event.xany.type == XShmGetEventBase (display) + ShmCompletion)
+                        repainter->notifyPaintCompleted (reinterpret_cast<const XShmCompletionEvent&> (event));
                 }
                #endif
                 break;
@@ -1614,6 +1666,12 @@ public:
         }
     }
 
+    void handleGraphicsExposeEvent (const XGraphicsExposeEvent& exposeEvent)
+    {
+        repaint (Rectangle<int> (exposeEvent.x, exposeEvent.y,
+                                 exposeEvent.width, exposeEvent.height));
+    }
+
     void handleConfigureNotifyEvent (XConfigureEvent& confEvent)
     {
         updateBounds();
@@ -1779,14 +1837,16 @@ public:
 
 private:
     //==============================================================================
-    class LinuxRepaintManager   : public Timer
+    class LinuxRepaintManager   : public PaintScheduler::Target,
+                                  private Timer
     {
     public:
         LinuxRepaintManager (LinuxComponentPeer& p)
-            : peer (p), lastTimeImageUsed (0)
+            : peer (p)
         {
            #if JUCE_USE_XSHM
-            shmPaintsPending = 0;
+            currentBuffer = 0;
+            shmPaintsPending[0] = shmPaintsPending[1] = 0;
 
             useARGBImagesForRendering = XSHMHelpers::isShmAvailable();
 
@@ -1805,51 +1865,54 @@ private:
            #endif
         }
 
+        // (the image is released when it hasn't been used for a while)
         void timerCallback()
         {
            #if JUCE_USE_XSHM
-            if (shmPaintsPending != 0)
+            // (an image that the server is still reading from has to be kept alive)
+            if (shmPaintsPending[0] + shmPaintsPending[1] != 0)
                 return;
            #endif
 
-            if (! regionsNeedingRepaint.isEmpty())
-            {
-                stopTimer();
-                performAnyPendingRepaintsNow();
-            }
-            else if (Time::getApproximateMillisecondCounter() > lastTimeImageUsed + 3000)
-            {
-                stopTimer();
-                image = Image::null;
-            }
-        }
-
-        void repaint (const Rectangle<int>& area)
-        {
-            if (! isTimerRunning())
-                startTimer (repaintTimerPeriod);
-
-            regionsNeedingRepaint.add (area);
+            stopTimer();
+            images[0] = Image::null;
+            images[1] = Image::null;
         }
 
-        void performAnyPendingRepaintsNow()
+        bool flushRepaintRegion (const RectangleList& regionToPaint)
         {
            #if JUCE_USE_XSHM
-            if (shmPaintsPending != 0)
+            // We can't draw into an image until the server has finished blitting it, so
+            // if the last frame is still in flight, the other buffer gets used instead.
+            if (shmPaintsPending [currentBuffer] != 0)
             {
-                startTimer (repaintTimerPeriod);
-                return;
+                if (shmPaintsPending [1 - currentBuffer] != 0)
+                    return false;
+
+                currentBuffer = 1 - currentBuffer;
             }
+
+            Image& image = images [currentBuffer];
+           #else
+            Image& image = images[0];
            #endif
 
             peer.clearMaskedRegion();
 
-            RectangleList originalRepaintRegion (regionsNeedingRepaint);
-            regionsNeedingRepaint.clear();
+            RectangleList originalRepaintRegion (regionToPaint);
             const Rectangle<int> totalArea (originalRepaintRegion.getBounds());
 
             if (! totalArea.isEmpty())
             {
+               #if JUCE_USE_XSHM
+                // Each blit has a fixed cost, so it's worth painting a few extra pixels if it
+                // means sending fewer rectangles. (Without XShm the pixels themselves go down the
+                // wire, so in that case only exactly-equivalent merging is done).
+                mergeDamageRegion (originalRepaintRegion, useARGBImagesForRendering);
+               #else
+                mergeDamageRegion (originalRepaintRegion, false);
+               #endif
+
                 if (image.isNull() || image.getWidth() < totalArea.getWidth()
                      || image.getHeight() < totalArea.getHeight())
                 {
@@ -1864,8 +1927,6 @@ private:
                                                      false, peer.depth, peer.visual));
                 }
 
-                startTimer (repaintTimerPeriod);
-
                 RectangleList adjustedList (originalRepaintRegion);
                 adjustedList.offsetAll (-totalArea.getX(), -totalArea.getY());
 
@@ -1880,41 +1941,118 @@ private:
                 }
 
                 if (! peer.maskedRegion.isEmpty())
+                {
                     originalRepaintRegion.subtract (peer.maskedRegion);
+                    originalRepaintRegion.consolidate();
+                }
+
+                XBitmapImage* const bitmap = static_cast<XBitmapImage*> (image.getPixelData());
 
                 for (const Rectangle<int>* i = originalRepaintRegion.begin(), * const e = originalRepaintRegion.end(); i != e; ++i)
                 {
                    #if JUCE_USE_XSHM
-                    ++shmPaintsPending;
+                    if (bitmap->isUsingXShm())
+                        ++shmPaintsPending [currentBuffer];
                    #endif
 
-                    static_cast<XBitmapImage*> (image.getPixelData())
-                        ->blitToWindow (peer.windowH,
+                    bitmap->blitToWindow (peer.windowH,
                                         i->getX(), i->getY(), i->getWidth(), i->getHeight(),
                                         i->getX() - totalArea.getX(), i->getY() - totalArea.getY());
                 }
             }
 
-            lastTimeImageUsed = Time::getApproximateMillisecondCounter();
-            startTimer (repaintTimerPeriod);
+            startTimer (imageReleaseTimeout);
+            return true;
         }
 
        #if JUCE_USE_XSHM
-        void notifyPaintCompleted() noexcept        { --shmPaintsPending; }
+        void notifyPaintCompleted (const XShmCompletionEvent& event) noexcept
+        {
+            for (int i = 0; i < 2; ++i)
+            {
+                XBitmapImage* const bitmap = static_cast<XBitmapImage*> (images[i].getPixelData());
+
+                if (bitmap != nullptr && bitmap->isUsingXShm()
+                     && bitmap->getShmSegment() == event.shmseg && shmPaintsPending[i] > 0)
+                {
+                    --shmPaintsPending[i];
+                    return;
+                }
+            }
+        }
        #endif
 
     private:
-        enum { repaintTimerPeriod = 1000 / 100 };
+        enum { imageReleaseTimeout = 3000 };
 
         LinuxComponentPeer& peer;
-        Image image;
-        uint32 lastTimeImageUsed;
-        RectangleList regionsNeedingRepaint;
+        Image images[2];
 
        #if JUCE_USE_XSHM
         bool useARGBImagesForRendering;
-        int shmPaintsPending;
+        int currentBuffer;
+        int shmPaintsPending[2];
        #endif
+
+        /* Reduces the number of rectangles that need to be painted and blitted. The list is
+           first consolidated into an equivalent set of larger rectangles, and then if
+           allowOverdraw is true, rectangles are repeatedly replaced by their joint bounding
+           box whenever the extra area that this paints is smaller than the cost of a blit.
+        */
+        static void mergeDamageRegion (RectangleList& region, const bool allowOverdraw)
+        {
+            region.consolidate();
+
+            if (! allowOverdraw)
+                return;
+
+            const int pixelsPerBlit = 64 * 64;  // roughly the overhead of a single put-image request
+            const int maxNumBlits = 16;
+
+            // (the number of passes is limited, because adding a rectangle can split up others)
+            for (int pass = 0; pass < maxNumBlits * 2; ++pass)
+            {
+                const int num = region.getNumRectangles();
+
+                if (num <= 1)
+                    return;
+
+                int bestI = -1, bestJ = -1;
+                int64 bestWaste = pixelsPerBlit;
+
+                for (int i = 0; i < num; ++i)
+                {
+                    const Rectangle<int> r1 (region.getRectangle (i));
+
+                    for (int j = i + 1; j < num; ++j)
+                    {
+                        const Rectangle<int> r2 (region.getRectangle (j));
+                        const Rectangle<int> joined (r1.getUnion (r2));
+
+                        const int64 waste = joined.getWidth() * (int64) joined.getHeight()
+                                             - r1.getWidth() * (int64) r1.getHeight()
+                                             - r2.getWidth() * (int64) r2.getHeight();
+
+                        if (waste < bestWaste)
+                        {
+                            bestWaste = waste;
+                            bestI = i;
+                            bestJ = j;
+                        }
+                    }
+                }
+
+                if (bestI < 0)
+                    break;
+
+                const Rectangle<int> joined (region.getRectangle (bestI).getUnion (region.getRectangle (bestJ)));
+                region.add (joined);
+                region.consolidate();
+            }
+
+            if (region.getNumRectangles() > maxNumBlits)
+                region = RectangleList (region.getBounds());
+        }
         JUCE_DECLARE_NON_COPYABLE (LinuxRepaintManager)
     };
 
@@ -1929,6 +2067,7 @@ private:
     int depth;
     BorderSize<int> windowBorder;
     bool isAlwaysOnTop;
+    GC scrollGC;
     enum { KeyPressEventType = 2 };
 
     struct MotifWmHints
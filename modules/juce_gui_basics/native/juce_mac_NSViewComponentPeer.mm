@@ -42,7 +42,8 @@ namespace juce {
 #endif
 
 //==============================================================================
-class NSViewComponentPeer  : public ComponentPeer
+class NSViewComponentPeer  : public ComponentPeer,
+                             private PaintScheduler::Target
 {
 public:
     NSViewComponentPeer (Component& comp, const int windowStyleFlags, NSView* viewToAttachTo)
@@ -63,6 +64,7 @@ public:
     {
         appFocusChangeCallback = appFocusChanged;
         isEventBlockedByModalComps = checkEventBlockedByModalComps;
+        paintScheduler = new PaintScheduler (*this);
 
         NSRect r = NSMakeRect (0, 0, (CGFloat) component.getWidth(), (CGFloat) component.getHeight());
 
@@ -156,6 +158,7 @@ public:
 
     ~NSViewComponentPeer()
     {
+        paintScheduler = nullptr;
         [notificationCenter removeObserver: view];
         setOwner (view, nullptr);
 
@@ -1141,40 +1144,47 @@ public:
     //==============================================================================
     void repaint (const Rectangle<int>& area)
     {
+        paintScheduler->invalidate (area);
+    }
+
+    bool flushRepaintRegion (const RectangleList& regionToPaint)
+    {
+        // (the view ignores any areas that are invalidated while it's drawing, so these
+        // will be left until the next frame)
         if (insideDrawRect)
-        {
-            class AsyncRepaintMessage  : public CallbackMessage
-            {
-            public:
-                AsyncRepaintMessage (NSViewComponentPeer* const p, const Rectangle<int>& r)
-                    : peer (p), rect (r)
-                {}
+            return false;
 
-                void messageCallback()
-                {
-                    if (ComponentPeer::isValidPeer (peer))
-                        peer->repaint (rect);
-                }
+        const CGFloat viewHeight = [view frame].size.height;
 
-            private:
-                NSViewComponentPeer* const peer;
-                const Rectangle<int> rect;
-            };
+        for (const Rectangle<int>* i = regionToPaint.begin(), * const e = regionToPaint.end(); i != e; ++i)
+            [view setNeedsDisplayInRect: NSMakeRect ((CGFloat) i->getX(), viewHeight - (CGFloat) i->getBottom(),
+                                                     (CGFloat) i->getWidth(), (CGFloat) i->getHeight())];
 
-            (new AsyncRepaintMessage (this, area))->post();
-        }
-        else
-        {
-            [view setNeedsDisplayInRect: NSMakeRect ((CGFloat) area.getX(), [view frame].size.height - (CGFloat) area.getBottom(),
-                                                     (CGFloat) area.getWidth(), (CGFloat) area.getHeight())];
-        }
+        return true;
     }
 
     void performAnyPendingRepaintsNow()
     {
+        paintScheduler->flush();
         [view displayIfNeeded];
     }
 
+    bool copyWindowArea (const Rectangle<int>& sourceArea, const Point<int>& delta)
+    {
+        if (insideDrawRect || [view layer] != nil)
+            return false;
+
+        // the view doesn't move the areas that it's waiting to draw, so they're drawn first
+        [view displayIfNeeded];
+
+        const CGFloat viewHeight = [view frame].size.height;
+
+        [view scrollRect: NSMakeRect ((CGFloat) sourceArea.getX(), viewHeight - (CGFloat) sourceArea.getBottom(),
+                                      (CGFloat) sourceArea.getWidth(), (CGFloat) sourceArea.getHeight())
+                      by: NSMakeSize ((CGFloat) delta.x, (CGFloat) -delta.y)];
+        return true;
+    }
+
     //==============================================================================
     NSWindow* window;
     NSView* view;
@@ -497,7 +497,8 @@ namespace IconConverters
 }
 
 //==============================================================================
-class HWNDComponentPeer  : public ComponentPeer
+class HWNDComponentPeer  : public ComponentPeer,
+                           private PaintScheduler::Target
 {
 public:
     enum RenderingEngineType
@@ -523,6 +524,7 @@ public:
           dropTarget (nullptr),
           updateLayeredWindowAlpha (255)
     {
+        paintScheduler = new PaintScheduler (*this);
         callFunctionIfNotLocked (&createWindowCallback, this);
 
         setTitle (component.getName());
@@ -539,6 +541,7 @@ public:
 
     ~HWNDComponentPeer()
     {
+        paintScheduler = nullptr;
         shadower = nullptr;
 
         // do this before the next bit to avoid messages arriving for this window
@@ -873,18 +876,65 @@ public:
 
     void repaint (const Rectangle<int>& area)
     {
-        const RECT r = { area.getX(), area.getY(), area.getRight(), area.getBottom() };
-        InvalidateRect (hwnd, &r, FALSE);
+        paintScheduler->invalidate (area);
+    }
+
+    bool flushRepaintRegion (const RectangleList& regionToPaint)
+    {
+        for (const Rectangle<int>* i = regionToPaint.begin(), * const e = regionToPaint.end(); i != e; ++i)
+        {
+            const RECT r = { i->getX(), i->getY(), i->getRight(), i->getBottom() };
+            InvalidateRect (hwnd, &r, FALSE);
+        }
+
+        return true;
     }
 
     void performAnyPendingRepaintsNow()
     {
+        paintScheduler->flush();
+
         MSG m;
         if (component.isVisible()
              && (PeekMessage (&m, hwnd, WM_PAINT, WM_PAINT, PM_REMOVE) || isUsingUpdateLayeredWindow()))
             handlePaintMessage();
     }
 
+    bool copyWindowArea (const Rectangle<int>& sourceArea, const Point<int>& delta)
+    {
+        // (layered windows and Direct2D don't leave their pixels in the window to be copied)
+        if (isUsingUpdateLayeredWindow())
+            return false;
+
+       #if JUCE_DIRECT2D
+        if (direct2DContext != nullptr)
+            return false;
+       #endif
+
+        const Rectangle<int> area (sourceArea.getUnion (sourceArea + delta));
+        const RECT r = { area.getX(), area.getY(), area.getRight(), area.getBottom() };
+
+        // The window's update region isn't scrolled, so any invalid parts of the area also need
+        // to be invalidated where their pixels end up. (ScrollWindowEx itself invalidates the
+        // uncovered strip, and anything that was hidden by another window)
+        HRGN pendingRegion = CreateRectRgn (0, 0, 0, 0);
+        const bool anyPending = GetUpdateRgn (hwnd, pendingRegion, FALSE) > NULLREGION;
+
+        ScrollWindowEx (hwnd, delta.x, delta.y, &r, &r, 0, 0, SW_INVALIDATE);
+
+        if (anyPending)
+        {
+            HRGN clipRegion = CreateRectRgnIndirect (&r);
+            OffsetRgn (pendingRegion, delta.x, delta.y);
+            CombineRgn (pendingRegion, pendingRegion, clipRegion, RGN_AND);
+            InvalidateRgn (hwnd, pendingRegion, FALSE);
+            DeleteObject (clipRegion);
+        }
+
+        DeleteObject (pendingRegion);
+        return true;
+    }
+
     //==============================================================================
     static HWNDComponentPeer* getOwnerOfWindow (HWND h) noexcept
     {
@@ -1413,10 +1463,16 @@ private:
 
             if (GetUpdateRect (hwnd, &r, false))
             {
-                direct2DContext->start();
-                direct2DContext->clipToRectangle (rectangleFromRECT (r));
-                handlePaint (*direct2DContext);
-                direct2DContext->end();
+                if (direct2DContext->start())
+                {
+                    direct2DContext->clipToRectangle (rectangleFromRECT (r));
+                    handlePaint (*direct2DContext);
+                    direct2DContext->end();
+                }
+
+                // (nothing else validates the area when we don't call BeginPaint, so without
+                // this, the window would keep getting sent WM_PAINT messages)
+                ValidateRect (hwnd, &r);
             }
         }
         else
@@ -190,6 +190,7 @@ public:
         : RelativeCoordinatePositionerBase (comp),
           rectangle (r)
     {
+        compileExpressions();
     }
 
     bool registerCoordinates()
@@ -211,7 +212,13 @@ public:
         for (int i = 4; --i >= 0;)
         {
             ComponentScope scope (getComponent());
-            const Rectangle<int> newBounds (rectangle.resolve (&scope).getSmallestIntegerContainer());
+            const double l = resolve (left, scope);
+            const double r = resolve (right, scope);
+            const double t = resolve (top, scope);
+            const double b = resolve (bottom, scope);
+
+            const Rectangle<int> newBounds (Rectangle<float> ((float) l, (float) t, (float) jmax (0.0, r - l),
+                                                              (float) jmax (0.0, b - t)).getSmallestIntegerContainer());
 
             if (newBounds == getComponent().getBounds())
                 return;
@@ -228,6 +235,7 @@ public:
         {
             ComponentScope scope (getComponent());
             rectangle.moveToAbsolute (newBounds.toFloat(), &scope);
+            compileExpressions();
 
             applyToComponentBounds();
         }
@@ -236,6 +244,25 @@ public:
 private:
     RelativeRectangle rectangle;
 
+    // The expressions are flattened once, so that each layout pass only needs to
+    // look up the symbols' current values, and can skip any arithmetic whose inputs
+    // haven't changed since the last pass.
+    CompiledExpression left, right, top, bottom;
+
+    void compileExpressions()
+    {
+        left   = CompiledExpression (rectangle.left.getExpression());
+        right  = CompiledExpression (rectangle.right.getExpression());
+        top    = CompiledExpression (rectangle.top.getExpression());
+        bottom = CompiledExpression (rectangle.bottom.getExpression());
+    }
+
+    static double resolve (CompiledExpression& e, const Expression::Scope& scope)
+    {
+        e.updateSymbolValues (scope);
+        return e.evaluate (scope);
+    }
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (RelativeRectangleComponentPositioner)
 };
 
@@ -41,6 +41,32 @@ public:
         }
     }
 
+    SectionComponent (const String& sectionTitle,
+                      SectionModel* const sectionModel,
+                      const bool sectionIsOpen_)
+        : Component (sectionTitle),
+          titleHeight (sectionTitle.isNotEmpty() ? 22 : 0),
+          sectionIsOpen (sectionIsOpen_),
+          model (sectionModel),
+          firstModelIndex (0)
+    {
+        jassert (model != nullptr);
+
+        // Only the heights are kept for the properties that haven't been created..
+        const int numProperties = model->getNumProperties();
+        modelPropertyY.ensureStorageAllocated (numProperties + 1);
+
+        int y = titleHeight;
+
+        for (int i = 0; i < numProperties; ++i)
+        {
+            modelPropertyY.add (y);
+            y += model->getPropertyHeight (i);
+        }
+
+        modelPropertyY.add (y);
+    }
+
     ~SectionComponent()
     {
         propertyComps.clear();
@@ -54,6 +80,15 @@ public:
 
     void resized()
     {
+        if (model != nullptr)
+        {
+            for (int i = 0; i < propertyComps.size(); ++i)
+                if (PropertyComponent* const pec = propertyComps.getUnchecked (i))
+                    pec->setBounds (1, modelPropertyY.getUnchecked (firstModelIndex + i), getWidth() - 2, pec->getPreferredHeight());
+
+            return;
+        }
+
         int y = titleHeight;
 
         for (int i = 0; i < propertyComps.size(); ++i)
@@ -68,7 +103,12 @@ public:
     {
         int y = titleHeight;
 
-        if (isOpen())
+        if (model != nullptr)
+        {
+            if (isOpen())
+                y = modelPropertyY.getLast();
+        }
+        else if (isOpen())
         {
             for (int i = propertyComps.size(); --i >= 0;)
                 y += propertyComps.getUnchecked(i)->getPreferredHeight();
@@ -83,8 +123,10 @@ public:
         {
             sectionIsOpen = open;
 
-            for (int i = propertyComps.size(); --i >= 0;)
-                propertyComps.getUnchecked(i)->setVisible (open);
+            // (a section with a model just creates or deletes its components when the panel updates)
+            if (model == nullptr)
+                for (int i = propertyComps.size(); --i >= 0;)
+                    propertyComps.getUnchecked(i)->setVisible (open);
 
             if (PropertyPanel* const pp = findParentComponentOfClass<PropertyPanel>())
                 pp->resized();
@@ -99,7 +141,61 @@ public:
     void refreshAll() const
     {
         for (int i = propertyComps.size(); --i >= 0;)
-            propertyComps.getUnchecked (i)->refresh();
+            if (PropertyComponent* const pec = propertyComps.getUnchecked (i))
+                pec->refresh();
+    }
+
+    // For a section with a model, this creates the components that overlap the given area, and
+    // deletes any others.
+    void updateModelComponents (const Rectangle<int>& visibleArea)
+    {
+        if (model == nullptr)
+            return;
+
+        int start = 0, end = 0;
+
+        if (isOpen() && ! visibleArea.isEmpty())
+        {
+            start = getModelIndexAt (visibleArea.getY());
+            end = getModelIndexAt (visibleArea.getBottom() - 1) + 1;
+        }
+
+        const int numProperties = modelPropertyY.size() - 1;
+        start = jlimit (0, numProperties, start);
+        end = jlimit (start, numProperties, end);
+
+        // (any components that are still in view are kept, so they don't lose their state)
+        OwnedArray<PropertyComponent> newComps;
+
+        for (int i = start; i < end; ++i)
+        {
+            const int oldIndex = i - firstModelIndex;
+            PropertyComponent* pec = nullptr;
+
+            if (isPositiveAndBelow (oldIndex, propertyComps.size()))
+            {
+                pec = propertyComps.getUnchecked (oldIndex);
+                propertyComps.set (oldIndex, nullptr, false);
+            }
+
+            if (pec == nullptr)
+            {
+                pec = model->createPropertyComponent (i);
+                jassert (pec == nullptr || pec->getPreferredHeight() == modelPropertyY[i + 1] - modelPropertyY[i]);
+
+                if (pec != nullptr)
+                {
+                    addAndMakeVisible (pec);
+                    pec->setBounds (1, modelPropertyY.getUnchecked (i), getWidth() - 2, pec->getPreferredHeight());
+                    pec->refresh();
+                }
+            }
+
+            newComps.add (pec);
+        }
+
+        propertyComps.swapWithArray (newComps);
+        firstModelIndex = start;
     }
 
     void mouseUp (const MouseEvent& e)
@@ -123,6 +219,15 @@ private:
     OwnedArray <PropertyComponent> propertyComps;
     int titleHeight;
     bool sectionIsOpen;
+    ScopedPointer<SectionModel> model;
+    Array<int> modelPropertyY;
+    int firstModelIndex;
+
+    int getModelIndexAt (const int y) const noexcept
+    {
+        const int* const positions = modelPropertyY.begin();
+        return (int) (std::upper_bound (positions, positions + modelPropertyY.size(), y) - positions) - 1;
+    }
 
     JUCE_DECLARE_NON_COPYABLE (SectionComponent)
 };
@@ -149,6 +254,27 @@ public:
 
         setSize (width, y);
         repaint();
+        updateVisibleProperties();
+    }
+
+    void moved()
+    {
+        updateVisibleProperties();
+    }
+
+    // Lets any sections that create their components on demand know which of them are in view.
+    void updateVisibleProperties()
+    {
+        if (Component* const parent = getParentComponent())
+        {
+            const Rectangle<int> visibleArea (getLocalArea (parent, parent->getLocalBounds()));
+
+            for (int i = 0; i < sections.size(); ++i)
+            {
+                SectionComponent* const section = sections.getUnchecked(i);
+                section->updateModelComponents (visibleArea - section->getPosition());
+            }
+        }
     }
 
     void refreshAll() const
@@ -178,6 +304,12 @@ private:
 };
 
 
+//==============================================================================
+int PropertyPanel::SectionModel::getPropertyHeight (int)
+{
+    return 25;
+}
+
 //==============================================================================
 PropertyPanel::PropertyPanel()
     : messageWhenEmpty (TRANS("(nothing selected)"))
@@ -252,6 +384,28 @@ void PropertyPanel::addSection (const String& sectionTitle,
     updatePropHolderLayout();
 }
 
+void PropertyPanel::addProperties (SectionModel* const sectionModel)
+{
+    if (isEmpty())
+        repaint();
+
+    propertyHolderComponent->addSection (new SectionComponent (String::empty, sectionModel, true));
+    updatePropHolderLayout();
+}
+
+void PropertyPanel::addSection (const String& sectionTitle,
+                                SectionModel* const sectionModel,
+                                const bool shouldBeOpen)
+{
+    jassert (sectionTitle.isNotEmpty());
+
+    if (isEmpty())
+        repaint();
+
+    propertyHolderComponent->addSection (new SectionComponent (sectionTitle, sectionModel, shouldBeOpen));
+    updatePropHolderLayout();
+}
+
 void PropertyPanel::updatePropHolderLayout() const
 {
     const int maxWidth = viewport.getMaximumVisibleWidth();
@@ -51,6 +51,41 @@ public:
     /** Destructor. */
     ~PropertyPanel();
 
+    //==============================================================================
+    /**
+        Creates the PropertyComponents for a section of a PropertyPanel when they're needed.
+
+        Instead of creating all of a section's components up-front, you can give addSection()
+        or addProperties() one of these, and the panel will only ask it for the components
+        that are scrolled into view. Components that scroll out of view, or are in a section
+        that gets closed, are deleted again - so a panel with thousands of properties only
+        ever holds the few that are actually on-screen.
+
+        @see PropertyPanel::addSection
+    */
+    class JUCE_API  SectionModel
+    {
+    public:
+        /** Destructor. */
+        virtual ~SectionModel() {}
+
+        /** Returns the number of properties in the section. */
+        virtual int getNumProperties() = 0;
+
+        /** Creates the component for one of the properties.
+            The panel takes ownership of the object that is returned, and may delete it and
+            ask for a new one at any time.
+        */
+        virtual PropertyComponent* createPropertyComponent (int propertyIndex) = 0;
+
+        /** Returns the height of one of the properties.
+            This must be the same as the getPreferredHeight() of the component that
+            createPropertyComponent() would return for it. The default returns 25, which is
+            the default PropertyComponent height.
+        */
+        virtual int getPropertyHeight (int propertyIndex);
+    };
+
     //==============================================================================
     /** Deletes all property components from the panel. */
     void clear();
@@ -79,6 +114,26 @@ public:
                      const Array <PropertyComponent*>& newPropertyComponents,
                      bool shouldSectionInitiallyBeOpen = true);
 
+    /** Adds a set of properties whose components will be created as they're needed.
+
+        This is like addProperties(), but the components are only created when they're
+        scrolled into view - see SectionModel for more details.
+
+        The model will be owned by this object, and deleted when no longer needed.
+    */
+    void addProperties (SectionModel* sectionModel);
+
+    /** Adds a section whose components will be created as they're needed.
+
+        This is like addSection(), but the components are only created when the section is
+        open and they're scrolled into view - see SectionModel for more details.
+
+        The model will be owned by this object, and deleted when no longer needed.
+    */
+    void addSection (const String& sectionTitle,
+                     SectionModel* sectionModel,
+                     bool shouldSectionInitiallyBeOpen = true);
+
     /** Calls the refresh() method of all PropertyComponents in the panel */
     void refreshAll() const;
 
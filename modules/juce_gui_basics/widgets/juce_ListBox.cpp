@@ -154,7 +154,7 @@ public:
     {
         setWantsKeyboardFocus (false);
 
-        Component* const content = new Component();
+        Component* const content = new RowHolder (lb);
         setViewedComponent (content);
         content->setWantsKeyboardFocus (false);
     }
@@ -325,6 +325,26 @@ public:
     }
 
 private:
+    //==============================================================================
+    // This is made opaque when the list's background is, so that the viewport can scroll
+    // it by moving the pixels that are already on-screen.
+    class RowHolder  : public Component
+    {
+    public:
+        RowHolder (ListBox& lb)  : owner (lb) {}
+
+        void paint (Graphics& g) override
+        {
+            if (isOpaque())
+                g.fillAll (owner.findColour (ListBox::backgroundColourId));
+        }
+
+    private:
+        ListBox& owner;
+
+        JUCE_DECLARE_NON_COPYABLE (RowHolder)
+    };
+
     ListBox& owner;
     OwnedArray<RowComponent> rows;
     int firstIndex, firstWholeIndex, lastWholeIndex;
@@ -853,6 +873,7 @@ void ListBox::colourChanged()
 {
     setOpaque (findColour (backgroundColourId).isOpaque());
     viewport->setOpaque (isOpaque());
+    viewport->getViewedComponent()->setOpaque (isOpaque());
     repaint();
 }
 
@@ -0,0 +1,292 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+
+class TableRowSorter::SortJob  : public ThreadPoolJob
+{
+public:
+    SortJob (TableRowSorter& owner_)
+        : ThreadPoolJob ("TableRowSorter"),
+          owner (owner_), numSourceRows (0), columnId (0), forwards (true)
+    {
+    }
+
+    JobStatus runJob()
+    {
+        Array<int> result;
+        result.ensureStorageAllocated (numSourceRows);
+
+        for (int i = 0; i < numSourceRows; ++i)
+        {
+            if ((i & 1023) == 0 && shouldExit())
+                return jobHasFinished;
+
+            if (owner.source.shouldShowRow (i))
+                result.add (i);
+        }
+
+        if (columnId != 0)
+        {
+            RowComparator comparator (*this);
+            sortArray (comparator, result.getRawDataPointer(), 0, result.size() - 1, false);
+        }
+
+        if (! shouldExit())
+        {
+            const ScopedLock sl (owner.resultLock);
+            result.swapWithArray (owner.completedRows);
+            owner.hasCompletedRows = true;
+            owner.triggerAsyncUpdate();
+        }
+
+        return jobHasFinished;
+    }
+
+    TableRowSorter& owner;
+    int numSourceRows, columnId;
+    bool forwards;
+
+private:
+    struct RowComparator
+    {
+        RowComparator (SortJob& job_) noexcept  : job (job_) {}
+
+        int compareElements (const int row1, const int row2) const
+        {
+            // Once the job's been cancelled, the result will be thrown away, so this just
+            // needs to let the sort finish as quickly as possible.
+            if (! job.shouldExit())
+            {
+                const int diff = job.owner.source.compareRows (row1, row2, job.columnId);
+
+                if (diff != 0)
+                    return job.forwards ? diff : -diff;
+            }
+
+            return row1 - row2;  // (keeps equivalent rows in their original order)
+        }
+
+        SortJob& job;
+    };
+
+    JUCE_DECLARE_NON_COPYABLE (SortJob)
+};
+
+//==============================================================================
+TableRowSorter::TableRowSorter (TableListBox& t, DataSource& s, ThreadPool* poolToUse)
+    : table (t), source (s),
+      ownedPool (poolToUse == nullptr ? new ThreadPool (1) : nullptr),
+      pool (poolToUse != nullptr ? poolToUse : ownedPool.get()),
+      sortColumnId (0), sortForwards (true), hasCompletedRows (false)
+{
+    job = new SortJob (*this);
+}
+
+TableRowSorter::~TableRowSorter()
+{
+    stop();
+}
+
+//==============================================================================
+int TableRowSorter::getNumRows() const noexcept
+{
+    return rows.size();
+}
+
+int TableRowSorter::getSourceRow (const int tableRow) const noexcept
+{
+    return isPositiveAndBelow (tableRow, rows.size()) ? rows.getUnchecked (tableRow) : -1;
+}
+
+int TableRowSorter::getTableRow (const int sourceRow) const
+{
+    if (tableRowsForSourceRows.size() == 0 && rows.size() > 0)
+    {
+        int numSourceRows = 0;
+
+        for (int i = rows.size(); --i >= 0;)
+            numSourceRows = jmax (numSourceRows, rows.getUnchecked (i) + 1);
+
+        tableRowsForSourceRows.insertMultiple (0, -1, numSourceRows);
+
+        for (int i = rows.size(); --i >= 0;)
+            tableRowsForSourceRows.set (rows.getUnchecked (i), i);
+    }
+
+    return isPositiveAndBelow (sourceRow, tableRowsForSourceRows.size())
+             ? tableRowsForSourceRows.getUnchecked (sourceRow) : -1;
+}
+
+//==============================================================================
+void TableRowSorter::sortOrderChanged (const int columnId, const bool isForwards)
+{
+    sortColumnId = columnId;
+    sortForwards = isForwards;
+    startSorting();
+}
+
+void TableRowSorter::dataChanged()
+{
+    const int numSourceRows = source.getNumSourceRows();
+
+    // Until the new ordering arrives, the table mustn't be asked to show rows that have gone..
+    bool anyRemoved = false;
+
+    for (int i = rows.size(); --i >= 0;)
+    {
+        if (rows.getUnchecked (i) >= numSourceRows)
+        {
+            rows.remove (i);
+            anyRemoved = true;
+        }
+    }
+
+    if (anyRemoved)
+    {
+        tableRowsForSourceRows.clearQuick();
+        table.updateContent();
+    }
+
+    startSorting();
+}
+
+void TableRowSorter::stop()
+{
+    pool->removeJob (job, true, -1);
+
+    // any result that was finished but hasn't been shown yet may refer to old data
+    const ScopedLock sl (resultLock);
+    hasCompletedRows = false;
+    completedRows.clear();
+    cancelPendingUpdate();
+}
+
+bool TableRowSorter::isSorting() const
+{
+    return pool->contains (job);
+}
+
+void TableRowSorter::startSorting()
+{
+    stop();
+
+    job->numSourceRows = source.getNumSourceRows();
+    job->columnId = sortColumnId;
+    job->forwards = sortForwards;
+
+    pool->addJob (job, false);
+}
+
+//==============================================================================
+void TableRowSorter::handleAsyncUpdate()
+{
+    swapInCompletedRows();
+}
+
+void TableRowSorter::swapInCompletedRows()
+{
+    Array<int> newRows;
+
+    {
+        const ScopedLock sl (resultLock);
+
+        if (! hasCompletedRows)
+            return;
+
+        newRows.swapWithArray (completedRows);
+        hasCompletedRows = false;
+    }
+
+    // remember which items were selected, so that the selection can follow them..
+    const SparseSet<int> oldSelection (table.getSelectedRows());
+    Array<int> selectedSourceRows;
+
+    for (int i = 0; i < oldSelection.getNumRanges(); ++i)
+    {
+        const Range<int> range (oldSelection.getRange (i));
+
+        for (int row = range.getStart(); row < range.getEnd(); ++row)
+            if (isPositiveAndBelow (row, rows.size()))
+                selectedSourceRows.add (rows.getUnchecked (row));
+    }
+
+    // ..and which of the rows on-screen will be showing something different
+    Array<int> changedRows;
+    const int rowHeight = table.getRowHeight();
+
+    if (rowHeight > 0)
+    {
+        const Viewport* const viewport = table.getViewport();
+        const int firstVisible = viewport->getViewPositionY() / rowHeight;
+        const int lastVisible = firstVisible + 1 + viewport->getMaximumVisibleHeight() / rowHeight;
+
+        for (int row = firstVisible; row <= lastVisible; ++row)
+        {
+            const int oldSourceRow = isPositiveAndBelow (row, rows.size()) ? rows.getUnchecked (row) : -1;
+            const int newSourceRow = isPositiveAndBelow (row, newRows.size()) ? newRows.getUnchecked (row) : -1;
+
+            if (oldSourceRow != newSourceRow)
+                changedRows.add (row);
+        }
+    }
+
+    rows.swapWithArray (newRows);
+    tableRowsForSourceRows.clearQuick();
+
+    table.updateContent();
+
+    if (! oldSelection.isEmpty())
+    {
+        Array<int> newSelectedRows;
+
+        for (int i = 0; i < selectedSourceRows.size(); ++i)
+        {
+            const int row = getTableRow (selectedSourceRows.getUnchecked (i));
+
+            if (row >= 0)
+                newSelectedRows.add (row);
+        }
+
+        DefaultElementComparator<int> comparator;
+        newSelectedRows.sort (comparator);
+
+        SparseSet<int> newSelection;
+
+        for (int i = 0; i < newSelectedRows.size();)
+        {
+            const int start = newSelectedRows.getUnchecked (i);
+            int end = start + 1;
+
+            while (++i < newSelectedRows.size() && newSelectedRows.getUnchecked (i) == end)
+                ++end;
+
+            newSelection.addRange (Range<int> (start, end));
+        }
+
+        table.setSelectedRows (newSelection, dontSendNotification);
+    }
+
+    for (int i = 0; i < changedRows.size(); ++i)
+        table.repaintRow (changedRows.getUnchecked (i));
+}
@@ -0,0 +1,154 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+
+#ifndef __JUCE_TABLEROWSORTER_JUCEHEADER__
+#define __JUCE_TABLEROWSORTER_JUCEHEADER__
+
+#include "juce_TableListBox.h"
+
+
+//==============================================================================
+/**
+    Sorts and filters the rows of a TableListBox on a background thread.
+
+    Rather than rearranging your data when the user clicks on a column header, you
+    can give the table one of these: it builds an index of the rows that should be
+    shown, in sorted order, using a ThreadPool, and when it's ready, swaps it into the
+    table without changing the scroll position, keeping the same items selected and
+    only repainting the visible rows whose contents have changed.
+
+    Your TableListBoxModel should return getNumRows() from its getNumRows() method, call
+    getSourceRow() to find the data to draw for each row, and pass its sortOrderChanged()
+    callback on to the sorter's sortOrderChanged() method.
+
+    @see TableListBox, TableListBoxModel
+*/
+class JUCE_API  TableRowSorter  : private AsyncUpdater
+{
+public:
+    //==============================================================================
+    /** Provides the sorter with access to the rows being sorted.
+
+        The compareRows() and shouldShowRow() methods will be called on a background
+        thread, so the data mustn't be modified while a sort is in progress - call
+        TableRowSorter::stop() before changing it, and TableRowSorter::dataChanged()
+        afterwards.
+    */
+    class JUCE_API  DataSource
+    {
+    public:
+        /** Destructor. */
+        virtual ~DataSource() {}
+
+        /** Returns the number of rows in the underlying data.
+            This is called on the message thread when a new sort is started.
+        */
+        virtual int getNumSourceRows() = 0;
+
+        /** Compares two rows of the underlying data by the given column.
+            Should return a negative number if the first row comes before the second, a
+            positive number if it comes after it, or zero if they're equivalent.
+        */
+        virtual int compareRows (int sourceRow1, int sourceRow2, int columnId) = 0;
+
+        /** Returns true if the given row should be included in the table.
+            By default, all rows are shown.
+        */
+        virtual bool shouldShowRow (int sourceRow)      { (void) sourceRow; return true; }
+    };
+
+    //==============================================================================
+    /** Creates a sorter for a table.
+
+        If a ThreadPool is supplied, the sorting will be done on it, and it must not be deleted
+        before the sorter is. If it's nullptr, the sorter will create its own single-thread pool.
+
+        The sorter starts off with no rows - call dataChanged() once the data is ready to be
+        read (but not from the constructor of a class that is itself the DataSource).
+    */
+    TableRowSorter (TableListBox& table, DataSource& source, ThreadPool* poolToUse = nullptr);
+
+    /** Destructor. */
+    ~TableRowSorter();
+
+    //==============================================================================
+    /** Returns the number of rows that should currently be shown by the table. */
+    int getNumRows() const noexcept;
+
+    /** Returns the underlying data row that should be shown at a row of the table,
+        or -1 if the row number is out of range.
+    */
+    int getSourceRow (int tableRow) const noexcept;
+
+    /** Returns the table row at which one of the underlying data rows is being shown,
+        or -1 if it's filtered out.
+    */
+    int getTableRow (int sourceRow) const;
+
+    //==============================================================================
+    /** Starts re-sorting the rows by the given column.
+        Call this from your TableListBoxModel::sortOrderChanged() method.
+    */
+    void sortOrderChanged (int columnId, bool isForwards);
+
+    /** Re-runs the filter and sort - call this if the criteria used by
+        DataSource::shouldShowRow() change, or after the underlying data has changed.
+    */
+    void dataChanged();
+
+    /** Stops any sort that's in progress, waiting for the background thread to finish with it.
+        The table will keep showing the last completed ordering.
+    */
+    void stop();
+
+    /** Returns true if a sort is currently in progress. */
+    bool isSorting() const;
+
+private:
+    //==============================================================================
+    class SortJob;
+    friend class SortJob;
+    friend class ScopedPointer<SortJob>;
+
+    TableListBox& table;
+    DataSource& source;
+    ScopedPointer<ThreadPool> ownedPool;
+    ThreadPool* pool;
+    ScopedPointer<SortJob> job;
+    CriticalSection resultLock;
+    Array<int> rows, completedRows;
+    mutable Array<int> tableRowsForSourceRows;
+    int sortColumnId;
+    bool sortForwards, hasCompletedRows;
+
+    void startSorting();
+    void handleAsyncUpdate();
+    void swapInCompletedRows();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TableRowSorter)
+};
+
+
+#endif   // __JUCE_TABLEROWSORTER_JUCEHEADER__
@@ -108,13 +108,7 @@ public:
                 }
             }
 
-            atoms.ensureStorageAllocated (atoms.size() + other.atoms.size() - i);
-
-            while (i < other.atoms.size())
-            {
-                atoms.add (other.atoms.getUnchecked(i));
-                ++i;
-            }
+            atoms.addArray (other.atoms, i);
         }
     }
 
@@ -131,12 +125,8 @@ public:
 
             if (index == indexToBreakAt)
             {
-                for (int j = i; j < atoms.size(); ++j)
-                    section2->atoms.add (atoms.getUnchecked (j));
-
-                for (int j = atoms.size(); --j >= i;)
-                    atoms.remove (j);
-
+                section2->atoms.addArray (atoms, i);
+                atoms.removeRange (i, atoms.size());
                 break;
             }
             else if (indexToBreakAt >= index && indexToBreakAt < nextIndex)
@@ -153,12 +143,8 @@ public:
                 atom->width = font.getStringWidthFloat (atom->getText (passwordChar));
                 atom->numChars = (uint16) (indexToBreakAt - index);
 
-                for (int j = i + 1; j < atoms.size(); ++j)
-                    section2->atoms.add (atoms.getUnchecked (j));
-
-                for (int j = atoms.size(); --j > i;)
-                    atoms.remove (j);
-
+                section2->atoms.addArray (atoms, i + 1);
+                atoms.removeRange (i + 1, atoms.size());
                 break;
             }
 
@@ -337,6 +323,53 @@ public:
     {
     }
 
+    //==============================================================================
+    /** A snapshot of the iterator's state just after it has stepped over a line-break,
+        from which the layout of the next paragraph can be resumed.
+    */
+    struct ParagraphStart
+    {
+        int getIndex() const noexcept   { return indexInText + atom->numChars; }
+        float getY() const noexcept     { return lineY + lineHeight; }
+
+        int indexInText, sectionIndex, atomIndex;
+        float lineY, lineHeight, maxDescent, atomX, atomRight;
+        float maxWidth; // the right-hand edge of the widest line in the paragraph that ends here
+        const TextAtom* atom;
+        const UniformTextSection* currentSection;
+    };
+
+    Iterator (const Array <UniformTextSection*>& sectionList,
+              const float wrapWidth,
+              const juce_wchar passwordChar,
+              const ParagraphStart& start)
+      : indexInText (start.indexInText),
+        lineY (start.lineY),
+        lineHeight (start.lineHeight),
+        maxDescent (start.maxDescent),
+        atomX (start.atomX),
+        atomRight (start.atomRight),
+        atom (start.atom),
+        currentSection (start.currentSection),
+        sections (sectionList),
+        sectionIndex (start.sectionIndex),
+        atomIndex (start.atomIndex),
+        wordWrapWidth (wrapWidth),
+        passwordCharacter (passwordChar)
+    {
+        jassert (wordWrapWidth > 0);
+    }
+
+    ParagraphStart getParagraphStart() const noexcept
+    {
+        jassert (atom != nullptr && atom->isNewLine());
+
+        const ParagraphStart p = { indexInText, sectionIndex, atomIndex,
+                                   lineY, lineHeight, maxDescent, atomX, atomRight, 0.0f,
+                                   atom, currentSection };
+        return p;
+    }
+
     //==============================================================================
     bool next()
     {
@@ -718,6 +751,233 @@ private:
     JUCE_LEAK_DETECTOR (Iterator)
 };
 
+//==============================================================================
+// Remembers where each paragraph starts in the laid-out text, so that lookups and
+// painting can resume the layout from the nearest line-break rather than from the
+// top, and an edit only needs to re-wrap the paragraphs that it actually touched.
+class TextEditor::LayoutCache
+{
+public:
+    LayoutCache (const Array <UniformTextSection*>& sectionList)
+        : sections (sectionList),
+          numValidParagraphs (0),
+          pendingIndexOffset (0),
+          wordWrapWidth (0),
+          passwordCharacter (0),
+          isComplete (false),
+          maxWidth (0),
+          totalHeight (0),
+          lastParagraphWidth (0)
+    {
+    }
+
+    void clear() noexcept
+    {
+        paragraphs.clearQuick();
+        numValidParagraphs = 0;
+        isComplete = false;
+    }
+
+    void update (const float wrapWidth, const juce_wchar passwordChar)
+    {
+        jassert (wrapWidth > 0);
+
+        if (wordWrapWidth != wrapWidth || passwordCharacter != passwordChar)
+        {
+            wordWrapWidth = wrapWidth;
+            passwordCharacter = passwordChar;
+            clear();
+        }
+
+        if (! isComplete)
+            layOutRemainingParagraphs();
+    }
+
+    float getMaxWidth() const noexcept      { return maxWidth; }
+    float getTotalHeight() const noexcept   { return totalHeight; }
+
+    /** Returns an iterator which will reach the atom containing this index before
+        any other atom that could contain it. */
+    Iterator getIteratorForIndex (const int index) const
+    {
+        jassert (isComplete);
+        return createIterator (getNumParagraphsStartingAtOrBefore (index) - 1);
+    }
+
+    /** Returns an iterator whose lines all lie at or below the one containing this y position. */
+    Iterator getIteratorForY (const float y) const
+    {
+        jassert (isComplete);
+
+        int start = 0, end = paragraphs.size();
+
+        while (start < end)
+        {
+            const int mid = (start + end) / 2;
+
+            if (paragraphs.getReference (mid).getY() < y)
+                start = mid + 1;
+            else
+                end = mid;
+        }
+
+        return createIterator (start - 1);
+    }
+
+    //==============================================================================
+    /** Must be called before the sections are modified in a way that could affect the
+        given range of characters, and followed by a call to textChanged() once done.
+
+        Paragraphs that start before the range are kept as they are, and those beyond the
+        paragraph following it are left in place to be shifted by the next update(), once
+        it has re-wrapped the ones in between.
+    */
+    void textChanging (const Range<int> range)
+    {
+        if (wordWrapWidth <= 0 || (paragraphs.size() == 0 && ! isComplete))
+            return; // (nothing has been laid out yet)
+
+        if (! isComplete)
+            layOutRemainingParagraphs();
+
+        const int numToKeep = getNumParagraphsStartingAtOrBefore (range.getStart());
+        const int firstToReuse = jmin (paragraphs.size(), getNumParagraphsStartingAtOrBefore (range.getEnd()) + 1);
+
+        paragraphs.removeRange (numToKeep, firstToReuse - numToKeep);
+        numValidParagraphs = numToKeep;
+        pendingIndexOffset = 0;
+        isComplete = false;
+    }
+
+    void textChanged (const int numCharsAdded) noexcept
+    {
+        pendingIndexOffset += numCharsAdded;
+    }
+
+private:
+    const Array <UniformTextSection*>& sections;
+    Array <Iterator::ParagraphStart> paragraphs;
+    int numValidParagraphs, pendingIndexOffset;
+    float wordWrapWidth;
+    juce_wchar passwordCharacter;
+    bool isComplete;
+    float maxWidth, totalHeight, lastParagraphWidth;
+
+    Iterator createIterator (const int paragraphIndex) const
+    {
+        if (isPositiveAndBelow (paragraphIndex, paragraphs.size()))
+            return Iterator (sections, wordWrapWidth, passwordCharacter, paragraphs.getReference (paragraphIndex));
+
+        return Iterator (sections, wordWrapWidth, passwordCharacter);
+    }
+
+    int getNumParagraphsStartingAtOrBefore (const int index) const noexcept
+    {
+        int start = 0, end = paragraphs.size();
+
+        while (start < end)
+        {
+            const int mid = (start + end) / 2;
+
+            if (paragraphs.getReference (mid).getIndex() <= index)
+                start = mid + 1;
+            else
+                end = mid;
+        }
+
+        return start;
+    }
+
+    void layOutRemainingParagraphs()
+    {
+        Iterator i (createIterator (numValidParagraphs - 1));
+        Array <Iterator::ParagraphStart> newParagraphs;
+        float paragraphWidth = 0;
+
+        while (i.next())
+        {
+            paragraphWidth = jmax (paragraphWidth, i.atomRight);
+
+            if (i.atom->isNewLine())
+            {
+                Iterator::ParagraphStart p (i.getParagraphStart());
+                p.maxWidth = paragraphWidth;
+                paragraphWidth = 0;
+
+                if (numValidParagraphs < paragraphs.size() && reusePendingParagraphs (p, newParagraphs))
+                    return;
+
+                newParagraphs.add (p);
+            }
+        }
+
+        paragraphs.removeRange (numValidParagraphs, paragraphs.size());
+        paragraphs.addArray (newParagraphs);
+        finishLayout (i.lineY + i.lineHeight, paragraphWidth);
+    }
+
+    bool reusePendingParagraphs (const Iterator::ParagraphStart& p,
+                                 Array <Iterator::ParagraphStart>& newParagraphs)
+    {
+        Iterator::ParagraphStart& first = paragraphs.getReference (numValidParagraphs);
+        const int expectedIndex = first.indexInText + pendingIndexOffset;
+
+        if (p.indexInText > expectedIndex)
+        {
+            // the edit must have changed the text in a way that can't be matched up..
+            paragraphs.removeRange (numValidParagraphs, paragraphs.size());
+            return false;
+        }
+
+        if (p.atom != first.atom || p.indexInText != expectedIndex)
+            return false;
+
+        // The layout of everything from here onwards is unchanged, apart from its position.
+        // Any section that was split or merged by the edit can only be the one that this
+        // paragraph ended in, so the atoms that follow it in there get renumbered to match.
+        const float yOffset = p.lineY - first.lineY;
+        const int sectionOffset = p.sectionIndex - first.sectionIndex;
+        const int atomOffset = p.atomIndex - first.atomIndex;
+        const UniformTextSection* const oldSection = first.currentSection;
+
+        first = p;
+
+        for (int j = numValidParagraphs + 1; j < paragraphs.size(); ++j)
+        {
+            Iterator::ParagraphStart& ps = paragraphs.getReference (j);
+
+            if (ps.currentSection == oldSection)
+            {
+                ps.currentSection = p.currentSection;
+                ps.atomIndex += atomOffset;
+            }
+
+            ps.indexInText += pendingIndexOffset;
+            ps.sectionIndex += sectionOffset;
+            ps.lineY += yOffset;
+        }
+
+        paragraphs.insertArray (numValidParagraphs, newParagraphs.getRawDataPointer(), newParagraphs.size());
+        finishLayout (totalHeight + yOffset, lastParagraphWidth);
+        return true;
+    }
+
+    void finishLayout (const float height, const float lastWidth)
+    {
+        numValidParagraphs = paragraphs.size();
+        totalHeight = height;
+        lastParagraphWidth = lastWidth;
+        maxWidth = lastWidth;
+
+        for (int i = paragraphs.size(); --i >= 0;)
+            maxWidth = jmax (maxWidth, paragraphs.getReference (i).maxWidth);
+
+        isComplete = true;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (LayoutCache)
+};
+
 
 //==============================================================================
 class TextEditor::InsertAction  : public UndoableAction
@@ -946,6 +1206,7 @@ TextEditor::TextEditor (const String& name,
       currentFont (14.0f),
       totalNumChars (0),
       caretPosition (0),
+      layoutCache (new LayoutCache (sections)),
       passwordCharacter (passwordChar),
       dragType (notDragging)
 {
@@ -1095,6 +1356,7 @@ void TextEditor::applyFontToAllText (const Font& newFont)
     }
 
     coalesceSimilarSections();
+    layoutCache->clear();
     updateTextHolderSize();
     scrollToMakeSureCursorIsVisible();
     repaint();
@@ -1291,7 +1553,8 @@ void TextEditor::repaintText (const Range<int> range)
 
         if (wordWrapWidth > 0)
         {
-            Iterator i (sections, wordWrapWidth, passwordCharacter);
+            layoutCache->update (wordWrapWidth, passwordCharacter);
+            Iterator i (layoutCache->getIteratorForIndex (range.getStart()));
 
             i.getCharPosition (range.getStart(), x, y, lh);
 
@@ -1404,15 +1667,10 @@ void TextEditor::updateTextHolderSize()
 
     if (wordWrapWidth > 0)
     {
-        float maxWidth = 0.0f;
-
-        Iterator i (sections, wordWrapWidth, passwordCharacter);
-
-        while (i.next())
-            maxWidth = jmax (maxWidth, i.atomRight);
+        layoutCache->update (wordWrapWidth, passwordCharacter);
 
-        const int w = leftIndent + roundToInt (maxWidth);
-        const int h = topIndent + roundToInt (jmax (i.lineY + i.lineHeight,
+        const int w = leftIndent + roundToInt (layoutCache->getMaxWidth());
+        const int h = topIndent + roundToInt (jmax (layoutCache->getTotalHeight(),
                                                     currentFont.getHeight()));
 
         textHolder->setSize (w + rightEdgeSpace, h + 1); // (allows a bit of space for the cursor to be at the right-hand-edge)
@@ -1610,7 +1868,8 @@ void TextEditor::drawContent (Graphics& g)
         const Rectangle<int> clip (g.getClipBounds());
         Colour selectedTextColour;
 
-        Iterator i (sections, wordWrapWidth, passwordCharacter);
+        layoutCache->update (wordWrapWidth, passwordCharacter);
+        Iterator i (layoutCache->getIteratorForY ((float) clip.getY()));
 
         while (i.lineY + 200.0 < clip.getY() && i.next())
         {}
@@ -1655,7 +1914,7 @@ void TextEditor::drawContent (Graphics& g)
         {
             const Range<int> underlinedSection = underlinedSections.getReference (j);
 
-            Iterator i2 (sections, wordWrapWidth, passwordCharacter);
+            Iterator i2 (layoutCache->getIteratorForY ((float) clip.getY()));
 
             while (i2.next() && i2.lineY < clip.getBottom())
             {
@@ -2201,6 +2460,9 @@ void TextEditor::insert (const String& text,
             repaintText (Range<int> (insertIndex, getTotalNumChars())); // must do this before and after changing the data, in case
                                                                         // a line gets moved due to word wrap
 
+            const int oldNumChars = getTotalNumChars();
+            layoutCache->textChanging (Range<int> (insertIndex, insertIndex));
+
             int index = 0;
             int nextIndex = 0;
 
@@ -2229,6 +2491,7 @@ void TextEditor::insert (const String& text,
             coalesceSimilarSections();
             totalNumChars = -1;
             valueTextNeedsUpdating = true;
+            layoutCache->textChanged (getTotalNumChars() - oldNumChars);
 
             updateTextHolderSize();
             moveCaretTo (caretPositionToMoveTo, false);
@@ -2241,6 +2504,9 @@ void TextEditor::insert (const String& text,
 void TextEditor::reinsert (const int insertIndex,
                            const Array <UniformTextSection*>& sectionsToInsert)
 {
+    const int oldNumChars = getTotalNumChars();
+    layoutCache->textChanging (Range<int> (insertIndex, insertIndex));
+
     int index = 0;
     int nextIndex = 0;
 
@@ -2277,6 +2543,7 @@ void TextEditor::reinsert (const int insertIndex,
     coalesceSimilarSections();
     totalNumChars = -1;
     valueTextNeedsUpdating = true;
+    layoutCache->textChanged (getTotalNumChars() - oldNumChars);
 }
 
 void TextEditor::remove (Range<int> range,
@@ -2285,6 +2552,9 @@ void TextEditor::remove (Range<int> range,
 {
     if (! range.isEmpty())
     {
+        const int oldNumChars = getTotalNumChars();
+        layoutCache->textChanging (range); // (splitting the sections renumbers them, even if nothing is removed yet)
+
         int index = 0;
 
         for (int i = 0; i < sections.size(); ++i)
@@ -2331,6 +2601,8 @@ void TextEditor::remove (Range<int> range,
                 index = nextIndex;
             }
 
+            layoutCache->textChanged (0);
+
             if (um->getNumActionsInCurrentTransaction() > TextEditorDefs::maxActionsPerTransaction)
                 newTransaction();
 
@@ -2368,6 +2640,7 @@ void TextEditor::remove (Range<int> range,
             coalesceSimilarSections();
             totalNumChars = -1;
             valueTextNeedsUpdating = true;
+            layoutCache->textChanged (getTotalNumChars() - oldNumChars);
 
             moveCaretTo (caretPositionToMoveTo, false);
 
@@ -2446,7 +2719,8 @@ void TextEditor::getCharPosition (const int index, float& cx, float& cy, float&
 
     if (wordWrapWidth > 0 && sections.size() > 0)
     {
-        Iterator i (sections, wordWrapWidth, passwordCharacter);
+        layoutCache->update (wordWrapWidth, passwordCharacter);
+        Iterator i (layoutCache->getIteratorForIndex (index));
 
         i.getCharPosition (index, cx, cy, lineHeight);
     }
@@ -2463,7 +2737,8 @@ int TextEditor::indexAtPosition (const float x, const float y)
 
     if (wordWrapWidth > 0)
     {
-        Iterator i (sections, wordWrapWidth, passwordCharacter);
+        layoutCache->update (wordWrapWidth, passwordCharacter);
+        Iterator i (layoutCache->getIteratorForY (y));
 
         while (i.next())
         {
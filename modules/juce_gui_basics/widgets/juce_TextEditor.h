@@ -642,6 +642,7 @@ protected:
 private:
     //==============================================================================
     class Iterator;
+    class LayoutCache;
     JUCE_PUBLIC_IN_DLL_BUILD (class UniformTextSection)
     class TextHolderComponent;
     class InsertAction;
@@ -676,6 +677,7 @@ private:
     mutable int totalNumChars;
     int caretPosition;
     Array <UniformTextSection*> sections;
+    ScopedPointer<LayoutCache> layoutCache;
     String textToShowWhenEmpty;
     Colour colourForTextWhenEmpty;
     juce_wchar passwordCharacter;
@@ -181,6 +181,15 @@ public:
             TreeViewItem* item = owner.rootItem;
             int y = (item != nullptr && ! owner.rootItemVisible) ? -item->itemHeight : 0;
 
+            // if the layout's current, we can jump straight to the first row that's on-screen
+            if (item != nullptr && ! owner.needsRecalculating && visibleTop > y)
+            {
+                item = item->findItemRecursively (visibleTop - 1 - y);
+
+                if (item != nullptr)
+                    y = item->y;
+            }
+
             while (item != nullptr && y < visibleBottom)
             {
                 y += item->itemHeight;
@@ -842,7 +851,7 @@ void TreeView::recalculateIfNeeded()
         const ScopedLock sl (nodeAlterationLock);
 
         if (rootItem != nullptr)
-            rootItem->updatePositions (rootItemVisible ? 0 : -rootItem->itemHeight);
+            rootItem->updatePositions (rootItemVisible ? 0 : -rootItem->itemHeight, 0);
 
         viewport->updateComponents (false);
 
@@ -1125,6 +1134,9 @@ TreeViewItem::TreeViewItem()
       totalHeight (0),
       itemWidth (0),
       totalWidth (0),
+      row (0),
+      totalRows (1),
+      indexInParent (0),
       selected (false),
       redrawNeeded (true),
       drawLinesInside (true),
@@ -1417,30 +1429,81 @@ bool TreeViewItem::areAllParentsOpen() const noexcept
             || (parentItem->isOpen() && parentItem->areAllParentsOpen());
 }
 
-void TreeViewItem::updatePositions (int newY)
+void TreeViewItem::updatePositions (int newY, int newRow)
 {
     y = newY;
+    row = newRow;
     itemHeight = getItemHeight();
     totalHeight = itemHeight;
+    totalRows = 1;
     itemWidth = getItemWidth();
     totalWidth = jmax (itemWidth, 0) + getIndentX();
 
     if (isOpen())
     {
         newY += totalHeight;
+        ++newRow;
 
         for (int i = 0; i < subItems.size(); ++i)
         {
             TreeViewItem* const ti = subItems.getUnchecked(i);
 
-            ti->updatePositions (newY);
+            ti->indexInParent = i;
+            ti->updatePositions (newY, newRow);
             newY += ti->totalHeight;
+            newRow += ti->totalRows;
             totalHeight += ti->totalHeight;
+            totalRows += ti->totalRows;
             totalWidth = jmax (totalWidth, ti->totalWidth);
         }
     }
 }
 
+/*  The y, row and total values that updatePositions() leaves in each visible item act as
+    prefix sums over their siblings, so while they're up-to-date, finding the item at a
+    position or row is a binary search at each level rather than a walk over the tree.
+*/
+bool TreeViewItem::hasUpToDateLayout() const noexcept
+{
+    return ownerView != nullptr
+            && ! ownerView->needsRecalculating
+            && areAllParentsOpen();
+}
+
+int TreeViewItem::findSubItemIndexAt (const int absoluteY) const noexcept
+{
+    int start = 0, end = subItems.size();
+
+    while (end - start > 1)
+    {
+        const int mid = (start + end) / 2;
+
+        if (subItems.getUnchecked (mid)->y <= absoluteY)
+            start = mid;
+        else
+            end = mid;
+    }
+
+    return start;
+}
+
+int TreeViewItem::findSubItemIndexForRow (const int absoluteRow) const noexcept
+{
+    int start = 0, end = subItems.size();
+
+    while (end - start > 1)
+    {
+        const int mid = (start + end) / 2;
+
+        if (subItems.getUnchecked (mid)->row <= absoluteRow)
+            start = mid;
+        else
+            end = mid;
+    }
+
+    return start;
+}
+
 TreeViewItem* TreeViewItem::getDeepestOpenParentItem() noexcept
 {
     TreeViewItem* result = this;
@@ -1562,7 +1625,7 @@ void TreeViewItem::paintRecursively (Graphics& g, int width)
     {
         const Rectangle<int> clip (g.getClipBounds());
 
-        for (int i = 0; i < subItems.size(); ++i)
+        for (int i = findSubItemIndexAt (y + clip.getY()); i < subItems.size(); ++i)
         {
             TreeViewItem* const ti = subItems.getUnchecked(i);
 
@@ -1592,8 +1655,14 @@ bool TreeViewItem::isLastOfSiblings() const noexcept
 
 int TreeViewItem::getIndexInParent() const noexcept
 {
-    return parentItem == nullptr ? 0
-                                 : parentItem->subItems.indexOf (this);
+    if (parentItem == nullptr)
+        return 0;
+
+    // the index cached by the last layout is usually still right..
+    if (parentItem->subItems [indexInParent] == this)
+        return indexInParent;
+
+    return parentItem->subItems.indexOf (this);
 }
 
 TreeViewItem* TreeViewItem::getTopLevelItem() noexcept
@@ -1604,6 +1673,9 @@ TreeViewItem* TreeViewItem::getTopLevelItem() noexcept
 
 int TreeViewItem::getNumRows() const noexcept
 {
+    if (hasUpToDateLayout())
+        return totalRows;
+
     int num = 1;
 
     if (isOpen())
@@ -1622,6 +1694,16 @@ TreeViewItem* TreeViewItem::getItemOnRow (int index) noexcept
 
     if (index > 0 && isOpen())
     {
+        if (hasUpToDateLayout())
+        {
+            if (index >= totalRows || subItems.size() == 0)
+                return nullptr;
+
+            const int targetRow = row + index;
+            TreeViewItem* const item = subItems.getUnchecked (findSubItemIndexForRow (targetRow));
+            return item->getItemOnRow (targetRow - item->row);
+        }
+
         --index;
 
         for (int i = 0; i < subItems.size(); ++i)
@@ -1652,19 +1734,11 @@ TreeViewItem* TreeViewItem::findItemRecursively (int targetY) noexcept
         if (targetY < h)
             return this;
 
-        if (isOpen())
+        if (isOpen() && subItems.size() > 0)
         {
-            targetY -= h;
-
-            for (int i = 0; i < subItems.size(); ++i)
-            {
-                TreeViewItem* const ti = subItems.getUnchecked(i);
-
-                if (targetY < ti->totalHeight)
-                    return ti->findItemRecursively (targetY);
-
-                targetY -= ti->totalHeight;
-            }
+            const int absoluteY = y + targetY;
+            TreeViewItem* const ti = subItems.getUnchecked (findSubItemIndexAt (absoluteY));
+            return ti->findItemRecursively (absoluteY - ti->y);
         }
     }
 
@@ -1712,9 +1786,12 @@ int TreeViewItem::getRowNumberInTree() const noexcept
 {
     if (parentItem != nullptr && ownerView != nullptr)
     {
+        if (hasUpToDateLayout())
+            return ownerView->rootItemVisible ? row : row - 1;
+
         int n = 1 + parentItem->getRowNumberInTree();
 
-        int ourIndex = parentItem->subItems.indexOf (this);
+        int ourIndex = getIndexInParent();
         jassert (ourIndex >= 0);
 
         while (--ourIndex >= 0)
@@ -1742,7 +1819,7 @@ TreeViewItem* TreeViewItem::getNextVisibleItem (const bool recurse) const noexce
 
     if (parentItem != nullptr)
     {
-        const int nextIndex = parentItem->subItems.indexOf (this) + 1;
+        const int nextIndex = getIndexInParent() + 1;
 
         if (nextIndex >= parentItem->subItems.size())
             return parentItem->getNextVisibleItem (false);
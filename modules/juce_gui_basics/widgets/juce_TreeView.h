@@ -524,6 +524,7 @@ private:
     TreeViewItem* parentItem;
     OwnedArray <TreeViewItem> subItems;
     int y, itemHeight, totalHeight, itemWidth, totalWidth;
+    int row, totalRows, indexInParent;
     int uid;
     bool selected           : 1;
     bool redrawNeeded       : 1;
@@ -533,7 +534,10 @@ private:
 
     friend class TreeView;
 
-    void updatePositions (int newY);
+    void updatePositions (int newY, int newRow);
+    bool hasUpToDateLayout() const noexcept;
+    int findSubItemIndexAt (int absoluteY) const noexcept;
+    int findSubItemIndexForRow (int absoluteRow) const noexcept;
     int getIndentX() const noexcept;
     void setOwnerView (TreeView*) noexcept;
     void paintRecursively (Graphics&, int width);
@@ -32,6 +32,7 @@ ComponentPeer::ComponentPeer (Component& comp, const int flags)
       constrainer (nullptr),
       lastDragAndDropCompUnderMouse (nullptr),
       uniqueID (lastUniqueID += 2), // increment by 2 so that this can never hit 0
+      creationTicks (Time::getHighResolutionTicks()),
       fakeMouseMessageSent (false),
       isWindowMinimised (false)
 {
@@ -122,18 +123,35 @@ void ComponentPeer::handleMagnifyGesture (const int touchIndex, const Point<int>
 //==============================================================================
 void ComponentPeer::handlePaint (LowLevelGraphicsContext& contextToPaintTo)
 {
+    JUCE_TRACE_SCOPE_WITH_ID ("Window paint", (int) uniqueID);
     Graphics g (&contextToPaintTo);
 
    #if JUCE_ENABLE_REPAINT_DEBUGGING
     g.saveState();
    #endif
 
+    if (paintScheduler != nullptr)
+        paintScheduler->paintStarted();
+
     JUCE_TRY
     {
         component.paintEntireComponent (g, true);
     }
     JUCE_CATCH_EXCEPTION
 
+    if (paintScheduler != nullptr)
+        paintScheduler->paintFinished();
+
+   #if JUCE_ENABLE_TRACING
+    // records the time from the window's creation until it first had something on
+    // screen, which is how long the user spent looking at an empty window
+    if (creationTicks != 0)
+    {
+        TraceLog::addCompleteEvent ("Window startup", creationTicks, Time::getHighResolutionTicks(), (int) uniqueID);
+        creationTicks = 0;
+    }
+   #endif
+
    #if JUCE_ENABLE_REPAINT_DEBUGGING
     // enabling this code will fill all areas that get repainted with a colour overlay, to show
     // clearly when things are being repainted.
@@ -580,6 +598,123 @@ void ComponentPeer::addMaskedRegion (const Rectangle<int>& area)
     maskedRegion.add (area);
 }
 
+//==============================================================================
+bool ComponentPeer::moveComponentByScrolling (Component& comp, const Point<int>& newPosition)
+{
+    const Component* const parent = comp.getParentComponent();
+
+    if (parent == nullptr || newPosition == comp.getPosition() || ! comp.isOpaque())
+        return false;
+
+    // the component has to cover its parent both before and after moving, or else some of
+    // the parent's background would get dragged along with it
+    const Rectangle<int> parentArea (parent->getLocalBounds());
+
+    if (! (comp.getBounds().contains (parentArea)
+            && comp.getBounds().withPosition (newPosition).contains (parentArea)))
+        return false;
+
+    Rectangle<int> area;
+
+    if (! (findScrollableArea (comp, comp.getLocalBounds(), area)
+            && scrollWindowArea (area, newPosition - comp.getPosition())))
+        return false;
+
+    comp.flags.movedByScrollingFlag = true;
+    comp.setTopLeftPosition (newPosition.x, newPosition.y);
+    return true;
+}
+
+bool ComponentPeer::scrollComponentArea (Component& comp, const Rectangle<int>& area, const Point<int>& delta)
+{
+    Rectangle<int> windowArea;
+
+    if (! (comp.isOpaque()
+            && findScrollableArea (comp, area, windowArea)
+            && scrollWindowArea (windowArea, delta)))
+        return false;
+
+    // any children will have been dragged along with the pixels, so need repainting both
+    // where they are and where their old image has ended up
+    for (int i = comp.getNumChildComponents(); --i >= 0;)
+    {
+        const Component& child = *comp.getChildComponent (i);
+
+        if (child.isVisible())
+        {
+            const Rectangle<int> childArea (child.getBoundsInParent());
+
+            comp.repaint (childArea.getIntersection (area));
+            comp.repaint ((childArea + delta).getIntersection (area));
+        }
+    }
+
+    return true;
+}
+
+bool ComponentPeer::findScrollableArea (const Component& comp, const Rectangle<int>& areaInComp,
+                                        Rectangle<int>& result) const
+{
+    if (isMinimised())
+        return false;
+
+    Rectangle<int> area (areaInComp.getIntersection (comp.getLocalBounds()));
+
+    for (const Component* c = &comp;; c = c->getParentComponent())
+    {
+        // anything that's drawn through a transform, an effect, a cached image or with some
+        // transparency could be affected by pixels that aren't being moved
+        if (c == nullptr || ! c->isVisible() || c->isTransformed() || c->componentTransparency != 0
+             || c->getComponentEffect() != nullptr || c->cachedImage != nullptr)
+            return false;
+
+        if (c == &component)
+            break;
+
+        const Component& parent = *c->getParentComponent();
+        area = (area + c->getPosition()).getIntersection (parent.getLocalBounds());
+
+        // ..and anything in front of the area might be painted over it
+        for (int i = parent.getIndexOfChildComponent (c); ++i < parent.getNumChildComponents();)
+        {
+            const Component& sibling = *parent.getChildComponent (i);
+
+            if (sibling.isVisible()
+                 && (sibling.flags.dontClipGraphicsFlag || sibling.getBoundsInParent().intersects (area)))
+                return false;
+        }
+    }
+
+    result = area;
+    return ! area.isEmpty();
+}
+
+bool ComponentPeer::scrollWindowArea (const Rectangle<int>& area, const Point<int>& delta)
+{
+    const Rectangle<int> destArea (area.getIntersection (area + delta));
+
+    if (destArea.isEmpty() || delta.isOrigin() || maskedRegion.intersectsRectangle (area)
+         || ! copyWindowArea (destArea - delta, delta))
+        return false;
+
+    // (any areas that were waiting to be repainted will have had their old pixels moved too)
+    if (paintScheduler != nullptr)
+        paintScheduler->areaScrolled (area, delta);
+
+    RectangleList uncoveredArea (area);
+    uncoveredArea.subtract (destArea);
+
+    for (const Rectangle<int>* i = uncoveredArea.begin(), * const e = uncoveredArea.end(); i != e; ++i)
+        repaint (*i);
+
+    return true;
+}
+
+bool ComponentPeer::copyWindowArea (const Rectangle<int>&, const Point<int>&)
+{
+    return false;
+}
+
 //==============================================================================
 StringArray ComponentPeer::getAvailableRenderingEngines()       { return StringArray ("Software Renderer"); }
 int ComponentPeer::getCurrentRenderingEngine() const            { return 0; }
@@ -28,6 +28,7 @@
 #include "../components/juce_Component.h"
 #include "../mouse/juce_MouseCursor.h"
 #include "../keyboard/juce_TextInputTarget.h"
+class PaintScheduler;
 
 class ComponentBoundsConstrainer;
 
@@ -315,6 +316,40 @@ public:
     bool handleDragExit (const DragInfo&);
     bool handleDragDrop (const DragInfo&);
 
+    //==============================================================================
+    /** Returns the object that this peer uses to schedule its repaints, if it has one.
+
+        Peers on platforms that support it use a PaintScheduler to merge all the repaint
+        requests that their components make, and to paint them at a fixed frame rate. You
+        can use this to change the frame rate or the way the areas are merged, or to find
+        out how many frames are being dropped. On platforms that don't use one, this returns
+        nullptr.
+    */
+    PaintScheduler* getPaintScheduler() const noexcept          { return paintScheduler; }
+
+    //==============================================================================
+    /** Moves a component by shifting the pixels it has already drawn, rather than repainting it.
+
+        Viewport uses this when it scrolls, so that only the strip that gets uncovered has to
+        be painted. It can only be done if the component is opaque and fills its parent, and if
+        nothing else in the window can be drawn over the parent. If that's not the case, or the
+        platform can't copy its window's pixels, this returns false without doing anything, and
+        the caller should just move the component in the normal way.
+    */
+    bool moveComponentByScrolling (Component& componentToMove, const Point<int>& newPosition);
+
+    /** Shifts the pixels that an opaque component has drawn within an area of itself, and
+        repaints the strip that gets uncovered.
+
+        A component that scrolls its own content can call this instead of repainting the whole
+        area - it should be called before the component changes what it's going to draw, so
+        that the pixels being moved are still correct. Any child components that overlap the
+        area are repainted. As with
+        moveComponentByScrolling(), this returns false if it can't be done safely, and in that
+        case the component will need to repaint the area itself.
+    */
+    bool scrollComponentArea (Component& comp, const Rectangle<int>& area, const Point<int>& delta);
+
     //==============================================================================
     /** Resets the masking region.
         The subclass should call this every time it's about to call the handlePaint method.
@@ -364,16 +399,29 @@ protected:
     RectangleList maskedRegion;
     Rectangle<int> lastNonFullscreenBounds;
     ComponentBoundsConstrainer* constrainer;
+    ScopedPointer<PaintScheduler> paintScheduler;
 
     static void updateCurrentModifiers() noexcept;
 
+    /** Copies an area of the window's pixels by the given offset, for scrolling.
+
+        Peers that can do this should override it and return true; the default just returns
+        false. If parts of the source area aren't available (e.g. because they're covered by
+        another window), the peer must make sure they get repainted at their new position. The
+        caller takes care of repainting the strip that's uncovered.
+    */
+    virtual bool copyWindowArea (const Rectangle<int>& sourceArea, const Point<int>& delta);
+
 private:
     //==============================================================================
     WeakReference<Component> lastFocusedComponent, dragAndDropTargetComponent;
     Component* lastDragAndDropCompUnderMouse;
     const uint32 uniqueID;
+    int64 creationTicks;
     bool fakeMouseMessageSent, isWindowMinimised;
     Component* getTargetForKeyPress();
+    bool findScrollableArea (const Component&, const Rectangle<int>&, Rectangle<int>&) const;
+    bool scrollWindowArea (const Rectangle<int>&, const Point<int>&);
     static MouseInputSource* getOrCreateMouseInputSource (int);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ComponentPeer)
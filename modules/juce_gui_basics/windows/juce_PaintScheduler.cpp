@@ -0,0 +1,192 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+PaintScheduler::Statistics::Statistics() noexcept
+    : numFramesPainted (0), numFramesDropped (0),
+      lastPaintTimeMs (0), averagePaintTimeMs (0), worstPaintTimeMs (0)
+{
+}
+
+//==============================================================================
+PaintScheduler::PaintScheduler (Target& t)
+    : target (t),
+      mergeStrategy (consolidateWhenFragmented),
+      maxRectangles (16),
+      framePeriodMs (1000.0 / 60.0),
+      frameBudgetMs (0),
+      lastFrameTime (0),
+      paintStartTime (0),
+      totalPaintTimeMs (0),
+      paintDepth (0)
+{
+}
+
+PaintScheduler::~PaintScheduler()
+{
+}
+
+//==============================================================================
+void PaintScheduler::invalidate (const Rectangle<int>& area)
+{
+    if (! area.isEmpty())
+    {
+        pendingRegion.add (area);
+
+        if (! isTimerRunning())
+            startTimerForNextFrame();
+    }
+}
+
+bool PaintScheduler::isRepaintPending() const noexcept
+{
+    return ! pendingRegion.isEmpty();
+}
+
+void PaintScheduler::flush()
+{
+    if (! pendingRegion.isEmpty())
+    {
+        mergeRegion();
+
+        // (the region is cleared first, so that any repaints that the target triggers
+        // while it's painting will be kept for the next frame)
+        RectangleList region;
+        region.swapWith (pendingRegion);
+
+        if (! target.flushRepaintRegion (region))
+        {
+            region.add (pendingRegion);
+            region.swapWith (pendingRegion);
+        }
+    }
+
+    if (pendingRegion.isEmpty())
+        stopTimer();
+    else
+        startTimerForNextFrame();
+}
+
+void PaintScheduler::areaScrolled (const Rectangle<int>& area, const Point<int>& delta)
+{
+    RectangleList movedRegion (pendingRegion);
+
+    if (movedRegion.clipTo (area))
+    {
+        movedRegion.offsetAll (delta.x, delta.y);
+        movedRegion.clipTo (area);
+        pendingRegion.add (movedRegion);
+    }
+}
+
+void PaintScheduler::timerCallback()
+{
+    lastFrameTime = Time::getMillisecondCounterHiRes();
+    const int framesMissedBefore = stats.numFramesDropped;
+    flush();
+
+    // if the target couldn't accept the region, this frame has been dropped
+    if (isRepaintPending() && stats.numFramesDropped == framesMissedBefore)
+        ++stats.numFramesDropped;
+}
+
+void PaintScheduler::startTimerForNextFrame()
+{
+    // All schedulers use the same clock, so the frames of different windows happen together.
+    // (The timer may fire a little early or late, so the next frame must also be at least half
+    // a period after the last one)
+    const double now = Time::getMillisecondCounterHiRes();
+    const double earliest = jmax (now, lastFrameTime + framePeriodMs * 0.5);
+    const double nextFrame = (std::floor (earliest / framePeriodMs) + 1.0) * framePeriodMs;
+
+    startTimer (jmax (1, roundToInt (nextFrame - now)));
+}
+
+void PaintScheduler::mergeRegion()
+{
+    if (mergeStrategy == mergeIntoBoundingBox
+         || (mergeStrategy == consolidateWhenFragmented && pendingRegion.getNumRectangles() > maxRectangles))
+    {
+        if (mergeStrategy == consolidateWhenFragmented)
+            pendingRegion.consolidate();
+
+        if (mergeStrategy == mergeIntoBoundingBox || pendingRegion.getNumRectangles() > maxRectangles)
+        {
+            const Rectangle<int> bounds (pendingRegion.getBounds());
+            pendingRegion.clear();
+            pendingRegion.add (bounds);
+        }
+    }
+}
+
+//==============================================================================
+void PaintScheduler::setMergeStrategy (const MergeStrategy newStrategy, const int maxNumRectangles)
+{
+    jassert (maxNumRectangles > 0);
+
+    mergeStrategy = newStrategy;
+    maxRectangles = jmax (1, maxNumRectangles);
+}
+
+void PaintScheduler::setFrameRate (const double framesPerSecond)
+{
+    jassert (framesPerSecond > 0);
+    framePeriodMs = 1000.0 / jlimit (1.0, 1000.0, framesPerSecond);
+}
+
+void PaintScheduler::setFrameBudget (const double milliseconds)
+{
+    frameBudgetMs = jmax (0.0, milliseconds);
+}
+
+//==============================================================================
+void PaintScheduler::resetStatistics() noexcept
+{
+    stats = Statistics();
+    totalPaintTimeMs = 0;
+}
+
+void PaintScheduler::paintStarted() noexcept
+{
+    if (paintDepth++ == 0)
+        paintStartTime = Time::getMillisecondCounterHiRes();
+}
+
+void PaintScheduler::paintFinished() noexcept
+{
+    jassert (paintDepth > 0);
+
+    if (--paintDepth == 0)
+    {
+        const double elapsed = Time::getMillisecondCounterHiRes() - paintStartTime;
+        const double budget = frameBudgetMs > 0 ? frameBudgetMs : framePeriodMs;
+
+        stats.lastPaintTimeMs = elapsed;
+        stats.worstPaintTimeMs = jmax (stats.worstPaintTimeMs, elapsed);
+        totalPaintTimeMs += elapsed;
+        stats.averagePaintTimeMs = totalPaintTimeMs / ++stats.numFramesPainted;
+
+        if (elapsed > budget)
+            stats.numFramesDropped += (int) (elapsed / budget);
+    }
+}
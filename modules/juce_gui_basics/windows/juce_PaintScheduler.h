@@ -0,0 +1,187 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_PAINTSCHEDULER_JUCEHEADER__
+#define __JUCE_PAINTSCHEDULER_JUCEHEADER__
+
+
+//==============================================================================
+/**
+    Collects the areas of a window that need repainting, and hands them over to be
+    painted at a fixed frame rate.
+
+    Each ComponentPeer that supports it owns one of these (see ComponentPeer::getPaintScheduler()),
+    and sends it all the repaint requests that its components make. Rather than each request
+    being passed to the OS immediately, they're merged into a single region which is flushed
+    once per frame. The frames of all the schedulers in the app are aligned to the same
+    clock, so that several windows that are animating will be painted together rather than
+    at random times.
+
+    The scheduler also measures how long each paint takes, so you can see how many frames
+    are being dropped when the painting can't keep up with the frame rate.
+
+    @see ComponentPeer::getPaintScheduler
+*/
+class JUCE_API  PaintScheduler  : private Timer
+{
+public:
+    //==============================================================================
+    /** The object that a PaintScheduler hands its regions over to - this will be the
+        native window that is being painted.
+    */
+    class JUCE_API  Target
+    {
+    public:
+        /** Destructor. */
+        virtual ~Target() {}
+
+        /** Called at the start of a frame with the region that needs to be repainted.
+
+            The target should either paint the region, or pass it to the OS to be painted.
+            If it can't do this yet (e.g. because a previous frame is still being blitted
+            to the screen), it can return false, and the region will be kept and offered
+            again at the next frame.
+        */
+        virtual bool flushRepaintRegion (const RectangleList& regionToPaint) = 0;
+    };
+
+    //==============================================================================
+    /** Creates a scheduler which will flush its regions to the given target. */
+    explicit PaintScheduler (Target& target);
+
+    /** Destructor. */
+    ~PaintScheduler();
+
+    //==============================================================================
+    /** Adds an area to the region that'll be repainted at the next frame. */
+    void invalidate (const Rectangle<int>& area);
+
+    /** Returns true if there's a region waiting to be flushed. */
+    bool isRepaintPending() const noexcept;
+
+    /** Immediately hands any pending region to the target, without waiting for the next frame. */
+    void flush();
+
+    /** Tells the scheduler that the window's pixels within an area have been moved by the
+        given amount. Any pending parts of that area will have taken their out-of-date pixels
+        with them, so they're also invalidated at their new position.
+        @see ComponentPeer::scrollComponentArea
+    */
+    void areaScrolled (const Rectangle<int>& area, const Point<int>& delta);
+
+    //==============================================================================
+    /** The ways in which the invalidated areas can be merged together before they're painted. */
+    enum MergeStrategy
+    {
+        /** The areas are kept as separate rectangles (overlapping areas are still merged,
+            as a RectangleList does). This avoids painting any pixels that weren't invalidated,
+            but can mean painting many small rectangles.
+        */
+        keepSeparate,
+
+        /** If the number of rectangles exceeds the maximum, they're consolidated into the
+            smallest set of larger rectangles that covers exactly the same area, and if there are
+            still too many, the whole region is painted as its bounding box.
+        */
+        consolidateWhenFragmented,
+
+        /** The whole region is always painted as a single bounding rectangle. */
+        mergeIntoBoundingBox
+    };
+
+    /** Changes the way the invalidated areas are merged.
+        The default is consolidateWhenFragmented with a maximum of 16 rectangles.
+    */
+    void setMergeStrategy (MergeStrategy newStrategy, int maxNumRectangles = 16);
+
+    /** Returns the current merge strategy. */
+    MergeStrategy getMergeStrategy() const noexcept             { return mergeStrategy; }
+
+    //==============================================================================
+    /** Sets the number of frames per second at which regions are flushed.
+        The default is 60.
+    */
+    void setFrameRate (double framesPerSecond);
+
+    /** Returns the current frame rate. */
+    double getFrameRate() const noexcept                        { return 1000.0 / framePeriodMs; }
+
+    /** Sets the length of time that a single paint is allowed to take before it's counted
+        as having dropped frames. The default of 0 means one frame period.
+    */
+    void setFrameBudget (double milliseconds);
+
+    //==============================================================================
+    /** Some statistics about the frames that a scheduler has painted.
+        @see getStatistics
+    */
+    struct Statistics
+    {
+        Statistics() noexcept;
+
+        int numFramesPainted;           /**< The number of paints that have been performed. */
+        int numFramesDropped;           /**< The number of frames that were missed, either because a paint
+                                             went over the frame budget, or because the target couldn't
+                                             accept a frame when it was due. */
+        double lastPaintTimeMs;         /**< The time taken by the most recent paint. */
+        double averagePaintTimeMs;      /**< The mean time taken by all the paints. */
+        double worstPaintTimeMs;        /**< The longest time taken by a paint. */
+    };
+
+    /** Returns the statistics for the frames that have been painted so far. */
+    const Statistics& getStatistics() const noexcept            { return stats; }
+
+    /** Resets the statistics. */
+    void resetStatistics() noexcept;
+
+    //==============================================================================
+    /** The target should call this just before it starts painting, so that the time
+        taken can be measured. ComponentPeer::handlePaint() does this automatically.
+    */
+    void paintStarted() noexcept;
+
+    /** The target should call this when it has finished painting.
+        @see paintStarted
+    */
+    void paintFinished() noexcept;
+
+private:
+    //==============================================================================
+    Target& target;
+    RectangleList pendingRegion;
+    MergeStrategy mergeStrategy;
+    int maxRectangles;
+    double framePeriodMs, frameBudgetMs, lastFrameTime, paintStartTime, totalPaintTimeMs;
+    int paintDepth;
+    Statistics stats;
+
+    void timerCallback();
+    void startTimerForNextFrame();
+    void mergeRegion();
+
+    JUCE_DECLARE_NON_COPYABLE (PaintScheduler)
+};
+
+
+#endif   // __JUCE_PAINTSCHEDULER_JUCEHEADER__
@@ -27,10 +27,8 @@ class CodeDocumentLine
 public:
     CodeDocumentLine (const String::CharPointerType& l,
                       const int lineLen,
-                      const int numNewLineChars,
-                      const int startInFile)
+                      const int numNewLineChars)
         : line (l, (size_t) lineLen),
-          lineStartInFile (startInFile),
           lineLength (lineLen),
           lineLengthWithoutNewLines (lineLen - numNewLineChars)
     {
@@ -45,7 +43,6 @@ public:
         while (! (finished || t.isEmpty()))
         {
             String::CharPointerType startOfLine (t);
-            int startOfLineInFile = charNumInFile;
             int lineLength = 0;
             int numNewLineChars = 0;
 
@@ -84,8 +81,7 @@ public:
                 }
             }
 
-            newLines.add (new CodeDocumentLine (startOfLine, lineLength,
-                                                numNewLineChars, startOfLineInFile));
+            newLines.add (new CodeDocumentLine (startOfLine, lineLength, numNewLineChars));
         }
 
         jassert (charNumInFile == text.length());
@@ -118,7 +114,7 @@ public:
     }
 
     String line;
-    int lineStartInFile, lineLength, lineLengthWithoutNewLines;
+    int lineLength, lineLengthWithoutNewLines;
 };
 
 //==============================================================================
@@ -130,6 +126,18 @@ CodeDocument::Iterator::Iterator (const CodeDocument& doc) noexcept
 {
 }
 
+CodeDocument::Iterator::Iterator (const CodeDocument::Position& p) noexcept
+    : document (p.owner),
+      charPointer (nullptr),
+      line (p.getLineNumber()),
+      position (p.getPosition())
+{
+    jassert (document != nullptr);
+
+    if (const CodeDocumentLine* const l = document->lines [line])
+        charPointer = l->line.getCharPointer() + p.getIndexInLine();
+}
+
 CodeDocument::Iterator::Iterator (const CodeDocument::Iterator& other) noexcept
     : document (other.document),
       charPointer (other.charPointer),
@@ -273,8 +281,7 @@ CodeDocument::Position& CodeDocument::Position::operator= (const Position& other
     if (this != &other)
     {
         const bool wasPositionMaintained = positionMaintained;
-        if (owner != other.owner)
-            setPositionMaintained (false);
+        setPositionMaintained (false);
 
         owner = other.owner;
         line = other.line;
@@ -308,6 +315,37 @@ void CodeDocument::Position::setLineAndIndex (const int newLineNum, const int ne
 {
     jassert (owner != nullptr);
 
+    if (positionMaintained)
+    {
+        // the document keeps its maintained positions sorted, so this needs to be re-inserted
+        owner->removeMaintainedPosition (this);
+        updateLineAndIndex (newLineNum, newIndexInLine);
+        owner->addMaintainedPosition (this);
+    }
+    else
+    {
+        updateLineAndIndex (newLineNum, newIndexInLine);
+    }
+}
+
+void CodeDocument::Position::setPosition (const int newPosition)
+{
+    jassert (owner != nullptr);
+
+    if (positionMaintained)
+    {
+        owner->removeMaintainedPosition (this);
+        updatePosition (newPosition);
+        owner->addMaintainedPosition (this);
+    }
+    else
+    {
+        updatePosition (newPosition);
+    }
+}
+
+void CodeDocument::Position::updateLineAndIndex (const int newLineNum, const int newIndexInLine) noexcept
+{
     if (owner->lines.size() == 0)
     {
         line = 0;
@@ -322,7 +360,7 @@ void CodeDocument::Position::setLineAndIndex (const int newLineNum, const int ne
 
             const CodeDocumentLine& l = *owner->lines.getUnchecked (line);
             indexInLine = l.lineLengthWithoutNewLines;
-            characterPos = l.lineStartInFile + indexInLine;
+            characterPos = owner->getLineStart (line) + indexInLine;
         }
         else
         {
@@ -335,53 +373,24 @@ void CodeDocument::Position::setLineAndIndex (const int newLineNum, const int ne
             else
                 indexInLine = 0;
 
-            characterPos = l.lineStartInFile + indexInLine;
+            characterPos = owner->getLineStart (line) + indexInLine;
         }
     }
 }
 
-void CodeDocument::Position::setPosition (const int newPosition)
+void CodeDocument::Position::updatePosition (const int newPosition) noexcept
 {
-    jassert (owner != nullptr);
-
     line = 0;
     indexInLine = 0;
     characterPos = 0;
 
-    if (newPosition > 0)
+    if (newPosition > 0 && owner->lines.size() > 0)
     {
-        int lineStart = 0;
-        int lineEnd = owner->lines.size();
-
-        for (;;)
-        {
-            if (lineEnd - lineStart < 4)
-            {
-                for (int i = lineStart; i < lineEnd; ++i)
-                {
-                    const CodeDocumentLine& l = *owner->lines.getUnchecked (i);
-                    const int index = newPosition - l.lineStartInFile;
-
-                    if (index >= 0 && (index < l.lineLength || i == lineEnd - 1))
-                    {
-                        line = i;
-                        indexInLine = jmin (l.lineLengthWithoutNewLines, index);
-                        characterPos = l.lineStartInFile + indexInLine;
-                    }
-                }
+        line = owner->getLineIndexForPosition (newPosition);
 
-                break;
-            }
-            else
-            {
-                const int midIndex = (lineStart + lineEnd + 1) / 2;
-
-                if (newPosition >= owner->lines.getUnchecked (midIndex)->lineStartInFile)
-                    lineStart = midIndex;
-                else
-                    lineEnd = midIndex;
-            }
-        }
+        const int lineStart = owner->getLineStart (line);
+        indexInLine = jmin (owner->lines.getUnchecked (line)->lineLengthWithoutNewLines, newPosition - lineStart);
+        characterPos = lineStart + indexInLine;
     }
 }
 
@@ -448,13 +457,13 @@ void CodeDocument::Position::setPositionMaintained (const bool isMaintained)
             if (isMaintained)
             {
                 jassert (! owner->positionsToMaintain.contains (this));
-                owner->positionsToMaintain.add (this);
+                owner->addMaintainedPosition (this);
             }
             else
             {
                 // If this happens, you may have deleted the document while there are Position objects that are still using it...
                 jassert (owner->positionsToMaintain.contains (this));
-                owner->positionsToMaintain.removeFirstMatchingValue (this);
+                owner->removeMaintainedPosition (this);
             }
         }
     }
@@ -527,10 +536,7 @@ String CodeDocument::getTextBetween (const Position& start, const Position& end)
 
 int CodeDocument::getNumCharacters() const noexcept
 {
-    if (const CodeDocumentLine* const lastLine = lines.getLast())
-        return lastLine->lineStartInFile + lastLine->lineLength;
-
-    return 0;
+    return getLineStart (lines.size());
 }
 
 String CodeDocument::getLine (const int lineIndex) const noexcept
@@ -586,7 +592,7 @@ void CodeDocument::applyChanges (const String& newContent)
     const String corrected (StringArray::fromLines (newContent)
                                 .joinIntoString (newLineChars));
 
-    TextDiff diff (getAllContent(), corrected);
+    TextDiff diff (getAllContent(), corrected, TextDiff::myersByLine);
 
     for (int i = 0; i < diff.changes.size(); ++i)
     {
@@ -606,12 +612,33 @@ void CodeDocument::replaceAllContent (const String& newContent)
 }
 
 bool CodeDocument::loadFromStream (InputStream& stream)
+{
+    loadContent (stream.readEntireStreamAsString());
+    return true;
+}
+
+bool CodeDocument::loadFromFile (const File& file)
+{
+    {
+        const MemoryMappedFile mappedFile (file, MemoryMappedFile::readOnly);
+
+        if (mappedFile.getData() != nullptr)
+        {
+            loadContent (String::createStringFromData (mappedFile.getData(), (int) mappedFile.getSize()));
+            return true;
+        }
+    }
+
+    FileInputStream in (file);
+    return in.openedOk() && loadFromStream (in);
+}
+
+void CodeDocument::loadContent (const String& newContent)
 {
     remove (0, getNumCharacters(), false);
-    insert (stream.readEntireStreamAsString(), 0, false);
+    insert (newContent, 0, false);
     setSavePoint();
     clearUndoHistory();
-    return true;
 }
 
 bool CodeDocument::writeToStream (OutputStream& stream)
@@ -791,10 +818,132 @@ void CodeDocument::checkLastLineStatus()
     if (lastLine != nullptr && lastLine->endsWithLineBreak())
     {
         // check that there's an empty line at the end if the preceding one ends in a newline..
-        lines.add (new CodeDocumentLine (String::empty.getCharPointer(), 0, 0, lastLine->lineStartInFile + lastLine->lineLength));
+        lines.add (new CodeDocumentLine (String::empty.getCharPointer(), 0, 0));
+    }
+}
+
+//==============================================================================
+// The line start offsets are held in a binary indexed (Fenwick) tree of line lengths, so
+// that an edit within a line only needs to touch log (numLines) entries, and a character
+// position can be mapped to its line without scanning.
+void CodeDocument::rebuildLineIndex()
+{
+    const int numLines = lines.size();
+    lineLengthTree.clearQuick();
+    lineLengthTree.ensureStorageAllocated (numLines + 1);
+    lineLengthTree.add (0);
+
+    for (int i = 0; i < numLines; ++i)
+        lineLengthTree.add (lines.getUnchecked (i)->lineLength);
+
+    int* const tree = lineLengthTree.getRawDataPointer();
+
+    for (int i = 1; i <= numLines; ++i)
+    {
+        const int parent = i + (i & -i);
+
+        if (parent <= numLines)
+            tree[parent] += tree[i];
     }
 }
 
+void CodeDocument::updateLineIndex (const int lineIndex, const int lengthDelta) noexcept
+{
+    jassert (lineLengthTree.size() == lines.size() + 1);
+
+    if (lengthDelta != 0)
+    {
+        int* const tree = lineLengthTree.getRawDataPointer();
+        const int numLines = lines.size();
+
+        for (int i = lineIndex + 1; i <= numLines; i += (i & -i))
+            tree[i] += lengthDelta;
+    }
+}
+
+int CodeDocument::getLineStart (int lineIndex) const noexcept
+{
+    jassert (lineLengthTree.size() == lines.size() + 1 || lines.size() == 0);
+
+    int total = 0;
+
+    for (lineIndex = jmin (lineIndex, lineLengthTree.size() - 1); lineIndex > 0; lineIndex -= (lineIndex & -lineIndex))
+        total += lineLengthTree.getUnchecked (lineIndex);
+
+    return total;
+}
+
+int CodeDocument::getLineIndexForPosition (int characterPos) const noexcept
+{
+    const int numLines = lineLengthTree.size() - 1;
+    int bit = 1;
+
+    while (bit * 2 <= numLines)
+        bit *= 2;
+
+    // finds the number of lines that end at or before this position..
+    int index = 0;
+
+    for (; bit > 0; bit >>= 1)
+    {
+        const int next = index + bit;
+
+        if (next <= numLines && lineLengthTree.getUnchecked (next) <= characterPos)
+        {
+            index = next;
+            characterPos -= lineLengthTree.getUnchecked (next);
+        }
+    }
+
+    return jlimit (0, jmax (0, numLines - 1), index);
+}
+
+//==============================================================================
+// The maintained positions are kept sorted by character position, so an edit only has to
+// visit the positions that come after it, and those that lie beyond the lines it touched
+// can just be shifted rather than looked up again.
+int CodeDocument::getFirstMaintainedPositionIndex (const int characterPos) const noexcept
+{
+    int start = 0, end = positionsToMaintain.size();
+
+    while (start < end)
+    {
+        const int mid = (start + end) / 2;
+
+        if (positionsToMaintain.getUnchecked (mid)->characterPos < characterPos)
+            start = mid + 1;
+        else
+            end = mid;
+    }
+
+    return start;
+}
+
+void CodeDocument::addMaintainedPosition (Position* const p)
+{
+    positionsToMaintain.insert (getFirstMaintainedPositionIndex (p->characterPos + 1), p);
+}
+
+void CodeDocument::removeMaintainedPosition (Position* const p)
+{
+    for (int i = getFirstMaintainedPositionIndex (p->characterPos); i < positionsToMaintain.size(); ++i)
+    {
+        const Position* const other = positionsToMaintain.getUnchecked (i);
+
+        if (other == p)
+        {
+            positionsToMaintain.remove (i);
+            return;
+        }
+
+        if (other->characterPos != p->characterPos)
+            break;
+    }
+
+    jassertfalse; // the list has got out of order somehow..
+    positionsToMaintain.removeFirstMatchingValue (p);
+}
+
 //==============================================================================
 void CodeDocument::addListener    (CodeDocument::Listener* const l) noexcept   { listeners.add (l); }
 void CodeDocument::removeListener (CodeDocument::Listener* const l) noexcept   { listeners.remove (l); }
@@ -844,6 +993,7 @@ void CodeDocument::insert (const String& text, const int insertPos, const bool u
         {
             Position pos (*this, insertPos);
             const int firstAffectedLine = pos.getLineNumber();
+            const int oldNumLines = lines.size();
 
             CodeDocumentLine* const firstLine = lines [firstAffectedLine];
             String textInsideOriginalLine (text);
@@ -862,29 +1012,35 @@ void CodeDocument::insert (const String& text, const int insertPos, const bool u
             jassert (newLines.size() > 0);
 
             CodeDocumentLine* const newFirstLine = newLines.getUnchecked (0);
-            newFirstLine->lineStartInFile = firstLine != nullptr ? firstLine->lineStartInFile : 0;
+            const int oldFirstLineLength = firstLine != nullptr ? firstLine->lineLength : 0;
             lines.set (firstAffectedLine, newFirstLine);
 
             if (newLines.size() > 1)
                 lines.insertArray (firstAffectedLine + 1, newLines.getRawDataPointer() + 1, newLines.size() - 1);
 
-            int lineStart = newFirstLine->lineStartInFile;
-            for (int i = firstAffectedLine; i < lines.size(); ++i)
-            {
-                CodeDocumentLine& l = *lines.getUnchecked (i);
-                l.lineStartInFile = lineStart;
-                lineStart += l.lineLength;
-            }
-
             checkLastLineStatus();
 
+            if (lines.size() == oldNumLines)
+                updateLineIndex (firstAffectedLine, newFirstLine->lineLength - oldFirstLineLength);
+            else
+                rebuildLineIndex();
+
             const int newTextLength = text.length();
-            for (int i = 0; i < positionsToMaintain.size(); ++i)
+            const int numLinesAdded = lines.size() - oldNumLines;
+
+            for (int i = getFirstMaintainedPositionIndex (insertPos); i < positionsToMaintain.size(); ++i)
             {
                 CodeDocument::Position& p = *positionsToMaintain.getUnchecked(i);
 
-                if (p.getPosition() >= insertPos)
-                    p.setPosition (p.getPosition() + newTextLength);
+                if (p.line > firstAffectedLine)
+                {
+                    p.characterPos += newTextLength;
+                    p.line += numLinesAdded;
+                }
+                else
+                {
+                    p.updatePosition (p.characterPos + newTextLength);
+                }
             }
 
             listeners.call (&CodeDocument::Listener::codeDocumentTextInserted, text, insertPos);
@@ -944,7 +1100,9 @@ void CodeDocument::remove (const int startPos, const int endPos, const bool undo
         maximumLineLength = -1;
         const int firstAffectedLine = startPosition.getLineNumber();
         const int endLine = endPosition.getLineNumber();
+        const int oldNumLines = lines.size();
         CodeDocumentLine& firstLine = *lines.getUnchecked (firstAffectedLine);
+        const int oldFirstLineLength = firstLine.lineLength;
 
         if (firstAffectedLine == endLine)
         {
@@ -964,26 +1122,35 @@ void CodeDocument::remove (const int startPos, const int endPos, const bool undo
             lines.removeRange (firstAffectedLine + 1, numLinesToRemove);
         }
 
-        for (int i = firstAffectedLine + 1; i < lines.size(); ++i)
-        {
-            CodeDocumentLine& l = *lines.getUnchecked (i);
-            const CodeDocumentLine& previousLine = *lines.getUnchecked (i - 1);
-            l.lineStartInFile = previousLine.lineStartInFile + previousLine.lineLength;
-        }
+        const int newFirstLineLength = firstLine.lineLength;
 
         checkLastLineStatus();
 
+        if (lines.size() == oldNumLines)
+            updateLineIndex (firstAffectedLine, newFirstLineLength - oldFirstLineLength);
+        else
+            rebuildLineIndex();
+
         const int totalChars = getNumCharacters();
+        const int numCharsRemoved = endPosition.getPosition() - startPosition.getPosition();
+        const int numLinesRemoved = oldNumLines - lines.size();
 
-        for (int i = 0; i < positionsToMaintain.size(); ++i)
+        for (int i = getFirstMaintainedPositionIndex (startPosition.getPosition() + 1); i < positionsToMaintain.size(); ++i)
         {
             CodeDocument::Position& p = *positionsToMaintain.getUnchecked(i);
 
-            if (p.getPosition() > startPosition.getPosition())
-                p.setPosition (jmax (startPos, p.getPosition() + startPos - endPos));
+            if (p.line > endLine)
+            {
+                p.characterPos -= numCharsRemoved;
+                p.line -= numLinesRemoved;
+            }
+            else
+            {
+                p.updatePosition (jmax (startPosition.getPosition(), p.characterPos - numCharsRemoved));
 
-            if (p.getPosition() > totalChars)
-                p.setPosition (totalChars);
+                if (p.characterPos > totalChars)
+                    p.updatePosition (totalChars);
+            }
         }
 
         listeners.call (&CodeDocument::Listener::codeDocumentTextDeleted, startPos, endPos);
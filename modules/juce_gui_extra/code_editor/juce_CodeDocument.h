@@ -48,6 +48,8 @@ public:
     /** Destructor. */
     ~CodeDocument();
 
+    class Iterator;
+
     //==============================================================================
     /** A position in a code document.
 
@@ -177,9 +179,14 @@ public:
         String getLineText() const;
 
     private:
+        friend class CodeDocument;
+        friend class Iterator;
         CodeDocument* owner;
         int characterPos, line, indexInLine;
         bool positionMaintained;
+
+        void updatePosition (int newPosition) noexcept;
+        void updateLineAndIndex (int newLine, int newIndexInLine) noexcept;
     };
 
     //==============================================================================
@@ -243,6 +250,13 @@ public:
     */
     bool loadFromStream (InputStream& stream);
 
+    /** Replaces the editor's contents with the contents of a file.
+        Where possible, the file is read through a MemoryMappedFile rather than being
+        copied through a stream first, which makes opening very large files much quicker.
+        This will also reset the undo history and save point marker.
+    */
+    bool loadFromFile (const File& file);
+
     /** Writes the editor's current contents to a stream. */
     bool writeToStream (OutputStream& stream);
 
@@ -355,6 +369,12 @@ public:
     {
     public:
         Iterator (const CodeDocument& document) noexcept;
+
+        /** Creates an iterator that will read on from the given position.
+            If this is used with a CodeTokeniser, the position should be the start of a token.
+        */
+        explicit Iterator (const Position& position) noexcept;
+
         Iterator (const Iterator& other) noexcept;
         Iterator& operator= (const Iterator& other) noexcept;
         ~Iterator() noexcept;
@@ -399,6 +419,7 @@ private:
     friend class Position;
 
     OwnedArray <CodeDocumentLine> lines;
+    Array <int> lineLengthTree;
     Array <Position*> positionsToMaintain;
     UndoManager undoManager;
     int currentActionIndex, indexOfSavedState;
@@ -409,6 +430,16 @@ private:
     void insert (const String& text, int insertPos, bool undoable);
     void remove (int startPos, int endPos, bool undoable);
     void checkLastLineStatus();
+    void loadContent (const String& newContent);
+
+    void rebuildLineIndex();
+    void updateLineIndex (int lineIndex, int lengthDelta) noexcept;
+    int getLineStart (int lineIndex) const noexcept;
+    int getLineIndexForPosition (int characterPos) const noexcept;
+
+    int getFirstMaintainedPositionIndex (int characterPos) const noexcept;
+    void addMaintainedPosition (Position*);
+    void removeMaintainedPosition (Position*);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CodeDocument)
 };
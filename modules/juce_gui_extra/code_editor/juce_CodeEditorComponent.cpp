@@ -25,15 +25,26 @@
 class CodeEditorComponent::CodeEditorLine
 {
 public:
-    CodeEditorLine() noexcept   : highlightColumnStart (0), highlightColumnEnd (0)
+    CodeEditorLine() noexcept
+        : highlightColumnStart (0), highlightColumnEnd (0),
+          tokenisedLine (-1), tokenisedTabSpaces (0)
     {
     }
 
-    bool update (CodeDocument& codeDoc, int lineNum,
-                 CodeDocument::Iterator& source,
-                 CodeTokeniser* tokeniser, const int tabSpaces,
-                 const CodeDocument::Position& selStart,
-                 const CodeDocument::Position& selEnd)
+    bool hasTokensFor (const int lineNum, const int tabSpaces) const noexcept
+    {
+        return tokenisedLine == lineNum && tokenisedTabSpaces == tabSpaces;
+    }
+
+    void invalidateTokens (const int firstChangedLine) noexcept
+    {
+        if (tokenisedLine >= firstChangedLine)
+            tokenisedLine = -1;
+    }
+
+    bool updateTokens (CodeDocument& codeDoc, int lineNum,
+                       CodeDocument::Iterator& source,
+                       CodeTokeniser* tokeniser, const int tabSpaces)
     {
         Array <SyntaxToken> newTokens;
         newTokens.ensureStorageAllocated (8);
@@ -52,6 +63,20 @@ public:
 
         replaceTabsWithSpaces (newTokens, tabSpaces);
 
+        tokenisedLine = lineNum;
+        tokenisedTabSpaces = tabSpaces;
+
+        if (tokens == newTokens)
+            return false;
+
+        tokens.swapWithArray (newTokens);
+        return true;
+    }
+
+    bool updateHighlight (CodeDocument& codeDoc, int lineNum, const int tabSpaces,
+                          const CodeDocument::Position& selStart,
+                          const CodeDocument::Position& selEnd)
+    {
         int newHighlightStart = 0;
         int newHighlightEnd = 0;
 
@@ -66,17 +91,11 @@ public:
                                              line, tabSpaces);
         }
 
-        if (newHighlightStart != highlightColumnStart || newHighlightEnd != highlightColumnEnd)
-        {
-            highlightColumnStart = newHighlightStart;
-            highlightColumnEnd = newHighlightEnd;
-        }
-        else if (tokens == newTokens)
-        {
+        if (newHighlightStart == highlightColumnStart && newHighlightEnd == highlightColumnEnd)
             return false;
-        }
 
-        tokens.swapWithArray (newTokens);
+        highlightColumnStart = newHighlightStart;
+        highlightColumnEnd = newHighlightEnd;
         return true;
     }
 
@@ -134,6 +153,7 @@ private:
 
     Array <SyntaxToken> tokens;
     int highlightColumnStart, highlightColumnEnd;
+    int tokenisedLine, tokenisedTabSpaces;
 
     static void createTokens (int startPosition, const String& lineText,
                               CodeDocument::Iterator& source,
@@ -247,7 +267,7 @@ namespace CodeEditorHelpers
 }
 
 //==============================================================================
-class CodeEditorComponent::Pimpl   : public Timer,
+class CodeEditorComponent::Pimpl   : public MultiTimer,
                                      public AsyncUpdater,
                                      public ScrollBar::Listener,
                                      public CodeDocument::Listener
@@ -255,10 +275,23 @@ class CodeEditorComponent::Pimpl   : public Timer,
 public:
     Pimpl (CodeEditorComponent& ed) : owner (ed) {}
 
+    enum TimerIds
+    {
+        newTransactionTimer,
+        tokeniseAheadTimer
+    };
+
 private:
     CodeEditorComponent& owner;
 
-    void timerCallback()        { owner.newTransaction(); }
+    void timerCallback (const int timerId)
+    {
+        if (timerId == newTransactionTimer)
+            owner.newTransaction();
+        else if (! owner.tokeniseAhead())
+            stopTimer (tokeniseAheadTimer);
+    }
+
     void handleAsyncUpdate()    { owner.rebuildLineTokens(); }
 
     void scrollBarMoved (ScrollBar* scrollBarThatHasMoved, double newRangeStart)
@@ -271,17 +304,12 @@ private:
 
     void codeDocumentTextInserted (const String& newText, int pos)
     {
-        codeDocumentChanged (pos, pos + newText.length());
+        owner.codeDocumentChanged (pos, pos + newText.length(), newText.length());
     }
 
     void codeDocumentTextDeleted (int start, int end)
     {
-        codeDocumentChanged (start, end);
-    }
-
-    void codeDocumentChanged (const int start, const int end)
-    {
-        owner.codeDocumentChanged (start, end);
+        owner.codeDocumentChanged (start, end, start - end);
     }
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Pimpl)
@@ -387,6 +415,8 @@ CodeEditorComponent::CodeEditorComponent (CodeDocument& doc, CodeTokeniser* cons
     verticalScrollBar.addListener (pimpl);
     horizontalScrollBar.addListener (pimpl);
     document.addListener (pimpl);
+
+    pimpl->startTimer (Pimpl::tokeniseAheadTimer, 50);
 }
 
 CodeEditorComponent::~CodeEditorComponent()
@@ -522,12 +552,33 @@ void CodeEditorComponent::rebuildLineTokens()
     jassert (numNeeded == lines.size());
 
     CodeDocument::Iterator source (document);
-    getIteratorForPosition (CodeDocument::Position (document, firstLineOnScreen, 0).getPosition(), source);
+    bool sourceIsAtLine = false;
 
     for (int i = 0; i < numNeeded; ++i)
     {
-        if (lines.getUnchecked(i)->update (document, firstLineOnScreen + i, source, codeTokeniser,
-                                           spacesPerTab, selectionStart, selectionEnd))
+        CodeEditorLine& line = *lines.getUnchecked(i);
+        const int lineNum = firstLineOnScreen + i;
+        bool needsRepaint = false;
+
+        // lines which are still tokenised from last time are left alone, so the tokeniser only
+        // needs to be re-run from wherever the first out-of-date line is.
+        if (line.hasTokensFor (lineNum, spacesPerTab))
+        {
+            sourceIsAtLine = false;
+        }
+        else
+        {
+            if (! sourceIsAtLine)
+            {
+                getIteratorForPosition (CodeDocument::Position (document, lineNum, 0).getPosition(), source);
+                sourceIsAtLine = true;
+            }
+
+            needsRepaint = line.updateTokens (document, lineNum, source, codeTokeniser, spacesPerTab);
+        }
+
+        if (line.updateHighlight (document, lineNum, spacesPerTab, selectionStart, selectionEnd)
+             || needsRepaint)
         {
             minLineToRepaint = jmin (minLineToRepaint, i);
             maxLineToRepaint = jmax (maxLineToRepaint, i);
@@ -542,12 +593,15 @@ void CodeEditorComponent::rebuildLineTokens()
         gutter->documentChanged (document);
 }
 
-void CodeEditorComponent::codeDocumentChanged (const int startIndex, const int endIndex)
+void CodeEditorComponent::codeDocumentChanged (const int startIndex, const int endIndex, const int lengthDelta)
 {
     const CodeDocument::Position affectedTextStart (document, startIndex);
     const CodeDocument::Position affectedTextEnd (document, endIndex);
 
-    clearCachedIterators (affectedTextStart.getLineNumber());
+    invalidateCachedIterators (startIndex, endIndex, lengthDelta);
+
+    for (int i = lines.size(); --i >= 0;)
+        lines.getUnchecked(i)->invalidateTokens (affectedTextStart.getLineNumber() - 1);
 
     rebuildLineTokensAsync();
 
@@ -656,12 +710,38 @@ void CodeEditorComponent::scrollToLineInternal (int newFirstLineOnScreen)
 
     if (newFirstLineOnScreen != firstLineOnScreen)
     {
+        const int delta = newFirstLineOnScreen - firstLineOnScreen;
+
+        // If possible, the lines that stay on-screen are just moved rather than redrawn. (This
+        // has to happen before anything changes, while the pixels being moved are still valid)
+        const int gutterSize = getGutterSize();
+        ComponentPeer* const peer = getPeer();
+        const bool linesWereScrolled = peer != nullptr
+            && peer->scrollComponentArea (*this, Rectangle<int> (gutterSize, 0, verticalScrollBar.getX() - gutterSize,
+                                                                 horizontalScrollBar.getY()),
+                                          Point<int> (0, -delta * lineHeight));
+
         firstLineOnScreen = newFirstLineOnScreen;
         updateCaretPosition();
 
+        // shuffle the rows along so that any lines which are still visible keep their tokens
+        if (delta > 0)
+            for (int i = jmin (delta, lines.size()); --i >= 0;)
+                lines.move (0, -1);
+        else
+            for (int i = jmin (-delta, lines.size()); --i >= 0;)
+                lines.move (lines.size() - 1, 0);
+
         updateCachedIterators (firstLineOnScreen);
         rebuildLineTokensAsync();
         pimpl->handleUpdateNowIfNeeded();
+
+        if (! linesWereScrolled)
+            repaint();
+        else if (gutter != nullptr)
+            gutter->repaint();
+
+        pimpl->startTimer (Pimpl::tokeniseAheadTimer, 50);
     }
 }
 
@@ -1128,7 +1208,7 @@ bool CodeEditorComponent::redo()
 void CodeEditorComponent::newTransaction()
 {
     document.newTransaction();
-    pimpl->startTimer (600);
+    pimpl->startTimer (Pimpl::newTransactionTimer, 600);
 }
 
 void CodeEditorComponent::setCommandManager (ApplicationCommandManager* newManager) noexcept
@@ -1508,6 +1588,103 @@ void CodeEditorComponent::clearCachedIterators (const int firstLineToBeInvalid)
             break;
 
     cachedIterators.removeRange (jmax (0, i - 1), cachedIterators.size());
+    staleIteratorPositions.clearQuick();
+    staleIteratorBarriers.clearQuick();
+}
+
+void CodeEditorComponent::invalidateCachedIterators (const int editStart, const int editEnd, const int lengthDelta)
+{
+    // The cached positions that came after the edit are remembered at their new offsets, so that
+    // when the tokeniser gets back in step with one of them, all the following ones can be trusted
+    // again instead of re-tokenising the rest of the document.
+    // If there were still some stale positions left over from an earlier edit further on, a
+    // barrier is added where they begin, because getting back in step after this edit says
+    // nothing about the text beyond that earlier one.
+    const int oldEditEnd = lengthDelta >= 0 ? editStart : editEnd;
+    const CodeDocument::Position editPos (document, editStart);
+    const int editLineStart = editPos.getPosition() - editPos.getIndexInLine();
+
+    // (this drops one more iterator than it strictly needs to, as clearCachedIterators() does)
+    int numToKeep = cachedIterators.size();
+
+    while (numToKeep > 0 && cachedIterators.getUnchecked (numToKeep - 1)->getPosition() >= editLineStart)
+        --numToKeep;
+
+    numToKeep = jmax (0, numToKeep - 1);
+
+    Array<int> positionsAfterEdit, barriersAfterEdit;
+
+    for (int i = numToKeep; i < cachedIterators.size(); ++i)
+    {
+        const int pos = cachedIterators.getUnchecked (i)->getPosition();
+
+        if (pos >= oldEditEnd && (positionsAfterEdit.size() == 0 || positionsAfterEdit.getLast() < pos + lengthDelta))
+            positionsAfterEdit.add (pos + lengthDelta);
+    }
+
+    const int numValidPositionsAfterEdit = positionsAfterEdit.size();
+
+    for (int i = 0; i < staleIteratorPositions.size(); ++i)
+    {
+        const int pos = staleIteratorPositions.getUnchecked (i);
+
+        if (pos >= oldEditEnd && (positionsAfterEdit.size() == 0 || positionsAfterEdit.getLast() < pos + lengthDelta))
+            positionsAfterEdit.add (pos + lengthDelta);
+    }
+
+    if (numValidPositionsAfterEdit > 0 && positionsAfterEdit.size() > numValidPositionsAfterEdit)
+        barriersAfterEdit.add (positionsAfterEdit.getUnchecked (numValidPositionsAfterEdit));
+
+    for (int i = 0; i < staleIteratorBarriers.size(); ++i)
+    {
+        const int pos = staleIteratorBarriers.getUnchecked (i);
+
+        if (pos >= oldEditEnd)
+            barriersAfterEdit.addIfNotAlreadyThere (pos + lengthDelta);
+    }
+
+    cachedIterators.removeRange (numToKeep, cachedIterators.size());
+    staleIteratorPositions.swapWithArray (positionsAfterEdit);
+    staleIteratorBarriers.swapWithArray (barriersAfterEdit);
+
+    pimpl->startTimer (Pimpl::tokeniseAheadTimer, 50);
+}
+
+bool CodeEditorComponent::revalidateStaleIterators (const CodeDocument::Iterator& source)
+{
+    const int pos = source.getPosition();
+    int numPassed = 0;
+
+    while (numPassed < staleIteratorPositions.size()
+            && staleIteratorPositions.getUnchecked (numPassed) < pos)
+        ++numPassed;
+
+    staleIteratorPositions.removeRange (0, numPassed);
+
+    while (staleIteratorBarriers.size() > 0 && staleIteratorBarriers.getFirst() <= pos)
+        staleIteratorBarriers.remove (0);
+
+    if (staleIteratorPositions.size() == 0 || staleIteratorPositions.getFirst() != pos)
+        return false;
+
+    // the source has reached a token boundary that was also a boundary before the edit,
+    // so the tokens from here up to the next barrier must be the same as they were..
+    const int limit = staleIteratorBarriers.size() > 0 ? staleIteratorBarriers.getFirst()
+                                                      : std::numeric_limits<int>::max();
+    int numRevalidated = 1;
+
+    for (; numRevalidated < staleIteratorPositions.size(); ++numRevalidated)
+    {
+        const int stalePos = staleIteratorPositions.getUnchecked (numRevalidated);
+
+        if (stalePos >= limit)
+            break;
+
+        cachedIterators.add (new CodeDocument::Iterator (CodeDocument::Position (document, stalePos)));
+    }
+
+    staleIteratorPositions.removeRange (0, numRevalidated);
+    return true;
 }
 
 void CodeEditorComponent::updateCachedIterators (int maxLineNum)
@@ -1524,7 +1701,7 @@ void CodeEditorComponent::updateCachedIterators (int maxLineNum)
         {
             CodeDocument::Iterator& last = *cachedIterators.getLast();
 
-            if (last.getLine() >= maxLineNum)
+            if (last.getLine() >= maxLineNum || last.isEOF())
                 break;
 
             CodeDocument::Iterator* t = new CodeDocument::Iterator (last);
@@ -1535,6 +1712,9 @@ void CodeEditorComponent::updateCachedIterators (int maxLineNum)
             {
                 codeTokeniser->readNextToken (*t);
 
+                if (staleIteratorPositions.size() > 0 && revalidateStaleIterators (*t))
+                    break;
+
                 if (t->getLine() >= targetLine)
                     break;
 
@@ -1545,6 +1725,32 @@ void CodeEditorComponent::updateCachedIterators (int maxLineNum)
     }
 }
 
+bool CodeEditorComponent::tokeniseAhead()
+{
+    if (codeTokeniser == nullptr)
+        return false;
+
+    // Builds up the cached iterators beyond the visible area in small time-slices, so that
+    // scrolling into an area that hasn't been seen yet doesn't have to tokenise all of it first.
+    const uint32 endTime = Time::getMillisecondCounter() + 5;
+
+    do
+    {
+        const int lastLine = cachedIterators.size() > 0 ? cachedIterators.getLast()->getLine() : 0;
+
+        if (lastLine >= document.getNumLines() - 1)
+            return false;
+
+        updateCachedIterators (lastLine + 1);
+
+        if (cachedIterators.getLast()->getLine() <= lastLine)
+            return false;
+    }
+    while (Time::getMillisecondCounter() < endTime);
+
+    return true;
+}
+
 void CodeEditorComponent::getIteratorForPosition (int position, CodeDocument::Iterator& source)
 {
     if (codeTokeniser != nullptr)
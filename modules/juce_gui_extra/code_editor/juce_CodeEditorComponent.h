@@ -388,11 +388,15 @@ private:
     OwnedArray <CodeEditorLine> lines;
     void rebuildLineTokens();
     void rebuildLineTokensAsync();
-    void codeDocumentChanged (int start, int end);
+    void codeDocumentChanged (int start, int end, int lengthDelta);
 
     OwnedArray <CodeDocument::Iterator> cachedIterators;
+    Array <int> staleIteratorPositions, staleIteratorBarriers;
     void clearCachedIterators (int firstLineToBeInvalid);
+    void invalidateCachedIterators (int editStart, int editEnd, int lengthDelta);
+    bool revalidateStaleIterators (const CodeDocument::Iterator&);
     void updateCachedIterators (int maxLineNum);
+    bool tokeniseAhead();
     void getIteratorForPosition (int position, CodeDocument::Iterator&);
 
     void moveLineDelta (int delta, bool selecting);
@@ -186,8 +186,10 @@ private:
 #include "opengl/juce_OpenGLHelpers.cpp"
 #include "opengl/juce_OpenGLImage.cpp"
 #include "opengl/juce_OpenGLPixelFormat.cpp"
+#include "opengl/juce_OpenGLResourcePool.cpp"
 #include "opengl/juce_OpenGLShaderProgram.cpp"
 #include "opengl/juce_OpenGLTexture.cpp"
+#include "opengl/juce_OpenGLTextureUploader.cpp"
 
 //==============================================================================
 #if JUCE_MAC || JUCE_IOS
@@ -107,12 +107,18 @@ namespace juce
 #ifndef __JUCE_OPENGLRENDERER_JUCEHEADER__
  #include "opengl/juce_OpenGLRenderer.h"
 #endif
+#ifndef __JUCE_OPENGLRESOURCEPOOL_JUCEHEADER__
+ #include "opengl/juce_OpenGLResourcePool.h"
+#endif
 #ifndef __JUCE_OPENGLSHADERPROGRAM_JUCEHEADER__
  #include "opengl/juce_OpenGLShaderProgram.h"
 #endif
 #ifndef __JUCE_OPENGLTEXTURE_JUCEHEADER__
  #include "opengl/juce_OpenGLTexture.h"
 #endif
+#ifndef __JUCE_OPENGLTEXTUREUPLOADER_JUCEHEADER__
+ #include "opengl/juce_OpenGLTextureUploader.h"
+#endif
 #ifndef __JUCE_QUATERNION_JUCEHEADER__
  #include "opengl/juce_Quaternion.h"
 #endif
@@ -42,6 +42,30 @@
  #define GL_RGBA8                GL_RGBA
 #endif
 
+#ifndef GL_ALPHA32F_ARB
+ #define GL_ALPHA32F_ARB         0x8816
+#endif
+
+#ifndef GL_PIXEL_UNPACK_BUFFER
+ #define GL_PIXEL_UNPACK_BUFFER  0x88EC
+#endif
+
+#ifndef GL_WRITE_ONLY
+ #define GL_WRITE_ONLY           0x88B9
+#endif
+
+#ifndef GL_PROGRAM_BINARY_LENGTH
+ #define GL_PROGRAM_BINARY_LENGTH            0x8741
+#endif
+
+#ifndef GL_NUM_PROGRAM_BINARY_FORMATS
+ #define GL_NUM_PROGRAM_BINARY_FORMATS       0x87FE
+#endif
+
+#ifndef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+ #define GL_PROGRAM_BINARY_RETRIEVABLE_HINT  0x8257
+#endif
+
 #if JUCE_ANDROID
  #define JUCE_RGBA_FORMAT        GL_RGBA
 #else
@@ -54,7 +54,16 @@
     EXT_FUNCTION (glCheckFramebufferStatus, GLenum, (GLenum p1), (p1))\
     EXT_FUNCTION (glFramebufferTexture2D,   void, (GLenum p1, GLenum p2, GLenum p3, GLuint p4, GLint p5), (p1, p2, p3, p4, p5))\
     EXT_FUNCTION (glFramebufferRenderbuffer,  void, (GLenum p1, GLenum p2, GLenum p3, GLuint p4), (p1, p2, p3, p4))\
-    EXT_FUNCTION (glGetFramebufferAttachmentParameteriv, void, (GLenum p1, GLenum p2, GLenum p3, GLint* p4), (p1, p2, p3, p4))
+    EXT_FUNCTION (glGetFramebufferAttachmentParameteriv, void, (GLenum p1, GLenum p2, GLenum p3, GLint* p4), (p1, p2, p3, p4))\
+    JUCE_GL_BUFFER_MAPPING_FUNCTIONS(USE_FUNCTION)
+
+#if JUCE_OPENGL_ES
+ #define JUCE_GL_BUFFER_MAPPING_FUNCTIONS(USE_FUNCTION)
+#else
+ #define JUCE_GL_BUFFER_MAPPING_FUNCTIONS(USE_FUNCTION) \
+    USE_FUNCTION (glMapBuffer,              GLvoid*, (GLenum p1, GLenum p2), (p1, p2))\
+    USE_FUNCTION (glUnmapBuffer,            GLboolean, (GLenum p1), (p1))
+#endif
 
 #if JUCE_USE_OPENGL_SHADERS
  #define JUCE_GL_EXTENSION_FUNCTIONS1(USE_FUNCTION, EXT_FUNCTION) \
@@ -22,6 +22,45 @@
   ==============================================================================
 */
 
+// Renders all the contexts that have called setUsesSharedRenderThread (true)
+class OpenGLContext::SharedRenderThread  : public Thread
+{
+public:
+    static void addImage (CachedImage&);
+    static void removeImage (CachedImage&);
+
+    /** This is passed to the MessageManagerLocks that the thread acquires, so that it can
+        be made to give up waiting for one when the message thread needs to remove a context.
+    */
+    ThreadPoolJob* getExitSignal() const noexcept     { return exitSignal; }
+
+private:
+    SharedRenderThread();
+    ~SharedRenderThread();
+
+    struct ExitSignal  : public ThreadPoolJob
+    {
+        ExitSignal() : ThreadPoolJob ("OpenGL exit signal") {}
+        JobStatus runJob()      { return jobHasFinished; } // (never actually run)
+    };
+
+    CriticalSection lock;
+    Array<CachedImage*> images, imagesToAdd, imagesToRemove;
+    ScopedPointer<ExitSignal> exitSignal;
+
+    static SharedRenderThread* instance;
+    static int numUsers;
+    static CriticalSection instanceLock;
+
+    void run();
+    void removeImages();
+    void addImages();
+    void updateSwapIntervals();
+
+    JUCE_DECLARE_NON_COPYABLE (SharedRenderThread)
+};
+
+//==============================================================================
 class OpenGLContext::CachedImage  : public CachedComponentImage,
                                     public Thread
 {
@@ -37,7 +76,9 @@ public:
           shadersAvailable (false),
          #endif
           hasInitialised (false),
-          needsUpdate (1)
+          needsUpdate (1),
+          lastFrameRenderTime (0),
+          sharedThread (nullptr)
     {
         nativeContext = new NativeContext (component, pixFormat, contextToShare);
 
@@ -56,14 +97,22 @@ public:
     {
        #if ! JUCE_ANDROID
         if (nativeContext != nullptr)
-            startThread (6);
+        {
+            if (context.useSharedRenderThread)
+                SharedRenderThread::addImage (*this);
+            else
+                startThread (6);
+        }
        #endif
     }
 
     void stop()
     {
        #if ! JUCE_ANDROID
-        stopThread (10000);
+        if (sharedThread != nullptr)
+            SharedRenderThread::removeImage (*this);
+        else
+            stopThread (10000);
        #endif
         hasInitialised = false;
     }
@@ -107,9 +156,13 @@ public:
         const int fbW = cachedImageFrameBuffer.getWidth();
         const int fbH = cachedImageFrameBuffer.getHeight();
 
-        if (fbW != viewportArea.getWidth() || fbH != viewportArea.getHeight() || ! cachedImageFrameBuffer.isValid())
+        // (the buffer comes from the context's resource pool, so it's rounded up to the
+        // pool's bucket size, and doesn't need replacing for small changes in size)
+        if (fbW != OpenGLResourcePool::getBucketSize (viewportArea.getWidth())
+             || fbH != OpenGLResourcePool::getBucketSize (viewportArea.getHeight())
+             || ! cachedImageFrameBuffer.isValid())
         {
-            if (! cachedImageFrameBuffer.initialise (context, viewportArea.getWidth(), viewportArea.getHeight()))
+            if (! cachedImageFrameBuffer.initialiseFromPool (context, viewportArea.getWidth(), viewportArea.getHeight()))
                 return false;
 
             validArea.clear();
@@ -148,7 +201,7 @@ public:
 
         if (context.renderComponents && isUpdating)
         {
-            mmLock = new MessageManagerLock (this);  // need to acquire this before locking the context.
+            mmLock = lockMessageManager();  // need to acquire this before locking the context.
             if (! mmLock->lockWasGained())
                 return false;
         }
@@ -157,6 +210,7 @@ public:
             return false;
 
         NativeContext::Locker locker (*nativeContext);
+        const double startTime = Time::getMillisecondCounterHiRes();
 
         JUCE_CHECK_OPENGL_ERROR
 
@@ -179,10 +233,20 @@ public:
             drawComponentBuffer();
         }
 
+        lastFrameRenderTime = Time::getMillisecondCounterHiRes() - startTime;
         context.swapBuffers();
         return true;
     }
 
+    MessageManagerLock* lockMessageManager()
+    {
+        // (a shared thread can't use its own exit flag, as it needs to carry on running)
+        if (sharedThread != nullptr)
+            return new MessageManagerLock (sharedThread->getExitSignal());
+
+        return new MessageManagerLock (this);
+    }
+
     void updateViewportSize (bool canTriggerUpdate)
     {
         const double newScale = Desktop::getInstance().getDisplays()
@@ -245,7 +309,7 @@ public:
         glBindTexture (GL_TEXTURE_2D, cachedImageFrameBuffer.getTextureID());
 
         const Rectangle<int> cacheBounds (cachedImageFrameBuffer.getWidth(), cachedImageFrameBuffer.getHeight());
-        context.copyTexture (cacheBounds, cacheBounds, cacheBounds.getWidth(), cacheBounds.getHeight(), false);
+        context.copyTexture (viewportArea, cacheBounds, viewportArea.getWidth(), viewportArea.getHeight(), false);
         glBindTexture (GL_TEXTURE_2D, 0);
         JUCE_CHECK_OPENGL_ERROR
     }
@@ -371,10 +435,186 @@ public:
     WaitableEvent canPaintNowFlag, finishedPaintingFlag;
     bool shadersAvailable, hasInitialised;
     Atomic<int> needsUpdate;
+    volatile double lastFrameRenderTime;
+
+    SharedRenderThread* sharedThread;
+    WaitableEvent removedFromSharedThread;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CachedImage)
 };
 
+//==============================================================================
+OpenGLContext::SharedRenderThread* OpenGLContext::SharedRenderThread::instance = nullptr;
+int OpenGLContext::SharedRenderThread::numUsers = 0;
+CriticalSection OpenGLContext::SharedRenderThread::instanceLock;
+
+OpenGLContext::SharedRenderThread::SharedRenderThread()
+    : Thread ("OpenGL Shared Rendering"), exitSignal (new ExitSignal())
+{
+}
+
+OpenGLContext::SharedRenderThread::~SharedRenderThread()
+{
+    stopThread (10000);
+}
+
+void OpenGLContext::SharedRenderThread::addImage (CachedImage& image)
+{
+    const ScopedLock sl (instanceLock);
+
+    if (instance == nullptr)
+    {
+        instance = new SharedRenderThread();
+        instance->startThread (6);
+    }
+
+    ++numUsers;
+    image.sharedThread = instance;
+
+    const ScopedLock sl2 (instance->lock);
+    instance->imagesToAdd.add (&image);
+    instance->notify();
+}
+
+void OpenGLContext::SharedRenderThread::removeImage (CachedImage& image)
+{
+    SharedRenderThread* const thread = image.sharedThread;
+    jassert (thread != nullptr);
+    bool needsToWait = false;
+
+    {
+        const ScopedLock sl (thread->lock);
+
+        if (thread->imagesToAdd.contains (&image))
+        {
+            thread->imagesToAdd.removeFirstMatchingValue (&image);
+        }
+        else
+        {
+            // The render thread might be waiting for the message thread, which is about to
+            // be blocked, so this makes it give up and deal with the removal first.
+            thread->imagesToRemove.add (&image);
+            thread->exitSignal->signalJobShouldExit();
+            thread->notify();
+            needsToWait = true;
+        }
+    }
+
+    if (needsToWait)
+        image.removedFromSharedThread.wait();
+
+    image.sharedThread = nullptr;
+
+    const ScopedLock sl (instanceLock);
+
+    if (--numUsers == 0)
+    {
+        jassert (thread == instance);
+
+        // (deleted here rather than with deleteAndZero(), which can't reach the private destructor)
+        delete instance;
+        instance = nullptr;
+    }
+}
+
+void OpenGLContext::SharedRenderThread::run()
+{
+    while (! threadShouldExit())
+    {
+        removeImages();
+        addImages();
+
+        bool anyFramesRendered = false;
+
+        for (int i = 0; i < images.size() && ! exitSignal->shouldExit(); ++i)
+            if (images.getUnchecked (i)->renderFrame())
+                anyFramesRendered = true;
+
+        if (! anyFramesRendered)
+            wait (5); // no contexts, or they all failed to render, so avoid a tight fail-loop.
+    }
+}
+
+void OpenGLContext::SharedRenderThread::removeImages()
+{
+    Array<CachedImage*> removed;
+
+    {
+        const ScopedLock sl (lock);
+        removed.swapWithArray (imagesToRemove);
+
+        if (exitSignal->shouldExit())
+            exitSignal = new ExitSignal();
+    }
+
+    for (int i = 0; i < removed.size(); ++i)
+    {
+        CachedImage& image = *removed.getUnchecked (i);
+        images.removeFirstMatchingValue (&image);
+
+        image.context.makeActive();
+        image.shutdownOnThread();
+        image.removedFromSharedThread.signal();
+    }
+
+    if (removed.size() > 0)
+        updateSwapIntervals();
+}
+
+void OpenGLContext::SharedRenderThread::addImages()
+{
+    const int oldNumImages = images.size();
+
+    for (;;)
+    {
+        CachedImage* image = nullptr;
+
+        {
+            const ScopedLock sl (lock);
+            image = imagesToAdd.getFirst();
+        }
+
+        if (image == nullptr)
+            break;
+
+        {
+            // Allow the message thread to finish setting-up the context before using it..
+            MessageManagerLock mml (exitSignal.get());
+            if (! mml.lockWasGained())
+                break;  // (a context is being removed, so that needs to be dealt with first)
+        }
+
+        {
+            const ScopedLock sl (lock);
+
+            if (! imagesToAdd.contains (image))
+                continue;
+
+            imagesToAdd.removeFirstMatchingValue (image);
+        }
+
+        image->initialiseOnThread();
+        image->hasInitialised = true;
+        images.add (image);
+    }
+
+    if (images.size() != oldNumImages)
+        updateSwapIntervals();
+}
+
+void OpenGLContext::SharedRenderThread::updateSwapIntervals()
+{
+    // Only the first context waits for the vertical sync, so that all the others
+    // get swapped straight after it, rather than each one waiting for its own sync.
+    for (int i = 0; i < images.size(); ++i)
+    {
+        CachedImage& image = *images.getUnchecked (i);
+
+        if (image.context.makeActive())
+            image.context.setSwapInterval (i == 0 ? 1 : 0);
+    }
+}
+
 //==============================================================================
 #if JUCE_ANDROID
 void OpenGLContext::NativeContext::contextCreatedCallback()
@@ -521,7 +761,7 @@ private:
 //==============================================================================
 OpenGLContext::OpenGLContext()
     : nativeContext (nullptr), renderer (nullptr), contextToShareWith (nullptr),
-      renderComponents (true)
+      renderComponents (true), useSharedRenderThread (false)
 {
 }
 
@@ -566,6 +806,15 @@ void OpenGLContext::setNativeSharedContext (void* nativeContextToShareWith) noex
     contextToShareWith = nativeContextToShareWith;
 }
 
+void OpenGLContext::setUsesSharedRenderThread (bool shouldUseSharedThread) noexcept
+{
+    // This method must not be called when the context has already been attached!
+    // Call it before attaching your context, or use detach() first, before calling this!
+    jassert (nativeContext == nullptr);
+
+    useSharedRenderThread = shouldUseSharedThread;
+}
+
 void OpenGLContext::attachTo (Component& component)
 {
     component.repaint();
@@ -631,6 +880,14 @@ void OpenGLContext::triggerRepaint()
         cachedImage->triggerRepaint();
 }
 
+double OpenGLContext::getLastFrameRenderTime() const noexcept
+{
+    if (CachedImage* const cachedImage = getCachedImage())
+        return cachedImage->lastFrameRenderTime;
+
+    return 0;
+}
+
 void OpenGLContext::swapBuffers()
 {
     if (nativeContext != nullptr)
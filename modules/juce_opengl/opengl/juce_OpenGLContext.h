@@ -92,6 +92,22 @@ public:
     */
     void setNativeSharedContext (void* nativeContextToShareWith) noexcept;
 
+    /** Makes the context get rendered by a thread that's shared with any other contexts
+        that have also enabled this, rather than by a thread of its own.
+
+        When a window contains lots of GL views, giving each one its own thread means they
+        all compete for the driver, and each one waits separately for the vertical sync.
+        The shared thread renders all its contexts in turn, and only the first one's buffer
+        swap waits for the sync, so they all present their frames together.
+
+        By default this is false. It has no effect on Android, where rendering is driven by
+        the OS.
+
+        Note: This must be called BEFORE attaching your context to a target component!
+        @see getLastFrameRenderTime
+    */
+    void setUsesSharedRenderThread (bool shouldUseSharedThread) noexcept;
+
     //==============================================================================
     /** Attaches the context to a target component.
 
@@ -128,6 +144,12 @@ public:
     /** Asynchronously causes a repaint to be made. */
     void triggerRepaint();
 
+    /** Returns the number of milliseconds that the most recent frame took to render,
+        including the OpenGLRenderer callback and any component painting, but not the time
+        spent waiting to swap the buffers. This is updated after every frame.
+    */
+    double getLastFrameRenderTime() const noexcept;
+
     //==============================================================================
     /** If this context is backed by a frame buffer, this returns its ID number,
         or 0 if the context does not use a framebuffer.
@@ -237,12 +259,13 @@ public:
 private:
     class CachedImage;
     class Attachment;
+    class SharedRenderThread;
     NativeContext* nativeContext;
     OpenGLRenderer* renderer;
     ScopedPointer<Attachment> attachment;
     OpenGLPixelFormat pixelFormat;
     void* contextToShareWith;
-    bool renderComponents;
+    bool renderComponents, useSharedRenderThread;
 
     CachedImage* getCachedImage() const noexcept;
 
@@ -29,7 +29,7 @@ public:
            const bool wantsDepthBuffer, const bool wantsStencilBuffer)
         : context (c), width (w), height (h),
           textureID (0), frameBufferID (0), depthOrStencilBuffer (0),
-          hasDepthBuffer (false), hasStencilBuffer (false)
+          hasDepthBuffer (false), hasStencilBuffer (false), isPooled (false)
     {
         // Framebuffer objects can only be created when the current thread has an active OpenGL
         // context. You'll need to create this object in one of the OpenGLContext's callbacks.
@@ -124,7 +124,7 @@ public:
     OpenGLContext& context;
     const int width, height;
     GLuint textureID, frameBufferID, depthOrStencilBuffer;
-    bool hasDepthBuffer, hasStencilBuffer;
+    bool hasDepthBuffer, hasStencilBuffer, isPooled;
 
 private:
     bool checkStatus() noexcept
@@ -169,13 +169,17 @@ private:
 
 //==============================================================================
 OpenGLFrameBuffer::OpenGLFrameBuffer() {}
-OpenGLFrameBuffer::~OpenGLFrameBuffer() {}
+
+OpenGLFrameBuffer::~OpenGLFrameBuffer()
+{
+    releasePimpl();
+}
 
 bool OpenGLFrameBuffer::initialise (OpenGLContext& context, int width, int height)
 {
     jassert (context.isActive()); // The context must be active when creating a framebuffer!
 
-    pimpl = nullptr;
+    releasePimpl();
     pimpl = new Pimpl (context, width, height, false, false);
 
     if (! pimpl->createdOk())
@@ -227,9 +231,42 @@ bool OpenGLFrameBuffer::initialise (OpenGLFrameBuffer& other)
     return false;
 }
 
-void OpenGLFrameBuffer::release()
+bool OpenGLFrameBuffer::initialiseFromPool (OpenGLContext& context, int width, int height)
 {
+    jassert (context.isActive()); // The context must be active when creating a framebuffer!
+
+    releasePimpl();
+    OpenGLResourcePool& pool = OpenGLResourcePool::getFor (context);
+    pimpl = pool.takeFrameBuffer (width, height);
+
+    if (pimpl == nullptr)
+    {
+        pimpl = new Pimpl (context, OpenGLResourcePool::getBucketSize (width),
+                           OpenGLResourcePool::getBucketSize (height), false, false);
+
+        if (! pimpl->createdOk())
+        {
+            pimpl = nullptr;
+            return false;
+        }
+    }
+
+    pimpl->isPooled = true;
+    return true;
+}
+
+void OpenGLFrameBuffer::releasePimpl()
+{
+    if (pimpl != nullptr && pimpl->isPooled
+         && OpenGLContext::getCurrentContext() == &(pimpl->context))
+        OpenGLResourcePool::getFor (pimpl->context).returnFrameBuffer (pimpl.release());
+
     pimpl = nullptr;
+}
+
+void OpenGLFrameBuffer::release()
+{
+    releasePimpl();
     savedState = nullptr;
 }
 
@@ -238,7 +275,7 @@ void OpenGLFrameBuffer::saveAndRelease()
     if (pimpl != nullptr)
     {
         savedState = new SavedState (*this, pimpl->width, pimpl->height);
-        pimpl = nullptr;
+        releasePimpl();
     }
 }
 
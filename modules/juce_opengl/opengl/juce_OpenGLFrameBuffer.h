@@ -58,6 +58,20 @@ public:
     */
     bool initialise (OpenGLFrameBuffer& other);
 
+    /** Tries to allocate a buffer that's at least the given size, re-using a spare one
+        from the context's OpenGLResourcePool if there's one available.
+
+        This is intended for buffers that are only needed briefly, such as intermediate
+        layers while rendering. The size is rounded up (see OpenGLResourcePool::getBucketSize()),
+        so getWidth() and getHeight() may return more than was asked for, and any old content
+        that it contains will be left there. When the buffer is released, it's given back to
+        the pool rather than being deleted.
+
+        This must be called while the context is active on its rendering thread.
+        @see OpenGLResourcePool
+    */
+    bool initialiseFromPool (OpenGLContext& context, int width, int height);
+
     /** Releases the buffer, if one has been allocated.
         Any saved state that was created with saveAndRelease() will also be freed by this call.
     */
@@ -140,12 +154,15 @@ public:
 private:
     class Pimpl;
     friend class ScopedPointer<Pimpl>;
+    friend class OpenGLResourcePool;
     ScopedPointer<Pimpl> pimpl;
 
     class SavedState;
     friend class ScopedPointer<SavedState>;
     ScopedPointer<SavedState> savedState;
 
+    void releasePimpl();
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (OpenGLFrameBuffer)
 };
 
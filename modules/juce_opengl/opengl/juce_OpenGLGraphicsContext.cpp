@@ -22,6 +22,9 @@
   ==============================================================================
 */
 
+// (defined in juce_OpenGLImage.cpp)
+ImagePixelData::Ptr createPooledOpenGLImage (OpenGLContext&, int width, int height);
+
 namespace OpenGLRendering
 {
 
@@ -165,7 +168,8 @@ public:
           tiledImage (context),
           tiledImageMasked (context),
           copyTexture (context),
-          maskTexture (context)
+          maskTexture (context),
+          alphaTexture (context)
     {}
 
     typedef ReferenceCountedObjectPtr<ShaderPrograms> Ptr;
@@ -173,11 +177,13 @@ public:
     //==============================================================================
     struct ShaderProgramHolder
     {
-        ShaderProgramHolder (OpenGLContext& context, const char* fragmentShader)
+        ShaderProgramHolder (OpenGLContext& context, const char* fragmentShader, const char* vertexShader)
             : program (context)
         {
             JUCE_CHECK_OPENGL_ERROR
-            program.addShader ("attribute vec2 position;"
+
+            if (vertexShader == nullptr)
+                vertexShader = "attribute vec2 position;"
                                "attribute vec4 colour;"
                                "uniform vec4 screenBounds;"
                                "varying " JUCE_MEDIUMP " vec4 frontColour;"
@@ -189,8 +195,9 @@ public:
                                " pixelPos = adjustedPos;"
                                " vec2 scaledPos = adjustedPos / screenBounds.zw;"
                                " gl_Position = vec4 (scaledPos.x - 1.0, 1.0 - scaledPos.y, 0, 1.0);"
-                               "}", GL_VERTEX_SHADER);
+                               "}";
 
+            program.addShader (vertexShader, GL_VERTEX_SHADER);
             program.addShader (fragmentShader, GL_FRAGMENT_SHADER);
             program.link();
             JUCE_CHECK_OPENGL_ERROR
@@ -201,8 +208,8 @@ public:
 
     struct ShaderBase   : public ShaderProgramHolder
     {
-        ShaderBase (OpenGLContext& context, const char* fragmentShader)
-            : ShaderProgramHolder (context, fragmentShader),
+        ShaderBase (OpenGLContext& context, const char* fragmentShader, const char* vertexShader = nullptr)
+            : ShaderProgramHolder (context, fragmentShader, vertexShader),
               positionAttribute (program, "position"),
               colourAttribute (program, "colour"),
               screenBounds (program, "screenBounds")
@@ -213,15 +220,17 @@ public:
             screenBounds.set (bounds.getX(), bounds.getY(), 0.5f * bounds.getWidth(), 0.5f * bounds.getHeight());
         }
 
-        void bindAttributes (OpenGLContext& context)
+        virtual ~ShaderBase() {}
+
+        virtual void bindAttributes (OpenGLContext& context)
         {
-            context.extensions.glVertexAttribPointer (positionAttribute.attributeID, 2, GL_SHORT, GL_FALSE, 8, (void*) 0);
-            context.extensions.glVertexAttribPointer (colourAttribute.attributeID, 4, GL_UNSIGNED_BYTE, GL_TRUE, 8, (void*) 4);
+            context.extensions.glVertexAttribPointer (positionAttribute.attributeID, 2, GL_SHORT, GL_FALSE, 12, (void*) 0);
+            context.extensions.glVertexAttribPointer (colourAttribute.attributeID, 4, GL_UNSIGNED_BYTE, GL_TRUE, 12, (void*) 4);
             context.extensions.glEnableVertexAttribArray (positionAttribute.attributeID);
             context.extensions.glEnableVertexAttribArray (colourAttribute.attributeID);
         }
 
-        void unbindAttributes (OpenGLContext& context)
+        virtual void unbindAttributes (OpenGLContext& context)
         {
             context.extensions.glDisableVertexAttribArray (positionAttribute.attributeID);
             context.extensions.glDisableVertexAttribArray (colourAttribute.attributeID);
@@ -579,6 +588,60 @@ public:
         ImageParams imageParams;
     };
 
+    //==============================================================================
+    #define JUCE_DECLARE_VARYING_ALPHAPOS "varying " JUCE_HIGHP " vec2 alphaPos;"
+
+    // Fills quads from an alpha texture, using the texture position given for each vertex
+    struct AlphaTextureProgram  : public ShaderBase
+    {
+        AlphaTextureProgram (OpenGLContext& context)
+            : ShaderBase (context,
+                          "uniform sampler2D alphaTexture;"
+                          JUCE_DECLARE_VARYING_COLOUR JUCE_DECLARE_VARYING_ALPHAPOS
+                          "void main() {"
+                            "gl_FragColor = frontColour * texture2D (alphaTexture, alphaPos).a;"
+                          "}",
+                          "attribute vec2 position;"
+                          "attribute vec4 colour;"
+                          "attribute vec2 texturePosition;"
+                          "uniform vec4 screenBounds;"
+                          "uniform vec2 textureScale;"
+                          JUCE_DECLARE_VARYING_COLOUR JUCE_DECLARE_VARYING_ALPHAPOS
+                          "void main()"
+                          "{"
+                          " frontColour = colour;"
+                          " alphaPos = texturePosition * textureScale;"
+                          " vec2 scaledPos = (position - screenBounds.xy) / screenBounds.zw;"
+                          " gl_Position = vec4 (scaledPos.x - 1.0, 1.0 - scaledPos.y, 0, 1.0);"
+                          "}"),
+              texturePositionAttribute (program, "texturePosition"),
+              alphaTexture (program, "alphaTexture"),
+              textureScale (program, "textureScale")
+        {}
+
+        void bindAttributes (OpenGLContext& context)
+        {
+            ShaderBase::bindAttributes (context);
+            context.extensions.glVertexAttribPointer (texturePositionAttribute.attributeID, 2, GL_SHORT, GL_FALSE, 12, (void*) 8);
+            context.extensions.glEnableVertexAttribArray (texturePositionAttribute.attributeID);
+        }
+
+        void unbindAttributes (OpenGLContext& context)
+        {
+            context.extensions.glDisableVertexAttribArray (texturePositionAttribute.attributeID);
+            ShaderBase::unbindAttributes (context);
+        }
+
+        void setTextureSize (const int width, const int height) const
+        {
+            alphaTexture.set ((GLint) 0);
+            textureScale.set (1.0f / (float) width, 1.0f / (float) height);
+        }
+
+        OpenGLShaderProgram::Attribute texturePositionAttribute;
+        OpenGLShaderProgram::Uniform alphaTexture, textureScale;
+    };
+
     SolidColourProgram solidColourProgram;
     SolidColourMaskedProgram solidColourMasked;
     RadialGradientProgram radialGradient;
@@ -593,6 +656,7 @@ public:
     TiledImageMaskedProgram tiledImageMasked;
     CopyTextureProgram copyTexture;
     MaskTextureProgram maskTexture;
+    AlphaTextureProgram alphaTexture;
 };
 
 //==============================================================================
@@ -838,6 +902,19 @@ struct StateHelpers
             }
         }
 
+        /** Binds a texture, first flushing any quads that were queued using the old one. */
+        template <class QuadQueueType>
+        void bindTexture (QuadQueueType& quadQueue, const GLuint textureID) noexcept
+        {
+            jassert (currentActiveTexture >= 0);
+
+            if (currentTextureID [currentActiveTexture] != textureID)
+            {
+                quadQueue.flush();
+                bindTexture (textureID);
+            }
+        }
+
     private:
         GLuint currentTextureID [3];
         int texturesEnabled, currentActiveTexture;
@@ -882,21 +959,35 @@ struct StateHelpers
             {
                 gradientNeedsRefresh = false;
 
-                if (gradientTextures.size() < numGradientTexturesToCache)
+                typedef RenderingHelpers::GradientLookupTableCache::LookupTable LookupTable;
+                const LookupTable::Ptr lookup (RenderingHelpers::GradientLookupTableCache::getInstance()
+                                                    .getLookupTable (gradient, (int) gradientTextureSize));
+
+                // If one of our textures already holds this table, there's no need to upload it again..
+                const int existingIndex = gradientTextureTables.indexOf (lookup);
+
+                if (existingIndex >= 0)
                 {
-                    activeGradientIndex = gradientTextures.size();
-                    activeTextures.clear();
-                    gradientTextures.add (new OpenGLTexture());
+                    activeGradientIndex = existingIndex;
                 }
                 else
                 {
-                    activeGradientIndex = (activeGradientIndex + 1) % numGradientTexturesToCache;
-                }
+                    if (gradientTextures.size() < numGradientTexturesToCache)
+                    {
+                        activeGradientIndex = gradientTextures.size();
+                        activeTextures.clear();
+                        gradientTextures.add (new OpenGLTexture());
+                        gradientTextureTables.add (nullptr);
+                    }
+                    else
+                    {
+                        activeGradientIndex = (activeGradientIndex + 1) % numGradientTexturesToCache;
+                    }
 
-                JUCE_CHECK_OPENGL_ERROR;
-                PixelARGB lookup [gradientTextureSize];
-                gradient.createLookupTable (lookup, gradientTextureSize);
-                gradientTextures.getUnchecked (activeGradientIndex)->loadARGB (lookup, gradientTextureSize, 1);
+                    JUCE_CHECK_OPENGL_ERROR;
+                    gradientTextures.getUnchecked (activeGradientIndex)->loadARGB (lookup->table, gradientTextureSize, 1);
+                    gradientTextureTables.set (activeGradientIndex, lookup);
+                }
             }
 
             activeTextures.bindTexture (gradientTextures.getUnchecked (activeGradientIndex)->getTextureID());
@@ -907,6 +998,7 @@ struct StateHelpers
     private:
         enum { numTexturesToCache = 8, numGradientTexturesToCache = 10 };
         OwnedArray<OpenGLTexture> textures, gradientTextures;
+        ReferenceCountedArray<RenderingHelpers::GradientLookupTableCache::LookupTable> gradientTextureTables;
         int activeGradientIndex;
         bool gradientNeedsRefresh;
     };
@@ -920,7 +1012,7 @@ struct StateHelpers
 
         ~ShaderQuadQueue() noexcept
         {
-            static_jassert (sizeof (VertexInfo) == 8);
+            static_jassert (sizeof (VertexInfo) == 12);
             context.extensions.glBindBuffer (GL_ARRAY_BUFFER, 0);
             context.extensions.glBindBuffer (GL_ELEMENT_ARRAY_BUFFER, 0);
             context.extensions.glDeleteBuffers (2, buffers);
@@ -949,13 +1041,17 @@ struct StateHelpers
         {
             jassert (w > 0 && h > 0);
 
+            const GLuint rgba = colour.getInRGBAMemoryOrder();
+
+            if (extendQuadAbove (x, y, w, h, rgba))
+                return;
+
             VertexInfo* const v = vertexData + numVertices;
             v[0].x = v[2].x = (GLshort) x;
             v[0].y = v[1].y = (GLshort) y;
             v[1].x = v[3].x = (GLshort) (x + w);
             v[2].y = v[3].y = (GLshort) (y + h);
 
-            const GLuint rgba = colour.getInRGBAMemoryOrder();
             v[0].colour = rgba;
             v[1].colour = rgba;
             v[2].colour = rgba;
@@ -972,6 +1068,36 @@ struct StateHelpers
             add (r.getX(), r.getY(), r.getWidth(), r.getHeight(), colour);
         }
 
+        /** Adds a quad whose top-left corner maps onto the given texel of the current texture,
+            with one texel per pixel.
+        */
+        void add (const Rectangle<int>& r, const Point<int> texturePos, const PixelARGB colour) noexcept
+        {
+            jassert (! r.isEmpty());
+
+            VertexInfo* const v = vertexData + numVertices;
+            v[0].x = v[2].x = (GLshort) r.getX();
+            v[0].y = v[1].y = (GLshort) r.getY();
+            v[1].x = v[3].x = (GLshort) r.getRight();
+            v[2].y = v[3].y = (GLshort) r.getBottom();
+
+            v[0].textureX = v[2].textureX = (GLshort) texturePos.x;
+            v[0].textureY = v[1].textureY = (GLshort) texturePos.y;
+            v[1].textureX = v[3].textureX = (GLshort) (texturePos.x + r.getWidth());
+            v[2].textureY = v[3].textureY = (GLshort) (texturePos.y + r.getHeight());
+
+            const GLuint rgba = colour.getInRGBAMemoryOrder();
+            v[0].colour = rgba;
+            v[1].colour = rgba;
+            v[2].colour = rgba;
+            v[3].colour = rgba;
+
+            numVertices += 4;
+
+            if (numVertices > numQuads * 4 - 4)
+                draw();
+        }
+
         void add (const Rectangle<float>& r, const PixelARGB colour) noexcept
         {
             FloatRectangleRenderer<ShaderQuadQueue> frr (*this, colour);
@@ -1012,6 +1138,7 @@ struct StateHelpers
         {
             GLshort x, y;
             GLuint colour;
+            GLshort textureX, textureY;
         };
 
        #if JUCE_MAC || JUCE_ANDROID || JUCE_IOS
@@ -1020,14 +1147,43 @@ struct StateHelpers
         enum { numQuads = 64 }; // (had problems with my drivers segfaulting when these buffers are any larger)
        #endif
 
+        enum { maxQuadsToSearchForMerging = 32 };
+
         GLuint buffers[2];
         VertexInfo vertexData [numQuads * 4];
         GLushort indexData [numQuads * 6];
         const OpenGLContext& context;
         int numVertices;
 
+        // Edge tables produce lots of identical spans on successive lines, so rather than adding a
+        // new quad, this looks for one that ends just above it and can be stretched down to cover it.
+        // It gives up if it meets a quad that overlaps the new one, so the blending order is preserved.
+        bool extendQuadAbove (const int x, const int y, const int w, const int h, const GLuint rgba) noexcept
+        {
+            const int right = x + w, bottom = y + h;
+
+            const VertexInfo* const end = vertexData + jmax (0, numVertices - 4 * (int) maxQuadsToSearchForMerging);
+
+            for (VertexInfo* v = vertexData + numVertices; (v -= 4) >= end;)
+            {
+                if (v[0].x < right && v[1].x > x && v[0].y < bottom && v[2].y > y)
+                    break;
+
+                if (v[2].y == y && v[0].x == x && v[1].x == right && v[0].colour == rgba)
+                {
+                    v[2].y = v[3].y = (GLshort) bottom;
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
         void draw() noexcept
         {
+            // Orphaning the buffer's old contents lets the driver carry on using them for any
+            // draws that are still in flight, rather than stalling until they're finished.
+            context.extensions.glBufferData (GL_ARRAY_BUFFER, sizeof (vertexData), nullptr, GL_STREAM_DRAW);
             context.extensions.glBufferSubData (GL_ARRAY_BUFFER, 0, numVertices * sizeof (VertexInfo), vertexData);
             // NB: If you get a random crash in here and are running in a Parallels VM, it seems to be a bug in
             // their driver.. Can't find a workaround unfortunately.
@@ -1039,6 +1195,451 @@ struct StateHelpers
         JUCE_DECLARE_NON_COPYABLE (ShaderQuadQueue)
     };
 
+    //==============================================================================
+    /** Renders an edge table into a top-down alpha map of the given size. */
+    struct AlphaMap
+    {
+        AlphaMap (const EdgeTable& et, const int w, const int h)
+            : area (et.getMaximumBounds()), lineStride (w)
+        {
+            data.calloc ((size_t) (w * h));
+            et.iterate (*this);
+        }
+
+        inline void setEdgeTableYPos (const int y) noexcept
+        {
+            currentLine = data + (y - area.getY()) * lineStride - area.getX();
+        }
+
+        inline void handleEdgeTablePixel (const int x, const int alphaLevel) const noexcept
+        {
+            currentLine[x] = (uint8) alphaLevel;
+        }
+
+        inline void handleEdgeTablePixelFull (const int x) const noexcept
+        {
+            currentLine[x] = 255;
+        }
+
+        inline void handleEdgeTableLine (int x, int width, const int alphaLevel) const noexcept
+        {
+            memset (currentLine + x, (uint8) alphaLevel, (size_t) width);
+        }
+
+        inline void handleEdgeTableLineFull (int x, int width) const noexcept
+        {
+            memset (currentLine + x, 255, (size_t) width);
+        }
+
+        HeapBlock<uint8> data;
+
+    private:
+        const Rectangle<int> area;
+        const int lineStride;
+        uint8* currentLine;
+
+        JUCE_DECLARE_NON_COPYABLE (AlphaMap)
+    };
+
+    //==============================================================================
+    /** Keeps rendered glyphs in a set of alpha texture pages, so that text can be drawn as
+        textured quads rather than having to render each glyph's edge table as spans.
+
+        Each glyph is keyed by its typeface, size and a quantised sub-pixel x offset. New glyphs are
+        packed into horizontal shelves on the current page, and when that's full, a new page is
+        started or the one that was least recently used gets cleared out and reused. (Filling gaps
+        in older pages would scatter a string's glyphs across several textures, so isn't done).
+    */
+    struct GlyphAtlas  : public ReferenceCountedObject
+    {
+        GlyphAtlas()  : glyphs ((int) numHashSlots), currentPage (-1), accessCounter (0)
+        {}
+
+        typedef ReferenceCountedObjectPtr<GlyphAtlas> Ptr;
+
+        enum
+        {
+            pageSize = 1024,
+            maxNumPages = 4,
+            maxGlyphSize = 96,
+            numSubPixelPositions = 4
+        };
+
+        struct Key
+        {
+            Key (Typeface* t, const float h, const float hScale, const int glyph, const int subPixel) noexcept
+                : typeface (t), height (h), horizontalScale (hScale), glyphNumber (glyph), subPixelIndex (subPixel)
+            {}
+
+            bool operator== (const Key& other) const noexcept
+            {
+                return typeface == other.typeface && height == other.height && horizontalScale == other.horizontalScale
+                        && glyphNumber == other.glyphNumber && subPixelIndex == other.subPixelIndex;
+            }
+
+            static int generateHash (const Key& key, const int upperLimit) noexcept
+            {
+                uint32 h = (uint32) (pointer_sized_int) key.typeface;
+                h = h * 31 + (uint32) roundToInt (key.height * 64.0f);
+                h = h * 31 + (uint32) roundToInt (key.horizontalScale * 64.0f);
+                h = h * 31 + (uint32) key.glyphNumber;
+                h = h * 31 + (uint32) key.subPixelIndex;
+                return (int) (h % (uint32) upperLimit);
+            }
+
+            Typeface* typeface;
+            float height, horizontalScale;
+            int glyphNumber, subPixelIndex;
+        };
+
+        struct Glyph
+        {
+            Glyph (const Key& k, Typeface* t) noexcept  : key (k), typeface (t), pageIndex (-1) {}
+
+            Key key;
+            Typeface::Ptr typeface;
+            Rectangle<int> area;    // the glyph's pixel bounds, relative to its origin
+            Point<int> texturePos;  // the position of the top-left of the area within its page
+            int pageIndex;
+        };
+
+        /** Returns the atlas glyph for this font and position, rendering it if necessary. This may need
+            to flush the quad queue and bind a different texture, so it must be called before binding
+            the texture that the glyph will be drawn from.
+
+            Returns nullptr if the glyph is too big to go in the atlas, and should be drawn as a path.
+        */
+        const Glyph* getGlyph (ActiveTextures& activeTextures, ShaderQuadQueue& quadQueue,
+                               const Font& font, const int glyphNumber, const int subPixelIndex)
+        {
+            const float height = font.getHeight();
+
+            if (height > (float) maxGlyphSize)
+                return nullptr;
+
+            Typeface* const typeface = font.getTypeface();
+            const Key key (typeface, height, font.getHorizontalScale(), glyphNumber, subPixelIndex);
+
+            Glyph* g = glyphs [key];
+
+            if (g == nullptr)
+                g = createGlyph (activeTextures, quadQueue, key);
+
+            if (g->pageIndex >= 0)
+                pages.getUnchecked (g->pageIndex)->lastUsed = ++accessCounter;
+            else if (! g->area.isEmpty())
+                return nullptr;
+
+            return g;
+        }
+
+        GLuint getPageTextureID (const int pageIndex) const noexcept
+        {
+            return pages.getUnchecked (pageIndex)->texture.getTextureID();
+        }
+
+    private:
+        struct Shelf
+        {
+            int y, height, nextX;
+        };
+
+        struct Page
+        {
+            Page() noexcept : lastUsed (0) {}
+
+            bool allocate (const int w, const int h, Point<int>& pos)
+            {
+                for (int i = 0; i < shelves.size(); ++i)
+                {
+                    Shelf& s = shelves.getReference (i);
+
+                    // (avoid putting small glyphs on shelves that are much taller than they need)
+                    if (h <= s.height && h * 4 >= s.height * 3 && s.nextX + w <= (int) pageSize)
+                    {
+                        pos.setXY (s.nextX, s.y);
+                        s.nextX += w;
+                        return true;
+                    }
+                }
+
+                const int y = shelves.size() > 0 ? shelves.getLast().y + shelves.getLast().height : 0;
+
+                if (y + h > (int) pageSize)
+                    return false;
+
+                const Shelf s = { y, h, w };
+                shelves.add (s);
+                pos.setXY (0, y);
+                return true;
+            }
+
+            OpenGLTexture texture;
+            Array<Shelf> shelves;
+            OwnedArray<Glyph> glyphs;
+            int lastUsed;
+
+            JUCE_DECLARE_NON_COPYABLE (Page)
+        };
+
+        enum { numHashSlots = 1031, maxNumUnpackedGlyphs = 1024 };
+
+        HashMap<Key, Glyph*, Key> glyphs;
+        OwnedArray<Page> pages;
+        OwnedArray<Glyph> unpackedGlyphs; // (empty ones, and ones too big to go in a page)
+        int currentPage, accessCounter;
+
+        Glyph* createGlyph (ActiveTextures& activeTextures, ShaderQuadQueue& quadQueue, const Key& key)
+        {
+            const ScopedPointer<EdgeTable> et (key.typeface->getEdgeTableForGlyph (key.glyphNumber,
+                                                  AffineTransform::scale (key.height * key.horizontalScale, key.height)
+                                                                  #if JUCE_MAC || JUCE_IOS
+                                                                    .translated (0.0f, -0.5f)
+                                                                  #endif
+                                                                  .translated (key.subPixelIndex / (float) numSubPixelPositions, 0.0f)));
+
+            Glyph* const g = new Glyph (key, key.typeface);
+
+            if (et != nullptr && ! et->isEmpty())
+            {
+                g->area = et->getMaximumBounds();
+
+                // each glyph is padded with an extra row and column of blank texels
+                const int w = g->area.getWidth() + 1;
+                const int h = g->area.getHeight() + 1;
+
+                if (w <= (int) maxGlyphSize && h <= (int) maxGlyphSize)
+                {
+                    g->pageIndex = allocate (activeTextures, quadQueue, w, h, g->texturePos);
+
+                    const AlphaMap alphaMap (*et, w, h);
+                    activeTextures.bindTexture (quadQueue, getPageTextureID (g->pageIndex));
+                    glPixelStorei (GL_UNPACK_ALIGNMENT, 1);
+                    glTexSubImage2D (GL_TEXTURE_2D, 0, g->texturePos.x, g->texturePos.y, w, h,
+                                     GL_ALPHA, GL_UNSIGNED_BYTE, alphaMap.data);
+                    JUCE_CHECK_OPENGL_ERROR
+
+                    pages.getUnchecked (g->pageIndex)->glyphs.add (g);
+                    glyphs.set (key, g);
+                    return g;
+                }
+            }
+
+            if (unpackedGlyphs.size() >= (int) maxNumUnpackedGlyphs)
+            {
+                for (int i = unpackedGlyphs.size(); --i >= 0;)
+                    glyphs.remove (unpackedGlyphs.getUnchecked (i)->key);
+
+                unpackedGlyphs.clear();
+            }
+
+            unpackedGlyphs.add (g);
+            glyphs.set (key, g);
+            return g;
+        }
+
+        int allocate (ActiveTextures& activeTextures, ShaderQuadQueue& quadQueue, const int w, const int h, Point<int>& pos)
+        {
+            if (currentPage >= 0 && pages.getUnchecked (currentPage)->allocate (w, h, pos))
+                return currentPage;
+
+            if (pages.size() < (int) maxNumPages)
+            {
+                quadQueue.flush();
+
+                Page* const page = new Page();
+                pages.add (page);
+
+                HeapBlock<uint8> blank ((size_t) (pageSize * pageSize), true);
+                page->texture.loadAlpha (blank, pageSize, pageSize);
+                glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+                glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+                activeTextures.clear();
+
+                page->allocate (w, h, pos);
+                currentPage = pages.size() - 1;
+                return currentPage;
+            }
+
+            int oldest = 0;
+
+            for (int i = 1; i < pages.size(); ++i)
+                if (pages.getUnchecked (i)->lastUsed < pages.getUnchecked (oldest)->lastUsed)
+                    oldest = i;
+
+            // there may be quads still waiting to be drawn from the page that's being reused
+            quadQueue.flush();
+
+            Page& page = *pages.getUnchecked (oldest);
+
+            for (int i = page.glyphs.size(); --i >= 0;)
+                glyphs.remove (page.glyphs.getUnchecked (i)->key);
+
+            page.glyphs.clear();
+            page.shelves.clearQuick();
+            page.allocate (w, h, pos);
+            currentPage = oldest;
+            return currentPage;
+        }
+
+        JUCE_DECLARE_NON_COPYABLE (GlyphAtlas)
+    };
+
+    //==============================================================================
+    /** Keeps the rendered coverage of recently-filled paths in alpha textures, so that filling
+        the same path again with the same transform only needs a single textured quad.
+
+        The transform is matched without its whole-pixel translation, so a path that just moves
+        around by whole pixels can still be reused. A path is only given a texture the second
+        time it's seen, so that ones which change every time they're drawn don't keep pushing
+        the useful entries out of the cache.
+    */
+    struct PathCache  : public ReferenceCountedObject
+    {
+        PathCache()  : accessCounter (0), totalTextureBytes (0)
+        {}
+
+        typedef ReferenceCountedObjectPtr<PathCache> Ptr;
+
+        struct CachedPath
+        {
+            CachedPath (const Path& p, const int64 h, const AffineTransform& t)
+                : path (p), hash (h), transform (t), lastUsed (0)
+            {}
+
+            Path path;
+            int64 hash;
+            AffineTransform transform;  // the transform that was used, minus its whole-pixel translation
+            Rectangle<int> area;        // the area covered by the path, when drawn with that transform
+            OpenGLTexture texture;
+            int lastUsed;
+
+            JUCE_DECLARE_NON_COPYABLE (CachedPath)
+        };
+
+        /** Returns the cached texture for filling this path, creating it if the path has been seen
+            recently. The whole-pixel offset at which the texture's area should be drawn is returned
+            in offset. This may need to flush the quad queue and create textures, so must be called
+            before binding the texture that the path will be drawn from.
+
+            Returns nullptr if the path isn't cached, and should be filled as an edge table.
+        */
+        const CachedPath* getPath (ActiveTextures& activeTextures, ShaderQuadQueue& quadQueue,
+                                   const Path& path, const AffineTransform& transform, Point<int>& offset)
+        {
+            const Rectangle<float> bounds (path.getBoundsTransformed (transform));
+
+            if (bounds.getWidth() * bounds.getHeight() > (float) maxPathArea || bounds.isEmpty())
+                return nullptr;
+
+            const int dx = (int) std::floor (transform.getTranslationX());
+            const int dy = (int) std::floor (transform.getTranslationY());
+            const AffineTransform t (transform.translated ((float) -dx, (float) -dy));
+            const int64 hash = getHash (path, t);
+
+            offset.setXY (dx, dy);
+
+            for (int i = cachedPaths.size(); --i >= 0;)
+            {
+                CachedPath* const c = cachedPaths.getUnchecked (i);
+
+                if (c->hash == hash && c->transform == t && c->path == path)
+                {
+                    c->lastUsed = ++accessCounter;
+                    return c;
+                }
+            }
+
+            const int seenIndex = recentlySeen.indexOf (hash);
+
+            if (seenIndex >= 0)
+            {
+                recentlySeen.remove (seenIndex);
+                return createPath (activeTextures, quadQueue, path, hash, t);
+            }
+
+            if (recentlySeen.size() >= (int) maxNumRecentlySeen)
+                recentlySeen.remove (0);
+
+            recentlySeen.add (hash);
+            return nullptr;
+        }
+
+    private:
+        enum
+        {
+            maxPathArea = 256 * 256,
+            maxNumCachedPaths = 256,
+            maxNumRecentlySeen = 256,
+            maxTextureBytes = 8 * 1024 * 1024
+        };
+
+        OwnedArray<CachedPath> cachedPaths;
+        Array<int64> recentlySeen;
+        int accessCounter, totalTextureBytes;
+
+        static int64 getHash (const Path& path, const AffineTransform& t) noexcept
+        {
+            const float values[] = { t.mat00, t.mat01, t.mat02, t.mat10, t.mat11, t.mat12 };
+            int64 hash = path.hashCode64();
+
+            for (int i = 0; i < numElementsInArray (values); ++i)
+                hash = hash * 101 + roundToInt (values[i] * 4096.0f);
+
+            return hash;
+        }
+
+        CachedPath* createPath (ActiveTextures& activeTextures, ShaderQuadQueue& quadQueue,
+                                const Path& path, const int64 hash, const AffineTransform& t)
+        {
+            const EdgeTable et (path.getBoundsTransformed (t).getSmallestIntegerContainer().expanded (1, 1), path, t);
+
+            if (et.getMaximumBounds().isEmpty())
+                return nullptr;
+
+            // there may be quads waiting to be drawn using the texture that gets deleted or rebound here
+            quadQueue.flush();
+
+            CachedPath* const c = new CachedPath (path, hash, t);
+            c->area = et.getMaximumBounds();
+            c->lastUsed = ++accessCounter;
+
+            const AlphaMap alphaMap (et, c->area.getWidth(), c->area.getHeight());
+            c->texture.loadAlpha (alphaMap.data, c->area.getWidth(), c->area.getHeight());
+            glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+            glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+            activeTextures.clear();
+
+            totalTextureBytes += getTextureBytes (*c);
+            cachedPaths.add (c);
+
+            while (cachedPaths.size() > (int) maxNumCachedPaths
+                    || (totalTextureBytes > (int) maxTextureBytes && cachedPaths.size() > 1))
+                removeLeastRecentlyUsed();
+
+            return c;
+        }
+
+        void removeLeastRecentlyUsed()
+        {
+            int oldest = 0;
+
+            for (int i = 1; i < cachedPaths.size(); ++i)
+                if (cachedPaths.getUnchecked (i)->lastUsed < cachedPaths.getUnchecked (oldest)->lastUsed)
+                    oldest = i;
+
+            totalTextureBytes -= getTextureBytes (*cachedPaths.getUnchecked (oldest));
+            cachedPaths.remove (oldest);
+        }
+
+        static int getTextureBytes (const CachedPath& c) noexcept
+        {
+            return c.texture.getWidth() * c.texture.getHeight();
+        }
+
+        JUCE_DECLARE_NON_COPYABLE (PathCache)
+    };
+
     //==============================================================================
     struct CurrentShader
     {
@@ -1124,6 +1725,26 @@ public:
         activeTextures.clear();
         shaderQuadQueue.initialise();
         JUCE_CHECK_OPENGL_ERROR
+
+        const char glyphAtlasValueID[] = "GraphicsContextGlyphAtlas";
+        glyphAtlas = static_cast <StateHelpers::GlyphAtlas*> (target.context.getAssociatedObject (glyphAtlasValueID));
+
+        if (glyphAtlas == nullptr)
+        {
+            glyphAtlas = new StateHelpers::GlyphAtlas();
+            target.context.setAssociatedObject (glyphAtlasValueID, glyphAtlas);
+        }
+
+        const char pathCacheValueID[] = "GraphicsContextPathCache";
+        pathCache = static_cast <StateHelpers::PathCache*> (target.context.getAssociatedObject (pathCacheValueID));
+
+        if (pathCache == nullptr)
+        {
+            pathCache = new StateHelpers::PathCache();
+            target.context.setAssociatedObject (pathCacheValueID, pathCache);
+        }
+
+        OpenGLResourcePool::getFor (target.context).releaseIdleResources();
     }
 
     ~GLState()
@@ -1302,6 +1923,8 @@ public:
     StateHelpers::TextureCache textureCache;
     StateHelpers::CurrentShader currentShader;
     StateHelpers::ShaderQuadQueue shaderQuadQueue;
+    StateHelpers::GlyphAtlas::Ptr glyphAtlas;
+    StateHelpers::PathCache::Ptr pathCache;
 
 private:
     GLuint previousFrameBufferTarget;
@@ -1329,6 +1952,8 @@ public:
     virtual void fillEdgeTable (EdgeTable& et, const FillType& fill) = 0;
     virtual void drawImage (const Image&, const AffineTransform&, float alpha,
                             const Rectangle<int>& clip, EdgeTable* mask) = 0;
+    virtual bool drawGlyphFromAtlas (const Font&, int glyphNumber, float x, float y, const PixelARGB colour) = 0;
+    virtual bool fillPathFromCache (const Path&, const AffineTransform&, const PixelARGB colour) = 0;
 
     GLState& state;
 
@@ -1350,7 +1975,7 @@ public:
         state.shaderQuadQueue.flush();
         state.activeTextures.setSingleTextureMode (state.shaderQuadQueue);
         state.activeTextures.clear();
-        mask.initialise (state.target.context, maskArea.getWidth(), maskArea.getHeight());
+        mask.initialiseFromPool (state.target.context, maskArea.getWidth(), maskArea.getHeight());
         maskArea.setSize (mask.getWidth(), mask.getHeight());
         makeActive();
 
@@ -1378,7 +2003,7 @@ public:
         state.currentShader.clearShader (state.shaderQuadQueue);
         state.shaderQuadQueue.flush();
         state.activeTextures.clear();
-        mask.initialise (state.target.context, maskArea.getWidth(), maskArea.getHeight());
+        mask.initialiseFromPool (state.target.context, maskArea.getWidth(), maskArea.getHeight());
         maskArea.setSize (mask.getWidth(), mask.getHeight());
         mask.makeCurrentAndClear();
         makeActive();
@@ -1446,9 +2071,13 @@ public:
             state.shaderQuadQueue.flush();
             state.activeTextures.clear();
 
-            OpenGLTexture texture;
-            PositionedTexture pt (texture, et, clip);
-            return clipToTexture (pt);
+            OpenGLResourcePool& pool = OpenGLResourcePool::getFor (state.target.context);
+            ScopedPointer<OpenGLTexture> texture (pool.takeTexture (et.getMaximumBounds().getWidth(),
+                                                                    et.getMaximumBounds().getHeight()));
+            PositionedTexture pt (*texture, et, clip);
+            Ptr result (clipToTexture (pt));
+            pool.returnTexture (texture.release());
+            return result;
         }
 
         return Ptr();
@@ -1555,6 +2184,16 @@ public:
         state.currentShader.clearShader (state.shaderQuadQueue);
     }
 
+    bool drawGlyphFromAtlas (const Font&, int, float, float, const PixelARGB)
+    {
+        return false; // (the atlas quads can't be masked, so these glyphs get drawn as edge tables)
+    }
+
+    bool fillPathFromCache (const Path&, const AffineTransform&, const PixelARGB)
+    {
+        return false;
+    }
+
 private:
     OpenGLFrameBuffer mask;
     Rectangle<int> clip, maskArea;
@@ -1704,6 +2343,82 @@ public:
         }
     }
 
+    bool drawGlyphFromAtlas (const Font& font, const int glyphNumber, float x, const float y, const PixelARGB colour)
+    {
+        if (font.getTypeface()->isHinted())
+            x = std::floor (x + 0.5f);
+
+        const int fixedPointX = (int) (x * 256.0f);
+        int subPixelIndex = ((fixedPointX & 255) * StateHelpers::GlyphAtlas::numSubPixelPositions + 128) >> 8;
+        int glyphX = fixedPointX >> 8;
+
+        if (subPixelIndex == StateHelpers::GlyphAtlas::numSubPixelPositions)
+        {
+            subPixelIndex = 0;
+            ++glyphX;
+        }
+
+        state.activeTextures.setSingleTextureMode (state.shaderQuadQueue);
+
+        const StateHelpers::GlyphAtlas::Glyph* const glyph
+            = state.glyphAtlas->getGlyph (state.activeTextures, state.shaderQuadQueue, font, glyphNumber, subPixelIndex);
+
+        if (glyph == nullptr)
+            return false;
+
+        const Rectangle<int> area (glyph->area.translated (glyphX, roundToInt (y)));
+
+        if (area.isEmpty() || ! clip.intersectsRectangle (area))
+            return true;
+
+        state.activeTextures.bindTexture (state.shaderQuadQueue, state.glyphAtlas->getPageTextureID (glyph->pageIndex));
+        state.blendMode.setPremultipliedBlendingMode (state.shaderQuadQueue);
+        state.setShader (state.currentShader.programs->alphaTexture);
+        state.currentShader.programs->alphaTexture.setTextureSize (StateHelpers::GlyphAtlas::pageSize,
+                                                                   StateHelpers::GlyphAtlas::pageSize);
+
+        for (const Rectangle<int>* i = clip.begin(), * const e = clip.end(); i != e; ++i)
+        {
+            const Rectangle<int> r (i->getIntersection (area));
+
+            if (! r.isEmpty())
+                state.shaderQuadQueue.add (r, glyph->texturePos + (r.getPosition() - area.getPosition()), colour);
+        }
+
+        return true;
+    }
+
+    bool fillPathFromCache (const Path& path, const AffineTransform& transform, const PixelARGB colour)
+    {
+        Point<int> offset;
+        const StateHelpers::PathCache::CachedPath* const cached
+            = state.pathCache->getPath (state.activeTextures, state.shaderQuadQueue, path, transform, offset);
+
+        if (cached == nullptr)
+            return false;
+
+        const Rectangle<int> area (cached->area + offset);
+
+        if (! clip.intersectsRectangle (area))
+            return true;
+
+        state.activeTextures.setSingleTextureMode (state.shaderQuadQueue);
+        state.activeTextures.bindTexture (state.shaderQuadQueue, cached->texture.getTextureID());
+        state.blendMode.setPremultipliedBlendingMode (state.shaderQuadQueue);
+        state.setShader (state.currentShader.programs->alphaTexture);
+        state.currentShader.programs->alphaTexture.setTextureSize (cached->texture.getWidth(), cached->texture.getHeight());
+
+        for (const Rectangle<int>* i = clip.begin(), * const e = clip.end(); i != e; ++i)
+        {
+            const Rectangle<int> r (i->getIntersection (area));
+
+            if (! r.isEmpty())
+                state.shaderQuadQueue.add (r, r.getPosition() - area.getPosition(), colour);
+        }
+
+        return true;
+    }
+
     Rectangle<int> getClipBounds() const                { return clip.getBounds(); }
     Ptr clipToRectangle (const Rectangle<int>& r)       { return clip.clipTo (r) ? this : nullptr; }
     Ptr clipToRectangleList (const RectangleList& r)    { return clip.clipTo (r) ? this : nullptr; }
@@ -1901,7 +2616,7 @@ public:
             const Rectangle<int> clipBounds (clip->getClipBounds());
 
             state->flush();
-            s->transparencyLayer = Image (OpenGLImageType().create (Image::ARGB, clipBounds.getWidth(), clipBounds.getHeight(), true));
+            s->transparencyLayer = Image (createPooledOpenGLImage (state->target.context, clipBounds.getWidth(), clipBounds.getHeight()));
             s->previousTarget = new Target (state->target);
             state->target = Target (state->target.context, *OpenGLImageType::getFrameBufferFrom (s->transparencyLayer), clipBounds.getPosition());
             s->transparencyLayerAlpha = opacity;
@@ -1976,6 +2691,10 @@ public:
     {
         if (clip != nullptr)
         {
+            if (fillType.isColour()
+                 && clip->fillPathFromCache (path, transform.getTransformWith (t), fillType.colour.getPixelARGB()))
+                return;
+
             EdgeTable et (clip->getClipBounds(), path, transform.getTransformWith (t));
             fillEdgeTable (et);
         }
@@ -1987,6 +2706,13 @@ public:
         {
             if (transform.isOnlyTranslated && t.isOnlyTranslation())
             {
+                if (fillType.isColour()
+                     && clip->drawGlyphFromAtlas (font, glyphNumber,
+                                                  transform.xOffset + t.getTranslationX(),
+                                                  transform.yOffset + t.getTranslationY(),
+                                                  fillType.colour.getPixelARGB()))
+                    return;
+
                 RenderingHelpers::GlyphCache <RenderingHelpers::CachedGlyphEdgeTable <SavedState>, SavedState>::getInstance()
                     .drawGlyph (*this, font, glyphNumber,
                                 transform.xOffset + t.getTranslationX(),
@@ -2172,16 +2898,18 @@ public:
         clearGLError();
        #endif
 
-        OpenGLTexture texture;
-        texture.loadImage (image);
-        texture.bind();
+        OpenGLResourcePool& pool = OpenGLResourcePool::getFor (target.context);
+        ScopedPointer<OpenGLTexture> texture (pool.takeTexture (image.getWidth(), image.getHeight()));
+        texture->loadImage (image);
+        texture->bind();
 
         target.makeActive();
-        target.context.copyTexture (target.bounds, Rectangle<int> (texture.getWidth(),
-                                                                   texture.getHeight()),
+        target.context.copyTexture (target.bounds, Rectangle<int> (texture->getWidth(),
+                                                                   texture->getHeight()),
                                     target.bounds.getWidth(), target.bounds.getHeight(),
                                     false);
         glBindTexture (GL_TEXTURE_2D, 0);
+        pool.returnTexture (texture.release());
 
        #if JUCE_WINDOWS
         if (target.context.extensions.glBindFramebuffer != nullptr)
@@ -262,13 +262,18 @@ OpenGLTextureFromImage::OpenGLTextureFromImage (const Image& image)
     JUCE_CHECK_OPENGL_ERROR
     if (OpenGLFrameBuffer* const fb = OpenGLImageType::getFrameBufferFrom (image))
     {
+        // (the frame buffer may be bigger than the image if it came from an OpenGLResourcePool)
         textureID = fb->getTextureID();
-        fullWidthProportion  = 1.0f;
-        fullHeightProportion = 1.0f;
+        fullWidthProportion  = imageWidth  / (float) fb->getWidth();
+        fullHeightProportion = imageHeight / (float) fb->getHeight();
     }
     else
     {
-        texture = new OpenGLTexture();
+        if (OpenGLContext* const context = OpenGLContext::getCurrentContext())
+            texture = OpenGLResourcePool::getFor (*context).takeTexture (imageWidth, imageHeight);
+        else
+            texture = new OpenGLTexture();
+
         texture->loadImage (image);
         textureID = texture->getTextureID();
 
@@ -279,4 +284,9 @@ OpenGLTextureFromImage::OpenGLTextureFromImage (const Image& image)
     JUCE_CHECK_OPENGL_ERROR
 }
 
-OpenGLTextureFromImage::~OpenGLTextureFromImage() {}
+OpenGLTextureFromImage::~OpenGLTextureFromImage()
+{
+    if (texture != nullptr)
+        if (OpenGLContext* const context = OpenGLContext::getCurrentContext())
+            OpenGLResourcePool::getFor (*context).returnTexture (texture.release());
+}
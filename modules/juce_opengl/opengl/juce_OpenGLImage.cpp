@@ -33,9 +33,10 @@ public:
     {
     }
 
-    bool initialise()
+    bool initialise (const bool useResourcePool)
     {
-        return frameBuffer.initialise (context, width, height);
+        return useResourcePool ? frameBuffer.initialiseFromPool (context, width, height)
+                               : frameBuffer.initialise (context, width, height);
     }
 
     LowLevelGraphicsContext* createLowLevelContext()
@@ -186,7 +187,20 @@ ImagePixelData::Ptr OpenGLImageType::create (Image::PixelFormat, int width, int
 
     ScopedPointer<OpenGLFrameBufferImage> im (new OpenGLFrameBufferImage (*currentContext, width, height));
 
-    if (! im->initialise())
+    if (! im->initialise (false))
+        return nullptr;
+
+    im->frameBuffer.clear (Colours::transparentBlack);
+    return im.release();
+}
+
+// Creates a temporary image for the graphics context, whose frame buffer comes from the
+// context's OpenGLResourcePool, and may be bigger than the image
+ImagePixelData::Ptr createPooledOpenGLImage (OpenGLContext& context, int width, int height)
+{
+    ScopedPointer<OpenGLFrameBufferImage> im (new OpenGLFrameBufferImage (context, width, height));
+
+    if (! im->initialise (true))
         return nullptr;
 
     im->frameBuffer.clear (Colours::transparentBlack);
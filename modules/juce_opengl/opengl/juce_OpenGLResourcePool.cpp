@@ -0,0 +1,186 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+
+struct OpenGLResourcePool::SpareObject
+{
+    SpareObject (OpenGLFrameBuffer::Pimpl* fb) noexcept
+        : frameBuffer (fb), width (fb->width), height (fb->height),
+          lastUsed (Time::getMillisecondCounter())
+    {}
+
+    SpareObject (OpenGLTexture* t) noexcept
+        : texture (t), width (t->getWidth()), height (t->getHeight()),
+          lastUsed (Time::getMillisecondCounter())
+    {}
+
+    size_t getNumBytes() const noexcept     { return sizeof (PixelARGB) * (size_t) (width * height); }
+
+    ScopedPointer<OpenGLFrameBuffer::Pimpl> frameBuffer;
+    ScopedPointer<OpenGLTexture> texture;
+    const int width, height;
+    const uint32 lastUsed;
+
+    JUCE_DECLARE_NON_COPYABLE (SpareObject)
+};
+
+//==============================================================================
+OpenGLResourcePool::OpenGLResourcePool()
+    : spareBytes (0), memoryLimit (32 * 1024 * 1024), maxIdleTime (10000)
+{
+}
+
+OpenGLResourcePool::~OpenGLResourcePool()
+{
+}
+
+OpenGLResourcePool& OpenGLResourcePool::getFor (OpenGLContext& context)
+{
+    static const char poolValueID[] = "OpenGLResourcePool";
+    OpenGLResourcePool* pool = static_cast <OpenGLResourcePool*> (context.getAssociatedObject (poolValueID));
+
+    if (pool == nullptr)
+    {
+        pool = new OpenGLResourcePool();
+        context.setAssociatedObject (poolValueID, pool);
+    }
+
+    return *pool;
+}
+
+int OpenGLResourcePool::getBucketSize (const int size) noexcept
+{
+    return (jmax (1, size) + 63) & ~63;
+}
+
+//==============================================================================
+void OpenGLResourcePool::setMemoryLimit (const size_t maxBytes)
+{
+    memoryLimit = maxBytes;
+    releaseIdleResources();
+}
+
+void OpenGLResourcePool::setMaxIdleTime (const int milliseconds)
+{
+    maxIdleTime = jmax (0, milliseconds);
+    releaseIdleResources();
+}
+
+void OpenGLResourcePool::releaseIdleResources()
+{
+    const uint32 now = Time::getMillisecondCounter();
+
+    // (the objects are kept in the order they were returned, so the oldest come first)
+    while (spareObjects.size() > 0
+            && (spareBytes > memoryLimit
+                 || (int) (now - spareObjects.getUnchecked (0)->lastUsed) > maxIdleTime))
+        removeSpareObject (0);
+}
+
+void OpenGLResourcePool::releaseAll()
+{
+    while (spareObjects.size() > 0)
+        removeSpareObject (spareObjects.size() - 1);
+}
+
+//==============================================================================
+OpenGLTexture* OpenGLResourcePool::takeTexture (const int width, const int height)
+{
+    const int textureW = nextPowerOfTwo (width);
+    const int textureH = nextPowerOfTwo (height);
+    int bestIndex = -1;
+
+    for (int i = spareObjects.size(); --i >= 0;)
+    {
+        const SpareObject& spare = *spareObjects.getUnchecked (i);
+
+        if (spare.texture != nullptr)
+        {
+            if (spare.width == textureW && spare.height == textureH)
+            {
+                bestIndex = i;
+                break;
+            }
+
+            if (bestIndex < 0)
+                bestIndex = i;
+        }
+    }
+
+    if (bestIndex < 0)
+        return new OpenGLTexture();
+
+    spareBytes -= spareObjects.getUnchecked (bestIndex)->getNumBytes();
+    ScopedPointer<SpareObject> spare (spareObjects.removeAndReturn (bestIndex));
+    return spare->texture.release();
+}
+
+void OpenGLResourcePool::returnTexture (OpenGLTexture* const texture)
+{
+    if (texture != nullptr)
+    {
+        if (texture->getTextureID() != 0)
+            addSpareObject (new SpareObject (texture));
+        else
+            delete texture;
+    }
+}
+
+OpenGLFrameBuffer::Pimpl* OpenGLResourcePool::takeFrameBuffer (const int width, const int height)
+{
+    const int bucketW = getBucketSize (width);
+    const int bucketH = getBucketSize (height);
+
+    for (int i = spareObjects.size(); --i >= 0;)
+    {
+        const SpareObject& spare = *spareObjects.getUnchecked (i);
+
+        if (spare.frameBuffer != nullptr && spare.width == bucketW && spare.height == bucketH)
+        {
+            spareBytes -= spare.getNumBytes();
+            ScopedPointer<SpareObject> s (spareObjects.removeAndReturn (i));
+            return s->frameBuffer.release();
+        }
+    }
+
+    return nullptr;
+}
+
+void OpenGLResourcePool::returnFrameBuffer (OpenGLFrameBuffer::Pimpl* const fb)
+{
+    addSpareObject (new SpareObject (fb));
+}
+
+void OpenGLResourcePool::addSpareObject (SpareObject* const spare)
+{
+    spareObjects.add (spare);
+    spareBytes += spare->getNumBytes();
+    releaseIdleResources();
+}
+
+void OpenGLResourcePool::removeSpareObject (const int index)
+{
+    spareBytes -= spareObjects.getUnchecked (index)->getNumBytes();
+    spareObjects.remove (index);
+}
@@ -0,0 +1,126 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+
+#ifndef __JUCE_OPENGLRESOURCEPOOL_JUCEHEADER__
+#define __JUCE_OPENGLRESOURCEPOOL_JUCEHEADER__
+
+#include "juce_OpenGLFrameBuffer.h"
+class OpenGLTexture;
+
+
+//==============================================================================
+/**
+    Keeps hold of spare frame buffers and textures for an OpenGLContext, so that
+    temporary ones can be re-used rather than being created and deleted on every frame.
+
+    The pool belongs to the context, and is found with getFor(). Frame buffers that are
+    created with OpenGLFrameBuffer::initialiseFromPool() go back into the pool when
+    they're released, and textures can be borrowed and returned with takeTexture()
+    and returnTexture(). The OpenGL graphics context uses it for its transparency
+    layers, clip masks and temporary image textures, and the component image that an
+    attached context renders into also comes from it.
+
+    To stop the pool from holding on to too much GPU memory, the spare objects that have
+    been unused for longest are deleted when their total size goes over a limit, and any
+    that haven't been used for a while are also deleted.
+
+    @see OpenGLFrameBuffer::initialiseFromPool
+*/
+class JUCE_API  OpenGLResourcePool  : public ReferenceCountedObject
+{
+public:
+    /** Creates an empty pool.
+        You'll normally use getFor() rather than creating one of these yourself.
+    */
+    OpenGLResourcePool();
+
+    /** Destructor. */
+    ~OpenGLResourcePool();
+
+    /** Returns the pool that belongs to a context, creating it if there isn't one yet.
+        The pool is attached to the context with OpenGLContext::setAssociatedObject(), so
+        this must only be called while the context is active on its rendering thread.
+    */
+    static OpenGLResourcePool& getFor (OpenGLContext& context);
+
+    //==============================================================================
+    /** Sets the maximum number of bytes of GPU memory that the spare objects may use.
+        The default is 32MB.
+    */
+    void setMemoryLimit (size_t maxBytes);
+
+    /** Sets the time after which an unused spare object is deleted.
+        The default is 10 seconds.
+    */
+    void setMaxIdleTime (int milliseconds);
+
+    /** Returns the number of bytes of GPU memory that the spare objects are using. */
+    size_t getSpareMemorySize() const noexcept                  { return spareBytes; }
+
+    /** Deletes any spare objects that have been unused for longer than the maximum idle
+        time. The OpenGL graphics context calls this each time it's created.
+    */
+    void releaseIdleResources();
+
+    /** Deletes all the spare objects. */
+    void releaseAll();
+
+    //==============================================================================
+    /** Takes a texture out of the pool, preferably one that's already the right size for
+        an image of the given dimensions, or creates a new one if there isn't a spare.
+        The caller owns the texture, and can give it back with returnTexture().
+    */
+    OpenGLTexture* takeTexture (int width, int height);
+
+    /** Gives a texture back to the pool.
+        The pool takes ownership of it, and if it's already over its memory limit, the
+        texture (or an older spare) will be deleted straight away.
+    */
+    void returnTexture (OpenGLTexture* texture);
+
+    /** Returns the width or height that a frame buffer from the pool will have when a
+        given size is asked for. Sizes are rounded up to multiples of 64 pixels, so that
+        buffers of similar sizes can be swapped for each other.
+    */
+    static int getBucketSize (int size) noexcept;
+
+private:
+    //==============================================================================
+    friend class OpenGLFrameBuffer;
+    struct SpareObject;
+    OwnedArray<SpareObject> spareObjects;
+    size_t spareBytes, memoryLimit;
+    int maxIdleTime;
+
+    OpenGLFrameBuffer::Pimpl* takeFrameBuffer (int width, int height);
+    void returnFrameBuffer (OpenGLFrameBuffer::Pimpl*);
+    void addSpareObject (SpareObject*);
+    void removeSpareObject (int index);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (OpenGLResourcePool)
+};
+
+
+#endif   // __JUCE_OPENGLRESOURCEPOOL_JUCEHEADER__
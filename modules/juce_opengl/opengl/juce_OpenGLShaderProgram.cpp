@@ -24,6 +24,71 @@
 
 #if JUCE_USE_OPENGL_SHADERS
 
+#if JUCE_WINDOWS
+ #define JUCE_GL_PROGRAM_BINARY_STDCALL __stdcall
+#else
+ #define JUCE_GL_PROGRAM_BINARY_STDCALL
+#endif
+
+// The program binary functions are part of GL 4.1 and ES 3.0, or are available as the
+// GL_ARB_get_program_binary and GL_OES_get_program_binary extensions, so they're looked
+// up at runtime rather than being added to the OpenGLExtensionFunctions.
+struct OpenGLShaderProgram::ProgramBinaryFunctions
+{
+    ProgramBinaryFunctions() noexcept
+    {
+        getProgramBinary = (GetProgramBinaryFn) getFunction ("glGetProgramBinary");
+        programBinary    = (ProgramBinaryFn)    getFunction ("glProgramBinary");
+        programParameter = (ProgramParameterFn) OpenGLHelpers::getExtensionFunction ("glProgramParameteri");
+
+        GLint numFormats = 0;
+
+        if (getProgramBinary != nullptr && programBinary != nullptr)
+            glGetIntegerv (GL_NUM_PROGRAM_BINARY_FORMATS, &numFormats);
+
+        OpenGLHelpers::resetErrorState();
+        isAvailable = numFormats > 0;
+    }
+
+    static void* getFunction (const char* name)
+    {
+        if (void* f = OpenGLHelpers::getExtensionFunction (name))
+            return f;
+
+        return OpenGLHelpers::getExtensionFunction ((String (name) + "OES").toRawUTF8());
+    }
+
+    typedef void (JUCE_GL_PROGRAM_BINARY_STDCALL *GetProgramBinaryFn) (GLuint, GLsizei, GLsizei*, GLenum*, GLvoid*);
+    typedef void (JUCE_GL_PROGRAM_BINARY_STDCALL *ProgramBinaryFn) (GLuint, GLenum, const GLvoid*, GLint);
+    typedef void (JUCE_GL_PROGRAM_BINARY_STDCALL *ProgramParameterFn) (GLuint, GLenum, GLint);
+
+    GetProgramBinaryFn getProgramBinary;
+    ProgramBinaryFn programBinary;
+    ProgramParameterFn programParameter;
+    bool isAvailable;
+};
+
+#undef JUCE_GL_PROGRAM_BINARY_STDCALL
+
+struct ShaderProgramBinaryCache
+{
+    static CriticalSection& getLock()   { static CriticalSection lock; return lock; }
+    static File& getDirectory()         { static File directory; return directory; }
+};
+
+void OpenGLShaderProgram::setBinaryCacheDirectory (const File& directory)
+{
+    const ScopedLock sl (ShaderProgramBinaryCache::getLock());
+    ShaderProgramBinaryCache::getDirectory() = directory;
+}
+
+File OpenGLShaderProgram::getBinaryCacheDirectory()
+{
+    const ScopedLock sl (ShaderProgramBinaryCache::getLock());
+    return ShaderProgramBinaryCache::getDirectory();
+}
+
+//==============================================================================
 OpenGLShaderProgram::OpenGLShaderProgram (const OpenGLContext& context_) noexcept
     : context (context_)
 {
@@ -31,6 +96,14 @@ OpenGLShaderProgram::OpenGLShaderProgram (const OpenGLContext& context_) noexcep
     jassert (OpenGLHelpers::isContextActive());
 
     programID = context.extensions.glCreateProgram();
+
+    if (getBinaryCacheDirectory() != File::nonexistent)
+    {
+        binaryFunctions = new ProgramBinaryFunctions();
+
+        if (! binaryFunctions->isAvailable)
+            binaryFunctions = nullptr;
+    }
 }
 
 OpenGLShaderProgram::~OpenGLShaderProgram() noexcept
@@ -50,6 +123,19 @@ double OpenGLShaderProgram::getLanguageVersion()
 }
 
 bool OpenGLShaderProgram::addShader (const char* const code, GLenum type)
+{
+    if (binaryFunctions != nullptr)
+    {
+        // (compiling is deferred until link(), in case the program's in the cache)
+        pendingSources.add (code);
+        pendingTypes.add (type);
+        return true;
+    }
+
+    return compileShader (code, type);
+}
+
+bool OpenGLShaderProgram::compileShader (const char* const code, GLenum type)
 {
     GLuint shaderID = context.extensions.glCreateShader (type);
     context.extensions.glShaderSource (shaderID, 1, (const GLchar**) &code, nullptr);
@@ -80,6 +166,119 @@ bool OpenGLShaderProgram::addShader (const char* const code, GLenum type)
 }
 
 bool OpenGLShaderProgram::link() noexcept
+{
+    if (binaryFunctions == nullptr || pendingSources.size() == 0)
+        return linkProgram();
+
+    const String key (getBinaryCacheKey());
+    const File cacheFile (getBinaryCacheDirectory().getChildFile (String::toHexString (key.hashCode64()) + ".glbin"));
+
+    if (loadFromBinaryCache (cacheFile, key))
+    {
+        pendingSources.clear();
+        pendingTypes.clear();
+        return true;
+    }
+
+    for (int i = 0; i < pendingSources.size(); ++i)
+        if (! compileShader (pendingSources[i].toRawUTF8(), pendingTypes.getUnchecked (i)))
+            return false;
+
+    pendingSources.clear();
+    pendingTypes.clear();
+
+    if (binaryFunctions->programParameter != nullptr)
+        binaryFunctions->programParameter (programID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+
+    if (! linkProgram())
+        return false;
+
+    saveToBinaryCache (cacheFile, key);
+    return true;
+}
+
+String OpenGLShaderProgram::getBinaryCacheKey() const
+{
+    String key;
+    key << (const char*) glGetString (GL_VENDOR) << newLine
+        << (const char*) glGetString (GL_RENDERER) << newLine
+        << (const char*) glGetString (GL_VERSION) << newLine;
+
+    for (int i = 0; i < pendingSources.size(); ++i)
+        key << (int) pendingTypes.getUnchecked (i) << newLine << pendingSources[i] << newLine;
+
+    return key;
+}
+
+bool OpenGLShaderProgram::loadFromBinaryCache (const File& file, const String& key)
+{
+    FileInputStream in (file);
+
+    if (in.failedToOpen() || in.readString() != key)
+        return false;
+
+    const GLenum format = (GLenum) in.readInt();
+    const int size = in.readInt();
+
+    if (size <= 0 || size > in.getNumBytesRemaining())
+        return false;
+
+    HeapBlock<char> data ((size_t) size);
+
+    if (in.read (data, size) != size)
+        return false;
+
+    binaryFunctions->programBinary (programID, format, data, size);
+
+    GLint status = GL_FALSE;
+    context.extensions.glGetProgramiv (programID, GL_LINK_STATUS, &status);
+
+    // The driver may reject a binary even if it was created by the same version,
+    // in which case the program will just get compiled from source again..
+    OpenGLHelpers::resetErrorState();
+    return status != GL_FALSE;
+}
+
+void OpenGLShaderProgram::saveToBinaryCache (const File& file, const String& key)
+{
+    GLint size = 0;
+    context.extensions.glGetProgramiv (programID, GL_PROGRAM_BINARY_LENGTH, &size);
+
+    if (size <= 0)
+        return;
+
+    HeapBlock<char> data ((size_t) size);
+    GLsizei length = 0;
+    GLenum format = 0;
+    binaryFunctions->getProgramBinary (programID, size, &length, &format, data);
+    OpenGLHelpers::resetErrorState();
+
+    if (length <= 0 || ! file.getParentDirectory().createDirectory())
+        return;
+
+    // (other processes might be reading or writing the same file)
+    TemporaryFile temp (file);
+
+    {
+        FileOutputStream out (temp.getFile());
+
+        if (out.failedToOpen())
+            return;
+
+        out.writeString (key);
+        out.writeInt ((int) format);
+        out.writeInt ((int) length);
+        out.write (data, (size_t) length);
+        out.flush();
+
+        if (out.getStatus().failed())
+            return;
+    }
+
+    temp.overwriteTargetFileWithTemporary();
+}
+
+bool OpenGLShaderProgram::linkProgram()
 {
     context.extensions.glLinkProgram (programID);
 
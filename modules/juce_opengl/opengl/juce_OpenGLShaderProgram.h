@@ -28,6 +28,11 @@
 //==============================================================================
 /**
     Manages an OpenGL shader program.
+
+    If a binary cache directory has been set with setBinaryCacheDirectory(), and the driver
+    supports program binaries, linked programs are saved there, and any later program that's
+    built from the same shader sources on the same driver and GPU is loaded from its binary
+    rather than being compiled again.
 */
 class JUCE_API  OpenGLShaderProgram
 {
@@ -46,6 +51,20 @@ public:
     */
     static double getLanguageVersion();
 
+    /** Sets a directory in which linked programs will be cached, so that they can be
+        reloaded without being compiled again the next time they're needed.
+
+        The cache is shared by all the OpenGLShaderPrograms in the process, and only
+        affects programs whose shaders are added after this has been called. Each cached
+        program is identified by its shader sources and the GL vendor, renderer and version,
+        so a driver update or a different GPU will cause the programs to be rebuilt.
+        Pass File::nonexistent to stop using a cache (this is the default).
+    */
+    static void setBinaryCacheDirectory (const File& directory);
+
+    /** Returns the directory that was set with setBinaryCacheDirectory(). */
+    static File getBinaryCacheDirectory();
+
     /** Compiles and adds a shader to this program.
 
         After adding all your shaders, remember to call link() to link them into
@@ -56,6 +75,10 @@ public:
 
         The shaderType parameter could be GL_VERTEX_SHADER, GL_FRAGMENT_SHADER, etc.
 
+        If a binary cache is being used, the shader isn't actually compiled until link()
+        is called, and only then if the program couldn't be loaded from the cache, so
+        any compilation errors will be reported by link() instead.
+
         @returns  true if the shader compiled successfully. If not, you can call
                   getLastError() to find out what happened.
     */
@@ -66,6 +89,7 @@ public:
         fails to link correctly.
         @returns  true if the program linked successfully. If not, you can call
                   getLastError() to find out what happened.
+        @see setBinaryCacheDirectory
     */
     bool link() noexcept;
 
@@ -147,6 +171,17 @@ private:
     const OpenGLContext& context;
     String errorLog;
 
+    struct ProgramBinaryFunctions;
+    ScopedPointer<ProgramBinaryFunctions> binaryFunctions;
+    StringArray pendingSources;
+    Array<GLenum> pendingTypes;
+
+    bool compileShader (const char*, GLenum);
+    bool linkProgram();
+    String getBinaryCacheKey() const;
+    bool loadFromBinaryCache (const File&, const String& key);
+    void saveToBinaryCache (const File&, const String& key);
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (OpenGLShaderProgram)
 };
 
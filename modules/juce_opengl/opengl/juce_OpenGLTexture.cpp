@@ -23,7 +23,8 @@
 */
 
 OpenGLTexture::OpenGLTexture()
-    : textureID (0), width (0), height (0), ownerContext (nullptr)
+    : textureID (0), width (0), height (0), ownerContext (nullptr),
+      pixelFormat (0), pixelDataType (0), internalFormat (0)
 {
 }
 
@@ -37,7 +38,17 @@ bool OpenGLTexture::isValidSize (int width, int height)
     return isPowerOfTwo (width) && isPowerOfTwo (height);
 }
 
-void OpenGLTexture::create (const int w, const int h, const void* pixels, GLenum type, bool topLeft)
+bool OpenGLTexture::isFloatFormatSupported()
+{
+   #if JUCE_OPENGL_ES
+    return OpenGLHelpers::isExtensionSupported ("GL_OES_texture_float");
+   #else
+    return OpenGLHelpers::isExtensionSupported ("GL_ARB_texture_float");
+   #endif
+}
+
+void OpenGLTexture::create (const int w, const int h, const void* pixels, GLenum type, bool topLeft,
+                            GLenum dataType, GLint internalformat)
 {
     ownerContext = OpenGLContext::getCurrentContext();
 
@@ -65,23 +76,41 @@ void OpenGLTexture::create (const int w, const int h, const void* pixels, GLenum
     glPixelStorei (GL_UNPACK_ALIGNMENT, 1);
     JUCE_CHECK_OPENGL_ERROR
 
+    if (internalformat == 0)
+        internalformat = type == GL_ALPHA ? GL_ALPHA : GL_RGBA;
+
+    // If the texture's storage is already the right size and format (e.g. because it's
+    // been re-used from an OpenGLResourcePool), there's no need to re-allocate it.
+    if (width == nextPowerOfTwo (w) && height == nextPowerOfTwo (h)
+         && pixelFormat == type && pixelDataType == dataType && internalFormat == internalformat)
+    {
+        if (pixels != nullptr)
+            glTexSubImage2D (GL_TEXTURE_2D, 0, 0, topLeft ? (height - h) : 0, w, h,
+                             type, dataType, pixels);
+
+        JUCE_CHECK_OPENGL_ERROR
+        return;
+    }
+
     width  = nextPowerOfTwo (w);
     height = nextPowerOfTwo (h);
-
-    const GLint internalformat = type == GL_ALPHA ? GL_ALPHA : GL_RGBA;
+    pixelFormat = type;
+    pixelDataType = dataType;
+    internalFormat = internalformat;
 
     if (width != w || height != h)
     {
         glTexImage2D (GL_TEXTURE_2D, 0, internalformat,
-                      width, height, 0, type, GL_UNSIGNED_BYTE, nullptr);
+                      width, height, 0, type, dataType, nullptr);
 
-        glTexSubImage2D (GL_TEXTURE_2D, 0, 0, topLeft ? (height - h) : 0, w, h,
-                         type, GL_UNSIGNED_BYTE, pixels);
+        if (pixels != nullptr)
+            glTexSubImage2D (GL_TEXTURE_2D, 0, 0, topLeft ? (height - h) : 0, w, h,
+                             type, dataType, pixels);
     }
     else
     {
         glTexImage2D (GL_TEXTURE_2D, 0, internalformat,
-                      w, h, 0, type, GL_UNSIGNED_BYTE, pixels);
+                      w, h, 0, type, dataType, pixels);
     }
 
     JUCE_CHECK_OPENGL_ERROR
@@ -90,15 +119,13 @@ void OpenGLTexture::create (const int w, const int h, const void* pixels, GLenum
 template <class PixelType>
 struct Flipper
 {
-    static void flip (HeapBlock<PixelARGB>& dataCopy, const uint8* srcData, const int lineStride,
-                      const int w, const int h)
+    static void flip (PixelARGB* const dest, const uint8* srcData, const int lineStride,
+                      const int w, const int h) noexcept
     {
-        dataCopy.malloc ((size_t) (w * h));
-
         for (int y = 0; y < h; ++y)
         {
             const PixelType* src = (const PixelType*) srcData;
-            PixelARGB* const dst = (PixelARGB*) (dataCopy + w * (h - 1 - y));
+            PixelARGB* const dst = dest + w * (h - 1 - y);
 
             for (int x = 0; x < w; ++x)
                 dst[x].set (src[x]);
@@ -106,25 +133,78 @@ struct Flipper
             srcData += lineStride;
         }
     }
+
+    static void flip (HeapBlock<PixelARGB>& dataCopy, const uint8* srcData, const int lineStride,
+                      const int w, const int h)
+    {
+        dataCopy.malloc ((size_t) (w * h));
+        flip (dataCopy.getData(), srcData, lineStride, w, h);
+    }
 };
 
+// Converts some bitmap data to ARGB, flipping it vertically so that it can be uploaded
+// to a texture whose top-left is at (0, 1)
+static void copyImageDataFlipped (PixelARGB* const dest, const Image::BitmapData& srcData) noexcept
+{
+    switch (srcData.pixelFormat)
+    {
+        case Image::ARGB:           Flipper<PixelARGB> ::flip (dest, srcData.data, srcData.lineStride, srcData.width, srcData.height); break;
+        case Image::RGB:            Flipper<PixelRGB>  ::flip (dest, srcData.data, srcData.lineStride, srcData.width, srcData.height); break;
+        case Image::SingleChannel:  Flipper<PixelAlpha>::flip (dest, srcData.data, srcData.lineStride, srcData.width, srcData.height); break;
+        default: break;
+    }
+}
+
 void OpenGLTexture::loadImage (const Image& image)
 {
     const int imageW = image.getWidth();
     const int imageH = image.getHeight();
 
-    HeapBlock<PixelARGB> dataCopy;
-    Image::BitmapData srcData (image, Image::BitmapData::readOnly);
+    HeapBlock<PixelARGB> dataCopy ((size_t) (imageW * imageH), true);
+    const Image::BitmapData srcData (image, Image::BitmapData::readOnly);
+    copyImageDataFlipped (dataCopy, srcData);
 
-    switch (srcData.pixelFormat)
+    create (imageW, imageH, dataCopy, JUCE_RGBA_FORMAT, true);
+}
+
+void OpenGLTexture::updateImage (const Image& image, const Rectangle<int>& area)
+{
+    if (textureID == 0 || image.getWidth() > width || image.getHeight() > height)
     {
-        case Image::ARGB:           Flipper<PixelARGB> ::flip (dataCopy, srcData.data, srcData.lineStride, imageW, imageH); break;
-        case Image::RGB:            Flipper<PixelRGB>  ::flip (dataCopy, srcData.data, srcData.lineStride, imageW, imageH); break;
-        case Image::SingleChannel:  Flipper<PixelAlpha>::flip (dataCopy, srcData.data, srcData.lineStride, imageW, imageH); break;
-        default: break;
+        loadImage (image);
+        return;
     }
 
-    create (imageW, imageH, dataCopy, JUCE_RGBA_FORMAT, true);
+    const Rectangle<int> section (area.getIntersection (image.getBounds()));
+
+    if (! section.isEmpty())
+    {
+        HeapBlock<PixelARGB> dataCopy ((size_t) (section.getWidth() * section.getHeight()));
+        const Image::BitmapData srcData (image, section.getX(), section.getY(),
+                                         section.getWidth(), section.getHeight());
+        copyImageDataFlipped (dataCopy, srcData);
+
+        updateSection (section.getX(), height - section.getBottom(),
+                       section.getWidth(), section.getHeight(), dataCopy);
+    }
+}
+
+void OpenGLTexture::updateARGB (const PixelARGB* pixels, const int x, const int y, const int w, const int h)
+{
+    updateSection (x, y, w, h, pixels);
+}
+
+void OpenGLTexture::updateSection (const int x, const int y, const int w, const int h, const void* pixels)
+{
+    // The texture must have been created before you can update part of it, and it
+    // must be done on the context that owns it.
+    jassert (textureID != 0 && ownerContext == OpenGLContext::getCurrentContext());
+    jassert (x >= 0 && y >= 0 && x + w <= width && y + h <= height);
+
+    glBindTexture (GL_TEXTURE_2D, textureID);
+    glPixelStorei (GL_UNPACK_ALIGNMENT, 1);
+    glTexSubImage2D (GL_TEXTURE_2D, 0, x, y, w, h, JUCE_RGBA_FORMAT, GL_UNSIGNED_BYTE, pixels);
+    JUCE_CHECK_OPENGL_ERROR
 }
 
 void OpenGLTexture::loadARGB (const PixelARGB* pixels, const int w, const int h)
@@ -137,6 +217,38 @@ void OpenGLTexture::loadAlpha (const uint8* pixels, int w, int h)
     create (w, h, pixels, GL_ALPHA, false);
 }
 
+void OpenGLTexture::loadFloatValues (const float* values, int w, int h)
+{
+   #if JUCE_OPENGL_ES
+    // GLES can only take float data if the texture itself is stored as floats..
+    if (! isFloatFormatSupported())
+    {
+        HeapBlock<uint8> levels ((size_t) (w * h));
+
+        for (int i = w * h; --i >= 0;)
+            levels[i] = (uint8) jlimit (0, 255, roundToInt (values[i] * 255.0f));
+
+        create (w, h, levels, GL_ALPHA, false);
+        return;
+    }
+
+    create (w, h, values, GL_ALPHA, false, GL_FLOAT, GL_ALPHA);
+   #else
+    create (w, h, values, GL_ALPHA, false, GL_FLOAT,
+            isFloatFormatSupported() ? GL_ALPHA32F_ARB : GL_ALPHA);
+   #endif
+}
+
+void OpenGLTexture::loadColourMap (const ColourGradient& gradient, int numEntries)
+{
+    jassert (numEntries > 0);
+
+    HeapBlock<PixelARGB> lookupTable ((size_t) numEntries);
+    gradient.createLookupTable (lookupTable, numEntries);
+
+    create (numEntries, 1, lookupTable, JUCE_RGBA_FORMAT, false);
+}
+
 void OpenGLTexture::loadARGBFlipped (const PixelARGB* pixels, int w, int h)
 {
     HeapBlock<PixelARGB> flippedCopy;
@@ -155,6 +267,9 @@ void OpenGLTexture::release()
         textureID = 0;
         width = 0;
         height = 0;
+        pixelFormat = 0;
+        pixelDataType = 0;
+        internalFormat = 0;
     }
 }
 
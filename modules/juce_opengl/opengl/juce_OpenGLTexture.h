@@ -60,6 +60,22 @@ public:
     */
     void loadARGBFlipped (const PixelARGB* pixels, int width, int height);
 
+    /** Replaces a section of a texture that was created by loadImage().
+
+        Rather than re-creating the whole texture, this only converts and uploads the pixels
+        inside the given area, so it's much quicker when only part of an image has changed.
+        The image must be the same size as the one that the texture was loaded from - if the
+        texture hasn't been created yet, or is too small, this just calls loadImage().
+    */
+    void updateImage (const Image& image, const Rectangle<int>& area);
+
+    /** Replaces a section of a texture with a raw array of pixels.
+        Like loadARGB(), the data isn't flipped, so the first pixel goes at texture
+        position (x, y), measured from the bottom-left. The texture must already be big
+        enough to contain the area.
+    */
+    void updateARGB (const PixelARGB* pixels, int x, int y, int width, int height);
+
     /** Creates an alpha-channel texture from an array of alpha values.
         If width and height are not powers-of-two, the texture will be created with a
         larger size, and only the subsection (0, 0, width, height) will be initialised.
@@ -68,6 +84,38 @@ public:
     */
     void loadAlpha (const uint8* pixels, int width, int height);
 
+    /** Creates a single-channel texture from an array of floating point values.
+
+        The values end up in the texture's alpha channel, so this is handy for data such as
+        meter levels or spectrogram bins, which can then be turned into colours by a shader,
+        e.g. by using them to look up a colour map that was loaded with loadColourMap():
+        @code
+        gl_FragColor = texture2D (colourMap, vec2 (texture2D (values, texCoord).a, 0.5));
+        @endcode
+
+        The floats are handed straight to the driver, so no conversion is done on the CPU.
+        If the driver supports float textures (see isFloatFormatSupported()), the values will
+        keep their full precision and range, otherwise they'll be clamped to 0..1 and stored
+        at 8-bit resolution.
+
+        If width and height are not powers-of-two, the texture will be created with a
+        larger size, and only the subsection (0, 0, width, height) will be initialised.
+        The data is sent directly to the OpenGL driver without being flipped vertically,
+        so the first value will be mapped onto texture coordinate (0, 0).
+    */
+    void loadFloatValues (const float* values, int width, int height);
+
+    /** Creates a one-pixel-high texture containing a lookup table of the colours in a gradient.
+
+        The gradient's start and end points are ignored - the colour at proportion p along the
+        gradient is put at texture coordinate (p, 0.5). This makes it easy for a shader to map
+        values loaded with loadFloatValues() onto colours.
+
+        The number of entries should be a power-of-two, otherwise the texture will be padded
+        and the texture coordinates will need scaling to compensate.
+    */
+    void loadColourMap (const ColourGradient& gradient, int numEntries = 256);
+
     /** Frees the texture, if there is one. */
     void release();
 
@@ -104,12 +152,23 @@ public:
     */
     static bool isValidSize (int width, int height);
 
+    /** Returns true if the current context can store textures loaded by loadFloatValues() at
+        full floating-point precision. This must be called while a context is active.
+    */
+    static bool isFloatFormatSupported();
+
 private:
     GLuint textureID;
     int width, height;
     OpenGLContext* ownerContext;
+    GLenum pixelFormat, pixelDataType;
+    GLint internalFormat;
+
+    void create (int w, int h, const void*, GLenum, bool topLeft,
+                 GLenum dataType = GL_UNSIGNED_BYTE, GLint internalFormat = 0);
+    void updateSection (int x, int y, int w, int h, const void*);
 
-    void create (int w, int h, const void*, GLenum, bool topLeft);
+    friend class OpenGLTextureUploader;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (OpenGLTexture)
 };
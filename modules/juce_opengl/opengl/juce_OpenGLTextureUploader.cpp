@@ -0,0 +1,260 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+
+struct OpenGLTextureUploader::StagingBuffer
+{
+    StagingBuffer() noexcept : numAllocated (0), imageWidth (0), imageHeight (0), sequenceNumber (0) {}
+
+    enum State
+    {
+        empty,
+        filling,
+        readyToUpload
+    };
+
+    Atomic<int> state;
+    HeapBlock<PixelARGB> pixels;
+    size_t numAllocated;
+    Rectangle<int> area;
+    int imageWidth, imageHeight, sequenceNumber;
+
+    bool covers (const StagingBuffer& other) const noexcept
+    {
+        return imageWidth == other.imageWidth && imageHeight == other.imageHeight
+                && area.contains (other.area);
+    }
+};
+
+//==============================================================================
+OpenGLTextureUploader::OpenGLTextureUploader (const int numStagingBuffers)
+    : ownerContext (nullptr), nextPixelBuffer (0), hasCheckedForPixelBuffers (false)
+{
+    jassert (numStagingBuffers > 0);
+
+    for (int i = jmax (1, numStagingBuffers); --i >= 0;)
+        stagingBuffers.add (new StagingBuffer());
+
+    buffersToUpload.malloc ((size_t) stagingBuffers.size());
+}
+
+OpenGLTextureUploader::~OpenGLTextureUploader()
+{
+    release();
+}
+
+//==============================================================================
+bool OpenGLTextureUploader::stageImage (const Image& image)
+{
+    return stageImage (image, image.getBounds());
+}
+
+bool OpenGLTextureUploader::stageImage (const Image& image, const Rectangle<int>& areaToStage)
+{
+    const Rectangle<int> section (areaToStage.getIntersection (image.getBounds()));
+
+    if (section.isEmpty())
+        return true;
+
+    for (int i = 0; i < stagingBuffers.size(); ++i)
+    {
+        StagingBuffer& buffer = *stagingBuffers.getUnchecked (i);
+
+        if (buffer.state.compareAndSetBool (StagingBuffer::filling, StagingBuffer::empty))
+        {
+            const size_t numPixels = (size_t) (section.getWidth() * section.getHeight());
+
+            if (buffer.numAllocated < numPixels)
+            {
+                buffer.pixels.malloc (numPixels);
+                buffer.numAllocated = numPixels;
+            }
+
+            const Image::BitmapData srcData (image, section.getX(), section.getY(),
+                                             section.getWidth(), section.getHeight());
+            copyImageDataFlipped (buffer.pixels, srcData);
+
+            buffer.area = section;
+            buffer.imageWidth = image.getWidth();
+            buffer.imageHeight = image.getHeight();
+            buffer.sequenceNumber = ++lastSequenceNumber;
+            buffer.state.set (StagingBuffer::readyToUpload);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool OpenGLTextureUploader::hasStagedImages() const noexcept
+{
+    for (int i = stagingBuffers.size(); --i >= 0;)
+        if (stagingBuffers.getUnchecked (i)->state.get() == StagingBuffer::readyToUpload)
+            return true;
+
+    return false;
+}
+
+//==============================================================================
+int OpenGLTextureUploader::uploadStagedImages (OpenGLTexture& texture)
+{
+    // This must be called on a thread that has an active OpenGL context.
+    jassert (OpenGLContext::getCurrentContext() != nullptr);
+
+    int numToUpload = 0;
+
+    for (int i = 0; i < stagingBuffers.size(); ++i)
+    {
+        StagingBuffer* const buffer = stagingBuffers.getUnchecked (i);
+
+        if (buffer->state.get() == StagingBuffer::readyToUpload)
+        {
+            // (keep them sorted into the order in which they were staged)
+            int insertIndex = numToUpload++;
+
+            for (; insertIndex > 0; --insertIndex)
+            {
+                StagingBuffer* const previous = buffersToUpload [insertIndex - 1];
+
+                if (previous->sequenceNumber - buffer->sequenceNumber < 0)
+                    break;
+
+                buffersToUpload [insertIndex] = previous;
+            }
+
+            buffersToUpload [insertIndex] = buffer;
+        }
+    }
+
+    if (numToUpload > 0 && ! hasCheckedForPixelBuffers)
+        createPixelBuffers();
+
+    int numUploaded = 0;
+
+    for (int i = 0; i < numToUpload; ++i)
+    {
+        StagingBuffer& buffer = *buffersToUpload[i];
+        bool isOverwrittenLater = false;
+
+        for (int j = i + 1; j < numToUpload && ! isOverwrittenLater; ++j)
+            isOverwrittenLater = buffersToUpload[j]->covers (buffer);
+
+        if (! isOverwrittenLater)
+        {
+            upload (texture, buffer);
+            ++numUploaded;
+        }
+
+        buffer.state.set (StagingBuffer::empty);
+    }
+
+    return numUploaded;
+}
+
+void OpenGLTextureUploader::upload (OpenGLTexture& texture, const StagingBuffer& buffer)
+{
+    if (texture.getTextureID() == 0
+         || texture.getWidth()  != nextPowerOfTwo (buffer.imageWidth)
+         || texture.getHeight() != nextPowerOfTwo (buffer.imageHeight))
+        texture.create (buffer.imageWidth, buffer.imageHeight, nullptr, JUCE_RGBA_FORMAT, true);
+
+    const int x = buffer.area.getX();
+    const int y = texture.getHeight() - buffer.area.getBottom();
+
+    if (! uploadWithPixelBuffer (texture, buffer, x, y))
+        texture.updateSection (x, y, buffer.area.getWidth(), buffer.area.getHeight(), buffer.pixels);
+}
+
+bool OpenGLTextureUploader::uploadWithPixelBuffer (OpenGLTexture& texture, const StagingBuffer& buffer,
+                                                   const int x, const int y)
+{
+   #if JUCE_OPENGL_ES
+    (void) texture; (void) buffer; (void) x; (void) y;
+   #else
+    if (pixelBuffers.size() > 0)
+    {
+        const OpenGLExtensionFunctions& gl = ownerContext->extensions;
+        const size_t numBytes = sizeof (PixelARGB) * (size_t) (buffer.area.getWidth() * buffer.area.getHeight());
+
+        // Cycling through several buffers, and orphaning each one's previous storage,
+        // means that the driver never has to wait for an earlier upload to finish.
+        gl.glBindBuffer (GL_PIXEL_UNPACK_BUFFER, pixelBuffers.getUnchecked (nextPixelBuffer));
+        nextPixelBuffer = (nextPixelBuffer + 1) % pixelBuffers.size();
+        gl.glBufferData (GL_PIXEL_UNPACK_BUFFER, (GLsizeiptr) numBytes, nullptr, GL_STREAM_DRAW);
+
+        bool ok = false;
+
+        if (void* const mapped = gl.glMapBuffer (GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY))
+        {
+            memcpy (mapped, buffer.pixels, numBytes);
+
+            if (gl.glUnmapBuffer (GL_PIXEL_UNPACK_BUFFER))
+            {
+                // (with a pixel buffer bound, the data pointer is an offset into it)
+                texture.updateSection (x, y, buffer.area.getWidth(), buffer.area.getHeight(), nullptr);
+                ok = true;
+            }
+        }
+
+        gl.glBindBuffer (GL_PIXEL_UNPACK_BUFFER, 0);
+        return ok;
+    }
+   #endif
+
+    return false;
+}
+
+//==============================================================================
+void OpenGLTextureUploader::createPixelBuffers()
+{
+    hasCheckedForPixelBuffers = true;
+    ownerContext = OpenGLContext::getCurrentContext();
+
+   #if ! JUCE_OPENGL_ES
+    if (OpenGLHelpers::isExtensionSupported ("GL_ARB_pixel_buffer_object"))
+    {
+        pixelBuffers.insertMultiple (0, 0, stagingBuffers.size());
+        ownerContext->extensions.glGenBuffers (pixelBuffers.size(), pixelBuffers.getRawDataPointer());
+        JUCE_CHECK_OPENGL_ERROR
+    }
+   #endif
+}
+
+void OpenGLTextureUploader::release()
+{
+    if (pixelBuffers.size() > 0)
+    {
+        // The pixel buffers must be deleted while their context is active!
+        jassert (ownerContext == OpenGLContext::getCurrentContext());
+
+        if (ownerContext == OpenGLContext::getCurrentContext())
+            ownerContext->extensions.glDeleteBuffers (pixelBuffers.size(), pixelBuffers.getRawDataPointer());
+
+        pixelBuffers.clear();
+    }
+
+    ownerContext = nullptr;
+    nextPixelBuffer = 0;
+    hasCheckedForPixelBuffers = false;
+}
@@ -0,0 +1,132 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+
+#ifndef __JUCE_OPENGLTEXTUREUPLOADER_JUCEHEADER__
+#define __JUCE_OPENGLTEXTUREUPLOADER_JUCEHEADER__
+
+#include "juce_OpenGLTexture.h"
+
+
+//==============================================================================
+/**
+    Streams images into an OpenGLTexture without making the GL thread do the work
+    of preparing them.
+
+    Any thread can call stageImage() to hand over a new image, or just the part of an
+    image that has changed. The pixels are converted and flipped into one of a set of
+    staging buffers on the calling thread, so the GL thread only has to call
+    uploadStagedImages() during its render callback to send them to the texture.
+
+    Where the driver supports pixel buffer objects, the uploads go through a ring of
+    them, so that glTexSubImage2D returns straight away and the copy into the texture
+    happens asynchronously, rather than stalling the render thread.
+
+    E.g.
+    @code
+    // on a background thread:
+    uploader.stageImage (spectrogramImage, Rectangle<int> (column, 0, 1, spectrogramImage.getHeight()));
+
+    // in the OpenGLRenderer::renderOpenGL() callback:
+    uploader.uploadStagedImages (texture);
+    texture.bind();
+    @endcode
+
+    The images must be software images, rather than ones created by OpenGLImageType.
+
+    @see OpenGLTexture
+*/
+class JUCE_API  OpenGLTextureUploader
+{
+public:
+    //==============================================================================
+    /** Creates an uploader.
+        The number of staging buffers limits how many images can be waiting to be uploaded
+        at once, and is also the number of pixel buffer objects that will be used.
+    */
+    explicit OpenGLTextureUploader (int numStagingBuffers = 3);
+
+    /** Destructor.
+        If the uploader has created any pixel buffers, this must be called while their
+        context is active, or release() must have been called beforehand.
+    */
+    ~OpenGLTextureUploader();
+
+    //==============================================================================
+    /** Copies a section of an image into a staging buffer, ready to be uploaded.
+
+        This can be called on any thread. The area's position is relative to the whole
+        image, and after the image's size changes, the next image staged should be the
+        whole image, because the texture will be re-created to fit it.
+
+        @returns false if all the staging buffers are still waiting to be uploaded, in
+                 which case nothing is done, and it's up to the caller to try again later
+    */
+    bool stageImage (const Image& image, const Rectangle<int>& area);
+
+    /** Copies a whole image into a staging buffer, ready to be uploaded.
+        @see stageImage
+    */
+    bool stageImage (const Image& image);
+
+    /** Returns true if there are some staged images waiting to be uploaded. */
+    bool hasStagedImages() const noexcept;
+
+    //==============================================================================
+    /** Uploads any images that have been staged into the given texture, in the order in
+        which they were staged.
+
+        This must be called on a thread with an active OpenGL context. If the texture is
+        the wrong size for the staged images, it'll be re-created.
+
+        @returns the number of images that were uploaded
+    */
+    int uploadStagedImages (OpenGLTexture& texture);
+
+    /** Frees the pixel buffer objects, if there are any.
+        This must be called while the context that created them is active.
+    */
+    void release();
+
+private:
+    //==============================================================================
+    struct StagingBuffer;
+    OwnedArray<StagingBuffer> stagingBuffers;
+    HeapBlock<StagingBuffer*> buffersToUpload;
+    Atomic<int> lastSequenceNumber;
+
+    OpenGLContext* ownerContext;
+    Array<GLuint> pixelBuffers;
+    int nextPixelBuffer;
+    bool hasCheckedForPixelBuffers;
+
+    void createPixelBuffers();
+    void upload (OpenGLTexture&, const StagingBuffer&);
+    bool uploadWithPixelBuffer (OpenGLTexture&, const StagingBuffer&, int x, int y);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (OpenGLTextureUploader)
+};
+
+
+#endif   // __JUCE_OPENGLTEXTUREUPLOADER_JUCEHEADER__
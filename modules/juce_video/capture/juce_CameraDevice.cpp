@@ -0,0 +1,66 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+
+CameraDevice::Frame::Frame (const void* topLine_, int lineStride_, PixelFormat format,
+                            int width_, int height_, double timeStamp_, Image* imageToReuse_) noexcept
+    : topLine (static_cast<const uint8*> (topLine_)), lineStride (lineStride_), pixelFormat (format),
+      width (width_), height (height_), timeStamp (timeStamp_), imageToReuse (imageToReuse_)
+{
+}
+
+Image CameraDevice::Frame::toImage() const
+{
+    if (image.isNull())
+    {
+        const Image::PixelFormat imageFormat = (pixelFormat == rgb24) ? Image::RGB : Image::ARGB;
+
+        // The recycled image can only be overwritten if no-one else is still holding onto it..
+        if (imageToReuse != nullptr
+             && imageToReuse->getReferenceCount() == 1
+             && imageToReuse->getFormat() == imageFormat
+             && imageToReuse->getWidth() == width
+             && imageToReuse->getHeight() == height)
+        {
+            image = *imageToReuse;
+        }
+        else
+        {
+            image = Image (imageFormat, width, height, false);
+
+            if (imageToReuse != nullptr)
+                *imageToReuse = image;
+        }
+
+        // (the pixel layouts match JUCE's own RGB and ARGB formats, and the camera's alpha
+        // is always opaque, so no conversion is needed, other than the line order)
+        const Image::BitmapData destData (image, Image::BitmapData::writeOnly);
+        const size_t bytesPerLine = (size_t) (width * getPixelStride());
+
+        for (int y = 0; y < height; ++y)
+            memcpy (destData.getLinePointer (y), getLinePointer (y), bytesPerLine);
+    }
+
+    return image;
+}
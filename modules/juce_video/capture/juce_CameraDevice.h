@@ -105,6 +105,82 @@ public:
     */
     Time getTimeOfFirstRecordedFrame() const;
 
+    //==============================================================================
+    /**
+        A view onto a single frame of video, as it was delivered by the camera driver.
+
+        A Frame doesn't own or copy its pixels: they belong to the driver's capture buffer,
+        and are only valid for the duration of the Listener::frameReceived() callback that
+        it's passed to. If you need to keep the frame, copy the pixels or call toImage().
+
+        Because the pixels are in their native layout, a BGRA frame can be uploaded to
+        an OpenGL texture directly, e.g. with OpenGLTexture::loadARGB(), a line at a time
+        if the stride isn't the width.
+
+        @see Listener::frameReceived
+    */
+    class JUCE_API  Frame
+    {
+    public:
+        /** The layouts in which a frame's pixels may be stored. */
+        enum PixelFormat
+        {
+            rgb24,      /**< 3 bytes per pixel, in the order blue, green, red. */
+            bgra32      /**< 4 bytes per pixel, in the order blue, green, red, alpha. */
+        };
+
+       #ifndef DOXYGEN
+        /** @internal Frames are created by the platform-specific capture code. */
+        Frame (const void* topLine, int lineStride, PixelFormat format,
+               int width, int height, double timeStamp, Image* imageToReuse) noexcept;
+       #endif
+
+        /** Returns the width of the frame in pixels. */
+        int getWidth() const noexcept                               { return width; }
+
+        /** Returns the height of the frame in pixels. */
+        int getHeight() const noexcept                              { return height; }
+
+        /** Returns the layout of the frame's pixels. */
+        PixelFormat getPixelFormat() const noexcept                 { return pixelFormat; }
+
+        /** Returns the number of bytes used by each pixel. */
+        int getPixelStride() const noexcept                         { return pixelFormat == rgb24 ? 3 : 4; }
+
+        /** Returns the number of bytes between the start of one line and the start of the
+            next one down. This will be negative if the driver stores its frames bottom-up.
+        */
+        int getLineStride() const noexcept                          { return lineStride; }
+
+        /** Returns a pointer to the first pixel of a line, where line 0 is the top of the frame. */
+        const uint8* getLinePointer (int y) const noexcept          { return topLine + y * lineStride; }
+
+        /** Returns the time at which the frame was captured, in seconds.
+            This comes from the driver's clock, so it's only meaningful when compared
+            with the time-stamps of other frames from the same device.
+        */
+        double getTimeStamp() const noexcept                        { return timeStamp; }
+
+        /** Returns a copy of the frame as an Image.
+
+            The conversion is only done once for each frame, however many times this is
+            called. The device recycles the image's storage for later frames, unless you
+            keep a reference to it, in which case it'll use a new one.
+        */
+        Image toImage() const;
+
+    private:
+        const uint8* topLine;
+        int lineStride;
+        PixelFormat pixelFormat;
+        int width, height;
+        double timeStamp;
+        Image* imageToReuse;
+        mutable Image image;
+
+        JUCE_DECLARE_NON_COPYABLE (Frame)
+    };
+
     //==============================================================================
     /**
         Receives callbacks with images from a CameraDevice.
@@ -122,8 +198,23 @@ public:
             This may be called by any thread, so be careful about thread-safety,
             and make sure that you process the data as quickly as possible to
             avoid glitching!
+
+            It's called by the default implementation of frameReceived(), so if you
+            override that, this won't be used.
+        */
+        virtual void imageReceived (const Image&)                {}
+
+        /** This method is called when a new frame arrives, before it has been converted
+            to an Image.
+
+            Override this to use the driver's own pixel buffer without any copying or
+            conversion. The frame is only valid until this method returns. The default
+            implementation converts it to an Image and calls imageReceived().
+
+            This may be called by any thread, so the same warnings as for imageReceived()
+            apply here.
         */
-        virtual void imageReceived (const Image& image) = 0;
+        virtual void frameReceived (const Frame& frame)         { imageReceived (frame.toImage()); }
     };
 
     /** Adds a listener to receive images from the camera.
@@ -85,6 +85,12 @@
   #include <evr.h>
  #endif
 
+ #if JUCE_MEDIAFOUNDATION
+  #include <mfapi.h>
+  #include <mfidl.h>
+  #include <mfreadwrite.h>
+ #endif
+
  #if JUCE_USE_CAMERA && JUCE_MSVC && ! JUCE_DONT_AUTOLINK_TO_WIN32_LIBRARIES
   #pragma comment (lib, "Strmiids.lib")
   #pragma comment (lib, "wmvcore.lib")
@@ -92,6 +98,8 @@
 
  #if JUCE_MEDIAFOUNDATION && JUCE_MSVC && ! JUCE_DONT_AUTOLINK_TO_WIN32_LIBRARIES
   #pragma comment (lib, "mfuuid.lib")
+  #pragma comment (lib, "mfplat.lib")
+  #pragma comment (lib, "mfreadwrite.lib")
  #endif
 
  #if JUCE_DIRECTSHOW && JUCE_MSVC && ! JUCE_DONT_AUTOLINK_TO_WIN32_LIBRARIES
@@ -105,6 +113,10 @@ using namespace juce;
 namespace juce
 {
 
+#if JUCE_USE_CAMERA
+ #include "capture/juce_CameraDevice.cpp"
+#endif
+
 #if JUCE_MAC || JUCE_IOS
  #include "../juce_core/native/juce_osx_ObjCHelpers.h"
 
@@ -131,6 +143,10 @@ namespace juce
   #include "native/juce_win32_QuickTimeMovieComponent.cpp"
  #endif
 
+ #if JUCE_MEDIAFOUNDATION
+  #include "native/juce_win32_MediaFoundationVideoDecoder.cpp"
+ #endif
+
 #elif JUCE_LINUX
 
 #elif JUCE_ANDROID
@@ -139,4 +155,6 @@ namespace juce
  #endif
 #endif
 
+#include "playback/juce_VideoPlayer.cpp"
+
 }
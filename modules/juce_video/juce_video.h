@@ -27,6 +27,7 @@
 
 //=============================================================================
 #include "../juce_gui_extra/juce_gui_extra.h"
+#include "../juce_audio_basics/juce_audio_basics.h"
 
 //=============================================================================
 /** Config: JUCE_DIRECTSHOW
@@ -80,6 +81,12 @@ namespace juce
 #ifndef __JUCE_QUICKTIMEMOVIECOMPONENT_JUCEHEADER__
  #include "playback/juce_QuickTimeMovieComponent.h"
 #endif
+#ifndef __JUCE_VIDEODECODER_JUCEHEADER__
+ #include "playback/juce_VideoDecoder.h"
+#endif
+#ifndef __JUCE_VIDEOPLAYER_JUCEHEADER__
+ #include "playback/juce_VideoPlayer.h"
+#endif
 #ifndef __JUCE_CAMERADEVICE_JUCEHEADER__
  #include "capture/juce_CameraDevice.h"
 #endif
@@ -71,6 +71,10 @@ public:
                     imageOutput = [[QTCaptureDecompressedVideoOutput alloc] init];
                     [imageOutput setDelegate: callbackDelegate];
 
+                    // Ask for BGRA buffers, which are laid out the same way as an ARGB Image
+                    [imageOutput setPixelBufferAttributes: [NSDictionary dictionaryWithObject: [NSNumber numberWithUnsignedInt: kCVPixelFormatType_32BGRA]
+                                                                                       forKey: (id) kCVPixelBufferPixelFormatTypeKey]];
+
                     if (err == nil)
                     {
                         [session startRunning];
@@ -151,10 +155,43 @@ public:
             [session removeOutput: imageOutput];
     }
 
-    void callListeners (CIImage* frame, int w, int h)
+    void callListeners (CVImageBufferRef videoFrame, double timeStamp)
     {
-        Image image (juce_createImageFromCIImage (frame, w, h));
+        if (CVPixelBufferGetPixelFormatType (videoFrame) != kCVPixelFormatType_32BGRA)
+        {
+            // (if the driver ignored the pixel format that was requested, fall back to using CoreImage)
+            JUCE_AUTORELEASEPOOL
+            {
+                const int w = (int) CVPixelBufferGetWidth (videoFrame);
+                const int h = (int) CVPixelBufferGetHeight (videoFrame);
+                Image image (juce_createImageFromCIImage ([CIImage imageWithCVImageBuffer: videoFrame], w, h));
+
+                const Image::BitmapData data (image, Image::BitmapData::readOnly);
+                const CameraDevice::Frame frame (data.data, data.lineStride, CameraDevice::Frame::bgra32,
+                                                 w, h, timeStamp, nullptr);
+                callListeners (frame);
+            }
+
+            return;
+        }
+
+        CVPixelBufferLockBaseAddress (videoFrame, 0);
+
+        {
+            const CameraDevice::Frame frame (CVPixelBufferGetBaseAddress (videoFrame),
+                                             (int) CVPixelBufferGetBytesPerRow (videoFrame),
+                                             CameraDevice::Frame::bgra32,
+                                             (int) CVPixelBufferGetWidth (videoFrame),
+                                             (int) CVPixelBufferGetHeight (videoFrame),
+                                             timeStamp, &listenerImage);
+            callListeners (frame);
+        }
+
+        CVPixelBufferUnlockBaseAddress (videoFrame, 0);
+    }
 
+    void callListeners (const CameraDevice::Frame& frame)
+    {
         const ScopedLock sl (listenerLock);
 
         for (int i = listeners.size(); --i >= 0;)
@@ -162,7 +199,7 @@ public:
             CameraDevice::Listener* const l = listeners[i];
 
             if (l != nullptr)
-                l->imageReceived (image);
+                l->frameReceived (frame);
         }
     }
 
@@ -207,6 +244,7 @@ public:
 
     Array<CameraDevice::Listener*> listeners;
     CriticalSection listenerLock;
+    Image listenerImage;
 
 private:
     //==============================================================================
@@ -236,12 +274,9 @@ private:
 
             if (internal->listeners.size() > 0)
             {
-                JUCE_AUTORELEASEPOOL
-                {
-                    internal->callListeners ([CIImage imageWithCVImageBuffer: videoFrame],
-                                             CVPixelBufferGetWidth (videoFrame),
-                                             CVPixelBufferGetHeight (videoFrame));
-                }
+                const QTTime time ([sampleBuffer presentationTime]);
+
+                internal->callListeners (videoFrame, time.timeScale > 0 ? time.timeValue / (double) time.timeScale : 0.0);
             }
         }
 
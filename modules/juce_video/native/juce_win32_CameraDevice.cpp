@@ -204,7 +204,7 @@ public:
         return previewMaxFPS;
     }
 
-    void handleFrame (double /*time*/, BYTE* buffer, long /*bufferSize*/)
+    void handleFrame (double time, BYTE* buffer, long /*bufferSize*/)
     {
         if (recordNextFrameTime)
         {
@@ -229,26 +229,35 @@ public:
             }
         }
 
+        const int lineStride = width * 3;
+
+        if (listeners.size() > 0)
         {
-            const int lineStride = width * 3;
-            const ScopedLock sl (imageSwapLock);
+            // (the grabber's RGB24 buffer is bottom-up, so the frame starts from its last line)
+            const CameraDevice::Frame frame (buffer + lineStride * (height - 1), -lineStride,
+                                             CameraDevice::Frame::rgb24, width, height, time, &listenerImage);
+            callListeners (frame);
+        }
 
+        if (viewerComps.size() > 0)
+        {
             {
-                const Image::BitmapData destData (loadingImage, 0, 0, width, height, Image::BitmapData::writeOnly);
+                const ScopedLock sl (imageSwapLock);
 
-                for (int i = 0; i < height; ++i)
-                    memcpy (destData.getLinePointer ((height - 1) - i),
-                            buffer + lineStride * i,
-                            lineStride);
-            }
+                {
+                    const Image::BitmapData destData (loadingImage, 0, 0, width, height, Image::BitmapData::writeOnly);
 
-            imageNeedsFlipping = true;
-        }
+                    for (int i = 0; i < height; ++i)
+                        memcpy (destData.getLinePointer ((height - 1) - i),
+                                buffer + lineStride * i,
+                                lineStride);
+                }
 
-        if (listeners.size() > 0)
-            callListeners (loadingImage);
+                imageNeedsFlipping = true;
+            }
 
-        sendChangeMessage();
+            sendChangeMessage();
+        }
     }
 
     void drawCurrentImage (Graphics& g, int x, int y, int w, int h)
@@ -410,13 +419,13 @@ public:
             removeUser();
     }
 
-    void callListeners (const Image& image)
+    void callListeners (const CameraDevice::Frame& frame)
     {
         const ScopedLock sl (listenerLock);
 
         for (int i = listeners.size(); --i >= 0;)
             if (CameraDevice::Listener* const l = listeners[i])
-                l->imageReceived (image);
+                l->frameReceived (frame);
     }
 
     //==============================================================================
@@ -506,6 +515,7 @@ private:
     bool imageNeedsFlipping;
     Image loadingImage;
     Image activeImage;
+    Image listenerImage;
 
     bool recordNextFrameTime;
     int previewMaxFPS;
@@ -0,0 +1,230 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+
+class MediaFoundationVideoDecoder  : public VideoDecoder
+{
+public:
+    MediaFoundationVideoDecoder (const File& file)
+        : width (0), height (0), frameRate (0), lengthInFrames (0), defaultStride (0),
+          isStarted (false)
+    {
+        CoInitialize (0);
+        isStarted = SUCCEEDED (MFStartup (MF_VERSION));
+
+        if (! isStarted)
+            return;
+
+        ComSmartPtr<IMFAttributes> attributes;
+
+        if (FAILED (MFCreateAttributes (attributes.resetAndGetPointerAddress(), 2)))
+            return;
+
+        // This lets the reader use hardware decoders, and convert their output to RGB32
+        attributes->SetUINT32 (MF_READWRITE_ENABLE_HARDWARE_TRANSFORMS, TRUE);
+        attributes->SetUINT32 (MF_SOURCE_READER_ENABLE_VIDEO_PROCESSING, TRUE);
+
+        if (FAILED (MFCreateSourceReaderFromURL (file.getFullPathName().toWideCharPointer(),
+                                                 attributes, reader.resetAndGetPointerAddress())))
+            return;
+
+        reader->SetStreamSelection ((DWORD) MF_SOURCE_READER_ALL_STREAMS, FALSE);
+        reader->SetStreamSelection ((DWORD) MF_SOURCE_READER_FIRST_VIDEO_STREAM, TRUE);
+
+        ComSmartPtr<IMFMediaType> outputType;
+
+        if (FAILED (MFCreateMediaType (outputType.resetAndGetPointerAddress()))
+             || FAILED (outputType->SetGUID (MF_MT_MAJOR_TYPE, MFMediaType_Video))
+             || FAILED (outputType->SetGUID (MF_MT_SUBTYPE, MFVideoFormat_RGB32))
+             || FAILED (reader->SetCurrentMediaType ((DWORD) MF_SOURCE_READER_FIRST_VIDEO_STREAM, nullptr, outputType))
+             || ! updateFormat())
+        {
+            reader = nullptr;
+            return;
+        }
+
+        PROPVARIANT duration;
+        PropVariantInit (&duration);
+
+        if (SUCCEEDED (reader->GetPresentationAttribute ((DWORD) MF_SOURCE_READER_MEDIASOURCE, MF_PD_DURATION, &duration)))
+        {
+            lengthInFrames = (int64) (duration.uhVal.QuadPart * frameRate / 10000000.0);
+            PropVariantClear (&duration);
+        }
+    }
+
+    ~MediaFoundationVideoDecoder()
+    {
+        reader = nullptr;
+
+        if (isStarted)
+            MFShutdown();
+    }
+
+    bool isOpen() const noexcept        { return reader != nullptr && frameRate > 0; }
+
+    //==============================================================================
+    int getWidth() const                { return width; }
+    int getHeight() const               { return height; }
+    double getFrameRate() const         { return frameRate; }
+    int64 getLengthInFrames() const     { return lengthInFrames; }
+
+    bool seek (int64 frameIndex)
+    {
+        CoInitialize (0);  // (this will be called on the player's decoding thread)
+
+        PROPVARIANT position;
+        PropVariantInit (&position);
+        position.vt = VT_I8;
+        position.hVal.QuadPart = (LONGLONG) (frameIndex * 10000000.0 / frameRate);
+
+        const bool ok = SUCCEEDED (reader->SetCurrentPosition (GUID_NULL, position));
+        PropVariantClear (&position);
+        return ok;
+    }
+
+    bool readNextFrame (Image& destination, int64& frameIndex)
+    {
+        CoInitialize (0);
+
+        for (;;)
+        {
+            DWORD flags = 0;
+            LONGLONG timeStamp = 0;
+            ComSmartPtr<IMFSample> sample;
+
+            if (FAILED (reader->ReadSample ((DWORD) MF_SOURCE_READER_FIRST_VIDEO_STREAM, 0, nullptr,
+                                            &flags, &timeStamp, sample.resetAndGetPointerAddress()))
+                 || (flags & (MF_SOURCE_READERF_ENDOFSTREAM | MF_SOURCE_READERF_ERROR)) != 0)
+                return false;
+
+            if ((flags & MF_SOURCE_READERF_CURRENTMEDIATYPECHANGED) != 0 && ! updateFormat())
+                return false;
+
+            if (sample == nullptr)
+                continue;  // (a gap in the stream)
+
+            frameIndex = (int64) std::floor (timeStamp * frameRate / 10000000.0 + 0.5);
+            return copySample (sample, destination);
+        }
+    }
+
+private:
+    //==============================================================================
+    ComSmartPtr<IMFSourceReader> reader;
+    int width, height;
+    double frameRate;
+    int64 lengthInFrames;
+    LONG defaultStride;
+    bool isStarted;
+
+    bool updateFormat()
+    {
+        ComSmartPtr<IMFMediaType> type;
+
+        if (FAILED (reader->GetCurrentMediaType ((DWORD) MF_SOURCE_READER_FIRST_VIDEO_STREAM, type.resetAndGetPointerAddress())))
+            return false;
+
+        UINT32 w = 0, h = 0, num = 0, den = 0;
+        MFGetAttributeSize (type, MF_MT_FRAME_SIZE, &w, &h);
+        MFGetAttributeRatio (type, MF_MT_FRAME_RATE, &num, &den);
+
+        width = (int) w;
+        height = (int) h;
+
+        if (den > 0)
+            frameRate = num / (double) den;
+
+        // (the stride is stored as a UINT32, but it's really a signed value, which is
+        // negative if the image is bottom-up)
+        defaultStride = (LONG) MFGetAttributeUINT32 (type, MF_MT_DEFAULT_STRIDE, 0);
+
+        if (defaultStride == 0)
+            MFGetStrideForBitmapInfoHeader (MFVideoFormat_RGB32.Data1, w, &defaultStride);
+
+        return width > 0 && height > 0;
+    }
+
+    bool copySample (IMFSample* sample, Image& destination)
+    {
+        ComSmartPtr<IMFMediaBuffer> buffer;
+
+        if (FAILED (sample->ConvertToContiguousBuffer (buffer.resetAndGetPointerAddress())))
+            return false;
+
+        if (! (destination.isValid() && destination.getFormat() == Image::ARGB
+                && destination.getWidth() == width && destination.getHeight() == height))
+            destination = Image (Image::ARGB, width, height, false);
+
+        // A 2D buffer knows its own pitch, which is quicker than assuming the default one
+        ComSmartPtr<IMF2DBuffer> buffer2D;
+        BYTE* topLine = nullptr;
+        LONG pitch = 0;
+
+        if (SUCCEEDED (buffer.QueryInterface (buffer2D))
+             && SUCCEEDED (buffer2D->Lock2D (&topLine, &pitch)))
+        {
+            copyPixels (destination, topLine, pitch);
+            buffer2D->Unlock2D();
+            return true;
+        }
+
+        BYTE* data = nullptr;
+
+        if (FAILED (buffer->Lock (&data, nullptr, nullptr)))
+            return false;
+
+        copyPixels (destination, defaultStride < 0 ? data - defaultStride * (height - 1) : data, defaultStride);
+        buffer->Unlock();
+        return true;
+    }
+
+    void copyPixels (Image& destination, const BYTE* topLine, LONG pitch) const
+    {
+        const Image::BitmapData destData (destination, Image::BitmapData::writeOnly);
+
+        for (int y = 0; y < height; ++y)
+        {
+            const uint32* src = reinterpret_cast<const uint32*> (topLine + y * pitch);
+            uint32* dest = reinterpret_cast<uint32*> (destData.getLinePointer (y));
+
+            // (RGB32's padding byte is undefined, so it needs to be made opaque)
+            for (int x = 0; x < width; ++x)
+                dest[x] = src[x] | 0xff000000;
+        }
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MediaFoundationVideoDecoder)
+};
+
+//==============================================================================
+VideoDecoder* VideoDecoder::createForFile (const File& file)
+{
+    ScopedPointer<MediaFoundationVideoDecoder> decoder (new MediaFoundationVideoDecoder (file));
+
+    if (decoder->isOpen())
+        return decoder.release();
+
+    return nullptr;
+}
@@ -0,0 +1,97 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+
+#ifndef __JUCE_VIDEODECODER_JUCEHEADER__
+#define __JUCE_VIDEODECODER_JUCEHEADER__
+
+
+//==============================================================================
+/**
+    Decodes the frames of a video stream, for use by a VideoPlayer.
+
+    A decoder is only ever used by one thread at a time, so it doesn't need to
+    do any locking of its own.
+
+    You can use createForFile() to get a decoder that uses the platform's own codecs,
+    or write a subclass to wrap some other video library.
+
+    @see VideoPlayer
+*/
+class JUCE_API  VideoDecoder
+{
+public:
+    //==============================================================================
+    /** Destructor. */
+    virtual ~VideoDecoder() {}
+
+    /** Returns the size of the decoded frames. */
+    virtual int getWidth() const = 0;
+
+    /** Returns the size of the decoded frames. */
+    virtual int getHeight() const = 0;
+
+    /** Returns the number of frames per second. */
+    virtual double getFrameRate() const = 0;
+
+    /** Returns the total number of frames in the stream. */
+    virtual int64 getLengthInFrames() const = 0;
+
+    //==============================================================================
+    /** Moves the stream so that the next call to readNextFrame() returns the given frame,
+        or one before it.
+
+        Most formats can only start decoding at a key-frame, so a decoder will usually
+        go to the nearest key-frame before the target, and leave the VideoPlayer to skip
+        the frames between there and the target.
+
+        @returns false if the stream couldn't be repositioned.
+    */
+    virtual bool seek (int64 frameIndex) = 0;
+
+    /** Decodes the next frame in the stream.
+
+        @param destination  the image to decode into. If it's a valid ARGB or RGB image
+                            of the right size, its pixels should be overwritten rather than
+                            a new image being allocated, as the player recycles its images
+        @param frameIndex   on return, this is set to the index of the frame that was read
+        @returns false if there are no more frames, or there was an error.
+    */
+    virtual bool readNextFrame (Image& destination, int64& frameIndex) = 0;
+
+    //==============================================================================
+    /** Tries to create a decoder for a video file using the platform's own codecs.
+
+        These will use hardware decoding where the platform supports it. At the moment,
+        this is only available on Windows, using Media Foundation (so JUCE_MEDIAFOUNDATION
+        must be enabled); on other platforms, this returns nullptr.
+
+        @returns a new decoder, which the caller must delete, or nullptr if the file
+                 couldn't be opened.
+    */
+    static VideoDecoder* createForFile (const File& file);
+};
+
+
+#endif   // __JUCE_VIDEODECODER_JUCEHEADER__
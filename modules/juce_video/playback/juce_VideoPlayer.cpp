@@ -0,0 +1,382 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+
+class VideoPlayer::AudioClock  : public AudioSource
+{
+public:
+    AudioClock (VideoPlayer& owner_)
+        : owner (owner_), source (nullptr), sampleRate (0), blockSize (0),
+          lastPosition (0), lastBlockLength (0), lastBlockTime (0)
+    {
+    }
+
+    void setSource (PositionableAudioSource* newSource)
+    {
+        const ScopedLock sl (lock);
+
+        if (newSource != source)
+        {
+            if (source != nullptr && sampleRate > 0)
+                source->releaseResources();
+
+            source = newSource;
+
+            if (source != nullptr && sampleRate > 0)
+                source->prepareToPlay (blockSize, sampleRate);
+
+            resetPosition (owner.startPosition);
+        }
+    }
+
+    bool isActive() const
+    {
+        const ScopedLock sl (lock);
+        return source != nullptr && sampleRate > 0;
+    }
+
+    double getPosition() const
+    {
+        const ScopedLock sl (lock);
+
+        // The last block was handed to the device when it was read, so it's assumed to be
+        // playing from then until its end..
+        double position = (lastPosition - lastBlockLength) / sampleRate;
+
+        if (owner.playing)
+            position += jmin (lastBlockLength / sampleRate,
+                              (Time::getMillisecondCounterHiRes() - lastBlockTime) * 0.001);
+
+        return position;
+    }
+
+    void resetPosition (double newPositionSeconds)
+    {
+        const ScopedLock sl (lock);
+
+        if (source != nullptr && sampleRate > 0)
+        {
+            lastPosition = (int64) (newPositionSeconds * sampleRate);
+            lastBlockLength = 0;
+            lastBlockTime = Time::getMillisecondCounterHiRes();
+            source->setNextReadPosition (lastPosition);
+        }
+    }
+
+    //==============================================================================
+    void prepareToPlay (int samplesPerBlockExpected, double newSampleRate)
+    {
+        const ScopedLock sl (lock);
+        sampleRate = newSampleRate;
+        blockSize = samplesPerBlockExpected;
+
+        if (source != nullptr)
+        {
+            source->prepareToPlay (samplesPerBlockExpected, newSampleRate);
+            resetPosition (owner.startPosition);
+        }
+    }
+
+    void releaseResources()
+    {
+        const ScopedLock sl (lock);
+
+        if (source != nullptr)
+            source->releaseResources();
+
+        sampleRate = 0;
+    }
+
+    void getNextAudioBlock (const AudioSourceChannelInfo& info)
+    {
+        const ScopedLock sl (lock);
+
+        if (source == nullptr || ! owner.playing)
+        {
+            info.clearActiveBufferRegion();
+            return;
+        }
+
+        source->getNextAudioBlock (info);
+
+        lastPosition = source->getNextReadPosition();
+        lastBlockLength = info.numSamples;
+        lastBlockTime = Time::getMillisecondCounterHiRes();
+    }
+
+private:
+    VideoPlayer& owner;
+    CriticalSection lock;
+    PositionableAudioSource* source;
+    double sampleRate;
+    int blockSize;
+    int64 lastPosition;
+    int lastBlockLength;
+    double lastBlockTime;
+
+    JUCE_DECLARE_NON_COPYABLE (AudioClock)
+};
+
+//==============================================================================
+VideoPlayer::VideoPlayer (VideoDecoder* const decoder_,
+                          TimeSliceThread& thread_,
+                          const int numFramesToBuffer_)
+    : decoder (decoder_),
+      thread (thread_),
+      numFramesToBuffer (jmax (1, numFramesToBuffer_)),
+      frameRate (decoder_->getFrameRate()),
+      currentFrameIndex (-1),
+      seekTarget (0),
+      playing (false),
+      isWaitingForSeek (false),
+      reachedEnd (false),
+      startPosition (0),
+      startTime (0)
+{
+    jassert (decoder != nullptr);
+    jassert (frameRate > 0);
+
+    audioClock = new AudioClock (*this);
+    thread.addTimeSliceClient (this);
+}
+
+VideoPlayer::~VideoPlayer()
+{
+    thread.removeTimeSliceClient (this);
+}
+
+double VideoPlayer::getLengthInSeconds() const
+{
+    return decoder->getLengthInFrames() / frameRate;
+}
+
+//==============================================================================
+void VideoPlayer::start()
+{
+    const ScopedLock sl (frameLock);
+
+    if (! playing)
+    {
+        startPosition = getPosition();
+        startTime = Time::getMillisecondCounterHiRes();
+        playing = true;
+    }
+}
+
+void VideoPlayer::stop()
+{
+    const ScopedLock sl (frameLock);
+
+    if (playing)
+    {
+        startPosition = getPosition();
+        playing = false;
+    }
+}
+
+void VideoPlayer::setPosition (double newPositionSeconds)
+{
+    setFrame ((int64) std::floor (newPositionSeconds * frameRate));
+}
+
+void VideoPlayer::setFrame (int64 frameIndex)
+{
+    frameIndex = jlimit ((int64) 0, jmax ((int64) 0, decoder->getLengthInFrames() - 1), frameIndex);
+
+    const ScopedLock sl (frameLock);
+
+    startPosition = frameIndex / frameRate;
+    startTime = Time::getMillisecondCounterHiRes();
+    audioClock->resetPosition (startPosition);
+
+    // If the frame's already been decoded, there's no need to seek..
+    for (int i = 0; i < frames.size(); ++i)
+        if (frames.getReference (i).index == frameIndex)
+            return;
+
+    for (int i = 0; i < frames.size(); ++i)
+        recycle (frames.getReference (i).image);
+
+    frames.clearQuick();
+    seekTarget = frameIndex;
+    thread.moveToFrontOfQueue (this);
+}
+
+double VideoPlayer::getPosition() const
+{
+    if (isUsingAudioClock())
+        return audioClock->getPosition();
+
+    const ScopedLock sl (frameLock);
+
+    if (playing)
+        return startPosition + (Time::getMillisecondCounterHiRes() - startTime) * 0.001;
+
+    return startPosition;
+}
+
+bool VideoPlayer::isUsingAudioClock() const noexcept
+{
+    return audioClock->isActive();
+}
+
+//==============================================================================
+Image VideoPlayer::getCurrentFrame (int64* frameIndex)
+{
+    const int64 index = (int64) std::floor (getPosition() * frameRate);
+
+    const ScopedLock sl (frameLock);
+
+    // Move on to the latest decoded frame that's due by now, skipping any that are late
+    while (frames.size() > 0 && frames.getReference (0).index <= index)
+    {
+        recycle (currentFrame);
+        currentFrame = frames.getReference (0).image;
+        currentFrameIndex = frames.getReference (0).index;
+        frames.remove (0);
+    }
+
+    if (frameIndex != nullptr)
+        *frameIndex = currentFrameIndex;
+
+    return currentFrame;
+}
+
+//==============================================================================
+void VideoPlayer::setAudioSource (PositionableAudioSource* audioSource)
+{
+    const ScopedLock sl (frameLock);
+    audioClock->setSource (audioSource);
+}
+
+AudioSource& VideoPlayer::getAudioSource() noexcept
+{
+    return *audioClock;
+}
+
+//==============================================================================
+Image VideoPlayer::getSpareImage()
+{
+    const ScopedLock sl (frameLock);
+
+    if (spareImages.size() == 0)
+        return Image();
+
+    const Image image (spareImages.getLast());
+    spareImages.removeLast();
+    return image;
+}
+
+void VideoPlayer::recycle (Image& image)
+{
+    // (the image can only be reused if no-one else is holding onto it)
+    if (image.getReferenceCount() == 1 && spareImages.size() < numFramesToBuffer + 2)
+        spareImages.add (image);
+
+    image = Image();
+}
+
+bool VideoPlayer::seekTo (const int64 frameIndex)
+{
+    if (! decoder->seek (frameIndex))
+        return false;
+
+    Image image (getSpareImage());
+
+    for (;;)
+    {
+        if (seekTarget.get() >= 0)
+            return false;  // (a new seek has been requested, so give up on this one)
+
+        int64 index;
+
+        if (! decoder->readNextFrame (image, index))
+        {
+            reachedEnd = true;
+            return false;
+        }
+
+        if (index >= frameIndex)
+        {
+            const ScopedLock sl (frameLock);
+
+            if (seekTarget.get() < 0)
+            {
+                DecodedFrame frame = { image, index };
+                frames.add (frame);
+            }
+
+            return true;
+        }
+    }
+}
+
+int VideoPlayer::useTimeSlice()
+{
+    if (seekTarget.get() >= 0)
+    {
+        isWaitingForSeek = true;
+        reachedEnd = false;
+        seekTo (seekTarget.exchange (-1));
+        isWaitingForSeek = false;
+        return 0;
+    }
+
+    if (reachedEnd)
+        return 20;
+
+    {
+        const ScopedLock sl (frameLock);
+
+        if (frames.size() >= numFramesToBuffer)
+            return 5;
+    }
+
+    Image image (getSpareImage());
+    int64 index;
+
+    if (! decoder->readNextFrame (image, index))
+    {
+        reachedEnd = true;
+        return 20;
+    }
+
+    const ScopedLock sl (frameLock);
+
+    if (seekTarget.get() < 0)  // (if a seek was started while decoding, this frame's not needed)
+    {
+        DecodedFrame frame = { image, index };
+        frames.add (frame);
+    }
+
+    return 0;
+}
+
+//==============================================================================
+#if ! JUCE_MEDIAFOUNDATION
+VideoDecoder* VideoDecoder::createForFile (const File&)
+{
+    return nullptr;
+}
+#endif
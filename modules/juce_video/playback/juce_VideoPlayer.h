@@ -0,0 +1,172 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2013 - Raw Material Software Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+
+#ifndef __JUCE_VIDEOPLAYER_JUCEHEADER__
+#define __JUCE_VIDEOPLAYER_JUCEHEADER__
+
+#include "juce_VideoDecoder.h"
+
+
+//==============================================================================
+/**
+    Plays a video stream, decoding its frames ahead of time on a background thread.
+
+    Unlike the DirectShowComponent and QuickTimeMovieComponent, this doesn't draw
+    anything itself: whatever's doing the drawing calls getCurrentFrame() to find
+    the image that should be shown at the current time. For example, an
+    OpenGLRenderer can call it from renderOpenGL() and load the result into an
+    OpenGLTexture, or a component can call it from paint(), triggered by a Timer.
+
+    The timing comes from the system clock, unless an audio track has been given to
+    setAudioSource(). In that case the video follows the position of the audio, which
+    must be played through the AudioSource that getAudioSource() returns.
+
+    Seeking is frame-accurate: after setPosition() or setFrame(), the player decodes
+    from the preceding key-frame and skips forward to the exact frame, while
+    getCurrentFrame() carries on returning the last frame that was shown.
+
+    @see VideoDecoder
+*/
+class JUCE_API  VideoPlayer  : private TimeSliceClient
+{
+public:
+    //==============================================================================
+    /** Creates a player for a decoder.
+
+        @param decoder              the stream to play. The player takes ownership of this
+        @param decodingThread       the thread that will be used to decode frames. This must
+                                    be running, and mustn't be deleted until the player has
+                                    been deleted
+        @param numFramesToBuffer    the number of decoded frames to keep ready ahead of the
+                                    current position
+    */
+    VideoPlayer (VideoDecoder* decoder,
+                 TimeSliceThread& decodingThread,
+                 int numFramesToBuffer = 8);
+
+    /** Destructor. */
+    ~VideoPlayer();
+
+    //==============================================================================
+    /** Returns the decoder that's being played. */
+    VideoDecoder& getDecoder() const noexcept                   { return *decoder; }
+
+    /** Returns the length of the video in seconds. */
+    double getLengthInSeconds() const;
+
+    //==============================================================================
+    /** Starts playing from the current position. */
+    void start();
+
+    /** Stops playing, leaving the position where it is. */
+    void stop();
+
+    /** Returns true if it's currently playing. */
+    bool isPlaying() const noexcept                             { return playing; }
+
+    /** Moves to a new position, in seconds.
+        This rounds the time down to the start of a frame, and then calls setFrame().
+    */
+    void setPosition (double newPositionSeconds);
+
+    /** Moves to a particular frame.
+        This can be called repeatedly for scrubbing: a new call abandons any seek that's
+        still in progress.
+    */
+    void setFrame (int64 frameIndex);
+
+    /** Returns the current position, in seconds. */
+    double getPosition() const;
+
+    /** Returns true while a seek is waiting for the frame it's moving to. */
+    bool isSeeking() const noexcept                             { return seekTarget.get() >= 0 || isWaitingForSeek; }
+
+    //==============================================================================
+    /** Returns the frame that should be shown at the current position.
+
+        If the right frame hasn't been decoded yet, e.g. during a seek, this returns the
+        last one that was returned. The image is shared with the player, and its storage
+        is only reused once you've released it, so it's safe to hold onto.
+
+        @param frameIndex   if this isn't null, it's set to the index of the frame
+    */
+    Image getCurrentFrame (int64* frameIndex = nullptr);
+
+    //==============================================================================
+    /** Gives the player an audio track to synchronise the video with.
+
+        The source's position should be in samples at the rate at which it'll be
+        played, starting at the beginning of the video. The player doesn't take
+        ownership of it. Pass nullptr to go back to using the system clock.
+
+        Once a source has been set, it should be played through getAudioSource(), which
+        only lets the audio through while the player is playing.
+    */
+    void setAudioSource (PositionableAudioSource* audioSource);
+
+    /** Returns the AudioSource through which the audio track must be played.
+        @see setAudioSource
+    */
+    AudioSource& getAudioSource() noexcept;
+
+private:
+    //==============================================================================
+    class AudioClock;
+    friend class AudioClock;
+
+    struct DecodedFrame
+    {
+        Image image;
+        int64 index;
+    };
+
+    ScopedPointer<VideoDecoder> decoder;
+    TimeSliceThread& thread;
+    const int numFramesToBuffer;
+    const double frameRate;
+
+    CriticalSection frameLock;
+    Array<DecodedFrame> frames;
+    Array<Image> spareImages;
+    Image currentFrame;
+    int64 currentFrameIndex;
+
+    Atomic<int64> seekTarget;
+    bool volatile playing, isWaitingForSeek, reachedEnd;
+
+    double startPosition, startTime;
+    ScopedPointer<AudioClock> audioClock;
+
+    int useTimeSlice();
+    bool seekTo (int64 frameIndex);
+    Image getSpareImage();
+    void recycle (Image&);
+    bool isUsingAudioClock() const noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (VideoPlayer)
+};
+
+
+#endif   // __JUCE_VIDEOPLAYER_JUCEHEADER__